@@ -0,0 +1,42 @@
+/*****************************************************************************
+ *
+ * bench.h
+ *    Microbenchmarks of the kernels of temporal types.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+
+/*****************************************************************************/
+
+/**
+ * Kernels that are measured by the microbenchmarks
+ */
+typedef enum
+{
+  BENCH_TSEQUENCE_MAKE,
+  BENCH_TSEQUENCE_AT_PERIOD,
+  BENCH_SYNC_TFUNC,
+  BENCH_DISTANCE_TPOINT_GEO,
+  BENCH_TPOINTSEQ_AT_GEOMETRY,
+  BENCH_TSEQUENCE_TAGG,
+  BENCH_TEMPORAL_OUT,
+  BENCH_TEMPORAL_IN,
+} BenchKernel;
+
+#define BENCH_KERNELS 8
+
+extern Datum mobdb_bench(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
@@ -0,0 +1,52 @@
+/*****************************************************************************
+ *
+ * funcstat.h
+ *    Counters of the work done by the functions of temporal types.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __FUNCSTAT_H__
+#define __FUNCSTAT_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+
+/*****************************************************************************/
+
+/**
+ * Counters of the work done by the functions of temporal types
+ */
+typedef enum
+{
+  FUNC_STAT_SEQUENCES,        /**< sequences constructed */
+  FUNC_STAT_INSTANTS,         /**< instants of these sequences */
+  FUNC_STAT_SEQUENCE_BYTES,   /**< bytes allocated for these sequences */
+  FUNC_STAT_POSTGIS_CALLS,    /**< calls to PostGIS and base type functions */
+  FUNC_STAT_SKIPLIST_SPLICES, /**< splices in the skiplists of aggregates */
+  FUNC_STAT_DETOAST_BYTES,    /**< bytes of the temporal values detoasted */
+  FUNC_STAT_SHARED_CACHE_HITS, /**< values read from the shared cache */
+} FuncStatKind;
+
+#define FUNC_STAT_KINDS 7
+
+extern bool function_stats;
+extern uint64 func_counters[FUNC_STAT_KINDS];
+
+/* The counters are only updated when mobilitydb.function_stats is on */
+#define FUNC_STAT_ADD(kind, n) \
+  do { \
+    if (function_stats) \
+      func_counters[kind] += (uint64) (n); \
+  } while (0)
+
+extern Datum mobilitydb_stat_counters(PG_FUNCTION_ARGS);
+extern Datum mobilitydb_stat_reset(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
@@ -0,0 +1,43 @@
+/*****************************************************************************
+ *
+ * indexesstat.h
+ *    Statistics about the GiST and SP-GiST indexes of temporal types.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __INDEXESSTAT_H__
+#define __INDEXESSTAT_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+
+/*****************************************************************************/
+
+/**
+ * Families of GiST consistent methods whose calls are counted
+ */
+typedef enum
+{
+  GIST_STAT_PERIOD,
+  GIST_STAT_TBOX,
+  GIST_STAT_STBOX,
+} GistStatKind;
+
+#define GIST_STAT_KINDS 3
+
+extern void gist_consistent_count(GistStatKind kind, bool leaf, bool result,
+  bool recheck);
+
+extern Datum spgiststat(PG_FUNCTION_ARGS);
+extern Datum giststat(PG_FUNCTION_ARGS);
+extern Datum gist_consistent_counters(PG_FUNCTION_ARGS);
+extern Datum gist_consistent_reset(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
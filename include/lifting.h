@@ -16,6 +16,7 @@
 #include <postgres.h>
 #include <catalog/pg_type.h>
 #include "temporal.h"
+#include "oidcache.h"
 
 /**
  * Structure to represent the information about lifted functions
@@ -77,6 +78,13 @@ extern Temporal *
 sync_tfunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
   Datum param, LiftedFunctionInfo lfinfo);
 
+extern Temporal *tfunc_tfloat_arithop_base(const Temporal *temp, double d,
+  TArithmetic oper, bool invert);
+extern Temporal *tfunc_tfloat_comp_base(const Temporal *temp, double d,
+  CachedOp op, bool invert);
+extern Temporal *tfunc_tbool_boolop_base(const Temporal *temp, bool b,
+  bool isand);
+
 /*****************************************************************************/
 
 #endif
@@ -0,0 +1,151 @@
+/*****************************************************************************
+ *
+ * mobdb_probes.h
+ *    Static tracepoints of MobilityDB.
+ *
+ * The tracepoints are compiled when configuring with -DWITH_DTRACE=ON,
+ * which defines ENABLE_MOBDB_DTRACE, and expand to nothing otherwise. They
+ * are USDT probes of the provider mobilitydb defined with <sys/sdt.h>, in
+ * the style of the TRACE_POSTGRESQL_* probes of PostgreSQL, and can be
+ * attached with perf, bpftrace, or SystemTap, e.g.,
+ * @code
+ * bpftrace -e 'usdt:/path/to/libMobilityDB-1.0.so:mobilitydb:* { ... }'
+ * @endcode
+ * The probes ending with _START and _DONE are fired at the start and at the
+ * end of a function. Their arguments are the number of instants and the
+ * size in bytes of the temporal values, or the number of entries for the
+ * index methods, so that latency outliers can be attributed to the size of
+ * the values. The number of instants of a temporal value is given by the
+ * function temporal_probe_count.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __MOBDB_PROBES_H__
+#define __MOBDB_PROBES_H__
+
+#ifdef ENABLE_MOBDB_DTRACE
+
+#include <sys/sdt.h>
+
+#define MOBDB_PROBE1(name, a) \
+  DTRACE_PROBE1(mobilitydb, name, a)
+#define MOBDB_PROBE2(name, a, b) \
+  DTRACE_PROBE2(mobilitydb, name, a, b)
+#define MOBDB_PROBE3(name, a, b, c) \
+  DTRACE_PROBE3(mobilitydb, name, a, b, c)
+
+#else
+
+#define MOBDB_PROBE1(name, a) do {} while (0)
+#define MOBDB_PROBE2(name, a, b) do {} while (0)
+#define MOBDB_PROBE3(name, a, b, c) do {} while (0)
+
+#endif
+
+/*****************************************************************************
+ * Aggregates: number of instants and size of the value added, number of
+ * values of the skiplists, and number of instants and size of the result
+ *****************************************************************************/
+
+#define TRACE_MOBILITYDB_AGG_TRANSFN_START(count, size) \
+  MOBDB_PROBE2(agg__transfn__start, count, size)
+#define TRACE_MOBILITYDB_AGG_TRANSFN_DONE(length) \
+  MOBDB_PROBE1(agg__transfn__done, length)
+#define TRACE_MOBILITYDB_AGG_COMBINEFN_START(length1, length2) \
+  MOBDB_PROBE2(agg__combinefn__start, length1, length2)
+#define TRACE_MOBILITYDB_AGG_COMBINEFN_DONE(length) \
+  MOBDB_PROBE1(agg__combinefn__done, length)
+#define TRACE_MOBILITYDB_AGG_FINALFN_START(length) \
+  MOBDB_PROBE1(agg__finalfn__start, length)
+#define TRACE_MOBILITYDB_AGG_FINALFN_DONE(count, size) \
+  MOBDB_PROBE2(agg__finalfn__done, count, size)
+
+/*****************************************************************************
+ * GiST indexes: family of the key (see GistStatKind), strategy and result
+ * of the consistent methods, and number of entries split by the picksplit
+ * methods with the number of entries in the left and right pages
+ *****************************************************************************/
+
+#define TRACE_MOBILITYDB_GIST_CONSISTENT_START(kind, strategy) \
+  MOBDB_PROBE2(gist__consistent__start, kind, strategy)
+#define TRACE_MOBILITYDB_GIST_CONSISTENT_DONE(kind, result) \
+  MOBDB_PROBE2(gist__consistent__done, kind, result)
+#define TRACE_MOBILITYDB_GIST_PICKSPLIT_START(kind, nentries) \
+  MOBDB_PROBE2(gist__picksplit__start, kind, nentries)
+#define TRACE_MOBILITYDB_GIST_PICKSPLIT_DONE(kind, nleft, nright) \
+  MOBDB_PROBE3(gist__picksplit__done, kind, nleft, nright)
+
+/*****************************************************************************
+ * Construction of sequences: number of instants given, and number of
+ * instants and size of the result after normalization
+ *****************************************************************************/
+
+#define TRACE_MOBILITYDB_SEQUENCE_MAKE_START(count) \
+  MOBDB_PROBE1(sequence__make__start, count)
+#define TRACE_MOBILITYDB_SEQUENCE_MAKE_DONE(count, size) \
+  MOBDB_PROBE2(sequence__make__done, count, size)
+
+/*****************************************************************************
+ * Restriction: kind of restriction, number of instants and size of the
+ * argument and of the result, which are 0 for a NULL result
+ *****************************************************************************/
+
+/**
+ * Kinds of restriction given to the restriction probes
+ */
+typedef enum
+{
+  PROBE_RESTRICT_VALUE,
+  PROBE_RESTRICT_VALUES,
+  PROBE_RESTRICT_MINMAX,
+  PROBE_RESTRICT_TIMESTAMP,
+  PROBE_RESTRICT_TIMESTAMPSET,
+  PROBE_RESTRICT_PERIOD,
+  PROBE_RESTRICT_PERIODSET,
+} ProbeRestrictKind;
+
+#define TRACE_MOBILITYDB_RESTRICT_START(kind, count, size) \
+  MOBDB_PROBE3(restrict__start, kind, count, size)
+#define TRACE_MOBILITYDB_RESTRICT_DONE(kind, count, size) \
+  MOBDB_PROBE3(restrict__done, kind, count, size)
+
+/*****************************************************************************
+ * ANALYZE: number of sample rows, and number of non-null values and their
+ * total size
+ *****************************************************************************/
+
+#define TRACE_MOBILITYDB_ANALYZE_START(samplerows) \
+  MOBDB_PROBE1(analyze__start, samplerows)
+#define TRACE_MOBILITYDB_ANALYZE_DONE(nonnull, size) \
+  MOBDB_PROBE2(analyze__done, nonnull, size)
+
+/*****************************************************************************
+ * Input and output: size of the text or binary representation, and
+ * number of instants and size of the temporal value
+ *****************************************************************************/
+
+#define TRACE_MOBILITYDB_IN_START(length) \
+  MOBDB_PROBE1(in__start, length)
+#define TRACE_MOBILITYDB_IN_DONE(count, size) \
+  MOBDB_PROBE2(in__done, count, size)
+#define TRACE_MOBILITYDB_OUT_START(count, size) \
+  MOBDB_PROBE2(out__start, count, size)
+#define TRACE_MOBILITYDB_OUT_DONE(length) \
+  MOBDB_PROBE1(out__done, length)
+#define TRACE_MOBILITYDB_RECV_START(length) \
+  MOBDB_PROBE1(recv__start, length)
+#define TRACE_MOBILITYDB_RECV_DONE(count, size) \
+  MOBDB_PROBE2(recv__done, count, size)
+#define TRACE_MOBILITYDB_SEND_START(count, size) \
+  MOBDB_PROBE2(send__start, count, size)
+#define TRACE_MOBILITYDB_SEND_DONE(length) \
+  MOBDB_PROBE1(send__done, length)
+
+/*****************************************************************************/
+
+#endif
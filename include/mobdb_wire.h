@@ -0,0 +1,131 @@
+/*****************************************************************************
+ *
+ * mobdb_wire.h
+ *    Standalone writer of the compact binary format of temporal types.
+ *
+ * This header and its implementation do not depend on PostgreSQL, PostGIS or
+ * the extension, so that they can be embedded in applications running
+ * outside the database. The values written are accepted by the receive
+ * functions of the temporal types, e.g., with COPY ... WITH (FORMAT binary)
+ * or with the binary protocol of a client driver.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __MOBDB_WIRE_H__
+#define __MOBDB_WIRE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*****************************************************************************/
+
+/* Durations, with the same values as the TDuration enumeration */
+#define MOBDB_WIRE_INSTANT      1
+#define MOBDB_WIRE_INSTANTSET   2
+#define MOBDB_WIRE_SEQUENCE     3
+#define MOBDB_WIRE_SEQUENCESET  4
+
+/* Microseconds between 1970-01-01 and 2000-01-01, the epoch of timestamps */
+#define MOBDB_WIRE_UNIX_EPOCH_USECS INT64_C(946684800000000)
+
+/**
+ * Base types written by the writer
+ */
+typedef enum
+{
+  MOBDB_WIRE_BOOL,
+  MOBDB_WIRE_INT,
+  MOBDB_WIRE_FLOAT,
+  MOBDB_WIRE_GEOMPOINT,
+  MOBDB_WIRE_GEOGPOINT,
+} MobdbWireBase;
+
+/**
+ * Status codes returned by the functions of the writer
+ */
+typedef enum
+{
+  MOBDB_WIRE_OK,
+  MOBDB_WIRE_NOMEM,         /**< The allocator returned NULL */
+  MOBDB_WIRE_INVALID,       /**< Invalid argument for the type or duration */
+  MOBDB_WIRE_ORDER,         /**< Timestamps are not strictly increasing */
+  MOBDB_WIRE_EMPTY,         /**< Value, or sequence, without instants */
+} MobdbWireStatus;
+
+/**
+ * Allocator used by the writer, the functions of the C library are used
+ * when no allocator is given
+ */
+typedef struct
+{
+  void *(*alloc)(size_t size);
+  void *(*realloc)(void *ptr, size_t size);
+  void (*free)(void *ptr);
+} MobdbWireAllocator;
+
+typedef struct MobdbWireWriter MobdbWireWriter;
+
+extern MobdbWireWriter *mobdb_wire_writer_new(MobdbWireBase base,
+  int duration, bool linear, bool hasz, int32_t srid,
+  const MobdbWireAllocator *allocator);
+extern void mobdb_wire_writer_free(MobdbWireWriter *writer);
+extern void mobdb_wire_writer_reset(MobdbWireWriter *writer);
+
+extern MobdbWireStatus mobdb_wire_begin_sequence(MobdbWireWriter *writer,
+  bool lower_inc, bool upper_inc);
+extern MobdbWireStatus mobdb_wire_add_bool(MobdbWireWriter *writer,
+  int64_t t, bool value);
+extern MobdbWireStatus mobdb_wire_add_int(MobdbWireWriter *writer,
+  int64_t t, int32_t value);
+extern MobdbWireStatus mobdb_wire_add_float(MobdbWireWriter *writer,
+  int64_t t, double value);
+extern MobdbWireStatus mobdb_wire_add_point(MobdbWireWriter *writer,
+  int64_t t, double x, double y, double z);
+
+extern MobdbWireStatus mobdb_wire_finish(MobdbWireWriter *writer,
+  uint8_t **data, size_t *size);
+
+/*****************************************************************************
+ * Batch API
+ *****************************************************************************/
+
+/**
+ * Sequence to write with the batch API. The values of temporal booleans,
+ * integers and floats are given in x, the coordinates of temporal points in
+ * x, y and, when the writer has Z coordinates, in z.
+ */
+typedef struct
+{
+  int32_t count;           /**< Number of instants */
+  const int64_t *times;    /**< Timestamps in microseconds since 2000-01-01 */
+  const double *x;
+  const double *y;
+  const double *z;
+  bool lower_inc;
+  bool upper_inc;
+} MobdbWireSequence;
+
+/**
+ * Binary representation of a sequence written with the batch API
+ */
+typedef struct
+{
+  MobdbWireStatus status;
+  uint8_t *data;            /**< Allocated with the allocator of the batch */
+  size_t size;
+} MobdbWireOutput;
+
+extern MobdbWireStatus mobdb_wire_write_batch(MobdbWireBase base,
+  bool linear, bool hasz, int32_t srid, const MobdbWireSequence *seqs,
+  int32_t count, int nthreads, const MobdbWireAllocator *allocator,
+  MobdbWireOutput *outputs);
+
+/*****************************************************************************/
+
+#endif
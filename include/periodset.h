@@ -19,6 +19,22 @@
 
 /*****************************************************************************/
 
+/**
+ * Structure to represent a search index of the lower bounds of the periods
+ * of a period set
+ *
+ * The bounds are stored in Eytzinger (breadth-first) order, i.e., the
+ * implicit binary search tree whose root is at position 1 and the children
+ * of position k are at positions 2k and 2k+1, so that the search accesses
+ * memory in a predictable pattern and has no data-dependent branches.
+ */
+typedef struct
+{
+  int         count;          /**< number of periods */
+  TimestampTz *bounds;        /**< lower bounds in Eytzinger order */
+  int        *pos;            /**< position of each bound in the period set */
+} PeriodSetIndex;
+
 /* Assorted support functions */
 
 extern Period *periodset_per_n(const PeriodSet *ps, int index);
@@ -30,6 +46,9 @@ extern PeriodSet *periodset_make_free(Period **periods, int count,
 extern PeriodSet *periodset_copy(const PeriodSet *ps);
 extern bool periodset_find_timestamp(const PeriodSet *ps, TimestampTz t,
   int *loc);
+extern PeriodSetIndex *periodset_index_make(const PeriodSet *ps);
+extern bool periodset_index_find_timestamp(const PeriodSetIndex *idx,
+  const PeriodSet *ps, TimestampTz t, int *loc);
 
 /* Input/output functions */
 
@@ -25,6 +25,8 @@ extern Datum upper_datum(const RangeType *range);
 extern bool lower_inc(RangeType *range);
 extern bool upper_inc(RangeType *range);
 extern void range_bounds(RangeType *range, double *xmin, double *xmax);
+extern void rangearr_bounds(RangeType **ranges, int count, double *xmin,
+  double *xmax);
 extern RangeType *range_make(Datum from, Datum to, bool lower_inc,
   bool upper_inc, Oid basetypid);
 extern RangeType **rangearr_normalize(RangeType **ranges, int count,
@@ -146,32 +146,118 @@ struct tduration_struct
   (sizeof tduration_struct_array/sizeof(struct tduration_struct))
 #define TDURATION_MAX_LEN   13
 
+/*****************************************************************************
+ * Binary format of temporal types
+ *****************************************************************************/
+
+/**
+ * Enumeration for the binary format written by the send function
+ */
+typedef enum
+{
+  BINARY_STANDARD,
+  BINARY_COMPACT
+} BinaryFormat;
+
+/** Bit set in the first byte, the duration, of the compact binary format */
+#define COMPACT_BINARY_FLAG     0x80
+#define COMPACT_BINARY_VERSION  1
+
+/* Flags of the compact binary format */
+#define COMPACT_LINEAR          0x01
+#define COMPACT_Z               0x02
+#define COMPACT_GEODETIC        0x04
+
+/* Bounds of the sequences in the compact binary format */
+#define COMPACT_LOWER_INC       0x01
+#define COMPACT_UPPER_INC       0x02
+
 /*****************************************************************************
  * Macros for manipulating the 'flags' element
- * GTZXBL
+ * RFSQKVJPGTZXBL
  *****************************************************************************/
 
 #define MOBDB_FLAGS_GET_LINEAR(flags)     ((bool) ((flags) & 0x01))
-/* The following flag is only used for TInstant */
+/* The following flag is used for TInstant and, in the current format, for
+ * TInstantSet and TSequence, whose instants then have a fixed size */
 #define MOBDB_FLAGS_GET_BYVAL(flags)     ((bool) (((flags) & 0x02)>>1))
 #define MOBDB_FLAGS_GET_X(flags)      ((bool) (((flags) & 0x04)>>2))
 #define MOBDB_FLAGS_GET_Z(flags)       ((bool) (((flags) & 0x08)>>3))
 #define MOBDB_FLAGS_GET_T(flags)       ((bool) (((flags) & 0x10)>>4))
 #define MOBDB_FLAGS_GET_GEODETIC(flags)   ((bool) (((flags) & 0x20)>>5))
+/* The following flag is only used for the packed format */
+#define MOBDB_FLAGS_GET_PACKED(flags)     ((bool) (((flags) & 0x40)>>6))
+/* The following flag is only used for TSequence */
+#define MOBDB_FLAGS_GET_TRAJ(flags)     ((bool) (((flags) & 0x80)>>7))
+/* The following flag is only used for TInstantSet, TSequence, and TSequenceSet */
+#define MOBDB_FLAGS_GET_VERSION(flags)     ((bool) (((flags) & 0x0100)>>8))
+/* The following flag is only used for TSequence */
+#define MOBDB_FLAGS_GET_BLOCKS(flags)     ((bool) (((flags) & 0x0200)>>9))
+/* The following flag is only used for the packed format */
+#define MOBDB_FLAGS_GET_QUANTIZED(flags)     ((bool) (((flags) & 0x0400)>>10))
+/* The following flag is only used for TSequence */
+#define MOBDB_FLAGS_GET_LEVELS(flags)     ((bool) (((flags) & 0x0800)>>11))
+/* The following flag is only used for the packed format */
+#define MOBDB_FLAGS_GET_SHUFFLED(flags)     ((bool) (((flags) & 0x1000)>>12))
+/* The following flag is only used for TSequence */
+#define MOBDB_FLAGS_GET_REGULAR(flags)     ((bool) (((flags) & 0x2000)>>13))
 
 #define MOBDB_FLAGS_SET_LINEAR(flags, value) \
-  ((flags) = (value) ? ((flags) | 0x01) : ((flags) & 0xFE))
-/* The following flag is only used for TInstant */
+  ((flags) = (value) ? ((flags) | 0x01) : ((flags) & 0xFFFE))
+/* The following flag is used for TInstant and, in the current format, for
+ * TInstantSet and TSequence, whose instants then have a fixed size */
 #define MOBDB_FLAGS_SET_BYVAL(flags, value) \
-  ((flags) = (value) ? ((flags) | 0x02) : ((flags) & 0xFD))
+  ((flags) = (value) ? ((flags) | 0x02) : ((flags) & 0xFFFD))
 #define MOBDB_FLAGS_SET_X(flags, value) \
-  ((flags) = (value) ? ((flags) | 0x04) : ((flags) & 0xFB))
+  ((flags) = (value) ? ((flags) | 0x04) : ((flags) & 0xFFFB))
 #define MOBDB_FLAGS_SET_Z(flags, value) \
-  ((flags) = (value) ? ((flags) | 0x08) : ((flags) & 0xF7))
+  ((flags) = (value) ? ((flags) | 0x08) : ((flags) & 0xFFF7))
 #define MOBDB_FLAGS_SET_T(flags, value) \
-  ((flags) = (value) ? ((flags) | 0x10) : ((flags) & 0xEF))
+  ((flags) = (value) ? ((flags) | 0x10) : ((flags) & 0xFFEF))
 #define MOBDB_FLAGS_SET_GEODETIC(flags, value) \
-  ((flags) = (value) ? ((flags) | 0x20) : ((flags) & 0xDF))
+  ((flags) = (value) ? ((flags) | 0x20) : ((flags) & 0xFFDF))
+/* The following flag is only used for the packed format */
+#define MOBDB_FLAGS_SET_PACKED(flags, value) \
+  ((flags) = (value) ? ((flags) | 0x40) : ((flags) & 0xFFBF))
+/* The following flag is only used for TSequence */
+#define MOBDB_FLAGS_SET_TRAJ(flags, value) \
+  ((flags) = (value) ? ((flags) | 0x80) : ((flags) & 0xFF7F))
+/* The following flag is only used for TInstantSet, TSequence, and TSequenceSet */
+#define MOBDB_FLAGS_SET_VERSION(flags, value) \
+  ((flags) = (value) ? ((flags) | 0x0100) : ((flags) & 0xFEFF))
+/* The following flag is only used for TSequence */
+#define MOBDB_FLAGS_SET_BLOCKS(flags, value) \
+  ((flags) = (value) ? ((flags) | 0x0200) : ((flags) & 0xFDFF))
+/* The following flag is only used for the packed format */
+#define MOBDB_FLAGS_SET_QUANTIZED(flags, value) \
+  ((flags) = (value) ? ((flags) | 0x0400) : ((flags) & 0xFBFF))
+/* The following flag is only used for TSequence */
+#define MOBDB_FLAGS_SET_LEVELS(flags, value) \
+  ((flags) = (value) ? ((flags) | 0x0800) : ((flags) & 0xF7FF))
+/* The following flag is only used for the packed format */
+#define MOBDB_FLAGS_SET_SHUFFLED(flags, value) \
+  ((flags) = (value) ? ((flags) | 0x1000) : ((flags) & 0xEFFF))
+/* The following flag is only used for TSequence */
+#define MOBDB_FLAGS_SET_REGULAR(flags, value) \
+  ((flags) = (value) ? ((flags) | 0x2000) : ((flags) & 0xDFFF))
+
+/* Size of the elements of the offset array of a temporal value: values
+ * in the original format keep 64-bit offsets, including those of the
+ * bounding box and of the trajectory that follow the data, values in the
+ * current format, marked by the version flag, keep 32-bit offsets */
+#define TEMPORAL_OFFSET_SIZE(flags) \
+  (MOBDB_FLAGS_GET_VERSION(flags) ? sizeof(uint32) : sizeof(size_t))
+
+/* Size of a temporal instant value whose base type is passed by value,
+ * the struct is already double padded since it ends with a timestamp.
+ * The instants of instant sets and sequences of these types keep their
+ * header, which repeats the duration, the flags, and the base type of the
+ * value, since the accessors return pointers to TInstant; only the offset
+ * array is omitted */
+#define TINSTANT_BYVAL_SIZE     (sizeof(TInstant) + sizeof(Datum))
+
+/* Flags describing the value independently of its physical representation */
+#define MOBDB_FLAGS_LOGICAL(flags)     ((flags) & 0x3D)
 
 /*****************************************************************************
  * Macros for GiST indexes
@@ -189,11 +275,19 @@ struct tduration_struct
 #define FLOAT8_MAX(a,b)  (FLOAT8_GT(a, b) ? (a) : (b))
 #define FLOAT8_MIN(a,b)  (FLOAT8_LT(a, b) ? (a) : (b))
 
+/* Inline minimum and maximum for values that cannot be NaN, such as the
+ * timestamps or the coordinates of the boxes verified with isnan, which are
+ * compiled into branch-free instructions */
+#define FAST_MAX(a,b)  ((a) > (b) ? (a) : (b))
+#define FAST_MIN(a,b)  ((a) < (b) ? (a) : (b))
+
 /*****************************************************************************
  * Additional operator strategy numbers used in the GiST and SP-GiST temporal
  * opclasses with respect to those defined in the file stratnum.h
  *****************************************************************************/
 
+#define RTFrechetStrategyNumber       26    /* for <~> */
+#define RTDynTimeWarpStrategyNumber   27    /* for <~~> */
 #define RTOverBeforeStrategyNumber    28    /* for &<# */
 #define RTBeforeStrategyNumber        29    /* for <<# */
 #define RTAfterStrategyNumber         30    /* for #>> */
@@ -243,7 +337,7 @@ typedef struct
   int16    flags;          /**< flags */
   Oid     valuetypid;      /**< base type's OID (4 bytes) */
   int32     count;         /**< number of TInstant elements */
-  size_t    offsets[1];    /**< beginning of variable-length data */
+  /* variable-length data follows */
 } TInstantSet;
 
 /**
@@ -257,7 +351,7 @@ typedef struct
   Oid     valuetypid;      /**< base type's OID (4 bytes) */
   int32     count;         /**< number of TInstant elements */
   Period     period;       /**< time span (24 bytes) */
-  size_t    offsets[1];    /**< beginning of variable-length data */
+  /* variable-length data follows */
 } TSequence;
 
 /**
@@ -271,7 +365,7 @@ typedef struct
   Oid         valuetypid;     /**< base type's OID (4 bytes) */
   int32       count;          /**< number of TSequence elements */
   int32       totalcount;     /**< total number of TInstant elements in all TSequence elements */
-  size_t      offsets[1];     /**< beginning of variable-length data */
+  /* variable-length data follows */
 } TSequenceSet;
 
 /**
@@ -367,13 +461,24 @@ typedef struct
 
 /* Temporal types */
 
-#define DatumGetTemporal(X)      ((Temporal *) PG_DETOAST_DATUM(X))
+/* Values in packed format are unpacked when fetching them, the functions
+ * that read the arrays of a packed value call temporal_detoast instead */
+#define DatumGetTemporal(X)      (temporal_unpack(temporal_detoast(X)))
 #define DatumGetTInstant(X)    ((TInstant *) PG_DETOAST_DATUM(X))
 #define DatumGetTInstantSet(X)    ((TInstantSet *) PG_DETOAST_DATUM(X))
 #define DatumGetTSequence(X)    ((TSequence *) PG_DETOAST_DATUM(X))
 #define DatumGetTSequenceSet(X)    ((TSequenceSet *) PG_DETOAST_DATUM(X))
 
-#define PG_GETARG_TEMPORAL(i)    ((Temporal *) PG_GETARG_VARLENA_P(i))
+#define PG_GETARG_TEMPORAL(i)    (temporal_unpack(temporal_detoast(PG_GETARG_DATUM(i))))
+
+/* Functions on temporal values that leave their argument unchanged return
+ * the argument itself rather than a copy of it, which must then not be
+ * freed by the caller */
+#define PG_FREE_IF_COPY_NOT_RESULT(ptr, result, n) \
+  do { \
+    if ((Pointer) (ptr) != (Pointer) (result)) \
+      PG_FREE_IF_COPY(ptr, n); \
+  } while (0)
 
 #define PG_GETARG_ANYDATUM(i) (get_typlen(get_fn_expr_argtype(fcinfo->flinfo, i)) == -1 ? \
   PointerGetDatum(PG_GETARG_VARLENA_P(i)) : PG_GETARG_DATUM(i))
@@ -412,6 +517,10 @@ extern TInstant *tsequenceset_find_timestamp_excl(const TSequenceSet *ts, Timest
 extern TInstant *tsequence_find_timestamp_excl(const TSequence *seq, TimestampTz t);
 
 extern Temporal *temporal_copy(const Temporal *temp);
+extern Temporal *temporal_unpack(Temporal *temp);
+extern Temporal *temporal_detoast(Datum value);
+extern int temporal_probe_count(const Temporal *temp);
+extern int64 temporal_probe_size(const Temporal *temp);
 extern Temporal *pg_getarg_temporal(const Temporal *temp);
 extern bool intersection_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
   TIntersection mode, Temporal **inter1, Temporal **inter2);
@@ -432,8 +541,13 @@ extern Oid base_oid_from_temporal(Oid type);
 
 /* Trajectory functions */
 
+extern bool precompute_trajectory;
 extern bool type_has_precomputed_trajectory(Oid type);
 
+/* Binary format */
+
+extern int binary_format;
+
 /* Parameter tests */
 
 extern bool talpha_base_type(Oid type);
@@ -479,6 +593,9 @@ extern Datum temporal_send(PG_FUNCTION_ARGS);
 extern Datum temporal_recv(PG_FUNCTION_ARGS);
 extern Temporal* temporal_read(StringInfo buf, Oid valuetypid);
 extern void temporal_write(Temporal* temp, StringInfo buf);
+extern Temporal *temporal_read_compact(StringInfo buf, int16 duration,
+  Oid valuetypid);
+extern void temporal_write_compact(const Temporal *temp, StringInfo buf);
 
 /* Constructor functions */
 
@@ -500,6 +617,7 @@ extern Temporal *tint_to_tfloat_internal(Temporal *temp);
 extern Datum temporal_duration(PG_FUNCTION_ARGS);
 extern Datum temporal_interpolation(PG_FUNCTION_ARGS);
 extern Datum temporal_mem_size(PG_FUNCTION_ARGS);
+extern Datum temporal_mem_breakdown(PG_FUNCTION_ARGS);
 extern Datum temporal_get_values(PG_FUNCTION_ARGS);
 extern Datum temporal_get_time(PG_FUNCTION_ARGS);
 extern Datum tinstant_get_value(PG_FUNCTION_ARGS);
@@ -566,6 +684,7 @@ extern Datum temporal_minus_max(PG_FUNCTION_ARGS);
 extern Datum temporal_at_timestamp(PG_FUNCTION_ARGS);
 extern Datum temporal_minus_timestamp(PG_FUNCTION_ARGS);
 extern Datum temporal_value_at_timestamp(PG_FUNCTION_ARGS);
+extern Datum temporal_values_at_timestamps(PG_FUNCTION_ARGS);
 extern Datum temporal_at_timestampset(PG_FUNCTION_ARGS);
 extern Datum temporal_minus_timestampset(PG_FUNCTION_ARGS);
 extern Datum temporal_at_period(PG_FUNCTION_ARGS);
@@ -577,6 +696,8 @@ extern Datum temporal_intersects_timestampset(PG_FUNCTION_ARGS);
 extern Datum temporal_intersects_period(PG_FUNCTION_ARGS);
 extern Datum temporal_intersects_periodset(PG_FUNCTION_ARGS);
 
+extern bool temporal_value_at_timestamp_internal(const Temporal *temp,
+  TimestampTz t, Datum *value);
 extern bool temporal_value_at_timestamp_inc(const Temporal *temp,
   TimestampTz t, Datum *value);
 
@@ -606,6 +727,11 @@ extern char *temporal_to_string(const Temporal *temp,
   char *(*value_out)(Oid, Datum));
 extern void *temporal_bbox_ptr(const Temporal *temp);
 extern void temporal_bbox(void *box, const Temporal *temp);
+extern void temporal_bbox_slice(void *box, Datum tempdatum);
+extern void temporal_period_slice(Period *p, Datum tempdatum);
+extern size_t temporal_offset_get(const void *offsets, int16 flags, int index);
+extern void temporal_offset_set(void *offsets, int16 flags, int index,
+  size_t value);
 
 /* Comparison functions */
 
@@ -618,6 +744,11 @@ extern Datum temporal_cmp(PG_FUNCTION_ARGS);
 extern Datum temporal_hash(PG_FUNCTION_ARGS);
 
 extern uint32 temporal_hash_internal(const Temporal *temp);
+#if MOBDB_PGSQL_VERSION >= 110000
+extern Datum temporal_hash_extended(PG_FUNCTION_ARGS);
+extern uint64 temporal_hash_extended_internal(const Temporal *temp,
+  uint64 seed);
+#endif
 
 /*****************************************************************************/
 
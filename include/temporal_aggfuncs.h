@@ -15,6 +15,7 @@
 
 #include <postgres.h>
 #include <catalog/pg_type.h>
+#include <storage/buffile.h>
 #include "temporal.h"
 
 /*****************************************************************************/
@@ -22,37 +23,186 @@
 /* SkipList - Internal type for computing aggregates */
 
 #define SKIPLIST_MAXLEVEL 32   // maximum possible is 47 with current RNG
-#define SKIPLIST_INITIAL_CAPACITY 1024
-#define SKIPLIST_GROW 2
-#define SKIPLIST_INITIAL_FREELIST 32
+#define SKIPLIST_BLOCK_INITIAL_SIZE 1024
+#define SKIPLIST_BLOCK_MAX_SIZE 65536
+#define SKIPLIST_INITIAL_PENDING 8
+#define SKIPLIST_MIN_PENDING 256
 
 /**
  * Structure to represent elements in the skiplists
+ *
+ * The elements only have as many forward pointers as their height, which
+ * is 2 on average, and are carved out of blocks allocated in the aggregate
+ * memory context. The blocks start small and double in size up to a maximum
+ * so that the many states of a hash aggregation stay small.
  */
-typedef struct
+typedef struct SkipListElem
 {
   Temporal *value;
   int height;
-  int next[SKIPLIST_MAXLEVEL];
+  struct SkipListElem *next[FLEXIBLE_ARRAY_MEMBER];
 } Elem;
 
+/**
+ * Size of an element of the skiplists with the given height
+ */
+#define SKIPLIST_ELEM_SIZE(height) \
+  MAXALIGN(offsetof(Elem, next) + sizeof(Elem *) * (height))
+
+/**
+ * Structure to represent a partition of a skiplist spilled to a temporary
+ * file, which keeps the values of the skiplist during a time range
+ */
+typedef struct
+{
+  BufFile *file;
+  size_t size;          /**< Number of bytes written in the file */
+  int fileno;           /**< Position of the end of the file */
+  off_t offset;
+  TimestampTz lower;    /**< Time span of the values written in the file */
+  TimestampTz upper;
+} SkipListPart;
+
+/**
+ * Structure to represent the partitions of a spilled skiplist, where the
+ * partition i keeps the values during [bounds[i - 1], bounds[i])
+ */
+typedef struct
+{
+  int count;
+  TimestampTz *bounds;  /**< Bounds between the partitions */
+  SkipListPart *parts;
+  Temporal *sample;     /**< Value used for checking the new values */
+} SkipListSpill;
+
+#define SKIPLIST_SPILL_PARTITIONS 16
+#define SKIPLIST_SPILL_MAX_PARTITIONS 256
+
 /**
  * Structure to represent skiplists that keep the current state of an aggregation
+ *
+ * The values added by the transition functions are not spliced into the
+ * skiplist one at a time but kept in a buffer of pending values until
+ * their size exceeds work_mem, until their number exceeds both the length
+ * of the skiplist and SKIPLIST_MIN_PENDING, or until the state is read,
+ * so that the buffer does not outgrow small states. The pending
+ * values are then sorted and aggregated together, and the result is
+ * spliced into the skiplist at once. When the skiplist exceeds work_mem,
+ * its values are spilled to temporary files partitioned by time, to which
+ * the following pending values are appended.
  */
 typedef struct
 {
-  int capacity;
-  int next;
   int length;
-  int *freed;
-  int freecount;
-  int freecap;
-  int tail;
+  Elem *head;
+  Elem *tail;
+  char *block;          /**< Free space of the current block of elements */
+  size_t blockfree;     /**< Number of free bytes in the current block */
+  size_t blocksize;     /**< Size of the current block */
+  Elem *freed[SKIPLIST_MAXLEVEL]; /**< Freed elements for each height */
+  Temporal **pending;   /**< Values not yet spliced into the skiplist */
+  int pendingcount;
+  int pendingcap;
+  size_t pendingsize;   /**< Total size in bytes of the pending values */
+  Datum (*func)(Datum, Datum); /**< Aggregate function of the pending values */
+  bool crossings;       /**< Crossings of the pending values */
+  SkipListSpill *spill; /**< Partitions when the skiplist is spilled */
+  MemoryContextCallback *spillcb; /**< Callback closing the temporary files
+                        of the partitions when the aggregate context is reset */
+  Datum (*prune)(Datum, bool *); /**< Function of the moving aggregates
+                        stating the values kept when the list is flushed */
   void *extra;
   size_t extrasize;
-  Elem *elems;
 } SkipList;
 
+/* AppendState - Internal type for appending instants in an aggregation */
+
+#define APPENDSTATE_INITIAL_CAPACITY 64
+#define APPENDSTATE_GROW 2
+
+/**
+ * Structure to keep the instants appended by an aggregation, which reserves
+ * slack capacity so that each instant is appended in amortized constant time
+ */
+typedef struct
+{
+  int capacity;
+  int count;
+  TInstant **instants;
+} AppendState;
+
+/* BucketState - Internal type for bucketed aggregations */
+
+#define BUCKETSTATE_INITIAL_CAPACITY 64
+
+/**
+ * Structure to accumulate the contributions of the values to a bucket
+ */
+typedef struct
+{
+  int count;          /**< Number of values intersecting the bucket */
+  int instants;       /**< Number of instantaneous contributions */
+  double sum;         /**< Sum of the values of the instantaneous contributions */
+  double integral;    /**< Integral of the values over the bucket */
+  double duration;    /**< Duration in microseconds of the values in the bucket */
+} BucketAcc;
+
+/**
+ * Structure to keep a dense array of accumulators for the consecutive 
+ * buckets covered by the values of a bucketed aggregation, whose size 
+ * only depends on the time span of the values and not on their number
+ */
+typedef struct
+{
+  int64 size;         /**< Size of the buckets in microseconds */
+  TimestampTz origin; /**< Origin of the buckets, normalized to [0, size) */
+  int64 first;        /**< Index of the first bucket of the array */
+  int count;          /**< Number of buckets in the array */
+  int capacity;
+  BucketAcc *buckets;
+} BucketState;
+
+/* PeriodUnionState - Internal type for the union of periods */
+
+#define PERIODUNION_INITIAL_CAPACITY 64
+
+/**
+ * Structure to buffer the periods of a union, which are sorted and
+ * coalesced when the buffer is full and when the result is computed
+ */
+typedef struct
+{
+  int count;          /**< Number of periods in the buffer */
+  int capacity;
+  bool normalized;    /**< The periods are sorted and disjoint */
+  Period *periods;
+} PeriodUnionState;
+
+/* HllState - Internal type for approximate distinct counts */
+
+#define HLLSTATE_INITIAL_CAPACITY 16
+
+/* Number of bits of the hashes selecting the register of a sketch, which
+ * gives a standard error of 1.04 / sqrt(HLL_REGISTERS), about 3% */
+#define HLL_PRECISION 10
+#define HLL_REGISTERS (1 << HLL_PRECISION)
+
+/**
+ * Structure to keep a dense array of HyperLogLog sketches for the
+ * consecutive buckets covered by the values of an approximate distinct
+ * count, whose size only depends on the time span of the values and not on
+ * their number
+ */
+typedef struct
+{
+  int64 size;         /**< Size of the buckets in microseconds */
+  TimestampTz origin; /**< Origin of the buckets, normalized to [0, size) */
+  int64 first;        /**< Index of the first bucket of the array */
+  int count;          /**< Number of buckets in the array */
+  int capacity;
+  uint8 *registers;   /**< HLL_REGISTERS registers per bucket */
+} HllState;
+
 /*****************************************************************************/
 
 extern Datum datum_min_int32(Datum l, Datum r);
@@ -67,15 +217,29 @@ extern Datum datum_sum_double2(Datum l, Datum r);
 extern Datum datum_sum_double3(Datum l, Datum r);
 extern Datum datum_sum_double4(Datum l, Datum r);
 
+extern MemoryContext set_aggregation_context(FunctionCallInfo fcinfo);
+extern void unset_aggregation_context(MemoryContext ctx);
+
 extern Temporal *skiplist_headval(SkipList *list);
 extern Temporal **skiplist_values(SkipList *list);
 extern SkipList *skiplist_make(FunctionCallInfo fcinfo, Temporal **values, 
   int count);
 extern void skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, 
   Temporal **values, int count, Datum (*func)(Datum, Datum), bool crossings);
+extern void skiplist_add(FunctionCallInfo fcinfo, SkipList *list,
+  Temporal **values, int count, Datum (*func)(Datum, Datum), bool crossings);
+extern void skiplist_flush(FunctionCallInfo fcinfo, SkipList *list);
+extern void skiplist_prune(FunctionCallInfo fcinfo, SkipList *list);
+extern void skiplist_unspill(FunctionCallInfo fcinfo, SkipList *list);
+extern Temporal *skiplist_finalize(FunctionCallInfo fcinfo, SkipList *list,
+  Temporal *(*func)(Temporal **, int, void *), void *arg);
+extern void *aggstate_box_alloc(FunctionCallInfo fcinfo, size_t size);
 extern void aggstate_set_extra(FunctionCallInfo fcinfo, SkipList *state, 
   void *data, size_t size);
 
+extern TSequence **tsequence_tagg(TSequence **sequences1, int count1,
+  TSequence **sequences2, int count2, Datum (*func)(Datum, Datum),
+  bool crossings, int *newcount);
 extern SkipList *tsequence_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
   TSequence *seq, Datum (*func)(Datum, Datum), bool interpoint);
 extern SkipList *temporal_tagg_combinefn1(FunctionCallInfo fcinfo, SkipList *state1,
@@ -106,15 +270,49 @@ extern Datum tfloat_tsum_transfn(PG_FUNCTION_ARGS);
 extern Datum tfloat_tsum_combinefn(PG_FUNCTION_ARGS);
 extern Datum temporal_tcount_transfn(PG_FUNCTION_ARGS);
 extern Datum temporal_tcount_combinefn(PG_FUNCTION_ARGS);
+extern Datum temporal_tcount_invfn(PG_FUNCTION_ARGS);
 extern Datum tnumber_tavg_transfn(PG_FUNCTION_ARGS);
 extern Datum tnumber_tavg_combinefn(PG_FUNCTION_ARGS);
 extern Datum temporal_tagg_finalfn(PG_FUNCTION_ARGS);
 extern Datum tnumber_tavg_finalfn(PG_FUNCTION_ARGS);
+extern Datum tnumber_tavg_invfn(PG_FUNCTION_ARGS);
+extern Datum temporal_tcount_mfinalfn(PG_FUNCTION_ARGS);
+extern Datum tint_tsum_mfinalfn(PG_FUNCTION_ARGS);
+extern Datum tnumber_tavg_mfinalfn(PG_FUNCTION_ARGS);
 extern Datum ttext_tmin_transfn(PG_FUNCTION_ARGS);
 extern Datum ttext_tmin_combinefn(PG_FUNCTION_ARGS);
 extern Datum ttext_tmax_transfn(PG_FUNCTION_ARGS);
 extern Datum ttext_tmax_combinefn(PG_FUNCTION_ARGS);
 
+extern void appendstate_init(AppendState *state);
+extern bool appendstate_has_last(const AppendState *state,
+  const TInstant *inst);
+extern void appendstate_append(AppendState *state, const TInstant *inst);
+
+extern Datum temporal_append_tinstant_transfn(PG_FUNCTION_ARGS);
+extern Datum temporal_append_finalfn(PG_FUNCTION_ARGS);
+
+extern Datum temporal_tcount_bucket_transfn(PG_FUNCTION_ARGS);
+extern Datum tnumber_tavg_bucket_transfn(PG_FUNCTION_ARGS);
+extern Datum temporal_bucket_combinefn(PG_FUNCTION_ARGS);
+extern Datum temporal_bucket_serialize(PG_FUNCTION_ARGS);
+extern Datum temporal_bucket_deserialize(PG_FUNCTION_ARGS);
+extern Datum temporal_tcount_bucket_finalfn(PG_FUNCTION_ARGS);
+extern Datum tnumber_tavg_bucket_finalfn(PG_FUNCTION_ARGS);
+extern Datum period_union_transfn(PG_FUNCTION_ARGS);
+extern Datum periodset_union_transfn(PG_FUNCTION_ARGS);
+extern Datum period_union_combinefn(PG_FUNCTION_ARGS);
+extern Datum period_union_serialize(PG_FUNCTION_ARGS);
+extern Datum period_union_deserialize(PG_FUNCTION_ARGS);
+extern Datum period_union_finalfn(PG_FUNCTION_ARGS);
+extern Datum temporal_tcount_approx_transfn(PG_FUNCTION_ARGS);
+extern Datum temporal_tcount_approx_combinefn(PG_FUNCTION_ARGS);
+extern Datum temporal_tcount_approx_serialize(PG_FUNCTION_ARGS);
+extern Datum temporal_tcount_approx_deserialize(PG_FUNCTION_ARGS);
+extern Datum temporal_tcount_approx_finalfn(PG_FUNCTION_ARGS);
+extern Datum temporal_tsample(PG_FUNCTION_ARGS);
+extern Datum tnumber_tprecision(PG_FUNCTION_ARGS);
+
 /*****************************************************************************/
 
 #endif
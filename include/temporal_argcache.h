@@ -0,0 +1,94 @@
+/*****************************************************************************
+ *
+ * temporal_argcache.h
+ *    Cache of the arguments of a function that are the same across calls.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_ARGCACHE_H__
+#define __TEMPORAL_ARGCACHE_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+
+#include "temporal.h"
+
+/*****************************************************************************
+ * Struct definitions for the cache
+ *****************************************************************************/
+
+/**
+ * Maximum number of arguments of a function that can be cached
+ */
+#define ARGCACHE_MAX_ARGS  2
+
+/**
+ * Number of bytes at the start of an argument whose hash is compared before
+ * the argument itself
+ */
+#define ARGCACHE_HASH_BYTES  64
+
+/**
+ * Structure to represent a cached argument
+ *
+ * The size of the argument as received by the function and the hash of its
+ * first bytes are kept to recognize it in the next call. The argument is
+ * only copied and detoasted when they match the ones of the previous call,
+ * so that arguments that change in every call are neither copied nor
+ * compared in full.
+ */
+typedef struct
+{
+  Size        size;           /**< size of the argument of the last call */
+  uint32      hash;           /**< hash of the first bytes of the argument */
+  struct varlena *raw;        /**< argument as received by the function, or
+                                   NULL when it has been received once */
+  Datum       value;          /**< detoasted argument or 0 */
+  Datum       traj;           /**< trajectory of a temporal point or 0 */
+  void       *aux;            /**< search structure of the argument or NULL */
+  void      (*aux_free)(void *); /**< function freeing the search structure,
+                                      or NULL when it is freed with pfree */
+  int         loc;            /**< location of the last timestamp found */
+} ArgCacheEntry;
+
+/**
+ * Structure to cache in the fn_extra field the arguments of a function
+ */
+typedef struct
+{
+  ArgCacheEntry args[ARGCACHE_MAX_ARGS];
+  FmgrInfo   *flinfo;         /**< FmgrInfo to call PostGIS functions or NULL */
+} ArgCache;
+
+/**
+ * Frees the argument if it is a copy and it does not belong to the cache
+ */
+#define ARGCACHE_FREE_IF_COPY(ptr, n, entry) \
+  do { \
+    if ((entry) == NULL) \
+      PG_FREE_IF_COPY(ptr, n); \
+  } while (0)
+
+/*****************************************************************************/
+
+extern ArgCacheEntry *argcache_temporal(FunctionCallInfo fcinfo, int argno);
+extern ArgCacheEntry *argcache_gserialized(FunctionCallInfo fcinfo,
+  int argno);
+extern ArgCacheEntry *argcache_periodset(FunctionCallInfo fcinfo,
+  int argno);
+extern Datum argcache_tpoint_trajectory(FunctionCallInfo fcinfo,
+  ArgCacheEntry *entry);
+extern void *argcache_geog_circ_tree(FunctionCallInfo fcinfo,
+  ArgCacheEntry *entry);
+extern FmgrInfo *argcache_flinfo(FunctionCallInfo fcinfo);
+extern Temporal *rowcache_tpoint(FunctionCallInfo fcinfo, int argno,
+  Datum *traj);
+
+/*****************************************************************************/
+
+#endif
@@ -109,4 +109,29 @@ extern Datum boxop_tnumber_tnumber(FunctionCallInfo fcinfo,
 
 /*****************************************************************************/
 
+/*****************************************************************************
+ * Inlinable predicates, see timeops.h
+ *****************************************************************************/
+
+/**
+ * Returns true if the temporal boxes overlap (inlinable function). The
+ * function raising the error is only called when the boxes have no common
+ * dimension.
+ */
+static inline bool
+overlaps_tbox_tbox_inline(const TBOX *box1, const TBOX *box2)
+{
+  bool hasx = MOBDB_FLAGS_GET_X(box1->flags) && MOBDB_FLAGS_GET_X(box2->flags);
+  bool hast = MOBDB_FLAGS_GET_T(box1->flags) && MOBDB_FLAGS_GET_T(box2->flags);
+  if (! hasx && ! hast)
+    ensure_common_dimension_tbox(box1, box2);
+  if (hasx && (box1->xmax < box2->xmin || box1->xmin > box2->xmax))
+    return false;
+  if (hast && (box1->tmax < box2->tmin || box1->tmin > box2->tmax))
+    return false;
+  return true;
+}
+
+/*****************************************************************************/
+
 #endif
@@ -0,0 +1,55 @@
+/*****************************************************************************
+ *
+ * temporal_datagen.h
+ *    Generators of random temporal values for load and index testing.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_DATAGEN_H__
+#define __TEMPORAL_DATAGEN_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+#include <utils/timestamp.h>
+
+#include "timetypes.h"
+#include "temporal.h"
+
+/*****************************************************************************/
+
+/**
+ * State of the generators, which is kept across the calls of the
+ * set-returning functions
+ */
+typedef struct
+{
+  uint64 rng;              /**< State of the pseudo-random generator */
+  int length;              /**< Number of instants of the values */
+  int64 step;              /**< Interval between two consecutive instants */
+  TimestampTz lower;       /**< First possible start of the values */
+  int64 span;              /**< Number of possible starts of the values */
+  TInstant **instants;     /**< Instants of the value being generated */
+  void *extra;             /**< Parameters specific to the base type */
+} DatagenState;
+
+extern double datagen_random(uint64 *rng);
+extern double datagen_gaussian(uint64 *rng);
+extern DatagenState *datagen_init(int32 count, int32 length,
+  const Period *p, const Interval *interval, int32 seed);
+extern TimestampTz datagen_start(DatagenState *state);
+extern Temporal *datagen_result(DatagenState *state, bool linear);
+
+extern Datum generate_tints(PG_FUNCTION_ARGS);
+extern Datum generate_tfloats(PG_FUNCTION_ARGS);
+extern Datum generate_ttexts(PG_FUNCTION_ARGS);
+
+extern Datum datagen_from_storage(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
@@ -0,0 +1,65 @@
+/*****************************************************************************
+ *
+ * temporal_expanded.h
+ *    Expanded representation of temporal sequences.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_EXPANDED_H__
+#define __TEMPORAL_EXPANDED_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include <utils/expandeddatum.h>
+
+#include "temporal.h"
+
+/*****************************************************************************
+ * Struct definition for the expanded representation
+ *****************************************************************************/
+
+/**
+ * Magic number identifying expanded temporal values, for debugging
+ */
+#define EXPANDED_TEMPORAL_MAGIC  0x54534551
+
+/**
+ * Structure to represent temporal sequences in expanded format
+ *
+ * The sequence is kept as an array of pointers to its instants with slack
+ * capacity for the instants to be appended. The instants point either to
+ * the flat value that has been expanded or to copies allocated in the
+ * memory context of the object. The flat representation of the current
+ * value is only computed when the value is stored and is cached until the
+ * next modification.
+ */
+typedef struct
+{
+  ExpandedObjectHeader hdr;   /**< standard header of expanded objects */
+  int         magic;          /**< EXPANDED_TEMPORAL_MAGIC */
+  Oid         valuetypid;     /**< base type's OID */
+  bool        lower_inc;      /**< lower bound is inclusive */
+  bool        upper_inc;      /**< upper bound is inclusive */
+  bool        linear;         /**< linear interpolation */
+  int         count;          /**< number of instants */
+  int         capacity;       /**< number of allocated instant pointers */
+  TInstant  **instants;       /**< instants of the sequence */
+  TSequence  *fvalue;         /**< flat value that has been expanded */
+  TSequence  *fcache;         /**< flat value of the current state or NULL */
+} ExpandedTemporal;
+
+/*****************************************************************************/
+
+extern Datum temporal_expand(Datum tempdatum, MemoryContext parentcontext);
+extern ExpandedTemporal *DatumGetExpandedTemporalRW(Datum d);
+extern bool expanded_tsequence_append_tinstant(ExpandedTemporal *et,
+  const TInstant *inst);
+
+/*****************************************************************************/
+
+#endif
@@ -0,0 +1,92 @@
+/*****************************************************************************
+ *
+ * temporal_packed.h
+ *    Packed (columnar) storage format for temporal types.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_PACKED_H__
+#define __TEMPORAL_PACKED_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+
+#include "temporal.h"
+
+/*****************************************************************************
+ * Struct definitions for the packed format
+ *****************************************************************************/
+
+/**
+ * Number of instants between two entries of the sample index of the
+ * timestamps in packed format
+ */
+#define PACK_TIME_SAMPLE  32
+
+/**
+ * Structure to represent temporal values in packed format
+ *
+ * The fixed-size header is compatible with the one of the other temporal
+ * types so that the duration and the flags can be read without knowing
+ * whether the value is packed. The bounding box and the arrays storing the
+ * components of the instants follow the header.
+ */
+typedef struct
+{
+  int32       vl_len_;        /**< varlena header (do not touch directly!) */
+  TDuration   duration;       /**< duration */
+  int16       flags;          /**< flags */
+  Oid         valuetypid;     /**< base type's OID (4 bytes) */
+  int32       count;          /**< number of instants */
+  int32       deltasize;      /**< size of the encoded timestamps */
+  Period      period;         /**< time span (24 bytes) */
+  /* variable-length data follows */
+} TemporalPacked;
+
+/**
+ * Structure to represent an entry of the sample index of the timestamps
+ */
+typedef struct
+{
+  TimestampTz t;              /**< timestamp of the sampled instant */
+  int32       pos;            /**< position of the next encoded delta */
+} TimeSample;
+
+/**
+ * Structure to represent the scale and the origin of the quantized
+ * coordinates of a packed temporal point, which are stored as int32
+ * multiples of the scale from the origin
+ */
+typedef struct
+{
+  double      scale;          /**< scale of the coordinates */
+  double      origin[3];      /**< origin of the x, y, and z coordinates */
+} PackQuant;
+
+/*****************************************************************************/
+
+extern bool temporal_packable(const Temporal *temp);
+extern Temporal *temporal_pack_internal(const Temporal *temp, double scale,
+  bool shuffle);
+extern STBOX *tpointpk_bbox_ptr(const TemporalPacked *ptemp);
+extern int temporalpk_find_timestamp(const TemporalPacked *ptemp,
+  TimestampTz t);
+extern bool temporalpk_value_at_timestamp(const TemporalPacked *ptemp,
+  TimestampTz t, Datum *result);
+extern TimestampTz temporalpk_timestamp_n(const TemporalPacked *ptemp, int n);
+extern Temporal *temporalpk_at_period(const TemporalPacked *ptemp,
+  const Period *p);
+extern ArrayType *temporalpk_timestamps(const TemporalPacked *ptemp);
+extern Datum tpointpk_trajectory(const TemporalPacked *ptemp);
+
+extern Datum temporal_pack(PG_FUNCTION_ARGS);
+extern Datum temporal_pack_shuffle(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
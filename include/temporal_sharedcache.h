@@ -0,0 +1,49 @@
+/*****************************************************************************
+ *
+ * temporal_sharedcache.h
+ *    Cache of detoasted temporal values shared by all the backends.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_SHAREDCACHE_H__
+#define __TEMPORAL_SHAREDCACHE_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+
+/*****************************************************************************/
+
+/**
+ * Number of slots of the cache in which a value can be kept
+ */
+#define SHARED_CACHE_WAYS  8
+
+/**
+ * Number of locks serializing the writers of the sets of slots
+ */
+#define SHARED_CACHE_LOCKS  16
+
+/**
+ * Number of epoch counters of the TOAST tables
+ */
+#define SHARED_CACHE_EPOCHS  256
+
+extern int shared_cache_size;
+extern int shared_cache_entry_size;
+extern bool enable_shared_cache;
+
+extern void shared_cache_init(void);
+extern struct varlena *shared_cache_get(const struct varlena *ptr);
+extern void shared_cache_put(const struct varlena *ptr,
+  const struct varlena *value);
+
+extern Datum mobilitydb_shared_cache_reset(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
@@ -0,0 +1,41 @@
+/*****************************************************************************
+ *
+ * temporal_support.h
+ *    Fused evaluation of chained temporal functions.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_SUPPORT_H__
+#define __TEMPORAL_SUPPORT_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+
+#include "temporal.h"
+#include "oidcache.h"
+
+/*****************************************************************************/
+
+extern Temporal *tnumber_at_tcomp_internal(const Temporal *temp, Datum value,
+  CachedOp op, bool atvalue);
+
+extern Datum tnumber_at_tlt(PG_FUNCTION_ARGS);
+extern Datum tnumber_at_tle(PG_FUNCTION_ARGS);
+extern Datum tnumber_at_tgt(PG_FUNCTION_ARGS);
+extern Datum tnumber_at_tge(PG_FUNCTION_ARGS);
+
+#if MOBDB_PGSQL_VERSION >= 120000
+extern Datum tnumber_twavg_support(PG_FUNCTION_ARGS);
+extern Datum tbool_at_value_support(PG_FUNCTION_ARGS);
+extern Datum temporal_intersects_timestamp_support(PG_FUNCTION_ARGS);
+extern Datum temporal_overlaps_support(PG_FUNCTION_ARGS);
+#endif
+
+/*****************************************************************************/
+
+#endif
@@ -26,6 +26,12 @@
 
 /*****************************************************************************/
 
+/**
+ * Number of positions of a search in an array of timestamps that are
+ * interpolated before falling back to a binary search
+ */
+#define INTERPOLATION_MAX_PROBES  3
+
 /* Miscellaneous functions */
 
 extern void _PG_init(void);
@@ -34,11 +40,16 @@ extern bool get_typbyval_fast(Oid type);
 extern int get_typlen_fast(Oid type);
 extern Datum datum_copy(Datum value, Oid type);
 extern double datum_double(Datum d, Oid valuetypid);
+extern int interpolation_probe(int first, int last, TimestampTz t1,
+  TimestampTz t2, TimestampTz t);
 
 /* PostgreSQL call helpers */
 
 extern Datum call_input(Oid type, char *str);
 extern char *call_output(Oid type, Datum value);
+extern int timestamp_iso_write(char *str, TimestampTz t, char sep);
+extern char *timestamp_output(TimestampTz t);
+extern char *float8_output(double d);
 extern bytea *call_send(Oid type, Datum value);
 extern Datum call_recv(Oid type, StringInfo buf);
 extern Datum call_function1(PGFunction func, Datum arg1);
@@ -89,9 +100,17 @@ extern int datumarr_remove_duplicates(Datum *values, int count,
 extern int timestamparr_remove_duplicates(TimestampTz *values, int count);
 extern int tinstantarr_remove_duplicates(TInstant **instants, int count);
 
+/* Search functions */
+
+extern int datumarr_lower_bound(const Datum *values, int count, Datum value,
+  Oid valuetypid);
+extern bool datumarr_contains(const Datum *values, int count, Datum value,
+  Oid valuetypid);
+
 /* Text functions */
 
 extern int text_cmp(text *arg1, text *arg2, Oid collid);
+extern bool text_eq(text *arg1, text *arg2);
 
 /* Comparison functions on datums */
 
@@ -121,6 +140,12 @@ extern Datum datum2_ge2(Datum l, Datum r, Oid typel, Oid typer);
 extern double hypot3d(double x, double y, double z);
 extern double hypot4d(double x, double y, double z, double m);
 
+/* Z-order functions */
+
+extern uint64 double_zorder_key(double d);
+extern uint64 timestamp_zorder_key(TimestampTz t);
+extern int zorder_cmp(const uint64 *keys1, const uint64 *keys2, int ndims);
+
 /*****************************************************************************/
 
 #endif
@@ -16,6 +16,50 @@
 #include <postgres.h>
 #include <fmgr.h>
 #include <catalog/pg_type.h>
+#include <utils/timestamp.h>
+
+/*****************************************************************************/
+
+/* Window aggregate operations */
+
+#define WINDOW_MIN     0
+#define WINDOW_MAX     1
+#define WINDOW_SUM     2
+#define WINDOW_COUNT   3
+#define WINDOW_AVG     4
+
+/**
+ * Structure to represent the period during which an input value is visible
+ * by the window aggregates, that is, the period of the value extended by the
+ * time interval
+ */
+typedef struct
+{
+  TimestampTz lower;
+  TimestampTz upper;
+  bool lower_inc;
+  bool upper_inc;
+  Datum value;
+} WindowPiece;
+
+/**
+ * Structure to represent the state of the sliding window over the pieces.
+ * The pieces enter and leave the window in the same order, so the pieces
+ * in the window are those in [left, right).
+ */
+typedef struct
+{
+  int op;              /**< Aggregate operation */
+  Oid valuetypid;      /**< Base type of the pieces */
+  WindowPiece *pieces; /**< Pieces of the temporal value */
+  int left;            /**< First piece in the window */
+  int right;           /**< One past the last piece in the window */
+  int *deque;          /**< Monotonic deque of pieces for min and max */
+  int dqfirst;         /**< First element of the deque */
+  int dqlast;          /**< One past the last element of the deque */
+  int64 isum;          /**< Running sum for integer values */
+  double dsum;         /**< Running sum for integer values in averages */
+} WindowState;
 
 /*****************************************************************************/
 
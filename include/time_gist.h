@@ -27,6 +27,14 @@ extern Datum period_gist_penalty(PG_FUNCTION_ARGS);
 extern Datum period_gist_picksplit(PG_FUNCTION_ARGS);
 extern Datum period_gist_same(PG_FUNCTION_ARGS);
 extern Datum period_gist_fetch(PG_FUNCTION_ARGS);
+#if MOBDB_PGSQL_VERSION >= 140000
+extern Datum period_gist_sortsupport(PG_FUNCTION_ARGS);
+#endif
+
+extern Datum period_brin_opcinfo(PG_FUNCTION_ARGS);
+extern Datum period_brin_add_value(PG_FUNCTION_ARGS);
+extern Datum period_brin_consistent(PG_FUNCTION_ARGS);
+extern Datum period_brin_union(PG_FUNCTION_ARGS);
 
 extern int common_entry_cmp(const void *i1, const void *i2);
 
@@ -325,6 +325,29 @@ extern PeriodSet *minus_periodset_timestampset_internal(const PeriodSet *ps, con
 extern PeriodSet *minus_periodset_period_internal(const PeriodSet *ps, const Period *p);
 extern PeriodSet *minus_periodset_periodset_internal(const PeriodSet *ps1, const PeriodSet *ps2);
 
+/*****************************************************************************
+ * Inlinable predicates
+ *
+ * The predicates called for every row by the bounding box operators are
+ * defined here, so that the operators do not call a function of another
+ * translation unit and can be inlined by the JIT compiler of PostgreSQL
+ * when MobilityDB is installed with its LLVM bitcode.
+ *****************************************************************************/
+
+/**
+ * Returns true if the two periods overlap (inlinable function)
+ */
+static inline bool
+overlaps_period_period_inline(const Period *p1, const Period *p2)
+{
+  return (p1->lower < p2->upper ||
+      (p1->lower == p2->upper && p1->lower_inc && p2->upper_inc)) &&
+    (p2->lower < p1->upper ||
+      (p2->lower == p1->upper && p2->lower_inc && p1->upper_inc));
+}
+
+/*****************************************************************************/
+
 #endif
 
 /*****************************************************************************/
\ No newline at end of file
@@ -19,6 +19,26 @@
 
 /*****************************************************************************/
 
+/**
+ * Timestamp sets whose average number of timestamps per run is at least this
+ * value are stored as runs of equally spaced timestamps
+ */
+#define TIMESTAMPSET_RUN_MIN_LENGTH  4
+
+/**
+ * Structure to represent a run of a timestamp set, which is an arithmetic
+ * progression of timestamps
+ */
+typedef struct
+{
+  TimestampTz start;   /**< first timestamp of the run */
+  int64       step;    /**< difference between consecutive timestamps */
+  int32       count;   /**< number of timestamps of the run */
+  int32       first;   /**< position of the first timestamp in the set */
+} TimestampRun;
+
+/*****************************************************************************/
+
 /* assorted support functions */
 
 extern TimestampTz timestampset_time_n(const TimestampSet *ts, int index);
@@ -27,6 +47,12 @@ extern TimestampSet *timestampset_make_internal(const TimestampTz *times, int co
 extern TimestampSet *timestampset_make_free(TimestampTz *times, int count);
 extern TimestampSet *timestampset_copy(const TimestampSet *ts);
 extern bool timestampset_find_timestamp(const TimestampSet *ts, TimestampTz t, int *loc);
+extern int timestampset_num_runs(const TimestampSet *ts);
+extern const TimestampRun *timestampset_run_n(const TimestampSet *ts,
+  int index);
+extern TimestampSet *timestampset_make_runs(TimestampRun *runs, int count);
+extern bool timestamprun_find_period(const TimestampRun *run, const Period *p,
+  int *first, int *last);
 
 /* Input/output functions */
 
@@ -122,6 +122,9 @@ extern bool tinstant_eq(const TInstant *inst1, const TInstant *inst2);
 /* Function for defining hash index */
 
 extern uint32 tinstant_hash(const TInstant *inst);
+#if MOBDB_PGSQL_VERSION >= 110000
+extern uint64 tinstant_hash_extended(const TInstant *inst, uint64 seed);
+#endif
 
 /*****************************************************************************/
 
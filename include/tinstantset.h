@@ -24,6 +24,7 @@
 
 extern TInstant *tinstantset_inst_n(const TInstantSet *ti, int index);
 extern bool tinstantset_find_timestamp(const TInstantSet *ti, TimestampTz t, int *pos);
+extern TInstantSet *tinstantset_make1(TInstant **instants, int count);
 extern TInstantSet *tinstantset_make(TInstant **instants, int count);
 extern TInstantSet *tinstantset_make_free(TInstant **instants, int count);
 extern TInstantSet *tinstantset_copy(const TInstantSet *ti);
@@ -139,6 +140,9 @@ extern bool tinstantset_eq(const TInstantSet *ti1, const TInstantSet *ti2);
 /* Function for defining hash index */
 
 extern uint32 tinstantset_hash(const TInstantSet *ti);
+#if MOBDB_PGSQL_VERSION >= 110000
+extern uint64 tinstantset_hash_extended(const TInstantSet *ti, uint64 seed);
+#endif
 
 /*****************************************************************************/
 
@@ -19,17 +19,45 @@
 
 /*****************************************************************************/
 
+/* Split strategies of the GiST indexes for boxes */
+#define BOX_GIST_SPLIT_DOUBLESORT  0
+#define BOX_GIST_SPLIT_RSTAR       1
+
+/* Parameters of the GiST operator classes for boxes */
+typedef struct
+{
+  int32 vl_len_;    /* varlena header (do not touch directly!) */
+  int split;        /* split strategy */
+} BoxGistOptions;
+
+/*****************************************************************************/
+
 extern Datum tbox_gist_union(PG_FUNCTION_ARGS);
 extern Datum tbox_gist_penalty(PG_FUNCTION_ARGS);
 extern Datum tbox_gist_picksplit(PG_FUNCTION_ARGS);
 extern Datum tnumber_gist_consistent(PG_FUNCTION_ARGS);
 extern Datum tnumber_gist_compress(PG_FUNCTION_ARGS);
 extern Datum tbox_gist_same(PG_FUNCTION_ARGS);
+extern Datum tbox_gist_fetch(PG_FUNCTION_ARGS);
+#if MOBDB_PGSQL_VERSION >= 130000
+extern Datum box_gist_options(PG_FUNCTION_ARGS);
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+extern Datum tbox_gist_sortsupport(PG_FUNCTION_ARGS);
+#endif
+
+extern Datum tbox_brin_opcinfo(PG_FUNCTION_ARGS);
+extern Datum tbox_brin_add_value(PG_FUNCTION_ARGS);
+extern Datum tbox_brin_consistent(PG_FUNCTION_ARGS);
+extern Datum tbox_brin_union(PG_FUNCTION_ARGS);
 
 /* The following functions are also called by tpoint_gist.c */
 extern int interval_cmp_lower(const void *i1, const void *i2);
 extern int interval_cmp_upper(const void *i1, const void *i2);
 extern float non_negative(float val);
+extern int box_gist_split_strategy(FunctionCallInfo fcinfo);
+extern void gist_rstar_split(double *bounds, int nentries, int ndims,
+  bool *left);
 
 /* The following functions are also called by tnumber_spgist.c */
 extern bool tbox_index_consistent_leaf(const TBOX *key, const TBOX *query, 
@@ -22,21 +22,21 @@
 
 extern Datum datum_round(Datum value, Datum prec);
 
-extern Datum add_base_temporal(PG_FUNCTION_ARGS);
-extern Datum add_temporal_base(PG_FUNCTION_ARGS);
-extern Datum add_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum add_base_tnumber(PG_FUNCTION_ARGS);
+extern Datum add_tnumber_base(PG_FUNCTION_ARGS);
+extern Datum add_tnumber_tnumber(PG_FUNCTION_ARGS);
 
-extern Datum sub_base_temporal(PG_FUNCTION_ARGS);
-extern Datum sub_temporal_base(PG_FUNCTION_ARGS);
-extern Datum sub_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum sub_base_tnumber(PG_FUNCTION_ARGS);
+extern Datum sub_tnumber_base(PG_FUNCTION_ARGS);
+extern Datum sub_tnumber_tnumber(PG_FUNCTION_ARGS);
 
-extern Datum mult_base_temporal(PG_FUNCTION_ARGS);
-extern Datum mult_temporal_base(PG_FUNCTION_ARGS);
-extern Datum mult_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum mult_base_tnumber(PG_FUNCTION_ARGS);
+extern Datum mult_tnumber_base(PG_FUNCTION_ARGS);
+extern Datum mult_tnumber_tnumber(PG_FUNCTION_ARGS);
 
-extern Datum div_base_temporal(PG_FUNCTION_ARGS);
-extern Datum div_temporal_base(PG_FUNCTION_ARGS);
-extern Datum div_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum div_base_tnumber(PG_FUNCTION_ARGS);
+extern Datum div_tnumber_base(PG_FUNCTION_ARGS);
+extern Datum div_tnumber_tnumber(PG_FUNCTION_ARGS);
 
 extern int int_cmp(const void *a, const void *b);
 
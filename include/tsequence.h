@@ -22,15 +22,97 @@
 
 /*****************************************************************************/
 
+/**
+ * Sequences with at least this number of instants keep a directory with the
+ * bounding box of each block of TSEQUENCE_BLOCK_SIZE consecutive segments
+ */
+#define TSEQUENCE_BLOCK_MIN_COUNT  1024
+#define TSEQUENCE_BLOCK_SIZE       128
+
+/**
+ * Sequences with at least this number of instants are marked as regular
+ * when their instants are nearly evenly spaced, their segments are then
+ * located by interpolation
+ */
+#define TSEQUENCE_REGULAR_MIN_COUNT  64
+
+/**
+ * Structure of the simplification levels of a temporal sequence point
+ *
+ * The structure is followed by the array of the number of instants of each
+ * level, by the array of the indexes of the instants, and by the array of
+ * their significance, which is the greatest tolerance for which the
+ * Douglas-Peucker algorithm keeps them. The instants are sorted by
+ * decreasing significance, so that the instants of a level are a prefix of
+ * those of the finer levels. The level `k` keeps the instants whose
+ * significance is greater than `tolerance * 2^k`.
+ */
+typedef struct
+{
+  double      tolerance;      /**< tolerance of the finest level */
+  int32       count;          /**< number of levels */
+  int32       total;          /**< number of instants of the finest level */
+} TSequenceLevels;
+
+/**
+ * Structure to construct a temporal sequence by appending its instants one
+ * at a time without allocating each of them
+ */
+typedef struct
+{
+  Oid         valuetypid;     /**< base type of the instants */
+  int         maxcount;       /**< maximum number of instants */
+  int         count;          /**< number of instants appended */
+  bool        linear;         /**< true when the interpolation is linear */
+  bool        normalize;      /**< true when redundant instants are removed */
+  bool        byval;          /**< true when the base type is passed by value */
+  int16       instflags;      /**< flags of the instants passed by value */
+  TSequence  *seq;            /**< result for base types passed by value */
+  char       *data;           /**< first instant of the result */
+  TInstant  **instants;       /**< instants for base types passed by reference */
+} TSequenceBuilder;
+
+/*****************************************************************************/
+
+extern void *tsequence_offsets_ptr(const TSequence *seq);
+extern int tsequence_offsets_count(const TSequence *seq);
+extern char *tsequence_data_ptr(const TSequence *seq);
+extern int tsequence_block_count(const TSequence *seq);
+extern void *tsequence_block_bbox_ptr(const TSequence *seq, int block);
+extern void tsequence_reset_blocks(TSequence *seq);
 extern TInstant *tsequence_inst_n(const TSequence *seq, int index);
+extern TSequence *tsequence_make1(TInstant **instants, 
+  int count, bool lower_inc, bool upper_inc, bool linear, bool normalize);
 extern TSequence *tsequence_make(TInstant **instants, 
   int count, bool lower_inc, bool upper_inc, bool linear, bool normalize);
 extern TSequence *tsequence_make_free(TInstant **instants, 
   int count, bool lower_inc, bool upper_inc, bool linear, bool normalize);
+extern TSequence *tsequence_make_free1(TInstant **instants, 
+  int count, bool lower_inc, bool upper_inc, bool linear, bool normalize);
 extern TSequence *tsequence_copy(const TSequence *seq);
+
+extern size_t tsequence_levels_size(int count, int total);
+extern int32 *tsequence_levels_counts(const TSequenceLevels *levels);
+extern int32 *tsequence_levels_indexes(const TSequenceLevels *levels);
+extern double *tsequence_levels_significance(const TSequenceLevels *levels);
+extern const TSequenceLevels *tsequence_levels_ptr(const TSequence *seq);
+extern TSequence *tsequence_add_levels(const TSequence *seq,
+  const TSequenceLevels *levels);
+
+extern void tsequence_builder_init(TSequenceBuilder *b, Oid valuetypid,
+  int maxcount, bool linear, bool normalize);
+extern TInstant *tsequence_builder_last(const TSequenceBuilder *b);
+extern void tsequence_builder_append(TSequenceBuilder *b, Datum value,
+  TimestampTz t);
+extern void tsequence_builder_remove_last(TSequenceBuilder *b);
+extern void tsequence_builder_append_tinstant(TSequenceBuilder *b,
+  const TInstant *inst);
+extern TSequence *tsequence_builder_finish(TSequenceBuilder *b,
+  bool lower_inc, bool upper_inc);
 extern int tsequence_find_timestamp(const TSequence *seq, TimestampTz t);
 extern Datum tsequence_value_at_timestamp1(const TInstant *inst1,
   const TInstant *inst2, bool linear, TimestampTz t);
+extern bool tsequencearr_normalized(TSequence **sequences, int count);
 extern TSequence **tsequencearr_normalize(TSequence **sequences, int count, 
   int *newcount);
 extern TSequence **tsequencearr2_to_tsequencearr(TSequence ***sequences, 
@@ -49,6 +131,8 @@ extern bool intersection_tinstantset_tsequence(const TInstantSet *ti, const TSeq
 extern bool intersection_tsequence_tsequence(const TSequence *seq1, const TSequence *seq2,
   TSequence **inter1, TSequence **inter2);
 
+extern bool tsequence_same_timestamps(const TSequence *seq1,
+  const TSequence *seq2);
 extern bool synchronize_tsequence_tsequence(const TSequence *seq1, const TSequence *seq2,
   TSequence **sync1, TSequence **sync2, bool interpoint);
 
@@ -75,6 +159,8 @@ extern Datum tsequence_from_base(PG_FUNCTION_ARGS);
 /* Append and merge functions */
 
 extern TSequence *tsequence_join(const TSequence *seq1, const TSequence *seq2, bool last, bool first);
+extern bool tsequence_redundant_tinstant(const TInstant *inst1,
+  const TInstant *inst2, const TInstant *inst3, bool linear);
 extern Temporal *tsequence_append_tinstant(const TSequence *seq, const TInstant *inst);
 extern Temporal *tsequence_merge(const TSequence *seq1, const TSequence *seq2);
 extern TSequence **tsequence_merge_array1(TSequence **sequences, int count, int *totalcount);
@@ -156,6 +242,8 @@ extern bool tsequence_value_at_timestamp(const TSequence *seq, TimestampTz t,
   Datum *result);
 extern bool tsequence_value_at_timestamp_inc(const TSequence *seq, TimestampTz t,
   Datum *result);
+extern int tsequence_values_at_timestamps(const TSequence *seq,
+  const TimestampTz *times, int count, Datum *values, bool *found);
 
 extern int tsequence_minus_timestamp1(TSequence **result, const TSequence *seq,
   TimestampTz t);
@@ -200,6 +288,9 @@ extern bool tsequence_eq(const TSequence *seq1, const TSequence *seq2);
 /* Function for defining hash index */
 
 extern uint32 tsequence_hash(const TSequence *seq);
+#if MOBDB_PGSQL_VERSION >= 110000
+extern uint64 tsequence_hash_extended(const TSequence *seq, uint64 seed);
+#endif
 
 /*****************************************************************************/
 
@@ -25,13 +25,19 @@
 /* General functions */
 
 extern TSequence *tsequenceset_seq_n(const TSequenceSet *ts, int index);
+extern TSequenceSet *tsequenceset_make1(TSequence **sequences, int count,
+  bool normalize);
 extern TSequenceSet *tsequenceset_make(TSequence **sequences, int count,
   bool normalize);
 extern TSequenceSet * tsequenceset_make_free(TSequence **sequences, int count, 
   bool normalize);
+extern TSequenceSet *tsequenceset_make_free1(TSequence **sequences,
+  int count, bool normalize);
 extern TSequenceSet *tsequenceset_copy(const TSequenceSet *ts);
 extern bool tsequenceset_find_timestamp(const TSequenceSet *ts, TimestampTz t,
   int *loc);
+extern bool tsequenceset_find_timestamp_hint(const TSequenceSet *ts,
+  TimestampTz t, int hint, int *loc);
 extern double tsequenceset_interval_double(const TSequenceSet *ts);
 
 /* Intersection/synchronize functions */
@@ -140,6 +146,8 @@ extern TSequenceSet *tsequenceset_restrict_minmax(const TSequenceSet *ts,
   
 extern bool tsequenceset_value_at_timestamp(const TSequenceSet *ts, 
   TimestampTz t, Datum *result);
+extern bool tsequenceset_value_at_timestamp_slice(Datum tsdatum,
+  TimestampTz t, Datum *result, bool *found);
 extern bool tsequenceset_value_at_timestamp_inc(const TSequenceSet *ts, 
   TimestampTz t, Datum *result);
 
@@ -176,6 +184,9 @@ extern bool tsequenceset_eq(const TSequenceSet *ts1, const TSequenceSet *ts2);
 /* Function for defining hash index */
 
 extern uint32 tsequenceset_hash(const TSequenceSet *ts);
+#if MOBDB_PGSQL_VERSION >= 110000
+extern uint64 tsequenceset_hash_extended(const TSequenceSet *ts, uint64 seed);
+#endif
 
 /*****************************************************************************/
 
@@ -16,11 +16,36 @@
 #define ACCEPT_USE_OF_DEPRECATED_PROJ_API_H 1
 
 #include <postgres.h>
+#include <fmgr.h>
 #include <liblwgeom.h>
 #include "postgis.h"
+#include "temporal_argcache.h"
 
 /*****************************************************************************/
 
+/**
+ * Structure to keep the circular tree of a geography together with the
+ * geometry whose coordinates are referenced by the leaves of the tree
+ */
+typedef struct
+{
+  LWGEOM *lwgeom;       /**< Geometry of the geography */
+  CIRC_NODE *tree;      /**< Circular tree of the geometry */
+} GeogCircTree;
+
+/*****************************************************************************/
+
+extern GeogCircTree *geog_circ_tree_make(const GSERIALIZED *gs);
+extern void geog_circ_tree_free(void *tree);
+extern GeogCircTree *geography_circ_tree(FunctionCallInfo fcinfo,
+  ArgCacheEntry *entry, const GSERIALIZED *gs);
+extern void geography_circ_tree_release(GeogCircTree *tree,
+  ArgCacheEntry *entry);
+
+extern LWGEOM *geography_tree_shortestline(const CIRC_NODE *circ_tree1,
+  const CIRC_NODE *circ_tree2, int srid, double threshold,
+  const SPHEROID *spheroid);
+
 extern double circ_tree_distance_tree_internal(const CIRC_NODE* n1, const CIRC_NODE* n2, double threshold,
     double* min_dist, double* max_dist, GEOGRAPHIC_POINT* closest1, GEOGRAPHIC_POINT* closest2);
 
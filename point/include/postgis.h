@@ -52,6 +52,9 @@ extern double ptarray_length_spheroid(const POINTARRAY *pa, const SPHEROID *s);
 extern int lwline_is_empty(const LWLINE *line);
 extern void geographic_point_init(double lon, double lat, GEOGRAPHIC_POINT *g);
 extern double sphere_distance(const GEOGRAPHIC_POINT *s, const GEOGRAPHIC_POINT *e);
+extern double sphere_direction(const GEOGRAPHIC_POINT *s, const GEOGRAPHIC_POINT *e,
+  double d);
+extern double longitude_degrees_normalize(double lon);
 extern void geog2cart(const GEOGRAPHIC_POINT *g, POINT3D *p);
 extern void cart2geog(const POINT3D *p, GEOGRAPHIC_POINT *g);
 extern void normalize(POINT3D *p);
@@ -162,6 +165,8 @@ typedef struct circ_node
 
 extern CIRC_NODE* lwgeom_calculate_circ_tree(const LWGEOM* lwgeom);
 extern void circ_tree_free(CIRC_NODE* node);
+extern double circ_tree_distance_tree(const CIRC_NODE* n1, const CIRC_NODE* n2,
+  const SPHEROID *spheroid, double threshold);
 
 /* Definitions copied from liblwgeom_internal.h */
 
@@ -141,6 +141,8 @@ extern STBOX *stbox_expand_temporal_internal(STBOX *box, Datum interval);
 
 /* Topological operators */
 
+extern void ensure_valid_stbox_stbox(const STBOX *box1, const STBOX *box2);
+
 extern Datum contains_stbox_stbox(PG_FUNCTION_ARGS);
 extern Datum contained_stbox_stbox(PG_FUNCTION_ARGS);
 extern Datum overlaps_stbox_stbox(PG_FUNCTION_ARGS);
@@ -68,6 +68,8 @@
 /* Period bounds */
 #define WKB_LOWER_INC      0x01
 #define WKB_UPPER_INC      0x02
+/* The writer states that the sequence is normalized, only used in input */
+#define WKB_NORMALIZED     0x04
 
 /* Machine endianness */
 #define XDR            0  /* big endian */
@@ -88,6 +90,7 @@ extern void temporalgeom_init();
 /* Input/output functions */
 
 extern Datum tpoint_in(PG_FUNCTION_ARGS);
+extern Datum tpoint_recv(PG_FUNCTION_ARGS);
 extern Datum tgeompoint_typmod_in(PG_FUNCTION_ARGS);
 extern Datum tgeogpoint_typmod_in(PG_FUNCTION_ARGS);
 extern Datum tpoint_typmod_out(PG_FUNCTION_ARGS);
@@ -96,6 +99,7 @@ extern Datum tpoint_enforce_typmod(PG_FUNCTION_ARGS);
 /* Constructor functions */
 
 extern Datum tpointinst_constructor(PG_FUNCTION_ARGS);
+extern Datum tpointseq_from_arrays(PG_FUNCTION_ARGS);
 
 /* Accessor functions */
 
@@ -26,6 +26,20 @@ extern Datum tpoint_tcentroid_transfn(PG_FUNCTION_ARGS);
 extern Datum tpoint_tcentroid_combinefn(PG_FUNCTION_ARGS);
 extern Datum tpoint_tcentroid_finalfn(PG_FUNCTION_ARGS);
 
+extern Datum tpoint_append_simplify_transfn(PG_FUNCTION_ARGS);
+
+extern Datum tpoint_grid_transfn(PG_FUNCTION_ARGS);
+extern Datum tpoint_grid_combinefn(PG_FUNCTION_ARGS);
+extern Datum tpoint_grid_serialize(PG_FUNCTION_ARGS);
+extern Datum tpoint_grid_deserialize(PG_FUNCTION_ARGS);
+extern Datum tpoint_grid_finalfn(PG_FUNCTION_ARGS);
+
+extern Datum tpoint_fix_transfn(PG_FUNCTION_ARGS);
+extern Datum tpoint_fix_combinefn(PG_FUNCTION_ARGS);
+extern Datum tpoint_fix_serialize(PG_FUNCTION_ARGS);
+extern Datum tpoint_fix_deserialize(PG_FUNCTION_ARGS);
+extern Datum tpoint_fix_finalfn(PG_FUNCTION_ARGS);
+
 /*****************************************************************************/
 
 #endif
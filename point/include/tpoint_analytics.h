@@ -16,6 +16,8 @@
 #include <postgres.h>
 #include <fmgr.h>
 
+#include "temporal.h"
+
 /*****************************************************************************/
 
 /* Convert a temporal point into a PostGIS trajectory geometry/geography */
@@ -32,6 +34,10 @@ extern Datum point_to_geo_measure(PG_FUNCTION_ARGS);
 
 extern Datum tfloat_simplify(PG_FUNCTION_ARGS);
 extern Datum tpoint_simplify(PG_FUNCTION_ARGS);
+extern Datum tpoint_with_simplify_levels(PG_FUNCTION_ARGS);
+
+extern Temporal *tpoint_simplify_levels(const Temporal *temp,
+  double eps_dist);
 
 /*****************************************************************************/
 
@@ -21,6 +21,8 @@
 #include <commands/vacuum.h>
 #include <liblwgeom.h>
 
+#include "stbox.h"
+
 /*****************************************************************************/
 
 /**
@@ -95,6 +97,7 @@ extern int nd_box_init(ND_BOX *a);
 extern int nd_box_init_bounds(ND_BOX *a);
 extern int nd_box_merge(const ND_BOX *source, ND_BOX *target);
 extern void nd_box_from_gbox(const GBOX *gbox, ND_BOX *nd_box);
+extern void nd_box_from_stbox_time(const STBOX *box, int ndims, ND_BOX *nd_box);
 extern int nd_increment(ND_IBOX *ibox, int ndims, int *counter);
 extern int nd_box_overlap(const ND_STATS *nd_stats, const ND_BOX *nd_box, ND_IBOX *nd_ibox);
 extern int nd_box_intersects(const ND_BOX *a, const ND_BOX *b, int ndims);
@@ -85,4 +85,38 @@ extern Datum adjacent_bbox_tpoint_tpoint(PG_FUNCTION_ARGS);
 
 /*****************************************************************************/
 
+/*****************************************************************************
+ * Inlinable predicates, see timeops.h
+ *****************************************************************************/
+
+/**
+ * Returns true if the spatiotemporal boxes overlap (inlinable function).
+ * The functions raising the errors are only called when one of the
+ * conditions on the boxes may not hold.
+ */
+static inline bool
+overlaps_stbox_stbox_inline(const STBOX *box1, const STBOX *box2)
+{
+  bool hasx = MOBDB_FLAGS_GET_X(box1->flags) && MOBDB_FLAGS_GET_X(box2->flags);
+  bool hasz = MOBDB_FLAGS_GET_Z(box1->flags) && MOBDB_FLAGS_GET_Z(box2->flags);
+  bool hast = MOBDB_FLAGS_GET_T(box1->flags) && MOBDB_FLAGS_GET_T(box2->flags);
+  bool geodetic = MOBDB_FLAGS_GET_GEODETIC(box1->flags) &&
+    MOBDB_FLAGS_GET_GEODETIC(box2->flags);
+  if ((! hasx && ! hast) || (hasx && (box1->srid != box2->srid ||
+      MOBDB_FLAGS_GET_Z(box1->flags) != MOBDB_FLAGS_GET_Z(box2->flags) ||
+      MOBDB_FLAGS_GET_GEODETIC(box1->flags) !=
+        MOBDB_FLAGS_GET_GEODETIC(box2->flags))))
+    ensure_valid_stbox_stbox(box1, box2);
+  if (hasx && (box1->xmax < box2->xmin || box1->xmin > box2->xmax ||
+    box1->ymax < box2->ymin || box1->ymin > box2->ymax))
+    return false;
+  if ((hasz || geodetic) && (box1->zmax < box2->zmin || box1->zmin > box2->zmax))
+    return false;
+  if (hast && (box1->tmax < box2->tmin || box1->tmin > box2->tmax))
+    return false;
+  return true;
+}
+
+/*****************************************************************************/
+
 #endif
@@ -22,11 +22,12 @@
 #include "temporal.h"
 #include <liblwgeom.h>
 #include "tpoint.h"
+#include "postgis.h"
 
 /*****************************************************************************/
 
-extern double lw_dist_sphere_point_dist(const LWGEOM *lw1, const LWGEOM *lw2,
-  int mode, double *fraction);
+extern double lw_dist_sphere_point_dist(const LWGEOM *lw1,
+  const CIRC_NODE *circ_tree2, int mode, double *fraction);
 
 /* Distance functions */
 
@@ -41,7 +42,8 @@ extern bool tgeogpointseq_min_dist_at_timestamp(const TInstant *start1,
   const TInstant *end1, const TInstant *start2, const TInstant *end2,
   double *mindist, TimestampTz *t);
 
-extern Temporal *distance_tpoint_geo_internal(const Temporal *temp, Datum geo);
+extern Temporal *distance_tpoint_geo_internal(const Temporal *temp, Datum geo,
+  FmgrInfo *flinfo);
 extern Temporal *distance_tpoint_tpoint_internal(const Temporal *temp1, const Temporal *temp2);
 
 /* Nearest approach distance/instance and shortest line functions */
@@ -60,6 +62,8 @@ extern Datum NAD_tpoint_stbox(PG_FUNCTION_ARGS);
 extern Datum NAD_tpoint_tpoint(PG_FUNCTION_ARGS);
 
 extern double NAD_stbox_stbox_internal(const STBOX *box1, const STBOX *box2);
+extern double NAD_tpoint_tpoint_internal(const Temporal *temp1,
+  const Temporal *temp2);
 
 extern Datum shortestline_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum shortestline_tpoint_geo(PG_FUNCTION_ARGS);
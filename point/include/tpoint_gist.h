@@ -25,12 +25,39 @@ extern Datum stbox_gist_union(PG_FUNCTION_ARGS);
 extern Datum stbox_gist_penalty(PG_FUNCTION_ARGS);
 extern Datum stbox_gist_picksplit(PG_FUNCTION_ARGS);
 extern Datum stbox_gist_same(PG_FUNCTION_ARGS);
+extern Datum stbox_gist_fetch(PG_FUNCTION_ARGS);
 extern Datum tpoint_gist_compress(PG_FUNCTION_ARGS);
+#if MOBDB_PGSQL_VERSION >= 140000
+extern Datum stbox_gist_sortsupport(PG_FUNCTION_ARGS);
+#endif
+
+extern Datum tpoint_gist_multi_compress(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_multi_consistent(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_multi_union(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_multi_penalty(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_multi_picksplit(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_multi_same(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_multi_distance(PG_FUNCTION_ARGS);
+
+extern Datum tpoint_gist_compact_compress(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_compact_consistent(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_compact_union(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_compact_penalty(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_compact_picksplit(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_compact_same(PG_FUNCTION_ARGS);
+extern Datum tpoint_gist_compact_distance(PG_FUNCTION_ARGS);
+
+extern Datum stbox_brin_opcinfo(PG_FUNCTION_ARGS);
+extern Datum stbox_brin_add_value(PG_FUNCTION_ARGS);
+extern Datum stbox_brin_consistent(PG_FUNCTION_ARGS);
+extern Datum stbox_brin_union(PG_FUNCTION_ARGS);
 
 /* The following functions are also called by IndexSpgistTPoint.c */
 extern bool tpoint_index_recheck(StrategyNumber strategy);
 extern bool stbox_index_consistent_leaf(const STBOX *key, const STBOX *query,
   StrategyNumber strategy);
+extern bool tpoint_index_query_box(Datum query, Oid subtype, STBOX *box);
+extern double stbox_index_distance(const STBOX *key, const STBOX *query);
 
 /*****************************************************************************/
 
@@ -0,0 +1,28 @@
+/*****************************************************************************
+ *
+ * tpoint_joinscan.h
+ *    Custom scan provider for the spatiotemporal joins of temporal points.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_JOINSCAN_H__
+#define __TPOINT_JOINSCAN_H__
+
+#include <postgres.h>
+
+/*****************************************************************************/
+
+#if MOBDB_PGSQL_VERSION >= 120000
+extern bool enable_spatial_join;
+
+extern void tpoint_joinscan_init(void);
+#endif
+
+/*****************************************************************************/
+
+#endif
@@ -56,6 +56,8 @@
 #define STATISTIC_KIND_2D 103
 #define STATISTIC_SLOT_ND 0
 #define STATISTIC_SLOT_2D 1
+#define STATISTIC_KIND_ND_TIME 104
+#define STATISTIC_SLOT_ND_TIME 4
 
 /**
 * More modest fallafter selectivity factor
@@ -0,0 +1,42 @@
+/*****************************************************************************
+ *
+ * tpoint_similarity.h
+ *    Similarity distances between temporal points.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_SIMILARITY_H__
+#define __TPOINT_SIMILARITY_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+#include <access/stratnum.h>
+
+#include "temporal.h"
+
+/*****************************************************************************/
+
+/* Similarity distances */
+
+extern Datum frechet_distance_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern Datum dyntimewarp_distance_tpoint_tpoint(PG_FUNCTION_ARGS);
+
+extern double frechet_distance_internal(const Temporal *temp1,
+  const Temporal *temp2);
+extern double dyntimewarp_distance_internal(const Temporal *temp1,
+  const Temporal *temp2);
+
+/* Lower bounds of the similarity distances for the GiST indexes */
+
+extern bool tpoint_similarity_strategy(StrategyNumber strategy);
+extern double tpoint_similarity_index_distance(FunctionCallInfo fcinfo,
+  const STBOX *boxes, int count, StrategyNumber strategy);
+
+/*****************************************************************************/
+
+#endif
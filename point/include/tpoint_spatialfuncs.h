@@ -25,10 +25,19 @@
 
 /*****************************************************************************/
 
-/* Fetch from and store in the cache the fcinfo of the external function */
+/**
+ * Enumeration for the accuracy of the segment-level geodetic computations
+ */
+typedef enum
+{
+  GEODETIC_SPHEROID,
+  GEODETIC_SPHERE,
+  GEODETIC_FAST
+} GeodeticAccuracy;
+
+extern int geodetic_accuracy;
 
-extern FunctionCallInfo fetch_fcinfo();
-extern void store_fcinfo(FunctionCallInfo fcinfo);
+/*****************************************************************************/
 
 /* Functions derived from PostGIS to increase floating-point precision */
 
@@ -83,13 +92,13 @@ extern bool datum_point_eq(Datum geopoint1, Datum geopoint2);
 extern Datum datum2_point_eq(Datum geopoint1, Datum geopoint2);
 extern Datum datum2_point_ne(Datum geopoint1, Datum geopoint2);
 extern GSERIALIZED *geo_serialize(LWGEOM *geom);
-extern Datum datum_transform(Datum value, Datum srid);
+extern Datum datum_transform(Datum value, Datum srid, FmgrInfo *flinfo);
 
-extern Datum geom_distance2d(Datum geom1, Datum geom2);
-extern Datum geom_distance3d(Datum geom1, Datum geom2);
-extern Datum geog_distance(Datum geog1, Datum geog2);
-extern Datum pt_distance2d(Datum geom1, Datum geom2);
-extern Datum pt_distance3d(Datum geom1, Datum geom2);
+extern Datum geom_distance2d(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_distance3d(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geog_distance(Datum geog1, Datum geog2, Datum flinfo);
+extern Datum pt_distance2d(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum pt_distance3d(Datum geom1, Datum geom2, Datum flinfo);
 
 extern Datum geoseg_interpolate_point(Datum value1, Datum value2, double ratio);
 extern double geoseg_locate_point(Datum start, Datum end, Datum point, double *dist);
@@ -109,7 +118,8 @@ extern int tpointinstset_srid(const TInstantSet *ti);
 extern int tpointseq_srid(const TSequence *seq);
 extern int tpointseqset_srid(const TSequenceSet *ts);
 extern int tpoint_srid_internal(const Temporal *t);
-extern TInstant *tpointinst_transform(const TInstant *inst, Datum srid);
+extern TInstant *tpointinst_transform(const TInstant *inst, Datum srid,
+  FmgrInfo *flinfo);
 
 /* Cast functions */
 
@@ -127,6 +137,7 @@ extern Datum tpoint_trajectory(PG_FUNCTION_ARGS);
 extern Datum tpointinstset_trajectory(const TInstantSet *ti);
 extern Datum tpoint_trajectory_internal(const Temporal *temp);
 extern Datum tpointseq_make_trajectory(TInstant **instants, int count, bool linear);
+extern Datum lwpointarr_trajectory(LWPOINT **points, int count, bool linear);
 
 extern Datum geopoint_line(Datum value1, Datum value2);
 extern LWLINE *geopoint_lwline(Datum value1, Datum value2);
@@ -139,13 +150,15 @@ extern Datum tpointseqset_trajectory(const TSequenceSet *ts);
 
 extern Datum tpoint_length(PG_FUNCTION_ARGS);
 extern Datum tpoint_cumulative_length(PG_FUNCTION_ARGS);
+extern Datum tpoint_time_at_distance(PG_FUNCTION_ARGS);
+extern Datum tpoint_at_distance(PG_FUNCTION_ARGS);
+extern Datum tpoint_substring_by_distance(PG_FUNCTION_ARGS);
 extern Datum tpoint_speed(PG_FUNCTION_ARGS);
-extern Datum tgeompoint_twcentroid(PG_FUNCTION_ARGS);
+extern Datum tpoint_twcentroid(PG_FUNCTION_ARGS);
 extern Datum tpoint_azimuth(PG_FUNCTION_ARGS);
+extern Datum tpoint_kinematics(PG_FUNCTION_ARGS);
 
-extern Datum tgeompointi_twcentroid(const TInstantSet *ti);
-extern Datum tgeompointseq_twcentroid(const TSequence *seq);
-extern Datum tgeompoints_twcentroid(const TSequenceSet *ts);
+extern Datum tpoint_twcentroid_internal(Temporal *temp);
 
 /* Restriction functions */
 
@@ -159,6 +172,11 @@ extern TSequence **tpointseq_at_geometry2(const TSequence *seq, Datum geo, int *
 
 extern Temporal *tpoint_at_geometry_internal(const Temporal *temp, Datum geo);
 extern Temporal *tpoint_minus_geometry_internal(const Temporal *temp, Datum geo);
+extern Temporal *tpoint_at_stbox_internal(const Temporal *temp, const STBOX *box);
+
+/* Space-time tiles */
+
+extern Datum tpoint_space_time_split(PG_FUNCTION_ARGS);
 
 /*****************************************************************************/
 
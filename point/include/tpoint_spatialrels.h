@@ -23,26 +23,30 @@
 extern Datum spatialrel(Datum value1, Datum value2, Datum param, 
   LiftedFunctionInfo lfinfo);
 
-extern Datum geom_contains(Datum geom1, Datum geom2);
-extern Datum geom_containsproperly(Datum geom1, Datum geom2);
-extern Datum geom_covers(Datum geom1, Datum geom2);
-extern Datum geom_coveredby(Datum geom1, Datum geom2);
-extern Datum geom_crosses(Datum geom1, Datum geom2);
-extern Datum geom_disjoint(Datum geom1, Datum geom2);
-extern Datum geom_equals(Datum geom1, Datum geom2);
-extern Datum geom_intersects2d(Datum geom1, Datum geom2);
-extern Datum geom_intersects3d(Datum geom1, Datum geom2);
-extern Datum geom_overlaps(Datum geom1, Datum geom2);
-extern Datum geom_touches(Datum geom1, Datum geom2);
-extern Datum geom_within(Datum geom1, Datum geom2);
+extern FmgrInfo *spatialrel_flinfo(FunctionCallInfo fcinfo, bool geodetic);
+
+extern Datum geom_contains(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_containsproperly(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_covers(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_coveredby(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_crosses(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_disjoint(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_equals(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_intersects2d(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_intersects3d(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_overlaps(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_touches(Datum geom1, Datum geom2, Datum flinfo);
+extern Datum geom_within(Datum geom1, Datum geom2, Datum flinfo);
 extern Datum geom_dwithin2d(Datum geom1, Datum geom2, Datum dist);
 extern Datum geom_dwithin3d(Datum geom1, Datum geom2, Datum dist);
-extern Datum geom_relate(Datum geom1, Datum geom2);
+extern Datum geom_relate(Datum geom1, Datum geom2, Datum flinfo);
 extern Datum geom_relate_pattern(Datum geom1, Datum geom2, Datum pattern);
 
-extern Datum geog_covers(Datum geog1, Datum geog2);
-extern Datum geog_coveredby(Datum geog1, Datum geog2);
-extern Datum geog_intersects(Datum geog1, Datum geog2);
+extern Datum geog_covers(Datum geog1, Datum geog2, Datum flinfo);
+extern Datum geog_coveredby(Datum geog1, Datum geog2, Datum flinfo);
+extern Datum geog_intersects(Datum geog1, Datum geog2, Datum flinfo);
+extern Datum geog_dwithin_flinfo(Datum geog1, Datum geog2, Datum dist,
+  Datum flinfo);
 extern Datum geog_dwithin(Datum geog1, Datum geog2, Datum dist);
 
 extern Datum contains_geo_tpoint(PG_FUNCTION_ARGS);
@@ -0,0 +1,29 @@
+/*****************************************************************************
+ *
+ * tpoint_support.h
+ *    Planner support functions for the spatial relationships of temporal
+ *    points.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_SUPPORT_H__
+#define __TPOINT_SUPPORT_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+
+/*****************************************************************************/
+
+#if MOBDB_PGSQL_VERSION >= 120000
+extern bool tpoint_support_overlaps(Oid funcid, bool *expand);
+extern Datum tpoint_supportfn(PG_FUNCTION_ARGS);
+#endif
+
+/*****************************************************************************/
+
+#endif
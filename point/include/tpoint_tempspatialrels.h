@@ -41,6 +41,7 @@ extern Datum tequals_tpoint_tpoint(PG_FUNCTION_ARGS);
 extern Datum tintersects_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum tintersects_tpoint_geo(PG_FUNCTION_ARGS);
 extern Datum tintersects_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern Datum tintersects_tpoint_geoarr(PG_FUNCTION_ARGS);
 
 extern Datum ttouches_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum ttouches_tpoint_geo(PG_FUNCTION_ARGS);
@@ -51,6 +52,7 @@ extern Datum twithin_tpoint_geo(PG_FUNCTION_ARGS);
 extern Datum tdwithin_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum tdwithin_tpoint_geo(PG_FUNCTION_ARGS);
 extern Datum tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern Datum tdwithin_pairs(PG_FUNCTION_ARGS);
 
 extern Datum trelate_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum trelate_tpoint_geo(PG_FUNCTION_ARGS);
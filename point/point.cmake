@@ -22,8 +22,11 @@ point/src/tpoint_in.c
 point/src/tpoint_out.c
 point/src/tpoint_analyze.c
 point/src/tpoint_selfuncs.c
+point/src/tpoint_support.c
+point/src/tpoint_joinscan.c
 point/src/tpoint_tempspatialrels.c
 point/src/tpoint_analytics.c
+point/src/tpoint_similarity.c
 )
 
 set(SQLPOINT
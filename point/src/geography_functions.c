@@ -22,6 +22,7 @@
 
 #include "postgis.h"
 #include "tpoint_spatialfuncs.h"
+#include "geography_funcs.h"
 
 extern void lwerror(const char *fmt, ...);
 
@@ -275,28 +276,86 @@ circ_tree_distance_tree_internal(const CIRC_NODE* n1, const CIRC_NODE* n2, doubl
   }
 }
 
+/***********************************************************************
+ * Circular trees of geographies
+ ***********************************************************************/
+
+/**
+ * Returns the circular tree of the geography
+ *
+ * @note The leaves of the tree reference the coordinates of the geography,
+ * which must thus live at least as long as the tree
+ */
+GeogCircTree *
+geog_circ_tree_make(const GSERIALIZED *gs)
+{
+  GeogCircTree *result = palloc(sizeof(GeogCircTree));
+  result->lwgeom = lwgeom_from_gserialized(gs);
+  result->tree = lwgeom_calculate_circ_tree(result->lwgeom);
+  return result;
+}
+
+/**
+ * Frees the circular tree of the geography
+ */
+void
+geog_circ_tree_free(void *tree)
+{
+  GeogCircTree *ctree = (GeogCircTree *) tree;
+  circ_tree_free(ctree->tree);
+  lwgeom_free(ctree->lwgeom);
+  pfree(ctree);
+}
+
+/**
+ * Returns the circular tree of the geography argument of a function. When
+ * the argument has the same value as in the previous call of the function,
+ * the tree is kept in the cache of the function so that it is computed only
+ * once per query.
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] entry Cache entry of the argument or NULL
+ * @param[in] gs Geography
+ */
+GeogCircTree *
+geography_circ_tree(FunctionCallInfo fcinfo, ArgCacheEntry *entry,
+  const GSERIALIZED *gs)
+{
+  if (entry != NULL)
+    return (GeogCircTree *) argcache_geog_circ_tree(fcinfo, entry);
+  return geog_circ_tree_make(gs);
+}
+
+/**
+ * Frees the circular tree of the geography argument of a function if it
+ * does not belong to the cache of the function
+ */
+void
+geography_circ_tree_release(GeogCircTree *tree, ArgCacheEntry *entry)
+{
+  if (entry == NULL)
+    geog_circ_tree_free(tree);
+  return;
+}
+
 /***********************************************************************
  * Closest point and closest line functions for geographies.
  ***********************************************************************/
 
-LWGEOM *
-geography_tree_closestpoint(const GSERIALIZED* g1, const GSERIALIZED* g2, double threshold)
+/**
+ * Returns the point of the first geography that is closest to the second
+ * one, where the geographies are given by their circular trees
+ */
+static LWGEOM *
+geography_tree_closestpoint(const CIRC_NODE *circ_tree1,
+  const CIRC_NODE *circ_tree2, int srid, double threshold)
 {
-  CIRC_NODE* circ_tree1 = NULL;
-  CIRC_NODE* circ_tree2 = NULL;
-  LWGEOM* lwgeom1 = NULL;
-  LWGEOM* lwgeom2 = NULL;
   double min_dist = FLT_MAX;
   double max_dist = FLT_MAX;
   GEOGRAPHIC_POINT closest1, closest2;
   LWGEOM *result;
   POINT4D p;
 
-  lwgeom1 = lwgeom_from_gserialized(g1);
-  lwgeom2 = lwgeom_from_gserialized(g2);
-  circ_tree1 = lwgeom_calculate_circ_tree(lwgeom1);
-  circ_tree2 = lwgeom_calculate_circ_tree(lwgeom2);
-
   /* Quietly decrease the threshold just a little to avoid cases where */
   /* the actual spheroid distance is larger than the sphere distance */
   /* causing the return value to be larger than the threshold value */
@@ -308,12 +367,7 @@ geography_tree_closestpoint(const GSERIALIZED* g1, const GSERIALIZED* g2, double
 
   p.x = rad2deg(closest1.lon);
   p.y = rad2deg(closest1.lat);
-  result = (LWGEOM *)lwpoint_make2d(gserialized_get_srid(g1), p.x, p.y);
-
-  circ_tree_free(circ_tree1);
-  circ_tree_free(circ_tree2);
-  lwgeom_free(lwgeom1);
-  lwgeom_free(lwgeom2);
+  result = (LWGEOM *)lwpoint_make2d(srid, p.x, p.y);
   return result;
 }
 
@@ -330,20 +384,29 @@ Datum geography_closestpoint(PG_FUNCTION_ARGS)
   GSERIALIZED* result;
 
   /* Get our geography objects loaded into memory. */
-  g1 = PG_GETARG_GSERIALIZED_P(0);
-  g2 = PG_GETARG_GSERIALIZED_P(1);
+  ArgCacheEntry *entry1 = argcache_gserialized(fcinfo, 0);
+  ArgCacheEntry *entry2 = argcache_gserialized(fcinfo, 1);
+  g1 = (entry1 != NULL) ? (GSERIALIZED *) DatumGetPointer(entry1->value) :
+    PG_GETARG_GSERIALIZED_P(0);
+  g2 = (entry2 != NULL) ? (GSERIALIZED *) DatumGetPointer(entry2->value) :
+    PG_GETARG_GSERIALIZED_P(1);
 
   error_if_srid_mismatch(gserialized_get_srid(g1), gserialized_get_srid(g2));
 
   /* Return NULL on empty arguments. */
   if ( gserialized_is_empty(g1) || gserialized_is_empty(g2) )
   {
-    PG_FREE_IF_COPY(g1, 0);
-    PG_FREE_IF_COPY(g2, 1);
+    ARGCACHE_FREE_IF_COPY(g1, 0, entry1);
+    ARGCACHE_FREE_IF_COPY(g2, 1, entry2);
     PG_RETURN_NULL();
   }
 
-  point = geography_tree_closestpoint(g1, g2, FP_TOLERANCE);
+  GeogCircTree *tree1 = geography_circ_tree(fcinfo, entry1, g1);
+  GeogCircTree *tree2 = geography_circ_tree(fcinfo, entry2, g2);
+  point = geography_tree_closestpoint(tree1->tree, tree2->tree,
+    gserialized_get_srid(g1), FP_TOLERANCE);
+  geography_circ_tree_release(tree1, entry1);
+  geography_circ_tree_release(tree2, entry2);
 
   if (lwgeom_is_empty(point))
     PG_RETURN_NULL();
@@ -351,21 +414,22 @@ Datum geography_closestpoint(PG_FUNCTION_ARGS)
   result = geography_serialize(point);
   lwgeom_free(point);
 
-  PG_FREE_IF_COPY(g1, 0);
-  PG_FREE_IF_COPY(g2, 1);
+  ARGCACHE_FREE_IF_COPY(g1, 0, entry1);
+  ARGCACHE_FREE_IF_COPY(g2, 1, entry2);
   PG_RETURN_POINTER(result);
 }
 
 /*****************************************************************************/
 
+/**
+ * Returns the shortest line between the two geographies given by their
+ * circular trees
+ */
 LWGEOM *
-geography_tree_shortestline(const GSERIALIZED* g1, const GSERIALIZED* g2,
-  double threshold, const SPHEROID *spheroid)
+geography_tree_shortestline(const CIRC_NODE *circ_tree1,
+  const CIRC_NODE *circ_tree2, int srid, double threshold,
+  const SPHEROID *spheroid)
 {
-  CIRC_NODE* circ_tree1 = NULL;
-  CIRC_NODE* circ_tree2 = NULL;
-  LWGEOM* lwgeom1 = NULL;
-  LWGEOM* lwgeom2 = NULL;
   double min_dist = FLT_MAX;
   double max_dist = FLT_MAX;
   GEOGRAPHIC_POINT closest1, closest2;
@@ -373,11 +437,6 @@ geography_tree_shortestline(const GSERIALIZED* g1, const GSERIALIZED* g2,
   LWGEOM *result;
   POINT4D p1, p2;
 
-  lwgeom1 = lwgeom_from_gserialized(g1);
-  lwgeom2 = lwgeom_from_gserialized(g2);
-  circ_tree1 = lwgeom_calculate_circ_tree(lwgeom1);
-  circ_tree2 = lwgeom_calculate_circ_tree(lwgeom2);
-
   /* Quietly decrease the threshold just a little to avoid cases where */
   /* the actual spheroid distance is larger than the sphere distance */
   /* causing the return value to be larger than the threshold value */
@@ -392,16 +451,12 @@ geography_tree_shortestline(const GSERIALIZED* g1, const GSERIALIZED* g2,
   p2.x = rad2deg(closest2.lon);
   p2.y = rad2deg(closest2.lat);
 
-  geoms[0] = (LWGEOM *)lwpoint_make2d(gserialized_get_srid(g1), p1.x, p1.y);
-  geoms[1] = (LWGEOM *)lwpoint_make2d(gserialized_get_srid(g1), p2.x, p2.y);
+  geoms[0] = (LWGEOM *)lwpoint_make2d(srid, p1.x, p1.y);
+  geoms[1] = (LWGEOM *)lwpoint_make2d(srid, p2.x, p2.y);
   result = (LWGEOM *)lwline_from_lwgeom_array(geoms[0]->srid, 2, geoms);
 
   lwgeom_free(geoms[0]);
   lwgeom_free(geoms[1]);
-  circ_tree_free(circ_tree1);
-  circ_tree_free(circ_tree2);
-  lwgeom_free(lwgeom1);
-  lwgeom_free(lwgeom2);
   return result;
 }
 
@@ -420,8 +475,12 @@ Datum geography_shortestline(PG_FUNCTION_ARGS)
   SPHEROID s;
 
   /* Get our geography objects loaded into memory. */
-  g1 = PG_GETARG_GSERIALIZED_P(0);
-  g2 = PG_GETARG_GSERIALIZED_P(1);
+  ArgCacheEntry *entry1 = argcache_gserialized(fcinfo, 0);
+  ArgCacheEntry *entry2 = argcache_gserialized(fcinfo, 1);
+  g1 = (entry1 != NULL) ? (GSERIALIZED *) DatumGetPointer(entry1->value) :
+    PG_GETARG_GSERIALIZED_P(0);
+  g2 = (entry2 != NULL) ? (GSERIALIZED *) DatumGetPointer(entry2->value) :
+    PG_GETARG_GSERIALIZED_P(1);
 
   error_if_srid_mismatch(gserialized_get_srid(g1), gserialized_get_srid(g2));
 
@@ -432,8 +491,8 @@ Datum geography_shortestline(PG_FUNCTION_ARGS)
   /* Return NULL on empty arguments. */
   if ( gserialized_is_empty(g1) || gserialized_is_empty(g2) )
   {
-    PG_FREE_IF_COPY(g1, 0);
-    PG_FREE_IF_COPY(g2, 1);
+    ARGCACHE_FREE_IF_COPY(g1, 0, entry1);
+    ARGCACHE_FREE_IF_COPY(g2, 1, entry2);
     PG_RETURN_NULL();
   }
 
@@ -447,7 +506,12 @@ Datum geography_shortestline(PG_FUNCTION_ARGS)
   if ( ! use_spheroid )
     s.a = s.b = s.radius;
 
-  line = geography_tree_shortestline(g1, g2, FP_TOLERANCE, &s);
+  GeogCircTree *tree1 = geography_circ_tree(fcinfo, entry1, g1);
+  GeogCircTree *tree2 = geography_circ_tree(fcinfo, entry2, g2);
+  line = geography_tree_shortestline(tree1->tree, tree2->tree,
+    gserialized_get_srid(g1), FP_TOLERANCE, &s);
+  geography_circ_tree_release(tree1, entry1);
+  geography_circ_tree_release(tree2, entry2);
 
   if (lwgeom_is_empty(line))
     PG_RETURN_NULL();
@@ -455,8 +519,8 @@ Datum geography_shortestline(PG_FUNCTION_ARGS)
   result = geography_serialize(line);
   lwgeom_free(line);
 
-  PG_FREE_IF_COPY(g1, 0);
-  PG_FREE_IF_COPY(g2, 1);
+  ARGCACHE_FREE_IF_COPY(g1, 0, entry1);
+  ARGCACHE_FREE_IF_COPY(g2, 1, entry2);
   PG_RETURN_POINTER(result);
 }
 
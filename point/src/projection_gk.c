@@ -137,40 +137,70 @@ point2d_get_datum(const POINT2D *p2d)
   return PointerGetDatum(result);
 }
 
+/**
+ * Transform the arrays of coordinates into the Gauss-Kruger projection used
+ * in Secondo
+ *
+ * The computation is split into one loop per step of the projection. The
+ * closed-form steps are thus loops over contiguous arrays that the compiler
+ * can vectorize, only the iterative computation of the Bessel latitude is
+ * done point by point.
+ *
+ * @param[in] x,y Longitudes and latitudes of the points in degrees
+ * @param[out] resx,resy Projected coordinates, which may be the input arrays
+ * @param[in] count Number of points
+ */
+static void
+gk_points(const double *x, const double *y, double *resx, double *resy,
+  int count)
+{
+  eqwgs = (awgs * awgs - bwgs * bwgs) / (awgs * awgs);
+  eqbes = (abes * abes - bbes * bbes) / (abes * abes);
+  double *X = palloc(sizeof(double) * count * 3);
+  double *Y = X + count;
+  double *Z = Y + count;
+
+  /* Geocentric coordinates on WGS84 followed by the Helmert transformation */
+  for (int i = 0; i < count; i++)
+  {
+    double l1 = (x[i] / 180) * Pi;
+    double b1 = (y[i] / 180) * Pi;
+    double N = awgs / sqrt(1 - eqwgs * sin(b1) * sin(b1));
+    double Xq = (N + h1) * cos(b1) * cos(l1);
+    double Yq = (N + h1) * cos(b1) * sin(l1);
+    double Zq = ((1 - eqwgs) * N + h1) * sin(b1);
+    POINT3D p = HelmertTransformation(Xq, Yq, Zq);
+    X[i] = p.x;
+    Y[i] = p.y;
+    Z[i] = p.z;
+  }
+  /* Latitude and longitude on the Bessel ellipsoid */
+  for (int i = 0; i < count; i++)
+  {
+    POINT3D p = BLRauenberg(X[i], Y[i], Z[i]);
+    X[i] = p.x;
+    Y[i] = p.y;
+  }
+  /* Gauss-Krueger coordinates */
+  for (int i = 0; i < count; i++)
+  {
+    POINT2D p = BesselBLToGaussKrueger(X[i], Y[i]);
+    resx[i] = p.x;
+    resy[i] = p.y;
+  }
+  pfree(X);
+  return;
+}
+
 /**
  * Transform a point into the Gauss-Kruger projection used in Secondo
  */
 static Datum
 gk(Datum point)
 {
-  eqwgs = (awgs * awgs - bwgs * bwgs) / (awgs * awgs);
-  eqbes = (abes * abes - bbes * bbes) / (abes * abes);
   const POINT2D *p2d = datum_get_point2d_p(point);
   POINT2D result;
-  double x = p2d->x;
-  double y = p2d->y;
-  double a = (x / 180) * Pi;
-  double b = (y / 180) * Pi;
-  double l1 = a;
-  double b1 = b;
-
-  a = awgs;
-
-  double eq = eqwgs;
-  double N = a / sqrt(1 - eq * sin(b1) * sin(b1));
-  double Xq = (N + h1) * cos(b1) * cos(l1);
-  double Yq = (N + h1) * cos(b1) * sin(l1);
-  double Zq = ((1 - eq) * N + h1) * sin(b1);
-
-  POINT3D p = HelmertTransformation(Xq, Yq, Zq);
-  double X = p.x;
-  double Y = p.y;
-  double Z = p.z;
-
-  p = BLRauenberg(X, Y, Z);
-  double b2 = p.x;
-  double l2 = p.y;
-  result = BesselBLToGaussKrueger(b2, l2);
+  gk_points(&p2d->x, &p2d->y, &result.x, &result.y, 1);
   return point2d_get_datum(&result);
 }
 
@@ -189,10 +219,10 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
       lwpoint = lwpoint_construct_empty(0, false, false);
     else
     {
-      const POINT2D *p2d= gs_get_point2d_p(gs);
-      Datum geom = gk(point2d_get_datum(p2d));
-      p2d  = datum_get_point2d_p(geom);
-      lwpoint = lwpoint_make2d(4326, p2d->x, p2d->y);
+      const POINT2D *p2d = gs_get_point2d_p(gs);
+      POINT2D p;
+      gk_points(&p2d->x, &p2d->y, &p.x, &p.y, 1);
+      lwpoint = lwpoint_make2d(4326, p.x, p.y);
     }
     result = geo_serialize((LWGEOM *)lwpoint);
     lwpoint_free(lwpoint);
@@ -207,25 +237,32 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
     }
     else
     {
-      LWPOINT *lwpoint = NULL;
       line = lwgeom_as_lwline(lwgeom_from_gserialized(gs));
       uint32_t numPoints = line->points->npoints;
-      LWPOINT **points = palloc(sizeof(LWPOINT *) * numPoints);
+      /* Project all the vertices in a single batch */
+      double *x = palloc(sizeof(double) * numPoints * 2);
+      double *y = x + numPoints;
+      POINT4D p;
       for (uint32_t i = 0; i < numPoints; i++)
       {
-        lwpoint = lwline_get_lwpoint(line, i);
-        Datum point2d_datum = PointerGetDatum(geo_serialize((LWGEOM *) lwpoint));
-        Datum geom = gk(point2d_datum);
-        const POINT2D *p2d  = datum_get_point2d_p(geom);
-        points[i] = lwpoint_make2d(4326, p2d->x, p2d->y);
+        getPoint4d_p(line->points, i, &p);
+        x[i] = p.x;
+        y[i] = p.y;
       }
-
-      line = lwline_from_ptarray(4326, numPoints, points);
-      result = geo_serialize((LWGEOM *) line);
-      lwline_free(line); lwpoint_free(lwpoint);
+      gk_points(x, y, x, y, (int) numPoints);
+      POINTARRAY *pa = ptarray_construct(false, false, numPoints);
+      p.z = p.m = 0.0;
       for (uint32_t i = 0; i < numPoints; i++)
-        lwpoint_free(points[i]);
-      pfree(points);
+      {
+        p.x = x[i];
+        p.y = y[i];
+        ptarray_set_point4d(pa, i, &p);
+      }
+      lwline_free(line);
+      line = lwline_construct(4326, NULL, pa);
+      result = geo_serialize((LWGEOM *) line);
+      lwline_free(line);
+      pfree(x);
     }
   }
   else
@@ -248,6 +285,112 @@ geometry_transform_gk(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/**
+ * Transform the points of the temporal instant points into the
+ * Gauss-Krueger projection used in Secondo
+ *
+ * The coordinates are projected in a single batch and written back into
+ * the values of the instants, which are thus modified in place
+ *
+ * @param[in,out] instants Array of temporal instant points
+ * @param[in] count Number of elements in the input array
+ * @pre The temporal points are 2D
+ */
+static void
+tpointinstarr_transform_gk(TInstant **instants, int count)
+{
+  double *x = palloc(sizeof(double) * count * 2);
+  double *y = x + count;
+  for (int i = 0; i < count; i++)
+  {
+    const POINT2D *p = datum_get_point2d_p(tinstant_value(instants[i]));
+    x[i] = p->x;
+    y[i] = p->y;
+  }
+  gk_points(x, y, x, y, count);
+  for (int i = 0; i < count; i++)
+  {
+    GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(
+      tinstant_value_ptr(instants[i]));
+    POINT2D *p = (POINT2D *) gs_get_point2d_p(gs);
+    p->x = x[i];
+    p->y = y[i];
+    gserialized_set_srid(gs, 4326);
+  }
+  pfree(x);
+  return;
+}
+
+/**
+ * Transform a 2D temporal point into the Gauss-Krueger projection used in
+ * Secondo
+ *
+ * The instants of a copy of the temporal point are projected in a single
+ * batch and the result is constructed from them as done in tfunc_temporal
+ */
+static Temporal *
+tgeompoint_transform_gk_internal(const Temporal *temp)
+{
+  if (temp->duration == INSTANT)
+  {
+    TInstant *result = tinstant_copy((TInstant *) temp);
+    tpointinstarr_transform_gk(&result, 1);
+    return (Temporal *) result;
+  }
+
+  if (temp->duration == INSTANTSET)
+  {
+    TInstantSet *copy = tinstantset_copy((TInstantSet *) temp);
+    TInstant **instants = palloc(sizeof(TInstant *) * copy->count);
+    for (int i = 0; i < copy->count; i++)
+      instants[i] = tinstantset_inst_n(copy, i);
+    tpointinstarr_transform_gk(instants, copy->count);
+    TInstantSet *result = tinstantset_make(instants, copy->count);
+    pfree(instants); pfree(copy);
+    return (Temporal *) result;
+  }
+
+  if (temp->duration == SEQUENCE)
+  {
+    TSequence *copy = tsequence_copy((TSequence *) temp);
+    TInstant **instants = palloc(sizeof(TInstant *) * copy->count);
+    for (int i = 0; i < copy->count; i++)
+      instants[i] = tsequence_inst_n(copy, i);
+    tpointinstarr_transform_gk(instants, copy->count);
+    TSequence *result = tsequence_make(instants, copy->count,
+      copy->period.lower_inc, copy->period.upper_inc,
+      MOBDB_FLAGS_GET_LINEAR(copy->flags), NORMALIZE);
+    pfree(instants); pfree(copy);
+    return (Temporal *) result;
+  }
+
+  /* temp->duration == SEQUENCESET */
+  TSequenceSet *copy = tsequenceset_copy((TSequenceSet *) temp);
+  TInstant **instants = palloc(sizeof(TInstant *) * copy->totalcount);
+  int k = 0;
+  for (int i = 0; i < copy->count; i++)
+  {
+    TSequence *seq = tsequenceset_seq_n(copy, i);
+    for (int j = 0; j < seq->count; j++)
+      instants[k++] = tsequence_inst_n(seq, j);
+  }
+  tpointinstarr_transform_gk(instants, copy->totalcount);
+  TSequence **sequences = palloc(sizeof(TSequence *) * copy->count);
+  k = 0;
+  for (int i = 0; i < copy->count; i++)
+  {
+    TSequence *seq = tsequenceset_seq_n(copy, i);
+    sequences[i] = tsequence_make(&instants[k], seq->count,
+      seq->period.lower_inc, seq->period.upper_inc,
+      MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
+    k += seq->count;
+  }
+  TSequenceSet *result = tsequenceset_make_free(sequences, copy->count,
+    NORMALIZE);
+  pfree(instants); pfree(copy);
+  return (Temporal *) result;
+}
+
 PG_FUNCTION_INFO_V1(tgeompoint_transform_gk);
 /**
  * Transform a temporal point into the Gauss-Krueger projection used in Secondo
@@ -257,12 +400,20 @@ tgeompoint_transform_gk(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
   ensure_valid_duration(temp->duration);
-  /* We only need to fill these parameters for tfunc_temporal */
-  LiftedFunctionInfo lfinfo;
-  lfinfo.func = (varfunc) &gk;
-  lfinfo.numparam = 1;
-  lfinfo.restypid = temp->valuetypid;
-  Temporal *result = tfunc_temporal(temp, (Datum) NULL, lfinfo);
+  Temporal *result;
+  if (! MOBDB_FLAGS_GET_Z(temp->flags))
+    result = tgeompoint_transform_gk_internal(temp);
+  else
+  {
+    /* The projection of 3D points results in 2D points, which cannot be
+     * written in place */
+    /* We only need to fill these parameters for tfunc_temporal */
+    LiftedFunctionInfo lfinfo;
+    lfinfo.func = (varfunc) &gk;
+    lfinfo.numparam = 1;
+    lfinfo.restypid = temp->valuetypid;
+    result = tfunc_temporal(temp, (Datum) NULL, lfinfo);
+  }
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_POINTER(result);
 }
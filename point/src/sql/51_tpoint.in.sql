@@ -30,7 +30,7 @@ CREATE FUNCTION temporal_out(tgeompoint)
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tgeompoint_recv(internal, oid, integer)
   RETURNS tgeompoint
-  AS 'MODULE_PATHNAME', 'temporal_recv'
+  AS 'MODULE_PATHNAME', 'tpoint_recv'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION temporal_send(tgeompoint)
   RETURNS bytea
@@ -78,7 +78,7 @@ CREATE FUNCTION temporal_out(tgeogpoint)
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tgeogpoint_recv(internal, oid, integer)
   RETURNS tgeogpoint
-  AS 'MODULE_PATHNAME', 'temporal_recv'
+  AS 'MODULE_PATHNAME', 'tpoint_recv'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION temporal_send(tgeogpoint)
   RETURNS bytea
@@ -145,6 +145,31 @@ CREATE FUNCTION tgeogpointseq(tgeogpoint[], lower_inc boolean DEFAULT true,
   AS 'MODULE_PATHNAME', 'tlinearseq_constructor'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION tgeompointseq(x float8[], y float8[], t timestamptz[],
+  srid integer DEFAULT 0, lower_inc boolean DEFAULT true,
+  upper_inc boolean DEFAULT true, linear boolean DEFAULT true)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'tpointseq_from_arrays'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeompointseq(x float8[], y float8[], z float8[],
+  t timestamptz[], srid integer DEFAULT 0, lower_inc boolean DEFAULT true,
+  upper_inc boolean DEFAULT true, linear boolean DEFAULT true)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'tpointseq_from_arrays'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeogpointseq(x float8[], y float8[], t timestamptz[],
+  srid integer DEFAULT 4326, lower_inc boolean DEFAULT true,
+  upper_inc boolean DEFAULT true, linear boolean DEFAULT true)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'tpointseq_from_arrays'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeogpointseq(x float8[], y float8[], z float8[],
+  t timestamptz[], srid integer DEFAULT 4326, lower_inc boolean DEFAULT true,
+  upper_inc boolean DEFAULT true, linear boolean DEFAULT true)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'tpointseq_from_arrays'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION tgeompoints(tgeompoint[])
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'tsequenceset_constructor'
@@ -258,6 +283,39 @@ CREATE FUNCTION merge(tgeogpoint[])
 AS 'MODULE_PATHNAME', 'temporal_merge_array'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION pack(tgeompoint)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'temporal_pack'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION pack(tgeogpoint)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'temporal_pack'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION pack(tgeompoint, scale float)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'temporal_pack'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION pack(tgeogpoint, scale float)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'temporal_pack'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION pack(tgeompoint, shuffle boolean)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'temporal_pack_shuffle'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION pack(tgeogpoint, shuffle boolean)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'temporal_pack_shuffle'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION pack(tgeompoint, scale float, shuffle boolean)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'temporal_pack_shuffle'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION pack(tgeogpoint, scale float, shuffle boolean)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'temporal_pack_shuffle'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /******************************************************************************
  * Functions
  ******************************************************************************/
@@ -289,6 +347,15 @@ CREATE FUNCTION memSize(tgeogpoint)
   AS 'MODULE_PATHNAME', 'temporal_mem_size'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION memBreakdown(tgeompoint)
+  RETURNS mem_breakdown
+  AS 'MODULE_PATHNAME', 'temporal_mem_breakdown'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION memBreakdown(tgeogpoint)
+  RETURNS mem_breakdown
+  AS 'MODULE_PATHNAME', 'temporal_mem_breakdown'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 -- value is a reserved word in SQL
 CREATE FUNCTION getValue(tgeompoint)
   RETURNS geometry(Point)
@@ -674,6 +741,14 @@ CREATE FUNCTION valueAtTimestamp(tgeogpoint, timestamptz)
   RETURNS geography(Point)
   AS 'MODULE_PATHNAME', 'temporal_value_at_timestamp'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valuesAtTimestamps(tgeompoint, timestamptz[])
+  RETURNS geometry[]
+  AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valuesAtTimestamps(tgeogpoint, timestamptz[])
+  RETURNS geography[]
+  AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION atTimestampSet(tgeompoint, timestampset)
   RETURNS tgeompoint
@@ -729,14 +804,27 @@ CREATE FUNCTION minusPeriodSet(tgeogpoint, periodset)
   AS 'MODULE_PATHNAME', 'temporal_minus_periodset'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+#if MOBDB_PGSQL_VERSION >= 120000
 CREATE FUNCTION intersectsTimestamp(tgeompoint, timestamptz)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp'
+  SUPPORT temporal_intersects_timestamp_support
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION intersectsTimestamp(tgeogpoint, timestamptz)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp'
+  SUPPORT temporal_intersects_timestamp_support
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION intersectsTimestamp(tgeompoint, timestamptz)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION intersectsTimestamp(tgeogpoint, timestamptz)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 CREATE FUNCTION intersectsTimestampSet(tgeompoint, timestampset)
   RETURNS boolean
@@ -937,14 +1025,30 @@ CREATE FUNCTION tgeogpoint_hash(tgeogpoint)
   RETURNS integer
   AS 'MODULE_PATHNAME', 'temporal_hash'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 110000
+CREATE FUNCTION tgeompoint_hash_extended(tgeompoint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeogpoint_hash_extended(tgeogpoint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
 
 CREATE OPERATOR CLASS hash_tgeompoint_ops
   DEFAULT FOR TYPE tgeompoint USING hash AS
     OPERATOR    1   = ,
+#if MOBDB_PGSQL_VERSION >= 110000
+    FUNCTION    2   tgeompoint_hash_extended(tgeompoint, bigint),
+#endif
     FUNCTION    1   tgeompoint_hash(tgeompoint);
 CREATE OPERATOR CLASS hash_tgeogpoint_ops
   DEFAULT FOR TYPE tgeogpoint USING hash AS
     OPERATOR    1   = ,
+#if MOBDB_PGSQL_VERSION >= 110000
+    FUNCTION    2   tgeogpoint_hash_extended(tgeogpoint, bigint),
+#endif
     FUNCTION    1   tgeogpoint_hash(tgeogpoint);
 
 /******************************************************************************/
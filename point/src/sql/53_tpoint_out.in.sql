@@ -124,4 +124,20 @@ CREATE FUNCTION asHexEWKB(tgeogpoint, endianenconding text)
   AS 'MODULE_PATHNAME', 'tpoint_as_hexewkb'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION points(tgeompoint)
+  RETURNS TABLE(seq integer, t timestamptz, x float, y float, z float)
+  AS 'MODULE_PATHNAME', 'tpoint_points'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION points(tgeogpoint)
+  RETURNS TABLE(seq integer, t timestamptz, x float, y float, z float)
+  AS 'MODULE_PATHNAME', 'tpoint_points'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION asMVTGeom(tpoint tgeompoint, bounds stbox,
+    extent int4 DEFAULT 4096, buffer int4 DEFAULT 256,
+    clip_geom bool DEFAULT true, OUT geom geometry, OUT times timestamptz[])
+  RETURNS record
+  AS 'MODULE_PATHNAME', 'tpoint_as_mvtgeom'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -129,6 +129,33 @@ CREATE FUNCTION cumulativeLength(tgeogpoint)
   AS 'MODULE_PATHNAME', 'tpoint_cumulative_length'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION timeAtDistance(tgeompoint, float)
+  RETURNS timestamptz
+  AS 'MODULE_PATHNAME', 'tpoint_time_at_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION timeAtDistance(tgeogpoint, float)
+  RETURNS timestamptz
+  AS 'MODULE_PATHNAME', 'tpoint_time_at_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION atDistance(tgeompoint, float)
+  RETURNS geometry
+  AS 'MODULE_PATHNAME', 'tpoint_at_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION atDistance(tgeogpoint, float)
+  RETURNS geography
+  AS 'MODULE_PATHNAME', 'tpoint_at_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION substringByDistance(tgeompoint, float, float)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'tpoint_substring_by_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION substringByDistance(tgeogpoint, float, float)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'tpoint_substring_by_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION speed(tgeompoint)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'tpoint_speed'
@@ -140,7 +167,11 @@ CREATE FUNCTION speed(tgeogpoint)
 
 CREATE FUNCTION twcentroid(tgeompoint)
   RETURNS geometry
-  AS 'MODULE_PATHNAME', 'tgeompoint_twcentroid'
+  AS 'MODULE_PATHNAME', 'tpoint_twcentroid'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION twcentroid(tgeogpoint)
+  RETURNS geography
+  AS 'MODULE_PATHNAME', 'tpoint_twcentroid'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION azimuth(tgeompoint)
@@ -152,6 +183,19 @@ CREATE FUNCTION azimuth(tgeogpoint)
   AS 'MODULE_PATHNAME', 'tpoint_azimuth'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION kinematics(tgeompoint, OUT length float,
+    OUT cumulativeLength tfloat, OUT speed tfloat, OUT azimuth tfloat,
+    OUT acceleration tfloat)
+  RETURNS record
+  AS 'MODULE_PATHNAME', 'tpoint_kinematics'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION kinematics(tgeogpoint, OUT length float,
+    OUT cumulativeLength tfloat, OUT speed tfloat, OUT azimuth tfloat,
+    OUT acceleration tfloat)
+  RETURNS record
+  AS 'MODULE_PATHNAME', 'tpoint_kinematics'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
 
 CREATE FUNCTION atGeometry(tgeompoint, geometry)
@@ -182,4 +226,14 @@ CREATE FUNCTION minusStbox(tgeogpoint, stbox)
   AS 'MODULE_PATHNAME', 'tpoint_minus_stbox'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION spaceTimeSplit(tgeompoint, xsize float, tsize interval)
+  RETURNS TABLE(tile integer, box stbox, temp tgeompoint)
+  AS 'MODULE_PATHNAME', 'tpoint_space_time_split'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION spaceTimeSplit(tgeompoint, xsize float, tsize interval,
+    sorigin geometry, torigin timestamptz)
+  RETURNS TABLE(tile integer, box stbox, temp tgeompoint)
+  AS 'MODULE_PATHNAME', 'tpoint_space_time_split'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -583,4 +583,19 @@ CREATE OPERATOR -|- (
   RESTRICT = tpoint_sel, JOIN = tpoint_joinsel
 );
 
+/*****************************************************************************
+ * Planner support function
+ *****************************************************************************/
+
+#if MOBDB_PGSQL_VERSION >= 120000
+ALTER FUNCTION overlaps_bbox(stbox, tgeompoint)
+  SUPPORT temporal_overlaps_support;
+ALTER FUNCTION overlaps_bbox(tgeompoint, stbox)
+  SUPPORT temporal_overlaps_support;
+ALTER FUNCTION overlaps_bbox(stbox, tgeogpoint)
+  SUPPORT temporal_overlaps_support;
+ALTER FUNCTION overlaps_bbox(tgeogpoint, stbox)
+  SUPPORT temporal_overlaps_support;
+#endif
+
 /*****************************************************************************/
@@ -270,3 +270,29 @@ CREATE FUNCTION shortestLine(tgeogpoint, tgeogpoint)
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Similarity distances
+ *****************************************************************************/
+
+CREATE FUNCTION frechetDistance(tgeompoint, tgeompoint)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'frechet_distance_tpoint_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistance(tgeompoint, tgeompoint)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'dyntimewarp_distance_tpoint_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR <~> (
+  LEFTARG = tgeompoint, RIGHTARG = tgeompoint,
+  PROCEDURE = frechetDistance,
+  COMMUTATOR = '<~>'
+);
+CREATE OPERATOR <~~> (
+  LEFTARG = tgeompoint, RIGHTARG = tgeompoint,
+  PROCEDURE = dynTimeWarpDistance,
+  COMMUTATOR = '<~~>'
+);
+
+/*****************************************************************************/
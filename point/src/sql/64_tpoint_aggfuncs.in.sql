@@ -50,6 +50,7 @@ CREATE FUNCTION tcount_transfn(internal, tgeogpoint)
 CREATE AGGREGATE tcount(tgeompoint) (
   SFUNC = tcount_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tcount_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -59,6 +60,7 @@ CREATE AGGREGATE tcount(tgeompoint) (
 CREATE AGGREGATE tcount(tgeogpoint) (
   SFUNC = tcount_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tcount_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -66,6 +68,63 @@ CREATE AGGREGATE tcount(tgeogpoint) (
   PARALLEL = SAFE
 );
 
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, tgeompoint, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, tgeompoint, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, tgeogpoint, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, tgeogpoint, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE tcountApprox(bigint, tgeompoint, interval) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(bigint, tgeompoint, interval, timestamptz) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(bigint, tgeogpoint, interval) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(bigint, tgeogpoint, interval, timestamptz) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
 CREATE FUNCTION wcount_transfn(internal, tgeompoint, interval)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'temporal_wcount_transfn'
@@ -78,6 +137,7 @@ CREATE FUNCTION wcount_transfn(internal, tgeogpoint, interval)
 CREATE AGGREGATE wcount(tgeompoint, interval) (
   SFUNC = wcount_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tint_tsum_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -87,6 +147,7 @@ CREATE AGGREGATE wcount(tgeompoint, interval) (
 CREATE AGGREGATE wcount(tgeogpoint, interval) (
   SFUNC = wcount_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tint_tsum_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -110,6 +171,7 @@ CREATE FUNCTION tcentroid_finalfn(internal)
 CREATE AGGREGATE tcentroid(tgeompoint) (
   SFUNC = tcentroid_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tcentroid_combinefn,
   FINALFUNC = tcentroid_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -117,4 +179,194 @@ CREATE AGGREGATE tcentroid(tgeompoint) (
   PARALLEL = SAFE
 );
 
+CREATE FUNCTION tcentroid_transfn(internal, tgeogpoint)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_tcentroid_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tgeogpoint_tcentroid_finalfn(internal)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'tpoint_tcentroid_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE tcentroid(tgeogpoint) (
+  SFUNC = tcentroid_transfn,
+  STYPE = internal,
+  SSPACE = 2048,
+  COMBINEFUNC = tcentroid_combinefn,
+  FINALFUNC = tgeogpoint_tcentroid_finalfn,
+  SERIALFUNC = tagg_serialize,
+  DESERIALFUNC = tagg_deserialize,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************/
+
+CREATE FUNCTION append_transfn(internal, tgeompoint)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_append_tinstant_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION append_transfn(internal, tgeogpoint)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_append_tinstant_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tgeompoint_append_finalfn(internal)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'temporal_append_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeogpoint_append_finalfn(internal)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'temporal_append_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE appendInstant(tgeompoint) (
+  SFUNC = append_transfn,
+  STYPE = internal,
+  SSPACE = 1024,
+  FINALFUNC = tgeompoint_append_finalfn,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE appendInstant(tgeogpoint) (
+  SFUNC = append_transfn,
+  STYPE = internal,
+  SSPACE = 1024,
+  FINALFUNC = tgeogpoint_append_finalfn,
+  PARALLEL = SAFE
+);
+
+CREATE FUNCTION append_transfn(internal, tgeompoint, float8)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_append_simplify_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE appendInstant(tgeompoint, float8) (
+  SFUNC = append_transfn,
+  STYPE = internal,
+  SSPACE = 1024,
+  FINALFUNC = tgeompoint_append_finalfn,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************/
+
+CREATE TYPE gridcell AS (
+  cell stbox,
+  duration interval,
+  count integer
+);
+
+CREATE FUNCTION gridOccupancy_transfn(internal, tgeompoint, float8, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_grid_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION gridOccupancy_transfn(internal, tgeompoint, float8, interval,
+    geometry, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_grid_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION gridOccupancy_combinefn(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_grid_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION gridOccupancy_serialize(internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'tpoint_grid_serialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gridOccupancy_deserialize(bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_grid_deserialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gridOccupancy_finalfn(internal)
+  RETURNS gridcell[]
+  AS 'MODULE_PATHNAME', 'tpoint_grid_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE gridOccupancy(tgeompoint, float8, interval) (
+  SFUNC = gridOccupancy_transfn,
+  STYPE = internal,
+  SSPACE = 4096,
+  COMBINEFUNC = gridOccupancy_combinefn,
+  FINALFUNC = gridOccupancy_finalfn,
+  SERIALFUNC = gridOccupancy_serialize,
+  DESERIALFUNC = gridOccupancy_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE gridOccupancy(tgeompoint, float8, interval, geometry,
+    timestamptz) (
+  SFUNC = gridOccupancy_transfn,
+  STYPE = internal,
+  SSPACE = 4096,
+  COMBINEFUNC = gridOccupancy_combinefn,
+  FINALFUNC = gridOccupancy_finalfn,
+  SERIALFUNC = gridOccupancy_serialize,
+  DESERIALFUNC = gridOccupancy_deserialize,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************/
+
+CREATE FUNCTION tgeompointSeqAgg_transfn(internal, geometry, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_fix_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tgeompointSeqAgg_transfn(internal, geometry, timestamptz,
+    maxt interval, maxdist float8)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_fix_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tgeompointSeqAgg_combinefn(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_fix_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tgeompointSeqAgg_serialize(internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'tpoint_fix_serialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeompointSeqAgg_deserialize(bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_fix_deserialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeompointSeqAgg_finalfn(internal)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'tpoint_fix_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE tgeompointSeqAgg(geometry, timestamptz) (
+  SFUNC = tgeompointSeqAgg_transfn,
+  STYPE = internal,
+  COMBINEFUNC = tgeompointSeqAgg_combinefn,
+  FINALFUNC = tgeompointSeqAgg_finalfn,
+  SERIALFUNC = tgeompointSeqAgg_serialize,
+  DESERIALFUNC = tgeompointSeqAgg_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tgeompointSeqAgg(geometry, timestamptz, maxt interval,
+    maxdist float8) (
+  SFUNC = tgeompointSeqAgg_transfn,
+  STYPE = internal,
+  COMBINEFUNC = tgeompointSeqAgg_combinefn,
+  FINALFUNC = tgeompointSeqAgg_finalfn,
+  SERIALFUNC = tgeompointSeqAgg_serialize,
+  DESERIALFUNC = tgeompointSeqAgg_deserialize,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************/
+
+CREATE FUNCTION tsample(tgeompoint, interval)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tgeompoint, interval, timestamptz)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tgeogpoint, interval)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tgeogpoint, interval, timestamptz)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -14,7 +14,10 @@
  *    covers, coveredby, intersects, dwithin
  * All these relationships, excepted disjoint and relate, will automatically 
  * include a bounding box comparison that will make use of any spatial, 
- * temporal, or spatiotemporal indexes that are available.
+ * temporal, or spatiotemporal indexes that are available. For PostgreSQL 12
+ * and later, the comparison is derived by the planner support function
+ * tpoint_supportfn, which also estimates the selectivity of the
+ * relationships.
  * N.B. In the current version of Postgis (2.4) the only index operator 
  * implemented for geography is &&
  *
@@ -25,6 +28,13 @@
  *
  *****************************************************************************/
 
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION tpoint_supportfn(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_supportfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
+
 /*****************************************************************************
  * contains
  *****************************************************************************/
@@ -33,24 +43,48 @@ CREATE FUNCTION _contains(geometry, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'contains_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION contains(geometry, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'contains_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION contains(geometry, tgeompoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.@>) $2 AND @extschema@._contains($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _contains(tgeompoint, geometry)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'contains_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION contains(tgeompoint, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'contains_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION contains(tgeompoint, geometry)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.@>) $2 AND @extschema@._contains($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
 CREATE FUNCTION contains(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'contains_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION contains(tgeompoint, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'contains_tpoint_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************
  * containsproperly
@@ -60,24 +94,48 @@ CREATE FUNCTION _containsproperly(geometry, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'containsproperly_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION containsproperly(geometry, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'containsproperly_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION containsproperly(geometry, tgeompoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.@>) $2 AND @extschema@._containsproperly($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _containsproperly(tgeompoint, geometry)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'containsproperly_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION containsproperly(tgeompoint, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'containsproperly_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION containsproperly(tgeompoint, geometry)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.@>) $2 AND @extschema@._containsproperly($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION containsproperly(tgeompoint, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'containsproperly_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION containsproperly(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'containsproperly_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
     
 /*****************************************************************************
  * covers
@@ -87,24 +145,48 @@ CREATE FUNCTION _covers(geometry, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'covers_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION covers(geometry, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'covers_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION covers(geometry, tgeompoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.@>) $2 AND @extschema@._covers($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _covers(tgeompoint, geometry)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'covers_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION covers(tgeompoint, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'covers_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION covers(tgeompoint, geometry)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.@>) $2 AND @extschema@._covers($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
 CREATE FUNCTION covers(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'covers_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION covers(tgeompoint, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'covers_tpoint_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************/
 
@@ -112,24 +194,48 @@ CREATE FUNCTION _covers(geography, tgeogpoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'covers_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION covers(geography, tgeogpoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'covers_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION covers(geography, tgeogpoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.@>) $2 AND @extschema@._covers($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _covers(tgeogpoint, geography)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'covers_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION covers(tgeogpoint, geography)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'covers_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION covers(tgeogpoint, geography)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.@>) $2 AND @extschema@._covers($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
 CREATE FUNCTION covers(tgeogpoint, tgeogpoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'covers_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION covers(tgeogpoint, tgeogpoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'covers_tpoint_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
       
 /*****************************************************************************
  * coveredby
@@ -139,24 +245,48 @@ CREATE FUNCTION _coveredby(geometry, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'coveredby_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION coveredby(geometry, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'coveredby_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION coveredby(geometry, tgeompoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.<@) $2 AND @extschema@._coveredby($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _coveredby(tgeompoint, geometry)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'coveredby_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION coveredby(tgeompoint, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'coveredby_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION coveredby(tgeompoint, geometry)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.<@) $2 AND @extschema@._coveredby($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
 CREATE FUNCTION coveredby(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'coveredby_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION coveredby(tgeompoint, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'coveredby_tpoint_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************/
 
@@ -164,24 +294,48 @@ CREATE FUNCTION _coveredby(geography, tgeogpoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'coveredby_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION coveredby(geography, tgeogpoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'coveredby_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION coveredby(geography, tgeogpoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.<@) $2 AND @extschema@._coveredby($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _coveredby(tgeogpoint, geography)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'coveredby_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION coveredby(tgeogpoint, geography)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'coveredby_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION coveredby(tgeogpoint, geography)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.<@) $2 AND @extschema@._coveredby($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION coveredby(tgeogpoint, tgeogpoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'coveredby_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION coveredby(tgeogpoint, tgeogpoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'coveredby_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
     
 /*****************************************************************************
  * crosses
@@ -191,24 +345,48 @@ CREATE FUNCTION _crosses(geometry, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'crosses_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION crosses(geometry, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'crosses_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION crosses(geometry, tgeompoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) $2 AND @extschema@._crosses($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _crosses(tgeompoint, geometry)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'crosses_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION crosses(tgeompoint, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'crosses_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION crosses(tgeompoint, geometry)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) $2 AND @extschema@._crosses($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION crosses(tgeompoint, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'crosses_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION crosses(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'crosses_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************
  * disjoint
@@ -235,24 +413,48 @@ CREATE FUNCTION _equals(geometry, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'equals_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION equals(geometry, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'equals_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION equals(geometry, tgeompoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.~=) $2 AND @extschema@._equals($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _equals(tgeompoint, geometry)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'equals_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION equals(tgeompoint, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'equals_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION equals(tgeompoint, geometry)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.~=) $2 AND @extschema@._equals($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION equals(tgeompoint, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'equals_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION equals(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'equals_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************
  * intersects
@@ -262,24 +464,48 @@ CREATE FUNCTION _intersects(geometry, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'intersects_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION intersects(geometry, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'intersects_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION intersects(geometry, tgeompoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) $2 AND @extschema@._intersects($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _intersects(tgeompoint, geometry)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'intersects_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION intersects(tgeompoint, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'intersects_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION intersects(tgeompoint, geometry)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) $2 AND @extschema@._intersects($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
 CREATE FUNCTION intersects(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'intersects_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION intersects(tgeompoint, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'intersects_tpoint_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************/
 
@@ -287,24 +513,48 @@ CREATE FUNCTION _intersects(geography, tgeogpoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'intersects_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION intersects(geography, tgeogpoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'intersects_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION intersects(geography, tgeogpoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) $2 AND @extschema@._intersects($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _intersects(tgeogpoint, geography)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'intersects_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION intersects(tgeogpoint, geography)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'intersects_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION intersects(tgeogpoint, geography)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) $2 AND @extschema@._intersects($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION intersects(tgeogpoint, tgeogpoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'intersects_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION intersects(tgeogpoint, tgeogpoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'intersects_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************
  * overlaps
@@ -314,24 +564,48 @@ CREATE FUNCTION _overlaps(geometry, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'overlaps_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION overlaps(geometry, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'overlaps_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION overlaps(geometry, tgeompoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) $2 AND @extschema@._overlaps($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _overlaps(tgeompoint, geometry)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'overlaps_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION overlaps(tgeompoint, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'overlaps_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION overlaps(tgeompoint, geometry)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) $2 AND @extschema@._overlaps($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
 CREATE FUNCTION overlaps(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'overlaps_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION overlaps(tgeompoint, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'overlaps_tpoint_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************
  * touches
@@ -341,24 +615,48 @@ CREATE FUNCTION _touches(geometry, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'touches_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION touches(geometry, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'touches_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION touches(geometry, tgeompoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) $2 AND @extschema@._touches($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _touches(tgeompoint, geometry)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'touches_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION touches(tgeompoint, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'touches_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION touches(tgeompoint, geometry)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) $2 AND @extschema@._touches($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION touches(tgeompoint, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'touches_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION touches(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'touches_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************
  * within
@@ -368,24 +666,48 @@ CREATE FUNCTION _within(geometry, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'within_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION within(geometry, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'within_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION within(geometry, tgeompoint)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.<@) $2 AND @extschema@._within($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _within(tgeompoint, geometry)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'within_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION within(tgeompoint, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'within_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION within(tgeompoint, geometry)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.<@) $2 AND @extschema@._within($1,$2)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
 CREATE FUNCTION within(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'within_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION within(tgeompoint, tgeompoint)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'within_tpoint_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************
  * dwithin
@@ -395,24 +717,48 @@ CREATE FUNCTION _dwithin(geometry, tgeompoint, dist float8)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'dwithin_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION dwithin(geometry, tgeompoint, dist float8)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'dwithin_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION dwithin(geometry, tgeompoint, dist float8)
   RETURNS boolean
   AS 'SELECT @extschema@.ST_Expand($1,$3) OPERATOR(@extschema@.&&) $2 AND @extschema@._dwithin($1, $2, $3)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _dwithin(tgeompoint, geometry, dist float8)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'dwithin_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION dwithin(tgeompoint, geometry, dist float8)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'dwithin_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION dwithin(tgeompoint, geometry, dist float8)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) @extschema@.ST_Expand($2,$3)  AND @extschema@._dwithin($1, $2, $3)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
 CREATE FUNCTION dwithin(tgeompoint, tgeompoint, dist float8)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'dwithin_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION dwithin(tgeompoint, tgeompoint, dist float8)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'dwithin_tpoint_tpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************/
 
@@ -420,24 +766,48 @@ CREATE FUNCTION _dwithin(geography, tgeogpoint, dist float8)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'dwithin_geo_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION dwithin(geography, tgeogpoint, dist float8)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'dwithin_geo_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION dwithin(geography, tgeogpoint, dist float8)
   RETURNS boolean
   AS 'SELECT @extschema@._ST_Expand($1,$3) OPERATOR(@extschema@.&&) $2 AND @extschema@._dwithin($1, $2, $3)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION _dwithin(tgeogpoint, geography, dist float8)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'dwithin_tpoint_geo'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION dwithin(tgeogpoint, geography, dist float8)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'dwithin_tpoint_geo'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION dwithin(tgeogpoint, geography, dist float8)
   RETURNS boolean
   AS 'SELECT $1 OPERATOR(@extschema@.&&) @extschema@._ST_Expand($2,$3) AND @extschema@._dwithin($1, $2, $3)'
   LANGUAGE 'sql' IMMUTABLE PARALLEL SAFE;
+#endif
   
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION dwithin(tgeogpoint, tgeogpoint, dist float8)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'dwithin_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION dwithin(tgeogpoint, tgeogpoint, dist float8)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'dwithin_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
   
 /*****************************************************************************
  * relate (2 arguments)
@@ -132,6 +132,10 @@ CREATE FUNCTION tintersects(tgeompoint, tgeompoint)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'tintersects_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tintersects(tgeompoint, geometry[])
+  RETURNS TABLE(geo integer, tintersects tbool)
+  AS 'MODULE_PATHNAME', 'tintersects_tpoint_geoarr'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION tintersects(tgeogpoint, tgeogpoint)
   RETURNS tbool
@@ -181,6 +185,11 @@ CREATE FUNCTION tdwithin(tgeompoint, tgeompoint, dist float8)
   AS 'MODULE_PATHNAME', 'tdwithin_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION tdwithinPairs(ids integer[], temps tgeompoint[], dist float8)
+  RETURNS TABLE(id1 integer, id2 integer, tdwithin tbool)
+  AS 'MODULE_PATHNAME', 'tdwithin_pairs'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION tdwithin(tgeogpoint, tgeogpoint, dist float8)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'tdwithin_tpoint_tpoint'
@@ -22,6 +22,12 @@ CREATE FUNCTION stbox_gist_penalty(internal, internal, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'stbox_gist_penalty'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 140000
+CREATE FUNCTION stbox_gist_sortsupport(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'stbox_gist_sortsupport'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
 #if MOBDB_PGSQL_VERSION < 110000
 CREATE FUNCTION tpoint_gist_decompress(internal)
   RETURNS internal
@@ -36,6 +42,10 @@ CREATE FUNCTION stbox_gist_same(stbox, stbox, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'stbox_gist_same'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox_gist_fetch(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION stbox_gist_distance(internal, stbox, smallint, oid, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'stbox_gist_distance'
@@ -113,10 +123,17 @@ CREATE OPERATOR CLASS stbox_gist_ops
   -- functions
   FUNCTION  1  stbox_gist_consistent(internal, stbox, smallint, oid, internal),
   FUNCTION  2  stbox_gist_union(internal, internal),
+#if MOBDB_PGSQL_VERSION >= 130000
+  FUNCTION  10  box_gist_options(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  stbox_gist_sortsupport(internal),
+#endif
   FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  stbox_gist_picksplit(internal, internal),
   FUNCTION  7  stbox_gist_same(stbox, stbox, internal),
-  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal);
+  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal),
+  FUNCTION  9  stbox_gist_fetch(internal);
 
 /******************************************************************************/
 
@@ -192,6 +209,9 @@ CREATE OPERATOR CLASS gist_tgeompoint_ops
   OPERATOR  25    |=| (tgeompoint, geometry) FOR ORDER BY pg_catalog.float_ops,
   OPERATOR  25    |=| (tgeompoint, stbox) FOR ORDER BY pg_catalog.float_ops,
   OPERATOR  25    |=| (tgeompoint, tgeompoint) FOR ORDER BY pg_catalog.float_ops,
+  -- similarity distances
+  OPERATOR  26    <~> (tgeompoint, tgeompoint) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  27    <~~> (tgeompoint, tgeompoint) FOR ORDER BY pg_catalog.float_ops,
   -- overlaps or before
   OPERATOR  28    &<# (tgeompoint, stbox),
   OPERATOR  28    &<# (tgeompoint, tgeompoint),
@@ -226,6 +246,12 @@ CREATE OPERATOR CLASS gist_tgeompoint_ops
   FUNCTION  3  tpoint_gist_compress(internal),
 #if MOBDB_PGSQL_VERSION < 110000
   FUNCTION  4  tpoint_gist_decompress(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 130000
+  FUNCTION  10  box_gist_options(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  stbox_gist_sortsupport(internal),
 #endif
   FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  stbox_gist_picksplit(internal, internal),
@@ -277,10 +303,503 @@ CREATE OPERATOR CLASS gist_tgeogpoint_ops
   FUNCTION  3  tpoint_gist_compress(internal),
 #if MOBDB_PGSQL_VERSION < 110000
   FUNCTION  4  tpoint_gist_decompress(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 130000
+  FUNCTION  10  box_gist_options(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  stbox_gist_sortsupport(internal),
 #endif
   FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  stbox_gist_picksplit(internal, internal),
   FUNCTION  7  stbox_gist_same(stbox, stbox, internal),
   FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal);
   
+/******************************************************************************
+ * Multi-box GiST index for temporal geometric points
+ ******************************************************************************/
+
+CREATE FUNCTION tpoint_gist_multi_consistent(internal, tgeompoint, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'tpoint_gist_multi_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_multi_union(internal, internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'tpoint_gist_multi_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_multi_compress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_gist_multi_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_multi_penalty(internal, internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_gist_multi_penalty'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_multi_picksplit(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_gist_multi_picksplit'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_multi_same(bytea, bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_gist_multi_same'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_multi_distance(internal, tgeompoint, smallint, oid, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_gist_multi_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS gist_tgeompoint_multi_ops
+  FOR TYPE tgeompoint USING gist AS
+  STORAGE bytea,
+  -- strictly left
+  OPERATOR  1    << (tgeompoint, geometry),  
+  OPERATOR  1    << (tgeompoint, stbox),  
+  OPERATOR  1    << (tgeompoint, tgeompoint),  
+  -- overlaps or left
+  OPERATOR  2    &< (tgeompoint, geometry),  
+  OPERATOR  2    &< (tgeompoint, stbox),  
+  OPERATOR  2    &< (tgeompoint, tgeompoint),  
+  -- overlaps  
+  OPERATOR  3    && (tgeompoint, geometry),  
+  OPERATOR  3    && (tgeompoint, stbox),  
+  OPERATOR  3    && (tgeompoint, tgeompoint),  
+  -- overlaps or right
+  OPERATOR  4    &> (tgeompoint, geometry),  
+  OPERATOR  4    &> (tgeompoint, stbox),  
+  OPERATOR  4    &> (tgeompoint, tgeompoint),  
+    -- strictly right
+  OPERATOR  5    >> (tgeompoint, geometry),  
+  OPERATOR  5    >> (tgeompoint, stbox),  
+  OPERATOR  5    >> (tgeompoint, tgeompoint),  
+    -- same
+  OPERATOR  6    ~= (tgeompoint, geometry),  
+  OPERATOR  6    ~= (tgeompoint, stbox),  
+  OPERATOR  6    ~= (tgeompoint, tgeompoint),  
+  -- contains
+  OPERATOR  7    @> (tgeompoint, geometry),  
+  OPERATOR  7    @> (tgeompoint, stbox),  
+  OPERATOR  7    @> (tgeompoint, tgeompoint),  
+  -- contained by
+  OPERATOR  8    <@ (tgeompoint, geometry),  
+  OPERATOR  8    <@ (tgeompoint, stbox),  
+  OPERATOR  8    <@ (tgeompoint, tgeompoint),  
+  -- overlaps or below
+  OPERATOR  9    &<| (tgeompoint, geometry),  
+  OPERATOR  9    &<| (tgeompoint, stbox),  
+  OPERATOR  9    &<| (tgeompoint, tgeompoint),  
+  -- strictly below
+  OPERATOR  10    <<| (tgeompoint, geometry),  
+  OPERATOR  10    <<| (tgeompoint, stbox),  
+  OPERATOR  10    <<| (tgeompoint, tgeompoint),  
+  -- strictly above
+  OPERATOR  11    |>> (tgeompoint, geometry),  
+  OPERATOR  11    |>> (tgeompoint, stbox),  
+  OPERATOR  11    |>> (tgeompoint, tgeompoint),  
+  -- overlaps or above
+  OPERATOR  12    |&> (tgeompoint, geometry),  
+  OPERATOR  12    |&> (tgeompoint, stbox),  
+  OPERATOR  12    |&> (tgeompoint, tgeompoint),  
+  -- adjacent
+  OPERATOR  17    -|- (tgeompoint, geometry),
+  OPERATOR  17    -|- (tgeompoint, stbox),
+  OPERATOR  17    -|- (tgeompoint, tgeompoint),
+  -- nearest approach distance
+  OPERATOR  25    |=| (tgeompoint, geometry) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tgeompoint, stbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tgeompoint, tgeompoint) FOR ORDER BY pg_catalog.float_ops,
+  -- similarity distances
+  OPERATOR  26    <~> (tgeompoint, tgeompoint) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  27    <~~> (tgeompoint, tgeompoint) FOR ORDER BY pg_catalog.float_ops,
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeompoint, stbox),
+  OPERATOR  28    &<# (tgeompoint, tgeompoint),
+  -- strictly before
+  OPERATOR  29    <<# (tgeompoint, stbox),
+  OPERATOR  29    <<# (tgeompoint, tgeompoint),
+  -- strictly after
+  OPERATOR  30    #>> (tgeompoint, stbox),
+  OPERATOR  30    #>> (tgeompoint, tgeompoint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeompoint, stbox),
+  OPERATOR  31    #&> (tgeompoint, tgeompoint),
+  -- overlaps or front
+  OPERATOR  32    &</ (tgeompoint, geometry),
+  OPERATOR  32    &</ (tgeompoint, stbox),
+  OPERATOR  32    &</ (tgeompoint, tgeompoint),
+  -- strictly front
+  OPERATOR  33    <</ (tgeompoint, geometry),
+  OPERATOR  33    <</ (tgeompoint, stbox),
+  OPERATOR  33    <</ (tgeompoint, tgeompoint),
+  -- strictly back
+  OPERATOR  34    />> (tgeompoint, geometry),
+  OPERATOR  34    />> (tgeompoint, stbox),
+  OPERATOR  34    />> (tgeompoint, tgeompoint),
+  -- overlaps or back
+  OPERATOR  35    /&> (tgeompoint, geometry),
+  OPERATOR  35    /&> (tgeompoint, stbox),
+  OPERATOR  35    /&> (tgeompoint, tgeompoint),
+  -- functions
+  FUNCTION  1  tpoint_gist_multi_consistent(internal, tgeompoint, smallint, oid, internal),
+  FUNCTION  2  tpoint_gist_multi_union(internal, internal),
+  FUNCTION  3  tpoint_gist_multi_compress(internal),
+#if MOBDB_PGSQL_VERSION < 110000
+  FUNCTION  4  tpoint_gist_decompress(internal),
+#endif
+  FUNCTION  5  tpoint_gist_multi_penalty(internal, internal, internal),
+  FUNCTION  6  tpoint_gist_multi_picksplit(internal, internal),
+  FUNCTION  7  tpoint_gist_multi_same(bytea, bytea, internal),
+  FUNCTION  8  tpoint_gist_multi_distance(internal, tgeompoint, smallint, oid, internal);
+
+/******************************************************************************
+ * Compact GiST index for temporal geometric points
+ ******************************************************************************/
+
+CREATE FUNCTION tpoint_gist_compact_consistent(internal, tgeompoint, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'tpoint_gist_compact_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_compact_union(internal, internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'tpoint_gist_compact_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_compact_compress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_gist_compact_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_compact_penalty(internal, internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_gist_compact_penalty'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_compact_picksplit(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_gist_compact_picksplit'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_compact_same(bytea, bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_gist_compact_same'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist_compact_distance(internal, tgeompoint, smallint, oid, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tpoint_gist_compact_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS gist_tgeompoint_compact_ops
+  FOR TYPE tgeompoint USING gist AS
+  STORAGE bytea,
+  -- strictly left
+  OPERATOR  1    << (tgeompoint, geometry),  
+  OPERATOR  1    << (tgeompoint, stbox),  
+  OPERATOR  1    << (tgeompoint, tgeompoint),  
+  -- overlaps or left
+  OPERATOR  2    &< (tgeompoint, geometry),  
+  OPERATOR  2    &< (tgeompoint, stbox),  
+  OPERATOR  2    &< (tgeompoint, tgeompoint),  
+  -- overlaps  
+  OPERATOR  3    && (tgeompoint, geometry),  
+  OPERATOR  3    && (tgeompoint, stbox),  
+  OPERATOR  3    && (tgeompoint, tgeompoint),  
+  -- overlaps or right
+  OPERATOR  4    &> (tgeompoint, geometry),  
+  OPERATOR  4    &> (tgeompoint, stbox),  
+  OPERATOR  4    &> (tgeompoint, tgeompoint),  
+    -- strictly right
+  OPERATOR  5    >> (tgeompoint, geometry),  
+  OPERATOR  5    >> (tgeompoint, stbox),  
+  OPERATOR  5    >> (tgeompoint, tgeompoint),  
+    -- same
+  OPERATOR  6    ~= (tgeompoint, geometry),  
+  OPERATOR  6    ~= (tgeompoint, stbox),  
+  OPERATOR  6    ~= (tgeompoint, tgeompoint),  
+  -- contains
+  OPERATOR  7    @> (tgeompoint, geometry),  
+  OPERATOR  7    @> (tgeompoint, stbox),  
+  OPERATOR  7    @> (tgeompoint, tgeompoint),  
+  -- contained by
+  OPERATOR  8    <@ (tgeompoint, geometry),  
+  OPERATOR  8    <@ (tgeompoint, stbox),  
+  OPERATOR  8    <@ (tgeompoint, tgeompoint),  
+  -- overlaps or below
+  OPERATOR  9    &<| (tgeompoint, geometry),  
+  OPERATOR  9    &<| (tgeompoint, stbox),  
+  OPERATOR  9    &<| (tgeompoint, tgeompoint),  
+  -- strictly below
+  OPERATOR  10    <<| (tgeompoint, geometry),  
+  OPERATOR  10    <<| (tgeompoint, stbox),  
+  OPERATOR  10    <<| (tgeompoint, tgeompoint),  
+  -- strictly above
+  OPERATOR  11    |>> (tgeompoint, geometry),  
+  OPERATOR  11    |>> (tgeompoint, stbox),  
+  OPERATOR  11    |>> (tgeompoint, tgeompoint),  
+  -- overlaps or above
+  OPERATOR  12    |&> (tgeompoint, geometry),  
+  OPERATOR  12    |&> (tgeompoint, stbox),  
+  OPERATOR  12    |&> (tgeompoint, tgeompoint),  
+  -- adjacent
+  OPERATOR  17    -|- (tgeompoint, geometry),
+  OPERATOR  17    -|- (tgeompoint, stbox),
+  OPERATOR  17    -|- (tgeompoint, tgeompoint),
+  -- nearest approach distance
+  OPERATOR  25    |=| (tgeompoint, geometry) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tgeompoint, stbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tgeompoint, tgeompoint) FOR ORDER BY pg_catalog.float_ops,
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeompoint, stbox),
+  OPERATOR  28    &<# (tgeompoint, tgeompoint),
+  -- strictly before
+  OPERATOR  29    <<# (tgeompoint, stbox),
+  OPERATOR  29    <<# (tgeompoint, tgeompoint),
+  -- strictly after
+  OPERATOR  30    #>> (tgeompoint, stbox),
+  OPERATOR  30    #>> (tgeompoint, tgeompoint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeompoint, stbox),
+  OPERATOR  31    #&> (tgeompoint, tgeompoint),
+  -- overlaps or front
+  OPERATOR  32    &</ (tgeompoint, geometry),
+  OPERATOR  32    &</ (tgeompoint, stbox),
+  OPERATOR  32    &</ (tgeompoint, tgeompoint),
+  -- strictly front
+  OPERATOR  33    <</ (tgeompoint, geometry),
+  OPERATOR  33    <</ (tgeompoint, stbox),
+  OPERATOR  33    <</ (tgeompoint, tgeompoint),
+  -- strictly back
+  OPERATOR  34    />> (tgeompoint, geometry),
+  OPERATOR  34    />> (tgeompoint, stbox),
+  OPERATOR  34    />> (tgeompoint, tgeompoint),
+  -- overlaps or back
+  OPERATOR  35    /&> (tgeompoint, geometry),
+  OPERATOR  35    /&> (tgeompoint, stbox),
+  OPERATOR  35    /&> (tgeompoint, tgeompoint),
+  -- functions
+  FUNCTION  1  tpoint_gist_compact_consistent(internal, tgeompoint, smallint, oid, internal),
+  FUNCTION  2  tpoint_gist_compact_union(internal, internal),
+  FUNCTION  3  tpoint_gist_compact_compress(internal),
+#if MOBDB_PGSQL_VERSION < 110000
+  FUNCTION  4  tpoint_gist_decompress(internal),
+#endif
+  FUNCTION  5  tpoint_gist_compact_penalty(internal, internal, internal),
+  FUNCTION  6  tpoint_gist_compact_picksplit(internal, internal),
+  FUNCTION  7  tpoint_gist_compact_same(bytea, bytea, internal),
+  FUNCTION  8  tpoint_gist_compact_distance(internal, tgeompoint, smallint, oid, internal);
+
+/******************************************************************************
+ * BRIN index for temporal points and spatiotemporal boxes
+ ******************************************************************************/
+
+CREATE FUNCTION stbox_brin_opcinfo(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'stbox_brin_opcinfo'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox_brin_add_value(internal, internal, internal, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'stbox_brin_add_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox_brin_consistent(internal, internal, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'stbox_brin_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox_brin_union(internal, internal, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'stbox_brin_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS stbox_brin_ops
+  DEFAULT FOR TYPE stbox USING brin AS
+  -- strictly left
+  OPERATOR  1    << (stbox, stbox),
+  OPERATOR  1    << (stbox, tgeompoint),
+  -- overlaps or left
+  OPERATOR  2    &< (stbox, stbox),
+  OPERATOR  2    &< (stbox, tgeompoint),
+  -- overlaps
+  OPERATOR  3    && (stbox, stbox),
+  OPERATOR  3    && (stbox, tgeompoint),
+  -- overlaps or right
+  OPERATOR  4    &> (stbox, stbox),
+  OPERATOR  4    &> (stbox, tgeompoint),
+    -- strictly right
+  OPERATOR  5    >> (stbox, stbox),
+  OPERATOR  5    >> (stbox, tgeompoint),
+    -- same
+  OPERATOR  6    ~= (stbox, stbox),
+  OPERATOR  6    ~= (stbox, tgeompoint),
+  -- contains
+  OPERATOR  7    @> (stbox, stbox),
+  OPERATOR  7    @> (stbox, tgeompoint),
+  -- contained by
+  OPERATOR  8    <@ (stbox, stbox),
+  OPERATOR  8    <@ (stbox, tgeompoint),
+  -- overlaps or below
+  OPERATOR  9    &<| (stbox, stbox),
+  OPERATOR  9    &<| (stbox, tgeompoint),
+  -- strictly below
+  OPERATOR  10    <<| (stbox, stbox),
+  OPERATOR  10    <<| (stbox, tgeompoint),
+  -- strictly above
+  OPERATOR  11    |>> (stbox, stbox),
+  OPERATOR  11    |>> (stbox, tgeompoint),
+  -- overlaps or above
+  OPERATOR  12    |&> (stbox, stbox),
+  OPERATOR  12    |&> (stbox, tgeompoint),
+  -- adjacent
+  OPERATOR  17    -|- (stbox, stbox),
+  OPERATOR  17    -|- (stbox, tgeompoint),
+  -- overlaps or before
+  OPERATOR  28    &<# (stbox, stbox),
+  OPERATOR  28    &<# (stbox, tgeompoint),
+  -- strictly before
+  OPERATOR  29    <<# (stbox, stbox),
+  OPERATOR  29    <<# (stbox, tgeompoint),
+  -- strictly after
+  OPERATOR  30    #>> (stbox, stbox),
+  OPERATOR  30    #>> (stbox, tgeompoint),
+  -- overlaps or after
+  OPERATOR  31    #&> (stbox, stbox),
+  OPERATOR  31    #&> (stbox, tgeompoint),
+  -- overlaps or front
+  OPERATOR  32    &</ (stbox, stbox),
+  OPERATOR  32    &</ (stbox, tgeompoint),
+  -- strictly front
+  OPERATOR  33    <</ (stbox, stbox),
+  OPERATOR  33    <</ (stbox, tgeompoint),
+  -- strictly back
+  OPERATOR  34    />> (stbox, stbox),
+  OPERATOR  34    />> (stbox, tgeompoint),
+  -- overlaps or back
+  OPERATOR  35    /&> (stbox, stbox),
+  OPERATOR  35    /&> (stbox, tgeompoint),
+  -- functions
+  FUNCTION  1  stbox_brin_opcinfo(internal),
+  FUNCTION  2  stbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  stbox_brin_consistent(internal, internal, internal),
+  FUNCTION  4  stbox_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS brin_tgeompoint_ops
+  DEFAULT FOR TYPE tgeompoint USING brin AS
+  -- strictly left
+  OPERATOR  1    << (tgeompoint, geometry),  
+  OPERATOR  1    << (tgeompoint, stbox),  
+  OPERATOR  1    << (tgeompoint, tgeompoint),  
+  -- overlaps or left
+  OPERATOR  2    &< (tgeompoint, geometry),  
+  OPERATOR  2    &< (tgeompoint, stbox),  
+  OPERATOR  2    &< (tgeompoint, tgeompoint),  
+  -- overlaps  
+  OPERATOR  3    && (tgeompoint, geometry),  
+  OPERATOR  3    && (tgeompoint, stbox),  
+  OPERATOR  3    && (tgeompoint, tgeompoint),  
+  -- overlaps or right
+  OPERATOR  4    &> (tgeompoint, geometry),  
+  OPERATOR  4    &> (tgeompoint, stbox),  
+  OPERATOR  4    &> (tgeompoint, tgeompoint),  
+    -- strictly right
+  OPERATOR  5    >> (tgeompoint, geometry),  
+  OPERATOR  5    >> (tgeompoint, stbox),  
+  OPERATOR  5    >> (tgeompoint, tgeompoint),  
+    -- same
+  OPERATOR  6    ~= (tgeompoint, geometry),  
+  OPERATOR  6    ~= (tgeompoint, stbox),  
+  OPERATOR  6    ~= (tgeompoint, tgeompoint),  
+  -- contains
+  OPERATOR  7    @> (tgeompoint, geometry),  
+  OPERATOR  7    @> (tgeompoint, stbox),  
+  OPERATOR  7    @> (tgeompoint, tgeompoint),  
+  -- contained by
+  OPERATOR  8    <@ (tgeompoint, geometry),  
+  OPERATOR  8    <@ (tgeompoint, stbox),  
+  OPERATOR  8    <@ (tgeompoint, tgeompoint),  
+  -- overlaps or below
+  OPERATOR  9    &<| (tgeompoint, geometry),  
+  OPERATOR  9    &<| (tgeompoint, stbox),  
+  OPERATOR  9    &<| (tgeompoint, tgeompoint),  
+  -- strictly below
+  OPERATOR  10    <<| (tgeompoint, geometry),  
+  OPERATOR  10    <<| (tgeompoint, stbox),  
+  OPERATOR  10    <<| (tgeompoint, tgeompoint),  
+  -- strictly above
+  OPERATOR  11    |>> (tgeompoint, geometry),  
+  OPERATOR  11    |>> (tgeompoint, stbox),  
+  OPERATOR  11    |>> (tgeompoint, tgeompoint),  
+  -- overlaps or above
+  OPERATOR  12    |&> (tgeompoint, geometry),  
+  OPERATOR  12    |&> (tgeompoint, stbox),  
+  OPERATOR  12    |&> (tgeompoint, tgeompoint),  
+  -- adjacent
+  OPERATOR  17    -|- (tgeompoint, geometry),
+  OPERATOR  17    -|- (tgeompoint, stbox),
+  OPERATOR  17    -|- (tgeompoint, tgeompoint),
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeompoint, stbox),
+  OPERATOR  28    &<# (tgeompoint, tgeompoint),
+  -- strictly before
+  OPERATOR  29    <<# (tgeompoint, stbox),
+  OPERATOR  29    <<# (tgeompoint, tgeompoint),
+  -- strictly after
+  OPERATOR  30    #>> (tgeompoint, stbox),
+  OPERATOR  30    #>> (tgeompoint, tgeompoint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeompoint, stbox),
+  OPERATOR  31    #&> (tgeompoint, tgeompoint),
+  -- overlaps or front
+  OPERATOR  32    &</ (tgeompoint, geometry),
+  OPERATOR  32    &</ (tgeompoint, stbox),
+  OPERATOR  32    &</ (tgeompoint, tgeompoint),
+  -- strictly front
+  OPERATOR  33    <</ (tgeompoint, geometry),
+  OPERATOR  33    <</ (tgeompoint, stbox),
+  OPERATOR  33    <</ (tgeompoint, tgeompoint),
+  -- strictly back
+  OPERATOR  34    />> (tgeompoint, geometry),
+  OPERATOR  34    />> (tgeompoint, stbox),
+  OPERATOR  34    />> (tgeompoint, tgeompoint),
+  -- overlaps or back
+  OPERATOR  35    /&> (tgeompoint, geometry),
+  OPERATOR  35    /&> (tgeompoint, stbox),
+  OPERATOR  35    /&> (tgeompoint, tgeompoint),
+  -- functions
+  FUNCTION  1  stbox_brin_opcinfo(internal),
+  FUNCTION  2  stbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  stbox_brin_consistent(internal, internal, internal),
+  FUNCTION  4  stbox_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS brin_tgeogpoint_ops
+  DEFAULT FOR TYPE tgeogpoint USING brin AS
+  -- overlaps
+  OPERATOR  3    && (tgeogpoint, geography),  
+  OPERATOR  3    && (tgeogpoint, stbox),  
+  OPERATOR  3    && (tgeogpoint, tgeogpoint),  
+    -- same
+  OPERATOR  6    ~= (tgeogpoint, geography),  
+  OPERATOR  6    ~= (tgeogpoint, stbox),  
+  OPERATOR  6    ~= (tgeogpoint, tgeogpoint),  
+  -- contains
+  OPERATOR  7    @> (tgeogpoint, geography),  
+  OPERATOR  7    @> (tgeogpoint, stbox),  
+  OPERATOR  7    @> (tgeogpoint, tgeogpoint),  
+  -- contained by
+  OPERATOR  8    <@ (tgeogpoint, geography),  
+  OPERATOR  8    <@ (tgeogpoint, stbox),  
+  OPERATOR  8    <@ (tgeogpoint, tgeogpoint),  
+  -- adjacent
+  OPERATOR  17    -|- (tgeogpoint, geography),
+  OPERATOR  17    -|- (tgeogpoint, stbox),
+  OPERATOR  17    -|- (tgeogpoint, tgeogpoint),
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeogpoint, stbox),
+  OPERATOR  28    &<# (tgeogpoint, tgeogpoint),
+  -- strictly before
+  OPERATOR  29    <<# (tgeogpoint, stbox),
+  OPERATOR  29    <<# (tgeogpoint, tgeogpoint),
+  -- strictly after
+  OPERATOR  30    #>> (tgeogpoint, stbox),
+  OPERATOR  30    #>> (tgeogpoint, tgeogpoint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeogpoint, stbox),
+  OPERATOR  31    #&> (tgeogpoint, tgeogpoint),
+  -- functions
+  FUNCTION  1  stbox_brin_opcinfo(internal),
+  FUNCTION  2  stbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  stbox_brin_consistent(internal, internal, internal),
+  FUNCTION  4  stbox_brin_union(internal, internal, internal);
+
 /******************************************************************************/
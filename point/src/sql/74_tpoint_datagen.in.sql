@@ -15,4 +15,27 @@ CREATE FUNCTION create_trip(record[], timestamptz, boolean, text)
   AS 'MODULE_PATHNAME', 'create_trip'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/*
+ * The records of the edges start with the identifier of the trip, the
+ * consecutive edges with the same identifier compose a trip
+ */
+CREATE FUNCTION create_trips(record[], timestamptz[], boolean, text,
+    OUT id integer, OUT trip tgeompoint)
+  RETURNS SETOF record
+  AS 'MODULE_PATHNAME', 'create_trips'
+  LANGUAGE C VOLATILE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
+
+/*
+ * The distribution is one of uniform, gaussian, and walk
+ */
+CREATE FUNCTION generate_tgeompoints(count integer, length integer,
+    box stbox, p period, step interval DEFAULT '1 minute',
+    distribution text DEFAULT 'uniform', linear boolean DEFAULT true,
+    seed integer DEFAULT 1)
+  RETURNS SETOF tgeompoint
+  AS 'MODULE_PATHNAME', 'generate_tgeompoints'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
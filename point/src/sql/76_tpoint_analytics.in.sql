@@ -74,4 +74,10 @@ RETURNS tgeompoint
 AS 'MODULE_PATHNAME', 'tpoint_simplify'
 LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE OR REPLACE FUNCTION withSimplifyLevels(tgeompoint, float8,
+  integer DEFAULT 8)
+RETURNS tgeompoint
+AS 'MODULE_PATHNAME', 'tpoint_with_simplify_levels'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -22,6 +22,7 @@
 #include "temporal_util.h"
 #include "tnumber_mathfuncs.h"
 #include "tpoint.h"
+#include "tpoint_boxops.h"
 #include "tpoint_parser.h"
 #include "tpoint_spatialfuncs.h"
 
@@ -1045,6 +1046,20 @@ stbox_stbox_flags(const STBOX *box1, const STBOX *box2, bool *hasx,
   return;
 }
   
+/**
+ * Ensure that the spatiotemporal boxes satisfy the conditions of the
+ * topological and position operators
+ */
+void
+ensure_valid_stbox_stbox(const STBOX *box1, const STBOX *box2)
+{
+  ensure_common_dimension_stbox(box1, box2);
+  ensure_same_geodetic_stbox(box1, box2);
+  ensure_same_srid_stbox(box1, box2);
+  ensure_same_spatial_dimensionality_stbox(box1, box2);
+  return;
+}
+
 /**
  * Verify the conditions and set the ouput variables with the values of the
  * flags of the boxes.
@@ -1056,10 +1071,7 @@ static void
 topo_stbox_stbox_init(const STBOX *box1, const STBOX *box2, bool *hasx,
   bool *hasz, bool *hast, bool *geodetic)
 {
-  ensure_common_dimension_stbox(box1, box2);
-  ensure_same_geodetic_stbox(box1, box2);
-  ensure_same_srid_stbox(box1, box2);
-  ensure_same_spatial_dimensionality_stbox(box1, box2);
+  ensure_valid_stbox_stbox(box1, box2);
   stbox_stbox_flags(box1, box2, hasx, hasz, hast, geodetic);
   return;
 }
@@ -1124,16 +1136,7 @@ contained_stbox_stbox(PG_FUNCTION_ARGS)
 bool
 overlaps_stbox_stbox_internal(const STBOX *box1, const STBOX *box2)
 {
-  bool hasx, hasz, hast, geodetic;
-  topo_stbox_stbox_init(box1, box2, &hasx, &hasz, &hast, &geodetic);
-  if (hasx && (box1->xmax < box2->xmin || box1->xmin > box2->xmax ||
-    box1->ymax < box2->ymin || box1->ymin > box2->ymax))
-    return false;
-  if ((hasz || geodetic) && (box1->zmax < box2->zmin || box1->zmin > box2->zmax))
-    return false;
-  if (hast && (box1->tmax < box2->tmin || box1->tmin > box2->tmax))
-    return false;
-  return true;
+  return overlaps_stbox_stbox_inline(box1, box2);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_stbox_stbox);
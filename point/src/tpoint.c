@@ -18,6 +18,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_packed.h"
 #include "lifting.h"
 #include "temporal_compops.h"
 #include "stbox.h"
@@ -146,6 +147,22 @@ tpoint_in(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+PG_FUNCTION_INFO_V1(tpoint_recv);
+/**
+ * Generic receive function for temporal points
+ *
+ * @note The typmod of the column is verified here since, contrary to the
+ * values given in text, the values received by COPY are not cast to it
+ */
+PGDLLEXPORT Datum
+tpoint_recv(PG_FUNCTION_ARGS)
+{
+  int32 typmod = PG_GETARG_INT32(2);
+  Temporal *result = (Temporal *) DatumGetPointer(temporal_recv(fcinfo));
+  result = tpoint_valid_typmod(result, typmod);
+  PG_RETURN_POINTER(result);
+}
+
 /**
  * Input typmod information for temporal points
  */
@@ -382,6 +399,79 @@ tpointinst_constructor(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/**
+ * Returns the number of elements of the array of coordinates or timestamps,
+ * which must be one-dimensional and without nulls
+ */
+static int
+tpointseq_array_count(ArrayType *array)
+{
+  ensure_non_empty_array(array);
+  if (ARR_NDIM(array) != 1 || array_contains_nulls(array))
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The arrays must be one-dimensional and without nulls")));
+  return ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+}
+
+PG_FUNCTION_INFO_V1(tpointseq_from_arrays);
+/**
+ * Construct a temporal sequence point value from the arrays of coordinates
+ * and of timestamps. The instants are composed from a single point whose
+ * coordinates are overwritten, without creating a geometry and an instant
+ * value for each element of the arrays.
+ */
+PGDLLEXPORT Datum
+tpointseq_from_arrays(PG_FUNCTION_ARGS)
+{
+  bool hasz = (PG_NARGS() == 8);
+  int n = hasz ? 4 : 3;
+  ArrayType *arrays[4];
+  int count = 0;
+  for (int i = 0; i < n; i++)
+  {
+    arrays[i] = PG_GETARG_ARRAYTYPE_P(i);
+    int count1 = tpointseq_array_count(arrays[i]);
+    if (i == 0)
+      count = count1;
+    else if (count1 != count)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The arrays must have the same number of elements")));
+  }
+  int srid = PG_GETARG_INT32(n);
+  bool lower_inc = PG_GETARG_BOOL(n + 1);
+  bool upper_inc = PG_GETARG_BOOL(n + 2);
+  bool linear = PG_GETARG_BOOL(n + 3);
+  Oid valuetypid = base_oid_from_temporal(get_fn_expr_rettype(fcinfo->flinfo));
+  bool geodetic = (valuetypid == type_oid(T_GEOGRAPHY));
+
+  /* Elements of float8 and timestamptz arrays are read in place */
+  double *coords[3];
+  for (int i = 0; i < n - 1; i++)
+    coords[i] = (double *) ARR_DATA_PTR(arrays[i]);
+  TimestampTz *times = (TimestampTz *) ARR_DATA_PTR(arrays[n - 1]);
+
+  LWPOINT *lwpoint = hasz ? lwpoint_make3dz(srid, 0, 0, 0) :
+    lwpoint_make2d(srid, 0, 0);
+  FLAGS_SET_GEODETIC(lwpoint->flags, geodetic);
+  GSERIALIZED *gs = geo_serialize((LWGEOM *) lwpoint);
+  lwpoint_free(lwpoint);
+  double *ptcoords = (double *) datum_get_point2d_p(PointerGetDatum(gs));
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    for (int j = 0; j < n - 1; j++)
+      ptcoords[j] = coords[j][i];
+    instants[i] = tinstant_make(PointerGetDatum(gs), times[i], valuetypid);
+  }
+  pfree(gs);
+  /* The timestamps are validated while constructing the sequence */
+  Temporal *result = (Temporal *) tsequence_make_free(instants, count,
+    lower_inc, upper_inc, linear, NORMALIZE);
+  for (int i = 0; i < n; i++)
+    PG_FREE_IF_COPY(arrays[i], i);
+  PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************
  * Accessor functions
  *****************************************************************************/
@@ -393,10 +483,8 @@ PG_FUNCTION_INFO_V1(tpoint_to_stbox);
 PGDLLEXPORT Datum
 tpoint_to_stbox(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
   STBOX *result = palloc0(sizeof(STBOX));
-  temporal_bbox(result, temp);
-  PG_FREE_IF_COPY(temp, 0);
+  temporal_bbox_slice(result, PG_GETARG_DATUM(0));
   PG_RETURN_POINTER(result);
 }
 
@@ -499,8 +587,10 @@ PG_FUNCTION_INFO_V1(tpoint_values);
 PGDLLEXPORT Datum
 tpoint_values(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
-  Datum result = tpoint_trajectory_internal(temp);
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
+  Datum result = MOBDB_FLAGS_GET_PACKED(temp->flags) ?
+    tpointpk_trajectory((TemporalPacked *) temp) :
+    tpoint_trajectory_internal(temp);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_POINTER(result);
 }
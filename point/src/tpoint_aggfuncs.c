@@ -3,7 +3,10 @@
  * tpoint_aggfuncs.c
  *  Aggregate functions for temporal points.
  *
- * The only functions currently provided are extent and temporal centroid.
+ * The functions currently provided are extent, temporal centroid,
+ * simplifying append, and grid occupancy. The temporal centroid of
+ * geographic points is the mean of their geocentric coordinates projected
+ * back on the sphere.
  *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
  *    Universite Libre de Bruxelles
@@ -15,6 +18,17 @@
 #include "tpoint_aggfuncs.h"
 
 #include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <access/hash.h>
+#include <access/htup_details.h>
+#include <funcapi.h>
+#include <utils/array.h>
+#include <utils/builtins.h>
+#include <utils/lsyscache.h>
+#include <utils/memutils.h>
+#include <utils/timestamp.h>
+#include <utils/typcache.h>
 
 #include "temporaltypes.h"
 #include "oidcache.h"
@@ -23,20 +37,21 @@
 #include "temporal_aggfuncs.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
+#include "postgis.h"
 
 /*****************************************************************************
  * Generic functions
  *****************************************************************************/
 
 /**
- * Structure storing the SRID and the dimensionality of the temporal point 
- * values for aggregation. Notice that for the moment we do not aggregate
- * temporal geographic points.
+ * Structure storing the SRID, the dimensionality, and whether the temporal
+ * point values for aggregation are geographic
  */
 struct GeoAggregateState
 {
   int32_t srid;
   bool hasz;
+  bool geodetic;
 };
 
 /**
@@ -91,7 +106,20 @@ static TInstant *
 tpointinst_transform_tcentroid(const TInstant *inst)
 {
   TInstant *result;
-  if (MOBDB_FLAGS_GET_Z(inst->flags))
+  if (MOBDB_FLAGS_GET_GEODETIC(inst->flags))
+  {
+    /* Geographic points are summed as geocentric unit vectors */
+    const POINT2D *point = datum_get_point2d_p(tinstant_value(inst));
+    GEOGRAPHIC_POINT gpoint;
+    POINT3D p;
+    geographic_point_init(point->x, point->y, &gpoint);
+    geog2cart(&gpoint, &p);
+    double4 dvalue;
+    double4_set(&dvalue, p.x, p.y, p.z, 1);
+    result = tinstant_make(PointerGetDatum(&dvalue), inst->t,
+      type_oid(T_DOUBLE4));
+  }
+  else if (MOBDB_FLAGS_GET_Z(inst->flags))
   {
     const POINT3DZ *point = datum_get_point3dz_p(tinstant_value(inst));
     double4 dvalue;
@@ -206,33 +234,33 @@ PGDLLEXPORT Datum
 tpoint_extent_transfn(PG_FUNCTION_ARGS)
 {
   STBOX *box = PG_ARGISNULL(0) ? NULL : PG_GETARG_STBOX_P(0);
-  Temporal *temp = PG_ARGISNULL(1) ? NULL : PG_GETARG_TEMPORAL(1);
+  bool hastemp = ! PG_ARGISNULL(1);
 
   /* Can't do anything with null inputs */
-  if (!box && !temp)
+  if (!box && ! hastemp)
     PG_RETURN_NULL();
-  STBOX *result = palloc0(sizeof(STBOX));
-  /* Null box and non-null temporal, return the bbox of the temporal */
-  if (!box && temp)
-  {
-    temporal_bbox(result, temp);
-    PG_RETURN_POINTER(result);
-  }
   /* Non-null box and null temporal, return the box */
-  if (box && !temp)
+  if (! hastemp)
+    PG_RETURN_POINTER(box);
+  /* Null box and non-null temporal, return the bbox of the temporal */
+  if (!box)
   {
-    memcpy(result, box, sizeof(STBOX));
+    STBOX *result = aggstate_box_alloc(fcinfo, sizeof(STBOX));
+    temporal_bbox_slice(result, PG_GETARG_DATUM(1));
     PG_RETURN_POINTER(result);
   }
 
-  /* Both box and temporal are not null */
-  ensure_same_srid_tpoint_stbox(temp, box);
-  ensure_same_dimensionality_tpoint_stbox(temp, box);
-  ensure_same_geodetic_tpoint_stbox(temp, box);
-  temporal_bbox(result, temp);
-  stbox_expand(result, box);
-  PG_FREE_IF_COPY(temp, 1);
-  PG_RETURN_POINTER(result);
+  /* Both box and temporal are not null
+   * The state is expanded in place when called as an aggregate */
+  STBOX box1;
+  temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
+  ensure_same_srid_stbox(&box1, box);
+  ensure_same_dimensionality_stbox(&box1, box);
+  ensure_same_geodetic_stbox(&box1, box);
+  if (! AggCheckCallContext(fcinfo, NULL))
+    box = stbox_copy(box);
+  stbox_expand(box, &box1);
+  PG_RETURN_POINTER(box);
 }
 
 PG_FUNCTION_INFO_V1(tpoint_extent_combinefn);
@@ -255,9 +283,10 @@ tpoint_extent_combinefn(PG_FUNCTION_ARGS)
   ensure_same_srid_stbox(box1, box2);
   ensure_same_dimensionality_stbox(box1, box2);
   ensure_same_geodetic_stbox(box1, box2);
-  STBOX *result = stbox_copy(box1);
-  stbox_expand(result, box2);
-  PG_RETURN_POINTER(result);
+  if (! AggCheckCallContext(fcinfo, NULL))
+    box1 = stbox_copy(box1);
+  stbox_expand(box1, box2);
+  PG_RETURN_POINTER(box1);
 }
 
 /*****************************************************************************
@@ -284,7 +313,12 @@ tpoint_tcentroid_transfn(PG_FUNCTION_ARGS)
   }
 
   geoaggstate_check_t(state, temp);
-  Datum (*func)(Datum, Datum) = MOBDB_FLAGS_GET_Z(temp->flags) ?
+  bool geodetic = MOBDB_FLAGS_GET_GEODETIC(temp->flags);
+  if (geodetic && MOBDB_FLAGS_GET_Z(temp->flags))
+    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+      errmsg("The temporal centroid of geographic points with Z dimension is not supported")));
+  Datum (*func)(Datum, Datum) = 
+    (geodetic || MOBDB_FLAGS_GET_Z(temp->flags)) ?
     &datum_sum_double4 : &datum_sum_double3;
 
   int count;
@@ -299,7 +333,7 @@ tpoint_tcentroid_transfn(PG_FUNCTION_ARGS)
       ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
         errmsg("Cannot aggregate temporal values of different interpolation")));
 
-    skiplist_splice(fcinfo, state, temparr, count, func, false);
+    skiplist_add(fcinfo, state, temparr, count, func, false);
   }
   else
   {
@@ -307,7 +341,8 @@ tpoint_tcentroid_transfn(PG_FUNCTION_ARGS)
     struct GeoAggregateState extra =
     {
       .srid = tpoint_srid_internal(temp),
-      .hasz = MOBDB_FLAGS_GET_Z(temp->flags) != 0
+      .hasz = MOBDB_FLAGS_GET_Z(temp->flags) != 0,
+      .geodetic = geodetic
     };
     aggstate_set_extra(fcinfo, state, &extra, sizeof(struct GeoAggregateState));
   }
@@ -340,7 +375,7 @@ tpoint_tcentroid_combinefn(PG_FUNCTION_ARGS)
   if (state2 && state2->extra) 
     extra = state2->extra;
   assert(extra != NULL);
-  Datum (*func)(Datum, Datum) = extra->hasz ?
+  Datum (*func)(Datum, Datum) = (extra->hasz || extra->geodetic) ?
     &datum_sum_double4 : &datum_sum_double3;
   SkipList *result = temporal_tagg_combinefn1(fcinfo, state1, state2, 
     func, false);
@@ -352,14 +387,30 @@ tpoint_tcentroid_combinefn(PG_FUNCTION_ARGS)
 
 /**
  * Transforms a temporal doubleN instant into a point
+ *
+ * @note For geographic points the mean of the geocentric vectors is projected
+ * back on the sphere, its norm is irrelevant
  */
 static Datum 
-doublen_to_point(TInstant *inst, int srid)
+doublen_to_point(TInstant *inst, int srid, bool geodetic)
 {
   assert(inst->valuetypid == type_oid(T_DOUBLE4) ||
     inst->valuetypid == type_oid(T_DOUBLE3));
   LWPOINT *point;
-  if (inst->valuetypid == type_oid(T_DOUBLE4))
+  if (geodetic)
+  {
+    double4 *value4 = (double4 *)DatumGetPointer(tinstant_value_ptr(inst));
+    POINT3D p;
+    GEOGRAPHIC_POINT gpoint;
+    p.x = value4->a;
+    p.y = value4->b;
+    p.z = value4->c;
+    normalize(&p);
+    cart2geog(&p, &gpoint);
+    point = lwpoint_make2d(srid, rad2deg(gpoint.lon), rad2deg(gpoint.lat));
+    FLAGS_SET_GEODETIC(point->flags, true);
+  }
+  else if (inst->valuetypid == type_oid(T_DOUBLE4))
   {
     double4 *value4 = (double4 *)DatumGetPointer(tinstant_value_ptr(inst));
     assert(value4->d != 0);
@@ -376,7 +427,6 @@ doublen_to_point(TInstant *inst, int srid)
     double valueb = value3->b / value3->c;
     point = lwpoint_make2d(srid, valuea, valueb);
   }
-  /* Notice that for the moment we do not aggregate temporal geographic points */
   Datum result = PointerGetDatum(geo_serialize((LWGEOM *) point));
   lwpoint_free(point);
   return result;
@@ -389,16 +439,19 @@ doublen_to_point(TInstant *inst, int srid)
  * @param[in] instants Temporal values
  * @param[in] count Number of elements in the array
  * @param[in] srid SRID of the values
+ * @param[in] geodetic True when the values are geographic points
  */
 TInstantSet *
-tpointinst_tcentroid_finalfn(TInstant **instants, int count, int srid)
+tpointinst_tcentroid_finalfn(TInstant **instants, int count, int srid,
+  bool geodetic)
 {
+  Oid valuetypid = geodetic ? type_oid(T_GEOGRAPHY) : type_oid(T_GEOMETRY);
   TInstant **newinstants = palloc(sizeof(TInstant *) * count);
   for (int i = 0; i < count; i++)
   {
     TInstant *inst = instants[i];
-    Datum value = doublen_to_point(inst, srid);
-    newinstants[i] = tinstant_make(value, inst->t, type_oid(T_GEOMETRY));
+    Datum value = doublen_to_point(inst, srid, geodetic);
+    newinstants[i] = tinstant_make(value, inst->t, valuetypid);
     pfree(DatumGetPointer(value));
   }
   return tinstantset_make_free(newinstants, count);
@@ -411,10 +464,13 @@ tpointinst_tcentroid_finalfn(TInstant **instants, int count, int srid)
  * @param[in] sequences Temporal values
  * @param[in] count Number of elements in the array
  * @param[in] srid SRID of the values
+ * @param[in] geodetic True when the values are geographic points
  */
 TSequenceSet *
-tpointseq_tcentroid_finalfn(TSequence **sequences, int count, int srid)
+tpointseq_tcentroid_finalfn(TSequence **sequences, int count, int srid,
+  bool geodetic)
 {
+  Oid valuetypid = geodetic ? type_oid(T_GEOGRAPHY) : type_oid(T_GEOMETRY);
   TSequence **newsequences = palloc(sizeof(TSequence *) * count);
   for (int i = 0; i < count; i++)
   {
@@ -423,8 +479,8 @@ tpointseq_tcentroid_finalfn(TSequence **sequences, int count, int srid)
     for (int j = 0; j < seq->count; j++)
     {
       TInstant *inst = tsequence_inst_n(seq, j);
-      Datum value = doublen_to_point(inst, srid);
-      instants[j] = tinstant_make(value, inst->t, type_oid(T_GEOMETRY));
+      Datum value = doublen_to_point(inst, srid, geodetic);
+      instants[j] = tinstant_make(value, inst->t, valuetypid);
       pfree(DatumGetPointer(value));
     }
     newsequences[i] = tsequence_make_free(instants, seq->count,
@@ -434,6 +490,23 @@ tpointseq_tcentroid_finalfn(TSequence **sequences, int count, int srid)
   return tsequenceset_make_free(newsequences, count, NORMALIZE);
 }
 
+/**
+ * Construct the result of a temporal centroid aggregation from its values
+ */
+static Temporal *
+tpoint_tcentroid_finalfn1(Temporal **values, int count, void *arg)
+{
+  struct GeoAggregateState *extra = (struct GeoAggregateState *) arg;
+  assert(values[0]->duration == INSTANT ||
+    values[0]->duration == SEQUENCE);
+  if (values[0]->duration == INSTANT)
+    return (Temporal *)tpointinst_tcentroid_finalfn(
+      (TInstant **)values, count, extra->srid, extra->geodetic);
+  else /* values[0]->duration == SEQUENCE */
+    return (Temporal *)tpointseq_tcentroid_finalfn(
+      (TSequence **)values, count, extra->srid, extra->geodetic);
+}
+
 PG_FUNCTION_INFO_V1(tpoint_tcentroid_finalfn);
 /**
  * Final function for temporal centroid aggregation of temporal point values
@@ -443,23 +516,1081 @@ tpoint_tcentroid_finalfn(PG_FUNCTION_ARGS)
 {
   /* The final function is strict, we do not need to test for null values */
   SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
-  if (state->length == 0)
+  struct GeoAggregateState extra = { .srid = 0, .hasz = false,
+    .geodetic = false };
+  if (state->extra)
+    memcpy(&extra, state->extra, sizeof(struct GeoAggregateState));
+  Temporal *result = skiplist_finalize(fcinfo, state,
+    &tpoint_tcentroid_finalfn1, &extra);
+  if (result == NULL)
     PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
 
-  Temporal **values = skiplist_values(state);
-  int32_t srid = ((struct GeoAggregateState *) state->extra)->srid;
-  Temporal *result = NULL;
-  assert(values[0]->duration == INSTANT ||
-    values[0]->duration == SEQUENCE);
-  if (values[0]->duration == INSTANT)
-    result = (Temporal *)tpointinst_tcentroid_finalfn(
-      (TInstant **)values, state->length, srid);
-  else if (values[0]->duration == SEQUENCE)
-    result = (Temporal *)tpointseq_tcentroid_finalfn(
-      (TSequence **)values, state->length, srid);
+/*****************************************************************************
+ * Simplifying append aggregate
+ *
+ * The instants are simplified as they arrive with the opening window
+ * algorithm using the synchronized Euclidean distance, that is, the
+ * distance between a dropped instant and the position at its timestamp of
+ * the segment that replaces it. The last instant of the state is always
+ * kept tentatively: it is dropped when the next one arrives if the segment
+ * from the previous kept instant to the new one stays within the distance
+ * of the last instant and of all instants already dropped since then.
+ * Therefore the appended sequence is at most at the distance of every
+ * input instant at its timestamp.
+ *****************************************************************************/
+
+/**
+ * Structure to keep the state of the simplifying append aggregation. The
+ * instants kept are in the append state, which must be the first member so
+ * that the state can be finalized as a plain append state. The coordinates
+ * and timestamps of the instants dropped since the previous kept instant are
+ * packed in arrays with slack capacity.
+ */
+typedef struct
+{
+  AppendState append;
+  double dist;
+  int capacity;
+  int count;
+  POINT3DZ *points;
+  TimestampTz *times;
+} SimplifyState;
+
+/**
+ * Returns the coordinates of the temporal instant point, with a zero Z
+ * coordinate for 2D points
+ */
+static POINT3DZ
+tpointinst_point3dz(const TInstant *inst, bool hasz)
+{
+  POINT3DZ result;
+  if (hasz)
+    result = datum_get_point3dz(tinstant_value(inst));
+  else
+  {
+    const POINT2D *p = datum_get_point2d_p(tinstant_value(inst));
+    result.x = p->x;
+    result.y = p->y;
+    result.z = 0;
+  }
+  return result;
+}
+
+/**
+ * Returns the synchronized Euclidean distance between the point at the
+ * timestamp and the segment defined by the two points and their timestamps
+ */
+static double
+point_sed(const POINT3DZ *p, TimestampTz t, const POINT3DZ *p1,
+  TimestampTz t1, const POINT3DZ *p2, TimestampTz t2)
+{
+  double ratio = (double) (t - t1) / (double) (t2 - t1);
+  double dx = p1->x + (p2->x - p1->x) * ratio - p->x;
+  double dy = p1->y + (p2->y - p1->y) * ratio - p->y;
+  double dz = p1->z + (p2->z - p1->z) * ratio - p->z;
+  return hypot3d(dx, dy, dz);
+}
+
+/**
+ * Returns true if the last instant of the state can be dropped when
+ * appending the instant, that is, if the segment from the previous kept
+ * instant to the instant is within the distance of the last instant and of
+ * the instants dropped since the previous kept one
+ */
+static bool
+simplifystate_drop_last(const SimplifyState *state, const TInstant *inst)
+{
+  const AppendState *append = &state->append;
+  if (append->count < 2)
+    return false;
+  const TInstant *inst1 = append->instants[append->count - 2];
+  const TInstant *last = append->instants[append->count - 1];
+  bool hasz = MOBDB_FLAGS_GET_Z(inst->flags);
+  POINT3DZ p1 = tpointinst_point3dz(inst1, hasz);
+  POINT3DZ p2 = tpointinst_point3dz(inst, hasz);
+  POINT3DZ p = tpointinst_point3dz(last, hasz);
+  if (point_sed(&p, last->t, &p1, inst1->t, &p2, inst->t) > state->dist)
+    return false;
+  for (int i = 0; i < state->count; i++)
+  {
+    if (point_sed(&state->points[i], state->times[i], &p1, inst1->t,
+        &p2, inst->t) > state->dist)
+      return false;
+  }
+  return true;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_append_simplify_transfn);
+/**
+ * Transition function for the aggregation that appends temporal instant
+ * points dropping those that are within the distance of the simplified
+ * sequence
+ */
+PGDLLEXPORT Datum
+tpoint_append_simplify_transfn(PG_FUNCTION_ARGS)
+{
+  SimplifyState *state = PG_ARGISNULL(0) ? NULL :
+    (SimplifyState *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1) || PG_ARGISNULL(2))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
+
+  Temporal *temp = PG_GETARG_TEMPORAL(1);
+  double dist = PG_GETARG_FLOAT8(2);
+  if (temp->duration != INSTANT)
+    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+      errmsg("The argument must be of instant duration")));
+  if (dist < 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The distance must be positive")));
+  TInstant *inst = (TInstant *) temp;
+  MemoryContext oldctx = set_aggregation_context(fcinfo);
+  if (! state)
+  {
+    state = palloc(sizeof(SimplifyState));
+    appendstate_init(&state->append);
+    state->dist = dist;
+    state->capacity = APPENDSTATE_INITIAL_CAPACITY;
+    state->count = 0;
+    state->points = palloc(sizeof(POINT3DZ) * state->capacity);
+    state->times = palloc(sizeof(TimestampTz) * state->capacity);
+  }
+  else if (appendstate_has_last(&state->append, inst))
+  {
+    /* The instant is already in the state */
+    unset_aggregation_context(oldctx);
+    PG_FREE_IF_COPY(temp, 1);
+    PG_RETURN_POINTER(state);
+  }
+
+  AppendState *append = &state->append;
+  if (simplifystate_drop_last(state, inst))
+  {
+    /* Replace the last instant by the new one */
+    TInstant *last = append->instants[append->count - 1];
+    if (state->count == state->capacity)
+    {
+      state->capacity *= APPENDSTATE_GROW;
+      state->points = repalloc(state->points,
+        sizeof(POINT3DZ) * state->capacity);
+      state->times = repalloc(state->times,
+        sizeof(TimestampTz) * state->capacity);
+    }
+    state->points[state->count] = tpointinst_point3dz(last,
+      MOBDB_FLAGS_GET_Z(last->flags));
+    state->times[state->count++] = last->t;
+    pfree(last);
+    append->instants[append->count - 1] = tinstant_copy(inst);
+  }
+  else
+  {
+    /* The last instant is kept and starts a new window */
+    state->count = 0;
+    appendstate_append(append, inst);
+  }
+  unset_aggregation_context(oldctx);
+  PG_FREE_IF_COPY(temp, 1);
+  PG_RETURN_POINTER(state);
+}
+
+/*****************************************************************************/
+
+/*****************************************************************************
+ * Grid occupancy aggregate
+ *
+ * The segments of the temporal points are walked through the cells of a
+ * regular grid of squares and of time buckets as in a DDA line traversal:
+ * the next cell is the one whose boundary in x, y, or time is crossed first
+ * by the segment. The time spent in each cell and the number of temporal
+ * points visiting it are accumulated in an open addressing hash table keyed
+ * on the indexes of the cells. As for the bucketed aggregates the cells are
+ * half-open, so that each part of a segment is in a single cell.
+ *****************************************************************************/
 
-  pfree(values);
+/**
+ * Structure to accumulate the occupancy of a cell of the grid
+ */
+typedef struct
+{
+  int index[3];       /**< Indexes of the cell in the x, y, and t dimensions */
+  bool used;          /**< False for the empty slots of the hash table */
+  int count;          /**< Number of temporal points visiting the cell */
+  int last;           /**< Last temporal point counted in the cell */
+  int64 duration;     /**< Time spent in the cell in microseconds */
+} GridCellAcc;
 
+/**
+ * Structure to keep the state of the grid occupancy aggregation. The members
+ * before the cells are those of the serialized state.
+ */
+typedef struct
+{
+  double size;        /**< Size of the cells in the spatial dimensions */
+  int64 tsize;        /**< Size of the cells in microseconds */
+  double xorigin;     /**< Origin of the grid, normalized to [0, size) */
+  double yorigin;
+  TimestampTz torigin;  /**< Time origin, normalized to [0, tsize) */
+  int32 srid;         /**< SRID of the temporal points */
+  int values;         /**< Number of temporal points aggregated */
+  int count;          /**< Number of cells */
+  uint32 mask;        /**< Size of the hash table minus one */
+  GridCellAcc *cells; /**< Hash table of cells */
+} GridState;
+
+/**
+ * Set the grid of the state of a grid occupancy aggregation
+ */
+static void
+gridstate_set(GridState *result, double size, int64 tsize, double xorigin,
+  double yorigin, TimestampTz torigin, int32 srid)
+{
+  result->size = size;
+  result->tsize = tsize;
+  /* Normalize the origin so that the indexes of the cells of two states
+   * with equivalent origins are the same */
+  result->xorigin = fmod(xorigin, size);
+  if (result->xorigin < 0)
+    result->xorigin += size;
+  result->yorigin = fmod(yorigin, size);
+  if (result->yorigin < 0)
+    result->yorigin += size;
+  result->torigin = torigin % tsize;
+  if (result->torigin < 0)
+    result->torigin += tsize;
+  result->srid = srid;
+  return;
+}
+
+/**
+ * Construct an empty state for a grid occupancy aggregation
+ */
+static GridState *
+gridstate_make(FunctionCallInfo fcinfo, const GridState *grid)
+{
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  GridState *result = palloc(sizeof(GridState));
+  memcpy(result, grid, offsetof(GridState, values));
+  result->values = 0;
+  result->count = 0;
+  result->mask = 63;
+  result->cells = palloc0(sizeof(GridCellAcc) * (result->mask + 1));
+  unset_aggregation_context(ctx);
+  return result;
+}
+
+/**
+ * Ensure that the state of a grid occupancy aggregation has the same grid
+ */
+static void
+ensure_same_grid(const GridState *state, const GridState *grid)
+{
+  if (state->size != grid->size || state->tsize != grid->tsize ||
+    state->xorigin != grid->xorigin || state->yorigin != grid->yorigin ||
+    state->torigin != grid->torigin)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The values must be aggregated with the same grid")));
+  if (state->srid != grid->srid)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The temporal points must be in the same SRID")));
+}
+
+/**
+ * Returns the accumulator of the cell of the hash table
+ */
+static GridCellAcc *
+gridstate_lookup(GridCellAcc *cells, uint32 mask, const int *index)
+{
+  uint32 i = DatumGetUInt32(hash_any((unsigned char *) index,
+    sizeof(int) * 3)) & mask;
+  while (cells[i].used && memcmp(cells[i].index, index, sizeof(int) * 3) != 0)
+    i = (i + 1) & mask;
+  return &cells[i];
+}
+
+/**
+ * Returns the accumulator of the cell with the given indexes, adding it
+ * to the hash table if needed
+ *
+ * @note The hash table keeps the memory context in which it was allocated
+ */
+static GridCellAcc *
+gridstate_get(GridState *state, const int *index)
+{
+  GridCellAcc *acc = gridstate_lookup(state->cells, state->mask, index);
+  if (acc->used)
+    return acc;
+  /* Keep the load factor of the hash table below one half */
+  if ((uint32) (state->count + 1) * 2 > state->mask)
+  {
+    uint32 mask = state->mask * 2 + 1;
+    GridCellAcc *cells = MemoryContextAllocZero(
+      GetMemoryChunkContext(state->cells), sizeof(GridCellAcc) * (mask + 1));
+    for (uint32 i = 0; i <= state->mask; i++)
+    {
+      if (state->cells[i].used)
+        *gridstate_lookup(cells, mask, state->cells[i].index) =
+          state->cells[i];
+    }
+    pfree(state->cells);
+    state->cells = cells;
+    state->mask = mask;
+    acc = gridstate_lookup(state->cells, state->mask, index);
+  }
+  memcpy(acc->index, index, sizeof(int) * 3);
+  acc->used = true;
+  acc->count = 0;
+  acc->last = -1;
+  acc->duration = 0;
+  state->count++;
+  return acc;
+}
+
+/**
+ * Add the time spent by the current temporal point in the cell
+ */
+static void
+gridstate_add(GridState *state, const int *index, int64 duration)
+{
+  GridCellAcc *acc = gridstate_get(state, index);
+  if (acc->last != state->values)
+  {
+    acc->count++;
+    acc->last = state->values;
+  }
+  acc->duration += duration;
+  return;
+}
+
+/**
+ * Returns the index of the cell containing the coordinate
+ */
+static int
+grid_index(double value, double origin, double size)
+{
+  return (int) floor((value - origin) / size);
+}
+
+/**
+ * Returns the index of the time bucket containing the timestamp
+ */
+static int
+grid_tindex(const GridState *state, TimestampTz t)
+{
+  int64 delta = t - state->torigin;
+  int64 result = delta / state->tsize;
+  /* Round towards minus infinity */
+  if (delta % state->tsize < 0)
+    result--;
+  return (int) result;
+}
+
+/**
+ * Add the instant to the cell containing it
+ */
+static void
+tpointinst_grid_add(GridState *state, const TInstant *inst)
+{
+  const POINT2D *p = datum_get_point2d_p(tinstant_value(inst));
+  int index[3];
+  index[0] = grid_index(p->x, state->xorigin, state->size);
+  index[1] = grid_index(p->y, state->yorigin, state->size);
+  index[2] = grid_tindex(state, inst->t);
+  gridstate_add(state, index, 0);
+  return;
+}
+
+/**
+ * Returns the fraction of the segment at which the coordinate crosses the
+ * next boundary of the cells after the one of the given index
+ */
+static double
+grid_next_fraction(double c1, double delta, double origin, double size,
+  int index)
+{
+  if (delta == 0)
+    return DBL_MAX;
+  double bound = origin + (delta > 0 ? index + 1 : index) * size;
+  return (bound - c1) / delta;
+}
+
+/**
+ * Walk the segment through the cells of the grid, adding to each cell the
+ * time spent in it
+ *
+ * @param[in,out] state State
+ * @param[in] inst1,inst2 Instants defining the segment
+ * @param[in] linear True when the segment has linear interpolation
+ */
+static void
+tpointseg_grid_add(GridState *state, const TInstant *inst1,
+  const TInstant *inst2, bool linear)
+{
+  const POINT2D *p1 = datum_get_point2d_p(tinstant_value(inst1));
+  const POINT2D *p2 = datum_get_point2d_p(tinstant_value(inst2));
+  double dx = linear ? p2->x - p1->x : 0;
+  double dy = linear ? p2->y - p1->y : 0;
+  double duration = (double) (inst2->t - inst1->t);
+  /* Indexes of the cell at the start of the segment, which is the next one
+   * in the direction of the segment when the point is on a boundary */
+  int index[3];
+  index[0] = grid_index(p1->x, state->xorigin, state->size);
+  if (dx < 0 && state->xorigin + index[0] * state->size == p1->x)
+    index[0]--;
+  index[1] = grid_index(p1->y, state->yorigin, state->size);
+  if (dy < 0 && state->yorigin + index[1] * state->size == p1->y)
+    index[1]--;
+  index[2] = grid_tindex(state, inst1->t);
+  TimestampTz lower = inst1->t;
+  while (lower < inst2->t)
+  {
+    double fx = grid_next_fraction(p1->x, dx, state->xorigin, state->size,
+      index[0]);
+    double fy = grid_next_fraction(p1->y, dy, state->yorigin, state->size,
+      index[1]);
+    TimestampTz tbound = state->torigin + (int64) (index[2] + 1) * state->tsize;
+    double ft = (double) (tbound - inst1->t) / duration;
+    double fs = Min(fx, fy);
+    /* The bounds of the time buckets are exact timestamps */
+    bool tcross = (ft <= fs);
+    TimestampTz upper;
+    if (tcross)
+      upper = Min(tbound, inst2->t);
+    else
+      upper = (fs >= 1.0) ? inst2->t :
+        Min(inst1->t + (long) (duration * fs), inst2->t);
+    if (upper > lower)
+    {
+      gridstate_add(state, index, upper - lower);
+      lower = upper;
+    }
+    /* Move to the next cell, which may be diagonal to the current one */
+    double next = tcross ? ft : fs;
+    if (fx <= next)
+      index[0] += (dx > 0) ? 1 : -1;
+    if (fy <= next)
+      index[1] += (dy > 0) ? 1 : -1;
+    if (ft <= next)
+      index[2]++;
+  }
+  return;
+}
+
+/**
+ * Add the temporal sequence point to the cells of the grid
+ */
+static void
+tpointseq_grid_add(GridState *state, const TSequence *seq)
+{
+  TInstant *inst1 = tsequence_inst_n(seq, 0);
+  if (seq->count == 1)
+  {
+    tpointinst_grid_add(state, inst1);
+    return;
+  }
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  for (int i = 1; i < seq->count; i++)
+  {
+    TInstant *inst2 = tsequence_inst_n(seq, i);
+    tpointseg_grid_add(state, inst1, inst2, linear);
+    inst1 = inst2;
+  }
+  return;
+}
+
+/**
+ * Add the temporal point to the cells of the grid (dispatch function)
+ */
+static void
+tpoint_grid_add(GridState *state, const Temporal *temp)
+{
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+    tpointinst_grid_add(state, (TInstant *) temp);
+  else if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (TInstantSet *) temp;
+    for (int i = 0; i < ti->count; i++)
+      tpointinst_grid_add(state, tinstantset_inst_n(ti, i));
+  }
+  else if (temp->duration == SEQUENCE)
+    tpointseq_grid_add(state, (TSequence *) temp);
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (TSequenceSet *) temp;
+    for (int i = 0; i < ts->count; i++)
+      tpointseq_grid_add(state, tsequenceset_seq_n(ts, i));
+  }
+  /* The next temporal point is counted again in the cells */
+  state->values++;
+  return;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_grid_transfn);
+/**
+ * Transition function for the grid occupancy aggregation
+ *
+ * @note The origin of the grid is optional and defaults to the point (0, 0)
+ * and to Monday, January 3, 2000, as for the bucketed aggregates
+ */
+PGDLLEXPORT Datum
+tpoint_grid_transfn(PG_FUNCTION_ARGS)
+{
+  GridState *state = PG_ARGISNULL(0) ? NULL :
+    (GridState *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1) || PG_ARGISNULL(2) || PG_ARGISNULL(3) ||
+    (PG_NARGS() > 4 && (PG_ARGISNULL(4) || PG_ARGISNULL(5))))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
+
+  Temporal *temp = PG_GETARG_TEMPORAL(1);
+  double size = PG_GETARG_FLOAT8(2);
+  if (size <= 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The size of the cells must be positive")));
+  Interval *interval = PG_GETARG_INTERVAL_P(3);
+  if (interval->month != 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The interval of the cells cannot have months")));
+  int64 tsize = interval->time + interval->day * USECS_PER_DAY;
+  if (tsize <= 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The interval of the cells must be positive")));
+  double xorigin = 0, yorigin = 0;
+  TimestampTz torigin = 2 * USECS_PER_DAY;
+  if (PG_NARGS() > 4)
+  {
+    GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(4);
+    ensure_point_type(gs);
+    ensure_non_empty(gs);
+    ensure_same_srid_tpoint_gs(temp, gs);
+    const POINT2D *p = datum_get_point2d_p(PointerGetDatum(gs));
+    xorigin = p->x;
+    yorigin = p->y;
+    torigin = PG_GETARG_TIMESTAMPTZ(5);
+  }
+  GridState grid;
+  gridstate_set(&grid, size, tsize, xorigin, yorigin, torigin,
+    tpoint_srid_internal(temp));
+  if (state)
+    ensure_same_grid(state, &grid);
+  else
+    state = gridstate_make(fcinfo, &grid);
+  tpoint_grid_add(state, temp);
+  PG_FREE_IF_COPY(temp, 1);
+  PG_RETURN_POINTER(state);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_grid_combinefn);
+/**
+ * Combine function for the grid occupancy aggregation, which adds the
+ * accumulators of the cells of the second state to those of the first one
+ */
+PGDLLEXPORT Datum
+tpoint_grid_combinefn(PG_FUNCTION_ARGS)
+{
+  GridState *state1 = PG_ARGISNULL(0) ? NULL :
+    (GridState *) PG_GETARG_POINTER(0);
+  GridState *state2 = PG_ARGISNULL(1) ? NULL :
+    (GridState *) PG_GETARG_POINTER(1);
+  if (state1 == NULL && state2 == NULL)
+    PG_RETURN_NULL();
+  if (state1 == NULL)
+    PG_RETURN_POINTER(state2);
+  if (state2 == NULL || state2->count == 0)
+    PG_RETURN_POINTER(state1);
+
+  ensure_same_grid(state1, state2);
+  for (uint32 i = 0; i <= state2->mask; i++)
+  {
+    GridCellAcc *acc2 = &state2->cells[i];
+    if (! acc2->used)
+      continue;
+    GridCellAcc *acc1 = gridstate_get(state1, acc2->index);
+    acc1->count += acc2->count;
+    acc1->duration += acc2->duration;
+  }
+  /* The temporal points of the two states are distinct */
+  state1->values += state2->values;
+  PG_RETURN_POINTER(state1);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_grid_serialize);
+/**
+ * Serialize the state of a grid occupancy aggregation, keeping only the
+ * cells of the hash table
+ */
+PGDLLEXPORT Datum
+tpoint_grid_serialize(PG_FUNCTION_ARGS)
+{
+  GridState *state = (GridState *) PG_GETARG_POINTER(0);
+  size_t size = offsetof(GridState, mask);
+  size_t datasize = sizeof(GridCellAcc) * state->count;
+  bytea *result = palloc(VARHDRSZ + size + datasize);
+  SET_VARSIZE(result, VARHDRSZ + size + datasize);
+  memcpy(VARDATA(result), state, size);
+  GridCellAcc *cells = (GridCellAcc *) (VARDATA(result) + size);
+  int k = 0;
+  for (uint32 i = 0; i <= state->mask; i++)
+  {
+    if (state->cells[i].used)
+      memcpy(&cells[k++], &state->cells[i], sizeof(GridCellAcc));
+  }
+  PG_RETURN_BYTEA_P(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_grid_deserialize);
+/**
+ * Deserialize the state of a grid occupancy aggregation
+ */
+PGDLLEXPORT Datum
+tpoint_grid_deserialize(PG_FUNCTION_ARGS)
+{
+  bytea *data = PG_GETARG_BYTEA_P(0);
+  size_t size = offsetof(GridState, mask);
+  GridState header;
+  memcpy(&header, VARDATA(data), size);
+  /* The grid of the header is already normalized */
+  GridState *result = gridstate_make(fcinfo, &header);
+  result->values = header.values;
+  const char *cells = VARDATA(data) + size;
+  for (int i = 0; i < header.count; i++)
+  {
+    GridCellAcc acc;
+    memcpy(&acc, cells + sizeof(GridCellAcc) * i, sizeof(GridCellAcc));
+    *gridstate_get(result, acc.index) = acc;
+  }
+  PG_RETURN_POINTER(result);
+}
+
+/**
+ * Comparator function for cells, which orders them by time and then by
+ * their y and x indexes
+ */
+static int
+gridcellacc_cmp(const void *a, const void *b)
+{
+  const GridCellAcc *acc1 = (const GridCellAcc *) a;
+  const GridCellAcc *acc2 = (const GridCellAcc *) b;
+  for (int i = 2; i >= 0; i--)
+  {
+    if (acc1->index[i] != acc2->index[i])
+      return (acc1->index[i] < acc2->index[i]) ? -1 : 1;
+  }
+  return 0;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_grid_finalfn);
+/**
+ * Final function for the grid occupancy aggregation, which returns an
+ * array with the extent of each cell visited, the time spent in it, and the
+ * number of temporal points visiting it
+ */
+PGDLLEXPORT Datum
+tpoint_grid_finalfn(PG_FUNCTION_ARGS)
+{
+  /* The final function is strict, we do not need to test for null values */
+  GridState *state = (GridState *) PG_GETARG_POINTER(0);
+  if (state->count == 0)
+    PG_RETURN_NULL();
+
+  GridCellAcc *cells = palloc(sizeof(GridCellAcc) * state->count);
+  int k = 0;
+  for (uint32 i = 0; i <= state->mask; i++)
+  {
+    if (state->cells[i].used)
+      cells[k++] = state->cells[i];
+  }
+  qsort(cells, (size_t) k, sizeof(GridCellAcc), gridcellacc_cmp);
+
+  /* The result is an array of the composite type gridcell */
+  Oid elemtypid = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+  TupleDesc tupdesc = lookup_rowtype_tupdesc_copy(elemtypid, -1);
+  tupdesc = BlessTupleDesc(tupdesc);
+  Datum *elems = palloc(sizeof(Datum) * k);
+  for (int i = 0; i < k; i++)
+  {
+    STBOX *box = palloc0(sizeof(STBOX));
+    box->xmin = state->xorigin + cells[i].index[0] * state->size;
+    box->xmax = box->xmin + state->size;
+    box->ymin = state->yorigin + cells[i].index[1] * state->size;
+    box->ymax = box->ymin + state->size;
+    box->tmin = state->torigin + (int64) cells[i].index[2] * state->tsize;
+    box->tmax = box->tmin + state->tsize;
+    box->srid = state->srid;
+    MOBDB_FLAGS_SET_X(box->flags, true);
+    MOBDB_FLAGS_SET_T(box->flags, true);
+    Datum values[3];
+    bool isnull[3] = {false, false, false};
+    values[0] = PointerGetDatum(box);
+    values[1] = call_function2(timestamp_mi,
+      TimestampTzGetDatum(cells[i].duration), TimestampTzGetDatum(0));
+    values[2] = Int32GetDatum(cells[i].count);
+    HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+    elems[i] = HeapTupleGetDatum(tuple);
+    pfree(box);
+  }
+  int16 elmlen;
+  bool elmbyval;
+  char elmalign;
+  get_typlenbyvalalign(elemtypid, &elmlen, &elmbyval, &elmalign);
+  ArrayType *result = construct_array(elems, k, elemtypid, elmlen, elmbyval,
+    elmalign);
+  pfree(elems); pfree(cells);
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Bulk loading of unordered fixes into temporal points
+ *****************************************************************************/
+
+/**
+ * Structure to represent a fix, that is, a point and its timestamp
+ */
+typedef struct
+{
+  TimestampTz t;   /**< Timestamp of the fix */
+  double x;        /**< X coordinate */
+  double y;        /**< Y coordinate */
+  double z;        /**< Z coordinate, 0 for two-dimensional points */
+} Fix;
+
+/**
+ * Structure to represent the state of the aggregation of fixes, which are
+ * collected in a growable array without constructing temporal instants
+ */
+typedef struct
+{
+  int32 srid;       /**< SRID of the points */
+  bool hasz;        /**< True when the points have Z dimension */
+  int64 maxt;       /**< Maximum time gap in a sequence, 0 if unbounded */
+  double maxdist;   /**< Maximum distance in a sequence, 0 if unbounded */
+  int count;        /**< Number of fixes */
+  int size;         /**< Allocated number of fixes */
+  Fix *fixes;       /**< Fixes */
+} FixState;
+
+/**
+ * Returns a new state of the aggregation of fixes, which is allocated in the
+ * aggregation context
+ */
+static FixState *
+fixstate_make(FunctionCallInfo fcinfo, const FixState *header, int size)
+{
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  FixState *result = palloc(sizeof(FixState));
+  memcpy(result, header, offsetof(FixState, count));
+  result->count = 0;
+  result->size = Max(size, 64);
+  result->fixes = palloc(sizeof(Fix) * result->size);
+  unset_aggregation_context(ctx);
+  return result;
+}
+
+/**
+ * Ensure that the fixes of two states of the aggregation can be combined
+ */
+static void
+ensure_same_fixstate(const FixState *state1, const FixState *state2)
+{
+  if (state1->srid != state2->srid)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The points must be in the same SRID")));
+  if (state1->hasz != state2->hasz)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The points must be of the same dimensionality")));
+  if (state1->maxt != state2->maxt || state1->maxdist != state2->maxdist)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The values must be aggregated with the same gaps")));
+}
+
+/**
+ * Ensure that the state of the aggregation has room for the fixes.
+ * The array keeps the memory context of the state.
+ */
+static void
+fixstate_reserve(FixState *state, int count)
+{
+  if (state->count + count <= state->size)
+    return;
+  while (state->count + count > state->size)
+    state->size *= 2;
+  state->fixes = repalloc(state->fixes, sizeof(Fix) * state->size);
+  return;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_fix_transfn);
+/**
+ * Transition function for the aggregation of fixes into a temporal point
+ *
+ * @note Fixes with a null point or timestamp are ignored. The optional gaps
+ * are those of the first fix aggregated.
+ */
+PGDLLEXPORT Datum
+tpoint_fix_transfn(PG_FUNCTION_ARGS)
+{
+  FixState *state = PG_ARGISNULL(0) ? NULL :
+    (FixState *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1) || PG_ARGISNULL(2))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
+
+  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+  ensure_point_type(gs);
+  ensure_non_empty(gs);
+  ensure_has_not_M_gs(gs);
+  TimestampTz t = PG_GETARG_TIMESTAMPTZ(2);
+  if (state == NULL)
+  {
+    FixState header;
+    header.srid = gserialized_get_srid(gs);
+    header.hasz = (bool) FLAGS_GET_Z(gs->flags);
+    header.maxt = 0;
+    header.maxdist = 0;
+    if (PG_NARGS() > 3 && ! PG_ARGISNULL(3))
+    {
+      Interval *interval = PG_GETARG_INTERVAL_P(3);
+      if (interval->month != 0)
+        ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+          errmsg("The maximum time gap cannot have months")));
+      header.maxt = interval->time + interval->day * USECS_PER_DAY;
+      if (header.maxt <= 0)
+        ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+          errmsg("The maximum time gap must be positive")));
+    }
+    if (PG_NARGS() > 4 && ! PG_ARGISNULL(4))
+    {
+      header.maxdist = PG_GETARG_FLOAT8(4);
+      if (header.maxdist <= 0)
+        ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+          errmsg("The maximum distance must be positive")));
+    }
+    state = fixstate_make(fcinfo, &header, 0);
+  }
+  else
+  {
+    if (gserialized_get_srid(gs) != state->srid)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The points must be in the same SRID")));
+    if ((bool) FLAGS_GET_Z(gs->flags) != state->hasz)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The points must be of the same dimensionality")));
+  }
+
+  fixstate_reserve(state, 1);
+  Fix *fix = &state->fixes[state->count++];
+  fix->t = t;
+  if (state->hasz)
+  {
+    const POINT3DZ *p = datum_get_point3dz_p(PointerGetDatum(gs));
+    fix->x = p->x; fix->y = p->y; fix->z = p->z;
+  }
+  else
+  {
+    const POINT2D *p = datum_get_point2d_p(PointerGetDatum(gs));
+    fix->x = p->x; fix->y = p->y; fix->z = 0;
+  }
+  PG_FREE_IF_COPY(gs, 1);
+  PG_RETURN_POINTER(state);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_fix_combinefn);
+/**
+ * Combine function for the aggregation of fixes into a temporal point,
+ * which appends the fixes of the second state to those of the first one
+ */
+PGDLLEXPORT Datum
+tpoint_fix_combinefn(PG_FUNCTION_ARGS)
+{
+  FixState *state1 = PG_ARGISNULL(0) ? NULL :
+    (FixState *) PG_GETARG_POINTER(0);
+  FixState *state2 = PG_ARGISNULL(1) ? NULL :
+    (FixState *) PG_GETARG_POINTER(1);
+  if (state1 == NULL && state2 == NULL)
+    PG_RETURN_NULL();
+  if (state1 == NULL)
+    PG_RETURN_POINTER(state2);
+  if (state2 == NULL || state2->count == 0)
+    PG_RETURN_POINTER(state1);
+
+  ensure_same_fixstate(state1, state2);
+  fixstate_reserve(state1, state2->count);
+  memcpy(&state1->fixes[state1->count], state2->fixes,
+    sizeof(Fix) * state2->count);
+  state1->count += state2->count;
+  PG_RETURN_POINTER(state1);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_fix_serialize);
+/**
+ * Serialize the state of an aggregation of fixes
+ */
+PGDLLEXPORT Datum
+tpoint_fix_serialize(PG_FUNCTION_ARGS)
+{
+  FixState *state = (FixState *) PG_GETARG_POINTER(0);
+  size_t size = offsetof(FixState, size);
+  size_t datasize = sizeof(Fix) * state->count;
+  bytea *result = palloc(VARHDRSZ + size + datasize);
+  SET_VARSIZE(result, VARHDRSZ + size + datasize);
+  memcpy(VARDATA(result), state, size);
+  memcpy(VARDATA(result) + size, state->fixes, datasize);
+  PG_RETURN_BYTEA_P(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_fix_deserialize);
+/**
+ * Deserialize the state of an aggregation of fixes
+ */
+PGDLLEXPORT Datum
+tpoint_fix_deserialize(PG_FUNCTION_ARGS)
+{
+  bytea *data = PG_GETARG_BYTEA_P(0);
+  size_t size = offsetof(FixState, size);
+  FixState header;
+  memcpy(&header, VARDATA(data), size);
+  FixState *result = fixstate_make(fcinfo, &header, header.count);
+  memcpy(result->fixes, VARDATA(data) + size, sizeof(Fix) * header.count);
+  result->count = header.count;
+  PG_RETURN_POINTER(result);
+}
+
+/**
+ * Sorts the fixes by timestamp with a least significant digit radix sort
+ * on the bytes of the timestamps. The sort is stable, so that fixes with
+ * the same timestamp keep the order in which they were aggregated.
+ */
+static void
+fixarr_radix_sort(Fix *fixes, int count)
+{
+  Fix *buffer = palloc(sizeof(Fix) * count);
+  Fix *from = fixes, *to = buffer;
+  for (int shift = 0; shift < 64; shift += 8)
+  {
+    int offsets[256];
+    memset(offsets, 0, sizeof(offsets));
+    /* Flipping the sign bit orders negative timestamps first */
+    for (int i = 0; i < count; i++)
+      offsets[(((uint64) from[i].t ^ UINT64CONST(0x8000000000000000)) >>
+        shift) & 0xFF]++;
+    /* Skip the digits shared by all the fixes */
+    bool skip = false;
+    for (int i = 0; i < 256; i++)
+    {
+      if (offsets[i] == count)
+        skip = true;
+      if (offsets[i] != 0)
+        break;
+    }
+    if (skip)
+      continue;
+    int sum = 0;
+    for (int i = 0; i < 256; i++)
+    {
+      int n = offsets[i];
+      offsets[i] = sum;
+      sum += n;
+    }
+    for (int i = 0; i < count; i++)
+      to[offsets[(((uint64) from[i].t ^ UINT64CONST(0x8000000000000000)) >>
+        shift) & 0xFF]++] = from[i];
+    Fix *tmp = from; from = to; to = tmp;
+  }
+  if (from != fixes)
+    memcpy(fixes, from, sizeof(Fix) * count);
+  pfree(buffer);
+  return;
+}
+
+/**
+ * Returns true if a new sequence must be started between the two fixes
+ */
+static bool
+fix_gap(const FixState *state, const Fix *fix1, const Fix *fix2)
+{
+  if (state->maxt > 0 && fix2->t - fix1->t > state->maxt)
+    return true;
+  if (state->maxdist > 0)
+  {
+    double dx = fix2->x - fix1->x, dy = fix2->y - fix1->y,
+      dz = fix2->z - fix1->z;
+    if (sqrt(dx * dx + dy * dy + dz * dz) > state->maxdist)
+      return true;
+  }
+  return false;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_fix_finalfn);
+/**
+ * Final function for the aggregation of fixes into a temporal point
+ *
+ * The fixes are sorted by timestamp, fixes with the same timestamp as the
+ * previous one are removed, and the result is split into sequences with
+ * linear interpolation where the time gap or the distance between two
+ * consecutive fixes exceeds the given bounds.
+ */
+PGDLLEXPORT Datum
+tpoint_fix_finalfn(PG_FUNCTION_ARGS)
+{
+  /* The final function is strict, we do not need to test for null values */
+  FixState *state = (FixState *) PG_GETARG_POINTER(0);
+  if (state->count == 0)
+    PG_RETURN_NULL();
+
+  /* The state may be finalized several times, e.g., in window functions */
+  Fix *fixes = palloc(sizeof(Fix) * state->count);
+  memcpy(fixes, state->fixes, sizeof(Fix) * state->count);
+  fixarr_radix_sort(fixes, state->count);
+  int count = 1;
+  for (int i = 1; i < state->count; i++)
+  {
+    if (fixes[i].t != fixes[count - 1].t)
+      fixes[count++] = fixes[i];
+  }
+
+  /* The instants are composed from a single point */
+  LWPOINT *lwpoint = state->hasz ? lwpoint_make3dz(state->srid, 0, 0, 0) :
+    lwpoint_make2d(state->srid, 0, 0);
+  GSERIALIZED *gs = geo_serialize((LWGEOM *) lwpoint);
+  lwpoint_free(lwpoint);
+  double *coords = (double *) datum_get_point2d_p(PointerGetDatum(gs));
+  Oid valuetypid = type_oid(T_GEOMETRY);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  TSequence **sequences = palloc(sizeof(TSequence *) * count);
+  int nseqs = 0, start = 0;
+  for (int i = 0; i <= count; i++)
+  {
+    if (i == count || (i > start && fix_gap(state, &fixes[i - 1], &fixes[i])))
+    {
+      sequences[nseqs++] = tsequence_make(&instants[start], i - start,
+        true, true, LINEAR, NORMALIZE);
+      for (int j = start; j < i; j++)
+        pfree(instants[j]);
+      start = i;
+      if (i == count)
+        break;
+    }
+    coords[0] = fixes[i].x;
+    coords[1] = fixes[i].y;
+    if (state->hasz)
+      coords[2] = fixes[i].z;
+    instants[i] = tinstant_make(PointerGetDatum(gs), fixes[i].t, valuetypid);
+  }
+  TSequenceSet *result = tsequenceset_make_free(sequences, nseqs, NORMALIZE_NO);
+  pfree(instants); pfree(fixes); pfree(gs);
   PG_RETURN_POINTER(result);
 }
 
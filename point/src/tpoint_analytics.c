@@ -1131,14 +1131,14 @@ tfloat_simplify(PG_FUNCTION_ARGS)
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT || temp->duration == INSTANTSET ||
     ! MOBDB_FLAGS_GET_LINEAR(temp->flags))
-    result = temporal_copy(temp);
+    result = temp;
   else if (temp->duration == SEQUENCE)
     result = (Temporal *) tfloatseq_simplify((TSequence *)temp,
       eps_dist, 2);
   else /* temp->duration == SEQUENCESET */
     result = (Temporal *) tfloatseqset_simplify((TSequenceSet *)temp,
       eps_dist, 2);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_RETURN_POINTER(result);
 }
 
@@ -1149,20 +1149,23 @@ tfloat_simplify(PG_FUNCTION_ARGS)
  ***********************************************************************/
 
 /**
- * Returns the speed of the temporal point in the segment
+ * Returns the speed of the temporal point in the segment defined by the
+ * packed coordinates and timestamps
  *
- * @param[in] inst1, inst2 Instants defining the segment
- * @param[in] func Distance function (2D, 3D, or geodetic)
+ * @param[in] p1, p2 Points defining the segment
+ * @param[in] t1, t2 Timestamps of the points
+ * @param[in] hasz True when the points have Z coordinates
  */
 static double
-tpointinst_speed(const TInstant *inst1, const TInstant *inst2,
-  Datum (*func)(Datum, Datum))
+point3dz_speed(const POINT3DZ *p1, TimestampTz t1, const POINT3DZ *p2,
+  TimestampTz t2, bool hasz)
 {
-  Datum value1 = tinstant_value(inst1);
-  Datum value2 = tinstant_value(inst2);
-  return datum_point_eq(value1, value2) ? 0 :
-    DatumGetFloat8(func(value1, value2)) / 
-      ((double)(inst2->t - inst1->t) / 1000000);
+  if (p1->x == p2->x && p1->y == p2->y && p1->z == p2->z)
+    return 0;
+  double dist = hasz ?
+    distance3d_pt_pt((POINT3D *) p1, (POINT3D *) p2) :
+    distance2d_pt_pt((POINT2D *) p1, (POINT2D *) p2);
+  return dist / ((double)(t2 - t1) / 1000000);
 }
 
 /**
@@ -1315,7 +1318,12 @@ dist4d_pt_seg(POINT4D *p, POINT4D *A, POINT4D *B)
  * spatio-temporal extension of the Douglas-Peucker line simplification
  * algorithm.
  *
- * @param[in] seq Temporal sequence
+ * The coordinates and the timestamps of the sequence are packed in arrays
+ * so that they are not read again from the instants at every recursion
+ * level. The Z coordinates of 2D points are ignored.
+ *
+ * @param[in] points, times Coordinates and timestamps of the sequence
+ * @param[in] hasz True when the points have Z coordinates
  * @param[in] i1,i2 Indexes of the reference instants
  * @param[in] withspeed True when the delta in the speed must be considered
  * @param[out] split Location of the split
@@ -1323,100 +1331,207 @@ dist4d_pt_seg(POINT4D *p, POINT4D *A, POINT4D *B)
  * @param[out] delta_speed Delta speed at the split
  */
 static void
-tpointseq_dp_findsplit(const TSequence *seq, int i1, int i2, bool withspeed,
-  int *split, double *dist, double *delta_speed)
+tpointseq_dp_findsplit(POINT3DZ *points, const TimestampTz *times,
+  bool hasz, int i1, int i2, bool withspeed, int *split, double *dist,
+  double *delta_speed)
 {
-  POINT2D p2k, p2k_tmp, p2a, p2b;
-  POINT3DZ p3k, p3k_tmp, p3a, p3b;
+  POINT3DZ p3k, p3a, p3b;
   POINT4D p4k, p4a, p4b;
   double d;
-  bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
   *split = i1;
   d = -1;
   if (i1 + 1 < i2)
   {
     double speed_seg;
-    Datum (*func)(Datum, Datum);
-    if (withspeed)
-      func = hasz ? &pt_distance3d : &pt_distance2d;
-    TInstant *inst1 = tsequence_inst_n(seq, i1);
-    TInstant *inst2 = tsequence_inst_n(seq, i2);
+    POINT3DZ *pa = &points[i1], *pb = &points[i2];
     if (withspeed)
-      speed_seg = tpointinst_speed(inst1, inst2, func);
-    if (hasz)
     {
-      p3a = datum_get_point3dz(tinstant_value(inst1));
-      p3b = datum_get_point3dz(tinstant_value(inst2));
-      if (withspeed)
+      speed_seg = point3dz_speed(pa, times[i1], pb, times[i2], hasz);
+      if (hasz)
       {
-        p4a.x = p3a.x; p4a.y = p3a.y;
-        p4a.z = p3a.z; p4a.m = speed_seg;
-        p4b.x = p3b.x; p4b.y = p3b.y;
-        p4b.z = p3b.z; p4b.m = speed_seg;
+        p4a.x = pa->x; p4a.y = pa->y;
+        p4a.z = pa->z; p4a.m = speed_seg;
+        p4b.x = pb->x; p4b.y = pb->y;
+        p4b.z = pb->z; p4b.m = speed_seg;
       }
-    }
-    else
-    {
-      p2a = datum_get_point2d(tinstant_value(inst1));
-      p2b = datum_get_point2d(tinstant_value(inst2));
-      if (withspeed)
+      else
       {
-        p3a.x = p2a.x; p3a.y = p2a.y; p3a.z = speed_seg;
-        p3b.x = p2b.x; p3b.y = p2b.y; p3b.z = speed_seg;
+        p3a.x = pa->x; p3a.y = pa->y; p3a.z = speed_seg;
+        p3b.x = pb->x; p3b.y = pb->y; p3b.z = speed_seg;
       }
     }
     for (int k = i1 + 1; k < i2; k++)
     {
       double d_tmp, speed_pt;
-      inst2 = tsequence_inst_n(seq, k);
+      POINT3DZ *pk = &points[k];
       if (withspeed)
-        speed_pt = tpointinst_speed(inst1, inst2, func);
-      if (hasz)
       {
-        p3k_tmp = datum_get_point3dz(tinstant_value(inst2));
-        if (withspeed)
+        speed_pt = point3dz_speed(&points[k - 1], times[k - 1], pk,
+          times[k], hasz);
+        if (hasz)
         {
-          p4k.x = p3k_tmp.x; p4k.y = p3k_tmp.y;
-          p4k.z = p3k_tmp.z; p4k.m = speed_pt;
+          p4k.x = pk->x; p4k.y = pk->y;
+          p4k.z = pk->z; p4k.m = speed_pt;
           d_tmp = dist4d_pt_seg(&p4k, &p4a, &p4b);
         }
         else
-          d_tmp = dist3d_pt_seg(&p3k_tmp, &p3a, &p3b);
-      }
-      else
-      {
-        p2k_tmp = datum_get_point2d(tinstant_value(inst2));
-        if (withspeed)
         {
-          p3k.x = p2k_tmp.x; p3k.y = p2k_tmp.y; p3k.z = speed_pt;
+          p3k.x = pk->x; p3k.y = pk->y; p3k.z = speed_pt;
           d_tmp = dist3d_pt_seg(&p3k, &p3a, &p3b);
         }
-        else
-          d_tmp = dist2d_pt_seg(&p2k_tmp, &p2a, &p2b);
       }
+      else
+        d_tmp = hasz ? dist3d_pt_seg(pk, pa, pb) :
+          dist2d_pt_seg((POINT2D *) pk, (POINT2D *) pa, (POINT2D *) pb);
       if (d_tmp > d)
       {
         /* record the maximum */
         d = d_tmp;
-        if (hasz)
-          p3k = p3k_tmp;
-        else
-          p2k = p2k_tmp;
         if (withspeed)
           *delta_speed = fabs(speed_seg - speed_pt);
         *split = k;
       }
-      inst1 = inst2;
     }
-    *dist = hasz ? dist3d_pt_seg(&p3k, &p3a, &p3b) :
-      distance2d_pt_seg(&p2k, &p2a, &p2b);
+    *dist = hasz ? dist3d_pt_seg(&points[*split], pa, pb) :
+      distance2d_pt_seg((POINT2D *) &points[*split], (POINT2D *) pa,
+        (POINT2D *) pb);
   }
   else
     *dist = -1;
 }
 
+/**
+ * Packs the coordinates and the timestamps of the temporal sequence point
+ * in arrays, the Z coordinates of 2D points being set to 0
+ */
+static void
+tpointseq_dp_pack(const TSequence *seq, POINT3DZ **points,
+  TimestampTz **times)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+  *points = palloc(sizeof(POINT3DZ) * seq->count);
+  *times = palloc(sizeof(TimestampTz) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    TInstant *inst = tsequence_inst_n(seq, i);
+    (*times)[i] = inst->t;
+    if (hasz)
+      (*points)[i] = datum_get_point3dz(tinstant_value(inst));
+    else
+    {
+      const POINT2D *p = datum_get_point2d_p(tinstant_value(inst));
+      (*points)[i].x = p->x;
+      (*points)[i].y = p->y;
+      (*points)[i].z = 0;
+    }
+  }
+  return;
+}
+
 /***********************************************************************/
 
+/**
+ * Returns the number of instants of the simplification levels of the
+ * temporal sequence point whose significance is greater than the tolerance
+ *
+ * The coarsest level whose tolerance is not greater than the one given is
+ * found in constant time, the instants to keep are then found by a binary
+ * search between the instants of this level and those of the next one.
+ */
+static int
+tpointseq_levels_count(const TSequenceLevels *levels, double eps_dist)
+{
+  const int32 *counts = tsequence_levels_counts(levels);
+  const double *signif = tsequence_levels_significance(levels);
+  int k = 0;
+  double tol = levels->tolerance;
+  while (k + 1 < levels->count && tol * 2 <= eps_dist)
+  {
+    tol *= 2;
+    k++;
+  }
+  int lower = (k + 1 < levels->count) ? counts[k + 1] : 0;
+  int upper = counts[k];
+  while (lower < upper)
+  {
+    int middle = (lower + upper) / 2;
+    if (signif[middle] > eps_dist)
+      lower = middle + 1;
+    else
+      upper = middle;
+  }
+  return lower;
+}
+
+/**
+ * Simplifies the temporal sequence point with its simplification levels
+ *
+ * The result is the one of the Douglas-Peucker algorithm without speed
+ * since the latter keeps exactly the instants whose significance is greater
+ * than the tolerance.
+ *
+ * @return Returns NULL if the sequence does not have simplification levels
+ * or if the tolerance is smaller than the one of their finest level
+ */
+static TSequence *
+tpointseq_simplify_levels(const TSequence *seq, double eps_dist)
+{
+  const TSequenceLevels *levels = tsequence_levels_ptr(seq);
+  if (levels == NULL || eps_dist < levels->tolerance)
+    return NULL;
+  int count = tpointseq_levels_count(levels, eps_dist);
+  int *indexes = palloc(sizeof(int) * count);
+  memcpy(indexes, tsequence_levels_indexes(levels), sizeof(int) * count);
+  qsort(indexes, count, sizeof(int), int_cmp);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    instants[i] = tsequence_inst_n(seq, indexes[i]);
+  TSequence *result = tsequence_make(instants, count,
+    seq->period.lower_inc, seq->period.upper_inc,
+    MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
+  pfree(instants); pfree(indexes);
+  return result;
+}
+
+/**
+ * Simplifies the temporal point with its simplification levels, the
+ * sequences without levels fine enough for the tolerance being kept as
+ * they are
+ *
+ * @return Returns NULL if no sequence of the temporal point has
+ * simplification levels fine enough for the tolerance
+ */
+Temporal *
+tpoint_simplify_levels(const Temporal *temp, double eps_dist)
+{
+  if (temp->duration == SEQUENCE)
+    return (Temporal *) tpointseq_simplify_levels((TSequence *) temp,
+      eps_dist);
+  if (temp->duration != SEQUENCESET)
+    return NULL;
+  const TSequenceSet *ts = (TSequenceSet *) temp;
+  TSequence **sequences = palloc(sizeof(TSequence *) * ts->count);
+  bool found = false;
+  for (int i = 0; i < ts->count; i++)
+  {
+    const TSequence *seq = tsequenceset_seq_n(ts, i);
+    sequences[i] = tpointseq_simplify_levels(seq, eps_dist);
+    if (sequences[i] == NULL)
+      sequences[i] = tsequence_copy(seq);
+    else
+      found = true;
+  }
+  if (! found)
+  {
+    for (int i = 0; i < ts->count; i++)
+      pfree(sequences[i]);
+    pfree(sequences);
+    return NULL;
+  }
+  return (Temporal *) tsequenceset_make_free(sequences, ts->count,
+    NORMALIZE);
+}
+
 /**
  * Simplifies the temporal sequence point using a spatio-temporal
  * extension of the Douglas-Peucker line simplification algorithm.
@@ -1445,6 +1560,14 @@ tpointseq_simplify(const TSequence *seq, double eps_dist,
   if (seq->count < 3)
     return tsequence_copy(seq);
 
+  /* Use the simplification levels when they are fine enough */
+  if (! withspeed && minpts <= 2)
+  {
+    TSequence *result = tpointseq_simplify_levels(seq, eps_dist);
+    if (result != NULL)
+      return result;
+  }
+
   /* Only heap allocate book-keeping arrays if necessary */
   if ((unsigned int) seq->count > stack_size)
   {
@@ -1457,13 +1580,20 @@ tpointseq_simplify(const TSequence *seq, double eps_dist,
     outlist = outlist_static;
   }
 
+  /* Pack the coordinates and the timestamps of the sequence */
+  bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+  POINT3DZ *points;
+  TimestampTz *times;
+  tpointseq_dp_pack(seq, &points, &times);
+
   p1 = 0;
   stack[++sp] = seq->count - 1;
   /* Add first point to output list */
   outlist[outn++] = 0;
   do
   {
-    tpointseq_dp_findsplit(seq, p1, stack[sp], withspeed, &split, &dist, &delta_speed);
+    tpointseq_dp_findsplit(points, times, hasz, p1, stack[sp], withspeed,
+      &split, &dist, &delta_speed);
     bool dosplit;
     if (withspeed)
       dosplit = (dist >= 0 &&
@@ -1491,6 +1621,7 @@ tpointseq_simplify(const TSequence *seq, double eps_dist,
     seq->period.lower_inc, seq->period.upper_inc,
     MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
   pfree(instants);
+  pfree(points); pfree(times);
 
   /* Only free if arrays are on heap */
   if (stack != stack_static)
@@ -1548,14 +1679,172 @@ tpoint_simplify(PG_FUNCTION_ARGS)
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT || temp->duration == INSTANTSET ||
     ! MOBDB_FLAGS_GET_LINEAR(temp->flags))
-    result = temporal_copy(temp);
+    result = temp;
   else if (temp->duration == SEQUENCE)
     result = (Temporal *) tpointseq_simplify((TSequence *)temp,
       eps_dist, eps_speed, 2);
   else /* temp->duration == SEQUENCESET */
     result = (Temporal *) tpointseqset_simplify((TSequenceSet *)temp,
       eps_dist, eps_speed, 2);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Simplification levels stored with the temporal points
+ *****************************************************************************/
+
+/**
+ * Structure to sort the instants of the simplification levels
+ */
+typedef struct
+{
+  int index;
+  double signif;
+} LevelInstant;
+
+/**
+ * Sorts the instants of the simplification levels by decreasing
+ * significance and then by increasing index
+ */
+static int
+level_instant_cmp(const void *a, const void *b)
+{
+  const LevelInstant *la = (const LevelInstant *) a;
+  const LevelInstant *lb = (const LevelInstant *) b;
+  if (la->signif != lb->signif)
+    return (la->signif > lb->signif) ? -1 : 1;
+  return la->index - lb->index;
+}
+
+/**
+ * Returns a copy of the temporal sequence point with simplification levels
+ *
+ * The Douglas-Peucker algorithm is run once with the tolerance of the
+ * finest level. The significance of an instant is the minimum of its
+ * distance to the segment it splits and of the significance of the instants
+ * bounding this segment, so that the algorithm keeps an instant for a given
+ * tolerance if and only if its significance is greater than the latter.
+ *
+ * @param[in] seq Temporal point
+ * @param[in] eps_dist Tolerance of the finest level
+ * @param[in] count Number of levels
+ */
+static TSequence *
+tpointseq_with_simplify_levels(const TSequence *seq, double eps_dist,
+  int count)
+{
+  /* Really short things are not simplified */
+  if (seq->count < 3)
+    return tsequence_copy(seq);
+
+  bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+  POINT3DZ *points;
+  TimestampTz *times;
+  tpointseq_dp_pack(seq, &points, &times);
+  double *signif = palloc(sizeof(double) * seq->count);
+  int *stack = palloc(sizeof(int) * seq->count);
+  for (int i = 1; i < seq->count - 1; i++)
+    signif[i] = -1;
+  signif[0] = signif[seq->count - 1] = DBL_MAX;
+  int sp = -1, p1 = 0, split, total = 2;
+  double dist, delta_speed;
+  stack[++sp] = seq->count - 1;
+  do
+  {
+    tpointseq_dp_findsplit(points, times, hasz, p1, stack[sp], false,
+      &split, &dist, &delta_speed);
+    if (dist >= 0 && dist > eps_dist)
+    {
+      signif[split] = Min(dist, Min(signif[p1], signif[stack[sp]]));
+      stack[++sp] = split;
+      total++;
+    }
+    else
+      p1 = stack[sp--];
+  }
+  while (sp >= 0);
+
+  /* Sort the instants kept by decreasing significance */
+  LevelInstant *kept = palloc(sizeof(LevelInstant) * total);
+  int k = 0;
+  for (int i = 0; i < seq->count; i++)
+  {
+    if (signif[i] >= 0)
+    {
+      kept[k].index = i;
+      kept[k++].signif = signif[i];
+    }
+  }
+  qsort(kept, total, sizeof(LevelInstant), level_instant_cmp);
+
+  /* Construct the levels */
+  size_t size = tsequence_levels_size(count, total);
+  TSequenceLevels *levels = palloc0(size);
+  levels->tolerance = eps_dist;
+  levels->count = count;
+  levels->total = total;
+  int32 *counts = tsequence_levels_counts(levels);
+  int32 *indexes = tsequence_levels_indexes(levels);
+  double *lsignif = tsequence_levels_significance(levels);
+  for (int i = 0; i < total; i++)
+  {
+    indexes[i] = kept[i].index;
+    lsignif[i] = kept[i].signif;
+  }
+  double tol = eps_dist;
+  k = total;
+  for (int i = 0; i < count; i++)
+  {
+    while (k > 0 && lsignif[k - 1] <= tol)
+      k--;
+    counts[i] = k;
+    tol *= 2;
+  }
+  TSequence *result = tsequence_add_levels(seq, levels);
+  pfree(levels); pfree(kept); pfree(stack); pfree(signif);
+  pfree(points); pfree(times);
+  return result;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_with_simplify_levels);
+/**
+ * Returns a copy of the temporal point whose sequences keep simplification
+ * levels, which are used by the simplification of the temporal point with
+ * a tolerance not smaller than the one given
+ */
+Datum
+tpoint_with_simplify_levels(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  double eps_dist = PG_GETARG_FLOAT8(1);
+  int32 count = PG_GETARG_INT32(2);
+  if (eps_dist <= 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The tolerance must be positive")));
+  if (count < 1 || count > 32)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The number of levels must be between 1 and 32")));
+
+  Temporal *result;
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT || temp->duration == INSTANTSET ||
+    ! MOBDB_FLAGS_GET_LINEAR(temp->flags))
+    result = temp;
+  else if (temp->duration == SEQUENCE)
+    result = (Temporal *) tpointseq_with_simplify_levels((TSequence *) temp,
+      eps_dist, count);
+  else /* temp->duration == SEQUENCESET */
+  {
+    TSequenceSet *ts = (TSequenceSet *) temp;
+    TSequence **sequences = palloc(sizeof(TSequence *) * ts->count);
+    for (int i = 0; i < ts->count; i++)
+      sequences[i] = tpointseq_with_simplify_levels(tsequenceset_seq_n(ts, i),
+        eps_dist, count);
+    result = (Temporal *) tsequenceset_make_free(sequences, ts->count,
+      NORMALIZE_NO);
+  }
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_RETURN_POINTER(result);
 }
 
@@ -23,7 +23,8 @@
  * 
  * For the spatial dimension, the statistics collected are the same for all 
  * durations. These statistics are obtained by calling the PostGIS function
- * `gserialized_analyze_nd`.
+ * `gserialized_analyze_nd` on the bounding boxes stored in the temporal
+ * points, which are read without detoasting the whole values.
  * - Slot 1
  *     - `stakind` contains the type of statistics which is `STATISTIC_SLOT_2D`.
  *     - `stanumbers` stores the 2D histrogram of occurrence of features.
@@ -33,6 +34,14 @@
  *
  * For the time dimension, the statistics collected in Slots 3 and 4 depend on 
  * the duration. Please refer to file temporal_analyze.c for more information.
+ *
+ * For the joint space and time dimensions, the statistics are obtained by
+ * the same function applied to the spatiotemporal bounding boxes.
+ * - Slot 5
+ *     - `stakind` contains the type of statistics which is
+ *       `STATISTIC_KIND_ND_TIME`.
+ *     - `stanumbers` stores the (x, y[, z], t) histogram of occurrence of
+ *       features, the time dimension being the last one.
  */
 
 #include "tpoint_analyze.h"
@@ -72,6 +81,13 @@
 #define STATISTIC_SLOT_ND 0
 #define STATISTIC_SLOT_2D 1
 
+/**
+ * Assign a number to the space-time statistics kind, which is not defined
+ * by PostGIS
+ */
+#define STATISTIC_KIND_ND_TIME 104
+#define STATISTIC_SLOT_ND_TIME 4
+
 /**
  * The SD factor restricts the side of the statistics histogram
  * based on the standard deviation of the extent of the data.
@@ -289,6 +305,35 @@ nd_box_from_gbox(const GBOX *gbox, ND_BOX *nd_box)
   }
 }
 
+/**
+ * Set the values of an #ND_BOX from the spatial and time dimensions of an
+ * STBOX. The time dimension, if any, is the last of the ndims dimensions,
+ * the third spatial dimension is only set when ndims is 4.
+ */
+void
+nd_box_from_stbox_time(const STBOX *box, int ndims, ND_BOX *nd_box)
+{
+  nd_box_init(nd_box);
+  if (MOBDB_FLAGS_GET_X(box->flags))
+  {
+    nd_box->min[0] = (float4) box->xmin;
+    nd_box->max[0] = (float4) box->xmax;
+    nd_box->min[1] = (float4) box->ymin;
+    nd_box->max[1] = (float4) box->ymax;
+    if (ndims == 4)
+    {
+      nd_box->min[2] = (float4) box->zmin;
+      nd_box->max[2] = (float4) box->zmax;
+    }
+  }
+  if (MOBDB_FLAGS_GET_T(box->flags))
+  {
+    nd_box->min[ndims - 1] = (float4) box->tmin;
+    nd_box->max[ndims - 1] = (float4) box->tmax;
+  }
+  return;
+}
+
 /**
  * The difference between the fourth and first quintile values,
  * the "inter-quintile range"
@@ -490,6 +535,10 @@ gbox_ndims(const GBOX* gbox)
  * We will populate an n-d histogram using the provided
  * sample rows. The selectivity estimators (sel and j_oinsel)
  * can then use the histogram
+ *
+ * This changes wrt the original PostGIS function. A mode of 3 or 4 builds
+ * a joint histogram with mode dimensions from the spatiotemporal bounding
+ * boxes of the temporal points, the time dimension being the last one.
  */
 void
 gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
@@ -560,12 +609,10 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   for ( i = 0; i < sample_rows; i++ )
   {
     Datum datum;
-    Temporal *temp;
-    GSERIALIZED *geom;
+    STBOX box;
     GBOX gbox;
     ND_BOX *nd_box;
     bool is_null;
-    bool is_copy;
 
     datum = fetchfunc(stats, i, &is_null);
 
@@ -578,43 +625,50 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 
     /*
      * This changes wrt the original PostGIS function. We get a temporal
-     * point while the original function gets a geometry.
+     * point while the original function gets a geometry. The bounding box
+     * of the temporal point is read without detoasting the whole value and
+     * its spatial dimensions replace the bounds of the trajectory.
      */
-    temp = DatumGetTemporal(datum);
-
-    /* TO VERIFY */
-    is_copy = VARATT_IS_EXTENDED(temp);
-
-    /* Get trajectory from temporal point */
-    geom = (GSERIALIZED *) DatumGetPointer(tpoint_trajectory_internal(temp));
+    memset(&box, 0, sizeof(STBOX));
+    temporal_bbox_slice(&box, datum);
 
-    /* Read the bounds from the gserialized. */
-    if ( LW_FAILURE == gserialized_get_gbox_p(geom, &gbox) )
+    if ( mode >= 3 )
     {
-      /* Skip empties too. */
-      continue;
+      ndims = mode;
+      nd_box = palloc(sizeof(ND_BOX));
+      nd_box_from_stbox_time(&box, ndims, nd_box);
     }
-
-    /* If we're in 2D mode, zero out the higher dimensions for "safety" */
-    if ( mode == 2 )
-      gbox.zmin = gbox.zmax = gbox.mmin = gbox.mmax = 0.0;
-
-    /* Check bounds for validity (finite and not NaN) */
-    if ( ! gbox_is_valid(&gbox) )
+    else
     {
-      continue;
-    }
+      /* Read the bounds from the bounding box */
+      memset(&gbox, 0, sizeof(GBOX));
+      gbox.flags = gflags(MOBDB_FLAGS_GET_Z(box.flags), false,
+        MOBDB_FLAGS_GET_GEODETIC(box.flags));
+      gbox.xmin = box.xmin; gbox.xmax = box.xmax;
+      gbox.ymin = box.ymin; gbox.ymax = box.ymax;
+      gbox.zmin = box.zmin; gbox.zmax = box.zmax;
+
+      /* If we're in 2D mode, zero out the higher dimensions for "safety" */
+      if ( mode == 2 )
+        gbox.zmin = gbox.zmax = gbox.mmin = gbox.mmax = 0.0;
+
+      /* Check bounds for validity (finite and not NaN) */
+      if ( ! gbox_is_valid(&gbox) )
+      {
+        continue;
+      }
 
-    /*
-     * In N-D mode, set the ndims to the maximum dimensionality found
-     * in the sample. Otherwise, leave at ndims == 2.
-     */
-    if ( mode != 2 )
-      ndims = Max(gbox_ndims(&gbox), ndims);
+      /*
+       * In N-D mode, set the ndims to the maximum dimensionality found
+       * in the sample. Otherwise, leave at ndims == 2.
+       */
+      if ( mode != 2 )
+        ndims = Max(gbox_ndims(&gbox), ndims);
 
-    /* Convert gbox to n-d box */
-    nd_box = palloc(sizeof(ND_BOX));
-    nd_box_from_gbox(&gbox, nd_box);
+      /* Convert gbox to n-d box */
+      nd_box = palloc(sizeof(ND_BOX));
+      nd_box_from_gbox(&gbox, nd_box);
+    }
 
     /* Cache n-d bounding box */
     sample_boxes[notnull_cnt] = nd_box;
@@ -636,10 +690,6 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     /* Increment our "good feature" count */
     notnull_cnt++;
 
-    /* Free up memory if our sample geometry was copied */
-    if ( is_copy )
-      pfree(geom);
-
     /* Give backend a chance of interrupting us */
     vacuum_delay_point();
   }
@@ -916,6 +966,11 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     stats_slot = STATISTIC_SLOT_2D;
     stats_kind = STATISTIC_KIND_2D;
   }
+  else if ( mode >= 3 )
+  {
+    stats_slot = STATISTIC_SLOT_ND_TIME;
+    stats_kind = STATISTIC_KIND_ND_TIME;
+  }
   else
   {
     stats_slot = STATISTIC_SLOT_ND;
@@ -949,6 +1004,7 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   double total_width = 0;      /* # of bytes used by sample */
 
   int slot_idx = 2;        /* Starting slot for storing temporal statistics */
+  bool hasz = false;        /* Whether the points have a third dimension */
 
   PeriodBound *time_lowers = (PeriodBound *) palloc(sizeof(PeriodBound) * sample_rows);
   PeriodBound *time_uppers = (PeriodBound *) palloc(sizeof(PeriodBound) * sample_rows);
@@ -961,12 +1017,11 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   for (int i = 0; i < sample_rows; i++)
   {
     Datum value;
-    Temporal *temp;
+    STBOX box;
     Period period;
     PeriodBound period_lower,
         period_upper;
     bool is_null;
-    bool is_copy;
 
     value = fetchfunc(stats, i, &is_null);
 
@@ -977,17 +1032,22 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
       continue;
     }
 
-    /* Get temporal point */
-    temp = DatumGetTemporal(value);
+    /* How many bytes does this sample use? */
+    total_width += VARSIZE_ANY(DatumGetPointer(value));
 
-    /* TO VERIFY */
-    is_copy = VARATT_IS_EXTENDED(temp);
+    /*
+     * The bounding box and the period of the temporal point are read
+     * without detoasting the whole value
+     */
+    memset(&box, 0, sizeof(STBOX));
+    temporal_bbox_slice(&box, value);
 
-    /* How many bytes does this sample use? */
-    total_width += VARSIZE(temp);
+    /* Geodetic points have a third dimension in their bounding box */
+    if (MOBDB_FLAGS_GET_Z(box.flags) || MOBDB_FLAGS_GET_GEODETIC(box.flags))
+      hasz = true;
 
     /* Get period from temporal point */
-    temporal_period(&period, temp);
+    temporal_period_slice(&period, value);
 
     /* Remember time bounds and length for further usage in histograms */
     period_deserialize(&period, &period_lower, &period_upper);
@@ -999,10 +1059,6 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     /* Increment our "good feature" count */
     notnull_cnt++;
 
-    /* Free up memory if our sample temporal point was copied */
-    if (is_copy)
-      pfree(temp);
-
     /* Give backend a chance of interrupting us */
     vacuum_delay_point();
   }
@@ -1023,6 +1079,9 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     gserialized_compute_stats(stats, fetchfunc, sample_rows, total_rows, 2);
     /* ND Mode */
     gserialized_compute_stats(stats, fetchfunc, sample_rows, total_rows, 0);
+    /* Space-time Mode */
+    gserialized_compute_stats(stats, fetchfunc, sample_rows, total_rows,
+      hasz ? 4 : 3);
 
     /* Compute statistics for time dimension */
     period_compute_stats1(stats, notnull_cnt, &slot_idx,
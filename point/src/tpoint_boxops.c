@@ -212,15 +212,13 @@ boxop_geo_tpoint(FunctionCallInfo fcinfo,
 	GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
 	if (gserialized_is_empty(gs))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
 	geo_to_stbox_internal(&box1, gs);
-	temporal_bbox(&box2, temp);
+	temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
 	bool result = func(&box1, &box2);
 	PG_FREE_IF_COPY(gs, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -237,14 +235,12 @@ boxop_tpoint_geo(FunctionCallInfo fcinfo,
 	GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
 	if (gserialized_is_empty(gs))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	geo_to_stbox_internal(&box2, gs);
 	bool result = func(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
 	PG_RETURN_BOOL(result);
 }
@@ -260,12 +256,10 @@ boxop_stbox_tpoint(FunctionCallInfo fcinfo,
 	bool (*func)(const STBOX *, const STBOX *))
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
 	bool result = func(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -279,13 +273,11 @@ Datum
 boxop_tpoint_stbox(FunctionCallInfo fcinfo,
 	bool (*func)(const STBOX *, const STBOX *))
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
 	bool result = func(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -299,16 +291,12 @@ Datum
 boxop_tpoint_tpoint(FunctionCallInfo fcinfo,
 	bool (*func)(const STBOX *, const STBOX *))
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
 	bool result = func(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -324,7 +312,7 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_geo_tpoint);
 PGDLLEXPORT Datum
 overlaps_bbox_geo_tpoint(PG_FUNCTION_ARGS)
 {
-	return boxop_geo_tpoint(fcinfo, &overlaps_stbox_stbox_internal);
+	return boxop_geo_tpoint(fcinfo, &overlaps_stbox_stbox_inline);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_bbox_stbox_tpoint);
@@ -335,7 +323,7 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_stbox_tpoint);
 PGDLLEXPORT Datum
 overlaps_bbox_stbox_tpoint(PG_FUNCTION_ARGS)
 {
-	return boxop_stbox_tpoint(fcinfo, &overlaps_stbox_stbox_internal);
+	return boxop_stbox_tpoint(fcinfo, &overlaps_stbox_stbox_inline);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_bbox_tpoint_geo);
@@ -345,7 +333,7 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tpoint_geo);
 PGDLLEXPORT Datum
 overlaps_bbox_tpoint_geo(PG_FUNCTION_ARGS)
 {
-	return boxop_tpoint_geo(fcinfo, &overlaps_stbox_stbox_internal);
+	return boxop_tpoint_geo(fcinfo, &overlaps_stbox_stbox_inline);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_bbox_tpoint_stbox);
@@ -355,7 +343,7 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tpoint_stbox);
 PGDLLEXPORT Datum
 overlaps_bbox_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	return boxop_tpoint_stbox(fcinfo, &overlaps_stbox_stbox_internal);
+	return boxop_tpoint_stbox(fcinfo, &overlaps_stbox_stbox_inline);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_bbox_tpoint_tpoint);
@@ -365,7 +353,7 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tpoint_tpoint);
 PGDLLEXPORT Datum
 overlaps_bbox_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-	return boxop_tpoint_tpoint(fcinfo, &overlaps_stbox_stbox_internal);
+	return boxop_tpoint_tpoint(fcinfo, &overlaps_stbox_stbox_inline);
 }
 
 /*****************************************************************************
@@ -15,6 +15,7 @@
 #include <access/htup_details.h>
 #include <access/tupdesc.h>    /* for * () */
 #include <executor/executor.h>  /* for GetAttributeByName() */
+#include <funcapi.h>
 #include <utils/builtins.h>
 #include <utils/lsyscache.h>
 #include <utils/timestamp.h>
@@ -31,7 +32,9 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_datagen.h"
 #include "postgis.h"
+#include "stbox.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
 
@@ -83,7 +86,8 @@ pt_angle(POINT2D p1, POINT2D p2, POINT2D p3)
   } while (0)
 
 /**
- * Create a trip using the BerlinMOD data generator (internal function)
+ * Create a trip using the BerlinMOD data generator (internal function).
+ * The edges are not freed by the function.
  */
 TSequence *
 create_trip_internal(LWLINE **lines, const double *maxSpeeds, const int *categories,
@@ -434,136 +438,429 @@ create_trip_internal(LWLINE **lines, const double *maxSpeeds, const int *categor
         errmsg("    ------------------------------------------")));
   }
 
-  for (i = 0; i < noEdges; i++)
-    lwgeom_free(lwline_as_lwgeom(lines[i]));
-  pfree(lines);
   return result;
 }
 
-PG_FUNCTION_INFO_V1(create_trip);
+/* Ordinal numbers used in the error messages about the records */
+static const char *trip_record_ordinals[] =
+  {"First", "Second", "Third", "Fourth"};
+
 /**
- * Create a trip using the BerlinMOD data generator
+ * Verifies that the attribute of the records of the edges is of the type
  */
-Datum
-create_trip(PG_FUNCTION_ARGS)
+static void
+trip_record_att_valid(TupleDesc tupdesc, int att, Oid type, const char *name)
+{
+  if (TupleDescAttr(tupdesc, att)->atttypid != type)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("%s element of the record must be of type %s",
+        trip_record_ordinals[att], name)));
+  return;
+}
+
+/**
+ * Extracts the edges of the trips from the array of records. The records
+ * are composed of a linestring, a maximum speed, and a category, preceded
+ * by the identifier of the trip when withid is true.
+ *
+ * The type of the records is looked up and their attributes are extracted
+ * once per record, instead of once per attribute as with GetAttributeByNum.
+ *
+ * @param[in] array Array of records
+ * @param[in] withid True when the records start with the trip identifier
+ * @param[out] ids Identifiers of the trips of the edges, if withid is true
+ * @param[out] lines,maxSpeeds,categories Attributes of the edges
+ * @return Number of edges
+ */
+static int
+trip_edges_extract(ArrayType *array, bool withid, int32 **ids,
+  LWLINE ***lines, double **maxSpeeds, int **categories)
 {
-  ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
   ensure_non_empty_array(array);
   if (ARR_NDIM(array) > 1)
     ereport(ERROR, (errcode(ERRCODE_ARRAY_SUBSCRIPT_ERROR), 
       errmsg("1-dimensional array needed")));
-  TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
-  bool disturbData = PG_GETARG_BOOL(2);
-  // int32 messages = PG_GETARG_INT32(3);
-  text *messages = PG_GETARG_TEXT_PP(3);
-  char* msgstr = text_to_cstring(messages);
-  int32 msg = 0; /* 'minimal' by default */
   Datum *datums;
   bool *nulls;
   int count;
   int16 elemWidth;
   Oid elemType = ARR_ELEMTYPE(array);
-  bool elemTypeByVal, isNull;
+  bool elemTypeByVal;
   char elemAlignmentCode;
-  HeapTupleHeader td;
-  Form_pg_attribute att;
-
   get_typlenbyvalalign(elemType, &elemWidth, &elemTypeByVal, &elemAlignmentCode);
   deconstruct_array(array, elemType, elemWidth, elemTypeByVal, 
     elemAlignmentCode, &datums, &nulls, &count);
-
-  td = DatumGetHeapTupleHeader(datums[0]);
+  for (int i = 0; i < count; i++)
+  {
+    if (nulls[i])
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("Elements of the array cannot be NULL")));
+  }
 
   /* Extract rowtype info and find a tupdesc */
+  HeapTupleHeader td = DatumGetHeapTupleHeader(datums[0]);
   Oid tupType = HeapTupleHeaderGetTypeId(td);
   int32 tupTypmod = HeapTupleHeaderGetTypMod(td);
   TupleDesc tupdesc = lookup_rowtype_tupdesc(tupType, tupTypmod);
   /* Verify the type of the attributes */
-  att = TupleDescAttr(tupdesc, 0);
-  if (att->atttypid != type_oid(T_GEOMETRY))
-  {
-    PG_FREE_IF_COPY(array, 0);
+  int first = withid ? 1 : 0;
+  if (tupdesc->natts != first + 3)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-      errmsg("First element of the record must be of type geometry")));
-  }
-  att = TupleDescAttr(tupdesc, 1);
-  if (att->atttypid != FLOAT8OID)
-  {
-    PG_FREE_IF_COPY(array, 0);
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-      errmsg("Second element of the record must be of type double precision")));
-  }
-  att = TupleDescAttr(tupdesc, 2);
-  if (att->atttypid != INT4OID)
-  {
-    PG_FREE_IF_COPY(array, 0);
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-      errmsg("Third element of the record must be of type integer")));
-  }
-  ReleaseTupleDesc(tupdesc);
-
-  LWLINE **lines = palloc(sizeof(LWLINE *) * count);
-  double *maxSpeeds = palloc(sizeof(double) * count);
-  int *categories = palloc(sizeof(int) * count);
+      errmsg("The record must have %d elements", first + 3)));
+  if (withid)
+    trip_record_att_valid(tupdesc, 0, INT4OID, "integer");
+  trip_record_att_valid(tupdesc, first, type_oid(T_GEOMETRY), "geometry");
+  trip_record_att_valid(tupdesc, first + 1, FLOAT8OID, "double precision");
+  trip_record_att_valid(tupdesc, first + 2, INT4OID, "integer");
+
+  if (withid)
+    *ids = palloc(sizeof(int32) * count);
+  *lines = palloc(sizeof(LWLINE *) * count);
+  *maxSpeeds = palloc(sizeof(double) * count);
+  *categories = palloc(sizeof(int) * count);
+  Datum values[4];
+  bool isnull[4];
   for (int i = 0; i < count; i++)
   {
-    if (nulls[i])
-    {
-      PG_FREE_IF_COPY(array, 0);
-      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-        errmsg("Elements of the array cannot be NULL")));
-    }
-    else
+    HeapTupleData tuple;
+    td = DatumGetHeapTupleHeader(datums[i]);
+    tuple.t_len = HeapTupleHeaderGetDatumLength(td);
+    ItemPointerSetInvalid(&(tuple.t_self));
+    tuple.t_tableOid = InvalidOid;
+    tuple.t_data = td;
+    heap_deform_tuple(&tuple, tupdesc, values, isnull);
+    for (int j = 0; j < first + 3; j++)
     {
-      td = DatumGetHeapTupleHeader(datums[i]);
-      /* First Attribute: Linestring */
-      GSERIALIZED *gs = (GSERIALIZED *)PG_DETOAST_DATUM(GetAttributeByNum(td, 1, &isNull));
-      if (isNull)
-      {
-        PG_FREE_IF_COPY(array, 0);
-        ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-          errmsg("Elements of the record cannot be NULL")));
-      }
-      if (gserialized_get_type(gs) != LINETYPE)
-      {
-        PG_FREE_IF_COPY(array, 0);
-        ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-          errmsg("Geometry must be a linestring")));
-      }
-      lines[i] = lwgeom_as_lwline(lwgeom_from_gserialized(gs));
-      /* Second Attribute: Maximum Speed */
-      maxSpeeds[i] = DatumGetFloat8(GetAttributeByNum(td, 2, &isNull));
-      if (isNull)
-      {
-        PG_FREE_IF_COPY(array, 0);
-        ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-          errmsg("Elements of the record cannot be NULL")));
-      }
-      /* Third Attribute: Category */
-      categories[i] = DatumGetInt32(GetAttributeByNum(td, 3, &isNull));
-      if (isNull)
-      {
-        PG_FREE_IF_COPY(array, 0);
+      if (isnull[j])
         ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
           errmsg("Elements of the record cannot be NULL")));
-      }
     }
+    if (withid)
+      (*ids)[i] = DatumGetInt32(values[0]);
+    /* Linestring */
+    GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(values[first]);
+    if (gserialized_get_type(gs) != LINETYPE)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("Geometry must be a linestring")));
+    (*lines)[i] = lwgeom_as_lwline(lwgeom_from_gserialized(gs));
+    /* Maximum Speed */
+    (*maxSpeeds)[i] = DatumGetFloat8(values[first + 1]);
+    /* Category */
+    (*categories)[i] = DatumGetInt32(values[first + 2]);
   }
+  ReleaseTupleDesc(tupdesc);
+  pfree(datums);
+  pfree(nulls);
+  return count;
+}
 
-  if (strcmp(msgstr, "minimal") == 0)
-    msg = 0;
-  else if (strcmp(msgstr, "medium") == 0)
-    msg = 1;
+/**
+ * Returns the verbosity of the messages of the trip generator
+ */
+static int32
+trip_verbosity(text *messages)
+{
+  char *msgstr = text_to_cstring(messages);
+  int32 result = 0; /* 'minimal' by default */
+  if (strcmp(msgstr, "medium") == 0)
+    result = 1;
   else if (strcmp(msgstr, "verbose") == 0)
-    msg = 2;
+    result = 2;
   else if (strcmp(msgstr, "debug") == 0)
-    msg = 3;
+    result = 3;
+  pfree(msgstr);
+  return result;
+}
+
+PG_FUNCTION_INFO_V1(create_trip);
+/**
+ * Create a trip using the BerlinMOD data generator
+ */
+Datum
+create_trip(PG_FUNCTION_ARGS)
+{
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+  TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+  bool disturbData = PG_GETARG_BOOL(2);
+  text *messages = PG_GETARG_TEXT_PP(3);
+  LWLINE **lines;
+  double *maxSpeeds;
+  int *categories;
+  int count = trip_edges_extract(array, false, NULL, &lines, &maxSpeeds,
+    &categories);
 
   TSequence *result = create_trip_internal(lines, maxSpeeds, categories,
-    (uint32_t) count, t, disturbData, msg);
+    (uint32_t) count, t, disturbData, trip_verbosity(messages));
 
+  for (int i = 0; i < count; i++)
+    lwgeom_free(lwline_as_lwgeom(lines[i]));
+  pfree(lines); pfree(maxSpeeds); pfree(categories);
   PG_FREE_IF_COPY(array, 0);
   PG_RETURN_POINTER(result);
 }
 
+/**
+ * State of the batch trip generator
+ */
+typedef struct
+{
+  LWLINE **lines;
+  double *maxSpeeds;
+  int *categories;
+  int *firsts;           /**< First edge of each trip, and number of edges */
+  int32 *ids;            /**< Identifier of each trip */
+  TimestampTz *starts;   /**< Start time of each trip */
+  bool disturbData;
+  int32 verbosity;
+} TripBatch;
+
+PG_FUNCTION_INFO_V1(create_trips);
+/**
+ * Create a batch of trips using the BerlinMOD data generator. The
+ * consecutive edges with the same identifier compose a trip, which starts
+ * at the timestamp with the same position in the array of start times as
+ * the trip in the array of edges.
+ */
+Datum
+create_trips(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+
+  if (SRF_IS_FIRSTCALL())
+  {
+    ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+    ArrayType *timearr = PG_GETARG_ARRAYTYPE_P(1);
+    funcctx = SRF_FIRSTCALL_INIT();
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    TupleDesc tupdesc;
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+      ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+        errmsg("function returning record called in context that cannot accept type record")));
+    funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+    TripBatch *batch = palloc(sizeof(TripBatch));
+    int32 *edgeids;
+    int count = trip_edges_extract(array, true, &edgeids, &batch->lines,
+      &batch->maxSpeeds, &batch->categories);
+    batch->firsts = palloc(sizeof(int) * (count + 1));
+    batch->ids = palloc(sizeof(int32) * count);
+    int ntrips = 0;
+    for (int i = 0; i < count; i++)
+    {
+      if (i == 0 || edgeids[i] != edgeids[i - 1])
+      {
+        batch->firsts[ntrips] = i;
+        batch->ids[ntrips++] = edgeids[i];
+      }
+    }
+    batch->firsts[ntrips] = count;
+    pfree(edgeids);
+
+    ensure_non_empty_array(timearr);
+    int nstarts;
+    Datum *starts = datumarr_extract(timearr, &nstarts);
+    if (nstarts != ntrips)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The number of start times must be equal to the number of trips")));
+    batch->starts = palloc(sizeof(TimestampTz) * ntrips);
+    for (int i = 0; i < ntrips; i++)
+      batch->starts[i] = DatumGetTimestampTz(starts[i]);
+    pfree(starts);
+    batch->disturbData = PG_GETARG_BOOL(2);
+    batch->verbosity = trip_verbosity(PG_GETARG_TEXT_PP(3));
+    funcctx->user_fctx = batch;
+    funcctx->max_calls = (uint64) ntrips;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr < funcctx->max_calls)
+  {
+    TripBatch *batch = funcctx->user_fctx;
+    int k = (int) funcctx->call_cntr;
+    int first = batch->firsts[k];
+    int count = batch->firsts[k + 1] - first;
+    if (batch->verbosity >= 1)
+      ereport(INFO, (errcode(ERRCODE_SUCCESSFUL_COMPLETION),
+        errmsg("  Trip %d", batch->ids[k])));
+    TSequence *trip = create_trip_internal(&batch->lines[first],
+      &batch->maxSpeeds[first], &batch->categories[first], (uint32_t) count,
+      batch->starts[k], batch->disturbData, batch->verbosity);
+    for (int i = first; i < first + count; i++)
+      lwgeom_free(lwline_as_lwgeom(batch->lines[i]));
+    Datum values[2];
+    bool isnull[2] = {false, false};
+    values[0] = Int32GetDatum(batch->ids[k]);
+    values[1] = PointerGetDatum(trip);
+    HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+    SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+  }
+  SRF_RETURN_DONE(funcctx);
+}
+
+/*****************************************************************************
+ * Generator of random temporal points
+ *****************************************************************************/
+
+/**
+ * Spatial distributions of the generator of temporal points
+ */
+typedef enum
+{
+  DATAGEN_UNIFORM,     /**< Every position is uniform in the box */
+  DATAGEN_GAUSSIAN,    /**< Every position is normal around the center */
+  DATAGEN_WALK,        /**< Random walk from a uniform position */
+} DatagenDistribution;
+
+/**
+ * Parameters of the generator of temporal points
+ */
+typedef struct
+{
+  STBOX box;
+  bool hasz;
+  bool linear;
+  DatagenDistribution distribution;
+  GSERIALIZED *point;   /**< Point whose coordinates are set for each instant */
+} DatagenPoint;
+
+/**
+ * Returns the coordinate brought back into the range by reflection
+ */
+static double
+datagen_reflect(double value, double min, double max)
+{
+  if (value < min)
+    value = 2 * min - value;
+  else if (value > max)
+    value = 2 * max - value;
+  /* The reflection may overflow the range for very large steps */
+  return Max(min, Min(max, value));
+}
+
+/**
+ * Returns the next coordinate of the generator in the range
+ */
+static double
+datagen_coord(DatagenState *state, DatagenDistribution distribution,
+  bool first, double prev, double min, double max)
+{
+  double extent = max - min;
+  if (distribution == DATAGEN_GAUSSIAN)
+  {
+    /* 99.7% of the positions are in the range before clamping */
+    double value = (min + max) / 2 + datagen_gaussian(&state->rng) * extent / 6;
+    return Max(min, Min(max, value));
+  }
+  if (distribution == DATAGEN_UNIFORM || first)
+    return min + datagen_random(&state->rng) * extent;
+  /* The steps of the random walk are at most 1% of the extent */
+  double value = prev + (datagen_random(&state->rng) * 2.0 - 1.0) *
+    extent / 100;
+  return datagen_reflect(value, min, max);
+}
+
+/**
+ * Returns the next temporal point of the generator. The instants are
+ * constructed from a serialized point whose coordinates are overwritten,
+ * instead of constructing and serializing a new point for every instant.
+ */
+static Temporal *
+datagen_tgeompoint(DatagenState *state)
+{
+  DatagenPoint *params = (DatagenPoint *) state->extra;
+  const STBOX *box = &params->box;
+  POINT3DZ *point = (POINT3DZ *) gs_get_point3dz_p(params->point);
+  Datum value = PointerGetDatum(params->point);
+  double x = 0.0, y = 0.0, z = 0.0;
+  TimestampTz t = datagen_start(state);
+  for (int i = 0; i < state->length; i++)
+  {
+    x = datagen_coord(state, params->distribution, i == 0, x, box->xmin,
+      box->xmax);
+    y = datagen_coord(state, params->distribution, i == 0, y, box->ymin,
+      box->ymax);
+    point->x = x;
+    point->y = y;
+    if (params->hasz)
+    {
+      z = datagen_coord(state, params->distribution, i == 0, z, box->zmin,
+        box->zmax);
+      point->z = z;
+    }
+    state->instants[i] = tinstant_make(value, t, type_oid(T_GEOMETRY));
+    t += state->step;
+  }
+  return datagen_result(state, params->linear);
+}
+
+PG_FUNCTION_INFO_V1(generate_tgeompoints);
+/**
+ * Generates random temporal geometric points in the spatial extent of the
+ * box, with the SRID and the Z dimension of the box
+ */
+Datum
+generate_tgeompoints(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+
+  if (SRF_IS_FIRSTCALL())
+  {
+    int32 count = PG_GETARG_INT32(0);
+    int32 length = PG_GETARG_INT32(1);
+    STBOX *box = PG_GETARG_STBOX_P(2);
+    if (! MOBDB_FLAGS_GET_X(box->flags))
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The box must have XY dimension")));
+    if (MOBDB_FLAGS_GET_GEODETIC(box->flags))
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The box cannot be geodetic")));
+    Period *p = PG_GETARG_PERIOD(3);
+    Interval *interval = PG_GETARG_INTERVAL_P(4);
+    text *disttxt = PG_GETARG_TEXT_PP(5);
+    char *diststr = text_to_cstring(disttxt);
+    DatagenDistribution distribution;
+    if (strcmp(diststr, "uniform") == 0)
+      distribution = DATAGEN_UNIFORM;
+    else if (strcmp(diststr, "gaussian") == 0)
+      distribution = DATAGEN_GAUSSIAN;
+    else if (strcmp(diststr, "walk") == 0)
+      distribution = DATAGEN_WALK;
+    else
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("Unknown distribution: %s", diststr)));
+    pfree(diststr);
+    bool linear = PG_GETARG_BOOL(6);
+    int32 seed = PG_GETARG_INT32(7);
+
+    funcctx = SRF_FIRSTCALL_INIT();
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    DatagenState *state = datagen_init(count, length, p, interval, seed);
+    DatagenPoint *params = palloc(sizeof(DatagenPoint));
+    params->box = *box;
+    params->hasz = MOBDB_FLAGS_GET_Z(box->flags);
+    params->linear = linear;
+    params->distribution = distribution;
+    LWPOINT *lwpoint = params->hasz ?
+      lwpoint_make3dz(box->srid, 0.0, 0.0, 0.0) :
+      lwpoint_make2d(box->srid, 0.0, 0.0);
+    params->point = geo_serialize((LWGEOM *) lwpoint);
+    lwpoint_free(lwpoint);
+    state->extra = params;
+    funcctx->user_fctx = state;
+    funcctx->max_calls = (uint64) count;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr < funcctx->max_calls)
+  {
+    Temporal *result = datagen_tgeompoint(funcctx->user_fctx);
+    SRF_RETURN_NEXT(funcctx, PointerGetDatum(result));
+  }
+  SRF_RETURN_DONE(funcctx);
+}
+
 /*****************************************************************************/
@@ -28,6 +28,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_argcache.h"
 #include "lifting.h"
 #include "tnumber_mathfuncs.h"
 #include "postgis.h"
@@ -90,10 +91,16 @@ lw_dist3d_point_dist(const LWGEOM *lw1, const LWGEOM *lw2, int mode,
 /**
  * Compute the projected point and the distance between the closest point
  * (geodetic version).
+ *
+ * @param[in] lw1 Segment
+ * @param[in] circ_tree2 Circular tree of the geography, which is computed
+ * once by the calling function for all the segments
+ * @param[in] mode Distance mode
+ * @param[out] fraction Location of the closest point in the segment
  */
 double
-lw_dist_sphere_point_dist(const LWGEOM *lw1, const LWGEOM *lw2, int mode,
-  double *fraction)
+lw_dist_sphere_point_dist(const LWGEOM *lw1, const CIRC_NODE *circ_tree2,
+  int mode, double *fraction)
 {
   double min_dist = FLT_MAX;
   double max_dist = FLT_MAX;
@@ -102,9 +109,9 @@ lw_dist_sphere_point_dist(const LWGEOM *lw1, const LWGEOM *lw2, int mode,
   POINT4D a, b;
 
   CIRC_NODE *circ_tree1 = lwgeom_calculate_circ_tree(lw1);
-  CIRC_NODE *circ_tree2 = lwgeom_calculate_circ_tree(lw2);
   circ_tree_distance_tree_internal(circ_tree1, circ_tree2, FP_TOLERANCE,
     &min_dist, &max_dist, &closest1, &closest2);
+  circ_tree_free(circ_tree1);
   double result = sphere_distance(&closest1, &closest2);
 
   /* Initialize edge */
@@ -129,6 +136,126 @@ lw_dist_sphere_point_dist(const LWGEOM *lw1, const LWGEOM *lw2, int mode,
  * Temporal distance
  *****************************************************************************/
 
+/**
+ * Reads the coordinates of the geometric point, the z coordinate is set
+ * to 0 for 2D points
+ */
+static void
+datum_get_point3dz(Datum geom, bool hasz, POINT3DZ *p)
+{
+  if (hasz)
+    *p = *datum_get_point3dz_p(geom);
+  else
+  {
+    const POINT2D *p2d = datum_get_point2d_p(geom);
+    p->x = p2d->x;
+    p->y = p2d->y;
+    p->z = 0.0;
+  }
+  return;
+}
+
+/**
+ * Returns the distance between the two geometric points
+ */
+static double
+geompoint_distance(const POINT3DZ *p1, const POINT3DZ *p2, bool hasz)
+{
+  if (hasz)
+    return distance3d_pt_pt((POINT3D *) p1, (POINT3D *) p2);
+  POINT2D q1, q2;
+  q1.x = p1->x; q1.y = p1->y;
+  q2.x = p2->x; q2.y = p2->y;
+  return distance2d_pt_pt(&q1, &q2);
+}
+
+/**
+ * Returns the fraction of the segment at which the point is the closest
+ *
+ * @param[in] p1,p2 Points defining the segment
+ * @param[in] p Point
+ * @param[in] hasz True for 3D points
+ * @param[out] proj Closest point of the segment
+ * @note Same computation as geoseg_locate_point for geometric points
+ */
+static double
+geompointseg_locate_point(const POINT3DZ *p1, const POINT3DZ *p2,
+  const POINT3DZ *p, bool hasz, POINT3DZ *proj)
+{
+  double result;
+  if (hasz)
+  {
+    result = closest_point3dz_on_segment_ratio(p, p1, p2, proj);
+    /* For robustness, force 0/1 when closest point == start/endpoint */
+    if (p3d_same((POINT3D *) p1, (POINT3D *) proj))
+      result = 0.0;
+    else if (p3d_same((POINT3D *) p2, (POINT3D *) proj))
+      result = 1.0;
+  }
+  else
+  {
+    POINT2D q1, q2, q, closest;
+    q1.x = p1->x; q1.y = p1->y;
+    q2.x = p2->x; q2.y = p2->y;
+    q.x = p->x; q.y = p->y;
+    result = closest_point2d_on_segment_ratio(&q, &q1, &q2, &closest);
+    if (p2d_same(&q1, &closest))
+      result = 0.0;
+    else if (p2d_same(&q2, &closest))
+      result = 1.0;
+    proj->x = closest.x; proj->y = closest.y; proj->z = 0.0;
+  }
+  return result;
+}
+
+/**
+ * Returns the temporal distance between the temporal sequence point and
+ * the geometry point
+ *
+ * @note The distances are computed from the coordinates of the points
+ * instead of calling the distance function for each instant
+ */
+static TSequence *
+distance_tgeompointseq_geo(const TSequence *seq, Datum point)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  POINT3DZ p, p1, p2, proj;
+  datum_get_point3dz(point, hasz, &p);
+  TInstant *inst1 = tsequence_inst_n(seq, 0);
+  datum_get_point3dz(tinstant_value(inst1), hasz, &p1);
+  TSequenceBuilder builder;
+  tsequence_builder_init(&builder, FLOAT8OID, seq->count * 2, linear,
+    NORMALIZE);
+  for (int i = 1; i < seq->count; i++)
+  {
+    /* Each iteration of the loop adds one or two points */
+    TInstant *inst2 = tsequence_inst_n(seq, i);
+    datum_get_point3dz(tinstant_value(inst2), hasz, &p2);
+    tsequence_builder_append(&builder,
+      Float8GetDatum(geompoint_distance(&p, &p1, hasz)), inst1->t);
+    /* Linear segment that is not constant */
+    if (linear && (p1.x != p2.x || p1.y != p2.y || p1.z != p2.z))
+    {
+      long double fraction = (long double)
+        geompointseg_locate_point(&p1, &p2, &p, hasz, &proj);
+      if (fraction != 0.0 && fraction != 1.0)
+      {
+        long double duration = (long double) (inst2->t - inst1->t);
+        TimestampTz time = inst1->t + (long) (duration * fraction);
+        tsequence_builder_append(&builder,
+          Float8GetDatum(geompoint_distance(&p, &proj, hasz)), time);
+      }
+    }
+    inst1 = inst2; p1 = p2;
+  }
+  tsequence_builder_append(&builder,
+    Float8GetDatum(geompoint_distance(&p, &p1, hasz)), inst1->t);
+
+  return tsequence_builder_finish(&builder, seq->period.lower_inc,
+    seq->period.upper_inc);
+}
+
 /**
  * Returns the temporal distance between the temporal sequence point and
  * the geometry/geography point
@@ -136,16 +263,21 @@ lw_dist_sphere_point_dist(const LWGEOM *lw1, const LWGEOM *lw2, int mode,
  * @param[in] seq Temporal point
  * @param[in] point Point
  * @param[in] func Distance function
+ * @param[in] flinfo FmgrInfo passed as a pointer datum to the distance
+ * function
  */
 static TSequence *
 distance_tpointseq_geo(const TSequence *seq, Datum point,
-  Datum (*func)(Datum, Datum))
+  Datum (*func)(Datum, Datum, Datum), Datum flinfo)
 {
-  int k = 0;
-  TInstant **instants = palloc(sizeof(TInstant *) * seq->count * 2);
+  if (! MOBDB_FLAGS_GET_GEODETIC(seq->flags))
+    return distance_tgeompointseq_geo(seq, point);
   TInstant *inst1 = tsequence_inst_n(seq, 0);
   Datum value1 = tinstant_value(inst1);
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  TSequenceBuilder builder;
+  tsequence_builder_init(&builder, FLOAT8OID, seq->count * 2, linear,
+    NORMALIZE);
   for (int i = 1; i < seq->count; i++)
   {
     /* Each iteration of the loop adds between one and three points */
@@ -155,8 +287,8 @@ distance_tpointseq_geo(const TSequence *seq, Datum point,
     /* Constant segment or step interpolation */
     if (datum_point_eq(value1, value2) || ! linear)
     {
-      instants[k++] = tinstant_make(func(point, value1),
-        inst1->t, FLOAT8OID);
+      tsequence_builder_append(&builder, func(point, value1, flinfo),
+        inst1->t);
     }
     else
     {
@@ -167,24 +299,23 @@ distance_tpointseq_geo(const TSequence *seq, Datum point,
 
       if (fraction == 0.0 || fraction == 1.0)
       {
-        instants[k++] = tinstant_make(func(point, value1),
-          inst1->t, FLOAT8OID);
+        tsequence_builder_append(&builder, func(point, value1, flinfo),
+          inst1->t);
       }
       else
       {
         TimestampTz time = inst1->t + (long) (duration * fraction);
-        instants[k++] = tinstant_make(func(point, value1),
-          inst1->t, FLOAT8OID);
-        instants[k++] = tinstant_make(Float8GetDatum(dist),
-          time, FLOAT8OID);
+        tsequence_builder_append(&builder, func(point, value1, flinfo),
+          inst1->t);
+        tsequence_builder_append(&builder, Float8GetDatum(dist), time);
       }
     }
     inst1 = inst2; value1 = value2;
   }
-  instants[k++] = tinstant_make(func(point, value1), inst1->t, FLOAT8OID);
+  tsequence_builder_append(&builder, func(point, value1, flinfo), inst1->t);
 
-  return tsequence_make_free(instants, k, seq->period.lower_inc,
-    seq->period.upper_inc, linear, NORMALIZE);
+  return tsequence_builder_finish(&builder, seq->period.lower_inc,
+    seq->period.upper_inc);
 }
 
 /**
@@ -194,66 +325,57 @@ distance_tpointseq_geo(const TSequence *seq, Datum point,
  * @param[in] ts Temporal point
  * @param[in] point Point
  * @param[in] func Distance function
+ * @param[in] flinfo FmgrInfo passed as a pointer datum to the distance
+ * function
  */
 static TSequenceSet *
 distance_tpointseqset_geo(const TSequenceSet *ts, Datum point,
-  Datum (*func)(Datum, Datum))
+  Datum (*func)(Datum, Datum, Datum), Datum flinfo)
 {
   TSequence **sequences = palloc(sizeof(TSequence *) * ts->count);
   for (int i = 0; i < ts->count; i++)
   {
     TSequence *seq = tsequenceset_seq_n(ts, i);
-    sequences[i] = distance_tpointseq_geo(seq, point, func);
+    sequences[i] = distance_tpointseq_geo(seq, point, func, flinfo);
   }
   return tsequenceset_make_free(sequences, ts->count, NORMALIZE);
 }
 
 /**
- * Returns the single timestamp at which the two temporal geometric point
- * segments are at the minimum distance. These are the turning points
- * when computing the temporal distance.
+ * Returns the fraction of the time interval of two synchronized geometric
+ * point segments at which they are at the minimum distance
  *
- * @param[in] start1,end1 Instants defining the first segment
- * @param[in] start2,end2 Instants defining the second segment
- * @param[out] t Timestamp
- * @note The PostGIS functions `lw_dist2d_seg_seg` and `lw_dist3d_seg_seg`
- * cannot be used since they do not take time into consideration and would
- * return, e.g., that the minimum distance between the two following segments
- * `[Point(2 2)@t1, Point(1 1)@t2]` and `[Point(3 1)@t1, Point(1 1)@t2]`
- * is at `Point(2 2)@t2` instead of `Point(1.5 1.5)@(t1 + (t2 - t1)/2)`.
- * @pre The segments are not both constants.
- * @note
+ * @param[in] p1,p2 Points defining the first segment
+ * @param[in] p3,p4 Points defining the second segment
+ * @param[in] hasz True for 3D segments, otherwise the z coordinates are
+ * not used
+ * @param[out] fraction Fraction
+ * @result Returns false if the segments are parallel
  */
-bool
-tgeompointseq_min_dist_at_timestamp(const TInstant *start1,
-  const TInstant *end1, const TInstant *start2,
-  const TInstant *end2, TimestampTz *t)
+static bool
+geompointseg_min_dist_fraction(const POINT3DZ *p1, const POINT3DZ *p2,
+  const POINT3DZ *p3, const POINT3DZ *p4, bool hasz, long double *fraction)
 {
-  long double denum, fraction;
+  long double denum;
   long double dx1, dy1, dx2, dy2, f1, f2, f3, f4;
-  long double duration = (long double) (end1->t - start1->t);
-
-  if (MOBDB_FLAGS_GET_Z(start1->flags)) /* 3D */
+  /* The following basically computes d/dx (Euclidean distance) = 0.
+     To reduce problems related to floating point arithmetic, t1 and t2
+     are shifted, respectively, to 0 and 1 before computing d/dx */
+  dx1 = p2->x - p1->x;
+  dy1 = p2->y - p1->y;
+  dx2 = p4->x - p3->x;
+  dy2 = p4->y - p3->y;
+
+  f1 = p3->x * (dx1 - dx2);
+  f2 = p1->x * (dx2 - dx1);
+  f3 = p3->y * (dy1 - dy2);
+  f4 = p1->y * (dy2 - dy1);
+
+  if (hasz) /* 3D */
   {
     long double dz1, dz2, f5, f6;
-    const POINT3DZ *p1 = datum_get_point3dz_p(tinstant_value(start1));
-    const POINT3DZ *p2 = datum_get_point3dz_p(tinstant_value(end1));
-    const POINT3DZ *p3 = datum_get_point3dz_p(tinstant_value(start2));
-    const POINT3DZ *p4 = datum_get_point3dz_p(tinstant_value(end2));
-    /* The following basically computes d/dx (Euclidean distance) = 0->
-       To reduce problems related to floating point arithmetic, t1 and t2
-       are shifted, respectively, to 0 and 1 before computing d/dx */
-    dx1 = p2->x - p1->x;
-    dy1 = p2->y - p1->y;
     dz1 = p2->z - p1->z;
-    dx2 = p4->x - p3->x;
-    dy2 = p4->y - p3->y;
     dz2 = p4->z - p3->z;
-
-    f1 = p3->x * (dx1 - dx2);
-    f2 = p1->x * (dx2 - dx1);
-    f3 = p3->y * (dy1 - dy2);
-    f4 = p1->y * (dy2 - dy1);
     f5 = p3->z * (dz1 - dz2);
     f6 = p1->z * (dz2 - dz1);
 
@@ -262,36 +384,53 @@ tgeompointseq_min_dist_at_timestamp(const TInstant *start1,
     if (denum == 0)
       return false;
 
-    fraction = (f1 + f2 + f3 + f4 + f5 + f6) / denum;
+    *fraction = (f1 + f2 + f3 + f4 + f5 + f6) / denum;
   }
   else /* 2D */
   {
-    const POINT2D *p1 = datum_get_point2d_p(tinstant_value(start1));
-    const POINT2D *p2 = datum_get_point2d_p(tinstant_value(end1));
-    const POINT2D *p3 = datum_get_point2d_p(tinstant_value(start2));
-    const POINT2D *p4 = datum_get_point2d_p(tinstant_value(end2));
-    /* The following basically computes d/dx (Euclidean distance) = 0.
-       To reduce problems related to floating point arithmetic, t1 and t2
-       are shifted, respectively, to 0 and 1 before computing d/dx */
-    dx1 = p2->x - p1->x;
-    dy1 = p2->y - p1->y;
-    dx2 = p4->x - p3->x;
-    dy2 = p4->y - p3->y;
-
-    f1 = p3->x * (dx1 - dx2);
-    f2 = p1->x * (dx2 - dx1);
-    f3 = p3->y * (dy1 - dy2);
-    f4 = p1->y * (dy2 - dy1);
-
     denum = dx1*(dx1-2*dx2) + dy1*(dy1-2*dy2) + dy2*dy2 + dx2*dx2;
     /* If the segments are parallel */
     if (denum == 0)
       return false;
 
-    fraction = (f1 + f2 + f3 + f4) / denum;
+    *fraction = (f1 + f2 + f3 + f4) / denum;
   }
+  return true;
+}
+
+/**
+ * Returns the single timestamp at which the two temporal geometric point
+ * segments are at the minimum distance. These are the turning points
+ * when computing the temporal distance.
+ *
+ * @param[in] start1,end1 Instants defining the first segment
+ * @param[in] start2,end2 Instants defining the second segment
+ * @param[out] t Timestamp
+ * @note The PostGIS functions `lw_dist2d_seg_seg` and `lw_dist3d_seg_seg`
+ * cannot be used since they do not take time into consideration and would
+ * return, e.g., that the minimum distance between the two following segments
+ * `[Point(2 2)@t1, Point(1 1)@t2]` and `[Point(3 1)@t1, Point(1 1)@t2]`
+ * is at `Point(2 2)@t2` instead of `Point(1.5 1.5)@(t1 + (t2 - t1)/2)`.
+ * @pre The segments are not both constants.
+ * @note
+ */
+bool
+tgeompointseq_min_dist_at_timestamp(const TInstant *start1,
+  const TInstant *end1, const TInstant *start2,
+  const TInstant *end2, TimestampTz *t)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(start1->flags);
+  POINT3DZ p1, p2, p3, p4;
+  datum_get_point3dz(tinstant_value(start1), hasz, &p1);
+  datum_get_point3dz(tinstant_value(end1), hasz, &p2);
+  datum_get_point3dz(tinstant_value(start2), hasz, &p3);
+  datum_get_point3dz(tinstant_value(end2), hasz, &p4);
+  long double fraction;
+  if (! geompointseg_min_dist_fraction(&p1, &p2, &p3, &p4, hasz, &fraction))
+    return false;
   if (fraction <= EPSILON || fraction >= (1.0 - EPSILON))
     return false;
+  long double duration = (long double) (end1->t - start1->t);
   *t = start1->t + (long) (duration * fraction);
   return true;
 }
@@ -397,16 +536,257 @@ tpointseq_min_dist_at_timestamp(const TInstant *start1, const TInstant *end1,
     return tgeompointseq_min_dist_at_timestamp(start1, end1, start2, end2, t);
 }
 
+/**
+ * Sets the point of the segment of a temporal geometric point at the
+ * timestamp with the same computation as tsequence_value_at_timestamp1
+ *
+ * @param[in] p1,p2 Points defining the segment
+ * @param[in] t1,t2 Timestamps associated to the points
+ * @param[in] t Timestamp
+ * @param[out] p Point
+ */
+static void
+geompointseg_point_at(const POINT3DZ *p1, const POINT3DZ *p2,
+  TimestampTz t1, TimestampTz t2, TimestampTz t, POINT3DZ *p)
+{
+  if ((p1->x == p2->x && p1->y == p2->y && p1->z == p2->z) || t1 == t)
+    *p = *p1;
+  else if (t2 == t)
+    *p = *p2;
+  else
+  {
+    double ratio = (double) (t - t1) / (double) (t2 - t1);
+    p->x = p1->x + (p2->x - p1->x) * ratio;
+    p->y = p1->y + (p2->y - p1->y) * ratio;
+    p->z = p1->z + (p2->z - p1->z) * ratio;
+  }
+  return;
+}
+
+/**
+ * Sets the point of the temporal geometric point with linear interpolation
+ * at the timestamp
+ *
+ * @param[in] seq Temporal point
+ * @param[in] n Segment of the sequence containing the timestamp
+ * @param[in] t Timestamp
+ * @param[in] hasz True for 3D points
+ * @param[out] p Point
+ */
+static void
+tgeompointseq_point_at(const TSequence *seq, int n, TimestampTz t, bool hasz,
+  POINT3DZ *p)
+{
+  TInstant *inst1 = tsequence_inst_n(seq, n);
+  datum_get_point3dz(tinstant_value(inst1), hasz, p);
+  if (inst1->t == t || n == seq->count - 1)
+    return;
+  TInstant *inst2 = tsequence_inst_n(seq, n + 1);
+  POINT3DZ p1 = *p, p2;
+  datum_get_point3dz(tinstant_value(inst2), hasz, &p2);
+  geompointseg_point_at(&p1, &p2, inst1->t, inst2->t, t, p);
+  return;
+}
+
+/**
+ * Returns the minimum between the bound and the nearest approach distance
+ * of the two temporal geometric points with linear interpolation
+ *
+ * The sequences are traversed in the same way as when synchronizing them
+ * for computing the temporal distance. If the builder is not NULL, the
+ * distances at the synchronized instants and at the turning points between
+ * them are appended to it, which yields the temporal distance. Otherwise
+ * they are only compared with the bound and the traversal stops as soon as
+ * the distance is zero.
+ *
+ * @param[in] seq1,seq2 Temporal points
+ * @param[in] builder Builder of the temporal distance, may be NULL
+ * @param[in] bound Best distance found so far
+ * @pre The periods of the sequences overlap
+ */
+static double
+distance_tgeompointseq_tgeompointseq1(const TSequence *seq1,
+  const TSequence *seq2, TSequenceBuilder *builder, double bound)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(seq1->flags);
+  double result = bound;
+  TimestampTz lower = Max(seq1->period.lower, seq2->period.lower);
+  TimestampTz upper = Min(seq1->period.upper, seq2->period.upper);
+  POINT3DZ p1, p2, prev1, prev2, inter1, inter2;
+  /* If the two sequences intersect at an instant */
+  if (lower == upper)
+  {
+    int n1 = (seq1->count == 1) ? 0 : tsequence_find_timestamp(seq1, lower);
+    int n2 = (seq2->count == 1) ? 0 : tsequence_find_timestamp(seq2, lower);
+    tgeompointseq_point_at(seq1, n1, lower, hasz, &p1);
+    tgeompointseq_point_at(seq2, n2, lower, hasz, &p2);
+    double d = geompoint_distance(&p1, &p2, hasz);
+    if (builder != NULL)
+      tsequence_builder_append(builder, Float8GetDatum(d), lower);
+    return Min(result, d);
+  }
+
+  /* General case */
+  int i = 0, j = 0, k = 0;
+  TimestampTz t1 = tsequence_inst_n(seq1, 0)->t;
+  TimestampTz t2 = tsequence_inst_n(seq2, 0)->t;
+  TimestampTz t, prevt = 0, intertime;
+  /* Synchronize the start instant, in this case i or j is the segment
+   * containing the lower bound */
+  if (t1 < lower)
+  {
+    i = tsequence_find_timestamp(seq1, lower);
+    t1 = lower;
+  }
+  else if (t2 < lower)
+  {
+    j = tsequence_find_timestamp(seq2, lower);
+    t2 = lower;
+  }
+  while (i < seq1->count && j < seq2->count &&
+    (t1 <= upper || t2 <= upper))
+  {
+    /* Synchronize the instants, when a sequence has no instant at t the
+     * point is interpolated in the segment ending at its next instant */
+    int cmp = timestamp_cmp_internal(t1, t2);
+    if (cmp == 0)
+    {
+      t = t1;
+      tgeompointseq_point_at(seq1, Min(i, seq1->count - 2), t, hasz, &p1);
+      tgeompointseq_point_at(seq2, Min(j, seq2->count - 2), t, hasz, &p2);
+      i++; j++;
+    }
+    else if (cmp < 0)
+    {
+      t = t1;
+      tgeompointseq_point_at(seq1, Min(i, seq1->count - 2), t, hasz, &p1);
+      tgeompointseq_point_at(seq2, j - 1, t, hasz, &p2);
+      i++;
+    }
+    else
+    {
+      t = t2;
+      tgeompointseq_point_at(seq1, i - 1, t, hasz, &p1);
+      tgeompointseq_point_at(seq2, Min(j, seq2->count - 2), t, hasz, &p2);
+      j++;
+    }
+    /* If not the first instant consider the potential turning point
+     * between the previous and the current instants */
+    long double fraction;
+    if (k > 0 &&
+      geompointseg_min_dist_fraction(&prev1, &p1, &prev2, &p2, hasz,
+        &fraction) &&
+      fraction > EPSILON && fraction < (1.0 - EPSILON))
+    {
+      long double duration = (long double) (t - prevt);
+      intertime = prevt + (long) (duration * fraction);
+      geompointseg_point_at(&prev1, &p1, prevt, t, intertime, &inter1);
+      geompointseg_point_at(&prev2, &p2, prevt, t, intertime, &inter2);
+      double d = geompoint_distance(&inter1, &inter2, hasz);
+      if (builder != NULL)
+        tsequence_builder_append(builder, Float8GetDatum(d), intertime);
+      result = Min(result, d);
+    }
+    double d = geompoint_distance(&p1, &p2, hasz);
+    if (builder != NULL)
+      tsequence_builder_append(builder, Float8GetDatum(d), t);
+    result = Min(result, d);
+    k++;
+    if (i == seq1->count || j == seq2->count ||
+      (builder == NULL && result == 0.0))
+      break;
+    prev1 = p1; prev2 = p2; prevt = t;
+    t1 = tsequence_inst_n(seq1, i)->t;
+    t2 = tsequence_inst_n(seq2, j)->t;
+  }
+  return result;
+}
+
+/**
+ * Returns the temporal distance between the two temporal geometric point
+ * sequences with linear interpolation
+ *
+ * @result Returns NULL if the sequences do not intersect in time
+ */
+static TSequence *
+distance_tgeompointseq_tgeompointseq(const TSequence *seq1,
+  const TSequence *seq2)
+{
+  Period *inter = intersection_period_period_internal(&seq1->period,
+    &seq2->period);
+  if (inter == NULL)
+    return NULL;
+  TSequenceBuilder builder;
+  tsequence_builder_init(&builder, FLOAT8OID,
+    (seq1->count + seq2->count) * 2, LINEAR, NORMALIZE);
+  distance_tgeompointseq_tgeompointseq1(seq1, seq2, &builder, DBL_MAX);
+  TSequence *result = tsequence_builder_finish(&builder, inter->lower_inc,
+    inter->upper_inc);
+  pfree(inter);
+  return result;
+}
+
+/**
+ * Returns the temporal distance between the two temporal geometric points
+ * with linear interpolation
+ *
+ * The composing sequences are paired as in sync_tfunc_temporal_temporal
+ * but the distances are computed from the coordinates of the points and
+ * written directly into the result.
+ *
+ * @param[in] temp1,temp2 Temporal sequence or sequence set points
+ */
+static Temporal *
+distance_tgeompoint_tgeompoint(const Temporal *temp1, const Temporal *temp2)
+{
+  if (temp1->duration == SEQUENCE && temp2->duration == SEQUENCE)
+    return (Temporal *) distance_tgeompointseq_tgeompointseq(
+      (TSequence *) temp1, (TSequence *) temp2);
+
+  int count1 = (temp1->duration == SEQUENCE) ? 1 :
+    ((TSequenceSet *) temp1)->count;
+  int count2 = (temp2->duration == SEQUENCE) ? 1 :
+    ((TSequenceSet *) temp2)->count;
+  TSequence **sequences = palloc(sizeof(TSequence *) * (count1 + count2));
+  int i = 0, j = 0, k = 0;
+  while (i < count1 && j < count2)
+  {
+    const TSequence *seq1 = (temp1->duration == SEQUENCE) ?
+      (TSequence *) temp1 : tsequenceset_seq_n((TSequenceSet *) temp1, i);
+    const TSequence *seq2 = (temp2->duration == SEQUENCE) ?
+      (TSequence *) temp2 : tsequenceset_seq_n((TSequenceSet *) temp2, j);
+    TSequence *seq = distance_tgeompointseq_tgeompointseq(seq1, seq2);
+    if (seq != NULL)
+      sequences[k++] = seq;
+    /* Advance the sequence that ends first, or both if they end together */
+    int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+    if (cmp == 0 && seq1->period.upper_inc != seq2->period.upper_inc)
+      cmp = seq1->period.upper_inc ? 1 : -1;
+    if (cmp <= 0)
+      i++;
+    if (cmp >= 0)
+      j++;
+  }
+  return (Temporal *) tsequenceset_make_free(sequences, k, NORMALIZE);
+}
+
 /*****************************************************************************/
 
 /**
  * Returns the temporal distance between the temporal point and the
  * geometry/geography point (distpatch function)
+ *
+ * @param[in] temp Temporal point
+ * @param[in] geo Point
+ * @param[in] flinfo FmgrInfo passed to the PostGIS distance function for
+ * geographies, which keeps in it the tree of the point, or NULL to call the
+ * function without cache
  */
 Temporal *
-distance_tpoint_geo_internal(const Temporal *temp, Datum geo)
+distance_tpoint_geo_internal(const Temporal *temp, Datum geo,
+  FmgrInfo *flinfo)
 {
-  Datum (*func)(Datum, Datum);
+  Datum (*func)(Datum, Datum, Datum);
   if (MOBDB_FLAGS_GET_GEODETIC(temp->flags))
     func = &geog_distance;
   else
@@ -417,7 +797,7 @@ distance_tpoint_geo_internal(const Temporal *temp, Datum geo)
   if (temp->duration == INSTANT || temp->duration == INSTANTSET)
   {
     lfinfo.func = (varfunc) func;
-    lfinfo.numparam = 2;
+    lfinfo.numparam = 3;
     lfinfo.restypid = FLOAT8OID;
     lfinfo.reslinear = MOBDB_FLAGS_GET_LINEAR(temp->flags);
     lfinfo.invert = INVERT_NO;
@@ -427,14 +807,16 @@ distance_tpoint_geo_internal(const Temporal *temp, Datum geo)
   Temporal *result;
   if (temp->duration == INSTANT)
     result = (Temporal *)tfunc_tinstant_base((TInstant *)temp, geo,
-      temp->valuetypid, (Datum) NULL, lfinfo);
+      temp->valuetypid, PointerGetDatum(flinfo), lfinfo);
   else if (temp->duration == INSTANTSET)
     result = (Temporal *)tfunc_tinstantset_base((TInstantSet *)temp, geo,
-      temp->valuetypid, (Datum) NULL, lfinfo);
+      temp->valuetypid, PointerGetDatum(flinfo), lfinfo);
   else if (temp->duration == SEQUENCE)
-    result = (Temporal *)distance_tpointseq_geo((TSequence *)temp, geo, func);
+    result = (Temporal *)distance_tpointseq_geo((TSequence *)temp, geo, func,
+      PointerGetDatum(flinfo));
   else /* temp->duration == SEQUENCESET */
-    result = (Temporal *)distance_tpointseqset_geo((TSequenceSet *)temp, geo, func);
+    result = (Temporal *)distance_tpointseqset_geo((TSequenceSet *)temp, geo,
+      func, PointerGetDatum(flinfo));
   return result;
 }
 
@@ -453,9 +835,8 @@ distance_geo_tpoint(PG_FUNCTION_ARGS)
   ensure_point_type(gs);
   ensure_same_srid_tpoint_gs(temp, gs);
   ensure_same_dimensionality_tpoint_gs(temp, gs);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
-  Temporal *result = distance_tpoint_geo_internal(temp, PointerGetDatum(gs));
+  Temporal *result = distance_tpoint_geo_internal(temp, PointerGetDatum(gs),
+    fcinfo->flinfo);
   PG_FREE_IF_COPY(gs, 0);
   PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_POINTER(result);
@@ -476,9 +857,8 @@ distance_tpoint_geo(PG_FUNCTION_ARGS)
   ensure_point_type(gs);
   ensure_same_srid_tpoint_gs(temp, gs);
   ensure_same_dimensionality_tpoint_gs(temp, gs);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
-  Temporal *result = distance_tpoint_geo_internal(temp, PointerGetDatum(gs));
+  Temporal *result = distance_tpoint_geo_internal(temp, PointerGetDatum(gs),
+    fcinfo->flinfo);
   PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(gs, 1);
   PG_RETURN_POINTER(result);
@@ -491,21 +871,30 @@ distance_tpoint_geo(PG_FUNCTION_ARGS)
 Temporal *
 distance_tpoint_tpoint_internal(const Temporal *temp1, const Temporal *temp2)
 {
+  if (! MOBDB_FLAGS_GET_GEODETIC(temp1->flags) &&
+    (temp1->duration == SEQUENCE || temp1->duration == SEQUENCESET) &&
+    (temp2->duration == SEQUENCE || temp2->duration == SEQUENCESET) &&
+    MOBDB_FLAGS_GET_LINEAR(temp1->flags) &&
+    MOBDB_FLAGS_GET_LINEAR(temp2->flags))
+    return distance_tgeompoint_tgeompoint(temp1, temp2);
+
   LiftedFunctionInfo lfinfo;
   if (MOBDB_FLAGS_GET_GEODETIC(temp1->flags))
     lfinfo.func = (varfunc) &geog_distance;
   else
     lfinfo.func = MOBDB_FLAGS_GET_Z(temp1->flags) ?
       (varfunc) &pt_distance3d : (varfunc) &pt_distance2d;
-  lfinfo.numparam = 2;
+  lfinfo.numparam = 3;
   lfinfo.restypid = FLOAT8OID;
   lfinfo.reslinear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) ||
     MOBDB_FLAGS_GET_LINEAR(temp2->flags);
   lfinfo.invert = INVERT_NO;
   lfinfo.discont = CONTINUOUS;
   lfinfo.tpfunc = lfinfo.reslinear ? &tpointseq_min_dist_at_timestamp : NULL;
-  Temporal *result = sync_tfunc_temporal_temporal(temp1, temp2, (Datum) NULL,
-    lfinfo);
+  /* Both points change at every instant and thus PostGIS is called without
+   * cache */
+  Temporal *result = sync_tfunc_temporal_temporal(temp1, temp2,
+    PointerGetDatum(NULL), lfinfo);
   return result;
 }
 
@@ -520,8 +909,6 @@ distance_tpoint_tpoint(PG_FUNCTION_ARGS)
   Temporal *temp2 = PG_GETARG_TEMPORAL(1);
   ensure_same_srid_tpoint(temp1, temp2);
   ensure_same_dimensionality_tpoint(temp1, temp2);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   Temporal *result = distance_tpoint_tpoint_internal(temp1, temp2);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
@@ -541,9 +928,12 @@ distance_tpoint_tpoint(PG_FUNCTION_ARGS)
  * @param[in] ti Temporal point
  * @param[in] geo Geometry
  * @param[in] func Distance function
+ * @param[in] flinfo FmgrInfo passed as a pointer datum to the distance
+ * function
  */
 static TInstant *
-NAI_tpointinstset_geo(const TInstantSet *ti, Datum geo, Datum (*func)(Datum, Datum))
+NAI_tpointinstset_geo(const TInstantSet *ti, Datum geo,
+  Datum (*func)(Datum, Datum, Datum), Datum flinfo)
 {
   double mindist = DBL_MAX;
   int number = 0; /* keep compiler quiet */
@@ -551,7 +941,7 @@ NAI_tpointinstset_geo(const TInstantSet *ti, Datum geo, Datum (*func)(Datum, Dat
   {
     TInstant *inst = tinstantset_inst_n(ti, i);
     Datum value = tinstant_value(inst);
-    double dist = DatumGetFloat8(func(value, geo));
+    double dist = DatumGetFloat8(func(value, geo, flinfo));
     if (dist < mindist)
     {
       mindist = dist;
@@ -576,16 +966,18 @@ NAI_tpointinstset_geo(const TInstantSet *ti, Datum geo, Datum (*func)(Datum, Dat
  * begining but contains the minimum distance found in the previous
  * sequences of a temporal sequence set
  * @param[in] func Distance function
+ * @param[in] flinfo FmgrInfo passed as a pointer datum to the distance
+ * function
  * @param[out] mininst Instant with the minimum distance
  */
 static double
 NAI_tpointseq_step_geo1(const TSequence *seq, Datum geo, double mindist,
-  Datum (*func)(Datum, Datum), TInstant **mininst)
+  Datum (*func)(Datum, Datum, Datum), Datum flinfo, TInstant **mininst)
 {
   for (int i = 0; i < seq->count; i++)
   {
     TInstant *inst = tsequence_inst_n(seq, i);
-    double dist = DatumGetFloat8(func(tinstant_value(inst), geo));
+    double dist = DatumGetFloat8(func(tinstant_value(inst), geo, flinfo));
     if (dist < mindist)
     {
       mindist = dist;
@@ -602,13 +994,15 @@ NAI_tpointseq_step_geo1(const TSequence *seq, Datum geo, double mindist,
  * @param[in] seq Temporal point
  * @param[in] geo Geometry
  * @param[in] func Distance function
+ * @param[in] flinfo FmgrInfo passed as a pointer datum to the distance
+ * function
  */
 static TInstant *
 NAI_tpointseq_step_geo(const TSequence *seq, Datum geo,
-  Datum (*func)(Datum, Datum))
+  Datum (*func)(Datum, Datum, Datum), Datum flinfo)
 {
   TInstant *inst;
-  NAI_tpointseq_step_geo1(seq, geo, DBL_MAX, func, &inst);
+  NAI_tpointseq_step_geo1(seq, geo, DBL_MAX, func, flinfo, &inst);
   return tinstant_copy(inst);
 }
 
@@ -619,17 +1013,20 @@ NAI_tpointseq_step_geo(const TSequence *seq, Datum geo,
  * @param[in] ts Temporal point
  * @param[in] geo Geometry
  * @param[in] func Distance function
+ * @param[in] flinfo FmgrInfo passed as a pointer datum to the distance
+ * function
  */
 static TInstant *
 NAI_tpointseqset_step_geo(const TSequenceSet *ts, Datum geo,
-  Datum (*func)(Datum, Datum))
+  Datum (*func)(Datum, Datum, Datum), Datum flinfo)
 {
   TInstant *inst;
   double mindist = DBL_MAX;
   for (int i = 0; i < ts->count; i++)
   {
     TSequence *seq = tsequenceset_seq_n(ts, i);
-    mindist = NAI_tpointseq_step_geo1(seq, geo, mindist, func, &inst);
+    mindist = NAI_tpointseq_step_geo1(seq, geo, mindist, func, flinfo,
+      &inst);
   }
   assert(inst != NULL);
   return tinstant_copy(inst);
@@ -643,13 +1040,15 @@ NAI_tpointseqset_step_geo(const TSequenceSet *ts, Datum geo,
  *
  * @param[in] inst1,inst2 Temporal segment
  * @param[in] lwgeom Geometry
+ * @param[in] tree Circular tree of the geometry for geographies, or NULL
  * @param[out] closest Closest point
  * @param[out] t Timestamp
  * @param[out] tofree True when the resulting instant should be freed
  */
 static double
 NAI_tpointseq_linear_geo1(const TInstant *inst1, const TInstant *inst2,
-  LWGEOM *lwgeom, Datum *closest, TimestampTz *t, bool *tofree)
+  const LWGEOM *lwgeom, const CIRC_NODE *tree, Datum *closest,
+  TimestampTz *t, bool *tofree)
 {
   Datum value1 = tinstant_value(inst1);
   Datum value2 = tinstant_value(inst2);
@@ -667,7 +1066,7 @@ NAI_tpointseq_linear_geo1(const TInstant *inst1, const TInstant *inst2,
   /* The trajectory is a line */
   LWLINE *lwline = geopoint_lwline(value1, value2);
   if (MOBDB_FLAGS_GET_GEODETIC(inst1->flags))
-    dist = lw_dist_sphere_point_dist((LWGEOM *) lwline, lwgeom, DIST_MIN, &fraction);
+    dist = lw_dist_sphere_point_dist((LWGEOM *) lwline, tree, DIST_MIN, &fraction);
   else
     dist = MOBDB_FLAGS_GET_Z(inst1->flags) ?
       lw_dist3d_point_dist((LWGEOM *) lwline, lwgeom, DIST_MIN, &fraction) :
@@ -701,15 +1100,21 @@ NAI_tpointseq_linear_geo1(const TInstant *inst1, const TInstant *inst2,
  *
  * @param[in] seq Temporal point
  * @param[in] geo Geometry
+ * @param[in] lwgeom Geometry
+ * @param[in] tree Circular tree of the geometry for geographies, or NULL
  * @param[in] mindist Minimum distance found so far, or DBL_MAX at the beginning
  * @param[in] func Distance function
+ * @param[in] flinfo FmgrInfo passed as a pointer datum to the distance
+ * function
  * @param[out] closest Closest point
  * @param[out] t Timestamp
  * @param[out] tofree True when the resulting instant should be freed
  */
 static double
-NAI_tpointseq_linear_geo2(const TSequence *seq, Datum geo, double mindist,
-  Datum (*func)(Datum, Datum), Datum *closest, TimestampTz *t, bool *tofree)
+NAI_tpointseq_linear_geo2(const TSequence *seq, Datum geo,
+  const LWGEOM *lwgeom, const CIRC_NODE *tree, double mindist,
+  Datum (*func)(Datum, Datum, Datum), Datum flinfo, Datum *closest,
+  TimestampTz *t, bool *tofree)
 {
   TInstant *inst1;
   double dist;
@@ -722,7 +1127,7 @@ NAI_tpointseq_linear_geo2(const TSequence *seq, Datum geo, double mindist,
   {
     inst1 = tsequence_inst_n(seq, 0);
     point = tinstant_value(inst1);
-    dist =  DatumGetFloat8(func(point, geo));
+    dist =  DatumGetFloat8(func(point, geo, flinfo));
     if (dist < mindist)
     {
       mindist = dist;
@@ -733,14 +1138,13 @@ NAI_tpointseq_linear_geo2(const TSequence *seq, Datum geo, double mindist,
     return mindist;
   }
 
-  GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(geo);
-  LWGEOM *lwgeom = lwgeom_from_gserialized(gs);
   inst1 = tsequence_inst_n(seq, 0);
   *tofree = false;
   for (int i = 0; i < seq->count - 1; i++)
   {
     TInstant *inst2 = tsequence_inst_n(seq, i + 1);
-    dist = NAI_tpointseq_linear_geo1(inst1, inst2, lwgeom, &point, &t1, &tofree1);
+    dist = NAI_tpointseq_linear_geo1(inst1, inst2, lwgeom, tree, &point, &t1,
+      &tofree1);
     if (dist < mindist)
     {
       if (*tofree)
@@ -763,12 +1167,14 @@ NAI_tpointseq_linear_geo2(const TSequence *seq, Datum geo, double mindist,
  */
 static TInstant *
 NAI_tpointseq_linear_geo(const TSequence *seq, Datum geo,
-  Datum (*func)(Datum, Datum))
+  const LWGEOM *lwgeom, const CIRC_NODE *tree,
+  Datum (*func)(Datum, Datum, Datum), Datum flinfo)
 {
   Datum closest;
   TimestampTz t;
   bool tofree;
-  NAI_tpointseq_linear_geo2(seq, geo, DBL_MAX, func, &closest, &t, &tofree);
+  NAI_tpointseq_linear_geo2(seq, geo, lwgeom, tree, DBL_MAX, func, flinfo,
+    &closest, &t, &tofree);
   TInstant *result = tinstant_make(closest, t, seq->valuetypid);
   if (tofree)
     pfree(DatumGetPointer(closest));
@@ -781,7 +1187,8 @@ NAI_tpointseq_linear_geo(const TSequence *seq, Datum geo,
  */
 static TInstant *
 NAI_tpointseqset_linear_geo(const TSequenceSet *ts, Datum geo,
-  Datum (*func)(Datum, Datum))
+  const LWGEOM *lwgeom, const CIRC_NODE *tree,
+  Datum (*func)(Datum, Datum, Datum), Datum flinfo)
 {
   Datum closest, point;
   TimestampTz t, t1;
@@ -790,8 +1197,8 @@ NAI_tpointseqset_linear_geo(const TSequenceSet *ts, Datum geo,
   for (int i = 0; i < ts->count; i++)
   {
     TSequence *seq = tsequenceset_seq_n(ts, i);
-    double dist = NAI_tpointseq_linear_geo2(seq, geo, mindist, func,
-      &point, &t1, &tofree1);
+    double dist = NAI_tpointseq_linear_geo2(seq, geo, lwgeom, tree, mindist,
+      func, flinfo, &point, &t1, &tofree1);
     if (dist < mindist)
     {
       if (tofree)
@@ -815,34 +1222,66 @@ NAI_tpointseqset_linear_geo(const TSequenceSet *ts, Datum geo,
 /**
  * Returns the nearest approach instant between the temporal point and
  * the geometry (dispatch function)
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] temp Temporal point
+ * @param[in] gs Geometry
+ * @param[in] gentry Cache entry of the geometry or NULL
  */
 TInstant *
 NAI_tpoint_geo_internal(FunctionCallInfo fcinfo, const Temporal *temp,
-  GSERIALIZED *gs)
+  GSERIALIZED *gs, ArgCacheEntry *gentry)
 {
   ensure_same_srid_tpoint_gs(temp, gs);
   ensure_same_dimensionality_tpoint_gs(temp, gs);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
-  Datum (*func)(Datum, Datum);
-  if (MOBDB_FLAGS_GET_GEODETIC(temp->flags))
+  bool geodetic = MOBDB_FLAGS_GET_GEODETIC(temp->flags);
+  Datum (*func)(Datum, Datum, Datum);
+  if (geodetic)
     func = &geog_distance;
   else
     func = &geom_distance2d;
+  /* The fn_extra field of the external function keeps the cache of its
+   * arguments, PostGIS keeps the tree of the geography in the FmgrInfo of
+   * this cache */
+  Datum flinfo = PointerGetDatum(argcache_flinfo(fcinfo));
   TInstant *result;
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT)
     result = tinstant_copy((TInstant *)temp);
   else if (temp->duration == INSTANTSET)
-    result = NAI_tpointinstset_geo((TInstantSet *)temp, PointerGetDatum(gs), func);
-  else if (temp->duration == SEQUENCE)
-    result = MOBDB_FLAGS_GET_LINEAR(temp->flags) ?
-      NAI_tpointseq_linear_geo((TSequence *)temp, PointerGetDatum(gs), func) :
-      NAI_tpointseq_step_geo((TSequence *)temp, PointerGetDatum(gs), func);
-  else /* temp->duration == SEQUENCESET */
-    result = MOBDB_FLAGS_GET_LINEAR(temp->flags) ?
-      NAI_tpointseqset_linear_geo((TSequenceSet *)temp, PointerGetDatum(gs), func) :
-      NAI_tpointseqset_step_geo((TSequenceSet *)temp, PointerGetDatum(gs), func);
+    result = NAI_tpointinstset_geo((TInstantSet *)temp, PointerGetDatum(gs),
+      func, flinfo);
+  else if (! MOBDB_FLAGS_GET_LINEAR(temp->flags))
+    result = (temp->duration == SEQUENCE) ?
+      NAI_tpointseq_step_geo((TSequence *)temp, PointerGetDatum(gs), func,
+        flinfo) :
+      NAI_tpointseqset_step_geo((TSequenceSet *)temp, PointerGetDatum(gs),
+        func, flinfo);
+  else
+  {
+    /* The geometry and, for geographies, its circular tree are computed
+     * once for all the segments, and for geographies repeated across calls
+     * the tree is kept in the cache of the function */
+    GeogCircTree *gtree = NULL;
+    LWGEOM *lwgeom;
+    if (geodetic)
+    {
+      gtree = geography_circ_tree(fcinfo, gentry, gs);
+      lwgeom = gtree->lwgeom;
+    }
+    else
+      lwgeom = lwgeom_from_gserialized(gs);
+    const CIRC_NODE *tree = geodetic ? gtree->tree : NULL;
+    result = (temp->duration == SEQUENCE) ?
+      NAI_tpointseq_linear_geo((TSequence *)temp, PointerGetDatum(gs),
+        lwgeom, tree, func, flinfo) :
+      NAI_tpointseqset_linear_geo((TSequenceSet *)temp, PointerGetDatum(gs),
+        lwgeom, tree, func, flinfo);
+    if (geodetic)
+      geography_circ_tree_release(gtree, gentry);
+    else
+      lwgeom_free(lwgeom);
+  }
   return result;
 }
 
@@ -854,12 +1293,15 @@ PG_FUNCTION_INFO_V1(NAI_geo_tpoint);
 PGDLLEXPORT Datum
 NAI_geo_tpoint(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 0);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(0);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
   Temporal *temp = PG_GETARG_TEMPORAL(1);
-  TInstant *result = NAI_tpoint_geo_internal(fcinfo, temp, gs);
-  PG_FREE_IF_COPY(gs, 0);
+  TInstant *result = NAI_tpoint_geo_internal(fcinfo, temp, gs, gentry);
+  ARGCACHE_FREE_IF_COPY(gs, 0, gentry);
   PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_POINTER(result);
 }
@@ -872,13 +1314,16 @@ PG_FUNCTION_INFO_V1(NAI_tpoint_geo);
 PGDLLEXPORT Datum
 NAI_tpoint_geo(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 1);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(1);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
   Temporal *temp = PG_GETARG_TEMPORAL(0);
-  TInstant *result = NAI_tpoint_geo_internal(fcinfo, temp, gs);
+  TInstant *result = NAI_tpoint_geo_internal(fcinfo, temp, gs, gentry);
   PG_FREE_IF_COPY(temp, 0);
-  PG_FREE_IF_COPY(gs, 1);
+  ARGCACHE_FREE_IF_COPY(gs, 1, gentry);
   PG_RETURN_POINTER(result);
 }
 
@@ -894,8 +1339,6 @@ NAI_tpoint_tpoint(PG_FUNCTION_ARGS)
   ensure_same_srid_tpoint(temp1, temp2);
   ensure_same_dimensionality_tpoint(temp1, temp2);
   TInstant *result = NULL;
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   Temporal *dist = distance_tpoint_tpoint_internal(temp1, temp2);
   if (dist != NULL)
   {
@@ -924,26 +1367,64 @@ NAI_tpoint_tpoint(PG_FUNCTION_ARGS)
  * Nearest approach distance
  *****************************************************************************/
 
+/**
+ * Returns the distance between the trajectory of a temporal geographic point
+ * and the geography whose circular tree is given
+ *
+ * @note As in PostGIS, the distance is rounded to avoid differences at the
+ * nanometer level between the computation with and without circular trees
+ */
+static double
+NAD_geog_tree(Datum traj, const CIRC_NODE *tree2)
+{
+  SPHEROID s;
+  spheroid_init(&s, WGS84_MAJOR_AXIS, WGS84_MINOR_AXIS);
+  if (geodetic_accuracy != GEODETIC_SPHEROID)
+    s.a = s.b = s.radius;
+  GeogCircTree *tree1 = geog_circ_tree_make(
+    (GSERIALIZED *) DatumGetPointer(traj));
+  double result = circ_tree_distance_tree(tree1->tree, tree2, &s,
+    FP_TOLERANCE);
+  geog_circ_tree_free(tree1);
+  return round(result * 1.0e8) / 1.0e8;
+}
+
 /**
  * Returns the nearest approach distance between the temporal point and the
  * geometry (internal function)
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] temp Temporal point
+ * @param[in] gs Geometry
+ * @param[in] gentry Cache entry of the geometry or NULL
  */
 Datum
 NAD_tpoint_geo_internal(FunctionCallInfo fcinfo, Temporal *temp,
-  GSERIALIZED *gs)
+  GSERIALIZED *gs, ArgCacheEntry *gentry)
 {
   ensure_same_srid_tpoint_gs(temp, gs);
   ensure_same_dimensionality_tpoint_gs(temp, gs);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
-  Datum (*func)(Datum, Datum);
-  if (MOBDB_FLAGS_GET_GEODETIC(temp->flags))
-    func = &geog_distance;
-  else
-    func = MOBDB_FLAGS_GET_Z(temp->flags) ? &geom_distance3d :
-      &geom_distance2d;
   Datum traj = tpoint_trajectory_internal(temp);
-  Datum result = func(traj, PointerGetDatum(gs));
+  Datum result;
+  if (MOBDB_FLAGS_GET_GEODETIC(temp->flags) && gentry != NULL)
+  {
+    /* The circular tree of a geography repeated across calls is kept in
+     * the cache of the function */
+    GeogCircTree *gtree = geography_circ_tree(fcinfo, gentry, gs);
+    result = Float8GetDatum(NAD_geog_tree(traj, gtree->tree));
+    geography_circ_tree_release(gtree, gentry);
+  }
+  else
+  {
+    Datum (*func)(Datum, Datum, Datum);
+    if (MOBDB_FLAGS_GET_GEODETIC(temp->flags))
+      func = &geog_distance;
+    else
+      func = MOBDB_FLAGS_GET_Z(temp->flags) ? &geom_distance3d :
+        &geom_distance2d;
+    result = func(traj, PointerGetDatum(gs),
+      PointerGetDatum(argcache_flinfo(fcinfo)));
+  }
   pfree(DatumGetPointer(traj));
   return result;
 }
@@ -956,12 +1437,15 @@ PG_FUNCTION_INFO_V1(NAD_geo_tpoint);
 PGDLLEXPORT Datum
 NAD_geo_tpoint(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 0);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(0);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
   Temporal *temp = PG_GETARG_TEMPORAL(1);
-  Datum result = NAD_tpoint_geo_internal(fcinfo, temp, gs);
-  PG_FREE_IF_COPY(gs, 0);
+  Datum result = NAD_tpoint_geo_internal(fcinfo, temp, gs, gentry);
+  ARGCACHE_FREE_IF_COPY(gs, 0, gentry);
   PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_DATUM(result);
 }
@@ -974,13 +1458,16 @@ PG_FUNCTION_INFO_V1(NAD_tpoint_geo);
 PGDLLEXPORT Datum
 NAD_tpoint_geo(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 1);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(1);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
   Temporal *temp = PG_GETARG_TEMPORAL(0);
-  Datum result = NAD_tpoint_geo_internal(fcinfo, temp, gs);
+  Datum result = NAD_tpoint_geo_internal(fcinfo, temp, gs, gentry);
   PG_FREE_IF_COPY(temp, 0);
-  PG_FREE_IF_COPY(gs, 1);
+  ARGCACHE_FREE_IF_COPY(gs, 1, gentry);
   PG_RETURN_DATUM(result);
 }
 
@@ -994,10 +1481,8 @@ NAD_stbox_geo_internal(FunctionCallInfo fcinfo, STBOX *box,
 {
   ensure_same_srid_stbox_gs(box, gs);
   ensure_same_spatial_dimensionality_stbox_gs(box, gs);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   bool hasz = MOBDB_FLAGS_GET_Z(box->flags);
-  Datum (*func)(Datum, Datum);
+  Datum (*func)(Datum, Datum, Datum);
   if (MOBDB_FLAGS_GET_GEODETIC(box->flags))
     func = &geog_distance;
   else
@@ -1014,7 +1499,10 @@ NAD_stbox_geo_internal(FunctionCallInfo fcinfo, STBOX *box,
     box1 = PointerGetDatum(stbox_to_gbox(box));
     geo = call_function1(BOX2D_to_LWGEOM, box1);
   }
-  Datum result = func(geo, PointerGetDatum(gs));
+  /* PostGIS keeps the tree of the geography in the FmgrInfo of the external
+   * function */
+  Datum result = func(geo, PointerGetDatum(gs),
+    PointerGetDatum(fcinfo->flinfo));
   pfree(DatumGetPointer(box1));
   pfree(DatumGetPointer(geo));
   return result;
@@ -1081,7 +1569,7 @@ NAD_stbox_stbox_internal(const STBOX *box1, const STBOX *box2)
 
   /* Select the distance function to be applied */
   bool hasz = MOBDB_FLAGS_GET_Z(box1->flags);
-  Datum (*func)(Datum, Datum);
+  Datum (*func)(Datum, Datum, Datum);
   if (MOBDB_FLAGS_GET_GEODETIC(box1->flags))
     func = &geog_distance;
   else
@@ -1099,7 +1587,7 @@ NAD_stbox_stbox_internal(const STBOX *box1, const STBOX *box2)
   Datum geo21 = call_function2(LWGEOM_set_srid, geo2,
     Int32GetDatum(box2->srid));
   /* Compute the result */
-  double result = DatumGetFloat8(func(geo11, geo21));
+  double result = DatumGetFloat8(func(geo11, geo21, PointerGetDatum(NULL)));
 
   pfree(DatumGetPointer(gbox1)); pfree(DatumGetPointer(geo1));
   pfree(DatumGetPointer(geo11));
@@ -1119,8 +1607,6 @@ NAD_stbox_stbox(PG_FUNCTION_ARGS)
 {
   STBOX *box1 = PG_GETARG_STBOX_P(0);
   STBOX *box2 = PG_GETARG_STBOX_P(1);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   double result = NAD_stbox_stbox_internal(box1, box2);
   if (result == DBL_MAX)
     PG_RETURN_NULL();
@@ -1154,7 +1640,7 @@ NAD_tpoint_stbox_internal(const Temporal *temp, STBOX *box)
 
   /* Select the distance function to be applied */
   bool hasz = MOBDB_FLAGS_GET_Z(box->flags);
-  Datum (*func)(Datum, Datum);
+  Datum (*func)(Datum, Datum, Datum);
   if (MOBDB_FLAGS_GET_GEODETIC(temp->flags))
     func = &geog_distance;
   else
@@ -1170,13 +1656,15 @@ NAD_tpoint_stbox_internal(const Temporal *temp, STBOX *box)
     (Temporal *) temp;
   /* Compute the result */
   Datum traj = tpoint_trajectory_internal(temp1);
-  double result = DatumGetFloat8(func(traj, geo1));
+  double result = DatumGetFloat8(func(traj, geo1, PointerGetDatum(NULL)));
 
   pfree(DatumGetPointer(gbox)); pfree(DatumGetPointer(geo));
   pfree(DatumGetPointer(traj)); pfree(DatumGetPointer(geo1));
   if (hast)
   {
-    pfree(inter); pfree(temp1);
+    pfree(inter);
+    if (temp1 != temp)
+      pfree(temp1);
   }
   return result;
 }
@@ -1191,8 +1679,6 @@ NAD_stbox_tpoint(PG_FUNCTION_ARGS)
 {
   STBOX *box = PG_GETARG_STBOX_P(0);
   Temporal *temp = PG_GETARG_TEMPORAL(1);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   double result = NAD_tpoint_stbox_internal(temp, box);
   PG_FREE_IF_COPY(temp, 1);
   if (result == DBL_MAX)
@@ -1210,8 +1696,6 @@ NAD_tpoint_stbox(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
   STBOX *box = PG_GETARG_STBOX_P(1);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   double result = NAD_tpoint_stbox_internal(temp, box);
   PG_FREE_IF_COPY(temp, 0);
   if (result == DBL_MAX)
@@ -1219,6 +1703,85 @@ NAD_tpoint_stbox(PG_FUNCTION_ARGS)
   PG_RETURN_DATUM(result);
 }
 
+/**
+ * Returns a lower bound of the distance between the two temporal points
+ * computed from their bounding boxes
+ */
+static double
+tpointseq_bbox_distance(const TSequence *seq1, const TSequence *seq2,
+  bool hasz)
+{
+  const STBOX *box1 = tsequence_bbox_ptr(seq1);
+  const STBOX *box2 = tsequence_bbox_ptr(seq2);
+  double dx = Max(0.0, Max(box1->xmin - box2->xmax, box2->xmin - box1->xmax));
+  double dy = Max(0.0, Max(box1->ymin - box2->ymax, box2->ymin - box1->ymax));
+  double dz = hasz ?
+    Max(0.0, Max(box1->zmin - box2->zmax, box2->zmin - box1->zmax)) : 0.0;
+  return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * Returns the nearest approach distance between the temporal points
+ * (internal function)
+ *
+ * For temporal geometric points with linear interpolation, the sequences
+ * of the two values are traversed in time order while keeping the best
+ * distance found so far. The pairs of overlapping sequences whose bounding
+ * boxes are farther than this distance are skipped. In the other cases the
+ * minimum of the temporal distance is computed.
+ *
+ * @result Returns DBL_MAX if the temporal points do not intersect in time
+ */
+double
+NAD_tpoint_tpoint_internal(const Temporal *temp1, const Temporal *temp2)
+{
+  if (MOBDB_FLAGS_GET_GEODETIC(temp1->flags) ||
+    (temp1->duration != SEQUENCE && temp1->duration != SEQUENCESET) ||
+    (temp2->duration != SEQUENCE && temp2->duration != SEQUENCESET) ||
+    ! MOBDB_FLAGS_GET_LINEAR(temp1->flags) ||
+    ! MOBDB_FLAGS_GET_LINEAR(temp2->flags))
+  {
+    Temporal *dist = distance_tpoint_tpoint_internal(temp1, temp2);
+    if (dist == NULL)
+      return DBL_MAX;
+    double result = DatumGetFloat8(temporal_min_value_internal(dist));
+    pfree(dist);
+    return result;
+  }
+
+  bool hasz = MOBDB_FLAGS_GET_Z(temp1->flags);
+  int count1 = (temp1->duration == SEQUENCE) ? 1 :
+    ((TSequenceSet *) temp1)->count;
+  int count2 = (temp2->duration == SEQUENCE) ? 1 :
+    ((TSequenceSet *) temp2)->count;
+  double result = DBL_MAX;
+  int i = 0, j = 0;
+  while (i < count1 && j < count2)
+  {
+    const TSequence *seq1 = (temp1->duration == SEQUENCE) ?
+      (TSequence *) temp1 : tsequenceset_seq_n((TSequenceSet *) temp1, i);
+    const TSequence *seq2 = (temp2->duration == SEQUENCE) ?
+      (TSequence *) temp2 : tsequenceset_seq_n((TSequenceSet *) temp2, j);
+    if (overlaps_period_period_internal(&seq1->period, &seq2->period) &&
+      tpointseq_bbox_distance(seq1, seq2, hasz) < result)
+    {
+      result = distance_tgeompointseq_tgeompointseq1(seq1, seq2, NULL,
+        result);
+      if (result == 0.0)
+        break;
+    }
+    /* Advance the sequence that ends first, or both if they end together */
+    int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+    if (cmp == 0 && seq1->period.upper_inc != seq2->period.upper_inc)
+      cmp = seq1->period.upper_inc ? 1 : -1;
+    if (cmp <= 0)
+      i++;
+    if (cmp >= 0)
+      j++;
+  }
+  return result;
+}
+
 PG_FUNCTION_INFO_V1(NAD_tpoint_tpoint);
 /**
  * Returns the nearest approach distance between the temporal points
@@ -1230,33 +1793,51 @@ NAD_tpoint_tpoint(PG_FUNCTION_ARGS)
   Temporal *temp2 = PG_GETARG_TEMPORAL(1);
   ensure_same_srid_tpoint(temp1, temp2);
   ensure_same_dimensionality_tpoint(temp1, temp2);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
-  Temporal *dist = distance_tpoint_tpoint_internal(temp1, temp2);
-  if (dist == NULL)
-  {
-    PG_FREE_IF_COPY(temp1, 0);
-    PG_FREE_IF_COPY(temp2, 1);
-    PG_RETURN_NULL();
-  }
-
-  Datum result = temporal_min_value_internal(dist);
-  pfree(dist);
+  double result = NAD_tpoint_tpoint_internal(temp1, temp2);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
-  PG_RETURN_DATUM(result);
+  if (result == DBL_MAX)
+    PG_RETURN_NULL();
+  PG_RETURN_FLOAT8(result);
 }
 
 /*****************************************************************************
  * ShortestLine
  *****************************************************************************/
 
+/**
+ * Returns the line connecting the nearest approach point between the
+ * trajectory of a temporal geographic point and the geography whose
+ * circular tree is given
+ */
+static Datum
+shortestline_geog_tree(Datum traj, const CIRC_NODE *tree2)
+{
+  SPHEROID s;
+  spheroid_init(&s, WGS84_MAJOR_AXIS, WGS84_MINOR_AXIS);
+  GSERIALIZED *gstraj = (GSERIALIZED *) DatumGetPointer(traj);
+  GeogCircTree *tree1 = geog_circ_tree_make(gstraj);
+  LWGEOM *line = geography_tree_shortestline(tree1->tree, tree2,
+    gserialized_get_srid(gstraj), FP_TOLERANCE, &s);
+  geog_circ_tree_free(tree1);
+  lwgeom_set_geodetic(line, true);
+  Datum result = PointerGetDatum(geo_serialize(line));
+  lwgeom_free(line);
+  return result;
+}
+
 /**
  * Returns the line connecting the nearest approach point between the
  * temporal instant point and the geometry (internal function)
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] temp Temporal point
+ * @param[in] gs Geometry
+ * @param[in] gentry Cache entry of the geometry or NULL
  */
 Datum
-shortestline_tpoint_geo_internal(Temporal *temp, GSERIALIZED *gs)
+shortestline_tpoint_geo_internal(FunctionCallInfo fcinfo, Temporal *temp,
+  GSERIALIZED *gs, ArgCacheEntry *gentry)
 {
   ensure_same_srid_tpoint_gs(temp, gs);
   bool geodetic = MOBDB_FLAGS_GET_GEODETIC(temp->flags);
@@ -1266,7 +1847,13 @@ shortestline_tpoint_geo_internal(Temporal *temp, GSERIALIZED *gs)
   Datum traj = tpoint_trajectory_internal(temp);
   Datum result;
   if (geodetic)
-    result = call_function2(geography_shortestline, traj, PointerGetDatum(gs));
+  {
+    /* The circular tree of a geography repeated across calls is kept in
+     * the cache of the function */
+    GeogCircTree *gtree = geography_circ_tree(fcinfo, gentry, gs);
+    result = shortestline_geog_tree(traj, gtree->tree);
+    geography_circ_tree_release(gtree, gentry);
+  }
   else
     result = MOBDB_FLAGS_GET_Z(temp->flags) ?
       call_function2(LWGEOM_shortestline3d, traj, PointerGetDatum(gs)) :
@@ -1283,12 +1870,15 @@ PG_FUNCTION_INFO_V1(shortestline_geo_tpoint);
 PGDLLEXPORT Datum
 shortestline_geo_tpoint(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 0);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(0);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
   Temporal *temp = PG_GETARG_TEMPORAL(1);
-  Datum result = shortestline_tpoint_geo_internal(temp, gs);
-  PG_FREE_IF_COPY(gs, 0);
+  Datum result = shortestline_tpoint_geo_internal(fcinfo, temp, gs, gentry);
+  ARGCACHE_FREE_IF_COPY(gs, 0, gentry);
   PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_DATUM(result);
 }
@@ -1301,13 +1891,16 @@ PG_FUNCTION_INFO_V1(shortestline_tpoint_geo);
 PGDLLEXPORT Datum
 shortestline_tpoint_geo(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 1);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(1);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
   Temporal *temp = PG_GETARG_TEMPORAL(0);
-  Datum result = shortestline_tpoint_geo_internal(temp, gs);
+  Datum result = shortestline_tpoint_geo_internal(fcinfo, temp, gs, gentry);
   PG_FREE_IF_COPY(temp, 0);
-  PG_FREE_IF_COPY(gs, 1);
+  ARGCACHE_FREE_IF_COPY(gs, 1, gentry);
   PG_RETURN_DATUM(result);
 }
 
@@ -1344,8 +1937,6 @@ shortestline_tpoint_tpoint(PG_FUNCTION_ARGS)
   Temporal *temp2 = PG_GETARG_TEMPORAL(1);
   ensure_same_srid_tpoint(temp1, temp2);
   ensure_same_dimensionality_tpoint(temp1, temp2);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   Datum result;
   bool found = shortestline_tpoint_tpoint_internal(temp1, temp2, &result);
   PG_FREE_IF_COPY(temp1, 0);
@@ -14,8 +14,14 @@
 
 #include <assert.h>
 #include <float.h>
+#include <math.h>
 #include <utils/timestamp.h>
 #include <access/gist.h>
+#include <access/brin_internal.h>
+#include <access/brin_tuple.h>
+#include <utils/datum.h>
+#include <utils/sortsupport.h>
+#include <utils/typcache.h>
 
 #if MOBDB_PGSQL_VERSION >= 120000
 #include <utils/float.h>
@@ -24,11 +30,15 @@
 #include "time_gist.h"
 #include "temporaltypes.h"
 #include "oidcache.h"
+#include "indexesstat.h"
+#include "mobdb_probes.h"
+#include "temporal_util.h"
 #include "tpoint.h"
 #include "tnumber_gist.h"
 #include "tpoint_boxops.h"
 #include "tpoint_distance.h"
 #include "tpoint_posops.h"
+#include "tpoint_similarity.h"
 
 /*****************************************************************************
  * GiST consistent methods
@@ -247,6 +257,77 @@ tpoint_index_recheck(StrategyNumber strategy)
   }
 }
 
+/**
+ * Transform the query argument of an index support function into a box 
+ * initializing the dimensions that must not be taken into account by the
+ * operators to infinity.
+ *
+ * @param[in] query Query argument
+ * @param[in] subtype Oid of the type of the query
+ * @param[out] box Resulting box
+ * @return False if the query is empty
+ */
+bool
+tpoint_index_query_box(Datum query, Oid subtype, STBOX *box)
+{
+  memset(box, 0, sizeof(STBOX));
+  if (tgeo_base_type(subtype))
+  {
+    GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(query);
+    bool result = geo_to_stbox_internal(box, gs);
+    if ((Pointer) gs != DatumGetPointer(query))
+      pfree(gs);
+    return result;
+  }
+  else if (subtype == type_oid(T_STBOX))
+    memcpy(box, DatumGetSTboxP(query), sizeof(STBOX));
+  else if (tgeo_type(subtype))
+    temporal_bbox_slice(box, query);
+  else
+    elog(ERROR, "Unsupported subtype for indexing: %d", subtype);
+  return true;
+}
+
+/**
+ * Returns a lower bound of the distance between the key and the query
+ * boxes for ordering the index entries. When both boxes have a time
+ * dimension, the entries whose period does not intersect the one of the
+ * query are pruned by returning the maximum distance. The distance between
+ * planar boxes is computed from their bounds without converting them into
+ * geometries.
+ */
+double
+stbox_index_distance(const STBOX *key, const STBOX *query)
+{
+  double dx, dy, dz;
+
+  if (! MOBDB_FLAGS_GET_X(query->flags))
+    return DBL_MAX;
+  if (MOBDB_FLAGS_GET_T(key->flags) && MOBDB_FLAGS_GET_T(query->flags) &&
+      (key->tmax < query->tmin || query->tmax < key->tmin))
+    return DBL_MAX;
+
+  if (MOBDB_FLAGS_GET_GEODETIC(key->flags))
+  {
+    /* The time dimension has been considered above */
+    STBOX box1, box2;
+    memcpy(&box1, key, sizeof(STBOX));
+    memcpy(&box2, query, sizeof(STBOX));
+    MOBDB_FLAGS_SET_T(box1.flags, false);
+    MOBDB_FLAGS_SET_T(box2.flags, false);
+    return NAD_stbox_stbox_internal(&box1, &box2);
+  }
+
+  dx = Max(Max(key->xmin - query->xmax, query->xmin - key->xmax), 0);
+  dy = Max(Max(key->ymin - query->ymax, query->ymin - key->ymax), 0);
+  if (MOBDB_FLAGS_GET_Z(key->flags) && MOBDB_FLAGS_GET_Z(query->flags))
+  {
+    dz = Max(Max(key->zmin - query->zmax, query->zmin - key->zmax), 0);
+    return hypot3d(dx, dy, dz);
+  }
+  return hypot(dx, dy);
+}
+
 PG_FUNCTION_INFO_V1(stbox_gist_consistent);
 /**
  * GiST consistent method for temporal points
@@ -267,40 +348,18 @@ stbox_gist_consistent(PG_FUNCTION_ARGS)
   if (key == NULL)
     PG_RETURN_BOOL(false);
   
-  /*
-   * Transform the query into a box initializing the dimensions that must
-   * not be taken into account by the operators to infinity.
-   */
-  memset(&query, 0, sizeof(STBOX));
-  if (tgeo_base_type(subtype))
-  {
-    /* Since function stbox_gist_consistent is strict, query is not NULL */
-    if (!geo_to_stbox_internal(&query, PG_GETARG_GSERIALIZED_P(1)))
-      PG_RETURN_BOOL(false);
-  }
-  else if (subtype == type_oid(T_STBOX))
-  {
-    STBOX *box = PG_GETARG_STBOX_P(1);
-    if (box == NULL)
-      PG_RETURN_BOOL(false);
-    memcpy(&query, box, sizeof(STBOX));
-  }
-  else if (tgeo_type(subtype))
-  {
-    Temporal *temp = PG_GETARG_TEMPORAL(1);
-    if (temp == NULL)
-      PG_RETURN_BOOL(false);
-    temporal_bbox(&query, temp);
-    PG_FREE_IF_COPY(temp, 1);
-  }
-  else
-    elog(ERROR, "Unsupported subtype for indexing: %d", subtype);
+  /* Transform the query into a box */
+  if (!tpoint_index_query_box(PG_GETARG_DATUM(1), subtype, &query))
+    PG_RETURN_BOOL(false);
   
+  TRACE_MOBILITYDB_GIST_CONSISTENT_START(GIST_STAT_STBOX, strategy);
   if (GIST_LEAF(entry))
     result = stbox_index_consistent_leaf(key, &query, strategy);
   else
     result = stbox_gist_consistent_internal(key, &query, strategy);
+  TRACE_MOBILITYDB_GIST_CONSISTENT_DONE(GIST_STAT_STBOX, result);
 
+  gist_consistent_count(GIST_STAT_STBOX, GIST_LEAF(entry), result, *recheck);
   PG_RETURN_BOOL(result);
 }
 
@@ -308,28 +367,98 @@ stbox_gist_consistent(PG_FUNCTION_ARGS)
  * GiST union method
  *****************************************************************************/
 
+/**
+ * Returns true if the spatial coordinates of the box are not NaN, in which
+ * case the box can be compared with the inline comparisons
+ */
+static inline bool
+stbox_nonan(const STBOX *box)
+{
+  return ! isnan(box->xmin) && ! isnan(box->xmax) && ! isnan(box->ymin) &&
+    ! isnan(box->ymax) && ! isnan(box->zmin) && ! isnan(box->zmax);
+}
+
 /**
  * Increase the first box to include the second one
  */
 static void
 stbox_adjust(STBOX *b, const STBOX *addon)
 {
-  if (FLOAT8_LT(b->xmax, addon->xmax))
-    b->xmax = addon->xmax;
-  if (FLOAT8_GT(b->xmin, addon->xmin))
-    b->xmin = addon->xmin;
-  if (FLOAT8_LT(b->ymax, addon->ymax))
-    b->ymax = addon->ymax;
-  if (FLOAT8_GT(b->ymin, addon->ymin))
-    b->ymin = addon->ymin;
-  if (FLOAT8_LT(b->zmax, addon->zmax))
-    b->zmax = addon->zmax;
-  if (FLOAT8_GT(b->zmin, addon->zmin))
-    b->zmin = addon->zmin;
-  if (b->tmax < addon->tmax)
-    b->tmax = addon->tmax;
-  if (b->tmin > addon->tmin)
-    b->tmin = addon->tmin;
+  if (stbox_nonan(b) && stbox_nonan(addon))
+  {
+    b->xmax = FAST_MAX(b->xmax, addon->xmax);
+    b->xmin = FAST_MIN(b->xmin, addon->xmin);
+    b->ymax = FAST_MAX(b->ymax, addon->ymax);
+    b->ymin = FAST_MIN(b->ymin, addon->ymin);
+    b->zmax = FAST_MAX(b->zmax, addon->zmax);
+    b->zmin = FAST_MIN(b->zmin, addon->zmin);
+  }
+  else
+  {
+    if (FLOAT8_LT(b->xmax, addon->xmax))
+      b->xmax = addon->xmax;
+    if (FLOAT8_GT(b->xmin, addon->xmin))
+      b->xmin = addon->xmin;
+    if (FLOAT8_LT(b->ymax, addon->ymax))
+      b->ymax = addon->ymax;
+    if (FLOAT8_GT(b->ymin, addon->ymin))
+      b->ymin = addon->ymin;
+    if (FLOAT8_LT(b->zmax, addon->zmax))
+      b->zmax = addon->zmax;
+    if (FLOAT8_GT(b->zmin, addon->zmin))
+      b->zmin = addon->zmin;
+  }
+  b->tmax = FAST_MAX(b->tmax, addon->tmax);
+  b->tmin = FAST_MIN(b->tmin, addon->tmin);
+  return;
+}
+
+/**
+ * Returns in the first box the union of the boxes of the entries of the
+ * vector from the first to the last offset (inclusive)
+ *
+ * The extrema are accumulated by a branch-free loop that also detects the
+ * NaN coordinates, in which case the union is computed again with the
+ * NaN-aware comparisons.
+ */
+static void
+stbox_union_vector(STBOX *result, const GistEntryVector *entryvec,
+  OffsetNumber first, OffsetNumber last)
+{
+  const STBOX *box = (STBOX *) DatumGetPointer(entryvec->vector[first].key);
+  *result = *box;
+  double xmin = box->xmin, xmax = box->xmax, ymin = box->ymin,
+    ymax = box->ymax, zmin = box->zmin, zmax = box->zmax;
+  TimestampTz tmin = box->tmin, tmax = box->tmax;
+  bool hasnan = ! stbox_nonan(box);
+  for (OffsetNumber i = first + 1; i <= last; i++)
+  {
+    box = (STBOX *) DatumGetPointer(entryvec->vector[i].key);
+    xmin = FAST_MIN(xmin, box->xmin);
+    xmax = FAST_MAX(xmax, box->xmax);
+    ymin = FAST_MIN(ymin, box->ymin);
+    ymax = FAST_MAX(ymax, box->ymax);
+    zmin = FAST_MIN(zmin, box->zmin);
+    zmax = FAST_MAX(zmax, box->zmax);
+    tmin = FAST_MIN(tmin, box->tmin);
+    tmax = FAST_MAX(tmax, box->tmax);
+    hasnan |= isnan(box->xmin) | isnan(box->xmax) | isnan(box->ymin) |
+      isnan(box->ymax) | isnan(box->zmin) | isnan(box->zmax);
+  }
+  if (hasnan)
+  {
+    for (OffsetNumber i = first + 1; i <= last; i++)
+      stbox_adjust(result, (STBOX *) DatumGetPointer(entryvec->vector[i].key));
+    return;
+  }
+  result->xmin = xmin;
+  result->xmax = xmax;
+  result->ymin = ymin;
+  result->ymax = ymax;
+  result->zmin = zmin;
+  result->zmax = zmax;
+  result->tmin = tmin;
+  result->tmax = tmax;
   return;
 }
 
@@ -343,19 +472,9 @@ PGDLLEXPORT Datum
 stbox_gist_union(PG_FUNCTION_ARGS)
 {
   GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
-  int  i;
-  STBOX *cur, *pageunion;
-  
-  pageunion = (STBOX *)palloc0(sizeof(STBOX));
-  cur = (STBOX *)DatumGetPointer(entryvec->vector[0].key);
-  memcpy((void *)pageunion, (void *)cur, sizeof(STBOX));
-  
-  for (i = 1; i < entryvec->n; i++)
-  {
-    cur = (STBOX *)DatumGetPointer(entryvec->vector[i].key);
-    stbox_adjust(pageunion, cur);
-  }
-  
+  STBOX *pageunion = (STBOX *) palloc0(sizeof(STBOX));
+  stbox_union_vector(pageunion, entryvec, 0,
+    (OffsetNumber) (entryvec->n - 1));
   PG_RETURN_POINTER(pageunion);
 }
 
@@ -374,9 +493,8 @@ tpoint_gist_compress(PG_FUNCTION_ARGS)
   if (entry->leafkey)
   {
     GISTENTRY *retval = palloc(sizeof(GISTENTRY));
-    Temporal *temp = DatumGetTemporal(entry->key);
     STBOX *box = palloc0(sizeof(STBOX));
-    temporal_bbox(box, temp);
+    temporal_bbox_slice(box, entry->key);
     gistentryinit(*retval, PointerGetDatum(box), entry->rel, entry->page, 
       entry->offset, false);
     PG_RETURN_POINTER(retval);
@@ -417,14 +535,35 @@ stbox_union_rt(STBOX *n, const STBOX *a, const STBOX *b)
   n->xmax = FLOAT8_MAX(a->xmax, b->xmax);
   n->ymax = FLOAT8_MAX(a->ymax, b->ymax);
   n->zmax = FLOAT8_MAX(a->zmax, b->zmax);
-  n->tmax = a->tmax > b->tmax ? a->tmax : b->tmax;
+  n->tmax = FAST_MAX(a->tmax, b->tmax);
   n->xmin = FLOAT8_MIN(a->xmin, b->xmin);
   n->ymin = FLOAT8_MIN(a->ymin, b->ymin);
   n->zmin = FLOAT8_MIN(a->zmin, b->zmin);
-  n->tmin = a->tmin < b->tmin ? a->tmin : b->tmin;
+  n->tmin = FAST_MIN(a->tmin, b->tmin);
   return;
 }
 
+/**
+ * Returns the size of the union of two spatiotemporal boxes whose
+ * coordinates are not NaN, without constructing the union
+ */
+static inline double
+stbox_union_size_nonan(const STBOX *a, const STBOX *b)
+{
+  double xmin = FAST_MIN(a->xmin, b->xmin);
+  double xmax = FAST_MAX(a->xmax, b->xmax);
+  double ymin = FAST_MIN(a->ymin, b->ymin);
+  double ymax = FAST_MAX(a->ymax, b->ymax);
+  double zmin = FAST_MIN(a->zmin, b->zmin);
+  double zmax = FAST_MAX(a->zmax, b->zmax);
+  TimestampTz tmin = FAST_MIN(a->tmin, b->tmin);
+  TimestampTz tmax = FAST_MAX(a->tmax, b->tmax);
+  /* The same zero-width cases as in stbox_size */
+  if (xmax <= xmin || ymax <= ymin || zmax <= zmin || tmax <= tmin)
+    return 0.0;
+  return (xmax - xmin) * (ymax - ymin) * (zmax - zmin) * (tmax - tmin);
+}
+
 /**
  * Returns the size of a spatiotemporal box for penalty-calculation purposes.
  * The result can be +Infinity, but not NaN.
@@ -432,6 +571,9 @@ stbox_union_rt(STBOX *n, const STBOX *a, const STBOX *b)
 static double
 stbox_size(const STBOX *box)
 {
+  if (stbox_nonan(box))
+    return stbox_union_size_nonan(box, box);
+
   /*
    * Check for zero-width cases.  Note that we define the size of a zero-
    * by-infinity box as zero.  It's important to special-case this somehow,
@@ -463,11 +605,39 @@ stbox_penalty(const STBOX *original, const STBOX *new)
 {
   STBOX unionbox;
   
+  if (stbox_nonan(original) && stbox_nonan(new))
+    return stbox_union_size_nonan(original, new) - stbox_size(original);
   memset(&unionbox, 0, sizeof(STBOX));
   stbox_union_rt(&unionbox, original, new);
   return stbox_size(&unionbox) - stbox_size(original);
 }
 
+/**
+ * Computes for the common entries of a split the delta between the
+ * penalties of adding them to the left and to the right box
+ *
+ * The sizes of the left and the right boxes are computed once for all the
+ * entries whose coordinates are not NaN.
+ */
+static void
+stbox_common_deltas(const STBOX *left, const STBOX *right,
+  const GistEntryVector *entryvec, CommonEntry *entries, int count)
+{
+  bool nonan = stbox_nonan(left) && stbox_nonan(right);
+  double leftsize = stbox_size(left), rightsize = stbox_size(right);
+  for (int i = 0; i < count; i++)
+  {
+    const STBOX *box =
+      (STBOX *) DatumGetPointer(entryvec->vector[entries[i].index].key);
+    if (nonan && stbox_nonan(box))
+      entries[i].delta = Abs((stbox_union_size_nonan(left, box) - leftsize) -
+        (stbox_union_size_nonan(right, box) - rightsize));
+    else
+      entries[i].delta = Abs(stbox_penalty(left, box) -
+        stbox_penalty(right, box));
+  }
+  return;
+}
 
 PG_FUNCTION_INFO_V1(stbox_gist_penalty);
 /**
@@ -682,6 +852,56 @@ stbox_gist_consider_split(ConsiderSplitContext *context, int dimNum,
   return;
 }
 
+/**
+ * R*-tree split for temporal points. The missing dimensions of the boxes
+ * have the same value in all the entries and thus they are not taken into
+ * account for choosing the split.
+ */
+static void
+stbox_gist_rstar_split(GistEntryVector *entryvec, GIST_SPLITVEC *v)
+{
+  OffsetNumber i, maxoff = (OffsetNumber) (entryvec->n - 1);
+  int nentries = maxoff - FirstOffsetNumber + 1, k;
+  double *bounds = palloc(sizeof(double) * nentries * 8);
+  bool *left = palloc(sizeof(bool) * nentries);
+  STBOX *leftBox = NULL, *rightBox = NULL;
+
+  for (i = FirstOffsetNumber, k = 0; i <= maxoff; i = OffsetNumberNext(i), k++)
+  {
+    STBOX *box = DatumGetSTboxP(entryvec->vector[i].key);
+    bounds[k * 8] = box->xmin;
+    bounds[k * 8 + 1] = box->xmax;
+    bounds[k * 8 + 2] = box->ymin;
+    bounds[k * 8 + 3] = box->ymax;
+    bounds[k * 8 + 4] = box->zmin;
+    bounds[k * 8 + 5] = box->zmax;
+    bounds[k * 8 + 6] = (double) box->tmin;
+    bounds[k * 8 + 7] = (double) box->tmax;
+  }
+  gist_rstar_split(bounds, nentries, 4, left);
+
+  v->spl_left = (OffsetNumber *) palloc(nentries * sizeof(OffsetNumber));
+  v->spl_right = (OffsetNumber *) palloc(nentries * sizeof(OffsetNumber));
+  v->spl_nleft = v->spl_nright = 0;
+  for (i = FirstOffsetNumber, k = 0; i <= maxoff; i = OffsetNumberNext(i), k++)
+  {
+    STBOX *box = DatumGetSTboxP(entryvec->vector[i].key);
+    STBOX **groupBox = left[k] ? &leftBox : &rightBox;
+    if (*groupBox == NULL)
+      *groupBox = stbox_copy(box);
+    else
+      stbox_adjust(*groupBox, box);
+    if (left[k])
+      v->spl_left[v->spl_nleft++] = i;
+    else
+      v->spl_right[v->spl_nright++] = i;
+  }
+  v->spl_ldatum = PointerGetDatum(leftBox);
+  v->spl_rdatum = PointerGetDatum(rightBox);
+  pfree(bounds); pfree(left);
+  return;
+}
+
 PG_FUNCTION_INFO_V1(stbox_gist_picksplit);
 /**
  * GiST picksplit method for temporal points.
@@ -726,6 +946,15 @@ stbox_gist_picksplit(PG_FUNCTION_ARGS)
         *intervalsUpper;
   CommonEntry *commonEntries;
   
+  if (box_gist_split_strategy(fcinfo) == BOX_GIST_SPLIT_RSTAR)
+  {
+    stbox_gist_rstar_split(entryvec, v);
+    TRACE_MOBILITYDB_GIST_PICKSPLIT_DONE(GIST_STAT_STBOX, v->spl_nleft,
+      v->spl_nright);
+    PG_RETURN_POINTER(v);
+  }
+
+  TRACE_MOBILITYDB_GIST_PICKSPLIT_START(GIST_STAT_STBOX, entryvec->n - 1);
   memset(&context, 0, sizeof(ConsiderSplitContext));
   
   maxoff = (OffsetNumber) (entryvec->n - 1);
@@ -738,14 +967,8 @@ stbox_gist_picksplit(PG_FUNCTION_ARGS)
   /*
    * Calculate the overall minimum bounding box over all the entries.
    */
-  for (i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext(i))
-  {
-    box = (STBOX *)DatumGetPointer(entryvec->vector[i].key);
-    if (i == FirstOffsetNumber)
-      context.boundingBox = *box;
-    else
-      stbox_adjust(&context.boundingBox, box);
-  }
+  stbox_union_vector(&context.boundingBox, entryvec, FirstOffsetNumber,
+    maxoff);
 
   /* Determine whether there is a Z dimension */
   box = (STBOX *)DatumGetPointer(entryvec->vector[FirstOffsetNumber].key);
@@ -915,6 +1138,8 @@ stbox_gist_picksplit(PG_FUNCTION_ARGS)
   if (context.first)
   {
     stbox_gist_fallback_split(entryvec, v);
+    TRACE_MOBILITYDB_GIST_PICKSPLIT_DONE(GIST_STAT_STBOX, v->spl_nleft,
+      v->spl_nright);
     PG_RETURN_POINTER(v);
   }
   
@@ -1039,12 +1264,8 @@ stbox_gist_picksplit(PG_FUNCTION_ARGS)
      * Calculate delta between penalties of join "common entries" to
      * different groups.
      */
-    for (i = 0; i < commonEntriesCount; i++)
-    {
-      box = (STBOX *)DatumGetPointer(entryvec->vector[commonEntries[i].index].key);
-      commonEntries[i].delta = Abs(stbox_penalty(leftBox, box) -
-                     stbox_penalty(rightBox, box));
-    }
+    stbox_common_deltas(leftBox, rightBox, entryvec, commonEntries,
+      commonEntriesCount);
     
     /*
      * Sort "common entries" by calculated deltas in order to distribute
@@ -1080,6 +1301,8 @@ stbox_gist_picksplit(PG_FUNCTION_ARGS)
   
   v->spl_ldatum = PointerGetDatum(leftBox);
   v->spl_rdatum = PointerGetDatum(rightBox);
+  TRACE_MOBILITYDB_GIST_PICKSPLIT_DONE(GIST_STAT_STBOX, v->spl_nleft,
+    v->spl_nright);
   PG_RETURN_POINTER(v);
 }
 
@@ -1115,6 +1338,23 @@ stbox_gist_same(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * GiST fetch method
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(stbox_gist_fetch);
+/**
+ * GiST fetch method for spatiotemporal boxes. Since the keys of the index are
+ * the boxes themselves, they are returned unchanged, which enables
+ * index-only scans.
+ */
+PGDLLEXPORT Datum
+stbox_gist_fetch(PG_FUNCTION_ARGS)
+{
+  GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  PG_RETURN_POINTER(entry);
+}
+
 /*****************************************************************************
  * GiST distance method
  *****************************************************************************/
@@ -1128,6 +1368,7 @@ Datum
 stbox_gist_distance(PG_FUNCTION_ARGS)
 {
   GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
   Oid subtype = PG_GETARG_OID(3);
   bool *recheck = (bool *) PG_GETARG_POINTER(4);
   STBOX *key = (STBOX *) DatumGetPointer(entry->key);
@@ -1141,40 +1382,862 @@ stbox_gist_distance(PG_FUNCTION_ARGS)
   if (key == NULL)
     PG_RETURN_FLOAT8(DBL_MAX);
 
-  /*
-   * Transform the query into a box initializing the dimensions that must
-   * not be taken into account by the operators to infinity.
-   */
-  memset(&query, 0, sizeof(STBOX));
-  if (tgeo_base_type(subtype))
+  /* The similarity distances are bounded by the distances of the points of
+   * the query to the box */
+  if (tpoint_similarity_strategy(strategy))
+    PG_RETURN_FLOAT8(tpoint_similarity_index_distance(fcinfo, key, 1,
+      strategy));
+
+  /* Transform the query into a box */
+  if (!tpoint_index_query_box(PG_GETARG_DATUM(1), subtype, &query))
+    PG_RETURN_FLOAT8(DBL_MAX);
+
+  /* Since we only have boxes we'll return the minimum possible distance,
+   * and let the recheck sort things out in the case of leaves */
+  distance = stbox_index_distance(key, &query);
+
+  PG_RETURN_FLOAT8(distance);
+}
+
+
+#if MOBDB_PGSQL_VERSION >= 140000
+/*****************************************************************************
+ * GiST sortsupport method
+ *****************************************************************************/
+
+/**
+ * Computes the keys of the center of a spatiotemporal box for sorting it
+ * along a Z-order curve
+ */
+static void
+stbox_zorder_keys(uint64 *keys, const STBOX *box)
+{
+  keys[0] = double_zorder_key(box->xmin / 2.0 + box->xmax / 2.0);
+  keys[1] = double_zorder_key(box->ymin / 2.0 + box->ymax / 2.0);
+  keys[2] = double_zorder_key(box->zmin / 2.0 + box->zmax / 2.0);
+  /* Halving the bounds avoids overflows with infinite timestamps */
+  keys[3] = timestamp_zorder_key((box->tmin >> 1) + (box->tmax >> 1));
+  return;
+}
+
+/**
+ * Compares the centers of two spatiotemporal boxes along a Z-order curve
+ */
+static int
+stbox_gist_cmp_zorder(Datum a, Datum b, SortSupport ssup)
+{
+  uint64 keys1[4], keys2[4];
+  stbox_zorder_keys(keys1, DatumGetSTboxP(a));
+  stbox_zorder_keys(keys2, DatumGetSTboxP(b));
+  return zorder_cmp(keys1, keys2, 4);
+}
+
+PG_FUNCTION_INFO_V1(stbox_gist_sortsupport);
+/**
+ * GiST sortsupport method for temporal points. It is used for building
+ * the index by sorting the boxes along a Z-order curve instead of inserting
+ * them one by one.
+ */
+PGDLLEXPORT Datum
+stbox_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+  SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+  ssup->comparator = stbox_gist_cmp_zorder;
+  PG_RETURN_VOID();
+}
+#endif
+
+/*****************************************************************************
+ * Multi-box GiST methods
+ *
+ * A single bounding box is a crude approximation of a long trajectory that
+ * changes direction, since most of its volume is empty. The operator class
+ * gist_tgeompoint_multi_ops stores in the leaf entries, together with the
+ * bounding box, up to TPOINT_GIST_MAXBOXES tighter boxes, each one covering
+ * a run of consecutive segments of the temporal point. The overlaps strategy
+ * filters the leaf entries with these boxes, while the other strategies and
+ * the internal entries use the bounding box.
+ *****************************************************************************/
+
+/**
+ * Maximum number of boxes kept in a leaf entry
+ */
+#define TPOINT_GIST_MAXBOXES 8
+
+/**
+ * Structure of the keys of the multi-box operator class. The header is 
+ * followed by the bounding box and then by count boxes. Internal entries
+ * have a count of 0.
+ */
+typedef struct
+{
+  int32 vl_len_;     /**< varlena header (do not touch directly!) */
+  int32 count;       /**< number of boxes after the bounding box */
+} MultiSTBOX;
+
+/* Keys coming from the index are not aligned, the boxes are thus copied */
+#define MULTISTBOX_BOX_PTR(key, n) \
+  ((char *)(key) + sizeof(MultiSTBOX) + (n) * sizeof(STBOX))
+#define MULTISTBOX_SIZE(count) \
+  (sizeof(MultiSTBOX) + ((count) + 1) * sizeof(STBOX))
+
+/**
+ * Returns a key of the multi-box operator class
+ *
+ * @param[in] bbox Bounding box
+ * @param[in] boxes Array of boxes, may be NULL if count is 0
+ * @param[in] count Number of elements in the array
+ */
+static MultiSTBOX *
+multistbox_make(const STBOX *bbox, const STBOX *boxes, int count)
+{
+  size_t size = MULTISTBOX_SIZE(count);
+  MultiSTBOX *result = palloc0(size);
+  SET_VARSIZE(result, size);
+  result->count = count;
+  memcpy(MULTISTBOX_BOX_PTR(result, 0), bbox, sizeof(STBOX));
+  if (count > 0)
+    memcpy(MULTISTBOX_BOX_PTR(result, 1), boxes, count * sizeof(STBOX));
+  return result;
+}
+
+/**
+ * Copies the n-th box of the key, where the box 0 is the bounding box
+ */
+static void
+multistbox_box_n(STBOX *box, const MultiSTBOX *key, int n)
+{
+  memcpy(box, MULTISTBOX_BOX_PTR(key, n), sizeof(STBOX));
+  return;
+}
+
+/**
+ * Expands the box of the group with the box of the instant
+ */
+static void
+multistbox_group_add(STBOX *boxes, bool *init, int group, const TInstant *inst)
+{
+  STBOX box;
+  memset(&box, 0, sizeof(STBOX));
+  tpointinst_make_stbox(&box, inst);
+  if (init[group])
+    stbox_adjust(&boxes[group], &box);
+  else
   {
-    /* Since function stbox_gist_consistent is strict, query is not NULL */
-    if (!geo_to_stbox_internal(&query, PG_GETARG_GSERIALIZED_P(1)))
-      PG_RETURN_FLOAT8(DBL_MAX);
+    memcpy(&boxes[group], &box, sizeof(STBOX));
+    init[group] = true;
   }
-  else if (subtype == type_oid(T_STBOX))
+  return;
+}
+
+/**
+ * Computes the boxes of the groups of consecutive elements of the temporal
+ * point, where the elements are the instants of an instant set and the 
+ * segments of a sequence (set)
+ *
+ * @param[out] boxes Array of boxes of size TPOINT_GIST_MAXBOXES
+ * @param[in] temp Temporal point
+ * @return Number of boxes, 0 if a single box would be equal to the
+ * bounding box
+ */
+static int
+tpoint_gist_boxes(STBOX *boxes, const Temporal *temp)
+{
+  int count, ngroups, i, j, k;
+  bool init[TPOINT_GIST_MAXBOXES];
+
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+    return 0;
+  /* Count the elements */
+  if (temp->duration == INSTANTSET)
+    count = ((TInstantSet *) temp)->count;
+  else if (temp->duration == SEQUENCE)
+    count = Max(((TSequence *) temp)->count - 1, 1);
+  else /* temp->duration == SEQUENCESET */
   {
-    STBOX *box = PG_GETARG_STBOX_P(1);
-    if (box == NULL)
-      PG_RETURN_FLOAT8(DBL_MAX);
-    memcpy(&query, box, sizeof(STBOX));
+    const TSequenceSet *ts = (const TSequenceSet *) temp;
+    count = 0;
+    for (i = 0; i < ts->count; i++)
+      count += Max(tsequenceset_seq_n(ts, i)->count - 1, 1);
   }
-  else if (tgeo_type(subtype))
+  ngroups = Min(count, TPOINT_GIST_MAXBOXES);
+  if (ngroups <= 1)
+    return 0;
+
+  /* Element k is added to the group k * ngroups / count */
+  memset(init, 0, sizeof(init));
+  if (temp->duration == INSTANTSET)
   {
-    Temporal *temp = PG_GETARG_TEMPORAL(1);
-    if (temp == NULL)
-      PG_RETURN_FLOAT8(DBL_MAX);
-    temporal_bbox(&query, temp);
-    PG_FREE_IF_COPY(temp, 1);
+    const TInstantSet *ti = (const TInstantSet *) temp;
+    for (k = 0; k < ti->count; k++)
+      multistbox_group_add(boxes, init, k * ngroups / count,
+        tinstantset_inst_n(ti, k));
   }
   else
-    elog(ERROR, "Unsupported subtype for indexing: %d", subtype);
+  {
+    const TSequenceSet *ts = (temp->duration == SEQUENCESET) ?
+      (const TSequenceSet *) temp : NULL;
+    int nseqs = (ts == NULL) ? 1 : ts->count;
+    k = 0;
+    for (i = 0; i < nseqs; i++)
+    {
+      const TSequence *seq = (ts == NULL) ?
+        (const TSequence *) temp : tsequenceset_seq_n(ts, i);
+      if (seq->count == 1)
+      {
+        multistbox_group_add(boxes, init, k++ * ngroups / count,
+          tsequence_inst_n(seq, 0));
+        continue;
+      }
+      for (j = 0; j < seq->count - 1; j++)
+      {
+        int group = k++ * ngroups / count;
+        multistbox_group_add(boxes, init, group, tsequence_inst_n(seq, j));
+        multistbox_group_add(boxes, init, group, tsequence_inst_n(seq, j + 1));
+      }
+    }
+  }
+  return ngroups;
+}
 
-  /* Since we only have boxes we'll return the minimum possible distance,
-   * and let the recheck sort things out in the case of leaves */
-  distance = NAD_stbox_stbox_internal(key, &query);
+PG_FUNCTION_INFO_V1(tpoint_gist_multi_compress);
+/**
+ * GiST compress method for the multi-box operator class of temporal points
+ */
+PGDLLEXPORT Datum
+tpoint_gist_multi_compress(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  if (entry->leafkey)
+  {
+    GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+    Temporal *temp = DatumGetTemporal(entry->key);
+    STBOX bbox, boxes[TPOINT_GIST_MAXBOXES];
+    memset(&bbox, 0, sizeof(STBOX));
+    temporal_bbox(&bbox, temp);
+    int count = tpoint_gist_boxes(boxes, temp);
+    MultiSTBOX *key = multistbox_make(&bbox, boxes, count);
+    gistentryinit(*retval, PointerGetDatum(key), entry->rel, entry->page,
+      entry->offset, false);
+    PG_RETURN_POINTER(retval);
+  }
+  PG_RETURN_POINTER(entry);
+}
 
-  PG_RETURN_FLOAT8(distance);
+PG_FUNCTION_INFO_V1(tpoint_gist_multi_consistent);
+/**
+ * GiST consistent method for the multi-box operator class of temporal points
+ */
+PGDLLEXPORT Datum
+tpoint_gist_multi_consistent(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+  Oid subtype = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4), result;
+  MultiSTBOX *key;
+  STBOX query, box;
+
+  /* Determine whether the index is lossy depending on the strategy */
+  *recheck = tpoint_index_recheck(strategy);
+
+  if (DatumGetPointer(entry->key) == NULL)
+    PG_RETURN_BOOL(false);
+
+  /* Transform the query into a box */
+  if (!tpoint_index_query_box(PG_GETARG_DATUM(1), subtype, &query))
+    PG_RETURN_BOOL(false);
+
+  key = (MultiSTBOX *) PG_DETOAST_DATUM(entry->key);
+  multistbox_box_n(&box, key, 0);
+  if (! GIST_LEAF(entry))
+    PG_RETURN_BOOL(stbox_gist_consistent_internal(&box, &query, strategy));
+
+  result = stbox_index_consistent_leaf(&box, &query, strategy);
+  if (result && strategy == RTOverlapStrategyNumber && key->count > 0)
+  {
+    result = false;
+    for (int i = 1; i <= key->count && ! result; i++)
+    {
+      multistbox_box_n(&box, key, i);
+      result = overlaps_stbox_stbox_internal(&box, &query);
+    }
+  }
+  PG_RETURN_BOOL(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_multi_union);
+/**
+ * GiST union method for the multi-box operator class of temporal points
+ *
+ * Returns the minimal bounding box that encloses all the entries in entryvec
+ */
+PGDLLEXPORT Datum
+tpoint_gist_multi_union(PG_FUNCTION_ARGS)
+{
+  GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+  int *sizep = (int *) PG_GETARG_POINTER(1);
+  MultiSTBOX *result;
+  STBOX pageunion, box;
+
+  multistbox_box_n(&pageunion,
+    (MultiSTBOX *) PG_DETOAST_DATUM(entryvec->vector[0].key), 0);
+  for (int i = 1; i < entryvec->n; i++)
+  {
+    multistbox_box_n(&box,
+      (MultiSTBOX *) PG_DETOAST_DATUM(entryvec->vector[i].key), 0);
+    stbox_adjust(&pageunion, &box);
+  }
+  result = multistbox_make(&pageunion, NULL, 0);
+  *sizep = VARSIZE(result);
+  PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_multi_penalty);
+/**
+ * GiST penalty method for the multi-box operator class of temporal points
+ *
+ * As in the R-tree paper, we use change in area as our penalty metric
+ */
+PGDLLEXPORT Datum
+tpoint_gist_multi_penalty(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *origentry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  GISTENTRY *newentry = (GISTENTRY *) PG_GETARG_POINTER(1);
+  float *result = (float *) PG_GETARG_POINTER(2);
+  STBOX origbox, newbox;
+
+  multistbox_box_n(&origbox, (MultiSTBOX *) PG_DETOAST_DATUM(origentry->key), 0);
+  multistbox_box_n(&newbox, (MultiSTBOX *) PG_DETOAST_DATUM(newentry->key), 0);
+  *result = (float) stbox_penalty(&origbox, &newbox);
+  PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_multi_picksplit);
+/**
+ * GiST picksplit method for the multi-box operator class of temporal points
+ *
+ * The split is computed on the bounding boxes of the entries by the
+ * double sorting algorithm of the stbox_gist_picksplit function
+ */
+PGDLLEXPORT Datum
+tpoint_gist_multi_picksplit(PG_FUNCTION_ARGS)
+{
+  GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+  GIST_SPLITVEC *v = (GIST_SPLITVEC *) PG_GETARG_POINTER(1);
+  GistEntryVector *boxvec = palloc(GEVHDRSZ + entryvec->n * sizeof(GISTENTRY));
+  STBOX *boxes = palloc0(entryvec->n * sizeof(STBOX));
+  OffsetNumber i;
+
+  boxvec->n = entryvec->n;
+  for (i = FirstOffsetNumber; i < entryvec->n; i = OffsetNumberNext(i))
+  {
+    GISTENTRY *entry = &entryvec->vector[i];
+    multistbox_box_n(&boxes[i], (MultiSTBOX *) PG_DETOAST_DATUM(entry->key), 0);
+    gistentryinit(boxvec->vector[i], PointerGetDatum(&boxes[i]), entry->rel,
+      entry->page, entry->offset, false);
+  }
+  DirectFunctionCall2(stbox_gist_picksplit, PointerGetDatum(boxvec),
+    PointerGetDatum(v));
+  v->spl_ldatum = PointerGetDatum(multistbox_make(
+    (STBOX *) DatumGetPointer(v->spl_ldatum), NULL, 0));
+  v->spl_rdatum = PointerGetDatum(multistbox_make(
+    (STBOX *) DatumGetPointer(v->spl_rdatum), NULL, 0));
+  pfree(boxes); pfree(boxvec);
+  PG_RETURN_POINTER(v);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_multi_same);
+/**
+ * GiST same method for the multi-box operator class of temporal points
+ *
+ * Returns true only when the keys are exactly the same
+ */
+PGDLLEXPORT Datum
+tpoint_gist_multi_same(PG_FUNCTION_ARGS)
+{
+  MultiSTBOX *key1 = (MultiSTBOX *) PG_DETOAST_DATUM(PG_GETARG_DATUM(0));
+  MultiSTBOX *key2 = (MultiSTBOX *) PG_DETOAST_DATUM(PG_GETARG_DATUM(1));
+  bool *result = (bool *) PG_GETARG_POINTER(2);
+  *result = VARSIZE(key1) == VARSIZE(key2) &&
+    memcmp(key1, key2, VARSIZE(key1)) == 0;
+  PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_multi_distance);
+/**
+ * GiST distance method for the multi-box operator class of temporal points
+ *
+ * The distance of a leaf entry is the minimum distance to its boxes
+ */
+PGDLLEXPORT Datum
+tpoint_gist_multi_distance(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+  Oid subtype = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4);
+  MultiSTBOX *key;
+  STBOX query, box;
+  double distance;
+
+  /* The index is lossy for leaf levels */
+  if (GIST_LEAF(entry))
+    *recheck = true;
+
+  if (DatumGetPointer(entry->key) == NULL)
+    PG_RETURN_FLOAT8(DBL_MAX);
+
+  /* The similarity distances of a leaf entry are bounded by the distances
+   * of the points of the query to the nearest box of the segments */
+  if (tpoint_similarity_strategy(strategy))
+  {
+    STBOX boxes[TPOINT_GIST_MAXBOXES];
+    int count = 1;
+    key = (MultiSTBOX *) PG_DETOAST_DATUM(entry->key);
+    if (GIST_LEAF(entry) && key->count > 0)
+    {
+      count = key->count;
+      for (int i = 0; i < count; i++)
+        multistbox_box_n(&boxes[i], key, i + 1);
+    }
+    else
+      multistbox_box_n(&boxes[0], key, 0);
+    PG_RETURN_FLOAT8(tpoint_similarity_index_distance(fcinfo, boxes, count,
+      strategy));
+  }
+
+  /* Transform the query into a box */
+  if (!tpoint_index_query_box(PG_GETARG_DATUM(1), subtype, &query))
+    PG_RETURN_FLOAT8(DBL_MAX);
+
+  key = (MultiSTBOX *) PG_DETOAST_DATUM(entry->key);
+  multistbox_box_n(&box, key, 0);
+  distance = stbox_index_distance(&box, &query);
+  if (GIST_LEAF(entry) && key->count > 0)
+  {
+    distance = DBL_MAX;
+    for (int i = 1; i <= key->count; i++)
+    {
+      multistbox_box_n(&box, key, i);
+      distance = Min(distance, stbox_index_distance(&box, &query));
+    }
+  }
+  PG_RETURN_FLOAT8(distance);
+}
+
+
+/*****************************************************************************
+ * Compact GiST methods
+ *
+ * The operator class gist_tgeompoint_compact_ops stores the boxes in the
+ * entries with float4 coordinates and with int32 timestamps in seconds
+ * since the PostgreSQL epoch, which is about half the size of an STBOX.
+ * The coordinates and the timestamps are rounded outward, so that the box
+ * of a key contains the box of every value below it. All the entries are
+ * thus handled as internal entries by the consistent method and the
+ * results are always rechecked.
+ *****************************************************************************/
+
+/**
+ * Structure of the keys of the compact operator class
+ */
+typedef struct
+{
+  int32 vl_len_;     /**< varlena header (do not touch directly!) */
+  float4 xmin;       /**< minimum x value rounded downward */
+  float4 xmax;       /**< maximum x value rounded upward */
+  float4 ymin;       /**< minimum y value rounded downward */
+  float4 ymax;       /**< maximum y value rounded upward */
+  float4 zmin;       /**< minimum z value rounded downward */
+  float4 zmax;       /**< maximum z value rounded upward */
+  int32 tmin;        /**< minimum timestamp in seconds rounded downward */
+  int32 tmax;        /**< maximum timestamp in seconds rounded upward */
+  int16 flags;       /**< flags of the box */
+} CompactSTBOX;
+
+#define COMPACTSTBOX_SIZE (offsetof(CompactSTBOX, flags) + sizeof(int16))
+
+/**
+ * Returns the coordinate rounded to a float4 downward or upward
+ */
+static float4
+compactstbox_coord(double d, bool upper)
+{
+  float4 result = (float4) d;
+  if (upper && (double) result < d)
+    result = nextafterf(result, get_float4_infinity());
+  else if (! upper && (double) result > d)
+    result = nextafterf(result, -get_float4_infinity());
+  return result;
+}
+
+/**
+ * Returns the timestamp rounded to seconds downward or upward, where the
+ * timestamps out of the range of an int32 are mapped to the extreme values
+ */
+static int32
+compactstbox_time(TimestampTz t, bool upper)
+{
+  TimestampTz secs = t / USECS_PER_SEC;
+  if (upper && secs * USECS_PER_SEC < t)
+    secs++;
+  else if (! upper && secs * USECS_PER_SEC > t)
+    secs--;
+  if (secs <= PG_INT32_MIN)
+    return PG_INT32_MIN;
+  if (secs >= PG_INT32_MAX)
+    return PG_INT32_MAX;
+  return (int32) secs;
+}
+
+/**
+ * Returns the key of the compact operator class containing the box
+ */
+static CompactSTBOX *
+compactstbox_make(const STBOX *box)
+{
+  CompactSTBOX *result = palloc0(COMPACTSTBOX_SIZE);
+  SET_VARSIZE(result, COMPACTSTBOX_SIZE);
+  result->xmin = compactstbox_coord(box->xmin, false);
+  result->xmax = compactstbox_coord(box->xmax, true);
+  result->ymin = compactstbox_coord(box->ymin, false);
+  result->ymax = compactstbox_coord(box->ymax, true);
+  result->zmin = compactstbox_coord(box->zmin, false);
+  result->zmax = compactstbox_coord(box->zmax, true);
+  result->tmin = compactstbox_time(box->tmin, false);
+  result->tmax = compactstbox_time(box->tmax, true);
+  result->flags = box->flags;
+  return result;
+}
+
+/**
+ * Returns in the box the box of the key, where the extreme timestamps are
+ * mapped to minus and plus infinity
+ */
+static void
+compactstbox_box(STBOX *box, const CompactSTBOX *key)
+{
+  memset(box, 0, sizeof(STBOX));
+  box->xmin = key->xmin;
+  box->xmax = key->xmax;
+  box->ymin = key->ymin;
+  box->ymax = key->ymax;
+  box->zmin = key->zmin;
+  box->zmax = key->zmax;
+  box->tmin = (key->tmin == PG_INT32_MIN) ? DT_NOBEGIN :
+    (TimestampTz) key->tmin * USECS_PER_SEC;
+  box->tmax = (key->tmax == PG_INT32_MAX) ? DT_NOEND :
+    (TimestampTz) key->tmax * USECS_PER_SEC;
+  box->flags = key->flags;
+  return;
+}
+
+/**
+ * Returns in the box the box of the key of the entry
+ */
+static void
+compactstbox_entry_box(STBOX *box, const GISTENTRY *entry)
+{
+  compactstbox_box(box, (CompactSTBOX *) PG_DETOAST_DATUM(entry->key));
+  return;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_compact_compress);
+/**
+ * GiST compress method for the compact operator class of temporal points
+ */
+PGDLLEXPORT Datum
+tpoint_gist_compact_compress(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  if (entry->leafkey)
+  {
+    GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+    STBOX box;
+    memset(&box, 0, sizeof(STBOX));
+    temporal_bbox_slice(&box, entry->key);
+    gistentryinit(*retval, PointerGetDatum(compactstbox_make(&box)),
+      entry->rel, entry->page, entry->offset, false);
+    PG_RETURN_POINTER(retval);
+  }
+  PG_RETURN_POINTER(entry);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_compact_consistent);
+/**
+ * GiST consistent method for the compact operator class of temporal points
+ */
+PGDLLEXPORT Datum
+tpoint_gist_compact_consistent(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+  Oid subtype = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4);
+  STBOX query, box;
+
+  /* The keys are larger than the boxes of the values */
+  *recheck = true;
+
+  if (DatumGetPointer(entry->key) == NULL)
+    PG_RETURN_BOOL(false);
+
+  /* Transform the query into a box */
+  if (!tpoint_index_query_box(PG_GETARG_DATUM(1), subtype, &query))
+    PG_RETURN_BOOL(false);
+
+  compactstbox_entry_box(&box, entry);
+  PG_RETURN_BOOL(stbox_gist_consistent_internal(&box, &query, strategy));
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_compact_union);
+/**
+ * GiST union method for the compact operator class of temporal points
+ *
+ * Returns the minimal key that encloses all the entries in entryvec
+ */
+PGDLLEXPORT Datum
+tpoint_gist_compact_union(PG_FUNCTION_ARGS)
+{
+  GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+  int *sizep = (int *) PG_GETARG_POINTER(1);
+  STBOX pageunion, box;
+
+  compactstbox_entry_box(&pageunion, &entryvec->vector[0]);
+  for (int i = 1; i < entryvec->n; i++)
+  {
+    compactstbox_entry_box(&box, &entryvec->vector[i]);
+    stbox_adjust(&pageunion, &box);
+  }
+  *sizep = COMPACTSTBOX_SIZE;
+  PG_RETURN_POINTER(compactstbox_make(&pageunion));
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_compact_penalty);
+/**
+ * GiST penalty method for the compact operator class of temporal points
+ *
+ * As in the R-tree paper, we use change in area as our penalty metric
+ */
+PGDLLEXPORT Datum
+tpoint_gist_compact_penalty(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *origentry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  GISTENTRY *newentry = (GISTENTRY *) PG_GETARG_POINTER(1);
+  float *result = (float *) PG_GETARG_POINTER(2);
+  STBOX origbox, newbox;
+
+  compactstbox_entry_box(&origbox, origentry);
+  compactstbox_entry_box(&newbox, newentry);
+  *result = (float) stbox_penalty(&origbox, &newbox);
+  PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_compact_picksplit);
+/**
+ * GiST picksplit method for the compact operator class of temporal points
+ *
+ * The split is computed on the boxes of the keys by the double sorting
+ * algorithm of the stbox_gist_picksplit function
+ */
+PGDLLEXPORT Datum
+tpoint_gist_compact_picksplit(PG_FUNCTION_ARGS)
+{
+  GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+  GIST_SPLITVEC *v = (GIST_SPLITVEC *) PG_GETARG_POINTER(1);
+  GistEntryVector *boxvec = palloc(GEVHDRSZ + entryvec->n * sizeof(GISTENTRY));
+  STBOX *boxes = palloc0(entryvec->n * sizeof(STBOX));
+  OffsetNumber i;
+
+  boxvec->n = entryvec->n;
+  for (i = FirstOffsetNumber; i < entryvec->n; i = OffsetNumberNext(i))
+  {
+    GISTENTRY *entry = &entryvec->vector[i];
+    compactstbox_entry_box(&boxes[i], entry);
+    gistentryinit(boxvec->vector[i], PointerGetDatum(&boxes[i]), entry->rel,
+      entry->page, entry->offset, false);
+  }
+  DirectFunctionCall2(stbox_gist_picksplit, PointerGetDatum(boxvec),
+    PointerGetDatum(v));
+  v->spl_ldatum = PointerGetDatum(compactstbox_make(
+    (STBOX *) DatumGetPointer(v->spl_ldatum)));
+  v->spl_rdatum = PointerGetDatum(compactstbox_make(
+    (STBOX *) DatumGetPointer(v->spl_rdatum)));
+  pfree(boxes); pfree(boxvec);
+  PG_RETURN_POINTER(v);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_compact_same);
+/**
+ * GiST same method for the compact operator class of temporal points
+ *
+ * Returns true only when the keys are exactly the same
+ */
+PGDLLEXPORT Datum
+tpoint_gist_compact_same(PG_FUNCTION_ARGS)
+{
+  CompactSTBOX *key1 = (CompactSTBOX *) PG_DETOAST_DATUM(PG_GETARG_DATUM(0));
+  CompactSTBOX *key2 = (CompactSTBOX *) PG_DETOAST_DATUM(PG_GETARG_DATUM(1));
+  bool *result = (bool *) PG_GETARG_POINTER(2);
+  *result = memcmp(key1, key2, COMPACTSTBOX_SIZE) == 0;
+  PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_gist_compact_distance);
+/**
+ * GiST distance method for the compact operator class of temporal points
+ *
+ * The distance to the box of a leaf entry is a lower bound of the distance
+ * to the value, which is thus rechecked
+ */
+PGDLLEXPORT Datum
+tpoint_gist_compact_distance(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  Oid subtype = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4);
+  STBOX query, box;
+
+  /* The index is lossy for leaf levels */
+  if (GIST_LEAF(entry))
+    *recheck = true;
+
+  if (DatumGetPointer(entry->key) == NULL)
+    PG_RETURN_FLOAT8(DBL_MAX);
+
+  /* Transform the query into a box */
+  if (!tpoint_index_query_box(PG_GETARG_DATUM(1), subtype, &query))
+    PG_RETURN_FLOAT8(DBL_MAX);
+
+  compactstbox_entry_box(&box, entry);
+  PG_RETURN_FLOAT8(stbox_index_distance(&box, &query));
+}
+
+
+/*****************************************************************************
+ * BRIN methods
+ *
+ * The summary of a block range is the union of the bounding boxes of its
+ * values. Since this union plays the same role as the key of an internal
+ * node of a GiST index, the consistent method reuses the GiST internal-page
+ * consistency.
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(stbox_brin_opcinfo);
+/**
+ * BRIN opcinfo method for temporal points and spatiotemporal boxes
+ */
+PGDLLEXPORT Datum
+stbox_brin_opcinfo(PG_FUNCTION_ARGS)
+{
+  BrinOpcInfo *result = palloc0(MAXALIGN(SizeofBrinOpcInfo(1)));
+  result->oi_nstored = 1;
+  result->oi_typcache[0] = lookup_type_cache(type_oid(T_STBOX), 0);
+  PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(stbox_brin_add_value);
+/**
+ * BRIN add value method for temporal points and spatiotemporal boxes
+ */
+PGDLLEXPORT Datum
+stbox_brin_add_value(PG_FUNCTION_ARGS)
+{
+  BrinDesc *bdesc = (BrinDesc *) PG_GETARG_POINTER(0);
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  Datum newval = PG_GETARG_DATUM(2);
+  bool isnull = PG_GETARG_BOOL(3);
+  Oid typid = TupleDescAttr(bdesc->bd_tupdesc, column->bv_attno - 1)->atttypid;
+  STBOX box, *unionbox;
+
+  if (isnull)
+  {
+    if (column->bv_hasnulls)
+      PG_RETURN_BOOL(false);
+    column->bv_hasnulls = true;
+    PG_RETURN_BOOL(true);
+  }
+
+  memset(&box, 0, sizeof(STBOX));
+  if (typid == type_oid(T_STBOX))
+    memcpy(&box, DatumGetSTboxP(newval), sizeof(STBOX));
+  else
+    temporal_bbox_slice(&box, newval);
+
+  if (column->bv_allnulls)
+  {
+    column->bv_values[0] = datumCopy(PointerGetDatum(&box), false,
+      sizeof(STBOX));
+    column->bv_allnulls = false;
+    PG_RETURN_BOOL(true);
+  }
+  unionbox = DatumGetSTboxP(column->bv_values[0]);
+  if (contains_stbox_stbox_internal(unionbox, &box))
+    PG_RETURN_BOOL(false);
+  stbox_adjust(unionbox, &box);
+  PG_RETURN_BOOL(true);
+}
+
+PG_FUNCTION_INFO_V1(stbox_brin_consistent);
+/**
+ * BRIN consistent method for temporal points and spatiotemporal boxes
+ */
+PGDLLEXPORT Datum
+stbox_brin_consistent(PG_FUNCTION_ARGS)
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  ScanKey key = (ScanKey) PG_GETARG_POINTER(2);
+  STBOX query;
+
+  /* Handle IS NULL/IS NOT NULL tests */
+  if (key->sk_flags & SK_ISNULL)
+  {
+    if (key->sk_flags & SK_SEARCHNULL)
+      PG_RETURN_BOOL(column->bv_allnulls || column->bv_hasnulls);
+    if (key->sk_flags & SK_SEARCHNOTNULL)
+      PG_RETURN_BOOL(! column->bv_allnulls);
+    /* Neither IS NULL nor IS NOT NULL was used, the operators are strict */
+    PG_RETURN_BOOL(false);
+  }
+
+  /* If the block range contains only nulls, it cannot contain any match */
+  if (column->bv_allnulls)
+    PG_RETURN_BOOL(false);
+
+  /* Transform the query into a box */
+  if (! tpoint_index_query_box(key->sk_argument, key->sk_subtype, &query))
+    PG_RETURN_BOOL(false);
+
+  PG_RETURN_BOOL(stbox_gist_consistent_internal(
+    DatumGetSTboxP(column->bv_values[0]), &query, key->sk_strategy));
+}
+
+PG_FUNCTION_INFO_V1(stbox_brin_union);
+/**
+ * BRIN union method for temporal points and spatiotemporal boxes
+ */
+PGDLLEXPORT Datum
+stbox_brin_union(PG_FUNCTION_ARGS)
+{
+  BrinValues *col_a = (BrinValues *) PG_GETARG_POINTER(1);
+  BrinValues *col_b = (BrinValues *) PG_GETARG_POINTER(2);
+
+  if (col_b->bv_hasnulls)
+    col_a->bv_hasnulls = true;
+  if (col_b->bv_allnulls)
+    PG_RETURN_VOID();
+  if (col_a->bv_allnulls)
+  {
+    col_a->bv_values[0] = datumCopy(col_b->bv_values[0], false,
+      sizeof(STBOX));
+    col_a->bv_allnulls = false;
+    PG_RETURN_VOID();
+  }
+  stbox_adjust(DatumGetSTboxP(col_a->bv_values[0]),
+    DatumGetSTboxP(col_b->bv_values[0]));
+  PG_RETURN_VOID();
 }
 
 /*****************************************************************************/
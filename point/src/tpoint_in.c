@@ -14,193 +14,842 @@
 
 #include <assert.h>
 #include <float.h>
-#include <json-c/json.h>
+#include <miscadmin.h>
 
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_parser.h"
 #include "postgis.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
 
 /*****************************************************************************
  * Input in MFJSON format 
+ *
+ * The MF-JSON representation is parsed in a single pass by a parser
+ * specialized for the MovingPoint schema, without building the tree of
+ * JSON objects. The coordinates are read into arrays of doubles and the
+ * positions of the datetimes are kept, and the members are only validated
+ * once the whole document has been read, in the same order as they have
+ * been validated so far. Member names are compared case insensitively and
+ * only the first occurrence of a member is kept.
  *****************************************************************************/
 
 /**
- * Convert a text value into a C string
- *
- * @note We don't include <utils/builtins.h> to avoid collisions with json-c/json.h 
- * @note Function taken from PostGIS file lwgeom_in_geojson.c
+ * Kind of the value of a member of the MF-JSON representation
+ */
+typedef enum
+{
+  MFJSON_MISSING,
+  MFJSON_ARRAY,
+  MFJSON_STRING,
+  MFJSON_OTHER
+} MFJSONKind;
+
+/** Dimension of an element of the coordinates which is a single number */
+#define MFJSON_NUMBER  -1
+/** Dimension of an element of the coordinates which is not an array of numbers */
+#define MFJSON_INVALID -2
+
+/**
+ * Structure to keep the value of the coordinates member
+ */
+typedef struct
+{
+  MFJSONKind kind;
+  int count;          /**< Number of elements of the array */
+  int *dims;          /**< Number of coordinates of each element */
+  double *coords;     /**< Coordinates of all the elements */
+  int ncoords;
+  int maxdims;
+  int maxcoords;
+} MFJSONCoords;
+
+/**
+ * Structure to keep the value of the datetimes member. The datetimes are
+ * kept as their position in the input string, they are only converted
+ * into timestamps when constructing the instants.
+ */
+typedef struct
+{
+  MFJSONKind kind;
+  int count;          /**< Number of elements of the array */
+  const char **start; /**< Start of each string, NULL if it is not a string */
+  int *len;           /**< Length of each string */
+  int maxcount;
+} MFJSONDatetimes;
+
+/**
+ * Structure to keep the members of a sequence
+ */
+typedef struct
+{
+  bool isobject;
+  int nmembers;
+  MFJSONCoords coords;
+  MFJSONDatetimes dates;
+  int lower_inc;      /**< -1 if missing, otherwise the boolean value */
+  int upper_inc;      /**< -1 if missing, otherwise the boolean value */
+} MFJSONSeq;
+
+/**
+ * Structure to keep the members of the MF-JSON representation
+ */
+typedef struct
+{
+  MFJSONSeq seq;      /**< Members of an instant, instant set or sequence */
+  bool hastype;
+  char *type;
+  MFJSONKind interpkind;
+  int ninterp;
+  char *interp;
+  char *srs;
+  MFJSONKind seqskind;
+  int nseqs;
+  MFJSONSeq *seqs;
+} MFJSONDoc;
+
+/**
+ * Structure to keep the state of the parser
+ */
+typedef struct
+{
+  const char *cur;
+  const char *end;
+} MFJSONParser;
+
+/*****************************************************************************/
+
+/**
+ * Raise an error for a string that is not a valid JSON document
  */
-static char*
-text2cstring(const text *textptr)
+static void
+mfjson_error(void)
 {
-  size_t size = VARSIZE_ANY_EXHDR(textptr);
-  char *str = palloc(size + 1);
-  memcpy(str, VARDATA(textptr), size);
-  str[size]='\0';
-  return str;
+  ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+    errmsg("Error while processing MFJSON string")));
 }
 
 /**
- * Returns the JSON member corresponding to the name
- *
- * @note Function taken from PostGIS file lwin_geojson.c
+ * Skip the white spaces and returns the next character, or 0 at the end of
+ * the input
  */
-static json_object *
-findMemberByName(json_object *poObj, const char *pszName )
+static char
+mfjson_peek(MFJSONParser *p)
+{
+  while (p->cur < p->end && (*p->cur == ' ' || *p->cur == '\t' ||
+      *p->cur == '\n' || *p->cur == '\r'))
+    p->cur++;
+  return (p->cur < p->end) ? *p->cur : '\0';
+}
+
+/**
+ * Consume the next character, which must be the one given
+ */
+static void
+mfjson_expect(MFJSONParser *p, char c)
 {
-  json_object *poTmp = poObj;
-  json_object_iter it;
+  if (mfjson_peek(p) != c)
+    mfjson_error();
+  p->cur++;
+  return;
+}
 
-  if (pszName == NULL || poObj == NULL)
-    return NULL;
+/**
+ * Consume the literal, e.g., true, false, or null
+ */
+static void
+mfjson_literal(MFJSONParser *p, const char *literal)
+{
+  size_t len = strlen(literal);
+  if ((size_t) (p->end - p->cur) < len || strncmp(p->cur, literal, len) != 0)
+    mfjson_error();
+  p->cur += len;
+  return;
+}
 
-  it.key = NULL;
-  it.val = NULL;
-  it.entry = NULL;
+/**
+ * Read a string and returns the position and the length of its content,
+ * which may contain escape sequences
+ */
+static void
+mfjson_string_span(MFJSONParser *p, const char **start, int *len)
+{
+  mfjson_expect(p, '"');
+  *start = p->cur;
+  while (p->cur < p->end && *p->cur != '"')
+  {
+    if ((unsigned char) *p->cur < 0x20)
+      mfjson_error();
+    if (*p->cur == '\\')
+    {
+      if (++p->cur == p->end)
+        mfjson_error();
+    }
+    p->cur++;
+  }
+  if (p->cur == p->end)
+    mfjson_error();
+  *len = (int) (p->cur - *start);
+  p->cur++;
+  return;
+}
 
-  if (json_object_get_object(poTmp) != NULL)
+/**
+ * Returns the content of the string with its escape sequences decoded
+ */
+static char *
+mfjson_decode(const char *start, int len)
+{
+  char *result = palloc(len + 1);
+  char *ptr = result;
+  for (int i = 0; i < len; i++)
   {
-    if (json_object_get_object(poTmp)->head == NULL)
+    if (start[i] != '\\')
     {
-      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-        errmsg("Invalid MFJSON string")));
-      return NULL;
+      *ptr++ = start[i];
+      continue;
     }
-    for (it.entry = json_object_get_object(poTmp)->head;
-        ( it.entry ?
-          ( it.key = (char*)it.entry->k,
-          it.val = (json_object*)it.entry->v, it.entry) : 0);
-        it.entry = it.entry->next)
+    switch (start[++i])
     {
-      if (strcasecmp(it.key, pszName) == 0)
-        return it.val;
+      case 'b': *ptr++ = '\b'; break;
+      case 'f': *ptr++ = '\f'; break;
+      case 'n': *ptr++ = '\n'; break;
+      case 'r': *ptr++ = '\r'; break;
+      case 't': *ptr++ = '\t'; break;
+      case 'u':
+      {
+        /* Only the escape sequences of ASCII characters are accepted */
+        int code = 0;
+        if (i + 4 >= len)
+          mfjson_error();
+        for (int j = 1; j <= 4; j++)
+        {
+          char c = start[i + j];
+          code <<= 4;
+          if (c >= '0' && c <= '9') code |= c - '0';
+          else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+          else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+          else mfjson_error();
+        }
+        if (code == 0 || code > 0x7F)
+          mfjson_error();
+        *ptr++ = (char) code;
+        i += 4;
+        break;
+      }
+      case '"': case '\\': case '/':
+        *ptr++ = start[i];
+        break;
+      default:
+        mfjson_error();
     }
   }
-  return NULL;
+  *ptr = '\0';
+  return result;
 }
 
 /**
- * Returns a single point from its MF-JSON coordinates. In this case the
- * coordinate array is a single array of cordinations such as 
- * "coordinates":[1,1]
+ * Read a string and returns its content
  */
-static Datum
-parse_mfjson_coord(json_object *poObj, int srid)
+static char *
+mfjson_string(MFJSONParser *p)
 {
-  if (json_type_array != json_object_get_type(poObj))
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-      errmsg("Invalid value of the 'coordinates' array in MFJSON string")));
+  const char *start;
+  int len;
+  mfjson_string_span(p, &start, &len);
+  return mfjson_decode(start, len);
+}
 
-  const int numcoord = json_object_array_length(poObj);
-  if (numcoord < 2)
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-      errmsg("Too few elements in 'coordinates' values in MFJSON string")));
-  else if (numcoord > 3)
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-      errmsg("Too many elements in 'coordinates' values in MFJSON string")));
+/**
+ * Read a number
+ */
+static double
+mfjson_number(MFJSONParser *p)
+{
+  /* Only the characters of JSON numbers are given to strtod */
+  char str[64];
+  int len = 0;
+  mfjson_peek(p);
+  while (p->cur < p->end && ((*p->cur >= '0' && *p->cur <= '9') ||
+    *p->cur == '-' || *p->cur == '+' || *p->cur == '.' ||
+    *p->cur == 'e' || *p->cur == 'E'))
+  {
+    if (len == (int) sizeof(str) - 1)
+      mfjson_error();
+    str[len++] = *p->cur++;
+  }
+  str[len] = '\0';
+  char *endptr;
+  double result = strtod(str, &endptr);
+  if (len == 0 || *endptr != '\0')
+    mfjson_error();
+  return result;
+}
+
+/**
+ * Returns the kind of the next value
+ */
+static MFJSONKind
+mfjson_kind(MFJSONParser *p)
+{
+  char c = mfjson_peek(p);
+  if (c == '[')
+    return MFJSON_ARRAY;
+  if (c == '"')
+    return MFJSON_STRING;
+  return MFJSON_OTHER;
+}
 
-  double x, y;
-  json_object *poObjCoord = NULL;
+/**
+ * Returns true if the first array element or object member follows,
+ * consuming the opening character
+ */
+static bool
+mfjson_open(MFJSONParser *p, char open, char close)
+{
+  mfjson_expect(p, open);
+  if (mfjson_peek(p) == close)
+  {
+    p->cur++;
+    return false;
+  }
+  return true;
+}
 
-  /* Read X coordinate */
-  poObjCoord = json_object_array_get_idx(poObj, 0);
-  x = json_object_get_double(poObjCoord);
+/**
+ * Returns true if another array element or object member follows,
+ * consuming the separator or the closing character
+ */
+static bool
+mfjson_next(MFJSONParser *p, char close)
+{
+  char c = mfjson_peek(p);
+  p->cur++;
+  if (c == ',')
+    return true;
+  if (c != close)
+    mfjson_error();
+  return false;
+}
 
-  /* Read Y coordinate */
-  poObjCoord = json_object_array_get_idx(poObj, 1);
-  y = json_object_get_double(poObjCoord);
+/**
+ * Returns true if the name of the member is the given one
+ */
+static bool
+mfjson_name_is(const char *start, int len, const char *name)
+{
+  return (strlen(name) == (size_t) len &&
+    pg_strncasecmp(start, name, len) == 0);
+}
 
-  LWPOINT *point;
-  if (numcoord == 3)
+/**
+ * Skip a value of any type
+ */
+static void
+mfjson_skip_value(MFJSONParser *p)
+{
+  const char *start;
+  int len;
+  char c = mfjson_peek(p);
+  check_stack_depth();
+  if (c == '{')
+  {
+    if (! mfjson_open(p, '{', '}'))
+      return;
+    do
+    {
+      mfjson_string_span(p, &start, &len);
+      mfjson_expect(p, ':');
+      mfjson_skip_value(p);
+    } while (mfjson_next(p, '}'));
+  }
+  else if (c == '[')
   {
-    /* Read Z coordinate */
-    poObjCoord = json_object_array_get_idx(poObj, 2);
-    double z = json_object_get_double(poObjCoord);
-    point = lwpoint_make3dz(srid, x, y, z);
+    if (! mfjson_open(p, '[', ']'))
+      return;
+    do
+      mfjson_skip_value(p);
+    while (mfjson_next(p, ']'));
   }
+  else if (c == '"')
+    mfjson_string_span(p, &start, &len);
+  else if (c == 't')
+    mfjson_literal(p, "true");
+  else if (c == 'f')
+    mfjson_literal(p, "false");
+  else if (c == 'n')
+    mfjson_literal(p, "null");
   else
-    point = lwpoint_make2d(srid, x, y);
+    mfjson_number(p);
+  return;
+}
 
-  Datum result = PointerGetDatum(geo_serialize((LWGEOM *) point));
-  lwpoint_free(point);
-  return result;
+/*****************************************************************************/
+
+/**
+ * Append a coordinate to the coordinates member
+ */
+static void
+mfjson_coords_add(MFJSONCoords *coords, double d)
+{
+  if (coords->ncoords == coords->maxcoords)
+  {
+    coords->maxcoords *= 2;
+    coords->coords = repalloc(coords->coords,
+      sizeof(double) * coords->maxcoords);
+  }
+  coords->coords[coords->ncoords++] = d;
+  return;
 }
 
-/* TODO MAKE POSSIBLE TO CALL THIS FUNCTION */
 /**
- * Returns an array of points from its MF-JSON coordinates. In this case the
- * coordinate array is an array of arrays of cordinates such as 
- * "coordinates":[[1,1],[2,2]]
+ * Read the value of the coordinates member, which is either an array of
+ * numbers or an array of arrays of numbers
  */
-static Datum *
-parse_mfjson_points(json_object *mfjson, int srid, int *count)
+static void
+mfjson_parse_coords(MFJSONParser *p, MFJSONCoords *coords)
 {
-  json_object *mfjsonTmp = mfjson;
-  json_object *coordinates = NULL;
-  coordinates = findMemberByName(mfjsonTmp, "coordinates");
-  if (coordinates == NULL)
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-      errmsg("Unable to find 'coordinates' in MFJSON string")));
-  if (json_object_get_type(coordinates) != json_type_array)
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-      errmsg("Invalid 'coordinates' array in MFJSON string")));
+  coords->kind = mfjson_kind(p);
+  if (coords->kind != MFJSON_ARRAY)
+  {
+    mfjson_skip_value(p);
+    return;
+  }
+  coords->maxdims = 64;
+  coords->maxcoords = 128;
+  coords->dims = palloc(sizeof(int) * coords->maxdims);
+  coords->coords = palloc(sizeof(double) * coords->maxcoords);
+  if (! mfjson_open(p, '[', ']'))
+    return;
+  do
+  {
+    if (coords->count == coords->maxdims)
+    {
+      coords->maxdims *= 2;
+      coords->dims = repalloc(coords->dims, sizeof(int) * coords->maxdims);
+    }
+    char c = mfjson_peek(p);
+    int dim;
+    if (c == '-' || (c >= '0' && c <= '9'))
+    {
+      mfjson_coords_add(coords, mfjson_number(p));
+      dim = MFJSON_NUMBER;
+    }
+    else if (c == '[')
+    {
+      dim = 0;
+      if (mfjson_open(p, '[', ']'))
+      {
+        do
+        {
+          c = mfjson_peek(p);
+          if (c == '-' || (c >= '0' && c <= '9'))
+          {
+            mfjson_coords_add(coords, mfjson_number(p));
+            if (dim >= 0) dim++;
+          }
+          else
+          {
+            mfjson_skip_value(p);
+            dim = MFJSON_INVALID;
+          }
+        } while (mfjson_next(p, ']'));
+      }
+    }
+    else
+    {
+      mfjson_skip_value(p);
+      dim = MFJSON_INVALID;
+    }
+    coords->dims[coords->count++] = dim;
+  } while (mfjson_next(p, ']'));
+  return;
+}
 
-  int numpoints = json_object_array_length(coordinates);
-  if (numpoints < 1)
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-      errmsg("Invalid value of 'coordinates' array in MFJSON string")));
-  
-  Datum *values = palloc(sizeof(Datum) * numpoints);
-  for (int i = 0; i < numpoints; ++i)
+/**
+ * Read the value of the datetimes member, which is either a string or an
+ * array of strings
+ */
+static void
+mfjson_parse_datetimes(MFJSONParser *p, MFJSONDatetimes *dates)
+{
+  dates->kind = mfjson_kind(p);
+  if (dates->kind == MFJSON_OTHER)
   {
-    json_object *coords = NULL;
-    coords = json_object_array_get_idx(coordinates, i);
-    values[i] = parse_mfjson_coord(coords, srid);
+    mfjson_skip_value(p);
+    return;
   }
-  *count = numpoints;
-  return values;
+  dates->maxcount = (dates->kind == MFJSON_STRING) ? 1 : 64;
+  dates->start = palloc(sizeof(char *) * dates->maxcount);
+  dates->len = palloc(sizeof(int) * dates->maxcount);
+  if (dates->kind == MFJSON_STRING)
+  {
+    mfjson_string_span(p, &dates->start[0], &dates->len[0]);
+    dates->count = 1;
+    return;
+  }
+  if (! mfjson_open(p, '[', ']'))
+    return;
+  do
+  {
+    if (dates->count == dates->maxcount)
+    {
+      dates->maxcount *= 2;
+      dates->start = repalloc(dates->start, sizeof(char *) * dates->maxcount);
+      dates->len = repalloc(dates->len, sizeof(int) * dates->maxcount);
+    }
+    if (mfjson_kind(p) == MFJSON_STRING)
+      mfjson_string_span(p, &dates->start[dates->count],
+        &dates->len[dates->count]);
+    else
+    {
+      mfjson_skip_value(p);
+      dates->start[dates->count] = NULL;
+    }
+    dates->count++;
+  } while (mfjson_next(p, ']'));
+  return;
 }
 
 /**
- * Returns an array of timestamps from its MF-JSON datetimes values
+ * Read the value of a bound member, returns -1 if it is not a boolean
  */
-static TimestampTz *
-parse_mfjson_datetimes(json_object *mfjson, int *count)
+static int
+mfjson_parse_bool(MFJSONParser *p)
 {
-  json_object *datetimes = NULL;
-  datetimes = findMemberByName(mfjson, "datetimes");
-  if (datetimes == NULL)
+  char c = mfjson_peek(p);
+  if (c == 't')
+  {
+    mfjson_literal(p, "true");
+    return 1;
+  }
+  if (c == 'f')
+  {
+    mfjson_literal(p, "false");
+    return 0;
+  }
+  mfjson_skip_value(p);
+  return -1;
+}
+
+/**
+ * Initialize the members of a sequence
+ */
+static void
+mfjson_seq_init(MFJSONSeq *seq)
+{
+  memset(seq, 0, sizeof(MFJSONSeq));
+  seq->lower_inc = seq->upper_inc = -1;
+  return;
+}
+
+/**
+ * Read the value of a member of a sequence if its name is one of them,
+ * returns false otherwise
+ */
+static bool
+mfjson_parse_seq_member(MFJSONParser *p, const char *name, int len,
+  MFJSONSeq *seq)
+{
+  if (mfjson_name_is(name, len, "coordinates") &&
+    seq->coords.kind == MFJSON_MISSING)
+    mfjson_parse_coords(p, &seq->coords);
+  else if (mfjson_name_is(name, len, "datetimes") &&
+    seq->dates.kind == MFJSON_MISSING)
+    mfjson_parse_datetimes(p, &seq->dates);
+  else if (mfjson_name_is(name, len, "lower_inc") && seq->lower_inc == -1)
+  {
+    seq->lower_inc = mfjson_parse_bool(p);
+    if (seq->lower_inc == -1)
       ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-        errmsg("Unable to find 'datetimes' in MFJSON string")));
-  if (json_object_get_type(datetimes) != json_type_array)
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-      errmsg("Invalid 'datetimes' array in MFJSON string")));
+        errmsg("Invalid 'lower_inc' value in MFJSON string")));
+  }
+  else if (mfjson_name_is(name, len, "upper_inc") && seq->upper_inc == -1)
+  {
+    seq->upper_inc = mfjson_parse_bool(p);
+    if (seq->upper_inc == -1)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+        errmsg("Invalid 'upper_inc' value in MFJSON string")));
+  }
+  else
+    return false;
+  return true;
+}
 
-  int numdates = json_object_array_length(datetimes);
-  if (numdates < 1)
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-      errmsg("Invalid value of 'datetimes' array in MFJSON string")));
-  
-  TimestampTz *times = palloc(sizeof(TimestampTz) * numdates);
-  for (int i = 0; i < numdates; i++)
-  {
-    json_object* datevalue = NULL;
-    datevalue = json_object_array_get_idx(datetimes, i);
-    const char *strdatevalue = json_object_get_string(datevalue);
-    if (strdatevalue)
+/**
+ * Read an element of the sequences member
+ */
+static void
+mfjson_parse_seq(MFJSONParser *p, MFJSONSeq *seq)
+{
+  mfjson_seq_init(seq);
+  if (mfjson_peek(p) != '{')
+  {
+    mfjson_skip_value(p);
+    return;
+  }
+  seq->isobject = true;
+  if (! mfjson_open(p, '{', '}'))
+    return;
+  int nmembers = 0;
+  do
+  {
+    const char *name;
+    int len;
+    mfjson_string_span(p, &name, &len);
+    mfjson_expect(p, ':');
+    if (! mfjson_parse_seq_member(p, name, len, seq))
+      mfjson_skip_value(p);
+    nmembers++;
+  } while (mfjson_next(p, '}'));
+  seq->nmembers = nmembers;
+  return;
+}
+
+/**
+ * Read the value of the sequences member
+ */
+static void
+mfjson_parse_seqs(MFJSONParser *p, MFJSONDoc *doc)
+{
+  doc->seqskind = mfjson_kind(p);
+  if (doc->seqskind != MFJSON_ARRAY)
+  {
+    mfjson_skip_value(p);
+    return;
+  }
+  int maxseqs = 16;
+  doc->seqs = palloc(sizeof(MFJSONSeq) * maxseqs);
+  if (! mfjson_open(p, '[', ']'))
+    return;
+  do
+  {
+    if (doc->nseqs == maxseqs)
+    {
+      maxseqs *= 2;
+      doc->seqs = repalloc(doc->seqs, sizeof(MFJSONSeq) * maxseqs);
+    }
+    mfjson_parse_seq(p, &doc->seqs[doc->nseqs++]);
+  } while (mfjson_next(p, ']'));
+  return;
+}
+
+/**
+ * Read the value of the interpolations member
+ */
+static void
+mfjson_parse_interp(MFJSONParser *p, MFJSONDoc *doc)
+{
+  doc->interpkind = mfjson_kind(p);
+  if (doc->interpkind != MFJSON_ARRAY || ! mfjson_open(p, '[', ']'))
+  {
+    if (doc->interpkind != MFJSON_ARRAY)
+      mfjson_skip_value(p);
+    return;
+  }
+  do
+  {
+    if (doc->ninterp++ == 0 && mfjson_kind(p) == MFJSON_STRING)
+      doc->interp = mfjson_string(p);
+    else
+      mfjson_skip_value(p);
+  } while (mfjson_next(p, ']'));
+  return;
+}
+
+/**
+ * Read the value of the crs member. The SRS is the name in the properties
+ * member, provided that there is also a type member.
+ */
+static void
+mfjson_parse_crs(MFJSONParser *p, MFJSONDoc *doc)
+{
+  if (mfjson_peek(p) != '{')
+  {
+    mfjson_skip_value(p);
+    return;
+  }
+  if (! mfjson_open(p, '{', '}'))
+    return;
+  bool hastype = false;
+  char *name = NULL;
+  do
+  {
+    const char *key;
+    int len;
+    mfjson_string_span(p, &key, &len);
+    mfjson_expect(p, ':');
+    if (mfjson_name_is(key, len, "type"))
+    {
+      hastype = true;
+      mfjson_skip_value(p);
+    }
+    else if (mfjson_name_is(key, len, "properties") &&
+      mfjson_peek(p) == '{')
+    {
+      if (! mfjson_open(p, '{', '}'))
+        continue;
+      do
+      {
+        mfjson_string_span(p, &key, &len);
+        mfjson_expect(p, ':');
+        if (name == NULL && mfjson_name_is(key, len, "name") &&
+          mfjson_kind(p) == MFJSON_STRING)
+          name = mfjson_string(p);
+        else
+          mfjson_skip_value(p);
+      } while (mfjson_next(p, '}'));
+    }
+    else
+      mfjson_skip_value(p);
+  } while (mfjson_next(p, '}'));
+  if (hastype)
+    doc->srs = name;
+  return;
+}
+
+/**
+ * Read the MF-JSON representation
+ */
+static void
+mfjson_parse(const char *str, int len, MFJSONDoc *doc)
+{
+  MFJSONParser parser = {str, str + len};
+  MFJSONParser *p = &parser;
+  memset(doc, 0, sizeof(MFJSONDoc));
+  mfjson_seq_init(&doc->seq);
+  if (mfjson_peek(p) != '{')
+    /* A value which is not an object does not have any member */
+    mfjson_skip_value(p);
+  else
+  {
+    doc->seq.isobject = true;
+    if (mfjson_open(p, '{', '}'))
     {
-      char datetime[33];
-      strcpy(datetime, strdatevalue);
-      /* Replace 'T' by ' ' before converting to timestamptz */
-      datetime[10] = ' ';
-      times[i] = call_input(TIMESTAMPTZOID, datetime);
+      int nmembers = 0;
+      bool hascrs = false;
+      do
+      {
+        const char *name;
+        int namelen;
+        mfjson_string_span(p, &name, &namelen);
+        mfjson_expect(p, ':');
+        nmembers++;
+        if (mfjson_parse_seq_member(p, name, namelen, &doc->seq))
+          continue;
+        if (mfjson_name_is(name, namelen, "type") && ! doc->hastype)
+        {
+          doc->hastype = true;
+          if (mfjson_kind(p) == MFJSON_STRING)
+            doc->type = mfjson_string(p);
+          else
+            mfjson_skip_value(p);
+        }
+        else if (mfjson_name_is(name, namelen, "interpolations") &&
+          doc->interpkind == MFJSON_MISSING)
+          mfjson_parse_interp(p, doc);
+        else if (mfjson_name_is(name, namelen, "sequences") &&
+          doc->seqskind == MFJSON_MISSING)
+          mfjson_parse_seqs(p, doc);
+        else if (mfjson_name_is(name, namelen, "crs") && ! hascrs)
+        {
+          hascrs = true;
+          mfjson_parse_crs(p, doc);
+        }
+        else
+          mfjson_skip_value(p);
+      } while (mfjson_next(p, '}'));
+      doc->seq.nmembers = nmembers;
     }
   }
-  *count = numdates;
-  return times;
+  if (mfjson_peek(p) != '\0')
+    mfjson_error();
+  return;
+}
+
+/*****************************************************************************/
+
+/**
+ * Structure to construct the points from their coordinates. The coordinates
+ * are written in a point serialized once for each dimension, which is then
+ * copied in each instant.
+ */
+typedef struct
+{
+  int srid;
+  GSERIALIZED *gs[2];  /**< Points in 2D and in 3D */
+} MFJSONPoints;
+
+/**
+ * Returns the point whose coordinates are given
+ *
+ * @note The result is only valid until the next call of the function
+ */
+static Datum
+mfjson_point(MFJSONPoints *points, const double *coords, int dim)
+{
+  if (dim < 2 && dim != MFJSON_NUMBER && dim != MFJSON_INVALID)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Too few elements in 'coordinates' values in MFJSON string")));
+  else if (dim > 3)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Too many elements in 'coordinates' values in MFJSON string")));
+  else if (dim < 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Invalid value of the 'coordinates' array in MFJSON string")));
+
+  bool hasz = (dim == 3);
+  if (points->gs[hasz] == NULL)
+  {
+    LWPOINT *lwpoint = hasz ? lwpoint_make3dz(points->srid, 0, 0, 0) :
+      lwpoint_make2d(points->srid, 0, 0);
+    points->gs[hasz] = geo_serialize((LWGEOM *) lwpoint);
+    lwpoint_free(lwpoint);
+  }
+  double *ptcoords = (double *) datum_get_point2d_p(
+    PointerGetDatum(points->gs[hasz]));
+  memcpy(ptcoords, coords, sizeof(double) * dim);
+  return PointerGetDatum(points->gs[hasz]);
+}
+
+/**
+ * Release the points used to construct the instants
+ */
+static void
+mfjson_points_free(MFJSONPoints *points)
+{
+  for (int i = 0; i < 2; i++)
+    if (points->gs[i] != NULL)
+      pfree(points->gs[i]);
+  return;
+}
+
+/**
+ * Returns the timestamp from its MF-JSON representation. Timestamps in the
+ * ISO 8601 format, such as "2019-08-06T18:35:48.021455+02:30", are
+ * converted directly, while the other ones are given to the input function
+ * of timestamptz.
+ */
+static TimestampTz
+mfjson_timestamp(const char *start, int len)
+{
+  if (start == NULL)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Invalid 'datetimes' value in MFJSON string")));
+  char *str = mfjson_decode(start, len);
+  len = (int) strlen(str);
+  TimestampTz result;
+  if (! timestamp_parse_iso(str, len, &result))
+  {
+    /* Replace 'T' by ' ' before converting to timestamptz */
+    if (len > 10 && str[10] == 'T')
+      str[10] = ' ';
+    result = DatumGetTimestampTz(call_input(TIMESTAMPTZOID, str));
+  }
+  pfree(str);
+  return result;
 }
 
 /*****************************************************************************/
@@ -209,37 +858,36 @@ parse_mfjson_datetimes(json_object *mfjson, int *count)
  * Returns a temporal instant point from its MF-JSON representation
  */
 static TInstant *
-tpointinst_from_mfjson(json_object *mfjson, int srid)
+tpointinst_from_mfjson(const MFJSONSeq *seq, int srid)
 {
   /* Get coordinates */
-  json_object *coordinates = findMemberByName(mfjson, "coordinates");
-  if (coordinates == NULL)
+  const MFJSONCoords *coords = &seq->coords;
+  if (coords->kind == MFJSON_MISSING)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Unable to find 'coordinates' in MFJSON string")));
-  Datum value = parse_mfjson_coord(coordinates, srid);
-
-  /* Get datetimes 
-   * The maximum length of a datetime is 32 characters, e.g.,
-   *  "2019-08-06T18:35:48.021455+02:30" 
-   */
-  char str[33];
-  json_object *datetimes = findMemberByName(mfjson, "datetimes");
-  /* We don't need to test that datetimes is NULL since to differentiate 
-   * between an instant and a instant set we look for the "datetimes" 
-   * member and then call this function */
-  const char *strdatetimes = json_object_get_string(datetimes);
-  if (strdatetimes == NULL)
+  /* The coordinate array is a single array of numbers such as
+   * "coordinates":[1,1] */
+  int dim = MFJSON_INVALID;
+  if (coords->kind == MFJSON_ARRAY)
   {
+    dim = coords->count;
+    for (int i = 0; i < coords->count; i++)
+      if (coords->dims[i] != MFJSON_NUMBER)
+        dim = MFJSON_INVALID;
+  }
+
+  MFJSONPoints points = {srid, {NULL, NULL}};
+  Datum value = mfjson_point(&points, coords->coords, dim);
+
+  /* Get datetimes. We don't need to test that datetimes is missing since
+   * to differentiate between an instant and a instant set we look for the
+   * "datetimes" member and then call this function */
+  if (seq->dates.kind != MFJSON_STRING)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Invalid 'datetimes' value in MFJSON string")));
-    return NULL; /* make Codacy quiet */
-  }
-  strcpy(str, strdatetimes);
-  /* Replace 'T' by ' ' before converting to timestamptz */
-  str[10] = ' ';
-  TimestampTz t = call_input(TIMESTAMPTZOID, str);
+  TimestampTz t = mfjson_timestamp(seq->dates.start[0], seq->dates.len[0]);
   TInstant *result = tinstant_make(value, t, type_oid(T_GEOMETRY));
-  pfree(DatumGetPointer(value));
+  mfjson_points_free(&points);
   return result;
 }
 
@@ -247,24 +895,68 @@ tpointinst_from_mfjson(json_object *mfjson, int srid)
  * Returns array of temporal instant points from its MF-JSON representation
  */
 static TInstant **
-tpointinstarr_from_mfjson(json_object *mfjson, int srid, int *count)
+tpointinstarr_from_mfjson(const MFJSONSeq *seq, int srid, int *count)
 {
-  /* Get coordinates and datetimes */
-  int numpoints, numdates;
-  Datum *values = parse_mfjson_points(mfjson, srid, &numpoints);
-  TimestampTz *times = parse_mfjson_datetimes(mfjson, &numdates);
-  if (numpoints != numdates)
+  /* Get coordinates. In this case the coordinate array is an array of
+   * arrays of cordinates such as "coordinates":[[1,1],[2,2]] */
+  const MFJSONCoords *coords = &seq->coords;
+  if (! seq->isobject || coords->kind == MFJSON_MISSING)
+  {
+    if (seq->isobject && seq->nmembers == 0)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+        errmsg("Invalid MFJSON string")));
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Unable to find 'coordinates' in MFJSON string")));
+  }
+  if (coords->kind != MFJSON_ARRAY)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Invalid 'coordinates' array in MFJSON string")));
+  int numpoints = coords->count;
+  if (numpoints < 1)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Invalid value of 'coordinates' array in MFJSON string")));
+  for (int i = 0; i < numpoints; i++)
+  {
+    /* A single number in the array is not a point */
+    int dim = coords->dims[i];
+    if (dim == MFJSON_NUMBER || dim == MFJSON_INVALID)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+        errmsg("Invalid value of the 'coordinates' array in MFJSON string")));
+    else if (dim < 2)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+        errmsg("Too few elements in 'coordinates' values in MFJSON string")));
+    else if (dim > 3)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+        errmsg("Too many elements in 'coordinates' values in MFJSON string")));
+  }
+
+  /* Get datetimes */
+  const MFJSONDatetimes *dates = &seq->dates;
+  if (dates->kind == MFJSON_MISSING)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Unable to find 'datetimes' in MFJSON string")));
+  if (dates->kind != MFJSON_ARRAY)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Invalid 'datetimes' array in MFJSON string")));
+  if (dates->count < 1)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Invalid value of 'datetimes' array in MFJSON string")));
+  if (numpoints != dates->count)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Distinct number of elements in 'coordinates' and 'datetimes' arrays")));
 
   /* Construct the array of temporal instant points */
+  MFJSONPoints points = {srid, {NULL, NULL}};
   TInstant **result = palloc(sizeof(TInstant *) * numpoints);
+  const double *ptcoords = coords->coords;
   for (int i = 0; i < numpoints; i++)
-    result[i] = tinstant_make(values[i], times[i], type_oid(T_GEOMETRY));
-
-  for (int i = 0; i < numpoints; i++)
-    pfree(DatumGetPointer(values[i]));
-  pfree(values); pfree(times);
+  {
+    Datum value = mfjson_point(&points, ptcoords, coords->dims[i]);
+    ptcoords += coords->dims[i];
+    TimestampTz t = mfjson_timestamp(dates->start[i], dates->len[i]);
+    result[i] = tinstant_make(value, t, type_oid(T_GEOMETRY));
+  }
+  mfjson_points_free(&points);
   *count = numpoints;
   return result;
 }
@@ -273,10 +965,10 @@ tpointinstarr_from_mfjson(json_object *mfjson, int srid, int *count)
  * Returns a temporal instant set point from its MF-JSON representation
  */
 static TInstantSet *
-tpointinstset_from_mfjson(json_object *mfjson, int srid)
+tpointinstset_from_mfjson(const MFJSONSeq *seq, int srid)
 {
   int count;
-  TInstant **instants = tpointinstarr_from_mfjson(mfjson, srid, &count);
+  TInstant **instants = tpointinstarr_from_mfjson(seq, srid, &count);
   return tinstantset_make_free(instants, count);
 }
 
@@ -284,61 +976,46 @@ tpointinstset_from_mfjson(json_object *mfjson, int srid)
  * Returns a temporal sequence point from its MF-JSON representation
  */
 static TSequence *
-tpointseq_from_mfjson(json_object *mfjson, int srid, bool linear)
+tpointseq_from_mfjson(const MFJSONSeq *seq, int srid, bool linear)
 {
   /* Get the array of temporal instant points */
   int count;
-  TInstant **instants = tpointinstarr_from_mfjson(mfjson, srid, &count);
+  TInstant **instants = tpointinstarr_from_mfjson(seq, srid, &count);
 
-  /* Get lower bound flag */
-  json_object *lowerinc = NULL;
-  lowerinc = findMemberByName(mfjson, "lower_inc");
-  if (lowerinc == NULL)
+  /* Get the bound flags */
+  if (seq->lower_inc == -1)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Unable to find 'lower_inc' in MFJSON string")));
-  bool lower_inc = (bool) json_object_get_boolean(lowerinc);
-
-  /* Get upper bound flag */
-  json_object *upperinc = NULL;
-  upperinc = findMemberByName(mfjson, "upper_inc");
-  if (upperinc == NULL)
+  if (seq->upper_inc == -1)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Unable to find 'upper_inc' in MFJSON string")));
-  bool upper_inc = (bool) json_object_get_boolean(upperinc);
 
   /* Construct the temporal point */
-  return tsequence_make_free(instants, count, lower_inc, upper_inc, 
-    linear, NORMALIZE);
+  return tsequence_make_free(instants, count, seq->lower_inc == 1,
+    seq->upper_inc == 1, linear, NORMALIZE);
 }
 
 /**
  * Returns a temporal sequence set point from its MF-JSON representation
  */
 static TSequenceSet *
-tpointseqset_from_mfjson(json_object *mfjson, int srid, bool linear)
-{
-  json_object *seqs = NULL;
-  seqs = findMemberByName(mfjson, "sequences");
-  /* We don't need to test that seqs is NULL since to differentiate between
-   * a sequence and a sequence set we look for the "sequences" member and
-   * then call this function */
-  if (json_object_get_type(seqs) != json_type_array)
+tpointseqset_from_mfjson(const MFJSONDoc *doc, int srid, bool linear)
+{
+  /* We don't need to test that the sequences are missing since to
+   * differentiate between a sequence and a sequence set we look for the
+   * "sequences" member and then call this function */
+  if (doc->seqskind != MFJSON_ARRAY)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Invalid 'sequences' array in MFJSON string")));
-  int numseqs = json_object_array_length(seqs);
-  if (numseqs < 1)
+  if (doc->nseqs < 1)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Invalid value of 'sequences' array in MFJSON string")));
 
   /* Construct the temporal point */
-  TSequence **sequences = palloc(sizeof(TSequence *) * numseqs);
-  for (int i = 0; i < numseqs; i++)
-  {
-    json_object* seqvalue = NULL;
-    seqvalue = json_object_array_get_idx(seqs, i);
-    sequences[i] = tpointseq_from_mfjson(seqvalue, srid, linear);
-  }
-  return tsequenceset_make_free(sequences, numseqs, NORMALIZE);
+  TSequence **sequences = palloc(sizeof(TSequence *) * doc->nseqs);
+  for (int i = 0; i < doc->nseqs; i++)
+    sequences[i] = tpointseq_from_mfjson(&doc->seqs[i], srid, linear);
+  return tsequenceset_make_free(sequences, doc->nseqs, NORMALIZE);
 }
 
 PG_FUNCTION_INFO_V1(tpoint_from_mfjson);
@@ -348,48 +1025,25 @@ PG_FUNCTION_INFO_V1(tpoint_from_mfjson);
 PGDLLEXPORT Datum
 tpoint_from_mfjson(PG_FUNCTION_ARGS)
 {
-  text *mfjson_input;
-  char *mfjson;
-  char *srs = NULL;
+  text *mfjson_input = PG_GETARG_TEXT_P(0);
   int srid = 0;
   Temporal *result;
 
-  /* Get the mfjson stream */
-  mfjson_input = PG_GETARG_TEXT_P(0);
-  mfjson = text2cstring(mfjson_input);
-
-  json_tokener *jstok = NULL;
-  json_object *poObj = NULL;
-  json_object *poObjType = NULL;
-  json_object *poObjInterp = NULL;
-  json_object *poObjInterp1 = NULL;
-  json_object *poObjDates = NULL;
-  json_object *poObjSrs = NULL;
-
-  /* Begin to parse json */
-  jstok = json_tokener_new();
-  poObj = json_tokener_parse_ex(jstok, mfjson, -1);
-  if (jstok->err != json_tokener_success)
-  {
-    char err[256];
-    snprintf(err, 256, "%s (at offset %d)", json_tokener_error_desc(jstok->err), jstok->char_offset);
-    json_tokener_free(jstok);
-    json_object_put(poObj);
-    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-      errmsg("Error while processing MFJSON string")));
-  }
-  json_tokener_free(jstok);
-  
+  /* Parse the mfjson stream */
+  MFJSONDoc doc;
+  mfjson_parse(VARDATA(mfjson_input), VARSIZE(mfjson_input) - VARHDRSZ,
+    &doc);
+
   /*
    * Ensure that it is a moving point
    */
-  poObjType = findMemberByName(poObj, "type");
-  if (poObjType == NULL)
+  if (doc.seq.isobject && doc.seq.nmembers == 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Invalid MFJSON string")));
+  if (! doc.hastype)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Unable to find 'type' in MFJSON string")));
-
-  const char *pszType = json_object_get_string(poObjType);
-  if (strcmp(pszType, "MovingPoint") != 0)
+  if (doc.type == NULL || strcmp(doc.type, "MovingPoint") != 0)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Invalid 'type' value in MFJSON string")));
 
@@ -397,84 +1051,48 @@ tpoint_from_mfjson(PG_FUNCTION_ARGS)
    * Determine duration of temporal point and dispatch to the 
    *  corresponding parse function 
    */
-  poObjInterp = findMemberByName(poObj, "interpolations");
-  if (poObjInterp == NULL)
+  if (doc.interpkind == MFJSON_MISSING)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Unable to find 'interpolations' in MFJSON string")));
-
-  if (json_object_get_type(poObjInterp) != json_type_array)
+  if (doc.interpkind != MFJSON_ARRAY)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Invalid 'interpolations' value in MFJSON string")));
-
-  const int nSize = json_object_array_length(poObjInterp);
-  if (nSize != 1)
+  if (doc.ninterp != 1)
     ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
       errmsg("Multiple 'interpolations' values in MFJSON string")));
 
-  /* Parse crs and set SRID of temporal point */
-  poObjSrs = findMemberByName(poObj, "crs");
-  if (poObjSrs != NULL)
+  /* Set SRID of temporal point */
+  if (doc.srs)
   {
-    json_object *poObjSrsType = findMemberByName(poObjSrs, "type");
-    if (poObjSrsType != NULL)
-    {
-      json_object *poObjSrsProps = findMemberByName(poObjSrs, "properties");
-      if (poObjSrsProps)
-      {
-        json_object *poNameURL = findMemberByName(poObjSrsProps, "name");
-        if (poNameURL)
-        {
-          const char *pszName = json_object_get_string(poNameURL);
-          if (pszName)
-          {
-            srs = palloc(strlen(pszName) + 1);
-            strcpy(srs, pszName);
-          }
-        }
-      }
-    }
+    srid = getSRIDbySRS(doc.srs);
+    pfree(doc.srs);
   }
 
-  if (srs)
+  /* Read interpolation value */
+  if (doc.interp != NULL && strcmp(doc.interp, "Discrete") == 0)
   {
-    srid = getSRIDbySRS(srs);
-    pfree(srs);
+    if (doc.seq.dates.kind == MFJSON_ARRAY)
+      result = (Temporal *)tpointinstset_from_mfjson(&doc.seq, srid);
+    else
+      result = (Temporal *)tpointinst_from_mfjson(&doc.seq, srid);
   }
-
-  /* Read interpolation value */
-  poObjInterp1 = json_object_array_get_idx(poObjInterp, 0);
-  const char *pszInterp = json_object_get_string(poObjInterp1);
-  if (pszInterp)
+  else if (doc.interp != NULL && strcmp(doc.interp, "Stepwise") == 0)
   {
-    if (strcmp(pszInterp, "Discrete") == 0)
-    {
-      poObjDates = findMemberByName(poObj, "datetimes");
-      if (poObjDates != NULL &&
-        json_object_get_type(poObjDates) == json_type_array)
-        result = (Temporal *)tpointinstset_from_mfjson(poObj, srid);
-      else
-        result = (Temporal *)tpointinst_from_mfjson(poObj, srid);
-    }
-    else if (strcmp(pszInterp, "Stepwise") == 0)
-    {
-      json_object *poObjSeqs = findMemberByName(poObj, "sequences");
-      if (poObjSeqs != NULL)
-        result = (Temporal *)tpointseqset_from_mfjson(poObj, srid, false);
-      else
-        result = (Temporal *)tpointseq_from_mfjson(poObj, srid, false);
-    }
-    else if (strcmp(pszInterp, "Linear") == 0)
-    {
-      json_object *poObjSeqs = findMemberByName(poObj, "sequences");
-      if (poObjSeqs != NULL)
-        result = (Temporal *)tpointseqset_from_mfjson(poObj, srid, true);
-      else
-        result = (Temporal *)tpointseq_from_mfjson(poObj, srid, true);
-    }
+    if (doc.seqskind != MFJSON_MISSING)
+      result = (Temporal *)tpointseqset_from_mfjson(&doc, srid, false);
     else
-      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-        errmsg("Invalid 'interpolations' value in MFJSON string")));
+      result = (Temporal *)tpointseq_from_mfjson(&doc.seq, srid, false);
+  }
+  else if (doc.interp != NULL && strcmp(doc.interp, "Linear") == 0)
+  {
+    if (doc.seqskind != MFJSON_MISSING)
+      result = (Temporal *)tpointseqset_from_mfjson(&doc, srid, true);
+    else
+      result = (Temporal *)tpointseq_from_mfjson(&doc.seq, srid, true);
   }
+  else
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+      errmsg("Invalid 'interpolations' value in MFJSON string")));
 
   PG_RETURN_POINTER(result);
 }
@@ -497,6 +1115,8 @@ typedef struct
   bool has_srid;     /* SRID? */
   bool linear;     /* Linear Interpolation? */
   const uint8_t *pos; /* Current parse position */
+  GSERIALIZED *gs;   /* Point in which the coordinates are read */
+  double *coords;    /* Coordinates of the point */
 } wkb_parse_state;
 
 /**********************************************************************/
@@ -637,20 +1257,37 @@ tpoint_type_from_wkb_state(wkb_parse_state *s, uint8_t wkb_type)
 /**
  * Returns a point from its WKB representation. A WKB point has just a set of doubles, 
  * with the quantity depending on the dimension of the point.
+ *
+ * The point is serialized only once for the temporal point and its
+ * coordinates are overwritten for every instant. When the WKB has the
+ * endianness of the machine the coordinates are copied as a whole.
+ *
+ * @note The result is only valid until the next call of the function
  */
-Datum
+static Datum
 point_from_wkb_state(wkb_parse_state *s)
 {
-  double x, y, z;
-  x = double_from_wkb_state(s);
-  y = double_from_wkb_state(s);
-  if (s->has_z)
-    z = double_from_wkb_state(s);
-  LWPOINT *point = s->has_z ? lwpoint_make3dz(s->srid, x, y, z) :
-    lwpoint_make2d(s->srid, x, y);
-  Datum result = PointerGetDatum(geo_serialize((LWGEOM *) point));
-  lwpoint_free(point);
-  return result;
+  int ndims = (s->has_z) ? 3 : 2;
+  if (s->gs == NULL)
+  {
+    LWPOINT *point = s->has_z ? lwpoint_make3dz(s->srid, 0, 0, 0) :
+      lwpoint_make2d(s->srid, 0, 0);
+    s->gs = geo_serialize((LWGEOM *) point);
+    lwpoint_free(point);
+    s->coords = (double *) datum_get_point2d_p(PointerGetDatum(s->gs));
+  }
+  if (! s->swap_bytes)
+  {
+    wkb_parse_state_check(s, ndims * WKB_DOUBLE_SIZE);
+    memcpy(s->coords, s->pos, ndims * WKB_DOUBLE_SIZE);
+    s->pos += ndims * WKB_DOUBLE_SIZE;
+  }
+  else
+  {
+    for (int i = 0; i < ndims; i++)
+      s->coords[i] = double_from_wkb_state(s);
+  }
+  return PointerGetDatum(s->gs);
 }
 
 /**
@@ -671,9 +1308,7 @@ tpointinst_from_wkb_state(wkb_parse_state *s)
   /* Create the instant point */
   Datum value = point_from_wkb_state(s);
   TimestampTz t = timestamp_from_wkb_state(s);
-  TInstant *result = tinstant_make(value, t, type_oid(T_GEOMETRY)); // ????
-  pfree(DatumGetPointer(value));
-  return result;
+  return tinstant_make(value, t, type_oid(T_GEOMETRY));
 }
 
 /**
@@ -689,7 +1324,6 @@ tpointinstarr_from_wkb_state(wkb_parse_state *s, int count)
     Datum value = point_from_wkb_state(s);
     TimestampTz t = timestamp_from_wkb_state(s);
     result[i] = tinstant_make(value, t, type_oid(T_GEOMETRY));
-    pfree(DatumGetPointer(value));
   }
   return result;
 }
@@ -714,9 +1348,10 @@ tpointinstset_from_wkb_state(wkb_parse_state *s)
 }
 
 /**
- * Set the bound flags from their WKB representation
+ * Set the bound flags from their WKB representation. Returns true if the
+ * writer states that the sequence is already normalized.
  */
-static void
+static bool
 tpoint_bounds_from_wkb_state(uint8_t wkb_bounds, bool *lower_inc, bool *upper_inc)
 {
   if (wkb_bounds & WKB_LOWER_INC) 
@@ -727,7 +1362,7 @@ tpoint_bounds_from_wkb_state(uint8_t wkb_bounds, bool *lower_inc, bool *upper_in
     *upper_inc = true;
   else
     *upper_inc = false;
-  return;
+  return (wkb_bounds & WKB_NORMALIZED) != 0;
 }
 
 /**
@@ -744,14 +1379,15 @@ tpointseq_from_wkb_state(wkb_parse_state *s)
   /* Get the period bounds */
   uint8_t wkb_bounds = (uint8_t) byte_from_wkb_state(s);
   bool lower_inc, upper_inc;
-  tpoint_bounds_from_wkb_state(wkb_bounds, &lower_inc, &upper_inc);
+  bool normalized = tpoint_bounds_from_wkb_state(wkb_bounds, &lower_inc,
+    &upper_inc);
   /* Does the data we want to read exist? */
   size_t size = count * ((ndims * WKB_DOUBLE_SIZE) + WKB_TIMESTAMP_SIZE);
   wkb_parse_state_check(s, size);
   /* Parse the instants */
   TInstant **instants = tpointinstarr_from_wkb_state(s, count);
   return tsequence_make_free(instants, count, lower_inc, upper_inc,
-    s->linear, NORMALIZE); 
+    s->linear, normalized ? NORMALIZE_NO : NORMALIZE); 
 }
 
 /**
@@ -765,8 +1401,10 @@ tpointseqset_from_wkb_state(wkb_parse_state *s)
   /* Get the number of sequences */
   int count = integer_from_wkb_state(s);
   assert(count > 0);
-  /* Parse the sequences */
+  /* Parse the sequences. The sequence set is normalized unless the writer
+   * states that all its sequences are already normalized. */
   TSequence **sequences = palloc(sizeof(TSequence *) * count);
+  bool normalizedset = true;
   for (int i = 0; i < count; i++)
   {
     /* Get the number of instants */
@@ -774,30 +1412,25 @@ tpointseqset_from_wkb_state(wkb_parse_state *s)
     /* Get the period bounds */
     uint8_t wkb_bounds = (uint8_t) byte_from_wkb_state(s);
     bool lower_inc, upper_inc;
-    tpoint_bounds_from_wkb_state(wkb_bounds, &lower_inc, &upper_inc);
+    bool normalized = tpoint_bounds_from_wkb_state(wkb_bounds, &lower_inc,
+      &upper_inc);
+    normalizedset &= normalized;
     /* Does the data we want to read exist? */
     size_t size = countinst * ((ndims * WKB_DOUBLE_SIZE) + WKB_TIMESTAMP_SIZE);
     wkb_parse_state_check(s, size);
     /* Parse the instants */
-    TInstant **instants = palloc(sizeof(TInstant *) * countinst);
-    for (int j = 0; j < countinst; j++)
-    {
-      /* Parse the point and the timestamp to create the instant point */
-      Datum value = point_from_wkb_state(s);
-      TimestampTz t = timestamp_from_wkb_state(s);
-      instants[j] = tinstant_make(value, t, type_oid(T_GEOMETRY));
-      pfree(DatumGetPointer(value));
-    }
+    TInstant **instants = tpointinstarr_from_wkb_state(s, countinst);
     sequences[i] = tsequence_make_free(instants, countinst, lower_inc,
-      upper_inc, s->linear, NORMALIZE); 
+      upper_inc, s->linear, normalized ? NORMALIZE_NO : NORMALIZE); 
   }
-  return tsequenceset_make_free(sequences, count, NORMALIZE);
+  return tsequenceset_make_free(sequences, count,
+    normalizedset ? NORMALIZE_NO : NORMALIZE);
 }
 
 /**
  * Returns a temporal point from its WKB representation
  */
-Temporal *
+static Temporal *
 tpoint_from_wkb_state(wkb_parse_state *s)
 {
   /* Fail when handed incorrect starting byte */
@@ -859,8 +1492,12 @@ tpoint_from_ewkb(PG_FUNCTION_ARGS)
   s.has_srid = false;
   s.linear = false;
   s.pos = wkb;
+  s.gs = NULL;
+  s.coords = NULL;
 
   Temporal *temp = tpoint_from_wkb_state(&s);
+  if (s.gs != NULL)
+    pfree(s.gs);
   PG_FREE_IF_COPY(bytea_wkb, 0);
   PG_RETURN_POINTER(temp);
 }
@@ -0,0 +1,1061 @@
+/*****************************************************************************
+ *
+ * tpoint_joinscan.c
+ *    Custom scan provider for the spatiotemporal joins of temporal points.
+ *
+ * Without this provider, joins such as
+ * @code
+ * trips t1 JOIN trips t2 ON t1.trip && t2.trip
+ * trips JOIN zones ON intersects(trip, geom)
+ * @endcode
+ * are executed as nested loops that probe an index on the inner relation
+ * for every row of the outer relation. The provider, registered with the
+ * hook set_join_pathlist_hook, adds to the planner a join path that reads
+ * both inputs, computes the spatiotemporal boxes of their join keys,
+ * sorts them, and pairs the boxes that overlap with a plane sweep on the x
+ * dimension, or on the time dimension when the boxes have no spatial
+ * dimension. The candidate pairs are then filtered by the exact join
+ * clauses. The planner chooses the path when its cost, which grows with
+ * n log n instead of with the product of the sizes of the inputs, is lower
+ * than the one of the other join paths.
+ *
+ * The join key is derived from a join clause that implies that the
+ * bounding boxes of its arguments overlap, that is, the operator && or one
+ * of the spatial relationships known by the planner support function of
+ * temporal points, in which case the boxes of the inner relation are
+ * expanded by the distance of dwithin. The inputs are kept in memory in
+ * batches of at most half of work_mem each: when the outer input does not
+ * fit in one batch, the inner input is read again for every batch of the
+ * outer input, as in a block nested loop where each pair of batches is
+ * joined by the plane sweep. The provider is disabled by default and is
+ * enabled by the configuration parameter mobilitydb.enable_spatial_join.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_joinscan.h"
+
+#if MOBDB_PGSQL_VERSION >= 120000
+
+#include <float.h>
+#include <math.h>
+#include <fmgr.h>
+#include <access/htup_details.h>
+#include <miscadmin.h>
+#include <commands/explain.h>
+#include <executor/executor.h>
+#include <nodes/extensible.h>
+#include <nodes/makefuncs.h>
+#include <nodes/nodeFuncs.h>
+#include <optimizer/cost.h>
+#include <optimizer/optimizer.h>
+#include <optimizer/pathnode.h>
+#include <optimizer/paths.h>
+#include <optimizer/restrictinfo.h>
+#include <utils/lsyscache.h>
+#include <utils/memutils.h>
+
+#include "oidcache.h"
+#include "temporal.h"
+#include "postgis.h"
+#include "stbox.h"
+#include "tpoint_support.h"
+
+/**
+ * Global variable that enables the spatiotemporal join, which is the value
+ * of the configuration parameter mobilitydb.enable_spatial_join
+ */
+bool enable_spatial_join = false;
+
+static set_join_pathlist_hook_type prev_join_pathlist_hook = NULL;
+
+/*****************************************************************************
+ * Join keys
+ *****************************************************************************/
+
+/**
+ * Join key of a spatiotemporal join, which is given by a join clause whose
+ * arguments have overlapping bounding boxes
+ */
+typedef struct
+{
+  RestrictInfo *rinfo;  /**< Join clause from which the key is derived */
+  Expr *outerkey;       /**< Argument of the clause on the outer relation */
+  Expr *innerkey;       /**< Argument of the clause on the inner relation */
+  Expr *dist;           /**< Distance of dwithin, or NULL */
+} TPointJoinKey;
+
+/**
+ * Returns true if the type has a spatiotemporal box, where only the types
+ * whose box can be expanded by a distance are accepted for dwithin
+ */
+static bool
+tpoint_join_type(Oid typid, bool expand)
+{
+  if (typid == type_oid(T_TGEOMPOINT) || typid == type_oid(T_GEOMETRY))
+    return true;
+  if (expand)
+    return false;
+  return typid == type_oid(T_TGEOGPOINT) ||
+    typid == type_oid(T_GEOGRAPHY) || typid == type_oid(T_STBOX);
+}
+
+/**
+ * Returns the relations referenced by the expression
+ */
+static Relids
+tpoint_join_relids(PlannerInfo *root, Node *expr)
+{
+#if MOBDB_PGSQL_VERSION >= 140000
+  return pull_varnos(root, expr);
+#else
+  return pull_varnos(expr);
+#endif
+}
+
+/**
+ * Returns true if the join clause yields a join key, and sets the last
+ * argument to this key
+ */
+static bool
+tpoint_join_clause(PlannerInfo *root, RestrictInfo *rinfo,
+  Relids outer_relids, Relids inner_relids, TPointJoinKey *key)
+{
+  Expr *clause = rinfo->clause;
+  List *args;
+  bool expand = false;
+  if (IsA(clause, OpExpr))
+  {
+    char *name = get_func_name(get_opcode(((OpExpr *) clause)->opno));
+    bool overlaps = (name != NULL && strcmp(name, "overlaps_bbox") == 0);
+    if (name != NULL)
+      pfree(name);
+    if (! overlaps)
+      return false;
+    args = ((OpExpr *) clause)->args;
+  }
+  else if (IsA(clause, FuncExpr))
+  {
+    if (! tpoint_support_overlaps(((FuncExpr *) clause)->funcid, &expand))
+      return false;
+    args = ((FuncExpr *) clause)->args;
+  }
+  else
+    return false;
+  if (list_length(args) != (expand ? 3 : 2))
+    return false;
+
+  Expr *arg1 = (Expr *) linitial(args);
+  Expr *arg2 = (Expr *) lsecond(args);
+  if (! tpoint_join_type(exprType((Node *) arg1), expand) ||
+    ! tpoint_join_type(exprType((Node *) arg2), expand) ||
+    contain_volatile_functions((Node *) arg1) ||
+    contain_volatile_functions((Node *) arg2))
+    return false;
+  Relids relids1 = tpoint_join_relids(root, (Node *) arg1);
+  Relids relids2 = tpoint_join_relids(root, (Node *) arg2);
+  if (bms_is_empty(relids1) || bms_is_empty(relids2))
+    return false;
+  if (bms_is_subset(relids1, outer_relids) &&
+    bms_is_subset(relids2, inner_relids))
+  {
+    key->outerkey = arg1;
+    key->innerkey = arg2;
+  }
+  else if (bms_is_subset(relids2, outer_relids) &&
+    bms_is_subset(relids1, inner_relids))
+  {
+    key->outerkey = arg2;
+    key->innerkey = arg1;
+  }
+  else
+    return false;
+
+  key->dist = NULL;
+  if (expand)
+  {
+    /* The distance is evaluated once at the start of the join */
+    Expr *dist = (Expr *) lthird(args);
+    if (exprType((Node *) dist) != FLOAT8OID ||
+      ! bms_is_empty(tpoint_join_relids(root, (Node *) dist)) ||
+      contain_volatile_functions((Node *) dist))
+      return false;
+    key->dist = dist;
+  }
+  key->rinfo = rinfo;
+  return true;
+}
+
+/*****************************************************************************
+ * Paths and plans
+ *****************************************************************************/
+
+/**
+ * Dimension of the plane sweep
+ */
+typedef enum
+{
+  SWEEP_NONE,
+  SWEEP_X,
+  SWEEP_T,
+} TPointJoinAxis;
+
+/**
+ * Input row of the join with the box of its key
+ */
+typedef struct
+{
+  STBOX box;            /**< Box of the key */
+  double lower;         /**< Lower bound of the box on the sweep axis */
+  double upper;         /**< Upper bound of the box on the sweep axis */
+  MinimalTuple tuple;   /**< Row */
+} TPointJoinEntry;
+
+static Plan *tpoint_join_plan(PlannerInfo *root, RelOptInfo *rel,
+  CustomPath *best_path, List *tlist, List *clauses, List *custom_plans);
+static Node *tpoint_join_create_state(CustomScan *cscan);
+
+static CustomPathMethods tpoint_join_path_methods =
+{
+  .CustomName = "SpatialJoin",
+  .PlanCustomPath = tpoint_join_plan,
+};
+
+static CustomScanMethods tpoint_join_scan_methods =
+{
+  .CustomName = "SpatialJoin",
+  .CreateCustomScanState = tpoint_join_create_state,
+};
+
+/**
+ * Returns the base 2 logarithm of the number of rows, as in the cost of
+ * the sorts of PostgreSQL
+ */
+static double
+tpoint_join_log2(double rows)
+{
+  return (rows > 2.0) ? log(rows) / M_LN2 : 1.0;
+}
+
+/**
+ * Returns the size in memory of the rows of an input of the join
+ */
+static double
+tpoint_join_bytes(const Path *path)
+{
+  double width = MAXALIGN(sizeof(TPointJoinEntry)) +
+    MAXALIGN(path->pathtarget->width) + MAXALIGN(SizeofMinimalTupleHeader);
+  return path->rows * width;
+}
+
+/**
+ * Returns true if the boxes of the keys of the join will be compared by
+ * the sweep. The boxes of spatiotemporal boxes may have no common
+ * dimension, and no pair of rows is filtered out when the distance of
+ * dwithin is null or negative.
+ */
+static bool
+tpoint_join_sweepable(const TPointJoinKey *key)
+{
+  if (exprType((Node *) key->outerkey) == type_oid(T_STBOX) ||
+    exprType((Node *) key->innerkey) == type_oid(T_STBOX))
+    return false;
+  if (key->dist != NULL && IsA(key->dist, Const))
+  {
+    Const *dist = (Const *) key->dist;
+    return ! dist->constisnull && DatumGetFloat8(dist->constvalue) >= 0.0 &&
+      ! isnan(DatumGetFloat8(dist->constvalue));
+  }
+  return true;
+}
+
+/**
+ * Set the costs of the path
+ *
+ * The startup cost is the one of reading both inputs, evaluating their
+ * keys, copying their rows in memory, and sorting their boxes. The inputs
+ * are read in batches of half of work_mem, and the inner input is read
+ * again for every additional batch of the outer input. The number of
+ * pairs of overlapping boxes is estimated from the selectivity of the
+ * clause of the key, unless the boxes cannot be compared, in which case
+ * all the pairs are candidates. The run cost is the one of the rescans of
+ * the inner input, of the sweep, which compares each box with the lowest
+ * box of every batch of the other input and with about twice as many
+ * pairs, of the exact clauses on these pairs, and of the output rows.
+ */
+static void
+tpoint_join_cost(PlannerInfo *root, CustomPath *cpath, Path *outerpath,
+  Path *innerpath, TPointJoinKey *key, JoinPathExtraData *extra)
+{
+  double nouter = outerpath->rows, ninner = innerpath->rows;
+  double batchsize = (double) work_mem * 1024.0 / 2.0;
+  double nbatches = Max(ceil(tpoint_join_bytes(outerpath) / batchsize), 1.0);
+  double nchunks = Max(ceil(tpoint_join_bytes(innerpath) / batchsize), 1.0);
+  double npairs, ncomps;
+  if (tpoint_join_sweepable(key))
+  {
+    Selectivity sel = clause_selectivity(root, (Node *) key->rinfo, 0,
+      JOIN_INNER, extra->sjinfo);
+    npairs = clamp_row_est(nouter * ninner * sel);
+    ncomps = nouter * nchunks + ninner * nbatches + 2.0 * npairs;
+  }
+  else
+    ncomps = npairs = clamp_row_est(nouter * ninner);
+  QualCost qualcost;
+  cost_qual_eval(&qualcost, extract_actual_clauses(extra->restrictlist,
+    false), root);
+
+  /* Each row is read, its key is evaluated, and it is copied in memory */
+  Cost rowcost = cpu_tuple_cost + 2.0 * cpu_operator_cost;
+  Cost startup = outerpath->total_cost + innerpath->total_cost;
+  startup += (nouter + ninner) * rowcost;
+  startup += 2.0 * cpu_operator_cost *
+    (nouter * tpoint_join_log2(nouter / nbatches) +
+     ninner * tpoint_join_log2(ninner / nchunks));
+  startup += qualcost.startup + cpath->path.pathtarget->cost.startup;
+  Cost run = (nbatches - 1.0) * (innerpath->total_cost + ninner * rowcost +
+    2.0 * cpu_operator_cost * ninner * tpoint_join_log2(ninner / nchunks));
+  run += ncomps * cpu_operator_cost;
+  run += npairs * qualcost.per_tuple;
+  run += cpath->path.rows *
+    (cpu_tuple_cost + cpath->path.pathtarget->cost.per_tuple);
+  cpath->path.startup_cost = startup;
+  cpath->path.total_cost = startup + run;
+  return;
+}
+
+/**
+ * Adds the spatiotemporal join path to the join relation when the join has
+ * a join key (hook of the planner)
+ */
+static void
+tpoint_join_pathlist(PlannerInfo *root, RelOptInfo *joinrel,
+  RelOptInfo *outerrel, RelOptInfo *innerrel, JoinType jointype,
+  JoinPathExtraData *extra)
+{
+  if (prev_join_pathlist_hook)
+    prev_join_pathlist_hook(root, joinrel, outerrel, innerrel, jointype,
+      extra);
+  if (! enable_spatial_join || jointype != JOIN_INNER ||
+    ! bms_is_empty(joinrel->lateral_relids))
+    return;
+  Path *outerpath = outerrel->cheapest_total_path;
+  Path *innerpath = innerrel->cheapest_total_path;
+  if (outerpath == NULL || innerpath == NULL ||
+    PATH_REQ_OUTER(outerpath) != NULL || PATH_REQ_OUTER(innerpath) != NULL)
+    return;
+
+  TPointJoinKey key;
+  bool found = false;
+  ListCell *lc;
+  foreach (lc, extra->restrictlist)
+  {
+    RestrictInfo *rinfo = (RestrictInfo *) lfirst(lc);
+    /* The gating of the pseudoconstant clauses is left to the other paths */
+    if (rinfo->pseudoconstant)
+      return;
+    if (! found)
+      found = tpoint_join_clause(root, rinfo, outerrel->relids,
+        innerrel->relids, &key);
+  }
+  if (! found)
+    return;
+
+  CustomPath *cpath = makeNode(CustomPath);
+  cpath->path.pathtype = T_CustomScan;
+  cpath->path.parent = joinrel;
+  cpath->path.pathtarget = joinrel->reltarget;
+  cpath->path.param_info = NULL;
+  cpath->path.parallel_aware = false;
+  cpath->path.parallel_safe = joinrel->consider_parallel &&
+    outerpath->parallel_safe && innerpath->parallel_safe;
+  cpath->path.parallel_workers = 0;
+  cpath->path.rows = joinrel->rows;
+  cpath->path.pathkeys = NIL;
+  cpath->flags = 0;
+  cpath->custom_paths = list_make2(outerpath, innerpath);
+  List *keyexprs = list_make2(key.outerkey, key.innerkey);
+  if (key.dist != NULL)
+    keyexprs = lappend(keyexprs, key.dist);
+  cpath->custom_private = list_make2(extra->restrictlist, keyexprs);
+  cpath->methods = &tpoint_join_path_methods;
+  tpoint_join_cost(root, cpath, outerpath, innerpath, &key, extra);
+  add_path(joinrel, &cpath->path);
+  return;
+}
+
+/**
+ * Returns the plan of the spatiotemporal join path
+ *
+ * The scan tuple of the plan is composed of the columns of the outer plan
+ * followed by those of the inner plan. The join clauses are the quals of
+ * the plan and the keys are in the list custom_exprs.
+ */
+static Plan *
+tpoint_join_plan(PlannerInfo *root, RelOptInfo *rel, CustomPath *best_path,
+  List *tlist, List *clauses, List *custom_plans)
+{
+  List *restrictlist = (List *) linitial(best_path->custom_private);
+  List *keyexprs = (List *) lsecond(best_path->custom_private);
+  Plan *outerplan = (Plan *) linitial(custom_plans);
+  Plan *innerplan = (Plan *) lsecond(custom_plans);
+
+  List *scantlist = NIL;
+  AttrNumber resno = 1;
+  ListCell *lc;
+  foreach (lc, outerplan->targetlist)
+  {
+    TargetEntry *tle = (TargetEntry *) lfirst(lc);
+    scantlist = lappend(scantlist, makeTargetEntry(copyObject(tle->expr),
+      resno++, NULL, false));
+  }
+  foreach (lc, innerplan->targetlist)
+  {
+    TargetEntry *tle = (TargetEntry *) lfirst(lc);
+    scantlist = lappend(scantlist, makeTargetEntry(copyObject(tle->expr),
+      resno++, NULL, false));
+  }
+
+  CustomScan *cscan = makeNode(CustomScan);
+  cscan->scan.plan.targetlist = tlist;
+  cscan->scan.plan.qual = extract_actual_clauses(restrictlist, false);
+  cscan->scan.scanrelid = 0;
+  cscan->flags = best_path->flags;
+  cscan->custom_plans = custom_plans;
+  cscan->custom_exprs = copyObject(keyexprs);
+  cscan->custom_private =
+    list_make1(makeInteger(list_length(outerplan->targetlist)));
+  cscan->custom_scan_tlist = scantlist;
+  cscan->methods = &tpoint_join_scan_methods;
+  return &cscan->scan.plan;
+}
+
+/*****************************************************************************
+ * Execution
+ *****************************************************************************/
+
+/**
+ * Batch of rows of an input of the join, sorted on the lower bound of the
+ * boxes
+ */
+typedef struct
+{
+  ExprState *key;             /**< Key of the input */
+  Oid keytype;                /**< Type of the key */
+  TupleTableSlot *slot;       /**< Slot to read the rows of the input */
+  MemoryContext cxt;          /**< Context of the rows of the batch */
+  TPointJoinEntry *entries;   /**< Rows of the batch */
+  int count;                  /**< Number of rows */
+  int maxcount;               /**< Number of rows allocated */
+  Size size;                  /**< Size of the rows of the batch */
+  bool done;                  /**< True when all the rows have been read */
+  bool sorted;                /**< True when the rows are sorted on axis */
+  TPointJoinAxis axis;        /**< Dimension on which the rows are sorted */
+} TPointJoinInput;
+
+/**
+ * State of the plane sweep, which advances on the outer input when it has
+ * the next lowest box and on the inner input otherwise
+ */
+typedef enum
+{
+  SWEEP_NEXT,
+  SWEEP_OUTER,
+  SWEEP_INNER,
+} TPointJoinStep;
+
+/**
+ * State of the execution of the spatiotemporal join
+ */
+typedef struct
+{
+  CustomScanState css;
+  TPointJoinInput inputs[2];  /**< Outer and inner inputs */
+  int nouter;                 /**< Number of columns of the outer input */
+  ExprState *dist;            /**< Distance of dwithin, or NULL */
+  double distance;            /**< Value of the distance of dwithin */
+  bool valid;                 /**< False when the boxes are not compared */
+  Size maxsize;               /**< Maximum size of a batch in bytes */
+  bool loaded;                /**< True when the inputs have been read */
+  bool finished;              /**< True when all the pairs have been swept */
+  TPointJoinAxis axis;        /**< Dimension of the sweep */
+  TPointJoinStep step;        /**< Next step of the sweep */
+  int i, j, k;                /**< Positions of the sweep */
+  int64 npairs;               /**< Number of candidate pairs */
+  int64 nbatches;             /**< Number of pairs of batches swept */
+} TPointJoinState;
+
+static void tpoint_join_begin(CustomScanState *node, EState *estate,
+  int eflags);
+static TupleTableSlot *tpoint_join_exec(CustomScanState *node);
+static void tpoint_join_end(CustomScanState *node);
+static void tpoint_join_rescan(CustomScanState *node);
+static void tpoint_join_explain(CustomScanState *node, List *ancestors,
+  ExplainState *es);
+
+static CustomExecMethods tpoint_join_exec_methods =
+{
+  .CustomName = "SpatialJoin",
+  .BeginCustomScan = tpoint_join_begin,
+  .ExecCustomScan = tpoint_join_exec,
+  .EndCustomScan = tpoint_join_end,
+  .ReScanCustomScan = tpoint_join_rescan,
+  .ExplainCustomScan = tpoint_join_explain,
+};
+
+/**
+ * Returns the state of the execution of the plan
+ */
+static Node *
+tpoint_join_create_state(CustomScan *cscan)
+{
+  TPointJoinState *state = palloc0(sizeof(TPointJoinState));
+  NodeSetTag(state, T_CustomScanState);
+  state->css.flags = cscan->flags;
+  state->css.methods = &tpoint_join_exec_methods;
+  return (Node *) state;
+}
+
+/**
+ * Initialize the execution of the join
+ */
+static void
+tpoint_join_begin(CustomScanState *node, EState *estate, int eflags)
+{
+  TPointJoinState *state = (TPointJoinState *) node;
+  CustomScan *cscan = (CustomScan *) node->ss.ps.plan;
+  state->nouter = intVal(linitial(cscan->custom_private));
+  for (int i = 0; i < 2; i++)
+  {
+    PlanState *ps = ExecInitNode((Plan *) list_nth(cscan->custom_plans, i),
+      estate, eflags);
+    node->custom_ps = lappend(node->custom_ps, ps);
+    Expr *key = (Expr *) list_nth(cscan->custom_exprs, i);
+    state->inputs[i].key = ExecInitExpr(key, &node->ss.ps);
+    state->inputs[i].keytype = exprType((Node *) key);
+    state->inputs[i].slot = MakeSingleTupleTableSlot(ExecGetResultType(ps),
+      &TTSOpsMinimalTuple);
+    state->inputs[i].cxt = AllocSetContextCreate(estate->es_query_cxt,
+      "SpatialJoin", ALLOCSET_DEFAULT_SIZES);
+  }
+  if (list_length(cscan->custom_exprs) > 2)
+    state->dist = ExecInitExpr((Expr *) lthird(cscan->custom_exprs),
+      &node->ss.ps);
+  state->maxsize = (Size) work_mem * 1024L / 2;
+  return;
+}
+
+/**
+ * Store in the scan tuple the columns of the row of the input, the other
+ * columns being null
+ */
+static void
+tpoint_join_store(TPointJoinState *state, TupleTableSlot *scanslot,
+  int input, TupleTableSlot *slot, bool clear)
+{
+  int offset = (input == 0) ? 0 : state->nouter;
+  if (clear)
+  {
+    ExecClearTuple(scanslot);
+    for (int i = 0; i < scanslot->tts_tupleDescriptor->natts; i++)
+      scanslot->tts_isnull[i] = true;
+  }
+  slot_getallattrs(slot);
+  int natts = slot->tts_tupleDescriptor->natts;
+  memcpy(&scanslot->tts_values[offset], slot->tts_values,
+    sizeof(Datum) * natts);
+  memcpy(&scanslot->tts_isnull[offset], slot->tts_isnull,
+    sizeof(bool) * natts);
+  return;
+}
+
+/**
+ * Set the first argument to the box of the key, and returns false when the
+ * key is an empty geometry, whose spatial relationships are never true
+ */
+static bool
+tpoint_join_box(STBOX *box, Datum value, Oid keytype)
+{
+  memset(box, 0, sizeof(STBOX));
+  if (keytype == type_oid(T_STBOX))
+  {
+    memcpy(box, DatumGetSTboxP(value), sizeof(STBOX));
+    return true;
+  }
+  if (keytype == type_oid(T_GEOMETRY) || keytype == type_oid(T_GEOGRAPHY))
+  {
+    GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(value);
+    if (gserialized_is_empty(gs))
+      return false;
+    geo_to_stbox_internal(box, gs);
+    return true;
+  }
+  temporal_bbox_slice(box, value);
+  return true;
+}
+
+/**
+ * Free the rows of the batch of the input
+ */
+static void
+tpoint_join_clear(TPointJoinInput *in)
+{
+  ExecClearTuple(in->slot);
+  in->entries = NULL;
+  in->count = in->maxcount = 0;
+  in->size = 0;
+  in->sorted = false;
+  MemoryContextReset(in->cxt);
+  return;
+}
+
+/**
+ * Read the next batch of rows of the input and compute the boxes of their
+ * keys, where the batch ends when its size reaches half of work_mem. The
+ * rows whose key is null are skipped since the join clauses are strict.
+ */
+static void
+tpoint_join_read(TPointJoinState *state, int input, double dist)
+{
+  TPointJoinInput *in = &state->inputs[input];
+  PlanState *ps = (PlanState *) list_nth(state->css.custom_ps, input);
+  ExprContext *econtext = state->css.ss.ps.ps_ExprContext;
+  TupleTableSlot *scanslot = state->css.ss.ss_ScanTupleSlot;
+  tpoint_join_clear(in);
+  while (in->size < state->maxsize)
+  {
+    TupleTableSlot *slot = ExecProcNode(ps);
+    if (TupIsNull(slot))
+    {
+      in->done = true;
+      break;
+    }
+    ResetExprContext(econtext);
+    tpoint_join_store(state, scanslot, input, slot, true);
+    ExecStoreVirtualTuple(scanslot);
+    econtext->ecxt_scantuple = scanslot;
+    bool isnull;
+    Datum value = ExecEvalExprSwitchContext(in->key, econtext, &isnull);
+    if (isnull)
+      continue;
+    STBOX box;
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+    bool found = tpoint_join_box(&box, value, in->keytype);
+    MemoryContextSwitchTo(oldcontext);
+    if (! found)
+      continue;
+    if (dist > 0.0 && MOBDB_FLAGS_GET_X(box.flags))
+    {
+      box.xmin -= dist; box.xmax += dist;
+      box.ymin -= dist; box.ymax += dist;
+      box.zmin -= dist; box.zmax += dist;
+    }
+
+    oldcontext = MemoryContextSwitchTo(in->cxt);
+    if (in->count == in->maxcount)
+    {
+      in->maxcount = (in->maxcount == 0) ? 1024 : in->maxcount * 2;
+      in->entries = (in->entries == NULL) ?
+        MemoryContextAllocHuge(in->cxt,
+          sizeof(TPointJoinEntry) * in->maxcount) :
+        repalloc_huge(in->entries, sizeof(TPointJoinEntry) * in->maxcount);
+    }
+    TPointJoinEntry *entry = &in->entries[in->count++];
+    entry->box = box;
+    entry->tuple = ExecCopySlotMinimalTuple(slot);
+    in->size += sizeof(TPointJoinEntry) + entry->tuple->t_len;
+    MemoryContextSwitchTo(oldcontext);
+  }
+  ExecClearTuple(scanslot);
+  return;
+}
+
+/**
+ * Comparator of the rows of an input on the lower bound of their boxes
+ */
+static int
+tpoint_join_cmp(const void *a, const void *b)
+{
+  double l1 = ((const TPointJoinEntry *) a)->lower;
+  double l2 = ((const TPointJoinEntry *) b)->lower;
+  return (l1 < l2) ? -1 : ((l1 > l2) ? 1 : 0);
+}
+
+/**
+ * Returns the dimension of the sweep. The bounding boxes are only
+ * compared when all the boxes with a spatial dimension have the same
+ * SRID, the same number of dimensions, and are either all geodetic or all
+ * not, so that the pairs on which the exact clauses raise an error are
+ * not filtered out.
+ */
+static TPointJoinAxis
+tpoint_join_axis(TPointJoinState *state, bool valid)
+{
+  bool allx = true, allt = true, first = true;
+  int32 srid = 0;
+  int16 flags = 0;
+  for (int i = 0; i < 2 && valid; i++)
+  {
+    TPointJoinInput *in = &state->inputs[i];
+    for (int j = 0; j < in->count; j++)
+    {
+      const STBOX *box = &in->entries[j].box;
+      allx &= MOBDB_FLAGS_GET_X(box->flags);
+      allt &= MOBDB_FLAGS_GET_T(box->flags);
+      if (! MOBDB_FLAGS_GET_X(box->flags))
+        continue;
+      if (first)
+      {
+        srid = box->srid;
+        flags = box->flags;
+        first = false;
+      }
+      else if (box->srid != srid ||
+        MOBDB_FLAGS_GET_Z(box->flags) != MOBDB_FLAGS_GET_Z(flags) ||
+        MOBDB_FLAGS_GET_GEODETIC(box->flags) != MOBDB_FLAGS_GET_GEODETIC(flags))
+        return SWEEP_NONE;
+    }
+  }
+  if (! valid)
+    return SWEEP_NONE;
+  return allx ? SWEEP_X : (allt ? SWEEP_T : SWEEP_NONE);
+}
+
+/**
+ * Sort the boxes of the batch of the input on the sweep axis, unless they
+ * are already sorted on it
+ */
+static void
+tpoint_join_sort(TPointJoinInput *in, TPointJoinAxis axis)
+{
+  if (in->sorted && in->axis == axis)
+    return;
+  for (int j = 0; j < in->count; j++)
+  {
+    TPointJoinEntry *entry = &in->entries[j];
+    if (axis == SWEEP_X)
+    {
+      entry->lower = entry->box.xmin;
+      entry->upper = entry->box.xmax;
+    }
+    else if (axis == SWEEP_T)
+    {
+      entry->lower = (double) entry->box.tmin;
+      entry->upper = (double) entry->box.tmax;
+    }
+    else
+    {
+      entry->lower = -DBL_MAX;
+      entry->upper = DBL_MAX;
+    }
+  }
+  if (axis != SWEEP_NONE && in->count > 1)
+    qsort(in->entries, (size_t) in->count, sizeof(TPointJoinEntry),
+      tpoint_join_cmp);
+  in->sorted = true;
+  in->axis = axis;
+  return;
+}
+
+/**
+ * Read the next pair of batches of the inputs and sort their boxes on the
+ * sweep axis, and returns false when all the pairs of batches have been
+ * swept
+ *
+ * The next batch of the inner input is read until the inner input is
+ * exhausted, in which case the next batch of the outer input is read and
+ * the inner input is rescanned.
+ */
+static bool
+tpoint_join_load(TPointJoinState *state)
+{
+  TPointJoinInput *r = &state->inputs[0], *s = &state->inputs[1];
+  bool first = true;
+  if (state->finished)
+    return false;
+  if (! state->loaded)
+  {
+    state->distance = 0.0;
+    state->valid = true;
+    if (state->dist != NULL)
+    {
+      ExprContext *econtext = state->css.ss.ps.ps_ExprContext;
+      bool isnull;
+      Datum value = ExecEvalExprSwitchContext(state->dist, econtext,
+        &isnull);
+      /* The pairs are not filtered for the distances on which dwithin is
+       * not true or raises an error */
+      state->distance = isnull ? 0.0 : DatumGetFloat8(value);
+      state->valid = ! isnull && state->distance >= 0.0 &&
+        ! isnan(state->distance);
+    }
+    state->loaded = true;
+    tpoint_join_read(state, 0, 0.0);
+  }
+  else if (! s->done)
+    first = false;
+  else if (r->done)
+  {
+    state->finished = true;
+    return false;
+  }
+  else
+  {
+    tpoint_join_read(state, 0, 0.0);
+    ExecReScan((PlanState *) lsecond(state->css.custom_ps));
+    s->done = false;
+  }
+  tpoint_join_read(state, 1, state->valid ? state->distance : 0.0);
+  /* No pair remains when a batch of the outer input or the whole inner
+   * input is empty */
+  if (r->count == 0 || (first && s->count == 0))
+  {
+    state->finished = true;
+    return false;
+  }
+
+  state->axis = tpoint_join_axis(state, state->valid);
+  tpoint_join_sort(r, state->axis);
+  tpoint_join_sort(s, state->axis);
+  state->nbatches++;
+  state->step = SWEEP_NEXT;
+  state->i = state->j = state->k = 0;
+  return true;
+}
+
+/**
+ * Returns true if the boxes overlap on their common dimensions, as the
+ * operator &&. All the pairs are candidates when the boxes are not
+ * compared.
+ */
+static bool
+tpoint_join_overlaps(const TPointJoinState *state, const STBOX *box1,
+  const STBOX *box2)
+{
+  if (state->axis == SWEEP_NONE)
+    return true;
+  bool hasx = MOBDB_FLAGS_GET_X(box1->flags) && MOBDB_FLAGS_GET_X(box2->flags);
+  bool hasz = MOBDB_FLAGS_GET_Z(box1->flags) && MOBDB_FLAGS_GET_Z(box2->flags);
+  bool hast = MOBDB_FLAGS_GET_T(box1->flags) && MOBDB_FLAGS_GET_T(box2->flags);
+  bool geodetic = MOBDB_FLAGS_GET_GEODETIC(box1->flags) &&
+    MOBDB_FLAGS_GET_GEODETIC(box2->flags);
+  if (hasx && (box1->xmax < box2->xmin || box1->xmin > box2->xmax ||
+    box1->ymax < box2->ymin || box1->ymin > box2->ymax))
+    return false;
+  if (hasx && (hasz || geodetic) &&
+    (box1->zmax < box2->zmin || box1->zmin > box2->zmax))
+    return false;
+  if (hast && (box1->tmax < box2->tmin || box1->tmin > box2->tmax))
+    return false;
+  return true;
+}
+
+/**
+ * Set the arguments to the positions of the next pair of rows of the outer
+ * and the inner inputs whose boxes overlap, and returns false when there
+ * are no more pairs
+ *
+ * The sweep takes the input with the lowest box not yet swept and compares
+ * this box with the boxes of the other input whose lower bound is not
+ * greater than its upper bound. Each pair of overlapping boxes is thus
+ * produced exactly once.
+ */
+static bool
+tpoint_join_sweep(TPointJoinState *state, int *outer, int *inner)
+{
+  TPointJoinInput *r = &state->inputs[0], *s = &state->inputs[1];
+  for (;;)
+  {
+    if (state->step == SWEEP_OUTER)
+    {
+      const TPointJoinEntry *entry = &r->entries[state->i];
+      while (state->k < s->count &&
+        s->entries[state->k].lower <= entry->upper)
+      {
+        int k = state->k++;
+        if (tpoint_join_overlaps(state, &entry->box, &s->entries[k].box))
+        {
+          *outer = state->i;
+          *inner = k;
+          return true;
+        }
+      }
+      state->i++;
+    }
+    else if (state->step == SWEEP_INNER)
+    {
+      const TPointJoinEntry *entry = &s->entries[state->j];
+      while (state->k < r->count &&
+        r->entries[state->k].lower <= entry->upper)
+      {
+        int k = state->k++;
+        if (tpoint_join_overlaps(state, &r->entries[k].box, &entry->box))
+        {
+          *outer = k;
+          *inner = state->j;
+          return true;
+        }
+      }
+      state->j++;
+    }
+    if (state->i >= r->count || state->j >= s->count)
+    {
+      state->step = SWEEP_NEXT;
+      return false;
+    }
+    if (r->entries[state->i].lower < s->entries[state->j].lower)
+    {
+      state->step = SWEEP_OUTER;
+      state->k = state->j;
+    }
+    else
+    {
+      state->step = SWEEP_INNER;
+      state->k = state->i;
+    }
+  }
+}
+
+/**
+ * Returns the scan tuple of the next candidate pair of rows, or an empty
+ * slot when there are no more pairs
+ */
+static TupleTableSlot *
+tpoint_join_next(ScanState *node)
+{
+  TPointJoinState *state = (TPointJoinState *) node;
+  TupleTableSlot *scanslot = node->ss_ScanTupleSlot;
+  int outer, inner;
+  while (! state->loaded || ! tpoint_join_sweep(state, &outer, &inner))
+  {
+    if (! tpoint_join_load(state))
+      return ExecClearTuple(scanslot);
+  }
+  state->npairs++;
+  for (int i = 0; i < 2; i++)
+  {
+    TPointJoinInput *in = &state->inputs[i];
+    ExecStoreMinimalTuple(in->entries[i == 0 ? outer : inner].tuple,
+      in->slot, false);
+    tpoint_join_store(state, scanslot, i, in->slot, i == 0);
+  }
+  return ExecStoreVirtualTuple(scanslot);
+}
+
+/**
+ * Recheck the scan tuple, which is not needed since the quals of the
+ * plan contain all the join clauses
+ */
+static bool
+tpoint_join_recheck(ScanState *node, TupleTableSlot *slot)
+{
+  return true;
+}
+
+/**
+ * Returns the next row of the join
+ */
+static TupleTableSlot *
+tpoint_join_exec(CustomScanState *node)
+{
+  return ExecScan(&node->ss, (ExecScanAccessMtd) tpoint_join_next,
+    (ExecScanRecheckMtd) tpoint_join_recheck);
+}
+
+/**
+ * Free the rows read from the inputs
+ */
+static void
+tpoint_join_reset(TPointJoinState *state)
+{
+  for (int i = 0; i < 2; i++)
+  {
+    tpoint_join_clear(&state->inputs[i]);
+    state->inputs[i].done = false;
+  }
+  state->loaded = state->finished = false;
+  return;
+}
+
+/**
+ * Finish the execution of the join
+ */
+static void
+tpoint_join_end(CustomScanState *node)
+{
+  TPointJoinState *state = (TPointJoinState *) node;
+  tpoint_join_reset(state);
+  for (int i = 0; i < 2; i++)
+  {
+    MemoryContextDelete(state->inputs[i].cxt);
+    ExecDropSingleTupleTableSlot(state->inputs[i].slot);
+  }
+  ListCell *lc;
+  foreach (lc, node->custom_ps)
+    ExecEndNode((PlanState *) lfirst(lc));
+  return;
+}
+
+/**
+ * Restart the join, which reads again its inputs
+ */
+static void
+tpoint_join_rescan(CustomScanState *node)
+{
+  TPointJoinState *state = (TPointJoinState *) node;
+  tpoint_join_reset(state);
+  ListCell *lc;
+  foreach (lc, node->custom_ps)
+  {
+    PlanState *ps = (PlanState *) lfirst(lc);
+    /* The inputs whose parameters changed are rescanned by ExecProcNode */
+    if (ps->chgParam == NULL)
+      ExecReScan(ps);
+  }
+  ExecScanReScan(&node->ss);
+  return;
+}
+
+/**
+ * Show the dimension of the last sweep, the number of pairs of batches,
+ * and the number of candidate pairs in the output of EXPLAIN ANALYZE
+ */
+static void
+tpoint_join_explain(CustomScanState *node, List *ancestors, ExplainState *es)
+{
+  TPointJoinState *state = (TPointJoinState *) node;
+  if (! es->analyze || state->nbatches == 0)
+    return;
+  const char *axis = (state->axis == SWEEP_X) ? "x" :
+    ((state->axis == SWEEP_T) ? "t" : "none");
+  ExplainPropertyText("Sweep Axis", axis, es);
+  ExplainPropertyInteger("Batches", NULL, state->nbatches, es);
+  ExplainPropertyInteger("Candidate Pairs", NULL, state->npairs, es);
+  return;
+}
+
+/*****************************************************************************
+ * Registration
+ *****************************************************************************/
+
+/**
+ * Register the custom scan provider, which is called when the extension
+ * is loaded
+ */
+void
+tpoint_joinscan_init(void)
+{
+  RegisterCustomScanMethods(&tpoint_join_scan_methods);
+  prev_join_pathlist_hook = set_join_pathlist_hook;
+  set_join_pathlist_hook = tpoint_join_pathlist;
+  return;
+}
+
+#endif /* MOBDB_PGSQL_VERSION >= 120000 */
+
+/*****************************************************************************/
@@ -14,13 +14,18 @@
 
 #include <assert.h>
 #include <float.h>
+#include <funcapi.h>
+#include <lib/stringinfo.h>
 #include <utils/builtins.h>
+#include <utils/datetime.h>
+#include <utils/timestamp.h>
 
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
+#include "tpoint_analytics.h"
 
 /* The following definitions are taken from PostGIS */
 
@@ -263,398 +268,238 @@ tpointarr_as_ewkt(PG_FUNCTION_ARGS)
 
 /*****************************************************************************
  * Output in MFJSON format 
+ *
+ * The MF-JSON representation is written in a single pass into a growable
+ * buffer. The timestamps are written with a fixed-format ISO 8601 printer
+ * instead of the output function of timestamptz.
  *****************************************************************************/
 
 /**
- * Returns the maximum size in bytes of the coordinate array represented in
- * MF-JSON format
+ * Writes into the buffer the double with the given precision
  */
-static size_t
-coordinates_mfjson_size(int npoints, bool hasz, int precision)
+static void
+double_mfjson_buf(StringInfo buf, double d, int precision)
 {
   assert(precision <= OUT_MAX_DOUBLE_PRECISION);
-  if (hasz)
-    return (OUT_MAX_DIGS_DOUBLE + precision + sizeof(","))
-      * 3 * npoints + sizeof(",[]");
-  else
-    return (OUT_MAX_DIGS_DOUBLE + precision + sizeof(","))
-      * 2 * npoints + sizeof(",[]");
+  enlargeStringInfo(buf, OUT_DOUBLE_BUFFER_SIZE);
+  buf->len += lwprint_double(d, precision, buf->data + buf->len,
+    OUT_DOUBLE_BUFFER_SIZE);
+  return;
 }
 
 /**
  * Writes into the buffer the coordinate array represented in MF-JSON format
  */
-static size_t
-coordinates_mfjson_buf(char *output, const TInstant *inst, int precision)
+static void
+coordinates_mfjson_buf(StringInfo buf, const TInstant *inst, int precision)
 {
-  char *ptr;
-  char x[OUT_DOUBLE_BUFFER_SIZE];
-  char y[OUT_DOUBLE_BUFFER_SIZE];
-
-  assert (precision <= OUT_MAX_DOUBLE_PRECISION);
-  ptr = output;
-
+  appendStringInfoChar(buf, '[');
   if (MOBDB_FLAGS_GET_Z(inst->flags))
   {
-    char z[OUT_DOUBLE_BUFFER_SIZE];
     const POINT3DZ *pt = datum_get_point3dz_p(tinstant_value(inst));
-    lwprint_double(pt->x, precision, x, OUT_DOUBLE_BUFFER_SIZE);
-    lwprint_double(pt->y, precision, y, OUT_DOUBLE_BUFFER_SIZE);
-    lwprint_double(pt->z, precision, z, OUT_DOUBLE_BUFFER_SIZE);
-    ptr += sprintf(ptr, "[%s,%s,%s]", x, y, z);
+    double_mfjson_buf(buf, pt->x, precision);
+    appendStringInfoChar(buf, ',');
+    double_mfjson_buf(buf, pt->y, precision);
+    appendStringInfoChar(buf, ',');
+    double_mfjson_buf(buf, pt->z, precision);
   }
   else
   {
     const POINT2D *pt = datum_get_point2d_p(tinstant_value(inst));
-    lwprint_double(pt->x, precision, x, OUT_DOUBLE_BUFFER_SIZE);
-    lwprint_double(pt->y, precision, y, OUT_DOUBLE_BUFFER_SIZE);
-    ptr += sprintf(ptr, "[%s,%s]", x, y);
+    double_mfjson_buf(buf, pt->x, precision);
+    appendStringInfoChar(buf, ',');
+    double_mfjson_buf(buf, pt->y, precision);
   }
-  return (ptr - output);
+  appendStringInfoChar(buf, ']');
+  return;
 }
 
 /**
- * Returns the maximum size in bytes of the datetimes array represented 
- * in MF-JSON format.
+ * Writes into the buffer the timestamp in ISO 8601 format, e.g.,
+ * 2019-08-06T18:35:48.021455+02:30
  *
- * For example `"datetimes":["2019-08-06T18:35:48.021455+02:30","2019-08-06T18:45:18.476983+02:30"]`
- * will return  2 enclosing brackets + 1 comma + 
- * for each timestamptz 32 characters + 2 double quotes + 1 comma
- */
-static size_t
-datetimes_mfjson_size(int npoints)
-{
-  return sizeof("\"2019-08-06T18:35:48.021455+02:30\",") * npoints + sizeof("[],");
-}
-
-/**
- * Writes into the buffer the datetimes array represented in MF-JSON format
+ * @param[in] buf Buffer
+ * @param[in] t Timestamp
+ * @param[in] sep Separator between the date and the time parts
  */
-static size_t
-datetimes_mfjson_buf(char *output, const TInstant *inst)
+static void
+timestamp_mfjson_buf(StringInfo buf, TimestampTz t, char sep)
 {
-  char *ptr = output;
-  char *t = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(inst->t));
-  /* Replace ' ' by 'T' as separator between date and time parts */
-  t[10] = 'T';
-  ptr += sprintf(ptr, "\"%s\"", t);
-  pfree(t);
-  return (ptr - output);
+  enlargeStringInfo(buf, MAXDATELEN + 1);
+  int len = timestamp_iso_write(buf->data + buf->len, t, sep);
+  if (len > 0)
+  {
+    buf->len += len;
+    return;
+  }
+  /* Dates before Christ or after 9999 keep the output function */
+  char *str = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(t));
+  if (str[10] == ' ')
+    str[10] = sep;
+  appendStringInfoString(buf, str);
+  pfree(str);
+  return;
 }
 
 /**
- * Returns the maximum size in bytes of the SRS represented in MF-JSON format
+ * Writes into the buffer the datetime of the instant represented in
+ * MF-JSON format
  */
-static size_t
-srs_mfjson_size(char *srs)
+static void
+datetimes_mfjson_buf(StringInfo buf, const TInstant *inst)
 {
-  size_t size = sizeof("'crs':{'type':'name',");
-  size += sizeof("'properties':{'name':''}},");
-  size += strlen(srs) * sizeof(char);
-  return size;
+  appendStringInfoChar(buf, '"');
+  timestamp_mfjson_buf(buf, inst->t, 'T');
+  appendStringInfoChar(buf, '"');
+  return;
 }
 
 /**
  * Writes into the buffer the SRS represented in MF-JSON format
  */
-static size_t
-srs_mfjson_buf(char *output, char *srs)
-{
-  char *ptr = output;
-  ptr += sprintf(ptr, "\"crs\":{\"type\":\"name\",");
-  ptr += sprintf(ptr, "\"properties\":{\"name\":\"%s\"}},", srs);
-  return (ptr - output);
-}
-
-/**
- * Returns the maximum size in bytes of the bouding box represented in 
- * MF-JSON format
- */
-static size_t
-bbox_mfjson_size(int hasz, int precision)
+static void
+srs_mfjson_buf(StringInfo buf, char *srs)
 {
-  /* The maximum size of a timestamptz is 35 characters, e.g., "2019-08-06 23:18:16.195062-09:30" */
-  size_t size = sizeof("'stBoundedBy':{'period':{'begin':,'end':}},") +
-    sizeof("\"2019-08-06T18:35:48.021455+02:30\",") * 2;
-  if (!hasz)
-  {
-    size += sizeof("'bbox':[,,,],");
-    size +=  2 * 2 * (OUT_MAX_DIGS_DOUBLE + precision);
-  }
-  else
-  {
-    size += sizeof("\"bbox\":[,,,,,],");
-    size +=  2 * 3 * (OUT_MAX_DIGS_DOUBLE + precision);
-  }
-  return size;
+  appendStringInfoString(buf, "\"crs\":{\"type\":\"name\",");
+  appendStringInfo(buf, "\"properties\":{\"name\":\"%s\"}},", srs);
+  return;
 }
 
 /**
  * Writes into the buffer the bouding box represented in MF-JSON format
  */
-static size_t
-bbox_mfjson_buf(char *output, const STBOX *bbox, int hasz, int precision)
+static void
+bbox_mfjson_buf(StringInfo buf, const STBOX *bbox, int hasz, int precision)
 {
-  char *ptr = output;
-  ptr += sprintf(ptr, "\"stBoundedBy\":{");
+  appendStringInfoString(buf, "\"stBoundedBy\":{");
   if (!hasz)
-    ptr += sprintf(ptr, "\"bbox\":[%.*f,%.*f,%.*f,%.*f],",
+    appendStringInfo(buf, "\"bbox\":[%.*f,%.*f,%.*f,%.*f],",
       precision, bbox->xmin, precision, bbox->ymin,
       precision, bbox->xmax, precision, bbox->ymax);
   else
-    ptr += sprintf(ptr, "\"bbox\":[%.*f,%.*f,%.*f,%.*f,%.*f,%.*f],",
+    appendStringInfo(buf, "\"bbox\":[%.*f,%.*f,%.*f,%.*f,%.*f,%.*f],",
       precision, bbox->xmin, precision, bbox->ymin, precision, bbox->zmin,
       precision, bbox->xmax, precision, bbox->ymax, precision, bbox->zmax);
-  char *begin = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(bbox->tmin));
-  char *end = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(bbox->tmax));
-  ptr += sprintf(ptr, "\"period\":{\"begin\":\"%s\",\"end\":\"%s\"}},", begin, end);
-  pfree(begin); pfree(end);
-  return (ptr - output);
-}
-
-/*****************************************************************************/
-
-/**
- * Returns the maximum size in bytes of a temporal instant point represented
- * in MF-JSON format
- */
-static size_t
-tpointinst_as_mfjson_size(const TInstant *inst, int precision,
-  const STBOX *bbox, char *srs)
-{
-  size_t size = coordinates_mfjson_size(1,
-    MOBDB_FLAGS_GET_Z(inst->flags), precision);
-  size += datetimes_mfjson_size(1);
-  size += sizeof("{'type':'MovingPoint',");
-  size += sizeof("'coordinates':,'datetimes':,'interpolations':['Discrete']}");
-  if (srs) size += srs_mfjson_size(srs);
-  if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(inst->flags), precision);
-  return size;
-}
-
-/**
- * Writes into the buffer the temporal instant point represented in MF-JSON format
- */
-static size_t
-tpointinst_as_mfjson_buf(const TInstant *inst, int precision,
-  const STBOX *bbox, char *srs, char *output)
-{
-  char *ptr = output;
-  ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-  if (srs) ptr += srs_mfjson_buf(ptr, srs);
-  if (bbox) ptr += bbox_mfjson_buf(ptr, bbox,
-    MOBDB_FLAGS_GET_Z(inst->flags), precision);
-  ptr += sprintf(ptr, "\"coordinates\":");
-  ptr += coordinates_mfjson_buf(ptr, inst, precision);
-  ptr += sprintf(ptr, ",\"datetimes\":");
-  ptr += datetimes_mfjson_buf(ptr, inst);
-  ptr += sprintf(ptr, ",\"interpolations\":[\"Discrete\"]}");
-  return (ptr - output);
+  appendStringInfoString(buf, "\"period\":{\"begin\":\"");
+  timestamp_mfjson_buf(buf, bbox->tmin, ' ');
+  appendStringInfoString(buf, "\",\"end\":\"");
+  timestamp_mfjson_buf(buf, bbox->tmax, ' ');
+  appendStringInfoString(buf, "\"}},");
+  return;
 }
 
 /**
- * Returns the temporal instant point represented in MF-JSON format
+ * Writes into the buffer the header of the temporal point represented in
+ * MF-JSON format
  */
-static char *
-tpointinst_as_mfjson(const TInstant *inst, int precision,
+static void
+tpoint_mfjson_header_buf(StringInfo buf, const Temporal *temp, int precision,
   const STBOX *bbox, char *srs)
 {
-  size_t size = tpointinst_as_mfjson_size(inst, precision, bbox, srs);
-  char *output = palloc(size);
-  tpointinst_as_mfjson_buf(inst, precision, bbox, srs, output);
-  return output;
-}
-
-/*****************************************************************************/
-
-/**
- * Returns the maximum size in bytes of a temporal instant set point 
- * represented in MF-JSON format
- */
-static size_t
-tpointinstset_as_mfjson_size(const TInstantSet *ti, int precision, const STBOX *bbox,
-  char *srs)
-{
-  size_t size = coordinates_mfjson_size(ti->count,
-    MOBDB_FLAGS_GET_Z(ti->flags), precision);
-  size += datetimes_mfjson_size(ti->count);
-  size += sizeof("{'type':'MovingPoint',");
-  size += sizeof("'coordinates':[],'datetimes':[],'interpolations':['Discrete']}");
-  if (srs) size += srs_mfjson_size(srs);
-  if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(ti->flags), precision);
-  return size;
+  appendStringInfoString(buf, "{\"type\":\"MovingPoint\",");
+  if (srs) srs_mfjson_buf(buf, srs);
+  if (bbox) bbox_mfjson_buf(buf, bbox, MOBDB_FLAGS_GET_Z(temp->flags),
+    precision);
+  return;
 }
 
 /**
- * Writes into the buffer the temporal instant set point represented in MF-JSON format
+ * Writes into the buffer the coordinates and the datetimes arrays of the
+ * instants represented in MF-JSON format
  */
-static size_t
-tpointinstset_as_mfjson_buf(const TInstantSet *ti, int precision, const STBOX *bbox,
-  char *srs, char *output)
+static void
+tinstarr_mfjson_buf(StringInfo buf, TInstant **instants, int count,
+  int precision)
 {
-  char *ptr = output;
-  ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-  if (srs) ptr += srs_mfjson_buf(ptr, srs);
-  if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(ti->flags), precision);
-  ptr += sprintf(ptr, "\"coordinates\":[");
-  for (int i = 0; i < ti->count; i++)
+  appendStringInfoString(buf, "\"coordinates\":[");
+  for (int i = 0; i < count; i++)
   {
-    if (i) ptr += sprintf(ptr, ",");
-    ptr += coordinates_mfjson_buf(ptr, tinstantset_inst_n(ti, i), precision);
+    if (i) appendStringInfoChar(buf, ',');
+    coordinates_mfjson_buf(buf, instants[i], precision);
   }
-  ptr += sprintf(ptr, "],\"datetimes\":[");
-  for (int i = 0; i < ti->count; i++)
+  appendStringInfoString(buf, "],\"datetimes\":[");
+  for (int i = 0; i < count; i++)
   {
-    if (i) ptr += sprintf(ptr, ",");
-    ptr += datetimes_mfjson_buf(ptr, tinstantset_inst_n(ti, i));
+    if (i) appendStringInfoChar(buf, ',');
+    datetimes_mfjson_buf(buf, instants[i]);
   }
-  ptr += sprintf(ptr, "],\"interpolations\":[\"Discrete\"]}");
-  return (ptr - output);
-}
-
-/**
- * Returns the temporal instant set point represented in MF-JSON format
- */
-static char *
-tpointinstset_as_mfjson(const TInstantSet *ti, int precision, const STBOX *bbox, char *srs)
-{
-  size_t size = tpointinstset_as_mfjson_size(ti, precision, bbox, srs);
-  char *output = palloc(size);
-  tpointinstset_as_mfjson_buf(ti, precision, bbox, srs, output);
-  return output;
+  appendStringInfoChar(buf, ']');
+  return;
 }
 
 /*****************************************************************************/
 
 /**
- * Returns the maximum size in bytes of a temporal sequence point
- * represented in MF-JSON format
+ * Writes into the buffer the temporal instant point represented in MF-JSON format
  */
-static size_t
-tpointseq_as_mfjson_size(const TSequence *seq, int precision,
+static void
+tpointinst_as_mfjson_buf(StringInfo buf, const TInstant *inst, int precision,
   const STBOX *bbox, char *srs)
 {
-  size_t size = coordinates_mfjson_size(seq->count,
-    MOBDB_FLAGS_GET_Z(seq->flags), precision);
-  size += datetimes_mfjson_size(seq->count);
-  size += sizeof("{'type':'MovingPoint',");
-  /* We reserve space for the largest strings, i.e., 'false' and "Stepwise" */
-  size += sizeof("'coordinates':[],'datetimes':[],'lower_inc':false,'upper_inc':false,interpolations':['Stepwise']}");
-  if (srs) size += srs_mfjson_size(srs);
-  if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(seq->flags), precision);
-  return size;
-}
-
-/**
- * Writes into the buffer the temporal sequence point represented in MF-JSON format
- */
-static size_t
-tpointseq_as_mfjson_buf(const TSequence *seq, int precision, const STBOX *bbox,
-  char *srs, char *output)
-{
-  char *ptr = output;
-  ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-  if (srs) ptr += srs_mfjson_buf(ptr, srs);
-  if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(seq->flags), precision);
-  ptr += sprintf(ptr, "\"coordinates\":[");
-  for (int i = 0; i < seq->count; i++)
-  {
-    if (i) ptr += sprintf(ptr, ",");
-    ptr += coordinates_mfjson_buf(ptr, tsequence_inst_n(seq, i), precision);
-  }
-  ptr += sprintf(ptr, "],\"datetimes\":[");
-  for (int i = 0; i < seq->count; i++)
-  {
-    if (i) ptr += sprintf(ptr, ",");
-    ptr += datetimes_mfjson_buf(ptr, tsequence_inst_n(seq, i));
-  }
-  ptr += sprintf(ptr, "],\"lower_inc\":%s,\"upper_inc\":%s,\"interpolations\":[\"%s\"]}",
-    seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ? "true" : "false",
-    MOBDB_FLAGS_GET_LINEAR(seq->flags) ? "Linear" : "Stepwise");
-  return (ptr - output);
+  tpoint_mfjson_header_buf(buf, (Temporal *) inst, precision, bbox, srs);
+  appendStringInfoString(buf, "\"coordinates\":");
+  coordinates_mfjson_buf(buf, inst, precision);
+  appendStringInfoString(buf, ",\"datetimes\":");
+  datetimes_mfjson_buf(buf, inst);
+  appendStringInfoString(buf, ",\"interpolations\":[\"Discrete\"]}");
+  return;
 }
 
 /**
- * Returns the temporal sequence point represented in MF-JSON format
+ * Writes into the buffer the temporal instant set point represented in MF-JSON format
  */
-static char *
-tpointseq_as_mfjson(const TSequence *seq, int precision, const STBOX *bbox,
-  char *srs)
+static void
+tpointinstset_as_mfjson_buf(StringInfo buf, const TInstantSet *ti,
+  int precision, const STBOX *bbox, char *srs)
 {
-  size_t size = tpointseq_as_mfjson_size(seq, precision, bbox, srs);
-  char *output = palloc(size);
-  tpointseq_as_mfjson_buf(seq, precision, bbox, srs, output);
-  return output;
+  tpoint_mfjson_header_buf(buf, (Temporal *) ti, precision, bbox, srs);
+  TInstant **instants = tinstantset_instants(ti);
+  tinstarr_mfjson_buf(buf, instants, ti->count, precision);
+  pfree(instants);
+  appendStringInfoString(buf, ",\"interpolations\":[\"Discrete\"]}");
+  return;
 }
 
-/*****************************************************************************/
-
 /**
- * Returns the maximum size in bytes of a temporal sequence set point
- * represented in MF-JSON format
+ * Writes into the buffer the temporal sequence point represented in MF-JSON format
  */
-static size_t
-tpointseqset_as_mfjson_size(const TSequenceSet *ts, int precision, const STBOX *bbox,
-  char *srs)
+static void
+tpointseq_as_mfjson_buf(StringInfo buf, const TSequence *seq, int precision,
+  const STBOX *bbox, char *srs)
 {
-  size_t size = sizeof("{'type':'MovingPoint','sequences':[],");
-  size += sizeof("{'coordinates':[],'datetimes':[],'lower_inc':false,'upper_inc':false},") * ts->count;
-  size += coordinates_mfjson_size(ts->totalcount, MOBDB_FLAGS_GET_Z(ts->flags), precision);
-  size += datetimes_mfjson_size(ts->totalcount);
-  /* We reserve space for the largest interpolation string, i.e., "Stepwise" */
-  size += sizeof(",interpolations':['Stepwise']}");
-  if (srs) size += srs_mfjson_size(srs);
-  if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(ts->flags), precision);
-  return size;
+  tpoint_mfjson_header_buf(buf, (Temporal *) seq, precision, bbox, srs);
+  TInstant **instants = tsequence_instants(seq);
+  tinstarr_mfjson_buf(buf, instants, seq->count, precision);
+  pfree(instants);
+  appendStringInfo(buf, ",\"lower_inc\":%s,\"upper_inc\":%s,\"interpolations\":[\"%s\"]}",
+    seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ? "true" : "false",
+    MOBDB_FLAGS_GET_LINEAR(seq->flags) ? "Linear" : "Stepwise");
+  return;
 }
 
 /**
  * Writes into the buffer the temporal sequence set point represented in MF-JSON format
  */
-static size_t
-tpointseqset_as_mfjson_buf(const TSequenceSet *ts, int precision, const STBOX *bbox, char *srs,
-  char *output)
+static void
+tpointseqset_as_mfjson_buf(StringInfo buf, const TSequenceSet *ts,
+  int precision, const STBOX *bbox, char *srs)
 {
-  char *ptr = output;
-  ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-  if (srs) ptr += srs_mfjson_buf(ptr, srs);
-  if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(ts->flags), precision);
-  ptr += sprintf(ptr, "\"sequences\":[");
+  tpoint_mfjson_header_buf(buf, (Temporal *) ts, precision, bbox, srs);
+  appendStringInfoString(buf, "\"sequences\":[");
   for (int i = 0; i < ts->count; i++)
   {
     TSequence *seq = tsequenceset_seq_n(ts, i);
-    if (i) ptr += sprintf(ptr, ",");
-    ptr += sprintf(ptr, "{\"coordinates\":[");
-    for (int j = 0; j < seq->count; j++)
-    {
-      if (j) ptr += sprintf(ptr, ",");
-      ptr += coordinates_mfjson_buf(ptr, tsequence_inst_n(seq, j), precision);
-    }
-    ptr += sprintf(ptr, "],\"datetimes\":[");
-    for (int j = 0; j < seq->count; j++)
-    {
-      if (j) ptr += sprintf(ptr, ",");
-      ptr += datetimes_mfjson_buf(ptr, tsequence_inst_n(seq, j));
-    }
-    ptr += sprintf(ptr, "],\"lower_inc\":%s,\"upper_inc\":%s}",
+    if (i) appendStringInfoChar(buf, ',');
+    appendStringInfoChar(buf, '{');
+    TInstant **instants = tsequence_instants(seq);
+    tinstarr_mfjson_buf(buf, instants, seq->count, precision);
+    pfree(instants);
+    appendStringInfo(buf, ",\"lower_inc\":%s,\"upper_inc\":%s}",
       seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ? "true" : "false");
   }
-  ptr += sprintf(ptr, "],\"interpolations\":[\"%s\"]}",
+  appendStringInfo(buf, "],\"interpolations\":[\"%s\"]}",
     MOBDB_FLAGS_GET_LINEAR(ts->flags) ? "Linear" : "Stepwise");
-  return (ptr - output);
-}
-
-/**
- * Returns the temporal sequence set point represented in MF-JSON format
- */
-static char *
-tpointseqset_as_mfjson(const TSequenceSet *ts, int precision, const STBOX *bbox,
-  char *srs)
-{
-  size_t size = tpointseqset_as_mfjson_size(ts, precision, bbox, srs);
-  char *output = palloc(size);
-  tpointseqset_as_mfjson_buf(ts, precision, bbox, srs, output);
-  return output;
+  return;
 }
 
 /*****************************************************************************/
@@ -725,17 +570,19 @@ tpoint_as_mfjson(PG_FUNCTION_ARGS)
     bbox = &tmp;
   }
 
-  char *mfjson;
+  StringInfoData buf;
+  initStringInfo(&buf);
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT)
-    mfjson = tpointinst_as_mfjson((TInstant *)temp, precision, bbox, srs);
+    tpointinst_as_mfjson_buf(&buf, (TInstant *)temp, precision, bbox, srs);
   else if (temp->duration == INSTANTSET)
-    mfjson = tpointinstset_as_mfjson((TInstantSet *)temp, precision, bbox, srs);
+    tpointinstset_as_mfjson_buf(&buf, (TInstantSet *)temp, precision, bbox, srs);
   else if (temp->duration == SEQUENCE)
-    mfjson = tpointseq_as_mfjson((TSequence *)temp, precision, bbox, srs);
+    tpointseq_as_mfjson_buf(&buf, (TSequence *)temp, precision, bbox, srs);
   else /* temp->duration == SEQUENCESET */
-    mfjson = tpointseqset_as_mfjson((TSequenceSet *)temp, precision, bbox, srs);
-  text *result = cstring_to_text(mfjson);
+    tpointseqset_as_mfjson_buf(&buf, (TSequenceSet *)temp, precision, bbox, srs);
+  text *result = cstring_to_text_with_len(buf.data, buf.len);
+  pfree(buf.data);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_TEXT_P(result);
 }
@@ -1440,4 +1287,384 @@ tpoint_as_hexewkb(PG_FUNCTION_ARGS)
   PG_RETURN_TEXT_P(result);
 }
 
+/*****************************************************************************
+ * Output of the instants in columnar form
+ *****************************************************************************/
+
+/**
+ * Structure to represent the state of the set-returning function
+ */
+typedef struct
+{
+  Temporal *temp;  /**< Temporal point */
+  int seq;         /**< Number of the current sequence, starting at 0 */
+  int inst;        /**< Number of the current instant in the sequence */
+} TPointPointsState;
+
+/**
+ * Returns the number of sequences and the n-th instant of the n-th sequence
+ * of the temporal point. Temporal instant and instant set values are
+ * considered as a single sequence.
+ */
+static const TInstant *
+tpoint_points_inst_n(const Temporal *temp, int seq, int inst, int *count)
+{
+  if (temp->duration == INSTANT)
+  {
+    *count = 1;
+    return (TInstant *) temp;
+  }
+  if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (TInstantSet *) temp;
+    *count = ti->count;
+    return tinstantset_inst_n(ti, inst);
+  }
+  const TSequence *seq1 = (temp->duration == SEQUENCE) ?
+    (TSequence *) temp : tsequenceset_seq_n((TSequenceSet *) temp, seq);
+  *count = seq1->count;
+  return tsequence_inst_n(seq1, inst);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_points);
+/**
+ * Returns the instants of the temporal point as rows composed of the number
+ * of the sequence, the timestamp, and the coordinates read directly from the
+ * instants. The z coordinate is null for two-dimensional points.
+ */
+PGDLLEXPORT Datum
+tpoint_points(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  if (SRF_IS_FIRSTCALL())
+  {
+    funcctx = SRF_FIRSTCALL_INIT();
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    TPointPointsState *state = palloc(sizeof(TPointPointsState));
+    state->temp = PG_GETARG_TEMPORAL(0);
+    state->seq = state->inst = 0;
+    TupleDesc tupdesc;
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+      ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+        errmsg("function returning record called in context that cannot accept type record")));
+    funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+    funcctx->user_fctx = state;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  funcctx = SRF_PERCALL_SETUP();
+  TPointPointsState *state = (TPointPointsState *) funcctx->user_fctx;
+  Temporal *temp = state->temp;
+  int nseqs = (temp->duration == SEQUENCESET) ?
+    ((TSequenceSet *) temp)->count : 1;
+  if (state->seq < nseqs)
+  {
+    int count;
+    const TInstant *inst = tpoint_points_inst_n(temp, state->seq,
+      state->inst, &count);
+    Datum values[5];
+    bool isnull[5] = {false, false, false, false, false};
+    values[0] = Int32GetDatum(state->seq + 1);
+    values[1] = TimestampTzGetDatum(inst->t);
+    if (MOBDB_FLAGS_GET_Z(temp->flags))
+    {
+      const POINT3DZ *p = datum_get_point3dz_p(tinstant_value(inst));
+      values[2] = Float8GetDatum(p->x);
+      values[3] = Float8GetDatum(p->y);
+      values[4] = Float8GetDatum(p->z);
+    }
+    else
+    {
+      const POINT2D *p = datum_get_point2d_p(tinstant_value(inst));
+      values[2] = Float8GetDatum(p->x);
+      values[3] = Float8GetDatum(p->y);
+      values[4] = (Datum) 0;
+      isnull[4] = true;
+    }
+    if (++state->inst == count)
+    {
+      state->seq++;
+      state->inst = 0;
+    }
+    HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+    SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+  }
+  SRF_RETURN_DONE(funcctx);
+}
+
+/*****************************************************************************
+ * Mapbox Vector Tile output
+ *****************************************************************************/
+
+/**
+ * Structure used to transform the instants of a temporal point into tile
+ * coordinates in a single pass
+ */
+typedef struct
+{
+  const STBOX *bounds;  /**< Bounds of the tile */
+  double xscale;        /**< Scale of the x coordinates */
+  double yscale;        /**< Scale of the y coordinates */
+  LWGEOM **geoms;       /**< Points and lines in tile coordinates */
+  int ngeoms;           /**< Number of points and lines */
+  bool haslines;        /**< True when at least one line was added */
+  bool haspoints;       /**< True when at least one point was added */
+  TimestampTz *times;   /**< Timestamps of the vertices */
+  int ntimes;           /**< Number of timestamps */
+} MVTState;
+
+/**
+ * Transforms the point of the instant into tile coordinates. The y axis of
+ * the tiles points downwards.
+ */
+static void
+tpointinst_mvt_point(const TInstant *inst, const MVTState *state, POINT4D *pt)
+{
+  const POINT2D *p = datum_get_point2d_p(tinstant_value(inst));
+  pt->x = rint((p->x - state->bounds->xmin) * state->xscale);
+  pt->y = rint((state->bounds->ymax - p->y) * state->yscale);
+  pt->z = pt->m = 0;
+  return;
+}
+
+/**
+ * Adds to the state the instants as separate points, skipping those that
+ * fall on the same tile coordinates as the previous one
+ */
+static void
+tinstarr_mvt_points(const TInstant **instants, int count, MVTState *state)
+{
+  POINT4D pt, prev = { 0, 0, 0, 0 };
+  for (int i = 0; i < count; i++)
+  {
+    tpointinst_mvt_point(instants[i], state, &pt);
+    if (i > 0 && pt.x == prev.x && pt.y == prev.y)
+      continue;
+    state->geoms[state->ngeoms++] = (LWGEOM *) lwpoint_make2d(0, pt.x, pt.y);
+    state->times[state->ntimes++] = instants[i]->t;
+    prev = pt;
+  }
+  state->haspoints = true;
+  return;
+}
+
+/**
+ * Adds to the state the temporal sequence point with linear interpolation
+ * as a line, skipping the vertices that fall on the same tile coordinates
+ * as the previous one. A line collapsing into a single vertex is added as
+ * a point.
+ */
+static void
+tpointseq_mvt_line(const TSequence *seq, MVTState *state)
+{
+  POINTARRAY *pa = ptarray_construct_empty(0, 0, (uint32_t) seq->count);
+  POINT4D pt, prev = { 0, 0, 0, 0 };
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = tsequence_inst_n(seq, i);
+    tpointinst_mvt_point(inst, state, &pt);
+    if (i > 0 && pt.x == prev.x && pt.y == prev.y)
+      continue;
+    ptarray_append_point(pa, &pt, LW_TRUE);
+    state->times[state->ntimes++] = inst->t;
+    prev = pt;
+  }
+  if (pa->npoints == 1)
+  {
+    state->geoms[state->ngeoms++] = (LWGEOM *) lwpoint_construct(0, NULL, pa);
+    state->haspoints = true;
+  }
+  else
+  {
+    state->geoms[state->ngeoms++] = (LWGEOM *) lwline_construct(0, NULL, pa);
+    state->haslines = true;
+  }
+  return;
+}
+
+/**
+ * Adds to the state the temporal sequence point. Sequences with stepwise
+ * interpolation are added as points, as for their trajectory.
+ */
+static void
+tpointseq_mvt(const TSequence *seq, MVTState *state)
+{
+  if (MOBDB_FLAGS_GET_LINEAR(seq->flags) && seq->count > 1)
+    tpointseq_mvt_line(seq, state);
+  else
+  {
+    const TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+    for (int i = 0; i < seq->count; i++)
+      instants[i] = tsequence_inst_n(seq, i);
+    tinstarr_mvt_points(instants, seq->count, state);
+    pfree(instants);
+  }
+  return;
+}
+
+/**
+ * Returns the geometry in tile coordinates of the temporal point and sets
+ * the timestamps of its vertices (dispatch function)
+ *
+ * @param[in] temp Temporal point already clipped to the tile
+ * @param[in] bounds Bounds of the tile
+ * @param[in] extent Extent of the tile in tile coordinates
+ * @param[out] times Timestamps of the vertices
+ * @param[out] count Number of timestamps
+ */
+static LWGEOM *
+tpoint_mvt_geom(const Temporal *temp, const STBOX *bounds, int extent,
+  TimestampTz **times, int *count)
+{
+  int totalcount;
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+    totalcount = 1;
+  else if (temp->duration == INSTANTSET)
+    totalcount = ((TInstantSet *) temp)->count;
+  else if (temp->duration == SEQUENCE)
+    totalcount = ((TSequence *) temp)->count;
+  else /* temp->duration == SEQUENCESET */
+    totalcount = ((TSequenceSet *) temp)->totalcount;
+
+  MVTState state;
+  state.bounds = bounds;
+  state.xscale = extent / (bounds->xmax - bounds->xmin);
+  state.yscale = extent / (bounds->ymax - bounds->ymin);
+  /* Each vertex gives at most one point */
+  state.geoms = palloc(sizeof(LWGEOM *) * totalcount);
+  state.ngeoms = 0;
+  state.haslines = state.haspoints = false;
+  state.times = palloc(sizeof(TimestampTz) * totalcount);
+  state.ntimes = 0;
+  if (temp->duration == INSTANT)
+  {
+    const TInstant *inst = (TInstant *) temp;
+    tinstarr_mvt_points(&inst, 1, &state);
+  }
+  else if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (TInstantSet *) temp;
+    const TInstant **instants = palloc(sizeof(TInstant *) * ti->count);
+    for (int i = 0; i < ti->count; i++)
+      instants[i] = tinstantset_inst_n(ti, i);
+    tinstarr_mvt_points(instants, ti->count, &state);
+    pfree(instants);
+  }
+  else if (temp->duration == SEQUENCE)
+    tpointseq_mvt((TSequence *) temp, &state);
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (TSequenceSet *) temp;
+    for (int i = 0; i < ts->count; i++)
+      tpointseq_mvt(tsequenceset_seq_n(ts, i), &state);
+  }
+
+  LWGEOM *result;
+  if (state.ngeoms == 1)
+  {
+    result = state.geoms[0];
+    pfree(state.geoms);
+  }
+  else
+  {
+    uint8_t type = ! state.haslines ? MULTIPOINTTYPE :
+      (! state.haspoints ? MULTILINETYPE : COLLECTIONTYPE);
+    result = (LWGEOM *) lwcollection_construct(type, 0, NULL,
+      (uint32_t) state.ngeoms, state.geoms);
+  }
+  *times = state.times;
+  *count = state.ntimes;
+  return result;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_as_mvtgeom);
+/**
+ * Returns the geometry of the temporal point in the coordinate space of a
+ * Mapbox Vector Tile together with the timestamps of its vertices
+ *
+ * The temporal point is simplified with its simplification levels, if any,
+ * and clipped to the bounds of the tile extended by the buffer, and to the
+ * time extent of the bounds if any. The coordinates are
+ * then transformed into tile coordinates and rounded to integers in a
+ * single pass over the instants, vertices falling on the same tile
+ * coordinates being merged.
+ */
+PGDLLEXPORT Datum
+tpoint_as_mvtgeom(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  STBOX *bounds = PG_GETARG_STBOX_P(1);
+  int32_t extent = PG_GETARG_INT32(2);
+  int32_t buffer = PG_GETARG_INT32(3);
+  bool clip_geom = PG_GETARG_BOOL(4);
+  ensure_has_X_stbox(bounds);
+  ensure_same_srid_tpoint_stbox(temp, bounds);
+  if (bounds->xmax <= bounds->xmin || bounds->ymax <= bounds->ymin)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The bounds of the tile cannot be degenerate")));
+  if (extent <= 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The extent must be positive")));
+  if (buffer < 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The buffer cannot be negative")));
+
+  /* Simplify with the simplification levels of the temporal point, if any,
+   * with a tolerance of half a pixel of the tile */
+  double tol = Min(bounds->xmax - bounds->xmin,
+    bounds->ymax - bounds->ymin) / extent / 2;
+  Temporal *temp0 = tpoint_simplify_levels(temp, tol);
+  if (temp0 == NULL)
+    temp0 = temp;
+
+  /* Clip to the bounds extended with the buffer, which has at most 2D */
+  Temporal *temp1 = temp0;
+  if (clip_geom || MOBDB_FLAGS_GET_T(bounds->flags))
+  {
+    STBOX box = *bounds;
+    MOBDB_FLAGS_SET_Z(box.flags, false);
+    if (clip_geom)
+    {
+      double xbuffer = (bounds->xmax - bounds->xmin) * buffer / extent;
+      double ybuffer = (bounds->ymax - bounds->ymin) * buffer / extent;
+      box.xmin -= xbuffer; box.xmax += xbuffer;
+      box.ymin -= ybuffer; box.ymax += ybuffer;
+    }
+    else
+      MOBDB_FLAGS_SET_X(box.flags, false);
+    temp1 = tpoint_at_stbox_internal(temp0, &box);
+    if (temp1 == NULL)
+    {
+      if (temp0 != temp)
+        pfree(temp0);
+      PG_FREE_IF_COPY(temp, 0);
+      PG_RETURN_NULL();
+    }
+  }
+
+  TimestampTz *times;
+  int count;
+  LWGEOM *geom = tpoint_mvt_geom(temp1, bounds, extent, &times, &count);
+  TupleDesc tupdesc;
+  if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+      errmsg("function returning record called in context that cannot accept type record")));
+  tupdesc = BlessTupleDesc(tupdesc);
+  Datum values[2];
+  bool isnull[2] = {false, false};
+  values[0] = PointerGetDatum(geo_serialize(geom));
+  values[1] = PointerGetDatum(timestamparr_to_array(times, count));
+  HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+  lwgeom_free(geom);
+  pfree(times);
+  if (temp1 != temp0)
+    pfree(temp1);
+  if (temp0 != temp)
+    pfree(temp0);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
 /*****************************************************************************/
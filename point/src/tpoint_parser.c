@@ -12,6 +12,8 @@
 
 #include "tpoint_parser.h"
 
+#include <utils/memutils.h>
+
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "tpoint.h"
@@ -189,6 +191,117 @@ stbox_parse(char **str)
 
 /*****************************************************************************/
 
+/**
+ * Points serialized once in 2D and in 3D, whose SRID and coordinates are
+ * overwritten for each instant parsed by point_parse_fast
+ */
+static GSERIALIZED *point_template[2] = {NULL, NULL};
+
+/**
+ * Parse a coordinate of a point in WKT format, returns false if it is not
+ * a decimal number
+ */
+static bool
+coord_parse_fast(const char **str, double *result)
+{
+  /* Only the characters of decimal numbers are given to strtod */
+  char buf[64];
+  int len = 0;
+  const char *ptr = *str;
+  while ((*ptr >= '0' && *ptr <= '9') || *ptr == '-' || *ptr == '+' ||
+    *ptr == '.' || *ptr == 'e' || *ptr == 'E')
+  {
+    if (len == (int) sizeof(buf) - 1)
+      return false;
+    buf[len++] = *ptr++;
+  }
+  if (len == 0)
+    return false;
+  buf[len] = '\0';
+  char *end;
+  *result = strtod(buf, &end);
+  if (*end != '\0')
+    return false;
+  *str = ptr;
+  return true;
+}
+
+/**
+ * Parse a geometric point of the form POINT(x y), POINT(x y z), or
+ * POINT Z (x y z) followed by the at sign without calling the input
+ * function of geometry. The buffer is only advanced when the parsing
+ * succeeds, otherwise the point must be given to the input function.
+ *
+ * @param[inout] str Input string
+ * @param[out] coords Coordinates of the point
+ * @param[out] hasz Set to true when the point has Z dimension
+ */
+static bool
+point_parse_fast(char **str, double *coords, bool *hasz)
+{
+  const char *ptr = *str;
+  if (pg_strncasecmp(ptr, "POINT", 5) != 0)
+    return false;
+  ptr += 5;
+  while (*ptr == ' ')
+    ptr++;
+  bool zflag = false;
+  if (*ptr == 'Z' || *ptr == 'z')
+  {
+    zflag = true;
+    ptr++;
+    while (*ptr == ' ')
+      ptr++;
+  }
+  if (*ptr++ != '(')
+    return false;
+  int ncoords = 0;
+  while (ncoords < 3)
+  {
+    while (*ptr == ' ')
+      ptr++;
+    if (*ptr == ')' || ! coord_parse_fast(&ptr, &coords[ncoords]))
+      break;
+    ncoords++;
+  }
+  while (*ptr == ' ')
+    ptr++;
+  if (*ptr++ != ')' || ncoords < 2 || (zflag && ncoords != 3))
+    return false;
+  while (*ptr == ' ')
+    ptr++;
+  /* Since we know there's an @ here, let's take it with us */
+  if (*ptr++ != '@')
+    return false;
+  *hasz = (ncoords == 3);
+  *str = (char *) ptr;
+  return true;
+}
+
+/**
+ * Returns the geometric point with the given coordinates and SRID
+ *
+ * @note The result is only valid until the next call of the function
+ */
+static GSERIALIZED *
+point_make_fast(const double *coords, bool hasz, int srid)
+{
+  if (point_template[hasz] == NULL)
+  {
+    MemoryContext oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+    LWPOINT *lwpoint = hasz ? lwpoint_make3dz(SRID_UNKNOWN, 0, 0, 0) :
+      lwpoint_make2d(SRID_UNKNOWN, 0, 0);
+    point_template[hasz] = geo_serialize((LWGEOM *) lwpoint);
+    lwpoint_free(lwpoint);
+    MemoryContextSwitchTo(oldcontext);
+  }
+  GSERIALIZED *result = point_template[hasz];
+  gserialized_set_srid(result, srid);
+  double *ptcoords = (double *) datum_get_point2d_p(PointerGetDatum(result));
+  memcpy(ptcoords, coords, sizeof(double) * (hasz ? 3 : 2));
+  return result;
+}
+
 /**
  * Parse a temporal point value of instant duration from the buffer
  *
@@ -203,6 +316,20 @@ static TInstant *
 tpointinst_parse(char **str, Oid basetype, bool end, bool make, int *tpoint_srid) 
 {
   p_whitespace(str);
+  /* Geometric points in the usual form are parsed directly, they do not
+   * have an SRID and thus take the one of the temporal point */
+  double coords[3];
+  bool hasz;
+  if (basetype == type_oid(T_GEOMETRY) && point_parse_fast(str, coords, &hasz))
+  {
+    /* The next instruction will throw an exception if it fails */
+    TimestampTz t = timestamp_parse(str);
+    ensure_end_input(str, end);
+    if (! make)
+      return NULL;
+    GSERIALIZED *gs = point_make_fast(coords, hasz, *tpoint_srid);
+    return tinstant_make(PointerGetDatum(gs), t, basetype);
+  }
   /* The next instruction will throw an exception if it fails */
   Datum geo = basetype_parse(str, basetype); 
   GSERIALIZED *gs = (GSERIALIZED *)PG_DETOAST_DATUM(geo);
@@ -16,6 +16,7 @@
 #include <float.h>
 
 #include "period.h"
+#include "time_selfuncs.h"
 #include "temporal_selfuncs.h"
 #include "stbox.h"
 #include "tpoint.h"
@@ -571,6 +572,31 @@ default_tpoint_selectivity(CachedOp operator)
   }
 }
 
+/**
+ * Returns a copy of the ND_STATS of the given kind of the column, or NULL if
+ * the statistics are not available
+ */
+static ND_STATS *
+nd_stats_from_vardata(VariableStatData *vardata, int kind)
+{
+  AttStatsSlot sslot;
+  ND_STATS *nd_stats;
+
+  /* Currently PostGIS does not set the associated staopN so we
+   * can pass InvalidOid */
+  if (!(HeapTupleIsValid(vardata->statsTuple) &&
+      get_attstatsslot(&sslot, vardata->statsTuple, kind, InvalidOid,
+      ATTSTATSSLOT_NUMBERS)))
+    return NULL;
+
+  /* Clone the stats here so we can release the attstatsslot immediately */
+  nd_stats = palloc(sizeof(float4) * sslot.nnumbers);
+  memcpy(nd_stats, sslot.numbers, sizeof(float4) * sslot.nnumbers);
+
+  free_attstatsslot(&sslot);
+  return nd_stats;
+}
+
 /**
  * Returns an estimate of the selectivity of a spatiotemporal search box by
  * looking at data in the ND_STATS structure. The selectivity is a float in 
@@ -588,7 +614,6 @@ static float8
 calc_geo_selectivity(VariableStatData *vardata, const STBOX *box, CachedOp op)
 {
   ND_STATS *nd_stats;
-  AttStatsSlot sslot;  
   int d; /* counter */
   float8 selectivity;
   ND_BOX nd_box;
@@ -607,19 +632,10 @@ calc_geo_selectivity(VariableStatData *vardata, const STBOX *box, CachedOp op)
   bool bboxop = (op == OVERLAPS_OP || op == CONTAINS_OP ||
     op == CONTAINED_OP || op == SAME_OP);
 
-  /* Get statistics 
-   * Currently PostGIS does not set the associated staopN so we
-   * can pass InvalidOid */
-  if (!(HeapTupleIsValid(vardata->statsTuple) &&
-      get_attstatsslot(&sslot, vardata->statsTuple, STATISTIC_KIND_ND, 
-      InvalidOid, ATTSTATSSLOT_NUMBERS)))
+  /* Get statistics */
+  nd_stats = nd_stats_from_vardata(vardata, STATISTIC_KIND_ND);
+  if (nd_stats == NULL)
     return -1;
-
-  /* Clone the stats here so we can release the attstatsslot immediately */
-  nd_stats = palloc(sizeof(float4) * sslot.nnumbers);
-  memcpy(nd_stats, sslot.numbers, sizeof(float4) * sslot.nnumbers);
-
-  free_attstatsslot(&sslot);
   /* Calculate the number of common coordinate dimensions  on the histogram */
   ndims_max = (int) Max(nd_stats->ndims, MOBDB_FLAGS_GET_Z(box->flags) ? 3 : 2);
 
@@ -777,6 +793,280 @@ calc_geo_selectivity(VariableStatData *vardata, const STBOX *box, CachedOp op)
   return selectivity;
 }
 
+/**
+ * Returns the proportion of the cell whose coordinates in dimension d are
+ * below (or above) the value
+ */
+static double
+nd_cell_ratio_side(const ND_BOX *cell, int d, double value, bool below)
+{
+  double width = cell->max[d] - cell->min[d], ratio;
+  if (width <= 0.0)
+    return (below ? cell->max[d] <= value : cell->min[d] >= value) ?
+      1.0 : 0.0;
+  ratio = below ? (value - cell->min[d]) / width :
+    (cell->max[d] - value) / width;
+  return Max(0.0, Min(1.0, ratio));
+}
+
+/**
+ * Returns an estimate of the selectivity of a spatiotemporal search box by
+ * looking at the joint space-time histogram of the column, or -1 if the
+ * histogram is not available or cannot be used for the operator.
+ *
+ * Contrary to function calc_geo_selectivity followed by the estimation of
+ * the time dimension, this function does not assume that the spatial and
+ * the time dimensions are independent. The dimensions of the histogram
+ * that are missing in the search box are not restricted. The position
+ * operators restrict a single dimension, the bounding box operators are
+ * estimated as overlaps.
+ */
+static float8
+calc_geo_time_selectivity(VariableStatData *vardata, const STBOX *box,
+  CachedOp op)
+{
+  ND_STATS *nd_stats;
+  ND_BOX nd_box;
+  ND_IBOX search_ibox;
+  int at[ND_DIMS];
+  double min[ND_DIMS], cell_size[ND_DIMS];
+  double total_count = 0.0, value = 0.0;
+  float8 selectivity;
+  int d, ndims, tdim, posdim = -1;
+  bool hasx = MOBDB_FLAGS_GET_X(box->flags),
+    hasz = MOBDB_FLAGS_GET_Z(box->flags) ||
+      MOBDB_FLAGS_GET_GEODETIC(box->flags),
+    hast = MOBDB_FLAGS_GET_T(box->flags), below = false;
+  bool bboxop = (op == OVERLAPS_OP || op == CONTAINS_OP ||
+    op == CONTAINED_OP || op == SAME_OP);
+
+  nd_stats = nd_stats_from_vardata(vardata, STATISTIC_KIND_ND_TIME);
+  if (nd_stats == NULL)
+    return -1;
+  ndims = (int) nd_stats->ndims;
+  tdim = ndims - 1;
+  nd_box_from_stbox_time(box, ndims, &nd_box);
+
+  /* Determine the dimension and the value restricted by a position operator */
+  if (! bboxop)
+  {
+    if (op >= LEFT_OP && op <= OVERBACK_OP)
+    {
+      if (! hasx)
+      {
+        pfree(nd_stats);
+        return -1;
+      }
+      posdim = (op <= OVERRIGHT_OP) ? X_DIM :
+        (op <= OVERABOVE_OP) ? Y_DIM : Z_DIM;
+    }
+    else if (op >= BEFORE_OP && op <= OVERAFTER_OP && hast)
+      posdim = tdim;
+    /* The third spatial dimension is missing in the histogram or the box */
+    if (posdim < 0 || (posdim == Z_DIM && (ndims < 4 || ! hasz)))
+    {
+      pfree(nd_stats);
+      return -1;
+    }
+    /* The position operators follow the order of LEFT_OP, OVERLEFT_OP,
+     * RIGHT_OP, OVERRIGHT_OP and of BEFORE_OP, OVERBEFORE_OP, AFTER_OP,
+     * OVERAFTER_OP in the CachedOp enumeration */
+    int pos = (posdim == tdim) ? (int) (op - BEFORE_OP) :
+      (int) (op - LEFT_OP) % 4;
+    below = (pos == 0 || pos == 1);
+    value = (pos == 0 || pos == 3) ? nd_box.min[posdim] : nd_box.max[posdim];
+  }
+
+  /* The dimensions missing in the box are not restricted */
+  for (d = 0; d < ndims; d++)
+  {
+    if ((d < tdim && ! hasx) || (d == Z_DIM && d < tdim && ! hasz) ||
+      (d == tdim && ! hast))
+    {
+      nd_box.min[d] = nd_stats->extent.min[d];
+      nd_box.max[d] = nd_stats->extent.max[d];
+    }
+    min[d] = nd_stats->extent.min[d];
+    cell_size[d] = (nd_stats->extent.max[d] - min[d]) / nd_stats->size[d];
+  }
+
+  /* Determine the cells to traverse */
+  memset(&search_ibox, 0, sizeof(ND_IBOX));
+  if (bboxop)
+  {
+    if (! nd_box_intersects(&(nd_stats->extent), &nd_box, ndims))
+    {
+      pfree(nd_stats);
+      return 0.0;
+    }
+    nd_box_overlap(nd_stats, &nd_box, &search_ibox);
+  }
+  else
+  {
+    for (d = 0; d < ndims; d++)
+      search_ibox.max[d] = (int) (nd_stats->size[d] - 1);
+  }
+
+  /* Move through the cells and sum their pro-rated values */
+  memset(at, 0, sizeof(int) * ND_DIMS);
+  for (d = 0; d < ndims; d++)
+    at[d] = search_ibox.min[d];
+  do
+  {
+    ND_BOX nd_cell;
+    double ratio;
+    nd_box_init(&nd_cell);
+    for (d = 0; d < ndims; d++)
+    {
+      nd_cell.min[d] = (float4) (min[d] + (at[d]+0) * cell_size[d]);
+      nd_cell.max[d] = (float4) (min[d] + (at[d]+1) * cell_size[d]);
+    }
+    ratio = bboxop ? nd_box_ratio_overlaps(&nd_box, &nd_cell, ndims) :
+      nd_cell_ratio_side(&nd_cell, posdim, value, below);
+    total_count += nd_stats->value[nd_stats_value_index(nd_stats, at)] * ratio;
+  }
+  while (nd_increment(&search_ibox, ndims, at));
+
+  /* Scale by the number of features in our histogram to get the proportion */
+  selectivity = total_count / nd_stats->histogram_features;
+  pfree(nd_stats);
+
+  /* Prevent rounding overflows */
+  if (selectivity > 1.0) selectivity = 1.0;
+  else if (selectivity < 0.0) selectivity = 0.0;
+
+  return selectivity;
+}
+
+/**
+ * Returns an estimate of the join selectivity of the bounding box operators
+ * between two spatial columns by looking at the data in their ND_STATS
+ * structures. The statistics collected do not allow us to differentiate
+ * between the bounding box operators, which are estimated as overlaps.
+ *
+ * To get our estimate, we sum up for each pair of overlapping cells of the
+ * two histograms the product of their values pro-rated by the proportion
+ * of the cell of the second histogram that is covered by the cell of the
+ * first one, then divide by the number of pairs of features that generated
+ * the histograms.
+ *
+ * This function generalizes PostGIS function estimate_join_selectivity in
+ * file gserialized_estimate.c
+ */
+static float8
+calc_geo_joinselectivity(VariableStatData *vardata1,
+  VariableStatData *vardata2)
+{
+  ND_STATS *s1, *s2;
+  ND_IBOX ibox1, ibox2;
+  int at1[ND_DIMS], at2[ND_DIMS];
+  double min1[ND_DIMS], cellsize1[ND_DIMS];
+  double min2[ND_DIMS], cellsize2[ND_DIMS];
+  int ndims1, ndims2, ndims, d;
+  double total_count = 0.0;
+  float8 selectivity;
+
+  s1 = nd_stats_from_vardata(vardata1, STATISTIC_KIND_ND);
+  if (s1 == NULL)
+    return -1;
+  s2 = nd_stats_from_vardata(vardata2, STATISTIC_KIND_ND);
+  if (s2 == NULL)
+  {
+    pfree(s1);
+    return -1;
+  }
+
+  /* Put the histogram with the fewest cells in the outer loop */
+  if (s1->histogram_cells > s2->histogram_cells)
+  {
+    ND_STATS *swap = s1;
+    s1 = s2;
+    s2 = swap;
+  }
+  ndims1 = (int) s1->ndims;
+  ndims2 = (int) s2->ndims;
+  ndims = Max(ndims1, ndims2);
+
+  /* The extents of the histograms do not intersect */
+  if (! nd_box_intersects(&(s1->extent), &(s2->extent), ndims))
+  {
+    pfree(s1); pfree(s2);
+    return 0.0;
+  }
+
+  /* Cells of the first histogram that overlap the extent of the second one */
+  if (! nd_box_overlap(s1, &(s2->extent), &ibox1))
+  {
+    pfree(s1); pfree(s2);
+    return FALLBACK_ND_JOINSEL;
+  }
+
+  /* Work out some measurements of the histograms */
+  for (d = 0; d < ndims1; d++)
+  {
+    at1[d] = ibox1.min[d];
+    min1[d] = s1->extent.min[d];
+    cellsize1[d] = (s1->extent.max[d] - min1[d]) / s1->size[d];
+  }
+  for (d = 0; d < ndims2; d++)
+  {
+    min2[d] = s2->extent.min[d];
+    cellsize2[d] = (s2->extent.max[d] - min2[d]) / s2->size[d];
+  }
+
+  /* Move through the cells of the first histogram */
+  do
+  {
+    ND_BOX nd_cell1;
+    float cell_count1;
+    nd_box_init(&nd_cell1);
+    for (d = 0; d < ndims1; d++)
+    {
+      nd_cell1.min[d] = (float4) (min1[d] + (at1[d]+0) * cellsize1[d]);
+      nd_cell1.max[d] = (float4) (min1[d] + (at1[d]+1) * cellsize1[d]);
+    }
+    cell_count1 = s1->value[nd_stats_value_index(s1, at1)];
+    if (cell_count1 == 0.0)
+      continue;
+
+    /* Move through the cells of the second histogram that overlap the
+     * cell of the first one */
+    nd_box_overlap(s2, &nd_cell1, &ibox2);
+    memset(at2, 0, sizeof(int) * ND_DIMS);
+    for (d = 0; d < ndims2; d++)
+      at2[d] = ibox2.min[d];
+    do
+    {
+      ND_BOX nd_cell2;
+      float cell_count2, ratio;
+      nd_box_init(&nd_cell2);
+      for (d = 0; d < ndims2; d++)
+      {
+        nd_cell2.min[d] = (float4) (min2[d] + (at2[d]+0) * cellsize2[d]);
+        nd_cell2.max[d] = (float4) (min2[d] + (at2[d]+1) * cellsize2[d]);
+      }
+      ratio = (float4) nd_box_ratio_overlaps(&nd_cell1, &nd_cell2, ndims);
+      cell_count2 = s2->value[nd_stats_value_index(s2, at2)];
+
+      /* Add the pro-rated count for this pair of cells to the total */
+      total_count += cell_count1 * cell_count2 * ratio;
+    }
+    while (nd_increment(&ibox2, ndims2, at2));
+  }
+  while (nd_increment(&ibox1, ndims1, at1));
+
+  /* Scale by the number of pairs of features in our histograms */
+  selectivity = total_count /
+    ((double) s1->histogram_features * s2->histogram_features);
+  pfree(s1); pfree(s2);
+
+  /* Prevent rounding overflows */
+  if (selectivity > 1.0) selectivity = 1.0;
+  else if (selectivity < 0.0) selectivity = 0.0;
+
+  return selectivity;
+}
+
 /*****************************************************************************/
 
 PG_FUNCTION_INFO_V1(tpoint_sel);
@@ -859,6 +1149,23 @@ tpoint_sel(PG_FUNCTION_ARGS)
     PG_RETURN_FLOAT8(default_tpoint_selectivity(cachedOp));
 
   assert(MOBDB_FLAGS_GET_X(constBox.flags) || MOBDB_FLAGS_GET_T(constBox.flags));
+
+  /*
+   * Use the joint space-time histogram for the position operators and for
+   * the bounding box operators when the constant has both dimensions
+   */
+  if (! (cachedOp == OVERLAPS_OP || cachedOp == CONTAINS_OP ||
+      cachedOp == CONTAINED_OP || cachedOp == SAME_OP) ||
+    (MOBDB_FLAGS_GET_X(constBox.flags) && MOBDB_FLAGS_GET_T(constBox.flags)))
+  {
+    selec = calc_geo_time_selectivity(&vardata, &constBox, cachedOp);
+    if (selec >= 0.0)
+    {
+      ReleaseVariableStats(vardata);
+      CLAMP_PROBABILITY(selec);
+      PG_RETURN_FLOAT8(selec);
+    }
+  }
   
   /* Enable the multiplication of the selectivity of the spatial and time 
    * dimensions since either may be missing */
@@ -899,11 +1206,75 @@ tpoint_sel(PG_FUNCTION_ARGS)
 PG_FUNCTION_INFO_V1(tpoint_joinsel);
 /**
  * Estimate the join selectivity value of the operators for temporal points
+ *
+ * The selectivity of the spatial and time dimensions are computed from the
+ * ND_STATS histograms and from the histograms of period bounds of both
+ * columns, and are multiplied assuming that the dimensions are independent.
  */
 PGDLLEXPORT Datum
 tpoint_joinsel(PG_FUNCTION_ARGS)
 {
-  PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+  PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+  Oid operator = PG_GETARG_OID(1);
+  List *args = (List *) PG_GETARG_POINTER(2);
+  SpecialJoinInfo *sjinfo = (SpecialJoinInfo *) PG_GETARG_POINTER(4);
+  VariableStatData vardata1, vardata2;
+  bool join_is_reversed;
+  Selectivity selec, dimselec;
+  CachedOp cachedOp;
+
+  /*
+   * Get enumeration value associated to the operator
+   */
+  bool found = tpoint_cachedop(operator, &cachedOp);
+  /* In the case of unknown operator */
+  if (!found)
+    PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+
+  /* Only joins between two binary operator arguments are estimated */
+  if (list_length(args) != 2)
+    PG_RETURN_FLOAT8(default_tpoint_selectivity(cachedOp));
+
+  get_join_variables(root, args, sjinfo, &vardata1, &vardata2,
+    &join_is_reversed);
+
+  bool bboxop = (cachedOp == OVERLAPS_OP || cachedOp == CONTAINS_OP ||
+    cachedOp == CONTAINED_OP || cachedOp == SAME_OP);
+  bool spaceop = bboxop || (cachedOp >= LEFT_OP && cachedOp <= OVERBACK_OP);
+  /* There is no ~= operator for time types */
+  bool timeop = (bboxop && cachedOp != SAME_OP) ||
+    cachedOp == BEFORE_OP || cachedOp == AFTER_OP ||
+    cachedOp == OVERBEFORE_OP || cachedOp == OVERAFTER_OP;
+  /* The geometries and geographies do not have a time dimension */
+  if (tgeo_base_type(vardata1.atttype) || tgeo_base_type(vardata2.atttype))
+    timeop = false;
+
+  /* Enable the multiplication of the selectivity of the spatial and time
+   * dimensions since either may be missing */
+  selec = (spaceop || timeop) ? 1.0 : -1.0;
+
+  /* Selectivity for the spatial dimension */
+  if (spaceop)
+  {
+    /* The position operators are similar to scalar inequalities */
+    dimselec = bboxop ? calc_geo_joinselectivity(&vardata1, &vardata2) :
+      default_tpoint_selectivity(cachedOp);
+    selec = (dimselec < 0.0) ? -1.0 : selec * dimselec;
+  }
+  /* Selectivity for the time dimension */
+  if (timeop && selec >= 0.0)
+  {
+    dimselec = calc_period_hist_joinselectivity(&vardata1, &vardata2,
+      cachedOp);
+    selec = (dimselec < 0.0) ? -1.0 : selec * dimselec;
+  }
+  if (selec < 0.0)
+    selec = default_tpoint_selectivity(cachedOp);
+
+  ReleaseVariableStats(vardata1);
+  ReleaseVariableStats(vardata2);
+  CLAMP_PROBABILITY(selec);
+  PG_RETURN_FLOAT8(selec);
 }
 
 /*****************************************************************************/
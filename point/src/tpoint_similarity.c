@@ -0,0 +1,356 @@
+/*****************************************************************************
+ *
+ * tpoint_similarity.c
+ *    Similarity distances between temporal points.
+ *
+ * The discrete Frechet distance and the dynamic time warping distance
+ * compare the sequences of the instants of two temporal points regardless
+ * of their timestamps, so that two trips following the same route at
+ * different speeds or at different times are similar. Both distances are
+ * computed by dynamic programming over the coupling matrix of the instants,
+ * keeping only two rows of the matrix in memory.
+ *
+ * The GiST indexes answer k-nearest neighbor queries on these distances
+ * with lower bounds computed from the boxes of the index keys: every
+ * instant of the query is coupled with at least one instant of the value,
+ * which is contained in the box of its key, so that the distance from the
+ * instant of the query to the box bounds its contribution to the result.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_similarity.h"
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+
+#include "temporaltypes.h"
+#include "temporal_util.h"
+#include "tpoint.h"
+#include "tpoint_spatialfuncs.h"
+
+/*****************************************************************************
+ * Points of a temporal point
+ *****************************************************************************/
+
+/**
+ * Returns the points of the instants of a temporal point in time order,
+ * where the z coordinate is set to 0 for two-dimensional points
+ */
+static POINT3DZ *
+tpoint_similarity_points(const Temporal *temp, int *count)
+{
+  const TInstant **instants;
+  POINT3DZ *result;
+  bool hasz = MOBDB_FLAGS_GET_Z(temp->flags);
+  int n = 0;
+
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+  {
+    instants = palloc(sizeof(TInstant *));
+    instants[n++] = (const TInstant *) temp;
+  }
+  else if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (const TInstantSet *) temp;
+    instants = palloc(sizeof(TInstant *) * ti->count);
+    for (int i = 0; i < ti->count; i++)
+      instants[n++] = tinstantset_inst_n(ti, i);
+  }
+  else if (temp->duration == SEQUENCE)
+  {
+    const TSequence *seq = (const TSequence *) temp;
+    instants = palloc(sizeof(TInstant *) * seq->count);
+    for (int i = 0; i < seq->count; i++)
+      instants[n++] = tsequence_inst_n(seq, i);
+  }
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (const TSequenceSet *) temp;
+    instants = palloc(sizeof(TInstant *) * ts->totalcount);
+    for (int i = 0; i < ts->count; i++)
+    {
+      const TSequence *seq = tsequenceset_seq_n(ts, i);
+      for (int j = 0; j < seq->count; j++)
+        instants[n++] = tsequence_inst_n(seq, j);
+    }
+  }
+
+  result = palloc(sizeof(POINT3DZ) * n);
+  for (int i = 0; i < n; i++)
+  {
+    Datum value = tinstant_value(instants[i]);
+    if (hasz)
+      result[i] = datum_get_point3dz(value);
+    else
+    {
+      const POINT2D *point = datum_get_point2d_p(value);
+      result[i].x = point->x;
+      result[i].y = point->y;
+      result[i].z = 0.0;
+    }
+  }
+  pfree(instants);
+  *count = n;
+  return result;
+}
+
+/**
+ * Returns the Euclidean distance between two points
+ */
+static double
+point_similarity_distance(const POINT3DZ *p, const POINT3DZ *q, bool hasz)
+{
+  if (hasz)
+    return hypot3d(p->x - q->x, p->y - q->y, p->z - q->z);
+  return hypot(p->x - q->x, p->y - q->y);
+}
+
+/*****************************************************************************
+ * Similarity distances
+ *****************************************************************************/
+
+/**
+ * Returns the discrete Frechet distance or the dynamic time warping
+ * distance between two arrays of points
+ *
+ * @param[in] points1,count1 First array of points
+ * @param[in] points2,count2 Second array of points
+ * @param[in] hasz True when the distances consider the z coordinates
+ * @param[in] frechet True for the discrete Frechet distance, which is the
+ * maximum of the distances of the coupling, false for the dynamic time
+ * warping distance, which is their sum
+ */
+static double
+points_similarity_distance(const POINT3DZ *points1, int count1,
+  const POINT3DZ *points2, int count2, bool hasz, bool frechet)
+{
+  double *prev = palloc(sizeof(double) * count2);
+  double *curr = palloc(sizeof(double) * count2);
+  double *swap, result;
+
+  for (int i = 0; i < count1; i++)
+  {
+    for (int j = 0; j < count2; j++)
+    {
+      double dist = point_similarity_distance(&points1[i], &points2[j], hasz);
+      double best;
+      if (i == 0 && j == 0)
+      {
+        curr[j] = dist;
+        continue;
+      }
+      if (i == 0)
+        best = curr[j - 1];
+      else if (j == 0)
+        best = prev[j];
+      else
+        best = Min(Min(prev[j - 1], prev[j]), curr[j - 1]);
+      curr[j] = frechet ? Max(best, dist) : best + dist;
+    }
+    swap = prev; prev = curr; curr = swap;
+  }
+  result = prev[count2 - 1];
+  pfree(prev); pfree(curr);
+  return result;
+}
+
+/**
+ * Returns the similarity distance between two temporal points
+ */
+static double
+tpoint_similarity_distance(const Temporal *temp1, const Temporal *temp2,
+  bool frechet)
+{
+  POINT3DZ *points1, *points2;
+  int count1, count2;
+  double result;
+
+  ensure_same_srid_tpoint(temp1, temp2);
+  ensure_same_dimensionality_tpoint(temp1, temp2);
+  points1 = tpoint_similarity_points(temp1, &count1);
+  points2 = tpoint_similarity_points(temp2, &count2);
+  /* Keep the shortest row of the matrix in memory */
+  if (count1 >= count2)
+    result = points_similarity_distance(points1, count1, points2, count2,
+      MOBDB_FLAGS_GET_Z(temp1->flags), frechet);
+  else
+    result = points_similarity_distance(points2, count2, points1, count1,
+      MOBDB_FLAGS_GET_Z(temp1->flags), frechet);
+  pfree(points1); pfree(points2);
+  return result;
+}
+
+/**
+ * Returns the discrete Frechet distance between two temporal points
+ */
+double
+frechet_distance_internal(const Temporal *temp1, const Temporal *temp2)
+{
+  return tpoint_similarity_distance(temp1, temp2, true);
+}
+
+/**
+ * Returns the dynamic time warping distance between two temporal points
+ */
+double
+dyntimewarp_distance_internal(const Temporal *temp1, const Temporal *temp2)
+{
+  return tpoint_similarity_distance(temp1, temp2, false);
+}
+
+PG_FUNCTION_INFO_V1(frechet_distance_tpoint_tpoint);
+/**
+ * Returns the discrete Frechet distance between two temporal points
+ */
+PGDLLEXPORT Datum
+frechet_distance_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+  Temporal *temp1 = PG_GETARG_TEMPORAL(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL(1);
+  double result = frechet_distance_internal(temp1, temp2);
+  PG_FREE_IF_COPY(temp1, 0);
+  PG_FREE_IF_COPY(temp2, 1);
+  PG_RETURN_FLOAT8(result);
+}
+
+PG_FUNCTION_INFO_V1(dyntimewarp_distance_tpoint_tpoint);
+/**
+ * Returns the dynamic time warping distance between two temporal points
+ */
+PGDLLEXPORT Datum
+dyntimewarp_distance_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+  Temporal *temp1 = PG_GETARG_TEMPORAL(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL(1);
+  double result = dyntimewarp_distance_internal(temp1, temp2);
+  PG_FREE_IF_COPY(temp1, 0);
+  PG_FREE_IF_COPY(temp2, 1);
+  PG_RETURN_FLOAT8(result);
+}
+
+/*****************************************************************************
+ * Lower bounds of the similarity distances for the GiST indexes
+ *****************************************************************************/
+
+/**
+ * Structure to cache in the fn_extra field the points of the query of a
+ * k-nearest neighbor search on a similarity distance
+ */
+typedef struct
+{
+  struct varlena *query;   /**< raw datum of the query */
+  bool hasz;               /**< true when the query has z coordinates */
+  int count;               /**< number of points of the query */
+  POINT3DZ *points;        /**< points of the query */
+} SimilarityCache;
+
+/**
+ * Returns true if the strategy orders the entries by a similarity distance
+ */
+bool
+tpoint_similarity_strategy(StrategyNumber strategy)
+{
+  return strategy == RTFrechetStrategyNumber ||
+    strategy == RTDynTimeWarpStrategyNumber;
+}
+
+/**
+ * Returns the points of the query of the GiST distance method, which are
+ * extracted only once per scan
+ *
+ * @note The raw datum is compared so that the query is neither detoasted
+ * nor unpacked again for every entry of the index
+ */
+static SimilarityCache *
+similarity_query_cache(FunctionCallInfo fcinfo)
+{
+  SimilarityCache *cache = (SimilarityCache *) fcinfo->flinfo->fn_extra;
+  struct varlena *raw = (struct varlena *) DatumGetPointer(PG_GETARG_DATUM(1));
+  if (cache != NULL && VARSIZE_ANY(cache->query) == VARSIZE_ANY(raw) &&
+    memcmp(cache->query, raw, VARSIZE_ANY(raw)) == 0)
+    return cache;
+
+  Temporal *query = PG_GETARG_TEMPORAL(1);
+  MemoryContext oldcontext = MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+  if (cache == NULL)
+  {
+    cache = palloc(sizeof(SimilarityCache));
+    fcinfo->flinfo->fn_extra = cache;
+  }
+  else
+  {
+    pfree(cache->query); pfree(cache->points);
+  }
+  cache->query = palloc(VARSIZE_ANY(raw));
+  memcpy(cache->query, raw, VARSIZE_ANY(raw));
+  cache->hasz = MOBDB_FLAGS_GET_Z(query->flags);
+  cache->points = tpoint_similarity_points(query, &cache->count);
+  MemoryContextSwitchTo(oldcontext);
+  PG_FREE_IF_COPY(query, 1);
+  return cache;
+}
+
+/**
+ * Returns the distance between a point and the spatial extent of a box
+ */
+static double
+point_box_distance(const POINT3DZ *point, const STBOX *box, bool hasz)
+{
+  double dx = Max(Max(box->xmin - point->x, point->x - box->xmax), 0);
+  double dy = Max(Max(box->ymin - point->y, point->y - box->ymax), 0);
+  if (hasz && MOBDB_FLAGS_GET_Z(box->flags))
+  {
+    double dz = Max(Max(box->zmin - point->z, point->z - box->zmax), 0);
+    return hypot3d(dx, dy, dz);
+  }
+  return hypot(dx, dy);
+}
+
+/**
+ * Returns a lower bound of the similarity distance between the query of
+ * the GiST distance method and the values whose instants are contained in
+ * the union of the boxes
+ *
+ * Each point of the query is at least at the distance of the nearest box
+ * from the instants with which it is coupled. The lower bound of the
+ * discrete Frechet distance is thus the maximum of these distances and
+ * the one of the dynamic time warping distance is their sum. The time
+ * dimension of the boxes is ignored since the similarity distances do not
+ * depend on the timestamps.
+ *
+ * @param[in] fcinfo Arguments of the GiST distance method
+ * @param[in] boxes Boxes of the key, where the instants of the values
+ * below the key are contained in their union
+ * @param[in] count Number of boxes
+ * @param[in] strategy Strategy of the similarity distance
+ */
+double
+tpoint_similarity_index_distance(FunctionCallInfo fcinfo, const STBOX *boxes,
+  int count, StrategyNumber strategy)
+{
+  SimilarityCache *cache = similarity_query_cache(fcinfo);
+  double result = 0.0;
+
+  assert(tpoint_similarity_strategy(strategy));
+  for (int i = 0; i < cache->count; i++)
+  {
+    double dist = DBL_MAX;
+    for (int j = 0; j < count; j++)
+      dist = Min(dist, point_box_distance(&cache->points[i], &boxes[j],
+        cache->hasz));
+    if (strategy == RTFrechetStrategyNumber)
+      result = Max(result, dist);
+    else
+      result += dist;
+  }
+  return result;
+}
+
+/*****************************************************************************/
@@ -15,6 +15,8 @@
 #include <assert.h>
 #include <float.h>
 #include <math.h>
+#include <access/hash.h>
+#include <funcapi.h>
 #include <utils/builtins.h>
 #include <utils/timestamp.h>
 
@@ -24,6 +26,8 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_packed.h"
+#include "temporal_argcache.h"
 #include "lifting.h"
 #include "tnumber_mathfuncs.h"
 #include "postgis.h"
@@ -34,31 +38,127 @@
 
 /*****************************************************************************/
 
+/*****************************************************************************
+ * Accuracy of the geodetic computations
+ *****************************************************************************/
+
 /**
- * Global variable to save the fcinfo when PostGIS functions need to access
- * the cache such as transform, geography_distance, or geography_azimuth
+ * Global variable that states the accuracy of the segment-level geodetic
+ * computations. It is set by the configuration parameter
+ * mobilitydb.geodetic_accuracy. By default the distances and azimuths are
+ * computed on the spheroid as in PostGIS, with the value sphere they are
+ * computed on the sphere, and with the value fast all computations use a
+ * local equirectangular approximation of the sphere around the segment.
  */
-FunctionCallInfo _FCINFO;
+int geodetic_accuracy = GEODETIC_SPHEROID;
 
 /**
- * Fetch from the cache the fcinfo of the external function
+ * Projects the geography point with the local equirectangular approximation
+ * centered at the origin. The coordinates of the result are in radians on
+ * the unit sphere.
+ *
+ * @param[in] p Point to project
+ * @param[in] origin Origin of the projection
+ * @param[in] coslat Cosine of the reference latitude of the projection
+ * @param[out] q Projected point
  */
-FunctionCallInfo
-fetch_fcinfo()
+static void
+equirect_project(const POINT4D *p, const POINT4D *origin, double coslat,
+  POINT2D *q)
 {
-  assert(_FCINFO);
-  return _FCINFO;
+  q->x = deg2rad(longitude_degrees_normalize(p->x - origin->x)) * coslat;
+  q->y = deg2rad(p->y - origin->y);
 }
 
+/**
+ * Returns the cosine of the mean latitude of the two geography points, which
+ * is the reference latitude of the local equirectangular approximation
+ */
+static double
+equirect_coslat(const POINT4D *p1, const POINT4D *p2)
+{
+  return cos(deg2rad((p1->y + p2->y) / 2));
+}
 
 /**
- * Store in the cache the fcinfo of the external function
+ * Returns the distance in meters between the two geography points computed
+ * on the sphere, or with the local equirectangular approximation when the
+ * geodetic accuracy is fast
  */
-void
-store_fcinfo(FunctionCallInfo fcinfo)
+static double
+geog_point_distance(const POINT4D *p1, const POINT4D *p2)
 {
-  _FCINFO = fcinfo;
-  return;
+  if (geodetic_accuracy == GEODETIC_FAST)
+  {
+    POINT2D q;
+    equirect_project(p2, p1, equirect_coslat(p1, p2), &q);
+    return WGS84_RADIUS * hypot(q.x, q.y);
+  }
+  GEOGRAPHIC_POINT g1, g2;
+  geographic_point_init(p1->x, p1->y, &g1);
+  geographic_point_init(p2->x, p2->y, &g2);
+  return WGS84_RADIUS * sphere_distance(&g1, &g2);
+}
+
+/**
+ * Returns the azimuth in radians between the two geography points computed
+ * on the sphere, or with the local equirectangular approximation when the
+ * geodetic accuracy is fast
+ */
+static double
+geog_point_azimuth(const POINT4D *p1, const POINT4D *p2)
+{
+  double result;
+  if (geodetic_accuracy == GEODETIC_FAST)
+  {
+    POINT2D q;
+    equirect_project(p2, p1, equirect_coslat(p1, p2), &q);
+    result = atan2(q.x, q.y);
+  }
+  else
+  {
+    GEOGRAPHIC_POINT g1, g2;
+    geographic_point_init(p1->x, p1->y, &g1);
+    geographic_point_init(p2->x, p2->y, &g2);
+    result = sphere_direction(&g1, &g2, sphere_distance(&g1, &g2));
+  }
+  /* Return the azimuth in the range [0, 2*PI) as PostGIS does */
+  if (result < 0)
+    result += 2 * M_PI;
+  return result;
+}
+
+/**
+ * Returns a float between 0 and 1 representing the location of the closest
+ * point on the geography segment to the given point, as a fraction of total
+ * segment length, using the local equirectangular approximation.
+ *
+ * @param[in] p Reference point
+ * @param[in] A,B Points defining the segment
+ * @param[out] closest Closest point in the segment
+ * @param[out] dist Angular distance between the closest point and the
+ * reference point
+ */
+static double
+closest_point_on_segment_equirect(const POINT4D *p, const POINT4D *A,
+  const POINT4D *B, POINT4D *closest, double *dist)
+{
+  double coslat = equirect_coslat(A, B);
+  POINT2D a = {0, 0}, b, q, proj;
+  equirect_project(B, A, coslat, &b);
+  equirect_project(p, A, coslat, &q);
+  double result = closest_point2d_on_segment_ratio(&q, &a, &b, &proj);
+  *dist = distance2d_pt_pt(&q, &proj);
+  if (closest)
+  {
+    /* The projection is linear in the longitude and the latitude */
+    closest->x = longitude_degrees_normalize(A->x +
+      longitude_degrees_normalize(B->x - A->x) * result);
+    closest->y = A->y + ((B->y - A->y) * result);
+    closest->z = A->z + ((B->z - A->z) * result);
+    closest->m = A->m + ((B->m - A->m) * result);
+  }
+  return result;
 }
 
 /*****************************************************************************
@@ -181,6 +281,9 @@ double
 closest_point_on_segment_sphere(const POINT4D *p, const POINT4D *A,
   const POINT4D *B, POINT4D *closest, double *dist)
 {
+  if (geodetic_accuracy == GEODETIC_FAST)
+    return closest_point_on_segment_equirect(p, A, B, closest, dist);
+
   GEOGRAPHIC_EDGE e;
   GEOGRAPHIC_POINT a, proj;
   double length, /* length from A to the closest point */
@@ -237,7 +340,14 @@ geoseg_interpolate_point(Datum start, Datum end, double ratio)
   POINT4D p2 = datum_get_point4d(end);
   POINT4D p;
   bool geodetic = FLAGS_GET_GEODETIC(gs->flags);
-  if (geodetic)
+  if (geodetic && geodetic_accuracy == GEODETIC_FAST)
+  {
+    /* The projection is linear in the longitude and the latitude */
+    p2.x = p1.x + longitude_degrees_normalize(p2.x - p1.x);
+    interpolate_point4d(&p1, &p2, &p, ratio);
+    p.x = longitude_degrees_normalize(p.x);
+  }
+  else if (geodetic)
   {
     POINT3D q1, q2;
     GEOGRAPHIC_POINT g1, g2;
@@ -803,14 +913,20 @@ geo_serialize(LWGEOM *geom)
 }
 
 /**
- * Call the PostGIS transform function. We need to use the fcinfo cached
- * in the external functions stbox_transform and tpoint_transform
+ * Call the PostGIS transform function
+ *
+ * @param[in] value Geometry
+ * @param[in] srid SRID
+ * @param[in] flinfo FmgrInfo of the external function in which PostGIS
+ * keeps its cache of spatial reference systems, or NULL to call the function
+ * without cache
  */
 Datum
-datum_transform(Datum value, Datum srid)
+datum_transform(Datum value, Datum srid, FmgrInfo *flinfo)
 {
-  return CallerFInfoFunctionCall2(transform, (fetch_fcinfo())->flinfo,
-    InvalidOid, value, srid);
+  if (flinfo == NULL)
+    return call_function2(transform, value, srid);
+  return CallerFInfoFunctionCall2(transform, flinfo, InvalidOid, value, srid);
 }
 
 /**
@@ -837,9 +953,12 @@ geom_to_geog(Datum value)
 
 /**
  * Returns the 2D distance between the two geometries
+ *
+ * @note The FmgrInfo passed as a pointer datum is not used, it makes the
+ * signature the same as the one of geog_distance
  */
 Datum
-geom_distance2d(Datum geom1, Datum geom2)
+geom_distance2d(Datum geom1, Datum geom2, Datum flinfo)
 {
   return call_function2(distance, geom1, geom2);
 }
@@ -848,26 +967,51 @@ geom_distance2d(Datum geom1, Datum geom2)
  * Returns the 3D distance between the two geometries
  */
 Datum
-geom_distance3d(Datum geom1, Datum geom2)
+geom_distance3d(Datum geom1, Datum geom2, Datum flinfo)
 {
   return call_function2(distance3d, geom1, geom2);
 }
 
 /**
- * Returns the distance between the two geographies
+ * Returns the distance between the two geographies. Unless the geodetic
+ * accuracy is spheroid, the distance is computed on the sphere and, for two
+ * points, directly from their coordinates.
+ *
+ * @param[in] geog1,geog2 Geographies
+ * @param[in] flinfo FmgrInfo passed as a pointer datum in which PostGIS
+ * keeps the trees of the geographies repeated across calls, or NULL to call
+ * the function without cache
  */
 Datum
-geog_distance(Datum geog1, Datum geog2)
-{
-  return CallerFInfoFunctionCall2(geography_distance, (fetch_fcinfo())->flinfo,
-    InvalidOid, geog1, geog2);
+geog_distance(Datum geog1, Datum geog2, Datum flinfo)
+{
+  FmgrInfo *finfo = (FmgrInfo *) DatumGetPointer(flinfo);
+  if (geodetic_accuracy == GEODETIC_SPHEROID)
+    return (finfo == NULL) ?
+      call_function2(geography_distance, geog1, geog2) :
+      CallerFInfoFunctionCall2(geography_distance, finfo, InvalidOid,
+        geog1, geog2);
+
+  GSERIALIZED *gs1 = (GSERIALIZED *) DatumGetPointer(geog1);
+  GSERIALIZED *gs2 = (GSERIALIZED *) DatumGetPointer(geog2);
+  if (gserialized_get_type(gs1) == POINTTYPE && ! gserialized_is_empty(gs1) &&
+    gserialized_get_type(gs2) == POINTTYPE && ! gserialized_is_empty(gs2))
+  {
+    POINT4D p1 = datum_get_point4d(geog1);
+    POINT4D p2 = datum_get_point4d(geog2);
+    return Float8GetDatum(geog_point_distance(&p1, &p2));
+  }
+  return (finfo == NULL) ?
+    call_function3(geography_distance, geog1, geog2, BoolGetDatum(false)) :
+    CallerFInfoFunctionCall3(geography_distance, finfo, InvalidOid,
+      geog1, geog2, BoolGetDatum(false));
 }
 
 /**
  * Returns the 2D distance between the two geometric points
  */
 Datum
-pt_distance2d(Datum geom1, Datum geom2)
+pt_distance2d(Datum geom1, Datum geom2, Datum flinfo)
 {
   const POINT2D *p1 = datum_get_point2d_p(geom1);
   const POINT2D *p2 = datum_get_point2d_p(geom2);
@@ -878,7 +1022,7 @@ pt_distance2d(Datum geom1, Datum geom2)
  * Returns the 3D distance between the two geometric points
  */
 Datum
-pt_distance3d(Datum geom1, Datum geom2)
+pt_distance3d(Datum geom1, Datum geom2, Datum flinfo)
 {
   const POINT3DZ *p1 = datum_get_point3dz_p(geom1);
   const POINT3DZ *p2 = datum_get_point3dz_p(geom2);
@@ -890,6 +1034,64 @@ pt_distance3d(Datum geom1, Datum geom2)
  * Trajectory functions.
  *****************************************************************************/
 
+/**
+ * Structure to collect the distinct points of a trajectory. The points are
+ * looked up in expected constant time in an open addressing hash table that
+ * keeps the position of the points in the array, or -1 for empty slots.
+ */
+typedef struct
+{
+  LWPOINT **points;   /**< Distinct points in the order of first occurrence */
+  int count;          /**< Number of distinct points */
+  int *slots;         /**< Hash table of positions in the array of points */
+  uint32 mask;        /**< Size of the hash table minus one */
+} PointSet;
+
+/**
+ * Initializes the set of distinct points
+ *
+ * @param[out] set Set of points
+ * @param[in] points Array that receives the distinct points
+ * @param[in] maxcount Maximum number of points added to the set
+ */
+static void
+pointset_init(PointSet *set, LWPOINT **points, int maxcount)
+{
+  /* Keep the load factor of the hash table below one half */
+  uint32 size = 8;
+  while (size < (uint32) maxcount * 2)
+    size <<= 1;
+  set->points = points;
+  set->count = 0;
+  set->slots = palloc(sizeof(int) * size);
+  memset(set->slots, -1, sizeof(int) * size);
+  set->mask = size - 1;
+}
+
+/**
+ * Adds the point to the set if it does not contain an equal point
+ *
+ * @result True when the point has been added
+ */
+static bool
+pointset_add(PointSet *set, LWPOINT *point)
+{
+  /* Equal points have equal coordinates and thus equal hash values */
+  POINT4D p;
+  getPoint4d_p(point->point, 0, &p);
+  uint32 i = DatumGetUInt32(hash_any((unsigned char *) &p,
+    sizeof(POINT4D))) & set->mask;
+  while (set->slots[i] >= 0)
+  {
+    if (lwpoint_same(point, set->points[set->slots[i]]) == LW_TRUE)
+      return false;
+    i = (i + 1) & set->mask;
+  }
+  set->slots[i] = set->count;
+  set->points[set->count++] = point;
+  return true;
+}
+
 /**
  * Assemble the set of points of a temporal instant set geometry point as a
  * single geometry.
@@ -904,28 +1106,16 @@ tgeompointi_trajectory(const TInstantSet *ti)
 
   LWPOINT **points = palloc(sizeof(LWPOINT *) * ti->count);
   /* Remove all duplicate points */
-  TInstant *inst = tinstantset_inst_n(ti, 0);
-  GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(tinstant_value_ptr(inst));
-  LWPOINT *value = lwgeom_as_lwpoint(lwgeom_from_gserialized(gs));
-  points[0] = value;
-  int k = 1;
-  for (int i = 1; i < ti->count; i++)
+  PointSet set;
+  pointset_init(&set, points, ti->count);
+  for (int i = 0; i < ti->count; i++)
   {
-    inst = tinstantset_inst_n(ti, i);
-    gs = (GSERIALIZED *) DatumGetPointer(tinstant_value_ptr(inst));
-    value = lwgeom_as_lwpoint(lwgeom_from_gserialized(gs));
-    bool found = false;
-    for (int j = 0; j < k; j++)
-    {
-      if (lwpoint_same(value, points[j]) == LW_TRUE)
-      {
-        found = true;
-        break;
-      }
-    }
-    if (!found)
-      points[k++] = value;
+    TInstant *inst = tinstantset_inst_n(ti, i);
+    GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(tinstant_value_ptr(inst));
+    pointset_add(&set, lwgeom_as_lwpoint(lwgeom_from_gserialized(gs)));
   }
+  int k = set.count;
+  pfree(set.slots);
   LWGEOM *lwresult;
   if (k == 1)
   {
@@ -1031,81 +1221,107 @@ lwpointarr_make_trajectory(LWGEOM **lwpoints, int count, bool linear)
 }
 
 /**
- * Compute the trajectory of an array of instants.
- *
- * @note This function is called by the constructor of a temporal sequence
- * and returns a single Datum which is a geometry/geography.
- * Since the composing points have been already validated in the constructor
- * there is no verification of the input in this function, in particular
- * for geographies it is supposed that the composing points are geodetic
+ * Compute the trajectory of an array of points, removing the consecutive
+ * equal points when the interpolation is linear and all the duplicate
+ * points otherwise
  *
- * @param[in] instants Array of temporal instants
+ * @param[in] points Array of points, which are freed by the function
  * @param[in] count Number of elements in the input array
  * @param[in] linear True when the interpolation is linear
  */
 Datum
-tpointseq_make_trajectory(TInstant **instants, int count, bool linear)
+lwpointarr_trajectory(LWPOINT **points, int count, bool linear)
 {
-  LWPOINT **points = palloc(sizeof(LWPOINT *) * count);
-  LWPOINT *lwpoint;
-  Datum value;
-  GSERIALIZED *gs;
   int k;
   if (linear)
   {
     /* Remove two consecutive points if they are equal */
-    value = tinstant_value(instants[0]);
-    gs = (GSERIALIZED *) DatumGetPointer(value);
-    points[0] = lwgeom_as_lwpoint(lwgeom_from_gserialized(gs));
     k = 1;
     for (int i = 1; i < count; i++)
     {
-      value = tinstant_value(instants[i]);
-      gs = (GSERIALIZED *) DatumGetPointer(value);
-      lwpoint = lwgeom_as_lwpoint(lwgeom_from_gserialized(gs));
-      if (! lwpoint_same(lwpoint, points[k - 1]))
-        points[k++] = lwpoint;
+      if (! lwpoint_same(points[i], points[k - 1]))
+        points[k++] = points[i];
+      else
+        lwpoint_free(points[i]);
     }
   }
   else
   {
      /* Remove all duplicate points */
-    k = 0;
+    PointSet set;
+    pointset_init(&set, points, count);
     for (int i = 0; i < count; i++)
     {
-      value = tinstant_value(instants[i]);
-      gs = (GSERIALIZED *) DatumGetPointer(value);
-      lwpoint = lwgeom_as_lwpoint(lwgeom_from_gserialized(gs));
-      bool found = false;
-      for (int j = 0; j < k; j++)
-      {
-        if (lwpoint_same(lwpoint, points[j]) == LW_TRUE)
-        {
-          found = true;
-          break;
-        }
-      }
-      if (!found)
-        points[k++] = lwpoint;
+      if (! pointset_add(&set, points[i]))
+        lwpoint_free(points[i]);
     }
+    k = set.count;
+    pfree(set.slots);
   }
   Datum result = (k == 1) ?
     PointerGetDatum(geo_serialize((LWGEOM *)points[0])) :
     lwpointarr_make_trajectory((LWGEOM **)points, k, linear);
   for (int i = 0; i < k; i++)
     lwpoint_free(points[i]);
+  return result;
+}
+
+/**
+ * Compute the trajectory of an array of instants.
+ *
+ * @note This function is called by the constructor of a temporal sequence
+ * and returns a single Datum which is a geometry/geography.
+ * Since the composing points have been already validated in the constructor
+ * there is no verification of the input in this function, in particular
+ * for geographies it is supposed that the composing points are geodetic
+ *
+ * @param[in] instants Array of temporal instants
+ * @param[in] count Number of elements in the input array
+ * @param[in] linear True when the interpolation is linear
+ */
+Datum
+tpointseq_make_trajectory(TInstant **instants, int count, bool linear)
+{
+  LWPOINT **points = palloc(sizeof(LWPOINT *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(
+      tinstant_value(instants[i]));
+    points[i] = lwgeom_as_lwpoint(lwgeom_from_gserialized(gs));
+  }
+  Datum result = lwpointarr_trajectory(points, count, linear);
   pfree(points);
   return result;
 }
 
+/**
+ * Compute the trajectory of a temporal sequence point that does not have
+ * its trajectory precomputed
+ */
+static Datum
+tpointseq_compute_trajectory(const TSequence *seq)
+{
+  TInstant **instants = tsequence_instants(seq);
+  Datum result = tpointseq_make_trajectory(instants, seq->count,
+    MOBDB_FLAGS_GET_LINEAR(seq->flags));
+  pfree(instants);
+  return result;
+}
+
 /**
  * Returns the precomputed trajectory of a temporal sequence point
+ *
+ * @note If the trajectory is not precomputed, it is computed on demand and
+ * the result is allocated in the current memory context
  */
 Datum
 tpointseq_trajectory(const TSequence *seq)
 {
-  void *traj = (char *)(&seq->offsets[seq->count + 2]) +   /* start of data */
-    seq->offsets[seq->count + 1];            /* offset */
+  if (! MOBDB_FLAGS_GET_TRAJ(seq->flags))
+    return tpointseq_compute_trajectory(seq);
+  size_t offset = temporal_offset_get(tsequence_offsets_ptr(seq),
+    seq->flags, seq->count);
+  void *traj = tsequence_data_ptr(seq) + offset;
   return PointerGetDatum(traj);
 }
 
@@ -1115,8 +1331,11 @@ tpointseq_trajectory(const TSequence *seq)
 Datum
 tpointseq_trajectory_copy(const TSequence *seq)
 {
-  void *traj = (char *)(&seq->offsets[seq->count + 2]) +   /* start of data */
-      seq->offsets[seq->count + 1];          /* offset */
+  if (! MOBDB_FLAGS_GET_TRAJ(seq->flags))
+    return tpointseq_compute_trajectory(seq);
+  size_t offset = temporal_offset_get(tsequence_offsets_ptr(seq),
+    seq->flags, seq->count);
+  void *traj = tsequence_data_ptr(seq) + offset;
   return PointerGetDatum(gserialized_copy(traj));
 }
 
@@ -1138,46 +1357,21 @@ tgeompoints_trajectory(const TSequenceSet *ts)
 
   LWPOINT **points = palloc(sizeof(LWPOINT *) * ts->totalcount);
   LWGEOM **geoms = palloc(sizeof(LWGEOM *) * ts->count);
-  int k = 0, l = 0;
+  PointSet set;
+  pointset_init(&set, points, ts->totalcount);
+  int k = 0;
   for (int i = 0; i < ts->count; i++)
   {
     Datum traj = tpointseq_trajectory(tsequenceset_seq_n(ts, i));
     GSERIALIZED *gstraj = (GSERIALIZED *)DatumGetPointer(traj);
-    LWPOINT *lwpoint;
     if (gserialized_get_type(gstraj) == POINTTYPE)
-    {
-      lwpoint = lwgeom_as_lwpoint(lwgeom_from_gserialized(gstraj));
-      bool found = false;
-      for (int j = 0; j < l; j++)
-      {
-        if (lwpoint_same(lwpoint, points[j]) == LW_TRUE)
-        {
-          found = true;
-          break;
-        }
-      }
-      if (!found)
-        points[l++] = lwpoint;
-    }
+      pointset_add(&set, lwgeom_as_lwpoint(lwgeom_from_gserialized(gstraj)));
     else if (gserialized_get_type(gstraj) == MULTIPOINTTYPE)
     {
       LWMPOINT *lwmpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gstraj));
       int count = lwmpoint->ngeoms;
       for (int m = 0; m < count; m++)
-      {
-        lwpoint = lwmpoint->geoms[m];
-        bool found = false;
-        for (int j = 0; j < l; j++)
-        {
-          if (lwpoint_same(lwpoint, points[j]) == LW_TRUE)
-            {
-              found = true;
-              break;
-            }
-        }
-        if (!found)
-          points[l++] = lwpoint;
-      }
+        pointset_add(&set, lwmpoint->geoms[m]);
     }
     /* gserialized_get_type(gstraj) == LINETYPE */
     else
@@ -1185,6 +1379,8 @@ tgeompoints_trajectory(const TSequenceSet *ts)
       geoms[k++] = lwgeom_from_gserialized(gstraj);
     }
   }
+  int l = set.count;
+  pfree(set.slots);
   Datum result;
   if (k == 0)
   {
@@ -1281,12 +1477,27 @@ tpoint_trajectory_internal(const Temporal *temp)
 PG_FUNCTION_INFO_V1(tpoint_trajectory);
 /**
  * Returns the trajectory of a temporal point
+ *
+ * @note The temporal point is cached in the fn_extra field when it is
+ * received again in the next call, so that its trajectory is computed only
+ * once when the function is called repeatedly with the same value in a
+ * query
  */
 PGDLLEXPORT Datum
 tpoint_trajectory(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
-  Datum result = tpoint_trajectory_internal(temp);
+  ArgCacheEntry *entry = argcache_temporal(fcinfo, 0);
+  if (entry != NULL)
+  {
+    GSERIALIZED *traj = (GSERIALIZED *) DatumGetPointer(
+      argcache_tpoint_trajectory(fcinfo, entry));
+    PG_RETURN_POINTER(gserialized_copy(traj));
+  }
+  /* The trajectory of a packed value is computed from its coordinates */
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
+  Datum result = MOBDB_FLAGS_GET_PACKED(temp->flags) ?
+    tpointpk_trajectory((TemporalPacked *) temp) :
+    tpoint_trajectory_internal(temp);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_DATUM(result);
 }
@@ -1388,8 +1599,10 @@ PG_FUNCTION_INFO_V1(tpoint_srid);
 PGDLLEXPORT Datum
 tpoint_srid(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
-  int result = tpoint_srid_internal(temp);
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
+  int result = MOBDB_FLAGS_GET_PACKED(temp->flags) ?
+    tpointpk_bbox_ptr((TemporalPacked *) temp)->srid :
+    tpoint_srid_internal(temp);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_INT32(result);
 }
@@ -1531,10 +1744,8 @@ stbox_transform(PG_FUNCTION_ARGS)
   lwgeom_set_geodetic((LWGEOM *)ptmax, geodetic);
   Datum min = PointerGetDatum(geo_serialize((LWGEOM *)ptmin));
   Datum max = PointerGetDatum(geo_serialize((LWGEOM *)ptmax));
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
-  Datum min1 = datum_transform(min, srid);
-  Datum max1 = datum_transform(max, srid);
+  Datum min1 = datum_transform(min, srid, fcinfo->flinfo);
+  Datum max1 = datum_transform(max, srid, fcinfo->flinfo);
   if (hasz)
   {
     const POINT3DZ *ptmin1 = datum_get_point3dz_p(min1);
@@ -1565,110 +1776,143 @@ stbox_transform(PG_FUNCTION_ARGS)
 
 /**
  * Transform a temporal instant point into another spatial reference system
+ *
+ * @param[in] inst Temporal point
+ * @param[in] srid SRID
+ * @param[in] flinfo FmgrInfo passed to the PostGIS transform function
  */
 TInstant *
-tpointinst_transform(const TInstant *inst, Datum srid)
+tpointinst_transform(const TInstant *inst, Datum srid, FmgrInfo *flinfo)
 {
-  Datum geo = datum_transform(tinstant_value(inst), srid);
+  Datum geo = datum_transform(tinstant_value(inst), srid, flinfo);
   TInstant *result = tinstant_make(geo, inst->t, inst->valuetypid);
   pfree(DatumGetPointer(geo));
   return result;
 }
 
+/**
+ * Transform the points of the temporal instant points into another spatial
+ * reference system with a single call to the PostGIS transform function
+ *
+ * The coordinates are gathered into a single point array, and the transformed
+ * coordinates are written back into the values of the instants, which are
+ * thus modified in place.
+ *
+ * @param[in,out] instants Array of temporal instant points
+ * @param[in] count Number of elements in the input array
+ * @param[in] srid SRID
+ * @param[in] flinfo FmgrInfo passed to the PostGIS transform function
+ * @pre The number of instants is greater than 1
+ */
+static void
+tpointinstarr_transform(TInstant **instants, int count, Datum srid,
+  FmgrInfo *flinfo)
+{
+  GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(
+    tinstant_value_ptr(instants[0]));
+  bool hasz = (bool) FLAGS_GET_Z(gs->flags);
+  POINTARRAY *pa = ptarray_construct(hasz, false, (uint32_t) count);
+  POINT4D p;
+  p.z = p.m = 0.0;
+  for (int i = 0; i < count; i++)
+  {
+    gs = (GSERIALIZED *) DatumGetPointer(tinstant_value_ptr(instants[i]));
+    if (hasz)
+    {
+      const POINT3DZ *point = gs_get_point3dz_p(gs);
+      p.x = point->x; p.y = point->y; p.z = point->z;
+    }
+    else
+    {
+      const POINT2D *point = gs_get_point2d_p(gs);
+      p.x = point->x; p.y = point->y;
+    }
+    ptarray_set_point4d(pa, (uint32_t) i, &p);
+  }
+  LWLINE *lwline = lwline_construct(gserialized_get_srid(gs), NULL, pa);
+  Datum line = PointerGetDatum(geo_serialize((LWGEOM *) lwline));
+  lwline_free(lwline);
+  Datum transf = datum_transform(line, srid, flinfo);
+  GSERIALIZED *gstransf = (GSERIALIZED *) PG_DETOAST_DATUM(transf);
+  LWLINE *lwtransf = lwgeom_as_lwline(lwgeom_from_gserialized(gstransf));
+  int32 newsrid = DatumGetInt32(srid);
+  for (int i = 0; i < count; i++)
+  {
+    gs = (GSERIALIZED *) DatumGetPointer(tinstant_value_ptr(instants[i]));
+    getPoint4d_p(lwtransf->points, (uint32_t) i, &p);
+    if (hasz)
+    {
+      POINT3DZ *point = (POINT3DZ *) gs_get_point3dz_p(gs);
+      point->x = p.x; point->y = p.y; point->z = p.z;
+    }
+    else
+    {
+      POINT2D *point = (POINT2D *) gs_get_point2d_p(gs);
+      point->x = p.x; point->y = p.y;
+    }
+    gserialized_set_srid(gs, newsrid);
+  }
+  lwline_free(lwtransf);
+  POSTGIS_FREE_IF_COPY_P(gstransf, DatumGetPointer(transf));
+  pfree(DatumGetPointer(line)); pfree(DatumGetPointer(transf));
+  return;
+}
+
 /**
  * Transform a temporal instant set point into another spatial reference system
  */
 static TInstantSet *
-tpointinstset_transform(const TInstantSet *ti, Datum srid)
+tpointinstset_transform(const TInstantSet *ti, Datum srid, FmgrInfo *flinfo)
 {
-  TInstant *inst;
-
   /* Singleton instant set */
   if (ti->count == 1)
   {
-    inst = tpointinst_transform(tinstantset_inst_n(ti, 0), srid);
+    TInstant *inst = tpointinst_transform(tinstantset_inst_n(ti, 0), srid,
+      flinfo);
     TInstantSet *result = tinstantset_make(&inst, 1);
     pfree(inst);
     return result;
   }
 
   /* General case */
-  LWGEOM **points = palloc(sizeof(LWGEOM *) * ti->count);
-  for (int i = 0; i < ti->count; i++)
-  {
-    Datum value = tinstant_value(tinstantset_inst_n(ti, i));
-    GSERIALIZED *gsvalue = (GSERIALIZED *) DatumGetPointer(value);
-    points[i] = lwgeom_from_gserialized(gsvalue);
-  }
-  Datum multipoint = lwpointarr_make_trajectory(points, ti->count, false);
-  Datum transf = datum_transform(multipoint, srid);
-  GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(transf);
-  LWMPOINT *lwmpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gs));
+  TInstantSet *copy = tinstantset_copy(ti);
   TInstant **instants = palloc(sizeof(TInstant *) * ti->count);
   for (int i = 0; i < ti->count; i++)
-  {
-    Datum point = PointerGetDatum(geo_serialize((LWGEOM *) (lwmpoint->geoms[i])));
-    inst = tinstantset_inst_n(ti, i);
-    instants[i] = tinstant_make(point, inst->t, inst->valuetypid);
-    pfree(DatumGetPointer(point));
-  }
-  for (int i = 0; i < ti->count; i++)
-    lwpoint_free((LWPOINT *) points[i]);
-  pfree(points);
-  pfree(DatumGetPointer(multipoint)); pfree(DatumGetPointer(transf));
-  POSTGIS_FREE_IF_COPY_P(gs, DatumGetPointer(gs));
-  lwmpoint_free(lwmpoint);
-
-  return tinstantset_make_free(instants, ti->count);
+    instants[i] = tinstantset_inst_n(copy, i);
+  tpointinstarr_transform(instants, ti->count, srid, flinfo);
+  TInstantSet *result = tinstantset_make(instants, ti->count);
+  pfree(instants); pfree(copy);
+  return result;
 }
 
 /**
  * Transform a temporal sequence point into another spatial reference system
  */
 static TSequence *
-tpointseq_transform(const TSequence *seq, Datum srid)
+tpointseq_transform(const TSequence *seq, Datum srid, FmgrInfo *flinfo)
 {
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
 
   /* Instantaneous sequence */
   if (seq->count == 1)
   {
-    TInstant *inst = tpointinst_transform(tsequence_inst_n(seq, 0), srid);
+    TInstant *inst = tpointinst_transform(tsequence_inst_n(seq, 0), srid,
+      flinfo);
     TSequence *result = tinstant_to_tsequence(inst, linear);
     pfree(inst);
     return result;
   }
 
   /* General case */
-  LWGEOM **points = palloc(sizeof(LWGEOM *) * seq->count);
-  for (int i = 0; i < seq->count; i++)
-  {
-    Datum value = tinstant_value(tsequence_inst_n(seq, i));
-    GSERIALIZED *gsvalue = (GSERIALIZED *)DatumGetPointer(value);
-    points[i] = lwgeom_from_gserialized(gsvalue);
-  }
-  Datum multipoint = lwpointarr_make_trajectory(points, seq->count, false);
-  Datum transf = datum_transform(multipoint, srid);
-  GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(transf);
-  LWMPOINT *lwmpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gs));
+  TSequence *copy = tsequence_copy(seq);
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   for (int i = 0; i < seq->count; i++)
-  {
-    Datum point = PointerGetDatum(geo_serialize((LWGEOM *) (lwmpoint->geoms[i])));
-    TInstant *inst = tsequence_inst_n(seq, i);
-    instants[i] = tinstant_make(point, inst->t, inst->valuetypid);
-    pfree(DatumGetPointer(point));
-  }
-
-  for (int i = 0; i < seq->count; i++)
-    lwpoint_free((LWPOINT *) points[i]);
-  pfree(points);
-  pfree(DatumGetPointer(multipoint)); pfree(DatumGetPointer(transf));
-  POSTGIS_FREE_IF_COPY_P(gs, DatumGetPointer(gs));
-  lwmpoint_free(lwmpoint);
-
-  return tsequence_make_free(instants, seq->count,
+    instants[i] = tsequence_inst_n(copy, i);
+  tpointinstarr_transform(instants, seq->count, srid, flinfo);
+  TSequence *result = tsequence_make(instants, seq->count,
     seq->period.lower_inc, seq->period.upper_inc, linear, NORMALIZE_NO);
+  pfree(instants); pfree(copy);
+  return result;
 }
 
 /**
@@ -1678,62 +1922,42 @@ tpointseq_transform(const TSequence *seq, Datum srid)
  * not iterate through the sequences and call the transform for the sequence.
  */
 static TSequenceSet *
-tpointseqset_transform(const TSequenceSet *ts, Datum srid)
+tpointseqset_transform(const TSequenceSet *ts, Datum srid, FmgrInfo *flinfo)
 {
   /* Singleton sequence set */
   if (ts->count == 1)
   {
-    TSequence *seq = tpointseq_transform(tsequenceset_seq_n(ts, 0), srid);
+    TSequence *seq = tpointseq_transform(tsequenceset_seq_n(ts, 0), srid,
+      flinfo);
     TSequenceSet *result = tsequence_to_tsequenceset(seq);
     pfree(seq);
     return result;
   }
 
   /* General case */
+  TSequenceSet *copy = tsequenceset_copy(ts);
+  TInstant **instants = palloc(sizeof(TInstant *) * ts->totalcount);
   int k = 0;
-  LWGEOM **points = palloc(sizeof(LWGEOM *) * ts->totalcount);
-  int maxcount = -1; /* number of instants of the longest sequence */
   for (int i = 0; i < ts->count; i++)
   {
-    TSequence *seq = tsequenceset_seq_n(ts, i);
-    maxcount = Max(maxcount, seq->count);
+    TSequence *seq = tsequenceset_seq_n(copy, i);
     for (int j = 0; j < seq->count; j++)
-    {
-      Datum value = tinstant_value(tsequence_inst_n(seq, j));
-      GSERIALIZED *gsvalue = (GSERIALIZED *)DatumGetPointer(value);
-      points[k++] = lwgeom_from_gserialized(gsvalue);
-    }
+      instants[k++] = tsequence_inst_n(seq, j);
   }
-  Datum multipoint = lwpointarr_make_trajectory(points, ts->totalcount, false);
-  Datum transf = datum_transform(multipoint, srid);
-  GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(transf);
-  LWMPOINT *lwmpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gs));
+  tpointinstarr_transform(instants, ts->totalcount, srid, flinfo);
   TSequence **sequences = palloc(sizeof(TSequence *) * ts->count);
-  TInstant **instants = palloc(sizeof(TInstant *) * maxcount);
   bool linear = MOBDB_FLAGS_GET_LINEAR(ts->flags);
   k = 0;
   for (int i = 0; i < ts->count; i++)
   {
     TSequence *seq = tsequenceset_seq_n(ts, i);
-    for (int j = 0; j < seq->count; j++)
-    {
-      Datum point = PointerGetDatum(geo_serialize((LWGEOM *) (lwmpoint->geoms[k++])));
-      TInstant *inst = tsequence_inst_n(seq, j);
-      instants[j] = tinstant_make(point, inst->t, inst->valuetypid);
-      pfree(DatumGetPointer(point));
-    }
-    sequences[i] = tsequence_make(instants, seq->count,
+    sequences[i] = tsequence_make(&instants[k], seq->count,
       seq->period.lower_inc, seq->period.upper_inc, linear, NORMALIZE_NO);
-    for (int j = 0; j < seq->count; j++)
-      pfree(instants[j]);
-  }
-  TSequenceSet *result = tsequenceset_make_free(sequences, ts->count, NORMALIZE_NO);
-  for (int i = 0; i < ts->totalcount; i++)
-    lwpoint_free((LWPOINT *) points[i]);
-  pfree(points); pfree(instants);
-  pfree(DatumGetPointer(multipoint)); pfree(DatumGetPointer(transf));
-  POSTGIS_FREE_IF_COPY_P(gs, DatumGetPointer(gs));
-  lwmpoint_free(lwmpoint);
+    k += seq->count;
+  }
+  TSequenceSet *result = tsequenceset_make_free(sequences, ts->count,
+    NORMALIZE_NO);
+  pfree(instants); pfree(copy);
   return result;
 }
 
@@ -1746,19 +1970,22 @@ tpoint_transform(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
   Datum srid = PG_GETARG_DATUM(1);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
+  /* PostGIS keeps its cache of spatial reference systems in the fn_extra
+   * field of this function */
+  FmgrInfo *flinfo = fcinfo->flinfo;
 
   Temporal *result;
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT)
-    result = (Temporal *) tpointinst_transform((TInstant *)temp, srid);
+    result = (Temporal *) tpointinst_transform((TInstant *)temp, srid, flinfo);
   else if (temp->duration == INSTANTSET)
-    result = (Temporal *) tpointinstset_transform((TInstantSet *)temp, srid);
+    result = (Temporal *) tpointinstset_transform((TInstantSet *)temp, srid,
+      flinfo);
   else if (temp->duration == SEQUENCE)
-    result = (Temporal *) tpointseq_transform((TSequence *)temp, srid);
+    result = (Temporal *) tpointseq_transform((TSequence *)temp, srid, flinfo);
   else /* temp->duration == SEQUENCESET */
-    result = (Temporal *) tpointseqset_transform((TSequenceSet *)temp, srid);
+    result = (Temporal *) tpointseqset_transform((TSequenceSet *)temp, srid,
+      flinfo);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_POINTER(result);
 }
@@ -1813,12 +2040,53 @@ tgeogpoint_to_tgeompoint_old(PG_FUNCTION_ARGS)
 #define GEOG_FROM_GEOM        true
 #define GEOM_FROM_GEOG        false
 
+/**
+ * Returns true if the conversion of the temporal instant point does not
+ * change the coordinates of the point, which is the case for a geography
+ * point and for a geometry point without SRID or in WGS84 whose
+ * coordinates are valid longitudes and latitudes
+ */
+static bool
+tpointinst_convert_flags_only(const TInstant *inst, bool oper)
+{
+  GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(tinstant_value_ptr(inst));
+  if (FLAGS_GET_BBOX(gs->flags))
+    return false;
+  if (oper == GEOM_FROM_GEOG)
+    return true;
+  int32 srid = gserialized_get_srid(gs);
+  if (srid != SRID_UNKNOWN && srid != SRID_DEFAULT)
+    return false;
+  const POINT2D *pt = gs_get_point2d_p(gs);
+  return pt->x >= -180.0 && pt->x <= 180.0 && pt->y >= -90.0 && pt->y <= 90.0;
+}
+
+/**
+ * Converts the temporal point to a geometry/geography point by rewriting
+ * the flags, the base type, and the SRID of a copy of the point
+ */
+static TInstant *
+tpointinst_convert_flags(const TInstant *inst, bool oper)
+{
+  TInstant *result = tinstant_copy(inst);
+  GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(tinstant_value_ptr(result));
+  FLAGS_SET_GEODETIC(gs->flags, oper == GEOG_FROM_GEOM);
+  if (gserialized_get_srid(gs) == SRID_UNKNOWN)
+    gserialized_set_srid(gs, SRID_DEFAULT);
+  MOBDB_FLAGS_SET_GEODETIC(result->flags, oper == GEOG_FROM_GEOM);
+  result->valuetypid = (oper == GEOG_FROM_GEOM) ?
+    type_oid(T_GEOGRAPHY) : type_oid(T_GEOMETRY);
+  return result;
+}
+
 /**
  * Converts the temporal point to a geometry/geography point
  */
 static TInstant *
 tpointinst_convert_tgeom_tgeog(const TInstant *inst, bool oper)
 {
+    if (tpointinst_convert_flags_only(inst, oper))
+      return tpointinst_convert_flags(inst, oper);
     Datum point = (oper == GEOG_FROM_GEOM) ?
       call_function1(geography_from_geometry, tinstant_value(inst)) :
       call_function1(geometry_from_geography, tinstant_value(inst));
@@ -1832,11 +2100,26 @@ tpointinst_convert_tgeom_tgeog(const TInstant *inst, bool oper)
 static TInstantSet *
 tpointinstset_convert_tgeom_tgeog(const TInstantSet *ti, bool oper)
 {
-  /* Construct a multipoint with all the points */
-  LWPOINT **points = palloc(sizeof(LWPOINT *) * ti->count);
   TInstant *inst;
   GSERIALIZED *gs;
-  for (int i = 0; i < ti->count; i++)
+  int i;
+  /* The points are rewritten if the coordinates are not changed */
+  for (i = 0; i < ti->count; i++)
+  {
+    if (! tpointinst_convert_flags_only(tinstantset_inst_n(ti, i), oper))
+      break;
+  }
+  if (i == ti->count)
+  {
+    TInstant **instants = palloc(sizeof(TInstant *) * ti->count);
+    for (i = 0; i < ti->count; i++)
+      instants[i] = tpointinst_convert_flags(tinstantset_inst_n(ti, i), oper);
+    return tinstantset_make_free(instants, ti->count);
+  }
+
+  /* Construct a multipoint with all the points */
+  LWPOINT **points = palloc(sizeof(LWPOINT *) * ti->count);
+  for (i = 0; i < ti->count; i++)
   {
     inst = tinstantset_inst_n(ti, i);
     gs = (GSERIALIZED *) DatumGetPointer(tinstant_value_ptr(inst));
@@ -1845,7 +2128,7 @@ tpointinstset_convert_tgeom_tgeog(const TInstantSet *ti, bool oper)
   LWGEOM *lwresult = (LWGEOM *) lwcollection_construct(MULTIPOINTTYPE,
       points[0]->srid, NULL, (uint32_t) ti->count, (LWGEOM **) points);
   Datum mpoint_orig = PointerGetDatum(geo_serialize(lwresult));
-  for (int i = 0; i < ti->count; i++)
+  for (i = 0; i < ti->count; i++)
     lwpoint_free(points[i]);
   pfree(points);
   /* Convert the multipoint geometry/geography */
@@ -1856,7 +2139,7 @@ tpointinstset_convert_tgeom_tgeog(const TInstantSet *ti, bool oper)
   gs = (GSERIALIZED *) DatumGetPointer(mpoint_trans);
   LWMPOINT *lwmpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gs));
   TInstant **instants = palloc(sizeof(TInstant *) * ti->count);
-  for (int i = 0; i < ti->count; i++)
+  for (i = 0; i < ti->count; i++)
   {
     inst = tinstantset_inst_n(ti, i);
     Datum point = PointerGetDatum(geo_serialize((LWGEOM *)(lwmpoint->geoms[i])));
@@ -1874,20 +2157,36 @@ tpointinstset_convert_tgeom_tgeog(const TInstantSet *ti, bool oper)
 static TSequence *
 tpointseq_convert_tgeom_tgeog(const TSequence *seq, bool oper)
 {
-  /* Construct a multipoint with all the points */
-  LWPOINT **points = palloc(sizeof(LWPOINT *) * seq->count);
   TInstant *inst;
   GSERIALIZED *gs;
-  for (int i = 0; i < seq->count; i++)
+  int i;
+  /* The points are rewritten if the coordinates are not changed */
+  for (i = 0; i < seq->count; i++)
   {
-    inst = tsequence_inst_n(seq, i);
-    gs = (GSERIALIZED *) DatumGetPointer(tinstant_value_ptr(inst));
-    points[i] = lwgeom_as_lwpoint(lwgeom_from_gserialized(gs));
+    if (! tpointinst_convert_flags_only(tsequence_inst_n(seq, i), oper))
+      break;
   }
-  LWGEOM *lwresult = (LWGEOM *) lwcollection_construct(MULTIPOINTTYPE,
-      points[0]->srid, NULL, (uint32_t) seq->count, (LWGEOM **) points);
-  Datum mpoint_orig = PointerGetDatum(geo_serialize(lwresult));
-  for (int i = 0; i < seq->count; i++)
+  if (i == seq->count)
+  {
+    TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+    for (i = 0; i < seq->count; i++)
+      instants[i] = tpointinst_convert_flags(tsequence_inst_n(seq, i), oper);
+    return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
+      seq->period.upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE_NO);
+  }
+
+  /* Construct a multipoint with all the points */
+  LWPOINT **points = palloc(sizeof(LWPOINT *) * seq->count);
+  for (i = 0; i < seq->count; i++)
+  {
+    inst = tsequence_inst_n(seq, i);
+    gs = (GSERIALIZED *) DatumGetPointer(tinstant_value_ptr(inst));
+    points[i] = lwgeom_as_lwpoint(lwgeom_from_gserialized(gs));
+  }
+  LWGEOM *lwresult = (LWGEOM *) lwcollection_construct(MULTIPOINTTYPE,
+      points[0]->srid, NULL, (uint32_t) seq->count, (LWGEOM **) points);
+  Datum mpoint_orig = PointerGetDatum(geo_serialize(lwresult));
+  for (i = 0; i < seq->count; i++)
     lwpoint_free(points[i]);
   pfree(points);
   /* Convert the multipoint geometry/geography */
@@ -1898,7 +2197,7 @@ tpointseq_convert_tgeom_tgeog(const TSequence *seq, bool oper)
   gs = (GSERIALIZED *) DatumGetPointer(mpoint_trans);
   LWMPOINT *lwmpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gs));
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  for (int i = 0; i < seq->count; i++)
+  for (i = 0; i < seq->count; i++)
   {
     inst = tsequence_inst_n(seq, i);
     Datum point = PointerGetDatum(geo_serialize((LWGEOM *)(lwmpoint->geoms[i])));
@@ -2033,6 +2332,79 @@ tpoint_set_precision(PG_FUNCTION_ARGS)
  * Length functions
  *****************************************************************************/
 
+/**
+ * Returns the azimuth of the two geometry points
+ */
+static Datum
+geom_azimuth(Datum geom1, Datum geom2)
+{
+  const POINT2D *p1 = datum_get_point2d_p(geom1);
+  const POINT2D *p2 = datum_get_point2d_p(geom2);
+  double result;
+  azimuth_pt_pt(p1, p2, &result);
+  return Float8GetDatum(result);
+}
+
+/**
+ * Returns the azimuth the two geography points
+ */
+static Datum
+geog_azimuth(Datum geom1, Datum geom2)
+{
+  if (geodetic_accuracy == GEODETIC_SPHEROID)
+    return call_function2(geography_azimuth, geom1, geom2);
+  POINT4D p1 = datum_get_point4d(geom1);
+  POINT4D p2 = datum_get_point4d(geom2);
+  return Float8GetDatum(geog_point_azimuth(&p1, &p2));
+}
+
+/**
+ * Computes in a single pass whether the points of the segments of the
+ * temporal sequence point are equal and, optionally, the lengths and the
+ * azimuths of the segments. The lengths of geometric points are computed
+ * directly from their coordinates.
+ *
+ * @param[in] seq Temporal sequence point with at least two instants
+ * @param[out] equal True for the segments whose points are equal
+ * @param[out] lengths Lengths of the segments, may be NULL
+ * @param[out] azimuths Azimuths of the segments whose points are different,
+ * may be NULL
+ */
+static void
+tpointseq_segments(const TSequence *seq, bool *equal, double *lengths,
+  double *azimuths)
+{
+  bool geodetic = MOBDB_FLAGS_GET_GEODETIC(seq->flags);
+  bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+  Datum value1 = tinstant_value(tsequence_inst_n(seq, 0));
+  for (int i = 0; i < seq->count - 1; i++)
+  {
+    Datum value2 = tinstant_value(tsequence_inst_n(seq, i + 1));
+    equal[i] = datum_point_eq(value1, value2);
+    if (lengths != NULL)
+    {
+      if (equal[i])
+        lengths[i] = 0;
+      else if (geodetic)
+        /* The points of the segments change at every call and thus
+         * PostGIS is called without cache */
+        lengths[i] = DatumGetFloat8(geog_distance(value1, value2,
+          PointerGetDatum(NULL)));
+      else if (hasz)
+        lengths[i] = distance3d_pt_pt(
+          (POINT3D *) datum_get_point3dz_p(value1),
+          (POINT3D *) datum_get_point3dz_p(value2));
+      else
+        lengths[i] = distance2d_pt_pt(datum_get_point2d_p(value1),
+          datum_get_point2d_p(value2));
+    }
+    if (azimuths != NULL && ! equal[i])
+      azimuths[i] = DatumGetFloat8(geodetic ?
+        geog_azimuth(value1, value2) : geom_azimuth(value1, value2));
+    value1 = value2;
+  }
+}
+
 /**
  * Returns the length traversed by the temporal sequence point
  */
@@ -2040,17 +2412,29 @@ static double
 tpointseq_length(const TSequence *seq)
 {
   assert(MOBDB_FLAGS_GET_LINEAR(seq->flags));
-  Datum traj = tpointseq_trajectory(seq);
-  GSERIALIZED *gstraj = (GSERIALIZED *)DatumGetPointer(traj);
-  if (gserialized_get_type(gstraj) == POINTTYPE)
+  if (seq->count == 1)
     return 0;
 
-  /* We are sure that the trajectory is a line */
-  double result = MOBDB_FLAGS_GET_GEODETIC(seq->flags) ?
-    DatumGetFloat8(call_function2(geography_length, traj,
-      BoolGetDatum(true))) :
-    /* The next function call works for 2D and 3D */
-    DatumGetFloat8(call_function1(LWGEOM_length_linestring, traj));
+  if (MOBDB_FLAGS_GET_GEODETIC(seq->flags) &&
+    geodetic_accuracy == GEODETIC_SPHEROID)
+  {
+    Datum traj = tpointseq_trajectory(seq);
+    GSERIALIZED *gstraj = (GSERIALIZED *)DatumGetPointer(traj);
+    if (gserialized_get_type(gstraj) == POINTTYPE)
+      return 0;
+    /* We are sure that the trajectory is a line */
+    return DatumGetFloat8(call_function2(geography_length, traj,
+      BoolGetDatum(true)));
+  }
+
+  /* Add the lengths of the segments in the order of the trajectory */
+  bool *equal = palloc(sizeof(bool) * (seq->count - 1));
+  double *lengths = palloc(sizeof(double) * (seq->count - 1));
+  tpointseq_segments(seq, equal, lengths, NULL);
+  double result = 0;
+  for (int i = 0; i < seq->count - 1; i++)
+    result += lengths[i];
+  pfree(equal); pfree(lengths);
   return result;
 }
 
@@ -2117,9 +2501,16 @@ tpointinstset_cumulative_length(const TInstantSet *ti)
 
 /**
  * Returns the cumulative length traversed by the temporal sequence point
+ * from the lengths of its segments
+ *
+ * @param[in] seq Temporal sequence point
+ * @param[in] lengths Lengths of the segments, ignored for instantaneous
+ * sequences and stepwise interpolation
+ * @param[in] prevlength Length traversed before the sequence
  */
 static TSequence *
-tpointseq_cumulative_length(const TSequence *seq, double prevlength)
+tpointseq_cumulative_length1(const TSequence *seq, const double *lengths,
+  double prevlength)
 {
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
 
@@ -2148,37 +2539,34 @@ tpointseq_cumulative_length(const TSequence *seq, double prevlength)
   else
   /* Linear interpolation */
   {
-    Datum (*func)(Datum, Datum);
-    if (MOBDB_FLAGS_GET_GEODETIC(seq->flags))
-      func = &geog_distance;
-    else
-      func = MOBDB_FLAGS_GET_Z(seq->flags) ? &pt_distance3d :
-        &pt_distance2d;
-
-    TInstant *inst1 = tsequence_inst_n(seq, 0);
-    Datum value1 = tinstant_value(inst1);
     double length = prevlength;
-    instants[0] = tinstant_make(Float8GetDatum(length), inst1->t,
-        FLOAT8OID);
+    instants[0] = tinstant_make(Float8GetDatum(length),
+      tsequence_inst_n(seq, 0)->t, FLOAT8OID);
     for (int i = 1; i < seq->count; i++)
     {
-      TInstant *inst2 = tsequence_inst_n(seq, i);
-      Datum value2 = tinstant_value(inst2);
-      if (datum_ne(value1, value2, inst1->valuetypid))
-        length += DatumGetFloat8(func(value1, value2));
-      instants[i] = tinstant_make(Float8GetDatum(length), inst2->t,
-        FLOAT8OID);
-      inst1 = inst2;
-      value1 = value2;
+      length += lengths[i - 1];
+      instants[i] = tinstant_make(Float8GetDatum(length),
+        tsequence_inst_n(seq, i)->t, FLOAT8OID);
     }
   }
-  TSequence *result = tsequence_make(instants, seq->count,
+  return tsequence_make_free(instants, seq->count,
     seq->period.lower_inc, seq->period.upper_inc, linear, NORMALIZE);
+}
 
-  for (int i = 1; i < seq->count; i++)
-    pfree(instants[i]);
-  pfree(instants);
+/**
+ * Returns the cumulative length traversed by the temporal sequence point
+ */
+static TSequence *
+tpointseq_cumulative_length(const TSequence *seq, double prevlength)
+{
+  if (seq->count == 1 || ! MOBDB_FLAGS_GET_LINEAR(seq->flags))
+    return tpointseq_cumulative_length1(seq, NULL, prevlength);
 
+  bool *equal = palloc(sizeof(bool) * (seq->count - 1));
+  double *lengths = palloc(sizeof(double) * (seq->count - 1));
+  tpointseq_segments(seq, equal, lengths, NULL);
+  TSequence *result = tpointseq_cumulative_length1(seq, lengths, prevlength);
+  pfree(equal); pfree(lengths);
   return result;
 }
 
@@ -2217,8 +2605,6 @@ tpoint_cumulative_length(PG_FUNCTION_ARGS)
   Temporal *temp = PG_GETARG_TEMPORAL(0);
   Temporal *result;
   ensure_valid_duration(temp->duration);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   if (temp->duration == INSTANT)
     result = (Temporal *)tpointinst_cumulative_length((TInstant *)temp);
   else if (temp->duration == INSTANTSET)
@@ -2232,64 +2618,376 @@ tpoint_cumulative_length(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************
- * Speed functions
+ * Linear referencing functions
  *****************************************************************************/
 
 /**
- * Returns the speed of the temporal point in the temporal sequence point
+ * Structure to cache in the fn_extra field the cumulative lengths of the
+ * last temporal point given to a linear referencing function. The instants
+ * of all the sequences are flattened in a single array, the instants
+ * pointing to the copy of the temporal point kept in the cache. Since the
+ * cumulative length does not increase between two consecutive sequences,
+ * the searches below never end in the gap between them.
  */
-static TSequence *
-tpointseq_speed(const TSequence *seq)
+typedef struct
 {
-  /* Instantaneous sequence */
-  if (seq->count == 1)
-    return NULL;
+  Temporal *temp;          /**< temporal point */
+  int count;               /**< number of instants */
+  bool linear;             /**< true when the interpolation is linear */
+  const TInstant **instants; /**< instants of the temporal point */
+  double *cumul;           /**< cumulative length at each instant */
+} DistanceCache;
 
-  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  /* Stepwise interpolation */
-  if (! MOBDB_FLAGS_GET_LINEAR(seq->flags))
+/**
+ * Fills the instants and the cumulative lengths of the temporal sequence
+ * point starting at the position given
+ */
+static double
+tpointseq_distance_cache(const TSequence *seq, const TInstant **instants,
+  double *cumul, double prevlength)
+{
+  double *lengths = NULL;
+  bool *equal = NULL;
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  if (linear && seq->count > 1)
   {
-    Datum length = Float8GetDatum(0.0);
-    for (int i = 0; i < seq->count; i++)
+    equal = palloc(sizeof(bool) * (seq->count - 1));
+    lengths = palloc(sizeof(double) * (seq->count - 1));
+    tpointseq_segments(seq, equal, lengths, NULL);
+  }
+  for (int i = 0; i < seq->count; i++)
+  {
+    if (i > 0 && lengths != NULL)
+      prevlength += lengths[i - 1];
+    instants[i] = tsequence_inst_n(seq, i);
+    cumul[i] = prevlength;
+  }
+  if (lengths != NULL)
+  {
+    pfree(equal); pfree(lengths);
+  }
+  return prevlength;
+}
+
+/**
+ * Returns the cache of the cumulative lengths of the temporal point, which
+ * is computed only when the function is called with a value different from
+ * the one of the previous call
+ */
+static DistanceCache *
+tpoint_distance_cache(FunctionCallInfo fcinfo, const Temporal *temp)
+{
+  DistanceCache *cache = (DistanceCache *) fcinfo->flinfo->fn_extra;
+  if (cache != NULL && VARSIZE(cache->temp) == VARSIZE(temp) &&
+    memcmp(cache->temp, temp, VARSIZE(temp)) == 0)
+    return cache;
+
+  /* Compute the cache in the memory context of the function call */
+  MemoryContext oldcontext = MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+  if (cache == NULL)
+  {
+    cache = palloc(sizeof(DistanceCache));
+    fcinfo->flinfo->fn_extra = cache;
+  }
+  else
+  {
+    pfree(cache->temp); pfree(cache->instants); pfree(cache->cumul);
+  }
+  ensure_valid_duration(temp->duration);
+  Temporal *copy = temporal_copy(temp);
+  int count;
+  if (copy->duration == INSTANT)
+    count = 1;
+  else if (copy->duration == INSTANTSET)
+    count = ((TInstantSet *) copy)->count;
+  else if (copy->duration == SEQUENCE)
+    count = ((TSequence *) copy)->count;
+  else /* copy->duration == SEQUENCESET */
+    count = ((TSequenceSet *) copy)->totalcount;
+  cache->temp = copy;
+  cache->count = count;
+  cache->linear = MOBDB_FLAGS_GET_LINEAR(copy->flags);
+  cache->instants = palloc(sizeof(TInstant *) * count);
+  cache->cumul = palloc(sizeof(double) * count);
+  if (copy->duration == INSTANT)
+  {
+    cache->instants[0] = (TInstant *) copy;
+    cache->cumul[0] = 0;
+  }
+  else if (copy->duration == INSTANTSET)
+  {
+    TInstantSet *ti = (TInstantSet *) copy;
+    for (int i = 0; i < count; i++)
     {
-      TInstant *inst = tsequence_inst_n(seq, i);
-      instants[i] = tinstant_make(length, inst->t, FLOAT8OID);
+      cache->instants[i] = tinstantset_inst_n(ti, i);
+      cache->cumul[i] = 0;
     }
   }
-  else
-  /* Linear interpolation */
+  else if (copy->duration == SEQUENCE)
+    tpointseq_distance_cache((TSequence *) copy, cache->instants,
+      cache->cumul, 0);
+  else /* copy->duration == SEQUENCESET */
   {
-    Datum (*func)(Datum, Datum);
-    if (MOBDB_FLAGS_GET_GEODETIC(seq->flags))
-      func = &geog_distance;
-    else
-      func = MOBDB_FLAGS_GET_Z(seq->flags) ?
-        &pt_distance3d : &pt_distance2d;
-
-    TInstant *inst1 = tsequence_inst_n(seq, 0);
-    Datum value1 = tinstant_value(inst1);
-    double speed;
-    for (int i = 0; i < seq->count - 1; i++)
+    TSequenceSet *ts = (TSequenceSet *) copy;
+    double length = 0;
+    int k = 0;
+    for (int i = 0; i < ts->count; i++)
     {
-      TInstant *inst2 = tsequence_inst_n(seq, i + 1);
-      Datum value2 = tinstant_value(inst2);
-      speed = datum_point_eq(value1, value2) ? 0 :
-        DatumGetFloat8(func(value1, value2)) /
-          ((double)(inst2->t - inst1->t) / 1000000);
-      instants[i] = tinstant_make(Float8GetDatum(speed), inst1->t,
-        FLOAT8OID);
-      inst1 = inst2;
-      value1 = value2;
+      TSequence *seq = tsequenceset_seq_n(ts, i);
+      length = tpointseq_distance_cache(seq, &cache->instants[k],
+        &cache->cumul[k], length);
+      k += seq->count;
     }
-    instants[seq->count - 1] = tinstant_make(Float8GetDatum(speed),
-      seq->period.upper, FLOAT8OID);
   }
+  MemoryContextSwitchTo(oldcontext);
+  return cache;
+}
+
+/**
+ * Returns the position in the cache of the first instant whose cumulative
+ * length is greater than or equal to the distance, or the number of
+ * instants if there is none
+ */
+static int
+distance_cache_first(const DistanceCache *cache, double d)
+{
+  int first = 0, last = cache->count;
+  while (first < last)
+  {
+    int middle = (first + last) / 2;
+    if (cache->cumul[middle] < d)
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  return first;
+}
+
+/**
+ * Returns the position in the cache of the last instant whose cumulative
+ * length is less than or equal to the distance, or -1 if there is none
+ */
+static int
+distance_cache_last(const DistanceCache *cache, double d)
+{
+  int first = 0, last = cache->count;
+  while (first < last)
+  {
+    int middle = (first + last) / 2;
+    if (cache->cumul[middle] <= d)
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  return first - 1;
+}
+
+/**
+ * Returns the timestamp at which the temporal point reaches the distance
+ * between the instants n - 1 and n of the cache, assuming a constant speed
+ * in the segment
+ */
+static TimestampTz
+distance_cache_timestamp(const DistanceCache *cache, int n, double d)
+{
+  const TInstant *inst1 = cache->instants[n - 1];
+  const TInstant *inst2 = cache->instants[n];
+  double ratio = (d - cache->cumul[n - 1]) /
+    (cache->cumul[n] - cache->cumul[n - 1]);
+  return inst1->t + (TimestampTz) ((double) (inst2->t - inst1->t) * ratio);
+}
+
+/**
+ * Returns the first timestamp at which the temporal point has traversed the
+ * distance, in *t, and the position of the segment of the cache containing
+ * it, in *n. Returns false if the distance is not traversed.
+ */
+static bool
+distance_cache_first_timestamp(const DistanceCache *cache, double d,
+  TimestampTz *t, int *n)
+{
+  if (d < 0)
+    return false;
+  int pos = distance_cache_first(cache, d);
+  if (pos == cache->count)
+    return false;
+  /* The cumulative length only increases inside a linear segment */
+  *n = pos;
+  *t = (pos == 0 || cache->cumul[pos] == d) ? cache->instants[pos]->t :
+    distance_cache_timestamp(cache, pos, d);
+  return true;
+}
+
+/**
+ * Returns the last timestamp at which the temporal point has traversed the
+ * distance, or false if the distance is not traversed
+ */
+static bool
+distance_cache_last_timestamp(const DistanceCache *cache, double d,
+  TimestampTz *t)
+{
+  if (d > cache->cumul[cache->count - 1])
+    return false;
+  int pos = distance_cache_last(cache, d);
+  if (pos < 0)
+    return false;
+  *t = (pos == cache->count - 1 || cache->cumul[pos] == d) ?
+    cache->instants[pos]->t : distance_cache_timestamp(cache, pos + 1, d);
+  return true;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_time_at_distance);
+/**
+ * Returns the first timestamp at which the temporal point has traversed the
+ * distance
+ *
+ * @note The cumulative lengths of the temporal point are cached in the
+ * fn_extra field so that the function is answered by a binary search when
+ * it is called repeatedly with the same value in a query
+ */
+PGDLLEXPORT Datum
+tpoint_time_at_distance(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  double d = PG_GETARG_FLOAT8(1);
+  DistanceCache *cache = tpoint_distance_cache(fcinfo, temp);
+  TimestampTz t;
+  int n;
+  bool found = distance_cache_first_timestamp(cache, d, &t, &n);
+  PG_FREE_IF_COPY(temp, 0);
+  if (! found)
+    PG_RETURN_NULL();
+  PG_RETURN_TIMESTAMPTZ(t);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_at_distance);
+/**
+ * Returns the position of the temporal point when it has traversed the
+ * distance
+ */
+PGDLLEXPORT Datum
+tpoint_at_distance(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  double d = PG_GETARG_FLOAT8(1);
+  DistanceCache *cache = tpoint_distance_cache(fcinfo, temp);
+  TimestampTz t;
+  int n;
+  bool found = distance_cache_first_timestamp(cache, d, &t, &n);
+  PG_FREE_IF_COPY(temp, 0);
+  if (! found)
+    PG_RETURN_NULL();
+  Datum result = (t == cache->instants[n]->t) ?
+    tinstant_value_copy(cache->instants[n]) :
+    tsequence_value_at_timestamp1(cache->instants[n - 1],
+      cache->instants[n], cache->linear, t);
+  PG_RETURN_DATUM(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_substring_by_distance);
+/**
+ * Restricts the temporal point to the period in which the distance it has
+ * traversed is between the two distances
+ */
+PGDLLEXPORT Datum
+tpoint_substring_by_distance(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  double d1 = PG_GETARG_FLOAT8(1);
+  double d2 = PG_GETARG_FLOAT8(2);
+  if (d1 > d2)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The first distance cannot be greater than the second one")));
+  DistanceCache *cache = tpoint_distance_cache(fcinfo, temp);
+  TimestampTz t1, t2;
+  int n;
+  /* The distances are clipped to the length traversed by the point */
+  if (d2 < 0 || ! distance_cache_first_timestamp(cache, Max(d1, 0), &t1, &n))
+  {
+    PG_FREE_IF_COPY(temp, 0);
+    PG_RETURN_NULL();
+  }
+  if (! distance_cache_last_timestamp(cache, d2, &t2))
+    t2 = cache->instants[cache->count - 1]->t;
+  Period p;
+  period_set(&p, t1, t2, true, true);
+  Temporal *result = temporal_at_period_internal(temp, &p);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
+  if (result == NULL)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Speed functions
+ *****************************************************************************/
+
+/**
+ * Computes the speeds of the segments of the temporal sequence point from
+ * their lengths
+ *
+ * @param[in] seq Temporal sequence point with at least two instants
+ * @param[in] equal True for the segments whose points are equal
+ * @param[in] lengths Lengths of the segments
+ * @param[out] speeds Speeds of the segments
+ */
+static void
+tpointseq_segment_speeds(const TSequence *seq, const bool *equal,
+  const double *lengths, double *speeds)
+{
+  TInstant *inst1 = tsequence_inst_n(seq, 0);
+  for (int i = 0; i < seq->count - 1; i++)
+  {
+    TInstant *inst2 = tsequence_inst_n(seq, i + 1);
+    speeds[i] = equal[i] ? 0 :
+      lengths[i] / ((double)(inst2->t - inst1->t) / 1000000);
+    inst1 = inst2;
+  }
+}
+
+/**
+ * Returns the speed of the temporal sequence point from the speeds of its
+ * segments, which are zero for stepwise interpolation
+ *
+ * @param[in] seq Temporal sequence point with at least two instants
+ * @param[in] speeds Speeds of the segments
+ */
+static TSequence *
+tpointseq_speed1(const TSequence *seq, const double *speeds)
+{
+  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  for (int i = 0; i < seq->count - 1; i++)
+    instants[i] = tinstant_make(Float8GetDatum(speeds[i]),
+      tsequence_inst_n(seq, i)->t, FLOAT8OID);
+  instants[seq->count - 1] = tinstant_make(
+    Float8GetDatum(speeds[seq->count - 2]), seq->period.upper, FLOAT8OID);
   /* The resulting sequence has step interpolation */
-  TSequence *result = tsequence_make(instants, seq->count,
+  return tsequence_make_free(instants, seq->count,
     seq->period.lower_inc, seq->period.upper_inc, STEP, NORMALIZE);
-  for (int i = 0; i < seq->count - 1; i++)
-    pfree(instants[i]);
-  pfree(instants);
+}
+
+/**
+ * Returns the speed of the temporal point in the temporal sequence point
+ */
+static TSequence *
+tpointseq_speed(const TSequence *seq)
+{
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+    return NULL;
+
+  double *speeds = palloc0(sizeof(double) * (seq->count - 1));
+  /* The speed is zero for stepwise interpolation */
+  if (MOBDB_FLAGS_GET_LINEAR(seq->flags))
+  {
+    bool *equal = palloc(sizeof(bool) * (seq->count - 1));
+    double *lengths = palloc(sizeof(double) * (seq->count - 1));
+    tpointseq_segments(seq, equal, lengths, NULL);
+    tpointseq_segment_speeds(seq, equal, lengths, speeds);
+    pfree(equal); pfree(lengths);
+  }
+  TSequence *result = tpointseq_speed1(seq, speeds);
+  pfree(speeds);
   return result;
 }
 
@@ -2320,8 +3018,6 @@ tpoint_speed(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
   Temporal *result = NULL;
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT || temp->duration == INSTANTSET)
     ;
@@ -2336,217 +3032,243 @@ tpoint_speed(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************
- * Time-weighed centroid for temporal geometry points
+ * Time-weighed centroid for temporal points
+ *
+ * The centroid is computed in a single pass over the coordinates of the
+ * instants, the integrals of the coordinates over time being accumulated
+ * with compensated summation. Geographic points are averaged as geocentric
+ * unit vectors and the mean vector is projected back on the sphere.
  *****************************************************************************/
 
 /**
- * Returns the time-weighed centroid of the temporal geometry point of
- * instant set duration
+ * Structure to accumulate the coordinates of the time-weighed centroid.
+ * The coordinates are x, y, and z for geometric points and the geocentric
+ * x, y, and z followed by the height for geographic points.
  */
-Datum
-tgeompointi_twcentroid(const TInstantSet *ti)
+typedef struct
 {
-  int srid = tpointinstset_srid(ti);
-  TInstant **instantsx = palloc(sizeof(TInstant *) * ti->count);
-  TInstant **instantsy = palloc(sizeof(TInstant *) * ti->count);
-  TInstant **instantsz = NULL; /* keep compiler quiet */
-  bool hasz = MOBDB_FLAGS_GET_Z(ti->flags);
-  if (hasz)
-    instantsz = palloc(sizeof(TInstant *) * ti->count);
+  double sum[4];       /**< Integrals of the coordinates over time */
+  double comp[4];      /**< Compensations of the integrals */
+  double sumi[4];      /**< Sums of the coordinates of the instants */
+  double compi[4];     /**< Compensations of the sums */
+  double duration;     /**< Duration of the segments */
+  int count;           /**< Number of instants */
+  bool hasz;
+  bool geodetic;
+} TWCentroidState;
 
-  for (int i = 0; i < ti->count; i++)
+/**
+ * Add the weighted coordinates to the sums using the compensated summation
+ * of Neumaier
+ */
+static void
+twcentroid_sum(double *sum, double *comp, const double *coords,
+  double weight)
+{
+  for (int i = 0; i < 4; i++)
   {
-    TInstant *inst = tinstantset_inst_n(ti, i);
-    POINT4D point = datum_get_point4d(tinstant_value(inst));
-    instantsx[i] = tinstant_make(Float8GetDatum(point.x), inst->t,
-      FLOAT8OID);
-    instantsy[i] = tinstant_make(Float8GetDatum(point.y), inst->t,
-      FLOAT8OID);
-    if (hasz)
-      instantsz[i] = tinstant_make(Float8GetDatum(point.z), inst->t,
-        FLOAT8OID);
+    double value = coords[i] * weight;
+    double t = sum[i] + value;
+    if (fabs(sum[i]) >= fabs(value))
+      comp[i] += (sum[i] - t) + value;
+    else
+      comp[i] += (value - t) + sum[i];
+    sum[i] = t;
   }
-  TInstantSet *tix = tinstantset_make_free(instantsx, ti->count);
-  TInstantSet *tiy = tinstantset_make_free(instantsy, ti->count);
-  TInstantSet *tiz = NULL; /* keep compiler quiet */
-  if (hasz)
-    tiz = tinstantset_make_free(instantsz, ti->count);
-  double avgx = tnumberinstset_twavg(tix);
-  double avgy = tnumberinstset_twavg(tiy);
-  double avgz;
-  if (hasz)
-    avgz = tnumberinstset_twavg(tiz);
-  LWPOINT *lwpoint;
-  if (hasz)
-    lwpoint = lwpoint_make3dz(srid, avgx, avgy, avgz);
-  else
-    lwpoint = lwpoint_make2d(srid, avgx, avgy);
-  Datum result = PointerGetDatum(geo_serialize((LWGEOM *)lwpoint));
-
-  pfree(lwpoint);
-  pfree(tix); pfree(tiy);
-  if (hasz)
-    pfree(tiz);
-
-  return result;
-}
+  return;
+}
 
 /**
- * Returns the time-weighed centroid of the temporal geometry point of
- * sequence duration
+ * Set the coordinates to accumulate for the instant
  */
-Datum
-tgeompointseq_twcentroid(const TSequence *seq)
+static void
+twcentroid_coords(const TWCentroidState *state, const TInstant *inst,
+  double *coords)
 {
-  int srid = tpointseq_srid(seq);
-  TInstant **instantsx = palloc(sizeof(TInstant *) * seq->count);
-  TInstant **instantsy = palloc(sizeof(TInstant *) * seq->count);
-  TInstant **instantsz;
-  bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
-  if (hasz)
-    instantsz = palloc(sizeof(TInstant *) * seq->count);
-
-  for (int i = 0; i < seq->count; i++)
+  Datum value = tinstant_value(inst);
+  if (state->geodetic)
   {
-    TInstant *inst = tsequence_inst_n(seq, i);
-    POINT4D point = datum_get_point4d(tinstant_value(inst));
-    instantsx[i] = tinstant_make(Float8GetDatum(point.x), inst->t,
-      FLOAT8OID);
-    instantsy[i] = tinstant_make(Float8GetDatum(point.y), inst->t,
-      FLOAT8OID);
-    if (hasz)
-      instantsz[i] = tinstant_make(Float8GetDatum(point.z), inst->t,
-        FLOAT8OID);
-  }
-  TSequence *seqx = tsequence_make_free(instantsx, seq->count,
-    seq->period.lower_inc, seq->period.upper_inc,
-    MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
-  TSequence *seqy = tsequence_make_free(instantsy, seq->count,
-    seq->period.lower_inc, seq->period.upper_inc,
-    MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
-  TSequence *seqz;
-  if (hasz)
-    seqz = tsequence_make_free(instantsz, seq->count, seq->period.lower_inc,
-      seq->period.upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
-  double twavgx = tnumberseq_twavg(seqx);
-  double twavgy = tnumberseq_twavg(seqy);
-  LWPOINT *lwpoint;
-  if (hasz)
+    const POINT2D *point = datum_get_point2d_p(value);
+    GEOGRAPHIC_POINT gpoint;
+    POINT3D p;
+    geographic_point_init(point->x, point->y, &gpoint);
+    geog2cart(&gpoint, &p);
+    coords[0] = p.x;
+    coords[1] = p.y;
+    coords[2] = p.z;
+    coords[3] = state->hasz ? datum_get_point3dz_p(value)->z : 0;
+  }
+  else if (state->hasz)
   {
-    double twavgz = tnumberseq_twavg(seqz);
-    lwpoint = lwpoint_make3dz(srid, twavgx, twavgy, twavgz);
+    const POINT3DZ *point = datum_get_point3dz_p(value);
+    coords[0] = point->x;
+    coords[1] = point->y;
+    coords[2] = point->z;
+    coords[3] = 0;
   }
   else
-    lwpoint = lwpoint_make2d(srid, twavgx, twavgy);
-  Datum result = PointerGetDatum(geo_serialize((LWGEOM *)lwpoint));
+  {
+    const POINT2D *point = datum_get_point2d_p(value);
+    coords[0] = point->x;
+    coords[1] = point->y;
+    coords[2] = coords[3] = 0;
+  }
+  return;
+}
 
-  pfree(lwpoint);  pfree(seqx); pfree(seqy);
-  if (hasz)
-    pfree(seqz);
+/**
+ * Returns the factor by which the mean of the geocentric unit vectors at the
+ * ends of a great circle arc must be scaled to obtain the mean of the unit
+ * vectors along the arc traversed at constant speed, that is,
+ * tan(theta/2) / (theta/2) where theta is the angle of the arc
+ */
+static double
+twcentroid_arc_factor(const double *v1, const double *v2)
+{
+  double cx = v1[1] * v2[2] - v1[2] * v2[1];
+  double cy = v1[2] * v2[0] - v1[0] * v2[2];
+  double cz = v1[0] * v2[1] - v1[1] * v2[0];
+  double dot = v1[0] * v2[0] + v1[1] * v2[1] + v1[2] * v2[2];
+  double half = atan2(sqrt(cx * cx + cy * cy + cz * cz), dot) / 2.0;
+  /* The arc between antipodal points is not defined and the mean of their
+   * vectors is null whatever the factor */
+  if (half < 1e-8 || half > M_PI_2 - 1e-8)
+    return 1.0;
+  return tan(half) / half;
+}
 
-  return result;
+/**
+ * Accumulate the instant in the state
+ */
+static void
+tpointinst_twcentroid_add(TWCentroidState *state, const TInstant *inst)
+{
+  double coords[4];
+  twcentroid_coords(state, inst, coords);
+  twcentroid_sum(state->sumi, state->compi, coords, 1.0);
+  state->count++;
+  return;
 }
 
 /**
- * Returns the time-weighed centroid of the temporal geometry point of
- * sequence set duration
+ * Accumulate the segments of the temporal sequence point in the state
  */
-Datum
-tgeompoints_twcentroid(const TSequenceSet *ts)
+static void
+tpointseq_twcentroid_add(TWCentroidState *state, const TSequence *seq)
 {
-  int srid = tpointseqset_srid(ts);
-  TSequence **sequencesx = palloc(sizeof(TSequence *) * ts->count);
-  TSequence **sequencesy = palloc(sizeof(TSequence *) * ts->count);
-  TSequence **sequencesz = NULL; /* keep compiler quiet */
-  bool hasz = MOBDB_FLAGS_GET_Z(ts->flags);
-  if (hasz)
-    sequencesz = palloc(sizeof(TSequence *) * ts->count);
-  for (int i = 0; i < ts->count; i++)
+  TInstant *inst1 = tsequence_inst_n(seq, 0);
+  if (seq->count == 1)
   {
-    TSequence *seq = tsequenceset_seq_n(ts, i);
-    TInstant **instantsx = palloc(sizeof(TInstant *) * seq->count);
-    TInstant **instantsy = palloc(sizeof(TInstant *) * seq->count);
-    TInstant **instantsz;
-    if (hasz)
-      instantsz = palloc(sizeof(TInstant *) * seq->count);
-    for (int j = 0; j < seq->count; j++)
-    {
-      TInstant *inst = tsequence_inst_n(seq, j);
-      POINT4D point = datum_get_point4d(tinstant_value(inst));
-      instantsx[j] = tinstant_make(Float8GetDatum(point.x),
-        inst->t, FLOAT8OID);
-      instantsy[j] = tinstant_make(Float8GetDatum(point.y),
-        inst->t, FLOAT8OID);
-      if (hasz)
-        instantsz[j] = tinstant_make(Float8GetDatum(point.z),
-          inst->t, FLOAT8OID);
-    }
-    sequencesx[i] = tsequence_make_free(instantsx, seq->count,
-      seq->period.lower_inc, seq->period.upper_inc,
-      MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
-    sequencesy[i] = tsequence_make_free(instantsy,
-      seq->count, seq->period.lower_inc, seq->period.upper_inc,
-      MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
-    if (hasz)
-      sequencesz[i] = tsequence_make_free(instantsz, seq->count,
-        seq->period.lower_inc, seq->period.upper_inc,
-        MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
+    tpointinst_twcentroid_add(state, inst1);
+    return;
   }
-  TSequenceSet *tsx = tsequenceset_make_free(sequencesx, ts->count, NORMALIZE);
-  TSequenceSet *tsy = tsequenceset_make_free(sequencesy, ts->count, NORMALIZE);
-  TSequenceSet *tsz = NULL; /* keep compiler quiet */
-  if (hasz)
-    tsz = tsequenceset_make_free(sequencesz, ts->count, NORMALIZE);
-
-  double twavgx = tnumberseqset_twavg(tsx);
-  double twavgy = tnumberseqset_twavg(tsy);
-  LWPOINT *lwpoint;
-  if (hasz)
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  double coords1[4], coords2[4], mean[4];
+  twcentroid_coords(state, inst1, coords1);
+  for (int i = 1; i < seq->count; i++)
   {
-    double twavgz = tnumberseqset_twavg(tsz);
-    lwpoint = lwpoint_make3dz(srid, twavgx, twavgy, twavgz);
+    TInstant *inst2 = tsequence_inst_n(seq, i);
+    twcentroid_coords(state, inst2, coords2);
+    double duration = (double) (inst2->t - inst1->t);
+    if (linear)
+    {
+      double factor = state->geodetic ?
+        twcentroid_arc_factor(coords1, coords2) : 1.0;
+      for (int j = 0; j < 3; j++)
+        mean[j] = (coords1[j] + coords2[j]) / 2.0 * factor;
+      mean[3] = (coords1[3] + coords2[3]) / 2.0;
+      twcentroid_sum(state->sum, state->comp, mean, duration);
+    }
+    else
+      twcentroid_sum(state->sum, state->comp, coords1, duration);
+    state->duration += duration;
+    memcpy(coords1, coords2, sizeof(coords1));
+    inst1 = inst2;
   }
-  else
-    lwpoint = lwpoint_make2d(srid, twavgx, twavgy);
-  Datum result = PointerGetDatum(geo_serialize((LWGEOM *)lwpoint));
-
-  pfree(lwpoint);
-  pfree(tsx); pfree(tsy);
-  if (hasz)
-    pfree(tsz);
-
-  return result;
+  return;
 }
 
 /**
- * Returns the time-weighed centroid of the temporal geometry point
+ * Returns the time-weighed centroid of the temporal point
  * (dispatch function)
+ *
+ * @note As for the time-weighted average of temporal numbers, the instants
+ * are only taken into account when the temporal point has no duration, in
+ * which case the centroid is the mean of the instants
  */
 Datum
-tgeompoint_twcentroid_internal(Temporal *temp)
+tpoint_twcentroid_internal(Temporal *temp)
 {
-  Datum result;
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT)
-    result = tinstant_value_copy((TInstant *)temp);
-  else if (temp->duration == INSTANTSET)
-    result = tgeompointi_twcentroid((TInstantSet *)temp);
+    return tinstant_value_copy((TInstant *)temp);
+
+  TWCentroidState state;
+  memset(&state, 0, sizeof(TWCentroidState));
+  state.hasz = MOBDB_FLAGS_GET_Z(temp->flags);
+  state.geodetic = MOBDB_FLAGS_GET_GEODETIC(temp->flags);
+  if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (TInstantSet *)temp;
+    for (int i = 0; i < ti->count; i++)
+      tpointinst_twcentroid_add(&state, tinstantset_inst_n(ti, i));
+  }
   else if (temp->duration == SEQUENCE)
-    result = tgeompointseq_twcentroid((TSequence *)temp);
+    tpointseq_twcentroid_add(&state, (TSequence *)temp);
   else /* temp->duration == SEQUENCESET */
-    result = tgeompoints_twcentroid((TSequenceSet *)temp);
+  {
+    const TSequenceSet *ts = (TSequenceSet *)temp;
+    for (int i = 0; i < ts->count; i++)
+      tpointseq_twcentroid_add(&state, tsequenceset_seq_n(ts, i));
+  }
+
+  double coords[4];
+  for (int i = 0; i < 4; i++)
+    coords[i] = (state.duration > 0) ?
+      (state.sum[i] + state.comp[i]) / state.duration :
+      (state.sumi[i] + state.compi[i]) / state.count;
+  int srid = tpoint_srid_internal(temp);
+  LWPOINT *lwpoint;
+  if (state.geodetic)
+  {
+    POINT3D p;
+    GEOGRAPHIC_POINT gpoint;
+    p.x = coords[0];
+    p.y = coords[1];
+    p.z = coords[2];
+    /* The mean is not defined when the vectors cancel each other */
+    if (sqrt(p.x * p.x + p.y * p.y + p.z * p.z) < EPSILON)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The time-weighed centroid of the temporal point is undefined")));
+    /* The norm of the mean of the geocentric vectors is irrelevant */
+    normalize(&p);
+    cart2geog(&p, &gpoint);
+    if (state.hasz)
+      lwpoint = lwpoint_make3dz(srid, rad2deg(gpoint.lon),
+        rad2deg(gpoint.lat), coords[3]);
+    else
+      lwpoint = lwpoint_make2d(srid, rad2deg(gpoint.lon),
+        rad2deg(gpoint.lat));
+    FLAGS_SET_GEODETIC(lwpoint->flags, true);
+  }
+  else if (state.hasz)
+    lwpoint = lwpoint_make3dz(srid, coords[0], coords[1], coords[2]);
+  else
+    lwpoint = lwpoint_make2d(srid, coords[0], coords[1]);
+  Datum result = PointerGetDatum(geo_serialize((LWGEOM *)lwpoint));
+  lwpoint_free(lwpoint);
   return result;
 }
 
-PG_FUNCTION_INFO_V1(tgeompoint_twcentroid);
+PG_FUNCTION_INFO_V1(tpoint_twcentroid);
 /**
- * Returns the time-weighed centroid of the temporal geometry point
+ * Returns the time-weighed centroid of the temporal point
  */
 PGDLLEXPORT Datum
-tgeompoint_twcentroid(PG_FUNCTION_ARGS)
+tpoint_twcentroid(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
-  Datum result = tgeompoint_twcentroid_internal(temp);
+  Datum result = tpoint_twcentroid_internal(temp);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_DATUM(result);
 }
@@ -2555,63 +3277,32 @@ tgeompoint_twcentroid(PG_FUNCTION_ARGS)
  * Temporal azimuth
  *****************************************************************************/
 
-/**
- * Returns the azimuth of the two geometry points
- */
-static Datum
-geom_azimuth(Datum geom1, Datum geom2)
-{
-  const POINT2D *p1 = datum_get_point2d_p(geom1);
-  const POINT2D *p2 = datum_get_point2d_p(geom2);
-  double result;
-  azimuth_pt_pt(p1, p2, &result);
-  return Float8GetDatum(result);
-}
-
-/**
- * Returns the azimuth the two geography points
- */
-static Datum
-geog_azimuth(Datum geom1, Datum geom2)
-{
-  return CallerFInfoFunctionCall2(geography_azimuth, (fetch_fcinfo())->flinfo,
-    InvalidOid, geom1, geom2);
-}
-
 /**
  * Returns the temporal azimuth of the temporal geometry point of
- * sequence duration
+ * sequence duration from the azimuths of its segments
  *
  * @param[out] result Array on which the pointers of the newly constructed
  * sequences are stored
- * @param[in] seq Temporal value
+ * @param[in] seq Temporal value with at least two instants
+ * @param[in] equal True for the segments whose points are equal
+ * @param[in] azimuths Azimuths of the segments whose points are different
  */
 static int
-tpointseq_azimuth1(TSequence **result, const TSequence *seq)
+tpointseq_azimuth2(TSequence **result, const TSequence *seq,
+  const bool *equal, const double *azimuths)
 {
-  /* Instantaneous sequence */
-  if (seq->count == 1)
-    return 0;
-
-  /* Determine the PostGIS function to call */
-  Datum (*func)(Datum, Datum) = MOBDB_FLAGS_GET_GEODETIC(seq->flags) ?
-    &geog_azimuth : &geom_azimuth;
-
-  /* We are sure that there are at least 2 instants */
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   TInstant *inst1 = tsequence_inst_n(seq, 0);
-  Datum value1 = tinstant_value(inst1);
   int k = 0, l = 0;
   Datum azimuth = 0; /* Make the compiler quiet */
   bool lower_inc = seq->period.lower_inc, upper_inc;
   for (int i = 1; i < seq->count; i++)
   {
     TInstant *inst2 = tsequence_inst_n(seq, i);
-    Datum value2 = tinstant_value(inst2);
     upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-    if (datum_ne(value1, value2, seq->valuetypid))
+    if (! equal[i - 1])
     {
-      azimuth = func(value1, value2);
+      azimuth = Float8GetDatum(azimuths[i - 1]);
       instants[k++] = tinstant_make(azimuth, inst1->t, FLOAT8OID);
     }
     else
@@ -2630,7 +3321,6 @@ tpointseq_azimuth1(TSequence **result, const TSequence *seq)
       lower_inc = true;
     }
     inst1 = inst2;
-    value1 = value2;
   }
   if (k != 0)
   {
@@ -2645,6 +3335,30 @@ tpointseq_azimuth1(TSequence **result, const TSequence *seq)
   return l;
 }
 
+/**
+ * Returns the temporal azimuth of the temporal geometry point of
+ * sequence duration
+ *
+ * @param[out] result Array on which the pointers of the newly constructed
+ * sequences are stored
+ * @param[in] seq Temporal value
+ */
+static int
+tpointseq_azimuth1(TSequence **result, const TSequence *seq)
+{
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+    return 0;
+
+  /* We are sure that there are at least 2 instants */
+  bool *equal = palloc(sizeof(bool) * (seq->count - 1));
+  double *azimuths = palloc(sizeof(double) * (seq->count - 1));
+  tpointseq_segments(seq, equal, NULL, azimuths);
+  int count = tpointseq_azimuth2(result, seq, equal, azimuths);
+  pfree(equal); pfree(azimuths);
+  return count;
+}
+
 /**
  * Returns the temporal azimuth of the temporal geometry point
  * of sequence duration
@@ -2687,8 +3401,6 @@ PGDLLEXPORT Datum
 tpoint_azimuth(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   Temporal *result = NULL;
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT || temp->duration == INSTANTSET ||
@@ -2705,6 +3417,211 @@ tpoint_azimuth(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Kinematics
+ *****************************************************************************/
+
+/**
+ * Structure to keep the results of the kinematics of a temporal point
+ */
+typedef struct
+{
+  double length;         /**< Length traversed */
+  Temporal *cumul;       /**< Cumulative length */
+  Temporal *speed;       /**< Speed, may be NULL */
+  Temporal *azimuth;     /**< Azimuth, may be NULL */
+  Temporal *accel;       /**< Acceleration, may be NULL */
+} Kinematics;
+
+/**
+ * Returns the acceleration of the temporal sequence point from the speeds of
+ * its segments. The acceleration between two consecutive segments is the
+ * difference of their speeds divided by the time between their midpoints,
+ * and it is kept from the start of the second segment until the start of
+ * the next one.
+ *
+ * @param[in] seq Temporal sequence point with at least three instants
+ * @param[in] speeds Speeds of the segments
+ */
+static TSequence *
+tpointseq_acceleration1(const TSequence *seq, const double *speeds)
+{
+  TInstant **instants = palloc(sizeof(TInstant *) * (seq->count - 1));
+  double accel;
+  for (int i = 1; i < seq->count - 1; i++)
+  {
+    TimestampTz t1 = tsequence_inst_n(seq, i - 1)->t;
+    TimestampTz t2 = tsequence_inst_n(seq, i + 1)->t;
+    accel = (speeds[i] - speeds[i - 1]) / ((double)(t2 - t1) / 2000000);
+    instants[i - 1] = tinstant_make(Float8GetDatum(accel),
+      tsequence_inst_n(seq, i)->t, FLOAT8OID);
+  }
+  instants[seq->count - 2] = tinstant_make(Float8GetDatum(accel),
+    seq->period.upper, FLOAT8OID);
+  /* The resulting sequence has step interpolation */
+  return tsequence_make_free(instants, seq->count - 1, true,
+    seq->period.upper_inc, STEP, NORMALIZE);
+}
+
+/**
+ * Computes in a single pass over the temporal sequence point the results
+ * of the kinematics
+ *
+ * @param[in] seq Temporal sequence point
+ * @param[in] prevlength Length traversed before the sequence
+ * @param[out] length Length traversed
+ * @param[out] cumul Cumulative length
+ * @param[out] speed Speed, NULL for instantaneous sequences
+ * @param[out] accel Acceleration, NULL for sequences with less than three
+ * instants
+ * @param[out] azimuths Array on which the sequences of the azimuth are stored
+ * @result Number of sequences of the azimuth
+ */
+static int
+tpointseq_kinematics1(const TSequence *seq, double prevlength,
+  double *length, TSequence **cumul, TSequence **speed, TSequence **accel,
+  TSequence **azimuths)
+{
+  *length = 0;
+  *speed = *accel = NULL;
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+  {
+    *cumul = tpointseq_cumulative_length1(seq, NULL, prevlength);
+    return 0;
+  }
+
+  bool *equal = palloc(sizeof(bool) * (seq->count - 1));
+  double *lengths = palloc0(sizeof(double) * (seq->count - 1));
+  double *speeds = palloc0(sizeof(double) * (seq->count - 1));
+  double *azs = palloc(sizeof(double) * (seq->count - 1));
+  int result = 0;
+  /* The lengths and the speeds are zero and the azimuth is undefined for
+   * stepwise interpolation */
+  if (MOBDB_FLAGS_GET_LINEAR(seq->flags))
+  {
+    tpointseq_segments(seq, equal, lengths, azs);
+    tpointseq_segment_speeds(seq, equal, lengths, speeds);
+    /* The length of geographic points is computed on the trajectory */
+    if (MOBDB_FLAGS_GET_GEODETIC(seq->flags))
+      *length = tpointseq_length(seq);
+    else
+    {
+      for (int i = 0; i < seq->count - 1; i++)
+        *length += lengths[i];
+    }
+    result = tpointseq_azimuth2(azimuths, seq, equal, azs);
+  }
+  *cumul = tpointseq_cumulative_length1(seq, lengths, prevlength);
+  *speed = tpointseq_speed1(seq, speeds);
+  if (seq->count > 2)
+    *accel = tpointseq_acceleration1(seq, speeds);
+  pfree(equal); pfree(lengths); pfree(speeds); pfree(azs);
+  return result;
+}
+
+/**
+ * Computes the kinematics of the temporal sequence point
+ */
+static void
+tpointseq_kinematics(const TSequence *seq, Kinematics *result)
+{
+  TSequence *cumul, *speed, *accel;
+  TSequence **azimuths = palloc(sizeof(TSequence *) * seq->count);
+  int count = tpointseq_kinematics1(seq, 0, &result->length, &cumul, &speed,
+    &accel, azimuths);
+  result->cumul = (Temporal *) cumul;
+  result->speed = (Temporal *) speed;
+  result->accel = (Temporal *) accel;
+  /* Resulting sequence set has step interpolation */
+  result->azimuth = (Temporal *) tsequenceset_make_free(azimuths, count,
+    NORMALIZE);
+}
+
+/**
+ * Computes the kinematics of the temporal sequence set point
+ */
+static void
+tpointseqset_kinematics(const TSequenceSet *ts, Kinematics *result)
+{
+  TSequence **cumuls = palloc(sizeof(TSequence *) * ts->count);
+  TSequence **speeds = palloc(sizeof(TSequence *) * ts->count);
+  TSequence **accels = palloc(sizeof(TSequence *) * ts->count);
+  TSequence **azimuths = palloc(sizeof(TSequence *) * ts->totalcount);
+  int nspeeds = 0, naccels = 0, nazimuths = 0;
+  double prevlength = 0;
+  result->length = 0;
+  for (int i = 0; i < ts->count; i++)
+  {
+    TSequence *seq = tsequenceset_seq_n(ts, i);
+    TSequence *speed, *accel;
+    double length;
+    nazimuths += tpointseq_kinematics1(seq, prevlength, &length, &cumuls[i],
+      &speed, &accel, &azimuths[nazimuths]);
+    result->length += length;
+    TInstant *end = tsequence_inst_n(cumuls[i], cumuls[i]->count - 1);
+    prevlength = DatumGetFloat8(tinstant_value(end));
+    if (speed != NULL)
+      speeds[nspeeds++] = speed;
+    if (accel != NULL)
+      accels[naccels++] = accel;
+  }
+  result->cumul = (Temporal *) tsequenceset_make_free(cumuls, ts->count,
+    NORMALIZE_NO);
+  /* The resulting sequence sets have step interpolation */
+  result->speed = (Temporal *) tsequenceset_make_free(speeds, nspeeds,
+    NORMALIZE);
+  result->accel = (Temporal *) tsequenceset_make_free(accels, naccels,
+    NORMALIZE);
+  result->azimuth = (Temporal *) tsequenceset_make_free(azimuths, nazimuths,
+    NORMALIZE);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_kinematics);
+/**
+ * Returns the length, the cumulative length, the speed, the azimuth, and
+ * the acceleration of the temporal point, which are computed in a single
+ * pass over its instants
+ */
+PGDLLEXPORT Datum
+tpoint_kinematics(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  TupleDesc tupdesc;
+  if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+      errmsg("function returning record called in context that cannot accept type record")));
+  tupdesc = BlessTupleDesc(tupdesc);
+
+  Kinematics kin = { .length = 0, .cumul = NULL, .speed = NULL,
+    .azimuth = NULL, .accel = NULL };
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+    kin.cumul = (Temporal *) tpointinst_cumulative_length((TInstant *) temp);
+  else if (temp->duration == INSTANTSET)
+    kin.cumul = (Temporal *) tpointinstset_cumulative_length(
+      (TInstantSet *) temp);
+  else if (temp->duration == SEQUENCE)
+    tpointseq_kinematics((TSequence *) temp, &kin);
+  else /* temp->duration == SEQUENCESET */
+    tpointseqset_kinematics((TSequenceSet *) temp, &kin);
+
+  Datum values[5];
+  bool isnull[5];
+  values[0] = Float8GetDatum(kin.length);
+  values[1] = PointerGetDatum(kin.cumul);
+  values[2] = PointerGetDatum(kin.speed);
+  values[3] = PointerGetDatum(kin.azimuth);
+  values[4] = PointerGetDatum(kin.accel);
+  isnull[0] = isnull[1] = false;
+  isnull[2] = (kin.speed == NULL);
+  isnull[3] = (kin.azimuth == NULL);
+  isnull[4] = (kin.accel == NULL);
+  HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
 /*****************************************************************************
  * Restriction functions
  * N.B. In the PostGIS version currently used by MobilityDB (2.5) there is no
@@ -2746,48 +3663,426 @@ tpointinstset_restrict_geometry(const TInstantSet *ti, Datum geom, bool atfunc)
   return result;
 }
 
+/*****************************************************************************
+ * Native clipping of segments against 2D polygons
+ *****************************************************************************/
+
 /**
- * Restricts the segment of a temporal sequence point to the geometry
+ * Relative tolerance used when clipping segments against polygons
+ */
+#define CLIP_TOLERANCE 1.0E-12
+
+/**
+ * Candidate fraction of a segment where it may enter or leave a polygon
+ */
+typedef struct
+{
+  double fraction;  /**< Fraction of the segment in [0, 1] */
+  bool boundary;    /**< True when the point is on the boundary */
+} ClipParam;
+
+/**
+ * Structure used to clip the segments of a temporal point against a
+ * polygon or a multipolygon without calling GEOS
+ */
+typedef struct
+{
+  LWGEOM *geom;         /**< Polygon or multipolygon */
+  LWPOLY **polys;       /**< Polygons composing the geometry */
+  int npolys;           /**< Number of polygons */
+  GBOX box;             /**< Bounding box of the geometry */
+  ClipParam *params;    /**< Candidate fractions of the current segment */
+  double *pieces;       /**< Pairs of fractions inside the geometry */
+} PolyClipper;
+
+/**
+ * Comparator function for candidate fractions
+ */
+static int
+clipparam_cmp(const void *a, const void *b)
+{
+  double fa = ((const ClipParam *) a)->fraction;
+  double fb = ((const ClipParam *) b)->fraction;
+  return (fa < fb) ? -1 : ((fa > fb) ? 1 : 0);
+}
+
+/**
+ * Initialize the clipper when the geometry is a 2D polygon or multipolygon
  *
- * @param[in] inst1,inst2 Instants defining the segment
- * @param[in] linear True when the segment has linear interpolation
- * @param[in] lower_inc,upper_inc State whether the bounds are inclusive
- * @param[in] geom Geometry
- * @param[out] count Number of elements in the resulting array
- * @pre The instants have the same SRID and the points and the geometry
- * are in 2D
+ * @result False when the geometry must be handled by GEOS
  */
-static TSequence **
-tpointseq_at_geometry1(const TInstant *inst1, const TInstant *inst2,
-  bool linear, bool lower_inc, bool upper_inc, Datum geom, int *count)
+static bool
+polyclipper_init(PolyClipper *clip, Datum geom)
 {
-  Datum value1 = tinstant_value(inst1);
-  Datum value2 = tinstant_value(inst2);
-  TInstant *instants[2];
+  GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(geom);
+  int type = gserialized_get_type(gs);
+  if (FLAGS_GET_Z(gs->flags) || FLAGS_GET_GEODETIC(gs->flags) ||
+    (type != POLYGONTYPE && type != MULTIPOLYGONTYPE) ||
+    gserialized_get_gbox_p(gs, &clip->box) == LW_FAILURE)
+    return false;
 
-  /* Constant segment or step interpolation */
-  bool equal = datum_point_eq(value1, value2);
-  if (equal || ! linear)
+  clip->geom = lwgeom_from_gserialized(gs);
+  if (type == POLYGONTYPE)
   {
-    if (!DatumGetBool(call_function2(intersects, value1, geom)))
-    {
-      *count = 0;
-      return NULL;
-    }
+    clip->polys = palloc(sizeof(LWPOLY *));
+    clip->polys[0] = lwgeom_as_lwpoly(clip->geom);
+    clip->npolys = 1;
+  }
+  else
+  {
+    LWCOLLECTION *coll = lwgeom_as_lwcollection(clip->geom);
+    clip->polys = palloc(sizeof(LWPOLY *) * coll->ngeoms);
+    clip->npolys = coll->ngeoms;
+    for (int i = 0; i < coll->ngeoms; i++)
+      clip->polys[i] = lwgeom_as_lwpoly(coll->geoms[i]);
+  }
+  /* Each edge contributes at most two candidate fractions */
+  int nedges = 0;
+  for (int i = 0; i < clip->npolys; i++)
+    for (uint32_t j = 0; j < clip->polys[i]->nrings; j++)
+      nedges += clip->polys[i]->rings[j]->npoints;
+  clip->params = palloc(sizeof(ClipParam) * (2 * nedges + 2));
+  clip->pieces = palloc(sizeof(double) * (4 * nedges + 4));
+  return true;
+}
 
-    instants[0] = (TInstant *) inst1;
-    instants[1] = linear ? (TInstant *) inst2 :
-      tinstant_make(value1, inst2->t, inst1->valuetypid);
-    /* Stepwise segment with inclusive upper bound must return 2 sequences */
-    bool upper_inc1 = (linear) ? upper_inc : false;
-    TSequence **result = palloc(sizeof(TSequence *) * 2);
-    result[0] = tsequence_make(instants, 2, lower_inc, upper_inc1,
-      linear, NORMALIZE_NO);
-    int k = 1;
-    if (upper_inc != upper_inc1 &&
-      DatumGetBool(call_function2(intersects, value2, geom)))
-    {
-      result[1] = tinstant_to_tsequence(inst2, linear);
+/**
+ * Free the clipper
+ */
+static void
+polyclipper_free(PolyClipper *clip)
+{
+  lwgeom_free(clip->geom);
+  pfree(clip->polys); pfree(clip->params); pfree(clip->pieces);
+  return;
+}
+
+/**
+ * Returns true if the point is on the edge defined by the two points
+ */
+static bool
+point2d_on_edge(const POINT2D *p, const POINT2D *a, const POINT2D *b)
+{
+  double ex = b->x - a->x, ey = b->y - a->y;
+  double wx = p->x - a->x, wy = p->y - a->y;
+  double len2 = ex * ex + ey * ey;
+  if (len2 == 0)
+    return (wx == 0 && wy == 0);
+  if (fabs(ex * wy - ey * wx) > CLIP_TOLERANCE * len2)
+    return false;
+  double dot = ex * wx + ey * wy;
+  return (dot >= - CLIP_TOLERANCE * len2 && dot <= len2 * (1 + CLIP_TOLERANCE));
+}
+
+/**
+ * Locates the point with respect to the ring
+ *
+ * @result 1 when the point is inside, 0 when it is on the boundary, and
+ * -1 when it is outside of the ring
+ */
+static int
+ring_locate_point2d(const POINTARRAY *pa, const POINT2D *p)
+{
+  bool inside = false;
+  const POINT2D *p1 = getPoint2d_cp(pa, 0);
+  for (uint32_t i = 1; i < pa->npoints; i++)
+  {
+    const POINT2D *p2 = getPoint2d_cp(pa, i);
+    if (point2d_on_edge(p, p1, p2))
+      return 0;
+    if ((p1->y > p->y) != (p2->y > p->y) &&
+      p->x < (p2->x - p1->x) * (p->y - p1->y) / (p2->y - p1->y) + p1->x)
+      inside = ! inside;
+    p1 = p2;
+  }
+  return inside ? 1 : -1;
+}
+
+/**
+ * Returns true if the point intersects the geometry of the clipper
+ */
+static bool
+polyclipper_contains(const PolyClipper *clip, const POINT2D *p)
+{
+  if (p->x < clip->box.xmin || p->x > clip->box.xmax ||
+    p->y < clip->box.ymin || p->y > clip->box.ymax)
+    return false;
+  for (int i = 0; i < clip->npolys; i++)
+  {
+    const LWPOLY *poly = clip->polys[i];
+    if (poly->nrings == 0)
+      continue;
+    int loc = ring_locate_point2d(poly->rings[0], p);
+    if (loc == 0)
+      return true;
+    if (loc < 0)
+      continue;
+    bool inhole = false;
+    for (uint32_t j = 1; j < poly->nrings; j++)
+    {
+      loc = ring_locate_point2d(poly->rings[j], p);
+      if (loc == 0)
+        return true;
+      if (loc > 0)
+      {
+        inhole = true;
+        break;
+      }
+    }
+    if (! inhole)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Computes the pieces of the segment that intersect the geometry of the
+ * clipper. The segment is split at every crossing with an edge of the
+ * rings and each piece is classified by testing its midpoint.
+ *
+ * @param[in,out] clip Clipper, the pieces are stored as pairs of
+ * fractions in its pieces array, a pair with equal fractions is a point
+ * @param[in] start,end Points defining the segment, they must be different
+ * @result Number of pieces of the segment
+ */
+static int
+polyclipper_segment(PolyClipper *clip, const POINT2D *start,
+  const POINT2D *end)
+{
+  double xmin = Min(start->x, end->x), xmax = Max(start->x, end->x);
+  double ymin = Min(start->y, end->y), ymax = Max(start->y, end->y);
+  if (xmax < clip->box.xmin || xmin > clip->box.xmax ||
+    ymax < clip->box.ymin || ymin > clip->box.ymax)
+    return 0;
+
+  double dx = end->x - start->x, dy = end->y - start->y;
+  double dd = dx * dx + dy * dy;
+  ClipParam *params = clip->params;
+  int n = 0;
+  params[n].fraction = 0; params[n++].boundary = false;
+  params[n].fraction = 1; params[n++].boundary = false;
+  for (int i = 0; i < clip->npolys; i++)
+  {
+    const LWPOLY *poly = clip->polys[i];
+    for (uint32_t j = 0; j < poly->nrings; j++)
+    {
+      const POINTARRAY *pa = poly->rings[j];
+      const POINT2D *a = getPoint2d_cp(pa, 0);
+      for (uint32_t l = 1; l < pa->npoints; l++)
+      {
+        const POINT2D *b = getPoint2d_cp(pa, l);
+        const POINT2D *p1 = a;
+        a = b;
+        /* Edges whose bounding box does not overlap the segment */
+        if (Max(p1->x, b->x) < xmin || Min(p1->x, b->x) > xmax ||
+          Max(p1->y, b->y) < ymin || Min(p1->y, b->y) > ymax)
+          continue;
+        double ex = b->x - p1->x, ey = b->y - p1->y;
+        double elen2 = ex * ex + ey * ey;
+        if (elen2 == 0)
+          continue;
+        double wx = p1->x - start->x, wy = p1->y - start->y;
+        double denom = dx * ey - dy * ex;
+        if (fabs(denom) > CLIP_TOLERANCE * sqrt(dd * elen2))
+        {
+          /* Proper crossing of the segment and the edge */
+          double t = (wx * ey - wy * ex) / denom;
+          double u = (wx * dy - wy * dx) / denom;
+          if (t >= 0 && t <= 1 && u >= 0 && u <= 1)
+          {
+            params[n].fraction = t; params[n++].boundary = true;
+          }
+        }
+        else if (fabs(wx * dy - wy * dx) <= CLIP_TOLERANCE * dd)
+        {
+          /* Collinear edge, add the ends of the edge lying on the segment */
+          double ta = (wx * dx + wy * dy) / dd;
+          double tb = ((b->x - start->x) * dx + (b->y - start->y) * dy) / dd;
+          if (ta >= 0 && ta <= 1)
+          {
+            params[n].fraction = ta; params[n++].boundary = true;
+          }
+          if (tb >= 0 && tb <= 1)
+          {
+            params[n].fraction = tb; params[n++].boundary = true;
+          }
+        }
+      }
+    }
+  }
+
+  /* Sort the candidate fractions and remove duplicates */
+  qsort(params, n, sizeof(ClipParam), clipparam_cmp);
+  int m = 0;
+  for (int i = 1; i < n; i++)
+  {
+    if (params[i].fraction - params[m].fraction <= CLIP_TOLERANCE)
+      params[m].boundary |= params[i].boundary;
+    else
+      params[++m] = params[i];
+  }
+  /* The fraction 1 may have been merged with a smaller one */
+  params[m].fraction = 1;
+
+  /* Classify the pieces between consecutive fractions */
+  int k = 0, first = -1;
+  bool previnside = false;
+  for (int i = 0; i <= m; i++)
+  {
+    bool nextinside = false;
+    if (i < m)
+    {
+      double f = (params[i].fraction + params[i + 1].fraction) / 2;
+      POINT2D mid;
+      mid.x = start->x + dx * f;
+      mid.y = start->y + dy * f;
+      nextinside = polyclipper_contains(clip, &mid);
+    }
+    bool inside = params[i].boundary || previnside || nextinside;
+    /* Only the ends of the segment may be inside without a crossing */
+    if (! inside && (i == 0 || i == m))
+      inside = polyclipper_contains(clip, (i == 0) ? start : end);
+    if (inside)
+    {
+      if (first < 0)
+        first = i;
+      if (! nextinside)
+      {
+        clip->pieces[2 * k] = params[first].fraction;
+        clip->pieces[2 * k + 1] = params[i].fraction;
+        k++;
+        first = -1;
+      }
+    }
+    previnside = nextinside;
+  }
+  return k;
+}
+
+/**
+ * Restricts the linear segment of a temporal sequence point to the geometry
+ * of the clipper
+ *
+ * @param[in] inst1,inst2 Instants defining the segment, their values
+ * must be different
+ * @param[in] lower_inc,upper_inc State whether the bounds are inclusive
+ * @param[in] clip Clipper
+ * @param[out] count Number of elements in the resulting array
+ */
+static TSequence **
+tpointseq_clip_segment(const TInstant *inst1, const TInstant *inst2,
+  bool lower_inc, bool upper_inc, PolyClipper *clip, int *count)
+{
+  int npieces = polyclipper_segment(clip,
+    datum_get_point2d_p(tinstant_value(inst1)),
+    datum_get_point2d_p(tinstant_value(inst2)));
+  if (npieces == 0)
+  {
+    *count = 0;
+    return NULL;
+  }
+
+  TSequence **result = palloc(sizeof(TSequence *) * npieces);
+  TInstant *instants[2];
+  double duration = (inst2->t - inst1->t);
+  int k = 0;
+  for (int i = 0; i < npieces; i++)
+  {
+    TimestampTz t1 = inst1->t + (long) (duration * clip->pieces[2 * i]);
+    TimestampTz t2 = inst1->t + (long) (duration * clip->pieces[2 * i + 1]);
+    Datum point1 = tsequence_value_at_timestamp1(inst1, inst2, true, t1);
+    if (t1 == t2)
+    {
+      /* If the intersection is not at an exclusive bound */
+      if ((lower_inc || t1 > inst1->t) && (upper_inc || t1 < inst2->t))
+      {
+        instants[0] = tinstant_make(point1, t1, inst1->valuetypid);
+        result[k++] = tinstant_to_tsequence(instants[0], true);
+        pfree(instants[0]);
+      }
+    }
+    else
+    {
+      Datum point2 = tsequence_value_at_timestamp1(inst1, inst2, true, t2);
+      instants[0] = tinstant_make(point1, t1, inst1->valuetypid);
+      instants[1] = tinstant_make(point2, t2, inst1->valuetypid);
+      bool lower_inc1 = (t1 == inst1->t) ? lower_inc : true;
+      bool upper_inc1 = (t2 == inst2->t) ? upper_inc : true;
+      result[k++] = tsequence_make(instants, 2, lower_inc1, upper_inc1,
+        true, NORMALIZE_NO);
+      pfree(DatumGetPointer(point2));
+      pfree(instants[0]); pfree(instants[1]);
+    }
+    pfree(DatumGetPointer(point1));
+  }
+  if (k == 0)
+  {
+    pfree(result);
+    *count = 0;
+    return NULL;
+  }
+  *count = k;
+  return result;
+}
+
+/**
+ * Returns true if the point intersects the geometry, using the clipper
+ * when available
+ */
+static bool
+point_intersects_geom(Datum point, Datum geom, const PolyClipper *clip)
+{
+  if (clip != NULL)
+    return polyclipper_contains(clip, datum_get_point2d_p(point));
+  return DatumGetBool(call_function2(intersects, point, geom));
+}
+
+/*****************************************************************************/
+
+/**
+ * Restricts the segment of a temporal sequence point to the geometry
+ *
+ * @param[in] inst1,inst2 Instants defining the segment
+ * @param[in] linear True when the segment has linear interpolation
+ * @param[in] lower_inc,upper_inc State whether the bounds are inclusive
+ * @param[in] geom Geometry
+ * @param[in] clip Clipper of the geometry, NULL when GEOS must be used
+ * @param[out] count Number of elements in the resulting array
+ * @pre The instants have the same SRID and the points and the geometry
+ * are in 2D
+ */
+static TSequence **
+tpointseq_at_geometry1(const TInstant *inst1, const TInstant *inst2,
+  bool linear, bool lower_inc, bool upper_inc, Datum geom, PolyClipper *clip,
+  int *count)
+{
+  Datum value1 = tinstant_value(inst1);
+  Datum value2 = tinstant_value(inst2);
+  TInstant *instants[2];
+
+  /* Constant segment or step interpolation */
+  bool equal = datum_point_eq(value1, value2);
+  if (equal || ! linear)
+  {
+    if (! point_intersects_geom(value1, geom, clip))
+    {
+      *count = 0;
+      return NULL;
+    }
+
+    instants[0] = (TInstant *) inst1;
+    instants[1] = linear ? (TInstant *) inst2 :
+      tinstant_make(value1, inst2->t, inst1->valuetypid);
+    /* Stepwise segment with inclusive upper bound must return 2 sequences */
+    bool upper_inc1 = (linear) ? upper_inc : false;
+    TSequence **result = palloc(sizeof(TSequence *) * 2);
+    result[0] = tsequence_make(instants, 2, lower_inc, upper_inc1,
+      linear, NORMALIZE_NO);
+    int k = 1;
+    if (upper_inc != upper_inc1 &&
+      point_intersects_geom(value2, geom, clip))
+    {
+      result[1] = tinstant_to_tsequence(inst2, linear);
       k = 2;
     }
     if (! linear)
@@ -2796,6 +4091,11 @@ tpointseq_at_geometry1(const TInstant *inst1, const TInstant *inst2,
     return result;
   }
 
+  /* Clip the linear segment natively for 2D polygons */
+  if (clip != NULL)
+    return tpointseq_clip_segment(inst1, inst2, lower_inc, upper_inc, clip,
+      count);
+
   /* Look for intersections in linear segment */
   Datum line = geopoint_line(value1, value2);
   Datum inter = call_function2(intersection, line, geom);
@@ -2933,6 +4233,17 @@ tpointseq_at_geometry2(const TSequence *seq, Datum geom, int *count)
 
   /* Temporal sequence has at least 2 instants */
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  /* 2D polygons are clipped natively, other geometries use GEOS for the
+   * segments whose bounding box overlaps the one of the geometry */
+  PolyClipper clip;
+  bool native = polyclipper_init(&clip, geom);
+  GBOX box;
+  bool hasbox = native;
+  if (native)
+    box = clip.box;
+  else
+    hasbox = (gserialized_get_gbox_p((GSERIALIZED *) DatumGetPointer(geom),
+      &box) == LW_SUCCESS);
   TSequence ***sequences = palloc(sizeof(TSequence *) * (seq->count - 1));
   int *countseqs = palloc0(sizeof(int) * (seq->count - 1));
   int totalseqs = 0;
@@ -2942,12 +4253,21 @@ tpointseq_at_geometry2(const TSequence *seq, Datum geom, int *count)
   {
     TInstant *inst2 = tsequence_inst_n(seq, i + 1);
     bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
-    sequences[i] = tpointseq_at_geometry1(inst1, inst2, linear,
-      lower_inc, upper_inc, geom, &countseqs[i]);
+    const POINT2D *p1 = datum_get_point2d_p(tinstant_value(inst1));
+    const POINT2D *p2 = datum_get_point2d_p(tinstant_value(inst2));
+    if (hasbox && (Max(p1->x, p2->x) < box.xmin ||
+      Min(p1->x, p2->x) > box.xmax || Max(p1->y, p2->y) < box.ymin ||
+      Min(p1->y, p2->y) > box.ymax))
+      sequences[i] = NULL;
+    else
+      sequences[i] = tpointseq_at_geometry1(inst1, inst2, linear,
+        lower_inc, upper_inc, geom, native ? &clip : NULL, &countseqs[i]);
     totalseqs += countseqs[i];
     inst1 = inst2;
     lower_inc = true;
   }
+  if (native)
+    polyclipper_free(&clip);
   /* Set the output parameter */
   *count = totalseqs;
   if (totalseqs == 0)
@@ -3090,6 +4410,9 @@ tpointseqset_restrict_geometry(const TSequenceSet *ts, Datum geom,
  *
  * @pre The arguments are of the same dimensionality, have the same SRID,
  * and the geometry is not empty
+ *
+ * @note The function returns its argument rather than a copy of it when
+ * the restriction does not change the value
  */
 Temporal *
 tpoint_restrict_geometry_internal(const Temporal *temp, Datum geom, bool atfunc)
@@ -3102,7 +4425,7 @@ tpoint_restrict_geometry_internal(const Temporal *temp, Datum geom, bool atfunc)
   /* Non-empty geometries have a bounding box */
   assert(geo_to_stbox_internal(&box2, (GSERIALIZED *) DatumGetPointer(geom)));
   if (!overlaps_stbox_stbox_internal(&box1, &box2))
-    return atfunc ? NULL : temporal_copy(temp);
+    return atfunc ? NULL : (Temporal *) temp;
 
   Temporal *result;
   ensure_valid_duration(temp->duration);
@@ -3135,17 +4458,13 @@ tpoint_restrict_geometry(FunctionCallInfo fcinfo, bool atfunc)
       PG_RETURN_NULL();
     }
     else
-    {
-      Temporal *result = temporal_copy(temp);
-      PG_FREE_IF_COPY(temp, 0);
-      PG_RETURN_POINTER(result);
-    }
+      PG_RETURN_POINTER(temp);
   }
   ensure_same_srid_tpoint_gs(temp, gs);
   ensure_same_dimensionality_tpoint_gs(temp, gs);
   Temporal *result = tpoint_restrict_geometry_internal(temp,
     PointerGetDatum(gs), atfunc);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_FREE_IF_COPY(gs, 1);
   if (result == NULL)
     PG_RETURN_NULL();
@@ -3173,6 +4492,431 @@ tpoint_minus_geometry(PG_FUNCTION_ARGS)
   return tpoint_restrict_geometry(fcinfo, REST_MINUS);
 }
 
+/*****************************************************************************
+ * Native clipping of temporal points against spatiotemporal boxes
+ *****************************************************************************/
+
+/**
+ * Structure used to restrict the segments of a temporal point to a
+ * spatiotemporal box in a single pass
+ */
+typedef struct
+{
+  const STBOX *box;     /**< Box, which has at least the spatial dimension */
+  bool hasz;            /**< True when the box has Z dimension */
+  TimestampTz tmin;     /**< Lower bound of the time dimension */
+  TimestampTz tmax;     /**< Upper bound of the time dimension */
+  bool linear;          /**< Interpolation of the temporal point */
+  TInstant **instants;  /**< Instants of the sequence being constructed */
+  bool *tofree;         /**< True when the instant must be freed */
+  int ninsts;           /**< Number of instants of the current sequence */
+  int maxinsts;         /**< Size of the arrays of instants */
+  bool lower_inc;       /**< Lower bound of the current sequence */
+  TSequence **sequences;  /**< Resulting sequences */
+  int nseqs;            /**< Number of resulting sequences */
+  int maxseqs;          /**< Size of the array of sequences */
+} StboxClipper;
+
+/**
+ * Sets the box of the clipper
+ */
+static void
+stboxclipper_set_box(StboxClipper *clip, const STBOX *box)
+{
+  clip->box = box;
+  clip->hasz = MOBDB_FLAGS_GET_Z(box->flags);
+  clip->tmin = MOBDB_FLAGS_GET_T(box->flags) ? box->tmin : DT_NOBEGIN;
+  clip->tmax = MOBDB_FLAGS_GET_T(box->flags) ? box->tmax : DT_NOEND;
+  return;
+}
+
+/**
+ * Initialize the clipper for the box
+ *
+ * @param[out] clip Clipper
+ * @param[in] box Box
+ * @param[in] maxinsts Initial number of instants of a sequence
+ * @param[in] maxseqs Initial number of resulting sequences
+ * @note The arrays are enlarged when needed
+ */
+static void
+stboxclipper_init(StboxClipper *clip, const STBOX *box, int maxinsts,
+  int maxseqs)
+{
+  stboxclipper_set_box(clip, box);
+  clip->instants = palloc(sizeof(TInstant *) * maxinsts);
+  clip->tofree = palloc(sizeof(bool) * maxinsts);
+  clip->ninsts = 0;
+  clip->maxinsts = maxinsts;
+  clip->sequences = palloc(sizeof(TSequence *) * maxseqs);
+  clip->nseqs = 0;
+  clip->maxseqs = maxseqs;
+  return;
+}
+
+/**
+ * Appends the instant to the current sequence of the clipper
+ */
+static void
+stboxclipper_append(StboxClipper *clip, TInstant *inst, bool tofree)
+{
+  if (clip->ninsts == clip->maxinsts)
+  {
+    clip->maxinsts *= 2;
+    clip->instants = repalloc(clip->instants,
+      sizeof(TInstant *) * clip->maxinsts);
+    clip->tofree = repalloc(clip->tofree, sizeof(bool) * clip->maxinsts);
+  }
+  clip->instants[clip->ninsts] = inst;
+  clip->tofree[clip->ninsts++] = tofree;
+  return;
+}
+
+/**
+ * Appends the sequence to the result of the clipper
+ */
+static void
+stboxclipper_push(StboxClipper *clip, TSequence *seq)
+{
+  if (clip->nseqs == clip->maxseqs)
+  {
+    clip->maxseqs *= 2;
+    clip->sequences = repalloc(clip->sequences,
+      sizeof(TSequence *) * clip->maxseqs);
+  }
+  clip->sequences[clip->nseqs++] = seq;
+  return;
+}
+
+/**
+ * Returns true if the point is in the spatial extent of the box
+ */
+static bool
+point_in_stbox(Datum value, const StboxClipper *clip)
+{
+  const STBOX *box = clip->box;
+  if (clip->hasz)
+  {
+    const POINT3DZ *p = datum_get_point3dz_p(value);
+    return (p->x >= box->xmin && p->x <= box->xmax &&
+      p->y >= box->ymin && p->y <= box->ymax &&
+      p->z >= box->zmin && p->z <= box->zmax);
+  }
+  const POINT2D *p = datum_get_point2d_p(value);
+  return (p->x >= box->xmin && p->x <= box->xmax &&
+    p->y >= box->ymin && p->y <= box->ymax);
+}
+
+/**
+ * Returns true if the instant is in the box
+ */
+static bool
+tpointinst_in_stbox(const TInstant *inst, const StboxClipper *clip)
+{
+  return (inst->t >= clip->tmin && inst->t <= clip->tmax &&
+    point_in_stbox(tinstant_value(inst), clip));
+}
+
+/**
+ * Clips the coordinate of a segment against a slab of the box following
+ * the Liang-Barsky algorithm
+ *
+ * @param[in] c1,c2 Coordinates of the start and end points of the segment
+ * @param[in] cmin,cmax Bounds of the slab
+ * @param[in,out] lower,upper Fractions of the segment inside the box
+ * @result False when the segment does not intersect the slab
+ */
+static bool
+segment_clip_slab(double c1, double c2, double cmin, double cmax,
+  double *lower, double *upper)
+{
+  double delta = c2 - c1;
+  if (delta == 0)
+    return (c1 >= cmin && c1 <= cmax);
+  double f1 = (cmin - c1) / delta;
+  double f2 = (cmax - c1) / delta;
+  if (delta < 0)
+  {
+    double tmp = f1; f1 = f2; f2 = tmp;
+  }
+  *lower = Max(*lower, f1);
+  *upper = Min(*upper, f2);
+  return (*lower <= *upper);
+}
+
+/**
+ * Computes the period during which a linear segment of a temporal point
+ * is in the box
+ *
+ * @param[in] inst1,inst2 Instants defining the segment
+ * @param[in] clip Clipper
+ * @param[out] t1,t2 Bounds of the period
+ * @result False when the segment does not intersect the box
+ */
+static bool
+tpointseg_clip_stbox(const TInstant *inst1, const TInstant *inst2,
+  const StboxClipper *clip, TimestampTz *t1, TimestampTz *t2)
+{
+  const STBOX *box = clip->box;
+  double lower = 0.0, upper = 1.0;
+  if (clip->hasz)
+  {
+    const POINT3DZ *p1 = datum_get_point3dz_p(tinstant_value(inst1));
+    const POINT3DZ *p2 = datum_get_point3dz_p(tinstant_value(inst2));
+    if (! segment_clip_slab(p1->x, p2->x, box->xmin, box->xmax, &lower, &upper) ||
+      ! segment_clip_slab(p1->y, p2->y, box->ymin, box->ymax, &lower, &upper) ||
+      ! segment_clip_slab(p1->z, p2->z, box->zmin, box->zmax, &lower, &upper))
+      return false;
+  }
+  else
+  {
+    const POINT2D *p1 = datum_get_point2d_p(tinstant_value(inst1));
+    const POINT2D *p2 = datum_get_point2d_p(tinstant_value(inst2));
+    if (! segment_clip_slab(p1->x, p2->x, box->xmin, box->xmax, &lower, &upper) ||
+      ! segment_clip_slab(p1->y, p2->y, box->ymin, box->ymax, &lower, &upper))
+      return false;
+  }
+  /* The time dimension is clipped on the timestamps to avoid rounding */
+  double duration = (double) (inst2->t - inst1->t);
+  *t1 = Max(inst1->t + (long) (duration * lower), clip->tmin);
+  *t2 = Min(inst1->t + (long) (duration * upper), clip->tmax);
+  return (*t1 <= *t2);
+}
+
+/**
+ * Adds to the current sequence of the clipper the instant of the segment
+ * at the timestamp
+ */
+static void
+stboxclipper_add(StboxClipper *clip, const TInstant *inst1,
+  const TInstant *inst2, TimestampTz t)
+{
+  TInstant *inst;
+  bool tofree = false;
+  if (t == inst1->t)
+    inst = (TInstant *) inst1;
+  else if (clip->linear && t == inst2->t)
+    inst = (TInstant *) inst2;
+  else
+  {
+    Datum value = clip->linear ?
+      tsequence_value_at_timestamp1(inst1, inst2, true, t) :
+      tinstant_value(inst1);
+    inst = tinstant_make(value, t, inst1->valuetypid);
+    if (clip->linear)
+      pfree(DatumGetPointer(value));
+    tofree = true;
+  }
+  stboxclipper_append(clip, inst, tofree);
+  return;
+}
+
+/**
+ * Closes the current sequence of the clipper. An instantaneous sequence
+ * is only kept when both bounds are inclusive.
+ */
+static void
+stboxclipper_close(StboxClipper *clip, bool upper_inc)
+{
+  if (clip->ninsts == 0)
+    return;
+  if (clip->ninsts > 1 || (clip->lower_inc && upper_inc))
+    stboxclipper_push(clip, tsequence_make(clip->instants, clip->ninsts,
+      clip->lower_inc, upper_inc, clip->linear, NORMALIZE));
+  for (int i = 0; i < clip->ninsts; i++)
+  {
+    if (clip->tofree[i])
+      pfree(clip->instants[i]);
+  }
+  clip->ninsts = 0;
+  return;
+}
+
+/**
+ * Computes the period during which the segment of a temporal sequence point
+ * is in the box of the clipper
+ *
+ * @param[in] clip Clipper
+ * @param[in] inst1,inst2 Instants defining the segment
+ * @param[out] t1,t2 Bounds of the period, where for stepwise interpolation
+ * the value at t2 is the one of inst2
+ * @result False when the segment does not intersect the box
+ */
+static bool
+stboxclipper_inter(const StboxClipper *clip, const TInstant *inst1,
+  const TInstant *inst2, TimestampTz *t1, TimestampTz *t2)
+{
+  if (clip->linear)
+    return tpointseg_clip_stbox(inst1, inst2, clip, t1, t2);
+  /* The value of a stepwise segment is constant on [inst1, inst2) */
+  *t1 = Max(inst1->t, clip->tmin);
+  *t2 = Min(inst2->t, clip->tmax);
+  return (*t1 <= *t2 && *t1 < inst2->t &&
+    point_in_stbox(tinstant_value(inst1), clip));
+}
+
+/**
+ * Restricts the segment of a temporal sequence point to the box
+ *
+ * Consecutive segments that stay in the box are accumulated into the same
+ * sequence, which is closed when the temporal point leaves the box.
+ *
+ * @param[in,out] clip Clipper
+ * @param[in] inst1,inst2 Instants defining the segment
+ * @param[in] lower_inc True when the lower bound of the segment is inclusive
+ */
+static void
+stboxclipper_segment(StboxClipper *clip, const TInstant *inst1,
+  const TInstant *inst2, bool lower_inc)
+{
+  TimestampTz t1, t2;
+  if (! stboxclipper_inter(clip, inst1, inst2, &t1, &t2))
+  {
+    stboxclipper_close(clip, true);
+    return;
+  }
+
+  /* Start a new sequence unless the previous one reached inst1 */
+  if (clip->ninsts == 0 || t1 > inst1->t)
+  {
+    stboxclipper_close(clip, true);
+    clip->lower_inc = (t1 == inst1->t) ? lower_inc : true;
+    stboxclipper_add(clip, inst1, inst2, t1);
+  }
+  if (t2 < inst2->t)
+  {
+    if (t2 > t1)
+      stboxclipper_add(clip, inst1, inst2, t2);
+    stboxclipper_close(clip, true);
+  }
+  else if (clip->linear)
+  {
+    if (t2 > t1)
+      stboxclipper_add(clip, inst1, inst2, t2);
+  }
+  else if (tpointinst_in_stbox(inst2, clip))
+    stboxclipper_append(clip, (TInstant *) inst2, false);
+  else
+  {
+    /* The stepwise segment leaves the box at inst2 */
+    stboxclipper_add(clip, inst1, inst2, t2);
+    stboxclipper_close(clip, false);
+  }
+  return;
+}
+
+/**
+ * Closes the sequence of the clipper at the last instant of a temporal
+ * sequence point
+ *
+ * @param[in,out] clip Clipper
+ * @param[in] inst Last instant of the sequence
+ * @param[in] upper_inc True when the upper bound of the sequence is inclusive
+ */
+static void
+stboxclipper_end(StboxClipper *clip, const TInstant *inst, bool upper_inc)
+{
+  /* The last instant of a stepwise sequence may be alone in the box */
+  if (clip->ninsts == 0 && ! clip->linear && upper_inc &&
+    tpointinst_in_stbox(inst, clip))
+    stboxclipper_push(clip, tinstant_to_tsequence(inst, false));
+  stboxclipper_close(clip, upper_inc);
+  return;
+}
+
+/**
+ * Restricts the temporal sequence point to the box, adding the resulting
+ * sequences to the clipper
+ */
+static void
+tpointseq_clip_stbox(const TSequence *seq, StboxClipper *clip)
+{
+  TInstant *inst1 = tsequence_inst_n(seq, 0);
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+  {
+    if (tpointinst_in_stbox(inst1, clip))
+      stboxclipper_push(clip, tsequence_copy(seq));
+    return;
+  }
+
+  clip->linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  bool lower_inc = seq->period.lower_inc;
+  for (int i = 1; i < seq->count; i++)
+  {
+    TInstant *inst2 = tsequence_inst_n(seq, i);
+    stboxclipper_segment(clip, inst1, inst2, lower_inc);
+    inst1 = inst2;
+    lower_inc = true;
+  }
+  stboxclipper_end(clip, inst1, seq->period.upper_inc);
+  return;
+}
+
+/**
+ * Restricts the temporal planar point to the box without converting the
+ * box into a geometry (dispatch function)
+ *
+ * @pre The box has the spatial dimension and the bounding boxes overlap
+ */
+static Temporal *
+tpoint_clip_stbox(const Temporal *temp, const STBOX *box)
+{
+  StboxClipper clip;
+  Temporal *result = NULL;
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+  {
+    stboxclipper_init(&clip, box, 1, 1);
+    if (tpointinst_in_stbox((TInstant *) temp, &clip))
+      result = (Temporal *) tinstant_copy((TInstant *) temp);
+  }
+  else if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (TInstantSet *) temp;
+    stboxclipper_init(&clip, box, ti->count, 1);
+    int k = 0;
+    for (int i = 0; i < ti->count; i++)
+    {
+      TInstant *inst = tinstantset_inst_n(ti, i);
+      if (tpointinst_in_stbox(inst, &clip))
+        clip.instants[k++] = inst;
+    }
+    if (k != 0)
+      result = (Temporal *) tinstantset_make(clip.instants, k);
+  }
+  else if (temp->duration == SEQUENCE)
+  {
+    const TSequence *seq = (TSequence *) temp;
+    /* Each segment starts at most one sequence */
+    stboxclipper_init(&clip, box, seq->count, seq->count);
+    tpointseq_clip_stbox(seq, &clip);
+    result = (Temporal *) tsequenceset_make_free(clip.sequences, clip.nseqs,
+      NORMALIZE_NO);
+  }
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (TSequenceSet *) temp;
+    int maxinsts = 0;
+    for (int i = 0; i < ts->count; i++)
+      maxinsts = Max(maxinsts, tsequenceset_seq_n(ts, i)->count);
+    stboxclipper_init(&clip, box, maxinsts, ts->totalcount);
+    for (int i = 0; i < ts->count; i++)
+    {
+      TSequence *seq = tsequenceset_seq_n(ts, i);
+      if (overlaps_stbox_stbox_internal(box, tsequence_bbox_ptr(seq)))
+        tpointseq_clip_stbox(seq, &clip);
+    }
+    /* Sequences of different composing sequences may touch each other */
+    result = (Temporal *) tsequenceset_make_free(clip.sequences, clip.nseqs,
+      NORMALIZE);
+  }
+  if (temp->duration == INSTANT || temp->duration == INSTANTSET)
+    pfree(clip.sequences);
+  pfree(clip.instants); pfree(clip.tofree);
+  return result;
+}
+
 /*****************************************************************************/
 
 /**
@@ -3180,6 +4924,9 @@ tpoint_minus_geometry(PG_FUNCTION_ARGS)
  *
  * @pre The arguments are of the same dimensionality and
  * have the same SRID
+ *
+ * @note The function returns its argument rather than a copy of it when
+ * the restriction does not change the value
  */
 Temporal *
 tpoint_at_stbox_internal(const Temporal *temp, const STBOX *box)
@@ -3191,6 +4938,10 @@ tpoint_at_stbox_internal(const Temporal *temp, const STBOX *box)
   if (!overlaps_stbox_stbox_internal(box, &box1))
     return NULL;
 
+  /* Planar points are clipped natively in all the dimensions at once */
+  if (MOBDB_FLAGS_GET_X(box->flags) && ! MOBDB_FLAGS_GET_GEODETIC(temp->flags))
+    return tpoint_clip_stbox(temp, box);
+
   /* At least one of MOBDB_FLAGS_GET_T and MOBDB_FLAGS_GET_X is true */
   Temporal *temp1;
   if (MOBDB_FLAGS_GET_T(box->flags))
@@ -3200,7 +4951,7 @@ tpoint_at_stbox_internal(const Temporal *temp, const STBOX *box)
     temp1 = temporal_at_period_internal(temp, &p);
   }
   else
-    temp1 = temporal_copy(temp);
+    temp1 = (Temporal *) temp;
 
   Temporal *result;
   if (MOBDB_FLAGS_GET_X(box->flags))
@@ -3214,7 +4965,8 @@ tpoint_at_stbox_internal(const Temporal *temp, const STBOX *box)
     result = tpoint_restrict_geometry_internal(temp1, geom1, REST_AT);
     pfree(DatumGetPointer(gbox)); pfree(DatumGetPointer(geom));
     pfree(DatumGetPointer(geom1));
-    pfree(temp1);
+    if (temp1 != temp)
+      pfree(temp1);
   }
   else
     result = temp1;
@@ -3229,6 +4981,9 @@ tpoint_at_stbox_internal(const Temporal *temp, const STBOX *box)
  * compute the atStbox and then compute the complement of the value obtained.
  *
  * @pre The arguments are of the same dimensionality and have the same SRID
+ *
+ * @note The function returns its argument rather than a copy of it when
+ * the restriction does not change the value
  */
 Temporal *
 tpoint_minus_stbox_internal(const Temporal *temp, const STBOX *box)
@@ -3238,7 +4993,7 @@ tpoint_minus_stbox_internal(const Temporal *temp, const STBOX *box)
   memset(&box1, 0, sizeof(STBOX));
   temporal_bbox(&box1, temp);
   if (!overlaps_stbox_stbox_internal(box, &box1))
-    return temporal_copy(temp);
+    return (Temporal *) temp;
 
   Temporal *result = NULL;
   Temporal *temp1 = tpoint_at_stbox_internal(temp, box);
@@ -3252,7 +5007,9 @@ tpoint_minus_stbox_internal(const Temporal *temp, const STBOX *box)
       result = temporal_restrict_periodset_internal(temp, ps, true);
       pfree(ps);
     }
-    pfree(temp1); pfree(ps1); pfree(ps2);
+    if (temp1 != temp)
+      pfree(temp1);
+    pfree(ps1); pfree(ps2);
   }
   return result;
 }
@@ -3271,7 +5028,7 @@ tpoint_restrict_stbox(FunctionCallInfo fcinfo, bool atfunc)
     ensure_same_spatial_dimensionality_tpoint_stbox(temp, box);
   Temporal *result = atfunc ? tpoint_at_stbox_internal(temp, box) :
     tpoint_minus_stbox_internal(temp, box);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   if (result == NULL)
     PG_RETURN_NULL();
   PG_RETURN_POINTER(result);
@@ -3297,4 +5054,587 @@ tpoint_minus_stbox(PG_FUNCTION_ARGS)
   return tpoint_restrict_stbox(fcinfo, REST_MINUS);
 }
 
+/*****************************************************************************
+ * Splitting of temporal points into space-time tiles
+ *****************************************************************************/
+
+/**
+ * Structure to represent a space-time tile and the fragment of the
+ * temporal point that it contains
+ */
+typedef struct
+{
+  int index[4];       /**< Indexes of the tile in the x, y, z, and t dimensions */
+  STBOX box;          /**< Extent of the tile */
+  StboxClipper clip;  /**< Clipper accumulating the fragment */
+  int stamp;          /**< Last segment given to the clipper */
+} STTile;
+
+/**
+ * Structure to represent the tiles of a grid visited by a temporal point.
+ * The tiles are looked up in expected constant time in an open addressing
+ * hash table keyed on their indexes that keeps the position of the tiles
+ * in the array, or -1 for empty slots.
+ */
+typedef struct
+{
+  double xsize;          /**< Size of the tiles in the spatial dimensions */
+  int64 tsize;           /**< Size of the tiles in the time dimension */
+  POINT3DZ sorigin;      /**< Spatial origin of the grid */
+  TimestampTz torigin;   /**< Time origin of the grid */
+  bool hasz;             /**< True when the tiles have Z dimension */
+  int32 srid;            /**< SRID of the tiles */
+  bool linear;           /**< Interpolation of the temporal point */
+  STTile **tiles;        /**< Tiles in the order of their creation */
+  int count;             /**< Number of tiles */
+  int maxcount;          /**< Size of the array of tiles */
+  STTile **open;         /**< Tiles whose fragment reached the last instant */
+  int nopen;             /**< Number of open tiles */
+  STTile **nextopen;     /**< Open tiles after the current segment */
+  int *slots;            /**< Hash table of positions in the array of tiles */
+  uint32 mask;           /**< Size of the hash table minus one */
+  int stamp;             /**< Number of the current segment */
+} STGrid;
+
+/**
+ * Returns the size in microseconds of the tiles defined by the interval
+ */
+static int64
+tile_size(const Interval *interval)
+{
+  if (interval->month != 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The interval of the tiles cannot have months")));
+  int64 result = interval->time + interval->day * USECS_PER_DAY;
+  if (result <= 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The interval of the tiles must be positive")));
+  return result;
+}
+
+/**
+ * Computes the range of indexes of the tiles of a dimension that intersect
+ * the interval [min, max]. Since the tiles are closed, a value on the
+ * boundary of two tiles belongs to both of them.
+ */
+static void
+tile_range(double min, double max, double origin, double size, int *lo,
+  int *hi)
+{
+  *lo = (int) ceil((min - origin) / size) - 1;
+  *hi = (int) floor((max - origin) / size);
+  return;
+}
+
+/**
+ * Computes the range of indexes of the time tiles that intersect the
+ * period [t1, t2]
+ */
+static void
+tile_range_time(const STGrid *grid, TimestampTz t1, TimestampTz t2, int *lo,
+  int *hi)
+{
+  int64 delta1 = t1 - grid->torigin, delta2 = t2 - grid->torigin;
+  /* Round towards plus and minus infinity respectively */
+  int64 ceil1 = delta1 / grid->tsize;
+  if (delta1 % grid->tsize > 0)
+    ceil1++;
+  int64 floor2 = delta2 / grid->tsize;
+  if (delta2 % grid->tsize < 0)
+    floor2--;
+  *lo = (int) (ceil1 - 1);
+  *hi = (int) floor2;
+  return;
+}
+
+/**
+ * Sets the extent of the tile with the given indexes
+ */
+static void
+stgrid_tile_box(const STGrid *grid, const int *index, STBOX *box)
+{
+  memset(box, 0, sizeof(STBOX));
+  box->xmin = grid->sorigin.x + index[0] * grid->xsize;
+  box->xmax = box->xmin + grid->xsize;
+  box->ymin = grid->sorigin.y + index[1] * grid->xsize;
+  box->ymax = box->ymin + grid->xsize;
+  if (grid->hasz)
+  {
+    box->zmin = grid->sorigin.z + index[2] * grid->xsize;
+    box->zmax = box->zmin + grid->xsize;
+  }
+  box->tmin = grid->torigin + index[3] * grid->tsize;
+  box->tmax = box->tmin + grid->tsize;
+  box->srid = grid->srid;
+  MOBDB_FLAGS_SET_X(box->flags, true);
+  MOBDB_FLAGS_SET_Z(box->flags, grid->hasz);
+  MOBDB_FLAGS_SET_T(box->flags, true);
+  return;
+}
+
+/**
+ * Initializes the grid
+ */
+static void
+stgrid_init(STGrid *grid, double xsize, int64 tsize, const POINT3DZ *sorigin,
+  TimestampTz torigin, const Temporal *temp)
+{
+  grid->xsize = xsize;
+  grid->tsize = tsize;
+  grid->sorigin = *sorigin;
+  grid->torigin = torigin;
+  grid->hasz = MOBDB_FLAGS_GET_Z(temp->flags);
+  grid->srid = tpoint_srid_internal(temp);
+  grid->linear = MOBDB_FLAGS_GET_LINEAR(temp->flags);
+  grid->count = 0;
+  grid->maxcount = 16;
+  grid->tiles = palloc(sizeof(STTile *) * grid->maxcount);
+  grid->open = palloc(sizeof(STTile *) * grid->maxcount);
+  grid->nextopen = palloc(sizeof(STTile *) * grid->maxcount);
+  grid->nopen = 0;
+  /* Keep the load factor of the hash table below one half */
+  uint32 size = 32;
+  grid->slots = palloc(sizeof(int) * size);
+  memset(grid->slots, -1, sizeof(int) * size);
+  grid->mask = size - 1;
+  grid->stamp = 0;
+  return;
+}
+
+/**
+ * Returns the slot of the hash table of the tile with the given indexes,
+ * which is empty when the tile has not been created
+ */
+static uint32
+stgrid_slot(const STGrid *grid, const int *index)
+{
+  uint32 i = DatumGetUInt32(hash_any((unsigned char *) index,
+    sizeof(int) * 4)) & grid->mask;
+  while (grid->slots[i] >= 0 &&
+    memcmp(grid->tiles[grid->slots[i]]->index, index, sizeof(int) * 4) != 0)
+    i = (i + 1) & grid->mask;
+  return i;
+}
+
+/**
+ * Returns the tile with the given indexes, or NULL if it has not been
+ * created
+ */
+static STTile *
+stgrid_lookup(const STGrid *grid, const int *index)
+{
+  int pos = grid->slots[stgrid_slot(grid, index)];
+  return (pos < 0) ? NULL : grid->tiles[pos];
+}
+
+/**
+ * Creates the tile with the given indexes
+ */
+static STTile *
+stgrid_add(STGrid *grid, const int *index, const STBOX *box)
+{
+  if (grid->count == grid->maxcount)
+  {
+    grid->maxcount *= 2;
+    grid->tiles = repalloc(grid->tiles, sizeof(STTile *) * grid->maxcount);
+    grid->open = repalloc(grid->open, sizeof(STTile *) * grid->maxcount);
+    grid->nextopen = repalloc(grid->nextopen,
+      sizeof(STTile *) * grid->maxcount);
+  }
+  if ((uint32) grid->count * 2 >= grid->mask)
+  {
+    /* Double the size of the hash table and reinsert the tiles */
+    uint32 size = (grid->mask + 1) * 2;
+    pfree(grid->slots);
+    grid->slots = palloc(sizeof(int) * size);
+    memset(grid->slots, -1, sizeof(int) * size);
+    grid->mask = size - 1;
+    for (int i = 0; i < grid->count; i++)
+      grid->slots[stgrid_slot(grid, grid->tiles[i]->index)] = i;
+  }
+  STTile *tile = palloc(sizeof(STTile));
+  memcpy(tile->index, index, sizeof(int) * 4);
+  tile->box = *box;
+  stboxclipper_init(&tile->clip, &tile->box, 4, 2);
+  tile->clip.linear = grid->linear;
+  tile->stamp = -1;
+  grid->slots[stgrid_slot(grid, index)] = grid->count;
+  grid->tiles[grid->count++] = tile;
+  return tile;
+}
+
+/**
+ * Computes the ranges of indexes of the tiles intersecting the bounding
+ * box of the instants
+ */
+static void
+stgrid_ranges(const STGrid *grid, const TInstant *inst1,
+  const TInstant *inst2, int *lo, int *hi)
+{
+  if (grid->hasz)
+  {
+    const POINT3DZ *p1 = datum_get_point3dz_p(tinstant_value(inst1));
+    const POINT3DZ *p2 = datum_get_point3dz_p(tinstant_value(inst2));
+    tile_range(Min(p1->x, p2->x), Max(p1->x, p2->x), grid->sorigin.x,
+      grid->xsize, &lo[0], &hi[0]);
+    tile_range(Min(p1->y, p2->y), Max(p1->y, p2->y), grid->sorigin.y,
+      grid->xsize, &lo[1], &hi[1]);
+    tile_range(Min(p1->z, p2->z), Max(p1->z, p2->z), grid->sorigin.z,
+      grid->xsize, &lo[2], &hi[2]);
+  }
+  else
+  {
+    const POINT2D *p1 = datum_get_point2d_p(tinstant_value(inst1));
+    const POINT2D *p2 = datum_get_point2d_p(tinstant_value(inst2));
+    tile_range(Min(p1->x, p2->x), Max(p1->x, p2->x), grid->sorigin.x,
+      grid->xsize, &lo[0], &hi[0]);
+    tile_range(Min(p1->y, p2->y), Max(p1->y, p2->y), grid->sorigin.y,
+      grid->xsize, &lo[1], &hi[1]);
+    lo[2] = hi[2] = 0;
+  }
+  tile_range_time(grid, inst1->t, inst2->t, &lo[3], &hi[3]);
+  return;
+}
+
+/**
+ * Adds the instant to the tiles that contain it
+ *
+ * @param[in,out] grid Grid
+ * @param[in] inst Instant
+ * @param[in] seq True when the instant is an instantaneous sequence
+ */
+static void
+stgrid_add_instant(STGrid *grid, const TInstant *inst, bool seq)
+{
+  int lo[4], hi[4], index[4];
+  STBOX box;
+  StboxClipper probe;
+  stgrid_ranges(grid, inst, inst, lo, hi);
+  for (index[3] = lo[3]; index[3] <= hi[3]; index[3]++)
+  for (index[2] = lo[2]; index[2] <= hi[2]; index[2]++)
+  for (index[1] = lo[1]; index[1] <= hi[1]; index[1]++)
+  for (index[0] = lo[0]; index[0] <= hi[0]; index[0]++)
+  {
+    stgrid_tile_box(grid, index, &box);
+    stboxclipper_set_box(&probe, &box);
+    if (! tpointinst_in_stbox(inst, &probe))
+      continue;
+    STTile *tile = stgrid_lookup(grid, index);
+    if (tile == NULL)
+      tile = stgrid_add(grid, index, &box);
+    if (seq)
+      stboxclipper_push(&tile->clip, tinstant_to_tsequence(inst,
+        grid->linear));
+    else
+      stboxclipper_append(&tile->clip, (TInstant *) inst, false);
+  }
+  return;
+}
+
+/**
+ * Gives the segment to the clippers of the open tiles and of the tiles
+ * whose extent intersects the segment
+ */
+static void
+stgrid_add_segment(STGrid *grid, const TInstant *inst1,
+  const TInstant *inst2, bool lower_inc)
+{
+  int nopen = 0;
+  grid->stamp++;
+  /* The open tiles must be given the segment to close their fragment */
+  for (int i = 0; i < grid->nopen; i++)
+  {
+    STTile *tile = grid->open[i];
+    stboxclipper_segment(&tile->clip, inst1, inst2, lower_inc);
+    tile->stamp = grid->stamp;
+    if (tile->clip.ninsts > 0)
+      grid->nextopen[nopen++] = tile;
+  }
+  int lo[4], hi[4], index[4];
+  STBOX box;
+  StboxClipper probe;
+  probe.linear = grid->linear;
+  TimestampTz t1, t2;
+  stgrid_ranges(grid, inst1, inst2, lo, hi);
+  for (index[3] = lo[3]; index[3] <= hi[3]; index[3]++)
+  for (index[2] = lo[2]; index[2] <= hi[2]; index[2]++)
+  for (index[1] = lo[1]; index[1] <= hi[1]; index[1]++)
+  for (index[0] = lo[0]; index[0] <= hi[0]; index[0]++)
+  {
+    STTile *tile = stgrid_lookup(grid, index);
+    if (tile == NULL)
+    {
+      /* Tiles are only created when the segment intersects them */
+      stgrid_tile_box(grid, index, &box);
+      stboxclipper_set_box(&probe, &box);
+      if (! stboxclipper_inter(&probe, inst1, inst2, &t1, &t2))
+        continue;
+      tile = stgrid_add(grid, index, &box);
+    }
+    else if (tile->stamp == grid->stamp)
+      continue;
+    stboxclipper_segment(&tile->clip, inst1, inst2, lower_inc);
+    tile->stamp = grid->stamp;
+    if (tile->clip.ninsts > 0)
+      grid->nextopen[nopen++] = tile;
+  }
+  STTile **tmp = grid->open;
+  grid->open = grid->nextopen;
+  grid->nextopen = tmp;
+  grid->nopen = nopen;
+  return;
+}
+
+/**
+ * Closes the fragments of the tiles at the last instant of a temporal
+ * sequence point
+ */
+static void
+stgrid_end_sequence(STGrid *grid, const TInstant *inst, bool upper_inc)
+{
+  grid->stamp++;
+  for (int i = 0; i < grid->nopen; i++)
+  {
+    stboxclipper_end(&grid->open[i]->clip, inst, upper_inc);
+    grid->open[i]->stamp = grid->stamp;
+  }
+  grid->nopen = 0;
+  if (grid->linear || ! upper_inc)
+    return;
+  /* The last instant of a stepwise sequence may be alone in a tile */
+  int lo[4], hi[4], index[4];
+  STBOX box;
+  StboxClipper probe;
+  stgrid_ranges(grid, inst, inst, lo, hi);
+  for (index[3] = lo[3]; index[3] <= hi[3]; index[3]++)
+  for (index[2] = lo[2]; index[2] <= hi[2]; index[2]++)
+  for (index[1] = lo[1]; index[1] <= hi[1]; index[1]++)
+  for (index[0] = lo[0]; index[0] <= hi[0]; index[0]++)
+  {
+    STTile *tile = stgrid_lookup(grid, index);
+    if (tile == NULL)
+    {
+      stgrid_tile_box(grid, index, &box);
+      stboxclipper_set_box(&probe, &box);
+      if (! tpointinst_in_stbox(inst, &probe))
+        continue;
+      tile = stgrid_add(grid, index, &box);
+    }
+    else if (tile->stamp == grid->stamp)
+      continue;
+    stboxclipper_end(&tile->clip, inst, upper_inc);
+  }
+  return;
+}
+
+/**
+ * Gives the temporal sequence point to the tiles of the grid
+ */
+static void
+stgrid_add_sequence(STGrid *grid, const TSequence *seq)
+{
+  TInstant *inst1 = tsequence_inst_n(seq, 0);
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+  {
+    stgrid_add_instant(grid, inst1, true);
+    return;
+  }
+  bool lower_inc = seq->period.lower_inc;
+  for (int i = 1; i < seq->count; i++)
+  {
+    TInstant *inst2 = tsequence_inst_n(seq, i);
+    stgrid_add_segment(grid, inst1, inst2, lower_inc);
+    inst1 = inst2;
+    lower_inc = true;
+  }
+  stgrid_end_sequence(grid, inst1, seq->period.upper_inc);
+  return;
+}
+
+/**
+ * Comparator function for tiles, which orders them by time and then by
+ * their z, y, and x indexes
+ */
+static int
+sttile_cmp(const void *a, const void *b)
+{
+  const STTile *tile1 = *(const STTile **) a;
+  const STTile *tile2 = *(const STTile **) b;
+  for (int i = 3; i >= 0; i--)
+  {
+    if (tile1->index[i] != tile2->index[i])
+      return (tile1->index[i] < tile2->index[i]) ? -1 : 1;
+  }
+  return 0;
+}
+
+/**
+ * Returns the fragment of the temporal point accumulated in the tile,
+ * or NULL if it is empty
+ */
+static Temporal *
+sttile_fragment(STTile *tile, int16 duration)
+{
+  StboxClipper *clip = &tile->clip;
+  Temporal *result = NULL;
+  if (duration == INSTANT)
+    result = (Temporal *) tinstant_copy(clip->instants[0]);
+  else if (duration == INSTANTSET)
+    result = (Temporal *) tinstantset_make(clip->instants, clip->ninsts);
+  else
+  {
+    /* The sequences were closed in time order */
+    result = (Temporal *) tsequenceset_make_free(clip->sequences,
+      clip->nseqs, NORMALIZE);
+    clip->sequences = NULL;
+  }
+  return result;
+}
+
+/**
+ * Splits the temporal point into the fragments contained in the tiles of
+ * a space-time grid
+ *
+ * The segments are read once and each one is clipped against the tiles
+ * intersecting its bounding box, the fragment of each tile being built
+ * incrementally as for tpoint_at_stbox_internal.
+ *
+ * @param[in] temp Temporal point
+ * @param[in] xsize Size of the tiles in the spatial dimensions
+ * @param[in] tsize Size of the tiles in microseconds
+ * @param[in] sorigin,torigin Origin of the grid
+ * @param[out] boxes Extent of the tiles
+ * @param[out] fragments Fragments of the temporal point
+ * @result Number of non-empty tiles
+ */
+static int
+tpoint_space_time_split_internal(const Temporal *temp, double xsize,
+  int64 tsize, const POINT3DZ *sorigin, TimestampTz torigin, STBOX **boxes,
+  Temporal ***fragments)
+{
+  STGrid grid;
+  stgrid_init(&grid, xsize, tsize, sorigin, torigin, temp);
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+    stgrid_add_instant(&grid, (TInstant *) temp, false);
+  else if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (TInstantSet *) temp;
+    for (int i = 0; i < ti->count; i++)
+      stgrid_add_instant(&grid, tinstantset_inst_n(ti, i), false);
+  }
+  else if (temp->duration == SEQUENCE)
+    stgrid_add_sequence(&grid, (TSequence *) temp);
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (TSequenceSet *) temp;
+    for (int i = 0; i < ts->count; i++)
+      stgrid_add_sequence(&grid, tsequenceset_seq_n(ts, i));
+  }
+
+  if (grid.count > 1)
+    qsort(grid.tiles, (size_t) grid.count, sizeof(STTile *), sttile_cmp);
+  *boxes = palloc(sizeof(STBOX) * grid.count);
+  *fragments = palloc(sizeof(Temporal *) * grid.count);
+  int k = 0;
+  for (int i = 0; i < grid.count; i++)
+  {
+    STTile *tile = grid.tiles[i];
+    Temporal *fragment = sttile_fragment(tile, temp->duration);
+    /* A tile touched at an exclusive bound has an empty fragment */
+    if (fragment != NULL)
+    {
+      (*boxes)[k] = tile->box;
+      (*fragments)[k++] = fragment;
+    }
+    if (tile->clip.sequences != NULL)
+      pfree(tile->clip.sequences);
+    pfree(tile->clip.instants); pfree(tile->clip.tofree);
+    pfree(tile);
+  }
+  pfree(grid.tiles); pfree(grid.open); pfree(grid.nextopen);
+  pfree(grid.slots);
+  return k;
+}
+
+/**
+ * Structure to represent the state of the set-returning function
+ */
+typedef struct
+{
+  STBOX *boxes;          /**< Extent of the tiles */
+  Temporal **fragments;  /**< Fragments of the temporal point */
+} SpaceTimeSplitState;
+
+PG_FUNCTION_INFO_V1(tpoint_space_time_split);
+/**
+ * Returns the fragments of the temporal point in the tiles of a space-time
+ * grid together with the extent and the number of the tiles
+ *
+ * @note The origin of the grid is optional and defaults to the point
+ * (0, 0, 0) and to Monday, January 3, 2000, as for the bucketed aggregates
+ */
+PGDLLEXPORT Datum
+tpoint_space_time_split(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  if (SRF_IS_FIRSTCALL())
+  {
+    funcctx = SRF_FIRSTCALL_INIT();
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    Temporal *temp = PG_GETARG_TEMPORAL(0);
+    double xsize = PG_GETARG_FLOAT8(1);
+    int64 tsize = tile_size(PG_GETARG_INTERVAL_P(2));
+    if (xsize <= 0)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The size of the tiles must be positive")));
+    POINT3DZ sorigin = { 0, 0, 0 };
+    TimestampTz torigin = 2 * USECS_PER_DAY;
+    if (PG_NARGS() > 3)
+    {
+      GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(3);
+      ensure_point_type(gs);
+      ensure_non_empty(gs);
+      ensure_same_srid_tpoint_gs(temp, gs);
+      if (FLAGS_GET_Z(gs->flags))
+        sorigin = *datum_get_point3dz_p(PointerGetDatum(gs));
+      else
+      {
+        const POINT2D *p = datum_get_point2d_p(PointerGetDatum(gs));
+        sorigin.x = p->x;
+        sorigin.y = p->y;
+      }
+      torigin = PG_GETARG_TIMESTAMPTZ(4);
+    }
+    SpaceTimeSplitState *state = palloc(sizeof(SpaceTimeSplitState));
+    int count = tpoint_space_time_split_internal(temp, xsize, tsize,
+      &sorigin, torigin, &state->boxes, &state->fragments);
+    TupleDesc tupdesc;
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+      ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+        errmsg("function returning record called in context that cannot accept type record")));
+    funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+    funcctx->user_fctx = state;
+    funcctx->max_calls = count;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr < funcctx->max_calls)
+  {
+    SpaceTimeSplitState *state = (SpaceTimeSplitState *) funcctx->user_fctx;
+    int i = (int) funcctx->call_cntr;
+    Datum values[3];
+    bool isnull[3] = {false, false, false};
+    values[0] = Int32GetDatum(i + 1);
+    values[1] = PointerGetDatum(&state->boxes[i]);
+    values[2] = PointerGetDatum(state->fragments[i]);
+    HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+    SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+  }
+  SRF_RETURN_DONE(funcctx);
+}
+
 /*****************************************************************************/
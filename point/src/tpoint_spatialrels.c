@@ -29,6 +29,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_argcache.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
 #include "tpoint_distance.h"
@@ -39,112 +40,160 @@
  * covers and coveredby are inverse to each other
  *****************************************************************************/
 
+/**
+ * Returns the FmgrInfo used to call the PostGIS functions of the spatial
+ * relationships
+ *
+ * PostGIS keeps in the fn_extra field of this FmgrInfo its cache of prepared
+ * geometries so that a geometry that is repeated across calls, or across the
+ * instants of a temporal point, is only prepared once. For temporal geography
+ * points this is the FmgrInfo of the external function. For temporal geometry
+ * points, whose external functions keep in their fn_extra field the cache of
+ * their arguments, this is a FmgrInfo kept in this cache.
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] geodetic True when the arguments are geographies
+ */
+FmgrInfo *
+spatialrel_flinfo(FunctionCallInfo fcinfo, bool geodetic)
+{
+  return geodetic ? fcinfo->flinfo : argcache_flinfo(fcinfo);
+}
+
+/**
+ * Calls the PostGIS function with the 2 arguments and the FmgrInfo, if any,
+ * passed as a pointer datum
+ *
+ * @note The functions with 3 arguments such as ST_DWithin do not keep a
+ * cache in PostGIS and are thus called with call_function3
+ */
+static Datum
+geo_call2(PGFunction func, Datum geo1, Datum geo2, Datum flinfo)
+{
+  FmgrInfo *finfo = (FmgrInfo *) DatumGetPointer(flinfo);
+  if (finfo != NULL)
+    return CallerFInfoFunctionCall2(func, finfo, InvalidOid, geo1, geo2);
+  return call_function2(func, geo1, geo2);
+}
+
 /**
  * Calls the PostGIS function ST_Contains with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_contains(Datum geom1, Datum geom2)
+geom_contains(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(contains, geom1, geom2);
+  return geo_call2(contains, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_ContainsProperly with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_containsproperly(Datum geom1, Datum geom2)
+geom_containsproperly(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(containsproperly, geom1, geom2);
+  return geo_call2(containsproperly, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Covers with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_covers(Datum geom1, Datum geom2)
+geom_covers(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(covers, geom1, geom2);
+  return geo_call2(covers, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Coveredby with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_coveredby(Datum geom1, Datum geom2)
+geom_coveredby(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(coveredby, geom1, geom2);
+  return geo_call2(coveredby, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Crosses with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_crosses(Datum geom1, Datum geom2)
+geom_crosses(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(crosses, geom1, geom2);
+  return geo_call2(crosses, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Disjoint with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_disjoint(Datum geom1, Datum geom2)
+geom_disjoint(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(disjoint, geom1, geom2);
+  return geo_call2(disjoint, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Equals with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_equals(Datum geom1, Datum geom2)
+geom_equals(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(ST_Equals, geom1, geom2);
+  return geo_call2(ST_Equals, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Intersects with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_intersects2d(Datum geom1, Datum geom2)
+geom_intersects2d(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(intersects, geom1, geom2);
+  return geo_call2(intersects, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_3DIntersects with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_intersects3d(Datum geom1, Datum geom2)
+geom_intersects3d(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(intersects3d, geom1, geom2);
+  return geo_call2(intersects3d, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Overlaps with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_overlaps(Datum geom1, Datum geom2)
+geom_overlaps(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(overlaps, geom1, geom2);
+  return geo_call2(overlaps, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Touches with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_touches(Datum geom1, Datum geom2)
+geom_touches(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(touches, geom1, geom2);
+  return geo_call2(touches, geom1, geom2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Contains with the 2 arguments inverted
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_within(Datum geom1, Datum geom2)
+geom_within(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(contains, geom2, geom1);
+  return geo_call2(contains, geom2, geom1, flinfo);
 }
 
 /**
@@ -167,11 +216,12 @@ geom_dwithin3d(Datum geom1, Datum geom2, Datum dist)
 
 /**
  * Calls the PostGIS function ST_Relate with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geom_relate(Datum geom1, Datum geom2)
+geom_relate(Datum geom1, Datum geom2, Datum flinfo)
 {
-  return call_function2(relate_full, geom1, geom2);
+  return geo_call2(relate_full, geom1, geom2, flinfo);
 }
 
 /**
@@ -187,42 +237,63 @@ geom_relate_pattern(Datum geom1, Datum geom2, Datum pattern)
 
 /**
  * Calls the PostGIS function ST_Covers for geographies with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geog_covers(Datum geog1, Datum geog2)
+geog_covers(Datum geog1, Datum geog2, Datum flinfo)
 {
-  return call_function2(geography_covers, geog1, geog2);
+  return geo_call2(geography_covers, geog1, geog2, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Covers for geographies with the 2 arguments inverted
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geog_coveredby(Datum geog1, Datum geog2)
+geog_coveredby(Datum geog1, Datum geog2, Datum flinfo)
 {
-  return call_function2(geography_covers, geog2, geog1);
+  return geo_call2(geography_covers, geog2, geog1, flinfo);
 }
 
 /**
  * Calls the PostGIS function ST_Intersects for geographies with the 2 arguments
+ * and the FmgrInfo passed as a pointer datum
  */
 Datum
-geog_intersects(Datum geog1, Datum geog2)
+geog_intersects(Datum geog1, Datum geog2, Datum flinfo)
 {
   /* We apply the same threshold as PostGIS in the definition of the
    * function ST_Intersects(geography, geography) */
-  double dist = DatumGetFloat8(geog_distance(geog1, geog2));
+  double dist = DatumGetFloat8(geo_call2(geography_distance, geog1, geog2,
+    flinfo));
   return BoolGetDatum(dist < DIST_EPSILON);
 }
 
 /**
- * Calls the PostGIS function ST_DWithin for geographies with the 2 arguments
+ * Calls the PostGIS function ST_DWithin for geographies with the 3 arguments
+ * and the FmgrInfo passed as a pointer datum, in which PostGIS keeps the
+ * trees of the geographies repeated across calls
+ */
+Datum
+geog_dwithin_flinfo(Datum geog1, Datum geog2, Datum dist, Datum flinfo)
+{
+  FmgrInfo *finfo = (FmgrInfo *) DatumGetPointer(flinfo);
+  if (finfo != NULL)
+    return CallerFInfoFunctionCall4(geography_dwithin, finfo, InvalidOid,
+      geog1, geog2, dist, BoolGetDatum(true));
+  return call_function4(geography_dwithin, geog1, geog2, dist,
+    BoolGetDatum(true));
+}
+
+/**
+ * Calls the PostGIS function ST_DWithin for geographies with the 3 arguments
+ * and without cache, for the trajectories and the segments of two temporal
+ * points, which change at every call
  */
 Datum
 geog_dwithin(Datum geog1, Datum geog2, Datum dist)
 {
-  return CallerFInfoFunctionCall4(geography_dwithin, (fetch_fcinfo())->flinfo,
-    InvalidOid, geog1, geog2, dist, BoolGetDatum(true));
+  return geog_dwithin_flinfo(geog1, geog2, dist, PointerGetDatum(NULL));
 }
 
 /*****************************************************************************
@@ -357,60 +428,99 @@ spatialrel(Datum value1, Datum value2, Datum param, LiftedFunctionInfo lfinfo)
  * Generic spatial relationships for a temporal point and a geometry
  *
  * @param[in] temp Temporal point
+ * @param[in] traj Trajectory of the temporal point
  * @param[in] gs Geometry
- * @param[in] param Parameter
+ * @param[in] param Parameter of the ternary functions
+ * @param[in] flinfo FmgrInfo passed as a pointer datum to the PostGIS
+ * functions, as third argument to the binary functions and as fourth
+ * argument to the ternary functions for geographies
  * @param[in] geomfunc Function for geometries
  * @param[in] geogfunc Function for geographies
  * @param[in] numparam Number of parameters of the functions
  * @param[in] invert True if the arguments should be inverted
  */
 Datum
-spatialrel_tpoint_geo1(Temporal *temp, GSERIALIZED *gs, Datum param,
-  Datum (*geomfunc)(Datum, ...), Datum (*geogfunc)(Datum, ...),
-  int numparam, bool invert)
+spatialrel_tpoint_geo1(Temporal *temp, Datum traj, GSERIALIZED *gs,
+  Datum param, FmgrInfo *flinfo, Datum (*geomfunc)(Datum, ...),
+  Datum (*geogfunc)(Datum, ...), int numparam, bool invert)
 {
-  ensure_same_srid_tpoint_gs(temp, gs);
-  ensure_same_dimensionality_tpoint_gs(temp, gs);
   bool isgeod = MOBDB_FLAGS_GET_GEODETIC(temp->flags);
   if (isgeod)
      assert (geogfunc != NULL);
   else
      assert (geomfunc != NULL);
-  Datum traj = tpoint_trajectory_internal(temp);
+  Datum geo = PointerGetDatum(gs);
+  if (numparam == 3 && isgeod)
+    return invert ? geogfunc(geo, traj, param, PointerGetDatum(flinfo)) :
+      geogfunc(traj, geo, param, PointerGetDatum(flinfo));
   /* We only need to fill these parameters for function spatialrel */
   LiftedFunctionInfo lfinfo;
   lfinfo.func = isgeod ? geogfunc : geomfunc;
-  lfinfo.numparam = numparam;
+  lfinfo.numparam = 3;
   lfinfo.invert = invert;
   lfinfo.discont = DISCONTINUOUS;
-  Datum result = spatialrel(traj, PointerGetDatum(gs), param, lfinfo);
-  pfree(DatumGetPointer(traj));
-  return result;
+  return spatialrel(traj, geo,
+    (numparam == 2) ? PointerGetDatum(flinfo) : param, lfinfo);
 }
 
 /**
- * Generic spatial relationships for a geometry and a temporal point
+ * Generic spatial relationships for a temporal point and a geometry given
+ * the position of the arguments
+ *
+ * The temporal point, its trajectory, and the geometry are taken from the
+ * cache of the function arguments when they have the same value as in the
+ * previous call, e.g., when one of them is a constant of the query. This is
+ * not done for geographies since the PostGIS functions for geographies are
+ * called with the FmgrInfo of this function and keep their own cache in
+ * its fn_extra field. The functions with 2 arguments receive as third
+ * argument the FmgrInfo returned by function spatialrel_flinfo, and the
+ * functions for geographies with 3 arguments receive it as fourth argument.
+ * Otherwise,
+ * the temporal point and its trajectory are taken from the row cache, so
+ * that they are shared by all the spatial relationships called on the row.
  *
  * @param[in] fcinfo Catalog information about the external function
+ * @param[in] tpointarg,geoarg Number of the temporal point and the geometry
+ * arguments
  * @param[in] geomfunc Function for geometries
  * @param[in] geogfunc Function for geographies
  * @param[in] numparam Number of parameters of the functions
+ * @param[in] invert True if the arguments should be inverted
  */
-Datum
-spatialrel_geo_tpoint(FunctionCallInfo fcinfo, Datum (*geomfunc)(Datum, ...),
-  Datum (*geogfunc)(Datum, ...), int numparam)
+static Datum
+spatialrel_tpoint_geo2(FunctionCallInfo fcinfo, int tpointarg, int geoarg,
+  Datum (*geomfunc)(Datum, ...), Datum (*geogfunc)(Datum, ...),
+  int numparam, bool invert)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+  ArgCacheEntry *tentry = NULL, *gentry = NULL;
+  bool isgeom = (get_fn_expr_argtype(fcinfo->flinfo, tpointarg) ==
+    type_oid(T_TGEOMPOINT));
+  if (isgeom)
+  {
+    tentry = argcache_temporal(fcinfo, tpointarg);
+    gentry = argcache_gserialized(fcinfo, geoarg);
+  }
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(geoarg);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
-  Temporal *temp = PG_GETARG_TEMPORAL(1);
-  Datum param = (numparam == 2) ? (Datum) NULL : PG_GETARG_DATUM(2);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
-  Datum result = spatialrel_tpoint_geo1(temp, gs, param, geomfunc, geogfunc,
-    numparam, INVERT);
-  PG_FREE_IF_COPY(gs, 0);
-  PG_FREE_IF_COPY(temp, 1);
+  FmgrInfo *flinfo = spatialrel_flinfo(fcinfo, ! isgeom);
+  Datum param = (numparam == 2) ? PointerGetDatum(NULL) : PG_GETARG_DATUM(2);
+  Temporal *temp;
+  Datum traj;
+  if (tentry != NULL)
+  {
+    temp = (Temporal *) DatumGetPointer(tentry->value);
+    traj = argcache_tpoint_trajectory(fcinfo, tentry);
+  }
+  else
+    temp = rowcache_tpoint(fcinfo, tpointarg, &traj);
+  ensure_same_srid_tpoint_gs(temp, gs);
+  ensure_same_dimensionality_tpoint_gs(temp, gs);
+  Datum result = spatialrel_tpoint_geo1(temp, traj, gs, param, flinfo,
+    geomfunc, geogfunc, numparam, invert);
+  ARGCACHE_FREE_IF_COPY(gs, geoarg, gentry);
   PG_RETURN_DATUM(result);
 }
 
@@ -423,21 +533,27 @@ spatialrel_geo_tpoint(FunctionCallInfo fcinfo, Datum (*geomfunc)(Datum, ...),
  * @param[in] numparam Number of parameters of the functions
  */
 Datum
+spatialrel_geo_tpoint(FunctionCallInfo fcinfo, Datum (*geomfunc)(Datum, ...),
+  Datum (*geogfunc)(Datum, ...), int numparam)
+{
+  return spatialrel_tpoint_geo2(fcinfo, 1, 0, geomfunc, geogfunc, numparam,
+    INVERT);
+}
+
+/**
+ * Generic spatial relationships for a temporal point and a geometry
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] geomfunc Function for geometries
+ * @param[in] geogfunc Function for geographies
+ * @param[in] numparam Number of parameters of the functions
+ */
+Datum
 spatialrel_tpoint_geo(FunctionCallInfo fcinfo, Datum (*geomfunc)(Datum, ...),
   Datum (*geogfunc)(Datum, ...), int numparam)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
-  if (gserialized_is_empty(gs))
-    PG_RETURN_NULL();
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
-  Datum param = (numparam == 2) ? (Datum) NULL : PG_GETARG_DATUM(2);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
-  Datum result = spatialrel_tpoint_geo1(temp, gs, param, geomfunc, geogfunc,
-    numparam, INVERT_NO);
-  PG_FREE_IF_COPY(temp, 0);
-  PG_FREE_IF_COPY(gs, 1);
-  PG_RETURN_DATUM(result);
+  return spatialrel_tpoint_geo2(fcinfo, 0, 1, geomfunc, geogfunc, numparam,
+    INVERT_NO);
 }
 
 /**
@@ -454,7 +570,10 @@ spatialrel_tpoint_tpoint(FunctionCallInfo fcinfo, Datum (*geomfunc)(Datum, ...),
 {
   Temporal *temp1 = PG_GETARG_TEMPORAL(0);
   Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-  Datum param = (numparam == 2) ? (Datum) NULL : PG_GETARG_DATUM(2);
+  bool isgeod = MOBDB_FLAGS_GET_GEODETIC(temp1->flags);
+  /* The trajectories are computed in each call and thus the PostGIS
+   * functions are called without cache */
+  Datum param = (numparam == 2) ? PointerGetDatum(NULL) : PG_GETARG_DATUM(2);
   ensure_same_srid_tpoint(temp1, temp2);
   ensure_same_dimensionality_tpoint(temp1, temp2);
   Temporal *inter1, *inter2;
@@ -468,10 +587,7 @@ spatialrel_tpoint_tpoint(FunctionCallInfo fcinfo, Datum (*geomfunc)(Datum, ...),
   }
   Datum traj1 = tpoint_trajectory_internal(inter1);
   Datum traj2 = tpoint_trajectory_internal(inter2);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
 
-  bool isgeod = MOBDB_FLAGS_GET_GEODETIC(temp1->flags);
   if (isgeod)
      assert (geogfunc != NULL);
   else
@@ -479,7 +595,7 @@ spatialrel_tpoint_tpoint(FunctionCallInfo fcinfo, Datum (*geomfunc)(Datum, ...),
   /* We only need to fill these parameters for function spatialrel */
   LiftedFunctionInfo lfinfo;
   lfinfo.func = isgeod ? geogfunc : geomfunc;
-  lfinfo.numparam = numparam;
+  lfinfo.numparam = 3;
   lfinfo.invert = INVERT_NO;
   Datum result = spatialrel(traj1, traj2, param, lfinfo);
   pfree(DatumGetPointer(traj1)); pfree(DatumGetPointer(traj2));
@@ -904,7 +1020,7 @@ PGDLLEXPORT Datum
 dwithin_geo_tpoint(PG_FUNCTION_ARGS)
 {
   return spatialrel_geo_tpoint(fcinfo, (varfunc) &geom_dwithin2d,
-    (varfunc) geog_dwithin, 3);
+    (varfunc) geog_dwithin_flinfo, 3);
 }
 
 PG_FUNCTION_INFO_V1(dwithin_tpoint_geo);
@@ -916,7 +1032,7 @@ PGDLLEXPORT Datum
 dwithin_tpoint_geo(PG_FUNCTION_ARGS)
 {
   return spatialrel_tpoint_geo(fcinfo, (varfunc) &geom_dwithin2d,
-    (varfunc) geog_dwithin, 3);
+    (varfunc) geog_dwithin_flinfo, 3);
 }
 
 PG_FUNCTION_INFO_V1(dwithin_tpoint_tpoint);
@@ -949,8 +1065,6 @@ dwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
   else
     func = MOBDB_FLAGS_GET_Z(temp1->flags) ? &geom_dwithin3d :
       &geom_dwithin2d;
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
 
   bool result;
   ensure_valid_duration(sync1->duration);
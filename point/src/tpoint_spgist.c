@@ -71,12 +71,18 @@
  * every dimension of every corner of the box on every level of the tree
  * except the root.  For the root node, we are setting the boundaries
  * that we don't yet have as infinity.
+ *
+ * The module also provides a k-d tree over the same 8-dimensional space,
+ * in which every inner tuple splits its boxes along a single dimension.
+ * The fan-out of 2 avoids the large and mostly empty inner tuples of the
+ * oct-tree when the data is clustered, at the expense of a deeper tree.
  */
 
 #if MOBDB_PGSQL_VERSION >= 110000
 
 #include "tpoint_spgist.h"
 
+#include <float.h>
 #include <access/spgist.h>
 #include <utils/timestamp.h>
 #include <utils/builtins.h>
@@ -93,13 +99,6 @@
 #include "tpoint_boxops.h"
 #include "tpoint_gist.h"
 
-#if MOBDB_PGSQL_VERSION >= 120000
-/* To avoid including "access/spgist_private.h" since it conflicts with the
- * EPSILON constant defined there and also in MobilityDB */
-extern double *spg_key_orderbys_distances(Datum key, bool isLeaf, ScanKey orderbys,
-  int norderbys);
-#endif
-
 /*****************************************************************************/
 
 /**
@@ -364,7 +363,7 @@ overAbove8D(const CubeSTbox *cube_box, const STBOX *query)
  * Can any cube from cube_box be in front of query?
  */
 static bool
-front8D(CubeSTbox *cube_box, STBOX *query)
+front8D(const CubeSTbox *cube_box, const STBOX *query)
 {
   return (cube_box->right.zmax < query->zmin);
 }
@@ -435,15 +434,25 @@ overAfter8D(const CubeSTbox *cube_box, const STBOX *query)
 #if MOBDB_PGSQL_VERSION >= 110000
 /**
  * Lower bound for the distance between query and cube_box.
- * @note The temporal dimension is not taken into the account since it is not
- * possible to mix different units in the computation. As a consequence, the
- * filtering is not very restrictive.
+ * When the query has a time dimension, the cubes that cannot intersect the
+ * period of the query are pruned by returning the maximum distance. The
+ * coordinates of geodetic boxes are geocentric, so that no lower bound of
+ * the spatial distance is computed for them.
  */
 static double
 distanceBoxCubeBox(const STBOX *query, const CubeSTbox *cube_box)
 {
-  double dx, dy, dz;
-  bool hasz = MOBDB_FLAGS_GET_Z(cube_box->left.flags);
+  double dx, dy, dz = 0;
+  bool hasz = MOBDB_FLAGS_GET_Z(cube_box->left.flags) &&
+    MOBDB_FLAGS_GET_Z(query->flags);
+
+  if (! MOBDB_FLAGS_GET_X(query->flags))
+    return DBL_MAX;
+  if (MOBDB_FLAGS_GET_T(query->flags) &&
+      (cube_box->left.tmin > query->tmax || cube_box->right.tmax < query->tmin))
+    return DBL_MAX;
+  if (MOBDB_FLAGS_GET_GEODETIC(query->flags))
+    return 0.0;
 
   if (query->xmax < cube_box->left.xmin)
     dx = cube_box->left.xmin - query->xmax;
@@ -471,8 +480,105 @@ distanceBoxCubeBox(const STBOX *query, const CubeSTbox *cube_box)
 
   return hasz ? hypot3d(dx, dy, dz) : hypot(dx, dy);
 }
+
+/**
+ * Transform the arguments of the ORDER BY clause into bounding boxes.
+ * The flags of the boxes of empty geometries are not set, and thus their
+ * distance is the maximum one.
+ */
+static STBOX *
+spgist_orderby_boxes(ScanKey orderbys, int norderbys)
+{
+  STBOX *boxes = (STBOX *) palloc0(sizeof(STBOX) * norderbys);
+  for (int i = 0; i < norderbys; i++)
+    tpoint_index_query_box(orderbys[i].sk_argument, orderbys[i].sk_subtype,
+      &boxes[i]);
+  return boxes;
+}
 #endif
 
+/**
+ * Transform the queries into bounding boxes initializing the dimensions
+ * that must not be taken into account for the operators to infinity.
+ * This transformation is done once for all the nodes of an inner tuple.
+ */
+static STBOX *
+spgist_query_boxes(const spgInnerConsistentIn *in)
+{
+  STBOX *queries = (STBOX *) palloc0(sizeof(STBOX) * in->nkeys);
+  for (int i = 0; i < in->nkeys; i++)
+  {
+    Oid subtype = in->scankeys[i].sk_subtype;
+    if (tgeo_base_type(subtype))
+      /* We do not test the return value of the next function since
+         if the result is false all dimensions of the box have been
+         initialized to +-infinity */
+      geo_to_stbox_internal(&queries[i],
+        (GSERIALIZED*)PG_DETOAST_DATUM(in->scankeys[i].sk_argument));
+    else if (subtype == type_oid(T_STBOX))
+      memcpy(&queries[i], DatumGetSTboxP(in->scankeys[i].sk_argument), sizeof(STBOX));
+    else if (tgeo_type(subtype))
+      temporal_bbox_slice(&queries[i], in->scankeys[i].sk_argument);
+    else
+      elog(ERROR, "Unsupported subtype for indexing: %d", subtype);
+  }
+  return queries;
+}
+
+/**
+ * Can any box in cube_box satisfy the query for the strategy?
+ */
+static bool
+cube_box_consistent(const CubeSTbox *cube_box, const STBOX *query,
+  StrategyNumber strategy)
+{
+  switch (strategy)
+  {
+    case RTOverlapStrategyNumber:
+    case RTContainedByStrategyNumber:
+    case RTAdjacentStrategyNumber:
+      return overlap8D(cube_box, query);
+    case RTContainsStrategyNumber:
+    case RTSameStrategyNumber:
+      return contain8D(cube_box, query);
+    case RTLeftStrategyNumber:
+      return !overRight8D(cube_box, query);
+    case RTOverLeftStrategyNumber:
+      return !right8D(cube_box, query);
+    case RTRightStrategyNumber:
+      return !overLeft8D(cube_box, query);
+    case RTOverRightStrategyNumber:
+      return !left8D(cube_box, query);
+    case RTFrontStrategyNumber:
+      return !overBack8D(cube_box, query);
+    case RTOverFrontStrategyNumber:
+      return !back8D(cube_box, query);
+    case RTBackStrategyNumber:
+      return !overFront8D(cube_box, query);
+    case RTOverBackStrategyNumber:
+      return !front8D(cube_box, query);
+    case RTAboveStrategyNumber:
+      return !overBelow8D(cube_box, query);
+    case RTOverAboveStrategyNumber:
+      return !below8D(cube_box, query);
+    case RTBelowStrategyNumber:
+      return !overAbove8D(cube_box, query);
+    case RTOverBelowStrategyNumber:
+      return !above8D(cube_box, query);
+    case RTAfterStrategyNumber:
+      return !overBefore8D(cube_box, query);
+    case RTOverAfterStrategyNumber:
+      return !before8D(cube_box, query);
+    case RTBeforeStrategyNumber:
+      return !overAfter8D(cube_box, query);
+    case RTOverBeforeStrategyNumber:
+      return !after8D(cube_box, query);
+    default:
+      elog(ERROR, "unrecognized strategy: %d", strategy);
+      return false; /* make compiler quiet */
+  }
+}
+
 
 /*****************************************************************************
  * SP-GiST config function
@@ -654,6 +760,9 @@ stbox_spgist_inner_consistent(PG_FUNCTION_ARGS)
   CubeSTbox *cube_box;
   uint16 octant;
   STBOX *centroid = DatumGetSTboxP(in->prefixDatum), *queries;
+#if MOBDB_PGSQL_VERSION >= 120000
+  STBOX *orderbys = NULL;
+#endif
 
   /*
    * We are saving the traversal value or initialize it an unbounded one, if
@@ -664,6 +773,12 @@ stbox_spgist_inner_consistent(PG_FUNCTION_ARGS)
   else
     cube_box = initCubeSTbox(centroid);
 
+#if MOBDB_PGSQL_VERSION >= 120000
+  /* Transform the arguments of the ORDER BY clause into bounding boxes */
+  if (in->norderbys > 0)
+    orderbys = spgist_orderby_boxes(in->orderbys, in->norderbys);
+#endif
+
   if (in->allTheSame)
   {
     /* Report that all nodes should be visited */
@@ -677,10 +792,7 @@ stbox_spgist_inner_consistent(PG_FUNCTION_ARGS)
     {
       double *distances = palloc(sizeof(double) * in->norderbys);
       for (int j = 0; j < in->norderbys; j++)
-      {
-        STBOX *box = DatumGetSTboxP(in->orderbys[j].sk_argument);
-        distances[j] = distanceBoxCubeBox(box, cube_box);
-      }
+        distances[j] = distanceBoxCubeBox(&orderbys[j], cube_box);
 
       out->distances = (double **) palloc(sizeof(double *) * in->nNodes);
       out->distances[0] = distances;
@@ -697,30 +809,8 @@ stbox_spgist_inner_consistent(PG_FUNCTION_ARGS)
     PG_RETURN_VOID();
   }
 
-  /*
-   * Transform the queries into bounding boxes initializing the dimensions
-   * that must not be taken into account for the operators to infinity.
-   * This transformation is done here to avoid doing it for all octants
-   * in the loop below.
-   */
-  queries = (STBOX *) palloc0(sizeof(STBOX) * in->nkeys);
-  for (i = 0; i < in->nkeys; i++)
-  {
-    Oid subtype = in->scankeys[i].sk_subtype;
-    if (tgeo_base_type(subtype))
-      /* We do not test the return value of the next function since
-         if the result is false all dimensions of the box have been
-         initialized to +-infinity */
-      geo_to_stbox_internal(&queries[i],
-        (GSERIALIZED*)PG_DETOAST_DATUM(in->scankeys[i].sk_argument));
-    else if (subtype == type_oid(T_STBOX))
-      memcpy(&queries[i], DatumGetSTboxP(in->scankeys[i].sk_argument), sizeof(STBOX));
-    else if (tgeo_type(subtype))
-      temporal_bbox(&queries[i],
-        DatumGetTemporal(in->scankeys[i].sk_argument));
-    else
-      elog(ERROR, "Unsupported subtype for indexing: %d", subtype);
-  }
+  /* Transform the queries into bounding boxes */
+  queries = spgist_query_boxes(in);
 
   /* Allocate enough memory for nodes */
   out->nNodes = 0;
@@ -743,70 +833,8 @@ stbox_spgist_inner_consistent(PG_FUNCTION_ARGS)
     bool flag = true;
     for (i = 0; i < in->nkeys; i++)
     {
-      StrategyNumber strategy = in->scankeys[i].sk_strategy;
-      switch (strategy)
-      {
-        case RTOverlapStrategyNumber:
-        case RTContainedByStrategyNumber:
-        case RTAdjacentStrategyNumber:
-          flag = overlap8D(next_cube_box, &queries[i]);
-          break;
-        case RTContainsStrategyNumber:
-        case RTSameStrategyNumber:
-          flag = contain8D(next_cube_box, &queries[i]);
-          break;
-        case RTLeftStrategyNumber:
-          flag = !overRight8D(next_cube_box, &queries[i]);
-          break;
-        case RTOverLeftStrategyNumber:
-          flag = !right8D(next_cube_box, &queries[i]);
-          break;
-        case RTRightStrategyNumber:
-          flag = !overLeft8D(next_cube_box, &queries[i]);
-          break;
-        case RTOverRightStrategyNumber:
-          flag = !left8D(next_cube_box, &queries[i]);
-          break;
-        case RTFrontStrategyNumber:
-          flag = !overBack8D(next_cube_box, &queries[i]);
-          break;
-        case RTOverFrontStrategyNumber:
-          flag = !back8D(next_cube_box, &queries[i]);
-          break;
-        case RTBackStrategyNumber:
-          flag = !overFront8D(next_cube_box, &queries[i]);
-          break;
-        case RTOverBackStrategyNumber:
-          flag = !front8D(next_cube_box, &queries[i]);
-          break;
-        case RTAboveStrategyNumber:
-          flag = !overBelow8D(next_cube_box, &queries[i]);
-          break;
-        case RTOverAboveStrategyNumber:
-          flag = !below8D(next_cube_box, &queries[i]);
-          break;
-        case RTBelowStrategyNumber:
-          flag = !overAbove8D(next_cube_box, &queries[i]);
-          break;
-        case RTOverBelowStrategyNumber:
-          flag = !above8D(next_cube_box, &queries[i]);
-          break;
-        case RTAfterStrategyNumber:
-          flag = !overBefore8D(next_cube_box, &queries[i]);
-          break;
-        case RTOverAfterStrategyNumber:
-          flag = !before8D(next_cube_box, &queries[i]);
-          break;
-        case RTBeforeStrategyNumber:
-          flag = !overAfter8D(next_cube_box, &queries[i]);
-          break;
-        case RTOverBeforeStrategyNumber:
-          flag = !after8D(next_cube_box, &queries[i]);
-          break;
-        default:
-          elog(ERROR, "unrecognized strategy: %d", strategy);
-      }
-
+      flag = cube_box_consistent(next_cube_box, &queries[i],
+        in->scankeys[i].sk_strategy);
       /* If any check is failed, we have found our answer. */
       if (!flag)
         break;
@@ -822,10 +850,7 @@ stbox_spgist_inner_consistent(PG_FUNCTION_ARGS)
         double *distances = palloc(sizeof(double) * in->norderbys);
         out->distances[out->nNodes] = distances;
         for (int j = 0; j < in->norderbys; j++)
-        {
-          STBOX *box = DatumGetSTboxP(in->orderbys[j].sk_argument);
-          distances[j] = distanceBoxCubeBox(box, cube_box);
-        }
+          distances[j] = distanceBoxCubeBox(&orderbys[j], next_cube_box);
       }
 #endif
       out->nNodes++;
@@ -844,6 +869,300 @@ stbox_spgist_inner_consistent(PG_FUNCTION_ARGS)
   MemoryContextSwitchTo(old_ctx);
 
   pfree(queries);
+#if MOBDB_PGSQL_VERSION >= 120000
+  if (orderbys)
+    pfree(orderbys);
+#endif
+
+  PG_RETURN_VOID();
+}
+
+/*****************************************************************************
+ * K-d tree
+ *
+ * The boxes are seen as points in an 8-dimensional space and every inner
+ * tuple splits its boxes in two halves along one dimension. The cutoff
+ * value is kept in the prefix of the inner tuple and the dimension of the
+ * split in the labels of its two nodes. Since the dimension is stored,
+ * the picksplit function can skip the dimensions in which all its boxes
+ * have the same value, such as the Z dimension for 2D boxes.
+ *****************************************************************************/
+
+/**
+ * Number of dimensions of the k-d tree
+ */
+#define KDTREE_NDIMS 8
+
+/**
+ * Returns the coordinate of the box for the dimension of the k-d tree.
+ * The even and odd dimensions are respectively the lower and upper bounds
+ * of the X, Y, T, and Z dimensions.
+ */
+static double
+kdtree_coord(const STBOX *box, int dim)
+{
+  switch (dim)
+  {
+    case 0: return box->xmin;
+    case 1: return box->xmax;
+    case 2: return box->ymin;
+    case 3: return box->ymax;
+    case 4: return (double) box->tmin;
+    case 5: return (double) box->tmax;
+    case 6: return box->zmin;
+    default: return box->zmax;
+  }
+}
+
+/**
+ * Calculate the next traversal value of the k-d tree. The first node
+ * contains the boxes whose coordinate is less than or equal to the cutoff
+ * value and the second node the other ones.
+ */
+static CubeSTbox *
+kdtreeNextCubeSTbox(const CubeSTbox *cube_box, int dim, double cutoff,
+  int node)
+{
+  CubeSTbox *next_cube_box = (CubeSTbox *) palloc(sizeof(CubeSTbox));
+  STBOX *bounds;
+
+  memcpy(next_cube_box, cube_box, sizeof(CubeSTbox));
+  bounds = (dim % 2 == 0) ? &next_cube_box->left : &next_cube_box->right;
+  switch (dim / 2)
+  {
+    case 0:
+      if (node == 0)
+        bounds->xmax = cutoff;
+      else
+        bounds->xmin = cutoff;
+      break;
+    case 1:
+      if (node == 0)
+        bounds->ymax = cutoff;
+      else
+        bounds->ymin = cutoff;
+      break;
+    case 2:
+      if (node == 0)
+        bounds->tmax = (TimestampTz) cutoff;
+      else
+        bounds->tmin = (TimestampTz) cutoff;
+      break;
+    default:
+      if (node == 0)
+        bounds->zmax = cutoff;
+      else
+        bounds->zmin = cutoff;
+  }
+  return next_cube_box;
+}
+
+PG_FUNCTION_INFO_V1(stbox_kdtree_config);
+/**
+ * SP-GiST config function for the k-d tree of temporal points
+ */
+PGDLLEXPORT Datum
+stbox_kdtree_config(PG_FUNCTION_ARGS)
+{
+  spgConfigOut *cfg = (spgConfigOut *) PG_GETARG_POINTER(1);
+
+  Oid stbox_oid = type_oid(T_STBOX);
+  cfg->prefixType = FLOAT8OID;  /* The cutoff value */
+  cfg->labelType = INT2OID;     /* The dimension of the split */
+  cfg->leafType = stbox_oid;
+  cfg->canReturnData = false;
+  cfg->longValuesOK = false;
+
+  PG_RETURN_VOID();
+}
+
+PG_FUNCTION_INFO_V1(stbox_kdtree_choose);
+/**
+ * SP-GiST choose function for the k-d tree of temporal points
+ */
+PGDLLEXPORT Datum
+stbox_kdtree_choose(PG_FUNCTION_ARGS)
+{
+  spgChooseIn *in = (spgChooseIn *) PG_GETARG_POINTER(0);
+  spgChooseOut *out = (spgChooseOut *) PG_GETARG_POINTER(1);
+  STBOX *box = DatumGetSTboxP(in->leafDatum);
+
+  out->resultType = spgMatchNode;
+  out->result.matchNode.levelAdd = 1;
+  out->result.matchNode.restDatum = PointerGetDatum(box);
+
+  /* nodeN will be set by core, when allTheSame. */
+  if (!in->allTheSame)
+  {
+    int dim = DatumGetInt16(in->nodeLabels[0]);
+    double cutoff = DatumGetFloat8(in->prefixDatum);
+    out->result.matchNode.nodeN = (kdtree_coord(box, dim) > cutoff) ? 1 : 0;
+  }
+
+  PG_RETURN_VOID();
+}
+
+PG_FUNCTION_INFO_V1(stbox_kdtree_picksplit);
+/**
+ * SP-GiST pick-split function for the k-d tree of temporal points
+ *
+ * It splits a list of boxes in two halves by the median of their
+ * coordinates in one dimension. The dimensions are visited in cyclic order
+ * starting from the level of the inner tuple, and the first one in which
+ * the boxes do not have all the same value is chosen.
+ */
+PGDLLEXPORT Datum
+stbox_kdtree_picksplit(PG_FUNCTION_ARGS)
+{
+  spgPickSplitIn *in = (spgPickSplitIn *) PG_GETARG_POINTER(0);
+  spgPickSplitOut *out = (spgPickSplitOut *) PG_GETARG_POINTER(1);
+  double *coords = palloc(sizeof(double) * in->nTuples);
+  double cutoff;
+  int dim = 0, median, i, k;
+
+  for (k = 0; k < KDTREE_NDIMS; k++)
+  {
+    dim = (in->level + k) % KDTREE_NDIMS;
+    for (i = 0; i < in->nTuples; i++)
+      coords[i] = kdtree_coord(DatumGetSTboxP(in->datums[i]), dim);
+    qsort(coords, (size_t) in->nTuples, sizeof(double), compareDoubles);
+    if (coords[0] < coords[in->nTuples - 1])
+      break;
+  }
+
+  /* Ensure that the second node is not empty when there are duplicates */
+  median = (in->nTuples - 1) / 2;
+  while (median > 0 && coords[median] == coords[in->nTuples - 1])
+    median--;
+  cutoff = coords[median];
+
+  /* Fill the output */
+  out->hasPrefix = true;
+  out->prefixDatum = Float8GetDatum(cutoff);
+
+  out->nNodes = 2;
+  out->nodeLabels = palloc(sizeof(Datum) * 2);
+  out->nodeLabels[0] = out->nodeLabels[1] = Int16GetDatum(dim);
+
+  out->mapTuplesToNodes = palloc(sizeof(int) * in->nTuples);
+  out->leafTupleDatums = palloc(sizeof(Datum) * in->nTuples);
+  for (i = 0; i < in->nTuples; i++)
+  {
+    STBOX *box = DatumGetSTboxP(in->datums[i]);
+    out->leafTupleDatums[i] = STboxPGetDatum(box);
+    out->mapTuplesToNodes[i] = (kdtree_coord(box, dim) > cutoff) ? 1 : 0;
+  }
+
+  pfree(coords);
+
+  PG_RETURN_VOID();
+}
+
+PG_FUNCTION_INFO_V1(stbox_kdtree_inner_consistent);
+/**
+ * SP-GiST inner consistent function for the k-d tree of temporal points
+ */
+PGDLLEXPORT Datum
+stbox_kdtree_inner_consistent(PG_FUNCTION_ARGS)
+{
+  spgInnerConsistentIn *in = (spgInnerConsistentIn *) PG_GETARG_POINTER(0);
+  spgInnerConsistentOut *out = (spgInnerConsistentOut *) PG_GETARG_POINTER(1);
+  int  i, node, dim = 0;
+  double cutoff = 0;
+  MemoryContext old_ctx;
+  CubeSTbox *cube_box;
+  STBOX *queries = NULL;
+#if MOBDB_PGSQL_VERSION >= 120000
+  STBOX *orderbys = NULL;
+#endif
+
+  /*
+   * We are saving the traversal value or initialize it an unbounded one, if
+   * we have just begun to walk the tree. Since the prefix does not have the
+   * flags of the boxes, the distance is computed on the X and Y dimensions,
+   * which is still a lower bound of the distance.
+   */
+  old_ctx = MemoryContextSwitchTo(in->traversalMemoryContext);
+  if (in->traversalValue)
+    cube_box = in->traversalValue;
+  else
+  {
+    STBOX box;
+    memset(&box, 0, sizeof(STBOX));
+    cube_box = initCubeSTbox(&box);
+  }
+  MemoryContextSwitchTo(old_ctx);
+
+  if (! in->allTheSame)
+  {
+    cutoff = DatumGetFloat8(in->prefixDatum);
+    dim = DatumGetInt16(in->nodeLabels[0]);
+    queries = spgist_query_boxes(in);
+  }
+#if MOBDB_PGSQL_VERSION >= 120000
+  if (in->norderbys > 0)
+    orderbys = spgist_orderby_boxes(in->orderbys, in->norderbys);
+#endif
+
+  /* Allocate enough memory for nodes */
+  out->nNodes = 0;
+  out->nodeNumbers = (int *) palloc(sizeof(int) * in->nNodes);
+  out->traversalValues = (void **) palloc(sizeof(void *) * in->nNodes);
+#if MOBDB_PGSQL_VERSION >= 120000
+  if (in->norderbys > 0)
+    out->distances = (double **) palloc(sizeof(double *) * in->nNodes);
+#endif
+
+  for (node = 0; node < in->nNodes; node++)
+  {
+    CubeSTbox *next_cube_box;
+    bool flag = true;
+
+    old_ctx = MemoryContextSwitchTo(in->traversalMemoryContext);
+    if (in->allTheSame)
+    {
+      /* Report that all nodes should be visited */
+      next_cube_box = palloc(sizeof(CubeSTbox));
+      memcpy(next_cube_box, cube_box, sizeof(CubeSTbox));
+    }
+    else
+      next_cube_box = kdtreeNextCubeSTbox(cube_box, dim, cutoff, node);
+    MemoryContextSwitchTo(old_ctx);
+
+    for (i = 0; ! in->allTheSame && i < in->nkeys; i++)
+    {
+      flag = cube_box_consistent(next_cube_box, &queries[i],
+        in->scankeys[i].sk_strategy);
+      /* If any check is failed, we have found our answer. */
+      if (!flag)
+        break;
+    }
+
+    if (flag)
+    {
+      out->traversalValues[out->nNodes] = next_cube_box;
+      out->nodeNumbers[out->nNodes] = node;
+#if MOBDB_PGSQL_VERSION >= 120000
+      if (in->norderbys > 0)
+      {
+        double *distances = palloc(sizeof(double) * in->norderbys);
+        out->distances[out->nNodes] = distances;
+        for (int j = 0; j < in->norderbys; j++)
+          distances[j] = distanceBoxCubeBox(&orderbys[j], next_cube_box);
+      }
+#endif
+      out->nNodes++;
+    }
+    else
+      pfree(next_cube_box);
+  }
+
+  if (queries)
+    pfree(queries);
+#if MOBDB_PGSQL_VERSION >= 120000
+  if (orderbys)
+    pfree(orderbys);
+#endif
 
   PG_RETURN_VOID();
 }
@@ -861,9 +1180,6 @@ stbox_spgist_leaf_consistent(PG_FUNCTION_ARGS)
 {
   spgLeafConsistentIn *in = (spgLeafConsistentIn *) PG_GETARG_POINTER(0);
   spgLeafConsistentOut *out = (spgLeafConsistentOut *) PG_GETARG_POINTER(1);
-#if MOBDB_PGSQL_VERSION >= 120000
-  Datum leaf = in->leafDatum;
-#endif
   STBOX *key = DatumGetSTboxP(in->leafDatum);
   bool res = true;
   int i;
@@ -900,8 +1216,7 @@ stbox_spgist_leaf_consistent(PG_FUNCTION_ARGS)
     }
     else if (tgeo_type(subtype))
     {
-      temporal_bbox(&query,
-        DatumGetTemporal(in->scankeys[i].sk_argument));
+      temporal_bbox_slice(&query, in->scankeys[i].sk_argument);
       res = stbox_index_consistent_leaf(key, &query, strategy);
     }
     else
@@ -915,8 +1230,11 @@ stbox_spgist_leaf_consistent(PG_FUNCTION_ARGS)
 #if MOBDB_PGSQL_VERSION >= 120000
   if (res && in->norderbys > 0)
   {
-    out->distances = spg_key_orderbys_distances(leaf, false, in->orderbys,
-      in->norderbys);
+    STBOX *orderbys = spgist_orderby_boxes(in->orderbys, in->norderbys);
+    out->distances = palloc(sizeof(double) * in->norderbys);
+    for (i = 0; i < in->norderbys; i++)
+      out->distances[i] = stbox_index_distance(key, &orderbys[i]);
+    pfree(orderbys);
     /* Recheck is necessary when computing distance with bounding boxes */
     out->recheckDistances = true;
   }
@@ -936,10 +1254,8 @@ PG_FUNCTION_INFO_V1(tpoint_spgist_compress);
 PGDLLEXPORT Datum
 tpoint_spgist_compress(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
   STBOX *result = palloc0(sizeof(STBOX));
-  temporal_bbox(result, temp);
-  PG_FREE_IF_COPY(temp, 0);
+  temporal_bbox_slice(result, PG_GETARG_DATUM(0));
   PG_RETURN_STBOX_P(result);
 }
 #endif
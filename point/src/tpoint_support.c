@@ -0,0 +1,350 @@
+/*****************************************************************************
+ *
+ * tpoint_support.c
+ *    Planner support functions for the spatial relationships of temporal
+ *    points.
+ *
+ * For PostgreSQL 12 and later, the spatial relationships such as
+ * intersects(trip, geom) or dwithin(trip, geom, 50) are declared with the
+ * planner support function in this file. The function derives from the
+ * call a lossy bounding box index condition, e.g., trip && geom or
+ * trip && ST_Expand(geom, 50), so that the indexes on temporal points are
+ * used without the condition being written explicitly in the query, and
+ * estimates the selectivity of the call from the selectivity of this
+ * condition.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_support.h"
+
+#if MOBDB_PGSQL_VERSION >= 120000
+
+#include <access/stratnum.h>
+#include <nodes/makefuncs.h>
+#include <nodes/nodeFuncs.h>
+#include <nodes/supportnodes.h>
+#include <optimizer/optimizer.h>
+#include <parser/parse_func.h>
+#include <utils/lsyscache.h>
+
+#include "oidcache.h"
+#include "temporal.h"
+#include "tpoint_selfuncs.h"
+
+/*****************************************************************************
+ * Spatial relationships with a bounding box index condition
+ *****************************************************************************/
+
+/**
+ * Structure describing the bounding box condition implied by a spatial
+ * relationship
+ */
+typedef struct
+{
+  const char *name;          /**< Name of the relationship */
+  StrategyNumber strategy;   /**< Strategy when the first argument is indexed */
+  StrategyNumber commstrategy; /**< Strategy when the second argument is indexed */
+  bool expand;               /**< True when the bounding box of the other
+                                  argument is expanded by the distance */
+} TPointSupportRel;
+
+/**
+ * The spatial relationships and the bounding box operators they imply.
+ * The relationships disjoint and relate do not imply any condition.
+ */
+static const TPointSupportRel TPOINT_SUPPORT_RELS[] =
+{
+  {"contains", RTContainsStrategyNumber, RTContainedByStrategyNumber, false},
+  {"containsproperly", RTContainsStrategyNumber, RTContainedByStrategyNumber, false},
+  {"covers", RTContainsStrategyNumber, RTContainedByStrategyNumber, false},
+  {"coveredby", RTContainedByStrategyNumber, RTContainsStrategyNumber, false},
+  {"within", RTContainedByStrategyNumber, RTContainsStrategyNumber, false},
+  {"equals", RTSameStrategyNumber, RTSameStrategyNumber, false},
+  {"crosses", RTOverlapStrategyNumber, RTOverlapStrategyNumber, false},
+  {"intersects", RTOverlapStrategyNumber, RTOverlapStrategyNumber, false},
+  {"overlaps", RTOverlapStrategyNumber, RTOverlapStrategyNumber, false},
+  {"touches", RTOverlapStrategyNumber, RTOverlapStrategyNumber, false},
+  {"dwithin", RTOverlapStrategyNumber, RTOverlapStrategyNumber, true}
+};
+
+#define TPOINT_SUPPORT_NRELS \
+  (sizeof(TPOINT_SUPPORT_RELS) / sizeof(TPointSupportRel))
+
+/**
+ * Returns the description of the spatial relationship of the function,
+ * or NULL if the function is not a spatial relationship with an index
+ * condition
+ */
+static const TPointSupportRel *
+tpoint_support_rel(Oid funcid)
+{
+  char *name = get_func_name(funcid);
+  if (name == NULL)
+    return NULL;
+  for (size_t i = 0; i < TPOINT_SUPPORT_NRELS; i++)
+  {
+    if (strcmp(name, TPOINT_SUPPORT_RELS[i].name) == 0)
+    {
+      pfree(name);
+      return &TPOINT_SUPPORT_RELS[i];
+    }
+  }
+  pfree(name);
+  return NULL;
+}
+
+/**
+ * Returns true if the function is a spatial relationship that implies that
+ * the bounding boxes of its arguments overlap, and sets the last argument
+ * to true if the bounding box of one argument must be expanded by the
+ * distance given as third argument
+ */
+bool
+tpoint_support_overlaps(Oid funcid, bool *expand)
+{
+  const TPointSupportRel *rel = tpoint_support_rel(funcid);
+  if (rel == NULL)
+    return false;
+  *expand = rel->expand;
+  return true;
+}
+
+/**
+ * Returns the cached type of the argument of a spatial relationship
+ */
+static bool
+tpoint_support_type(Oid typid, CachedType *type)
+{
+  if (typid == type_oid(T_GEOMETRY))
+    *type = T_GEOMETRY;
+  else if (typid == type_oid(T_GEOGRAPHY))
+    *type = T_GEOGRAPHY;
+  else if (typid == type_oid(T_TGEOMPOINT))
+    *type = T_TGEOMPOINT;
+  else if (typid == type_oid(T_TGEOGPOINT))
+    *type = T_TGEOGPOINT;
+  else
+    return false;
+  return true;
+}
+
+/**
+ * Returns the cached operator corresponding to the strategy number
+ */
+static CachedOp
+tpoint_support_cachedop(StrategyNumber strategy)
+{
+  switch (strategy)
+  {
+    case RTContainsStrategyNumber:
+      return CONTAINS_OP;
+    case RTContainedByStrategyNumber:
+      return CONTAINED_OP;
+    case RTSameStrategyNumber:
+      return SAME_OP;
+    default: /* RTOverlapStrategyNumber */
+      return OVERLAPS_OP;
+  }
+}
+
+/**
+ * Returns a call to the function of the extension with the name and the
+ * arguments, or NULL if the function does not exist
+ */
+static Node *
+tpoint_support_call(Oid funcid, const char *name, List *args)
+{
+  int nargs = list_length(args);
+  Oid argtypes[2];
+  ListCell *lc;
+  int i = 0;
+  foreach (lc, args)
+    argtypes[i++] = exprType((Node *) lfirst(lc));
+  /* The function is in the schema of the extension */
+  char *nspname = get_namespace_name(get_func_namespace(funcid));
+  Oid callid = LookupFuncName(list_make2(makeString(nspname),
+    makeString(pstrdup(name))), nargs, argtypes, true);
+  if (! OidIsValid(callid))
+    return NULL;
+  return (Node *) makeFuncExpr(callid, get_func_rettype(callid), args,
+    InvalidOid, InvalidOid, COERCE_EXPLICIT_CALL);
+}
+
+/**
+ * Returns the bounding box of the other argument of dwithin expanded by
+ * the distance, or NULL if it cannot be computed
+ *
+ * The expansion is the one of the SQL definition of dwithin in previous
+ * versions of PostgreSQL, that is, ST_Expand for geometries and _ST_Expand
+ * for geographies. The bounding box of a temporal geometry point is
+ * expanded with expandSpatial, while there is no expansion in meters of the
+ * bounding box of a temporal geography point.
+ */
+static Node *
+tpoint_support_expand(Oid funcid, Node *other, Node *dist, CachedType type)
+{
+  if (type == T_GEOMETRY)
+    return tpoint_support_call(funcid, "st_expand", list_make2(other, dist));
+  if (type == T_GEOGRAPHY)
+    return tpoint_support_call(funcid, "_st_expand", list_make2(other, dist));
+  if (type == T_TGEOMPOINT)
+  {
+    Node *box = tpoint_support_call(funcid, "stbox", list_make1(other));
+    if (box == NULL)
+      return NULL;
+    return tpoint_support_call(funcid, "expandspatial", list_make2(box, dist));
+  }
+  return NULL;
+}
+
+/**
+ * Returns true if the expression can be compared with the index, that is,
+ * if it does not reference the relation of the index and does not contain
+ * volatile functions
+ */
+static bool
+tpoint_support_pseudoconst(SupportRequestIndexCondition *req, Node *expr)
+{
+#if MOBDB_PGSQL_VERSION >= 140000
+  Relids relids = pull_varnos(req->root, expr);
+#else
+  Relids relids = pull_varnos(expr);
+#endif
+  if (bms_is_member(req->index->rel->relid, relids))
+    return false;
+  return ! contain_volatile_functions(expr);
+}
+
+/**
+ * Returns the bounding box index condition of the spatial relationship
+ */
+static List *
+tpoint_support_indexcond(SupportRequestIndexCondition *req,
+  const TPointSupportRel *rel)
+{
+  List *args;
+  if (IsA(req->node, FuncExpr))
+    args = ((FuncExpr *) req->node)->args;
+  else
+    return NIL;
+  if (req->indexarg > 1 || list_length(args) != (rel->expand ? 3 : 2))
+    return NIL;
+
+  Node *indexed = (Node *) list_nth(args, req->indexarg);
+  Node *other = (Node *) list_nth(args, 1 - req->indexarg);
+  if (! tpoint_support_pseudoconst(req, other))
+    return NIL;
+  CachedType indextype, othertype;
+  if (! tpoint_support_type(exprType(indexed), &indextype) ||
+    ! tpoint_support_type(exprType(other), &othertype))
+    return NIL;
+
+  /* The spatial relationships between two temporal points are applied to
+   * their trajectories restricted to their common time frame. The only
+   * condition implied on their bounding boxes is thus that they overlap */
+  bool tpoints = (indextype == T_TGEOMPOINT || indextype == T_TGEOGPOINT) &&
+    (othertype == T_TGEOMPOINT || othertype == T_TGEOGPOINT);
+  StrategyNumber strategy = tpoints ? RTOverlapStrategyNumber :
+    (req->indexarg == 0 ? rel->strategy : rel->commstrategy);
+  if (rel->expand)
+  {
+    Node *dist = (Node *) lthird(args);
+    if (! tpoint_support_pseudoconst(req, dist))
+      return NIL;
+    other = tpoint_support_expand(req->funcid, other, dist, othertype);
+    if (other == NULL)
+      return NIL;
+  }
+
+  Oid opno = get_opfamily_member(req->opfamily, exprType(indexed),
+    exprType(other), strategy);
+  if (! OidIsValid(opno))
+    return NIL;
+  Expr *cond = make_opclause(opno, BOOLOID, false, (Expr *) indexed,
+    (Expr *) other, InvalidOid, req->indexcollation);
+  /* The index condition is only a necessary condition */
+  req->lossy = true;
+  return list_make1(cond);
+}
+
+/**
+ * Returns the selectivity of the spatial relationship, which is estimated
+ * as the one of its bounding box condition
+ */
+static Selectivity
+tpoint_support_selectivity(SupportRequestSelectivity *req,
+  const TPointSupportRel *rel)
+{
+  if (list_length(req->args) != (rel->expand ? 3 : 2))
+    return FALLBACK_ND_SEL;
+  Node *arg1 = (Node *) linitial(req->args);
+  Node *arg2 = (Node *) lsecond(req->args);
+  CachedType type1, type2;
+  if (! tpoint_support_type(exprType(arg1), &type1) ||
+    ! tpoint_support_type(exprType(arg2), &type2))
+    return FALLBACK_ND_SEL;
+  bool tpoints = (type1 == T_TGEOMPOINT || type1 == T_TGEOGPOINT) &&
+    (type2 == T_TGEOMPOINT || type2 == T_TGEOGPOINT);
+  CachedOp op = tpoints ? OVERLAPS_OP :
+    tpoint_support_cachedop(rel->strategy);
+  Oid opno = oper_oid(op, type1, type2);
+  if (! OidIsValid(opno))
+    return FALLBACK_ND_SEL;
+
+  List *args = list_make2(arg1, arg2);
+  Datum result;
+  if (req->is_join)
+    result = DirectFunctionCall5(tpoint_joinsel, PointerGetDatum(req->root),
+      ObjectIdGetDatum(opno), PointerGetDatum(args),
+      Int16GetDatum(req->jointype), PointerGetDatum(req->sjinfo));
+  else
+    result = DirectFunctionCall4(tpoint_sel, PointerGetDatum(req->root),
+      ObjectIdGetDatum(opno), PointerGetDatum(args),
+      Int32GetDatum(req->varRelid));
+  return DatumGetFloat8(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_supportfn);
+/**
+ * Planner support function for the spatial relationships of temporal points
+ *
+ * On a request for an index condition, e.g., for intersects(trip, geom),
+ * the function returns the lossy condition trip && geom when the index on
+ * trip supports the operator. On a request for the selectivity, the
+ * function returns the selectivity estimated for this condition.
+ */
+PGDLLEXPORT Datum
+tpoint_supportfn(PG_FUNCTION_ARGS)
+{
+  Node *rawreq = (Node *) PG_GETARG_POINTER(0);
+  if (IsA(rawreq, SupportRequestIndexCondition))
+  {
+    SupportRequestIndexCondition *req =
+      (SupportRequestIndexCondition *) rawreq;
+    const TPointSupportRel *rel = tpoint_support_rel(req->funcid);
+    if (rel == NULL)
+      PG_RETURN_POINTER(NULL);
+    List *result = tpoint_support_indexcond(req, rel);
+    PG_RETURN_POINTER(result);
+  }
+  if (IsA(rawreq, SupportRequestSelectivity))
+  {
+    SupportRequestSelectivity *req = (SupportRequestSelectivity *) rawreq;
+    const TPointSupportRel *rel = tpoint_support_rel(req->funcid);
+    if (rel == NULL)
+      PG_RETURN_POINTER(NULL);
+    req->selectivity = tpoint_support_selectivity(req, rel);
+    CLAMP_PROBABILITY(req->selectivity);
+    PG_RETURN_POINTER(req);
+  }
+  PG_RETURN_POINTER(NULL);
+}
+
+#endif /* MOBDB_PGSQL_VERSION >= 120000 */
+
+/*****************************************************************************/
@@ -27,6 +27,8 @@
 
 #include "tpoint_tempspatialrels.h"
 
+#include <math.h>
+#include <funcapi.h>
 #include <utils/timestamp.h>
 
 #include "period.h"
@@ -35,6 +37,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_argcache.h"
 #include "tbool_boolops.h"
 #include "lifting.h"
 #include "tpoint.h"
@@ -189,6 +192,20 @@ tpointseq_intersection_instants(const TInstant *inst1, const TInstant *inst2,
  * intersection function in PostGIS that is only available for geometries.
  *****************************************************************************/
 
+/**
+ * Returns true if the bounding box of the segment defined by the two
+ * instants does not intersect the 2D bounding box of the geometry
+ */
+static bool
+tpointseg_gbox_disjoint(const TInstant *inst1, const TInstant *inst2,
+  const GBOX *box)
+{
+  const POINT2D *p1 = datum_get_point2d_p(tinstant_value(inst1));
+  const POINT2D *p2 = datum_get_point2d_p(tinstant_value(inst2));
+  return (Max(p1->x, p2->x) < box->xmin || Min(p1->x, p2->x) > box->xmax ||
+    Max(p1->y, p2->y) < box->ymin || Min(p1->y, p2->y) > box->ymax);
+}
+
 /**
  * Returns the temporal spatial relationship between a segment of a
  * temporal sequence point and a geometry.
@@ -362,24 +379,67 @@ tspatialrel_tpointseq_geo2(TSequence *seq, Datum geo, Datum param,
   }
 
   /* General case */
+  /* The segments whose bounding box does not intersect the one of the
+   * geometry are in the exterior of the geometry, where the relationship
+   * has a single value. This value is computed once and each run of such
+   * consecutive segments is settled by a single sequence without computing
+   * the intersections */
+  GBOX box;
+  bool hasbox = (gserialized_get_gbox_p((GSERIALIZED *) DatumGetPointer(geo),
+    &box) == LW_SUCCESS);
+  Datum extvalue = (Datum) 0;
+  bool hasextvalue = false;
   TSequence ***sequences = palloc(sizeof(TSequence *) * seq->count);
   int *countseqs = palloc0(sizeof(int) * seq->count);
-  int totalseqs = 0;
+  int totalseqs = 0, k = 0;
   inst1 = tsequence_inst_n(seq, 0);
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
   bool lower_inc = seq->period.lower_inc;
-  for (int i = 0; i < seq->count - 1; i++)
+  int i = 0;
+  while (i < seq->count - 1)
   {
     inst2 = tsequence_inst_n(seq, i + 1);
-    bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
-    sequences[i] = tspatialrel_tpointseq_geo1(inst1, inst2, linear, geo,
-      param, lower_inc, upper_inc, lfinfo, &countseqs[i]);
-    totalseqs += countseqs[i];
+    if (hasbox && tpointseg_gbox_disjoint(inst1, inst2, &box))
+    {
+      /* Extend the run of segments in the exterior of the geometry */
+      while (i < seq->count - 2 &&
+        tpointseg_gbox_disjoint(inst2, tsequence_inst_n(seq, i + 2), &box))
+      {
+        i++;
+        inst2 = tsequence_inst_n(seq, i + 1);
+      }
+      if (! hasextvalue)
+      {
+        Datum value1 = tinstant_value(inst1);
+        extvalue = lfinfo.invert ? spatialrel(geo, value1, param, lfinfo) :
+          spatialrel(value1, geo, param, lfinfo);
+        hasextvalue = true;
+      }
+      bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
+      TInstant *instants[2];
+      instants[0] = tinstant_make(extvalue, inst1->t, lfinfo.restypid);
+      instants[1] = tinstant_make(extvalue, inst2->t, lfinfo.restypid);
+      sequences[k] = palloc(sizeof(TSequence *));
+      sequences[k][0] = tsequence_make(instants, 2, lower_inc, upper_inc,
+        STEP, NORMALIZE_NO);
+      pfree(instants[0]); pfree(instants[1]);
+      countseqs[k] = 1;
+    }
+    else
+    {
+      bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
+      sequences[k] = tspatialrel_tpointseq_geo1(inst1, inst2, linear, geo,
+        param, lower_inc, upper_inc, lfinfo, &countseqs[k]);
+    }
+    totalseqs += countseqs[k++];
     inst1 = inst2;
     lower_inc = true;
+    i++;
   }
+  if (hasextvalue)
+    DATUM_FREE(extvalue, lfinfo.restypid);
   *count = totalseqs;
-  return tsequencearr2_to_tsequencearr(sequences, countseqs, seq->count,
+  return tsequencearr2_to_tsequencearr(sequences, countseqs, k,
     totalseqs);
 }
 
@@ -500,10 +560,25 @@ tdwithin_tpointseq_geo1(TSequence *seq, Datum geo, Datum dist, int *count)
     return result;
   }
 
-  /* Restrict to the buffered geometry */
-  Datum geo_buffer = call_function2(buffer, geo, dist);
-  int count1;
-  TSequence **atbuffer = tpointseq_at_geometry2(seq, geo_buffer, &count1);
+  /* If the bounding box of the sequence does not intersect the one of the
+   * geometry expanded by the distance, the result is false at every instant
+   * and the buffered geometry is not computed. Otherwise, restrict to the
+   * buffered geometry, which skips the segments far away from it */
+  const STBOX *seqbox = tsequence_bbox_ptr(seq);
+  double d = DatumGetFloat8(dist);
+  GBOX box;
+  bool isfar = (gserialized_get_gbox_p((GSERIALIZED *) DatumGetPointer(geo),
+    &box) == LW_SUCCESS) && (seqbox->xmax < box.xmin - d ||
+    seqbox->xmin > box.xmax + d || seqbox->ymax < box.ymin - d ||
+    seqbox->ymin > box.ymax + d);
+  int count1 = 0;
+  TSequence **atbuffer = NULL;
+  if (! isfar)
+  {
+    Datum geo_buffer = call_function2(buffer, geo, dist);
+    atbuffer = tpointseq_at_geometry2(seq, geo_buffer, &count1);
+    pfree(DatumGetPointer(geo_buffer));
+  }
   Datum datum_true = BoolGetDatum(true);
   Datum datum_false = BoolGetDatum(false);
   /* We create two temporal instants with arbitrary values that are set in
@@ -708,106 +783,103 @@ tgeompoint '[POINT(4 3)@2000-01-04, POINT(5 3)@2000-01-05]', 1)
 
  *****************************************************************************/
 
+/**
+ * Computes for all the segments of two synchronized temporal points the
+ * coefficients of the quadratic equation a t^2 + b t + c = 0 stating that
+ * the distance between the segments at the time t, shifted to [0, 1], is
+ * equal to the given distance
+ *
+ * The coordinates of the instants are first gathered into arrays so that
+ * the coefficients are then computed in loops without branches nor function
+ * calls that the compiler can vectorize. The end point of a segment with
+ * step interpolation is its start point.
+ *
+ * @param[in] seq1,seq2 Temporal points
+ * @param[in] dist Distance
+ * @param[out] coeffs Array of size 3 * (seq1->count - 1) on which the
+ * coefficients a, b, and c of the segments are stored one after the other
+ * @pre The temporal points must be synchronized and have at least 2 instants
+ */
+static void
+tdwithin_tpointseq_tpointseq_coeffs(const TSequence *seq1,
+  const TSequence *seq2, double dist, double *coeffs)
+{
+  int n = seq1->count;
+  bool hasz = MOBDB_FLAGS_GET_Z(seq1->flags);
+  int dims = hasz ? 3 : 2;
+  /* Coordinates of the instants of the first and second points: all x,
+   * then all y, then all z values */
+  double *coords1 = palloc(sizeof(double) * dims * n * 2);
+  double *coords2 = coords1 + dims * n;
+  for (int i = 0; i < n; i++)
+  {
+    Datum value1 = tinstant_value(tsequence_inst_n(seq1, i));
+    Datum value2 = tinstant_value(tsequence_inst_n(seq2, i));
+    if (hasz)
+    {
+      const POINT3DZ *p1 = datum_get_point3dz_p(value1);
+      const POINT3DZ *p2 = datum_get_point3dz_p(value2);
+      coords1[i] = p1->x; coords1[n + i] = p1->y; coords1[2 * n + i] = p1->z;
+      coords2[i] = p2->x; coords2[n + i] = p2->y; coords2[2 * n + i] = p2->z;
+    }
+    else
+    {
+      const POINT2D *p1 = datum_get_point2d_p(value1);
+      const POINT2D *p2 = datum_get_point2d_p(value2);
+      coords1[i] = p1->x; coords1[n + i] = p1->y;
+      coords2[i] = p2->x; coords2[n + i] = p2->y;
+    }
+  }
+  /* The displacement of a segment with step interpolation is zero */
+  double lin1 = MOBDB_FLAGS_GET_LINEAR(seq1->flags) ? 1.0 : 0.0;
+  double lin2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags) ? 1.0 : 0.0;
+  double *a = coeffs, *b = coeffs + (n - 1), *c = coeffs + 2 * (n - 1);
+  memset(coeffs, 0, sizeof(double) * 3 * (n - 1));
+  for (int d = 0; d < dims; d++)
+  {
+    const double *v1 = coords1 + d * n;
+    const double *v2 = coords2 + d * n;
+    for (int i = 0; i < n - 1; i++)
+    {
+      /* Per segment functions v1(t) = a1 * t + c1 and v2(t) = a2 * t + c2 */
+      double da = lin1 * (v1[i + 1] - v1[i]) - lin2 * (v2[i + 1] - v2[i]);
+      double dc = v1[i] - v2[i];
+      a[i] += da * da;
+      b[i] += 2 * da * dc;
+      c[i] += dc * dc;
+    }
+  }
+  /* Distance function = dist */
+  for (int i = 0; i < n - 1; i++)
+    c[i] -= dist * dist;
+  pfree(coords1);
+  return;
+}
+
 /**
  * Returns the timestamps at which the segments of the two temporal points
  * are within the given distance
  *
- * @param[in] sv1,ev1 Points defining the first segment
- * @param[in] sv2,ev2 Points defining the second segment
+ * @param[in] sv1,sv2 Start points of the segments
+ * @param[in] coeffs Coefficients a, b, and c of the quadratic equation
+ * computed by function tdwithin_tpointseq_tpointseq_coeffs
  * @param[in] lower,upper Timestamps associated to the segments
  * @param[in] dist Distance
- * @param[in] hasz True for 3D segments
  * @param[in] func Distance function (2D or 3D)
  * @param[out] t1,t2 Resulting timestamps
  * @result Number of timestamps in the result, between 0 and 2. In the case
  * of a single result both t1 and t2 are set to the unique timestamp
  */
 static int
-tdwithin_tpointseq_tpointseq1(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
-  TimestampTz lower, TimestampTz upper, double dist, bool hasz,
+tdwithin_tpointseq_tpointseq1(Datum sv1, Datum sv2, const double coeffs[3],
+  TimestampTz lower, TimestampTz upper, double dist,
   Datum (*func)(Datum, Datum, Datum), TimestampTz *t1, TimestampTz *t2)
 {
   /* To reduce problems related to floating point arithmetic, lower and upper
    * are shifted, respectively, to 0 and 1 before computing the solutions
    * of the quadratic equation */
   double duration = upper - lower;
-  long double a, b, c;
-  if (hasz) /* 3D */
-  {
-    const POINT3DZ *p1 = datum_get_point3dz_p(sv1);
-    const POINT3DZ *p2 = datum_get_point3dz_p(ev1);
-    const POINT3DZ *p3 = datum_get_point3dz_p(sv2);
-    const POINT3DZ *p4 = datum_get_point3dz_p(ev2);
-
-    /* per1 functions
-     * x(t) = a1 * t + c1
-     * y(t) = a2 * t + c2
-    * z(t) = a3 * t + c3 */
-    double a1 = (p2->x - p1->x);
-    double c1 = p1->x;
-    double a2 = (p2->y - p1->y);
-    double c2 = p1->y;
-    double a3 = (p2->z - p1->z);
-    double c3 = p1->z;
-
-    /* per2 functions
-     * x(t) = a4 * t + c4
-     * y(t) = a5 * t + c5
-     * z(t) = a6 * t + c6 */
-    double a4 = (p4->x - p3->x);
-    double c4 = p3->x;
-    double a5 = (p4->y - p3->y);
-    double c5 = p3->y;
-    double a6 = (p4->z - p3->z);
-    double c6 = p3->z;
-
-    /* compute the distance function */
-    double a_x = (a1 - a4) * (a1 - a4);
-    double a_y = (a2 - a5) * (a2 - a5);
-    double a_z = (a3 - a6) * (a3 - a6);
-    double b_x = 2 * (a1 - a4) * (c1 - c4);
-    double b_y = 2 * (a2 - a5) * (c2 - c5);
-    double b_z = 2 * (a3 - a6) * (c3 - c6);
-    double c_x = (c1 - c4) * (c1 - c4);
-    double c_y = (c2 - c5) * (c2 - c5);
-    double c_z = (c3 - c6) * (c3 - c6);
-    /* distance function = dist */
-    a = a_x + a_y + a_z;
-    b = b_x + b_y + b_z;
-    c = c_x + c_y + c_z - (dist * dist);
-  }
-  else /* 2D */
-  {
-    const POINT2D *p1 = datum_get_point2d_p(sv1);
-    const POINT2D *p2 = datum_get_point2d_p(ev1);
-    const POINT2D *p3 = datum_get_point2d_p(sv2);
-    const POINT2D *p4 = datum_get_point2d_p(ev2);
-    /* per1 functions
-     * x(t) = a1 * t + c1
-     * y(t) = a2 * t + c2 */
-    double a1 = (p2->x - p1->x);
-    double c1 = p1->x;
-    double a2 = (p2->y - p1->y);
-    double c2 = p1->y;
-    /* per2 functions
-     * x(t) = a3 * t + c3
-     * y(t) = a4 * t + c4 */
-    double a3 = (p4->x - p3->x);
-    double c3 = p3->x;
-    double a4 = (p4->y - p3->y);
-    double c4 = p3->y;
-    /* compute the distance function */
-    double a_x = (a1 - a3) * (a1 - a3);
-    double a_y = (a2 - a4) * (a2 - a4);
-    double b_x = 2 * (a1 - a3) * (c1 - c3);
-    double b_y = 2 * (a2 - a4) * (c2 - c4);
-    double c_x = (c1 - c3) * (c1 - c3);
-    double c_y = (c2 - c4) * (c2 - c4);
-    /* distance function = dist */
-    a = a_x + a_y;
-    b = b_x + b_y;
-    c = c_x + c_y - (dist * dist);
-  }
+  long double a = coeffs[0], b = coeffs[1], c = coeffs[2];
   /* They are parallel, moving in the same direction at the same speed */
   if (a == 0)
   {
@@ -898,7 +970,14 @@ tdwithin_tpointseq_tpointseq2(TSequence **result, const TSequence *seq1,
   int k = 0;
   bool linear1 = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
   bool linear2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags);
-  bool hasz = MOBDB_FLAGS_GET_Z(seq1->flags);
+  /* The coefficients of all the segments are computed at once */
+  double *coeffs = NULL;
+  if (linear1 || linear2)
+  {
+    coeffs = palloc(sizeof(double) * 3 * (seq1->count - 1));
+    tdwithin_tpointseq_tpointseq_coeffs(seq1, seq2, DatumGetFloat8(dist),
+      coeffs);
+  }
   Datum sv1 = tinstant_value(start1);
   Datum sv2 = tinstant_value(start2);
   TimestampTz lower = start1->t;
@@ -943,10 +1022,11 @@ tdwithin_tpointseq_tpointseq2(TSequence **result, const TSequence *seq1,
     {
       /* Find the instants t1 and t2 (if any) during which the dwithin function is true */
       TimestampTz t1, t2;
-      Datum sev1 = linear1 ? ev1 : sv1;
-      Datum sev2 = linear2 ? ev2 : sv2;
-      int solutions = tdwithin_tpointseq_tpointseq1(sv1, sev1, sv2, sev2,
-        lower, upper, DatumGetFloat8(dist), hasz, func, &t1, &t2);
+      int nsegs = seq1->count - 1;
+      double segcoeffs[3] = { coeffs[i - 1], coeffs[nsegs + i - 1],
+        coeffs[2 * nsegs + i - 1] };
+      int solutions = tdwithin_tpointseq_tpointseq1(sv1, sv2, segcoeffs,
+        lower, upper, DatumGetFloat8(dist), func, &t1, &t2);
 
       /* <  F  > */
       bool upper_inc1 = linear1 && linear2 && upper_inc;
@@ -1000,6 +1080,8 @@ tdwithin_tpointseq_tpointseq2(TSequence **result, const TSequence *seq1,
     lower_inc = true;
   }
   pfree(instants[0]); pfree(instants[1]); pfree(instants[2]);
+  if (coeffs != NULL)
+    pfree(coeffs);
   return k;
 }
 
@@ -1055,6 +1137,26 @@ tdwithin_tpointseqset_tpointseqset(const TSequenceSet *ts1, const TSequenceSet *
  * Generic functions
  *****************************************************************************/
 
+/**
+ * Returns true if the two points are equal, the FmgrInfo passed as third
+ * argument by the generic functions is not used
+ */
+static Datum
+datum3_point_eq(Datum geopoint1, Datum geopoint2, Datum flinfo)
+{
+  return datum2_point_eq(geopoint1, geopoint2);
+}
+
+/**
+ * Returns true if the two points are different, the FmgrInfo passed as third
+ * argument by the generic functions is not used
+ */
+static Datum
+datum3_point_ne(Datum geopoint1, Datum geopoint2, Datum flinfo)
+{
+  return datum2_point_ne(geopoint1, geopoint2);
+}
+
 /**
  * Generic temporal spatial relationship for a geometry and a temporal point
  */
@@ -1093,15 +1195,23 @@ static Datum
 tspatialrel_geo_tpoint(FunctionCallInfo fcinfo, Datum (*func)(Datum, ...),
   int numparam, Oid restypid, bool withZ)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 0);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(0);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
-  Temporal *temp = PG_GETARG_TEMPORAL(1);
-  Datum param = (numparam == 3) ? PG_GETARG_DATUM(2) : (Datum) NULL;
-  Temporal *result = tspatialrel_tpoint_geo1(temp, gs, param, func, numparam,
+  ArgCacheEntry *tentry = argcache_temporal(fcinfo, 1);
+  Temporal *temp = (tentry != NULL) ?
+    (Temporal *) DatumGetPointer(tentry->value) : PG_GETARG_TEMPORAL(1);
+  /* The functions with 2 arguments receive the FmgrInfo used to call
+   * PostGIS as third argument */
+  Datum param = (numparam == 3) ? PG_GETARG_DATUM(2) :
+    PointerGetDatum(spatialrel_flinfo(fcinfo, false));
+  Temporal *result = tspatialrel_tpoint_geo1(temp, gs, param, func, 3,
     restypid, INVERT, withZ);
-  PG_FREE_IF_COPY(gs, 0);
-  PG_FREE_IF_COPY(temp, 1);
+  ARGCACHE_FREE_IF_COPY(gs, 0, gentry);
+  ARGCACHE_FREE_IF_COPY(temp, 1, tentry);
   PG_RETURN_POINTER(result);
 }
 
@@ -1118,15 +1228,23 @@ static Datum
 tspatialrel_tpoint_geo(FunctionCallInfo fcinfo, Datum (*func)(Datum, ...),
   int numparam, Oid restypid, bool withZ)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 1);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(1);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
-  Datum param = (numparam == 3) ? PG_GETARG_DATUM(2) : (Datum) NULL;
-  Temporal *result = tspatialrel_tpoint_geo1(temp, gs, param, func, numparam,
+  ArgCacheEntry *tentry = argcache_temporal(fcinfo, 0);
+  Temporal *temp = (tentry != NULL) ?
+    (Temporal *) DatumGetPointer(tentry->value) : PG_GETARG_TEMPORAL(0);
+  /* The functions with 2 arguments receive the FmgrInfo used to call
+   * PostGIS as third argument */
+  Datum param = (numparam == 3) ? PG_GETARG_DATUM(2) :
+    PointerGetDatum(spatialrel_flinfo(fcinfo, false));
+  Temporal *result = tspatialrel_tpoint_geo1(temp, gs, param, func, 3,
     restypid, INVERT_NO, withZ);
-  PG_FREE_IF_COPY(temp, 0);
-  PG_FREE_IF_COPY(gs, 1);
+  ARGCACHE_FREE_IF_COPY(temp, 0, tentry);
+  ARGCACHE_FREE_IF_COPY(gs, 1, gentry);
   PG_RETURN_POINTER(result);
 }
 
@@ -1145,7 +1263,9 @@ tspatialrel_tpoint_tpoint(FunctionCallInfo fcinfo, Datum (*func)(Datum, ...),
 {
   Temporal *temp1 = PG_GETARG_TEMPORAL(0);
   Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-  Datum param = (numparam == 3) ? PG_GETARG_DATUM(2) : (Datum) NULL;
+  /* The functions with 2 arguments receive as third argument a NULL
+   * FmgrInfo since the PostGIS functions are called without cache */
+  Datum param = (numparam == 3) ? PG_GETARG_DATUM(2) : PointerGetDatum(NULL);
   ensure_same_srid_tpoint(temp1, temp2);
   if (withZ)
     ensure_same_dimensionality_tpoint(temp1, temp2);
@@ -1156,7 +1276,7 @@ tspatialrel_tpoint_tpoint(FunctionCallInfo fcinfo, Datum (*func)(Datum, ...),
   }
   LiftedFunctionInfo lfinfo;
   lfinfo.func = (varfunc) func;
-  lfinfo.numparam = numparam;
+  lfinfo.numparam = 3;
   lfinfo.restypid = restypid;
   lfinfo.reslinear = STEP;
   lfinfo.invert = INVERT_NO;
@@ -1264,15 +1384,21 @@ PG_FUNCTION_INFO_V1(tdisjoint_geo_tpoint);
 PGDLLEXPORT Datum
 tdisjoint_geo_tpoint(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 0);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(0);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
-  Temporal *temp = PG_GETARG_TEMPORAL(1);
-  Temporal *negresult = tintersects_tpoint_geo1(temp, gs);
+  ArgCacheEntry *tentry = argcache_temporal(fcinfo, 1);
+  Temporal *temp = (tentry != NULL) ?
+    (Temporal *) DatumGetPointer(tentry->value) : PG_GETARG_TEMPORAL(1);
+  Temporal *negresult = tintersects_tpoint_geo1(temp, gs,
+    spatialrel_flinfo(fcinfo, false));
   Temporal *result = tnot_tbool_internal(negresult);
   pfree(negresult);
-  PG_FREE_IF_COPY(gs, 0);
-  PG_FREE_IF_COPY(temp, 1);
+  ARGCACHE_FREE_IF_COPY(gs, 0, gentry);
+  ARGCACHE_FREE_IF_COPY(temp, 1, tentry);
   PG_RETURN_POINTER(result);
 }
 
@@ -1284,15 +1410,21 @@ PG_FUNCTION_INFO_V1(tdisjoint_tpoint_geo);
 PGDLLEXPORT Datum
 tdisjoint_tpoint_geo(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 1);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(1);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
-  Temporal *negresult = tintersects_tpoint_geo1(temp, gs);
+  ArgCacheEntry *tentry = argcache_temporal(fcinfo, 0);
+  Temporal *temp = (tentry != NULL) ?
+    (Temporal *) DatumGetPointer(tentry->value) : PG_GETARG_TEMPORAL(0);
+  Temporal *negresult = tintersects_tpoint_geo1(temp, gs,
+    spatialrel_flinfo(fcinfo, false));
   Temporal *result = tnot_tbool_internal(negresult);
   pfree(negresult);
-  PG_FREE_IF_COPY(temp, 0);
-  PG_FREE_IF_COPY(gs, 1);
+  ARGCACHE_FREE_IF_COPY(temp, 0, tentry);
+  ARGCACHE_FREE_IF_COPY(gs, 1, gentry);
   PG_RETURN_POINTER(result);
 }
 
@@ -1303,7 +1435,7 @@ PG_FUNCTION_INFO_V1(tdisjoint_tpoint_tpoint);
 PGDLLEXPORT Datum
 tdisjoint_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-  return tspatialrel_tpoint_tpoint(fcinfo, (varfunc) &datum2_point_ne, 2,
+  return tspatialrel_tpoint_tpoint(fcinfo, (varfunc) &datum3_point_ne, 2,
     BOOLOID, WITH_Z);
 }
 
@@ -1319,7 +1451,7 @@ PG_FUNCTION_INFO_V1(tequals_geo_tpoint);
 PGDLLEXPORT Datum
 tequals_geo_tpoint(PG_FUNCTION_ARGS)
 {
-  return tspatialrel_geo_tpoint(fcinfo, (varfunc) &datum2_point_eq, 2,
+  return tspatialrel_geo_tpoint(fcinfo, (varfunc) &datum3_point_eq, 2,
     BOOLOID, WITH_Z);
 }
 
@@ -1331,7 +1463,7 @@ PG_FUNCTION_INFO_V1(tequals_tpoint_geo);
 PGDLLEXPORT Datum
 tequals_tpoint_geo(PG_FUNCTION_ARGS)
 {
-  return tspatialrel_tpoint_geo(fcinfo, (varfunc) &datum2_point_eq, 2,
+  return tspatialrel_tpoint_geo(fcinfo, (varfunc) &datum3_point_eq, 2,
     BOOLOID, WITH_Z);
 }
 
@@ -1342,7 +1474,7 @@ PG_FUNCTION_INFO_V1(tequals_tpoint_tpoint);
 PGDLLEXPORT Datum
 tequals_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-  return tspatialrel_tpoint_tpoint(fcinfo, (varfunc) &datum2_point_eq, 2,
+  return tspatialrel_tpoint_tpoint(fcinfo, (varfunc) &datum3_point_eq, 2,
     BOOLOID, WITH_Z);
 }
 
@@ -1356,7 +1488,7 @@ tequals_tpoint_tpoint(PG_FUNCTION_ARGS)
  * and the geometry
  */
 static Temporal *
-tintersects_tpoint_geo1(Temporal *temp, GSERIALIZED *gs)
+tintersects_tpoint_geo1(Temporal *temp, GSERIALIZED *gs, FmgrInfo *flinfo)
 {
   ensure_same_srid_tpoint_gs(temp, gs);
   ensure_same_dimensionality_tpoint_gs(temp, gs);
@@ -1365,11 +1497,11 @@ tintersects_tpoint_geo1(Temporal *temp, GSERIALIZED *gs)
   LiftedFunctionInfo lfinfo;
   lfinfo.func = MOBDB_FLAGS_GET_Z(temp->flags) ?
     (varfunc) &geom_intersects3d : (varfunc) &geom_intersects2d;
-  lfinfo.numparam = 2;
+  lfinfo.numparam = 3;
   lfinfo.restypid = BOOLOID;
   lfinfo.invert = INVERT_NO;
   Temporal *result = tspatialrel_tpoint_geo2(temp, PointerGetDatum(gs),
-    (Datum) NULL, lfinfo);
+    PointerGetDatum(flinfo), lfinfo);
   return result;
 }
 
@@ -1381,13 +1513,19 @@ PG_FUNCTION_INFO_V1(tintersects_geo_tpoint);
 PGDLLEXPORT Datum
 tintersects_geo_tpoint(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 0);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(0);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
-  Temporal *temp = PG_GETARG_TEMPORAL(1);
-  Temporal *result = tintersects_tpoint_geo1(temp, gs);
-  PG_FREE_IF_COPY(gs, 0);
-  PG_FREE_IF_COPY(temp, 1);
+  ArgCacheEntry *tentry = argcache_temporal(fcinfo, 1);
+  Temporal *temp = (tentry != NULL) ?
+    (Temporal *) DatumGetPointer(tentry->value) : PG_GETARG_TEMPORAL(1);
+  Temporal *result = tintersects_tpoint_geo1(temp, gs,
+    spatialrel_flinfo(fcinfo, false));
+  ARGCACHE_FREE_IF_COPY(gs, 0, gentry);
+  ARGCACHE_FREE_IF_COPY(temp, 1, tentry);
   PG_RETURN_POINTER(result);
 }
 
@@ -1399,13 +1537,19 @@ PG_FUNCTION_INFO_V1(tintersects_tpoint_geo);
 PGDLLEXPORT Datum
 tintersects_tpoint_geo(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 1);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(1);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
-  Temporal *result = tintersects_tpoint_geo1(temp, gs);
-  PG_FREE_IF_COPY(temp, 0);
-  PG_FREE_IF_COPY(gs, 1);
+  ArgCacheEntry *tentry = argcache_temporal(fcinfo, 0);
+  Temporal *temp = (tentry != NULL) ?
+    (Temporal *) DatumGetPointer(tentry->value) : PG_GETARG_TEMPORAL(0);
+  Temporal *result = tintersects_tpoint_geo1(temp, gs,
+    spatialrel_flinfo(fcinfo, false));
+  ARGCACHE_FREE_IF_COPY(temp, 0, tentry);
+  ARGCACHE_FREE_IF_COPY(gs, 1, gentry);
   PG_RETURN_POINTER(result);
 }
 
@@ -1421,15 +1565,13 @@ tintersects_tpoint_tpoint(PG_FUNCTION_ARGS)
   ensure_same_srid_tpoint(temp1, temp2);
   ensure_same_dimensionality_tpoint(temp1, temp2);
 
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   LiftedFunctionInfo lfinfo;
   if (MOBDB_FLAGS_GET_GEODETIC(temp1->flags))
     lfinfo.func = (varfunc) &geog_intersects;
   else
     lfinfo.func = MOBDB_FLAGS_GET_Z(temp1->flags) ?
       (varfunc) &geom_intersects3d : (varfunc) &geom_intersects2d;
-  lfinfo.numparam = 2;
+  lfinfo.numparam = 3;
   lfinfo.restypid = BOOLOID;
   lfinfo.reslinear = STEP;
   lfinfo.invert = INVERT_NO;
@@ -1542,14 +1684,19 @@ PG_FUNCTION_INFO_V1(tdwithin_geo_tpoint);
 PGDLLEXPORT Datum
 tdwithin_geo_tpoint(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(0);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 0);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(0);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
-  Temporal *temp = PG_GETARG_TEMPORAL(1);
+  ArgCacheEntry *tentry = argcache_temporal(fcinfo, 1);
+  Temporal *temp = (tentry != NULL) ?
+    (Temporal *) DatumGetPointer(tentry->value) : PG_GETARG_TEMPORAL(1);
   Datum dist = PG_GETARG_DATUM(2);
   Temporal *result = tdwithin_tpoint_geo_internal(temp, gs, dist);
-  PG_FREE_IF_COPY(gs, 0);
-  PG_FREE_IF_COPY(temp, 1);
+  ARGCACHE_FREE_IF_COPY(gs, 0, gentry);
+  ARGCACHE_FREE_IF_COPY(temp, 1, tentry);
   PG_RETURN_POINTER(result);
 }
 
@@ -1561,14 +1708,19 @@ PG_FUNCTION_INFO_V1(tdwithin_tpoint_geo);
 PGDLLEXPORT Datum
 tdwithin_tpoint_geo(PG_FUNCTION_ARGS)
 {
-  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+  ArgCacheEntry *gentry = argcache_gserialized(fcinfo, 1);
+  GSERIALIZED *gs = (gentry != NULL) ?
+    (GSERIALIZED *) DatumGetPointer(gentry->value) :
+    PG_GETARG_GSERIALIZED_P(1);
   if (gserialized_is_empty(gs))
     PG_RETURN_NULL();
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  ArgCacheEntry *tentry = argcache_temporal(fcinfo, 0);
+  Temporal *temp = (tentry != NULL) ?
+    (Temporal *) DatumGetPointer(tentry->value) : PG_GETARG_TEMPORAL(0);
   Datum dist = PG_GETARG_DATUM(2);
   Temporal *result = tdwithin_tpoint_geo_internal(temp, gs, dist);
-  PG_FREE_IF_COPY(temp, 0);
-  PG_FREE_IF_COPY(gs, 1);
+  ARGCACHE_FREE_IF_COPY(temp, 0, tentry);
+  ARGCACHE_FREE_IF_COPY(gs, 1, gentry);
   PG_RETURN_POINTER(result);
 }
 
@@ -1631,8 +1783,6 @@ tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
   Datum dist = PG_GETARG_DATUM(2);
   ensure_same_srid_tpoint(temp1, temp2);
   ensure_same_dimensionality_tpoint(temp1, temp2);
-  /* Store fcinfo into a global variable */
-  store_fcinfo(fcinfo);
   Temporal *result = tdwithin_tpoint_tpoint_internal(temp1, temp2, dist);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
@@ -1641,6 +1791,740 @@ tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Temporal dwithin for a batch of temporal points
+ *****************************************************************************/
+
+/**
+ * Structure to represent a temporal point in the plane sweep
+ */
+typedef struct
+{
+  int index;           /**< position of the temporal point in the array */
+  STBOX box;           /**< bounding box of the temporal point */
+} TPointSweepElem;
+
+/**
+ * Structure to represent a pair of temporal points that are within the
+ * distance at some instant
+ */
+typedef struct
+{
+  int index1;          /**< position of the first temporal point */
+  int index2;          /**< position of the second temporal point */
+  Temporal *result;    /**< result of tdwithin for the two points */
+} TDWithinPair;
+
+/**
+ * Comparator function for sorting the temporal points by start timestamp
+ */
+static int
+tpointsweepelem_cmp(const void *a1, const void *a2)
+{
+  const TPointSweepElem *e1 = (const TPointSweepElem *) a1;
+  const TPointSweepElem *e2 = (const TPointSweepElem *) a2;
+  int result = timestamp_cmp_internal(e1->box.tmin, e2->box.tmin);
+  if (result == 0)
+    result = (e1->index < e2->index) ? -1 : ((e1->index > e2->index) ? 1 : 0);
+  return result;
+}
+
+/**
+ * Comparator function for sorting the pairs of temporal points by position
+ */
+static int
+tdwithinpair_cmp(const void *a1, const void *a2)
+{
+  const TDWithinPair *p1 = (const TDWithinPair *) a1;
+  const TDWithinPair *p2 = (const TDWithinPair *) a2;
+  if (p1->index1 != p2->index1)
+    return (p1->index1 < p2->index1) ? -1 : 1;
+  if (p1->index2 != p2->index2)
+    return (p1->index2 < p2->index2) ? -1 : 1;
+  return 0;
+}
+
+/**
+ * Returns true if the spatial extents of the boxes are within the distance
+ */
+static bool
+stbox_spatial_dwithin(const STBOX *box1, const STBOX *box2, double dist,
+  bool hasz)
+{
+  if (box1->xmin - dist > box2->xmax || box2->xmin - dist > box1->xmax ||
+    box1->ymin - dist > box2->ymax || box2->ymin - dist > box1->ymax)
+    return false;
+  if (hasz &&
+    (box1->zmin - dist > box2->zmax || box2->zmin - dist > box1->zmax))
+    return false;
+  return true;
+}
+
+/**
+ * Returns the pairs of temporal points that are within the distance at
+ * some instant
+ *
+ * The temporal points are sorted by start timestamp and swept in time. Each
+ * point is only compared with the active points whose period has not ended
+ * and whose bounding box expanded by the distance intersects its bounding
+ * box. The candidate pairs are then computed with tdwithin.
+ *
+ * @param[in] temps Temporal points
+ * @param[in] count Number of elements in the array
+ * @param[in] dist Distance
+ * @param[out] newcount Number of pairs in the result
+ */
+static TDWithinPair *
+tdwithin_tpointarr_pairs(Temporal **temps, int count, Datum dist,
+  int *newcount)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(temps[0]->flags);
+  double d = DatumGetFloat8(dist);
+  TPointSweepElem *elems = palloc(sizeof(TPointSweepElem) * count);
+  for (int i = 0; i < count; i++)
+  {
+    elems[i].index = i;
+    temporal_bbox(&elems[i].box, temps[i]);
+  }
+  qsort(elems, (size_t) count, sizeof(TPointSweepElem), tpointsweepelem_cmp);
+
+  int *active = palloc(sizeof(int) * count);
+  int nactive = 0, k = 0, maxcount = count;
+  TDWithinPair *result = palloc(sizeof(TDWithinPair) * maxcount);
+  for (int i = 0; i < count; i++)
+  {
+    const TPointSweepElem *elem = &elems[i];
+    int n = 0;
+    for (int j = 0; j < nactive; j++)
+    {
+      const TPointSweepElem *elem1 = &elems[active[j]];
+      /* Remove from the active set the points that ended before */
+      if (elem1->box.tmax < elem->box.tmin)
+        continue;
+      active[n++] = active[j];
+      if (! stbox_spatial_dwithin(&elem1->box, &elem->box, d, hasz))
+        continue;
+      int index1 = Min(elem1->index, elem->index);
+      int index2 = Max(elem1->index, elem->index);
+      Temporal *tdw = tdwithin_tpoint_tpoint_internal(temps[index1],
+        temps[index2], dist);
+      if (tdw == NULL)
+        continue;
+      if (! temporal_ever_eq_internal(tdw, BoolGetDatum(true)))
+      {
+        pfree(tdw);
+        continue;
+      }
+      if (k == maxcount)
+      {
+        maxcount *= 2;
+        result = repalloc(result, sizeof(TDWithinPair) * maxcount);
+      }
+      result[k].index1 = index1;
+      result[k].index2 = index2;
+      result[k++].result = tdw;
+    }
+    active[n++] = i;
+    nactive = n;
+  }
+  pfree(elems); pfree(active);
+  qsort(result, (size_t) k, sizeof(TDWithinPair), tdwithinpair_cmp);
+  *newcount = k;
+  return result;
+}
+
+/**
+ * Structure to represent the state of the set-returning function
+ */
+typedef struct
+{
+  Datum *ids;          /**< identifiers of the temporal points */
+  TDWithinPair *pairs; /**< pairs of temporal points to return */
+} TDWithinPairsState;
+
+PG_FUNCTION_INFO_V1(tdwithin_pairs);
+/**
+ * Returns the identifiers of the pairs of temporal points that are within
+ * the given distance at some instant together with the temporal Boolean
+ * stating when they are within the distance
+ */
+PGDLLEXPORT Datum
+tdwithin_pairs(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  if (SRF_IS_FIRSTCALL())
+  {
+    funcctx = SRF_FIRSTCALL_INIT();
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    ArrayType *idarr = PG_GETARG_ARRAYTYPE_P(0);
+    ArrayType *temparr = PG_GETARG_ARRAYTYPE_P(1);
+    Datum dist = PG_GETARG_DATUM(2);
+    ensure_non_empty_array(temparr);
+    int count, idcount;
+    Datum *ids = datumarr_extract(idarr, &idcount);
+    Temporal **temps = temporalarr_extract(temparr, &count);
+    if (idcount != count)
+      ereport(ERROR, (errcode(ERRCODE_ARRAY_ELEMENT_ERROR),
+        errmsg("The arrays of identifiers and of temporal points must have the same length")));
+    for (int i = 1; i < count; i++)
+    {
+      ensure_same_srid_tpoint(temps[0], temps[i]);
+      ensure_same_dimensionality_tpoint(temps[0], temps[i]);
+    }
+    TDWithinPairsState *state = palloc(sizeof(TDWithinPairsState));
+    int npairs;
+    state->ids = ids;
+    state->pairs = tdwithin_tpointarr_pairs(temps, count, dist, &npairs);
+    TupleDesc tupdesc;
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+      ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+        errmsg("function returning record called in context that cannot accept type record")));
+    funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+    funcctx->user_fctx = state;
+    funcctx->max_calls = npairs;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr < funcctx->max_calls)
+  {
+    TDWithinPairsState *state = (TDWithinPairsState *) funcctx->user_fctx;
+    TDWithinPair *pair = &state->pairs[funcctx->call_cntr];
+    Datum values[3];
+    bool isnull[3] = {false, false, false};
+    values[0] = state->ids[pair->index1];
+    values[1] = state->ids[pair->index2];
+    values[2] = PointerGetDatum(pair->result);
+    HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+    SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+  }
+  SRF_RETURN_DONE(funcctx);
+}
+
+/*****************************************************************************
+ * Temporal intersects between a temporal point and an array of geometries
+ *
+ * The bounding boxes of the geometries are packed once into an STR-tree
+ * (Sort-Tile-Recursive R-tree). The temporal point is then traversed a
+ * single time and the tree is queried with the bounding box of each of its
+ * segments, so that each geometry only receives the segments that may
+ * intersect it. The segments of a geometry are computed as for tintersects
+ * and the others, which are in the exterior of the geometry, are settled
+ * without calling PostGIS.
+ *****************************************************************************/
+
+/**
+ * Maximum number of children of a node of the STR-tree
+ */
+#define STRTREE_CAPACITY    8
+
+/**
+ * Structure to represent a node of the STR-tree. The elements of the lowest
+ * level are the geometries, their first member being their position.
+ */
+typedef struct
+{
+  double xmin, ymin, xmax, ymax;  /**< Extent of the node */
+  int first;          /**< First child in the level below or position */
+  int count;          /**< Number of children, 0 for the geometries */
+} STRNode;
+
+/**
+ * Structure to represent an STR-tree, stored as an array of levels
+ */
+typedef struct
+{
+  STRNode **levels;   /**< Nodes of each level, the last one is the root */
+  int *counts;        /**< Number of nodes of each level */
+  int nlevels;        /**< Number of levels */
+} STRTree;
+
+/**
+ * Comparator functions for sorting the nodes by the center of their extent
+ */
+static int
+strnode_xcmp(const void *a1, const void *a2)
+{
+  const STRNode *n1 = (const STRNode *) a1;
+  const STRNode *n2 = (const STRNode *) a2;
+  double c1 = n1->xmin + n1->xmax, c2 = n2->xmin + n2->xmax;
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+static int
+strnode_ycmp(const void *a1, const void *a2)
+{
+  const STRNode *n1 = (const STRNode *) a1;
+  const STRNode *n2 = (const STRNode *) a2;
+  double c1 = n1->ymin + n1->ymax, c2 = n2->ymin + n2->ymax;
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+/**
+ * Sort the nodes of a level in STR order and returns the nodes of the level
+ * above, each of them grouping consecutive nodes
+ *
+ * @param[in,out] nodes Nodes of the level, which are reordered
+ * @param[in] count Number of nodes of the level
+ * @param[out] newcount Number of nodes of the resulting level
+ */
+static STRNode *
+strtree_pack(STRNode *nodes, int count, int *newcount)
+{
+  int nparents = (count + STRTREE_CAPACITY - 1) / STRTREE_CAPACITY;
+  int nslices = (int) ceil(sqrt((double) nparents));
+  int slicesize = nslices * STRTREE_CAPACITY;
+  /* Sort by x into vertical slices and each slice by y */
+  qsort(nodes, (size_t) count, sizeof(STRNode), strnode_xcmp);
+  for (int i = 0; i < count; i += slicesize)
+    qsort(&nodes[i], (size_t) Min(slicesize, count - i), sizeof(STRNode),
+      strnode_ycmp);
+  STRNode *result = palloc(sizeof(STRNode) * nparents);
+  for (int i = 0; i < nparents; i++)
+  {
+    STRNode *parent = &result[i];
+    parent->first = i * STRTREE_CAPACITY;
+    parent->count = Min(STRTREE_CAPACITY, count - parent->first);
+    const STRNode *child = &nodes[parent->first];
+    parent->xmin = child->xmin; parent->xmax = child->xmax;
+    parent->ymin = child->ymin; parent->ymax = child->ymax;
+    for (int j = 1; j < parent->count; j++)
+    {
+      child = &nodes[parent->first + j];
+      parent->xmin = Min(parent->xmin, child->xmin);
+      parent->xmax = Max(parent->xmax, child->xmax);
+      parent->ymin = Min(parent->ymin, child->ymin);
+      parent->ymax = Max(parent->ymax, child->ymax);
+    }
+  }
+  *newcount = nparents;
+  return result;
+}
+
+/**
+ * Build the STR-tree of the geometries
+ *
+ * @param[in] nodes Extents of the geometries, whose first member is their
+ * position, the array is owned by the tree
+ * @param[in] count Number of geometries, which must be greater than 0
+ */
+static STRTree *
+strtree_make(STRNode *nodes, int count)
+{
+  STRTree *result = palloc(sizeof(STRTree));
+  /* The height of the tree is logarithmic in the number of geometries */
+  int maxlevels = 2;
+  for (int n = count; n > 1; n = (n + STRTREE_CAPACITY - 1) / STRTREE_CAPACITY)
+    maxlevels++;
+  result->levels = palloc(sizeof(STRNode *) * maxlevels);
+  result->counts = palloc(sizeof(int) * maxlevels);
+  result->levels[0] = nodes;
+  result->counts[0] = count;
+  int k = 1;
+  do
+  {
+    result->levels[k] = strtree_pack(result->levels[k - 1],
+      result->counts[k - 1], &result->counts[k]);
+    k++;
+  } while (result->counts[k - 1] > 1);
+  result->nlevels = k;
+  return result;
+}
+
+/**
+ * Collect the positions of the geometries whose extent intersects the box
+ *
+ * @param[in] tree STR-tree
+ * @param[in] level,pos Node to explore
+ * @param[in] box Box, which is closed
+ * @param[out] result Array of positions, of size the number of geometries
+ * @param[in,out] count Number of elements in the resulting array
+ */
+static void
+strtree_query(const STRTree *tree, int level, int pos, const STRNode *box,
+  int *result, int *count)
+{
+  const STRNode *node = &tree->levels[level][pos];
+  if (node->xmin > box->xmax || node->xmax < box->xmin ||
+    node->ymin > box->ymax || node->ymax < box->ymin)
+    return;
+  if (level == 0)
+  {
+    result[(*count)++] = node->first;
+    return;
+  }
+  for (int i = 0; i < node->count; i++)
+    strtree_query(tree, level - 1, node->first + i, box, result, count);
+  return;
+}
+
+/**
+ * Structure to collect the segments of the temporal point that may
+ * intersect a geometry, as pairs of sequence and instant numbers
+ */
+typedef struct
+{
+  int *segs;           /**< Sequence and start instant of the segments */
+  int count;           /**< Number of segments */
+  int maxcount;        /**< Capacity of the array of segments */
+} STRCandidates;
+
+/**
+ * Add the segment to the candidates of the geometry
+ */
+static void
+strcandidates_add(STRCandidates *cand, int seqno, int instno)
+{
+  if (cand->maxcount == 0)
+  {
+    cand->maxcount = 8;
+    cand->segs = palloc(sizeof(int) * 2 * cand->maxcount);
+  }
+  else if (cand->count == cand->maxcount)
+  {
+    cand->maxcount *= 2;
+    cand->segs = repalloc(cand->segs, sizeof(int) * 2 * cand->maxcount);
+  }
+  cand->segs[cand->count * 2] = seqno;
+  cand->segs[cand->count * 2 + 1] = instno;
+  cand->count++;
+  return;
+}
+
+/**
+ * Returns the constant sequence false between the instants
+ */
+static TSequence *
+tintersects_exterior_seq(const TInstant *inst1, const TInstant *inst2,
+  bool lower_inc, bool upper_inc)
+{
+  Period p;
+  period_set(&p, inst1->t, inst2->t, lower_inc, upper_inc);
+  return tsequence_from_base_internal(BoolGetDatum(false), BOOLOID, &p, STEP);
+}
+
+/**
+ * Returns the temporal intersects relationship between a temporal sequence
+ * point and a geometry, given the segments that may intersect the geometry
+ *
+ * @param[in] seq Temporal point
+ * @param[in] geo Geometry
+ * @param[in] segs Start instants of the candidate segments in increasing
+ * order, given as pairs of sequence and instant numbers
+ * @param[in] nsegs Number of candidate segments
+ * @param[in] param Parameter of the lifted function
+ * @param[in] lfinfo Information about the lifted function
+ * @param[out] count Number of elements in the resulting array
+ */
+static TSequence **
+tintersects_tpointseq_candidates(const TSequence *seq, Datum geo,
+  const int *segs, int nsegs, Datum param, LiftedFunctionInfo lfinfo,
+  int *count)
+{
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+  {
+    TInstant *inst = tsequence_inst_n(seq, 0);
+    Datum value = (nsegs == 0) ? BoolGetDatum(false) :
+      spatialrel(tinstant_value(inst), geo, param, lfinfo);
+    TSequence **result = palloc(sizeof(TSequence *));
+    TInstant *inst1 = tinstant_make(value, inst->t, BOOLOID);
+    result[0] = tinstant_to_tsequence(inst1, STEP);
+    pfree(inst1);
+    *count = 1;
+    return result;
+  }
+
+  /* Each candidate segment may be preceded by a run of exterior segments */
+  TSequence ***sequences = palloc(sizeof(TSequence *) * (2 * nsegs + 1));
+  int *countseqs = palloc0(sizeof(int) * (2 * nsegs + 1));
+  int totalseqs = 0, k = 0, last = 0;
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  bool lower_inc = seq->period.lower_inc;
+  for (int i = 0; i < nsegs; i++)
+  {
+    int instno = segs[2 * i + 1];
+    if (instno > last)
+    {
+      sequences[k] = palloc(sizeof(TSequence *));
+      sequences[k][0] = tintersects_exterior_seq(tsequence_inst_n(seq, last),
+        tsequence_inst_n(seq, instno), lower_inc, false);
+      countseqs[k] = 1;
+      totalseqs += countseqs[k++];
+      lower_inc = true;
+    }
+    bool upper_inc = (instno == seq->count - 2) ?
+      seq->period.upper_inc : false;
+    sequences[k] = tspatialrel_tpointseq_geo1(tsequence_inst_n(seq, instno),
+      tsequence_inst_n(seq, instno + 1), linear, geo, param, lower_inc,
+      upper_inc, lfinfo, &countseqs[k]);
+    totalseqs += countseqs[k++];
+    lower_inc = true;
+    last = instno + 1;
+  }
+  if (last < seq->count - 1)
+  {
+    sequences[k] = palloc(sizeof(TSequence *));
+    sequences[k][0] = tintersects_exterior_seq(tsequence_inst_n(seq, last),
+      tsequence_inst_n(seq, seq->count - 1), lower_inc,
+      seq->period.upper_inc);
+    countseqs[k] = 1;
+    totalseqs += countseqs[k++];
+  }
+  *count = totalseqs;
+  return tsequencearr2_to_tsequencearr(sequences, countseqs, k, totalseqs);
+}
+
+/**
+ * Returns the temporal intersects relationship between a temporal sequence
+ * (set) point and a geometry, given the segments that may intersect the
+ * geometry
+ */
+static Temporal *
+tintersects_tpoint_candidates(const Temporal *temp, Datum geo,
+  const STRCandidates *cand, Datum param, LiftedFunctionInfo lfinfo)
+{
+  if (temp->duration == SEQUENCE)
+  {
+    int count;
+    TSequence **sequences = tintersects_tpointseq_candidates(
+      (TSequence *) temp, geo, cand->segs, cand->count, param, lfinfo,
+      &count);
+    return (Temporal *) tsequenceset_make_free(sequences, count, NORMALIZE);
+  }
+
+  /* temp->duration == SEQUENCESET */
+  const TSequenceSet *ts = (TSequenceSet *) temp;
+  TSequence ***sequences = palloc(sizeof(TSequence *) * ts->count);
+  int *countseqs = palloc0(sizeof(int) * ts->count);
+  int totalseqs = 0, j = 0;
+  for (int i = 0; i < ts->count; i++)
+  {
+    /* The candidates are sorted by sequence */
+    int first = j;
+    while (j < cand->count && cand->segs[2 * j] == i)
+      j++;
+    sequences[i] = tintersects_tpointseq_candidates(tsequenceset_seq_n(ts, i),
+      geo, &cand->segs[2 * first], j - first, param, lfinfo, &countseqs[i]);
+    totalseqs += countseqs[i];
+  }
+  TSequence **allsequences = tsequencearr2_to_tsequencearr(sequences,
+    countseqs, ts->count, totalseqs);
+  return (Temporal *) tsequenceset_make_free(allsequences, totalseqs,
+    NORMALIZE);
+}
+
+/**
+ * Set the extent of the query from the points
+ */
+static void
+strnode_set_points(STRNode *box, const POINT2D *p1, const POINT2D *p2)
+{
+  box->xmin = Min(p1->x, p2->x); box->xmax = Max(p1->x, p2->x);
+  box->ymin = Min(p1->y, p2->y); box->ymax = Max(p1->y, p2->y);
+  return;
+}
+
+/**
+ * Query the STR-tree with the bounding boxes of the segments of the
+ * temporal sequence point, adding the segments to the candidates of the
+ * geometries that they may intersect
+ */
+static void
+tpointseq_strtree_candidates(const TSequence *seq, int seqno,
+  const STRTree *tree, STRCandidates *cands, int *found)
+{
+  STRNode box;
+  int nfound;
+  const POINT2D *p1 = datum_get_point2d_p(
+    tinstant_value(tsequence_inst_n(seq, 0)));
+  if (seq->count == 1)
+  {
+    strnode_set_points(&box, p1, p1);
+    nfound = 0;
+    strtree_query(tree, tree->nlevels - 1, 0, &box, found, &nfound);
+    for (int j = 0; j < nfound; j++)
+      strcandidates_add(&cands[found[j]], seqno, 0);
+    return;
+  }
+  for (int i = 0; i < seq->count - 1; i++)
+  {
+    const POINT2D *p2 = datum_get_point2d_p(
+      tinstant_value(tsequence_inst_n(seq, i + 1)));
+    strnode_set_points(&box, p1, p2);
+    nfound = 0;
+    strtree_query(tree, tree->nlevels - 1, 0, &box, found, &nfound);
+    for (int j = 0; j < nfound; j++)
+      strcandidates_add(&cands[found[j]], seqno, i);
+    p1 = p2;
+  }
+  return;
+}
+
+/**
+ * Returns the temporal intersects relationship between the temporal point
+ * and each geometry of the array, or NULL for the geometries that the
+ * temporal point never intersects
+ *
+ * @param[in] temp Temporal point
+ * @param[in] geoms Geometries
+ * @param[in] count Number of geometries
+ * @param[in] flinfo Information for the PostGIS functions
+ */
+static Temporal **
+tintersects_tpoint_geoarr_internal(Temporal *temp, GSERIALIZED **geoms,
+  int count, FmgrInfo *flinfo)
+{
+  Temporal **result = palloc0(sizeof(Temporal *) * count);
+  /* Build the tree with the non-empty geometries */
+  STRNode *nodes = palloc(sizeof(STRNode) * count);
+  int n = 0;
+  for (int i = 0; i < count; i++)
+  {
+    ensure_same_srid_tpoint_gs(temp, geoms[i]);
+    ensure_same_dimensionality_tpoint_gs(temp, geoms[i]);
+    GBOX box;
+    if (gserialized_get_gbox_p(geoms[i], &box) != LW_SUCCESS)
+      continue;
+    nodes[n].xmin = box.xmin; nodes[n].xmax = box.xmax;
+    nodes[n].ymin = box.ymin; nodes[n].ymax = box.ymax;
+    nodes[n].first = i;
+    nodes[n++].count = 0;
+  }
+  if (n == 0)
+  {
+    pfree(nodes);
+    return result;
+  }
+  STRTree *tree = strtree_make(nodes, n);
+
+  /* Traverse the temporal point once, collecting the candidates */
+  STRCandidates *cands = palloc0(sizeof(STRCandidates) * count);
+  int *found = palloc(sizeof(int) * n);
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT || temp->duration == INSTANTSET)
+  {
+    /* The instants are handled as for tintersects, only the geometries
+     * whose extent contains one of the instants are candidates */
+    int ninst = (temp->duration == INSTANT) ? 1 :
+      ((TInstantSet *) temp)->count;
+    for (int i = 0; i < ninst; i++)
+    {
+      const TInstant *inst = (temp->duration == INSTANT) ?
+        (TInstant *) temp : tinstantset_inst_n((TInstantSet *) temp, i);
+      const POINT2D *p = datum_get_point2d_p(tinstant_value(inst));
+      STRNode box;
+      int nfound = 0;
+      strnode_set_points(&box, p, p);
+      strtree_query(tree, tree->nlevels - 1, 0, &box, found, &nfound);
+      for (int j = 0; j < nfound; j++)
+        strcandidates_add(&cands[found[j]], 0, i);
+    }
+  }
+  else if (temp->duration == SEQUENCE)
+    tpointseq_strtree_candidates((TSequence *) temp, 0, tree, cands, found);
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (TSequenceSet *) temp;
+    for (int i = 0; i < ts->count; i++)
+      tpointseq_strtree_candidates(tsequenceset_seq_n(ts, i), i, tree,
+        cands, found);
+  }
+
+  /* Compute the relationship for the geometries having candidates */
+  LiftedFunctionInfo lfinfo;
+  lfinfo.func = MOBDB_FLAGS_GET_Z(temp->flags) ?
+    (varfunc) &geom_intersects3d : (varfunc) &geom_intersects2d;
+  lfinfo.numparam = 3;
+  lfinfo.restypid = BOOLOID;
+  lfinfo.invert = INVERT_NO;
+  for (int i = 0; i < count; i++)
+  {
+    if (cands[i].count == 0)
+      continue;
+    Temporal *tinter = (temp->duration == INSTANT ||
+        temp->duration == INSTANTSET) ?
+      tintersects_tpoint_geo1(temp, geoms[i], flinfo) :
+      tintersects_tpoint_candidates(temp, PointerGetDatum(geoms[i]),
+        &cands[i], PointerGetDatum(flinfo), lfinfo);
+    if (temporal_ever_eq_internal(tinter, BoolGetDatum(true)))
+      result[i] = tinter;
+    else
+      pfree(tinter);
+    pfree(cands[i].segs);
+  }
+  pfree(cands); pfree(found);
+  for (int i = 0; i < tree->nlevels; i++)
+    pfree(tree->levels[i]);
+  pfree(tree->levels); pfree(tree->counts); pfree(tree);
+  return result;
+}
+
+/**
+ * Structure to represent the state of the set-returning function
+ */
+typedef struct
+{
+  Temporal **results;  /**< Results for each geometry, NULL if never true */
+  int count;           /**< Number of geometries */
+  int next;            /**< Next geometry to examine */
+} TIntersectsGeoArrState;
+
+PG_FUNCTION_INFO_V1(tintersects_tpoint_geoarr);
+/**
+ * Returns the position in the array of the geometries that the temporal
+ * point intersects at some instant together with the temporal Boolean
+ * stating when they intersect
+ */
+PGDLLEXPORT Datum
+tintersects_tpoint_geoarr(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  if (SRF_IS_FIRSTCALL())
+  {
+    funcctx = SRF_FIRSTCALL_INIT();
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    Temporal *temp = PG_GETARG_TEMPORAL(0);
+    ArrayType *array = PG_GETARG_ARRAYTYPE_P(1);
+    int count;
+    Datum *values = datumarr_extract(array, &count);
+    GSERIALIZED **geoms = palloc(sizeof(GSERIALIZED *) * (count + 1));
+    for (int i = 0; i < count; i++)
+      geoms[i] = (GSERIALIZED *) PG_DETOAST_DATUM(values[i]);
+    TIntersectsGeoArrState *state = palloc(sizeof(TIntersectsGeoArrState));
+    state->results = tintersects_tpoint_geoarr_internal(temp, geoms, count,
+      spatialrel_flinfo(fcinfo, false));
+    state->count = count;
+    state->next = 0;
+    TupleDesc tupdesc;
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+      ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+        errmsg("function returning record called in context that cannot accept type record")));
+    funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+    funcctx->user_fctx = state;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  funcctx = SRF_PERCALL_SETUP();
+  TIntersectsGeoArrState *state =
+    (TIntersectsGeoArrState *) funcctx->user_fctx;
+  while (state->next < state->count && state->results[state->next] == NULL)
+    state->next++;
+  if (state->next < state->count)
+  {
+    Datum values[2];
+    bool isnull[2] = {false, false};
+    /* The positions in SQL arrays start at 1 */
+    values[0] = Int32GetDatum(state->next + 1);
+    values[1] = PointerGetDatum(state->results[state->next++]);
+    HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+    SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+  }
+  SRF_RETURN_DONE(funcctx);
+}
+
 /*****************************************************************************
  * Temporal relate
  *****************************************************************************/
@@ -0,0 +1,40 @@
+-------------------------------------------------------------------------------
+-- Performance of the GiST index on temporal points
+-------------------------------------------------------------------------------
+
+DROP TABLE IF EXISTS perf_tgeompoint;
+CREATE TABLE perf_tgeompoint AS
+SELECT k, temp
+FROM generate_tgeompoints(20000, 50, stbox 'STBOX((0,0),(10000,10000))',
+  period '[2000-01-01, 2000-02-01]', '1 minute', 'walk')
+  WITH ORDINALITY t(temp, k);
+CREATE INDEX perf_tgeompoint_gist_idx ON perf_tgeompoint
+  USING gist(temp gist_tgeompoint_ops);
+ANALYZE perf_tgeompoint;
+
+/* The selective queries use the index */
+SELECT perf_assert_index(
+  'SELECT k FROM perf_tgeompoint WHERE temp && stbox ''STBOX((1000,1000),(1500,1500))''',
+  'perf_tgeompoint_gist_idx');
+SELECT perf_assert_index(
+  'SELECT k FROM perf_tgeompoint WHERE temp && period ''[2000-01-10, 2000-01-10 00:10:00]''',
+  'perf_tgeompoint_gist_idx');
+SELECT perf_assert_index(
+  'SELECT k FROM perf_tgeompoint WHERE temp && stbox ''STBOX T((1000,1000,2000-01-10),(5000,5000,2000-01-11))''',
+  'perf_tgeompoint_gist_idx');
+
+/* The index only visits the leaf entries of a few pages */
+SELECT perf_assert_gist(
+  'SELECT k FROM perf_tgeompoint WHERE temp && stbox ''STBOX((1000,1000),(1500,1500))''',
+  'stbox', 3000);
+
+/* The index scan is faster than the scan computing the boxes of all the
+ * values */
+SELECT perf_assert_faster(
+  'SELECT k FROM perf_tgeompoint WHERE temp && stbox ''STBOX T((1000,1000,2000-01-10),(5000,5000,2000-01-11))''',
+  'SELECT k FROM perf_tgeompoint WHERE temp::stbox && stbox ''STBOX T((1000,1000,2000-01-10),(5000,5000,2000-01-11))''',
+  0.5);
+
+DROP TABLE perf_tgeompoint;
+
+-------------------------------------------------------------------------------
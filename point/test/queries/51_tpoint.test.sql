@@ -44,6 +44,8 @@ SELECT asText(tgeompoint '[Point(1 1)@2001-01-01 08:00:00,Point(2 2)@2001-01-01
 SELECT asText(tgeogpoint ' [ Point(1 1)@2001-01-01 08:00:00 , Point(2 2)@2001-01-01 08:05:00 , Point(3 3)@2001-01-01 08:06:00 ] ');
 SELECT asText(tgeogpoint '[Point(1 1)@2001-01-01 08:00:00,Point(2 2)@2001-01-01 08:05:00,Point(3 3)@2001-01-01 08:06:00]');
 SELECT asText(tgeompoint '[Point(1 1 1)@2001-01-01, Point(2 2 2)@2001-01-02, Point(3 3 3)@2001-01-03]');
+SELECT asText(tgeompoint '[point(1.5 -2e1)@2001-01-01T08:00:00.25Z, POINT( 3  4 )@2001-01-02 00:00+01:30]');
+SELECT asText(tgeompoint 'SRID=5676;[Point Z (1 1 1)@2001-01-01, SRID=5676;Point(2 2 3)@2001-01-02]');
 /* Errors */
 SELECT tgeompoint '[Point(1 1)@2001-01-01 08:00:00,Point empty@2001-01-01 08:05:00,Point(3 3)@2001-01-01 08:06:00]';
 SELECT tgeogpoint '[Point(1 1)@2001-01-01 08:00:00,Point empty@2001-01-01 08:05:00,Point(3 3)@2001-01-01 08:06:00]';
@@ -429,10 +431,15 @@ tgeogpointinst(ST_Point(1,1), '2012-01-01 08:00:00'),
 tgeogpointinst(ST_Point(2,2), '2012-01-01 08:10:00'),
 tgeogpointinst(ST_Point(1,1), '2012-01-01 08:20:00')
 ]));
+SELECT asewkt(tgeompointseq(float8[] '{1,2,1}', float8[] '{1,2,1}', timestamptz[] '{2012-01-01 08:00:00, 2012-01-01 08:10:00, 2012-01-01 08:20:00}', 5676));
+SELECT asewkt(tgeompointseq(float8[] '{1,2}', float8[] '{1,2}', float8[] '{1,2}', timestamptz[] '{2012-01-01 08:00:00, 2012-01-01 08:10:00}', 0, true, true, false));
+SELECT asewkt(tgeogpointseq(float8[] '{1,2}', float8[] '{1,2}', timestamptz[] '{2012-01-01 08:00:00, 2012-01-01 08:10:00}'));
 
 /* Errors */
 SELECT tgeompointseq(ARRAY[tgeompoint 'SRID=5676;Point(1 1)@2001-01-01', 'SRID=4326;Point(2 2)@2001-01-02']);
 SELECT tgeompointseq(ARRAY[tgeompoint 'Point(1 1)@2001-01-01', 'Point(2 2 2)@2001-01-02']);
+SELECT tgeompointseq(float8[] '{1,2}', float8[] '{1}', timestamptz[] '{2012-01-01, 2012-01-02}');
+SELECT tgeompointseq(float8[] '{1,2}', float8[] '{1,2}', timestamptz[] '{2012-01-02, 2012-01-01}');
 
 -------------------------------------------------------------------------------
 
@@ -471,6 +478,11 @@ SELECT asewkt(tgeogpoint(tgeompoint 'Point(1 1)@2001-01-01'));
 SELECT asewkt(tgeogpoint(tgeompoint '{Point(1 1)@2001-01-01, Point(2 2)@2001-01-02}'));
 SELECT asewkt(tgeogpoint(tgeompoint '[Point(1 1)@2001-01-01, Point(1 1)@2001-01-02]'));
 SELECT asewkt(tgeogpoint(tgeompoint '{[Point(1 1)@2001-01-01, Point(1 1)@2001-01-02], [Point(2 2)@2001-01-03, Point(2 2)@2001-01-04]}'));
+SELECT asewkt(tgeompoint(tgeogpoint(tgeompoint '[Point(1 1)@2001-01-01, Point(2 2)@2001-01-02]')));
+SELECT stbox(tgeogpoint(tgeompoint '[Point(1 1)@2001-01-01, Point(2 2)@2001-01-02]')) =
+  stbox(tgeogpoint '[Point(1 1)@2001-01-01, Point(2 2)@2001-01-02]');
+SELECT tgeogpoint(tgeompoint '{Point(1 1)@2001-01-01, Point(2 2)@2001-01-02}') =
+  tgeogpoint '{Point(1 1)@2001-01-01, Point(2 2)@2001-01-02}';
 
 -------------------------------------------------------------------------------
 -- Transformation functions
@@ -640,6 +652,52 @@ SELECT memSize(tgeogpoint 'Point(1.5 1.5)@2000-01-01');
 SELECT memSize(tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}');
 SELECT memSize(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]');
 SELECT memSize(tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}');
+CREATE TEMP TABLE tbl_stbox_traj AS SELECT stbox(tgeogpoint '[Point(1 1)@2000-01-01, Point(3 2)@2000-01-02]') AS b1, stbox(tgeompoint '[Point(1 1)@2000-01-01, Point(3 2)@2000-01-02, Point(2 4)@2000-01-03]') AS b2;
+SET mobilitydb.precompute_trajectory = off;
+SELECT memSize(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]');
+SELECT b1 = stbox(tgeogpoint '[Point(1 1)@2000-01-01, Point(3 2)@2000-01-02]'), b2 = stbox(tgeompoint '[Point(1 1)@2000-01-01, Point(3 2)@2000-01-02, Point(2 4)@2000-01-03]') FROM tbl_stbox_traj;
+RESET mobilitydb.precompute_trajectory;
+DROP TABLE tbl_stbox_traj;
+SELECT memSize(pack(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'));
+SELECT memSize(pack(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]'));
+SELECT pack(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]') = tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]';
+SELECT pack(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]') = tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]';
+SELECT memSize(pack(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}'));
+SELECT memSize(pack(tgeompoint '[Point(1 1)@2000-01-01 00:00:00, Point(2 2)@2000-01-01 00:00:01, Point(3 3)@2000-01-01 00:00:02, Point(1 1)@2000-01-01 00:00:03]'));
+SELECT pack(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}') = tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}';
+SELECT asText(pack(tgeompoint '[Point(1 1)@2000-01-01 00:00:00, Point(2 2)@2000-01-01 00:00:01, Point(3 3)@2000-01-01 00:00:02, Point(1 1)@2000-01-01 00:00:03]'));
+SELECT asText(pack(tgeompoint '[Point(1 1)@2000-01-01, Point(2.3 1.7)@2000-01-02]', 0.5));
+SELECT pack(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', 0.5) = tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]';
+SELECT memSize(pack(temp)) - memSize(pack(temp, 0.001)) FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i * i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i)) AS temp FROM generate_series(1, 100) i) t;
+SELECT trajectory > 0 AND base_values > 0 FROM memBreakdown(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]');
+SELECT (b).size > (b).raw_size FROM (SELECT memBreakdown(pack(temp)) AS b FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i * i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i)) AS temp FROM generate_series(1, 100) i) t) t;
+SELECT pack(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', true) = tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]';
+SELECT pack(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]', true) = tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]';
+SELECT memSize(pack(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', true)) = memSize(pack(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'));
+SELECT asText(pack(tgeompoint '[Point(1 1)@2000-01-01, Point(2.3 1.7)@2000-01-02]', 0.5, true));
+CREATE TABLE tbl_pack_shuffle(plain tgeompoint, shuffled tgeompoint);
+INSERT INTO tbl_pack_shuffle SELECT pack(temp), pack(temp, true) FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i * i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i)) AS temp FROM generate_series(1, 1000) i) t;
+SELECT pg_column_size(shuffled) < pg_column_size(plain) FROM tbl_pack_shuffle;
+DROP TABLE tbl_pack_shuffle;
+SELECT bool_and(timestamps(p) = timestamps(temp) AND numInstants(p) = numInstants(temp) AND numTimestamps(p) = numTimestamps(temp) AND startTimestamp(p) = startTimestamp(temp) AND endTimestamp(p) = endTimestamp(temp) AND timestampN(p, 2) IS NOT DISTINCT FROM timestampN(temp, 2) AND timespan(p) = timespan(temp) AND period(p) = period(temp) AND SRID(p) = SRID(temp)) FROM (SELECT temp, pack(temp) AS p FROM tbl_tgeompoint) t;
+SELECT bool_and(ST_AsText(getValues(p)) = ST_AsText(getValues(temp)) AND ST_AsText(trajectory(p)) = ST_AsText(trajectory(temp))) FROM (SELECT temp, pack(temp, true) AS p FROM tbl_tgeompoint) t;
+SELECT bool_and(timestamps(p) = timestamps(temp) AND numInstants(p) = numInstants(temp) AND numTimestamps(p) = numTimestamps(temp) AND startTimestamp(p) = startTimestamp(temp) AND endTimestamp(p) = endTimestamp(temp) AND timestampN(p, 2) IS NOT DISTINCT FROM timestampN(temp, 2) AND timespan(p) = timespan(temp) AND period(p) = period(temp) AND SRID(p) = SRID(temp)) FROM (SELECT temp, pack(temp) AS p FROM tbl_tgeompoint3D) t;
+SELECT bool_and(ST_AsText(getValues(p)) = ST_AsText(getValues(temp)) AND ST_AsText(trajectory(p)) = ST_AsText(trajectory(temp))) FROM (SELECT temp, pack(temp, true) AS p FROM tbl_tgeompoint3D) t;
+SELECT bool_and(timestamps(p) = timestamps(temp) AND numInstants(p) = numInstants(temp) AND numTimestamps(p) = numTimestamps(temp) AND startTimestamp(p) = startTimestamp(temp) AND endTimestamp(p) = endTimestamp(temp) AND timestampN(p, 2) IS NOT DISTINCT FROM timestampN(temp, 2) AND timespan(p) = timespan(temp) AND period(p) = period(temp) AND SRID(p) = SRID(temp)) FROM (SELECT temp, pack(temp) AS p FROM tbl_tgeogpoint) t;
+SELECT bool_and(ST_AsText(getValues(p)) = ST_AsText(getValues(temp)) AND ST_AsText(trajectory(p)) = ST_AsText(trajectory(temp))) FROM (SELECT temp, pack(temp, true) AS p FROM tbl_tgeogpoint) t;
+SELECT bool_and(ST_AsText(valueAtTimestamp(p, t)) IS NOT DISTINCT FROM ST_AsText(valueAtTimestamp(temp, t))) FROM (SELECT temp, pack(temp) AS p FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i * i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i), false, true, true) AS temp FROM generate_series(1, 100) i) t1) t2, generate_series(timestamptz '2000-01-01', timestamptz '2000-01-01 00:01:50', interval '0.5 second') t;
+SELECT bool_and(ST_AsText(valueAtTimestamp(p, t)) IS NOT DISTINCT FROM ST_AsText(valueAtTimestamp(temp, t))) FROM (SELECT temp, pack(temp) AS p FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i * i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i), false, true, false) AS temp FROM generate_series(1, 100) i) t1) t2, generate_series(timestamptz '2000-01-01', timestamptz '2000-01-01 00:01:50', interval '0.5 second') t;
+SELECT bool_and(atTimestamp(p, t) IS NOT DISTINCT FROM atTimestamp(temp, t)) FROM (SELECT temp, pack(temp, true) AS p FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i * i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i), false, true, true) AS temp FROM generate_series(1, 100) i) t1) t2, generate_series(timestamptz '2000-01-01', timestamptz '2000-01-01 00:01:50', interval '0.5 second') t;
+SELECT bool_and(atTimestamp(p, t) IS NOT DISTINCT FROM atTimestamp(temp, t)) FROM (SELECT temp, pack(temp, 0.5, true) AS p FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i * i, -i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i)) AS temp FROM generate_series(1, 100) i) t1) t2, generate_series(timestamptz '2000-01-01', timestamptz '2000-01-01 00:01:50', interval '0.5 second') t;
+SELECT bool_and(ST_AsText(valueAtTimestamp(p, t)) IS NOT DISTINCT FROM ST_AsText(valueAtTimestamp(temp, t))) FROM (SELECT temp, pack(temp) AS p FROM (SELECT tgeogpointseq(array_agg(tgeogpointinst(ST_MakePoint(i / 10.0, i / 20.0)::geography, timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i)) AS temp FROM generate_series(1, 100) i) t1) t2, generate_series(timestamptz '2000-01-01', timestamptz '2000-01-01 00:01:50', interval '0.5 second') t;
+SELECT bool_and(atTimestamp(p, t) IS NOT DISTINCT FROM atTimestamp(temp, t)) FROM (SELECT temp, pack(temp) AS p FROM (SELECT tgeompointi(array_agg(tgeompointinst(ST_MakePoint(i, i * i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i)) AS temp FROM generate_series(1, 100) i) t1) t2, generate_series(timestamptz '2000-01-01', timestamptz '2000-01-01 00:01:50', interval '0.5 second') t;
+SELECT bool_and(atPeriod(p, period(t, t + interval '10.5 seconds', lower_inc, upper_inc)) IS NOT DISTINCT FROM atPeriod(temp, period(t, t + interval '10.5 seconds', lower_inc, upper_inc))) FROM (SELECT temp, pack(temp) AS p FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i * i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i), false, true, true) AS temp FROM generate_series(1, 100) i) t1) t2, generate_series(timestamptz '1999-12-31 23:59:50', timestamptz '2000-01-01 00:01:50', interval '2.5 second') t, (VALUES (true, true), (true, false), (false, true), (false, false)) b(lower_inc, upper_inc);
+SELECT bool_and(atPeriod(p, period(t, t + interval '10.5 seconds')) IS NOT DISTINCT FROM atPeriod(temp, period(t, t + interval '10.5 seconds'))) FROM (SELECT temp, pack(temp, true) AS p FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i * i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i), false, true, false) AS temp FROM generate_series(1, 100) i) t1) t2, generate_series(timestamptz '1999-12-31 23:59:50', timestamptz '2000-01-01 00:01:50', interval '2.5 second') t;
+SELECT bool_and(atPeriod(p, period(t, t + interval '10.5 seconds')) IS NOT DISTINCT FROM atPeriod(temp, period(t, t + interval '10.5 seconds'))) FROM (SELECT temp, pack(temp, 0.5, true) AS p FROM (SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(i, i * i, -i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i)) AS temp FROM generate_series(1, 100) i) t1) t2, generate_series(timestamptz '1999-12-31 23:59:50', timestamptz '2000-01-01 00:01:50', interval '2.5 second') t;
+SELECT bool_and(atPeriod(p, period(t, t + interval '10.5 seconds')) IS NOT DISTINCT FROM atPeriod(temp, period(t, t + interval '10.5 seconds'))) FROM (SELECT temp, pack(temp) AS p FROM (SELECT tgeompointi(array_agg(tgeompointinst(ST_MakePoint(i, i * i), timestamptz '2000-01-01' + i * interval '1 second') ORDER BY i)) AS temp FROM generate_series(1, 100) i) t1) t2, generate_series(timestamptz '1999-12-31 23:59:50', timestamptz '2000-01-01 00:01:50', interval '2.5 second') t;
+/* Errors */
+SELECT pack(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]', 0);
+SELECT pack(tgeompoint '[Point(0 0)@2000-01-01, Point(1000 0)@2000-01-02]', 1e-7);
 
 SELECT stbox(tgeompoint 'Point(1 1)@2000-01-01');
 SELECT setprecision(stbox(tgeogpoint 'Point(1.5 1.5)@2000-01-01'), 13);
@@ -0,0 +1,12 @@
+SELECT tgeompoint_hash(tgeompoint 'Point(1 1)@2000-01-01') = tgeompoint_hash(tgeompoint '{Point(1 1)@2000-01-01}');
+SELECT tgeompoint_hash_extended(tgeompoint 'Point(1 1)@2000-01-01', 1) = tgeompoint_hash_extended(tgeompoint '[Point(1 1)@2000-01-01]', 1);
+SELECT tgeompoint_hash_extended(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]', 1) <> tgeompoint_hash_extended(tgeompoint '[Point(1 1)@2000-01-01, Point(2 3)@2000-01-02]', 1);
+SELECT tgeogpoint_hash_extended(tgeogpoint 'Point(1 1)@2000-01-01', 1) = tgeogpoint_hash_extended(tgeogpoint '{[Point(1 1)@2000-01-01]}', 1);
+SELECT bool_and(tgeompoint_hash_extended(temp, 1) = tgeompoint_hash_extended(temp, 1)) FROM tbl_tgeompoint;
+SELECT bool_and(tgeogpoint_hash_extended(temp, 1) = tgeogpoint_hash_extended(temp, 1)) FROM tbl_tgeogpoint;
+SELECT (tgeompoint_hash_extended(tgeompoint 'Point(1 1)@2000-01-01', 0) & 4294967295) = (tgeompoint_hash(tgeompoint 'Point(1 1)@2000-01-01')::bigint & 4294967295);
+SELECT (tgeompoint_hash_extended(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02]', 0) & 4294967295) = (tgeompoint_hash(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02]')::bigint & 4294967295);
+SELECT (tgeogpoint_hash_extended(tgeogpoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02], [Point(3 3)@2000-01-03]}', 0) & 4294967295) = (tgeogpoint_hash(tgeogpoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02], [Point(3 3)@2000-01-03]}')::bigint & 4294967295);
+SELECT bool_and((tgeompoint_hash_extended(temp, 0) & 4294967295) = (tgeompoint_hash(temp)::bigint & 4294967295)) FROM tbl_tgeompoint;
+SELECT bool_and((tgeogpoint_hash_extended(temp, 0) & 4294967295) = (tgeogpoint_hash(temp)::bigint & 4294967295)) FROM tbl_tgeogpoint;
+SELECT bool_and((tgeompoint_hash_extended(temp, 0) & 4294967295) = (tgeompoint_hash(temp)::bigint & 4294967295)) FROM tbl_tgeompoint3D;
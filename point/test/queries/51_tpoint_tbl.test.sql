@@ -17,6 +17,48 @@ COPY tbl_tgeogpoint_tmp FROM '/tmp/tbl_tgeogpoint' (FORMAT BINARY);
 DROP TABLE tbl_tgeompoint_tmp;
 DROP TABLE tbl_tgeogpoint_tmp;
 
+SET mobilitydb.binary_format = compact;
+COPY tbl_tgeompoint TO '/tmp/tbl_tgeompoint_compact' (FORMAT BINARY);
+COPY tbl_tgeompoint3D TO '/tmp/tbl_tgeompoint3D_compact' (FORMAT BINARY);
+COPY tbl_tgeogpoint TO '/tmp/tbl_tgeogpoint_compact' (FORMAT BINARY);
+COPY tbl_tgeogpoint3D TO '/tmp/tbl_tgeogpoint3D_compact' (FORMAT BINARY);
+COPY (SELECT temp FROM tbl_tgeompoint3D WHERE temp IS NOT NULL LIMIT 1) TO '/tmp/tgeompoint3D_compact' (FORMAT BINARY);
+RESET mobilitydb.binary_format;
+
+DROP TABLE IF EXISTS tbl_tgeompoint_tmp;
+DROP TABLE IF EXISTS tbl_tgeompoint3D_tmp;
+DROP TABLE IF EXISTS tbl_tgeogpoint_tmp;
+DROP TABLE IF EXISTS tbl_tgeogpoint3D_tmp;
+DROP TABLE IF EXISTS tbl_tgeompoint2D_one;
+DROP TABLE IF EXISTS tbl_tgeogpoint_one;
+
+CREATE TABLE tbl_tgeompoint_tmp AS TABLE tbl_tgeompoint WITH NO DATA;
+CREATE TABLE tbl_tgeompoint3D_tmp AS TABLE tbl_tgeompoint3D WITH NO DATA;
+CREATE TABLE tbl_tgeogpoint_tmp AS TABLE tbl_tgeogpoint WITH NO DATA;
+CREATE TABLE tbl_tgeogpoint3D_tmp AS TABLE tbl_tgeogpoint3D WITH NO DATA;
+CREATE TABLE tbl_tgeompoint2D_one(temp tgeompoint(Point));
+CREATE TABLE tbl_tgeogpoint_one(temp tgeogpoint);
+
+COPY tbl_tgeompoint_tmp FROM '/tmp/tbl_tgeompoint_compact' (FORMAT BINARY);
+COPY tbl_tgeompoint3D_tmp FROM '/tmp/tbl_tgeompoint3D_compact' (FORMAT BINARY);
+COPY tbl_tgeogpoint_tmp FROM '/tmp/tbl_tgeogpoint_compact' (FORMAT BINARY);
+COPY tbl_tgeogpoint3D_tmp FROM '/tmp/tbl_tgeogpoint3D_compact' (FORMAT BINARY);
+-- The compact values are not read as geographies and must match the typmod
+COPY tbl_tgeogpoint_one FROM '/tmp/tgeompoint3D_compact' (FORMAT BINARY);
+COPY tbl_tgeompoint2D_one FROM '/tmp/tgeompoint3D_compact' (FORMAT BINARY);
+
+SELECT COUNT(*) FROM tbl_tgeompoint t1 FULL JOIN tbl_tgeompoint_tmp t2 ON t1.k = t2.k WHERE t1.temp IS DISTINCT FROM t2.temp;
+SELECT COUNT(*) FROM tbl_tgeompoint3D t1 FULL JOIN tbl_tgeompoint3D_tmp t2 ON t1.k = t2.k WHERE t1.temp IS DISTINCT FROM t2.temp;
+SELECT COUNT(*) FROM tbl_tgeogpoint t1 FULL JOIN tbl_tgeogpoint_tmp t2 ON t1.k = t2.k WHERE t1.temp IS DISTINCT FROM t2.temp;
+SELECT COUNT(*) FROM tbl_tgeogpoint3D t1 FULL JOIN tbl_tgeogpoint3D_tmp t2 ON t1.k = t2.k WHERE t1.temp IS DISTINCT FROM t2.temp;
+
+DROP TABLE tbl_tgeompoint_tmp;
+DROP TABLE tbl_tgeompoint3D_tmp;
+DROP TABLE tbl_tgeogpoint_tmp;
+DROP TABLE tbl_tgeogpoint3D_tmp;
+DROP TABLE tbl_tgeompoint2D_one;
+DROP TABLE tbl_tgeogpoint_one;
+
 ------------------------------------------------------------------------------
 -- Transformation functions
 ------------------------------------------------------------------------------
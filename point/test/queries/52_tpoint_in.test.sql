@@ -14,6 +14,8 @@ SELECT asEWKT(fromMFJSON(asMFJSON(tgeompoint 'SRID=4326;Point(1 2 3)@2000-01-01'
 SELECT asEWKT(fromMFJSON(asMFJSON(tgeompoint 'SRID=4326;{Point(1 2 3)@2000-01-01, Point(4 5 6)@2000-01-02}',1,2)));
 SELECT asEWKT(fromMFJSON(asMFJSON(tgeompoint 'SRID=4326;[Point(1 2 3)@2000-01-01, Point(4 5 6)@2000-01-02]',1,2)));
 SELECT asEWKT(fromMFJSON(asMFJSON(tgeompoint 'SRID=4326;{[Point(1 2 3)@2000-01-01, Point(4 5 6)@2000-01-02],[Point(1 2 3)@2000-01-03, Point(4 5 6)@2000-01-04]}',1,2)));
+SELECT asEWKT(fromMFJSON('{ "interpolations" : ["Linear"], "upper_inc" : false, "lower_inc" : true, "datetimes" : ["2000-01-01T00:00:00.5+01:30", "2000-01-02T00:00:00Z"], "coordinates" : [[1.5, 2e1], [3, -4]], "type" : "MovingPoint" }'));
+SELECT asEWKT(fromMFJSON('{"type":"MovingPoint","coordinates":[1,2],"datetimes":"2000-01-01T12:00:00","interpolations":["Discrete"]}'));
 /* Errors */
 SELECT fromMFJSON('ABC');
 SELECT fromMFJSON('{"types":"MovingPoint","coordinates":[1,1],"datetimes":"2000-01-01T00:00:00+01","interpolations":["Discrete"]}');
@@ -42,6 +44,7 @@ SELECT fromMFJSON('{"type":"MovingPoint","sequences":[],"interpolations":["Linea
 SELECT fromMFJSON('{"type":"MovingPoint","coordinates":[[1,1]],"datetimes":"2000-01-01T00:00:00+01","lower_inc":true,"upper_inc":true,"interpolations":["Linear"]}');
 
 SELECT fromMFJSON('{"type":"MovingPoint","coordinates":[[1,1]],"datetimes":[],"lower_inc":true,"upper_inc":true,"interpolations":["Linear"]}');
+SELECT fromMFJSON('{"type":"MovingPoint","coordinates":[[1,"a"]],"datetimes":["2000-01-01T00:00:00+01"],"interpolations":["Discrete"]}');
 
 -----------------------------------------------------------------------
 
@@ -60,6 +63,8 @@ SELECT asEWKT(fromEWKB(asEWKB(tgeompoint 'SRID=4326;{[Point(1 2 3)@2000-01-01, P
 
 select asEWKT(fromEWKB(asEWKB(tgeompoint 'SRID=5676;Point(1 1)@2000-01-01', 'XDR')));
 select asEWKT(fromEWKB(asEWKB(tgeompoint 'SRID=5676;Point(1 1 1)@2000-01-01', 'XDR')));
+select asEWKT(fromEWKB(decode('01430300000003000000000000F03F000000000000F03F0000000000000000000000000000004000000000000000400060D71D140000000000000000000840000000000000084000C0AE3B28000000', 'hex')));
+select asEWKT(fromEWKB(decode('01430300000007000000000000F03F000000000000F03F0000000000000000000000000000004000000000000000400060D71D140000000000000000000840000000000000084000C0AE3B28000000', 'hex')));
 /* Errors */
 select asEWKT(fromEWKB(asEWKB(tgeompoint 'SRID=5676;Point(1 1)@2000-01-01', 'ABC')));
 
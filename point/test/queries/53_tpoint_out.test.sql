@@ -65,6 +65,7 @@ SELECT asMFJSON(tgeompoint 'Point(1 1)@2000-01-01',-1);
 SELECT asMFJSON(tgeompoint 'SRID=4326;Point(50.813810 4.384260)@2019-01-01 18:00:00.15+02', 2, 3);
 SELECT asMFJSON(tgeompoint 'SRID=4326;Point(50.813810 4.384260)@2019-01-01 18:00:00.15+02', 2, 4);
 SELECT asMFJSON(tgeompoint '[Point(1 2 3)@2019-01-01, Point(4 5 6)@2019-01-02]', 2, 1);
+SELECT asMFJSON(tgeompoint '{Point(1 2)@2019-01-01 00:00:00.00012, Point(3.25 4)@2019-01-02 10:30:45.5}', 2, 1);
 
 /* Errors */
 SELECT asMFJSON(tgeompoint 'SRID=123456;Point(50.813810 4.384260)@2019-01-01 18:00:00.15+02', 2, 4);
@@ -92,3 +93,20 @@ SELECT astext('{}'::geometry[]);
 -------------------------------------------------------------------------------
 
 
+
+SELECT seq, t, x, y FROM points(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02], [Point(3 3)@2000-01-03]}');
+SELECT * FROM points(tgeompoint '{Point(1 1.5 2)@2000-01-01, Point(2 2.5 3)@2000-01-02}');
+SELECT COUNT(*) FROM points(tgeogpoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]');
+
+-------------------------------------------------------------------------------
+
+SELECT ST_AsText(geom), times FROM asMVTGeom(tgeompoint '[Point(1 1)@2000-01-01, Point(5 5)@2000-01-05, Point(15 5)@2000-01-15]', stbox 'STBOX((0,0),(10,10))', 10, 0);
+SELECT ST_AsText(geom), times FROM asMVTGeom(tgeompoint '[Point(1 1)@2000-01-01, Point(5 5)@2000-01-05]', stbox 'STBOX T((0,0,2000-01-01),(10,10,2000-01-03))', 10, 0, false);
+SELECT ST_AsText(geom), times FROM asMVTGeom(tgeompoint '[Point(1 1)@2000-01-01, Point(1.2 1.2)@2000-01-02, Point(8 8)@2000-01-03]', stbox 'STBOX((0,0),(10,10))', 10);
+SELECT ST_AsText(geom), times FROM asMVTGeom(tgeompoint '{Point(1 1)@2000-01-01, Point(3 3)@2000-01-02}', stbox 'STBOX((0,0),(10,10))', 10);
+SELECT geom IS NULL FROM asMVTGeom(tgeompoint '{Point(20 20)@2000-01-01}', stbox 'STBOX((0,0),(10,10))', 10, 0);
+/* Errors */
+SELECT asMVTGeom(tgeompoint 'Point(1 1)@2000-01-01', stbox 'STBOX((0,0),(10,10))', 0);
+SELECT asMVTGeom(tgeompoint 'Point(1 1)@2000-01-01', stbox 'STBOX((0,0),(0,10))');
+
+-------------------------------------------------------------------------------
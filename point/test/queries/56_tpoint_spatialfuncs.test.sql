@@ -61,6 +61,9 @@ SELECT startValue(transform(setSRID(tgeompoint 'Point(1 1 1)@2000-01-01', 5676),
 SELECT startValue(transform(setSRID(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}', 5676), 4326)) = st_transform(geometry 'SRID=5676;Point(1 1 1)', 4326);
 SELECT startValue(transform(setSRID(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]', 5676), 4326)) = st_transform(geometry 'SRID=5676;Point(1 1 1)', 4326);
 SELECT startValue(transform(setSRID(tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}', 5676), 4326)) = st_transform(geometry 'SRID=5676;Point(1 1 1)', 4326);
+SELECT valueAtTimestamp(transform(setSRID(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 3)@2000-01-03}', 5676), 4326), '2000-01-02') = st_transform(geometry 'SRID=5676;Point(2 2)', 4326);
+SELECT endValue(transform(setSRID(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02],[Point(3 3)@2000-01-04, Point(4 4)@2000-01-05]}', 5676), 4326)) = st_transform(geometry 'SRID=5676;Point(4 4)', 4326);
+SELECT endValue(transform(setSRID(tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02],[Point(3 3 3)@2000-01-04, Point(4 4 4)@2000-01-05]}', 5676), 4326)) = st_transform(geometry 'SRID=5676;Point(4 4 4)', 4326);
 
 --------------------------------------------------------
 
@@ -69,6 +72,8 @@ SELECT asEWKT(transform_gk(tgeompoint 'Point(13.43593 52.41721)@2018-12-20'));
 SELECT asEWKT(transform_gk(tgeompoint '{Point(13.43593 52.41721)@2018-12-20 10:00:00, Point(13.43605 52.41723)@2018-12-20 10:01:00}'));
 SELECT asEWKT(transform_gk(tgeompoint '[Point(13.43593 52.41721)@2018-12-20 10:00:00, Point(13.43605 52.41723)@2018-12-20 10:01:00]'));
 SELECT asEWKT(transform_gk(tgeompoint '{[Point(13.43593 52.41721)@2018-12-20 10:00:00, Point(13.43605 52.41723)@2018-12-20 10:01:00],[Point(13.43705 52.41724)@2018-12-20 10:02:00,Point(13.43805 52.41730)@2018-12-20 10:03:00]}'));
+SELECT ST_AsText(trajectory(transform_gk(tgeompoint '[Point(13.43593 52.41721)@2018-12-20 10:00:00, Point(13.43605 52.41723)@2018-12-20 10:01:00, Point(13.43705 52.41724)@2018-12-20 10:02:00]'))) = ST_AsText(transform_gk(geometry 'Linestring(13.43593 52.41721,13.43605 52.41723,13.43705 52.41724)'));
+SELECT asText(transform_gk(tgeompoint '[Point(13.43593 52.41721 1)@2018-12-20 10:00:00, Point(13.43605 52.41723 1)@2018-12-20 10:01:00]')) = asText(transform_gk(tgeompoint '[Point(13.43593 52.41721)@2018-12-20 10:00:00, Point(13.43605 52.41723)@2018-12-20 10:01:00]'));
 
 -- PostGIS geometry
 SELECT ST_AsText(transform_gk(geometry 'Point Empty'));
@@ -109,6 +114,8 @@ SELECT ST_AsText(trajectory(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-
 SELECT ST_AsText(trajectory(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}'));
 SELECT ST_AsText(trajectory(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'));
 SELECT ST_AsText(trajectory(tgeompoint 'Interp=Stepwise;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}'));
+SELECT ST_AsText(trajectory(tgeompoint '{[Point(1 1)@2000-01-01], [Point(2 2)@2000-01-02], [Point(1 1)@2000-01-03], [Point(3 3)@2000-01-04], [Point(2 2)@2000-01-05]}'));
+SELECT ST_NumGeometries(trajectory(tgeompoints(array_agg(tgeompointseq(tgeompointinst(ST_MakePoint(i % 10, 0), timestamptz '2000-01-01' + i * interval '1 hour')) ORDER BY i)))) FROM generate_series(1, 100) i;
 SELECT ST_AsText(trajectory(tgeogpoint 'Point(1.5 1.5)@2000-01-01'));
 SELECT ST_AsText(trajectory(tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}'));
 SELECT ST_AsText(trajectory(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]'));
@@ -129,6 +136,12 @@ SELECT ST_AsText(trajectory(tgeompoint '{[Point(1 1)@2001-01-01], [Point(1 1)@20
 SELECT ST_AsText(trajectory(tgeogpoint '{[Point(1 1)@2001-01-01], [Point(1 1)@2001-02-01], [Point(1 1)@2001-03-01]}'));
 SELECT ST_AsText(trajectory(tgeompoint 'Interp=Stepwise;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02],[Point(1 1)@2000-01-03, Point(2 2)@2000-01-04]}'));
 
+SET mobilitydb.precompute_trajectory = off;
+SELECT ST_AsText(trajectory(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'));
+SELECT ST_AsText(trajectory(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}'));
+SELECT round(length(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]')::numeric, 6);
+RESET mobilitydb.precompute_trajectory;
+
 --------------------------------------------------------
 
 -- 2D
@@ -158,6 +171,16 @@ SELECT round(length(tgeogpoint '{[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2
 SELECT round(length(tgeogpoint 'Interp=Stepwise;[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03]')::numeric, 6);
 SELECT round(length(tgeogpoint 'Interp=Stepwise;{[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03],[Point(3.5 3.5 3.5)@2000-01-04, Point(3.5 3.5 3.5)@2000-01-05]}')::numeric, 6);
 
+SET mobilitydb.geodetic_accuracy = sphere;
+SELECT round(length(tgeogpoint '[Point(0 0)@2000-01-01, Point(0 1)@2000-01-02]')::numeric);
+SELECT round(length(tgeogpoint '[Point(4.35 50.85)@2000-01-01, Point(4.40 50.88)@2000-01-02]')::numeric);
+SELECT round(startValue(azimuth(tgeogpoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02]'))::numeric, 6);
+SET mobilitydb.geodetic_accuracy = fast;
+SELECT round(length(tgeogpoint '[Point(0 0)@2000-01-01, Point(0 1)@2000-01-02]')::numeric);
+SELECT round(length(tgeogpoint '[Point(4.35 50.85)@2000-01-01, Point(4.40 50.88)@2000-01-02]')::numeric);
+SELECT round(startValue(azimuth(tgeogpoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02]'))::numeric, 6);
+RESET mobilitydb.geodetic_accuracy;
+
 -- 2D
 SELECT round(cumulativeLength(tgeompoint 'Point(1 1)@2000-01-01'), 6);
 SELECT round(cumulativeLength(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}'), 6);
@@ -185,6 +208,21 @@ SELECT round(cumulativeLength(tgeogpoint '{[Point(1.5 1.5 1.5)@2000-01-01, Point
 SELECT round(cumulativeLength(tgeogpoint 'Interp=Stepwise;[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03]'), 6);
 SELECT round(cumulativeLength(tgeogpoint 'Interp=Stepwise;{[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03],[Point(3.5 3.5 3.5)@2000-01-04, Point(3.5 3.5 3.5)@2000-01-05]}'), 6);
 
+SELECT timeAtDistance(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 0)@2000-01-03]', 0);
+SELECT timeAtDistance(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 0)@2000-01-03]', 7);
+SELECT timeAtDistance(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 0)@2000-01-03]', 10);
+SELECT timeAtDistance(tgeompoint '{[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 4)@2000-01-03],[Point(3 4)@2000-01-04, Point(3 0)@2000-01-05]}', 5);
+SELECT timeAtDistance(tgeompoint '{[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 4)@2000-01-03],[Point(3 4)@2000-01-04, Point(3 0)@2000-01-05]}', 7);
+SELECT timeAtDistance(tgeompoint 'Interp=Stepwise;[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02]', 1);
+SELECT timeAtDistance(t, endValue(cumulativeLength(t))) = endTimestamp(t) FROM (SELECT tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]' AS t) x;
+SELECT ST_AsText(atDistance(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 0)@2000-01-03]', 7));
+SELECT ST_AsText(atDistance(tgeompoint '{[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 4)@2000-01-03],[Point(3 4)@2000-01-04, Point(3 0)@2000-01-05]}', 5));
+SELECT ST_AsText(atDistance(tgeompoint 'Point(1 1)@2000-01-01', 0));
+SELECT asText(substringByDistance(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 0)@2000-01-03]', 2.5, 7));
+SELECT asText(substringByDistance(tgeompoint '{[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 4)@2000-01-03],[Point(3 4)@2000-01-04, Point(3 0)@2000-01-05]}', 5, 5));
+SELECT substringByDistance(t, -1, 100) = t FROM (SELECT tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]' AS t) x;
+SELECT substringByDistance(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 0)@2000-01-03]', 10, 20);
+
 -- 2D
 SELECT round(speed(tgeompoint 'Point(1 1)@2000-01-01'), 6);
 SELECT round(speed(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}'), 6);
@@ -226,6 +264,15 @@ SELECT st_astext(twcentroid(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2
 SELECT st_astext(twcentroid(tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}'));
 SELECT st_astext(twcentroid(tgeompoint 'Interp=Stepwise;[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]'));
 SELECT st_astext(twcentroid(tgeompoint 'Interp=Stepwise;{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}'));
+SELECT st_astext(twcentroid(tgeogpoint 'Point(1 1)@2000-01-01'));
+SELECT st_astext(twcentroid(tgeogpoint '{Point(0 0)@2000-01-01, Point(90 0)@2000-01-02}'));
+SELECT st_astext(twcentroid(tgeogpoint '[Point(0 0)@2000-01-01, Point(90 0)@2000-01-02, Point(0 0)@2000-01-03]'));
+SELECT st_astext(twcentroid(tgeogpoint 'Interp=Stepwise;{[Point(0 0)@2000-01-01, Point(0 0)@2000-01-02],[Point(90 0)@2000-01-03, Point(90 0)@2000-01-04]}'));
+SELECT st_astext(twcentroid(tgeogpoint '[Point(0 0 10)@2000-01-01, Point(90 0 20)@2000-01-02]'));
+SELECT round(ST_X(twcentroid(tgeogpoint '[Point(0 0)@2000-01-01, Point(90 0)@2000-01-02, Point(90 0)@2000-01-03]')::geometry)::numeric, 6);
+
+/* Errors */
+SELECT twcentroid(tgeogpoint '{Point(0 0)@2000-01-01, Point(180 0)@2000-01-02}');
 
 -- 2D
 SELECT round(degrees(azimuth(tgeompoint 'Point(1 1)@2000-01-01')), 6);
@@ -279,6 +326,11 @@ SELECT round(degrees(azimuth(tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000
 SELECT round(degrees(azimuth(tgeompoint '(Point(0 0)@2000-01-01, Point(1 1)@2000-01-02, Point(1 1)@2000-01-03, Point(0 0)@2000-01-04]')), 6);
 SELECT round(degrees(azimuth(tgeompoint '(Point(0 0)@2000-01-01, Point(1 1)@2000-01-02, Point(1 1)@2000-01-03, Point(0 0)@2000-01-04)')), 6);
 
+SELECT k.length = length(t) AND k.cumulativeLength = cumulativeLength(t) AND k.speed = speed(t) AND k.azimuth = azimuth(t) FROM (SELECT tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}' AS t) x, kinematics(t) k;
+SELECT k.length = length(t) AND k.cumulativeLength = cumulativeLength(t) AND k.speed = speed(t) AND k.azimuth = azimuth(t) FROM (SELECT tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}' AS t) x, kinematics(t) k;
+SELECT round((kinematics(tgeompoint '[Point(0 0)@2000-01-01 00:00:00, Point(10 0)@2000-01-01 00:00:10, Point(30 0)@2000-01-01 00:00:20]')).acceleration, 6);
+SELECT (kinematics(tgeompoint 'Point(1 1)@2000-01-01')).speed IS NULL;
+
 --------------------------------------------------------
 
 -- 2D
@@ -313,6 +365,8 @@ SELECT asText(atGeometry(tgeompoint 'Interp=Stepwise;{[Point(1 1 1)@2000-01-01,
 SELECT asText(atGeometry(tgeompoint '[Point(1 1)@2000-01-01]', geometry 'Linestring(0 0,1 1)'));
 SELECT asText(atGeometry(tgeompoint '[Point(1 1)@2000-01-01, Point(3 3)@2000-01-02]','Point(2 2)'));
 SELECT asText(atGeometry(tgeompoint '[Point(0 1)@2000-01-01,Point(5 1)@2000-01-05]', geometry 'Linestring(0 0,2 2,3 1,4 1,5 0)'));
+SELECT asText(atGeometry(tgeompoint '[Point(0 1)@2000-01-01, Point(4 1)@2000-01-05]', geometry 'Polygon((1 0,3 0,3 2,1 2,1 0),(1.5 0.5,2.5 0.5,2.5 1.5,1.5 1.5,1.5 0.5))'));
+SELECT asText(atGeometry(tgeompoint '[Point(0 2)@2000-01-01, Point(2 0)@2000-01-03]', geometry 'Polygon((1 1,2 1,2 2,1 2,1 1))'));
 
 -- NULL
 SELECT asText(atGeometry(tgeompoint '[Point(1 1)@2000-01-01]', geometry 'Linestring(2 2,3 3)'));
@@ -354,6 +408,7 @@ SELECT asText(minusGeometry(tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-
 SELECT asText(minusGeometry(tgeompoint '{[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02)}', geometry 'Linestring(0 1,2 1)'));
 SELECT asText(minusGeometry(tgeompoint '[Point(1 1)@2000-01-01, Point(3 3)@2000-01-02]','Point(2 2)'));
 SELECT asText(minusGeometry(tgeompoint '{[Point(1 1)@2000-01-01, Point(3 3)@2000-01-02],[Point(3 3)@2000-01-03]}','Point(2 2)'));
+SELECT asText(minusGeometry(tgeompoint '[Point(0 1)@2000-01-01, Point(4 1)@2000-01-05]', geometry 'Polygon((1 0,3 0,3 2,1 2,1 0),(1.5 0.5,2.5 0.5,2.5 1.5,1.5 1.5,1.5 0.5))'));
 /* Errors */
 SELECT minusGeometry(tgeompoint 'Point(1 1)@2000-01-01', geometry 'SRID=5676;Linestring(1 1,2 2)');
 SELECT minusGeometry(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring(1 1 1,2 2 2)');
@@ -366,6 +421,10 @@ SELECT asText(atStbox(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02,
 SELECT asText(atStbox(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', 'STBOX T((1,1,2000-01-01),(2,2,2000-01-02))'));
 SELECT asText(atStbox(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', 'STBOX T((1,1,2000-01-01),(2,2,2000-01-02))'));
 SELECT asText(atStbox(tgeompoint 'Interp=Stepwise;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', 'STBOX T((1,1,2000-01-01),(2,2,2000-01-02))'));
+SELECT asText(atStbox(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', 'STBOX((1,-1),(2,1))'));
+SELECT asText(atStbox(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05, Point(0 0)@2000-01-09]', 'STBOX T((1,-1,2000-01-01),(2,1,2000-01-08))'));
+SELECT asText(atStbox(tgeompoint '[Point(0 0 0)@2000-01-01, Point(4 4 4)@2000-01-05]', 'STBOX Z((1,1,1),(3,3,3))'));
+SELECT asText(atStbox(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(5 5)@2000-01-02, Point(1 1)@2000-01-03]', 'STBOX((0,0),(2,2))'));
 
 SELECT asText(atStbox(tgeompoint 'Point(1 1)@2000-01-01', 'STBOX((1,1),(2,2))'));
 SELECT asText(atStbox(tgeompoint 'Point(1 1)@2000-01-01', 'STBOX T((,2000-01-01),(,2000-01-02))'));
@@ -377,9 +436,14 @@ SELECT asText(minusStbox(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01
 SELECT asText(minusStbox(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', 'STBOX T((1,1,2000-01-01),(2,2,2000-01-02))'));
 SELECT asText(minusStbox(tgeompoint 'Interp=Stepwise;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', 'STBOX T((1,1,2000-01-01),(2,2,2000-01-02))'));
 
+SELECT tile, asText(temp) FROM spaceTimeSplit(tgeompoint '[Point(1 1)@2000-01-01, Point(5 1)@2000-01-05]', 2, interval '1 week');
+SELECT tile, box FROM spaceTimeSplit(tgeompoint 'Point(1 1)@2000-01-01 12:00', 2, interval '1 day');
+SELECT tile, asText(temp) FROM spaceTimeSplit(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(3 1)@2000-01-02, Point(1 1)@2000-01-03]', 2, interval '1 week', 'Point(0 0)', '1999-12-31');
+
 /* Errors */
 SELECT asText(atStbox(tgeompoint 'SRID=4326;Point(1 1)@2000-01-01', 'GEODSTBOX T((1,1,1,2000-01-01),(2,2,2,2000-01-02))'));
 SELECT asText(atStbox(tgeompoint 'SRID=5676;Point(1 1)@2000-01-01', 'STBOX T((1,1,2000-01-01),(2,2,2000-01-02))'));
 SELECT asText(atStbox(tgeompoint 'Point(1 1)@2000-01-01', 'STBOX ZT((1,1,1,2000-01-01),(2,2,2,2000-01-02))'));
+SELECT tile FROM spaceTimeSplit(tgeompoint 'Point(1 1)@2000-01-01', 0, interval '1 day');
 
 -------------------------------------------------------------------------------
@@ -757,3 +757,32 @@ WHERE noidx <> gistidx
 ORDER BY op, leftarg, rightarg;
 
 -------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Test the join selectivity
+-------------------------------------------------------------------------------
+
+ANALYZE tbl_tgeompoint;
+ANALYZE tbl_tgeogpoint;
+
+SELECT (SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t1.temp && t2.temp) = (SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t2.temp && t1.temp);
+SELECT (SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t1.temp @> t2.temp) = (SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t2.temp <@ t1.temp);
+SELECT (SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t1.temp <<# t2.temp) = (SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t2.temp #>> t1.temp);
+SELECT (SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t1.temp << t2.temp) = (SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t2.temp >> t1.temp);
+SELECT (SELECT count(*) FROM tbl_tgeogpoint t1, tbl_tgeogpoint t2 WHERE t1.temp && t2.temp) = (SELECT count(*) FROM tbl_tgeogpoint t1, tbl_tgeogpoint t2 WHERE t2.temp && t1.temp);
+SELECT (SELECT count(*) FROM tbl_tgeogpoint t1, tbl_tgeogpoint t2 WHERE t1.temp @> t2.temp) = (SELECT count(*) FROM tbl_tgeogpoint t1, tbl_tgeogpoint t2 WHERE t2.temp <@ t1.temp);
+
+-------------------------------------------------------------------------------
+-- Test the selectivity with the space-time histogram
+-------------------------------------------------------------------------------
+
+SELECT stakind5 FROM pg_statistic WHERE starelid = 'tbl_tgeompoint'::regclass AND staattnum = (SELECT attnum FROM pg_attribute WHERE attrelid = 'tbl_tgeompoint'::regclass AND attname = 'temp');
+SELECT stakind5 FROM pg_statistic WHERE starelid = 'tbl_tgeogpoint'::regclass AND staattnum = (SELECT attnum FROM pg_attribute WHERE attrelid = 'tbl_tgeogpoint'::regclass AND attname = 'temp');
+SELECT (SELECT count(*) FROM tbl_tgeompoint WHERE temp && stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))') = (SELECT count(*) FROM tbl_tgeompoint WHERE stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))' && temp);
+SELECT (SELECT count(*) FROM tbl_tgeompoint WHERE temp @> stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))') = (SELECT count(*) FROM tbl_tgeompoint WHERE stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))' <@ temp);
+SELECT (SELECT count(*) FROM tbl_tgeompoint WHERE temp <@ stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))') = (SELECT count(*) FROM tbl_tgeompoint WHERE stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))' @> temp);
+SELECT (SELECT count(*) FROM tbl_tgeompoint WHERE temp << stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))') = (SELECT count(*) FROM tbl_tgeompoint WHERE stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))' >> temp);
+SELECT (SELECT count(*) FROM tbl_tgeompoint WHERE temp <<| stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))') = (SELECT count(*) FROM tbl_tgeompoint WHERE stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))' |>> temp);
+SELECT (SELECT count(*) FROM tbl_tgeompoint WHERE temp <<# stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))') = (SELECT count(*) FROM tbl_tgeompoint WHERE stbox 'STBOX T((10, 10, 2001-01-01), (50, 50, 2001-06-01))' #>> temp);
+
+-------------------------------------------------------------------------------
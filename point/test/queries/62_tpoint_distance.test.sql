@@ -20,6 +20,7 @@ SELECT round(geometry 'Point(1 1)' <-> tgeompoint 'Point(2 2)@2000-01-01', 6);
 SELECT round(geometry 'Point(1 1)' <-> tgeompoint '{Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03}', 6);
 SELECT round(geometry 'Point(1 1)' <-> tgeompoint '[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03]', 6);
 SELECT round(geometry 'Point(2 2)' <-> tgeompoint '[Point(1 1)@2000-01-01, Point(3 3)@2000-01-03]', 6);
+SELECT round(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]' <-> geometry 'Point(1 1)', 6);
 SELECT round(geometry 'Point(1 1)' <-> tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', 6);
 
 SELECT round(geometry 'Point empty' <-> tgeompoint 'Point(2 2)@2000-01-01', 6);
@@ -113,6 +114,7 @@ SELECT round(tgeompoint 'Point(1 1)@2000-01-01' <-> tgeompoint '{[Point(2 2)@200
 SELECT round(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}' <-> tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', 6);
 SELECT round(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]' <-> tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', 6);
 SELECT round(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}' <-> tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', 6);
+SELECT round(tgeompoint '{[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03],[Point(2 2)@2000-01-04, Point(2 2)@2000-01-05]}' <-> tgeompoint '[Point(2 0)@2000-01-01, Point(0 0)@2000-01-03, Point(2 0)@2000-01-05]', 6);
 
 SELECT round(tgeompoint 'Point(1 1 1)@2000-01-01' <-> tgeompoint 'Point(2 2 2)@2000-01-01', 6);
 SELECT round(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}' <-> tgeompoint 'Point(2 2 2)@2000-01-01', 6);
@@ -188,6 +190,7 @@ SELECT asText(setPrecision(NearestApproachInstant(tgeogpoint 'Point(1.5 1.5)@200
 SELECT asText(setPrecision(NearestApproachInstant(tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}', geography 'Linestring(0 0,3 3)'),6));
 SELECT asText(setPrecision(NearestApproachInstant(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]', geography 'Linestring(0 0,3 3)'),6));
 SELECT asText(setPrecision(NearestApproachInstant(tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}', geography 'Linestring(0 0,3 3)'),6));
+SELECT DISTINCT asText(setPrecision(NearestApproachInstant(shift(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]', i * interval '0 days'), geography 'Linestring(0 0,3 3)'),6)) FROM generate_series(1, 3) i;
 SELECT asText(NearestApproachInstant(tgeogpoint 'Interp=Stepwise;[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]', geography 'Linestring(0 0,3 3)'));
 SELECT asText(NearestApproachInstant(tgeogpoint 'Interp=Stepwise;{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}', geography 'Linestring(0 0,3 3)'));
 SELECT asText(setPrecision(NearestApproachInstant(tgeogpoint 'Point(1.5 1.5)@2000-01-01', geography 'Linestring empty'),6));
@@ -478,6 +481,7 @@ SELECT round((tgeogpoint 'Point(1.5 1.5)@2000-01-01' |=| geography 'Linestring(0
 SELECT round((tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}' |=| geography 'Linestring(0 0,3 3)')::numeric, 6);
 SELECT round((tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]' |=| geography 'Linestring(0 0,3 3)')::numeric, 6);
 SELECT round((tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}' |=| geography 'Linestring(0 0,3 3)')::numeric, 6);
+SELECT DISTINCT round((shift(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]', i * interval '0 days') |=| geography 'Linestring(0 0,3 3)')::numeric, 6) FROM generate_series(1, 3) i;
 
 SELECT round((tgeogpoint 'Point(1.5 1.5)@2000-01-01' |=| geography 'Linestring empty')::numeric, 6);
 SELECT round((tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}' |=| geography 'Linestring empty')::numeric, 6);
@@ -568,6 +572,10 @@ SELECT round((tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Poi
 SELECT round((tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]' |=| tgeompoint '{[Point(2 2 2)@2000-01-01, Point(1 1 1)@2000-01-02, Point(2 2 2)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}')::numeric, 6);
 SELECT round((tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}' |=| tgeompoint '{[Point(2 2 2)@2000-01-01, Point(1 1 1)@2000-01-02, Point(2 2 2)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}')::numeric, 6);
 
+SELECT round((tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-03]' |=| tgeompoint '[Point(2 0)@2000-01-01, Point(0 2)@2000-01-03]')::numeric, 6);
+SELECT round((tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]' |=| tgeompoint '[Point(3 3)@2000-01-03, Point(3 1)@2000-01-05]')::numeric, 6);
+SELECT round((tgeompoint '{[Point(0 0)@2000-01-01, Point(10 0)@2000-01-02],[Point(0 5)@2000-01-03, Point(10 5)@2000-01-04]}' |=| tgeompoint '{[Point(0 1)@2000-01-01, Point(10 1)@2000-01-02],[Point(100 100)@2000-01-03, Point(101 100)@2000-01-04]}')::numeric, 6);
+
 SELECT round((tgeogpoint 'Point(1.5 1.5)@2000-01-01' |=| tgeogpoint 'Point(2.5 2.5)@2000-01-01')::numeric, 6);
 SELECT round((tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}' |=| tgeogpoint 'Point(2.5 2.5)@2000-01-01')::numeric, 6);
 SELECT round((tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]' |=| tgeogpoint 'Point(2.5 2.5)@2000-01-01')::numeric, 6);
@@ -636,6 +644,7 @@ SELECT ST_AsTexT(shortestLine(tgeogpoint 'Point(1.5 1.5)@2000-01-01', geography
 SELECT ST_AsTexT(shortestLine(tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}', geography 'Linestring(0 0,3 3)'), 1);
 SELECT ST_AsTexT(shortestLine(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]', geography 'Linestring(0 0,3 3)'), 1);
 SELECT ST_AsTexT(shortestLine(tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}', geography 'Linestring(0 0,3 3)'), 1);
+SELECT DISTINCT ST_AsTexT(shortestLine(shift(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]', i * interval '0 days'), geography 'Linestring(0 0,3 3)'), 1) FROM generate_series(1, 3) i;
 
 SELECT ST_AsTexT(shortestLine(tgeogpoint 'Point(1.5 1.5)@2000-01-01', geography 'Linestring empty'));
 SELECT ST_AsTexT(shortestLine(tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}', geography 'Linestring empty'));
@@ -761,3 +770,33 @@ SELECT shortestLine(geography 'Linestring(0 0 0,3 3 3)', tgeogpoint 'Point(1.5 1
 SELECT shortestLine(tgeogpoint 'Point(1.5 1.5 1.5)@2000-01-01', geography 'Linestring(0 0 0,3 3 3)');
 
 --------------------------------------------------------
+
+SELECT round(frechetDistance(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02, Point(2 0)@2000-01-03]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]')::numeric, 6);
+SELECT round(frechetDistance(tgeompoint 'Point(0 0)@2000-01-01', tgeompoint '{Point(3 4)@2000-01-01, Point(0 0)@2000-01-02}')::numeric, 6);
+SELECT round(frechetDistance(tgeompoint '{[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02],[Point(2 2)@2000-01-04]}', tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-05]')::numeric, 6);
+SELECT round(frechetDistance(tgeompoint '[Point(0 0 0)@2000-01-01, Point(0 0 2)@2000-01-02]', tgeompoint 'Point(0 0 1)@2000-01-01')::numeric, 6);
+SELECT round(dynTimeWarpDistance(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02, Point(2 0)@2000-01-03]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]')::numeric, 6);
+SELECT round(dynTimeWarpDistance(tgeompoint 'Point(0 0)@2000-01-01', tgeompoint '{Point(3 4)@2000-01-01, Point(0 0)@2000-01-02}')::numeric, 6);
+SELECT round(dynTimeWarpDistance(tgeompoint '{[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02],[Point(2 2)@2000-01-04]}', tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-05]')::numeric, 6);
+SELECT round(dynTimeWarpDistance(tgeompoint '[Point(0 0 0)@2000-01-01, Point(0 0 2)@2000-01-02]', tgeompoint 'Point(0 0 1)@2000-01-01')::numeric, 6);
+SELECT tgeompoint '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-02]' <~> tgeompoint '[Point(0 1)@2001-01-01, Point(10 1)@2001-01-02]';
+SELECT tgeompoint '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-02]' <~~> tgeompoint '[Point(0 1)@2001-01-01, Point(10 1)@2001-01-02]';
+CREATE TABLE tbl_similarity(k int, temp tgeompoint);
+INSERT INTO tbl_similarity VALUES (1, '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-02]'), (2, '[Point(0 5)@2000-01-01, Point(10 5)@2000-01-02]'), (3, '[Point(0 1)@2001-01-01, Point(10 1)@2001-01-02]'), (4, '[Point(0 100)@2000-01-01, Point(10 100)@2000-01-02]');
+SET enable_seqscan = off;
+CREATE INDEX tbl_similarity_gist_idx ON tbl_similarity USING GIST(temp);
+SELECT k FROM tbl_similarity ORDER BY temp <~> tgeompoint '[Point(0 1)@2000-01-01, Point(10 1)@2000-01-02]' LIMIT 2;
+SELECT k FROM tbl_similarity ORDER BY temp <~~> tgeompoint '[Point(0 1)@2000-01-01, Point(10 1)@2000-01-02]' LIMIT 2;
+DROP INDEX tbl_similarity_gist_idx;
+CREATE INDEX tbl_similarity_multi_idx ON tbl_similarity USING GIST(temp gist_tgeompoint_multi_ops);
+SELECT k FROM tbl_similarity ORDER BY temp <~> tgeompoint '[Point(0 1)@2000-01-01, Point(10 1)@2000-01-02]' LIMIT 2;
+SELECT k FROM tbl_similarity ORDER BY temp <~~> tgeompoint '[Point(0 1)@2000-01-01, Point(10 1)@2000-01-02]' LIMIT 2;
+RESET enable_seqscan;
+DROP TABLE tbl_similarity;
+/* Errors */
+SELECT frechetDistance(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'SRID=5676;Point(1 1)@2000-01-01');
+SELECT frechetDistance(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'Point(1 1 1)@2000-01-01');
+SELECT dynTimeWarpDistance(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'SRID=5676;Point(1 1)@2000-01-01');
+SELECT dynTimeWarpDistance(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'Point(1 1 1)@2000-01-01');
+
+--------------------------------------------------------
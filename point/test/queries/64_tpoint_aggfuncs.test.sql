@@ -11,6 +11,12 @@ SELECT asText(tcentroid(temp)) FROM (VALUES
   (tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02)'),
   (tgeompoint '[Point(3 3 3)@2000-01-03, Point(4 4 4)@2000-01-04)'),
   (tgeompoint '[Point(2 2 2)@2000-01-02, Point(3 3 3)@2000-01-03)')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES 
+  (tgeogpoint 'Point(0 0)@2000-01-01'),
+  (tgeogpoint 'Point(90 0)@2000-01-01')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES 
+  (tgeogpoint '[Point(0 0)@2000-01-01, Point(0 0)@2000-01-02]'),
+  (tgeogpoint '[Point(90 0)@2000-01-01, Point(90 0)@2000-01-02]')) t(temp);
 
 /* Errors */
 SELECT asText(tcentroid(temp)) FROM (VALUES 
@@ -33,6 +39,8 @@ SELECT asText(tcentroid(temp)) FROM (VALUES
   (tgeompoint '[Point(0 0)@2000-01-01]'),
   (tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]'),
   ('Point(2 2 2)@2000-01-01')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES 
+  (tgeogpoint 'Point(0 0 0)@2000-01-01')) t(temp);
   
 -------------------------------------------------------------------------------
 
@@ -54,3 +62,59 @@ SELECT extent(temp) FROM (VALUES
   (tgeompoint 'Point(1 1)@2000-01-01')) t(temp);
 
 -------------------------------------------------------------------------------
+
+SELECT asText(appendInstant(temp)) FROM (VALUES
+  (tgeompoint 'Point(1 1)@2000-01-01'),
+  (tgeompoint 'Point(2 2)@2000-01-02'),
+  (tgeompoint 'Point(2 3)@2000-01-03')) t(temp);
+SELECT asText(appendInstant(temp, 0.5)) FROM (VALUES
+  (tgeompoint 'Point(0 0)@2000-01-01'),
+  (tgeompoint 'Point(1 0.1)@2000-01-02'),
+  (tgeompoint 'Point(2 0)@2000-01-03'),
+  (tgeompoint 'Point(3 5)@2000-01-04'),
+  (tgeompoint 'Point(4 5)@2000-01-05')) t(temp);
+SELECT numInstants(appendInstant(tgeompointinst(ST_MakePoint(i, (i % 2) * 0.1), timestamptz '2000-01-01' + i * interval '1 hour'), 0.2 ORDER BY i)) FROM generate_series(0, 10) i;
+SELECT numInstants(appendInstant(tgeompointinst(ST_MakePoint(i, (i % 2) * 0.1), timestamptz '2000-01-01' + i * interval '1 hour'), 0.05 ORDER BY i)) FROM generate_series(0, 10) i;
+
+/* Errors */
+SELECT appendInstant(temp) FROM (VALUES
+  (tgeompoint 'Point(1 1 1)@2000-01-01'),
+  (tgeompoint 'Point(1 1)@2000-01-02')) t(temp);
+
+-------------------------------------------------------------------------------
+
+SELECT (unnest(gridOccupancy(temp, 2, interval '1 day'))).* FROM (VALUES
+  (tgeompoint '[Point(1 1)@2000-01-01, Point(3 1)@2000-01-03]'),
+  (tgeompoint 'Point(1.5 0.5)@2000-01-01 12:00:00')) t(temp);
+SELECT (unnest(gridOccupancy(temp, 2, interval '1 day', geometry 'Point(1 1)', timestamptz '2000-01-01 12:00:00'))).* FROM (VALUES
+  (tgeompoint 'Interp=Stepwise;[Point(1.5 1.5)@2000-01-01 12:00:00, Point(3.5 1.5)@2000-01-02 12:00:00]')) t(temp);
+SELECT count, duration FROM (SELECT (unnest(gridOccupancy(temp, 10, interval '1 day'))).* FROM (VALUES
+  (tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-01 12:00:00]'),
+  (tgeompoint '[Point(3 3)@2000-01-01 06:00:00, Point(4 4)@2000-01-01 12:00:00]'),
+  (tgeompoint '{Point(5 5)@2000-01-01 18:00:00}')) t(temp)) c;
+
+/* Errors */
+SELECT gridOccupancy(temp, 0, interval '1 day') FROM (VALUES
+  (tgeompoint 'Point(1 1)@2000-01-01')) t(temp);
+SELECT gridOccupancy(temp, 1, interval '1 month') FROM (VALUES
+  (tgeompoint 'Point(1 1)@2000-01-01')) t(temp);
+
+-------------------------------------------------------------------------------
+
+SELECT asText(tgeompointSeqAgg(geom, t)) FROM (VALUES
+  (geometry 'Point(3 3)', timestamptz '2000-01-03'), ('Point(1 1)', '2000-01-01'),
+  ('Point(2 2)', '2000-01-02'), ('Point(9 9)', '2000-01-01'), ('Point(4 4)', '2000-01-05')) t(geom, t);
+SELECT asText(tgeompointSeqAgg(geom, t, interval '1 day', NULL)) FROM (VALUES
+  (geometry 'Point(3 3)', timestamptz '2000-01-03'), ('Point(1 1)', '2000-01-01'),
+  ('Point(2 2)', '2000-01-02'), ('Point(9 9)', '2000-01-01'), ('Point(4 4)', '2000-01-05')) t(geom, t);
+SELECT asText(tgeompointSeqAgg(geom, t, NULL, 1.0)) FROM (VALUES
+  (geometry 'Point(3 3)', timestamptz '2000-01-03'), ('Point(1 1)', '2000-01-01'),
+  ('Point(2 2)', '2000-01-02'), ('Point(9 9)', '2000-01-01'), ('Point(4 4)', '2000-01-05')) t(geom, t);
+SELECT asText(tsample(tgeompoint '[Point(0 0)@2000-01-01, Point(4 4)@2000-01-03]', interval '12 hours'));
+/* Errors */
+SELECT tgeompointSeqAgg(geom, t) FROM (VALUES
+  (geometry 'SRID=4326;Point(1 1)', timestamptz '2000-01-01'), ('Point(2 2)', '2000-01-02')) t(geom, t);
+SELECT tgeompointSeqAgg(geom, t, interval '-1 day', NULL) FROM (VALUES
+  (geometry 'Point(1 1)', timestamptz '2000-01-01')) t(geom, t);
+
+-------------------------------------------------------------------------------
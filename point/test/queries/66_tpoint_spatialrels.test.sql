@@ -1385,6 +1385,12 @@ SELECT dwithin(tgeogpoint '{[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2
 
 SELECT dwithin(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]}', tgeompoint '{[Point(1 2)@2000-01-01, Point(2 3)@2000-01-02]}', 0.5);
 
+SELECT COUNT(*) FROM generate_series(-5, 15) i WHERE dwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11]', ST_MakePoint(i, 1), 2);
+SELECT COUNT(*) FROM generate_series(-5, 15) i WHERE dwithin(ST_MakePoint(i, 1), tgeompoint '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11]', 2);
+SELECT COUNT(*) FROM generate_series(0, 10) i WHERE dwithin(tgeogpoint '[Point(0 0)@2000-01-01, Point(0 1)@2000-01-11]', geography(ST_MakePoint(0, i * 0.1)), 1);
+SELECT COUNT(*) FROM generate_series(-5, 15) i WHERE intersects(('[Point(' || i || ' -1)@2000-01-01, Point(' || i || ' 6)@2000-01-02]')::tgeompoint, geometry 'Polygon((0 0,5 0,5 5,0 5,0 0))');
+SELECT COUNT(*) FROM generate_series(-5, 15) i WHERE contains(geometry 'Polygon((0 0,5 0,5 5,0 5,0 0))', ('[Point(' || i || ' 1)@2000-01-01, Point(' || i || ' 4)@2000-01-02]')::tgeompoint);
+
 /* Errors */
 SELECT dwithin(geometry 'SRID=5676;Point(1 1)', tgeompoint 'Point(1 1)@2000-01-01', 2);
 SELECT dwithin(tgeompoint 'Point(1 1)@2000-01-01', geometry 'SRID=5676;Point(1 1)', 2);
@@ -1578,4 +1584,11 @@ SELECT relate(geometry 'Point(1 1 1)', tgeompoint 'Point(1 1)@2000-01-01', 'T***
 SELECT relate(tgeompoint 'Point(1 1 1)@2000-01-01', geometry 'Point(1 1)', 'T*****FF*');
 SELECT relate(tgeompoint 'Point(1 1 1)@2000-01-01', tgeompoint 'Point(1 1)@2000-01-01', 'T*****FF*');
 
+/* Several relationships on the same rows */
+SELECT intersects(temp, geometry 'Linestring(0 2,2 0)'), dwithin(temp, geometry 'Point(7 7)', 2),
+  disjoint(temp, geometry 'Point(1 1)') FROM (VALUES
+(tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-02]'),
+(tgeompoint '{[Point(5 5)@2000-01-01, Point(6 6)@2000-01-02]}'),
+(tgeompoint 'Point(1 1)@2000-01-01')) t(temp);
+
 -------------------------------------------------------------------------------
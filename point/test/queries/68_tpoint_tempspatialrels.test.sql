@@ -21,6 +21,7 @@ SELECT tcontains(tgeompoint 'Point(1 1)@2000-01-01',  geometry 'Point empty');
 SELECT tcontains(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}',  geometry 'Point empty');
 SELECT tcontains(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]',  geometry 'Point empty');
 SELECT tcontains(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}',  geometry 'Point empty');
+SELECT tcontains(geometry 'Polygon((0 0,2 0,2 2,0 2,0 0))', tgeompoint '[Point(5 5)@2000-01-01, Point(6 5)@2000-01-02, Point(6 6)@2000-01-03]');
 
 /* Errors */
 SELECT tcontains(geometry 'SRID=5676;Point(1 1)', tgeompoint 'Point(1 1)@2000-01-01');
@@ -334,6 +335,7 @@ SELECT tintersects(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Po
 SELECT tintersects(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}',  geometry 'Point(1 1)');
 
 SELECT tintersects(tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-04]', geometry 'Linestring(1 0,1 1,2 1,2 0)');
+SELECT tintersects(tgeompoint '[Point(7 1)@2000-01-01, Point(5 1)@2000-01-02, Point(3 1)@2000-01-03, Point(1 1)@2000-01-04]', geometry 'Polygon((0 0,2 0,2 2,0 2,0 0))');
 SELECT tintersects(tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-04)', geometry 'Linestring(1 1,2 1)');
 SELECT tintersects(tgeompoint '[Point(1 1)@2000-01-01, Point(0 0)@2000-01-04)', geometry 'Linestring(0 0,1 1)');
 
@@ -352,6 +354,11 @@ SELECT tintersects(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02
 SELECT tintersects(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]',  geometry 'Point Z empty');
 SELECT tintersects(tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}',  geometry 'Point Z empty');
 
+SELECT * FROM tintersects(tgeompoint '[Point(7 1)@2000-01-01, Point(5 1)@2000-01-02, Point(3 1)@2000-01-03, Point(1 1)@2000-01-04]', ARRAY[geometry 'Polygon((0 0,2 0,2 2,0 2,0 0))', geometry 'Polygon((10 10,11 10,11 11,10 11,10 10))', geometry 'Polygon((4 0,6 0,6 2,4 2,4 0))']);
+SELECT * FROM tintersects(tgeompoint '{Point(1 1)@2000-01-01, Point(5 1)@2000-01-02}', ARRAY[geometry 'Polygon((0 0,2 0,2 2,0 2,0 0))', geometry 'Polygon((10 10,11 10,11 11,10 11,10 10))', geometry 'Polygon((4 0,6 0,6 2,4 2,4 0))']);
+SELECT COUNT(*) FROM tintersects(tgeompoint '[Point(0 0.5)@2000-01-01, Point(10 0.5)@2000-01-11]', ARRAY(SELECT ST_MakeEnvelope(i, 0, i + 0.5, 1) FROM generate_series(-5, 15) i));
+SELECT * FROM tintersects(tgeompoint 'Point(1 1)@2000-01-01', ARRAY[geometry 'Point(1 1)', geometry 'SRID=5676;Point(1 1)']);
+
 SELECT tintersects(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'Point(1 1)@2000-01-01');
 SELECT tintersects(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', tgeompoint 'Point(1 1)@2000-01-01');
 SELECT tintersects(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', tgeompoint 'Point(1 1)@2000-01-01');
@@ -539,6 +546,7 @@ SELECT tdwithin(geometry 'Point Z empty', tgeompoint '{[Point(1 1 1)@2000-01-01,
 SELECT tdwithin(tgeompoint 'Point(1 1)@2000-01-01',  geometry 'Point(1 1)', 2);
 SELECT tdwithin(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}',  geometry 'Point(1 1)', 2);
 SELECT tdwithin(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]',  geometry 'Point(1 1)', 2);
+SELECT tdwithin(tgeompoint '[Point(5 5)@2000-01-01, Point(6 5)@2000-01-02]',  geometry 'Point(1 1)', 1);
 SELECT tdwithin(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}',  geometry 'Point(1 1)', 2);
 
 SELECT tdwithin(tgeompoint 'Point(1 1)@2000-01-01',  geometry 'Point empty', 2);
@@ -579,6 +587,8 @@ SELECT tdwithin(tgeompoint '[Point(0 1)@2000-01-01, Point(0 0)@2000-01-02]', tge
 SELECT tdwithin(tgeompoint '[Point(1 1)@2000-01-01, Point(0 0)@2000-01-02]', tgeompoint '[Point(2 0)@2000-01-01, Point(1 1)@2000-01-02]', 1);
 SELECT tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]', tgeompoint '[Point(0 2)@2000-01-01, Point(1 3)@2000-01-02]', 1);
 SELECT tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]', tgeompoint '[Point(4 0)@2000-01-01, Point(3 1)@2000-01-02]', 0);
+SELECT tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', tgeompoint '[Point(4 0)@2000-01-01, Point(2 0)@2000-01-03, Point(0 0)@2000-01-05]', 2);
+SELECT tdwithin(tgeompoint '[Point(0 0 1)@2000-01-01, Point(2 0 1)@2000-01-03, Point(4 0 1)@2000-01-05]', tgeompoint '[Point(4 0 1)@2000-01-01, Point(2 0 1)@2000-01-03, Point(0 0 1)@2000-01-05]', 2);
 
 SELECT tdwithin(tgeompoint 'Point(1 1 1)@2000-01-01', tgeompoint 'Point(1 1 1)@2000-01-01', 2);
 SELECT tdwithin(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}', tgeompoint 'Point(1 1 1)@2000-01-01', 2);
@@ -638,6 +648,12 @@ SELECT tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-05]',
 SELECT tdwithin(tgeompoint '[Point(1 0)@2000-01-01, Point(1 4)@2000-01-05]',
   tgeompoint 'Interp=Stepwise;[Point(1 2)@2000-01-01, Point(1 3)@2000-01-05]', 1);
 
+SELECT COUNT(*) FROM generate_series(-5, 15) i WHERE tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11]', ST_MakePoint(i, 1), 2) ?= true;
+SELECT COUNT(*) FROM generate_series(0, 10) i WHERE tintersects(ST_MakePoint(i, 0), tgeompoint '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11]') ?= true;
+SELECT COUNT(*) FROM generate_series(-5, 15) i WHERE tintersects(geometry 'Polygon((0 0,5 0,5 5,0 5,0 0))', ('[Point(' || i || ' -1)@2000-01-01, Point(' || i || ' 6)@2000-01-02]')::tgeompoint) ?= true;
+SELECT * FROM tdwithinPairs(ARRAY[1, 2, 3, 4], ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', tgeompoint '[Point(4 0)@2000-01-01, Point(2 0)@2000-01-03, Point(0 0)@2000-01-05]', tgeompoint '[Point(100 100)@2000-01-01, Point(101 100)@2000-01-05]', tgeompoint '[Point(0 0)@2000-01-10, Point(4 0)@2000-01-12]'], 2);
+SELECT COUNT(*) FROM tdwithinPairs(ARRAY(SELECT i FROM generate_series(1, 10) i), ARRAY(SELECT ('[Point(' || i || ' 0)@2000-01-01, Point(' || i || ' 1)@2000-01-02]')::tgeompoint FROM generate_series(1, 10) i), 1.5);
+
 /* Errors */
 SELECT tdwithin(geometry 'SRID=5676;Point(1 1)', tgeompoint 'Point(1 1)@2000-01-01', 2);
 SELECT tdwithin(tgeompoint 'Point(1 1)@2000-01-01', geometry 'SRID=5676;Point(1 1)', 2);
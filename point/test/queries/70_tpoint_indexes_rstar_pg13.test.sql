@@ -0,0 +1,31 @@
+-------------------------------------------------------------------------------
+
+ANALYZE tbl_tgeompoint3D_big;
+ANALYZE tbl_tgeogpoint3D_big;
+ANALYZE tbl_tfloat_big;
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_rstar_idx;
+DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_rstar_idx;
+DROP INDEX IF EXISTS tbl_tfloat_big_rstar_idx;
+
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tgeompoint3D_big_rstar_idx ON tbl_tgeompoint3D_big USING GIST(temp gist_tgeompoint_ops(split = rstar));
+CREATE INDEX tbl_tgeogpoint3D_big_rstar_idx ON tbl_tgeogpoint3D_big USING GIST(temp gist_tgeogpoint_ops(split = rstar));
+CREATE INDEX tbl_tfloat_big_rstar_idx ON tbl_tfloat_big USING GIST(temp gist_tfloat_ops(split = rstar));
+
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp << geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &< geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp />> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp #>> period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp && geography 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp && floatrange '[1,3]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp @> floatrange '[1,3]';
+
+DROP INDEX tbl_tgeompoint3D_big_rstar_idx;
+DROP INDEX tbl_tgeogpoint3D_big_rstar_idx;
+DROP INDEX tbl_tfloat_big_rstar_idx;
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,36 @@
+-------------------------------------------------------------------------------
+-- Planner support functions of the spatial relationships
+-------------------------------------------------------------------------------
+
+ANALYZE tbl_tgeompoint;
+
+DROP INDEX IF EXISTS tbl_tgeompoint_gist_idx;
+
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tgeompoint_gist_idx ON tbl_tgeompoint USING GIST(temp);
+SET enable_seqscan = off;
+
+SELECT count(*) FROM tbl_geompoint, tbl_tgeompoint
+  WHERE NOT ST_IsCollection(trajectory(temp))  AND contains(g, temp);
+SELECT count(*) FROM tbl_tgeompoint, tbl_geompoint
+  WHERE NOT ST_IsCollection(trajectory(temp))  AND contains(temp, g);
+SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+  WHERE NOT ST_IsCollection(trajectory(t1.temp)) AND NOT ST_IsCollection(trajectory(t2.temp)) AND contains(t1.temp, t2.temp);
+SELECT count(*) FROM tbl_geompoint, tbl_tgeompoint
+  WHERE NOT ST_IsCollection(trajectory(temp))  AND intersects(g, temp);
+SELECT count(*) FROM tbl_tgeompoint, tbl_geompoint
+  WHERE NOT ST_IsCollection(trajectory(temp))  AND intersects(temp, g);
+SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+  WHERE NOT ST_IsCollection(trajectory(t1.temp)) AND NOT ST_IsCollection(trajectory(t2.temp)) AND intersects(t1.temp, t2.temp);
+SELECT count(*) FROM tbl_geompoint, tbl_tgeompoint
+  WHERE NOT ST_IsCollection(trajectory(temp))  AND dwithin(g, temp, 10);
+SELECT count(*) FROM tbl_tgeompoint, tbl_geompoint
+  WHERE NOT ST_IsCollection(trajectory(temp))  AND dwithin(temp, g, 10);
+SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+  WHERE NOT ST_IsCollection(trajectory(t1.temp)) AND NOT ST_IsCollection(trajectory(t2.temp)) AND dwithin(t1.temp, t2.temp, 10);
+
+RESET enable_seqscan;
+DROP INDEX tbl_tgeompoint_gist_idx;
+
+-------------------------------------------------------------------------------
@@ -99,3 +99,62 @@ DROP INDEX IF EXISTS tbl_tgeompoint3D_big_gist_idx;
 DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_gist_idx;
 
 -------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tgeompoint3D_big_multi_gist_idx ON tbl_tgeompoint3D_big USING GIST(temp gist_tgeompoint_multi_ops);
+
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <@ geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_multi_gist_idx;
+
+CREATE INDEX tbl_tgeompoint3D_big_compact_gist_idx ON tbl_tgeompoint3D_big USING GIST(temp gist_tgeompoint_compact_ops);
+
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <@ geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_compact_gist_idx;
+
+CREATE INDEX tbl_tgeompoint3D_big_brin_idx ON tbl_tgeompoint3D_big USING BRIN(temp);
+
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp #>> period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_brin_idx;
+
+VACUUM ANALYZE tbl_stbox;
+SET enable_seqscan = off;
+CREATE INDEX tbl_stbox_gist_idx ON tbl_stbox USING GIST(b);
+
+SELECT count(*) FROM tbl_stbox t1, tbl_stbox t2 WHERE t1.b && t2.b;
+SELECT count(*) FROM tbl_stbox t1, tbl_stbox t2 WHERE t1.b @> t2.b;
+
+DROP INDEX IF EXISTS tbl_stbox_gist_idx;
+RESET enable_seqscan;
+
+CREATE INDEX tbl_tgeompoint3D_big_gist_idx ON tbl_tgeompoint3D_big USING GIST(temp);
+CREATE INDEX tbl_tgeogpoint3D_big_gist_idx ON tbl_tgeogpoint3D_big USING GIST(temp);
+
+SELECT (SELECT round((temp |=| geometry 'Point(1 1 1)')::numeric, 6) FROM tbl_tgeompoint3D_big ORDER BY temp |=| geometry 'Point(1 1 1)' LIMIT 1) =
+  (SELECT round(MIN(temp |=| geometry 'Point(1 1 1)')::numeric, 6) FROM tbl_tgeompoint3D_big);
+SELECT (SELECT round((temp |=| stbox 'STBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))')::numeric, 6) FROM tbl_tgeompoint3D_big ORDER BY temp |=| stbox 'STBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))' LIMIT 1) =
+  (SELECT round(MIN(temp |=| stbox 'STBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))')::numeric, 6) FROM tbl_tgeompoint3D_big);
+SELECT (SELECT round((temp |=| geography 'Point(1 1 1)')::numeric, 6) FROM tbl_tgeogpoint3D_big ORDER BY temp |=| geography 'Point(1 1 1)' LIMIT 1) =
+  (SELECT round(MIN(temp |=| geography 'Point(1 1 1)')::numeric, 6) FROM tbl_tgeogpoint3D_big);
+SELECT (SELECT round((temp |=| stbox 'GEODSTBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))')::numeric, 6) FROM tbl_tgeogpoint3D_big ORDER BY temp |=| stbox 'GEODSTBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))' LIMIT 1) =
+  (SELECT round(MIN(temp |=| stbox 'GEODSTBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))')::numeric, 6) FROM tbl_tgeogpoint3D_big);
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_gist_idx;
+DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_gist_idx;
+
+-------------------------------------------------------------------------------
@@ -84,4 +84,33 @@ SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp #&> tgeogpoint '[Point(1 1
 DROP INDEX IF EXISTS tbl_tgeompoint3D_big_spgist_idx;
 DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_spgist_idx;
 
+CREATE INDEX tbl_tgeompoint3D_big_kdtree_idx ON tbl_tgeompoint3D_big USING SPGIST(temp kdtree_tgeompoint_ops);
+CREATE INDEX tbl_tgeogpoint3D_big_kdtree_idx ON tbl_tgeogpoint3D_big USING SPGIST(temp kdtree_tgeogpoint_ops);
+
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp << geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp />> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp #>> period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp @> tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp #&> tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+
+DROP INDEX tbl_tgeompoint3D_big_kdtree_idx;
+DROP INDEX tbl_tgeogpoint3D_big_kdtree_idx;
+
+CREATE INDEX tbl_tgeompoint3D_big_spgist_idx ON tbl_tgeompoint3D_big USING SPGIST(temp);
+CREATE INDEX tbl_tgeogpoint3D_big_spgist_idx ON tbl_tgeogpoint3D_big USING SPGIST(temp);
+
+SELECT (SELECT round((temp |=| geometry 'Point(1 1 1)')::numeric, 6) FROM tbl_tgeompoint3D_big ORDER BY temp |=| geometry 'Point(1 1 1)' LIMIT 1) =
+  (SELECT round(MIN(temp |=| geometry 'Point(1 1 1)')::numeric, 6) FROM tbl_tgeompoint3D_big);
+SELECT (SELECT round((temp |=| stbox 'STBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))')::numeric, 6) FROM tbl_tgeompoint3D_big ORDER BY temp |=| stbox 'STBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))' LIMIT 1) =
+  (SELECT round(MIN(temp |=| stbox 'STBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))')::numeric, 6) FROM tbl_tgeompoint3D_big);
+SELECT (SELECT round((temp |=| geography 'Point(1 1 1)')::numeric, 6) FROM tbl_tgeogpoint3D_big ORDER BY temp |=| geography 'Point(1 1 1)' LIMIT 1) =
+  (SELECT round(MIN(temp |=| geography 'Point(1 1 1)')::numeric, 6) FROM tbl_tgeogpoint3D_big);
+SELECT (SELECT round((temp |=| stbox 'GEODSTBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))')::numeric, 6) FROM tbl_tgeogpoint3D_big ORDER BY temp |=| stbox 'GEODSTBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))' LIMIT 1) =
+  (SELECT round(MIN(temp |=| stbox 'GEODSTBOX ZT((1,1,1,2001-06-01),(1,1,1,2001-07-01))')::numeric, 6) FROM tbl_tgeogpoint3D_big);
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_spgist_idx;
+DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_spgist_idx;
+
 -------------------------------------------------------------------------------
@@ -0,0 +1,31 @@
+-------------------------------------------------------------------------------
+
+SELECT count(*), bool_and(stbox 'STBOX((0,0),(100,100))' @> temp AND numInstants(temp) = 10)
+FROM generate_tgeompoints(100, 10, stbox 'STBOX((0,0),(100,100))', period '[2000-01-01, 2000-01-02]') temp;
+SELECT count(*), bool_and(stbox 'STBOX((0,0),(100,100))' @> temp)
+FROM generate_tgeompoints(100, 10, stbox 'STBOX((0,0),(100,100))', period '[2000-01-01, 2000-01-02]', '1 minute', 'gaussian') temp;
+SELECT count(*), bool_and(stbox 'STBOX((0,0),(100,100))' @> temp)
+FROM generate_tgeompoints(100, 10, stbox 'STBOX((0,0),(100,100))', period '[2000-01-01, 2000-01-02]', '1 minute', 'walk') temp;
+SELECT DISTINCT SRID(temp), ST_Z(startValue(temp)) BETWEEN 0 AND 10
+FROM generate_tgeompoints(10, 5, stbox 'SRID=3812;STBOX Z((0,0,0),(100,100,10))',
+  period '[2000-01-01, 2000-01-02]') temp;
+SELECT DISTINCT interpolation(temp)
+FROM generate_tgeompoints(10, 5, stbox 'STBOX((0,0),(100,100))', period '[2000-01-01, 2000-01-02]', '1 minute', 'walk', false) temp;
+SELECT id, startTimestamp(trip), ST_AsText(startValue(trip)),
+  ST_AsText(endValue(trip))
+FROM create_trips(ARRAY[(1, geometry 'Linestring(0 0,100 0)', 50.0::float, 0),
+  (1, geometry 'Linestring(100 0,100 100)', 50.0::float, 0),
+  (2, geometry 'Linestring(0 0,0 100)', 50.0::float, 1)],
+  ARRAY[timestamptz '2000-01-01', '2000-01-02'], false, 'minimal');
+
+/* Errors */
+SELECT * FROM generate_tgeompoints(10, 5, stbox 'STBOX T((,2000-01-01),(,2000-01-02))', period '[2000-01-01, 2000-01-02]');
+SELECT * FROM generate_tgeompoints(10, 5, stbox 'STBOX((0,0),(100,100))', period '[2000-01-01, 2000-01-02]', '1 minute', 'zipf');
+SELECT * FROM create_trips(ARRAY[(1, geometry 'Linestring(0 0,100 0)', 50.0::float, 0),
+  (1, geometry 'Linestring(100 0,100 100)', 50.0::float, 0),
+  (2, geometry 'Linestring(0 0,0 100)', 50.0::float, 1)],
+  ARRAY[timestamptz '2000-01-01'], false, 'minimal');
+SELECT create_trip(ARRAY[(geometry 'Linestring(0 0,100 0)', 50.0::float)],
+  '2000-01-01', false, 'minimal');
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,41 @@
+-------------------------------------------------------------------------------
+-- Spatiotemporal join
+-------------------------------------------------------------------------------
+
+ANALYZE tbl_tgeompoint;
+
+-------------------------------------------------------------------------------
+
+SET enable_nestloop = off;
+SET mobilitydb.enable_spatial_join = on;
+
+SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+  WHERE NOT ST_IsCollection(trajectory(t1.temp)) AND NOT ST_IsCollection(trajectory(t2.temp)) AND contains(t1.temp, t2.temp);
+SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+  WHERE NOT ST_IsCollection(trajectory(t1.temp)) AND NOT ST_IsCollection(trajectory(t2.temp)) AND intersects(t1.temp, t2.temp);
+SELECT count(*) FROM tbl_geompoint, tbl_tgeompoint
+  WHERE NOT ST_IsCollection(trajectory(temp))  AND dwithin(g, temp, 10);
+SELECT count(*) FROM tbl_tgeompoint, tbl_geompoint
+  WHERE NOT ST_IsCollection(trajectory(temp))  AND dwithin(temp, g, 10);
+SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+  WHERE NOT ST_IsCollection(trajectory(t1.temp)) AND NOT ST_IsCollection(trajectory(t2.temp)) AND dwithin(t1.temp, t2.temp, 10);
+
+-- Batches of the outer input that do not fit in work_mem
+SET work_mem = '64kB';
+
+SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+  WHERE NOT ST_IsCollection(trajectory(t1.temp)) AND NOT ST_IsCollection(trajectory(t2.temp)) AND contains(t1.temp, t2.temp);
+SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+  WHERE NOT ST_IsCollection(trajectory(t1.temp)) AND NOT ST_IsCollection(trajectory(t2.temp)) AND intersects(t1.temp, t2.temp);
+SELECT count(*) FROM tbl_geompoint, tbl_tgeompoint
+  WHERE NOT ST_IsCollection(trajectory(temp))  AND dwithin(g, temp, 10);
+SELECT count(*) FROM tbl_tgeompoint, tbl_geompoint
+  WHERE NOT ST_IsCollection(trajectory(temp))  AND dwithin(temp, g, 10);
+SELECT count(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2
+  WHERE NOT ST_IsCollection(trajectory(t1.temp)) AND NOT ST_IsCollection(trajectory(t2.temp)) AND dwithin(t1.temp, t2.temp, 10);
+
+RESET work_mem;
+RESET mobilitydb.enable_spatial_join;
+RESET enable_nestloop;
+
+-------------------------------------------------------------------------------
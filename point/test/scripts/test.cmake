@@ -31,3 +31,17 @@ foreach(file ${geom_testfiles})
 	endif()
 endforeach()
 
+file(GLOB geom_perffiles "point/test/perf/*.perf.sql")
+list(SORT geom_perffiles)
+
+foreach(file ${geom_perffiles})
+	get_filename_component(TESTNAME ${file} NAME_WE)
+	add_test(
+		NAME perf_${TESTNAME}
+		WORKING_DIRECTORY ${PROJECT_SOURCE_DIR}/test
+		COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh run_perf ${CMAKE_BINARY_DIR} perf_${TESTNAME} ${file}
+	)
+	set_tests_properties(perf_${TESTNAME} PROPERTIES FIXTURES_REQUIRED DBGEO)
+	set_tests_properties(perf_${TESTNAME} PROPERTIES RESOURCE_LOCK DBLOCK)
+	set_tests_properties(perf_${TESTNAME} PROPERTIES LABELS perf)
+endforeach()
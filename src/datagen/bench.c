@@ -0,0 +1,296 @@
+/*****************************************************************************
+ *
+ * bench.c
+ *    Microbenchmarks of the kernels of temporal types.
+ *
+ * The kernels are called directly from C on synthetic inputs generated with
+ * a fixed seed, so that the measures do not include the executor, the
+ * detoasting of the arguments, or the construction of the inputs. Each
+ * iteration runs in a dedicated memory context which is reset afterwards,
+ * and the memory used by the first iteration is reported as the number of
+ * bytes allocated by a call of the kernel.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "bench.h"
+
+#include <access/htup_details.h>
+#include <funcapi.h>
+#include <miscadmin.h>
+#include <nodes/memnodes.h>
+#include <portability/instr_time.h>
+#include <utils/builtins.h>
+#include <utils/memutils.h>
+#include <utils/timestamp.h>
+
+#include "period.h"
+#include "temporaltypes.h"
+#include "oidcache.h"
+#include "temporal_util.h"
+#include "temporal_parser.h"
+#include "temporal_aggfuncs.h"
+#include "lifting.h"
+#include "postgis.h"
+#include "tpoint.h"
+#include "tpoint_spatialfuncs.h"
+#include "tpoint_distance.h"
+
+/* Names of the kernels, in the order of the BenchKernel enumeration */
+static const char *bench_kernel_names[] =
+{
+  "tsequence_make",
+  "tsequence_at_period",
+  "sync_tfunc",
+  "distance_tpoint_geo",
+  "tpointseq_at_geometry",
+  "tsequence_tagg",
+  "temporal_out",
+  "temporal_in"
+};
+
+/* Seed of the generator of the synthetic inputs */
+#define BENCH_SEED 1
+
+/* Interval between two consecutive instants of the synthetic inputs */
+#define BENCH_STEP (60 * USECS_PER_SEC)
+
+/**
+ * Synthetic inputs of the kernels
+ */
+typedef struct
+{
+  int count;               /**< Number of instants of the sequences */
+  TInstant **instants;     /**< Instants of the temporal float */
+  TSequence *seq1;         /**< Temporal float */
+  TSequence *seq2;         /**< Temporal float shifted by half its duration */
+  TSequence *pointseq;     /**< Temporal geometric point */
+  Period period;           /**< Middle half of the period of seq1 */
+  Datum point;             /**< Geometric point */
+  Datum polygon;           /**< Geometric polygon */
+  char *str;               /**< Text representation of seq1 */
+} BenchInput;
+
+/* State of the generator of the synthetic inputs */
+static uint64 bench_state;
+
+/**
+ * Returns a pseudo-random number in [0, 1) using the xorshift64* generator
+ */
+static double
+bench_random(void)
+{
+  bench_state ^= bench_state >> 12;
+  bench_state ^= bench_state << 25;
+  bench_state ^= bench_state >> 27;
+  return (double) ((bench_state * UINT64CONST(2685821657736338717)) >> 11) /
+    (double) (UINT64CONST(1) << 53);
+}
+
+/**
+ * Generates the synthetic inputs of the kernels, which are random walks
+ * of the given number of instants separated by one minute and starting at
+ * 2000-01-01
+ */
+static void
+bench_input_make(BenchInput *input, int count)
+{
+  bench_state = BENCH_SEED;
+  TInstant **instants2 = palloc(sizeof(TInstant *) * count);
+  TInstant **points = palloc(sizeof(TInstant *) * count);
+  input->count = count;
+  input->instants = palloc(sizeof(TInstant *) * count);
+  double value = 500.0, x = 500.0, y = 500.0;
+  TimestampTz shift = (count / 2) * BENCH_STEP;
+  for (int i = 0; i < count; i++)
+  {
+    TimestampTz t = i * BENCH_STEP;
+    value += bench_random() * 20.0 - 10.0;
+    input->instants[i] = tinstant_make(Float8GetDatum(value), t, FLOAT8OID);
+    instants2[i] = tinstant_make(Float8GetDatum(1000.0 - value), t + shift,
+      FLOAT8OID);
+    x += bench_random() * 20.0 - 10.0;
+    y += bench_random() * 20.0 - 10.0;
+    LWPOINT *lwpoint = lwpoint_make2d(0, x, y);
+    Datum point = PointerGetDatum(geo_serialize((LWGEOM *) lwpoint));
+    lwpoint_free(lwpoint);
+    points[i] = tinstant_make(point, t, type_oid(T_GEOMETRY));
+    pfree(DatumGetPointer(point));
+  }
+  input->seq1 = tsequence_make(input->instants, count, true, true, LINEAR,
+    NORMALIZE_NO);
+  input->seq2 = tsequence_make_free(instants2, count, true, true, LINEAR,
+    NORMALIZE_NO);
+  input->pointseq = tsequence_make_free(points, count, true, true, LINEAR,
+    NORMALIZE_NO);
+  TimestampTz duration = (count - 1) * BENCH_STEP;
+  period_set(&input->period, duration / 4, 3 * duration / 4, true, true);
+  input->point = call_input(type_oid(T_GEOMETRY), "Point(500 500)");
+  input->polygon = call_input(type_oid(T_GEOMETRY),
+    "Polygon((400 400,600 400,600 600,400 600,400 400))");
+  input->str = temporal_to_string((Temporal *) input->seq1, &call_output);
+  return;
+}
+
+/**
+ * Calls the kernel on the synthetic inputs, the result is freed by the
+ * calling function when resetting the memory context
+ */
+static void
+bench_kernel_run(BenchKernel kernel, const BenchInput *input)
+{
+  switch (kernel)
+  {
+    case BENCH_TSEQUENCE_MAKE:
+      tsequence_make(input->instants, input->count, true, true, LINEAR,
+        NORMALIZE);
+      break;
+    case BENCH_TSEQUENCE_AT_PERIOD:
+      tsequence_at_period(input->seq1, &input->period);
+      break;
+    case BENCH_SYNC_TFUNC:
+    {
+      /* Same lifted function as the temporal comparison #< */
+      LiftedFunctionInfo lfinfo;
+      lfinfo.func = (varfunc) &datum2_lt2;
+      lfinfo.numparam = 4;
+      lfinfo.restypid = BOOLOID;
+      lfinfo.reslinear = STEP;
+      lfinfo.invert = INVERT_NO;
+      lfinfo.discont = true;
+      lfinfo.tpfunc = NULL;
+      sync_tfunc_temporal_temporal((Temporal *) input->seq1,
+        (Temporal *) input->seq2, (Datum) NULL, lfinfo);
+      break;
+    }
+    case BENCH_DISTANCE_TPOINT_GEO:
+      distance_tpoint_geo_internal((Temporal *) input->pointseq,
+        input->point, NULL);
+      break;
+    case BENCH_TPOINTSEQ_AT_GEOMETRY:
+    {
+      int count;
+      tpointseq_at_geometry2(input->pointseq, input->polygon, &count);
+      break;
+    }
+    case BENCH_TSEQUENCE_TAGG:
+    {
+      /* Same merge as the one of the transition function of tmin */
+      TSequence *seq1 = input->seq1, *seq2 = input->seq2;
+      int newcount;
+      tsequence_tagg(&seq1, 1, &seq2, 1, &datum_min_float8, CROSSINGS,
+        &newcount);
+      break;
+    }
+    case BENCH_TEMPORAL_OUT:
+      temporal_to_string((Temporal *) input->seq1, &call_output);
+      break;
+    default: /* BENCH_TEMPORAL_IN */
+    {
+      char *str = input->str;
+      temporal_parse(&str, FLOAT8OID);
+      break;
+    }
+  }
+  return;
+}
+
+/**
+ * Returns the number of bytes used in the memory context, including the
+ * headers of the chunks
+ */
+static int64
+bench_context_bytes(MemoryContext ctx)
+{
+  MemoryContextCounters counters;
+  memset(&counters, 0, sizeof(MemoryContextCounters));
+#if MOBDB_PGSQL_VERSION >= 110000
+  ctx->methods->stats(ctx, NULL, NULL, &counters);
+#else
+  ctx->methods->stats(ctx, 0, false, &counters);
+#endif
+  return (int64) (counters.totalspace - counters.freespace);
+}
+
+PG_FUNCTION_INFO_V1(mobdb_bench);
+/**
+ * Runs the kernel the given number of iterations on synthetic inputs of
+ * the given number of instants and returns the time per instant in
+ * nanoseconds and the number of bytes allocated per call
+ */
+PGDLLEXPORT Datum
+mobdb_bench(PG_FUNCTION_ARGS)
+{
+  text *name = PG_GETARG_TEXT_P(0);
+  int count = PG_GETARG_INT32(1);
+  int iterations = PG_GETARG_INT32(2);
+  char *str = text_to_cstring(name);
+  int kernel = -1;
+  for (int i = 0; i < BENCH_KERNELS; i++)
+  {
+    if (strcmp(str, bench_kernel_names[i]) == 0)
+    {
+      kernel = i;
+      break;
+    }
+  }
+  if (kernel < 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("Unknown kernel: %s", str)));
+  if (count < 2)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The number of instants must be at least 2")));
+  if (iterations < 1)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The number of iterations must be positive")));
+  TupleDesc tupdesc;
+  if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+      errmsg("function returning record called in context that cannot accept type record")));
+  tupdesc = BlessTupleDesc(tupdesc);
+
+  /* The inputs and the results of the kernel live in separate contexts */
+  MemoryContext inputctx = AllocSetContextCreate(CurrentMemoryContext,
+    "Benchmark inputs", ALLOCSET_DEFAULT_SIZES);
+  MemoryContext kernelctx = AllocSetContextCreate(CurrentMemoryContext,
+    "Benchmark kernel", ALLOCSET_DEFAULT_SIZES);
+  MemoryContext oldctx = MemoryContextSwitchTo(inputctx);
+  BenchInput input;
+  bench_input_make(&input, count);
+  MemoryContextSwitchTo(kernelctx);
+  instr_time total, start, end;
+  INSTR_TIME_SET_ZERO(total);
+  int64 bytes = 0;
+  for (int i = 0; i < iterations; i++)
+  {
+    INSTR_TIME_SET_CURRENT(start);
+    bench_kernel_run((BenchKernel) kernel, &input);
+    INSTR_TIME_SET_CURRENT(end);
+    INSTR_TIME_ACCUM_DIFF(total, end, start);
+    if (i == 0)
+      bytes = bench_context_bytes(kernelctx);
+    MemoryContextReset(kernelctx);
+    CHECK_FOR_INTERRUPTS();
+  }
+  MemoryContextSwitchTo(oldctx);
+  MemoryContextDelete(kernelctx);
+  MemoryContextDelete(inputctx);
+
+  Datum values[5];
+  bool isnull[5] = {false, false, false, false, false};
+  values[0] = PointerGetDatum(name);
+  values[1] = Int32GetDatum(count);
+  values[2] = Int32GetDatum(iterations);
+  values[3] = Float8GetDatum(INSTR_TIME_GET_DOUBLE(total) * 1e9 /
+    ((double) iterations * count));
+  values[4] = Int64GetDatum(bytes);
+  HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+  pfree(str);
+  PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+/*****************************************************************************/
@@ -0,0 +1,87 @@
+/*****************************************************************************
+ *
+ * funcstat.c
+ *    Counters of the work done by the functions of temporal types.
+ *
+ * The counters are incremented in the hot paths of the functions, e.g.,
+ * when constructing a sequence or detoasting a temporal value, only when
+ * the configuration parameter mobilitydb.function_stats is on, so that
+ * their cost is a test of a global variable otherwise.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "funcstat.h"
+
+#include <access/htup_details.h>
+#include <funcapi.h>
+#include <utils/builtins.h>
+
+/**
+ * Global variable that states whether the counters are updated. It is set
+ * by the configuration parameter mobilitydb.function_stats.
+ */
+bool function_stats = false;
+
+/* The counters are local to the backend */
+uint64 func_counters[FUNC_STAT_KINDS];
+
+static const char *func_stat_kind_names[FUNC_STAT_KINDS] =
+  {"sequences", "instants", "sequence_bytes", "postgis_calls",
+   "skiplist_splices", "detoast_bytes", "shared_cache_hits"};
+
+PG_FUNCTION_INFO_V1(mobilitydb_stat_counters);
+/**
+ * Returns the counters of the work done by the functions of temporal types
+ * in the current backend
+ */
+PGDLLEXPORT Datum
+mobilitydb_stat_counters(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+
+  if (SRF_IS_FIRSTCALL())
+  {
+    MemoryContext oldcontext;
+    TupleDesc tupdesc;
+    funcctx = SRF_FIRSTCALL_INIT();
+    oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+      ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+        errmsg("function returning record called in context that cannot accept type record")));
+    funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+    funcctx->max_calls = FUNC_STAT_KINDS;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr < funcctx->max_calls)
+  {
+    int i = (int) funcctx->call_cntr;
+    Datum values[2];
+    bool isnull[2] = {false, false};
+    values[0] = PointerGetDatum(cstring_to_text(func_stat_kind_names[i]));
+    values[1] = Int64GetDatum((int64) func_counters[i]);
+    HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+    SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+  }
+  SRF_RETURN_DONE(funcctx);
+}
+
+PG_FUNCTION_INFO_V1(mobilitydb_stat_reset);
+/**
+ * Resets the counters of the work done by the functions of temporal types
+ * in the current backend
+ */
+PGDLLEXPORT Datum
+mobilitydb_stat_reset(PG_FUNCTION_ARGS)
+{
+  memset(func_counters, 0, sizeof(func_counters));
+  PG_RETURN_VOID();
+}
+
+/*****************************************************************************/
@@ -1,7 +1,9 @@
 /*****************************************************************************
  *
- * spgiststat.c
- *    Function belonging to the initial implementation of SP-GiST taken from
+ * indexesstat.c
+ *    Statistics about the GiST and SP-GiST indexes of temporal types.
+ *    Function spgiststat belongs to the initial implementation of SP-GiST
+ *    taken from
  *    https://www.postgresql.org/message-id/29780.1324160816@sss.pgh.pa.us
  *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse, 
@@ -11,14 +13,27 @@
  *
  *****************************************************************************/
 
-#include <postgres.h>
+#include "indexesstat.h"
+
+#include <access/gist.h>
 #include <access/hash.h>
 #include <access/heapam.h>
+#include <access/htup_details.h>
+#include <access/itup.h>
 #include <catalog/namespace.h>
+#include <funcapi.h>
+#include <lib/stringinfo.h>
+#include <nodes/pg_list.h>
 #include <utils/builtins.h>
 #include <utils/rel.h>
 #include <utils/varlena.h>
 
+#include "temporal.h"
+#include "timetypes.h"
+#include "tbox.h"
+#include "stbox.h"
+#include "oidcache.h"
+
 /* These definitions are taken from <catalog/pg_am.h> */
 #define GIST_AM_OID 783
 #define SPGIST_AM_OID 4000
@@ -70,6 +85,12 @@ typedef SpGistInnerTupleData *SpGistInnerTuple;
 
 #define SPGIST_ROOT_BLKNO     (1)  /* root for normal entries */
 
+/* This definition is taken from <access/gist_private.h> */
+#define GIST_ROOT_BLKNO       0
+
+/* Maximum number of levels reported by giststat */
+#define GIST_MAX_LEVELS       32
+
 #define IS_INDEX(r) ((r)->rd_rel->relkind == RELKIND_INDEX)
 #define IS_GIST(r) ((r)->rd_rel->relam == GIST_AM_OID)
 #define IS_SPGIST(r) ((r)->rd_rel->relam == SPGIST_AM_OID)
@@ -201,4 +222,364 @@ spgiststat(PG_FUNCTION_ARGS)
        nLeafRedirect, nInnerRedirect);
 
   PG_RETURN_TEXT_P(CStringGetTextDatum(res));
-}
\ No newline at end of file
+}
+/*****************************************************************************
+ * GiST statistics
+ *****************************************************************************/
+
+/**
+ * Statistics collected for a level of a GiST index
+ */
+typedef struct
+{
+  BlockNumber pages;        /**< number of pages */
+  int64    tuples;          /**< number of tuples */
+  double   usedSpace;       /**< space used by the tuples */
+  int64    siblingPairs;    /**< number of pairs of keys in the same page */
+  int64    overlapPairs;    /**< number of these pairs that overlap */
+  double   keyVolume;       /**< sum of the volumes of the keys */
+  double   overlapVolume;   /**< sum of the overlap volumes of the pairs */
+} GistLevelStat;
+
+/**
+ * Get the bounds of the dimensions of a GiST key
+ *
+ * @param[in] key Key
+ * @param[in] keytype Oid of the type of the key
+ * @param[out] min,max Bounds of the dimensions
+ * @result Number of dimensions
+ */
+static int
+gist_key_bounds(Datum key, Oid keytype, double *min, double *max)
+{
+  int ndims = 0;
+  if (keytype == type_oid(T_PERIOD))
+  {
+    Period *p = DatumGetPeriod(key);
+    min[ndims] = (double) p->lower;
+    max[ndims++] = (double) p->upper;
+  }
+  else if (keytype == type_oid(T_TBOX))
+  {
+    TBOX *box = DatumGetTboxP(key);
+    if (MOBDB_FLAGS_GET_X(box->flags))
+    {
+      min[ndims] = box->xmin;
+      max[ndims++] = box->xmax;
+    }
+    if (MOBDB_FLAGS_GET_T(box->flags))
+    {
+      min[ndims] = (double) box->tmin;
+      max[ndims++] = (double) box->tmax;
+    }
+  }
+  else /* keytype == type_oid(T_STBOX) */
+  {
+    STBOX *box = DatumGetSTboxP(key);
+    if (MOBDB_FLAGS_GET_X(box->flags))
+    {
+      min[ndims] = box->xmin;
+      max[ndims++] = box->xmax;
+      min[ndims] = box->ymin;
+      max[ndims++] = box->ymax;
+      if (MOBDB_FLAGS_GET_Z(box->flags) ||
+        MOBDB_FLAGS_GET_GEODETIC(box->flags))
+      {
+        min[ndims] = box->zmin;
+        max[ndims++] = box->zmax;
+      }
+    }
+    if (MOBDB_FLAGS_GET_T(box->flags))
+    {
+      min[ndims] = (double) box->tmin;
+      max[ndims++] = (double) box->tmax;
+    }
+  }
+  return ndims;
+}
+
+/**
+ * Collect the statistics of a GiST page
+ */
+static void
+gist_page_stat(Relation index, Page page, Oid keytype, GistLevelStat *stat,
+  List **children)
+{
+  TupleDesc tupdesc = RelationGetDescr(index);
+  OffsetNumber max = PageGetMaxOffsetNumber(page);
+  double (*min)[4] = palloc(sizeof(double[4]) * max);
+  double (*maxb)[4] = palloc(sizeof(double[4]) * max);
+  int *ndims = palloc(sizeof(int) * max);
+  int nkeys = 0;
+  bool leaf = GistPageIsLeaf(page);
+
+  for (OffsetNumber i = FirstOffsetNumber; i <= max; i++)
+  {
+    ItemId iid = PageGetItemId(page, i);
+    IndexTuple itup;
+    Datum key;
+    bool isnull;
+
+    if (! ItemIdIsNormal(iid))
+      continue;
+    itup = (IndexTuple) PageGetItem(page, iid);
+    if (! leaf)
+      *children = lappend_int(*children,
+        (int) ItemPointerGetBlockNumber(&itup->t_tid));
+    key = index_getattr(itup, 1, tupdesc, &isnull);
+    if (isnull)
+      continue;
+    ndims[nkeys] = gist_key_bounds(key, keytype, min[nkeys], maxb[nkeys]);
+    double volume = 1.0;
+    for (int d = 0; d < ndims[nkeys]; d++)
+      volume *= maxb[nkeys][d] - min[nkeys][d];
+    stat->keyVolume += volume;
+    nkeys++;
+  }
+  stat->tuples += max;
+
+  /* Pairwise overlap of the keys of the page */
+  for (int i = 0; i < nkeys; i++)
+  {
+    for (int j = i + 1; j < nkeys; j++)
+    {
+      double volume = 1.0;
+      bool overlap = true;
+      int n = Min(ndims[i], ndims[j]);
+      for (int d = 0; d < n && overlap; d++)
+      {
+        double lower = Max(min[i][d], min[j][d]),
+          upper = Min(maxb[i][d], maxb[j][d]);
+        if (lower > upper)
+          overlap = false;
+        else
+          volume *= upper - lower;
+      }
+      stat->siblingPairs++;
+      if (overlap)
+      {
+        stat->overlapPairs++;
+        stat->overlapVolume += volume;
+      }
+    }
+  }
+  pfree(min); pfree(maxb); pfree(ndims);
+  return;
+}
+
+PG_FUNCTION_INFO_V1(giststat);
+/**
+ * Returns statistics about a GiST index on a time type, a temporal type,
+ * or a box type: depth, fill ratio, and overlap between sibling keys for
+ * each level of the tree, level 0 being the root
+ *
+ * The overlap ratio of a level is the sum of the overlap volumes of the
+ * pairs of keys sharing a page divided by the sum of the volumes of the
+ * keys. It is meaningful for comparing indexes on the same data.
+ */
+PGDLLEXPORT Datum
+giststat(PG_FUNCTION_ARGS)
+{
+  text *name = PG_GETARG_TEXT_P(0);
+  RangeVar *relvar;
+  Relation index;
+  Oid keytype;
+  GistLevelStat stats[GIST_MAX_LEVELS];
+  List *current, *next;
+  ListCell *lc;
+  int depth = 0, bufferSize = -1;
+  BlockNumber totalPages, emptyPages = 0;
+  StringInfoData res;
+
+  relvar = makeRangeVarFromNameList(textToQualifiedNameList(name));
+  index = relation_openrv(relvar, AccessShareLock);
+
+  if (!IS_INDEX(index) || !IS_GIST(index))
+    elog(ERROR, "relation \"%s\" is not a GiST index",
+       RelationGetRelationName(index));
+
+  keytype = TupleDescAttr(RelationGetDescr(index), 0)->atttypid;
+  if (keytype != type_oid(T_PERIOD) && keytype != type_oid(T_TBOX) &&
+    keytype != type_oid(T_STBOX))
+    elog(ERROR, "GiST index \"%s\" does not have period, tbox, or stbox keys",
+       RelationGetRelationName(index));
+
+  totalPages = RelationGetNumberOfBlocks(index);
+  memset(stats, 0, sizeof(stats));
+
+  /* Traverse the tree level by level starting from the root */
+  current = list_make1_int(GIST_ROOT_BLKNO);
+  while (current != NIL && depth < GIST_MAX_LEVELS)
+  {
+    next = NIL;
+    foreach (lc, current)
+    {
+      BlockNumber blkno = (BlockNumber) lfirst_int(lc);
+      Buffer buffer;
+      Page page;
+      int pageFree;
+
+      buffer = ReadBuffer(index, blkno);
+      LockBuffer(buffer, BUFFER_LOCK_SHARE);
+      page = BufferGetPage(buffer);
+      if (PageIsNew(page) || GistPageIsDeleted(page))
+      {
+        UnlockReleaseBuffer(buffer);
+        continue;
+      }
+
+      stats[depth].pages++;
+      gist_page_stat(index, page, keytype, &stats[depth], &next);
+
+      if (bufferSize < 0)
+        bufferSize = BufferGetPageSize(buffer)
+          - MAXALIGN(sizeof(GISTPageOpaqueData))
+          - SizeOfPageHeaderData;
+      pageFree = PageGetExactFreeSpace(page);
+      stats[depth].usedSpace += bufferSize - pageFree;
+      if (pageFree == bufferSize)
+        emptyPages++;
+
+      UnlockReleaseBuffer(buffer);
+    }
+    list_free(current);
+    current = next;
+    depth++;
+  }
+  list_free(current);
+
+  index_close(index, AccessShareLock);
+
+  initStringInfo(&res);
+  appendStringInfo(&res,
+       "totalPages:    %u\n"
+       "emptyPages:    %u\n"
+       "depth:         %d",
+       totalPages, emptyPages, depth);
+  for (int i = 0; i < depth; i++)
+  {
+    appendStringInfo(&res,
+       "\nlevel %d:       pages %u, tuples " INT64_FORMAT
+       ", fillRatio %.2f%%, overlapPairs " INT64_FORMAT "/" INT64_FORMAT
+       ", overlapRatio %.4f",
+       i, stats[i].pages, stats[i].tuples,
+       stats[i].pages > 0 ? 100.0 * (stats[i].usedSpace /
+         ((double) bufferSize * stats[i].pages)) : 0.0,
+       stats[i].overlapPairs, stats[i].siblingPairs,
+       stats[i].keyVolume > 0 ?
+         stats[i].overlapVolume / stats[i].keyVolume : 0.0);
+  }
+
+  PG_RETURN_TEXT_P(CStringGetTextDatum(res.data));
+}
+
+/*****************************************************************************
+ * Counters of the calls to the GiST consistent methods
+ *****************************************************************************/
+
+/**
+ * Counters of the calls to a family of GiST consistent methods
+ */
+typedef struct
+{
+  uint64 innerCalls;     /**< calls on inner entries */
+  uint64 innerTrue;      /**< calls on inner entries returning true */
+  uint64 leafCalls;      /**< calls on leaf entries */
+  uint64 leafTrue;       /**< calls on leaf entries returning true */
+  uint64 leafRecheck;    /**< of these, those requiring a recheck */
+} GistConsistentCounters;
+
+/* The counters are local to the backend */
+static GistConsistentCounters gist_counters[GIST_STAT_KINDS];
+
+static const char *gist_stat_kind_names[GIST_STAT_KINDS] =
+  {"period", "tbox", "stbox"};
+
+/**
+ * Count a call to a GiST consistent method
+ *
+ * @param[in] kind Family of the consistent method
+ * @param[in] leaf True when the entry is a leaf entry
+ * @param[in] result Result of the consistent method
+ * @param[in] recheck True when the operator must be rechecked
+ */
+void
+gist_consistent_count(GistStatKind kind, bool leaf, bool result,
+  bool recheck)
+{
+  GistConsistentCounters *c = &gist_counters[kind];
+  if (leaf)
+  {
+    c->leafCalls++;
+    if (result)
+    {
+      c->leafTrue++;
+      if (recheck)
+        c->leafRecheck++;
+    }
+  }
+  else
+  {
+    c->innerCalls++;
+    if (result)
+      c->innerTrue++;
+  }
+  return;
+}
+
+PG_FUNCTION_INFO_V1(gist_consistent_counters);
+/**
+ * Returns the counters of the calls to the GiST consistent methods in the
+ * current backend
+ */
+PGDLLEXPORT Datum
+gist_consistent_counters(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+
+  if (SRF_IS_FIRSTCALL())
+  {
+    MemoryContext oldcontext;
+    TupleDesc tupdesc;
+    funcctx = SRF_FIRSTCALL_INIT();
+    oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+      ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+        errmsg("function returning record called in context that cannot accept type record")));
+    funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+    funcctx->max_calls = GIST_STAT_KINDS;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr < funcctx->max_calls)
+  {
+    int i = (int) funcctx->call_cntr;
+    GistConsistentCounters *c = &gist_counters[i];
+    Datum values[6];
+    bool isnull[6] = {false, false, false, false, false, false};
+    values[0] = PointerGetDatum(cstring_to_text(gist_stat_kind_names[i]));
+    values[1] = Int64GetDatum((int64) c->innerCalls);
+    values[2] = Int64GetDatum((int64) c->innerTrue);
+    values[3] = Int64GetDatum((int64) c->leafCalls);
+    values[4] = Int64GetDatum((int64) c->leafTrue);
+    values[5] = Int64GetDatum((int64) c->leafRecheck);
+    HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+    SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+  }
+  SRF_RETURN_DONE(funcctx);
+}
+
+PG_FUNCTION_INFO_V1(gist_consistent_reset);
+/**
+ * Resets the counters of the calls to the GiST consistent methods in the
+ * current backend
+ */
+PGDLLEXPORT Datum
+gist_consistent_reset(PG_FUNCTION_ARGS)
+{
+  memset(gist_counters, 0, sizeof(gist_counters));
+  PG_RETURN_VOID();
+}
+
+/*****************************************************************************/
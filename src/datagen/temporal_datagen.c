@@ -0,0 +1,360 @@
+/*****************************************************************************
+ *
+ * temporal_datagen.c
+ *    Generators of random temporal values for load and index testing.
+ *
+ * The generators are set-returning functions that construct the instants of
+ * the values directly in C, instead of calling the constructors of the
+ * temporal types from PL/pgSQL for every instant as the functions of
+ * random_temporal.sql. The values are generated with a fixed seed, so that
+ * two calls with the same arguments return the same values. Each value
+ * starts at a random timestamp of the period given, in which it is entirely
+ * contained, and its instants are separated by the interval given.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_datagen.h"
+
+#include <math.h>
+#include <funcapi.h>
+#include <utils/builtins.h>
+
+#include "period.h"
+#include "oidcache.h"
+#include "temporaltypes.h"
+#include "temporal_util.h"
+
+/*****************************************************************************
+ * Functions shared by the generators of all temporal types
+ *****************************************************************************/
+
+/**
+ * Returns a pseudo-random number in [0, 1) using the xorshift64* generator
+ */
+double
+datagen_random(uint64 *rng)
+{
+  *rng ^= *rng >> 12;
+  *rng ^= *rng << 25;
+  *rng ^= *rng >> 27;
+  return (double) ((*rng * UINT64CONST(2685821657736338717)) >> 11) /
+    (double) (UINT64CONST(1) << 53);
+}
+
+/**
+ * Returns a pseudo-random number of the standard normal distribution using
+ * the Box-Muller transform
+ */
+double
+datagen_gaussian(uint64 *rng)
+{
+  double u1 = 1.0 - datagen_random(rng);
+  double u2 = datagen_random(rng);
+  return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/**
+ * Returns the state of a generator after verifying its arguments. The state
+ * is allocated in the current memory context, which must be the multi-call
+ * memory context of the calling function.
+ *
+ * @param[in] count Number of values generated
+ * @param[in] length Number of instants of the values
+ * @param[in] p Period containing the values
+ * @param[in] interval Interval between two consecutive instants
+ * @param[in] seed Seed of the pseudo-random generator
+ */
+DatagenState *
+datagen_init(int32 count, int32 length, const Period *p,
+  const Interval *interval, int32 seed)
+{
+  if (count < 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The number of values cannot be negative")));
+  if (length < 1)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The number of instants must be positive")));
+  if (interval->month != 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The interval between the instants cannot have months")));
+  int64 step = interval->time + interval->day * USECS_PER_DAY;
+  if (step <= 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The interval between the instants must be positive")));
+  int64 span = (p->upper - p->lower) - (int64) (length - 1) * step;
+  if (span < 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The period is too short for the number of instants")));
+
+  DatagenState *result = palloc0(sizeof(DatagenState));
+  /* The state of the xorshift64* generator must not be zero */
+  result->rng = (uint64) (uint32) seed * UINT64CONST(0x9E3779B97F4A7C15) +
+    UINT64CONST(0x2545F4914F6CDD1D);
+  result->length = length;
+  result->step = step;
+  result->lower = p->lower;
+  result->span = span;
+  result->instants = palloc(sizeof(TInstant *) * length);
+  return result;
+}
+
+/**
+ * Returns a random start of a value, such that all its instants are
+ * contained in the period of the generator
+ */
+TimestampTz
+datagen_start(DatagenState *state)
+{
+  return state->lower +
+    (int64) (datagen_random(&state->rng) * (double) state->span);
+}
+
+/**
+ * Returns the value composed of the instants generated, which is a temporal
+ * instant when the values have a single instant and a temporal sequence
+ * otherwise
+ */
+Temporal *
+datagen_result(DatagenState *state, bool linear)
+{
+  if (state->length == 1)
+    return (Temporal *) state->instants[0];
+  /* The timestamps are strictly increasing by construction */
+  return (Temporal *) tsequence_make1(state->instants, state->length, true,
+    true, linear, NORMALIZE_NO);
+}
+
+/*****************************************************************************
+ * Generators of the alphanumeric temporal types
+ *****************************************************************************/
+
+/**
+ * Parameters of the generators of temporal integers and temporal floats
+ */
+typedef struct
+{
+  double low;
+  double high;
+  bool linear;
+} DatagenNumber;
+
+/**
+ * Returns the next temporal number of the generator
+ */
+static Temporal *
+datagen_tnumber(DatagenState *state, Oid valuetypid)
+{
+  DatagenNumber *params = (DatagenNumber *) state->extra;
+  TimestampTz t = datagen_start(state);
+  for (int i = 0; i < state->length; i++)
+  {
+    double value = params->low +
+      datagen_random(&state->rng) * (params->high - params->low);
+    Datum d = (valuetypid == INT4OID) ?
+      Int32GetDatum((int32) floor(value)) : Float8GetDatum(value);
+    state->instants[i] = tinstant_make(d, t, valuetypid);
+    t += state->step;
+  }
+  return datagen_result(state, params->linear);
+}
+
+/**
+ * Returns the next value of a generator of temporal numbers
+ */
+static Datum
+generate_tnumbers(FunctionCallInfo fcinfo, Oid valuetypid)
+{
+  FuncCallContext *funcctx;
+
+  if (SRF_IS_FIRSTCALL())
+  {
+    int32 count = PG_GETARG_INT32(0);
+    int32 length = PG_GETARG_INT32(1);
+    double low, high;
+    if (valuetypid == INT4OID)
+    {
+      low = (double) PG_GETARG_INT32(2);
+      high = (double) PG_GETARG_INT32(3);
+    }
+    else
+    {
+      low = PG_GETARG_FLOAT8(2);
+      high = PG_GETARG_FLOAT8(3);
+    }
+    if (low > high)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The lower value cannot be greater than the upper value")));
+    /* The upper value of the temporal integers is inclusive */
+    if (valuetypid == INT4OID)
+      high += 1.0;
+    Period *p = PG_GETARG_PERIOD(4);
+    Interval *interval = PG_GETARG_INTERVAL_P(5);
+    bool linear = (valuetypid == FLOAT8OID) ? PG_GETARG_BOOL(6) : STEP;
+    int32 seed = PG_GETARG_INT32((valuetypid == FLOAT8OID) ? 7 : 6);
+
+    funcctx = SRF_FIRSTCALL_INIT();
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    DatagenState *state = datagen_init(count, length, p, interval, seed);
+    DatagenNumber *params = palloc(sizeof(DatagenNumber));
+    params->low = low;
+    params->high = high;
+    params->linear = linear;
+    state->extra = params;
+    funcctx->user_fctx = state;
+    funcctx->max_calls = (uint64) count;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr < funcctx->max_calls)
+  {
+    Temporal *result = datagen_tnumber(funcctx->user_fctx, valuetypid);
+    SRF_RETURN_NEXT(funcctx, PointerGetDatum(result));
+  }
+  SRF_RETURN_DONE(funcctx);
+}
+
+PG_FUNCTION_INFO_V1(generate_tints);
+/**
+ * Generates random temporal integers
+ */
+PGDLLEXPORT Datum
+generate_tints(PG_FUNCTION_ARGS)
+{
+  return generate_tnumbers(fcinfo, INT4OID);
+}
+
+PG_FUNCTION_INFO_V1(generate_tfloats);
+/**
+ * Generates random temporal floats
+ */
+PGDLLEXPORT Datum
+generate_tfloats(PG_FUNCTION_ARGS)
+{
+  return generate_tnumbers(fcinfo, FLOAT8OID);
+}
+
+/**
+ * Returns the next temporal text of the generator, whose values are
+ * composed of upper case letters
+ */
+static Temporal *
+datagen_ttext(DatagenState *state)
+{
+  int32 maxlen = *((int32 *) state->extra);
+  char *str = palloc(maxlen);
+  TimestampTz t = datagen_start(state);
+  for (int i = 0; i < state->length; i++)
+  {
+    int len = 1 + (int) (datagen_random(&state->rng) * maxlen);
+    for (int j = 0; j < len; j++)
+      str[j] = 'A' + (char) (datagen_random(&state->rng) * 26);
+    text *txt = cstring_to_text_with_len(str, len);
+    state->instants[i] = tinstant_make(PointerGetDatum(txt), t, TEXTOID);
+    pfree(txt);
+    t += state->step;
+  }
+  pfree(str);
+  return datagen_result(state, STEP);
+}
+
+PG_FUNCTION_INFO_V1(generate_ttexts);
+/**
+ * Generates random temporal texts
+ */
+PGDLLEXPORT Datum
+generate_ttexts(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+
+  if (SRF_IS_FIRSTCALL())
+  {
+    int32 count = PG_GETARG_INT32(0);
+    int32 length = PG_GETARG_INT32(1);
+    int32 maxlen = PG_GETARG_INT32(2);
+    if (maxlen < 1)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The maximum length of the texts must be positive")));
+    Period *p = PG_GETARG_PERIOD(3);
+    Interval *interval = PG_GETARG_INTERVAL_P(4);
+    int32 seed = PG_GETARG_INT32(5);
+
+    funcctx = SRF_FIRSTCALL_INIT();
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    DatagenState *state = datagen_init(count, length, p, interval, seed);
+    int32 *params = palloc(sizeof(int32));
+    *params = maxlen;
+    state->extra = params;
+    funcctx->user_fctx = state;
+    funcctx->max_calls = (uint64) count;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr < funcctx->max_calls)
+  {
+    Temporal *result = datagen_ttext(funcctx->user_fctx);
+    SRF_RETURN_NEXT(funcctx, PointerGetDatum(result));
+  }
+  SRF_RETURN_DONE(funcctx);
+}
+
+/*****************************************************************************
+ * Values in a given storage format
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(datagen_from_storage);
+/**
+ * Returns the value of the type of the second argument whose stored bytes,
+ * without the varlena header, are given in the first argument
+ *
+ * The function is used to test that values written in the storage format
+ * of previous versions can still be read. Only the fixed-size part of the
+ * struct is validated, and thus the function is restricted to superusers.
+ */
+PGDLLEXPORT Datum
+datagen_from_storage(PG_FUNCTION_ARGS)
+{
+  if (PG_ARGISNULL(0))
+    PG_RETURN_NULL();
+  bytea *raw = PG_GETARG_BYTEA_P(0);
+  Oid typid = get_fn_expr_argtype(fcinfo->flinfo, 1);
+  size_t size = VARSIZE_ANY_EXHDR(raw) + VARHDRSZ;
+  if (temporal_type(typid))
+  {
+    Temporal *temp = (Temporal *) (VARDATA_ANY(raw) - VARHDRSZ);
+    if (size < sizeof(Temporal) ||
+      temp->valuetypid != base_oid_from_temporal(typid))
+      ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+        errmsg("The bytes are not a value of the temporal type")));
+  }
+  else if (typid == type_oid(T_TIMESTAMPSET))
+  {
+    if (size < sizeof(TimestampSet))
+      ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+        errmsg("The bytes are not a value of the timestampset type")));
+  }
+  else if (typid == type_oid(T_PERIODSET))
+  {
+    if (size < sizeof(PeriodSet))
+      ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+        errmsg("The bytes are not a value of the periodset type")));
+  }
+  else
+    ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+      errmsg("The type is not a temporal or a time type")));
+  char *result = palloc(double_pad(size));
+  memcpy(result + VARHDRSZ, VARDATA_ANY(raw), size - VARHDRSZ);
+  SET_VARSIZE(result, size);
+  PG_FREE_IF_COPY(raw, 0);
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
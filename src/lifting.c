@@ -148,10 +148,13 @@
 
 #include "lifting.h"
 
+#include <assert.h>
+#include <math.h>
 #include <utils/timestamp.h>
 
 #include "period.h"
 #include "timeops.h"
+#include "tbox.h"
 #include "temporaltypes.h"
 #include "temporal_util.h"
 
@@ -222,7 +225,7 @@ tfunc_tsequence(const TSequence *seq, Datum param,
   }
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags) &&
     linear_interpolation(lfinfo.restypid);
-  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
+  return tsequence_make_free1(instants, seq->count, seq->period.lower_inc,
     seq->period.upper_inc, linear, NORMALIZE);
 }
 
@@ -243,7 +246,7 @@ tfunc_tsequenceset(const TSequenceSet *ts, Datum param,
     TSequence *seq = tsequenceset_seq_n(ts, i);
     sequences[i] = tfunc_tsequence(seq, param, lfinfo);
   }
-  return tsequenceset_make_free(sequences, ts->count, NORMALIZE);
+  return tsequenceset_make_free1(sequences, ts->count, NORMALIZE);
 }
 
 /**
@@ -369,7 +372,7 @@ tfunc_tsequence_base1(TSequence **result, const TSequence *seq, Datum value,
   }
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags) &&
     linear_interpolation(lfinfo.restypid);
-  result[0] = tsequence_make_free(instants, seq->count, seq->period.lower_inc,
+  result[0] = tsequence_make_free1(instants, seq->count, seq->period.lower_inc,
     seq->period.upper_inc, linear, NORMALIZE);
   return 1;
 }
@@ -437,7 +440,7 @@ tfunc_tsequence_base_discont1(TSequence **result, const TSequence *seq,
     {
       tinstant_set(instants[0], startresult, start->t);
       tinstant_set(instants[1], startresult, end->t);
-      result[k++] = tsequence_make(instants, 2, lower_inc, upper_inc,
+      result[k++] = tsequence_make1(instants, 2, lower_inc, upper_inc,
         STEP, NORMALIZE_NO);
     }
       /* If either the start or the end value is equal to the value compute
@@ -459,7 +462,7 @@ tfunc_tsequence_base_discont1(TSequence **result, const TSequence *seq,
       }
       tinstant_set(instants[0], intresult, start->t);
       tinstant_set(instants[1], intresult, end->t);
-      result[k++] = tsequence_make(instants, 2, lower_eq, upper_eq,
+      result[k++] = tsequence_make1(instants, 2, lower_eq, upper_eq,
         STEP, NORMALIZE_NO);
       if (upper_inc && ! upper_eq)
       {
@@ -489,7 +492,7 @@ tfunc_tsequence_base_discont1(TSequence **result, const TSequence *seq,
         /* Compute the function at the start and end instants */
         tinstant_set(instants[0], startresult, start->t);
         tinstant_set(instants[1], startresult, end->t);
-        result[k++] = tsequence_make(instants, 2, lower_inc,
+        result[k++] = tsequence_make1(instants, 2, lower_inc,
           hascross ? upper_eq : false, STEP, NORMALIZE_NO);
         if (! hascross && upper_inc)
         {
@@ -504,7 +507,7 @@ tfunc_tsequence_base_discont1(TSequence **result, const TSequence *seq,
          * at the crossing, and at the end instant */
         tinstant_set(instants[0], startresult, start->t);
         tinstant_set(instants[1], startresult, inttime);
-        result[k++] = tsequence_make(instants, 2, lower_inc, lower_eq,
+        result[k++] = tsequence_make1(instants, 2, lower_inc, lower_eq,
           STEP, NORMALIZE_NO);
         /* Second sequence if any */
         if (! lower_eq && ! upper_eq)
@@ -515,7 +518,7 @@ tfunc_tsequence_base_discont1(TSequence **result, const TSequence *seq,
         /* Third sequence */
         tinstant_set(instants[0], endresult, inttime);
         tinstant_set(instants[1], endresult, end->t);
-        result[k++] = tsequence_make(instants, 2, upper_eq, upper_inc,
+        result[k++] = tsequence_make1(instants, 2, upper_eq, upper_inc,
           STEP, NORMALIZE_NO);
         DATUM_FREE(intvalue, seq->valuetypid);
         DATUM_FREE(intresult, lfinfo.restypid);
@@ -549,7 +552,7 @@ tfunc_tsequence_base(const TSequence *seq, Datum value, Oid valuetypid,
   {
     int k = tfunc_tsequence_base_discont1(sequences, seq, value, valuetypid,
       param, lfinfo);
-    return (Temporal *) tsequenceset_make_free(sequences, k, NORMALIZE);
+    return (Temporal *) tsequenceset_make_free1(sequences, k, NORMALIZE);
   }
   else
   {
@@ -590,7 +593,7 @@ tfunc_tsequenceset_base(const TSequenceSet *ts, Datum value, Oid valuetypid,
       tfunc_tsequence_base1(&sequences[k], seq, value, valuetypid, param,
         lfinfo);
   }
-  return tsequenceset_make_free(sequences, k, NORMALIZE);
+  return tsequenceset_make_free1(sequences, k, NORMALIZE);
 }
 
 /**
@@ -1019,7 +1022,7 @@ sync_tfunc_tsequence_tsequence2(TSequence **result, const TSequence *seq1,
     {
       instants[0] = tinstant_make(startresult, start1->t, lfinfo.restypid);
       instants[1] = tinstant_make(startresult, end1->t, lfinfo.restypid);
-      result[k++] = tsequence_make(instants, 2, lower_inc, upper_inc,
+      result[k++] = tsequence_make1(instants, 2, lower_inc, upper_inc,
         STEP, NORMALIZE_NO);
       pfree(instants[0]); pfree(instants[1]);
     }
@@ -1046,7 +1049,7 @@ sync_tfunc_tsequence_tsequence2(TSequence **result, const TSequence *seq1,
       }
       instants[0] = tinstant_make(intresult, start1->t, lfinfo.restypid);
       instants[1] = tinstant_make(intresult, end1->t, lfinfo.restypid);
-      result[k++] = tsequence_make(instants, 2, lower_eq, upper_eq,
+      result[k++] = tsequence_make1(instants, 2, lower_eq, upper_eq,
         STEP, NORMALIZE_NO);
       pfree(instants[0]); pfree(instants[1]);
       if (upper_inc && ! upper_eq)
@@ -1078,7 +1081,7 @@ sync_tfunc_tsequence_tsequence2(TSequence **result, const TSequence *seq1,
       {
         instants[0] = tinstant_make(startresult, start1->t, lfinfo.restypid);
         instants[1] = tinstant_make(startresult, end1->t, lfinfo.restypid);
-        result[k++] = tsequence_make(instants, 2, lower_inc,
+        result[k++] = tsequence_make1(instants, 2, lower_inc,
           hascross ? upper_eq : false, STEP, NORMALIZE_NO);
         pfree(instants[0]); pfree(instants[1]);
         if (! hascross && upper_inc)
@@ -1093,7 +1096,7 @@ sync_tfunc_tsequence_tsequence2(TSequence **result, const TSequence *seq1,
         /* First sequence */
         instants[0] = tinstant_make(startresult, start1->t, lfinfo.restypid);
         instants[1] = tinstant_make(startresult, inttime, lfinfo.restypid);
-        result[k++] = tsequence_make(instants, 2, lower_inc, lower_eq,
+        result[k++] = tsequence_make1(instants, 2, lower_inc, lower_eq,
           STEP, NORMALIZE_NO);
         pfree(instants[0]); pfree(instants[1]);
         /* Second sequence if any */
@@ -1106,7 +1109,7 @@ sync_tfunc_tsequence_tsequence2(TSequence **result, const TSequence *seq1,
         /* Third sequence */
         instants[0] = tinstant_make(endresult, inttime, lfinfo.restypid);
         instants[1] = tinstant_make(endresult, end1->t, lfinfo.restypid);
-        result[k++] = tsequence_make(instants, 2, upper_eq, upper_inc,
+        result[k++] = tsequence_make1(instants, 2, upper_eq, upper_inc,
           STEP, NORMALIZE_NO);
         pfree(instants[0]); pfree(instants[1]);
         DATUM_FREE(intvalue1, start1->valuetypid);
@@ -1151,8 +1154,35 @@ sync_tfunc_tsequence_tsequence3(TSequence **result, const TSequence *seq1,
    * where X, I, and * are values computed, respectively at synchronization points,
    * intermediate points, and common points
    */
-  TInstant *inst1 = tsequence_inst_n(seq1, 0);
-  TInstant *inst2 = tsequence_inst_n(seq2, 0);
+  TInstant *inst1, *inst2;
+  Datum value;
+  TSequenceBuilder builder;
+
+  /*
+   * Same timestamps and no intermediate points
+   * The function is applied to the pairs of instants in a single loop
+   */
+  if (lfinfo.tpfunc == NULL && tsequence_same_timestamps(seq1, seq2))
+  {
+    tsequence_builder_init(&builder, lfinfo.restypid, seq1->count,
+      lfinfo.reslinear, NORMALIZE);
+    for (int i = 0; i < seq1->count; i++)
+    {
+      inst1 = tsequence_inst_n(seq1, i);
+      inst2 = tsequence_inst_n(seq2, i);
+      value = tfunc_base_base(tinstant_value(inst1), tinstant_value(inst2),
+        seq1->valuetypid, seq2->valuetypid, param, lfinfo);
+      tsequence_builder_append(&builder, value, inst1->t);
+      DATUM_FREE(value, lfinfo.restypid);
+    }
+    result[0] = tsequence_builder_finish(&builder, inter->lower_inc,
+      inter->upper_inc);
+    pfree(inter);
+    return 1;
+  }
+
+  inst1 = tsequence_inst_n(seq1, 0);
+  inst2 = tsequence_inst_n(seq2, 0);
   TInstant *tofreeinst = NULL;
   int i = 0, j = 0, k = 0, l = 0;
   if (inst1->t < inter->lower)
@@ -1168,12 +1198,12 @@ sync_tfunc_tsequence_tsequence3(TSequence **result, const TSequence *seq1,
     j = tsequence_find_timestamp(seq2, inter->lower);
   }
   int count = (seq1->count - i + seq2->count - j) * 2;
-  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  tsequence_builder_init(&builder, lfinfo.restypid, count, lfinfo.reslinear,
+    NORMALIZE);
   TInstant **tofree = palloc(sizeof(TInstant *) * count);
   if (tofreeinst != NULL)
     tofree[l++] = tofreeinst;
   TInstant *prev1, *prev2;
-  Datum value;
   TimestampTz intertime;
   bool linear1 = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
   bool linear2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags);
@@ -1208,7 +1238,7 @@ sync_tfunc_tsequence_tsequence3(TSequence **result, const TSequence *seq1,
         linear2, intertime);
       value = tfunc_base_base(inter1, inter2, seq1->valuetypid,
         seq2->valuetypid, param, lfinfo);
-      instants[k++] = tinstant_make(value, intertime, lfinfo.restypid);
+      tsequence_builder_append(&builder, value, intertime);
       DATUM_FREE(inter1, seq1->valuetypid);
       DATUM_FREE(inter2, seq2->valuetypid);
       DATUM_FREE(value, lfinfo.restypid);
@@ -1217,30 +1247,24 @@ sync_tfunc_tsequence_tsequence3(TSequence **result, const TSequence *seq1,
     Datum value2 = tinstant_value(inst2);
     value = tfunc_base_base(value1, value2, seq1->valuetypid,
       seq2->valuetypid, param, lfinfo);
-    instants[k++] = tinstant_make(value, inst1->t, lfinfo.restypid);
+    tsequence_builder_append(&builder, value, inst1->t);
     DATUM_FREE(value, lfinfo.restypid);
+    k++;
     if (i == seq1->count || j == seq2->count)
       break;
     prev1 = inst1; prev2 = inst2;
     inst1 = tsequence_inst_n(seq1, i);
     inst2 = tsequence_inst_n(seq2, j);
   }
-  /* We are sure that k != 0 due to the period intersection test above */
-  /* The last two values of sequences with step interpolation and
-     exclusive upper bound must be equal */
-  if (!lfinfo.reslinear && !inter->upper_inc && k > 1)
-  {
-    tofree[l++] = instants[k - 1];
-    value = tinstant_value(instants[k - 2]);
-    instants[k - 1] = tinstant_make(value, instants[k - 1]->t, lfinfo.restypid);
-  }
+  /* We are sure that k != 0 due to the period intersection test above.
+   * The builder makes equal the last two values of sequences with step
+   * interpolation and exclusive upper bound */
+  result[0] = tsequence_builder_finish(&builder, inter->lower_inc,
+    inter->upper_inc);
 
   for (i = 0; i < l; i++)
     pfree(tofree[i]);
   pfree(tofree); pfree(inter);
-
-  result[0] = tsequence_make_free(instants, k, inter->lower_inc,
-    inter->upper_inc, lfinfo.reslinear, NORMALIZE);
   return 1;
 }
 
@@ -1319,7 +1343,7 @@ sync_tfunc_tsequence_tsequence4(TSequence **result, const TSequence *seq1,
       seq2->valuetypid, param, lfinfo);
     instants[0] = tinstant_make(startresult, start1->t, lfinfo.restypid);
     instants[1] = tinstant_make(endresult, end1->t, lfinfo.restypid);
-    result[k++] = tsequence_make(instants, 2, lower_inc, false,
+    result[k++] = tsequence_make1(instants, 2, lower_inc, false,
       lfinfo.reslinear, NORMALIZE_NO);
     pfree(instants[0]); pfree(instants[1]);
     DATUM_FREE(startresult, lfinfo.restypid);
@@ -1414,7 +1438,7 @@ sync_tfunc_tsequence_tsequence(const TSequence *seq1, const TSequence *seq2,
   if (count == 1)
     return (Temporal *) sequences[0];
   else
-    return (Temporal *) tsequenceset_make_free(sequences, k, NORMALIZE);
+    return (Temporal *) tsequenceset_make_free1(sequences, k, NORMALIZE);
 }
 
 /*****************************************************************************/
@@ -1458,7 +1482,7 @@ sync_tfunc_tsequenceset_tsequence(const TSequenceSet *ts, const TSequence *seq,
       break;
   }
   /* We need to normalize when discont is true */
-  return tsequenceset_make_free(sequences, k, NORMALIZE);
+  return tsequenceset_make_free1(sequences, k, NORMALIZE);
 }
 
 /**
@@ -1522,7 +1546,7 @@ sync_tfunc_tsequenceset_tsequenceset(const TSequenceSet *ts1,
       j++;
   }
   /* We need to normalize if the function has instantaneous discontinuities */
-  return tsequenceset_make_free(sequences, k, NORMALIZE);
+  return tsequenceset_make_free1(sequences, k, NORMALIZE);
 }
 
 /*****************************************************************************/
@@ -1613,3 +1637,510 @@ sync_tfunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Specialized functions for the most frequent operators
+ *
+ * The functions above call the lifted function through a variadic function
+ * pointer for every instant, and the function in turn dispatches on the
+ * Oids of its arguments. The functions below handle the arithmetic
+ * operators and the comparisons of temporal floats with a base value, and
+ * the Boolean operators of temporal Booleans with a base value, by applying
+ * the operator directly to the values of the instants.
+ *****************************************************************************/
+
+/**
+ * Returns the result of the arithmetic operator on the two values
+ *
+ * @param[in] x Value of the temporal float
+ * @param[in] d Base value
+ * @param[in] oper Arithmetic operator
+ * @param[in] invert True when the base value is the first argument
+ */
+static inline double
+float8_arithop(double x, double d, TArithmetic oper, bool invert)
+{
+  switch (oper)
+  {
+    case ADD:
+      return x + d;
+    case SUB:
+      return invert ? d - x : x - d;
+    case MULT:
+      return x * d;
+    default: /* DIV */
+      return invert ? d / x : x / d;
+  }
+}
+
+/**
+ * Applies the arithmetic operator to the value range of the temporal box
+ *
+ * @note The function supposes that the operator is monotonic
+ */
+static void
+tbox_arithop(TBOX *box, double d, TArithmetic oper, bool invert)
+{
+  double xmin = float8_arithop(box->xmin, d, oper, invert);
+  double xmax = float8_arithop(box->xmax, d, oper, invert);
+  box->xmin = Min(xmin, xmax);
+  box->xmax = Max(xmin, xmax);
+  return;
+}
+
+/**
+ * Applies in place the arithmetic operator to the value of the instant
+ */
+static void
+tfloatinst_arithop(TInstant *inst, double d, TArithmetic oper, bool invert)
+{
+  Datum *value_ptr = tinstant_value_ptr(inst);
+  *value_ptr = Float8GetDatum(float8_arithop(DatumGetFloat8(*value_ptr),
+    d, oper, invert));
+  return;
+}
+
+/**
+ * Applies in place the arithmetic operator to the values and the bounding
+ * boxes of the temporal sequence, including those of its block directory
+ */
+static void
+tfloatseq_arithop(TSequence *seq, double d, TArithmetic oper, bool invert)
+{
+  for (int i = 0; i < seq->count; i++)
+    tfloatinst_arithop(tsequence_inst_n(seq, i), d, oper, invert);
+  tbox_arithop((TBOX *) tsequence_bbox_ptr(seq), d, oper, invert);
+  int nblocks = tsequence_block_count(seq);
+  for (int i = 0; i < nblocks; i++)
+    tbox_arithop((TBOX *) tsequence_block_bbox_ptr(seq, i), d, oper, invert);
+  return;
+}
+
+/**
+ * Applies the arithmetic operator to the temporal float and the base value
+ *
+ * The result is computed on a copy of the temporal value whose values and
+ * bounding boxes are modified in place, which avoids constructing every
+ * instant of the result.
+ *
+ * @param[in] temp Temporal float
+ * @param[in] d Base value
+ * @param[in] oper Arithmetic operator
+ * @param[in] invert True when the base value is the first argument
+ * @pre The operator is monotonic, that is, it is not a multiplication by 0
+ * nor a division of the base value by the temporal float, since otherwise
+ * the result may require to be normalized
+ */
+Temporal *
+tfunc_tfloat_arithop_base(const Temporal *temp, double d, TArithmetic oper,
+  bool invert)
+{
+  assert(temp->valuetypid == FLOAT8OID);
+  assert((oper != MULT || d != 0.0) && (oper != DIV || ! invert));
+  Temporal *result = temporal_copy(temp);
+  ensure_valid_duration(result->duration);
+  if (result->duration == INSTANT)
+    tfloatinst_arithop((TInstant *) result, d, oper, invert);
+  else if (result->duration == INSTANTSET)
+  {
+    TInstantSet *ti = (TInstantSet *) result;
+    for (int i = 0; i < ti->count; i++)
+      tfloatinst_arithop(tinstantset_inst_n(ti, i), d, oper, invert);
+    tbox_arithop((TBOX *) tinstantset_bbox_ptr(ti), d, oper, invert);
+  }
+  else if (result->duration == SEQUENCE)
+    tfloatseq_arithop((TSequence *) result, d, oper, invert);
+  else /* result->duration == SEQUENCESET */
+  {
+    TSequenceSet *ts = (TSequenceSet *) result;
+    for (int i = 0; i < ts->count; i++)
+      tfloatseq_arithop(tsequenceset_seq_n(ts, i), d, oper, invert);
+    tbox_arithop((TBOX *) tsequenceset_bbox_ptr(ts), d, oper, invert);
+  }
+  return result;
+}
+
+/**
+ * Returns the result of the comparison of the two values
+ *
+ * @note As in function datum_eq2, the equality of floats is the equality
+ * of their representation
+ */
+static inline bool
+float8_comp(double x, double d, CachedOp op, bool invert)
+{
+  double l = invert ? d : x;
+  double r = invert ? x : d;
+  switch (op)
+  {
+    case EQ_OP:
+      return Float8GetDatum(l) == Float8GetDatum(r);
+    case NE_OP:
+      return Float8GetDatum(l) != Float8GetDatum(r);
+    case LT_OP:
+      return l < r;
+    case LE_OP:
+      return l <= r;
+    case GT_OP:
+      return l > r;
+    default: /* GE_OP */
+      return l >= r;
+  }
+}
+
+/**
+ * Replaces the instants of the array by the temporal Booleans resulting
+ * from comparing their values with the base value
+ *
+ * The instants of the result are allocated in a single chunk of memory
+ * which is returned in the last argument.
+ */
+static void
+tfloatinstarr_comp_base(TInstant **instants, int count, double d,
+  CachedOp op, bool invert, char **chunk)
+{
+  TInstant *first = tinstant_make(BoolGetDatum(false), instants[0]->t,
+    BOOLOID);
+  size_t size = VARSIZE(first);
+  *chunk = palloc(size * count);
+  for (int i = 0; i < count; i++)
+  {
+    TInstant *inst = (TInstant *) (*chunk + i * size);
+    memcpy(inst, first, size);
+    inst->t = instants[i]->t;
+    *tinstant_value_ptr(inst) = BoolGetDatum(float8_comp(
+      DatumGetFloat8(tinstant_value(instants[i])), d, op, invert));
+    instants[i] = inst;
+  }
+  pfree(first);
+  return;
+}
+
+/**
+ * Compares the temporal float sequence with step interpolation with the
+ * base value
+ */
+static TSequence *
+tfloatseq_comp_base(const TSequence *seq, double d, CachedOp op, bool invert)
+{
+  char *chunk;
+  TInstant **instants = tsequence_instants(seq);
+  tfloatinstarr_comp_base(instants, seq->count, d, op, invert, &chunk);
+  TSequence *result = tsequence_make1(instants, seq->count,
+    seq->period.lower_inc, seq->period.upper_inc, STEP, NORMALIZE);
+  pfree(chunk); pfree(instants);
+  return result;
+}
+
+/**
+ * Computes in a single pass the crossings of the segments defined by the
+ * arrays of values and timestamps with the base value
+ *
+ * The loop has no branches and no function calls so that it can be
+ * vectorized by the compiler. The formulas are those of function
+ * tfloatseq_intersection_value, so that the crossings are exactly those
+ * found when lifting the comparison.
+ *
+ * @param[in] values,times Arrays of values and timestamps
+ * @param[in] count Number of elements of the arrays
+ * @param[in] d Base value
+ * @param[out] crosstimes Timestamps of the crossings
+ * @param[out] hascross True when the segment crosses the base value, the
+ * corresponding element of crosstimes is meaningless otherwise
+ */
+static void
+tfloatsegarr_crossings(const double *values, const TimestampTz *times,
+  int count, double d, TimestampTz *crosstimes, bool *hascross)
+{
+  for (int i = 0; i < count - 1; i++)
+  {
+    double v1 = values[i], v2 = values[i + 1];
+    double min = Min(v1, v2);
+    double max = Max(v1, v2);
+    double partial = (d - min) / (max - min);
+    double fraction = v1 < v2 ? partial : 1 - partial;
+    hascross[i] = ! (d < min || d > max) &&
+      ! (fabs(fraction) < EPSILON || fabs(fraction - 1.0) < EPSILON);
+    crosstimes[i] = times[i] +
+      (long) ((double) (times[i + 1] - times[i]) * fraction);
+  }
+  return;
+}
+
+/**
+ * Returns the value of the linear segment at the timestamp
+ *
+ * @note Same computation as function tsequence_value_at_timestamp1
+ */
+static inline double
+tfloatseg_value_at_timestamp(double v1, double v2, TimestampTz t1,
+  TimestampTz t2, TimestampTz t)
+{
+  if (t == t1)
+    return v1;
+  if (t == t2)
+    return v2;
+  double ratio = (double) (t - t1) / (double) (t2 - t1);
+  return v1 + (v2 - v1) * ratio;
+}
+
+/**
+ * Sets the two instants to the Boolean value at the bounds of the segment
+ * and returns the step sequence defined by them
+ */
+static inline TSequence *
+tboolseg_make(TInstant **instants, bool b, TimestampTz t1, TimestampTz t2,
+  bool lower_inc, bool upper_inc)
+{
+  tinstant_set(instants[0], BoolGetDatum(b), t1);
+  tinstant_set(instants[1], BoolGetDatum(b), t2);
+  return tsequence_make1(instants, 2, lower_inc, upper_inc, STEP,
+    NORMALIZE_NO);
+}
+
+/**
+ * Sets the first instant to the Boolean value at the timestamp and returns
+ * the instantaneous sequence defined by it
+ */
+static inline TSequence *
+tboolinst_make_seq(TInstant **instants, bool b, TimestampTz t)
+{
+  tinstant_set(instants[0], BoolGetDatum(b), t);
+  return tinstant_to_tsequence(instants[0], STEP);
+}
+
+/**
+ * Compares the temporal float sequence with linear interpolation with the
+ * base value
+ *
+ * The values and timestamps of the sequence are copied into arrays, which
+ * are allocated in a single chunk of memory together with the crossings,
+ * and all the crossings are computed in a single pass with function
+ * tfloatsegarr_crossings. The sequences of the result are then built as in
+ * function tfunc_tsequence_base_discont1, which is the generic version of
+ * this function, but without going through Datums and the lifted function.
+ *
+ * @param[out] result Array on which the pointers of the newly constructed
+ * sequences are stored
+ * @param[in] seq Temporal float
+ * @param[in] d Base value
+ * @param[in] op Comparison operator
+ * @param[in] invert True when the base value is the first argument
+ * @result Number of sequences of the result, which is at most three times
+ * the number of instants of the sequence
+ */
+static int
+tfloatseq_linear_comp_base(TSequence **result, const TSequence *seq,
+  double d, CachedOp op, bool invert)
+{
+  int count = seq->count;
+  char *chunk = palloc((sizeof(double) + sizeof(TimestampTz) * 2 +
+    sizeof(bool)) * count);
+  double *values = (double *) chunk;
+  TimestampTz *times = (TimestampTz *) (values + count);
+  TimestampTz *crosstimes = times + count;
+  bool *hascross = (bool *) (crosstimes + count);
+  for (int i = 0; i < count; i++)
+  {
+    const TInstant *inst = tsequence_inst_n(seq, i);
+    values[i] = DatumGetFloat8(tinstant_value(inst));
+    times[i] = inst->t;
+  }
+  tfloatsegarr_crossings(values, times, count, d, crosstimes, hascross);
+
+  TInstant *instants[2];
+  bool startresult = float8_comp(values[0], d, op, invert);
+  instants[0] = tinstant_make(BoolGetDatum(startresult), times[0], BOOLOID);
+  /* Instantaneous sequence */
+  if (count == 1)
+  {
+    result[0] = tinstant_to_tsequence(instants[0], STEP);
+    pfree(instants[0]); pfree(chunk);
+    return 1;
+  }
+
+  /* General case */
+  instants[1] = tinstant_make(BoolGetDatum(startresult), times[0], BOOLOID);
+  int k = 0;
+  bool lower_inc = seq->period.lower_inc;
+  for (int i = 0; i < count - 1; i++)
+  {
+    /* Each iteration of the loop adds between one and three sequences */
+    double v1 = values[i], v2 = values[i + 1];
+    TimestampTz t1 = times[i], t2 = times[i + 1];
+    bool endresult = float8_comp(v2, d, op, invert);
+    bool upper_inc = (i == count - 2) ? seq->period.upper_inc : false;
+    /* As in function datum_eq the equality of floats is the equality of
+     * their representation */
+    if (Float8GetDatum(v1) == Float8GetDatum(v2))
+      /* Constant segment */
+      result[k++] = tboolseg_make(instants, startresult, t1, t2, lower_inc,
+        upper_inc);
+    else if (Float8GetDatum(v1) == Float8GetDatum(d) ||
+      Float8GetDatum(v2) == Float8GetDatum(d))
+    {
+      /* The start or the end value is equal to the base value */
+      TimestampTz inttime = t1 + ((t2 - t1) / 2);
+      bool intresult = float8_comp(tfloatseg_value_at_timestamp(v1, v2,
+        t1, t2, inttime), d, op, invert);
+      bool lower_eq = lower_inc && startresult == intresult;
+      bool upper_eq = upper_inc && intresult == endresult;
+      if (lower_inc && ! lower_eq)
+        result[k++] = tboolinst_make_seq(instants, startresult, t1);
+      result[k++] = tboolseg_make(instants, intresult, t1, t2, lower_eq,
+        upper_eq);
+      if (upper_inc && ! upper_eq)
+        result[k++] = tboolinst_make_seq(instants, endresult, t2);
+    }
+    else if (! hascross[i])
+    {
+      result[k++] = tboolseg_make(instants, startresult, t1, t2, lower_inc,
+        false);
+      if (upper_inc)
+        result[k++] = tboolinst_make_seq(instants, endresult, t2);
+    }
+    else
+    {
+      TimestampTz inttime = crosstimes[i];
+      bool intresult = float8_comp(tfloatseg_value_at_timestamp(v1, v2,
+        t1, t2, inttime), d, op, invert);
+      bool lower_eq = startresult == intresult;
+      bool upper_eq = upper_inc && intresult == endresult;
+      if (lower_eq && upper_eq)
+        result[k++] = tboolseg_make(instants, startresult, t1, t2,
+          lower_inc, true);
+      else
+      {
+        result[k++] = tboolseg_make(instants, startresult, t1, inttime,
+          lower_inc, lower_eq);
+        if (! lower_eq && ! upper_eq)
+          result[k++] = tboolinst_make_seq(instants, intresult, inttime);
+        result[k++] = tboolseg_make(instants, endresult, inttime, t2,
+          upper_eq, upper_inc);
+      }
+    }
+    startresult = endresult;
+    lower_inc = true;
+  }
+  pfree(instants[0]); pfree(instants[1]); pfree(chunk);
+  return k;
+}
+
+/**
+ * Compares the temporal float with the base value
+ *
+ * @param[in] temp Temporal float
+ * @param[in] d Base value
+ * @param[in] op Comparison operator
+ * @param[in] invert True when the base value is the first argument
+ * @note When the temporal float has linear interpolation the result takes
+ * into account the crossings of the segments with the base value and is
+ * a temporal sequence set, as for the generic lifted comparison
+ */
+Temporal *
+tfunc_tfloat_comp_base(const Temporal *temp, double d, CachedOp op,
+  bool invert)
+{
+  assert(temp->valuetypid == FLOAT8OID);
+  Temporal *result;
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+  {
+    const TInstant *inst = (const TInstant *) temp;
+    result = (Temporal *) tinstant_make(BoolGetDatum(float8_comp(
+      DatumGetFloat8(tinstant_value(inst)), d, op, invert)), inst->t,
+      BOOLOID);
+  }
+  else if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (const TInstantSet *) temp;
+    char *chunk;
+    TInstant **instants = tinstantset_instants(ti);
+    tfloatinstarr_comp_base(instants, ti->count, d, op, invert, &chunk);
+    result = (Temporal *) tinstantset_make(instants, ti->count);
+    pfree(chunk); pfree(instants);
+  }
+  else if (temp->duration == SEQUENCE)
+  {
+    const TSequence *seq = (const TSequence *) temp;
+    if (MOBDB_FLAGS_GET_LINEAR(seq->flags))
+    {
+      TSequence **sequences = palloc(sizeof(TSequence *) * seq->count * 3);
+      int k = tfloatseq_linear_comp_base(sequences, seq, d, op, invert);
+      result = (Temporal *) tsequenceset_make_free1(sequences, k, NORMALIZE);
+    }
+    else
+      result = (Temporal *) tfloatseq_comp_base(seq, d, op, invert);
+  }
+  else if (MOBDB_FLAGS_GET_LINEAR(temp->flags))
+  {
+    const TSequenceSet *ts = (const TSequenceSet *) temp;
+    TSequence **sequences = palloc(sizeof(TSequence *) * ts->totalcount * 3);
+    int k = 0;
+    for (int i = 0; i < ts->count; i++)
+      k += tfloatseq_linear_comp_base(&sequences[k],
+        tsequenceset_seq_n(ts, i), d, op, invert);
+    result = (Temporal *) tsequenceset_make_free1(sequences, k, NORMALIZE);
+  }
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (const TSequenceSet *) temp;
+    TSequence **sequences = palloc(sizeof(TSequence *) * ts->count);
+    for (int i = 0; i < ts->count; i++)
+      sequences[i] = tfloatseq_comp_base(tsequenceset_seq_n(ts, i), d, op,
+        invert);
+    result = (Temporal *) tsequenceset_make_free1(sequences, ts->count,
+      NORMALIZE);
+  }
+  return result;
+}
+
+/**
+ * Applies the Boolean and or or operator to the temporal Boolean and the
+ * base value
+ *
+ * The result is either the temporal value itself, when the base value is
+ * the neutral element of the operator, or the constant base value during
+ * the time frame of the temporal value, when it is the absorbing element.
+ *
+ * @param[in] temp Temporal Boolean
+ * @param[in] b Base value
+ * @param[in] isand True for the and operator, false for the or operator
+ */
+Temporal *
+tfunc_tbool_boolop_base(const Temporal *temp, bool b, bool isand)
+{
+  assert(temp->valuetypid == BOOLOID);
+  if (b == isand)
+    return (Temporal *) temp;
+
+  Temporal *result;
+  Datum value = BoolGetDatum(b);
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+    result = (Temporal *) tinstant_make(value, ((TInstant *) temp)->t,
+      BOOLOID);
+  else if (temp->duration == INSTANTSET)
+  {
+    TInstantSet *ti = tinstantset_copy((TInstantSet *) temp);
+    for (int i = 0; i < ti->count; i++)
+      *tinstant_value_ptr(tinstantset_inst_n(ti, i)) = value;
+    result = (Temporal *) ti;
+  }
+  else if (temp->duration == SEQUENCE)
+    result = (Temporal *) tsequence_from_base_internal(value, BOOLOID,
+      &((TSequence *) temp)->period, STEP);
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (const TSequenceSet *) temp;
+    TSequence **sequences = palloc(sizeof(TSequence *) * ts->count);
+    for (int i = 0; i < ts->count; i++)
+      sequences[i] = tsequence_from_base_internal(value, BOOLOID,
+        &tsequenceset_seq_n(ts, i)->period, STEP);
+    result = (Temporal *) tsequenceset_make_free1(sequences, ts->count,
+      NORMALIZE);
+  }
+  return result;
+}
+
+/*****************************************************************************/
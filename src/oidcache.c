@@ -126,6 +126,90 @@ Oid _op_oids[sizeof(_op_names) / sizeof(char *)]
   [sizeof(_type_names) / sizeof(char *)]
   [sizeof(_type_names) / sizeof(char *)];
 
+/**
+ * Compact representation of the Oid cache stored in a single row of the
+ * table pg_temporal_oidcache. The Oids of the types are followed by the
+ * pairs composed of the position of an operator in the flattened array
+ * `_op_oids` and its Oid.
+ */
+typedef struct
+{
+  int32 vl_len_;   /**< varlena header (do not touch directly!) */
+  int32 ntypes;    /**< Number of types */
+  int32 nops;      /**< Number of operator classes */
+  int32 count;     /**< Number of operators */
+  Oid data[FLEXIBLE_ARRAY_MEMBER];
+} OidCacheBlob;
+
+/**
+ * Populate the Oid cache for types and operators from its compact
+ * representation, which is read with a single tuple fetch
+ *
+ * @result False if the compact representation is not available or does
+ * not correspond to the arrays of names, for example after an upgrade of
+ * the library not followed by an upgrade of the extension
+ */
+static bool
+populate_oidcache_blob()
+{
+  int ntypes = sizeof(_type_names) / sizeof(char *);
+  int nops = sizeof(_op_names) / sizeof(char *);
+  bool result = false;
+
+  Oid catalog = RelnameGetRelid("pg_temporal_oidcache");
+  if (!OidIsValid(catalog))
+    return false;
+#if MOBDB_PGSQL_VERSION < 130000
+  Relation rel = heap_open(catalog, AccessShareLock);
+#else
+  Relation rel = table_open(catalog, AccessShareLock);
+#endif
+  ScanKeyData scandata;
+#if MOBDB_PGSQL_VERSION >= 120000
+  TableScanDesc scan = table_beginscan_catalog(rel, 0, &scandata);
+#else
+  HeapScanDesc scan = heap_beginscan_catalog(rel, 0, &scandata);
+#endif
+  HeapTuple tuple = heap_getnext(scan, ForwardScanDirection);
+  if (HeapTupleIsValid(tuple))
+  {
+    bool isnull = false;
+    Datum value = heap_getattr(tuple, 1, rel->rd_att, &isnull);
+    if (!isnull)
+    {
+      OidCacheBlob *blob = (OidCacheBlob *) PG_DETOAST_DATUM(value);
+      if (blob->ntypes == ntypes && blob->nops == nops &&
+        VARSIZE(blob) == offsetof(OidCacheBlob, data) +
+          (ntypes + 2 * blob->count) * sizeof(Oid))
+      {
+        Oid *opoids = (Oid *) _op_oids;
+        Oid *pairs = blob->data + ntypes;
+        memcpy(_type_oids, blob->data, ntypes * sizeof(Oid));
+        bzero(_op_oids, sizeof(_op_oids));
+        result = true;
+        for (int i = 0; i < blob->count; i++)
+        {
+          if (pairs[2 * i] >= (Oid) (nops * ntypes * ntypes))
+          {
+            result = false;
+            break;
+          }
+          opoids[pairs[2 * i]] = pairs[2 * i + 1];
+        }
+      }
+      if ((Pointer) blob != DatumGetPointer(value))
+        pfree(blob);
+    }
+  }
+  heap_endscan(scan);
+#if MOBDB_PGSQL_VERSION < 130000
+  heap_close(rel, AccessShareLock);
+#else
+  table_close(rel, AccessShareLock);
+#endif
+  return result;
+}
+
 /**
  * Populate the Oid cache for types
  */
@@ -156,43 +240,46 @@ populate_operators()
 
   PG_TRY();
   {
+    /* Try first the compact representation of the cache */
+    if (!populate_oidcache_blob())
+    {
+      populate_types();
+      bzero(_op_oids, sizeof(_op_oids));
 
-    populate_types();
-    bzero(_op_oids, sizeof(_op_oids));
-
-    /*
-     * This fetches the pre-computed operator cache from the catalog where
-     * it is stored in a table. See the fill_opcache function below.
-     */
-    Oid catalog = RelnameGetRelid("pg_temporal_opcache");
+      /*
+       * This fetches the pre-computed operator cache from the catalog where
+       * it is stored in a table. See the fill_opcache function below.
+       */
+      Oid catalog = RelnameGetRelid("pg_temporal_opcache");
 #if MOBDB_PGSQL_VERSION < 130000
-    Relation rel = heap_open(catalog, AccessShareLock);
+      Relation rel = heap_open(catalog, AccessShareLock);
 #else
-    Relation rel = table_open(catalog, AccessShareLock);
+      Relation rel = table_open(catalog, AccessShareLock);
 #endif
-    TupleDesc tupDesc = rel->rd_att;
-    ScanKeyData scandata;
+      TupleDesc tupDesc = rel->rd_att;
+      ScanKeyData scandata;
 #if MOBDB_PGSQL_VERSION >= 120000
-    TableScanDesc scan = table_beginscan_catalog(rel, 0, &scandata);
+      TableScanDesc scan = table_beginscan_catalog(rel, 0, &scandata);
 #else
-    HeapScanDesc scan = heap_beginscan_catalog(rel, 0, &scandata);
+      HeapScanDesc scan = heap_beginscan_catalog(rel, 0, &scandata);
 #endif
-    HeapTuple tuple = heap_getnext(scan, ForwardScanDirection);
-    while (HeapTupleIsValid(tuple))
-    {
-      bool isnull = false;
-      int32 i = DatumGetInt32(heap_getattr(tuple, 1, tupDesc, &isnull));
-      int32 j = DatumGetInt32(heap_getattr(tuple, 2, tupDesc, &isnull));
-      int32 k = DatumGetInt32(heap_getattr(tuple, 3, tupDesc, &isnull));
-      _op_oids[i][j][k] = DatumGetObjectId(heap_getattr(tuple, 4, tupDesc, &isnull));
-      tuple = heap_getnext(scan, ForwardScanDirection);
-    }
-    heap_endscan(scan);
+      HeapTuple tuple = heap_getnext(scan, ForwardScanDirection);
+      while (HeapTupleIsValid(tuple))
+      {
+        bool isnull = false;
+        int32 i = DatumGetInt32(heap_getattr(tuple, 1, tupDesc, &isnull));
+        int32 j = DatumGetInt32(heap_getattr(tuple, 2, tupDesc, &isnull));
+        int32 k = DatumGetInt32(heap_getattr(tuple, 3, tupDesc, &isnull));
+        _op_oids[i][j][k] = DatumGetObjectId(heap_getattr(tuple, 4, tupDesc, &isnull));
+        tuple = heap_getnext(scan, ForwardScanDirection);
+      }
+      heap_endscan(scan);
 #if MOBDB_PGSQL_VERSION < 130000
-    heap_close(rel, AccessShareLock);
+      heap_close(rel, AccessShareLock);
 #else
-    table_close(rel, AccessShareLock);
+      table_close(rel, AccessShareLock);
 #endif
+    }
     _ready = true;
 
     PopOverrideSearchPath();
@@ -237,7 +324,8 @@ oper_oid(CachedOp op, CachedType lt, CachedType rt)
 PG_FUNCTION_INFO_V1(fill_opcache);
 /**
  * Function executed during the `CREATE EXTENSION` to precompute the
- * operator cache and store it as a table in the catalog
+ * operator cache and store it as a table in the catalog, both as one row
+ * per operator and as a single row containing its compact representation
  */
 PGDLLEXPORT Datum
 fill_opcache(PG_FUNCTION_ARGS)
@@ -256,6 +344,8 @@ fill_opcache(PG_FUNCTION_ARGS)
   populate_types();
   int32 m = sizeof(_op_names) / sizeof(char *);
   int32 n = sizeof(_type_names) / sizeof(char *);
+  Oid *pairs = palloc(sizeof(Oid) * 2 * m * n * n);
+  int32 count = 0;
   for (int32 i = 0; i < m; i++)
   {
     List* lst = list_make1(makeString((char *) _op_names[i]));
@@ -270,6 +360,9 @@ fill_opcache(PG_FUNCTION_ARGS)
           data[2] = Int32GetDatum(k);
           HeapTuple t = heap_form_tuple(tupDesc, data, isnull);
           simple_heap_insert(rel, t);
+          pairs[2 * count] = (Oid) ((i * n + j) * n + k);
+          pairs[2 * count + 1] = DatumGetObjectId(data[3]);
+          count++;
         }
       }
     pfree(lst);
@@ -279,6 +372,31 @@ fill_opcache(PG_FUNCTION_ARGS)
 #else
   table_close(rel, AccessExclusiveLock);
 #endif
+
+  /* Store the compact representation of the cache */
+  size_t size = offsetof(OidCacheBlob, data) + (n + 2 * count) * sizeof(Oid);
+  OidCacheBlob *blob = palloc(size);
+  SET_VARSIZE(blob, size);
+  blob->ntypes = n;
+  blob->nops = m;
+  blob->count = count;
+  memcpy(blob->data, _type_oids, n * sizeof(Oid));
+  memcpy(blob->data + n, pairs, 2 * count * sizeof(Oid));
+  catalog = RelnameGetRelid("pg_temporal_oidcache");
+#if MOBDB_PGSQL_VERSION < 130000
+  rel = heap_open(catalog, AccessExclusiveLock);
+#else
+  rel = table_open(catalog, AccessExclusiveLock);
+#endif
+  data[0] = PointerGetDatum(blob);
+  HeapTuple t = heap_form_tuple(rel->rd_att, data, isnull);
+  simple_heap_insert(rel, t);
+#if MOBDB_PGSQL_VERSION < 130000
+  heap_close(rel, AccessExclusiveLock);
+#else
+  table_close(rel, AccessExclusiveLock);
+#endif
+  pfree(blob); pfree(pairs);
   PG_RETURN_VOID();
 }
 
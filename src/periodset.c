@@ -248,6 +248,99 @@ periodset_find_timestamp(const PeriodSet *ps, TimestampTz t, int *loc)
   return false;
 }
 
+/**
+ * Fills the Eytzinger layout of the lower bounds of the period set value
+ * with an in-order traversal of the implicit tree
+ */
+static int
+periodset_index_fill(const PeriodSet *ps, PeriodSetIndex *idx, int i, int k)
+{
+  if (k <= idx->count)
+  {
+    i = periodset_index_fill(ps, idx, i, 2 * k);
+    idx->bounds[k] = periodset_per_n(ps, i)->lower;
+    idx->pos[k] = i++;
+    i = periodset_index_fill(ps, idx, i, 2 * k + 1);
+  }
+  return i;
+}
+
+/**
+ * Returns the search index of the period set value
+ *
+ * @note The index is allocated in a single chunk of memory that can be
+ * freed with pfree
+ */
+PeriodSetIndex *
+periodset_index_make(const PeriodSet *ps)
+{
+  /* Position 0 of the arrays is not used */
+  size_t size = double_pad(sizeof(PeriodSetIndex)) +
+    sizeof(TimestampTz) * (ps->count + 1) + sizeof(int) * (ps->count + 1);
+  PeriodSetIndex *result = palloc(size);
+  result->count = ps->count;
+  result->bounds = (TimestampTz *) ((char *) result +
+    double_pad(sizeof(PeriodSetIndex)));
+  result->pos = (int *) (result->bounds + ps->count + 1);
+  periodset_index_fill(ps, result, 0, 1);
+  return result;
+}
+
+/**
+ * Returns the location of the timestamp in the period set value using
+ * its search index
+ *
+ * The result is the same as the one of the function periodset_find_timestamp
+ *
+ * @param[in] idx Search index of the period set value
+ * @param[in] ps Period set value
+ * @param[in] t Timestamp
+ * @param[out] loc Location
+ * @result Returns true if the timestamp is contained in the period set value
+ */
+bool
+periodset_index_find_timestamp(const PeriodSetIndex *idx, const PeriodSet *ps,
+  TimestampTz t, int *loc)
+{
+  /* Descend the implicit tree without branching on the comparison */
+  int k = 1;
+  while (k <= idx->count)
+    k = 2 * k + (idx->bounds[k] <= t);
+  /* Undo the right turns after the last left turn, which gives the
+   * position of the first lower bound greater than t, or 0 if there is
+   * none */
+  while (k & 1)
+    k >>= 1;
+  k >>= 1;
+  /* Last period whose lower bound is not greater than t */
+  int n = (k == 0) ? idx->count - 1 : idx->pos[k] - 1;
+  if (n < 0)
+  {
+    *loc = 0;
+    return false;
+  }
+  Period *p = periodset_per_n(ps, n);
+  if (contains_period_timestamp_internal(p, t))
+  {
+    *loc = n;
+    return true;
+  }
+  if (t == p->lower)
+  {
+    /* The lower bound is exclusive and the previous period may end at t */
+    if (n > 0 &&
+      contains_period_timestamp_internal(periodset_per_n(ps, n - 1), t))
+    {
+      *loc = n - 1;
+      return true;
+    }
+    *loc = n;
+    return false;
+  }
+  *loc = n + 1;
+  return false;
+}
+
 /*****************************************************************************
  * Input/output functions
  *****************************************************************************/
@@ -746,6 +839,30 @@ periodset_timestamps(PG_FUNCTION_ARGS)
 PeriodSet *
 periodset_shift_internal(const PeriodSet *ps, const Interval *interval)
 {
+  /* An interval without months and days shifts every bound by the same
+   * amount and thus the periods can be shifted in place in a copy */
+  Period *bbox = periodset_bbox(ps);
+  if (interval->month == 0 && interval->day == 0 &&
+    ! TIMESTAMP_NOT_FINITE(bbox->lower) && ! TIMESTAMP_NOT_FINITE(bbox->upper))
+  {
+    /* Test the bounding box to raise the same error as the general case */
+    if (! IS_VALID_TIMESTAMP(bbox->lower + interval->time) ||
+      ! IS_VALID_TIMESTAMP(bbox->upper + interval->time))
+      ereport(ERROR, (errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE),
+        errmsg("timestamp out of range")));
+    PeriodSet *result = periodset_copy(ps);
+    for (int i = 0; i < result->count; i++)
+    {
+      Period *p = periodset_per_n(result, i);
+      p->lower += interval->time;
+      p->upper += interval->time;
+    }
+    bbox = periodset_bbox(result);
+    bbox->lower += interval->time;
+    bbox->upper += interval->time;
+    return result;
+  }
+
   Period **periods = palloc(sizeof(Period *) * ps->count);
   for (int i = 0; i < ps->count; i++)
   {
@@ -13,6 +13,7 @@
 #include "rangetypes_ext.h"
 
 #include <assert.h>
+#include <float.h>
 #include <utils/builtins.h>
 
 #include "temporal.h"
@@ -85,6 +86,41 @@ range_bounds(RangeType *range, double *xmin, double *xmax)
   }
 }
 
+/**
+ * Returns the bounds of the ranges as doubles. Infinite bounds are
+ * represented by -DBL_MAX and DBL_MAX.
+ *
+ * @param[in] ranges Array of non-empty ranges of the same type
+ * @param[in] count Number of elements in the input array
+ * @param[out] xmin, xmax Arrays of lower and upper bounds
+ * @note The typcache lookup is done once for the whole array
+ */
+void
+rangearr_bounds(RangeType **ranges, int count, double *xmin, double *xmax)
+{
+  ensure_tnumber_range_type(ranges[0]->rangetypid);
+  TypeCacheEntry *typcache = lookup_type_cache(ranges[0]->rangetypid,
+    TYPECACHE_RANGE_INFO);
+  bool isint = (ranges[0]->rangetypid == type_oid(T_INTRANGE));
+  for (int i = 0; i < count; i++)
+  {
+    RangeBound lower, upper;
+    bool empty;
+    range_deserialize(typcache, ranges[i], &lower, &upper, &empty);
+    assert(! empty);
+    if (lower.infinite)
+      xmin[i] = -DBL_MAX;
+    else
+      xmin[i] = isint ? (double) DatumGetInt32(lower.val) :
+        DatumGetFloat8(lower.val);
+    if (upper.infinite)
+      xmax[i] = DBL_MAX;
+    else
+      xmax[i] = isint ? (double) DatumGetInt32(upper.val) :
+        DatumGetFloat8(upper.val);
+  }
+}
+
 /**
  * Returns true if the upper bound of the range value is inclusive
  */ 
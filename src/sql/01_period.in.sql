@@ -213,8 +213,8 @@ CREATE FUNCTION period_hash(period)
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 #if MOBDB_PGSQL_VERSION >= 110000
-CREATE FUNCTION period_hash_extended(period)
-  RETURNS integer
+CREATE FUNCTION period_hash_extended(period, bigint)
+  RETURNS bigint
   AS 'MODULE_PATHNAME', 'period_hash_extended'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 #endif
@@ -222,6 +222,9 @@ CREATE FUNCTION period_hash_extended(period)
 CREATE OPERATOR CLASS hash_period_ops
   DEFAULT FOR TYPE period USING hash AS
     OPERATOR    1   = ,
+#if MOBDB_PGSQL_VERSION >= 110000
+    FUNCTION    2   period_hash_extended(period, bigint),
+#endif
     FUNCTION    1   period_hash(period);
 
 /******************************************************************************/
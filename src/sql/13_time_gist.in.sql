@@ -32,6 +32,12 @@ CREATE FUNCTION period_gist_penalty(internal, internal, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; 
+#if MOBDB_PGSQL_VERSION >= 140000
+CREATE FUNCTION period_gist_sortsupport(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'period_gist_sortsupport'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
 CREATE FUNCTION period_gist_picksplit(internal, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME'
@@ -90,6 +96,9 @@ CREATE OPERATOR CLASS gist_timestampset_ops
   FUNCTION  3  timestampset_gist_compress(internal),
 #if MOBDB_PGSQL_VERSION < 110000
   FUNCTION  4  period_gist_decompress(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  period_gist_sortsupport(internal),
 #endif
   FUNCTION  5  period_gist_penalty(internal, internal, internal),
   FUNCTION  6  period_gist_picksplit(internal, internal),
@@ -152,6 +161,9 @@ CREATE OPERATOR CLASS period_gist_ops
   FUNCTION  3  period_gist_compress(internal),
 #if MOBDB_PGSQL_VERSION < 110000
   FUNCTION  4  period_gist_decompress(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  period_gist_sortsupport(internal),
 #endif
   FUNCTION  5  period_gist_penalty(internal, internal, internal),
   FUNCTION  6  period_gist_picksplit(internal, internal),
@@ -215,9 +227,78 @@ CREATE OPERATOR CLASS gist_periodset_ops
   FUNCTION  3  periodset_gist_compress(internal),
 #if MOBDB_PGSQL_VERSION < 110000
   FUNCTION  4  period_gist_decompress(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  period_gist_sortsupport(internal),
 #endif
   FUNCTION  5  period_gist_penalty(internal, internal, internal),
   FUNCTION  6  period_gist_picksplit(internal, internal),
   FUNCTION  7  period_gist_same(period, period, internal);
 
+/******************************************************************************
+ * BRIN index for periods
+ ******************************************************************************/
+
+CREATE FUNCTION period_brin_opcinfo(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'period_brin_opcinfo'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION period_brin_add_value(internal, internal, internal, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'period_brin_add_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION period_brin_consistent(internal, internal, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'period_brin_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION period_brin_union(internal, internal, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'period_brin_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS period_brin_ops
+  DEFAULT FOR TYPE period USING brin AS
+  -- overlaps
+  OPERATOR  3    && (period, timestampset),
+  OPERATOR  3    && (period, period),
+  OPERATOR  3    && (period, periodset),
+  -- contains
+  OPERATOR  7    @> (period, timestamptz),
+  OPERATOR  7    @> (period, timestampset),
+  OPERATOR  7    @> (period, period),
+  OPERATOR  7    @> (period, periodset),
+  -- contained by
+  OPERATOR  8    <@ (period, period),
+  OPERATOR  8    <@ (period, periodset),
+  -- adjacent
+  OPERATOR  17    -|- (period, period),
+  OPERATOR  17    -|- (period, periodset),
+  -- equals
+  OPERATOR  18    = (period, period),
+  -- overlaps or before
+  OPERATOR  28    &<# (period, timestamptz),
+  OPERATOR  28    &<# (period, timestampset),
+  OPERATOR  28    &<# (period, period),
+  OPERATOR  28    &<# (period, periodset),
+  -- strictly before
+  OPERATOR  29    <<# (period, timestamptz),
+  OPERATOR  29    <<# (period, timestampset),
+  OPERATOR  29    <<# (period, period),
+  OPERATOR  29    <<# (period, periodset),
+  -- strictly after
+  OPERATOR  30    #>> (period, timestamptz),
+  OPERATOR  30    #>> (period, timestampset),
+  OPERATOR  30    #>> (period, period),
+  OPERATOR  30    #>> (period, periodset),
+  -- overlaps or after
+  OPERATOR  31    #&> (period, timestamptz),
+  OPERATOR  31    #&> (period, timestampset),
+  OPERATOR  31    #&> (period, period),
+  OPERATOR  31    #&> (period, periodset),
+  -- functions
+  FUNCTION  1  period_brin_opcinfo(internal),
+  FUNCTION  2  period_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  period_brin_consistent(internal, internal, internal),
+  FUNCTION  4  period_brin_union(internal, internal, internal);
+
 /******************************************************************************/
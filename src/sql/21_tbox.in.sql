@@ -224,6 +224,11 @@ CREATE FUNCTION tnumber_joinsel(internal, oid, internal, smallint, internal)
   AS 'MODULE_PATHNAME', 'tnumber_joinsel'
   LANGUAGE C IMMUTABLE STRICT;
 
+CREATE FUNCTION tnumber_ever_sel(internal, oid, internal, integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'tnumber_ever_sel'
+  LANGUAGE C IMMUTABLE STRICT;
+
 /*****************************************************************************
  * Topological operators
  *****************************************************************************/
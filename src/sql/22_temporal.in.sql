@@ -557,6 +557,57 @@ CREATE FUNCTION memSize(ttext)
   AS 'MODULE_PATHNAME', 'temporal_mem_size'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/*
+ * The size is the one of the value in the standard format, while raw_size
+ * and stored_size are the sizes of the value as stored in the table before
+ * and after compression, which differ from the size for packed values
+ */
+CREATE TYPE mem_breakdown AS (
+  header bigint,
+  bbox bigint,
+  offsets bigint,
+  blocks bigint,
+  instants bigint,
+  base_values bigint,
+  trajectory bigint,
+  size bigint,
+  raw_size bigint,
+  stored_size bigint
+);
+
+CREATE FUNCTION memBreakdown(tbool)
+  RETURNS mem_breakdown
+  AS 'MODULE_PATHNAME', 'temporal_mem_breakdown'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION memBreakdown(tint)
+  RETURNS mem_breakdown
+  AS 'MODULE_PATHNAME', 'temporal_mem_breakdown'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION memBreakdown(tfloat)
+  RETURNS mem_breakdown
+  AS 'MODULE_PATHNAME', 'temporal_mem_breakdown'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION memBreakdown(ttext)
+  RETURNS mem_breakdown
+  AS 'MODULE_PATHNAME', 'temporal_mem_breakdown'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION mem_breakdown_add(mem_breakdown, mem_breakdown)
+  RETURNS mem_breakdown
+  AS 'SELECT ROW($1.header + $2.header, $1.bbox + $2.bbox,
+    $1.offsets + $2.offsets, $1.blocks + $2.blocks,
+    $1.instants + $2.instants, $1.base_values + $2.base_values,
+    $1.trajectory + $2.trajectory, $1.size + $2.size,
+    $1.raw_size + $2.raw_size, $1.stored_size + $2.stored_size)::mem_breakdown'
+  LANGUAGE SQL IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE sum(mem_breakdown) (
+  SFUNC = mem_breakdown_add,
+  STYPE = mem_breakdown,
+  COMBINEFUNC = mem_breakdown_add,
+  PARALLEL = SAFE
+);
+
 -- values is a reserved word in SQL
 CREATE FUNCTION getValue(tbool)
   RETURNS boolean
@@ -1025,10 +1076,22 @@ CREATE FUNCTION shiftTscale(ttext, interval, interval)
 -- Restriction functions
 -------------------------------------------------------------------------------
 
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION tbool_at_value_support(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tbool_at_value_support'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION atValue(tbool, boolean)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'temporal_at_value'
+  SUPPORT tbool_at_value_support
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION atValue(tbool, boolean)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'temporal_at_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
 CREATE FUNCTION atValue(tint, integer)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'temporal_at_value'
@@ -1230,13 +1293,13 @@ CREATE OPERATOR ?= (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = ever_eq,
   NEGATOR = %<>,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?= (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = ever_eq,
   NEGATOR = %<>,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?= (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1272,13 +1335,13 @@ CREATE OPERATOR %= (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = always_eq,
   NEGATOR = ?<>,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %= (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = always_eq,
   NEGATOR = ?<>,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %= (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1314,13 +1377,13 @@ CREATE OPERATOR ?<> (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = ever_ne,
   NEGATOR = %=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?<> (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = ever_ne,
   NEGATOR = %=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?<> (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1356,13 +1419,13 @@ CREATE OPERATOR %<> (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = always_ne,
   NEGATOR = ?=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %<> (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = always_ne,
   NEGATOR = ?=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %<> (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1392,13 +1455,13 @@ CREATE OPERATOR ?< (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = ever_lt,
   NEGATOR = %>=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?< (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = ever_lt,
   NEGATOR = %>=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?< (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1424,13 +1487,13 @@ CREATE OPERATOR ?<= (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = ever_le,
   NEGATOR = %>,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?<= (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = ever_le,
   NEGATOR = %>,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?<= (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1456,13 +1519,13 @@ CREATE OPERATOR %< (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = always_lt,
   NEGATOR = ?>=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %< (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = always_lt,
   NEGATOR = ?>=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %< (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1488,13 +1551,13 @@ CREATE OPERATOR %<= (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = always_le,
   NEGATOR = ?>,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %<= (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = always_le,
   NEGATOR = ?>,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %<= (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1520,13 +1583,13 @@ CREATE OPERATOR ?> (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = ever_gt,
   NEGATOR = %<=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?> (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = ever_gt,
   NEGATOR = %<=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?> (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1552,13 +1615,13 @@ CREATE OPERATOR ?>= (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = ever_ge,
   NEGATOR = %<,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?>= (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = ever_ge,
   NEGATOR = %<,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR ?>= (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1584,13 +1647,13 @@ CREATE OPERATOR %> (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = always_gt,
   NEGATOR = ?<=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %> (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = always_gt,
   NEGATOR = ?<=,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %> (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1616,13 +1679,13 @@ CREATE OPERATOR %>= (
   LEFTARG = tint, RIGHTARG = integer,
   PROCEDURE = always_ge,
   NEGATOR = ?<,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %>= (
   LEFTARG = tfloat, RIGHTARG = float,
   PROCEDURE = always_ge,
   NEGATOR = ?<,
-  RESTRICT = scalarltsel, JOIN = scalarltjoinsel
+  RESTRICT = tnumber_ever_sel, JOIN = scalarltjoinsel
 );
 CREATE OPERATOR %>= (
   LEFTARG = ttext, RIGHTARG = text,
@@ -1686,6 +1749,23 @@ CREATE FUNCTION valueAtTimestamp(ttext, timestamptz)
   AS 'MODULE_PATHNAME', 'temporal_value_at_timestamp'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION valuesAtTimestamps(tbool, timestamptz[])
+  RETURNS bool[]
+  AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valuesAtTimestamps(tint, timestamptz[])
+  RETURNS integer[]
+  AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valuesAtTimestamps(tfloat, timestamptz[])
+  RETURNS float[]
+  AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION valuesAtTimestamps(ttext, timestamptz[])
+  RETURNS text[]
+  AS 'MODULE_PATHNAME', 'temporal_values_at_timestamps'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION atTimestampSet(tbool, timestampset)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'temporal_at_timestampset'
@@ -1788,6 +1868,32 @@ CREATE FUNCTION minusPeriodSet(ttext, periodset)
   AS 'MODULE_PATHNAME', 'temporal_minus_periodset'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION temporal_intersects_timestamp_support(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp_support'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION intersectsTimestamp(tbool, timestamptz)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp'
+  SUPPORT temporal_intersects_timestamp_support
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION intersectsTimestamp(tint, timestamptz)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp'
+  SUPPORT temporal_intersects_timestamp_support
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION intersectsTimestamp(tfloat, timestamptz)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp'
+  SUPPORT temporal_intersects_timestamp_support
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION intersectsTimestamp(ttext, timestamptz)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp'
+  SUPPORT temporal_intersects_timestamp_support
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
 CREATE FUNCTION intersectsTimestamp(tbool, timestamptz)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp'
@@ -1804,6 +1910,7 @@ CREATE FUNCTION intersectsTimestamp(ttext, timestamptz)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'temporal_intersects_timestamp'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
 
 CREATE FUNCTION intersectsTimestampSet(tbool, timestampset)
   RETURNS boolean
@@ -1865,14 +1972,31 @@ CREATE FUNCTION integral(tfloat)
   AS 'MODULE_PATHNAME', 'tnumber_integral'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION tnumber_twavg_support(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tnumber_twavg_support'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION twAvg(tint)
   RETURNS float
   AS 'MODULE_PATHNAME', 'tnumber_twavg'
+  SUPPORT tnumber_twavg_support
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION twAvg(tfloat)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'tnumber_twavg'
+  SUPPORT tnumber_twavg_support
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#else
+CREATE FUNCTION twAvg(tint)
   RETURNS float
   AS 'MODULE_PATHNAME', 'tnumber_twavg'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION twAvg(tfloat)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'tnumber_twavg'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
 
 /*****************************************************************************
  * Selectively functions for operators
@@ -2240,22 +2364,52 @@ CREATE FUNCTION ttext_hash(ttext)
   RETURNS integer
   AS 'MODULE_PATHNAME', 'temporal_hash'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if MOBDB_PGSQL_VERSION >= 110000
+CREATE FUNCTION tbool_hash_extended(tbool, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tint_hash_extended(tint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tfloat_hash_extended(tfloat, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ttext_hash_extended(ttext, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
 
 CREATE OPERATOR CLASS hash_tbool_ops
   DEFAULT FOR TYPE tbool USING hash AS
     OPERATOR    1   = ,
+#if MOBDB_PGSQL_VERSION >= 110000
+    FUNCTION    2   tbool_hash_extended(tbool, bigint),
+#endif
     FUNCTION    1   tbool_hash(tbool);
 CREATE OPERATOR CLASS hash_tint_ops
   DEFAULT FOR TYPE tint USING hash AS
     OPERATOR    1   = ,
+#if MOBDB_PGSQL_VERSION >= 110000
+    FUNCTION    2   tint_hash_extended(tint, bigint),
+#endif
     FUNCTION    1   tint_hash(tint);
 CREATE OPERATOR CLASS hash_tfloat_ops
   DEFAULT FOR TYPE tfloat USING hash AS
     OPERATOR    1   = ,
+#if MOBDB_PGSQL_VERSION >= 110000
+    FUNCTION    2   tfloat_hash_extended(tfloat, bigint),
+#endif
     FUNCTION    1   tfloat_hash(tfloat);
 CREATE OPERATOR CLASS hash_ttext_ops
   DEFAULT FOR TYPE ttext USING hash AS
     OPERATOR    1   = ,
+#if MOBDB_PGSQL_VERSION >= 110000
+    FUNCTION    2   ttext_hash_extended(ttext, bigint),
+#endif
     FUNCTION    1   ttext_hash(ttext);
 
 /******************************************************************************/
@@ -906,4 +906,43 @@ CREATE OPERATOR #>= (
   COMMUTATOR = #<=
 );
 
+/*****************************************************************************
+ * Fused restriction of the temporal comparisons of temporal numbers
+ *****************************************************************************/
+
+-- atValue(temp #< value, bool) and similarly for the other comparisons
+
+CREATE FUNCTION tnumber_at_tlt(tint, integer, boolean)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'tnumber_at_tlt'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_at_tlt(tfloat, float, boolean)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'tnumber_at_tlt'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_at_tle(tint, integer, boolean)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'tnumber_at_tle'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_at_tle(tfloat, float, boolean)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'tnumber_at_tle'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_at_tgt(tint, integer, boolean)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'tnumber_at_tgt'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_at_tgt(tfloat, float, boolean)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'tnumber_at_tgt'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_at_tge(tint, integer, boolean)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'tnumber_at_tge'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_at_tge(tfloat, float, boolean)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'tnumber_at_tge'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -1018,4 +1018,24 @@ CREATE OPERATOR -|- (
   RESTRICT = temporal_sel, JOIN = temporal_joinsel
 );
 
+/*****************************************************************************
+ * Planner support function
+ *****************************************************************************/
+
+#if MOBDB_PGSQL_VERSION >= 120000
+CREATE FUNCTION temporal_overlaps_support(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_overlaps_support'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+ALTER FUNCTION overlaps_bbox(period, tbool) SUPPORT temporal_overlaps_support;
+ALTER FUNCTION overlaps_bbox(tbool, period) SUPPORT temporal_overlaps_support;
+ALTER FUNCTION overlaps_bbox(tbox, tint) SUPPORT temporal_overlaps_support;
+ALTER FUNCTION overlaps_bbox(tint, tbox) SUPPORT temporal_overlaps_support;
+ALTER FUNCTION overlaps_bbox(tbox, tfloat) SUPPORT temporal_overlaps_support;
+ALTER FUNCTION overlaps_bbox(tfloat, tbox) SUPPORT temporal_overlaps_support;
+ALTER FUNCTION overlaps_bbox(period, ttext) SUPPORT temporal_overlaps_support;
+ALTER FUNCTION overlaps_bbox(ttext, period) SUPPORT temporal_overlaps_support;
+#endif
+
 /*****************************************************************************/
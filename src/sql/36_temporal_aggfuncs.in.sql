@@ -78,6 +78,10 @@ CREATE FUNCTION tcount_transfn(internal, tbool)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'temporal_tcount_transfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_invfn(internal, tbool)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_invfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
 CREATE FUNCTION tcount_combinefn(internal, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'temporal_tcount_combinefn'
@@ -106,19 +110,30 @@ CREATE FUNCTION tint_tagg_finalfn(internal)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'temporal_tagg_finalfn'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcount_mfinalfn(internal)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'temporal_tcount_mfinalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE AGGREGATE tcount(tbool) (
   SFUNC = tcount_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tcount_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
   DESERIALFUNC = tagg_deserialize,
+  MSFUNC = tcount_transfn,
+  MINVFUNC = tcount_invfn,
+  MSTYPE = internal,
+  MSSPACE = 2048,
+  MFINALFUNC = tcount_mfinalfn,
   PARALLEL = SAFE
 );
 CREATE AGGREGATE tand(tbool) (
   SFUNC = tbool_tand_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tbool_tand_combinefn,
   FINALFUNC = tbool_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -128,6 +143,7 @@ CREATE AGGREGATE tand(tbool) (
 CREATE AGGREGATE tor(tbool) (
   SFUNC = tbool_tor_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tbool_tor_combinefn,
   FINALFUNC = tbool_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -165,6 +181,10 @@ CREATE FUNCTION tcount_transfn(internal, tint)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'temporal_tcount_transfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_invfn(internal, tint)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_invfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
 CREATE FUNCTION tavg_transfn(internal, tint)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'tnumber_tavg_transfn'
@@ -177,10 +197,23 @@ CREATE FUNCTION tavg_finalfn(internal)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'tnumber_tavg_finalfn'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tavg_invfn(internal, tint)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tnumber_tavg_invfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tint_tsum_mfinalfn(internal)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'tint_tsum_mfinalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tavg_mfinalfn(internal)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'tnumber_tavg_mfinalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE AGGREGATE tmin(tint) (
   SFUNC = tint_tmin_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tint_tmin_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -190,6 +223,7 @@ CREATE AGGREGATE tmin(tint) (
 CREATE AGGREGATE tmax(tint) (
   SFUNC = tint_tmax_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tint_tmax_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -199,28 +233,46 @@ CREATE AGGREGATE tmax(tint) (
 CREATE AGGREGATE tsum(tint) (
   SFUNC = tint_tsum_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tint_tsum_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
   DESERIALFUNC = tagg_deserialize,
+  MSFUNC = tavg_transfn,
+  MINVFUNC = tavg_invfn,
+  MSTYPE = internal,
+  MSSPACE = 2048,
+  MFINALFUNC = tint_tsum_mfinalfn,
   PARALLEL = SAFE
 );
 CREATE AGGREGATE tcount(tint) (
   SFUNC = tcount_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tcount_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
   DESERIALFUNC = tagg_deserialize,
+  MSFUNC = tcount_transfn,
+  MINVFUNC = tcount_invfn,
+  MSTYPE = internal,
+  MSSPACE = 2048,
+  MFINALFUNC = tcount_mfinalfn,
   PARALLEL = SAFE
 );
 CREATE AGGREGATE tavg(tint) (
   SFUNC = tavg_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tavg_combinefn,
   FINALFUNC = tavg_finalfn,
   SERIALFUNC = tagg_serialize,
   DESERIALFUNC = tagg_deserialize,
+  MSFUNC = tavg_transfn,
+  MINVFUNC = tavg_invfn,
+  MSTYPE = internal,
+  MSSPACE = 2048,
+  MFINALFUNC = tavg_mfinalfn,
   PARALLEL = SAFE
 );
 
@@ -252,6 +304,10 @@ CREATE FUNCTION tcount_transfn(internal, tfloat)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'temporal_tcount_transfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_invfn(internal, tfloat)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_invfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
 CREATE FUNCTION tfloat_tagg_finalfn(internal)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'temporal_tagg_finalfn'
@@ -264,6 +320,7 @@ CREATE FUNCTION tavg_transfn(internal, tfloat)
 CREATE AGGREGATE tmin(tfloat) (
   SFUNC = tfloat_tmin_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tfloat_tmin_combinefn,
   FINALFUNC = tfloat_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -273,6 +330,7 @@ CREATE AGGREGATE tmin(tfloat) (
 CREATE AGGREGATE tmax(tfloat) (
   SFUNC = tfloat_tmax_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tfloat_tmax_combinefn,
   FINALFUNC = tfloat_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -282,6 +340,7 @@ CREATE AGGREGATE tmax(tfloat) (
 CREATE AGGREGATE tsum(tfloat) (
   SFUNC = tfloat_tsum_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tfloat_tsum_combinefn,
   FINALFUNC = tfloat_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -291,15 +350,22 @@ CREATE AGGREGATE tsum(tfloat) (
 CREATE AGGREGATE tcount(tfloat) (
   SFUNC = tcount_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tcount_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
   DESERIALFUNC = tagg_deserialize,
+  MSFUNC = tcount_transfn,
+  MINVFUNC = tcount_invfn,
+  MSTYPE = internal,
+  MSSPACE = 2048,
+  MFINALFUNC = tcount_mfinalfn,
   PARALLEL = SAFE
 );
 CREATE AGGREGATE tavg(tfloat) (
   SFUNC = tavg_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tavg_combinefn,
   FINALFUNC = tavg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -329,6 +395,10 @@ CREATE FUNCTION tcount_transfn(internal, ttext)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'temporal_tcount_transfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_invfn(internal, ttext)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_invfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
 CREATE FUNCTION ttext_tagg_finalfn(internal)
   RETURNS ttext
   AS 'MODULE_PATHNAME', 'temporal_tagg_finalfn'
@@ -337,6 +407,7 @@ CREATE FUNCTION ttext_tagg_finalfn(internal)
 CREATE AGGREGATE tmin(ttext) (
   SFUNC = ttext_tmin_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = ttext_tmin_combinefn,
   FINALFUNC = ttext_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -346,6 +417,7 @@ CREATE AGGREGATE tmin(ttext) (
 CREATE AGGREGATE tmax(ttext) (
   SFUNC = ttext_tmax_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = ttext_tmax_combinefn,
   FINALFUNC = ttext_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -355,11 +427,511 @@ CREATE AGGREGATE tmax(ttext) (
 CREATE AGGREGATE tcount(ttext) (
   SFUNC = tcount_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tcount_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
   DESERIALFUNC = tagg_deserialize,
+  MSFUNC = tcount_transfn,
+  MINVFUNC = tcount_invfn,
+  MSTYPE = internal,
+  MSSPACE = 2048,
+  MFINALFUNC = tcount_mfinalfn,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************/
+
+CREATE FUNCTION append_transfn(internal, tbool)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_append_tinstant_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION append_transfn(internal, tint)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_append_tinstant_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION append_transfn(internal, tfloat)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_append_tinstant_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION append_transfn(internal, ttext)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_append_tinstant_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tbool_append_finalfn(internal)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'temporal_append_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tint_append_finalfn(internal)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'temporal_append_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tfloat_append_finalfn(internal)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'temporal_append_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ttext_append_finalfn(internal)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'temporal_append_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE appendInstant(tbool) (
+  SFUNC = append_transfn,
+  STYPE = internal,
+  SSPACE = 1024,
+  FINALFUNC = tbool_append_finalfn,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE appendInstant(tint) (
+  SFUNC = append_transfn,
+  STYPE = internal,
+  SSPACE = 1024,
+  FINALFUNC = tint_append_finalfn,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE appendInstant(tfloat) (
+  SFUNC = append_transfn,
+  STYPE = internal,
+  SSPACE = 1024,
+  FINALFUNC = tfloat_append_finalfn,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE appendInstant(ttext) (
+  SFUNC = append_transfn,
+  STYPE = internal,
+  SSPACE = 1024,
+  FINALFUNC = ttext_append_finalfn,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************/
+
+CREATE FUNCTION tbucket_serialize(internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'temporal_bucket_serialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbucket_deserialize(bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_bucket_deserialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbucket_combinefn(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_bucket_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bucket_finalfn(internal)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tavg_bucket_finalfn(internal)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'tnumber_tavg_bucket_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcount_bucket_transfn(internal, tbool, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bucket_transfn(internal, tbool, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bucket_transfn(internal, tint, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bucket_transfn(internal, tint, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bucket_transfn(internal, tfloat, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bucket_transfn(internal, tfloat, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bucket_transfn(internal, ttext, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_bucket_transfn(internal, ttext, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tavg_bucket_transfn(internal, tint, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tnumber_tavg_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tavg_bucket_transfn(internal, tint, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tnumber_tavg_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tavg_bucket_transfn(internal, tfloat, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tnumber_tavg_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tavg_bucket_transfn(internal, tfloat, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tnumber_tavg_bucket_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE tcount(tbool, interval) (
+  SFUNC = tcount_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tcount_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(tbool, interval, timestamptz) (
+  SFUNC = tcount_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tcount_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(tint, interval) (
+  SFUNC = tcount_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tcount_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(tint, interval, timestamptz) (
+  SFUNC = tcount_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tcount_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(tfloat, interval) (
+  SFUNC = tcount_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tcount_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(tfloat, interval, timestamptz) (
+  SFUNC = tcount_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tcount_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(ttext, interval) (
+  SFUNC = tcount_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tcount_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(ttext, interval, timestamptz) (
+  SFUNC = tcount_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tcount_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavg(tint, interval) (
+  SFUNC = tavg_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tavg_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
   PARALLEL = SAFE
 );
+CREATE AGGREGATE tavg(tint, interval, timestamptz) (
+  SFUNC = tavg_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tavg_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavg(tfloat, interval) (
+  SFUNC = tavg_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tavg_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavg(tfloat, interval, timestamptz) (
+  SFUNC = tavg_bucket_transfn,
+  STYPE = internal,
+  SSPACE = 2560,
+  COMBINEFUNC = tbucket_combinefn,
+  FINALFUNC = tavg_bucket_finalfn,
+  SERIALFUNC = tbucket_serialize,
+  DESERIALFUNC = tbucket_deserialize,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************/
+
+/* The union of periods buffers the periods of the values, which are sorted
+ * and coalesced once */
+
+CREATE FUNCTION tunion_transfn(internal, period)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'period_union_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tunion_transfn(internal, periodset)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'periodset_union_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tunion_combinefn(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'period_union_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tunion_serialize(internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'period_union_serialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tunion_deserialize(bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'period_union_deserialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tunion_finalfn(internal)
+  RETURNS periodset
+  AS 'MODULE_PATHNAME', 'period_union_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE tunion(period) (
+  SFUNC = tunion_transfn,
+  STYPE = internal,
+  SSPACE = 1024,
+  COMBINEFUNC = tunion_combinefn,
+  FINALFUNC = tunion_finalfn,
+  SERIALFUNC = tunion_serialize,
+  DESERIALFUNC = tunion_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tunion(periodset) (
+  SFUNC = tunion_transfn,
+  STYPE = internal,
+  SSPACE = 1024,
+  COMBINEFUNC = tunion_combinefn,
+  FINALFUNC = tunion_finalfn,
+  SERIALFUNC = tunion_serialize,
+  DESERIALFUNC = tunion_deserialize,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************/
+
+/* The approximate distinct counts keep HyperLogLog sketches of the
+ * identifiers of the objects per bucket */
+
+CREATE FUNCTION tcountapprox_serialize(internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_serialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_deserialize(bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_deserialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_combinefn(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_finalfn(internal)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, tbool, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, tbool, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, tint, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, tint, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, tfloat, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, tfloat, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, ttext, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcountapprox_transfn(internal, bigint, ttext, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE tcountApprox(bigint, tbool, interval) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(bigint, tbool, interval, timestamptz) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(bigint, tint, interval) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(bigint, tint, interval, timestamptz) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(bigint, tfloat, interval) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(bigint, tfloat, interval, timestamptz) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(bigint, ttext, interval) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(bigint, ttext, interval, timestamptz) (
+  SFUNC = tcountapprox_transfn,
+  STYPE = internal,
+  SSPACE = 16384,
+  COMBINEFUNC = tcountapprox_combinefn,
+  FINALFUNC = tcountapprox_finalfn,
+  SERIALFUNC = tcountapprox_serialize,
+  DESERIALFUNC = tcountapprox_deserialize,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************/
+
+CREATE FUNCTION tsample(tbool, interval)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tbool, interval, timestamptz)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tint, interval)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tint, interval, timestamptz)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tfloat, interval)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tfloat, interval, timestamptz)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(ttext, interval)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(ttext, interval, timestamptz)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'temporal_tsample'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION tprecision(tint, interval)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'tnumber_tprecision'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tprecision(tint, interval, timestamptz)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'tnumber_tprecision'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tprecision(tfloat, interval)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'tnumber_tprecision'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tprecision(tfloat, interval, timestamptz)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'tnumber_tprecision'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /*****************************************************************************/
@@ -34,6 +34,7 @@ CREATE FUNCTION wavg_transfn(internal, tint, interval)
 CREATE AGGREGATE wmin(tint, interval) (
   SFUNC = tint_wmin_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tint_tmin_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -43,6 +44,7 @@ CREATE AGGREGATE wmin(tint, interval) (
 CREATE AGGREGATE wmax(tint, interval) (
   SFUNC = tint_wmax_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tint_tmax_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -52,6 +54,7 @@ CREATE AGGREGATE wmax(tint, interval) (
 CREATE AGGREGATE wsum(tint, interval) (
   SFUNC = tint_wsum_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tint_tsum_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -61,6 +64,7 @@ CREATE AGGREGATE wsum(tint, interval) (
 CREATE AGGREGATE wcount(tint, interval) (
   SFUNC = wcount_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tint_tsum_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -70,6 +74,7 @@ CREATE AGGREGATE wcount(tint, interval) (
 CREATE AGGREGATE wavg(tint, interval) (
   SFUNC = wavg_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tavg_combinefn,
   FINALFUNC = tavg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -103,6 +108,7 @@ CREATE FUNCTION wavg_transfn(internal, tfloat, interval)
 CREATE AGGREGATE wmin(tfloat, interval) (
   SFUNC = tfloat_wmin_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tfloat_tmin_combinefn,
   FINALFUNC = tfloat_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -112,6 +118,7 @@ CREATE AGGREGATE wmin(tfloat, interval) (
 CREATE AGGREGATE wmax(tfloat, interval) (
   SFUNC = tfloat_wmax_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tfloat_tmax_combinefn,
   FINALFUNC = tfloat_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -121,6 +128,7 @@ CREATE AGGREGATE wmax(tfloat, interval) (
 CREATE AGGREGATE wsum(tfloat, interval) (
   SFUNC = tfloat_wsum_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tfloat_tsum_combinefn,
   FINALFUNC = tfloat_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -130,6 +138,7 @@ CREATE AGGREGATE wsum(tfloat, interval) (
 CREATE AGGREGATE wcount(tfloat, interval) (
   SFUNC = wcount_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tint_tsum_combinefn,
   FINALFUNC = tint_tagg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -139,6 +148,7 @@ CREATE AGGREGATE wcount(tfloat, interval) (
 CREATE AGGREGATE wavg(tfloat, interval) (
   SFUNC = wavg_transfn,
   STYPE = internal,
+  SSPACE = 2048,
   COMBINEFUNC = tavg_combinefn,
   FINALFUNC = tavg_finalfn,
   SERIALFUNC = tagg_serialize,
@@ -26,6 +26,18 @@ CREATE FUNCTION tbox_gist_penalty(internal, internal, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; 
+#if MOBDB_PGSQL_VERSION >= 130000
+CREATE FUNCTION box_gist_options(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'box_gist_options'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+CREATE FUNCTION tbox_gist_sortsupport(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'tbox_gist_sortsupport'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif
 CREATE FUNCTION tbox_gist_picksplit(internal, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME'
@@ -34,6 +46,10 @@ CREATE FUNCTION tbox_gist_same(tbox, tbox, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; 
+CREATE FUNCTION tbox_gist_fetch(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 
 CREATE OPERATOR CLASS gist_tbool_ops
@@ -72,6 +88,9 @@ CREATE OPERATOR CLASS gist_tbool_ops
   FUNCTION  3  gist_tbool_compress(internal),
 #if MOBDB_PGSQL_VERSION < 110000
   FUNCTION  4  period_gist_decompress(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  period_gist_sortsupport(internal),
 #endif
   FUNCTION  5  period_gist_penalty(internal, internal, internal),
   FUNCTION  6  period_gist_picksplit(internal, internal),
@@ -142,9 +161,16 @@ CREATE OPERATOR CLASS tbox_gist_ops
   -- functions
   FUNCTION  1  tbox_gist_consistent(internal, tbox, smallint, oid, internal),
   FUNCTION  2  tbox_gist_union(internal, internal),
+#if MOBDB_PGSQL_VERSION >= 130000
+  FUNCTION  10  box_gist_options(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  tbox_gist_sortsupport(internal),
+#endif
   FUNCTION  5  tbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  tbox_gist_picksplit(internal, internal),
-  FUNCTION  7  tbox_gist_same(tbox, tbox, internal);
+  FUNCTION  7  tbox_gist_same(tbox, tbox, internal),
+  FUNCTION  9  tbox_gist_fetch(internal);
 
 /******************************************************************************/
 
@@ -233,6 +259,12 @@ CREATE OPERATOR CLASS gist_tint_ops
   FUNCTION  3  gist_tint_compress(internal),
 #if MOBDB_PGSQL_VERSION < 110000
   FUNCTION  4  tnumber_gist_decompress(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 130000
+  FUNCTION  10  box_gist_options(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  tbox_gist_sortsupport(internal),
 #endif
   FUNCTION  5  tbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  tbox_gist_picksplit(internal, internal),
@@ -319,6 +351,12 @@ CREATE OPERATOR CLASS gist_tfloat_ops
   FUNCTION  3  gist_tfloat_compress(internal),
 #if MOBDB_PGSQL_VERSION < 110000
   FUNCTION  4  tnumber_gist_decompress(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 130000
+  FUNCTION  10  box_gist_options(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  tbox_gist_sortsupport(internal),
 #endif
   FUNCTION  5  tbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  tbox_gist_picksplit(internal, internal),
@@ -371,9 +409,231 @@ CREATE OPERATOR CLASS gist_ttext_ops
   FUNCTION  3  gist_ttext_compress(internal),
 #if MOBDB_PGSQL_VERSION < 110000
   FUNCTION  4  period_gist_decompress(internal),
+#endif
+#if MOBDB_PGSQL_VERSION >= 140000
+  FUNCTION  11  period_gist_sortsupport(internal),
 #endif
   FUNCTION  5  period_gist_penalty(internal, internal, internal),
   FUNCTION  6  period_gist_picksplit(internal, internal),
   FUNCTION  7  period_gist_same(period, period, internal);
 
+/******************************************************************************
+ * BRIN index for temporal numbers and temporal boxes
+ ******************************************************************************/
+
+CREATE FUNCTION tbox_brin_opcinfo(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'tbox_brin_opcinfo'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbox_brin_add_value(internal, internal, internal, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'tbox_brin_add_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbox_brin_consistent(internal, internal, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'tbox_brin_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbox_brin_union(internal, internal, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'tbox_brin_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS tbox_brin_ops
+  DEFAULT FOR TYPE tbox USING brin AS
+  -- strictly left
+  OPERATOR  1    << (tbox, tbox),
+  OPERATOR  1    << (tbox, tint),
+  OPERATOR  1    << (tbox, tfloat),
+   -- overlaps or left
+  OPERATOR  2    &< (tbox, tbox),
+  OPERATOR  2    &< (tbox, tint),
+  OPERATOR  2    &< (tbox, tfloat),
+  -- overlaps
+  OPERATOR  3    && (tbox, tbox),
+  OPERATOR  3    && (tbox, tint),
+  OPERATOR  3    && (tbox, tfloat),
+  -- overlaps or right
+  OPERATOR  4    &> (tbox, tbox),
+  OPERATOR  4    &> (tbox, tint),
+  OPERATOR  4    &> (tbox, tfloat),
+  -- strictly right
+  OPERATOR  5    >> (tbox, tbox),
+  OPERATOR  5    >> (tbox, tint),
+  OPERATOR  5    >> (tbox, tfloat),
+    -- same
+  OPERATOR  6    ~= (tbox, tbox),
+  OPERATOR  6    ~= (tbox, tint),
+  OPERATOR  6    ~= (tbox, tfloat),
+  -- contains
+  OPERATOR  7    @> (tbox, tbox),
+  OPERATOR  7    @> (tbox, tint),
+  OPERATOR  7    @> (tbox, tfloat),
+  -- contained by
+  OPERATOR  8    <@ (tbox, tbox),
+  OPERATOR  8    <@ (tbox, tint),
+  OPERATOR  8    <@ (tbox, tfloat),
+  -- adjacent
+  OPERATOR  17    -|- (tbox, tbox),
+  OPERATOR  17    -|- (tbox, tint),
+  OPERATOR  17    -|- (tbox, tfloat),
+  -- overlaps or before
+  OPERATOR  28    &<# (tbox, tbox),
+  OPERATOR  28    &<# (tbox, tint),
+  OPERATOR  28    &<# (tbox, tfloat),
+  -- strictly before
+  OPERATOR  29    <<# (tbox, tbox),
+  OPERATOR  29    <<# (tbox, tint),
+  OPERATOR  29    <<# (tbox, tfloat),
+  -- strictly after
+  OPERATOR  30    #>> (tbox, tbox),
+  OPERATOR  30    #>> (tbox, tint),
+  OPERATOR  30    #>> (tbox, tfloat),
+  -- overlaps or after
+  OPERATOR  31    #&> (tbox, tbox),
+  OPERATOR  31    #&> (tbox, tint),
+  OPERATOR  31    #&> (tbox, tfloat),
+  -- functions
+  FUNCTION  1  tbox_brin_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS brin_tint_ops
+  DEFAULT FOR TYPE tint USING brin AS
+  -- strictly left
+  OPERATOR  1    << (tint, intrange),
+  OPERATOR  1    << (tint, tbox),
+  OPERATOR  1    << (tint, tint),
+  OPERATOR  1    << (tint, tfloat),
+   -- overlaps or left
+  OPERATOR  2    &< (tint, intrange),
+  OPERATOR  2    &< (tint, tbox),
+  OPERATOR  2    &< (tint, tint),
+  OPERATOR  2    &< (tint, tfloat),
+  -- overlaps
+  OPERATOR  3    && (tint, intrange),
+  OPERATOR  3    && (tint, tbox),
+  OPERATOR  3    && (tint, tint),
+  OPERATOR  3    && (tint, tfloat),
+  -- overlaps or right
+  OPERATOR  4    &> (tint, intrange),
+  OPERATOR  4    &> (tint, tbox),
+  OPERATOR  4    &> (tint, tint),
+  OPERATOR  4    &> (tint, tfloat),
+  -- strictly right
+  OPERATOR  5    >> (tint, intrange),
+  OPERATOR  5    >> (tint, tbox),
+  OPERATOR  5    >> (tint, tint),
+  OPERATOR  5    >> (tint, tfloat),
+    -- same
+  OPERATOR  6    ~= (tint, intrange),
+  OPERATOR  6    ~= (tint, tbox),
+  OPERATOR  6    ~= (tint, tint),
+  OPERATOR  6    ~= (tint, tfloat),
+  -- contains
+  OPERATOR  7    @> (tint, intrange),
+  OPERATOR  7    @> (tint, tbox),
+  OPERATOR  7    @> (tint, tint),
+  OPERATOR  7    @> (tint, tfloat),
+  -- contained by
+  OPERATOR  8    <@ (tint, intrange),
+  OPERATOR  8    <@ (tint, tbox),
+  OPERATOR  8    <@ (tint, tint),
+  OPERATOR  8    <@ (tint, tfloat),
+  -- adjacent
+  OPERATOR  17    -|- (tint, intrange),
+  OPERATOR  17    -|- (tint, tbox),
+  OPERATOR  17    -|- (tint, tint),
+  OPERATOR  17    -|- (tint, tfloat),
+  -- overlaps or before
+  OPERATOR  28    &<# (tint, tbox),
+  OPERATOR  28    &<# (tint, tint),
+  OPERATOR  28    &<# (tint, tfloat),
+  -- strictly before
+  OPERATOR  29    <<# (tint, tbox),
+  OPERATOR  29    <<# (tint, tint),
+  OPERATOR  29    <<# (tint, tfloat),
+  -- strictly after
+  OPERATOR  30    #>> (tint, tbox),
+  OPERATOR  30    #>> (tint, tint),
+  OPERATOR  30    #>> (tint, tfloat),
+  -- overlaps or after
+  OPERATOR  31    #&> (tint, tbox),
+  OPERATOR  31    #&> (tint, tint),
+  OPERATOR  31    #&> (tint, tfloat),
+  -- functions
+  FUNCTION  1  tbox_brin_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS brin_tfloat_ops
+  DEFAULT FOR TYPE tfloat USING brin AS
+  -- strictly left
+  OPERATOR  1    << (tfloat, floatrange),
+  OPERATOR  1    << (tfloat, tbox),
+  OPERATOR  1    << (tfloat, tint),
+  OPERATOR  1    << (tfloat, tfloat),
+   -- overlaps or left
+  OPERATOR  2    &< (tfloat, floatrange),
+  OPERATOR  2    &< (tfloat, tbox),
+  OPERATOR  2    &< (tfloat, tint),
+  OPERATOR  2    &< (tfloat, tfloat),
+  -- overlaps
+  OPERATOR  3    && (tfloat, floatrange),
+  OPERATOR  3    && (tfloat, tbox),
+  OPERATOR  3    && (tfloat, tint),
+  OPERATOR  3    && (tfloat, tfloat),
+  -- overlaps or right
+  OPERATOR  4    &> (tfloat, floatrange),
+  OPERATOR  4    &> (tfloat, tbox),
+  OPERATOR  4    &> (tfloat, tint),
+  OPERATOR  4    &> (tfloat, tfloat),
+  -- strictly right
+  OPERATOR  5    >> (tfloat, floatrange),
+  OPERATOR  5    >> (tfloat, tbox),
+  OPERATOR  5    >> (tfloat, tint),
+  OPERATOR  5    >> (tfloat, tfloat),
+    -- same
+  OPERATOR  6    ~= (tfloat, floatrange),
+  OPERATOR  6    ~= (tfloat, tbox),
+  OPERATOR  6    ~= (tfloat, tint),
+  OPERATOR  6    ~= (tfloat, tfloat),
+  -- contains
+  OPERATOR  7    @> (tfloat, floatrange),
+  OPERATOR  7    @> (tfloat, tbox),
+  OPERATOR  7    @> (tfloat, tint),
+  OPERATOR  7    @> (tfloat, tfloat),
+  -- contained by
+  OPERATOR  8    <@ (tfloat, floatrange),
+  OPERATOR  8    <@ (tfloat, tbox),
+  OPERATOR  8    <@ (tfloat, tint),
+  OPERATOR  8    <@ (tfloat, tfloat),
+  -- adjacent
+  OPERATOR  17    -|- (tfloat, floatrange),
+  OPERATOR  17    -|- (tfloat, tbox),
+  OPERATOR  17    -|- (tfloat, tint),
+  OPERATOR  17    -|- (tfloat, tfloat),
+  -- overlaps or before
+  OPERATOR  28    &<# (tfloat, tbox),
+  OPERATOR  28    &<# (tfloat, tint),
+  OPERATOR  28    &<# (tfloat, tfloat),
+  -- strictly before
+  OPERATOR  29    <<# (tfloat, tbox),
+  OPERATOR  29    <<# (tfloat, tint),
+  OPERATOR  29    <<# (tfloat, tfloat),
+  -- strictly after
+  OPERATOR  30    #>> (tfloat, tbox),
+  OPERATOR  30    #>> (tfloat, tint),
+  OPERATOR  30    #>> (tfloat, tfloat),
+  -- overlaps or after
+  OPERATOR  31    #&> (tfloat, tbox),
+  OPERATOR  31    #&> (tfloat, tint),
+  OPERATOR  31    #&> (tfloat, tfloat),
+  -- functions
+  FUNCTION  1  tbox_brin_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal);
+
 /******************************************************************************/
@@ -0,0 +1,52 @@
+/*****************************************************************************
+ *
+ * indexesstat.sql
+ *    Statistics about the GiST and SP-GiST indexes of temporal types
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+CREATE FUNCTION spgiststat(text)
+  RETURNS text
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C VOLATILE STRICT;
+CREATE FUNCTION giststat(text)
+  RETURNS text
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C VOLATILE STRICT;
+
+/******************************************************************************/
+
+CREATE FUNCTION gist_consistent_counters(OUT keytype text,
+    OUT inner_calls bigint, OUT inner_true bigint, OUT leaf_calls bigint,
+    OUT leaf_true bigint, OUT leaf_recheck bigint)
+  RETURNS SETOF record
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+CREATE FUNCTION gist_consistent_reset()
+  RETURNS void
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+/*
+ * The counters are local to the backend. The leaf entries for which the
+ * consistent method returned true and that require a recheck are those on
+ * which the executor evaluates the exact operator; comparing leaf_recheck
+ * with the rows removed by the recheck in EXPLAIN ANALYZE gives the rate of
+ * false positives of the index.
+ */
+CREATE VIEW gist_consistent_stats AS
+  SELECT keytype, inner_calls, inner_true,
+    CASE WHEN inner_calls = 0 THEN NULL
+      ELSE inner_true::float / inner_calls END AS inner_true_ratio,
+    leaf_calls, leaf_true,
+    CASE WHEN leaf_calls = 0 THEN NULL
+      ELSE leaf_true::float / leaf_calls END AS leaf_true_ratio,
+    leaf_recheck
+  FROM gist_consistent_counters();
+
+/******************************************************************************/
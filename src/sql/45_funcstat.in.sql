@@ -0,0 +1,36 @@
+/*****************************************************************************
+ *
+ * funcstat.sql
+ *    Counters of the work done by the functions of temporal types
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+CREATE FUNCTION mobilitydb_stat_counters(OUT counter text, OUT value bigint)
+  RETURNS SETOF record
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+CREATE FUNCTION mobilitydb_stat_reset()
+  RETURNS void
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+CREATE FUNCTION mobilitydb_shared_cache_reset()
+  RETURNS void
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+/*
+ * The counters are local to the backend and are only updated when the
+ * parameter mobilitydb.function_stats is on. Calling mobilitydb_stat_reset
+ * before a query gives the work done by the query.
+ */
+CREATE VIEW mobilitydb_stat_functions AS
+  SELECT counter, value
+  FROM mobilitydb_stat_counters();
+
+/******************************************************************************/
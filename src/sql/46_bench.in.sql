@@ -0,0 +1,26 @@
+/*****************************************************************************
+ *
+ * bench.sql
+ *    Microbenchmarks of the kernels of temporal types
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+/*
+ * The kernel is one of tsequence_make, tsequence_at_period, sync_tfunc,
+ * distance_tpoint_geo, tpointseq_at_geometry, tsequence_tagg, temporal_out,
+ * and temporal_in. The inputs are generated with a fixed seed and thus the
+ * measures of different builds are comparable.
+ */
+CREATE FUNCTION mobdb_bench(text, integer, integer DEFAULT 100,
+    OUT kernel text, OUT instants integer, OUT iterations integer,
+    OUT ns_per_instant float, OUT bytes_per_call bigint)
+  RETURNS record
+  AS 'MODULE_PATHNAME'
+  LANGUAGE C VOLATILE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
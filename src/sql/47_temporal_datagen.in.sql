@@ -0,0 +1,49 @@
+/*****************************************************************************
+ *
+ * temporal_datagen.sql
+ *    Generators of random temporal values for load and index testing
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+/*
+ * The values are temporal instants when the length is 1 and temporal
+ * sequences otherwise. They are contained in the period and are the same
+ * for the same arguments.
+ */
+CREATE FUNCTION generate_tints(count integer, length integer,
+    lowvalue integer, highvalue integer, p period,
+    step interval DEFAULT '1 minute', seed integer DEFAULT 1)
+  RETURNS SETOF tint
+  AS 'MODULE_PATHNAME', 'generate_tints'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION generate_tfloats(count integer, length integer,
+    lowvalue float, highvalue float, p period,
+    step interval DEFAULT '1 minute', linear boolean DEFAULT true,
+    seed integer DEFAULT 1)
+  RETURNS SETOF tfloat
+  AS 'MODULE_PATHNAME', 'generate_tfloats'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION generate_ttexts(count integer, length integer,
+    maxlength integer, p period, step interval DEFAULT '1 minute',
+    seed integer DEFAULT 1)
+  RETURNS SETOF ttext
+  AS 'MODULE_PATHNAME', 'generate_ttexts'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*
+ * Value of the type of the second argument whose stored bytes, without the
+ * varlena header, are given, which is used to test the storage formats of
+ * previous versions.
+ */
+CREATE FUNCTION from_storage(bytes bytea, sample anyelement)
+  RETURNS anyelement
+  AS 'MODULE_PATHNAME', 'datagen_from_storage'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+REVOKE ALL ON FUNCTION from_storage(bytea, anyelement) FROM PUBLIC;
+
+/******************************************************************************/
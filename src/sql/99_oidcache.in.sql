@@ -18,6 +18,11 @@ CREATE TABLE pg_temporal_opcache (
   opid Oid
 );
 
+/* Compact representation of the cache read with a single tuple fetch */
+CREATE TABLE pg_temporal_oidcache (
+  oids bytea
+);
+
 CREATE FUNCTION fill_opcache()
   RETURNS VOID
   AS 'MODULE_PATHNAME', 'fill_opcache'
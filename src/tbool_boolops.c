@@ -12,6 +12,9 @@
 
 #include "tbool_boolops.h"
 
+#include <utils/timestamp.h>
+
+#include "timeops.h"
 #include "temporaltypes.h"
 #include "lifting.h"
 
@@ -46,6 +49,10 @@ Temporal *
 boolop_tbool_bool(Temporal *temp, Datum b, Datum (*func)(Datum, Datum),
   bool invert)
 {
+  /* The and and or operators are commutative */
+  if (func == &datum_and || func == &datum_or)
+    return tfunc_tbool_boolop_base(temp, DatumGetBool(b), func == &datum_and);
+
   LiftedFunctionInfo lfinfo;
   lfinfo.func = (varfunc) func;
   lfinfo.numparam = 2;
@@ -56,10 +63,159 @@ boolop_tbool_bool(Temporal *temp, Datum b, Datum (*func)(Datum, Datum),
   return tfunc_temporal_base(temp, b, BOOLOID, (Datum) NULL, lfinfo);
 }
 
+/**
+ * Returns the Boolean and or or of the two temporal sequences.
+ *
+ * Since temporal Booleans have step interpolation, the value of a sequence
+ * between two consecutive instants is the value of the first one. The result
+ * is then obtained by a linear merge of the timestamps of both sequences
+ * without constructing the instants restricted to the synchronization points.
+ *
+ * @param[in] seq1,seq2 Temporal values
+ * @param[in] and True when computing the and, false when computing the or
+ */
+static TSequence *
+boolop_tboolseq_tboolseq(const TSequence *seq1, const TSequence *seq2,
+  bool and)
+{
+  Period *inter = intersection_period_period_internal(&seq1->period,
+    &seq2->period);
+  if (inter == NULL)
+    return NULL;
+
+  /* Position on the last instant of each sequence starting the intersection */
+  int i = 0, j = 0;
+  while (i < seq1->count - 1 &&
+    tsequence_inst_n(seq1, i + 1)->t <= inter->lower)
+    i++;
+  while (j < seq2->count - 1 &&
+    tsequence_inst_n(seq2, j + 1)->t <= inter->lower)
+    j++;
+
+  TSequenceBuilder builder;
+  tsequence_builder_init(&builder, BOOLOID, seq1->count - i + seq2->count - j,
+    STEP, NORMALIZE);
+  TimestampTz t = inter->lower;
+  while (true)
+  {
+    bool b1 = DatumGetBool(tinstant_value(tsequence_inst_n(seq1, i)));
+    bool b2 = DatumGetBool(tinstant_value(tsequence_inst_n(seq2, j)));
+    tsequence_builder_append(&builder, BoolGetDatum(and ? b1 && b2 : b1 || b2),
+      t);
+    if (t == inter->upper)
+      break;
+    TimestampTz t1 = (i < seq1->count - 1) ?
+      tsequence_inst_n(seq1, i + 1)->t : DT_NOEND;
+    TimestampTz t2 = (j < seq2->count - 1) ?
+      tsequence_inst_n(seq2, j + 1)->t : DT_NOEND;
+    t = Min(Min(t1, t2), inter->upper);
+    if (i < seq1->count - 1 && t1 == t)
+      i++;
+    if (j < seq2->count - 1 && t2 == t)
+      j++;
+  }
+  /* The builder makes equal the last two values of sequences with an
+   * exclusive upper bound */
+  TSequence *result = tsequence_builder_finish(&builder, inter->lower_inc,
+    inter->upper_inc);
+  pfree(inter);
+  return result;
+}
+
+/**
+ * Returns the Boolean and or or of the two arrays of temporal sequences.
+ * The arrays are scanned in parallel advancing on the sequence that ends
+ * first, as in the synchronization of two temporal sequence sets.
+ *
+ * @param[in] seqs1,seqs2 Arrays of temporal sequences
+ * @param[in] count1,count2 Number of elements in the arrays
+ * @param[in] and True when computing the and, false when computing the or
+ */
+static TSequenceSet *
+boolop_tboolseqarr_tboolseqarr(TSequence **seqs1, int count1,
+  TSequence **seqs2, int count2, bool and)
+{
+  TSequence **sequences = palloc(sizeof(TSequence *) * (count1 + count2));
+  int i = 0, j = 0, k = 0;
+  while (i < count1 && j < count2)
+  {
+    TSequence *seq1 = seqs1[i];
+    TSequence *seq2 = seqs2[j];
+    TSequence *seq = boolop_tboolseq_tboolseq(seq1, seq2, and);
+    if (seq != NULL)
+      sequences[k++] = seq;
+    int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+    if (cmp == 0)
+    {
+      if (!seq1->period.upper_inc && seq2->period.upper_inc)
+        cmp = -1;
+      else if (seq1->period.upper_inc && !seq2->period.upper_inc)
+        cmp = 1;
+    }
+    if (cmp == 0)
+    {
+      i++; j++;
+    }
+    else if (cmp < 0)
+      i++;
+    else
+      j++;
+  }
+  if (k == 0)
+  {
+    pfree(sequences);
+    return NULL;
+  }
+  return tsequenceset_make_free(sequences, k, NORMALIZE);
+}
+
+/**
+ * Returns the sequences composing a temporal sequence or a temporal sequence
+ * set. The result is an array of pointers into the temporal value.
+ */
+static TSequence **
+tbool_sequences_internal(const Temporal *temp, int *count)
+{
+  TSequence **result;
+  if (temp->duration == SEQUENCE)
+  {
+    result = palloc(sizeof(TSequence *));
+    result[0] = (TSequence *) temp;
+    *count = 1;
+  }
+  else
+  {
+    const TSequenceSet *ts = (const TSequenceSet *) temp;
+    result = palloc(sizeof(TSequence *) * ts->count);
+    for (int i = 0; i < ts->count; i++)
+      result[i] = tsequenceset_seq_n(ts, i);
+    *count = ts->count;
+  }
+  return result;
+}
+
 Temporal *
 boolop_tbool_tbool(Temporal *temp1, Temporal *temp2,
   Datum (*func)(Datum, Datum))
 {
+  /* Merge the instants directly when both values are continuous in time */
+  if ((func == &datum_and || func == &datum_or) &&
+    (temp1->duration == SEQUENCE || temp1->duration == SEQUENCESET) &&
+    (temp2->duration == SEQUENCE || temp2->duration == SEQUENCESET))
+  {
+    bool and = (func == &datum_and);
+    if (temp1->duration == SEQUENCE && temp2->duration == SEQUENCE)
+      return (Temporal *) boolop_tboolseq_tboolseq((TSequence *) temp1,
+        (TSequence *) temp2, and);
+    int count1, count2;
+    TSequence **seqs1 = tbool_sequences_internal(temp1, &count1);
+    TSequence **seqs2 = tbool_sequences_internal(temp2, &count2);
+    TSequenceSet *result = boolop_tboolseqarr_tboolseqarr(seqs1, count1,
+      seqs2, count2, and);
+    pfree(seqs1); pfree(seqs2);
+    return (Temporal *) result;
+  }
+
   LiftedFunctionInfo lfinfo;
   lfinfo.func = (varfunc) func;
   lfinfo.numparam = 2;
@@ -85,7 +241,7 @@ tand_bool_tbool(PG_FUNCTION_ARGS)
   Datum b = PG_GETARG_DATUM(0);
   Temporal *temp = PG_GETARG_TEMPORAL(1);
   Temporal *result = boolop_tbool_bool(temp, b, &datum_and, INVERT);
-  PG_FREE_IF_COPY(temp, 1);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 1);
   PG_RETURN_POINTER(result);
 }
 
@@ -99,7 +255,7 @@ tand_tbool_bool(PG_FUNCTION_ARGS)
   Temporal *temp = PG_GETARG_TEMPORAL(0);
   Datum b = PG_GETARG_DATUM(1);
   Temporal *result = boolop_tbool_bool(temp, b, &datum_and, INVERT_NO);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_RETURN_POINTER(result);
 }
 
@@ -134,7 +290,7 @@ tor_bool_tbool(PG_FUNCTION_ARGS)
   Datum b = PG_GETARG_DATUM(0);
   Temporal *temp = PG_GETARG_TEMPORAL(1);
   Temporal *result = boolop_tbool_bool(temp, b, &datum_or, INVERT);
-  PG_FREE_IF_COPY(temp, 1);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 1);
   PG_RETURN_POINTER(result);
 }
 
@@ -148,7 +304,7 @@ tor_tbool_bool(PG_FUNCTION_ARGS)
   Temporal *temp = PG_GETARG_TEMPORAL(0);
   Datum b = PG_GETARG_DATUM(1);
   Temporal *result = boolop_tbool_bool(temp, b, &datum_or, INVERT_NO);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_RETURN_POINTER(result);
 }
 
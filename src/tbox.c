@@ -22,6 +22,7 @@
 #include "periodset.h"
 #include "rangetypes_ext.h"
 #include "temporal.h"
+#include "temporal_boxops.h"
 #include "temporal_parser.h"
 #include "temporal_util.h"
 #include "tnumber_mathfuncs.h"
@@ -887,13 +888,7 @@ contained_tbox_tbox(PG_FUNCTION_ARGS)
 bool
 overlaps_tbox_tbox_internal(const TBOX *box1, const TBOX *box2)
 {
-  bool hasx, hast;
-  topo_tbox_tbox_init(box1, box2, &hasx, &hast);
-  if (hasx && (box1->xmax < box2->xmin || box1->xmin > box2->xmax))
-    return false;
-  if (hast && (box1->tmax < box2->tmin || box1->tmin > box2->tmax))
-    return false;
-  return true;
+  return overlaps_tbox_tbox_inline(box1, box2);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_tbox_tbox);
@@ -26,6 +26,7 @@
 #include <access/detoast.h>
 #endif
 #include <catalog/namespace.h>
+#include <funcapi.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
 #include <utils/fmgroids.h>
@@ -40,7 +41,11 @@
 #include "temporal_util.h"
 #include "temporal_boxops.h"
 #include "temporal_parser.h"
+#include "temporal_packed.h"
+#include "temporal_expanded.h"
+#include "temporal_argcache.h"
 #include "rangetypes_ext.h"
+#include "mobdb_probes.h"
 #include "temporal.h"
 #include "tpoint_spatialfuncs.h"
 
@@ -444,6 +449,14 @@ base_oid_from_temporal(Oid temptypid)
  * Trajectory functions
  *****************************************************************************/
 
+/**
+ * Global variable that states whether the trajectory of the temporal point
+ * sequences is precomputed and stored in the values. It is set by the
+ * configuration parameter mobilitydb.precompute_trajectory. When it is off,
+ * the trajectory is computed on demand.
+ */
+bool precompute_trajectory = true;
+
 /**
  * Returns true if the temporal type corresponding to the Oid of the
  * base type has its trajectory precomputed
@@ -899,11 +912,14 @@ temporal_in(PG_FUNCTION_ARGS)
   Oid temptypid = PG_GETARG_OID(1);
   int32 temp_typmod = -1;
   Oid valuetypid = temporal_valuetypid(temptypid);
+  TRACE_MOBILITYDB_IN_START(strlen(input));
   Temporal *result = temporal_parse(&input, valuetypid);
   if (PG_NARGS() > 2 && !PG_ARGISNULL(2))
     temp_typmod = PG_GETARG_INT32(2);
   if (temp_typmod >= 0)
     result = temporal_valid_typmod(result, temp_typmod);
+  TRACE_MOBILITYDB_IN_DONE(temporal_probe_count(result),
+    temporal_probe_size(result));
   PG_RETURN_POINTER(result);
 }
 
@@ -939,7 +955,10 @@ PGDLLEXPORT Datum
 temporal_out(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
+  TRACE_MOBILITYDB_OUT_START(temporal_probe_count(temp),
+    temporal_probe_size(temp));
   char *result = temporal_to_string(temp, &call_output);
+  TRACE_MOBILITYDB_OUT_DONE(strlen(result));
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_CSTRING(result);
 }
@@ -975,9 +994,15 @@ PGDLLEXPORT Datum
 temporal_send(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
+  TRACE_MOBILITYDB_SEND_START(temporal_probe_count(temp),
+    temporal_probe_size(temp));
   StringInfoData buf;
   pq_begintypsend(&buf);
-  temporal_write(temp, &buf) ;
+  if (binary_format == BINARY_COMPACT)
+    temporal_write_compact(temp, &buf);
+  else
+    temporal_write(temp, &buf) ;
+  TRACE_MOBILITYDB_SEND_DONE(buf.len);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
 }
@@ -994,6 +1019,13 @@ temporal_read(StringInfo buf, Oid valuetypid)
 {
   int16 type = (int16) pq_getmsgbyte(buf);
   Temporal *result;
+  /* Values in the compact binary format are recognized by their first byte */
+  if (type & COMPACT_BINARY_FLAG)
+  {
+    type &= ~COMPACT_BINARY_FLAG;
+    ensure_valid_duration(type);
+    return temporal_read_compact(buf, type, valuetypid);
+  }
   ensure_valid_duration(type);
   if (type == INSTANT)
     result = (Temporal *) tinstant_read(buf, valuetypid);
@@ -1016,7 +1048,10 @@ temporal_recv(PG_FUNCTION_ARGS)
   StringInfo buf = (StringInfo)PG_GETARG_POINTER(0);
   Oid temptypid = PG_GETARG_OID(1);
   Oid valuetypid = temporal_valuetypid(temptypid);
+  TRACE_MOBILITYDB_RECV_START(buf->len - buf->cursor);
   Temporal *result = temporal_read(buf, valuetypid) ;
+  TRACE_MOBILITYDB_RECV_DONE(temporal_probe_count(result),
+    temporal_probe_size(result));
   PG_RETURN_POINTER(result);
 }
 
@@ -1091,6 +1126,385 @@ PGDLLEXPORT Datum temporal_enforce_typmod(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(temp);
 }
 
+/*****************************************************************************
+ * Compact binary format
+ *
+ * In the compact binary format the header of the temporal value is written
+ * once and is followed by the array of timestamps and then by the array of
+ * values, instead of calling the send and receive functions of the
+ * timestamps and of the base type for each instant. The values of the
+ * temporal points are written as their coordinates. The first byte is the
+ * duration with the bit COMPACT_BINARY_FLAG set, so that the receive
+ * function accepts both formats, and it is followed by a version number.
+ *
+ *   uint8 duration | COMPACT_BINARY_FLAG, uint8 version, uint8 flags,
+ *   [int32 srid,] [int32 number of sequences,]
+ *   [int32 number of instants, [uint8 bounds,]] for each sequence,
+ *   int64 timestamps[], values[]
+ *
+ * The SRID is only written for temporal points and the number of sequences
+ * only for sequence sets. The number of instants is not written for
+ * instants and the bounds only for sequences and sequence sets.
+ *****************************************************************************/
+
+/**
+ * Global variable that states the binary format written by the send
+ * function. It is set by the configuration parameter
+ * mobilitydb.binary_format.
+ */
+int binary_format = BINARY_STANDARD;
+
+/**
+ * Write the 32-bit integer into the buffer
+ */
+static void
+compact_sendint32(StringInfo buf, int32 value)
+{
+#if MOBDB_PGSQL_VERSION < 110000
+  pq_sendint(buf, (uint32) value, 4);
+#else
+  pq_sendint32(buf, value);
+#endif
+  return;
+}
+
+/**
+ * Returns true if the base type is written as coordinates
+ */
+static bool
+compact_point_type(Oid valuetypid)
+{
+  return (valuetypid == type_oid(T_GEOMETRY) ||
+    valuetypid == type_oid(T_GEOGRAPHY));
+}
+
+/**
+ * Write the sequence header in the compact binary format
+ */
+static void
+tsequence_write_compact_header(const TSequence *seq, StringInfo buf)
+{
+  compact_sendint32(buf, seq->count);
+  pq_sendbyte(buf, (uint8) ((seq->period.lower_inc ? COMPACT_LOWER_INC : 0) |
+    (seq->period.upper_inc ? COMPACT_UPPER_INC : 0)));
+  return;
+}
+
+/**
+ * Write the value of the instant in the compact binary format
+ */
+static void
+tinstant_write_compact_value(const TInstant *inst, bool hasz,
+  StringInfo buf)
+{
+  Datum value = tinstant_value(inst);
+  if (inst->valuetypid == BOOLOID)
+    pq_sendbyte(buf, DatumGetBool(value) ? (uint8) 1 : (uint8) 0);
+  else if (inst->valuetypid == INT4OID)
+    compact_sendint32(buf, DatumGetInt32(value));
+  else if (inst->valuetypid == FLOAT8OID)
+    pq_sendfloat8(buf, DatumGetFloat8(value));
+  else if (compact_point_type(inst->valuetypid))
+  {
+    if (hasz)
+    {
+      const POINT3DZ *point = datum_get_point3dz_p(value);
+      pq_sendfloat8(buf, point->x);
+      pq_sendfloat8(buf, point->y);
+      pq_sendfloat8(buf, point->z);
+    }
+    else
+    {
+      const POINT2D *point = datum_get_point2d_p(value);
+      pq_sendfloat8(buf, point->x);
+      pq_sendfloat8(buf, point->y);
+    }
+  }
+  else
+  {
+    /* Variable-length values keep the format of their send function */
+    bytea *bv = call_send(inst->valuetypid, value);
+    compact_sendint32(buf, VARSIZE(bv) - VARHDRSZ);
+    pq_sendbytes(buf, VARDATA(bv), VARSIZE(bv) - VARHDRSZ);
+    pfree(bv);
+  }
+  return;
+}
+
+/**
+ * Returns the instants of the temporal value in an array
+ *
+ * @param[in] temp Temporal value
+ * @param[out] count Number of elements in the resulting array
+ */
+static TInstant **
+temporal_compact_instants(const Temporal *temp, int *count)
+{
+  TInstant **result;
+  if (temp->duration == INSTANT)
+  {
+    result = palloc(sizeof(TInstant *));
+    result[0] = (TInstant *) temp;
+    *count = 1;
+  }
+  else if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (TInstantSet *) temp;
+    result = palloc(sizeof(TInstant *) * ti->count);
+    for (int i = 0; i < ti->count; i++)
+      result[i] = tinstantset_inst_n(ti, i);
+    *count = ti->count;
+  }
+  else if (temp->duration == SEQUENCE)
+  {
+    const TSequence *seq = (TSequence *) temp;
+    result = palloc(sizeof(TInstant *) * seq->count);
+    for (int i = 0; i < seq->count; i++)
+      result[i] = tsequence_inst_n(seq, i);
+    *count = seq->count;
+  }
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (TSequenceSet *) temp;
+    result = palloc(sizeof(TInstant *) * ts->totalcount);
+    int k = 0;
+    for (int i = 0; i < ts->count; i++)
+    {
+      const TSequence *seq = tsequenceset_seq_n(ts, i);
+      for (int j = 0; j < seq->count; j++)
+        result[k++] = tsequence_inst_n(seq, j);
+    }
+    *count = k;
+  }
+  return result;
+}
+
+/**
+ * Write the binary representation of the temporal value into the buffer
+ * in the compact binary format
+ *
+ * @param[in] temp Temporal value
+ * @param[in] buf Buffer
+ */
+void
+temporal_write_compact(const Temporal *temp, StringInfo buf)
+{
+  ensure_valid_duration(temp->duration);
+  bool point = compact_point_type(temp->valuetypid);
+  bool hasz = point && MOBDB_FLAGS_GET_Z(temp->flags);
+  pq_sendbyte(buf, (uint8) temp->duration | COMPACT_BINARY_FLAG);
+  pq_sendbyte(buf, COMPACT_BINARY_VERSION);
+  pq_sendbyte(buf, (uint8) (
+    (MOBDB_FLAGS_GET_LINEAR(temp->flags) ? COMPACT_LINEAR : 0) |
+    (hasz ? COMPACT_Z : 0) |
+    (point && MOBDB_FLAGS_GET_GEODETIC(temp->flags) ? COMPACT_GEODETIC : 0)));
+  if (point)
+    compact_sendint32(buf, tpoint_srid_internal(temp));
+
+  /* Write the headers */
+  if (temp->duration == INSTANTSET)
+    compact_sendint32(buf, ((TInstantSet *) temp)->count);
+  else if (temp->duration == SEQUENCE)
+    tsequence_write_compact_header((TSequence *) temp, buf);
+  else if (temp->duration == SEQUENCESET)
+  {
+    const TSequenceSet *ts = (TSequenceSet *) temp;
+    compact_sendint32(buf, ts->count);
+    for (int i = 0; i < ts->count; i++)
+      tsequence_write_compact_header(tsequenceset_seq_n(ts, i), buf);
+  }
+
+  /* Write the arrays of timestamps and of values */
+  int count;
+  TInstant **instants = temporal_compact_instants(temp, &count);
+  for (int i = 0; i < count; i++)
+    pq_sendint64(buf, instants[i]->t);
+  for (int i = 0; i < count; i++)
+    tinstant_write_compact_value(instants[i], hasz, buf);
+  pfree(instants);
+  return;
+}
+
+/**
+ * Structure to keep the state when reading the values of temporal points
+ * in the compact binary format. The coordinates are written in a point
+ * serialized once, which is then copied in each instant.
+ */
+typedef struct
+{
+  GSERIALIZED *gs;    /**< Point in which the coordinates are written */
+  double *coords;     /**< Coordinates of the point */
+  bool hasz;
+} CompactPointReader;
+
+/**
+ * Raise an error for an invalid number of elements
+ */
+static void
+compact_invalid_count(void)
+{
+  ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+    errmsg("Invalid number of elements in the compact binary format")));
+}
+
+/**
+ * Read the next instant in the compact binary format
+ */
+static TInstant *
+tinstant_read_compact(StringInfo buf, Oid valuetypid, TimestampTz t,
+  CompactPointReader *reader)
+{
+  Datum value;
+  if (valuetypid == BOOLOID)
+    value = BoolGetDatum(pq_getmsgbyte(buf) != 0);
+  else if (valuetypid == INT4OID)
+    value = Int32GetDatum((int32) pq_getmsgint(buf, 4));
+  else if (valuetypid == FLOAT8OID)
+    value = Float8GetDatum(pq_getmsgfloat8(buf));
+  else if (compact_point_type(valuetypid))
+  {
+    reader->coords[0] = pq_getmsgfloat8(buf);
+    reader->coords[1] = pq_getmsgfloat8(buf);
+    if (reader->hasz)
+      reader->coords[2] = pq_getmsgfloat8(buf);
+    value = PointerGetDatum(reader->gs);
+  }
+  else
+  {
+    int size = pq_getmsgint(buf, 4);
+    StringInfoData buf2 =
+    {
+      .cursor = 0,
+      .len = size,
+      .maxlen = size,
+      .data = (char *) pq_getmsgbytes(buf, size)
+    };
+    value = call_recv(valuetypid, &buf2);
+  }
+  return tinstant_make(value, t, valuetypid);
+}
+
+/**
+ * Returns a new temporal value from its binary representation in the
+ * compact binary format read from the buffer
+ *
+ * @param[in] buf Buffer, whose first byte has already been read
+ * @param[in] duration Duration of the temporal value
+ * @param[in] valuetypid Oid of the base type
+ * @note The validity of the instants is tested when constructing the
+ * result but the result is not normalized
+ */
+Temporal *
+temporal_read_compact(StringInfo buf, int16 duration, Oid valuetypid)
+{
+  int version = pq_getmsgbyte(buf);
+  if (version != COMPACT_BINARY_VERSION)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+      errmsg("Unsupported version %d of the compact binary format", version)));
+  int flags = pq_getmsgbyte(buf);
+  bool linear = (flags & COMPACT_LINEAR) != 0;
+  CompactPointReader reader;
+  reader.gs = NULL;
+  reader.hasz = (flags & COMPACT_Z) != 0;
+  if (compact_point_type(valuetypid))
+  {
+    int srid = (int) pq_getmsgint(buf, 4);
+    bool geodetic = (flags & COMPACT_GEODETIC) != 0;
+    if (geodetic != (valuetypid == type_oid(T_GEOGRAPHY)))
+      ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+        errmsg("The compact binary format does not match the temporal type")));
+    /* The point is read by the receive function of the base type, which
+     * verifies its SRID, in particular that the one of a geography is a
+     * valid geodetic SRID */
+    LWPOINT *lwpoint = reader.hasz ? lwpoint_make3dz(srid, 0, 0, 0) :
+      lwpoint_make2d(srid, 0, 0);
+    size_t size;
+    uint8_t *wkb = lwgeom_to_wkb((LWGEOM *) lwpoint, WKB_EXTENDED, &size);
+    lwpoint_free(lwpoint);
+    StringInfoData buf2 =
+    {
+      .cursor = 0,
+      .len = (int) size,
+      .maxlen = (int) size,
+      .data = (char *) wkb
+    };
+    reader.gs = (GSERIALIZED *) DatumGetPointer(call_recv(valuetypid, &buf2));
+    lwfree(wkb);
+    reader.coords = (double *) datum_get_point2d_p(PointerGetDatum(reader.gs));
+  }
+
+  /* Read the headers */
+  int nseqs = 1, count = 1;
+  if (duration == INSTANTSET)
+    count = (int) pq_getmsgint(buf, 4);
+  else if (duration == SEQUENCESET)
+    nseqs = (int) pq_getmsgint(buf, 4);
+  /* Each sequence has a header of 5 bytes and each instant a timestamp of
+   * 8 bytes, which bounds the numbers of elements by the size of the
+   * message */
+  if (count <= 0 || nseqs <= 0 || nseqs > (buf->len - buf->cursor) / 5)
+    compact_invalid_count();
+  int *counts = palloc(sizeof(int) * nseqs);
+  uint8 *bounds = palloc(sizeof(uint8) * nseqs);
+  if (duration == SEQUENCE || duration == SEQUENCESET)
+  {
+    count = 0;
+    for (int i = 0; i < nseqs; i++)
+    {
+      counts[i] = (int) pq_getmsgint(buf, 4);
+      bounds[i] = (uint8) pq_getmsgbyte(buf);
+      if (counts[i] <= 0 || counts[i] > (buf->len - buf->cursor) / 8 - count)
+        compact_invalid_count();
+      count += counts[i];
+    }
+  }
+  if (count > (buf->len - buf->cursor) / 8)
+    compact_invalid_count();
+
+  /* Read the arrays of timestamps and of values */
+  TimestampTz *times = palloc(sizeof(TimestampTz) * count);
+  for (int i = 0; i < count; i++)
+    times[i] = (TimestampTz) pq_getmsgint64(buf);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    instants[i] = tinstant_read_compact(buf, valuetypid, times[i], &reader);
+  pfree(times);
+  if (reader.gs != NULL)
+    pfree(reader.gs);
+
+  Temporal *result;
+  if (duration == INSTANT)
+  {
+    result = (Temporal *) instants[0];
+    pfree(instants);
+  }
+  else if (duration == INSTANTSET)
+    result = (Temporal *) tinstantset_make_free(instants, count);
+  else if (duration == SEQUENCE)
+    result = (Temporal *) tsequence_make_free(instants, count,
+      (bounds[0] & COMPACT_LOWER_INC) != 0,
+      (bounds[0] & COMPACT_UPPER_INC) != 0, linear, NORMALIZE_NO);
+  else /* duration == SEQUENCESET */
+  {
+    TSequence **sequences = palloc(sizeof(TSequence *) * nseqs);
+    int k = 0;
+    for (int i = 0; i < nseqs; i++)
+    {
+      sequences[i] = tsequence_make(&instants[k], counts[i],
+        (bounds[i] & COMPACT_LOWER_INC) != 0,
+        (bounds[i] & COMPACT_UPPER_INC) != 0, linear, NORMALIZE_NO);
+      k += counts[i];
+    }
+    for (int i = 0; i < count; i++)
+      pfree(instants[i]);
+    pfree(instants);
+    result = (Temporal *) tsequenceset_make_free(sequences, nseqs,
+      NORMALIZE_NO);
+  }
+  pfree(counts); pfree(bounds);
+  return result;
+}
+
 /*****************************************************************************
  * Constructor functions
  ****************************************************************************/
@@ -1214,16 +1628,36 @@ tsequenceset_constructor(PG_FUNCTION_ARGS)
 PG_FUNCTION_INFO_V1(temporal_append_tinstant);
 /**
  * Append an instant to the end of a temporal value
+ *
+ * The instant is appended in place when the first argument is a read-write
+ * pointer to an expanded sequence. Such a pointer is only received when the
+ * function is the transition function of an aggregate whose state is the
+ * temporal value, in which case the resulting sequence is kept in expanded
+ * format in the aggregate context. Otherwise, the flat result is returned.
  */
 PGDLLEXPORT Datum
 temporal_append_tinstant(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
   Temporal *inst = PG_GETARG_TEMPORAL(1);
   /* Validity tests */
   if (inst->duration != INSTANT)
     ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
       errmsg("The second argument must be of instant duration")));
+
+  /* Append in place to a read-write expanded sequence */
+  ExpandedTemporal *et = DatumGetExpandedTemporalRW(PG_GETARG_DATUM(0));
+  if (et != NULL)
+  {
+    ensure_same_base_type((Temporal *) et->instants[0], inst);
+    ensure_spatial_validity((Temporal *) et->instants[0], inst);
+    if (expanded_tsequence_append_tinstant(et, (TInstant *) inst))
+    {
+      PG_FREE_IF_COPY(inst, 1);
+      PG_RETURN_DATUM(EOHPGetRWDatum(&et->hdr));
+    }
+  }
+
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
   ensure_same_base_type(temp, (Temporal *)inst);
   /* The test to ensure the increasing timestamps must be done in the
    * specific function since the inclusive/exclusive bounds must be
@@ -1247,6 +1681,16 @@ temporal_append_tinstant(PG_FUNCTION_ARGS)
 
   PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(inst, 1);
+  /* The executor keeps the state of an aggregate in expanded format and
+   * passes it back read-write only if its object is a child of the
+   * aggregate context */
+  MemoryContext aggctx;
+  if (result->duration == SEQUENCE && AggCheckCallContext(fcinfo, &aggctx))
+  {
+    Datum resultdatum = temporal_expand(PointerGetDatum(result), aggctx);
+    pfree(result);
+    PG_RETURN_DATUM(resultdatum);
+  }
   PG_RETURN_POINTER(result);
 }
 
@@ -1590,10 +2034,8 @@ PG_FUNCTION_INFO_V1(temporal_to_period);
 PGDLLEXPORT Datum
 temporal_to_period(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
   Period *result = (Period *) palloc(sizeof(Period));
-  temporal_period(result, temp);
-  PG_FREE_IF_COPY(temp, 0);
+  temporal_period_slice(result, PG_GETARG_DATUM(0));
   PG_RETURN_PERIOD(result);
 }
 
@@ -1612,14 +2054,14 @@ temporal_to_tinstant(PG_FUNCTION_ARGS)
   Temporal *result;
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT)
-    result = temporal_copy(temp);
+    result = temp;
   else if (temp->duration == INSTANTSET)
     result = (Temporal *)tinstantset_to_tinstant((TInstantSet *)temp);
   else if (temp->duration == SEQUENCE)
     result = (Temporal *)tsequence_to_tinstant((TSequence *)temp);
   else /* temp->duration == SEQUENCESET */
     result = (Temporal *)tsequenceset_to_tinstant((TSequenceSet *)temp);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_RETURN_POINTER(result);
 }
 
@@ -1636,12 +2078,12 @@ temporal_to_tinstantset(PG_FUNCTION_ARGS)
   if (temp->duration == INSTANT)
     result = (Temporal *)tinstant_to_tinstantset((TInstant *)temp);
   else if (temp->duration == INSTANTSET)
-    result = temporal_copy(temp);
+    result = temp;
   else if (temp->duration == SEQUENCE)
     result = (Temporal *)tsequence_to_tinstantset((TSequence *)temp);
   else /* temp->duration == SEQUENCESET */
     result = (Temporal *)tsequenceset_to_tinstantset((TSequenceSet *)temp);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_RETURN_POINTER(result);
 }
 
@@ -1661,10 +2103,10 @@ temporal_to_tsequence(PG_FUNCTION_ARGS)
   else if (temp->duration == INSTANTSET)
     result = (Temporal *)tinstantset_to_tsequence((TInstantSet *)temp, linear);
   else if (temp->duration == SEQUENCE)
-    result = temporal_copy(temp);
+    result = temp;
   else /* temp->duration == SEQUENCESET */
     result = (Temporal *)tsequenceset_to_tsequence((TSequenceSet *)temp);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_RETURN_POINTER(result);
 }
 
@@ -1686,8 +2128,8 @@ temporal_to_tsequenceset(PG_FUNCTION_ARGS)
   else if (temp->duration == SEQUENCE)
     result = (Temporal *)tsequence_to_tsequenceset((TSequence *)temp);
   else /* temp->duration == SEQUENCESET */
-    result = temporal_copy(temp);
-  PG_FREE_IF_COPY(temp, 0);
+    result = temp;
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_RETURN_POINTER(result);
 }
 
@@ -1704,7 +2146,7 @@ tstep_to_linear(PG_FUNCTION_ARGS)
   ensure_linear_interpolation(temp->valuetypid);
 
   if (MOBDB_FLAGS_GET_LINEAR(temp->flags))
-    PG_RETURN_POINTER(temporal_copy(temp));
+    PG_RETURN_POINTER(temp);
 
   Temporal *result;
   if (temp->duration == SEQUENCE)
@@ -1775,6 +2217,171 @@ temporal_mem_size(PG_FUNCTION_ARGS)
   Datum result = toast_datum_size(PG_GETARG_DATUM(0));
   PG_RETURN_DATUM(result);
 }
+
+/**
+ * Number of bytes used by each part of a temporal value
+ */
+typedef struct
+{
+  int64 header;       /**< Fixed-size structs and padding */
+  int64 bbox;         /**< Bounding boxes */
+  int64 offsets;      /**< Offset arrays */
+  int64 blocks;       /**< Block directories of the bounding boxes */
+  int64 instants;     /**< Headers of the instants */
+  int64 values;       /**< Base values of the instants */
+  int64 trajectory;   /**< Precomputed trajectories */
+} MemBreakdown;
+
+/**
+ * Add to the breakdown the bytes of the instant, which occupies the given
+ * number of bytes in the temporal value containing it
+ */
+static void
+tinstant_mem_breakdown(const TInstant *inst, size_t size, MemBreakdown *mb)
+{
+  size_t value_offset = double_pad(sizeof(TInstant));
+  mb->values += VARSIZE(inst) - value_offset;
+  mb->instants += size - (VARSIZE(inst) - value_offset);
+  return;
+}
+
+/**
+ * Add to the breakdown the bytes of the array of instants of a temporal
+ * instant set or a temporal sequence
+ */
+static size_t
+tinstantarr_mem_breakdown(TInstant **instants, int count, MemBreakdown *mb)
+{
+  size_t result = 0;
+  for (int i = 0; i < count; i++)
+  {
+    size_t size = MOBDB_FLAGS_GET_BYVAL(instants[i]->flags) ?
+      TINSTANT_BYVAL_SIZE : double_pad(VARSIZE(instants[i]));
+    tinstant_mem_breakdown(instants[i], size, mb);
+    result += size;
+  }
+  return result;
+}
+
+/**
+ * Add to the breakdown the bytes of the temporal sequence, the bytes not
+ * used by the other parts are those of the precomputed trajectory and of
+ * the simplification levels
+ */
+static void
+tsequence_mem_breakdown(const TSequence *seq, MemBreakdown *mb)
+{
+  size_t header = double_pad(sizeof(TSequence));
+  size_t bbox = double_pad(temporal_bbox_size(seq->valuetypid));
+  /* In the original format the offsets are not padded */
+  size_t offsets = ! MOBDB_FLAGS_GET_VERSION(seq->flags) ?
+    sizeof(size_t) * tsequence_offsets_count(seq) :
+    MOBDB_FLAGS_GET_BYVAL(seq->flags) ? 0 :
+    double_pad(TEMPORAL_OFFSET_SIZE(seq->flags) *
+      tsequence_offsets_count(seq));
+  size_t blocks = tsequence_block_count(seq) * bbox;
+  TInstant **instants = tsequence_instants(seq);
+  size_t insts = tinstantarr_mem_breakdown(instants, seq->count, mb);
+  pfree(instants);
+  mb->header += header;
+  mb->bbox += bbox;
+  mb->offsets += offsets;
+  mb->blocks += blocks;
+  mb->trajectory += VARSIZE(seq) - header - bbox - offsets - blocks - insts;
+  return;
+}
+
+/**
+ * Returns the number of bytes used by each part of the temporal value
+ */
+static void
+temporal_mem_breakdown_internal(const Temporal *temp, MemBreakdown *mb)
+{
+  memset(mb, 0, sizeof(MemBreakdown));
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+  {
+    mb->header += double_pad(sizeof(TInstant));
+    mb->values += VARSIZE(temp) - double_pad(sizeof(TInstant));
+  }
+  else if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (TInstantSet *) temp;
+    size_t header = double_pad(sizeof(TInstantSet));
+    size_t bbox = double_pad(temporal_bbox_size(ti->valuetypid));
+    /* In the original format the offsets keep that of the bounding box */
+    size_t offsets = ! MOBDB_FLAGS_GET_VERSION(ti->flags) ?
+      sizeof(size_t) * (ti->count + 1) :
+      MOBDB_FLAGS_GET_BYVAL(ti->flags) ? 0 :
+      double_pad(TEMPORAL_OFFSET_SIZE(ti->flags) * ti->count);
+    TInstant **instants = tinstantset_instants(ti);
+    size_t insts = tinstantarr_mem_breakdown(instants, ti->count, mb);
+    pfree(instants);
+    mb->header += VARSIZE(ti) - bbox - offsets - insts;
+    mb->bbox += bbox;
+    mb->offsets += offsets;
+  }
+  else if (temp->duration == SEQUENCE)
+    tsequence_mem_breakdown((TSequence *) temp, mb);
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (TSequenceSet *) temp;
+    size_t bbox = double_pad(temporal_bbox_size(ts->valuetypid));
+    size_t offsets = ! MOBDB_FLAGS_GET_VERSION(ts->flags) ?
+      sizeof(size_t) * (ts->count + 1) :
+      double_pad(TEMPORAL_OFFSET_SIZE(ts->flags) * ts->count);
+    size_t seqs = 0;
+    for (int i = 0; i < ts->count; i++)
+    {
+      const TSequence *seq = tsequenceset_seq_n(ts, i);
+      tsequence_mem_breakdown(seq, mb);
+      seqs += VARSIZE(seq);
+    }
+    /* The header includes the padding between the sequences */
+    mb->header += VARSIZE(ts) - bbox - offsets - seqs;
+    mb->bbox += bbox;
+    mb->offsets += offsets;
+  }
+  return;
+}
+
+PG_FUNCTION_INFO_V1(temporal_mem_breakdown);
+/**
+ * Returns the number of bytes used by each part of the temporal value,
+ * its size in the standard format, and the raw and stored sizes of the
+ * value as fetched from the table, which differ when the value is
+ * compressed or packed
+ */
+PGDLLEXPORT Datum
+temporal_mem_breakdown(PG_FUNCTION_ARGS)
+{
+  Datum value = PG_GETARG_DATUM(0);
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  MemBreakdown mb;
+  temporal_mem_breakdown_internal(temp, &mb);
+  TupleDesc tupdesc;
+  if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+      errmsg("function returning record called in context that cannot accept type record")));
+  tupdesc = BlessTupleDesc(tupdesc);
+  Datum values[10];
+  bool isnull[10];
+  memset(isnull, 0, sizeof(isnull));
+  values[0] = Int64GetDatum(mb.header);
+  values[1] = Int64GetDatum(mb.bbox);
+  values[2] = Int64GetDatum(mb.offsets);
+  values[3] = Int64GetDatum(mb.blocks);
+  values[4] = Int64GetDatum(mb.instants);
+  values[5] = Int64GetDatum(mb.values);
+  values[6] = Int64GetDatum(mb.trajectory);
+  values[7] = Int64GetDatum((int64) VARSIZE(temp));
+  values[8] = Int64GetDatum((int64) toast_raw_datum_size(value));
+  values[9] = Int64GetDatum((int64) toast_datum_size(value));
+  HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
 /*
 PGDLLEXPORT Datum
 temporal_mem_size(PG_FUNCTION_ARGS)
@@ -1962,6 +2569,142 @@ temporal_bbox(void *box, const Temporal *temp)
   return;
 }
 
+/**
+ * Returns the prefix of the temporal value given as a datum that contains
+ * the fixed-size part of the struct and the precomputed bounding box
+ *
+ * Since the precomputed bounding box is located immediately after the
+ * fixed-size part of the struct, only the first bytes of a toasted value
+ * need to be fetched, which avoids reading and decompressing the whole
+ * value. The result must be freed by the caller if it is different from
+ * the argument.
+ *
+ * Values in the original format, that is, without the version flag, keep
+ * the bounding box after the instants and are detoasted completely.
+ */
+static Temporal *
+temporal_prefix_slice(Datum tempdatum)
+{
+  Temporal *temp = (Temporal *) DatumGetPointer(tempdatum);
+  if (VARATT_IS_EXTENDED(temp))
+  {
+    temp = (Temporal *) PG_DETOAST_DATUM_SLICE(tempdatum, 0,
+      double_pad(sizeof(TemporalPacked)) + double_pad(sizeof(bboxunion)) -
+      VARHDRSZ);
+    if (temp->duration != INSTANT &&
+      ! MOBDB_FLAGS_GET_PACKED(temp->flags) &&
+      ! MOBDB_FLAGS_GET_VERSION(temp->flags))
+    {
+      pfree(temp);
+      temp = (Temporal *) PG_DETOAST_DATUM(tempdatum);
+    }
+  }
+  return temp;
+}
+
+/**
+ * Set the first argument to the bounding box of the temporal value given
+ * as a datum, detoasting only the prefix of the value that contains the box
+ *
+ * Temporal instant values do not have a precomputed bounding box and
+ * are detoasted completely.
+ */
+void
+temporal_bbox_slice(void *box, Datum tempdatum)
+{
+  Temporal *temp = temporal_prefix_slice(tempdatum);
+  if (temp->duration == INSTANT)
+  {
+    Temporal *inst = (Temporal *) PG_DETOAST_DATUM(tempdatum);
+    tinstant_make_bbox(box, (TInstant *) inst);
+    if ((Pointer) inst != DatumGetPointer(tempdatum))
+      pfree(inst);
+  }
+  else if (MOBDB_FLAGS_GET_PACKED(temp->flags))
+    memcpy(box, tpointpk_bbox_ptr((TemporalPacked *) temp), sizeof(STBOX));
+  else
+    memcpy(box, temporal_bbox_ptr(temp), temporal_bbox_size(temp->valuetypid));
+  if ((Pointer) temp != DatumGetPointer(tempdatum))
+    pfree(temp);
+  return;
+}
+
+/**
+ * Set the first argument to the period on which the temporal value given
+ * as a datum is defined, detoasting only the prefix of the value
+ *
+ * The period of temporal sequence values is stored in the fixed-size part
+ * of the struct. For temporal instant set and sequence set values, the
+ * period is obtained from the bounding box, and thus its bounds are
+ * inclusive unless the bounding box is a period.
+ */
+void
+temporal_period_slice(Period *p, Datum tempdatum)
+{
+  Temporal *temp = temporal_prefix_slice(tempdatum);
+  if (temp->duration == INSTANT)
+  {
+    Temporal *inst = (Temporal *) PG_DETOAST_DATUM(tempdatum);
+    temporal_period(p, inst);
+    if ((Pointer) inst != DatumGetPointer(tempdatum))
+      pfree(inst);
+  }
+  else if (MOBDB_FLAGS_GET_PACKED(temp->flags))
+    *p = ((TemporalPacked *) temp)->period;
+  else if (temp->duration == SEQUENCE)
+    *p = ((TSequence *) temp)->period;
+  else if (talpha_base_type(temp->valuetypid))
+    *p = *((Period *) temporal_bbox_ptr(temp));
+  else if (tnumber_base_type(temp->valuetypid))
+  {
+    TBOX *box = (TBOX *) temporal_bbox_ptr(temp);
+    period_set(p, box->tmin, box->tmax, true, true);
+  }
+  else /* tgeo_base_type(temp->valuetypid) */
+  {
+    STBOX *box = (STBOX *) temporal_bbox_ptr(temp);
+    period_set(p, box->tmin, box->tmax, true, true);
+  }
+  if ((Pointer) temp != DatumGetPointer(tempdatum))
+    pfree(temp);
+  return;
+}
+
+/**
+ * Returns the n-th element of the offset array of a temporal value
+ *
+ * @param[in] offsets Offset array
+ * @param[in] flags Flags of the temporal value, which determine the size
+ * of the elements of the array
+ * @param[in] index Index of the element
+ */
+size_t
+temporal_offset_get(const void *offsets, int16 flags, int index)
+{
+  if (MOBDB_FLAGS_GET_VERSION(flags))
+    return (size_t) ((const uint32 *) offsets)[index];
+  return ((const size_t *) offsets)[index];
+}
+
+/**
+ * Set the n-th element of the offset array of a temporal value
+ *
+ * @param[out] offsets Offset array
+ * @param[in] flags Flags of the temporal value, which determine the size
+ * of the elements of the array
+ * @param[in] index Index of the element
+ * @param[in] value Value of the offset
+ */
+void
+temporal_offset_set(void *offsets, int16 flags, int index, size_t value)
+{
+  if (MOBDB_FLAGS_GET_VERSION(flags))
+    ((uint32 *) offsets)[index] = (uint32) value;
+  else
+    ((size_t *) offsets)[index] = value;
+  return;
+}
+
 PG_FUNCTION_INFO_V1(tnumber_to_tbox);
 /**
  * Returns the bounding box of the temporal value
@@ -1969,10 +2712,8 @@ PG_FUNCTION_INFO_V1(tnumber_to_tbox);
 PGDLLEXPORT Datum
 tnumber_to_tbox(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
   TBOX *result = palloc0(sizeof(TBOX));
-  temporal_bbox(result, temp);
-  PG_FREE_IF_COPY(temp, 0);
+  temporal_bbox_slice(result, PG_GETARG_DATUM(0));
   PG_RETURN_POINTER(result);
 }
 
@@ -2174,10 +2915,14 @@ PG_FUNCTION_INFO_V1(temporal_timespan);
 PGDLLEXPORT Datum
 temporal_timespan(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  /* The timespan of a packed value is obtained from its period */
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
   Datum result;
   ensure_valid_duration(temp->duration);
-  if (temp->duration == INSTANT || temp->duration == INSTANTSET)
+  if (MOBDB_FLAGS_GET_PACKED(temp->flags) && temp->duration == SEQUENCE)
+    result = PointerGetDatum(period_timespan_internal(
+      &((TemporalPacked *) temp)->period));
+  else if (temp->duration == INSTANT || temp->duration == INSTANTSET)
   {
     Interval *interval = (Interval *) palloc(sizeof(Interval));
     interval->month = interval->day =  0;
@@ -2294,6 +3039,37 @@ temporal_sequences(PG_FUNCTION_ARGS)
   PG_RETURN_ARRAYTYPE_P(result);
 }
 
+/**
+ * Returns the number of instants of the temporal value given to the
+ * tracepoints, or 0 for a NULL value
+ *
+ * @note Contrary to the function numInstants, the instants shared by two
+ * consecutive sequences are counted twice
+ */
+int
+temporal_probe_count(const Temporal *temp)
+{
+  if (temp == NULL)
+    return 0;
+  if (temp->duration == INSTANT)
+    return 1;
+  if (temp->duration == INSTANTSET)
+    return ((TInstantSet *)temp)->count;
+  if (temp->duration == SEQUENCE)
+    return ((TSequence *)temp)->count;
+  return ((TSequenceSet *)temp)->totalcount;
+}
+
+/**
+ * Returns the size in bytes of the temporal value given to the tracepoints,
+ * or 0 for a NULL value
+ */
+int64
+temporal_probe_size(const Temporal *temp)
+{
+  return temp == NULL ? 0 : (int64) VARSIZE(temp);
+}
+
 PG_FUNCTION_INFO_V1(temporal_num_instants);
 /**
  * Returns the number of distinct instants of the temporal value
@@ -2301,10 +3077,12 @@ PG_FUNCTION_INFO_V1(temporal_num_instants);
 PGDLLEXPORT Datum
 temporal_num_instants(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
   int result;
   ensure_valid_duration(temp->duration);
-  if (temp->duration == INSTANT)
+  if (MOBDB_FLAGS_GET_PACKED(temp->flags))
+    result = ((TemporalPacked *) temp)->count;
+  else if (temp->duration == INSTANT)
     result = 1;
   else if (temp->duration == INSTANTSET)
     result = ((TInstantSet *)temp)->count;
@@ -2324,11 +3102,12 @@ PGDLLEXPORT Datum
 temporal_start_instant(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
+  if (temp->duration == INSTANT)
+    PG_RETURN_POINTER(temp);
+
   TInstant *result;
   ensure_valid_duration(temp->duration);
-  if (temp->duration == INSTANT)
-    result = tinstant_copy((TInstant *)temp);
-  else if (temp->duration == INSTANTSET)
+  if (temp->duration == INSTANTSET)
     result = tinstant_copy(tinstantset_inst_n((TInstantSet *)temp, 0));
   else if (temp->duration == SEQUENCE)
     result = tinstant_copy(tsequence_inst_n((TSequence *)temp, 0));
@@ -2374,6 +3153,9 @@ PGDLLEXPORT Datum
 temporal_end_instant(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
+  if (temp->duration == INSTANT)
+    PG_RETURN_POINTER(temp);
+
   TInstant *result = tinstant_copy(temporal_end_instant_internal(temp));
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_POINTER(result);
@@ -2393,7 +3175,7 @@ temporal_instant_n(PG_FUNCTION_ARGS)
   if (temp->duration == INSTANT)
   {
     if (n == 1)
-      result = tinstant_copy((TInstant *)temp);
+      PG_RETURN_POINTER(temp);
   }
   else if (temp->duration == INSTANTSET)
   {
@@ -2471,8 +3253,10 @@ PG_FUNCTION_INFO_V1(temporal_start_timestamp);
 PGDLLEXPORT Datum
 temporal_start_timestamp(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
-  TimestampTz result = temporal_start_timestamp_internal(temp);
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
+  TimestampTz result = MOBDB_FLAGS_GET_PACKED(temp->flags) ?
+    ((TemporalPacked *) temp)->period.lower :
+    temporal_start_timestamp_internal(temp);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_TIMESTAMPTZ(result);
 }
@@ -2484,10 +3268,12 @@ PG_FUNCTION_INFO_V1(temporal_end_timestamp);
 PGDLLEXPORT Datum
 temporal_end_timestamp(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
   TimestampTz result;
   ensure_valid_duration(temp->duration);
-  if (temp->duration == INSTANT)
+  if (MOBDB_FLAGS_GET_PACKED(temp->flags))
+    result = ((TemporalPacked *) temp)->period.upper;
+  else if (temp->duration == INSTANT)
     result = ((TInstant *)temp)->t;
   else if (temp->duration == INSTANTSET)
     result = tinstantset_inst_n((TInstantSet *)temp, ((TInstantSet *)temp)->count - 1)->t;
@@ -2506,10 +3292,12 @@ PG_FUNCTION_INFO_V1(temporal_num_timestamps);
 PGDLLEXPORT Datum
 temporal_num_timestamps(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
   int result;
   ensure_valid_duration(temp->duration);
-  if (temp->duration == INSTANT)
+  if (MOBDB_FLAGS_GET_PACKED(temp->flags))
+    result = ((TemporalPacked *) temp)->count;
+  else if (temp->duration == INSTANT)
     result = 1;
   else if (temp->duration == INSTANTSET)
     result = ((TInstantSet *)temp)->count;
@@ -2528,12 +3316,20 @@ PG_FUNCTION_INFO_V1(temporal_timestamp_n);
 PGDLLEXPORT Datum
 temporal_timestamp_n(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
   int n = PG_GETARG_INT32(1); /* Assume 1-based */
   TimestampTz result;
   bool found = false;
   ensure_valid_duration(temp->duration);
-  if (temp->duration == INSTANT)
+  if (MOBDB_FLAGS_GET_PACKED(temp->flags))
+  {
+    if (n >= 1 && n <= ((TemporalPacked *) temp)->count)
+    {
+      found = true;
+      result = temporalpk_timestamp_n((TemporalPacked *) temp, n - 1);
+    }
+  }
+  else if (temp->duration == INSTANT)
   {
     if (n == 1)
     {
@@ -2572,10 +3368,13 @@ PG_FUNCTION_INFO_V1(temporal_timestamps);
 PGDLLEXPORT Datum
 temporal_timestamps(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  /* The timestamps of a packed value are decoded without its coordinates */
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
   ArrayType *result;
   ensure_valid_duration(temp->duration);
-  if (temp->duration == INSTANT)
+  if (MOBDB_FLAGS_GET_PACKED(temp->flags))
+    result = temporalpk_timestamps((TemporalPacked *) temp);
+  else if (temp->duration == INSTANT)
     result = tinstant_timestamps((TInstant *)temp);
   else if (temp->duration == INSTANTSET)
     result = tinstantset_timestamps((TInstantSet *)temp);
@@ -3193,6 +3992,8 @@ tnumber_bbox_restrict_ranges(const Temporal *temp, RangeType **ranges,
  * @note This function does a bounding box test for the durations different
  * from instant. The singleton tests are done in the functions for the specific
  * durations.
+ * @note The function returns its argument rather than a copy of it when
+ * the restriction does not change the value
  */
 Temporal *
 temporal_restrict_value_internal(const Temporal *temp, Datum value,
@@ -3204,7 +4005,7 @@ temporal_restrict_value_internal(const Temporal *temp, Datum value,
     if (atfunc)
       return NULL;
     else
-      return (temp->duration != SEQUENCE) ? temporal_copy(temp) :
+      return (temp->duration != SEQUENCE) ? (Temporal *) temp :
         (Temporal *) tsequence_to_tsequenceset((TSequence *)temp);
   }
 
@@ -3232,10 +4033,14 @@ Datum
 temporal_restrict_value(FunctionCallInfo fcinfo, bool atfunc)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
+  TRACE_MOBILITYDB_RESTRICT_START(PROBE_RESTRICT_VALUE,
+    temporal_probe_count(temp), temporal_probe_size(temp));
   Datum value = PG_GETARG_ANYDATUM(1);
   Oid valuetypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
   Temporal *result = temporal_restrict_value_internal(temp, value, atfunc);
-  PG_FREE_IF_COPY(temp, 0);
+  TRACE_MOBILITYDB_RESTRICT_DONE(PROBE_RESTRICT_VALUE,
+    temporal_probe_count(result), temporal_probe_size(result));
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   DATUM_FREE_IF_COPY(value, valuetypid, 1);
   if (result == NULL)
     PG_RETURN_NULL();
@@ -3267,6 +4072,9 @@ temporal_minus_value(PG_FUNCTION_ARGS)
 /**
  * Restricts the temporal value to the (complement of the) array of base values
  * (dispatch function)
+ *
+ * @note The function returns its argument rather than a copy of it when
+ * the restriction does not change the value
  */
 Temporal *
 temporal_restrict_values_internal(const Temporal *temp, Datum *values,
@@ -3281,7 +4089,7 @@ temporal_restrict_values_internal(const Temporal *temp, Datum *values,
     if (atfunc)
       return NULL;
     else
-      return (temp->duration != SEQUENCE) ? temporal_copy(temp) :
+      return (temp->duration != SEQUENCE) ? (Temporal *) temp :
         (Temporal *) tsequence_to_tsequenceset((TSequence *)temp);
   }
 
@@ -3312,7 +4120,7 @@ temporal_restrict_values(FunctionCallInfo fcinfo, bool atfunc)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
   ArrayType *array = PG_GETARG_ARRAYTYPE_P(1);
-  /* Return NULL or a copy of the temporal value on empty array */
+  /* Return NULL or the temporal value on empty array */
   int count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
   if (count == 0)
   {
@@ -3323,13 +4131,11 @@ temporal_restrict_values(FunctionCallInfo fcinfo, bool atfunc)
       PG_RETURN_NULL();
     }
     else
-    {
-      Temporal *result = temporal_copy(temp);
-      PG_FREE_IF_COPY(temp, 0);
-      PG_RETURN_POINTER(result);
-    }
+      PG_RETURN_POINTER(temp);
   }
 
+  TRACE_MOBILITYDB_RESTRICT_START(PROBE_RESTRICT_VALUES,
+    temporal_probe_count(temp), temporal_probe_size(temp));
   Datum *values = datumarr_extract(array, &count);
   /* For temporal points the validity of values in the array is done in
    * bounding box function */
@@ -3338,7 +4144,9 @@ temporal_restrict_values(FunctionCallInfo fcinfo, bool atfunc)
     temporal_restrict_value_internal(temp, values[0], atfunc);
 
   pfree(values);
-  PG_FREE_IF_COPY(temp, 0);
+  TRACE_MOBILITYDB_RESTRICT_DONE(PROBE_RESTRICT_VALUES,
+    temporal_probe_count(result), temporal_probe_size(result));
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_FREE_IF_COPY(array, 1);
   if (result == NULL)
     PG_RETURN_NULL();
@@ -3370,6 +4178,9 @@ temporal_minus_values(PG_FUNCTION_ARGS)
 /**
  * Restricts the temporal value to the (complement of the) range of base values
  * (dispatch function)
+ *
+ * @note The function returns its argument rather than a copy of it when
+ * the restriction does not change the value
  */
 Temporal *
 tnumber_restrict_range_internal(const Temporal *temp, RangeType *range,
@@ -3383,7 +4194,7 @@ tnumber_restrict_range_internal(const Temporal *temp, RangeType *range,
     if (atfunc)
       return NULL;
     else
-      return (temp->duration != SEQUENCE) ? temporal_copy(temp) :
+      return (temp->duration != SEQUENCE) ? (Temporal *) temp :
         (Temporal *) tsequence_to_tsequenceset((TSequence *)temp);
   }
 
@@ -3414,7 +4225,7 @@ tnumber_restrict_range(FunctionCallInfo fcinfo, bool atfunc)
   RangeType *range = PG_GETARG_RANGE_P(1);
 #endif
   Temporal *result = tnumber_restrict_range_internal(temp, range, atfunc);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_FREE_IF_COPY(range, 1);
   if (result == NULL)
     PG_RETURN_NULL();
@@ -3446,6 +4257,9 @@ tnumber_minus_range(PG_FUNCTION_ARGS)
 /**
  * Restricts the temporal value to the (complement of the) array of ranges
  * of base values (internal function)
+ *
+ * @note The function returns its argument rather than a copy of it when
+ * the restriction does not change the value
  */
 Temporal *
 tnumber_restrict_ranges_internal(const Temporal *temp, RangeType **ranges,
@@ -3460,7 +4274,7 @@ tnumber_restrict_ranges_internal(const Temporal *temp, RangeType **ranges,
     if (atfunc)
       return NULL;
     else
-      return (temp->duration != SEQUENCE) ? temporal_copy(temp) :
+      return (temp->duration != SEQUENCE) ? (Temporal *) temp :
         (Temporal *) tsequence_to_tsequenceset((TSequence *)temp);
   }
 
@@ -3494,7 +4308,7 @@ tnumber_restrict_ranges(FunctionCallInfo fcinfo, bool atfunc)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
   ArrayType *array = PG_GETARG_ARRAYTYPE_P(1);
-  /* Return NULL or a copy of the temporal value on empty array */
+  /* Return NULL or the temporal value on empty array */
   int count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
   if (count == 0)
   {
@@ -3505,18 +4319,14 @@ tnumber_restrict_ranges(FunctionCallInfo fcinfo, bool atfunc)
       PG_RETURN_NULL();
     }
     else
-    {
-      Temporal *result = temporal_copy(temp);
-      PG_FREE_IF_COPY(temp, 0);
-      PG_RETURN_POINTER(result);
-    }
+      PG_RETURN_POINTER(temp);
   }
   RangeType **ranges = rangearr_extract(array, &count);
   Temporal *result = (count > 1) ?
     tnumber_restrict_ranges_internal(temp, ranges, count, atfunc) :
     tnumber_restrict_range_internal(temp, ranges[0], atfunc);
   pfree(ranges);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   PG_FREE_IF_COPY(array, 1);
   if (result == NULL)
     PG_RETURN_NULL();
@@ -3576,7 +4386,11 @@ Datum
 temporal_restrict_minmax(FunctionCallInfo fcinfo, bool min, bool atfunc)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
+  TRACE_MOBILITYDB_RESTRICT_START(PROBE_RESTRICT_MINMAX,
+    temporal_probe_count(temp), temporal_probe_size(temp));
   Temporal *result = temporal_restrict_minmax_internal(temp, min, atfunc);
+  TRACE_MOBILITYDB_RESTRICT_DONE(PROBE_RESTRICT_MINMAX,
+    temporal_probe_count(result), temporal_probe_size(result));
   PG_FREE_IF_COPY(temp, 0);
   if (result == NULL)
     PG_RETURN_NULL();
@@ -3656,9 +4470,29 @@ temporal_restrict_timestamp_internal(const Temporal *temp, TimestampTz t,
 Datum
 temporal_restrict_timestamp(FunctionCallInfo fcinfo, bool atfunc)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  /* A packed value is only unpacked for the minus function */
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
+  TRACE_MOBILITYDB_RESTRICT_START(PROBE_RESTRICT_TIMESTAMP,
+    temporal_probe_count(temp), temporal_probe_size(temp));
   TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
-  Temporal *result = temporal_restrict_timestamp_internal(temp, t, atfunc);
+  Temporal *result;
+  if (atfunc && MOBDB_FLAGS_GET_PACKED(temp->flags))
+  {
+    Datum value;
+    result = NULL;
+    if (temporalpk_value_at_timestamp((TemporalPacked *) temp, t, &value))
+    {
+      result = (Temporal *) tinstant_make(value, t, temp->valuetypid);
+      pfree(DatumGetPointer(value));
+    }
+  }
+  else
+  {
+    temp = temporal_unpack(temp);
+    result = temporal_restrict_timestamp_internal(temp, t, atfunc);
+  }
+  TRACE_MOBILITYDB_RESTRICT_DONE(PROBE_RESTRICT_TIMESTAMP,
+    temporal_probe_count(result), temporal_probe_size(result));
   PG_FREE_IF_COPY(temp, 0);
   if (result == NULL)
     PG_RETURN_NULL();
@@ -3709,32 +4543,131 @@ temporal_value_at_timestamp_inc(const Temporal *temp, TimestampTz t, Datum *valu
 
 /*****************************************************************************/
 
-PG_FUNCTION_INFO_V1(temporal_value_at_timestamp);
 /**
  * Returns the base value of the temporal value at the timestamp
+ * (dispatch function)
  */
-PGDLLEXPORT Datum
-temporal_value_at_timestamp(PG_FUNCTION_ARGS)
+bool
+temporal_value_at_timestamp_internal(const Temporal *temp, TimestampTz t,
+  Datum *value)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
-  TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
-  bool found = false;
-  Datum result;
+  bool result;
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT)
-    found = tinstant_value_at_timestamp((TInstant *)temp, t, &result);
+    result = tinstant_value_at_timestamp((TInstant *)temp, t, value);
   else if (temp->duration == INSTANTSET)
-    found = tinstantset_value_at_timestamp((TInstantSet *)temp, t, &result);
+    result = tinstantset_value_at_timestamp((TInstantSet *)temp, t, value);
   else if (temp->duration == SEQUENCE)
-    found = tsequence_value_at_timestamp((TSequence *)temp, t, &result);
+    result = tsequence_value_at_timestamp((TSequence *)temp, t, value);
   else /* temp->duration == SEQUENCESET */
-    found = tsequenceset_value_at_timestamp((TSequenceSet *)temp, t, &result);
-  PG_FREE_IF_COPY(temp, 0);
+    result = tsequenceset_value_at_timestamp((TSequenceSet *)temp, t, value);
+  return result;
+}
+
+PG_FUNCTION_INFO_V1(temporal_value_at_timestamp);
+/**
+ * Returns the base value of the temporal value at the timestamp
+ *
+ * @note When the function is called repeatedly with the same temporal
+ * sequence set, e.g., in a join with a series of timestamps, the value is
+ * taken from the cache of the function arguments and the sequence of the
+ * previous timestamp is used as a starting point to locate the timestamp
+ */
+PGDLLEXPORT Datum
+temporal_value_at_timestamp(PG_FUNCTION_ARGS)
+{
+  ArgCacheEntry *entry = argcache_temporal(fcinfo, 0);
+  TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+  Datum result;
+  bool found;
+  /* A sequence set stored out of line without compression is read
+   * partially unless it is cached */
+  if (entry == NULL && tsequenceset_value_at_timestamp_slice(
+      PG_GETARG_DATUM(0), t, &result, &found))
+  {
+    if (!found)
+      PG_RETURN_NULL();
+    PG_RETURN_DATUM(result);
+  }
+  Temporal *temp = (entry != NULL) ?
+    (Temporal *) DatumGetPointer(entry->value) :
+    temporal_detoast(PG_GETARG_DATUM(0));
+  /* Only the instants surrounding the timestamp of a packed value are
+   * decoded */
+  if (MOBDB_FLAGS_GET_PACKED(temp->flags))
+  {
+    found = temporalpk_value_at_timestamp((TemporalPacked *) temp, t,
+      &result);
+    ARGCACHE_FREE_IF_COPY(temp, 0, entry);
+    if (!found)
+      PG_RETURN_NULL();
+    PG_RETURN_DATUM(result);
+  }
+  if (entry != NULL && temp->duration == SEQUENCESET)
+  {
+    TSequenceSet *ts = (TSequenceSet *) temp;
+    int loc;
+    found = tsequenceset_find_timestamp_hint(ts, t, entry->loc, &loc) &&
+      tsequence_value_at_timestamp(tsequenceset_seq_n(ts, loc), t, &result);
+    entry->loc = loc;
+  }
+  else
+    found = temporal_value_at_timestamp_internal(temp, t, &result);
+  ARGCACHE_FREE_IF_COPY(temp, 0, entry);
   if (!found)
     PG_RETURN_NULL();
   PG_RETURN_DATUM(result);
 }
 
+PG_FUNCTION_INFO_V1(temporal_values_at_timestamps);
+/**
+ * Returns the base values of the temporal value at the timestamps in an
+ * array, which contains a NULL for each timestamp not contained in the
+ * temporal value
+ *
+ * @note The temporal value is detoasted only once for all the timestamps
+ */
+PGDLLEXPORT Datum
+temporal_values_at_timestamps(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(1);
+  ensure_non_empty_array(array);
+  int count;
+  TimestampTz *times = timestamparr_extract(array, &count);
+  Datum *values = palloc(sizeof(Datum) * count);
+  bool *found = palloc(sizeof(bool) * count);
+  if (temp->duration == SEQUENCE)
+    tsequence_values_at_timestamps((TSequence *)temp, times, count,
+      values, found);
+  else
+  {
+    for (int i = 0; i < count; i++)
+      found[i] = temporal_value_at_timestamp_internal(temp, times[i],
+        &values[i]);
+  }
+  /* The null flags of the array are the complement of the found flags */
+  for (int i = 0; i < count; i++)
+    found[i] = ! found[i];
+  int16 elmlen;
+  bool elmbyval;
+  char elmalign;
+  get_typlenbyvalalign(temp->valuetypid, &elmlen, &elmbyval, &elmalign);
+  int lbs = 1;
+  ArrayType *result = construct_md_array(values, found, 1, &count, &lbs,
+    temp->valuetypid, elmlen, elmbyval, elmalign);
+  if (! elmbyval)
+  {
+    for (int i = 0; i < count; i++)
+      if (! found[i])
+        pfree(DatumGetPointer(values[i]));
+  }
+  pfree(values); pfree(found); pfree(times);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY(array, 1);
+  PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************/
 
 /**
@@ -3744,6 +4677,8 @@ Datum
 temporal_restrict_timestampset(FunctionCallInfo fcinfo, bool atfunc)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
+  TRACE_MOBILITYDB_RESTRICT_START(PROBE_RESTRICT_TIMESTAMPSET,
+    temporal_probe_count(temp), temporal_probe_size(temp));
   TimestampSet *ts = PG_GETARG_TIMESTAMPSET(1);
   Temporal *result;
   ensure_valid_duration(temp->duration);
@@ -3760,6 +4695,8 @@ temporal_restrict_timestampset(FunctionCallInfo fcinfo, bool atfunc)
   else /* temp->duration == SEQUENCESET */
     result = (Temporal *)tsequenceset_restrict_timestampset(
       (TSequenceSet *)temp, ts, atfunc);
+  TRACE_MOBILITYDB_RESTRICT_DONE(PROBE_RESTRICT_TIMESTAMPSET,
+    temporal_probe_count(result), temporal_probe_size(result));
   PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(ts, 1);
   if (result == NULL)
@@ -3791,11 +4728,24 @@ temporal_minus_timestampset(PG_FUNCTION_ARGS)
 /**
  * Restricts the temporal value to the (complement of the) period
  * (dispatch function)
+ *
+ * @note The function returns its argument rather than a copy of it when
+ * the restriction does not change the value
  */
 Temporal *
 temporal_restrict_period_internal(const Temporal *temp, const Period *p,
   bool atfunc)
 {
+  /* Bounding box test */
+  Period p1;
+  temporal_period(&p1, temp);
+  if (atfunc && contains_period_period_internal(p, &p1))
+    return (Temporal *) temp;
+  /* The complement of a sequence is a sequence set */
+  if (! atfunc && temp->duration != SEQUENCE &&
+      ! overlaps_period_period_internal(p, &p1))
+    return (Temporal *) temp;
+
   Temporal *result;
   ensure_valid_duration(temp->duration);
   if (temp->duration == INSTANT)
@@ -3823,10 +4773,22 @@ temporal_at_period_internal(const Temporal *temp, const Period *p)
 Datum
 temporal_restrict_period(FunctionCallInfo fcinfo, bool atfunc)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  /* A packed value is only unpacked for the minus function */
+  Temporal *temp = temporal_detoast(PG_GETARG_DATUM(0));
+  TRACE_MOBILITYDB_RESTRICT_START(PROBE_RESTRICT_PERIOD,
+    temporal_probe_count(temp), temporal_probe_size(temp));
   Period *p = PG_GETARG_PERIOD(1);
-  Temporal *result = temporal_restrict_period_internal(temp, p, atfunc);
-  PG_FREE_IF_COPY(temp, 0);
+  Temporal *result;
+  if (atfunc && MOBDB_FLAGS_GET_PACKED(temp->flags))
+    result = temporalpk_at_period((TemporalPacked *) temp, p);
+  else
+  {
+    temp = temporal_unpack(temp);
+    result = temporal_restrict_period_internal(temp, p, atfunc);
+  }
+  TRACE_MOBILITYDB_RESTRICT_DONE(PROBE_RESTRICT_PERIOD,
+    temporal_probe_count(result), temporal_probe_size(result));
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   if (result == NULL)
     PG_RETURN_NULL();
   PG_RETURN_POINTER(result);
@@ -3887,8 +4849,12 @@ Datum
 temporal_restrict_periodset(FunctionCallInfo fcinfo, bool atfunc)
 {
   Temporal *temp = PG_GETARG_TEMPORAL(0);
+  TRACE_MOBILITYDB_RESTRICT_START(PROBE_RESTRICT_PERIODSET,
+    temporal_probe_count(temp), temporal_probe_size(temp));
   PeriodSet *ps = PG_GETARG_PERIODSET(1);
   Temporal *result = temporal_restrict_periodset_internal(temp, ps, atfunc);
+  TRACE_MOBILITYDB_RESTRICT_DONE(PROBE_RESTRICT_PERIODSET,
+    temporal_probe_count(result), temporal_probe_size(result));
   PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(ps, 1);
   if (result == NULL)
@@ -3920,6 +4886,9 @@ temporal_minus_periodset(PG_FUNCTION_ARGS)
 
 /**
  * Restrict the temporal number to the temporal box (internal function)
+ *
+ * @note The function returns its argument rather than a copy of it when
+ * the restriction does not change the value
  */
 Temporal *
 tnumber_at_tbox_internal(const Temporal *temp, const TBOX *box)
@@ -3941,7 +4910,7 @@ tnumber_at_tbox_internal(const Temporal *temp, const TBOX *box)
     temp1 = temporal_at_period_internal(temp, &p);
   }
   else
-    temp1 = temporal_copy(temp);
+    temp1 = (Temporal *) temp;
 
   Temporal *result;
   if (MOBDB_FLAGS_GET_X(box->flags))
@@ -3959,7 +4928,8 @@ tnumber_at_tbox_internal(const Temporal *temp, const TBOX *box)
         Float8GetDatum(box->xmax), true, true, FLOAT8OID);
     result = tnumber_restrict_range_internal(temp1, range, true);
     pfree(DatumGetPointer(range));
-    pfree(temp1);
+    if (temp1 != temp)
+      pfree(temp1);
   }
   else
     result = temp1;
@@ -3973,6 +4943,8 @@ tnumber_at_tbox_internal(const Temporal *temp, const TBOX *box)
  * restrict at the period and then restrict to the range. Therefore, we
  * compute the atTbox and then compute the complement of the value obtained.
  *
+ * @note The function returns its argument rather than a copy of it when
+ * the restriction does not change the value
  */
 Temporal *
 tnumber_minus_tbox_internal(const Temporal *temp, const TBOX *box)
@@ -3982,7 +4954,7 @@ tnumber_minus_tbox_internal(const Temporal *temp, const TBOX *box)
   memset(&box1, 0, sizeof(TBOX));
   temporal_bbox(&box1, temp);
   if (!overlaps_tbox_tbox_internal(box, &box1))
-    return temporal_copy(temp);
+    return (Temporal *) temp;
 
   Temporal *result = NULL;
   Temporal *temp1 = tnumber_at_tbox_internal(temp, box);
@@ -3996,7 +4968,9 @@ tnumber_minus_tbox_internal(const Temporal *temp, const TBOX *box)
       result = temporal_restrict_periodset_internal(temp, ps, true);
       pfree(ps);
     }
-    pfree(temp1); pfree(ps1); pfree(ps2);
+    if (temp1 != temp)
+      pfree(temp1);
+    pfree(ps1); pfree(ps2);
   }
   return result;
 }
@@ -4011,7 +4985,7 @@ tnumber_restrict_tbox(FunctionCallInfo fcinfo, bool atfunc)
   TBOX *box = PG_GETARG_TBOX_P(1);
   Temporal *result = atfunc ? tnumber_at_tbox_internal(temp, box) :
     tnumber_minus_tbox_internal(temp, box);
-  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
   if (result == NULL)
     PG_RETURN_NULL();
   PG_RETURN_POINTER(result);
@@ -4543,4 +5517,40 @@ temporal_hash(PG_FUNCTION_ARGS)
   PG_RETURN_UINT32(result);
 }
 
+#if MOBDB_PGSQL_VERSION >= 110000
+/**
+ * Returns the 64-bit hash value of the temporal value using a seed
+ * (dispatch function)
+ */
+uint64
+temporal_hash_extended_internal(const Temporal *temp, uint64 seed)
+{
+  uint64 result;
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+    result = tinstant_hash_extended((TInstant *)temp, seed);
+  else if (temp->duration == INSTANTSET)
+    result = tinstantset_hash_extended((TInstantSet *)temp, seed);
+  else if (temp->duration == SEQUENCE)
+    result = tsequence_hash_extended((TSequence *)temp, seed);
+  else /* temp->duration == SEQUENCESET */
+    result = tsequenceset_hash_extended((TSequenceSet *)temp, seed);
+  return result;
+}
+
+PG_FUNCTION_INFO_V1(temporal_hash_extended);
+/**
+ * Returns the 64-bit hash value of the temporal value using a seed
+ */
+PGDLLEXPORT Datum
+temporal_hash_extended(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  uint64 seed = PG_GETARG_INT64(1);
+  uint64 result = temporal_hash_extended_internal(temp, seed);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_UINT64(result);
+}
+#endif
+
 /*****************************************************************************/
@@ -15,13 +15,16 @@
 #include <assert.h>
 #include <math.h>
 #include <string.h>
+#include <access/hash.h>
 #include <catalog/pg_collation.h>
 #include <libpq/pqformat.h>
+#include <miscadmin.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
-#include <executor/spi.h>
 #include <gsl/gsl_rng.h>
 
 #include "period.h"
+#include "periodset.h"
 #include "timeops.h"
 #include "temporaltypes.h"
 #include "oidcache.h"
@@ -29,13 +32,13 @@
 #include "tbool_boolops.h"
 #include "temporal_boxops.h"
 #include "doublen.h"
+#include "funcstat.h"
+#include "mobdb_probes.h"
+#include "tpoint_spatialfuncs.h"
 
 static TInstant **
 tinstant_tagg(TInstant **instants1, int count1, TInstant **instants2, 
   int count2, Datum (*func)(Datum, Datum), int *newcount);
-static TSequence **
-tsequence_tagg(TSequence **sequences1, int count1, TSequence **sequences2,
-  int count2, Datum (*func)(Datum, Datum), bool crossings, int *newcount);
 
 /*****************************************************************************
  * Functions manipulating skip lists
@@ -44,7 +47,7 @@ tsequence_tagg(TSequence **sequences1, int count1, TSequence **sequences2,
 /**
  * Switch to the memory context for aggregation  
  */
-static MemoryContext
+MemoryContext
 set_aggregation_context(FunctionCallInfo fcinfo)
 {
   MemoryContext ctx;
@@ -57,7 +60,7 @@ set_aggregation_context(FunctionCallInfo fcinfo)
 /**
  * Switch to the given memory context
  */
-static void
+void
 unset_aggregation_context(MemoryContext ctx)
 {
   MemoryContextSwitchTo(ctx);
@@ -65,54 +68,50 @@ unset_aggregation_context(MemoryContext ctx)
 }
 
 /**
- * Allocate memory for the skiplist
+ * Allocate an element of the given height in the skiplist
+ *
+ * Freed elements of the same height are reused first, otherwise the element
+ * is carved out of the current block of the skiplist, a new block being
+ * allocated in the aggregate memory context when it is full. Every new block
+ * doubles the size of the previous one up to SKIPLIST_BLOCK_MAX_SIZE.
  */
-static int
-skiplist_alloc(FunctionCallInfo fcinfo, SkipList *list)
+static Elem *
+skiplist_alloc(FunctionCallInfo fcinfo, SkipList *list, int height)
 {
   list->length ++;
-  if (! list->freecount)
+  Elem *result = list->freed[height - 1];
+  if (result != NULL)
   {
-    /* No free list, give first available entry */
-    if (list->next >= list->capacity)
-    {
-      /* No more capacity, let's grow */
-      list->capacity <<= SKIPLIST_GROW;
-      MemoryContext ctx = set_aggregation_context(fcinfo);
-      list->elems = repalloc(list->elems, sizeof(Elem) * list->capacity);
-      unset_aggregation_context(ctx);
-    }
-    list->next ++;
-    return list->next - 1;
+    list->freed[height - 1] = result->next[0];
+    return result;
   }
-  else 
+  size_t size = SKIPLIST_ELEM_SIZE(height);
+  if (list->blockfree < size)
   {
-    list->freecount --;
-    return list->freed[list->freecount];
+    size_t blocksize = list->blocksize == 0 ? SKIPLIST_BLOCK_INITIAL_SIZE :
+      Min(list->blocksize * 2, SKIPLIST_BLOCK_MAX_SIZE);
+    if (blocksize < size)
+      blocksize = size;
+    MemoryContext ctx = set_aggregation_context(fcinfo);
+    list->block = palloc(blocksize);
+    unset_aggregation_context(ctx);
+    list->blockfree = list->blocksize = blocksize;
   }
+  result = (Elem *) list->block;
+  list->block += size;
+  list->blockfree -= size;
+  return result;
 }
 
 /**
- * Free memory for the skiplist
+ * Free an element of the skiplist, which is kept for reuse by an element
+ * of the same height
  */
 static void
-skiplist_free(FunctionCallInfo fcinfo, SkipList *list, int cur)
+skiplist_free(SkipList *list, Elem *e)
 {
-  if (! list->freed)
-  {
-    list->freecap = SKIPLIST_INITIAL_FREELIST;
-    MemoryContext ctx = set_aggregation_context(fcinfo);
-    list->freed = palloc(sizeof(int) * list->freecap);
-    unset_aggregation_context(ctx);
-  }
-  else if (list->freecount == list->freecap)
-  {
-    list->freecap <<= 1;
-    MemoryContext ctx = set_aggregation_context(fcinfo);
-    list->freed = repalloc(list->freed, sizeof(int) * list->freecap);
-    unset_aggregation_context(ctx);
-  }
-  list->freed[list->freecount ++] = cur;
+  e->next[0] = list->freed[e->height - 1];
+  list->freed[e->height - 1] = e;
   list->length --;
   return;
 }
@@ -164,18 +163,18 @@ pos_period_timestamp(const Period *p, TimestampTz t)
  * Comparison function used for skiplists 
  */
 static RelativeTimePos 
-skiplist_elmpos(const SkipList *list, int cur, TimestampTz t)
+skiplist_elmpos(const SkipList *list, const Elem *cur, TimestampTz t)
 {
-  if (cur == 0)
+  if (cur == list->head)
     return AFTER; /* Head is -inf */
-  else if (cur == -1 || cur == list->tail)
+  else if (cur == NULL || cur == list->tail)
     return BEFORE; /* Tail is +inf */
   else
   {
-    if (list->elems[cur].value->duration == INSTANT)
-      return pos_timestamp_timestamp(((TInstant *)list->elems[cur].value)->t, t);
+    if (cur->value->duration == INSTANT)
+      return pos_timestamp_timestamp(((TInstant *)cur->value)->t, t);
     else
-      return pos_period_timestamp(&((TSequence *)list->elems[cur].value)->period, t);
+      return pos_period_timestamp(&((TSequence *)cur->value)->period, t);
   }
 }
 
@@ -190,11 +189,10 @@ skiplist_print(const SkipList *list)
   len += sprintf(buf+len, "digraph skiplist {\n");
   len += sprintf(buf+len, "\trankdir = LR;\n");
   len += sprintf(buf+len, "\tnode [shape = record];\n");
-  int cur = 0;
-  while (cur != -1)
+  Elem *e = list->head;
+  while (e != NULL)
   {
-    Elem *e = &list->elems[cur];
-    len += sprintf(buf+len, "\telm%d [label=\"", cur);
+    len += sprintf(buf+len, "\telm%p [label=\"", (void *) e);
     for (int l = e->height - 1; l > 0; l --)
     {
       len += sprintf(buf+len, "<p%d>|", l);
@@ -204,19 +202,20 @@ skiplist_print(const SkipList *list)
     else
       len += sprintf(buf+len, "<p0>%f\"];\n", 
         DatumGetFloat8(temporal_min_value_internal(e->value)));
-    if (e->next[0] != -1)
+    if (e->next[0] != NULL)
     {
       for (int l = 0; l < e->height; l ++)
       {
-        int next = e->next[l];
-        len += sprintf(buf+len, "\telm%d:p%d -> elm%d:p%d ", cur, l, next, l);
+        Elem *next = e->next[l];
+        len += sprintf(buf+len, "\telm%p:p%d -> elm%p:p%d ", (void *) e, l,
+          (void *) next, l);
         if (l == 0)
           len += sprintf(buf+len, "[weight=100];\n");
         else
           len += sprintf(buf+len, ";\n");
       }
     }
-    cur = e->next[0];
+    e = e->next[0];
   }
   sprintf(buf+len, "}\n");
   ereport(WARNING, (errcode(ERRCODE_WARNING), errmsg("SKIPLIST: %s", buf)));
@@ -251,7 +250,51 @@ static long int gsl_random48()
 static int
 random_level()
 {
-  return ffsl(~(gsl_random48() & ((1l << SKIPLIST_MAXLEVEL) - 1)));
+  int result = ffsl(~(gsl_random48() & ((1l << SKIPLIST_MAXLEVEL) - 1)));
+  return Min(result, SKIPLIST_MAXLEVEL);
+}
+
+/**
+ * Link copies of the temporal values between the head and the tail of the
+ * skiplist, which must not have other elements, in a balanced fashion
+ *
+ * @note This function must be called in the aggregate memory context
+ */
+static void
+skiplist_link(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
+  int count)
+{
+  assert(count > 0);
+  int height = (int) ceil(log2(count + 1));
+  list->head->height = list->tail->height = height;
+  for (int level = 0; level < SKIPLIST_MAXLEVEL; level ++)
+  {
+    list->head->next[level] = list->tail;
+    list->tail->next[level] = NULL;
+  }
+
+  /* The element at position i has a pointer at each level l such that i
+   * is a multiple of 2^l */
+  Elem **update = palloc(sizeof(Elem *) * height);
+  for (int level = 0; level < height; level ++)
+    update[level] = list->head;
+  for (int i = 1; i <= count; i ++)
+  {
+    int eheight = 1;
+    while (eheight < height && (i & ((1 << eheight) - 1)) == 0)
+      eheight ++;
+    Elem *e = skiplist_alloc(fcinfo, list, eheight);
+    e->value = temporal_copy(values[i - 1]);
+    e->height = eheight;
+    for (int level = 0; level < eheight; level ++)
+    {
+      update[level]->next[level] = e;
+      e->next[level] = list->tail;
+      update[level] = e;
+    }
+  }
+  pfree(update);
+  return;
 }
 
 /**
@@ -265,48 +308,18 @@ SkipList *
 skiplist_make(FunctionCallInfo fcinfo, Temporal **values, int count)
 {
   assert(count > 0);
-  //FIXME: tail should be a constant (e.g. 1) but is not, for ease of construction
 
   MemoryContext oldctx = set_aggregation_context(fcinfo);
-  int capacity = SKIPLIST_INITIAL_CAPACITY;
-  count += 2; /* Account for head and tail */
-  while (capacity <= count)
-    capacity <<= 1;
   SkipList *result = palloc0(sizeof(SkipList));
-  result->elems = palloc0(sizeof(Elem) * capacity);
-  int height = (int) ceil(log2(count - 1));
-  result->capacity = capacity;
-  result->next = count;
-  result->length = count - 2;
   result->extra = NULL;
   result->extrasize = 0;
 
-  /* Fill values first */
-  result->elems[0].value = NULL;
-  for (int i = 0; i < count - 2; i ++)
-    result->elems[i + 1].value = temporal_copy(values[i]);
-  result->elems[count - 1].value = NULL;
-  result->tail = count - 1;
-
-  /* Link the list in a balanced fashion */
-  for (int level = 0; level < height; level ++)
-  {
-    int step = 1 << level;
-    for (int i = 0; i < count; i += step)
-    {
-      int next = i + step < count ? i + step : count - 1;
-      if (i != count - 1)
-      {
-        result->elems[i].next[level] = next;
-        result->elems[i].height = level + 1;
-      }
-      else
-      {
-        result->elems[i].next[level] = - 1;
-        result->elems[i].height = height;
-      }
-    }
-  }
+  /* The head and the tail may grow up to the maximum height */
+  result->head = skiplist_alloc(fcinfo, result, SKIPLIST_MAXLEVEL);
+  result->tail = skiplist_alloc(fcinfo, result, SKIPLIST_MAXLEVEL);
+  result->head->value = result->tail->value = NULL;
+  skiplist_link(fcinfo, result, values, count);
+  result->length = count;
   unset_aggregation_context(oldctx);
   return result;
 }
@@ -317,7 +330,10 @@ skiplist_make(FunctionCallInfo fcinfo, Temporal **values, int count)
 Temporal *
 skiplist_headval(SkipList *list)
 {
-  return list->elems[list->elems[0].next[0]].value;
+  /* The values of a spilled skiplist are in its partitions */
+  if (list->spill)
+    return list->spill->sample;
+  return list->head->next[0]->value;
 }
 
 /*  Function not currently used
@@ -325,11 +341,10 @@ static Temporal *
 skiplist_tailval(SkipList *list)
 {
   // Despite the look, this is pretty much O(1)
-  int cur = 0;
-  Elem *e = &list->elems[cur];
+  Elem *e = list->head;
   int height = e->height;
   while (e->next[height - 1] != list->tail)
-    e = &list->elems[e->next[height - 1]];
+    e = e->next[height - 1];
   return e->value;
 }
 */
@@ -341,12 +356,12 @@ Temporal **
 skiplist_values(SkipList *list)
 {
   Temporal **result = palloc(sizeof(Temporal *) * list->length);
-  int cur = list->elems[0].next[0];
+  Elem *cur = list->head->next[0];
   int count = 0;
   while (cur != list->tail)
   {
-    result[count++] = list->elems[cur].value;
-    cur = list->elems[cur].next[0];
+    result[count++] = cur->value;
+    cur = cur->next[0];
   }
   return result;
 }
@@ -372,6 +387,7 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
    * everything has to be deleted) 
    */
   assert(list->length > 0);
+  FUNC_STAT_ADD(FUNC_STAT_SKIPLIST_SPLICES, 1);
   int16 duration = skiplist_headval(list)->duration;
   Period period;
   if (duration == INSTANT)
@@ -383,61 +399,56 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
       ((TSequence *)values[0])->period.lower_inc, 
       ((TSequence *)values[count - 1])->period.upper_inc);
 
-  int update[SKIPLIST_MAXLEVEL];
-  memset(update, 0, sizeof(update));
-  int cur = 0;
-  int height = list->elems[cur].height;
-  Elem *e = &list->elems[cur];
+  Elem *update[SKIPLIST_MAXLEVEL];
+  Elem *e = list->head;
+  int height = e->height;
   for (int level = height - 1; level >= 0; level --)
   {
-    while (e->next[level] != -1 && 
+    while (e->next[level] != NULL && 
       skiplist_elmpos(list, e->next[level], period.lower) == AFTER)
-    {
-      cur = e->next[level];
-      e = &list->elems[cur];
-    }
-    update[level] = cur;
+      e = e->next[level];
+    update[level] = e;
   }
 
-  int lower = e->next[0];
-  cur = lower;
-  e = &list->elems[cur];
+  Elem *lower = e->next[0];
+  e = lower;
 
   int spliced_count = 0;
-  while (skiplist_elmpos(list, cur, period.upper) == AFTER)
+  while (skiplist_elmpos(list, e, period.upper) == AFTER)
   {
-    cur = e->next[0];
-    e = &list->elems[cur];
+    e = e->next[0];
     spliced_count ++;
   }
-  int upper = cur;
-  if (upper >= 0 && skiplist_elmpos(list, upper, period.upper) == DURING)
+  Elem *upper = e;
+  if (upper != NULL && skiplist_elmpos(list, upper, period.upper) == DURING)
   {
     upper = e->next[0]; /* if found upper, one more to remove */
     spliced_count ++;
   }
 
   /* Delete spliced-out elements but remember their values for later */
-  cur = lower;
+  e = lower;
   Temporal **spliced = palloc(sizeof(Temporal *) * spliced_count);
   spliced_count = 0;
-  while (cur != upper && cur != -1)
+  while (e != upper && e != NULL)
   {
     for (int level = 0; level < height; level ++)
     {
-      Elem *prev = &list->elems[update[level]];
-      if (prev->next[level] != cur)
+      Elem *prev = update[level];
+      if (prev->next[level] != e)
         break;
-      prev->next[level] = list->elems[cur].next[level];
+      prev->next[level] = e->next[level];
     }
-    spliced[spliced_count++] = list->elems[cur].value;
-    skiplist_free(fcinfo, list, cur);
-    cur = list->elems[cur].next[0];
+    spliced[spliced_count++] = e->value;
+    /* The element is reused by the next allocation of the same height */
+    Elem *next = e->next[0];
+    skiplist_free(list, e);
+    e = next;
   }
 
   /* Level down head & tail if necessary */
-  Elem *head = &list->elems[0];
-  Elem *tail = &list->elems[list->tail];
+  Elem *head = list->head;
+  Elem *tail = list->tail;
   while (head->height > 1 && head->next[head->height - 1] == list->tail)
   {
     head->height--;
@@ -469,13 +480,12 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
     if (rheight > height)
     {
       for (int l = height; l < rheight; l ++)
-        update[l] = 0;
+        update[l] = head;
       /* Grow head and tail as appropriate */
       head->height = rheight;
       tail->height = rheight;
     }
-    int new = skiplist_alloc(fcinfo, list);
-    Elem *newelm = &list->elems[new];
+    Elem *newelm = skiplist_alloc(fcinfo, list, rheight);
     MemoryContext ctx = set_aggregation_context(fcinfo);
     newelm->value = temporal_copy(values[i]);
     unset_aggregation_context(ctx);
@@ -483,8 +493,8 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 
     for (int level = 0; level < rheight; level ++)
     {
-      newelm->next[level] = list->elems[update[level]].next[level];
-      list->elems[update[level]].next[level] = new;
+      newelm->next[level] = update[level]->next[level];
+      update[level]->next[level] = newelm;
       if (level >= height && update[0] != list->tail)
       {
         newelm->next[level] = list->tail;
@@ -616,31 +626,31 @@ datum_sum_double4(Datum l, Datum r)
 /**
  * Writes the state value into the buffer
  *
+ * The temporal values are written in their in-memory format, which does not
+ * contain pointers, so that they can be read back without parsing them.
+ * This format is only meant for exchanging the states between the processes
+ * of a parallel aggregation. Each value is padded so that the next one is
+ * maximally aligned with respect to the first one.
+ *
  * @param[in] state State
  * @param[in] buf Buffer
  */
 static void 
 aggstate_write(SkipList *state, StringInfo buf)
 {
+  static const char padding[MAXIMUM_ALIGNOF] = {0};
   Temporal **values = skiplist_values(state);
 #if MOBDB_PGSQL_VERSION < 110000
   pq_sendint(buf, (uint32) state->length, 4);
 #else
   pq_sendint32(buf, (uint32) state->length);
-#endif
-  Oid valuetypid = InvalidOid;
-  if (state->length > 0)
-    valuetypid = values[0]->valuetypid;
-#if MOBDB_PGSQL_VERSION < 110000
-  pq_sendint(buf, valuetypid, 4);
-#else
-  pq_sendint32(buf, valuetypid);
 #endif
   for (int i = 0; i < state->length; i ++)
   {
-    SPI_connect();
-    temporal_write(values[i], buf);
-    SPI_finish();
+    size_t size = VARSIZE(values[i]);
+    pq_sendbytes(buf, (char *) values[i], (int) size);
+    if (MAXALIGN(size) != size)
+      pq_sendbytes(buf, padding, (int) (MAXALIGN(size) - size));
   }
   pq_sendint64(buf, state->extrasize);
   if (state->extra)
@@ -652,6 +662,10 @@ aggstate_write(SkipList *state, StringInfo buf)
 /**
  * Reads the state value from the buffer
  *
+ * The values are used in place since they are copied by skiplist_make,
+ * unless the buffer is not maximally aligned, in which case they are
+ * copied to aligned memory before being read.
+ *
  * @param[in] fcinfo Catalog information about the external function
  * @param[in] buf Buffer
  */
@@ -659,19 +673,33 @@ static SkipList *
 aggstate_read(FunctionCallInfo fcinfo, StringInfo buf)
 {
   int size = pq_getmsgint(buf, 4);
-  Oid valuetypid = pq_getmsgint(buf, 4);
-  Temporal **values = palloc0(sizeof(Temporal *) * size);
+  Temporal **values = palloc(sizeof(Temporal *) * size);
+  /* The values are padded so that they are all aligned if the first is */
+  const char *first = buf->data + buf->cursor;
+  bool aligned = (first == (const char *) MAXALIGN(first));
   for (int i = 0; i < size; i ++)
-    values[i] = temporal_read(buf, valuetypid);
+  {
+    const char *data = buf->data + buf->cursor;
+    uint32 len = VARSIZE(data);
+    pq_getmsgbytes(buf, (int) MAXALIGN(len));
+    if (aligned)
+      values[i] = (Temporal *) data;
+    else
+    {
+      values[i] = palloc(len);
+      memcpy(values[i], data, len);
+    }
+  }
   SkipList *result = skiplist_make(fcinfo, values, size);
+  if (! aligned)
+    for (int i = 0; i < size; i ++)
+      pfree(values[i]);
   size_t extrasize = (size_t) pq_getmsgint64(buf);
   if (extrasize)
   {
     const char *extra = pq_getmsgbytes(buf, (int) extrasize);
     aggstate_set_extra(fcinfo, result, (void *)extra, extrasize);
   }
-  for (int i = 0; i < size; i ++)
-    pfree(values[i]);
   pfree(values);
   return result;
 }
@@ -705,6 +733,8 @@ PGDLLEXPORT Datum
 temporal_tagg_serialize(PG_FUNCTION_ARGS)
 {
   SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  skiplist_flush(fcinfo, state);
+  skiplist_unspill(fcinfo, state);
   StringInfoData buf;
   pq_begintypsend(&buf);
   aggstate_write(state, &buf);
@@ -723,8 +753,8 @@ temporal_tagg_deserialize(PG_FUNCTION_ARGS)
   {
     .cursor = 0,
     .data = VARDATA(data),
-    .len = VARSIZE(data),
-    .maxlen = VARSIZE(data)
+    .len = VARSIZE(data) - VARHDRSZ,
+    .maxlen = VARSIZE(data) - VARHDRSZ
   };
   SkipList *result = aggstate_read(fcinfo, &buf);
   PG_RETURN_POINTER(result);
@@ -771,7 +801,9 @@ tinstant_tagg(TInstant **instants1, int count1, TInstant **instants2,
       j++;
     }
   }
-  /* Copy the instants from state2 that are after the end of state1 */
+  /* Copy the instants that are after the end of the other array */
+  while (i < count1)
+    result[count++] = tinstant_copy(instants1[i++]);
   while (j < count2)
     result[count++] = tinstant_copy(instants2[j++]);
   *newcount = count;
@@ -906,6 +938,12 @@ tsequence_tagg1(TSequence **result,  const TSequence *seq1, const TSequence *seq
     result[0] = sequences[0];
     return 1;
   }
+  if (tsequencearr_normalized(sequences, k))
+  {
+    for (int i = 0; i < k; i++)
+      result[i] = sequences[i];
+    return k;
+  }
   int count;
   TSequence **normsequences = tsequencearr_normalize(sequences, k, &count);
   for (int i = 0; i < k; i++)
@@ -929,7 +967,7 @@ tsequence_tagg1(TSequence **result,  const TSequence *seq1, const TSequence *seq
  * @param[in] newcount Number of elements in the result
  * @note Returns new sequences that must be freed by the calling function.
  */
-static TSequence **
+TSequence **
 tsequence_tagg(TSequence **sequences1, int count1, TSequence **sequences2, 
   int count2, Datum (*func)(Datum, Datum), bool crossings, int *newcount)
 {
@@ -997,6 +1035,11 @@ tsequence_tagg(TSequence **sequences1, int count1, TSequence **sequences2,
     *newcount = 1;
     return result;
   }
+  if (tsequencearr_normalized(sequences, k))
+  {
+    *newcount = k;
+    return sequences;
+  }
   int count;
   TSequence **result = tsequencearr_normalize(sequences, k, &count);
   for (i = 0; i < k; i++)
@@ -1007,370 +1050,2215 @@ tsequence_tagg(TSequence **sequences1, int count1, TSequence **sequences2,
 }
 
 /*****************************************************************************
- * Generic aggregate transition functions
+ * Batch aggregation of the pending values of skiplists
  *****************************************************************************/
 
 /**
- * Generic transition function for aggregating temporal values
- * of instant duration
- *
- * @param[in] fcinfo Catalog information about the external function
- * @param[inout] state Skiplist containing the state
- * @param[in] inst Temporal value
- * @param[in] func Function
+ * Return the number of components of the doubleN type summed by the
+ * function, or 0 if the function is not a sum of doubleN values
  */
-static SkipList *
-tinstant_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state,
-  const TInstant *inst, Datum (*func)(Datum, Datum))
+static int
+doublen_sum_dim(Datum (*func)(Datum, Datum))
 {
-  SkipList *result;
-  if (! state)
-    result = skiplist_make(fcinfo, (Temporal **)&inst, 1);
-  else
-  {
-    if (skiplist_headval(state)->duration != INSTANT)
-      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-        errmsg("Cannot aggregate temporal values of different duration")));
-    skiplist_splice(fcinfo, state, (Temporal **)&inst, 1, func, false);
-    result = state;
-  }
-  return result;
+  if (func == &datum_sum_double2)
+    return 2;
+  if (func == &datum_sum_double3)
+    return 3;
+  if (func == &datum_sum_double4)
+    return 4;
+  return 0;
 }
 
 /**
- * Generic transition function for aggregating temporal values
- * of instant set duration
+ * Sum the doubleN values of the run of temporal instants, which are freed,
+ * into a single instant
  *
- * @param[in] fcinfo Catalog information about the external function
- * @param[inout] state Skiplist containing the state
- * @param[in] ti Temporal value
- * @param[in] func Function
+ * The components are accumulated in arrays of doubles with the compensated
+ * summation of Neumaier, which avoids both a new value for every addition
+ * and the loss of precision of long sums of coordinates.
  */
-static SkipList *
-tinstantset_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
-  const TInstantSet *ti, Datum (*func)(Datum, Datum))
+static TInstant *
+tinstant_doublen_sum(TInstant **instants, int count, int dim)
 {
-  TInstant **instants = tinstantset_instants(ti);
-  SkipList *result;
-  if (! state)
-    result = skiplist_make(fcinfo, (Temporal **)instants, ti->count);
-  else
+  double sum[4] = {0}, comp[4] = {0};
+  for (int i = 0; i < count; i++)
   {
-    if (skiplist_headval(state)->duration != INSTANT)
-      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-        errmsg("Cannot aggregate temporal values of different duration")));
-    skiplist_splice(fcinfo, state, (Temporal **)instants, ti->count, func, false);
-    result = state;
+    const double *value = (double *) DatumGetPointer(
+      tinstant_value(instants[i]));
+    for (int j = 0; j < dim; j++)
+    {
+      double t = sum[j] + value[j];
+      if (fabs(sum[j]) >= fabs(value[j]))
+        comp[j] += (sum[j] - t) + value[j];
+      else
+        comp[j] += (value[j] - t) + sum[j];
+      sum[j] = t;
+    }
   }
-  pfree(instants);
+  for (int j = 0; j < dim; j++)
+    sum[j] += comp[j];
+  /* The components of the doubleN types are contiguous doubles */
+  TInstant *result = tinstant_make(PointerGetDatum(sum), instants[0]->t,
+    instants[0]->valuetypid);
+  for (int i = 0; i < count; i++)
+    pfree(instants[i]);
   return result;
 }
 
 /**
- * Generic transition function for aggregating temporal values
- * of sequence duration
+ * Aggregate the array of temporal instants, which are freed
  *
- * @param[in] fcinfo Catalog information about the external function
- * @param[inout] state Skiplist containing the state
- * @param[in] seq Temporal value
- * @param[in] func Function
- * @param[in] crossings State whether turning points are added in the segments
+ * The instants are sorted and the values of the instants with the same
+ * timestamp are then aggregated in a single pass. The runs of doubleN
+ * values of the average and centroid aggregates are summed at once.
  */
-SkipList *
-tsequence_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
-  TSequence *seq, Datum (*func)(Datum, Datum), bool crossings)
+static TInstant **
+tinstant_tagg_batch(TInstant **instants, int count,
+  Datum (*func)(Datum, Datum), int *newcount)
 {
-  SkipList *result;
-  if (! state)
-    result = skiplist_make(fcinfo, (Temporal **)&seq, 1);
-  else
+  tinstantarr_sort(instants, count);
+  TInstant **result = palloc(sizeof(TInstant *) * count);
+  int dim = doublen_sum_dim(func);
+  int k = 0;
+  for (int i = 0; i < count; i++)
   {
-    if (skiplist_headval(state)->duration != SEQUENCE)
-      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-        errmsg("Cannot aggregate temporal values of different duration")));
-    if (MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state)->flags) != 
-        MOBDB_FLAGS_GET_LINEAR(seq->flags))
-      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-        errmsg("Cannot aggregate temporal values of different interpolation")));
-    skiplist_splice(fcinfo, state, (Temporal **)&seq, 1, func, crossings);
-    result = state;
+    if (dim > 0)
+    {
+      int j = i + 1;
+      while (j < count && instants[j]->t == instants[i]->t)
+        j++;
+      result[k++] = (j - i == 1) ? instants[i] :
+        tinstant_doublen_sum(&instants[i], j - i, dim);
+      i = j - 1;
+    }
+    else if (k > 0 && result[k - 1]->t == instants[i]->t)
+    {
+      TInstant *inst = tinstant_make(func(tinstant_value(result[k - 1]),
+        tinstant_value(instants[i])), instants[i]->t,
+        instants[i]->valuetypid);
+      pfree(result[k - 1]); pfree(instants[i]);
+      result[k - 1] = inst;
+    }
+    else
+      result[k++] = instants[i];
   }
+  *newcount = k;
   return result;
 }
 
 /**
- * Generic transition function for aggregating temporal values
- * of sequence set duration
+ * Aggregate the array of temporal sequences, which are freed
  *
- * @param[in] fcinfo Catalog information about the external function
- * @param[inout] state Skiplist containing the state
- * @param[in] ts Temporal value
- * @param[in] func Function
- * @param[in] crossings State whether turning points are added in the segments
+ * The sequences are sorted by their period and then aggregated by merging
+ * pairwise adjacent runs of sequences, each sequence being initially a run,
+ * until a single run remains. Since the runs that are merged are close in
+ * time, the cost of each level of merges is linear in the number of
+ * sequences instead of in the size of the whole aggregation.
  */
-static SkipList *
-tsequenceset_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
-  const TSequenceSet *ts, Datum (*func)(Datum, Datum), bool crossings)
+static TSequence **
+tsequence_tagg_batch(TSequence **sequences, int count,
+  Datum (*func)(Datum, Datum), bool crossings, int *newcount)
 {
-  TSequence **sequences = tsequenceset_sequences(ts);
-  SkipList *result;
-  if (! state)
-    result = skiplist_make(fcinfo, (Temporal **)sequences, ts->count);
-  else
+  tsequencearr_sort(sequences, count);
+  TSequence ***runs = palloc(sizeof(TSequence **) * count);
+  int *runcounts = palloc(sizeof(int) * count);
+  for (int i = 0; i < count; i++)
   {
-    if (skiplist_headval(state)->duration != SEQUENCE)
-      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-        errmsg("Cannot aggregate temporal values of different duration")));
-    if (MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state)->flags) !=
-        MOBDB_FLAGS_GET_LINEAR(ts->flags))
-      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-        errmsg("Cannot aggregate temporal values of different interpolation")));
-    skiplist_splice(fcinfo, state, (Temporal **)sequences, ts->count, func, crossings);
-    result = state;
+    runs[i] = palloc(sizeof(TSequence *));
+    runs[i][0] = sequences[i];
+    runcounts[i] = 1;
   }
-  pfree(sequences);
+  int nruns = count;
+  while (nruns > 1)
+  {
+    int k = 0;
+    for (int i = 0; i < nruns; i += 2)
+    {
+      if (i == nruns - 1)
+      {
+        runs[k] = runs[i];
+        runcounts[k++] = runcounts[i];
+        continue;
+      }
+      int runcount;
+      TSequence **run = tsequence_tagg(runs[i], runcounts[i], runs[i + 1],
+        runcounts[i + 1], func, crossings, &runcount);
+      for (int j = i; j <= i + 1; j++)
+      {
+        for (int l = 0; l < runcounts[j]; l++)
+          pfree(runs[j][l]);
+        pfree(runs[j]);
+      }
+      runs[k] = run;
+      runcounts[k++] = runcount;
+    }
+    nruns = k;
+  }
+  TSequence **result = runs[0];
+  *newcount = runcounts[0];
+  pfree(runs); pfree(runcounts);
   return result;
 }
 
 /*****************************************************************************
- * Generic aggregate functions for TInstant and TSequence
+ * Spilling of skiplists to temporary files
+ *
+ * Since the aggregation of temporal values decomposes along time, a
+ * skiplist that exceeds work_mem is spilled to temporary files, each one
+ * keeping the values during a time range. The values that cross the
+ * bounds of the time ranges are split at these bounds. The partitions
+ * are then aggregated and finalized one at a time, and a partition that
+ * still exceeds work_mem is split in two before being read.
  *****************************************************************************/
 
 /**
- * Generic transition function for aggregating temporal values
- *
- * @param[in] fcinfo Catalog information about the external function
- * @param[in] func Aggregate function
- * @param[in] crossings State whether turning points are added in the segments
+ * Returns the approximate size in bytes of the values of the skiplist
  */
-static Datum
-temporal_tagg_transfn(FunctionCallInfo fcinfo, Datum (*func)(Datum, Datum),
-  bool crossings)
+static size_t
+skiplist_size(const SkipList *list)
 {
-  SkipList *state = PG_ARGISNULL(0) ? NULL :
-    (SkipList *) PG_GETARG_POINTER(0);
-  if (PG_ARGISNULL(1))
+  size_t result = 0;
+  Elem *cur = list->head->next[0];
+  while (cur != list->tail)
   {
-    if (state)
-      PG_RETURN_POINTER(state);
-    else
-      PG_RETURN_NULL();
+    result += VARSIZE(cur->value) + SKIPLIST_ELEM_SIZE(cur->height);
+    cur = cur->next[0];
   }
-  
-  Temporal *temp = PG_GETARG_TEMPORAL(1);
-  ensure_valid_duration(temp->duration);
-  SkipList *result;
-  if (temp->duration == INSTANT) 
-    result =  tinstant_tagg_transfn(fcinfo, state, (TInstant *)temp, 
-      func);
-  else if (temp->duration == INSTANTSET) 
-    result =  tinstantset_tagg_transfn(fcinfo, state, (TInstantSet *)temp, 
-      func);
-  else if (temp->duration == SEQUENCE) 
-    result =  tsequence_tagg_transfn(fcinfo, state, (TSequence *)temp, 
-      func, crossings);
-  else /* temp->duration == SEQUENCESET */
-    result = tsequenceset_tagg_transfn(fcinfo, state, (TSequenceSet *)temp, 
-      func, crossings);
-  PG_FREE_IF_COPY(temp, 1);
-  PG_RETURN_POINTER(result);
+  return result;
 }
 
 /**
- * Generic combine function for aggregating temporal values
- * 
- * @param[in] fcinfo Catalog information about the external function
- * @param[in] state1, state2 State values
- * @param[in] func Aggregate function
- * @param[in] crossings State whether turning points are added in the segments
- * @note This function is called for aggregating temporal points and thus
- * after checking the dimensionality and the SRID of the values 
+ * Initialize a partition of a spilled skiplist
  */
-SkipList *
-temporal_tagg_combinefn1(FunctionCallInfo fcinfo, SkipList *state1, 
-  SkipList *state2, Datum (*func)(Datum, Datum), bool crossings)
+static void
+skiplist_part_init(SkipListPart *part)
 {
-  if (! state1)
-    return state2;
-  if (! state2)
-    return state1;
-
-  if (skiplist_headval(state1)->duration != skiplist_headval(state2)->duration)
-    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-      errmsg("Cannot aggregate temporal values of different duration")));
-  if (MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state1)->flags) != 
-      MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state2)->flags))
-    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-      errmsg("Cannot aggregate temporal values of different interpolation")));
-
-  int count2 = state2->length;
-  Temporal **values2 = skiplist_values(state2);
-  skiplist_splice(fcinfo, state1, values2, count2, func, crossings);
-  pfree(values2);
-  return state1;
+  part->file = BufFileCreateTemp(false);
+  part->size = 0;
+  part->fileno = 0;
+  part->offset = 0;
+  part->lower = DT_NOEND;
+  part->upper = DT_NOBEGIN;
+  return;
 }
 
 /**
- * Generic combine function for aggregating temporal alphanumber values
- *
- * @param[in] fcinfo Catalog information about the external function
- * @param[in] func Function
- * @param[in] crossings State whether turning points are added in the segments
+ * Append the temporal value to the partition
  */
-Datum
-temporal_tagg_combinefn(FunctionCallInfo fcinfo, Datum (*func)(Datum, Datum), 
-  bool crossings)
+static void
+skiplist_part_write(SkipListPart *part, const Temporal *temp)
+{
+  uint32 size = VARSIZE(temp);
+#if MOBDB_PGSQL_VERSION >= 160000
+  /* BufFileWrite raises the error itself */
+  BufFileWrite(part->file, &size, sizeof(uint32));
+  BufFileWrite(part->file, (void *) temp, size);
+#else
+  if (BufFileWrite(part->file, &size, sizeof(uint32)) != sizeof(uint32) ||
+      BufFileWrite(part->file, (void *) temp, size) != size)
+    ereport(ERROR, (errcode_for_file_access(),
+      errmsg("could not write to temporary file: %m")));
+#endif
+  part->size += sizeof(uint32) + size;
+  Period p;
+  temporal_period(&p, temp);
+  part->lower = Min(part->lower, p.lower);
+  part->upper = Max(part->upper, p.upper);
+  return;
+}
+
+/**
+ * Returns the index of the partition of the spilled skiplist containing
+ * the timestamp
+ */
+static int
+skiplist_part_index(const SkipListSpill *spill, TimestampTz t)
+{
+  int first = 0, last = spill->count - 1;
+  /* Number of bounds that are less than or equal to the timestamp */
+  while (first < last)
+  {
+    int middle = (first + last) / 2;
+    if (spill->bounds[middle] <= t)
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  return first;
+}
+
+/**
+ * Write the temporal value in the partitions of the spilled skiplist,
+ * splitting it at the bounds of the partitions
+ */
+static void
+skiplist_spill_write(SkipListSpill *spill, const Temporal *temp)
+{
+  if (temp->duration == INSTANT)
+  {
+    TInstant *inst = (TInstant *) temp;
+    skiplist_part_write(&spill->parts[skiplist_part_index(spill, inst->t)],
+      temp);
+    return;
+  }
+
+  TSequence *seq = (TSequence *) temp;
+  int first = skiplist_part_index(spill, seq->period.lower);
+  int last = skiplist_part_index(spill, seq->period.upper);
+  if (last > first && ! seq->period.upper_inc &&
+      spill->bounds[last - 1] == seq->period.upper)
+    last--;
+  if (first == last)
+  {
+    skiplist_part_write(&spill->parts[first], temp);
+    return;
+  }
+  for (int i = first; i <= last; i++)
+  {
+    Period p;
+    period_set(&p, 
+      (i == first) ? seq->period.lower : spill->bounds[i - 1],
+      (i == last) ? seq->period.upper : spill->bounds[i],
+      (i == first) ? seq->period.lower_inc : true,
+      (i == last) ? seq->period.upper_inc : false);
+    TSequence *part = tsequence_at_period(seq, &p);
+    if (part)
+    {
+      skiplist_part_write(&spill->parts[i], (Temporal *) part);
+      pfree(part);
+    }
+  }
+  return;
+}
+
+/**
+ * Close the temporary files of the partitions of a spilled skiplist
+ */
+static void
+skiplist_spill_close(SkipListSpill *spill)
+{
+  for (int i = 0; i < spill->count; i++)
+    BufFileClose(spill->parts[i].file);
+  return;
+}
+
+/**
+ * Callback closing the temporary files of a spilled skiplist when its 
+ * aggregate memory context is reset or deleted
+ *
+ * @note The files cannot be closed by the final functions since they may
+ * be called several times on the same state, e.g., for moving aggregates
+ */
+static void
+skiplist_spill_callback(void *arg)
+{
+  SkipList *list = (SkipList *) arg;
+  if (list->spill)
+  {
+    skiplist_spill_close(list->spill);
+    list->spill = NULL;
+  }
+  return;
+}
+
+/**
+ * Spill the values of the skiplist to partitions whose bounds split the
+ * values of the skiplist in parts of the same size
+ */
+static void
+skiplist_spill(FunctionCallInfo fcinfo, SkipList *list)
+{
+  Temporal **values = skiplist_values(list);
+  int count = list->length;
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  if (list->spillcb == NULL)
+  {
+    /* The callback is allocated and registered in the aggregate context */
+    list->spillcb = palloc(sizeof(MemoryContextCallback));
+    list->spillcb->func = &skiplist_spill_callback;
+    list->spillcb->arg = (void *) list;
+    MemoryContextRegisterResetCallback(CurrentMemoryContext, list->spillcb);
+  }
+  SkipListSpill *spill = palloc(sizeof(SkipListSpill));
+  spill->bounds = palloc(sizeof(TimestampTz) * SKIPLIST_SPILL_PARTITIONS);
+  int nbounds = 0;
+  for (int i = 1; i < SKIPLIST_SPILL_PARTITIONS; i++)
+  {
+    Period p;
+    temporal_period(&p, values[(int) ((int64) count * i / 
+      SKIPLIST_SPILL_PARTITIONS)]);
+    if (nbounds == 0 || spill->bounds[nbounds - 1] < p.lower)
+      spill->bounds[nbounds++] = p.lower;
+  }
+  spill->count = nbounds + 1;
+  spill->parts = palloc(sizeof(SkipListPart) * spill->count);
+  for (int i = 0; i < spill->count; i++)
+    skiplist_part_init(&spill->parts[i]);
+  spill->sample = temporal_copy(values[0]);
+  for (int i = 0; i < count; i++)
+    skiplist_spill_write(spill, values[i]);
+  unset_aggregation_context(ctx);
+
+  /* Empty the skiplist, whose elements are kept for reuse */
+  Elem *cur = list->head->next[0];
+  while (cur != list->tail)
+  {
+    Elem *next = cur->next[0];
+    pfree(cur->value);
+    skiplist_free(list, cur);
+    cur = next;
+  }
+  for (int level = 0; level < SKIPLIST_MAXLEVEL; level ++)
+    list->head->next[level] = list->tail;
+  list->spill = spill;
+  pfree(values);
+  return;
+}
+
+/**
+ * Position the partition at its beginning for reading its values
+ */
+static void
+skiplist_part_rewind(SkipListPart *part)
+{
+  BufFileTell(part->file, &part->fileno, &part->offset);
+  if (BufFileSeek(part->file, 0, 0L, SEEK_SET) != 0)
+    ereport(ERROR, (errcode_for_file_access(),
+      errmsg("could not seek in temporary file: %m")));
+  return;
+}
+
+/**
+ * Position the partition at its end for appending new values
+ */
+static void
+skiplist_part_end(SkipListPart *part)
+{
+  if (BufFileSeek(part->file, part->fileno, part->offset, SEEK_SET) != 0)
+    ereport(ERROR, (errcode_for_file_access(),
+      errmsg("could not seek in temporary file: %m")));
+  return;
+}
+
+/**
+ * Read the next temporal value of the partition, returns NULL at the end
+ */
+static Temporal *
+skiplist_part_read(SkipListPart *part)
+{
+  uint32 size;
+  size_t nread = BufFileRead(part->file, &size, sizeof(uint32));
+  if (nread == 0)
+    return NULL;
+  Temporal *result = (nread == sizeof(uint32)) ? palloc(size) : NULL;
+  if (result == NULL || BufFileRead(part->file, result, size) != size)
+    ereport(ERROR, (errcode_for_file_access(),
+      errmsg("could not read from temporary file: %m")));
+  return result;
+}
+
+/**
+ * Split the partition i of the spilled skiplist in two partitions at the
+ * middle of the time span of its values
+ */
+static void
+skiplist_part_split(FunctionCallInfo fcinfo, SkipListSpill *spill, int i)
+{
+  SkipListPart *part = &spill->parts[i];
+  TimestampTz middle = part->lower + (part->upper - part->lower) / 2;
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  SkipListSpill split;
+  split.count = 2;
+  split.bounds = &middle;
+  split.parts = palloc(sizeof(SkipListPart) * 2);
+  skiplist_part_init(&split.parts[0]);
+  skiplist_part_init(&split.parts[1]);
+  skiplist_part_rewind(part);
+  Temporal *temp;
+  while ((temp = skiplist_part_read(part)) != NULL)
+  {
+    skiplist_spill_write(&split, temp);
+    pfree(temp);
+  }
+  BufFileClose(part->file);
+
+  spill->bounds = repalloc(spill->bounds, sizeof(TimestampTz) * spill->count);
+  memmove(&spill->bounds[i + 1], &spill->bounds[i],
+    sizeof(TimestampTz) * (spill->count - 1 - i));
+  spill->bounds[i] = middle;
+  spill->parts = repalloc(spill->parts,
+    sizeof(SkipListPart) * (spill->count + 1));
+  memmove(&spill->parts[i + 2], &spill->parts[i + 1],
+    sizeof(SkipListPart) * (spill->count - 1 - i));
+  spill->parts[i] = split.parts[0];
+  spill->parts[i + 1] = split.parts[1];
+  spill->count++;
+  pfree(split.parts);
+  unset_aggregation_context(ctx);
+  return;
+}
+
+/**
+ * Returns the aggregated values of the partition i of the spilled skiplist
+ *
+ * @note The partition is split beforehand while it exceeds work_mem, the
+ * time span of its values can be split, and the number of partitions is
+ * less than SKIPLIST_SPILL_MAX_PARTITIONS
+ */
+static Temporal **
+skiplist_part_values(FunctionCallInfo fcinfo, SkipList *list, int i,
+  int *count)
+{
+  SkipListSpill *spill = list->spill;
+  /* The number of partitions is capped since each one keeps a buffer */
+  while (spill->parts[i].size > (size_t) work_mem * 1024L &&
+    spill->parts[i].upper - spill->parts[i].lower >= 2 &&
+    spill->count < SKIPLIST_SPILL_MAX_PARTITIONS)
+    skiplist_part_split(fcinfo, spill, i);
+
+  SkipListPart *part = &spill->parts[i];
+  if (part->size == 0)
+  {
+    *count = 0;
+    return NULL;
+  }
+  int maxcount = 64, k = 0;
+  Temporal **values = palloc(sizeof(Temporal *) * maxcount);
+  skiplist_part_rewind(part);
+  Temporal *temp;
+  while ((temp = skiplist_part_read(part)) != NULL)
+  {
+    if (k == maxcount)
+    {
+      maxcount <<= 1;
+      values = repalloc(values, sizeof(Temporal *) * maxcount);
+    }
+    values[k++] = temp;
+  }
+  skiplist_part_end(part);
+  Temporal **result = (values[0]->duration == INSTANT) ?
+    (Temporal **) tinstant_tagg_batch((TInstant **) values, k, list->func,
+      count) :
+    (Temporal **) tsequence_tagg_batch((TSequence **) values, k, list->func,
+      list->crossings, count);
+  pfree(values);
+  return result;
+}
+
+/**
+ * Read back the values of a spilled skiplist into memory
+ *
+ * @note This function is called before serializing or combining the 
+ * states of parallel aggregations, which are kept in memory
+ */
+void
+skiplist_unspill(FunctionCallInfo fcinfo, SkipList *list)
+{
+  if (! list->spill)
+    return;
+  SkipListSpill *spill = list->spill;
+  int count = 0, maxcount = 64;
+  Temporal **values = palloc(sizeof(Temporal *) * maxcount);
+  for (int i = 0; i < spill->count; i++)
+  {
+    int partcount;
+    Temporal **partvalues = skiplist_part_values(fcinfo, list, i, &partcount);
+    if (partcount == 0)
+      continue;
+    if (count + partcount > maxcount)
+    {
+      while (count + partcount > maxcount)
+        maxcount <<= 1;
+      values = repalloc(values, sizeof(Temporal *) * maxcount);
+    }
+    memcpy(&values[count], partvalues, sizeof(Temporal *) * partcount);
+    count += partcount;
+    pfree(partvalues);
+  }
+  skiplist_spill_close(spill);
+  /* The values of the partitions are disjoint and in time order, the 
+   * skiplist is rebuilt from them keeping the other fields of its state */
+  SkipList *newlist = skiplist_make(fcinfo, values, count);
+  list->length = newlist->length;
+  list->head = newlist->head;
+  list->tail = newlist->tail;
+  list->block = newlist->block;
+  list->blockfree = newlist->blockfree;
+  list->blocksize = newlist->blocksize;
+  memcpy(list->freed, newlist->freed, sizeof(list->freed));
+  list->spill = NULL;
+  pfree(newlist);
+  for (int i = 0; i < count; i++)
+    pfree(values[i]);
+  pfree(values);
+  pfree(spill->sample); pfree(spill->bounds); pfree(spill->parts);
+  pfree(spill);
+  return;
+}
+
+/**
+ * Returns the final result of the aggregation of the skiplist
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] list Skiplist
+ * @param[in] func Final function applied to an array of aggregated values,
+ * which returns a temporal instant set or a temporal sequence set value
+ * @param[in] arg Additional argument of the final function
+ * @note The final function is applied to each partition of a spilled
+ * skiplist and the results are then merged. The result is NULL when the
+ * skiplist is empty or when the final function returns NULL for all parts.
+ * The temporary files of the partitions are kept since the state may be
+ * finalized again, they are closed when the aggregate context is reset.
+ */
+Temporal *
+skiplist_finalize(FunctionCallInfo fcinfo, SkipList *list,
+  Temporal *(*func)(Temporal **, int, void *), void *arg)
+{
+  skiplist_flush(fcinfo, list);
+  if (! list->spill)
+  {
+    if (list->length == 0)
+      return NULL;
+    Temporal **values = skiplist_values(list);
+    Temporal *result = func(values, list->length, arg);
+    pfree(values);
+    return result;
+  }
+
+  int count = 0, maxcount = 64;
+  void **elems = palloc(sizeof(void *) * maxcount);
+  int16 duration = INSTANTSET;
+  /* The list of partitions may grow when a partition is split */
+  for (int i = 0; i < list->spill->count; i++)
+  {
+    int partcount;
+    Temporal **values = skiplist_part_values(fcinfo, list, i, &partcount);
+    if (partcount == 0)
+      continue;
+    Temporal *part = func(values, partcount, arg);
+    for (int j = 0; j < partcount; j++)
+      pfree(values[j]);
+    pfree(values);
+    if (part == NULL)
+      continue;
+    duration = part->duration;
+    int n = (duration == INSTANTSET) ? ((TInstantSet *) part)->count :
+      ((TSequenceSet *) part)->count;
+    if (count + n > maxcount)
+    {
+      while (count + n > maxcount)
+        maxcount <<= 1;
+      elems = repalloc(elems, sizeof(void *) * maxcount);
+    }
+    for (int j = 0; j < n; j++)
+      elems[count++] = (duration == INSTANTSET) ?
+        (void *) tinstant_copy(tinstantset_inst_n((TInstantSet *) part, j)) :
+        (void *) tsequence_copy(tsequenceset_seq_n((TSequenceSet *) part, j));
+    pfree(part);
+  }
+  if (count == 0)
+  {
+    pfree(elems);
+    return NULL;
+  }
+  /* The parts of the values split at the bounds of the partitions are 
+   * joined back by the normalization */
+  return (duration == INSTANTSET) ?
+    (Temporal *) tinstantset_make_free((TInstant **) elems, count) :
+    (Temporal *) tsequenceset_make_free((TSequence **) elems, count, NORMALIZE);
+}
+
+/**
+ * Add the array of temporal values to the pending values of the skiplist
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[inout] list Skiplist
+ * @param[in] values Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @param[in] func Function
+ * @param[in] crossings State whether turning points are added in the segments
+ * @note The values are aggregated with the skiplist when their size exceeds
+ * work_mem, when their number exceeds the length of the skiplist, or when
+ * the skiplist is flushed before reading it
+ */
+void
+skiplist_add(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
+  int count, Datum (*func)(Datum, Datum), bool crossings)
+{
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  if (list->pendingcount + count > list->pendingcap)
+  {
+    int pendingcap = list->pendingcap ? list->pendingcap :
+      SKIPLIST_INITIAL_PENDING;
+    while (pendingcap < list->pendingcount + count)
+      pendingcap <<= 1;
+    list->pending = list->pending ?
+      repalloc(list->pending, sizeof(Temporal *) * pendingcap) :
+      palloc(sizeof(Temporal *) * pendingcap);
+    list->pendingcap = pendingcap;
+  }
+  for (int i = 0; i < count; i++)
+  {
+    list->pending[list->pendingcount++] = temporal_copy(values[i]);
+    list->pendingsize += VARSIZE(values[i]);
+  }
+  unset_aggregation_context(ctx);
+  list->func = func;
+  list->crossings = crossings;
+  if (list->pendingsize > (size_t) work_mem * 1024L ||
+    list->pendingcount > Max(list->length, SKIPLIST_MIN_PENDING))
+  {
+    skiplist_flush(fcinfo, list);
+    if (! list->spill && skiplist_size(list) > (size_t) work_mem * 1024L)
+      skiplist_spill(fcinfo, list);
+  }
+  return;
+}
+
+/**
+ * Splice the pending values of the skiplist after aggregating them together
+ *
+ * @note This function must be called before reading the values of
+ * the skiplist
+ */
+void
+skiplist_flush(FunctionCallInfo fcinfo, SkipList *list)
+{
+  if (list->pendingcount == 0)
+    return;
+  int count;
+  Temporal **values = (list->pending[0]->duration == INSTANT) ?
+    (Temporal **) tinstant_tagg_batch((TInstant **) list->pending,
+      list->pendingcount, list->func, &count) :
+    (Temporal **) tsequence_tagg_batch((TSequence **) list->pending,
+      list->pendingcount, list->func, list->crossings, &count);
+  list->pendingcount = 0;
+  list->pendingsize = 0;
+  if (list->spill)
+  {
+    MemoryContext ctx = set_aggregation_context(fcinfo);
+    for (int i = 0; i < count; i++)
+      skiplist_spill_write(list->spill, values[i]);
+    unset_aggregation_context(ctx);
+  }
+  else
+  {
+    skiplist_splice(fcinfo, list, values, count, list->func, list->crossings);
+    if (list->prune)
+      skiplist_prune(fcinfo, list);
+  }
+  for (int i = 0; i < count; i++)
+    pfree(values[i]);
+  pfree(values);
+  return;
+}
+
+/*****************************************************************************
+ * Generic aggregate transition functions
+ *****************************************************************************/
+
+/**
+ * Generic transition function for aggregating temporal values
+ * of instant duration
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[inout] state Skiplist containing the state
+ * @param[in] inst Temporal value
+ * @param[in] func Function
+ */
+static SkipList *
+tinstant_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state,
+  const TInstant *inst, Datum (*func)(Datum, Datum))
+{
+  SkipList *result;
+  if (! state)
+    result = skiplist_make(fcinfo, (Temporal **)&inst, 1);
+  else
+  {
+    if (skiplist_headval(state)->duration != INSTANT)
+      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+        errmsg("Cannot aggregate temporal values of different duration")));
+    skiplist_add(fcinfo, state, (Temporal **)&inst, 1, func, false);
+    result = state;
+  }
+  return result;
+}
+
+/**
+ * Generic transition function for aggregating temporal values
+ * of instant set duration
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[inout] state Skiplist containing the state
+ * @param[in] ti Temporal value
+ * @param[in] func Function
+ */
+static SkipList *
+tinstantset_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
+  const TInstantSet *ti, Datum (*func)(Datum, Datum))
+{
+  TInstant **instants = tinstantset_instants(ti);
+  SkipList *result;
+  if (! state)
+    result = skiplist_make(fcinfo, (Temporal **)instants, ti->count);
+  else
+  {
+    if (skiplist_headval(state)->duration != INSTANT)
+      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+        errmsg("Cannot aggregate temporal values of different duration")));
+    skiplist_add(fcinfo, state, (Temporal **)instants, ti->count, func, false);
+    result = state;
+  }
+  pfree(instants);
+  return result;
+}
+
+/**
+ * Generic transition function for aggregating temporal values
+ * of sequence duration
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[inout] state Skiplist containing the state
+ * @param[in] seq Temporal value
+ * @param[in] func Function
+ * @param[in] crossings State whether turning points are added in the segments
+ */
+SkipList *
+tsequence_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
+  TSequence *seq, Datum (*func)(Datum, Datum), bool crossings)
+{
+  SkipList *result;
+  if (! state)
+    result = skiplist_make(fcinfo, (Temporal **)&seq, 1);
+  else
+  {
+    if (skiplist_headval(state)->duration != SEQUENCE)
+      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+        errmsg("Cannot aggregate temporal values of different duration")));
+    if (MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state)->flags) != 
+        MOBDB_FLAGS_GET_LINEAR(seq->flags))
+      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+        errmsg("Cannot aggregate temporal values of different interpolation")));
+    skiplist_add(fcinfo, state, (Temporal **)&seq, 1, func, crossings);
+    result = state;
+  }
+  return result;
+}
+
+/**
+ * Generic transition function for aggregating temporal values
+ * of sequence set duration
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[inout] state Skiplist containing the state
+ * @param[in] ts Temporal value
+ * @param[in] func Function
+ * @param[in] crossings State whether turning points are added in the segments
+ */
+static SkipList *
+tsequenceset_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
+  const TSequenceSet *ts, Datum (*func)(Datum, Datum), bool crossings)
+{
+  TSequence **sequences = tsequenceset_sequences(ts);
+  SkipList *result;
+  if (! state)
+    result = skiplist_make(fcinfo, (Temporal **)sequences, ts->count);
+  else
+  {
+    if (skiplist_headval(state)->duration != SEQUENCE)
+      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+        errmsg("Cannot aggregate temporal values of different duration")));
+    if (MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state)->flags) !=
+        MOBDB_FLAGS_GET_LINEAR(ts->flags))
+      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+        errmsg("Cannot aggregate temporal values of different interpolation")));
+    skiplist_add(fcinfo, state, (Temporal **)sequences, ts->count, func, crossings);
+    result = state;
+  }
+  pfree(sequences);
+  return result;
+}
+
+/*****************************************************************************
+ * Generic aggregate functions for TInstant and TSequence
+ *****************************************************************************/
+
+/**
+ * Generic transition function for aggregating temporal values
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Aggregate function
+ * @param[in] crossings State whether turning points are added in the segments
+ */
+static Datum
+temporal_tagg_transfn(FunctionCallInfo fcinfo, Datum (*func)(Datum, Datum),
+  bool crossings)
+{
+  SkipList *state = PG_ARGISNULL(0) ? NULL :
+    (SkipList *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
+  
+  Temporal *temp = PG_GETARG_TEMPORAL(1);
+  TRACE_MOBILITYDB_AGG_TRANSFN_START(temporal_probe_count(temp),
+    temporal_probe_size(temp));
+  ensure_valid_duration(temp->duration);
+  SkipList *result;
+  if (temp->duration == INSTANT) 
+    result =  tinstant_tagg_transfn(fcinfo, state, (TInstant *)temp, 
+      func);
+  else if (temp->duration == INSTANTSET) 
+    result =  tinstantset_tagg_transfn(fcinfo, state, (TInstantSet *)temp, 
+      func);
+  else if (temp->duration == SEQUENCE) 
+    result =  tsequence_tagg_transfn(fcinfo, state, (TSequence *)temp, 
+      func, crossings);
+  else /* temp->duration == SEQUENCESET */
+    result = tsequenceset_tagg_transfn(fcinfo, state, (TSequenceSet *)temp, 
+      func, crossings);
+  TRACE_MOBILITYDB_AGG_TRANSFN_DONE(result->length);
+  PG_FREE_IF_COPY(temp, 1);
+  PG_RETURN_POINTER(result);
+}
+
+/**
+ * Generic combine function for aggregating temporal values
+ * 
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] state1, state2 State values
+ * @param[in] func Aggregate function
+ * @param[in] crossings State whether turning points are added in the segments
+ * @note This function is called for aggregating temporal points and thus
+ * after checking the dimensionality and the SRID of the values 
+ * @note The result is the first state, whose elements are reused for the
+ * merged values
+ */
+SkipList *
+temporal_tagg_combinefn1(FunctionCallInfo fcinfo, SkipList *state1, 
+  SkipList *state2, Datum (*func)(Datum, Datum), bool crossings)
+{
+  if (! state1)
+    return state2;
+  if (! state2)
+    return state1;
+
+  if (skiplist_headval(state1)->duration != skiplist_headval(state2)->duration)
+    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+      errmsg("Cannot aggregate temporal values of different duration")));
+  if (MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state1)->flags) != 
+      MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state2)->flags))
+    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+      errmsg("Cannot aggregate temporal values of different interpolation")));
+
+  /* Merge the values of the two states in a single pass and relink the
+   * result in the first state instead of splicing the values of one state
+   * into the other one */
+  skiplist_flush(fcinfo, state1);
+  skiplist_flush(fcinfo, state2);
+  skiplist_unspill(fcinfo, state1);
+  skiplist_unspill(fcinfo, state2);
+  int count1 = state1->length, count2 = state2->length, count;
+  Temporal **values1 = skiplist_values(state1);
+  Temporal **values2 = skiplist_values(state2);
+  Temporal **values = (values1[0]->duration == INSTANT) ?
+    (Temporal **)tinstant_tagg((TInstant **)values1, count1,
+      (TInstant **)values2, count2, func, &count) :
+    (Temporal **)tsequence_tagg((TSequence **)values1, count1,
+      (TSequence **)values2, count2, func, crossings, &count);
+  /* Free the elements of the first state except its head and its tail,
+   * which are reused by the merged values */
+  Elem *e = state1->head->next[0];
+  while (e != state1->tail)
+  {
+    Elem *next = e->next[0];
+    pfree(e->value);
+    skiplist_free(state1, e);
+    e = next;
+  }
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  skiplist_link(fcinfo, state1, values, count);
+  unset_aggregation_context(ctx);
+  if (! state1->extra && state2->extra)
+    aggstate_set_extra(fcinfo, state1, state2->extra, state2->extrasize);
+  for (int i = 0; i < count; i++)
+    pfree(values[i]);
+  pfree(values); pfree(values1); pfree(values2);
+  return state1;
+}
+
+/**
+ * Generic combine function for aggregating temporal alphanumber values
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Function
+ * @param[in] crossings State whether turning points are added in the segments
+ */
+Datum
+temporal_tagg_combinefn(FunctionCallInfo fcinfo, Datum (*func)(Datum, Datum), 
+  bool crossings)
+{
+  SkipList *state1 = PG_ARGISNULL(0) ? NULL :
+    (SkipList *) PG_GETARG_POINTER(0);
+  SkipList *state2 = PG_ARGISNULL(1) ? NULL :
+    (SkipList *) PG_GETARG_POINTER(1);
+  if (state1 == NULL && state2 == NULL)
+    PG_RETURN_NULL();
+
+  TRACE_MOBILITYDB_AGG_COMBINEFN_START(state1 ? state1->length : 0,
+    state2 ? state2->length : 0);
+  SkipList *result = temporal_tagg_combinefn1(fcinfo, state1, state2, func, 
+    crossings);
+  TRACE_MOBILITYDB_AGG_COMBINEFN_DONE(result->length);
+  PG_RETURN_POINTER(result);
+}
+
+/**
+ * Construct the result of a temporal aggregation from its values
+ */
+static Temporal *
+temporal_tagg_finalfn1(Temporal **values, int count, void *arg)
+{
+  assert(values[0]->duration == INSTANT ||
+    values[0]->duration == SEQUENCE);
+  if (values[0]->duration == INSTANT)
+    return (Temporal *)tinstantset_make((TInstant **)values, count);
+  else /* values[0]->duration == SEQUENCE */
+    return (Temporal *)tsequenceset_make((TSequence **)values, count,
+      NORMALIZE);
+}
+
+PG_FUNCTION_INFO_V1(temporal_tagg_finalfn);
+/**
+ * Generic final function for temporal aggregation
+ */
+PGDLLEXPORT Datum
+temporal_tagg_finalfn(PG_FUNCTION_ARGS)
+{
+  /* The final function is strict, we do not need to test for null values */
+  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  TRACE_MOBILITYDB_AGG_FINALFN_START(state->length);
+  Temporal *result = skiplist_finalize(fcinfo, state,
+    &temporal_tagg_finalfn1, NULL);
+  TRACE_MOBILITYDB_AGG_FINALFN_DONE(temporal_probe_count(result),
+    temporal_probe_size(result));
+  if (result == NULL)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Generic functions for aggregating temporal values that require a 
+ * transformation to be applied to each composing instant/sequence
+ * such as average and centroid. The function passed as
+ * argument is the function for transforming the temporal instant value
+ *****************************************************************************/
+
+/**
+ * Transform a temporal instant set value for aggregation 
+ */
+TInstant **
+tinstantset_transform_tagg(const TInstantSet *ti, 
+  TInstant *(*func)(const TInstant *))
+{
+  TInstant **result = palloc(sizeof(TInstant *) * ti->count);
+  for (int i = 0; i < ti->count; i++)
+  {
+    TInstant *inst = tinstantset_inst_n(ti, i);
+    result[i] = func(inst);
+  }
+  return result;
+}
+
+/**
+ * Transform a temporal sequence value for aggregation 
+ */
+TSequence *
+tsequence_transform_tagg(const TSequence *seq, 
+  TInstant *(*func)(const TInstant *))
+{
+  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    TInstant *inst = tsequence_inst_n(seq, i);
+    instants[i] = func(inst);
+  }
+  return tsequence_make_free(instants, seq->count,
+    seq->period.lower_inc, seq->period.upper_inc,
+    MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE_NO);
+}
+
+/**
+ * Transform a temporal sequence set value for aggregation 
+ */
+TSequence **
+tsequenceset_transform_tagg(const TSequenceSet *ts, 
+  TInstant *(*func)(const TInstant *))
+{
+  TSequence **result = palloc(sizeof(TSequence *) * ts->count);
+  for (int i = 0; i < ts->count; i++)
+  {
+    TSequence *seq = tsequenceset_seq_n(ts, i);
+    result[i] = tsequence_transform_tagg(seq, func);
+  }
+  return result;
+}
+
+/**
+ * Transform a temporal value for aggregation (dispatch function)
+ */
+Temporal **
+temporal_transform_tagg(const Temporal *temp, int *count, 
+  TInstant *(*func)(const TInstant *))
+{
+  Temporal **result;
+  if (temp->duration == INSTANT) 
+  {
+    result = palloc(sizeof(Temporal *));
+    result[0] = (Temporal *)func((TInstant *)temp);
+    *count = 1;
+  }
+  else if (temp->duration == INSTANTSET)
+  {
+    result = (Temporal **)tinstantset_transform_tagg((
+      TInstantSet *) temp, func);
+    *count = ((TInstantSet *)temp)->count;
+  } 
+  else if (temp->duration == SEQUENCE)
+  {
+    result = palloc(sizeof(Temporal *));
+    result[0] = (Temporal *)tsequence_transform_tagg(
+      (TSequence *) temp, func);
+    *count = 1;
+  }
+  else /* temp->duration == SEQUENCESET */
+  {
+    result = (Temporal **)tsequenceset_transform_tagg(
+      (TSequenceSet *) temp, func);
+    *count = ((TSequenceSet *)temp)->count;
+  }
+  assert(result != NULL);
+  return result;
+}
+
+/*****************************************************************************/
+
+/**
+ * Transition function for aggregating temporal values that require a
+ * transformation to each composing instant/sequence
+ * 
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Aggregate function
+ * @param[in] crossings State whether turning points are added in the segments
+ * @param[in] transform Transform function
+ */
+Datum
+temporal_tagg_transform_transfn(FunctionCallInfo fcinfo, 
+  Datum (*func)(Datum, Datum), bool crossings,
+  TInstant *(*transform)(const TInstant *))
+{
+  SkipList *state = PG_ARGISNULL(0) ? NULL : 
+    (SkipList *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
+
+  Temporal *temp = PG_GETARG_TEMPORAL(1);
+  int count;
+  Temporal **temparr = temporal_transform_tagg(temp, &count, transform);
+  if (state)
+  {
+    if (skiplist_headval(state)->duration != temparr[0]->duration)
+      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+        errmsg("Cannot aggregate temporal values of different duration")));
+    skiplist_add(fcinfo, state, temparr, count, func, crossings);
+  }
+  else
+    state = skiplist_make(fcinfo, temparr, count);
+
+  for (int i = 0; i< count; i++)
+    pfree(temparr[i]);
+  pfree(temparr);
+  PG_FREE_IF_COPY(temp, 1);
+  PG_RETURN_POINTER(state);
+}
+
+/*****************************************************************************
+ * Temporal count
+ *****************************************************************************/
+
+/**
+ * Transform a temporal instant value into a temporal integer value for
+ * performing temporal count aggregation 
+ *
+ * @param[in] inst Temporal value
+ * @param[in] one Value added to the count, which is -1 when the value is
+ * removed from a moving aggregate
+ */
+static TInstant *
+tinstant_transform_tcount(const TInstant *inst, Datum one)
+{
+  return tinstant_make(one, inst->t, INT4OID);
+}
+
+/**
+ * Transform a temporal instant set value into a temporal integer value for
+ * performing temporal count aggregation 
+ */
+static TInstant **
+tinstantset_transform_tcount(const TInstantSet *ti, Datum one)
+{
+  TInstant **result = palloc(sizeof(TInstant *) * ti->count);
+  for (int i = 0; i < ti->count; i++)
+  {
+    TInstant *inst = tinstantset_inst_n(ti, i);
+    result[i] = tinstant_make(one, inst->t, INT4OID);
+  }
+  return result;
+}
+
+/**
+ * Transform a temporal sequence value into a temporal integer value for
+ * performing temporal count aggregation 
+ */
+static TSequence *
+tsequence_transform_tcount(const TSequence *seq, Datum one)
+{
+  TSequence *result;
+  if (seq->count == 1)
+  {
+    TInstant *inst = tinstant_make(one, seq->period.lower, INT4OID);
+    result = tinstant_to_tsequence(inst, STEP);
+    pfree(inst);
+    return result;
+  }
+
+  TInstant *instants[2];
+  instants[0] = tinstant_make(one, seq->period.lower, INT4OID);
+  instants[1] = tinstant_make(one, seq->period.upper, INT4OID);
+  result = tsequence_make(instants, 2, seq->period.lower_inc,
+    seq->period.upper_inc, STEP, NORMALIZE_NO);
+  pfree(instants[0]); pfree(instants[1]); 
+  return result;
+}
+
+/**
+ * Transform a temporal sequence set value into a temporal integer value for
+ * performing temporal count aggregation 
+ */
+static TSequence **
+tsequenceset_transform_tcount(const TSequenceSet *ts, Datum one)
+{
+  TSequence **result = palloc(sizeof(TSequence *) * ts->count);
+  for (int i = 0; i < ts->count; i++)
+  {
+    TSequence *seq = tsequenceset_seq_n(ts, i);
+    result[i] = tsequence_transform_tcount(seq, one);
+  }
+  return result;
+}
+
+/**
+ * Transform a temporal value into a temporal integer value for
+ * performing temporal count aggregation (dispatch function)
+ */
+static Temporal **
+temporal_transform_tcount(const Temporal *temp, Datum one, int *count)
+{
+  Temporal **result;
+  if (temp->duration == INSTANT) 
+  {
+    result = palloc(sizeof(Temporal *));
+    result[0] = (Temporal *)tinstant_transform_tcount((TInstant *)temp, one);
+    *count = 1;
+  }
+  else if (temp->duration == INSTANTSET)
+  {
+    result = (Temporal **)tinstantset_transform_tcount((TInstantSet *) temp,
+      one);
+    *count = ((TInstantSet *)temp)->count;
+  } 
+  else if (temp->duration == SEQUENCE)
+  {
+    result = palloc(sizeof(Temporal *));
+    result[0] = (Temporal *)tsequence_transform_tcount((TSequence *) temp,
+      one);
+    *count = 1;
+  }
+  else /* temp->duration == SEQUENCESET */
+  {
+    result = (Temporal **)tsequenceset_transform_tcount((TSequenceSet *) temp,
+      one);
+    *count = ((TSequenceSet *)temp)->count;
+  }
+  assert(result != NULL);
+  return result;
+}
+
+/**
+ * Generic transition function for temporal count
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] one Value added to the count for each instant of the value
+ */
+static Datum 
+temporal_tcount_transfn1(FunctionCallInfo fcinfo, Datum one)
+{
+  SkipList *state = PG_ARGISNULL(0) ? NULL : 
+    (SkipList *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
+
+  Temporal *temp = PG_GETARG_TEMPORAL(1);
+  int count;
+  Temporal **tsequenceset = temporal_transform_tcount(temp, one, &count);
+  if (state)
+  {
+    if (skiplist_headval(state)->duration != tsequenceset[0]->duration)
+      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+        errmsg("Cannot aggregate temporal values of different duration")));
+    skiplist_add(fcinfo, state, tsequenceset, count, &datum_sum_int32, false);
+  }
+  else
+    state = skiplist_make(fcinfo, tsequenceset, count);
+
+  for (int i = 0; i< count; i++)
+    pfree(tsequenceset[i]);
+  pfree(tsequenceset);
+  PG_FREE_IF_COPY(temp, 1);
+  PG_RETURN_POINTER(state);
+}
+
+PG_FUNCTION_INFO_V1(temporal_tcount_transfn);
+/**
+ * Generic transition function for temporal aggregation
+ */
+PGDLLEXPORT Datum 
+temporal_tcount_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tcount_transfn1(fcinfo, Int32GetDatum(1));
+}
+
+/* Functions stating the values kept in the states of the moving aggregates */
+static Datum tcount_mfinal_value(Datum value, bool *found);
+static Datum double2_prune_value(Datum value, bool *found);
+
+PG_FUNCTION_INFO_V1(temporal_tcount_invfn);
+/**
+ * Inverse transition function for temporal count used as a moving aggregate,
+ * which removes a value from the current window frame by subtracting 1
+ * from the count during its time frame
+ *
+ * @note The parts of the state where the count becomes zero are removed 
+ * whenever the pending values are spliced into the state
+ */
+PGDLLEXPORT Datum 
+temporal_tcount_invfn(PG_FUNCTION_ARGS)
+{
+  if (PG_ARGISNULL(0))
+    PG_RETURN_NULL();
+  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  state->prune = &tcount_mfinal_value;
+  return temporal_tcount_transfn1(fcinfo, Int32GetDatum(-1));
+}
+
+PG_FUNCTION_INFO_V1(temporal_tcount_combinefn);
+/**
+ * Generic combine function for temporal aggregation
+ */
+PGDLLEXPORT Datum 
+temporal_tcount_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_sum_int32, false);
+}
+
+/*****************************************************************************
+ * Temporal extent
+ *
+ * The state of the extent aggregates is allocated in the aggregate context
+ * by the first call of the transition function and is then expanded in place
+ * with the bounding box of every input value. When these functions are not
+ * called as aggregates a new state is returned instead.
+ *****************************************************************************/
+
+/**
+ * Allocate a zeroed state of the given size for the extent aggregates in the
+ * aggregate memory context, or in the current memory context when the
+ * function is not called as an aggregate
+ */
+void *
+aggstate_box_alloc(FunctionCallInfo fcinfo, size_t size)
+{
+  MemoryContext ctx;
+  if (! AggCheckCallContext(fcinfo, &ctx))
+    return palloc0(size);
+  return MemoryContextAllocZero(ctx, size);
+}
+
+PG_FUNCTION_INFO_V1(temporal_extent_transfn);
+/**
+ * Transition function for temporal extent aggregation of temporal values
+ * with period bounding box
+ */
+PGDLLEXPORT Datum 
+temporal_extent_transfn(PG_FUNCTION_ARGS)
+{
+  Period *p = PG_ARGISNULL(0) ? NULL : PG_GETARG_PERIOD(0);
+  bool hastemp = ! PG_ARGISNULL(1);
+  
+  /* Can't do anything with null inputs */
+  if (!p && ! hastemp)
+    PG_RETURN_NULL();
+  /* Non-null period and null temporal, return the period */
+  if (! hastemp)
+    PG_RETURN_POINTER(p);
+  /* Null period and non-null temporal, return the bbox of the temporal */
+  if (!p)
+  {
+    Period *result = aggstate_box_alloc(fcinfo, sizeof(Period));
+    temporal_bbox_slice(result, PG_GETARG_DATUM(1));
+    PG_RETURN_POINTER(result);
+  }
+
+  Period p1;
+  temporal_bbox_slice(&p1, PG_GETARG_DATUM(1));
+  if (! AggCheckCallContext(fcinfo, NULL))
+    PG_RETURN_POINTER(period_super_union(p, &p1));
+  period_expand(p, &p1);
+  PG_RETURN_POINTER(p);
+}
+
+PG_FUNCTION_INFO_V1(temporal_extent_combinefn);
+/**
+ * Combine function for temporal extent aggregation
+ */
+PGDLLEXPORT Datum 
+temporal_extent_combinefn(PG_FUNCTION_ARGS)
+{
+  Period *p1 = PG_ARGISNULL(0) ? NULL : PG_GETARG_PERIOD(0);
+  Period *p2 = PG_ARGISNULL(1) ? NULL : PG_GETARG_PERIOD(1);
+
+  if (!p2 && !p1)
+    PG_RETURN_NULL();
+  if (p1 && !p2)
+    PG_RETURN_POINTER(p1);
+  if (p2 && !p1)
+    PG_RETURN_POINTER(p2);
+
+  if (! AggCheckCallContext(fcinfo, NULL))
+    PG_RETURN_POINTER(period_super_union(p1, p2));
+  period_expand(p1, p2);
+  PG_RETURN_POINTER(p1);
+}
+
+/*****************************************************************************/
+
+PG_FUNCTION_INFO_V1(tnumber_extent_transfn);
+/**
+ * Transition function for temporal extent aggregation for temporal numbers
+ */
+PGDLLEXPORT Datum 
+tnumber_extent_transfn(PG_FUNCTION_ARGS)
+{
+  TBOX *box = PG_ARGISNULL(0) ? NULL : PG_GETARG_TBOX_P(0);
+  bool hastemp = ! PG_ARGISNULL(1);
+
+  /* Can't do anything with null inputs */
+  if (!box && ! hastemp)
+    PG_RETURN_NULL();
+  /* Non-null box and null temporal, return the box */
+  if (! hastemp)
+    PG_RETURN_POINTER(box);
+  /* Null box and non-null temporal, return the bbox of the temporal */
+  if (!box)
+  {
+    TBOX *result = aggstate_box_alloc(fcinfo, sizeof(TBOX));
+    temporal_bbox_slice(result, PG_GETARG_DATUM(1));
+    PG_RETURN_POINTER(result);
+  }
+
+  /* Both box and temporal are not null */
+  TBOX box1;
+  temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
+  if (! AggCheckCallContext(fcinfo, NULL))
+    box = tbox_copy(box);
+  tbox_expand(box, &box1);
+  PG_RETURN_POINTER(box);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_extent_combinefn);
+/**
+ * Combine function for temporal extent aggregation for temporal numbers
+ */
+PGDLLEXPORT Datum 
+tnumber_extent_combinefn(PG_FUNCTION_ARGS)
+{
+  TBOX *box1 = PG_ARGISNULL(0) ? NULL : PG_GETARG_TBOX_P(0);
+  TBOX *box2 = PG_ARGISNULL(1) ? NULL : PG_GETARG_TBOX_P(1);
+
+  if (!box2 && !box1)
+    PG_RETURN_NULL();
+  if (box1 && !box2)
+    PG_RETURN_POINTER(box1);
+  if (box2 && !box1)
+    PG_RETURN_POINTER(box2);
+  /* Both boxes are not null */
+  ensure_same_dimensionality_tbox(box1, box2);
+  if (! AggCheckCallContext(fcinfo, NULL))
+    box1 = tbox_copy(box1);
+  tbox_expand(box1, box2);
+  PG_RETURN_POINTER(box1);
+}
+
+/*****************************************************************************
+ * Temporal boolean functions
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(tbool_tand_transfn);
+/**
+ * Transition function for temporal and aggregation of temporal boolean values
+ */
+PGDLLEXPORT Datum
+tbool_tand_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transfn(fcinfo, &datum_and, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(tbool_tand_combinefn);
+/**
+ * Combine function for temporal and aggregation of temporal boolean values
+ */
+PGDLLEXPORT Datum
+tbool_tand_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_and, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(tbool_tor_transfn);
+/**
+ * Transition function for temporal or aggregation of temporal boolean values
+ */
+PGDLLEXPORT Datum
+tbool_tor_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transfn(fcinfo, &datum_or, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(tbool_tor_combinefn);
+/**
+ * Combine function for temporal or aggregation of temporal boolean values
+ */
+PGDLLEXPORT Datum
+tbool_tor_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_or, CROSSINGS_NO);
+}
+
+/*****************************************************************************/
+
+PG_FUNCTION_INFO_V1(tint_tmin_transfn);
+/**
+ * Transition function for temporal minimum aggregation of temporal integer values
+ */
+PGDLLEXPORT Datum
+tint_tmin_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transfn(fcinfo, &datum_min_int32, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(tint_tmin_combinefn);
+/**
+ * Combine function for temporal minimum aggregation of temporal integer values
+ */
+PGDLLEXPORT Datum
+tint_tmin_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_min_int32, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(tfloat_tmin_transfn);
+/**
+ * Transition function for temporal minimum aggregation of temporal float values
+ */
+PGDLLEXPORT Datum
+tfloat_tmin_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transfn(fcinfo, &datum_min_float8, CROSSINGS);
+}
+
+PG_FUNCTION_INFO_V1(tfloat_tmin_combinefn);
+/**
+ * Combine function for temporal minimum aggregation of temporal float values
+ */
+PGDLLEXPORT Datum
+tfloat_tmin_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_min_float8, CROSSINGS);
+}
+
+PG_FUNCTION_INFO_V1(tint_tmax_transfn);
+/**
+ * Transition function for temporal maximum aggregation of temporal integer values
+ */
+PGDLLEXPORT Datum
+tint_tmax_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transfn(fcinfo, &datum_max_int32, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(tint_tmax_combinefn);
+/**
+ * Combine function for temporal maximum aggregation of temporal integer values
+ */
+PGDLLEXPORT Datum
+tint_tmax_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_max_int32, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(tfloat_tmax_transfn);
+/**
+ * Transition function for temporal maximum aggregation of temporal float values
+ */
+PGDLLEXPORT Datum
+tfloat_tmax_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transfn(fcinfo, &datum_max_float8, CROSSINGS);
+}
+
+PG_FUNCTION_INFO_V1(tfloat_tmax_combinefn);
+/**
+ * Combine function for temporal maximum aggregation of temporal float values
+ */
+PGDLLEXPORT Datum
+tfloat_tmax_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_max_float8, CROSSINGS);
+}
+
+PG_FUNCTION_INFO_V1(tint_tsum_transfn);
+/**
+ * Transition function for temporal sum aggregation of temporal integer values
+ */
+PGDLLEXPORT Datum
+tint_tsum_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transfn(fcinfo, &datum_sum_int32, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(tint_tsum_combinefn);
+/**
+ * Combine function for temporal sum aggregation of temporal integer values
+ */
+PGDLLEXPORT Datum
+tint_tsum_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_sum_int32, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(tfloat_tsum_transfn);
+/**
+ * Transition function for temporal sum aggregation of temporal float values
+ */
+PGDLLEXPORT Datum
+tfloat_tsum_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transfn(fcinfo, &datum_sum_float8, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(tfloat_tsum_combinefn);
+/**
+ * Combine function for temporal sum aggregation of temporal float values
+ */
+PGDLLEXPORT Datum
+tfloat_tsum_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_sum_float8, CROSSINGS_NO);
+}
+
+/*****************************************************************************/
+
+PG_FUNCTION_INFO_V1(ttext_tmin_transfn);
+/**
+ * Transition function for temporal minimum aggregation of temporal text values
+ */
+PGDLLEXPORT Datum
+ttext_tmin_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transfn(fcinfo, &datum_min_text, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(ttext_tmin_combinefn);
+/**
+ * Combine function for temporal minimum aggregation of temporal text values
+ */
+PGDLLEXPORT Datum
+ttext_tmin_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_min_text, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(ttext_tmax_transfn);
+/**
+ * Transition function for temporal maximum aggregation of temporal text values
+ */
+PGDLLEXPORT Datum
+ttext_tmax_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transfn(fcinfo, &datum_max_text, CROSSINGS_NO);
+}
+
+PG_FUNCTION_INFO_V1(ttext_tmax_combinefn);
+/**
+ * Combine function for temporal maximum aggregation of temporal text values
+ */
+PGDLLEXPORT Datum
+ttext_tmax_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_max_text, CROSSINGS_NO);
+}
+
+/*****************************************************************************
+ * Temporal average
+ *****************************************************************************/
+
+/**
+ * Transform a temporal number into a temporal double2 value for 
+ * performing temporal average aggregation
+ */
+TInstant *
+tnumberinst_transform_tavg(const TInstant *inst)
+{
+  double value = datum_double(tinstant_value(inst), inst->valuetypid);
+  double2 dvalue;
+  double2_set(&dvalue, value, 1);
+  TInstant *result = tinstant_make(PointerGetDatum(&dvalue), inst->t,
+    type_oid(T_DOUBLE2));
+  return result;
+}
+
+PG_FUNCTION_INFO_V1(tnumber_tavg_transfn);
+/**
+ * Transition function for temporal average aggregation
+ */
+PGDLLEXPORT Datum
+tnumber_tavg_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_transform_transfn(fcinfo, &datum_sum_double2,
+    CROSSINGS_NO, &tnumberinst_transform_tavg);
+}
+
+/**
+ * Transform a temporal number into a temporal double2 value for removing 
+ * it from a temporal average used as a moving aggregate
+ */
+static TInstant *
+tnumberinst_transform_tavg_inv(const TInstant *inst)
+{
+  double value = datum_double(tinstant_value(inst), inst->valuetypid);
+  double2 dvalue;
+  double2_set(&dvalue, -value, -1);
+  TInstant *result = tinstant_make(PointerGetDatum(&dvalue), inst->t,
+    type_oid(T_DOUBLE2));
+  return result;
+}
+
+PG_FUNCTION_INFO_V1(tnumber_tavg_invfn);
+/**
+ * Inverse transition function for temporal average used as a moving
+ * aggregate, which removes a value from the current window frame by
+ * subtracting its value and its count during its time frame
+ *
+ * @note This function is only used for temporal integers, since the 
+ * subtraction of floats accumulates rounding errors across window frames.
+ * The parts of the state where the count becomes zero are removed whenever
+ * the pending values are spliced into the state.
+ */
+PGDLLEXPORT Datum
+tnumber_tavg_invfn(PG_FUNCTION_ARGS)
+{
+  if (PG_ARGISNULL(0))
+    PG_RETURN_NULL();
+  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  state->prune = &double2_prune_value;
+  return temporal_tagg_transform_transfn(fcinfo, &datum_sum_double2,
+    CROSSINGS_NO, &tnumberinst_transform_tavg_inv);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_tavg_combinefn);
+/**
+ * Combine function for temporal average aggregation
+ */
+PGDLLEXPORT Datum
+tnumber_tavg_combinefn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_combinefn(fcinfo, &datum_sum_double2, false);
+}
+
+/* Final function for tavg */
+
+/**
+ * Final function for temporal average aggregation of temporal instat values
+ */
+static TInstantSet *
+tinstant_tavg_finalfn(TInstant **instants, int count)
+{
+  TInstant **newinstants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    TInstant *inst = instants[i];
+    double2 *value = (double2 *)DatumGetPointer(tinstant_value_ptr(inst));
+    double tavg = value->a / value->b;
+    newinstants[i] = tinstant_make(Float8GetDatum(tavg), inst->t,
+      FLOAT8OID);
+  }
+  return tinstantset_make_free(newinstants, count);
+}
+
+/**
+ * Final function for temporal average aggregation of temporal sequence values
+ */
+static TSequenceSet *
+tsequence_tavg_finalfn(TSequence **sequences, int count)
+{
+  TSequence **newsequences = palloc(sizeof(TSequence *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    TSequence *seq = sequences[i];
+    TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+    for (int j = 0; j < seq->count; j++)
+    {
+      TInstant *inst = tsequence_inst_n(seq, j);
+      double2 *value2 = (double2 *)DatumGetPointer(tinstant_value_ptr(inst));
+      double value = value2->a / value2->b;
+      instants[j] = tinstant_make(Float8GetDatum(value), inst->t,
+        FLOAT8OID);
+    }
+    newsequences[i] = tsequence_make_free(instants, seq->count, 
+      seq->period.lower_inc, seq->period.upper_inc, 
+      MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
+  }
+  return tsequenceset_make_free(newsequences, count, NORMALIZE);
+}
+
+/**
+ * Construct the result of a temporal average aggregation from its values
+ */
+static Temporal *
+tnumber_tavg_finalfn1(Temporal **values, int count, void *arg)
+{
+  assert(values[0]->duration == INSTANT || values[0]->duration == SEQUENCE);
+  return (values[0]->duration == INSTANT) ?
+    (Temporal *)tinstant_tavg_finalfn((TInstant **)values, count) :
+    (Temporal *)tsequence_tavg_finalfn((TSequence **)values, count);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_tavg_finalfn);
+/**
+ * Final function for temporal average aggregation
+ */
+PGDLLEXPORT Datum
+tnumber_tavg_finalfn(PG_FUNCTION_ARGS)
+{
+  /* The final function is strict, we do not need to test for null values */
+  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  Temporal *result = skiplist_finalize(fcinfo, state,
+    &tnumber_tavg_finalfn1, NULL);
+  if (result == NULL)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Final functions of the moving aggregates
+ *
+ * The inverse transition functions of the moving aggregates subtract the
+ * values that leave the window frame. The parts of the time frame of these
+ * values where the count is zero are removed from the state when the pending
+ * values are spliced into it, so that the state is bounded by the values of
+ * the window frame, and by the final functions. The states of these
+ * aggregates are temporal integers or temporal double2 values with stepwise
+ * interpolation.
+ *****************************************************************************/
+
+/**
+ * Final value of a temporal count used as a moving aggregate
+ */
+static Datum
+tcount_mfinal_value(Datum value, bool *found)
+{
+  *found = DatumGetInt32(value) != 0;
+  return value;
+}
+
+/**
+ * Final value of a temporal sum used as a moving aggregate
+ */
+static Datum
+tsum_mfinal_value(Datum value, bool *found)
+{
+  double2 *value2 = (double2 *) DatumGetPointer(value);
+  *found = value2->b != 0;
+  return Int32GetDatum((int) value2->a);
+}
+
+/**
+ * Value kept in the state of a temporal sum or of a temporal average used as
+ * a moving aggregate
+ */
+static Datum
+double2_prune_value(Datum value, bool *found)
+{
+  double2 *value2 = (double2 *) DatumGetPointer(value);
+  *found = value2->b != 0;
+  return value;
+}
+
+/**
+ * Final value of a temporal average used as a moving aggregate
+ */
+static Datum
+tavg_mfinal_value(Datum value, bool *found)
+{
+  double2 *value2 = (double2 *) DatumGetPointer(value);
+  *found = value2->b != 0;
+  return *found ? Float8GetDatum(value2->a / value2->b) : Float8GetDatum(0);
+}
+
+/**
+ * Generic final function of the moving aggregates for temporal instant values
+ *
+ * @param[in] instants Values of the state
+ * @param[in] count Number of values of the state
+ * @param[in] func Function computing the final value of an instant, which
+ * states whether the count of the instant is not zero
+ * @param[in] valuetypid Oid of the base type of the result
+ */
+static TInstantSet *
+tinstant_tagg_mfinalfn(TInstant **instants, int count, 
+  Datum (*func)(Datum, bool *), Oid valuetypid)
+{
+  TInstant **newinstants = palloc(sizeof(TInstant *) * count);
+  int k = 0;
+  for (int i = 0; i < count; i++)
+  {
+    bool found;
+    Datum value = func(tinstant_value(instants[i]), &found);
+    if (found)
+      newinstants[k++] = tinstant_make(value, instants[i]->t, valuetypid);
+  }
+  if (k == 0)
+  {
+    pfree(newinstants);
+    return NULL;
+  }
+  return tinstantset_make_free(newinstants, k);
+}
+
+/**
+ * Generic final function of the moving aggregates for temporal sequence 
+ * values, which only keeps the segments whose count is not zero
+ *
+ * @param[in] sequences Values of the state
+ * @param[in] count Number of values of the state
+ * @param[in] func Function computing the final value of an instant, which
+ * states whether the count of the instant is not zero
+ * @param[in] valuetypid Oid of the base type of the result
+ */
+static TSequenceSet *
+tsequence_tagg_mfinalfn(TSequence **sequences, int count, 
+  Datum (*func)(Datum, bool *), Oid valuetypid)
+{
+  int maxcount = 0;
+  for (int i = 0; i < count; i++)
+    maxcount = Max(maxcount, sequences[i]->count);
+  /* Each sequence is split at most in (count + 1) / 2 sequences */
+  TSequence **newsequences = palloc(sizeof(TSequence *) * 
+    (count * (maxcount + 1) / 2));
+  TInstant **instants = palloc(sizeof(TInstant *) * (maxcount + 1));
+  int k = 0;
+  for (int i = 0; i < count; i++)
+  {
+    TSequence *seq = sequences[i];
+    assert(! MOBDB_FLAGS_GET_LINEAR(seq->flags));
+    bool lower_inc = seq->period.lower_inc;
+    Datum value = 0; /* make compiler quiet */
+    int l = 0;
+    for (int j = 0; j < seq->count; j++)
+    {
+      TInstant *inst = tsequence_inst_n(seq, j);
+      bool found;
+      Datum newvalue = func(tinstant_value(inst), &found);
+      if (found)
+      {
+        value = newvalue;
+        instants[l++] = tinstant_make(value, inst->t, valuetypid);
+        continue;
+      }
+      /* The count is zero from this instant, the instants found so far, 
+       * if any, are closed by an exclusive bound at this instant */
+      if (l > 0)
+      {
+        instants[l++] = tinstant_make(value, inst->t, valuetypid);
+        newsequences[k++] = tsequence_make(instants, l, lower_inc, false,
+          STEP, NORMALIZE);
+        for (int m = 0; m < l; m++)
+          pfree(instants[m]);
+        l = 0;
+      }
+      lower_inc = true;
+    }
+    /* A last instant alone is only kept if both bounds are inclusive */
+    if (l > 1 || (l == 1 && lower_inc && seq->period.upper_inc))
+      newsequences[k++] = tsequence_make(instants, l, lower_inc,
+        seq->period.upper_inc, STEP, NORMALIZE);
+    for (int m = 0; m < l; m++)
+      pfree(instants[m]);
+  }
+  pfree(instants);
+  if (k == 0)
+  {
+    pfree(newsequences);
+    return NULL;
+  }
+  return tsequenceset_make_free(newsequences, k, NORMALIZE);
+}
+
+/**
+ * Arguments of the generic final function of the moving aggregates
+ */
+typedef struct
 {
-  SkipList *state1 = PG_ARGISNULL(0) ? NULL :
-    (SkipList *) PG_GETARG_POINTER(0);
-  SkipList *state2 = PG_ARGISNULL(1) ? NULL :
-    (SkipList *) PG_GETARG_POINTER(1);
-  if (state1 == NULL && state2 == NULL)
-    PG_RETURN_NULL();
+  Datum (*func)(Datum, bool *);
+  Oid valuetypid;
+} MFinalArgs;
 
-  SkipList *result = temporal_tagg_combinefn1(fcinfo, state1, state2, func, 
-    crossings);
-  PG_RETURN_POINTER(result);
+/**
+ * Construct the result of a moving aggregate from its values
+ */
+static Temporal *
+temporal_tagg_mfinalfn1(Temporal **values, int count, void *arg)
+{
+  MFinalArgs *args = (MFinalArgs *) arg;
+  assert(values[0]->duration == INSTANT || values[0]->duration == SEQUENCE);
+  return (values[0]->duration == INSTANT) ?
+    (Temporal *)tinstant_tagg_mfinalfn((TInstant **)values, count,
+      args->func, args->valuetypid) :
+    (Temporal *)tsequence_tagg_mfinalfn((TSequence **)values, count,
+      args->func, args->valuetypid);
 }
 
-PG_FUNCTION_INFO_V1(temporal_tagg_finalfn);
 /**
- * Generic final function for temporal aggregation
+ * Remove from the state of a moving aggregate the parts of the values where
+ * the count is zero
+ *
+ * @note The state is not pruned when it is spilled, in which case the parts
+ * are removed by the final function. The last value is kept when the count
+ * is zero everywhere since a skiplist cannot be empty.
  */
-PGDLLEXPORT Datum
-temporal_tagg_finalfn(PG_FUNCTION_ARGS)
+void
+skiplist_prune(FunctionCallInfo fcinfo, SkipList *list)
+{
+  if (list->spill || list->length == 0)
+    return;
+  Temporal **values = skiplist_values(list);
+  bool zero = false;
+  for (int i = 0; i < list->length && ! zero; i++)
+  {
+    bool found;
+    if (values[i]->duration == INSTANT)
+    {
+      list->prune(tinstant_value((TInstant *) values[i]), &found);
+      zero = ! found;
+    }
+    else
+    {
+      TSequence *seq = (TSequence *) values[i];
+      for (int j = 0; j < seq->count && ! zero; j++)
+      {
+        list->prune(tinstant_value(tsequence_inst_n(seq, j)), &found);
+        zero = ! found;
+      }
+    }
+  }
+  if (! zero)
+  {
+    pfree(values);
+    return;
+  }
+
+  MFinalArgs args;
+  args.func = list->prune;
+  args.valuetypid = values[0]->valuetypid;
+  Temporal *pruned = temporal_tagg_mfinalfn1(values, list->length, &args);
+  int count = (pruned == NULL) ? 0 : (pruned->duration == INSTANTSET) ?
+    ((TInstantSet *) pruned)->count : ((TSequenceSet *) pruned)->count;
+  Temporal **newvalues = palloc(sizeof(Temporal *) * Max(count, 1));
+  if (count == 0)
+    newvalues[count++] = values[list->length - 1];
+  else
+    for (int i = 0; i < count; i++)
+      newvalues[i] = (pruned->duration == INSTANTSET) ?
+        (Temporal *) tinstantset_inst_n((TInstantSet *) pruned, i) :
+        (Temporal *) tsequenceset_seq_n((TSequenceSet *) pruned, i);
+  /* Free the elements of the skiplist except its head and its tail */
+  Elem *e = list->head->next[0];
+  while (e != list->tail)
+  {
+    Elem *next = e->next[0];
+    if (e->value != newvalues[0])
+      pfree(e->value);
+    skiplist_free(list, e);
+    e = next;
+  }
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  skiplist_link(fcinfo, list, newvalues, count);
+  unset_aggregation_context(ctx);
+  /* The last value is copied by skiplist_link when it is the only one kept */
+  if (pruned == NULL)
+    pfree(newvalues[0]);
+  else
+    pfree(pruned);
+  pfree(newvalues); pfree(values);
+  return;
+}
+
+/**
+ * Generic final function of the moving aggregates
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Function computing the final value of an instant
+ * @param[in] valuetypid Oid of the base type of the result
+ */
+static Datum
+temporal_tagg_mfinalfn(FunctionCallInfo fcinfo, Datum (*func)(Datum, bool *),
+  Oid valuetypid)
 {
   /* The final function is strict, we do not need to test for null values */
   SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
-  if (state->length == 0)
+  MFinalArgs args;
+  args.func = func;
+  args.valuetypid = valuetypid;
+  Temporal *result = skiplist_finalize(fcinfo, state,
+    &temporal_tagg_mfinalfn1, &args);
+  if (result == NULL)
     PG_RETURN_NULL();
-
-  Temporal **values = skiplist_values(state);
-  Temporal *result = NULL;
-  assert(values[0]->duration == INSTANT ||
-    values[0]->duration == SEQUENCE);
-  if (values[0]->duration == INSTANT)
-    result = (Temporal *)tinstantset_make((TInstant **)values,
-      state->length);
-  else /* values[0]->duration == SEQUENCE */
-    result = (Temporal *)tsequenceset_make((TSequence **)values,
-      state->length, NORMALIZE);
-  pfree(values);
   PG_RETURN_POINTER(result);
 }
 
-/*****************************************************************************
- * Generic functions for aggregating temporal values that require a 
- * transformation to be applied to each composing instant/sequence
- * such as average and centroid. The function passed as
- * argument is the function for transforming the temporal instant value
- *****************************************************************************/
+PG_FUNCTION_INFO_V1(temporal_tcount_mfinalfn);
+/**
+ * Final function for temporal count used as a moving aggregate
+ */
+PGDLLEXPORT Datum
+temporal_tcount_mfinalfn(PG_FUNCTION_ARGS)
+{
+  return temporal_tagg_mfinalfn(fcinfo, &tcount_mfinal_value, INT4OID);
+}
 
+PG_FUNCTION_INFO_V1(tint_tsum_mfinalfn);
 /**
- * Transform a temporal instant set value for aggregation 
+ * Final function for temporal sum of temporal integers used as a moving 
+ * aggregate, whose state keeps the sums and the counts as for the 
+ * temporal average
  */
-TInstant **
-tinstantset_transform_tagg(const TInstantSet *ti, 
-  TInstant *(*func)(const TInstant *))
+PGDLLEXPORT Datum
+tint_tsum_mfinalfn(PG_FUNCTION_ARGS)
 {
-  TInstant **result = palloc(sizeof(TInstant *) * ti->count);
-  for (int i = 0; i < ti->count; i++)
-  {
-    TInstant *inst = tinstantset_inst_n(ti, i);
-    result[i] = func(inst);
-  }
-  return result;
+  return temporal_tagg_mfinalfn(fcinfo, &tsum_mfinal_value, INT4OID);
 }
 
+PG_FUNCTION_INFO_V1(tnumber_tavg_mfinalfn);
 /**
- * Transform a temporal sequence value for aggregation 
+ * Final function for temporal average used as a moving aggregate
  */
-TSequence *
-tsequence_transform_tagg(const TSequence *seq, 
-  TInstant *(*func)(const TInstant *))
+PGDLLEXPORT Datum
+tnumber_tavg_mfinalfn(PG_FUNCTION_ARGS)
 {
-  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  for (int i = 0; i < seq->count; i++)
-  {
-    TInstant *inst = tsequence_inst_n(seq, i);
-    instants[i] = func(inst);
-  }
-  return tsequence_make_free(instants, seq->count,
-    seq->period.lower_inc, seq->period.upper_inc,
-    MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE_NO);
+  return temporal_tagg_mfinalfn(fcinfo, &tavg_mfinal_value, FLOAT8OID);
 }
 
+/*****************************************************************************
+ * Append aggregate
+ *****************************************************************************/
+
 /**
- * Transform a temporal sequence set value for aggregation 
+ * Initializes the state of the aggregation that appends temporal instants
  */
-TSequence **
-tsequenceset_transform_tagg(const TSequenceSet *ts, 
-  TInstant *(*func)(const TInstant *))
+void
+appendstate_init(AppendState *state)
 {
-  TSequence **result = palloc(sizeof(TSequence *) * ts->count);
-  for (int i = 0; i < ts->count; i++)
-  {
-    TSequence *seq = tsequenceset_seq_n(ts, i);
-    result[i] = tsequence_transform_tagg(seq, func);
-  }
-  return result;
+  state->capacity = APPENDSTATE_INITIAL_CAPACITY;
+  state->count = 0;
+  state->instants = palloc(sizeof(TInstant *) * state->capacity);
 }
 
 /**
- * Transform a temporal value for aggregation (dispatch function)
+ * Returns true if the instant is already the last one of the state, after
+ * verifying that it can be appended to the state
  */
-Temporal **
-temporal_transform_tagg(const Temporal *temp, int *count, 
-  TInstant *(*func)(const TInstant *))
+bool
+appendstate_has_last(const AppendState *state, const TInstant *inst)
 {
-  Temporal **result;
-  if (temp->duration == INSTANT) 
-  {
-    result = palloc(sizeof(Temporal *));
-    result[0] = (Temporal *)func((TInstant *)temp);
-    *count = 1;
-  }
-  else if (temp->duration == INSTANTSET)
-  {
-    result = (Temporal **)tinstantset_transform_tagg((
-      TInstantSet *) temp, func);
-    *count = ((TInstantSet *)temp)->count;
-  } 
-  else if (temp->duration == SEQUENCE)
+  if (state->count == 0)
+    return false;
+  TInstant *last = state->instants[state->count - 1];
+  ensure_increasing_timestamps(last, inst, true); /* > */
+  ensure_spatial_validity((Temporal *) last, (Temporal *) inst);
+  if (last->t != inst->t)
+    return false;
+  if (! datum_eq(tinstant_value(last), tinstant_value(inst),
+      inst->valuetypid))
   {
-    result = palloc(sizeof(Temporal *));
-    result[0] = (Temporal *)tsequence_transform_tagg(
-      (TSequence *) temp, func);
-    *count = 1;
+    char *t1 = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(inst->t));
+    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+      errmsg("The temporal values have different value at their overlapping instant %s", t1)));
   }
-  else /* temp->duration == SEQUENCESET */
+  return true;
+}
+
+/**
+ * Appends a copy of the instant to the state, growing its capacity if needed
+ */
+void
+appendstate_append(AppendState *state, const TInstant *inst)
+{
+  if (state->count == state->capacity)
   {
-    result = (Temporal **)tsequenceset_transform_tagg(
-      (TSequenceSet *) temp, func);
-    *count = ((TSequenceSet *)temp)->count;
+    state->capacity *= APPENDSTATE_GROW;
+    state->instants = repalloc(state->instants,
+      sizeof(TInstant *) * state->capacity);
   }
-  assert(result != NULL);
-  return result;
+  state->instants[state->count++] = tinstant_copy(inst);
 }
 
-/*****************************************************************************/
-
+PG_FUNCTION_INFO_V1(temporal_append_tinstant_transfn);
 /**
- * Transition function for aggregating temporal values that require a
- * transformation to each composing instant/sequence
- * 
- * @param[in] fcinfo Catalog information about the external function
- * @param[in] func Aggregate function
- * @param[in] crossings State whether turning points are added in the segments
- * @param[in] transform Transform function
+ * Transition function for the aggregation that appends temporal instants
+ *
+ * Contrary to the appendInstant function, which copies the whole temporal
+ * value for every new instant, the instants are accumulated in an array
+ * with slack capacity, so that the sequence, its bounding box, and its
+ * trajectory are only computed once by the final function.
  */
-Datum
-temporal_tagg_transform_transfn(FunctionCallInfo fcinfo, 
-  Datum (*func)(Datum, Datum), bool crossings,
-  TInstant *(*transform)(const TInstant *))
+PGDLLEXPORT Datum
+temporal_append_tinstant_transfn(PG_FUNCTION_ARGS)
 {
-  SkipList *state = PG_ARGISNULL(0) ? NULL : 
-    (SkipList *) PG_GETARG_POINTER(0);
+  AppendState *state = PG_ARGISNULL(0) ? NULL :
+    (AppendState *) PG_GETARG_POINTER(0);
   if (PG_ARGISNULL(1))
   {
     if (state)
@@ -1380,142 +3268,330 @@ temporal_tagg_transform_transfn(FunctionCallInfo fcinfo,
   }
 
   Temporal *temp = PG_GETARG_TEMPORAL(1);
-  int count;
-  Temporal **temparr = temporal_transform_tagg(temp, &count, transform);
-  if (state)
+  if (temp->duration != INSTANT)
+    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+      errmsg("The argument must be of instant duration")));
+  TInstant *inst = (TInstant *) temp;
+  MemoryContext oldctx = set_aggregation_context(fcinfo);
+  if (! state)
   {
-    if (skiplist_headval(state)->duration != temparr[0]->duration)
-      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-        errmsg("Cannot aggregate temporal values of different duration")));
-    skiplist_splice(fcinfo, state, temparr, count, func, crossings);
+    state = palloc(sizeof(AppendState));
+    appendstate_init(state);
   }
-  else
-    state = skiplist_make(fcinfo, temparr, count);
-
-  for (int i = 0; i< count; i++)
-    pfree(temparr[i]);
-  pfree(temparr);
+  /* Do not append the instant if it is already in the state */
+  if (! appendstate_has_last(state, inst))
+    appendstate_append(state, inst);
+  unset_aggregation_context(oldctx);
   PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_POINTER(state);
 }
 
+PG_FUNCTION_INFO_V1(temporal_append_finalfn);
+/**
+ * Final function for the aggregation that appends temporal instants
+ */
+PGDLLEXPORT Datum
+temporal_append_finalfn(PG_FUNCTION_ARGS)
+{
+  /* The final function is strict, we do not need to test for null values */
+  AppendState *state = (AppendState *) PG_GETARG_POINTER(0);
+  if (state->count == 0)
+    PG_RETURN_NULL();
+
+  TSequence *result = tsequence_make(state->instants, state->count,
+    true, true, MOBDB_FLAGS_GET_LINEAR(state->instants[0]->flags), NORMALIZE);
+  PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************
- * Temporal count
+ * Bucketed aggregates
+ *
+ * These aggregates compute a single value for each bucket of a fixed size
+ * aligned to an origin instead of the exact piecewise result. Their state
+ * is a dense array of accumulators for the buckets covered by the values,
+ * to which each value adds its time-weighted contribution.
  *****************************************************************************/
 
 /**
- * Transform a temporal instant value into a temporal integer value for
- * performing temporal count aggregation 
+ * Returns the size in microseconds of the buckets defined by the interval
  */
-static TInstant *
-tinstant_transform_tcount(const TInstant *inst)
+static int64
+bucket_size(const Interval *interval)
 {
-  return tinstant_make(Int32GetDatum(1), inst->t, INT4OID);
+  if (interval->month != 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The interval of the buckets cannot have months")));
+  int64 result = interval->time + interval->day * USECS_PER_DAY;
+  if (result <= 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The interval of the buckets must be positive")));
+  return result;
 }
 
 /**
- * Transform a temporal instant set value into a temporal integer value for
- * performing temporal count aggregation 
+ * Returns the index of the bucket of the given size and origin containing
+ * the timestamp
  */
-static TInstant **
-tinstantset_transform_tcount(const TInstantSet *ti)
+static int64
+bucket_index1(int64 size, TimestampTz origin, TimestampTz t)
 {
-  TInstant **result = palloc(sizeof(TInstant *) * ti->count);
-  Datum datum_one = Int32GetDatum(1);
-  for (int i = 0; i < ti->count; i++)
+  int64 delta = t - origin;
+  int64 result = delta / size;
+  /* Round towards minus infinity */
+  if (delta % size < 0)
+    result--;
+  return result;
+}
+
+/**
+ * Returns the index of the bucket containing the timestamp
+ */
+static int64
+bucket_index(const BucketState *state, TimestampTz t)
+{
+  return bucket_index1(state->size, state->origin, t);
+}
+
+/**
+ * Returns the lower bound of the bucket with the given index
+ */
+static TimestampTz
+bucket_lower(const BucketState *state, int64 index)
+{
+  return state->origin + index * state->size;
+}
+
+/**
+ * Construct an empty state of buckets in the current memory context
+ */
+static BucketState *
+bucketstate_make1(int64 size, TimestampTz origin)
+{
+  BucketState *result = palloc(sizeof(BucketState));
+  result->size = size;
+  /* Normalize the origin so that the indexes of the buckets of two states
+   * with equivalent origins are the same */
+  result->origin = origin % size;
+  if (result->origin < 0)
+    result->origin += size;
+  result->first = 0;
+  result->count = 0;
+  result->capacity = BUCKETSTATE_INITIAL_CAPACITY;
+  result->buckets = palloc0(sizeof(BucketAcc) * result->capacity);
+  return result;
+}
+
+/**
+ * Construct an empty state for a bucketed aggregation
+ */
+static BucketState *
+bucketstate_make(FunctionCallInfo fcinfo, int64 size, TimestampTz origin)
+{
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  BucketState *result = bucketstate_make1(size, origin);
+  unset_aggregation_context(ctx);
+  return result;
+}
+
+/**
+ * Ensure that the two states of a bucketed aggregation have the same buckets
+ */
+static void
+ensure_same_buckets(const BucketState *state, int64 size, TimestampTz origin)
+{
+  TimestampTz origin1 = origin % size;
+  if (origin1 < 0)
+    origin1 += size;
+  if (state->size != size || state->origin != origin1)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The values must be aggregated with the same buckets")));
+}
+
+/**
+ * Returns the accumulator of the bucket with the given index, extending
+ * the dense array of buckets of the state if needed
+ */
+static BucketAcc *
+bucketstate_get(BucketState *state, int64 index)
+{
+  if (state->count == 0)
   {
-    TInstant *inst = tinstantset_inst_n(ti, i);
-    result[i] = tinstant_make(datum_one, inst->t, INT4OID);
+    state->first = index;
+    state->count = 1;
+    return &state->buckets[0];
+  }
+  if (index < state->first || index >= state->first + state->count)
+  {
+    int64 first = Min(state->first, index);
+    int64 count = Max(state->first + state->count, index + 1) - first;
+    if ((Size) count > MaxAllocSize / sizeof(BucketAcc))
+      ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+        errmsg("Too many buckets for the time span of the values")));
+    if (count > state->capacity)
+    {
+      int64 capacity = state->capacity;
+      while (capacity < count)
+        capacity <<= 1;
+      capacity = Min(capacity, (int64) (MaxAllocSize / sizeof(BucketAcc)));
+      /* The array keeps the memory context in which it was allocated */
+      state->buckets = repalloc(state->buckets, sizeof(BucketAcc) * capacity);
+      state->capacity = (int) capacity;
+    }
+    int shift = (int) (state->first - first);
+    if (shift > 0)
+    {
+      memmove(&state->buckets[shift], state->buckets,
+        sizeof(BucketAcc) * state->count);
+      memset(state->buckets, 0, sizeof(BucketAcc) * shift);
+    }
+    memset(&state->buckets[shift + state->count], 0,
+      sizeof(BucketAcc) * (count - shift - state->count));
+    state->first = first;
+    state->count = (int) count;
   }
-  return result;
+  return &state->buckets[index - state->first];
 }
 
 /**
- * Transform a temporal sequence value into a temporal integer value for
- * performing temporal count aggregation 
+ * Add the contribution of the temporal instant value to the buckets
+ *
+ * @param[inout] state State
+ * @param[in] inst Temporal value
+ * @param[in] number True when the values must be accumulated
+ * @param[inout] last Index of the last bucket counting the value
  */
-static TSequence *
-tsequence_transform_tcount(const TSequence *seq)
+static void
+tinstant_bucket_add(BucketState *state, const TInstant *inst, bool number,
+  int64 *last)
 {
-  TSequence *result;
-  Datum datum_one = Int32GetDatum(1);
-  if (seq->count == 1)
+  int64 index = bucket_index(state, inst->t);
+  BucketAcc *acc = bucketstate_get(state, index);
+  if (index > *last)
   {
-    TInstant *inst = tinstant_make(datum_one, seq->period.lower, INT4OID);
-    result = tinstant_to_tsequence(inst, STEP);
-    pfree(inst);
-    return result;
+    acc->count++;
+    *last = index;
   }
-
-  TInstant *instants[2];
-  instants[0] = tinstant_make(datum_one, seq->period.lower, INT4OID);
-  instants[1] = tinstant_make(datum_one, seq->period.upper, INT4OID);
-  result = tsequence_make(instants, 2, seq->period.lower_inc,
-    seq->period.upper_inc, STEP, NORMALIZE_NO);
-  pfree(instants[0]); pfree(instants[1]); 
-  return result;
+  if (number)
+  {
+    acc->sum += datum_double(tinstant_value(inst), inst->valuetypid);
+    acc->instants++;
+  }
+  return;
 }
 
 /**
- * Transform a temporal sequence set value into a temporal integer value for
- * performing temporal count aggregation 
+ * Add the contribution of the temporal sequence value to the buckets,
+ * where each segment is split at the bounds of the buckets
+ *
+ * @param[inout] state State
+ * @param[in] seq Temporal value
+ * @param[in] number True when the values must be accumulated
+ * @param[inout] last Index of the last bucket counting the value
  */
-static TSequence **
-tsequenceset_transform_tcount(const TSequenceSet *ts)
+static void
+tsequence_bucket_add(BucketState *state, const TSequence *seq, bool number,
+  int64 *last)
 {
-  TSequence **result = palloc(sizeof(TSequence *) * ts->count);
-  for (int i = 0; i < ts->count; i++)
+  if (seq->count == 1)
   {
-    TSequence *seq = tsequenceset_seq_n(ts, i);
-    result[i] = tsequence_transform_tcount(seq);
+    tinstant_bucket_add(state, tsequence_inst_n(seq, 0), number, last);
+    return;
   }
-  return result;
+
+  /* Count the value in every bucket intersecting its period */
+  int64 first = bucket_index(state, seq->period.lower);
+  int64 lastidx = bucket_index(state, seq->period.upper);
+  bool upperbound = bucket_lower(state, lastidx) == seq->period.upper;
+  if (upperbound && ! seq->period.upper_inc)
+    lastidx--;
+  for (int64 i = Max(first, *last + 1); i <= lastidx; i++)
+    bucketstate_get(state, i)->count++;
+  *last = Max(*last, lastidx);
+  if (! number)
+    return;
+
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  TInstant *inst1 = tsequence_inst_n(seq, 0);
+  double value1 = datum_double(tinstant_value(inst1), inst1->valuetypid);
+  for (int i = 1; i < seq->count; i++)
+  {
+    TInstant *inst2 = tsequence_inst_n(seq, i);
+    double value2 = datum_double(tinstant_value(inst2), inst2->valuetypid);
+    double segduration = (double) (inst2->t - inst1->t);
+    TimestampTz lower = inst1->t;
+    int64 index = bucket_index(state, lower);
+    double lvalue = value1;
+    while (lower < inst2->t)
+    {
+      TimestampTz upper = Min(bucket_lower(state, index + 1), inst2->t);
+      double uvalue = linear ?
+        value1 + (value2 - value1) * (double) (upper - inst1->t) / segduration :
+        value1;
+      BucketAcc *acc = bucketstate_get(state, index);
+      double duration = (double) (upper - lower);
+      acc->integral += (lvalue + uvalue) / 2 * duration;
+      acc->duration += duration;
+      lower = upper;
+      lvalue = uvalue;
+      index++;
+    }
+    inst1 = inst2;
+    value1 = value2;
+  }
+  /* An inclusive upper bound at the lower bound of a bucket only
+   * contributes with its instant to this bucket */
+  if (upperbound && seq->period.upper_inc)
+  {
+    BucketAcc *acc = bucketstate_get(state, lastidx);
+    acc->sum += value1;
+    acc->instants++;
+  }
+  return;
 }
 
 /**
- * Transform a temporal value into a temporal integer value for
- * performing temporal count aggregation (dispatch function)
+ * Add the contribution of the temporal value to the buckets (dispatch 
+ * function)
  */
-static Temporal **
-temporal_transform_tcount(const Temporal *temp, int *count)
+static void
+temporal_bucket_add(BucketState *state, const Temporal *temp, bool number)
 {
-  Temporal **result;
-  if (temp->duration == INSTANT) 
-  {
-    result = palloc(sizeof(Temporal *));
-    result[0] = (Temporal *)tinstant_transform_tcount((TInstant *)temp);
-    *count = 1;
-  }
+  int64 last = PG_INT64_MIN;
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+    tinstant_bucket_add(state, (TInstant *) temp, number, &last);
   else if (temp->duration == INSTANTSET)
   {
-    result = (Temporal **)tinstantset_transform_tcount((TInstantSet *) temp);
-    *count = ((TInstantSet *)temp)->count;
-  } 
-  else if (temp->duration == SEQUENCE)
-  {
-    result = palloc(sizeof(Temporal *));
-    result[0] = (Temporal *)tsequence_transform_tcount((TSequence *) temp);
-    *count = 1;
+    TInstantSet *ti = (TInstantSet *) temp;
+    for (int i = 0; i < ti->count; i++)
+      tinstant_bucket_add(state, tinstantset_inst_n(ti, i), number, &last);
   }
+  else if (temp->duration == SEQUENCE)
+    tsequence_bucket_add(state, (TSequence *) temp, number, &last);
   else /* temp->duration == SEQUENCESET */
   {
-    result = (Temporal **)tsequenceset_transform_tcount((TSequenceSet *) temp);
-    *count = ((TSequenceSet *)temp)->count;
+    TSequenceSet *ts = (TSequenceSet *) temp;
+    for (int i = 0; i < ts->count; i++)
+      tsequence_bucket_add(state, tsequenceset_seq_n(ts, i), number, &last);
   }
-  assert(result != NULL);
-  return result;
+  return;
 }
 
-PG_FUNCTION_INFO_V1(temporal_tcount_transfn);
 /**
- * Generic transition function for temporal aggregation
+ * Generic transition function for bucketed aggregation
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] number True when the values must be accumulated
+ * @note The origin of the buckets is optional and defaults to Monday,
+ * January 3, 2000, as for the date_bin function of PostgreSQL
  */
-PGDLLEXPORT Datum 
-temporal_tcount_transfn(PG_FUNCTION_ARGS)
+static Datum
+temporal_bucket_transfn(FunctionCallInfo fcinfo, bool number)
 {
-  SkipList *state = PG_ARGISNULL(0) ? NULL : 
-    (SkipList *) PG_GETARG_POINTER(0);
-  if (PG_ARGISNULL(1))
+  BucketState *state = PG_ARGISNULL(0) ? NULL :
+    (BucketState *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1) || PG_ARGISNULL(2) ||
+    (PG_NARGS() > 3 && PG_ARGISNULL(3)))
   {
     if (state)
       PG_RETURN_POINTER(state);
@@ -1524,469 +3600,973 @@ temporal_tcount_transfn(PG_FUNCTION_ARGS)
   }
 
   Temporal *temp = PG_GETARG_TEMPORAL(1);
-  int count;
-  Temporal **tsequenceset = temporal_transform_tcount(temp, &count);
+  int64 size = bucket_size(PG_GETARG_INTERVAL_P(2));
+  TimestampTz origin = (PG_NARGS() > 3) ? PG_GETARG_TIMESTAMPTZ(3) :
+    2 * USECS_PER_DAY;
   if (state)
-  {
-    if (skiplist_headval(state)->duration != tsequenceset[0]->duration)
-      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-        errmsg("Cannot aggregate temporal values of different duration")));
-    skiplist_splice(fcinfo, state, tsequenceset, count, &datum_sum_int32, false);
-  }
+    ensure_same_buckets(state, size, origin);
   else
-    state = skiplist_make(fcinfo, tsequenceset, count);
-
-  for (int i = 0; i< count; i++)
-    pfree(tsequenceset[i]);
-  pfree(tsequenceset);
+    state = bucketstate_make(fcinfo, size, origin);
+  temporal_bucket_add(state, temp, number);
   PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_POINTER(state);
 }
 
-PG_FUNCTION_INFO_V1(temporal_tcount_combinefn);
+PG_FUNCTION_INFO_V1(temporal_tcount_bucket_transfn);
 /**
- * Generic combine function for temporal aggregation
+ * Transition function for bucketed temporal count
  */
-PGDLLEXPORT Datum 
-temporal_tcount_combinefn(PG_FUNCTION_ARGS)
+PGDLLEXPORT Datum
+temporal_tcount_bucket_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_sum_int32, false);
+  return temporal_bucket_transfn(fcinfo, false);
 }
 
-/*****************************************************************************
- * Temporal extent
- *****************************************************************************/
+PG_FUNCTION_INFO_V1(tnumber_tavg_bucket_transfn);
+/**
+ * Transition function for bucketed temporal average
+ */
+PGDLLEXPORT Datum
+tnumber_tavg_bucket_transfn(PG_FUNCTION_ARGS)
+{
+  return temporal_bucket_transfn(fcinfo, true);
+}
 
-PG_FUNCTION_INFO_V1(temporal_extent_transfn);
+PG_FUNCTION_INFO_V1(temporal_bucket_combinefn);
 /**
- * Transition function for temporal extent aggregation of temporal values
- * with period bounding box
+ * Combine function for bucketed aggregation, which adds the accumulators
+ * of the buckets of the second state to those of the first one
  */
-PGDLLEXPORT Datum 
-temporal_extent_transfn(PG_FUNCTION_ARGS)
+PGDLLEXPORT Datum
+temporal_bucket_combinefn(PG_FUNCTION_ARGS)
 {
-  Period *p = PG_ARGISNULL(0) ? NULL : PG_GETARG_PERIOD(0);
-  Temporal *temp = PG_ARGISNULL(1) ? NULL : PG_GETARG_TEMPORAL(1);
-  Period *result;
-  
-  /* Can't do anything with null inputs */
-  if (!p && !temp)
+  BucketState *state1 = PG_ARGISNULL(0) ? NULL :
+    (BucketState *) PG_GETARG_POINTER(0);
+  BucketState *state2 = PG_ARGISNULL(1) ? NULL :
+    (BucketState *) PG_GETARG_POINTER(1);
+  if (state1 == NULL && state2 == NULL)
     PG_RETURN_NULL();
-  /* Null period and non-null temporal, return the bbox of the temporal */
-  if (!p)
-  {
-    result = palloc0(sizeof(Period));
-    temporal_bbox(result, temp);
-    PG_RETURN_POINTER(result);
-  }
-  /* Non-null period and null temporal, return the period */
-  if (!temp)
+  if (state1 == NULL)
+    PG_RETURN_POINTER(state2);
+  if (state2 == NULL || state2->count == 0)
+    PG_RETURN_POINTER(state1);
+
+  ensure_same_buckets(state1, state2->size, state2->origin);
+  /* Extend the array of the first state to the buckets of the second one */
+  bucketstate_get(state1, state2->first + state2->count - 1);
+  BucketAcc *acc1 = bucketstate_get(state1, state2->first);
+  for (int i = 0; i < state2->count; i++)
   {
-    result = palloc0(sizeof(Period));
-    memcpy(result, p, sizeof(Period));
-    PG_RETURN_POINTER(result);
+    BucketAcc *acc2 = &state2->buckets[i];
+    acc1[i].count += acc2->count;
+    acc1[i].instants += acc2->instants;
+    acc1[i].sum += acc2->sum;
+    acc1[i].integral += acc2->integral;
+    acc1[i].duration += acc2->duration;
   }
+  PG_RETURN_POINTER(state1);
+}
 
-  Period p1;
-  temporal_bbox(&p1, temp);
-  result = period_super_union(p, &p1);
+PG_FUNCTION_INFO_V1(temporal_bucket_serialize);
+/**
+ * Serialize the state of a bucketed aggregation
+ */
+PGDLLEXPORT Datum
+temporal_bucket_serialize(PG_FUNCTION_ARGS)
+{
+  BucketState *state = (BucketState *) PG_GETARG_POINTER(0);
+  size_t size = offsetof(BucketState, capacity);
+  size_t datasize = sizeof(BucketAcc) * state->count;
+  bytea *result = palloc(VARHDRSZ + size + datasize);
+  SET_VARSIZE(result, VARHDRSZ + size + datasize);
+  memcpy(VARDATA(result), state, size);
+  memcpy(VARDATA(result) + size, state->buckets, datasize);
+  PG_RETURN_BYTEA_P(result);
+}
 
-  PG_FREE_IF_COPY(temp, 1);
+PG_FUNCTION_INFO_V1(temporal_bucket_deserialize);
+/**
+ * Deserialize the state of a bucketed aggregation
+ */
+PGDLLEXPORT Datum
+temporal_bucket_deserialize(PG_FUNCTION_ARGS)
+{
+  bytea *data = PG_GETARG_BYTEA_P(0);
+  size_t size = offsetof(BucketState, capacity);
+  BucketState header;
+  memcpy(&header, VARDATA(data), size);
+  BucketState *result = bucketstate_make(fcinfo, header.size, header.origin);
+  if (header.count > 0)
+  {
+    bucketstate_get(result, header.first + header.count - 1);
+    BucketAcc *acc = bucketstate_get(result, header.first);
+    memcpy(acc, VARDATA(data) + size, sizeof(BucketAcc) * header.count);
+  }
   PG_RETURN_POINTER(result);
 }
 
-PG_FUNCTION_INFO_V1(temporal_extent_combinefn);
+PG_FUNCTION_INFO_V1(temporal_tcount_bucket_finalfn);
 /**
- * Combine function for temporal extent aggregation
+ * Final function for bucketed temporal count, which returns a temporal 
+ * integer whose instants are the lower bounds of the buckets
  */
-PGDLLEXPORT Datum 
-temporal_extent_combinefn(PG_FUNCTION_ARGS)
+PGDLLEXPORT Datum
+temporal_tcount_bucket_finalfn(PG_FUNCTION_ARGS)
 {
-  Period *p1 = PG_ARGISNULL(0) ? NULL : PG_GETARG_PERIOD(0);
-  Period *p2 = PG_ARGISNULL(1) ? NULL : PG_GETARG_PERIOD(1);
-
-  if (!p2 && !p1)
+  /* The final function is strict, we do not need to test for null values */
+  BucketState *state = (BucketState *) PG_GETARG_POINTER(0);
+  TInstant **instants = palloc(sizeof(TInstant *) * Max(state->count, 1));
+  int k = 0;
+  for (int i = 0; i < state->count; i++)
+  {
+    if (state->buckets[i].count > 0)
+      instants[k++] = tinstant_make(Int32GetDatum(state->buckets[i].count),
+        bucket_lower(state, state->first + i), INT4OID);
+  }
+  if (k == 0)
+  {
+    pfree(instants);
     PG_RETURN_NULL();
-  if (p1 && !p2)
-    PG_RETURN_POINTER(p1);
-  if (p2 && !p1)
-    PG_RETURN_POINTER(p2);
-
-  Period *result = period_super_union(p1, p2);
+  }
+  TInstantSet *result = tinstantset_make_free(instants, k);
   PG_RETURN_POINTER(result);
 }
 
-/*****************************************************************************/
-
-PG_FUNCTION_INFO_V1(tnumber_extent_transfn);
 /**
- * Transition function for temporal extent aggregation for temporal numbers
+ * Returns a temporal float whose instants are the lower bounds of the
+ * buckets of the state. The value of a bucket is the time-weighted average
+ * of the values during the bucket, or the average of the values of its
+ * instants for instantaneous values.
+ *
+ * @result Temporal instant set value, or NULL if the state has no values
  */
-PGDLLEXPORT Datum 
-tnumber_extent_transfn(PG_FUNCTION_ARGS)
+static TInstantSet *
+bucketstate_tavg(const BucketState *state)
 {
-  TBOX *box = PG_ARGISNULL(0) ? NULL : PG_GETARG_TBOX_P(0);
-  Temporal *temp = PG_ARGISNULL(1) ? NULL : PG_GETARG_TEMPORAL(1);
-
-  /* Can't do anything with null inputs */
-  if (!box && !temp)
-    PG_RETURN_NULL();
-  TBOX *result = palloc0(sizeof(TBOX));
-  /* Null box and non-null temporal, return the bbox of the temporal */
-  if (!box)
+  TInstant **instants = palloc(sizeof(TInstant *) * Max(state->count, 1));
+  int k = 0;
+  for (int i = 0; i < state->count; i++)
   {
-    temporal_bbox(result, temp);
-    PG_RETURN_POINTER(result);
+    BucketAcc *acc = &state->buckets[i];
+    if (acc->duration == 0 && acc->instants == 0)
+      continue;
+    double value = (acc->duration > 0) ? acc->integral / acc->duration :
+      acc->sum / acc->instants;
+    instants[k++] = tinstant_make(Float8GetDatum(value),
+      bucket_lower(state, state->first + i), FLOAT8OID);
   }
-  /* Non-null box and null temporal, return the box */
-  if (!temp)
+  if (k == 0)
   {
-    memcpy(result, box, sizeof(TBOX));
-    PG_RETURN_POINTER(result);
+    pfree(instants);
+    return NULL;
   }
-
-  /* Both box and temporal are not null */
-  temporal_bbox(result, temp);
-  tbox_expand(result, box);
-  PG_FREE_IF_COPY(temp, 1);
-  PG_RETURN_POINTER(result);
+  return tinstantset_make_free(instants, k);
 }
 
-PG_FUNCTION_INFO_V1(tnumber_extent_combinefn);
+PG_FUNCTION_INFO_V1(tnumber_tavg_bucket_finalfn);
 /**
- * Combine function for temporal extent aggregation for temporal numbers
+ * Final function for bucketed temporal average
  */
-PGDLLEXPORT Datum 
-tnumber_extent_combinefn(PG_FUNCTION_ARGS)
+PGDLLEXPORT Datum
+tnumber_tavg_bucket_finalfn(PG_FUNCTION_ARGS)
 {
-  TBOX *box1 = PG_ARGISNULL(0) ? NULL : PG_GETARG_TBOX_P(0);
-  TBOX *box2 = PG_ARGISNULL(1) ? NULL : PG_GETARG_TBOX_P(1);
-
-  if (!box2 && !box1)
+  /* The final function is strict, we do not need to test for null values */
+  BucketState *state = (BucketState *) PG_GETARG_POINTER(0);
+  TInstantSet *result = bucketstate_tavg(state);
+  if (result == NULL)
     PG_RETURN_NULL();
-  if (box1 && !box2)
-    PG_RETURN_POINTER(box1);
-  if (box2 && !box1)
-    PG_RETURN_POINTER(box2);
-  /* Both boxes are not null */
-  ensure_same_dimensionality_tbox(box1, box2);
-  TBOX *result = tbox_copy(box1);
-  tbox_expand(result, box2);
   PG_RETURN_POINTER(result);
 }
 
 /*****************************************************************************
- * Temporal boolean functions
+ * Approximate distinct counts
+ *
+ * These aggregates estimate for each bucket the number of distinct objects
+ * whose value intersects the bucket. The state keeps a HyperLogLog sketch
+ * of HLL_REGISTERS registers per bucket, so that its size only depends on
+ * the time span of the values, and the sketches of two states are merged by
+ * taking the maximum of their registers.
  *****************************************************************************/
 
-PG_FUNCTION_INFO_V1(tbool_tand_transfn);
 /**
- * Transition function for temporal and aggregation of temporal boolean values
+ * Construct an empty state for an approximate distinct count in the
+ * current memory context
  */
-PGDLLEXPORT Datum
-tbool_tand_transfn(PG_FUNCTION_ARGS)
+static HllState *
+hllstate_make1(int64 size, TimestampTz origin)
 {
-  return temporal_tagg_transfn(fcinfo, &datum_and, CROSSINGS_NO);
+  HllState *result = palloc(sizeof(HllState));
+  result->size = size;
+  /* Normalize the origin as for the other bucketed aggregates */
+  result->origin = origin % size;
+  if (result->origin < 0)
+    result->origin += size;
+  result->first = 0;
+  result->count = 0;
+  result->capacity = HLLSTATE_INITIAL_CAPACITY;
+  result->registers = palloc0(HLL_REGISTERS * result->capacity);
+  return result;
 }
 
-PG_FUNCTION_INFO_V1(tbool_tand_combinefn);
 /**
- * Combine function for temporal and aggregation of temporal boolean values
+ * Construct an empty state for an approximate distinct count
  */
-PGDLLEXPORT Datum
-tbool_tand_combinefn(PG_FUNCTION_ARGS)
+static HllState *
+hllstate_make(FunctionCallInfo fcinfo, int64 size, TimestampTz origin)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_and, CROSSINGS_NO);
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  HllState *result = hllstate_make1(size, origin);
+  unset_aggregation_context(ctx);
+  return result;
 }
 
-PG_FUNCTION_INFO_V1(tbool_tor_transfn);
 /**
- * Transition function for temporal or aggregation of temporal boolean values
+ * Ensure that the two states of an approximate distinct count have the
+ * same buckets
  */
-PGDLLEXPORT Datum
-tbool_tor_transfn(PG_FUNCTION_ARGS)
+static void
+ensure_same_hll_buckets(const HllState *state, int64 size,
+  TimestampTz origin)
+{
+  TimestampTz origin1 = origin % size;
+  if (origin1 < 0)
+    origin1 += size;
+  if (state->size != size || state->origin != origin1)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The values must be aggregated with the same buckets")));
+}
+
+/**
+ * Returns the registers of the bucket with the given index, extending the
+ * dense array of buckets of the state if needed
+ */
+static uint8 *
+hllstate_get(HllState *state, int64 index)
+{
+  if (state->count == 0)
+  {
+    state->first = index;
+    state->count = 1;
+    return state->registers;
+  }
+  if (index < state->first || index >= state->first + state->count)
+  {
+    int64 first = Min(state->first, index);
+    int64 count = Max(state->first + state->count, index + 1) - first;
+    if ((Size) count > MaxAllocSize / HLL_REGISTERS)
+      ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+        errmsg("Too many buckets for the time span of the values")));
+    if (count > state->capacity)
+    {
+      int64 capacity = state->capacity;
+      while (capacity < count)
+        capacity <<= 1;
+      capacity = Min(capacity, (int64) (MaxAllocSize / HLL_REGISTERS));
+      /* The array keeps the memory context in which it was allocated */
+      state->registers = repalloc(state->registers, HLL_REGISTERS * capacity);
+      state->capacity = (int) capacity;
+    }
+    int shift = (int) (state->first - first);
+    if (shift > 0)
+    {
+      memmove(&state->registers[HLL_REGISTERS * shift], state->registers,
+        HLL_REGISTERS * state->count);
+      memset(state->registers, 0, HLL_REGISTERS * shift);
+    }
+    memset(&state->registers[HLL_REGISTERS * (shift + state->count)], 0,
+      HLL_REGISTERS * (count - shift - state->count));
+    state->first = first;
+    state->count = (int) count;
+  }
+  return &state->registers[HLL_REGISTERS * (index - state->first)];
+}
+
+/**
+ * Add the hash of an object to the registers of the buckets first to last
+ */
+static void
+hllstate_add(HllState *state, int64 first, int64 last, uint64 hash)
+{
+  /* The first bits of the hash select the register, the position of the
+   * first 1 bit of the others is the rank kept by the register */
+  int reg = (int) (hash >> (64 - HLL_PRECISION));
+  uint64 rest = hash << HLL_PRECISION;
+  uint8 rank = 1;
+  while (rank <= 64 - HLL_PRECISION && (rest & UINT64CONST(0x8000000000000000)) == 0)
+  {
+    rank++;
+    rest <<= 1;
+  }
+  for (int64 i = first; i <= last; i++)
+  {
+    uint8 *registers = hllstate_get(state, i);
+    if (registers[reg] < rank)
+      registers[reg] = rank;
+  }
+  return;
+}
+
+/**
+ * Add the hash of an object to the registers of the buckets intersecting
+ * its temporal value
+ */
+static void
+temporal_hll_add(HllState *state, const Temporal *temp, uint64 hash)
+{
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT || temp->duration == INSTANTSET)
+  {
+    int count = (temp->duration == INSTANT) ? 1 : ((TInstantSet *) temp)->count;
+    for (int i = 0; i < count; i++)
+    {
+      TInstant *inst = (temp->duration == INSTANT) ? (TInstant *) temp :
+        tinstantset_inst_n((TInstantSet *) temp, i);
+      int64 index = bucket_index1(state->size, state->origin, inst->t);
+      hllstate_add(state, index, index, hash);
+    }
+  }
+  else
+  {
+    int count = (temp->duration == SEQUENCE) ? 1 : ((TSequenceSet *) temp)->count;
+    for (int i = 0; i < count; i++)
+    {
+      TSequence *seq = (temp->duration == SEQUENCE) ? (TSequence *) temp :
+        tsequenceset_seq_n((TSequenceSet *) temp, i);
+      int64 first = bucket_index1(state->size, state->origin,
+        seq->period.lower);
+      int64 last = bucket_index1(state->size, state->origin,
+        seq->period.upper);
+      /* An exclusive upper bound at the lower bound of a bucket does not
+       * intersect it */
+      if (last > first && ! seq->period.upper_inc &&
+        state->origin + last * state->size == seq->period.upper)
+        last--;
+      hllstate_add(state, first, last, hash);
+    }
+  }
+  return;
+}
+
+/**
+ * Returns the HyperLogLog estimate of the number of distinct objects whose
+ * hashes were added to the registers
+ */
+static int
+hll_estimate(const uint8 *registers)
 {
-  return temporal_tagg_transfn(fcinfo, &datum_or, CROSSINGS_NO);
+  const double m = HLL_REGISTERS;
+  double sum = 0;
+  int zeros = 0;
+  for (int i = 0; i < HLL_REGISTERS; i++)
+  {
+    sum += ldexp(1.0, - registers[i]);
+    if (registers[i] == 0)
+      zeros++;
+  }
+  double result = (0.7213 / (1 + 1.079 / m)) * m * m / sum;
+  /* Linear counting is more precise for small cardinalities */
+  if (result <= 2.5 * m && zeros > 0)
+    result = m * log(m / zeros);
+  return (int) rint(result);
 }
 
-PG_FUNCTION_INFO_V1(tbool_tor_combinefn);
+PG_FUNCTION_INFO_V1(temporal_tcount_approx_transfn);
 /**
- * Combine function for temporal or aggregation of temporal boolean values
+ * Transition function for approximate distinct temporal count
+ *
+ * @note The origin of the buckets is optional and defaults to Monday,
+ * January 3, 2000, as for the other bucketed aggregates
  */
 PGDLLEXPORT Datum
-tbool_tor_combinefn(PG_FUNCTION_ARGS)
+temporal_tcount_approx_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_or, CROSSINGS_NO);
-}
+  HllState *state = PG_ARGISNULL(0) ? NULL :
+    (HllState *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1) || PG_ARGISNULL(2) || PG_ARGISNULL(3) ||
+    (PG_NARGS() > 4 && PG_ARGISNULL(4)))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
 
-/*****************************************************************************/
+  int64 id = PG_GETARG_INT64(1);
+  Temporal *temp = PG_GETARG_TEMPORAL(2);
+  int64 size = bucket_size(PG_GETARG_INTERVAL_P(3));
+  TimestampTz origin = (PG_NARGS() > 4) ? PG_GETARG_TIMESTAMPTZ(4) :
+    2 * USECS_PER_DAY;
+  if (state)
+    ensure_same_hll_buckets(state, size, origin);
+  else
+    state = hllstate_make(fcinfo, size, origin);
+  uint64 hash = DatumGetUInt64(hash_any_extended((unsigned char *) &id,
+    sizeof(int64), 0));
+  temporal_hll_add(state, temp, hash);
+  PG_FREE_IF_COPY(temp, 2);
+  PG_RETURN_POINTER(state);
+}
 
-PG_FUNCTION_INFO_V1(tint_tmin_transfn);
+PG_FUNCTION_INFO_V1(temporal_tcount_approx_combinefn);
 /**
- * Transition function for temporal minimum aggregation of temporal integer values
+ * Combine function for approximate distinct temporal count, which merges
+ * the sketches of the buckets of the second state into those of the first
+ * one
  */
 PGDLLEXPORT Datum
-tint_tmin_transfn(PG_FUNCTION_ARGS)
+temporal_tcount_approx_combinefn(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_transfn(fcinfo, &datum_min_int32, CROSSINGS_NO);
+  HllState *state1 = PG_ARGISNULL(0) ? NULL :
+    (HllState *) PG_GETARG_POINTER(0);
+  HllState *state2 = PG_ARGISNULL(1) ? NULL :
+    (HllState *) PG_GETARG_POINTER(1);
+  if (state1 == NULL && state2 == NULL)
+    PG_RETURN_NULL();
+  if (state1 == NULL)
+    PG_RETURN_POINTER(state2);
+  if (state2 == NULL || state2->count == 0)
+    PG_RETURN_POINTER(state1);
+
+  ensure_same_hll_buckets(state1, state2->size, state2->origin);
+  /* Extend the array of the first state to the buckets of the second one */
+  hllstate_get(state1, state2->first + state2->count - 1);
+  uint8 *registers1 = hllstate_get(state1, state2->first);
+  for (int i = 0; i < HLL_REGISTERS * state2->count; i++)
+  {
+    if (registers1[i] < state2->registers[i])
+      registers1[i] = state2->registers[i];
+  }
+  PG_RETURN_POINTER(state1);
 }
 
-PG_FUNCTION_INFO_V1(tint_tmin_combinefn);
+PG_FUNCTION_INFO_V1(temporal_tcount_approx_serialize);
 /**
- * Combine function for temporal minimum aggregation of temporal integer values
+ * Serialize the state of an approximate distinct temporal count
  */
 PGDLLEXPORT Datum
-tint_tmin_combinefn(PG_FUNCTION_ARGS)
+temporal_tcount_approx_serialize(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_min_int32, CROSSINGS_NO);
+  HllState *state = (HllState *) PG_GETARG_POINTER(0);
+  size_t size = offsetof(HllState, capacity);
+  size_t datasize = HLL_REGISTERS * state->count;
+  bytea *result = palloc(VARHDRSZ + size + datasize);
+  SET_VARSIZE(result, VARHDRSZ + size + datasize);
+  memcpy(VARDATA(result), state, size);
+  memcpy(VARDATA(result) + size, state->registers, datasize);
+  PG_RETURN_BYTEA_P(result);
 }
 
-PG_FUNCTION_INFO_V1(tfloat_tmin_transfn);
+PG_FUNCTION_INFO_V1(temporal_tcount_approx_deserialize);
 /**
- * Transition function for temporal minimum aggregation of temporal float values
+ * Deserialize the state of an approximate distinct temporal count
  */
 PGDLLEXPORT Datum
-tfloat_tmin_transfn(PG_FUNCTION_ARGS)
+temporal_tcount_approx_deserialize(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_transfn(fcinfo, &datum_min_float8, CROSSINGS);
+  bytea *data = PG_GETARG_BYTEA_P(0);
+  size_t size = offsetof(HllState, capacity);
+  HllState header;
+  memcpy(&header, VARDATA(data), size);
+  HllState *result = hllstate_make(fcinfo, header.size, header.origin);
+  if (header.count > 0)
+  {
+    hllstate_get(result, header.first + header.count - 1);
+    uint8 *registers = hllstate_get(result, header.first);
+    memcpy(registers, VARDATA(data) + size, HLL_REGISTERS * header.count);
+  }
+  PG_RETURN_POINTER(result);
 }
 
-PG_FUNCTION_INFO_V1(tfloat_tmin_combinefn);
+PG_FUNCTION_INFO_V1(temporal_tcount_approx_finalfn);
 /**
- * Combine function for temporal minimum aggregation of temporal float values
+ * Final function for approximate distinct temporal count, which returns a
+ * temporal integer whose instants are the lower bounds of the buckets
  */
 PGDLLEXPORT Datum
-tfloat_tmin_combinefn(PG_FUNCTION_ARGS)
+temporal_tcount_approx_finalfn(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_min_float8, CROSSINGS);
+  /* The final function is strict, we do not need to test for null values */
+  HllState *state = (HllState *) PG_GETARG_POINTER(0);
+  TInstant **instants = palloc(sizeof(TInstant *) * Max(state->count, 1));
+  int k = 0;
+  for (int i = 0; i < state->count; i++)
+  {
+    const uint8 *registers = &state->registers[HLL_REGISTERS * i];
+    /* The buckets between two values have no object */
+    int j = 0;
+    while (j < HLL_REGISTERS && registers[j] == 0)
+      j++;
+    if (j == HLL_REGISTERS)
+      continue;
+    instants[k++] = tinstant_make(Int32GetDatum(hll_estimate(registers)),
+      state->origin + (state->first + i) * state->size, INT4OID);
+  }
+  if (k == 0)
+  {
+    pfree(instants);
+    PG_RETURN_NULL();
+  }
+  TInstantSet *result = tinstantset_make_free(instants, k);
+  PG_RETURN_POINTER(result);
 }
 
-PG_FUNCTION_INFO_V1(tint_tmax_transfn);
+/*****************************************************************************
+ * Union of periods
+ *
+ * The union of the periods of many values, e.g., of getTime(trip) for all
+ * the trips of a fleet, is not computed by successive unions of period
+ * sets, whose cost grows with the size of the result for every value. The
+ * state buffers the periods of the values, which are sorted and coalesced
+ * in a single pass when the buffer is full, and when the result is needed.
+ *****************************************************************************/
+
 /**
- * Transition function for temporal maximum aggregation of temporal integer values
+ * Comparator of periods used for sorting the buffer of a union state
  */
-PGDLLEXPORT Datum
-tint_tmax_transfn(PG_FUNCTION_ARGS)
+static int
+period_buffer_cmp(const void *l, const void *r)
 {
-  return temporal_tagg_transfn(fcinfo, &datum_max_int32, CROSSINGS_NO);
+  return period_cmp_internal((const Period *) l, (const Period *) r);
 }
 
-PG_FUNCTION_INFO_V1(tint_tmax_combinefn);
 /**
- * Combine function for temporal maximum aggregation of temporal integer values
+ * Sort the periods of the state and coalesce those that overlap or are
+ * adjacent, so that the periods of the state are those of a period set
  */
-PGDLLEXPORT Datum
-tint_tmax_combinefn(PG_FUNCTION_ARGS)
+static void
+periodunion_normalize(PeriodUnionState *state)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_max_int32, CROSSINGS_NO);
+  if (state->normalized)
+    return;
+  if (state->count > 1)
+    qsort(state->periods, (size_t) state->count, sizeof(Period),
+      period_buffer_cmp);
+  int k = 0;
+  for (int i = 1; i < state->count; i++)
+  {
+    Period *current = &state->periods[k];
+    Period *next = &state->periods[i];
+    int cmp = timestamp_cmp_internal(current->upper, next->lower);
+    if (cmp > 0 || (cmp == 0 && (current->upper_inc || next->lower_inc)))
+    {
+      /* The periods overlap or are adjacent */
+      if (current->lower == next->lower)
+        current->lower_inc |= next->lower_inc;
+      cmp = timestamp_cmp_internal(current->upper, next->upper);
+      if (cmp < 0)
+      {
+        current->upper = next->upper;
+        current->upper_inc = next->upper_inc;
+      }
+      else if (cmp == 0)
+        current->upper_inc |= next->upper_inc;
+    }
+    else
+      state->periods[++k] = *next;
+  }
+  if (state->count > 0)
+    state->count = k + 1;
+  state->normalized = true;
+  return;
 }
 
-PG_FUNCTION_INFO_V1(tfloat_tmax_transfn);
 /**
- * Transition function for temporal maximum aggregation of temporal float values
+ * Construct an empty state for the union of periods in the current memory
+ * context
  */
-PGDLLEXPORT Datum
-tfloat_tmax_transfn(PG_FUNCTION_ARGS)
+static PeriodUnionState *
+periodunion_make(int capacity)
 {
-  return temporal_tagg_transfn(fcinfo, &datum_max_float8, CROSSINGS);
+  PeriodUnionState *result = palloc(sizeof(PeriodUnionState));
+  result->count = 0;
+  result->capacity = Max(capacity, PERIODUNION_INITIAL_CAPACITY);
+  result->normalized = true;
+  result->periods = palloc(sizeof(Period) * result->capacity);
+  return result;
 }
 
-PG_FUNCTION_INFO_V1(tfloat_tmax_combinefn);
 /**
- * Combine function for temporal maximum aggregation of temporal float values
+ * Ensure that the state has room for the given number of additional periods
+ *
+ * When the buffer is full its periods are first coalesced, and the buffer
+ * is only enlarged when this does not free half of it, so that the number
+ * of sorts is logarithmic in the number of periods received
  */
-PGDLLEXPORT Datum
-tfloat_tmax_combinefn(PG_FUNCTION_ARGS)
+static void
+periodunion_reserve(PeriodUnionState *state, int count)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_max_float8, CROSSINGS);
+  if (state->count + count <= state->capacity)
+    return;
+  periodunion_normalize(state);
+  if (state->count + count <= state->capacity / 2)
+    return;
+  int64 capacity = state->capacity;
+  while (capacity < (int64) (state->count + count) * 2)
+    capacity <<= 1;
+  if ((Size) capacity > MaxAllocSize / sizeof(Period))
+    ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+      errmsg("Too many periods in the union")));
+  /* The array keeps the memory context in which it was allocated */
+  state->periods = repalloc(state->periods, sizeof(Period) * capacity);
+  state->capacity = (int) capacity;
+  return;
 }
 
-PG_FUNCTION_INFO_V1(tint_tsum_transfn);
 /**
- * Transition function for temporal sum aggregation of temporal integer values
+ * Add the periods to the state
  */
-PGDLLEXPORT Datum
-tint_tsum_transfn(PG_FUNCTION_ARGS)
+static void
+periodunion_add(PeriodUnionState *state, const Period *periods, int count)
 {
-  return temporal_tagg_transfn(fcinfo, &datum_sum_int32, CROSSINGS_NO);
+  periodunion_reserve(state, count);
+  /* The normalized state remains so if the periods are after its periods */
+  if (state->normalized && state->count > 0)
+  {
+    Period *last = &state->periods[state->count - 1];
+    int cmp = timestamp_cmp_internal(last->upper, periods[0].lower);
+    if (cmp > 0 || (cmp == 0 && (last->upper_inc || periods[0].lower_inc)))
+      state->normalized = false;
+  }
+  if (count > 1)
+    state->normalized = false;
+  memcpy(&state->periods[state->count], periods, sizeof(Period) * count);
+  state->count += count;
+  return;
 }
 
-PG_FUNCTION_INFO_V1(tint_tsum_combinefn);
 /**
- * Combine function for temporal sum aggregation of temporal integer values
+ * Generic transition function for the union of periods
  */
-PGDLLEXPORT Datum
-tint_tsum_combinefn(PG_FUNCTION_ARGS)
+static Datum
+periodunion_transfn(FunctionCallInfo fcinfo, const Period *periods, int count)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_sum_int32, CROSSINGS_NO);
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  PeriodUnionState *state = PG_ARGISNULL(0) ? periodunion_make(0) :
+    (PeriodUnionState *) PG_GETARG_POINTER(0);
+  periodunion_add(state, periods, count);
+  unset_aggregation_context(ctx);
+  PG_RETURN_POINTER(state);
 }
 
-PG_FUNCTION_INFO_V1(tfloat_tsum_transfn);
+PG_FUNCTION_INFO_V1(period_union_transfn);
 /**
- * Transition function for temporal sum aggregation of temporal float values
+ * Transition function for the union of periods
  */
 PGDLLEXPORT Datum
-tfloat_tsum_transfn(PG_FUNCTION_ARGS)
+period_union_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_transfn(fcinfo, &datum_sum_float8, CROSSINGS_NO);
+  if (PG_ARGISNULL(1))
+  {
+    if (PG_ARGISNULL(0))
+      PG_RETURN_NULL();
+    PG_RETURN_POINTER(PG_GETARG_POINTER(0));
+  }
+  Period *p = PG_GETARG_PERIOD(1);
+  return periodunion_transfn(fcinfo, p, 1);
 }
 
-PG_FUNCTION_INFO_V1(tfloat_tsum_combinefn);
+PG_FUNCTION_INFO_V1(periodset_union_transfn);
 /**
- * Combine function for temporal sum aggregation of temporal float values
+ * Transition function for the union of the periods of period sets
  */
 PGDLLEXPORT Datum
-tfloat_tsum_combinefn(PG_FUNCTION_ARGS)
+periodset_union_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_sum_float8, CROSSINGS_NO);
+  if (PG_ARGISNULL(1))
+  {
+    if (PG_ARGISNULL(0))
+      PG_RETURN_NULL();
+    PG_RETURN_POINTER(PG_GETARG_POINTER(0));
+  }
+  PeriodSet *ps = PG_GETARG_PERIODSET(1);
+  /* The periods of a period set are contiguous in its representation */
+  Datum result = periodunion_transfn(fcinfo, periodset_per_n(ps, 0),
+    ps->count);
+  PG_FREE_IF_COPY(ps, 1);
+  return result;
 }
 
-/*****************************************************************************/
-
-PG_FUNCTION_INFO_V1(ttext_tmin_transfn);
+PG_FUNCTION_INFO_V1(period_union_combinefn);
 /**
- * Transition function for temporal minimum aggregation of temporal text values
+ * Combine function for the union of periods, which merges the sorted
+ * periods of the two states
  */
 PGDLLEXPORT Datum
-ttext_tmin_transfn(PG_FUNCTION_ARGS)
+period_union_combinefn(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_transfn(fcinfo, &datum_min_text, CROSSINGS_NO);
+  PeriodUnionState *state1 = PG_ARGISNULL(0) ? NULL :
+    (PeriodUnionState *) PG_GETARG_POINTER(0);
+  PeriodUnionState *state2 = PG_ARGISNULL(1) ? NULL :
+    (PeriodUnionState *) PG_GETARG_POINTER(1);
+  if (state1 == NULL && state2 == NULL)
+    PG_RETURN_NULL();
+  if (state1 == NULL)
+    PG_RETURN_POINTER(state2);
+  if (state2 == NULL || state2->count == 0)
+    PG_RETURN_POINTER(state1);
+
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  periodunion_normalize(state1);
+  periodunion_normalize(state2);
+  PeriodUnionState *result = periodunion_make(state1->count + state2->count);
+  /* Merge the two sorted arrays, the result only needs to be coalesced */
+  int i = 0, j = 0;
+  while (i < state1->count || j < state2->count)
+  {
+    if (j == state2->count || (i < state1->count &&
+        period_cmp_internal(&state1->periods[i], &state2->periods[j]) <= 0))
+      result->periods[result->count++] = state1->periods[i++];
+    else
+      result->periods[result->count++] = state2->periods[j++];
+  }
+  unset_aggregation_context(ctx);
+  /* The sort of the normalization returns at once since the periods are
+   * already sorted */
+  result->normalized = false;
+  periodunion_normalize(result);
+  pfree(state1->periods);
+  pfree(state1);
+  PG_RETURN_POINTER(result);
 }
 
-PG_FUNCTION_INFO_V1(ttext_tmin_combinefn);
+PG_FUNCTION_INFO_V1(period_union_serialize);
 /**
- * Combine function for temporal minimum aggregation of temporal text values
+ * Serialize the state of the union of periods, whose periods are
+ * normalized before
  */
 PGDLLEXPORT Datum
-ttext_tmin_combinefn(PG_FUNCTION_ARGS)
+period_union_serialize(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_min_text, CROSSINGS_NO);
+  PeriodUnionState *state = (PeriodUnionState *) PG_GETARG_POINTER(0);
+  periodunion_normalize(state);
+  size_t size = sizeof(Period) * state->count;
+  bytea *result = palloc(VARHDRSZ + size);
+  SET_VARSIZE(result, VARHDRSZ + size);
+  memcpy(VARDATA(result), state->periods, size);
+  PG_RETURN_BYTEA_P(result);
 }
 
-PG_FUNCTION_INFO_V1(ttext_tmax_transfn);
+PG_FUNCTION_INFO_V1(period_union_deserialize);
 /**
- * Transition function for temporal maximum aggregation of temporal text values
+ * Deserialize the state of the union of periods
  */
 PGDLLEXPORT Datum
-ttext_tmax_transfn(PG_FUNCTION_ARGS)
+period_union_deserialize(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_transfn(fcinfo, &datum_max_text, CROSSINGS_NO);
+  bytea *data = PG_GETARG_BYTEA_P(0);
+  int count = (int) ((VARSIZE(data) - VARHDRSZ) / sizeof(Period));
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  PeriodUnionState *result = periodunion_make(count);
+  unset_aggregation_context(ctx);
+  memcpy(result->periods, VARDATA(data), sizeof(Period) * count);
+  result->count = count;
+  PG_RETURN_POINTER(result);
 }
 
-PG_FUNCTION_INFO_V1(ttext_tmax_combinefn);
+PG_FUNCTION_INFO_V1(period_union_finalfn);
 /**
- * Combine function for temporal maximum aggregation of temporal text values
+ * Final function for the union of periods
  */
 PGDLLEXPORT Datum
-ttext_tmax_combinefn(PG_FUNCTION_ARGS)
+period_union_finalfn(PG_FUNCTION_ARGS)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_max_text, CROSSINGS_NO);
+  /* The final function is strict, we do not need to test for null values */
+  PeriodUnionState *state = (PeriodUnionState *) PG_GETARG_POINTER(0);
+  periodunion_normalize(state);
+  if (state->count == 0)
+    PG_RETURN_NULL();
+  Period **periods = palloc(sizeof(Period *) * state->count);
+  for (int i = 0; i < state->count; i++)
+    periods[i] = &state->periods[i];
+  PeriodSet *result = periodset_make(periods, state->count, NORMALIZE_NO);
+  pfree(periods);
+  PG_RETURN_POINTER(result);
 }
 
 /*****************************************************************************
- * Temporal average
+ * Resampling functions
+ *
+ * These functions apply the buckets of the bucketed aggregates to a single
+ * temporal value, walking its instants once instead of computing the value
+ * at each timestamp of the grid.
  *****************************************************************************/
 
 /**
- * Transform a temporal number into a temporal double2 value for 
- * performing temporal average aggregation
+ * Returns the first timestamp of the grid that is greater than or equal to
+ * the timestamp
  */
-TInstant *
-tnumberinst_transform_tavg(const TInstant *inst)
+static TimestampTz
+grid_ceil(TimestampTz t, int64 size, TimestampTz origin)
 {
-  double value = datum_double(tinstant_value(inst), inst->valuetypid);
-  double2 dvalue;
-  double2_set(&dvalue, value, 1);
-  TInstant *result = tinstant_make(PointerGetDatum(&dvalue), inst->t,
-    type_oid(T_DOUBLE2));
-  return result;
+  int64 delta = (t - origin) % size;
+  if (delta < 0)
+    delta += size;
+  return (delta == 0) ? t : t + (size - delta);
 }
 
-PG_FUNCTION_INFO_V1(tnumber_tavg_transfn);
 /**
- * Transition function for temporal average aggregation
+ * Returns the number of timestamps of the grid in the period
  */
-PGDLLEXPORT Datum
-tnumber_tavg_transfn(PG_FUNCTION_ARGS)
+static int
+grid_count(const Period *p, int64 size, TimestampTz origin)
 {
-  return temporal_tagg_transform_transfn(fcinfo, &datum_sum_double2,
-    CROSSINGS_NO, &tnumberinst_transform_tavg);
+  TimestampTz t = grid_ceil(p->lower, size, origin);
+  if (t > p->upper)
+    return 0;
+  int64 result = (p->upper - t) / size + 1;
+  if ((Size) result > MaxAllocSize / sizeof(TInstant *))
+    ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+      errmsg("Too many timestamps in the grid for the time span of the value")));
+  return (int) result;
 }
 
-PG_FUNCTION_INFO_V1(tnumber_tavg_combinefn);
 /**
- * Combine function for temporal average aggregation
+ * Sample the temporal sequence value at the timestamps of the grid
+ *
+ * @param[in] seq Temporal value
+ * @param[in] size Size of the grid in microseconds
+ * @param[in] origin Origin of the grid
+ * @param[out] result Array on which the instants are stored
+ * @result Number of instants of the result
  */
-PGDLLEXPORT Datum
-tnumber_tavg_combinefn(PG_FUNCTION_ARGS)
+static int
+tsequence_sample(const TSequence *seq, int64 size, TimestampTz origin,
+  TInstant **result)
 {
-  return temporal_tagg_combinefn(fcinfo, &datum_sum_double2, false);
-}
-
-/* Final function for tavg */
+  TimestampTz t = grid_ceil(seq->period.lower, size, origin);
+  if (t == seq->period.lower && ! seq->period.lower_inc)
+    t += size;
+  if (seq->count == 1)
+  {
+    if (t != seq->period.lower)
+      return 0;
+    result[0] = tinstant_copy(tsequence_inst_n(seq, 0));
+    return 1;
+  }
 
-/**
- * Final function for temporal average aggregation of temporal instat values
- */
-static TInstantSet *
-tinstant_tavg_finalfn(TInstant **instants, int count)
-{
-  TInstant **newinstants = palloc(sizeof(TInstant *) * count);
-  for (int i = 0; i < count; i++)
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  TInstant *inst1 = tsequence_inst_n(seq, 0);
+  TInstant *inst2 = tsequence_inst_n(seq, 1);
+  int i = 1;
+  int k = 0;
+  while (t < seq->period.upper ||
+    (t == seq->period.upper && seq->period.upper_inc))
   {
-    TInstant *inst = instants[i];
-    double2 *value = (double2 *)DatumGetPointer(tinstant_value_ptr(inst));
-    double tavg = value->a / value->b;
-    newinstants[i] = tinstant_make(Float8GetDatum(tavg), inst->t,
-      FLOAT8OID);
+    /* Advance to the segment containing the timestamp */
+    while (inst2->t < t)
+    {
+      inst1 = inst2;
+      inst2 = tsequence_inst_n(seq, ++i);
+    }
+    if (t == inst2->t)
+      result[k++] = tinstant_copy(inst2);
+    else
+    {
+      Datum value = tsequence_value_at_timestamp1(inst1, inst2, linear, t);
+      result[k++] = tinstant_make(value, t, seq->valuetypid);
+      DATUM_FREE(value, seq->valuetypid);
+    }
+    t += size;
   }
-  return tinstantset_make_free(newinstants, count);
+  return k;
 }
 
 /**
- * Final function for temporal average aggregation of temporal sequence values
+ * Sample the temporal value at the timestamps of the grid (dispatch
+ * function)
+ *
+ * @result Temporal instant set value, or NULL if no timestamp of the grid
+ * intersects the value
  */
-static TSequenceSet *
-tsequence_tavg_finalfn(TSequence **sequences, int count)
+static TInstantSet *
+temporal_sample(const Temporal *temp, int64 size, TimestampTz origin)
 {
-  TSequence **newsequences = palloc(sizeof(TSequence *) * count);
-  for (int i = 0; i < count; i++)
+  TInstant **instants;
+  int k = 0;
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT || temp->duration == INSTANTSET)
   {
-    TSequence *seq = sequences[i];
-    TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-    for (int j = 0; j < seq->count; j++)
+    int count = (temp->duration == INSTANT) ? 1 : ((TInstantSet *) temp)->count;
+    instants = palloc(sizeof(TInstant *) * count);
+    for (int i = 0; i < count; i++)
     {
-      TInstant *inst = tsequence_inst_n(seq, j);
-      double2 *value2 = (double2 *)DatumGetPointer(tinstant_value_ptr(inst));
-      double value = value2->a / value2->b;
-      instants[j] = tinstant_make(Float8GetDatum(value), inst->t,
-        FLOAT8OID);
+      TInstant *inst = (temp->duration == INSTANT) ? (TInstant *) temp :
+        tinstantset_inst_n((TInstantSet *) temp, i);
+      if (grid_ceil(inst->t, size, origin) == inst->t)
+        instants[k++] = tinstant_copy(inst);
     }
-    newsequences[i] = tsequence_make_free(instants, seq->count, 
-      seq->period.lower_inc, seq->period.upper_inc, 
-      MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE);
   }
-  return tsequenceset_make_free(newsequences, count, NORMALIZE);
+  else if (temp->duration == SEQUENCE)
+  {
+    TSequence *seq = (TSequence *) temp;
+    instants = palloc(sizeof(TInstant *) *
+      Max(grid_count(&seq->period, size, origin), 1));
+    k = tsequence_sample(seq, size, origin, instants);
+  }
+  else /* temp->duration == SEQUENCESET */
+  {
+    TSequenceSet *ts = (TSequenceSet *) temp;
+    int count = 0;
+    for (int i = 0; i < ts->count; i++)
+      count += grid_count(&tsequenceset_seq_n(ts, i)->period, size, origin);
+    instants = palloc(sizeof(TInstant *) * Max(count, 1));
+    for (int i = 0; i < ts->count; i++)
+      k += tsequence_sample(tsequenceset_seq_n(ts, i), size, origin,
+        &instants[k]);
+  }
+  if (k == 0)
+  {
+    pfree(instants);
+    return NULL;
+  }
+  return tinstantset_make_free(instants, k);
 }
 
-PG_FUNCTION_INFO_V1(tnumber_tavg_finalfn);
+PG_FUNCTION_INFO_V1(temporal_tsample);
 /**
- * Final function for temporal average aggregation
+ * Sample the temporal value at the timestamps of a regular grid, which
+ * values are interpolated from the instants of the temporal value
+ *
+ * @note The origin of the grid is optional and defaults to Monday,
+ * January 3, 2000, as for the bucketed aggregates
  */
 PGDLLEXPORT Datum
-tnumber_tavg_finalfn(PG_FUNCTION_ARGS)
+temporal_tsample(PG_FUNCTION_ARGS)
 {
-  /* The final function is strict, we do not need to test for null values */
-  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
-  if (state->length == 0)
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  int64 size = bucket_size(PG_GETARG_INTERVAL_P(1));
+  TimestampTz origin = (PG_NARGS() > 2) ? PG_GETARG_TIMESTAMPTZ(2) :
+    2 * USECS_PER_DAY;
+  TInstantSet *result = temporal_sample(temp, size, origin);
+  PG_FREE_IF_COPY(temp, 0);
+  if (result == NULL)
     PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
 
-  Temporal **values = skiplist_values(state);
-  assert(values[0]->duration == INSTANT || values[0]->duration == SEQUENCE);
-  Temporal *result = (values[0]->duration == INSTANT) ?
-    (Temporal *)tinstant_tavg_finalfn((TInstant **)values, state->length) :
-    (Temporal *)tsequence_tavg_finalfn((TSequence **)values, state->length);
-  pfree(values);
+PG_FUNCTION_INFO_V1(tnumber_tprecision);
+/**
+ * Returns the time-weighted average of the temporal number in each bucket
+ * of a regular grid, as the bucketed temporal average of the single value
+ *
+ * @note The origin of the buckets is optional and defaults to Monday,
+ * January 3, 2000, as for the bucketed aggregates
+ */
+PGDLLEXPORT Datum
+tnumber_tprecision(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  int64 size = bucket_size(PG_GETARG_INTERVAL_P(1));
+  TimestampTz origin = (PG_NARGS() > 2) ? PG_GETARG_TIMESTAMPTZ(2) :
+    2 * USECS_PER_DAY;
+  BucketState *state = bucketstate_make1(size, origin);
+  temporal_bucket_add(state, temp, true);
+  TInstantSet *result = bucketstate_tavg(state);
+  pfree(state->buckets);
+  pfree(state);
+  PG_FREE_IF_COPY(temp, 0);
+  if (result == NULL)
+    PG_RETURN_NULL();
   PG_RETURN_POINTER(result);
 }
 
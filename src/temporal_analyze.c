@@ -74,6 +74,7 @@
 #include "oidcache.h"
 #include "temporal_util.h"
 #include "temporal_analyze.h"
+#include "mobdb_probes.h"
 
 /*
  * To avoid consuming too much memory, IO and CPU load during analysis, and/or
@@ -304,6 +305,7 @@ temp_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   Oid   rangetypid = 0; /* make compiler quiet */
   TypeCacheEntry *typcache;
 
+  TRACE_MOBILITYDB_ANALYZE_START(samplerows);
   temporal_extra_data = (TemporalAnalyzeExtraData *)stats->extra_data;
 
   if (valuestats)
@@ -333,7 +335,6 @@ temp_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     Period period;
     PeriodBound period_lower,
         period_upper;
-    Temporal *temp;
 
     /* Give backend a chance of interrupting us */
     vacuum_delay_point();
@@ -346,15 +347,26 @@ temp_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
       continue;
     }
 
-    total_width += VARSIZE(value);
+    /* The width is the one of the stored value, which may be toasted */
+    total_width += VARSIZE_ANY(DatumGetPointer(value));
 
-    /* Get Temporal value */
-    temp = DatumGetTemporal(value);
-
-    /* Remember bounds and length for further usage in histograms */
+    /*
+     * Remember bounds and length for further usage in histograms. All the
+     * statistics are obtained from the bounding box and the period of the
+     * value, which are fetched without detoasting the whole value.
+     */
     if (valuestats)
     {
-      RangeType *range = tnumber_value_range_internal(temp);
+      TBOX box;
+      RangeType *range;
+      memset(&box, 0, sizeof(TBOX));
+      temporal_bbox_slice(&box, value);
+      if (temporal_extra_data->value_type_id == INT4OID)
+        range = range_make(Int32GetDatum((int) box.xmin),
+          Int32GetDatum((int) box.xmax), true, true, INT4OID);
+      else /* temporal_extra_data->value_type_id == FLOAT8OID */
+        range = range_make(Float8GetDatum(box.xmin),
+          Float8GetDatum(box.xmax), true, true, FLOAT8OID);
       range_deserialize(typcache, range, &range_lower, &range_upper, &isempty);
       value_lowers[non_null_cnt] = range_lower;
       value_uppers[non_null_cnt] = range_upper;
@@ -366,7 +378,7 @@ temp_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
         value_lengths[non_null_cnt] = DatumGetFloat8(range_upper.val) -
           DatumGetFloat8(range_lower.val);
     }
-    temporal_period(&period, temp);
+    temporal_period_slice(&period, value);
     period_deserialize(&period, &period_lower, &period_upper);
     time_lowers[non_null_cnt] = period_lower;
     time_uppers[non_null_cnt] = period_upper;
@@ -410,6 +422,7 @@ temp_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     pfree(value_lowers); pfree(value_uppers); pfree(value_lengths);
   }
   pfree(time_lowers); pfree(time_uppers); pfree(time_lengths);
+  TRACE_MOBILITYDB_ANALYZE_DONE(non_null_cnt, (int64) total_width);
   return;
 }
 
@@ -0,0 +1,372 @@
+/*****************************************************************************
+ *
+ * temporal_argcache.c
+ *    Cache of the arguments of a function that are the same across calls.
+ *
+ * When a function is called for every row with a constant argument, e.g.,
+ * in a predicate such as dwithin(trip, $1, 100), the argument is detoasted
+ * and its derived values such as its trajectory are computed again in every
+ * call. The functions in this file keep these values in the memory context
+ * of the function call so that they are computed only once per query.
+ *
+ * The cache is kept in the fn_extra field of the function call. It can thus
+ * only be used by functions that do not use this field for other purposes,
+ * and in particular by functions that do not pass their FmgrInfo to the
+ * PostGIS functions that keep their own cache in this field, such as the
+ * functions for geographies.
+ *
+ * The values returned by the cache belong to it and must not be freed by
+ * the calling function, e.g., with PG_FREE_IF_COPY.
+ *
+ * When several functions are called on the same row, e.g., in a predicate
+ * such as intersects(trip, $1) OR dwithin(trip, $2, 100), the argument that
+ * changes in every row cannot be kept in the fn_extra field of each
+ * function. The row cache at the end of this file keeps the detoasted
+ * temporal point and its trajectory in the memory context of the call,
+ * which is the per-tuple context of the query, so that they are shared by
+ * all the functions called on the row.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_argcache.h"
+
+#include <assert.h>
+#include <access/hash.h>
+#include <utils/memutils.h>
+
+#include "temporaltypes.h"
+#include "periodset.h"
+#include "temporal_packed.h"
+#include "tpoint_spatialfuncs.h"
+#include "geography_funcs.h"
+
+/*****************************************************************************/
+
+/**
+ * Frees the values kept for a cached argument
+ */
+static void
+argcache_entry_reset(ArgCacheEntry *entry)
+{
+  if (entry->raw != NULL)
+    pfree(entry->raw);
+  if (entry->value != 0)
+    pfree(DatumGetPointer(entry->value));
+  if (entry->traj != 0)
+    pfree(DatumGetPointer(entry->traj));
+  if (entry->aux != NULL)
+  {
+    if (entry->aux_free != NULL)
+      entry->aux_free(entry->aux);
+    else
+      pfree(entry->aux);
+  }
+  entry->raw = NULL;
+  entry->value = entry->traj = 0;
+  entry->aux = NULL;
+  entry->aux_free = NULL;
+  entry->loc = 0;
+  return;
+}
+
+/**
+ * Returns the cache of the function, which is created in its first call
+ */
+static ArgCache *
+argcache_get(FunctionCallInfo fcinfo)
+{
+  ArgCache *cache = (ArgCache *) fcinfo->flinfo->fn_extra;
+  if (cache == NULL)
+  {
+    cache = MemoryContextAllocZero(fcinfo->flinfo->fn_mcxt, sizeof(ArgCache));
+    fcinfo->flinfo->fn_extra = cache;
+  }
+  return cache;
+}
+
+/**
+ * Returns the hash of the first bytes of the argument
+ */
+static uint32
+argcache_hash(const struct varlena *raw, Size size)
+{
+  return DatumGetUInt32(hash_any((const unsigned char *) raw,
+    (int) Min(size, ARGCACHE_HASH_BYTES)));
+}
+
+/**
+ * Returns the cache entry of the argument if it has the same value as in
+ * the previous call of the function, or NULL otherwise
+ *
+ * An argument that does not have the size and the hash of the previous one
+ * is only recorded by them. It is copied and detoasted when it is received
+ * again, and is then compared in full in the next calls.
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] argno Number of the argument
+ * @param[in] temporal True when the argument is a temporal value, which is
+ * unpacked in addition to being detoasted
+ */
+static ArgCacheEntry *
+argcache_lookup(FunctionCallInfo fcinfo, int argno, bool temporal)
+{
+  if (fcinfo->flinfo == NULL || argno >= ARGCACHE_MAX_ARGS)
+    return NULL;
+  struct varlena *raw = (struct varlena *) PG_GETARG_POINTER(argno);
+  /* Read-write expanded objects may be modified in place between calls */
+  if (VARATT_IS_EXTERNAL_EXPANDED(raw))
+    return NULL;
+
+  MemoryContext fcontext = fcinfo->flinfo->fn_mcxt;
+  ArgCache *cache = argcache_get(fcinfo);
+  ArgCacheEntry *entry = &cache->args[argno];
+  Size size = VARSIZE_ANY(raw);
+  uint32 hash = argcache_hash(raw, size);
+  if (entry->size == size && entry->hash == hash)
+  {
+    if (entry->raw != NULL && memcmp(entry->raw, raw, size) == 0)
+      /* Same argument as the cached one */
+      return entry;
+    if (entry->raw == NULL)
+    {
+      /* Second call with an argument that looks the same, which is cached
+       * from now on */
+      MemoryContext oldcontext = MemoryContextSwitchTo(fcontext);
+      entry->raw = palloc(size);
+      memcpy(entry->raw, raw, size);
+      struct varlena *value = pg_detoast_datum_copy(raw);
+      if (temporal)
+      {
+        Temporal *temp = temporal_unpack((Temporal *) value);
+        if ((struct varlena *) temp != value)
+          pfree(value);
+        value = (struct varlena *) temp;
+      }
+      entry->value = PointerGetDatum(value);
+      MemoryContextSwitchTo(oldcontext);
+      return entry;
+    }
+  }
+
+  /* Keep the size and the hash to recognize the argument in the next call */
+  argcache_entry_reset(entry);
+  entry->size = size;
+  entry->hash = hash;
+  return NULL;
+}
+
+/**
+ * Returns the cache entry of the temporal argument if it has the same
+ * value as in the previous call of the function, or NULL otherwise
+ */
+ArgCacheEntry *
+argcache_temporal(FunctionCallInfo fcinfo, int argno)
+{
+  return argcache_lookup(fcinfo, argno, true);
+}
+
+/**
+ * Returns the cache entry of the geometry or geography argument if it has
+ * the same value as in the previous call of the function, or NULL otherwise
+ */
+ArgCacheEntry *
+argcache_gserialized(FunctionCallInfo fcinfo, int argno)
+{
+  return argcache_lookup(fcinfo, argno, false);
+}
+
+/**
+ * Returns the cache entry of the period set argument if it has the same
+ * value as in the previous call of the function, or NULL otherwise
+ *
+ * The auxiliary structure of the entry is the search index of the period
+ * set, which is computed when the entry is created
+ */
+ArgCacheEntry *
+argcache_periodset(FunctionCallInfo fcinfo, int argno)
+{
+  ArgCacheEntry *entry = argcache_lookup(fcinfo, argno, false);
+  if (entry != NULL && entry->aux == NULL)
+  {
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+    entry->aux = periodset_index_make(
+      (PeriodSet *) DatumGetPointer(entry->value));
+    MemoryContextSwitchTo(oldcontext);
+  }
+  return entry;
+}
+
+/**
+ * Returns the trajectory of the cached temporal point, which is computed
+ * the first time it is requested
+ */
+Datum
+argcache_tpoint_trajectory(FunctionCallInfo fcinfo, ArgCacheEntry *entry)
+{
+  assert(entry->value != 0);
+  if (entry->traj == 0)
+  {
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+    entry->traj = tpoint_trajectory_internal(
+      (Temporal *) DatumGetPointer(entry->value));
+    MemoryContextSwitchTo(oldcontext);
+  }
+  return entry->traj;
+}
+
+/**
+ * Returns the circular tree of the cached geography, which is computed
+ * the first time it is requested
+ *
+ * The auxiliary structure of the entry is a GeogCircTree, whose leaves
+ * reference the coordinates of the detoasted value of the entry
+ */
+void *
+argcache_geog_circ_tree(FunctionCallInfo fcinfo, ArgCacheEntry *entry)
+{
+  assert(entry->value != 0);
+  if (entry->aux == NULL)
+  {
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+    entry->aux = geog_circ_tree_make(
+      (GSERIALIZED *) DatumGetPointer(entry->value));
+    entry->aux_free = &geog_circ_tree_free;
+    MemoryContextSwitchTo(oldcontext);
+  }
+  return entry->aux;
+}
+
+/**
+ * Returns the FmgrInfo kept in the cache to call the PostGIS functions
+ *
+ * PostGIS keeps in the fn_extra field of its FmgrInfo the geometries
+ * prepared for GEOS and the trees used for point-in-polygon tests when a
+ * function such as ST_Intersects is called repeatedly with the same
+ * geometry. The FmgrInfo built by call_function2 is new in every call, so
+ * that this cache is never reused. The FmgrInfo returned by this function
+ * lives as long as the one of the external function and its fn_extra field
+ * belongs to PostGIS.
+ */
+FmgrInfo *
+argcache_flinfo(FunctionCallInfo fcinfo)
+{
+  if (fcinfo->flinfo == NULL)
+    return NULL;
+  ArgCache *cache = argcache_get(fcinfo);
+  if (cache->flinfo == NULL)
+  {
+    cache->flinfo = MemoryContextAllocZero(fcinfo->flinfo->fn_mcxt,
+      sizeof(FmgrInfo));
+    cache->flinfo->fn_oid = InvalidOid;
+    cache->flinfo->fn_mcxt = fcinfo->flinfo->fn_mcxt;
+  }
+  return cache->flinfo;
+}
+
+/*****************************************************************************
+ * Cache of the temporal point of the current row
+ *****************************************************************************/
+
+/**
+ * Structure to keep the temporal point received by the functions called on
+ * the current row together with its trajectory
+ */
+typedef struct
+{
+  MemoryContext mcxt;         /**< memory context of the cache */
+  MemoryContextCallback callback; /**< callback called when the memory
+                                   context is reset */
+  struct varlena *rawptr;     /**< argument as received by the function */
+  struct varlena *raw;        /**< copy of the argument */
+  Temporal   *temp;           /**< detoasted temporal point */
+  Datum       traj;           /**< trajectory of the temporal point */
+} RowCache;
+
+/**
+ * Cache of the current row, which is NULL when its memory context has been
+ * reset
+ */
+static RowCache *row_cache = NULL;
+
+/**
+ * Forgets the row cache when its memory context is reset
+ */
+static void
+rowcache_reset_callback(void *arg)
+{
+  if (row_cache == (RowCache *) arg)
+    row_cache = NULL;
+  return;
+}
+
+/**
+ * Returns the detoasted temporal point argument and its trajectory, which
+ * are computed only once for all the functions called with the same
+ * argument in the same memory context
+ *
+ * The argument is recognized by its address, which is the same for all the
+ * functions called on a row, and by its content, so that an address reused
+ * for another value in the same memory context is not mistaken for it.
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] argno Number of the argument
+ * @param[out] traj Trajectory of the temporal point
+ * @note The values returned belong to the cache and must not be freed
+ */
+Temporal *
+rowcache_tpoint(FunctionCallInfo fcinfo, int argno, Datum *traj)
+{
+  struct varlena *raw = (struct varlena *) PG_GETARG_POINTER(argno);
+  Size size = VARSIZE_ANY(raw);
+  RowCache *cache = row_cache;
+  if (cache != NULL && cache->mcxt == CurrentMemoryContext &&
+    cache->rawptr == raw && VARSIZE_ANY(cache->raw) == size &&
+    memcmp(cache->raw, raw, size) == 0 &&
+    ! VARATT_IS_EXTERNAL_EXPANDED(raw))
+  {
+    *traj = cache->traj;
+    return cache->temp;
+  }
+
+  if (cache != NULL && cache->mcxt == CurrentMemoryContext)
+  {
+    /* Another value in the same memory context replaces the one of the
+     * previous row */
+    pfree(cache->raw);
+    pfree(cache->temp);
+    pfree(DatumGetPointer(cache->traj));
+  }
+  else
+  {
+    /* The cache of a previous memory context is freed with it */
+    cache = palloc(sizeof(RowCache));
+    cache->mcxt = CurrentMemoryContext;
+    cache->callback.func = rowcache_reset_callback;
+    cache->callback.arg = cache;
+    MemoryContextRegisterResetCallback(CurrentMemoryContext,
+      &cache->callback);
+    row_cache = cache;
+  }
+  cache->rawptr = raw;
+  cache->raw = palloc(size);
+  memcpy(cache->raw, raw, size);
+  /* The value must not reference the buffer of the row */
+  struct varlena *value = pg_detoast_datum_copy(raw);
+  Temporal *temp = temporal_unpack((Temporal *) value);
+  if ((struct varlena *) temp != value)
+    pfree(value);
+  cache->temp = temp;
+  cache->traj = tpoint_trajectory_internal(temp);
+  *traj = cache->traj;
+  return cache->temp;
+}
+
+/*****************************************************************************/
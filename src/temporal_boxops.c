@@ -453,7 +453,7 @@ PGDLLEXPORT Datum
 overlaps_bbox_period_temporal(PG_FUNCTION_ARGS)
 {
   return boxop_period_temporal(fcinfo,
-    &overlaps_period_period_internal);
+    &overlaps_period_period_inline);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_bbox_temporal_period);
@@ -465,7 +465,7 @@ PGDLLEXPORT Datum
 overlaps_bbox_temporal_period(PG_FUNCTION_ARGS)
 {
   return boxop_temporal_period(fcinfo,
-    &overlaps_period_period_internal);
+    &overlaps_period_period_inline);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_bbox_temporal_temporal);
@@ -476,7 +476,7 @@ PGDLLEXPORT Datum
 overlaps_bbox_temporal_temporal(PG_FUNCTION_ARGS)
 {
   return boxop_temporal_temporal(fcinfo,
-    &overlaps_period_period_internal);
+    &overlaps_period_period_inline);
 }
 
 /*****************************************************************************/
@@ -576,15 +576,13 @@ boxop_range_tnumber(FunctionCallInfo fcinfo,
   char flags = range_get_flags(range);
   if (flags & RANGE_EMPTY)
     PG_RETURN_BOOL(func == &contained_tbox_tbox_internal);
-  Temporal *temp = PG_GETARG_TEMPORAL(1);
   TBOX box1, box2;
   memset(&box1, 0, sizeof(TBOX));
   memset(&box2, 0, sizeof(TBOX));
   range_to_tbox_internal(&box1, range);
-  temporal_bbox(&box2, temp);
+  temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
   bool result = func(&box1, &box2);
   PG_FREE_IF_COPY(range, 0);
-  PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_BOOL(result);
 }
 
@@ -598,7 +596,6 @@ Datum
 boxop_tnumber_range(FunctionCallInfo fcinfo,
   bool (*func)(const TBOX *, const TBOX *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
 #if MOBDB_PGSQL_VERSION < 110000
   RangeType  *range = PG_GETARG_RANGE(1);
 #else
@@ -611,10 +608,9 @@ boxop_tnumber_range(FunctionCallInfo fcinfo,
   TBOX box1, box2;
   memset(&box1, 0, sizeof(TBOX));
   memset(&box2, 0, sizeof(TBOX));
-  temporal_bbox(&box1, temp);
+  temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
   range_to_tbox_internal(&box2, range);
   bool result = func(&box1, &box2);
-  PG_FREE_IF_COPY(temp, 0);
   PG_FREE_IF_COPY(range, 1);
   PG_RETURN_BOOL(result);
 }
@@ -630,12 +626,10 @@ boxop_tbox_tnumber(FunctionCallInfo fcinfo,
   bool (*func)(const TBOX *, const TBOX *))
 {
   TBOX *box = PG_GETARG_TBOX_P(0);
-  Temporal *temp = PG_GETARG_TEMPORAL(1);
   TBOX box1;
   memset(&box1, 0, sizeof(TBOX));
-  temporal_bbox(&box1, temp);
+  temporal_bbox_slice(&box1, PG_GETARG_DATUM(1));
   bool result = func(box, &box1);
-  PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_BOOL(result);
 }
 
@@ -649,13 +643,11 @@ Datum
 boxop_tnumber_tbox(FunctionCallInfo fcinfo,
   bool (*func)(const TBOX *, const TBOX *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
   TBOX *box = PG_GETARG_TBOX_P(1);
   TBOX box1;
   memset(&box1, 0, sizeof(TBOX));
-  temporal_bbox(&box1, temp);
+  temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
   bool result = func(&box1, box);
-  PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_BOOL(result);
 }
 
@@ -669,16 +661,12 @@ Datum
 boxop_tnumber_tnumber(FunctionCallInfo fcinfo,
   bool (*func)(const TBOX *, const TBOX *))
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL(1);
   TBOX box1, box2;
   memset(&box1, 0, sizeof(TBOX));
   memset(&box2, 0, sizeof(TBOX));
-  temporal_bbox(&box1, temp1);
-  temporal_bbox(&box2, temp2);
+  temporal_bbox_slice(&box1, PG_GETARG_DATUM(0));
+  temporal_bbox_slice(&box2, PG_GETARG_DATUM(1));
   bool result = func(&box1, &box2);
-  PG_FREE_IF_COPY(temp1, 0);
-  PG_FREE_IF_COPY(temp2, 1);
   PG_RETURN_BOOL(result);
 }
 
@@ -803,7 +791,7 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_range_tnumber);
 PGDLLEXPORT Datum
 overlaps_bbox_range_tnumber(PG_FUNCTION_ARGS)
 {
-  return boxop_range_tnumber(fcinfo, &overlaps_tbox_tbox_internal);
+  return boxop_range_tnumber(fcinfo, &overlaps_tbox_tbox_inline);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_range);
@@ -814,7 +802,7 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_range);
 PGDLLEXPORT Datum
 overlaps_bbox_tnumber_range(PG_FUNCTION_ARGS)
 {
-  return boxop_tnumber_range(fcinfo, &overlaps_tbox_tbox_internal);
+  return boxop_tnumber_range(fcinfo, &overlaps_tbox_tbox_inline);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_bbox_tbox_tnumber);
@@ -825,7 +813,7 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tbox_tnumber);
 PGDLLEXPORT Datum
 overlaps_bbox_tbox_tnumber(PG_FUNCTION_ARGS)
 {
-  return boxop_tbox_tnumber(fcinfo, &overlaps_tbox_tbox_internal);
+  return boxop_tbox_tnumber(fcinfo, &overlaps_tbox_tbox_inline);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_tbox);
@@ -836,7 +824,7 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_tbox);
 PGDLLEXPORT Datum
 overlaps_bbox_tnumber_tbox(PG_FUNCTION_ARGS)
 {
-  return boxop_tnumber_tbox(fcinfo, &overlaps_tbox_tbox_internal);
+  return boxop_tnumber_tbox(fcinfo, &overlaps_tbox_tbox_inline);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_tnumber);
@@ -846,7 +834,7 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_tnumber);
 PGDLLEXPORT Datum
 overlaps_bbox_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-  return boxop_tnumber_tnumber(fcinfo, &overlaps_tbox_tbox_internal);
+  return boxop_tnumber_tnumber(fcinfo, &overlaps_tbox_tbox_inline);
 }
 
 /*****************************************************************************/
@@ -24,10 +24,41 @@
  * Generic dispatch function
  *****************************************************************************/
 
+/**
+ * Returns in the last argument the comparison operator computed by the
+ * function, if any
+ */
+static bool
+tcomp_func_oper(Datum (*func)(Datum, Datum, Oid, Oid), CachedOp *op)
+{
+  if (func == &datum2_eq2)
+    *op = EQ_OP;
+  else if (func == &datum2_ne2)
+    *op = NE_OP;
+  else if (func == &datum2_lt2)
+    *op = LT_OP;
+  else if (func == &datum2_le2)
+    *op = LE_OP;
+  else if (func == &datum2_gt2)
+    *op = GT_OP;
+  else if (func == &datum2_ge2)
+    *op = GE_OP;
+  else
+    return false;
+  return true;
+}
+
 Temporal *
 tcomp_temporal_base1(const Temporal *temp, Datum value, Oid valuetypid,
   Datum (*func)(Datum, Datum, Oid, Oid), bool invert)
 {
+  /* Compare directly the values of a temporal float, the crossings of
+   * the segments of a linear temporal float are computed in batch */
+  CachedOp op;
+  if (temp->valuetypid == FLOAT8OID && valuetypid == FLOAT8OID &&
+    tcomp_func_oper(func, &op))
+    return tfunc_tfloat_comp_base(temp, DatumGetFloat8(value), op, invert);
+
   LiftedFunctionInfo lfinfo;
   lfinfo.func = (varfunc) func;
   lfinfo.numparam = 4;
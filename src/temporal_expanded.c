@@ -0,0 +1,182 @@
+/*****************************************************************************
+ *
+ * temporal_expanded.c
+ *    Expanded representation of temporal sequences.
+ *
+ * Functions that modify a temporal sequence, such as appendInstant, copy
+ * the whole value and recompute its bounding box and trajectory for every
+ * call. The expanded representation defined in this file keeps instead the
+ * sequence as an array of instants that can be modified in place when the
+ * function receives a read-write pointer to an expanded object, which
+ * happens when the function is the transition function of an aggregate
+ * whose state is the temporal value. The value is flattened with the usual
+ * functions only when it is stored, passed to a function that does not know
+ * about the expanded format, or output.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_expanded.h"
+
+#include <assert.h>
+#include <utils/memutils.h>
+
+#include "temporaltypes.h"
+#include "temporal_util.h"
+
+/*****************************************************************************
+ * Expanded object methods
+ *****************************************************************************/
+
+static Size expanded_temporal_get_flat_size(ExpandedObjectHeader *eohptr);
+static void expanded_temporal_flatten_into(ExpandedObjectHeader *eohptr,
+  void *result, Size allocated_size);
+
+static const ExpandedObjectMethods expanded_temporal_methods =
+{
+  expanded_temporal_get_flat_size,
+  expanded_temporal_flatten_into
+};
+
+/**
+ * Returns the size of the flat representation of the expanded value
+ *
+ * The flat value is computed when needed in the memory context of the
+ * object and is cached until the next modification.
+ */
+static Size
+expanded_temporal_get_flat_size(ExpandedObjectHeader *eohptr)
+{
+  ExpandedTemporal *et = (ExpandedTemporal *) eohptr;
+  assert(et->magic == EXPANDED_TEMPORAL_MAGIC);
+  if (et->fcache == NULL)
+  {
+    MemoryContext oldctx = MemoryContextSwitchTo(et->hdr.eoh_context);
+    et->fcache = tsequence_make1(et->instants, et->count, et->lower_inc,
+      et->upper_inc, et->linear, NORMALIZE_NO);
+    MemoryContextSwitchTo(oldctx);
+  }
+  return VARSIZE(et->fcache);
+}
+
+/**
+ * Write the flat representation of the expanded value into the buffer
+ */
+static void
+expanded_temporal_flatten_into(ExpandedObjectHeader *eohptr,
+  void *result, Size allocated_size)
+{
+  ExpandedTemporal *et = (ExpandedTemporal *) eohptr;
+  assert(et->magic == EXPANDED_TEMPORAL_MAGIC);
+  assert(et->fcache != NULL && allocated_size == VARSIZE(et->fcache));
+  memcpy(result, et->fcache, allocated_size);
+}
+
+/*****************************************************************************
+ * Construction and access functions
+ *****************************************************************************/
+
+/**
+ * Returns a read-write pointer to an expanded object constructed from the
+ * temporal sequence
+ *
+ * @param[in] tempdatum Temporal sequence, which may be toasted, packed, or
+ * itself expanded
+ * @param[in] parentcontext Memory context in which the object is created
+ */
+Datum
+temporal_expand(Datum tempdatum, MemoryContext parentcontext)
+{
+  MemoryContext objctx = AllocSetContextCreate(parentcontext,
+    "expanded temporal", ALLOCSET_START_SMALL_SIZES);
+  ExpandedTemporal *et = (ExpandedTemporal *) MemoryContextAlloc(objctx,
+    sizeof(ExpandedTemporal));
+  EOH_init_header(&et->hdr, &expanded_temporal_methods, objctx);
+  et->magic = EXPANDED_TEMPORAL_MAGIC;
+
+  MemoryContext oldctx = MemoryContextSwitchTo(objctx);
+  Temporal *temp = (Temporal *) PG_DETOAST_DATUM_COPY(tempdatum);
+  TSequence *seq = (TSequence *) temporal_unpack(temp);
+  if ((Temporal *) seq != temp)
+    pfree(temp);
+  assert(seq->duration == SEQUENCE);
+  et->valuetypid = seq->valuetypid;
+  et->lower_inc = seq->period.lower_inc;
+  et->upper_inc = seq->period.upper_inc;
+  et->linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  et->count = seq->count;
+  et->capacity = seq->count * 2;
+  et->instants = palloc(sizeof(TInstant *) * et->capacity);
+  for (int i = 0; i < seq->count; i++)
+    et->instants[i] = tsequence_inst_n(seq, i);
+  et->fvalue = et->fcache = seq;
+  MemoryContextSwitchTo(oldctx);
+
+  return EOHPGetRWDatum(&et->hdr);
+}
+
+/**
+ * Returns the expanded object if the datum is a read-write pointer to an
+ * expanded temporal value, and NULL otherwise
+ */
+ExpandedTemporal *
+DatumGetExpandedTemporalRW(Datum d)
+{
+  if (! VARATT_IS_EXTERNAL_EXPANDED_RW(DatumGetPointer(d)))
+    return NULL;
+  ExpandedTemporal *et = (ExpandedTemporal *) DatumGetEOHP(d);
+  if (et->hdr.eoh_methods != &expanded_temporal_methods)
+    return NULL;
+  assert(et->magic == EXPANDED_TEMPORAL_MAGIC);
+  return et;
+}
+
+/*****************************************************************************
+ * Modification functions
+ *****************************************************************************/
+
+/**
+ * Append an instant to the expanded temporal sequence in place
+ *
+ * The instant is simply added to the array of instants, possibly replacing
+ * the last one if it becomes redundant, in amortized constant time.
+ *
+ * @return False if the instant has the same timestamp as the last instant
+ * of the sequence, which is left unchanged. In this case, which may result
+ * in a sequence set, the instant must be appended to the flat value.
+ */
+bool
+expanded_tsequence_append_tinstant(ExpandedTemporal *et, const TInstant *inst)
+{
+  assert(et->valuetypid == inst->valuetypid);
+  TInstant *last = et->instants[et->count - 1];
+  ensure_increasing_timestamps(last, inst, true); /* > */
+  if (last->t == inst->t)
+    return false;
+
+  MemoryContext oldctx = MemoryContextSwitchTo(et->hdr.eoh_context);
+  /* Normalize the result */
+  if (et->count > 1 &&
+    tsequence_redundant_tinstant(et->instants[et->count - 2], last, inst,
+      et->linear))
+    et->count--;
+  if (et->count == et->capacity)
+  {
+    et->capacity *= 2;
+    et->instants = repalloc(et->instants, sizeof(TInstant *) * et->capacity);
+  }
+  et->instants[et->count++] = tinstant_copy(inst);
+  et->upper_inc = true;
+  /* Invalidate the flat value of the previous state */
+  if (et->fcache != NULL && et->fcache != et->fvalue)
+    pfree(et->fcache);
+  et->fcache = NULL;
+  MemoryContextSwitchTo(oldctx);
+  return true;
+}
+
+/*****************************************************************************/
@@ -36,9 +36,8 @@ gist_temporal_compress(PG_FUNCTION_ARGS)
   if (entry->leafkey)
   {
     GISTENTRY *retval = palloc(sizeof(GISTENTRY));
-    Temporal *temp = DatumGetTemporal(entry->key);
     Period *period = palloc0(sizeof(Period));
-    temporal_bbox(period, temp);
+    temporal_bbox_slice(period, entry->key);
     gistentryinit(*retval, PointerGetDatum(period),
       entry->rel, entry->page, entry->offset, false);
     PG_RETURN_POINTER(retval);
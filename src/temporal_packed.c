@@ -0,0 +1,920 @@
+/*****************************************************************************
+ *
+ * temporal_packed.c
+ *    Packed (columnar) storage format for temporal types.
+ *
+ * Temporal values are manipulated in memory as arrays of temporal instants,
+ * each of them being a varlena containing its own header, timestamp, and
+ * base value. This is costly for storing long sequences on disk since, e.g.,
+ * every point of a temporal point keeps a full GSERIALIZED with its own SRID
+ * and flags. The packed format stores instead the components of the
+ * instants in separate arrays and keeps the information common to all the
+ * instants only once in the header. Packed values are obtained with the
+ * SQL function pack() and are transparently unpacked into the standard
+ * format when they are passed as argument to a function with the macros
+ * PG_GETARG_TEMPORAL and DatumGetTemporal.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_packed.h"
+
+#include <assert.h>
+
+#include "temporaltypes.h"
+#include "oidcache.h"
+#include "temporal_util.h"
+#include "period.h"
+#include "timeops.h"
+#include "funcstat.h"
+#include "temporal_sharedcache.h"
+
+#include "tpoint.h"
+#include "tpoint_spatialfuncs.h"
+
+/*****************************************************************************
+ * Encoding of the timestamps
+ *
+ * The timestamps of a packed value are stored as zig-zag varint encoded
+ * deltas of the deltas between consecutive timestamps. For values sampled at
+ * a regular frequency, e.g., 1 Hz, each timestamp is thus encoded in a
+ * single byte. Every PACK_TIME_SAMPLE instants an entry of a sample index
+ * keeps the absolute timestamp and the position of the next encoded delta
+ * so that a timestamp can be found by a binary search on the sample index
+ * followed by the decoding of at most PACK_TIME_SAMPLE - 1 deltas.
+ *****************************************************************************/
+
+/**
+ * Maximum number of bytes of the varint encoding of an uint64
+ */
+#define VARINT_MAXLEN    10
+
+/**
+ * Number of entries of the sample index for count instants
+ */
+#define PACK_TIME_NSAMPLES(count) \
+  (((count) + PACK_TIME_SAMPLE - 1) / PACK_TIME_SAMPLE)
+
+/**
+ * Writes the uint64 value in varint format and returns the number of bytes
+ * written
+ */
+static size_t
+varint_write(uint8 *buf, uint64 value)
+{
+  size_t n = 0;
+  while (value >= 0x80)
+  {
+    buf[n++] = (uint8) (value | 0x80);
+    value >>= 7;
+  }
+  buf[n++] = (uint8) value;
+  return n;
+}
+
+/**
+ * Reads the uint64 value in varint format and advances the pointer
+ */
+static uint64
+varint_read(const uint8 **buf)
+{
+  const uint8 *ptr = *buf;
+  uint64 result = 0;
+  int shift = 0;
+  while (*ptr & 0x80)
+  {
+    result |= (uint64) (*ptr++ & 0x7F) << shift;
+    shift += 7;
+  }
+  result |= (uint64) *ptr++ << shift;
+  *buf = ptr;
+  return result;
+}
+
+/**
+ * Zig-zag encoding of an int64 value
+ */
+static inline uint64
+zigzag_encode(int64 value)
+{
+  return ((uint64) value << 1) ^ (uint64) (value >> 63);
+}
+
+/**
+ * Zig-zag decoding of an int64 value
+ */
+static inline int64
+zigzag_decode(uint64 value)
+{
+  return (int64) (value >> 1) ^ -(int64) (value & 1);
+}
+
+/**
+ * Encodes the array of timestamps. The function fills the sample index and
+ * returns the number of bytes of the encoded deltas
+ *
+ * @param[out] samples Sample index
+ * @param[out] buf Buffer for the encoded deltas, which must have space for
+ * `VARINT_MAXLEN * count` bytes
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the array
+ */
+static size_t
+timestamps_encode(TimeSample *samples, uint8 *buf, const TimestampTz *times,
+  int count)
+{
+  size_t pos = 0;
+  int64 prevdelta = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (i % PACK_TIME_SAMPLE == 0)
+    {
+      TimeSample *sample = &samples[i / PACK_TIME_SAMPLE];
+      sample->t = times[i];
+      sample->pos = (int32) pos;
+      prevdelta = 0;
+      continue;
+    }
+    int64 delta = times[i] - times[i - 1];
+    pos += varint_write(buf + pos, zigzag_encode(delta - prevdelta));
+    prevdelta = delta;
+  }
+  return pos;
+}
+
+/**
+ * Decodes the timestamps from the n-th sample up to the instant `last`
+ * (inclusive) into the array
+ */
+static void
+timestamps_decode(TimestampTz *result, const TimeSample *samples,
+  const uint8 *buf, int n, int last)
+{
+  const uint8 *ptr = buf + samples[n].pos;
+  int first = n * PACK_TIME_SAMPLE;
+  TimestampTz t = samples[n].t;
+  int64 prevdelta = 0;
+  result[0] = t;
+  for (int i = first + 1; i <= last; i++)
+  {
+    if (i % PACK_TIME_SAMPLE == 0)
+    {
+      n = i / PACK_TIME_SAMPLE;
+      ptr = buf + samples[n].pos;
+      t = samples[n].t;
+      prevdelta = 0;
+    }
+    else
+    {
+      int64 delta = prevdelta + zigzag_decode(varint_read(&ptr));
+      t += delta;
+      prevdelta = delta;
+    }
+    result[i - first] = t;
+  }
+  return;
+}
+
+/*****************************************************************************
+ * Packed temporal points
+ *
+ * The memory structure of a packed temporal point with n instants is as
+ * follows
+ * @code
+ * ------------------------------------------------------------------------
+ * ( TemporalPacked )_X | ( bbox )_X | x_1 ... x_n | y_1 ... y_n | ...
+ * ------------------------------------------------------------------------
+ * ------------------------------------------------------
+ * ... | z_1 ... z_n | sample_1 ... sample_k | deltas |
+ * ------------------------------------------------------
+ * @endcode
+ * where the `X` are unused bytes added for double padding, the array of
+ * z coordinates is only present for 3D points, `sample_i` are the entries
+ * of the sample index of the timestamps, and `deltas` are the varint
+ * encoded deltas of the timestamps. The SRID is kept in the bounding box
+ * and the Z and geodetic flags are kept in the header.
+ *
+ * Quantized values, marked by the quantized flag, keep a PackQuant struct
+ * after the bounding box and store the coordinates as int32 multiples of
+ * the scale from the origin, followed by padding bytes. The other arrays
+ * are unchanged.
+ *
+ * Shuffled values, marked by the shuffled flag, store each array of
+ * coordinates split by byte plane, i.e., the first byte of all the
+ * coordinates, then their second byte, and so on. The bytes of the sign,
+ * the exponent, and the high-order digits of neighbouring coordinates are
+ * then contiguous, which makes the value much more compressible by TOAST.
+ * The arrays are unshuffled when the value is unpacked.
+ *****************************************************************************/
+
+/**
+ * Splits the array of elements by byte plane
+ *
+ * @param[out] dst Shuffled array
+ * @param[in] src Array of elements
+ * @param[in] count Number of elements in the array
+ * @param[in] size Size in bytes of the elements
+ */
+static void
+bytes_shuffle(uint8 *dst, const uint8 *src, int count, size_t size)
+{
+  for (size_t b = 0; b < size; b++)
+  {
+    for (int i = 0; i < count; i++)
+      dst[b * count + i] = src[i * size + b];
+  }
+  return;
+}
+
+/**
+ * Restores the array of elements split by byte plane
+ *
+ * @param[out] dst Array of elements
+ * @param[in] src Shuffled array
+ * @param[in] count Number of elements in the array
+ * @param[in] size Size in bytes of the elements
+ */
+static void
+bytes_unshuffle(uint8 *dst, const uint8 *src, int count, size_t size)
+{
+  for (int i = 0; i < count; i++)
+  {
+    for (size_t b = 0; b < size; b++)
+      dst[i * size + b] = src[b * count + i];
+  }
+  return;
+}
+
+/**
+ * Returns a pointer to the bounding box of the packed temporal point
+ */
+STBOX *
+tpointpk_bbox_ptr(const TemporalPacked *ptemp)
+{
+  return (STBOX *)((char *) ptemp + double_pad(sizeof(TemporalPacked)));
+}
+
+/**
+ * Returns a pointer to the scale and origin of the quantized packed
+ * temporal point
+ */
+static PackQuant *
+tpointpk_quant(const TemporalPacked *ptemp)
+{
+  assert(MOBDB_FLAGS_GET_QUANTIZED(ptemp->flags));
+  return (PackQuant *)((char *) tpointpk_bbox_ptr(ptemp) +
+    double_pad(sizeof(STBOX)));
+}
+
+/**
+ * Returns the size in bytes of a coordinate of the packed temporal point
+ */
+static size_t
+tpointpk_coord_size(int16 flags)
+{
+  return MOBDB_FLAGS_GET_QUANTIZED(flags) ? sizeof(int32) : sizeof(double);
+}
+
+/**
+ * Returns a pointer to the array of coordinates of the packed temporal point
+ *
+ * @param[in] ptemp Packed temporal point
+ * @param[in] dim Dimension, i.e., 0 for x, 1 for y, and 2 for z
+ * @note The array is an array of double or of int32 values depending on
+ * whether the value is quantized
+ */
+static char *
+tpointpk_coords(const TemporalPacked *ptemp, int dim)
+{
+  char *result = (char *) tpointpk_bbox_ptr(ptemp) + double_pad(sizeof(STBOX));
+  if (MOBDB_FLAGS_GET_QUANTIZED(ptemp->flags))
+    result += double_pad(sizeof(PackQuant));
+  return result + dim * ptemp->count * tpointpk_coord_size(ptemp->flags);
+}
+
+/**
+ * Returns a pointer to the sample index of the timestamps of the packed
+ * temporal point
+ */
+static TimeSample *
+tpointpk_samples(const TemporalPacked *ptemp)
+{
+  int ndims = MOBDB_FLAGS_GET_Z(ptemp->flags) ? 3 : 2;
+  return (TimeSample *) (tpointpk_coords(ptemp, 0) +
+    double_pad(ndims * ptemp->count * tpointpk_coord_size(ptemp->flags)));
+}
+
+/**
+ * Returns a pointer to the encoded deltas of the timestamps of the packed
+ * temporal point
+ */
+static uint8 *
+tpointpk_deltas(const TemporalPacked *ptemp)
+{
+  return (uint8 *) (tpointpk_samples(ptemp) +
+    PACK_TIME_NSAMPLES(ptemp->count));
+}
+
+/**
+ * Returns the temporal point instant set or sequence from the arrays of
+ * coordinates and timestamps
+ *
+ * @param[in] coords Arrays of x, y, and z coordinates
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of instants
+ * @param[in] model Temporal value from which the duration, the flags, and
+ * the base type are taken
+ * @param[in] p Bounds of the sequence, ignored for instant sets
+ * @param[in] srid SRID of the points
+ *
+ * @note Since all the points share the same SRID and flags, only the first
+ * one is serialized by PostGIS, the other ones are obtained by overwriting
+ * the coordinates of the first one.
+ */
+static Temporal *
+tpoint_from_coords(const double **coords, const TimestampTz *times,
+  int count, const Temporal *model, const Period *p, int32 srid)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(model->flags);
+  const double *x = coords[0], *y = coords[1], *z = coords[2];
+  LWPOINT *lwpoint = hasz ?
+    lwpoint_make3dz(srid, x[0], y[0], z[0]) :
+    lwpoint_make2d(srid, x[0], y[0]);
+  FLAGS_SET_GEODETIC(lwpoint->flags, MOBDB_FLAGS_GET_GEODETIC(model->flags));
+  GSERIALIZED *gs = geo_serialize((LWGEOM *) lwpoint);
+  lwpoint_free(lwpoint);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    if (hasz)
+    {
+      POINT3DZ *point = (POINT3DZ *) gs_get_point3dz_p(gs);
+      point->x = x[i];
+      point->y = y[i];
+      point->z = z[i];
+    }
+    else
+    {
+      POINT2D *point = (POINT2D *) gs_get_point2d_p(gs);
+      point->x = x[i];
+      point->y = y[i];
+    }
+    instants[i] = tinstant_make(PointerGetDatum(gs), times[i],
+      model->valuetypid);
+  }
+  /* The instants were already validated and normalized when packing */
+  Temporal *result = (model->duration == INSTANTSET) ?
+    (Temporal *) tinstantset_make1(instants, count) :
+    (Temporal *) tsequence_make1(instants, count, p->lower_inc,
+      p->upper_inc, MOBDB_FLAGS_GET_LINEAR(model->flags), NORMALIZE_NO);
+  for (int i = 0; i < count; i++)
+    pfree(instants[i]);
+  pfree(instants); pfree(gs);
+  return result;
+}
+
+/**
+ * Returns the packed representation of the temporal point instant set or
+ * sequence
+ *
+ * @param[in] temp Temporal point
+ * @param[in] scale Scale of the quantized coordinates, or 0 if the
+ * coordinates are kept as double values
+ * @param[in] shuffle True when the coordinates are split by byte plane
+ */
+static TemporalPacked *
+tpoint_pack(const Temporal *temp, double scale, bool shuffle)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(temp->flags);
+  int ndims = hasz ? 3 : 2;
+  bool quantized = scale > 0;
+  int count;
+  const STBOX *box;
+  TInstant **instants;
+  Period p;
+  if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (const TInstantSet *) temp;
+    count = ti->count;
+    box = tinstantset_bbox_ptr(ti);
+    instants = tinstantset_instants(ti);
+    period_set(&p, instants[0]->t, instants[count - 1]->t, true, true);
+  }
+  else
+  {
+    const TSequence *seq = (const TSequence *) temp;
+    count = seq->count;
+    box = tsequence_bbox_ptr(seq);
+    instants = tsequence_instants(seq);
+    p = seq->period;
+  }
+  TimestampTz *times = palloc(sizeof(TimestampTz) * count);
+  double *coords[3] = {NULL, NULL, NULL};
+  for (int j = 0; j < ndims; j++)
+    coords[j] = palloc(sizeof(double) * count);
+  for (int i = 0; i < count; i++)
+  {
+    times[i] = instants[i]->t;
+    if (hasz)
+    {
+      const POINT3DZ *point = datum_get_point3dz_p(tinstant_value(instants[i]));
+      coords[0][i] = point->x;
+      coords[1][i] = point->y;
+      coords[2][i] = point->z;
+    }
+    else
+    {
+      const POINT2D *point = datum_get_point2d_p(tinstant_value(instants[i]));
+      coords[0][i] = point->x;
+      coords[1][i] = point->y;
+    }
+  }
+
+  /* Quantize the coordinates */
+  PackQuant quant;
+  int32 *qcoords[3] = {NULL, NULL, NULL};
+  STBOX qbox;
+  if (quantized)
+  {
+    memset(&quant, 0, sizeof(PackQuant));
+    quant.scale = scale;
+    for (int j = 0; j < ndims; j++)
+    {
+      double min = coords[j][0];
+      for (int i = 1; i < count; i++)
+        min = Min(min, coords[j][i]);
+      quant.origin[j] = min;
+      qcoords[j] = palloc(sizeof(int32) * count);
+      for (int i = 0; i < count; i++)
+      {
+        double q = rint((coords[j][i] - min) / scale);
+        if (q > PG_INT32_MAX)
+          ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+            errmsg("The scale is too small for the extent of the temporal point")));
+        qcoords[j][i] = (int32) q;
+        coords[j][i] = min + qcoords[j][i] * scale;
+      }
+    }
+    /* Since the coordinates are rounded, the bounding box is the one of
+     * the decoded value */
+    Temporal *qtemp = tpoint_from_coords((const double **) coords, times,
+      count, temp, &p, box->srid);
+    temporal_bbox(&qbox, qtemp);
+    pfree(qtemp);
+    box = &qbox;
+  }
+
+  /* Encode the timestamps in a temporary buffer to know their size */
+  int nsamples = PACK_TIME_NSAMPLES(count);
+  TimeSample *samples = palloc(sizeof(TimeSample) * nsamples);
+  uint8 *deltas = palloc(VARINT_MAXLEN * count);
+  size_t deltasize = timestamps_encode(samples, deltas, times, count);
+  size_t coordsize = quantized ? sizeof(int32) : sizeof(double);
+  size_t size = double_pad(sizeof(TemporalPacked)) +
+    double_pad(sizeof(STBOX)) +
+    (quantized ? double_pad(sizeof(PackQuant)) : 0) +
+    double_pad(ndims * coordsize * count) +
+    sizeof(TimeSample) * nsamples + deltasize;
+  TemporalPacked *result = palloc0(size);
+  SET_VARSIZE(result, size);
+  result->duration = temp->duration;
+  result->flags = temp->flags;
+  MOBDB_FLAGS_SET_PACKED(result->flags, true);
+  MOBDB_FLAGS_SET_QUANTIZED(result->flags, quantized);
+  MOBDB_FLAGS_SET_SHUFFLED(result->flags, shuffle);
+  result->valuetypid = temp->valuetypid;
+  result->count = count;
+  result->deltasize = (int32) deltasize;
+  result->period = p;
+  memcpy(tpointpk_bbox_ptr(result), box, sizeof(STBOX));
+  if (quantized)
+    memcpy(tpointpk_quant(result), &quant, sizeof(PackQuant));
+  for (int j = 0; j < ndims; j++)
+  {
+    const uint8 *src = quantized ? (const uint8 *) qcoords[j] :
+      (const uint8 *) coords[j];
+    if (shuffle)
+      bytes_shuffle((uint8 *) tpointpk_coords(result, j), src, count,
+        coordsize);
+    else
+      memcpy(tpointpk_coords(result, j), src, coordsize * count);
+  }
+  memcpy(tpointpk_samples(result), samples, sizeof(TimeSample) * nsamples);
+  memcpy(tpointpk_deltas(result), deltas, deltasize);
+  for (int j = 0; j < ndims; j++)
+  {
+    pfree(coords[j]);
+    if (quantized)
+      pfree(qcoords[j]);
+  }
+  pfree(instants); pfree(times); pfree(samples); pfree(deltas);
+  return result;
+}
+
+/**
+ * Returns the temporal point from its packed representation
+ */
+static Temporal *
+tpoint_unpack(const TemporalPacked *ptemp)
+{
+  int ndims = MOBDB_FLAGS_GET_Z(ptemp->flags) ? 3 : 2;
+  int count = ptemp->count;
+  TimestampTz *times = palloc(sizeof(TimestampTz) * count);
+  timestamps_decode(times, tpointpk_samples(ptemp), tpointpk_deltas(ptemp),
+    0, count - 1);
+  /* Unshuffle the coordinates */
+  size_t coordsize = tpointpk_coord_size(ptemp->flags);
+  const char *raw[3] = {NULL, NULL, NULL};
+  char *unshuffled[3] = {NULL, NULL, NULL};
+  for (int j = 0; j < ndims; j++)
+  {
+    raw[j] = tpointpk_coords(ptemp, j);
+    if (MOBDB_FLAGS_GET_SHUFFLED(ptemp->flags))
+    {
+      unshuffled[j] = palloc(coordsize * count);
+      bytes_unshuffle((uint8 *) unshuffled[j], (const uint8 *) raw[j],
+        count, coordsize);
+      raw[j] = unshuffled[j];
+    }
+  }
+  const double *coords[3] = {NULL, NULL, NULL};
+  double *qcoords[3] = {NULL, NULL, NULL};
+  if (MOBDB_FLAGS_GET_QUANTIZED(ptemp->flags))
+  {
+    /* Decode the quantized coordinates */
+    const PackQuant *quant = tpointpk_quant(ptemp);
+    for (int j = 0; j < ndims; j++)
+    {
+      const int32 *q = (const int32 *) raw[j];
+      qcoords[j] = palloc(sizeof(double) * count);
+      for (int i = 0; i < count; i++)
+        qcoords[j][i] = quant->origin[j] + q[i] * quant->scale;
+      coords[j] = qcoords[j];
+    }
+  }
+  else
+  {
+    for (int j = 0; j < ndims; j++)
+      coords[j] = (const double *) raw[j];
+  }
+  Temporal *result = tpoint_from_coords(coords, times, count,
+    (const Temporal *) ptemp, &ptemp->period, tpointpk_bbox_ptr(ptemp)->srid);
+  for (int j = 0; j < ndims; j++)
+  {
+    if (qcoords[j] != NULL)
+      pfree(qcoords[j]);
+    if (unshuffled[j] != NULL)
+      pfree(unshuffled[j]);
+  }
+  pfree(times);
+  return result;
+}
+
+/**
+ * Returns the position of the timestamp in the packed temporal point
+ * using a binary search on the sample index of the timestamps
+ *
+ * @param[in] ptemp Packed temporal point
+ * @param[in] t Timestamp
+ * @result Returns the position of the instant whose timestamp is less than or
+ * equal to the timestamp, or -1 if the timestamp is before the first instant
+ */
+int
+temporalpk_find_timestamp(const TemporalPacked *ptemp, TimestampTz t)
+{
+  const TimeSample *samples = tpointpk_samples(ptemp);
+  int nsamples = PACK_TIME_NSAMPLES(ptemp->count);
+  if (t < samples[0].t)
+    return -1;
+  int first = 0, last = nsamples - 1;
+  while (first < last)
+  {
+    int middle = (first + last + 1) / 2;
+    if (samples[middle].t <= t)
+      first = middle;
+    else
+      last = middle - 1;
+  }
+  /* Decode the deltas of the block of the sample found */
+  int start = first * PACK_TIME_SAMPLE;
+  int end = Min(start + PACK_TIME_SAMPLE, ptemp->count) - 1;
+  TimestampTz times[PACK_TIME_SAMPLE];
+  timestamps_decode(times, samples, tpointpk_deltas(ptemp), first, end);
+  int i = end - start;
+  while (i > 0 && times[i] > t)
+    i--;
+  return start + i;
+}
+
+/**
+ * Returns the timestamp of the n-th instant of the packed temporal point,
+ * decoding only the deltas from the preceding sample
+ *
+ * @param[in] ptemp Packed temporal point
+ * @param[in] n Position of the instant, 0-based
+ */
+TimestampTz
+temporalpk_timestamp_n(const TemporalPacked *ptemp, int n)
+{
+  TimestampTz times[PACK_TIME_SAMPLE];
+  int sample = n / PACK_TIME_SAMPLE;
+  timestamps_decode(times, tpointpk_samples(ptemp), tpointpk_deltas(ptemp),
+    sample, n);
+  return times[n - sample * PACK_TIME_SAMPLE];
+}
+
+/**
+ * Returns the n-th point of the packed temporal point, reading only its
+ * coordinates from the arrays
+ */
+static LWPOINT *
+tpointpk_lwpoint_n(const TemporalPacked *ptemp, int n)
+{
+  bool hasz = MOBDB_FLAGS_GET_Z(ptemp->flags);
+  int ndims = hasz ? 3 : 2;
+  size_t size = tpointpk_coord_size(ptemp->flags);
+  double coords[3] = {0, 0, 0};
+  for (int j = 0; j < ndims; j++)
+  {
+    const uint8 *raw = (const uint8 *) tpointpk_coords(ptemp, j);
+    uint8 bytes[sizeof(double)];
+    /* The bytes of a shuffled coordinate are in different byte planes */
+    if (MOBDB_FLAGS_GET_SHUFFLED(ptemp->flags))
+      for (size_t b = 0; b < size; b++)
+        bytes[b] = raw[b * ptemp->count + n];
+    else
+      memcpy(bytes, raw + n * size, size);
+    if (MOBDB_FLAGS_GET_QUANTIZED(ptemp->flags))
+    {
+      const PackQuant *quant = tpointpk_quant(ptemp);
+      int32 q;
+      memcpy(&q, bytes, sizeof(int32));
+      coords[j] = quant->origin[j] + q * quant->scale;
+    }
+    else
+      memcpy(&coords[j], bytes, sizeof(double));
+  }
+  int32 srid = tpointpk_bbox_ptr(ptemp)->srid;
+  LWPOINT *lwpoint = hasz ?
+    lwpoint_make3dz(srid, coords[0], coords[1], coords[2]) :
+    lwpoint_make2d(srid, coords[0], coords[1]);
+  FLAGS_SET_GEODETIC(lwpoint->flags, MOBDB_FLAGS_GET_GEODETIC(ptemp->flags));
+  return lwpoint;
+}
+
+/**
+ * Returns the n-th instant of the packed temporal point
+ */
+static TInstant *
+tpointpk_inst_n(const TemporalPacked *ptemp, int n, TimestampTz t)
+{
+  LWPOINT *lwpoint = tpointpk_lwpoint_n(ptemp, n);
+  GSERIALIZED *gs = geo_serialize((LWGEOM *) lwpoint);
+  lwpoint_free(lwpoint);
+  TInstant *result = tinstant_make(PointerGetDatum(gs), t, ptemp->valuetypid);
+  pfree(gs);
+  return result;
+}
+
+/**
+ * Returns the base value of the packed temporal point at the timestamp
+ *
+ * Only the instants surrounding the timestamp are decoded, the value is
+ * not unpacked.
+ *
+ * @param[in] ptemp Packed temporal point
+ * @param[in] t Timestamp
+ * @param[out] result Base value
+ * @result Returns true if the timestamp is contained in the temporal point
+ */
+bool
+temporalpk_value_at_timestamp(const TemporalPacked *ptemp, TimestampTz t,
+  Datum *result)
+{
+  if (! contains_period_timestamp_internal(&ptemp->period, t))
+    return false;
+  int n = temporalpk_find_timestamp(ptemp, t);
+  if (n < 0)
+    return false;
+  TimestampTz t1 = temporalpk_timestamp_n(ptemp, n);
+  if (t1 != t && (ptemp->duration == INSTANTSET || n == ptemp->count - 1))
+    return false;
+  TInstant *inst1 = tpointpk_inst_n(ptemp, n, t1);
+  if (t1 == t)
+    *result = tinstant_value_copy(inst1);
+  else
+  {
+    TInstant *inst2 = tpointpk_inst_n(ptemp, n + 1,
+      temporalpk_timestamp_n(ptemp, n + 1));
+    *result = tsequence_value_at_timestamp1(inst1, inst2,
+      MOBDB_FLAGS_GET_LINEAR(ptemp->flags), t);
+    pfree(inst2);
+  }
+  pfree(inst1);
+  return true;
+}
+
+/**
+ * Restricts the packed temporal point to the period
+ *
+ * The sample index locates the instants surrounding the bounds of the
+ * period, only these instants are decoded into a temporal value that is
+ * then restricted with the usual functions, the value is not unpacked.
+ *
+ * @note The function returns its argument rather than a copy of it when
+ * the period contains the temporal point
+ */
+Temporal *
+temporalpk_at_period(const TemporalPacked *ptemp, const Period *p)
+{
+  if (! overlaps_period_period_internal(p, &ptemp->period))
+    return NULL;
+  if (contains_period_period_internal(p, &ptemp->period))
+    return (Temporal *) ptemp;
+
+  int first = Max(temporalpk_find_timestamp(ptemp, p->lower), 0);
+  int last = temporalpk_find_timestamp(ptemp, p->upper);
+  /* The instant following the upper bound of the period is needed for
+   * computing the value at this bound */
+  if (ptemp->duration == SEQUENCE && last < ptemp->count - 1)
+    last++;
+  int count = last - first + 1;
+  int start = (first / PACK_TIME_SAMPLE) * PACK_TIME_SAMPLE;
+  TimestampTz *times = palloc(sizeof(TimestampTz) * (last - start + 1));
+  timestamps_decode(times, tpointpk_samples(ptemp), tpointpk_deltas(ptemp),
+    first / PACK_TIME_SAMPLE, last);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    instants[i] = tpointpk_inst_n(ptemp, first + i, times[first - start + i]);
+  pfree(times);
+
+  Temporal *result;
+  if (ptemp->duration == INSTANTSET)
+  {
+    TInstantSet *ti = tinstantset_make_free(instants, count);
+    result = (Temporal *) tinstantset_restrict_period(ti, p, REST_AT);
+    pfree(ti);
+  }
+  else
+  {
+    /* The bounds of the decoded instants are those of the temporal point
+     * only when they are its first or last instant */
+    bool lower_inc = (first == 0) ? ptemp->period.lower_inc : true;
+    bool upper_inc = (last == ptemp->count - 1) ?
+      ptemp->period.upper_inc : true;
+    TSequence *seq = tsequence_make_free(instants, count, lower_inc,
+      upper_inc, MOBDB_FLAGS_GET_LINEAR(ptemp->flags), NORMALIZE_NO);
+    result = (Temporal *) tsequence_at_period(seq, p);
+    pfree(seq);
+  }
+  return result;
+}
+
+/**
+ * Returns the timestamps of the packed temporal point as an array
+ */
+ArrayType *
+temporalpk_timestamps(const TemporalPacked *ptemp)
+{
+  TimestampTz *times = palloc(sizeof(TimestampTz) * ptemp->count);
+  timestamps_decode(times, tpointpk_samples(ptemp), tpointpk_deltas(ptemp),
+    0, ptemp->count - 1);
+  ArrayType *result = timestamparr_to_array(times, ptemp->count);
+  pfree(times);
+  return result;
+}
+
+/**
+ * Returns the trajectory of the packed temporal point, which is computed
+ * from the arrays of coordinates without decoding the timestamps
+ */
+Datum
+tpointpk_trajectory(const TemporalPacked *ptemp)
+{
+  LWPOINT **points = palloc(sizeof(LWPOINT *) * ptemp->count);
+  for (int i = 0; i < ptemp->count; i++)
+    points[i] = tpointpk_lwpoint_n(ptemp, i);
+  Datum result = lwpointarr_trajectory(points, ptemp->count,
+    ptemp->duration == SEQUENCE && MOBDB_FLAGS_GET_LINEAR(ptemp->flags));
+  pfree(points);
+  return result;
+}
+
+/*****************************************************************************
+ * Dispatch functions
+ *****************************************************************************/
+
+/**
+ * Returns true if the temporal value has a packed representation
+ */
+bool
+temporal_packable(const Temporal *temp)
+{
+  return (temp->duration == INSTANTSET || temp->duration == SEQUENCE) &&
+    tgeo_base_type(temp->valuetypid);
+}
+
+/**
+ * Returns the packed representation of the temporal value
+ *
+ * @note The function returns its argument if the temporal value is already
+ * packed or if it does not have a packed representation
+ */
+Temporal *
+temporal_pack_internal(const Temporal *temp, double scale, bool shuffle)
+{
+  if (MOBDB_FLAGS_GET_PACKED(temp->flags) || ! temporal_packable(temp))
+    return (Temporal *) temp;
+  return (Temporal *) tpoint_pack(temp, scale, shuffle);
+}
+
+/**
+ * Returns the temporal value in the standard format from its packed
+ * representation
+ *
+ * @note The function returns its argument if the temporal value is not
+ * packed. This function is called when fetching the arguments of the
+ * external functions, and thus it must be cheap for standard values
+ */
+Temporal *
+temporal_unpack(Temporal *temp)
+{
+  if (! MOBDB_FLAGS_GET_PACKED(temp->flags))
+    return temp;
+  assert(temporal_packable(temp));
+  return tpoint_unpack((TemporalPacked *) temp);
+}
+
+/**
+ * Returns the temporal value detoasted, counting the bytes of the values
+ * that are fetched from the TOAST table or decompressed
+ *
+ * The values stored in a TOAST table are taken from the shared cache when
+ * it is enabled, and are kept in it otherwise.
+ *
+ * @note This function is called when fetching the arguments of the
+ * external functions in place of PG_DETOAST_DATUM
+ */
+Temporal *
+temporal_detoast(Datum value)
+{
+  struct varlena *ptr = (struct varlena *) DatumGetPointer(value);
+  if (! VARATT_IS_EXTENDED(ptr))
+    return (Temporal *) ptr;
+  Temporal *result = (Temporal *) shared_cache_get(ptr);
+  if (result != NULL)
+    return result;
+  result = (Temporal *) pg_detoast_datum(ptr);
+  FUNC_STAT_ADD(FUNC_STAT_DETOAST_BYTES, VARSIZE(result));
+  shared_cache_put(ptr, (struct varlena *) result);
+  return result;
+}
+
+PG_FUNCTION_INFO_V1(temporal_pack);
+/**
+ * Returns the packed representation of the temporal value
+ *
+ * The optional second argument is the scale of the quantized coordinates,
+ * e.g., 1e-7 for coordinates in degrees with a precision of about 1 cm.
+ */
+PGDLLEXPORT Datum
+temporal_pack(PG_FUNCTION_ARGS)
+{
+  /* Do not use PG_GETARG_TEMPORAL since it unpacks the value */
+  Temporal *temp = (Temporal *) PG_GETARG_VARLENA_P(0);
+  double scale = (PG_NARGS() == 2) ? PG_GETARG_FLOAT8(1) : 0;
+  if (PG_NARGS() == 2 && scale <= 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The scale must be strictly positive")));
+  Temporal *result = temporal_pack_internal(temp, scale, false);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
+  PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(temporal_pack_shuffle);
+/**
+ * Returns the packed representation of the temporal value whose
+ * coordinates are split by byte plane if the last argument is true
+ *
+ * The optional second argument is the scale of the quantized coordinates.
+ */
+PGDLLEXPORT Datum
+temporal_pack_shuffle(PG_FUNCTION_ARGS)
+{
+  /* Do not use PG_GETARG_TEMPORAL since it unpacks the value */
+  Temporal *temp = (Temporal *) PG_GETARG_VARLENA_P(0);
+  double scale = (PG_NARGS() == 3) ? PG_GETARG_FLOAT8(1) : 0;
+  bool shuffle = PG_GETARG_BOOL(PG_NARGS() - 1);
+  if (PG_NARGS() == 3 && scale <= 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The scale must be strictly positive")));
+  Temporal *result = temporal_pack_internal(temp, scale, shuffle);
+  PG_FREE_IF_COPY_NOT_RESULT(temp, result, 0);
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
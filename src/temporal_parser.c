@@ -17,6 +17,9 @@
 
 #include "temporal_parser.h"
 
+#include <pgtime.h>
+#include <utils/datetime.h>
+
 #include "periodset.h"
 #include "period.h"
 #include "timestampset.h"
@@ -294,6 +297,136 @@ tbox_parse(char **str)
 /*****************************************************************************/
 /* Time Types */
 
+/**
+ * Reads the given number of digits from the string, returns -1 if they are
+ * not all digits
+ */
+static int
+iso_digits(const char *str, int ndigits)
+{
+  int result = 0;
+  for (int i = 0; i < ndigits; i++)
+  {
+    if (str[i] < '0' || str[i] > '9')
+      return -1;
+    result = result * 10 + (str[i] - '0');
+  }
+  return result;
+}
+
+/**
+ * Parse a timestamp in ISO 8601 format without calling the input function
+ * of timestamptz, e.g., "2019-08-06 18:35:48.021455+02:30"
+ *
+ * The accepted format is YYYY-MM-DD followed by an optional time HH:MM or
+ * HH:MM:SS[.ffffff], separated from the date by a space or by 'T', and an
+ * optional offset Z or +HH[[:]MM[[:]SS]]. Timestamps without offset are in
+ * the time zone of the session, as for the input function.
+ *
+ * @param[in] str Input string, which does not need to be null-terminated
+ * @param[in] len Length of the input string
+ * @param[out] result Timestamp
+ * @result Returns false if the string is not in this format, in which case
+ * it must be given to the input function
+ */
+bool
+timestamp_parse_iso(const char *str, int len, TimestampTz *result)
+{
+  /* Trailing white spaces are allowed */
+  while (len > 0 && (str[len - 1] == ' ' || str[len - 1] == '\t' ||
+      str[len - 1] == '\n' || str[len - 1] == '\r'))
+    len--;
+  if (len < 10 || str[4] != '-' || str[7] != '-')
+    return false;
+
+  struct pg_tm tt, *tm = &tt;
+  memset(tm, 0, sizeof(struct pg_tm));
+  fsec_t fsec = 0;
+  tm->tm_year = iso_digits(str, 4);
+  tm->tm_mon = iso_digits(str + 5, 2);
+  tm->tm_mday = iso_digits(str + 8, 2);
+  if (tm->tm_year < 1 || tm->tm_mon < 1 || tm->tm_mon > MONTHS_PER_YEAR ||
+    tm->tm_mday < 1 ||
+    tm->tm_mday > day_tab[isleap(tm->tm_year)][tm->tm_mon - 1])
+    return false;
+
+  /* Time */
+  int pos = 10;
+  if (pos < len && (str[pos] == ' ' || str[pos] == 'T'))
+  {
+    if (pos + 6 > len || str[pos + 3] != ':')
+      return false;
+    tm->tm_hour = iso_digits(str + pos + 1, 2);
+    tm->tm_min = iso_digits(str + pos + 4, 2);
+    pos += 6;
+    if (pos < len && str[pos] == ':')
+    {
+      if (pos + 3 > len)
+        return false;
+      tm->tm_sec = iso_digits(str + pos + 1, 2);
+      pos += 3;
+      if (pos < len && str[pos] == '.')
+      {
+        /* Digits after the microseconds are left to the input function
+         * which rounds them */
+        int ndigits = 0;
+        pos++;
+        while (pos < len && str[pos] >= '0' && str[pos] <= '9')
+        {
+          if (ndigits++ == 6)
+            return false;
+          fsec = fsec * 10 + (str[pos++] - '0');
+        }
+        if (ndigits == 0)
+          return false;
+        for (; ndigits < 6; ndigits++)
+          fsec *= 10;
+      }
+    }
+    if (tm->tm_hour < 0 || tm->tm_hour >= HOURS_PER_DAY ||
+      tm->tm_min < 0 || tm->tm_min >= MINS_PER_HOUR ||
+      tm->tm_sec < 0 || tm->tm_sec >= SECS_PER_MINUTE)
+      return false;
+  }
+
+  /* Offset, the time zone value is given in seconds west of Greenwich */
+  int tz;
+  if (pos < len && (str[pos] == '+' || str[pos] == '-'))
+  {
+    int sign = (str[pos] == '+') ? -1 : 1, nparts = 0, secs = 0;
+    pos++;
+    while (nparts < 3 && pos + 2 <= len)
+    {
+      int part = iso_digits(str + pos, 2);
+      if (part < 0 || (nparts > 0 && part >= 60))
+        return false;
+      secs = secs * 60 + part;
+      nparts++;
+      pos += 2;
+      /* The parts of the offset may be separated by colons */
+      if (pos < len && str[pos] == ':')
+        pos++;
+    }
+    if (nparts == 0 || str[pos - 1] == ':')
+      return false;
+    for (int i = nparts; i < 3; i++)
+      secs *= 60;
+    if (secs >= (MAX_TZDISP_HOUR + 1) * SECS_PER_HOUR)
+      return false;
+    tz = sign * secs;
+  }
+  else if (pos < len && str[pos] == 'Z')
+  {
+    tz = 0;
+    pos++;
+  }
+  else
+    tz = DetermineTimeZoneOffset(tm, session_timezone);
+  if (pos != len)
+    return false;
+  return (tm2timestamp(tm, fsec, &tz, result) == 0);
+}
+
 /**
  * Parse a timestamp value from the buffer
  */
@@ -305,10 +438,14 @@ timestamp_parse(char **str)
   while ((*str)[delim] != ',' && (*str)[delim] != ']' && (*str)[delim] != ')' && 
     (*str)[delim] != '}' && (*str)[delim] != '\0')
     delim++;
-  char bak = (*str)[delim];
-  (*str)[delim] = '\0';
-  Datum result = call_input(TIMESTAMPTZOID, *str);
-  (*str)[delim] = bak;
+  TimestampTz result;
+  if (! timestamp_parse_iso(*str, delim, &result))
+  {
+    char bak = (*str)[delim];
+    (*str)[delim] = '\0';
+    result = DatumGetTimestampTz(call_input(TIMESTAMPTZOID, *str));
+    (*str)[delim] = bak;
+  }
   *str += delim;
   return result;
 }
@@ -449,11 +449,44 @@ PG_FUNCTION_INFO_V1(temporal_joinsel);
 /*
  * Estimate the join selectivity value of the operators for temporal types
  * whose bounding box is a period, that is, tbool and ttext.
+ *
+ * The selectivity is computed from the histograms of period bounds of both
+ * columns.
  */
 PGDLLEXPORT Datum
 temporal_joinsel(PG_FUNCTION_ARGS)
 {
-  PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+  PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+  Oid operator = PG_GETARG_OID(1);
+  List *args = (List *) PG_GETARG_POINTER(2);
+  SpecialJoinInfo *sjinfo = (SpecialJoinInfo *) PG_GETARG_POINTER(4);
+  VariableStatData vardata1, vardata2;
+  bool join_is_reversed;
+  Selectivity selec;
+  CachedOp cachedOp;
+
+  /*
+   * Get enumeration value associated to the operator
+   */
+  bool found = temporal_cachedop(operator, &cachedOp);
+  /* In the case of unknown operator */
+  if (!found)
+    PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+
+  /* Only joins between two binary operator arguments are estimated */
+  if (list_length(args) != 2)
+    PG_RETURN_FLOAT8(default_temporal_selectivity(cachedOp));
+
+  get_join_variables(root, args, sjinfo, &vardata1, &vardata2,
+    &join_is_reversed);
+  selec = calc_period_hist_joinselectivity(&vardata1, &vardata2, cachedOp);
+  if (selec < 0.0)
+    selec = default_temporal_selectivity(cachedOp);
+
+  ReleaseVariableStats(vardata1);
+  ReleaseVariableStats(vardata2);
+  CLAMP_PROBABILITY(selec);
+  PG_RETURN_FLOAT8(selec);
 }
 
 /*****************************************************************************/
@@ -0,0 +1,554 @@
+/*****************************************************************************
+ *
+ * temporal_sharedcache.c
+ *    Cache of detoasted temporal values shared by all the backends.
+ *
+ * A small set of reference values, e.g., the routes of a bus network, may
+ * be read by every query of many backends, each of them fetching the values
+ * from the TOAST table and decompressing them in every query. The cache
+ * keeps in shared memory the detoasted values fetched from TOAST tables,
+ * identified by the database, the TOAST table, and the identifier of the
+ * value in it. These values are never modified in place: an update of a
+ * value stores a new one with a new identifier. However, the identifiers
+ * of the values removed by VACUUM may be reused by new values, and TRUNCATE,
+ * CLUSTER, or VACUUM FULL fill the TOAST table again. All of these send an
+ * invalidation of the relation cache entry of the TOAST table, upon which
+ * any backend increments the epoch of the TOAST table in shared memory.
+ * Since the epoch is part of the key of the values, the values cached
+ * before the invalidation are no longer found and are evicted when their
+ * slot is needed.
+ *
+ * The cache is only available when the extension is loaded with
+ * shared_preload_libraries and mobilitydb.shared_cache_size is not zero.
+ * It is divided into slots of mobilitydb.shared_cache_entry_size, values
+ * that are larger not being cached. A value can only be kept in the
+ * SHARED_CACHE_WAYS consecutive slots of the set given by its hash, in which
+ * a slot is chosen for a new value with the CLOCK algorithm. A value is only
+ * written into a slot when it is missed for the second time: the hashes of
+ * the keys of the values missed once are kept in SHARED_CACHE_WAYS entries
+ * of the set, so that a scan of values that are read only once neither
+ * copies them into the cache nor evicts the values of the cache.
+ *
+ * The values are read without taking any lock. Every slot has a version
+ * number, which is odd while the slot is written. A reader copies the value
+ * and then verifies that the version did not change, otherwise the copy is
+ * discarded and the value is read from the TOAST table. The writers take
+ * the exclusive lock of the set of slots to serialize the choice of the
+ * slots, the sets being distributed over SHARED_CACHE_LOCKS locks.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_sharedcache.h"
+
+#include <access/hash.h>
+#if MOBDB_PGSQL_VERSION >= 130000
+#include <access/detoast.h>
+#else
+#include <access/tuptoaster.h>
+#endif
+#include <miscadmin.h>
+#include <port/atomics.h>
+#include <storage/ipc.h>
+#include <storage/lwlock.h>
+#include <storage/shmem.h>
+#include <utils/inval.h>
+
+#include "funcstat.h"
+
+/*****************************************************************************/
+
+/**
+ * Size of the cache in kilobytes, 0 disabling the cache
+ */
+int shared_cache_size = 0;
+
+/**
+ * Size of the slots of the cache in kilobytes
+ */
+int shared_cache_entry_size = 64;
+
+/**
+ * True when the backend reads and writes the values of the cache
+ */
+bool enable_shared_cache = true;
+
+/**
+ * Structure to identify a value stored in a TOAST table
+ */
+typedef struct
+{
+  Oid         dbid;           /**< database of the TOAST table */
+  Oid         toastrelid;     /**< TOAST table */
+  Oid         valueid;        /**< identifier of the value in the table */
+  int32       rawsize;        /**< size of the detoasted value */
+  uint32      epoch;          /**< epoch of the TOAST table */
+} SharedCacheKey;
+
+/**
+ * Structure of the header of a slot of the cache, which is followed by the
+ * value
+ */
+typedef struct
+{
+  pg_atomic_uint32 version;   /**< odd while the slot is written */
+  pg_atomic_uint32 referenced; /**< reference bit of the CLOCK algorithm */
+  SharedCacheKey key;         /**< identifier of the value */
+  Size        size;           /**< size of the value or 0 if empty */
+} SharedCacheSlot;
+
+/**
+ * Structure of the cache in shared memory, which is followed by the hands
+ * of the CLOCK algorithm of the sets, the hands and the hashes of the values
+ * missed once of the sets, and the slots
+ *
+ * The epochs of the TOAST tables are kept in SHARED_CACHE_EPOCHS counters
+ * chosen by the hash of the table, so that an invalidation of a table may
+ * also evict the values of the other tables sharing its counter.
+ */
+typedef struct
+{
+  LWLockPadded *locks;        /**< locks serializing the writers of a set */
+  int         nsets;          /**< number of sets of slots */
+  Size        slotsize;       /**< size of a slot including its header */
+  pg_atomic_uint32 epochs[SHARED_CACHE_EPOCHS]; /**< epochs of the tables */
+} SharedCache;
+
+#define SHARED_CACHE_NAME "mobilitydb shared cache"
+
+#define SLOT_HEADER_SIZE MAXALIGN(sizeof(SharedCacheSlot))
+
+/**
+ * Cache in shared memory, NULL when it is not available
+ */
+static SharedCache *shared_cache = NULL;
+
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+#if MOBDB_PGSQL_VERSION >= 150000
+static shmem_request_hook_type prev_shmem_request_hook = NULL;
+#endif
+
+/**
+ * Returns the size of a slot of the cache
+ */
+static Size
+shared_cache_slotsize(void)
+{
+  return SLOT_HEADER_SIZE + MAXALIGN((Size) shared_cache_entry_size * 1024);
+}
+
+/**
+ * Returns the number of sets of slots of the cache
+ */
+static int
+shared_cache_nsets(void)
+{
+  return (int) (((Size) shared_cache_size * 1024) /
+    (shared_cache_slotsize() * SHARED_CACHE_WAYS));
+}
+
+/**
+ * Returns the offset of the slots from the start of the shared memory of
+ * the cache
+ */
+static Size
+shared_cache_slots_offset(Size nsets)
+{
+  return MAXALIGN(sizeof(SharedCache)) + 2 * MAXALIGN(nsets) +
+    MAXALIGN(nsets * SHARED_CACHE_WAYS * sizeof(uint32));
+}
+
+/**
+ * Returns the size of the shared memory of the cache
+ */
+static Size
+shared_cache_memsize(void)
+{
+  Size nsets = (Size) shared_cache_nsets();
+  return shared_cache_slots_offset(nsets) +
+    nsets * SHARED_CACHE_WAYS * shared_cache_slotsize();
+}
+
+/**
+ * Returns the hands of the CLOCK algorithm of the sets
+ */
+static uint8 *
+shared_cache_hands(void)
+{
+  return (uint8 *) shared_cache + MAXALIGN(sizeof(SharedCache));
+}
+
+/**
+ * Returns the hands of the hashes of the values missed once of the sets
+ */
+static uint8 *
+shared_cache_missed_hands(void)
+{
+  return shared_cache_hands() + MAXALIGN((Size) shared_cache->nsets);
+}
+
+/**
+ * Returns the hashes of the values missed once, SHARED_CACHE_WAYS for each
+ * set, 0 denoting an empty entry
+ */
+static uint32 *
+shared_cache_missed(void)
+{
+  return (uint32 *) (shared_cache_missed_hands() +
+    MAXALIGN((Size) shared_cache->nsets));
+}
+
+/**
+ * Returns the n-th slot of the cache
+ */
+static SharedCacheSlot *
+shared_cache_slot(int n)
+{
+  return (SharedCacheSlot *) ((char *) shared_cache +
+    shared_cache_slots_offset((Size) shared_cache->nsets) +
+    (Size) n * shared_cache->slotsize);
+}
+
+/**
+ * Requests the shared memory and the lock of the cache
+ */
+static void
+shared_cache_shmem_request(void)
+{
+#if MOBDB_PGSQL_VERSION >= 150000
+  if (prev_shmem_request_hook)
+    prev_shmem_request_hook();
+#endif
+  RequestAddinShmemSpace(shared_cache_memsize());
+  RequestNamedLWLockTranche(SHARED_CACHE_NAME, SHARED_CACHE_LOCKS);
+  return;
+}
+
+/**
+ * Attaches to the shared memory of the cache, which is initialized by the
+ * first process
+ */
+static void
+shared_cache_shmem_startup(void)
+{
+  if (prev_shmem_startup_hook)
+    prev_shmem_startup_hook();
+  LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+  bool found;
+  SharedCache *cache = ShmemInitStruct(SHARED_CACHE_NAME,
+    shared_cache_memsize(), &found);
+  if (! found)
+  {
+    cache->locks = GetNamedLWLockTranche(SHARED_CACHE_NAME);
+    cache->nsets = shared_cache_nsets();
+    cache->slotsize = shared_cache_slotsize();
+    for (int i = 0; i < SHARED_CACHE_EPOCHS; i++)
+      pg_atomic_init_u32(&cache->epochs[i], 0);
+  }
+  shared_cache = cache;
+  if (! found)
+  {
+    memset(shared_cache_hands(), 0, (Size) cache->nsets);
+    memset(shared_cache_missed_hands(), 0, (Size) cache->nsets);
+    memset(shared_cache_missed(), 0,
+      (Size) cache->nsets * SHARED_CACHE_WAYS * sizeof(uint32));
+    for (int i = 0; i < cache->nsets * SHARED_CACHE_WAYS; i++)
+    {
+      SharedCacheSlot *slot = shared_cache_slot(i);
+      pg_atomic_init_u32(&slot->version, 0);
+      pg_atomic_init_u32(&slot->referenced, 0);
+      memset(&slot->key, 0, sizeof(SharedCacheKey));
+      slot->size = 0;
+    }
+  }
+  LWLockRelease(AddinShmemInitLock);
+  return;
+}
+
+/**
+ * Returns the epoch counter of the TOAST table
+ */
+static pg_atomic_uint32 *
+shared_cache_epoch(Oid dbid, Oid toastrelid)
+{
+  Oid relid[2] = {dbid, toastrelid};
+  uint32 hash = DatumGetUInt32(hash_any((unsigned char *) relid,
+    sizeof(relid)));
+  return &shared_cache->epochs[hash % SHARED_CACHE_EPOCHS];
+}
+
+/**
+ * Invalidates the values of the TOAST table whose relation cache entry is
+ * invalidated, or the values of all tables if the relation is not given
+ *
+ * @note The callback is called for every relation and not only for the
+ * TOAST tables, which are not distinguished to avoid any catalog access
+ * in the callback
+ */
+static void
+shared_cache_relcache_callback(Datum arg, Oid relid)
+{
+  if (shared_cache == NULL)
+    return;
+  if (! OidIsValid(relid))
+  {
+    for (int i = 0; i < SHARED_CACHE_EPOCHS; i++)
+      pg_atomic_fetch_add_u32(&shared_cache->epochs[i], 1);
+  }
+  else
+    pg_atomic_fetch_add_u32(shared_cache_epoch(MyDatabaseId, relid), 1);
+  return;
+}
+
+/**
+ * Returns the lock of the set of slots starting at the slot
+ */
+static LWLock *
+shared_cache_lock(int first)
+{
+  return &shared_cache->locks[(first / SHARED_CACHE_WAYS) %
+    SHARED_CACHE_LOCKS].lock;
+}
+
+/**
+ * Installs the hooks creating the cache in shared memory
+ *
+ * @note This function is called by _PG_init after the definition of the
+ * configuration parameters of the cache
+ */
+void
+shared_cache_init(void)
+{
+  if (! process_shared_preload_libraries_in_progress ||
+    shared_cache_size == 0 || shared_cache_nsets() == 0)
+    return;
+#if MOBDB_PGSQL_VERSION >= 150000
+  prev_shmem_request_hook = shmem_request_hook;
+  shmem_request_hook = shared_cache_shmem_request;
+#else
+  shared_cache_shmem_request();
+#endif
+  prev_shmem_startup_hook = shmem_startup_hook;
+  shmem_startup_hook = shared_cache_shmem_startup;
+  CacheRegisterRelcacheCallback(shared_cache_relcache_callback, (Datum) 0);
+  return;
+}
+
+/*****************************************************************************/
+
+/**
+ * Sets the key of the value referenced by the TOAST pointer and its hash,
+ * and returns the first slot of its set, or -1 if the value cannot be
+ * cached
+ */
+static int
+shared_cache_key(const struct varlena *ptr, SharedCacheKey *key,
+  uint32 *hash)
+{
+  if (shared_cache == NULL || ! enable_shared_cache ||
+    ! VARATT_IS_EXTERNAL_ONDISK(ptr))
+    return -1;
+  struct varatt_external toast_pointer;
+  VARATT_EXTERNAL_GET_POINTER(toast_pointer, ptr);
+  memset(key, 0, sizeof(SharedCacheKey));
+  key->dbid = MyDatabaseId;
+  key->toastrelid = toast_pointer.va_toastrelid;
+  key->valueid = toast_pointer.va_valueid;
+  key->rawsize = toast_pointer.va_rawsize;
+  key->epoch = pg_atomic_read_u32(shared_cache_epoch(key->dbid,
+    key->toastrelid));
+  *hash = DatumGetUInt32(hash_any((unsigned char *) key,
+    sizeof(SharedCacheKey)));
+  return (int) (*hash % (uint32) shared_cache->nsets) * SHARED_CACHE_WAYS;
+}
+
+/**
+ * Returns a copy of the value of the slot if it has the key, or NULL
+ * otherwise, including when the slot is written while it is read
+ */
+static struct varlena *
+shared_cache_read(SharedCacheSlot *slot, const SharedCacheKey *key)
+{
+  uint32 version = pg_atomic_read_u32(&slot->version);
+  if (version & 1)
+    return NULL;
+  pg_read_barrier();
+  volatile SharedCacheSlot *vslot = slot;
+  Size size = vslot->size;
+  if (size == 0 || size > shared_cache->slotsize - SLOT_HEADER_SIZE ||
+    memcmp((const void *) &vslot->key, key, sizeof(SharedCacheKey)) != 0)
+    return NULL;
+  struct varlena *result = palloc(size);
+  memcpy(result, (char *) slot + SLOT_HEADER_SIZE, size);
+  pg_read_barrier();
+  if (pg_atomic_read_u32(&slot->version) != version)
+  {
+    pfree(result);
+    return NULL;
+  }
+  pg_atomic_write_u32(&slot->referenced, 1);
+  return result;
+}
+
+/**
+ * Returns a copy of the detoasted value referenced by the TOAST pointer if
+ * it is in the cache, or NULL otherwise
+ */
+struct varlena *
+shared_cache_get(const struct varlena *ptr)
+{
+  SharedCacheKey key;
+  uint32 hash;
+  int first = shared_cache_key(ptr, &key, &hash);
+  if (first < 0)
+    return NULL;
+  for (int i = 0; i < SHARED_CACHE_WAYS; i++)
+  {
+    struct varlena *result = shared_cache_read(shared_cache_slot(first + i),
+      &key);
+    if (result != NULL)
+    {
+      FUNC_STAT_ADD(FUNC_STAT_SHARED_CACHE_HITS, 1);
+      return result;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Writes the value into the slot
+ *
+ * @pre The exclusive lock of the set of the slot is held
+ */
+static void
+shared_cache_write(SharedCacheSlot *slot, const SharedCacheKey *key,
+  const struct varlena *value, Size size)
+{
+  /* The version is odd while the slot is written, the atomic operations
+   * being full memory barriers */
+  pg_atomic_fetch_add_u32(&slot->version, 1);
+  slot->key = *key;
+  slot->size = size;
+  if (size > 0)
+    memcpy((char *) slot + SLOT_HEADER_SIZE, value, size);
+  pg_atomic_fetch_add_u32(&slot->version, 1);
+  /* A new value is the first one evicted from its set if it is not read
+   * again, so that a scan of many values does not evict the values that
+   * are read often */
+  pg_atomic_write_u32(&slot->referenced, 0);
+  return;
+}
+
+/**
+ * Returns true if the value of the hash was already missed once in the set
+ * of slots starting at the slot, in which case the hash is removed, and
+ * records the hash otherwise
+ *
+ * @pre The exclusive lock of the set is held
+ */
+static bool
+shared_cache_missed_twice(int first, uint32 hash)
+{
+  uint32 *missed = &shared_cache_missed()[first];
+  /* The value 0 denotes an empty entry */
+  if (hash == 0)
+    hash = 1;
+  for (int i = 0; i < SHARED_CACHE_WAYS; i++)
+  {
+    if (missed[i] == hash)
+    {
+      missed[i] = 0;
+      return true;
+    }
+  }
+  uint8 *hand = &shared_cache_missed_hands()[first / SHARED_CACHE_WAYS];
+  missed[*hand] = hash;
+  *hand = (uint8) ((*hand + 1) % SHARED_CACHE_WAYS);
+  return false;
+}
+
+/**
+ * Keeps in the cache the detoasted value referenced by the TOAST pointer
+ * if it was already missed once, or records that it was missed otherwise
+ */
+void
+shared_cache_put(const struct varlena *ptr, const struct varlena *value)
+{
+  SharedCacheKey key;
+  uint32 hash;
+  int first = shared_cache_key(ptr, &key, &hash);
+  Size size = VARSIZE_ANY(value);
+  if (first < 0 || size > shared_cache->slotsize - SLOT_HEADER_SIZE)
+    return;
+  LWLock *lock = shared_cache_lock(first);
+  LWLockAcquire(lock, LW_EXCLUSIVE);
+  /* Another backend may have written the value meanwhile */
+  for (int i = 0; i < SHARED_CACHE_WAYS; i++)
+  {
+    SharedCacheSlot *slot = shared_cache_slot(first + i);
+    if (slot->size != 0 &&
+      memcmp(&slot->key, &key, sizeof(SharedCacheKey)) == 0)
+    {
+      LWLockRelease(lock);
+      return;
+    }
+  }
+  if (! shared_cache_missed_twice(first, hash))
+  {
+    LWLockRelease(lock);
+    return;
+  }
+  /* Advance the hand of the set up to an empty slot or to a slot that was
+   * not read since the hand passed over it, which happens at the latest in
+   * the second round */
+  uint8 *hand = &shared_cache_hands()[first / SHARED_CACHE_WAYS];
+  SharedCacheSlot *victim;
+  for ( ; ; )
+  {
+    victim = shared_cache_slot(first + *hand);
+    *hand = (uint8) ((*hand + 1) % SHARED_CACHE_WAYS);
+    if (victim->size == 0 ||
+      pg_atomic_exchange_u32(&victim->referenced, 0) == 0)
+      break;
+  }
+  shared_cache_write(victim, &key, value, size);
+  LWLockRelease(lock);
+  return;
+}
+
+PG_FUNCTION_INFO_V1(mobilitydb_shared_cache_reset);
+/**
+ * Removes all the values of the cache
+ */
+PGDLLEXPORT Datum
+mobilitydb_shared_cache_reset(PG_FUNCTION_ARGS)
+{
+  if (shared_cache == NULL)
+    PG_RETURN_VOID();
+  for (int i = 0; i < shared_cache->nsets; i++)
+  {
+    int first = i * SHARED_CACHE_WAYS;
+    LWLock *lock = shared_cache_lock(first);
+    LWLockAcquire(lock, LW_EXCLUSIVE);
+    for (int j = 0; j < SHARED_CACHE_WAYS; j++)
+    {
+      SharedCacheSlot *slot = shared_cache_slot(first + j);
+      if (slot->size != 0)
+      {
+        SharedCacheKey key;
+        memset(&key, 0, sizeof(SharedCacheKey));
+        shared_cache_write(slot, &key, NULL, 0);
+      }
+    }
+    memset(&shared_cache_missed()[first], 0,
+      SHARED_CACHE_WAYS * sizeof(uint32));
+    LWLockRelease(lock);
+  }
+  PG_RETURN_VOID();
+}
+
+/*****************************************************************************/
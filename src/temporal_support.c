@@ -0,0 +1,641 @@
+/*****************************************************************************
+ *
+ * temporal_support.c
+ *    Fused evaluation of chained temporal functions.
+ *
+ * Expressions such as atValue(speed(trip) #> 15, true) or
+ * twAvg(temp * 3.6) construct a complete intermediate temporal value at
+ * every step. The functions in this file provide fused implementations of
+ * such pipelines that compute the final result in a single pass over the
+ * input. For PostgreSQL 12 and later, the planner support functions attached
+ * to twAvg and atValue rewrite the nested calls into their fused variants,
+ * so that the queries do not need to be changed.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *    Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_support.h"
+
+#include <assert.h>
+
+#if MOBDB_PGSQL_VERSION >= 120000
+#include <access/stratnum.h>
+#include <access/table.h>
+#include <catalog/namespace.h>
+#include <catalog/pg_class.h>
+#include <nodes/makefuncs.h>
+#include <nodes/nodeFuncs.h>
+#include <nodes/supportnodes.h>
+#include <optimizer/optimizer.h>
+#include <parser/parse_func.h>
+#include <parser/parsetree.h>
+#include <rewrite/rewriteHandler.h>
+#include <rewrite/rewriteManip.h>
+#include <utils/fmgroids.h>
+#include <utils/lsyscache.h>
+#include <utils/partcache.h>
+#include <utils/rel.h>
+#endif
+
+#include "tbox.h"
+#include "temporaltypes.h"
+#include "temporal_util.h"
+#include "rangetypes_ext.h"
+#include "tnumber_mathfuncs.h"
+#include "temporal_compops.h"
+
+/*****************************************************************************
+ * Fused restriction of a temporal comparison
+ *****************************************************************************/
+
+/**
+ * Returns a temporal Boolean with the constant value and the time frame
+ * of the temporal value, which is the result of a restriction
+ */
+static Temporal *
+tnumber_tbool_const(const Temporal *temp, bool value)
+{
+  Temporal *result;
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+    result = (Temporal *) tinstant_make(BoolGetDatum(value),
+      ((TInstant *) temp)->t, BOOLOID);
+  else if (temp->duration == INSTANTSET)
+  {
+    const TInstantSet *ti = (const TInstantSet *) temp;
+    TInstant **instants = palloc(sizeof(TInstant *) * ti->count);
+    for (int i = 0; i < ti->count; i++)
+      instants[i] = tinstant_make(BoolGetDatum(value),
+        tinstantset_inst_n(ti, i)->t, BOOLOID);
+    result = (Temporal *) tinstantset_make_free(instants, ti->count);
+  }
+  else if (temp->duration == SEQUENCE)
+  {
+    TSequence *seq = tsequence_from_base_internal(BoolGetDatum(value),
+      BOOLOID, &((TSequence *) temp)->period, STEP);
+    result = (Temporal *) tsequence_to_tsequenceset(seq);
+    pfree(seq);
+  }
+  else /* temp->duration == SEQUENCESET */
+  {
+    const TSequenceSet *ts = (const TSequenceSet *) temp;
+    TSequence **sequences = palloc(sizeof(TSequence *) * ts->count);
+    for (int i = 0; i < ts->count; i++)
+      sequences[i] = tsequence_from_base_internal(BoolGetDatum(value),
+        BOOLOID, &tsequenceset_seq_n(ts, i)->period, STEP);
+    result = (Temporal *) tsequenceset_make_free(sequences, ts->count,
+      NORMALIZE);
+  }
+  return result;
+}
+
+/**
+ * Restricts the temporal comparison of the temporal number and the base
+ * value to the Boolean value without constructing the comparison
+ *
+ * The comparison is true when the temporal number is in a range bounded by
+ * the base value and by the extent of the temporal number, and thus the
+ * result is the time frame of the number restricted to (the complement of)
+ * this range.
+ *
+ * @param[in] temp Temporal number
+ * @param[in] value Base value of the same base type as the temporal number
+ * @param[in] op Comparison operator, which is one of <, <=, >, >=
+ * @param[in] atvalue Value of the comparison to which the result is
+ * restricted
+ * @result Returns NULL if the comparison never takes the value
+ */
+Temporal *
+tnumber_at_tcomp_internal(const Temporal *temp, Datum value, CachedOp op,
+  bool atvalue)
+{
+  assert(op == LT_OP || op == LE_OP || op == GT_OP || op == GE_OP);
+  TBOX box;
+  memset(&box, 0, sizeof(TBOX));
+  temporal_bbox(&box, temp);
+  double d = datum_double(value, temp->valuetypid);
+  bool above = (op == GT_OP || op == GE_OP);
+  bool inc = (op == LE_OP || op == GE_OP);
+  double lower = above ? d : box.xmin;
+  double upper = above ? box.xmax : d;
+  bool lowerinc = above ? inc : true;
+  bool upperinc = above ? true : inc;
+
+  Temporal *rest;
+  if (lower < upper || (lower == upper && lowerinc && upperinc))
+  {
+    RangeType *range = (temp->valuetypid == INT4OID) ?
+      range_make(Int32GetDatum((int) lower), Int32GetDatum((int) upper),
+        lowerinc, upperinc, INT4OID) :
+      range_make(Float8GetDatum(lower), Float8GetDatum(upper),
+        lowerinc, upperinc, FLOAT8OID);
+    rest = tnumber_restrict_range_internal(temp, range, atvalue);
+    pfree(range);
+  }
+  else
+    /* The comparison has the opposite value at every instant */
+    rest = atvalue ? NULL : (Temporal *) temp;
+  if (rest == NULL)
+    return NULL;
+  Temporal *result = tnumber_tbool_const(rest, atvalue);
+  if (rest != temp)
+    pfree(rest);
+  return result;
+}
+
+/**
+ * Restricts the temporal comparison of the temporal number and the base
+ * value to the Boolean value
+ */
+static Datum
+tnumber_at_tcomp(FunctionCallInfo fcinfo, CachedOp op)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL(0);
+  Datum value = PG_GETARG_DATUM(1);
+  bool atvalue = PG_GETARG_BOOL(2);
+  Temporal *result = tnumber_at_tcomp_internal(temp, value, op, atvalue);
+  PG_FREE_IF_COPY(temp, 0);
+  if (result == NULL)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_at_tlt);
+/**
+ * Restricts the temporal less than of the temporal number and the base
+ * value to the Boolean value
+ */
+PGDLLEXPORT Datum
+tnumber_at_tlt(PG_FUNCTION_ARGS)
+{
+  return tnumber_at_tcomp(fcinfo, LT_OP);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_at_tle);
+/**
+ * Restricts the temporal less than or equal to of the temporal number and
+ * the base value to the Boolean value
+ */
+PGDLLEXPORT Datum
+tnumber_at_tle(PG_FUNCTION_ARGS)
+{
+  return tnumber_at_tcomp(fcinfo, LE_OP);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_at_tgt);
+/**
+ * Restricts the temporal greater than of the temporal number and the base
+ * value to the Boolean value
+ */
+PGDLLEXPORT Datum
+tnumber_at_tgt(PG_FUNCTION_ARGS)
+{
+  return tnumber_at_tcomp(fcinfo, GT_OP);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_at_tge);
+/**
+ * Restricts the temporal greater than or equal to of the temporal number
+ * and the base value to the Boolean value
+ */
+PGDLLEXPORT Datum
+tnumber_at_tge(PG_FUNCTION_ARGS)
+{
+  return tnumber_at_tcomp(fcinfo, GE_OP);
+}
+
+/*****************************************************************************
+ * Planner support functions
+ *****************************************************************************/
+
+#if MOBDB_PGSQL_VERSION >= 120000
+
+/**
+ * Get the C function and the arguments of a call of a binary function or
+ * operator
+ *
+ * @return Returns false if the node is not such a call
+ */
+static bool
+support_binary_call(Node *node, PGFunction *func, Node **arg1, Node **arg2)
+{
+  Oid funcid;
+  List *args;
+  if (IsA(node, FuncExpr))
+  {
+    funcid = ((FuncExpr *) node)->funcid;
+    args = ((FuncExpr *) node)->args;
+  }
+  else if (IsA(node, OpExpr))
+  {
+    set_opfuncid((OpExpr *) node);
+    funcid = ((OpExpr *) node)->opfuncid;
+    args = ((OpExpr *) node)->args;
+  }
+  else
+    return false;
+  if (list_length(args) != 2)
+    return false;
+  FmgrInfo finfo;
+  fmgr_info(funcid, &finfo);
+  *func = finfo.fn_addr;
+  *arg1 = (Node *) linitial(args);
+  *arg2 = (Node *) lsecond(args);
+  return true;
+}
+
+PG_FUNCTION_INFO_V1(tnumber_twavg_support);
+/**
+ * Planner support function for the time-weighted average
+ *
+ * Since the time-weighted average is linear, the average of the result of
+ * the addition, subtraction, multiplication, or division of a temporal
+ * number and a base value is computed from the average of the temporal
+ * number, e.g., twAvg(temp * 3.6) is rewritten into twAvg(temp) * 3.6,
+ * which does not construct the intermediate temporal number. Integer
+ * divisions and divisions whose divisor is not a nonzero constant are
+ * not rewritten.
+ */
+PGDLLEXPORT Datum
+tnumber_twavg_support(PG_FUNCTION_ARGS)
+{
+  Node *rawreq = (Node *) PG_GETARG_POINTER(0);
+  if (! IsA(rawreq, SupportRequestSimplify))
+    PG_RETURN_POINTER(NULL);
+
+  FuncExpr *twavg = ((SupportRequestSimplify *) rawreq)->fcall;
+  Node *arg = (Node *) linitial(twavg->args);
+  PGFunction func;
+  Node *arg1, *arg2;
+  if (! support_binary_call(arg, &func, &arg1, &arg2))
+    PG_RETURN_POINTER(NULL);
+  Oid floatfunc;
+  bool invert = false;
+  if (func == add_tnumber_base || func == add_base_tnumber)
+    floatfunc = F_FLOAT8PL;
+  else if (func == sub_tnumber_base || func == sub_base_tnumber)
+    floatfunc = F_FLOAT8MI;
+  else if (func == mult_tnumber_base || func == mult_base_tnumber)
+    floatfunc = F_FLOAT8MUL;
+  else if (func == div_tnumber_base && exprType(arg) == type_oid(T_TFLOAT) &&
+    IsA(arg2, Const) && ! ((Const *) arg2)->constisnull &&
+    datum_double(((Const *) arg2)->constvalue,
+      ((Const *) arg2)->consttype) != 0.0)
+    floatfunc = F_FLOAT8DIV;
+  else
+    PG_RETURN_POINTER(NULL);
+  if (func == add_base_tnumber || func == sub_base_tnumber ||
+    func == mult_base_tnumber)
+    invert = true;
+
+  Node *temp = invert ? arg2 : arg1;
+  Node *base = invert ? arg1 : arg2;
+  /* The temporal number must not be cast, e.g., tint * float */
+  if (exprType(temp) != exprType(arg))
+    PG_RETURN_POINTER(NULL);
+  if (exprType(base) == INT4OID)
+    base = (Node *) makeFuncExpr(F_I4TOD, FLOAT8OID, list_make1(base),
+      InvalidOid, InvalidOid, COERCE_IMPLICIT_CAST);
+  else if (exprType(base) != FLOAT8OID)
+    PG_RETURN_POINTER(NULL);
+  Node *avg = (Node *) makeFuncExpr(twavg->funcid, FLOAT8OID,
+    list_make1(temp), InvalidOid, InvalidOid, COERCE_EXPLICIT_CALL);
+  List *args = invert ? list_make2(base, avg) : list_make2(avg, base);
+  PG_RETURN_POINTER(makeFuncExpr(floatfunc, FLOAT8OID, args, InvalidOid,
+    InvalidOid, COERCE_EXPLICIT_CALL));
+}
+
+PG_FUNCTION_INFO_V1(tbool_at_value_support);
+/**
+ * Planner support function for the restriction of a temporal Boolean to
+ * a value
+ *
+ * The restriction of the temporal comparison with <, <=, >, or >= of a
+ * temporal number and a base value of the same base type, e.g.,
+ * atValue(speed(trip) #> 15, true), is rewritten into the fused function
+ * tnumber_at_tgt(speed(trip), 15, true), which does not construct the
+ * intermediate temporal Boolean.
+ */
+PGDLLEXPORT Datum
+tbool_at_value_support(PG_FUNCTION_ARGS)
+{
+  Node *rawreq = (Node *) PG_GETARG_POINTER(0);
+  if (! IsA(rawreq, SupportRequestSimplify))
+    PG_RETURN_POINTER(NULL);
+
+  FuncExpr *atvalue = ((SupportRequestSimplify *) rawreq)->fcall;
+  Node *arg = (Node *) linitial(atvalue->args);
+  PGFunction func;
+  Node *arg1, *arg2;
+  if (! support_binary_call(arg, &func, &arg1, &arg2))
+    PG_RETURN_POINTER(NULL);
+  /* The comparison of a base value and a temporal number is inverted */
+  const char *name;
+  bool invert = false;
+  if (func == tlt_temporal_base || func == tgt_base_temporal)
+    name = "tnumber_at_tlt";
+  else if (func == tle_temporal_base || func == tge_base_temporal)
+    name = "tnumber_at_tle";
+  else if (func == tgt_temporal_base || func == tlt_base_temporal)
+    name = "tnumber_at_tgt";
+  else if (func == tge_temporal_base || func == tle_base_temporal)
+    name = "tnumber_at_tge";
+  else
+    PG_RETURN_POINTER(NULL);
+  if (func == tgt_base_temporal || func == tge_base_temporal ||
+    func == tlt_base_temporal || func == tle_base_temporal)
+    invert = true;
+
+  Node *temp = invert ? arg2 : arg1;
+  Node *base = invert ? arg1 : arg2;
+  Oid argtypes[3] = {exprType(temp), exprType(base), BOOLOID};
+  if (! (argtypes[0] == type_oid(T_TINT) && argtypes[1] == INT4OID) &&
+    ! (argtypes[0] == type_oid(T_TFLOAT) && argtypes[1] == FLOAT8OID))
+    PG_RETURN_POINTER(NULL);
+  /* The fused function is in the schema of the extension */
+  char *nspname = get_namespace_name(get_func_namespace(atvalue->funcid));
+  Oid fusedid = LookupFuncName(list_make2(makeString(nspname),
+    makeString(pstrdup(name))), 3, argtypes, true);
+  if (! OidIsValid(fusedid))
+    PG_RETURN_POINTER(NULL);
+  PG_RETURN_POINTER(makeFuncExpr(fusedid, atvalue->funcresulttype,
+    list_make3(temp, base, lsecond(atvalue->args)), InvalidOid, InvalidOid,
+    COERCE_EXPLICIT_CALL));
+}
+
+/**
+ * Names of the functions converting a timestamp into the bounding boxes
+ * of the indexes of the temporal types
+ */
+static const char *SUPPORT_TIMESTAMP_BOXES[] = {"period", "tbox", "stbox"};
+
+#define SUPPORT_TIMESTAMP_NBOXES \
+  (sizeof(SUPPORT_TIMESTAMP_BOXES) / sizeof(char *))
+
+/**
+ * Returns the index condition of the intersection of a temporal value and
+ * a timestamp, which is the overlap of the temporal value and the bounding
+ * box of the timestamp supported by the operator family of the index
+ */
+static List *
+support_timestamp_indexcond(SupportRequestIndexCondition *req)
+{
+  if (! IsA(req->node, FuncExpr) || req->indexarg != 0)
+    return NIL;
+  List *args = ((FuncExpr *) req->node)->args;
+  if (list_length(args) != 2)
+    return NIL;
+  Node *indexed = (Node *) linitial(args);
+  Node *t = (Node *) lsecond(args);
+  /* The timestamp must not reference the relation of the index */
+#if MOBDB_PGSQL_VERSION >= 140000
+  Relids relids = pull_varnos(req->root, t);
+#else
+  Relids relids = pull_varnos(t);
+#endif
+  if (bms_is_member(req->index->rel->relid, relids) ||
+    contain_volatile_functions(t))
+    return NIL;
+
+  /* The conversion functions are in the schema of the extension */
+  char *nspname = get_namespace_name(get_func_namespace(req->funcid));
+  Oid argtype = TIMESTAMPTZOID;
+  for (size_t i = 0; i < SUPPORT_TIMESTAMP_NBOXES; i++)
+  {
+    Oid boxfuncid = LookupFuncName(list_make2(makeString(nspname),
+      makeString(pstrdup(SUPPORT_TIMESTAMP_BOXES[i]))), 1, &argtype, true);
+    if (! OidIsValid(boxfuncid))
+      continue;
+    Oid boxtype = get_func_rettype(boxfuncid);
+    Oid opno = get_opfamily_member(req->opfamily, exprType(indexed),
+      boxtype, RTOverlapStrategyNumber);
+    if (! OidIsValid(opno))
+      continue;
+    Expr *box = (Expr *) makeFuncExpr(boxfuncid, boxtype, list_make1(t),
+      InvalidOid, InvalidOid, COERCE_EXPLICIT_CALL);
+    Expr *cond = make_opclause(opno, BOOLOID, false, (Expr *) indexed, box,
+      InvalidOid, req->indexcollation);
+    /* The temporal value may not be defined at the timestamp even if its
+     * bounding box contains it, e.g., in a gap of a sequence set */
+    req->lossy = true;
+    return list_make1(cond);
+  }
+  return NIL;
+}
+
+PG_FUNCTION_INFO_V1(temporal_intersects_timestamp_support);
+/**
+ * Planner support function for the intersection of a temporal value and
+ * a timestamp
+ *
+ * The function derives from intersectsTimestamp(temp, t) the lossy index
+ * condition temp && period(t), or the one with tbox(t) or stbox(t)
+ * depending on the index, so that snapshot queries such as
+ * SELECT valueAtTimestamp(trip, t) FROM trips WHERE intersectsTimestamp(trip, t)
+ * use the indexes on the temporal values.
+ */
+PGDLLEXPORT Datum
+temporal_intersects_timestamp_support(PG_FUNCTION_ARGS)
+{
+  Node *rawreq = (Node *) PG_GETARG_POINTER(0);
+  if (! IsA(rawreq, SupportRequestIndexCondition))
+    PG_RETURN_POINTER(NULL);
+  PG_RETURN_POINTER(support_timestamp_indexcond(
+    (SupportRequestIndexCondition *) rawreq));
+}
+
+/**
+ * Returns true if the expression is a call of the function of the extension
+ * with the name given on the column of the temporal value
+ */
+static bool
+support_bound_call(Node *node, const char *name, AttrNumber attno, Oid nspid)
+{
+  if (! IsA(node, FuncExpr))
+    return false;
+  FuncExpr *func = (FuncExpr *) node;
+  if (list_length(func->args) != 1 || ! IsA(linitial(func->args), Var) ||
+    ((Var *) linitial(func->args))->varattno != attno ||
+    get_func_namespace(func->funcid) != nspid)
+    return false;
+  return strcmp(get_func_name(func->funcid), name) == 0;
+}
+
+/**
+ * Returns the expression of the relation that is equal to the start or the
+ * end timestamp of the column of the temporal value, which is either an
+ * expression of the partition key or a stored generated column, or NULL if
+ * there is none
+ *
+ * @param[in] rel Relation
+ * @param[in] varno Range table index of the relation in the query
+ * @param[in] attno Column of the temporal value
+ * @param[in] name Name of the function, either starttimestamp or endtimestamp
+ * @param[in] nspid Schema of the extension
+ */
+static Expr *
+support_bound_column(Relation rel, Index varno, AttrNumber attno,
+  const char *name, Oid nspid)
+{
+  ListCell *lc;
+  if (rel->rd_rel->relkind == RELKIND_PARTITIONED_TABLE)
+  {
+    /* The expressions of the partition key refer to the relation as 1 */
+    PartitionKey key = RelationGetPartitionKey(rel);
+    foreach(lc, key->partexprs)
+    {
+      Node *expr = (Node *) lfirst(lc);
+      if (! support_bound_call(expr, name, attno, nspid))
+        continue;
+      expr = copyObject(expr);
+      if (varno != 1)
+        ChangeVarNodes(expr, 1, varno, 0);
+      return (Expr *) expr;
+    }
+  }
+  TupleDesc tupdesc = RelationGetDescr(rel);
+  if (tupdesc->constr == NULL || ! tupdesc->constr->has_generated_stored)
+    return NULL;
+  for (int i = 0; i < tupdesc->natts; i++)
+  {
+    Form_pg_attribute att = TupleDescAttr(tupdesc, i);
+    if (att->attisdropped || att->attgenerated != ATTRIBUTE_GENERATED_STORED ||
+      att->atttypid != TIMESTAMPTZOID)
+      continue;
+    Node *expr = build_column_default(rel, i + 1);
+    if (expr != NULL && support_bound_call(expr, name, attno, nspid))
+      return (Expr *) makeVar(varno, i + 1, TIMESTAMPTZOID, -1, InvalidOid, 0);
+  }
+  return NULL;
+}
+
+/**
+ * Returns the lower or the upper timestamp of a period or of a box, or NULL
+ * if the type of the argument is not supported
+ */
+static Expr *
+support_box_bound(PlannerInfo *root, Node *box, bool upper,
+  const char *nspname)
+{
+  Oid boxtype = exprType(box);
+  bool period = (boxtype == type_oid(T_PERIOD));
+  if (! period && boxtype != type_oid(T_TBOX) &&
+    boxtype != type_oid(T_STBOX))
+    return NULL;
+  const char *name = period ? (upper ? "upper" : "lower") :
+    (upper ? "tmax" : "tmin");
+  Oid funcid = LookupFuncName(list_make2(makeString(pstrdup(nspname)),
+    makeString(pstrdup(name))), 1, &boxtype, true);
+  if (! OidIsValid(funcid))
+    return NULL;
+  Expr *result = (Expr *) makeFuncExpr(funcid, TIMESTAMPTZOID,
+    list_make1(box), InvalidOid, InvalidOid, COERCE_EXPLICIT_CALL);
+  if (! period)
+  {
+    /* The boxes without time dimension do not bound the timestamps */
+    CoalesceExpr *coalesce = makeNode(CoalesceExpr);
+    coalesce->coalescetype = TIMESTAMPTZOID;
+    coalesce->coalescecollid = InvalidOid;
+    coalesce->args = list_make2(result, makeConst(TIMESTAMPTZOID, -1,
+      InvalidOid, sizeof(TimestampTz),
+      TimestampTzGetDatum(upper ? DT_NOEND : DT_NOBEGIN), false,
+      FLOAT8PASSBYVAL));
+    coalesce->location = -1;
+    result = (Expr *) coalesce;
+  }
+  return (Expr *) eval_const_expressions(root, (Node *) result);
+}
+
+/**
+ * Returns the comparison of the start or the end timestamp of the temporal
+ * value with a bound
+ */
+static Expr *
+support_bound_cond(Expr *column, const char *opname, Expr *bound)
+{
+  Oid opno = OpernameGetOprid(list_make2(makeString("pg_catalog"),
+    makeString(pstrdup(opname))), TIMESTAMPTZOID, TIMESTAMPTZOID);
+  return make_opclause(opno, BOOLOID, false, column, bound, InvalidOid,
+    InvalidOid);
+}
+
+PG_FUNCTION_INFO_V1(temporal_overlaps_support);
+/**
+ * Planner support function for the overlaps of the bounding boxes of a
+ * temporal value and a period or a box
+ *
+ * When the temporal value is a column of a partitioned table, or of a table
+ * with inheritance children, whose partition key contains the expression
+ * startTimestamp(temp) or endTimestamp(temp), or which has a stored
+ * generated column defined by such an expression, the function derives from
+ * temp && box the implied conditions startTimestamp(temp) <= tmax(box) and
+ * endTimestamp(temp) >= tmin(box) on these expressions or columns. This
+ * enables the partition pruning, including the pruning at execution when
+ * the box is a parameter, and the constraint exclusion of the children,
+ * which do not apply to the operator &&. The conditions are derived only
+ * for the parent table to avoid duplicating them when the planner
+ * translates the conditions to the children.
+ */
+PGDLLEXPORT Datum
+temporal_overlaps_support(PG_FUNCTION_ARGS)
+{
+  Node *rawreq = (Node *) PG_GETARG_POINTER(0);
+  if (! IsA(rawreq, SupportRequestSimplify))
+    PG_RETURN_POINTER(NULL);
+
+  SupportRequestSimplify *req = (SupportRequestSimplify *) rawreq;
+  FuncExpr *fcall = req->fcall;
+  if (req->root == NULL || list_length(fcall->args) != 2)
+    PG_RETURN_POINTER(NULL);
+  Node *arg1 = (Node *) linitial(fcall->args);
+  Node *arg2 = (Node *) lsecond(fcall->args);
+  Var *var = (Var *) (IsA(arg1, Var) ? arg1 : arg2);
+  Node *box = IsA(arg1, Var) ? arg2 : arg1;
+  List *rtable = req->root->parse->rtable;
+  if (! IsA(var, Var) || var->varlevelsup != 0 || var->varattno <= 0 ||
+    var->varno > (Index) list_length(rtable) || ! temporal_type(var->vartype) ||
+    contain_var_clause(box) || contain_volatile_functions(box))
+    PG_RETURN_POINTER(NULL);
+  RangeTblEntry *rte = rt_fetch(var->varno, rtable);
+  if (rte->rtekind != RTE_RELATION || ! rte->inh)
+    PG_RETURN_POINTER(NULL);
+
+  /* The functions are in the schema of the extension */
+  Oid nspid = get_func_namespace(fcall->funcid);
+  char *nspname = get_namespace_name(nspid);
+  Relation rel = table_open(rte->relid, NoLock);
+  Expr *start = support_bound_column(rel, var->varno, var->varattno,
+    "starttimestamp", nspid);
+  Expr *end = support_bound_column(rel, var->varno, var->varattno,
+    "endtimestamp", nspid);
+  table_close(rel, NoLock);
+  Expr *upper = start ? support_box_bound(req->root, box, true, nspname) :
+    NULL;
+  Expr *lower = end ? support_box_bound(req->root, box, false, nspname) :
+    NULL;
+  if (upper == NULL && lower == NULL)
+    PG_RETURN_POINTER(NULL);
+
+  /* The overlaps is kept as an operator so that it may use the indexes */
+  Oid opno = OpernameGetOprid(list_make2(makeString(nspname),
+    makeString("&&")), exprType(arg1), exprType(arg2));
+  Expr *overlaps = (OidIsValid(opno) && get_opcode(opno) == fcall->funcid) ?
+    make_opclause(opno, BOOLOID, false, (Expr *) arg1, (Expr *) arg2,
+      InvalidOid, fcall->inputcollid) :
+    (Expr *) makeFuncExpr(fcall->funcid, BOOLOID, fcall->args, InvalidOid,
+      fcall->inputcollid, COERCE_EXPLICIT_CALL);
+  List *conds = list_make1(overlaps);
+  if (upper)
+    conds = lappend(conds, support_bound_cond(start, "<=", upper));
+  if (lower)
+    conds = lappend(conds, support_bound_cond(end, ">=", lower));
+  PG_RETURN_POINTER(make_andclause(conds));
+}
+
+#endif /* MOBDB_PGSQL_VERSION >= 120000 */
+
+/*****************************************************************************/
@@ -15,8 +15,13 @@
 #include <assert.h>
 #include <catalog/pg_collation.h>
 #include <fmgr.h>
+#include <miscadmin.h>
+#include <pgtime.h>
 #include <utils/builtins.h>
+#include <utils/datetime.h>
+#include <utils/guc.h>
 #include <utils/lsyscache.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 #include <utils/varlena.h>
 
@@ -27,6 +32,9 @@
 
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
+#include "tpoint_joinscan.h"
+#include "funcstat.h"
+#include "temporal_sharedcache.h"
 
 /*
  * This is required for builds against pgsql
@@ -37,6 +45,27 @@ PG_MODULE_MAGIC;
  * Miscellaneous functions
  *****************************************************************************/
 
+/**
+ * Values of the configuration parameter mobilitydb.geodetic_accuracy
+ */
+static const struct config_enum_entry geodetic_accuracy_options[] =
+{
+  {"spheroid", GEODETIC_SPHEROID, false},
+  {"sphere", GEODETIC_SPHERE, false},
+  {"fast", GEODETIC_FAST, false},
+  {NULL, 0, false}
+};
+
+/**
+ * Values of the configuration parameter mobilitydb.binary_format
+ */
+static const struct config_enum_entry binary_format_options[] =
+{
+  {"standard", BINARY_STANDARD, false},
+  {"compact", BINARY_COMPACT, false},
+  {NULL, 0, false}
+};
+
 /**
  * Initialize the extension
  */
@@ -45,6 +74,58 @@ _PG_init(void)
 {
   /* elog(WARNING, "This is MobilityDB."); */
   temporalgeom_init();
+  DefineCustomBoolVariable("mobilitydb.precompute_trajectory",
+    "Store the trajectory of temporal point sequences.",
+    "When off, the trajectory is not stored in the temporal point sequences "
+    "but computed on demand.",
+    &precompute_trajectory, true, PGC_USERSET, 0, NULL, NULL, NULL);
+  DefineCustomEnumVariable("mobilitydb.geodetic_accuracy",
+    "Sets the accuracy of the geodetic computations on segments.",
+    "Valid values are spheroid, sphere, and fast. The value sphere computes "
+    "distances and azimuths on the sphere, while fast uses a local "
+    "equirectangular approximation of the sphere, accurate for short segments.",
+    &geodetic_accuracy, GEODETIC_SPHEROID, geodetic_accuracy_options,
+    PGC_USERSET, 0, NULL, NULL, NULL);
+  DefineCustomEnumVariable("mobilitydb.binary_format",
+    "Sets the binary format written by the send functions of temporal types.",
+    "Valid values are standard and compact. The compact format writes the "
+    "timestamps and the values in arrays after a single header. The receive "
+    "functions accept both formats.",
+    &binary_format, BINARY_STANDARD, binary_format_options,
+    PGC_USERSET, 0, NULL, NULL, NULL);
+  DefineCustomBoolVariable("mobilitydb.function_stats",
+    "Collects counters of the work done by the functions of temporal types.",
+    "When on, the sequences constructed, the calls to PostGIS functions, the "
+    "splices of the skiplists of aggregates, and the bytes detoasted are "
+    "counted in the view mobilitydb_stat_functions.",
+    &function_stats, false, PGC_USERSET, 0, NULL, NULL, NULL);
+  DefineCustomIntVariable("mobilitydb.shared_cache_size",
+    "Sets the size of the cache of detoasted values shared by the backends.",
+    "The cache keeps the temporal values read from TOAST tables. It is only "
+    "created when MobilityDB is loaded with shared_preload_libraries, and "
+    "the value 0 disables it.",
+    &shared_cache_size, 0, 0, MAX_KILOBYTES, PGC_POSTMASTER, GUC_UNIT_KB,
+    NULL, NULL, NULL);
+  DefineCustomIntVariable("mobilitydb.shared_cache_entry_size",
+    "Sets the maximum size of a value kept in the shared cache.",
+    NULL,
+    &shared_cache_entry_size, 64, 1, MAX_KILOBYTES, PGC_POSTMASTER,
+    GUC_UNIT_KB, NULL, NULL, NULL);
+  DefineCustomBoolVariable("mobilitydb.enable_shared_cache",
+    "Enables the use of the shared cache of detoasted values.",
+    "When off, the backend neither reads nor writes the values of the "
+    "shared cache.",
+    &enable_shared_cache, true, PGC_USERSET, 0, NULL, NULL, NULL);
+  shared_cache_init();
+#if MOBDB_PGSQL_VERSION >= 120000
+  DefineCustomBoolVariable("mobilitydb.enable_spatial_join",
+    "Enables the planner's use of spatiotemporal join plans.",
+    "The plans join the temporal points whose bounding boxes overlap with "
+    "a plane sweep on the boxes of both inputs, which are kept in memory "
+    "in batches of at most half of work_mem each.",
+    &enable_spatial_join, false, PGC_USERSET, 0, NULL, NULL, NULL);
+  tpoint_joinscan_init();
+#endif
 }
 
 /**
@@ -64,20 +145,29 @@ double_pad(size_t size)
  * This function is called only for the base types of the temporal types
  * and for TimestampTz. To avoid a call of the slow function get_typbyval
  * (which makes a lookup call), the known base types are explicitly enumerated.
+ * The built-in types, whose Oids are constants, are dispatched by a switch
+ * and only the other types are looked up in the Oid cache.
  */
 bool
 get_typbyval_fast(Oid type)
 {
-  ensure_temporal_base_type_all(type);
   bool result = false;
-  if (type == BOOLOID || type == INT4OID || type == FLOAT8OID ||
-    type == TIMESTAMPTZOID)
-    result = true;
-  else if (type == type_oid(T_DOUBLE2) || type == TEXTOID)
-    result = false;
-  else if (type == type_oid(T_GEOMETRY) || type == type_oid(T_GEOGRAPHY) ||
-       type == type_oid(T_DOUBLE3) || type == type_oid(T_DOUBLE4))
-    result = false;
+  switch (type)
+  {
+    case BOOLOID:
+    case INT4OID:
+    case FLOAT8OID:
+    case TIMESTAMPTZOID:
+      result = true;
+      break;
+    case TEXTOID:
+      result = false;
+      break;
+    default:
+      /* All the other base types are passed by reference */
+      ensure_temporal_base_type_all(type);
+      result = false;
+  }
   return result;
 }
 
@@ -87,28 +177,40 @@ get_typbyval_fast(Oid type)
  * This function is called only for the base types of the temporal types
  * and for TimestampTz. To avoid a call of the slow function get_typlen
  * (which makes a lookup call), the known base types are explicitly enumerated.
+ * The built-in types, whose Oids are constants, are dispatched by a switch
+ * and only the other types are looked up in the Oid cache.
  */
 int
 get_typlen_fast(Oid type)
 {
-  ensure_temporal_base_type_all(type);
   int result = 0;
-  if (type == BOOLOID)
-    result = 1;
-  else if (type == INT4OID)
-    result = 4;
-  else if (type == FLOAT8OID || type == TIMESTAMPTZOID)
-    result = 8;
-  else if (type == type_oid(T_DOUBLE2))
-    result = 16;
-  else if (type == TEXTOID)
-    result = -1;
-  else if (type == type_oid(T_GEOMETRY) || type == type_oid(T_GEOGRAPHY))
-    result = -1;
-  else if (type == type_oid(T_DOUBLE3))
-    result = 24;
-  else if (type == type_oid(T_DOUBLE4))
-    result = 32;
+  switch (type)
+  {
+    case BOOLOID:
+      result = 1;
+      break;
+    case INT4OID:
+      result = 4;
+      break;
+    case FLOAT8OID:
+    case TIMESTAMPTZOID:
+      result = 8;
+      break;
+    case TEXTOID:
+      result = -1;
+      break;
+    default:
+      if (type == type_oid(T_GEOMETRY) || type == type_oid(T_GEOGRAPHY))
+        result = -1;
+      else if (type == type_oid(T_DOUBLE2))
+        result = 16;
+      else if (type == type_oid(T_DOUBLE3))
+        result = 24;
+      else if (type == type_oid(T_DOUBLE4))
+        result = 32;
+      else
+        ensure_temporal_base_type_all(type);
+  }
   return result;
 }
 
@@ -144,36 +246,308 @@ datum_double(Datum d, Oid valuetypid)
   return result;
 }
 
+/**
+ * Returns the position to probe by an interpolation search of the timestamp
+ * in the elements first to last of an array, assuming that the timestamps
+ * of the elements are evenly spaced between t1 and t2
+ *
+ * The position is always between first and last, so that any search that
+ * narrows its interval on each probe terminates. When the timestamps of the
+ * array are nearly evenly spaced, as for regularly sampled values, the
+ * timestamp is found in a couple of probes. The searches fall back to a
+ * binary search after INTERPOLATION_MAX_PROBES probes, which bounds their
+ * cost for irregular arrays.
+ */
+int
+interpolation_probe(int first, int last, TimestampTz t1, TimestampTz t2,
+  TimestampTz t)
+{
+  if (t <= t1 || t2 <= t1)
+    return first;
+  if (t >= t2)
+    return last;
+  int result = first +
+    (int) ((double) (t - t1) / (double) (t2 - t1) * (last - first));
+  return Min(result, last);
+}
+
 /*****************************************************************************
  * Call PostgreSQL functions
  *****************************************************************************/
 
+/**
+ * Kinds of I/O functions of a type
+ */
+typedef enum
+{
+  IOFUNC_INPUT,
+  IOFUNC_OUTPUT,
+  IOFUNC_SEND,
+  IOFUNC_RECV,
+} IOFuncKind;
+
+#define IOFUNC_KINDS 4
+
+/**
+ * Information about the I/O functions of a type kept for the transaction
+ */
+typedef struct
+{
+  Oid type;                      /**< Oid of the type */
+  Oid typioparam;                /**< Type parameter of the input functions */
+  bool valid[IOFUNC_KINDS];      /**< True when the function is looked up */
+  FmgrInfo finfo[IOFUNC_KINDS];  /**< Function information */
+} TypeIOCacheEntry;
+
+/**
+ * Number of types whose I/O functions are cached. The base types and
+ * TimestampTz fit in the cache, the I/O functions of the other types are
+ * looked up for each call.
+ */
+#define TYPEIO_CACHE_SIZE 16
+
+/**
+ * Array caching the I/O functions of the types to avoid a lookup in the
+ * system catalogs for each value that is read or written in a transaction
+ */
+static TypeIOCacheEntry _typeio_cache[TYPEIO_CACHE_SIZE];
+static int _typeio_count = 0;
+
+/**
+ * Memory context of the function information of the cache and of what the
+ * I/O functions keep in their fn_extra field. It is a child of the memory
+ * context of the transaction, so that the cache is emptied when the
+ * transaction commits or aborts.
+ */
+static MemoryContext _typeio_cxt = NULL;
+static MemoryContextCallback _typeio_callback;
+
+/**
+ * Empties the cache of the I/O functions when its memory context is deleted
+ */
+static void
+typeio_cache_reset(void *arg)
+{
+  _typeio_count = 0;
+  _typeio_cxt = NULL;
+}
+
+/**
+ * Returns the information about an I/O function of a type, looking it up
+ * in the system catalogs only the first time it is requested in a
+ * transaction
+ *
+ * @param[in] type Oid of the type
+ * @param[in] kind Kind of I/O function
+ * @param[out] typioparam Type parameter to pass to the input and receive
+ * functions, may be NULL
+ * @param[in] local Function information used when the cache is full
+ */
+static FmgrInfo *
+typeio_finfo(Oid type, IOFuncKind kind, Oid *typioparam, FmgrInfo *local)
+{
+  TypeIOCacheEntry *entry = NULL;
+  for (int i = 0; i < _typeio_count; i++)
+  {
+    if (_typeio_cache[i].type == type)
+    {
+      entry = &_typeio_cache[i];
+      break;
+    }
+  }
+  if (entry == NULL && _typeio_count < TYPEIO_CACHE_SIZE)
+  {
+    if (_typeio_cxt == NULL)
+    {
+      _typeio_cxt = AllocSetContextCreate(TopTransactionContext,
+        "MobilityDB type I/O cache", ALLOCSET_SMALL_SIZES);
+      _typeio_callback.func = typeio_cache_reset;
+      _typeio_callback.arg = NULL;
+      MemoryContextRegisterResetCallback(_typeio_cxt, &_typeio_callback);
+    }
+    entry = &_typeio_cache[_typeio_count++];
+    memset(entry, 0, sizeof(TypeIOCacheEntry));
+    entry->type = type;
+  }
+  if (entry != NULL && entry->valid[kind])
+  {
+    if (typioparam != NULL)
+      *typioparam = entry->typioparam;
+    return &entry->finfo[kind];
+  }
+
+  FmgrInfo *result = (entry != NULL) ? &entry->finfo[kind] : local;
+  Oid func, param = InvalidOid;
+  bool isvarlena;
+  if (kind == IOFUNC_INPUT)
+    getTypeInputInfo(type, &func, &param);
+  else if (kind == IOFUNC_OUTPUT)
+    getTypeOutputInfo(type, &func, &isvarlena);
+  else if (kind == IOFUNC_SEND)
+    getTypeBinaryOutputInfo(type, &func, &isvarlena);
+  else /* kind == IOFUNC_RECV */
+    getTypeBinaryInputInfo(type, &func, &param);
+  fmgr_info_cxt(func, result, (entry != NULL) ? _typeio_cxt :
+    CurrentMemoryContext);
+  if (entry != NULL)
+  {
+    if (kind == IOFUNC_INPUT || kind == IOFUNC_RECV)
+      entry->typioparam = param;
+    entry->valid[kind] = true;
+  }
+  if (typioparam != NULL)
+    *typioparam = param;
+  return result;
+}
+
 /**
  * Call input function of the base type
  */
 Datum
 call_input(Oid type, char *str)
 {
-  Oid infunc;
-  Oid basetype;
-  FmgrInfo infuncinfo;
-  getTypeInputInfo(type, &infunc, &basetype);
-  fmgr_info(infunc, &infuncinfo);
-  return InputFunctionCall(&infuncinfo, str, basetype, -1);
+  Oid typioparam;
+  FmgrInfo local;
+  FmgrInfo *finfo = typeio_finfo(type, IOFUNC_INPUT, &typioparam, &local);
+  return InputFunctionCall(finfo, str, typioparam, -1);
+}
+
+/**
+ * Call output function of the base type through the function manager
+ */
+static char *
+call_output_fmgr(Oid type, Datum value)
+{
+  FmgrInfo local;
+  return OutputFunctionCall(typeio_finfo(type, IOFUNC_OUTPUT, NULL, &local),
+    value);
+}
+
+/**
+ * Writes into the string the unsigned integer padded with zeros to the
+ * given number of digits
+ */
+static char *
+timestamp_iso_digits(char *ptr, int value, int ndigits)
+{
+  for (int i = ndigits - 1; i >= 0; i--)
+  {
+    ptr[i] = (char) ('0' + value % 10);
+    value /= 10;
+  }
+  return ptr + ndigits;
+}
+
+/**
+ * Writes into the string the timestamp in ISO 8601 format with the same
+ * fields as the output function of timestamptz with the ISO date style,
+ * e.g., 2019-08-06 18:35:48.021455+02:30
+ *
+ * @param[out] str String of at least MAXDATELEN + 1 bytes
+ * @param[in] t Timestamp
+ * @param[in] sep Separator between the date and the time parts
+ * @result Number of characters written, or 0 for infinite timestamps and
+ * years outside 1..9999, which must be written by the output function
+ */
+int
+timestamp_iso_write(char *str, TimestampTz t, char sep)
+{
+  struct pg_tm tt, *tm = &tt;
+  fsec_t fsec;
+  int tz;
+  if (TIMESTAMP_NOT_FINITE(t) ||
+    timestamp2tm(t, &tz, tm, &fsec, NULL, NULL) != 0 ||
+    tm->tm_year <= 0 || tm->tm_year > 9999)
+    return 0;
+  char *ptr = str;
+  ptr = timestamp_iso_digits(ptr, tm->tm_year, 4);
+  *ptr++ = '-';
+  ptr = timestamp_iso_digits(ptr, tm->tm_mon, 2);
+  *ptr++ = '-';
+  ptr = timestamp_iso_digits(ptr, tm->tm_mday, 2);
+  *ptr++ = sep;
+  ptr = timestamp_iso_digits(ptr, tm->tm_hour, 2);
+  *ptr++ = ':';
+  ptr = timestamp_iso_digits(ptr, tm->tm_min, 2);
+  *ptr++ = ':';
+  ptr = timestamp_iso_digits(ptr, tm->tm_sec, 2);
+  if (fsec != 0)
+  {
+    /* Trailing zeros of the fractional seconds are not written */
+    int ndigits = 6, value = (int) fsec;
+    while (value % 10 == 0)
+    {
+      value /= 10;
+      ndigits--;
+    }
+    *ptr++ = '.';
+    ptr = timestamp_iso_digits(ptr, value, ndigits);
+  }
+  /* The time zone value is given in seconds west of Greenwich */
+  *ptr++ = (tz <= 0) ? '+' : '-';
+  int sec = abs(tz);
+  ptr = timestamp_iso_digits(ptr, sec / SECS_PER_HOUR, 2);
+  sec %= SECS_PER_HOUR;
+  if (sec != 0)
+  {
+    *ptr++ = ':';
+    ptr = timestamp_iso_digits(ptr, sec / SECS_PER_MINUTE, 2);
+    sec %= SECS_PER_MINUTE;
+    if (sec != 0)
+    {
+      *ptr++ = ':';
+      ptr = timestamp_iso_digits(ptr, sec, 2);
+    }
+  }
+  *ptr = '\0';
+  return (int) (ptr - str);
+}
+
+/**
+ * Returns the string representation of the timestamp. With the ISO date
+ * style, which is the default, the string is written directly instead of
+ * going through the output function of timestamptz
+ */
+char *
+timestamp_output(TimestampTz t)
+{
+  if (DateStyle == USE_ISO_DATES)
+  {
+    char *result = palloc(MAXDATELEN + 1);
+    if (timestamp_iso_write(result, t, ' ') > 0)
+      return result;
+    pfree(result);
+  }
+  return call_output_fmgr(TIMESTAMPTZOID, TimestampTzGetDatum(t));
+}
+
+/**
+ * Returns the string representation of the float, which is identical to
+ * the one of the output function of float8
+ */
+char *
+float8_output(double d)
+{
+#if MOBDB_PGSQL_VERSION >= 120000
+  return float8out_internal(d);
+#else
+  return call_output_fmgr(FLOAT8OID, Float8GetDatum(d));
+#endif
 }
 
 /**
- * Call output function of the base type
+ * Call output function of the base type. Timestamps and floats, which are
+ * written for every instant of the temporal types, avoid the lookup of the
+ * output function in the system catalogs.
  */
 char *
 call_output(Oid type, Datum value)
 {
-  Oid outfunc;
-  bool isvarlena;
-  FmgrInfo outfuncinfo;
-  getTypeOutputInfo(type, &outfunc, &isvarlena);
-  fmgr_info(outfunc, &outfuncinfo);
-  return OutputFunctionCall(&outfuncinfo, value);
+  if (type == TIMESTAMPTZOID)
+    return timestamp_output(DatumGetTimestampTz(value));
+  if (type == FLOAT8OID)
+    return float8_output(DatumGetFloat8(value));
+  return call_output_fmgr(type, value);
 }
 
 /**
@@ -182,12 +556,9 @@ call_output(Oid type, Datum value)
 bytea *
 call_send(Oid type, Datum value)
 {
-  Oid sendfunc;
-  bool isvarlena;
-  FmgrInfo sendfuncinfo;
-  getTypeBinaryOutputInfo(type, &sendfunc, &isvarlena);
-  fmgr_info(sendfunc, &sendfuncinfo);
-  return SendFunctionCall(&sendfuncinfo, value);
+  FmgrInfo local;
+  return SendFunctionCall(typeio_finfo(type, IOFUNC_SEND, NULL, &local),
+    value);
 }
 
 /**
@@ -196,12 +567,10 @@ call_send(Oid type, Datum value)
 Datum
 call_recv(Oid type, StringInfo buf)
 {
-  Oid recvfunc;
-  Oid basetype;
-  FmgrInfo recvfuncinfo;
-  getTypeBinaryInputInfo(type, &recvfunc, &basetype);
-  fmgr_info(recvfunc, &recvfuncinfo);
-  return ReceiveFunctionCall(&recvfuncinfo, buf, basetype, -1);
+  Oid typioparam;
+  FmgrInfo local;
+  FmgrInfo *finfo = typeio_finfo(type, IOFUNC_RECV, &typioparam, &local);
+  return ReceiveFunctionCall(finfo, buf, typioparam, -1);
 }
 
 /**
@@ -219,6 +588,7 @@ call_function1(PGFunction func, Datum arg1)
   InitFunctionCallInfoData(*fcinfo, &flinfo, 1, DEFAULT_COLLATION_OID, NULL, NULL);
   fcinfo->args[0].value = arg1;
   fcinfo->args[0].isnull = false;
+  FUNC_STAT_ADD(FUNC_STAT_POSTGIS_CALLS, 1);
   result = (*func) (fcinfo);
   if (fcinfo->isnull)
     elog(ERROR, "Function %p returned NULL", (void *) func);
@@ -233,8 +603,7 @@ call_function2(PGFunction func, Datum arg1, Datum arg2)
 {
   LOCAL_FCINFO(fcinfo, 2);
   FmgrInfo flinfo;
-  memset(&flinfo, 0, sizeof(flinfo)) ;
-  flinfo.fn_nargs = 2;
+  memset(&flinfo, 0, sizeof(flinfo));
   flinfo.fn_mcxt = CurrentMemoryContext;
   Datum result;
   InitFunctionCallInfoData(*fcinfo, &flinfo, 2, DEFAULT_COLLATION_OID, NULL, NULL);
@@ -242,6 +611,7 @@ call_function2(PGFunction func, Datum arg1, Datum arg2)
   fcinfo->args[0].isnull = false;
   fcinfo->args[1].value = arg2;
   fcinfo->args[1].isnull = false;
+  FUNC_STAT_ADD(FUNC_STAT_POSTGIS_CALLS, 1);
   result = (*func) (fcinfo);
   if (fcinfo->isnull)
     elog(ERROR, "function %p returned NULL", (void *) func);
@@ -256,7 +626,7 @@ call_function3(PGFunction func, Datum arg1, Datum arg2, Datum arg3)
 {
   LOCAL_FCINFO(fcinfo, 3);
   FmgrInfo flinfo;
-  memset(&flinfo, 0, sizeof(flinfo)) ;
+  memset(&flinfo, 0, sizeof(flinfo));
   flinfo.fn_mcxt = CurrentMemoryContext;
   Datum result;
   InitFunctionCallInfoData(*fcinfo, &flinfo, 3, DEFAULT_COLLATION_OID, NULL, NULL);
@@ -266,6 +636,7 @@ call_function3(PGFunction func, Datum arg1, Datum arg2, Datum arg3)
   fcinfo->args[1].isnull = false;
   fcinfo->args[2].value = arg3;
   fcinfo->args[2].isnull = false;
+  FUNC_STAT_ADD(FUNC_STAT_POSTGIS_CALLS, 1);
   result = (*func) (fcinfo);
   if (fcinfo->isnull)
     elog(ERROR, "function %p returned NULL", (void *) func);
@@ -286,6 +657,7 @@ call_function1(PGFunction func, Datum arg1)
   InitFunctionCallInfoData(fcinfo, &flinfo, 1, DEFAULT_COLLATION_OID, NULL, NULL);
   fcinfo.arg[0] = arg1;
   fcinfo.argnull[0] = false;
+  FUNC_STAT_ADD(FUNC_STAT_POSTGIS_CALLS, 1);
   result = (*func) (&fcinfo);
   if (fcinfo.isnull)
     elog(ERROR, "Function %p returned NULL", (void *) func);
@@ -300,7 +672,7 @@ call_function2(PGFunction func, Datum arg1, Datum arg2)
 {
   FunctionCallInfoData fcinfo;
   FmgrInfo flinfo;
-  memset(&flinfo, 0, sizeof(flinfo)) ;
+  memset(&flinfo, 0, sizeof(flinfo));
   flinfo.fn_mcxt = CurrentMemoryContext;
   Datum result;
   InitFunctionCallInfoData(fcinfo, &flinfo, 2, DEFAULT_COLLATION_OID, NULL, NULL);
@@ -308,6 +680,7 @@ call_function2(PGFunction func, Datum arg1, Datum arg2)
   fcinfo.argnull[0] = false;
   fcinfo.arg[1] = arg2;
   fcinfo.argnull[1] = false;
+  FUNC_STAT_ADD(FUNC_STAT_POSTGIS_CALLS, 1);
   result = (*func) (&fcinfo);
   if (fcinfo.isnull)
     elog(ERROR, "function %p returned NULL", (void *) func);
@@ -322,7 +695,7 @@ call_function3(PGFunction func, Datum arg1, Datum arg2, Datum arg3)
 {
   FunctionCallInfoData fcinfo;
   FmgrInfo flinfo;
-  memset(&flinfo, 0, sizeof(flinfo)) ;
+  memset(&flinfo, 0, sizeof(flinfo));
   flinfo.fn_mcxt = CurrentMemoryContext;
   Datum result;
   InitFunctionCallInfoData(fcinfo, &flinfo, 3, DEFAULT_COLLATION_OID, NULL, NULL);
@@ -332,6 +705,7 @@ call_function3(PGFunction func, Datum arg1, Datum arg2, Datum arg3)
   fcinfo.argnull[1] = false;
   fcinfo.arg[2] = arg3;
   fcinfo.argnull[2] = false;
+  FUNC_STAT_ADD(FUNC_STAT_POSTGIS_CALLS, 1);
   result = (*func) (&fcinfo);
   if (fcinfo.isnull)
     elog(ERROR, "function %p returned NULL", (void *) func);
@@ -362,6 +736,7 @@ CallerFInfoFunctionCall4(PGFunction func, FmgrInfo *flinfo, Oid collation,
   fcinfo.argnull[2] = false;
   fcinfo.argnull[3] = false;
 
+  FUNC_STAT_ADD(FUNC_STAT_POSTGIS_CALLS, 1);
   result = (*func) (&fcinfo);
 
   /* Check for null result, since caller is clearly not expecting one */
@@ -390,6 +765,7 @@ CallerFInfoFunctionCall4(PGFunction func, FmgrInfo *flinfo, Oid collation,
     fcinfo->args[3].value = arg4;
     fcinfo->args[3].isnull = false;
 
+    FUNC_STAT_ADD(FUNC_STAT_POSTGIS_CALLS, 1);
     result = (*func) (fcinfo);
 
     /* Check for null result, since caller is clearly not expecting one */
@@ -484,6 +860,9 @@ temporalarr_extract(ArrayType *array, int *count)
   Temporal **result;
   deconstruct_array(array, array->elemtype, -1, false, 'd',
     (Datum **) &result, NULL, count);
+  /* Values in packed format are unpacked */
+  for (int i = 0; i < *count; i++)
+    result[i] = temporal_unpack(result[i]);
   return result;
 }
 
@@ -773,6 +1152,44 @@ tinstantarr_remove_duplicates(TInstant **instants, int count)
   return newcount + 1;
 }
 
+/*****************************************************************************
+ * Search functions
+ * These functions assume that the array has been sorted before
+ *****************************************************************************/
+
+/**
+ * Returns the position of the first value of the array that is greater
+ * than or equal to the value using binary search
+ *
+ * @pre The array is sorted with datumarr_sort
+ */
+int
+datumarr_lower_bound(const Datum *values, int count, Datum value, Oid type)
+{
+  int first = 0, last = count;
+  while (first < last)
+  {
+    int middle = first + (last - first) / 2;
+    if (datum_lt(values[middle], value, type))
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  return first;
+}
+
+/**
+ * Returns true if the value belongs to the array using binary search
+ *
+ * @pre The array is sorted with datumarr_sort
+ */
+bool
+datumarr_contains(const Datum *values, int count, Datum value, Oid type)
+{
+  int loc = datumarr_lower_bound(values, count, value, type);
+  return loc < count && datum_eq(values[loc], value, type);
+}
+
 /*****************************************************************************
  * Text functions
  *****************************************************************************/
@@ -799,6 +1216,24 @@ text_cmp(text *arg1, text *arg2, Oid collid)
   return varstr_cmp(a1p, len1, a2p, len2, collid);
 }
 
+/**
+ * Returns true if the two text values are equal
+ *
+ * @note The default collation is deterministic and thus two text values
+ * are equal if and only if they are bytewise equal, as done in the texteq
+ * function of PostgreSQL. This avoids calling the collation-aware
+ * comparison for every instant of a temporal text value.
+ */
+bool
+text_eq(text *arg1, text *arg2)
+{
+  Size len1 = VARSIZE_ANY_EXHDR(arg1);
+  Size len2 = VARSIZE_ANY_EXHDR(arg2);
+  if (len1 != len2)
+    return false;
+  return memcmp(VARDATA_ANY(arg1), VARDATA_ANY(arg2), len1) == 0;
+}
+
 /*****************************************************************************
  * Comparison functions on datums
  *****************************************************************************/
@@ -811,24 +1246,31 @@ text_cmp(text *arg1, text *arg2, Oid collid)
 bool
 datum_eq(Datum l, Datum r, Oid type)
 {
-  ensure_temporal_base_type_all(type);
   bool result = false;
-  if (type == BOOLOID || type == INT4OID || type == FLOAT8OID)
-    result = l == r;
-  else if (type == TEXTOID)
-    result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) == 0;
-  else if (type == type_oid(T_DOUBLE2))
-    result = double2_eq((double2 *)DatumGetPointer(l), (double2 *)DatumGetPointer(r));
-  else if (type == type_oid(T_DOUBLE3))
-    result = double3_eq((double3 *)DatumGetPointer(l), (double3 *)DatumGetPointer(r));
-  else if (type == type_oid(T_DOUBLE4))
-    result = double4_eq((double4 *)DatumGetPointer(l), (double4 *)DatumGetPointer(r));
-  else if (type == type_oid(T_GEOMETRY))
-    //  result = DatumGetBool(call_function2(lwgeom_eq, l, r));
-    result = datum_point_eq(l, r);
-  else if (type == type_oid(T_GEOGRAPHY))
-    //  result = DatumGetBool(call_function2(geography_eq, l, r));
-    result = datum_point_eq(l, r);
+  switch (type)
+  {
+    case BOOLOID:
+    case INT4OID:
+    case FLOAT8OID:
+    case TIMESTAMPTZOID:
+      result = l == r;
+      break;
+    case TEXTOID:
+      result = text_eq(DatumGetTextPP(l), DatumGetTextPP(r));
+      break;
+    default:
+      if (type == type_oid(T_GEOMETRY) || type == type_oid(T_GEOGRAPHY))
+        //  result = DatumGetBool(call_function2(lwgeom_eq, l, r));
+        result = datum_point_eq(l, r);
+      else if (type == type_oid(T_DOUBLE2))
+        result = double2_eq((double2 *)DatumGetPointer(l), (double2 *)DatumGetPointer(r));
+      else if (type == type_oid(T_DOUBLE3))
+        result = double3_eq((double3 *)DatumGetPointer(l), (double3 *)DatumGetPointer(r));
+      else if (type == type_oid(T_DOUBLE4))
+        result = double4_eq((double4 *)DatumGetPointer(l), (double4 *)DatumGetPointer(r));
+      else
+        ensure_temporal_base_type_all(type);
+  }
   return result;
 }
 
@@ -847,20 +1289,29 @@ datum_ne(Datum l, Datum r, Oid type)
 bool
 datum_lt(Datum l, Datum r, Oid type)
 {
-  ensure_temporal_base_type(type);
   bool result = false;
-  if (type == BOOLOID)
-    result = DatumGetBool(l) < DatumGetBool(r);
-  else if (type == INT4OID)
-    result = DatumGetInt32(l) < DatumGetInt32(r);
-  else if (type == FLOAT8OID)
-    result = DatumGetFloat8(l) < DatumGetFloat8(r);
-  else if (type == TEXTOID)
-    result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) < 0;
-  else if (type == type_oid(T_GEOMETRY))
-    result = DatumGetBool(call_function2(lwgeom_lt, l, r));
-  else if (type == type_oid(T_GEOGRAPHY))
-    result = DatumGetBool(call_function2(geography_lt, l, r));
+  switch (type)
+  {
+    case BOOLOID:
+      result = DatumGetBool(l) < DatumGetBool(r);
+      break;
+    case INT4OID:
+      result = DatumGetInt32(l) < DatumGetInt32(r);
+      break;
+    case FLOAT8OID:
+      result = DatumGetFloat8(l) < DatumGetFloat8(r);
+      break;
+    case TEXTOID:
+      result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) < 0;
+      break;
+    default:
+      if (type == type_oid(T_GEOMETRY))
+        result = DatumGetBool(call_function2(lwgeom_lt, l, r));
+      else if (type == type_oid(T_GEOGRAPHY))
+        result = DatumGetBool(call_function2(geography_lt, l, r));
+      else
+        ensure_temporal_base_type(type);
+  }
   return result;
 }
 
@@ -916,7 +1367,7 @@ datum_eq2(Datum l, Datum r, Oid typel, Oid typer)
   else if (typel == FLOAT8OID && typer == INT4OID)
     result = DatumGetFloat8(l) == DatumGetInt32(r);
   else if (typel == TEXTOID && typer == TEXTOID)
-    result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) == 0;
+    result = text_eq(DatumGetTextPP(l), DatumGetTextPP(r));
     /* This function is never called with doubleN */
   else if (typel == type_oid(T_GEOMETRY) && typer == type_oid(T_GEOMETRY))
     //  result = DatumGetBool(call_function2(lwgeom_eq, l, r));
@@ -1164,5 +1615,59 @@ hypot4d(double x, double y, double z, double m)
   return x * sqrt(1.0 + (yx * yx) + (zx * zx) + (mx * mx));
 }
 
-/*****************************************************************************/
+/*****************************************************************************
+ * Z-order functions
+ *****************************************************************************/
 
+/**
+ * Returns an unsigned integer whose order is the order of the double.
+ * The bits of a positive double are ordered as the double once the sign bit
+ * is set, while all the bits of a negative double must be inverted.
+ */
+uint64
+double_zorder_key(double d)
+{
+  uint64 result;
+  memcpy(&result, &d, sizeof(uint64));
+  if (result & UINT64CONST(0x8000000000000000))
+    return ~result;
+  return result ^ UINT64CONST(0x8000000000000000);
+}
+
+/**
+ * Returns an unsigned integer whose order is the order of the timestamp
+ */
+uint64
+timestamp_zorder_key(TimestampTz t)
+{
+  return ((uint64) t) ^ UINT64CONST(0x8000000000000000);
+}
+
+/**
+ * Compares two points on the Z-order curve given by the keys of their
+ * dimensions without interleaving their bits. The order is determined by
+ * the dimension having the most significant differing bit.
+ *
+ * @see T. M. Chan, Closest-point problems simplified on the RAM, SODA 2002
+ */
+int
+zorder_cmp(const uint64 *keys1, const uint64 *keys2, int ndims)
+{
+  int dim = 0;
+  uint64 msb = 0;
+  for (int i = 0; i < ndims; i++)
+  {
+    uint64 diff = keys1[i] ^ keys2[i];
+    /* The most significant bit of msb is lower than the one of diff */
+    if (msb < diff && msb < (msb ^ diff))
+    {
+      dim = i;
+      msb = diff;
+    }
+  }
+  if (keys1[dim] == keys2[dim])
+    return 0;
+  return (keys1[dim] < keys2[dim]) ? -1 : 1;
+}
+
+/*****************************************************************************/
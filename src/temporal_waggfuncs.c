@@ -221,155 +221,10 @@ temporal_extend(Temporal *temp, Interval *interval, bool min, int *count)
 }
 
 /*****************************************************************************
- * Transform a temporal number type into a temporal integer type with value 1 
- * extended by a time interval. 
+ * Transform a temporal number into a temporal double extended by a time
+ * interval
  *****************************************************************************/
 
-/**
- * Construct a sequence with a value 1 by extending the two bounds by the
- * time interval
- */
-static TSequence *
-tinstant_transform_wcount1(TimestampTz lower, TimestampTz upper,
-  bool lower_inc, bool upper_inc, Interval *interval)
-{
-  TInstant *instants[2];
-  TimestampTz upper1 = DatumGetTimestampTz(DirectFunctionCall2(
-    timestamptz_pl_interval, TimestampTzGetDatum(upper), 
-    PointerGetDatum(interval)));
-  instants[0] = tinstant_make(Int32GetDatum(1), lower, INT4OID);
-  instants[1] = tinstant_make(Int32GetDatum(1), upper1, INT4OID);
-  TSequence *result = tsequence_make(instants, 2, lower_inc, upper_inc,
-    STEP, NORMALIZE_NO);
-  pfree(instants[0]); pfree(instants[1]);
-  return result;
-}
-
-/**
- * Transform the temporal number instant value by the time interval
- *
- * @param[out] result Array on which the pointers of the newly constructed 
- * values are stored
- * @param[in] inst Temporal value
- * @param[in] interval Interval
- */
-static int
-tinstant_transform_wcount(TSequence **result, TInstant *inst, 
-  Interval *interval)
-{
-  result[0] = tinstant_transform_wcount1(inst->t, inst->t, true, true,
-    interval);
-  return 1;
-}
-
-/**
- * Transform the temporal number instant set value by the time interval
- *
- * @param[out] result Array on which the pointers of the newly constructed 
- * values are stored
- * @param[in] ti Temporal value
- * @param[in] interval Interval
- */
-static int
-tinstantset_transform_wcount(TSequence **result, TInstantSet *ti, Interval *interval)
-{
-  for (int i = 0; i < ti->count; i++)
-  {
-    TInstant *inst = tinstantset_inst_n(ti, i);
-    tinstant_transform_wcount(&result[i], inst, interval);
-  }
-  return ti->count;
-}
-
-/**
- * Transform the temporal number sequence value by the time interval
- *
- * @param[out] result Array on which the pointers of the newly constructed 
- * values are stored
- * @param[in] seq Temporal value
- * @param[in] interval Interval
- */
-static int
-tsequence_transform_wcount(TSequence **result, TSequence *seq, Interval *interval)
-{
-  if (seq->count == 1)
-    return tinstant_transform_wcount(result, tsequence_inst_n(seq, 0), interval);
-
-  TInstant *inst1 = tsequence_inst_n(seq, 0);
-  bool lower_inc = seq->period.lower_inc;
-  for (int i = 0; i < seq->count - 1; i++)
-  {
-    TInstant *inst2 = tsequence_inst_n(seq, i + 1);
-    bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false ;
-    result[i] = tinstant_transform_wcount1(inst1->t, inst2->t, lower_inc,
-      upper_inc, interval);
-    inst1 = inst2;
-    lower_inc = true;
-  }
-  return seq->count - 1;
-}
-
-/**
- * Transform the temporal number sequence set value by the time interval
- *
- * @param[out] result Array on which the pointers of the newly constructed 
- * values are stored
- * @param[in] ts Temporal value
- * @param[in] interval Interval
- */
-static int
-tsequenceset_transform_wcount(TSequence **result, TSequenceSet *ts, Interval *interval)
-{
-  int k = 0;
-  for (int i = 0; i < ts->count; i++)
-  {
-    TSequence *seq = tsequenceset_seq_n(ts, i);
-    k += tsequence_transform_wcount(&result[k], seq, interval);
-  }
-  return k;
-}
-
-/**
- * Transform the temporal number by the time interval (dispatch function)
- *
- * @param[in] temp Temporal value
- * @param[in] interval Interval
- * @param[out] count Number of elements in the output array
- */
-static TSequence **
-temporal_transform_wcount(Temporal *temp, Interval *interval, int *count)
-{
-  ensure_valid_duration(temp->duration);
-  TSequence **result;
-  if (temp->duration == INSTANT)
-  {
-    TInstant *inst = (TInstant *)temp;
-    result = palloc(sizeof(TSequence *));
-    *count = tinstant_transform_wcount(result, inst, interval);
-  }
-  else if (temp->duration == INSTANTSET)
-  {
-    TInstantSet *ti = (TInstantSet *)temp;
-    result = palloc(sizeof(TSequence *) * ti->count);
-    *count = tinstantset_transform_wcount(result, ti, interval);
-  }
-  else if (temp->duration == SEQUENCE)
-  {
-    TSequence *seq = (TSequence *)temp;
-    result = palloc(sizeof(TSequence *) * seq->count);
-    *count = tsequence_transform_wcount(result, seq, interval);
-  }
-  else /* temp->duration == SEQUENCESET */
-  {
-    TSequenceSet *ts = (TSequenceSet *)temp;
-    result = palloc(sizeof(TSequence *) * ts->totalcount);
-    *count = tsequenceset_transform_wcount(result, ts, interval);
-  }
-  return result;
-}
-
-/*****************************************************************************/
-
 /**
  * Transform the temporal number into a temporal double and extend it
  * by the time interval
@@ -536,6 +391,339 @@ tnumber_transform_wavg(Temporal *temp, Interval *interval, int *count)
   return result;
 }
 
+/*****************************************************************************
+ * Sliding window evaluation
+ *****************************************************************************/
+
+/**
+ * Return the timestamp extended by the time interval
+ */
+static TimestampTz
+timestamp_extend(TimestampTz t, const Interval *interval)
+{
+  return DatumGetTimestampTz(DirectFunctionCall2(timestamptz_pl_interval,
+    TimestampTzGetDatum(t), PointerGetDatum(interval)));
+}
+
+/**
+ * Set the piece of the window from its bounds and its value
+ */
+static void
+windowpiece_set(WindowPiece *piece, TimestampTz lower, TimestampTz upper,
+  bool lower_inc, bool upper_inc, Datum value)
+{
+  piece->lower = lower;
+  piece->upper = upper;
+  piece->lower_inc = lower_inc;
+  piece->upper_inc = upper_inc;
+  piece->value = value;
+}
+
+/**
+ * Compute the pieces of the temporal sequence value, that is, the periods
+ * of its segments extended by the time interval as done by the function
+ * tsequence_extend for step interpolation
+ *
+ * @param[out] result Array on which the pieces are stored
+ * @param[in] seq Temporal value
+ * @param[in] interval Interval
+ */
+static int
+tsequence_window_pieces(WindowPiece *result, const TSequence *seq,
+  const Interval *interval)
+{
+  TInstant *inst1 = tsequence_inst_n(seq, 0);
+  if (seq->count == 1)
+  {
+    windowpiece_set(&result[0], inst1->t, timestamp_extend(inst1->t,
+      interval), true, true, tinstant_value(inst1));
+    return 1;
+  }
+
+  bool lower_inc = seq->period.lower_inc;
+  for (int i = 0; i < seq->count - 1; i++)
+  {
+    TInstant *inst2 = tsequence_inst_n(seq, i + 1);
+    bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false ;
+    windowpiece_set(&result[i], inst1->t, timestamp_extend(inst2->t,
+      interval), lower_inc, upper_inc, tinstant_value(inst1));
+    inst1 = inst2;
+    lower_inc = true;
+  }
+  return seq->count - 1;
+}
+
+/**
+ * Compute the pieces of the temporal value (dispatch function). The pieces
+ * are ordered both by their lower and by their upper bound.
+ *
+ * @param[in] temp Temporal value
+ * @param[in] interval Interval
+ * @param[out] count Number of elements in the output array
+ */
+static WindowPiece *
+temporal_window_pieces(const Temporal *temp, const Interval *interval,
+  int *count)
+{
+  WindowPiece *result;
+  ensure_valid_duration(temp->duration);
+  if (temp->duration == INSTANT)
+  {
+    TInstant *inst = (TInstant *) temp;
+    result = palloc(sizeof(WindowPiece));
+    windowpiece_set(&result[0], inst->t, timestamp_extend(inst->t, interval),
+      true, true, tinstant_value(inst));
+    *count = 1;
+  }
+  else if (temp->duration == INSTANTSET)
+  {
+    TInstantSet *ti = (TInstantSet *) temp;
+    result = palloc(sizeof(WindowPiece) * ti->count);
+    for (int i = 0; i < ti->count; i++)
+    {
+      TInstant *inst = tinstantset_inst_n(ti, i);
+      windowpiece_set(&result[i], inst->t, timestamp_extend(inst->t,
+        interval), true, true, tinstant_value(inst));
+    }
+    *count = ti->count;
+  }
+  else if (temp->duration == SEQUENCE)
+  {
+    TSequence *seq = (TSequence *) temp;
+    result = palloc(sizeof(WindowPiece) * seq->count);
+    *count = tsequence_window_pieces(result, seq, interval);
+  }
+  else /* temp->duration == SEQUENCESET */
+  {
+    TSequenceSet *ts = (TSequenceSet *) temp;
+    result = palloc(sizeof(WindowPiece) * ts->totalcount);
+    int k = 0;
+    for (int i = 0; i < ts->count; i++)
+      k += tsequence_window_pieces(&result[k], tsequenceset_seq_n(ts, i),
+        interval);
+    *count = k;
+  }
+  return result;
+}
+
+/**
+ * Return the value of a piece as a double
+ */
+static double
+windowpiece_double(const WindowState *state, int i)
+{
+  Datum value = state->pieces[i].value;
+  return (state->valuetypid == INT4OID) ? (double) DatumGetInt32(value) :
+    DatumGetFloat8(value);
+}
+
+/**
+ * Add the piece to the window. For min and max, the pieces in the deque
+ * that can no longer be the result are removed since they leave the window
+ * before the new piece.
+ */
+static void
+window_add(WindowState *state, int i)
+{
+  if (state->op == WINDOW_MIN || state->op == WINDOW_MAX)
+  {
+    Datum value = state->pieces[i].value;
+    while (state->dqlast > state->dqfirst)
+    {
+      Datum last = state->pieces[state->deque[state->dqlast - 1]].value;
+      if (state->op == WINDOW_MIN ?
+          datum_lt(last, value, state->valuetypid) :
+          datum_gt(last, value, state->valuetypid))
+        break;
+      state->dqlast--;
+    }
+    state->deque[state->dqlast++] = i;
+  }
+  else if (state->op == WINDOW_SUM && state->valuetypid == INT4OID)
+    state->isum += DatumGetInt32(state->pieces[i].value);
+  else if (state->op == WINDOW_COUNT)
+    state->isum++;
+  else if (state->op == WINDOW_AVG && state->valuetypid == INT4OID)
+  {
+    state->dsum += windowpiece_double(state, i);
+    state->isum++;
+  }
+  state->right = i + 1;
+  return;
+}
+
+/**
+ * Remove the piece from the window, which is always its first piece
+ */
+static void
+window_remove(WindowState *state, int i)
+{
+  assert(i == state->left);
+  if (state->op == WINDOW_MIN || state->op == WINDOW_MAX)
+  {
+    if (state->dqlast > state->dqfirst && state->deque[state->dqfirst] == i)
+      state->dqfirst++;
+  }
+  else if (state->op == WINDOW_SUM && state->valuetypid == INT4OID)
+    state->isum -= DatumGetInt32(state->pieces[i].value);
+  else if (state->op == WINDOW_COUNT)
+    state->isum--;
+  else if (state->op == WINDOW_AVG && state->valuetypid == INT4OID)
+  {
+    state->dsum -= windowpiece_double(state, i);
+    state->isum--;
+  }
+  state->left = i + 1;
+  return;
+}
+
+/**
+ * Return the aggregate of the pieces in the window. Float sums are
+ * recomputed from the pieces in the window in the order in which the
+ * skiplist would add them, so that no rounding error accumulates.
+ */
+static Datum
+window_value(const WindowState *state)
+{
+  if (state->op == WINDOW_MIN || state->op == WINDOW_MAX)
+    return state->pieces[state->deque[state->dqfirst]].value;
+  if (state->op == WINDOW_COUNT || state->valuetypid == INT4OID)
+  {
+    if (state->op != WINDOW_AVG)
+      return Int32GetDatum((int32) state->isum);
+    double2 *dvalue = palloc(sizeof(double2));
+    double2_set(dvalue, state->dsum, (double) state->isum);
+    return PointerGetDatum(dvalue);
+  }
+  double sum = windowpiece_double(state, state->left);
+  for (int i = state->left + 1; i < state->right; i++)
+    sum += windowpiece_double(state, i);
+  if (state->op == WINDOW_SUM)
+    return Float8GetDatum(sum);
+  double2 *dvalue = palloc(sizeof(double2));
+  double2_set(dvalue, sum, (double) (state->right - state->left));
+  return PointerGetDatum(dvalue);
+}
+
+/**
+ * Construct a sequence from the instants and free the instants
+ */
+static TSequence *
+window_sequence(TInstant **instants, int count, bool lower_inc,
+  bool upper_inc, bool linear)
+{
+  TSequence *result = tsequence_make(instants, count, lower_inc,
+    upper_inc, linear, NORMALIZE);
+  for (int i = 0; i < count; i++)
+    pfree(instants[i]);
+  return result;
+}
+
+/**
+ * Compute the window aggregate of a temporal value in a single sweep over
+ * the bounds of its pieces
+ *
+ * At each bound, the value at the bound and the value just after it are
+ * computed from the pieces in the window, using a monotonic deque for min
+ * and max and running sums for sum, count, and average. These values are
+ * accumulated in sequences that are split where the values cannot be
+ * represented with the interpolation of the result.
+ *
+ * @param[in] temp Temporal value
+ * @param[in] interval Interval
+ * @param[in] op Aggregate operation
+ * @param[in] restypid Base type of the result
+ * @param[in] linear True when the result has linear interpolation
+ * @param[out] count Number of elements in the output array
+ */
+static TSequence **
+temporal_window(const Temporal *temp, const Interval *interval, int op,
+  Oid restypid, bool linear, int *count)
+{
+  int npieces;
+  WindowState state;
+  memset(&state, 0, sizeof(WindowState));
+  state.op = op;
+  state.valuetypid = temp->valuetypid;
+  state.pieces = temporal_window_pieces(temp, interval, &npieces);
+  if (op == WINDOW_MIN || op == WINDOW_MAX)
+    state.deque = palloc(sizeof(int) * npieces);
+
+  /* Every bound completes at most two sequences */
+  TSequence **result = palloc(sizeof(TSequence *) * (npieces * 4 + 1));
+  TInstant **instants = palloc(sizeof(TInstant *) * (npieces * 2 + 1));
+  int k = 0, l = 0;
+  bool open = false, lower_inc = false;
+  Datum prev = 0;
+  while (state.left < npieces)
+  {
+    const WindowPiece *in = (state.right < npieces) ?
+      &state.pieces[state.right] : NULL;
+    TimestampTz t = state.pieces[state.left].upper;
+    if (in && in->lower < t)
+      t = in->lower;
+
+    /* Pieces whose exclusive upper bound is t leave the window */
+    while (state.left < state.right && state.pieces[state.left].upper == t &&
+      ! state.pieces[state.left].upper_inc)
+      window_remove(&state, state.left);
+    /* Pieces whose inclusive lower bound is t enter the window */
+    while (state.right < npieces && state.pieces[state.right].lower == t &&
+      state.pieces[state.right].lower_inc)
+      window_add(&state, state.right);
+    bool at = state.left < state.right;
+    Datum value = at ? window_value(&state) : 0;
+    /* Pieces whose inclusive upper bound is t leave the window */
+    while (state.left < state.right && state.pieces[state.left].upper == t)
+      window_remove(&state, state.left);
+    /* Pieces whose exclusive lower bound is t enter the window */
+    while (state.right < npieces && state.pieces[state.right].lower == t)
+      window_add(&state, state.right);
+    bool after = state.left < state.right;
+    Datum next = after ? window_value(&state) : 0;
+
+    /* Close the sequence if its last value does not extend until t, that is,
+     * if t is not in the window, if the value changes at t with linear
+     * interpolation, or if the value at t is different from both the value
+     * before and the value after it */
+    bool cont = at && after && datum_eq(value, next, restypid);
+    if (open && (! at || (! datum_eq(prev, value, restypid) &&
+      (linear || ! cont))))
+    {
+      instants[l++] = tinstant_make(prev, t, restypid);
+      result[k++] = window_sequence(instants, l, lower_inc, false, linear);
+      open = false;
+    }
+    if (at)
+    {
+      if (! open)
+      {
+        l = 0;
+        lower_inc = true;
+      }
+      instants[l++] = tinstant_make(value, t, restypid);
+      open = cont;
+      if (! cont)
+        result[k++] = window_sequence(instants, l, lower_inc, true, linear);
+    }
+    if (! open && after)
+    {
+      l = 0;
+      instants[l++] = tinstant_make(next, t, restypid);
+      lower_inc = false;
+      open = true;
+    }
+    prev = next;
+  }
+  assert(! open);
+  pfree(instants);
+  pfree(state.pieces);
+  if (state.deque)
+    pfree(state.deque);
+  *count = k;
+  return result;
+}
+
 /*****************************************************************************
  * Generic moving window transition functions 
  *****************************************************************************/
@@ -548,19 +736,31 @@ tnumber_transform_wavg(Temporal *temp, Interval *interval, int *count)
  * @param[in] temp Temporal value
  * @param[in] interval Interval
  * @param[in] func Function
- * @param[in] min True if the calling function is min, max otherwise
+ * @param[in] op Aggregate operation
  * @param[in] crossings State whether turning points are added in the segments
  * @note This function is directly called by the window sum aggregation for 
  * temporal floats after verifying since the operation is not supported for 
  * sequence (set) duration
+ * @note Only the sequences with linear interpolation are extended segment by
+ * segment, since their window aggregate has turning points. The other values
+ * are aggregated with a sliding window and only the result is added to the
+ * state.
  */
 static SkipList *
 temporal_wagg_transfn1(FunctionCallInfo fcinfo, SkipList *state, 
   Temporal *temp, Interval *interval,
-  Datum (*func)(Datum, Datum), bool min, bool crossings)
+  Datum (*func)(Datum, Datum), int op, bool crossings)
 {
   int count;
-  TSequence **sequences = temporal_extend(temp, interval, min, &count);
+  TSequence **sequences;
+  if (temp->duration == INSTANT || temp->duration == INSTANTSET)
+    sequences = temporal_window(temp, interval, op, temp->valuetypid,
+      linear_interpolation(temp->valuetypid), &count);
+  else if (! MOBDB_FLAGS_GET_LINEAR(temp->flags))
+    sequences = temporal_window(temp, interval, op, temp->valuetypid,
+      STEP, &count);
+  else
+    sequences = temporal_extend(temp, interval, op != WINDOW_MAX, &count);
   SkipList *result = tsequence_tagg_transfn(fcinfo, state, sequences[0], 
     func, crossings);
   for (int i = 1; i < count; i++)
@@ -577,12 +777,12 @@ temporal_wagg_transfn1(FunctionCallInfo fcinfo, SkipList *state,
  *
  * @param[in] fcinfo Catalog information about the external function
  * @param[in] func Function
- * @param[in] min True if the calling function is min, max otherwise
+ * @param[in] op Aggregate operation
  * @param[in] crossings State whether turning points are added in the segments
  */
 Datum
 temporal_wagg_transfn(FunctionCallInfo fcinfo, 
-  Datum (*func)(Datum, Datum), bool min, bool crossings)
+  Datum (*func)(Datum, Datum), int op, bool crossings)
 {
   SkipList *state = PG_ARGISNULL(0) ? NULL :
     (SkipList *) PG_GETARG_POINTER(0);
@@ -600,7 +800,7 @@ temporal_wagg_transfn(FunctionCallInfo fcinfo,
       errmsg("Operation not supported for temporal float sequences")));
       
   SkipList *result = temporal_wagg_transfn1(fcinfo, state, temp, interval,
-    func, min, crossings);
+    func, op, crossings);
   
   PG_FREE_IF_COPY(temp, 1);
   PG_FREE_IF_COPY(interval, 2);
@@ -610,11 +810,13 @@ temporal_wagg_transfn(FunctionCallInfo fcinfo,
 /**
  * Transition function for moving window count and average aggregation 
  * for temporal values
+ *
+ * @note The average of temporal float sequences is computed by transforming
+ * every segment since the sliding window only accepts constant segments
  */
 Datum
 temporal_wagg_transform_transfn(FunctionCallInfo fcinfo, 
-  Datum (*func)(Datum, Datum), 
-  TSequence ** (*transform)(Temporal *, Interval *, int *))
+  Datum (*func)(Datum, Datum), int op)
 {
   SkipList *state = PG_ARGISNULL(0) ? NULL :
     (SkipList *) PG_GETARG_POINTER(0);
@@ -627,7 +829,15 @@ temporal_wagg_transform_transfn(FunctionCallInfo fcinfo,
   Temporal *temp = PG_GETARG_TEMPORAL(1);
   Interval *interval = PG_GETARG_INTERVAL_P(2);
   int count;
-  TSequence **sequences = transform(temp, interval, &count);
+  TSequence **sequences;
+  if (op == WINDOW_COUNT)
+    sequences = temporal_window(temp, interval, op, INT4OID, STEP, &count);
+  else if (temp->valuetypid == FLOAT8OID &&
+    (temp->duration == SEQUENCE || temp->duration == SEQUENCESET))
+    sequences = tnumber_transform_wavg(temp, interval, &count);
+  else
+    sequences = temporal_window(temp, interval, op, type_oid(T_DOUBLE2),
+      LINEAR, &count);
   SkipList *result = tsequence_tagg_transfn(fcinfo, state, sequences[0], 
     func, false);
   for (int i = 1; i < count; i++)
@@ -650,7 +860,7 @@ PG_FUNCTION_INFO_V1(tint_wmin_transfn);
 PGDLLEXPORT Datum
 tint_wmin_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_wagg_transfn(fcinfo, &datum_min_int32, MIN, CROSSINGS);
+  return temporal_wagg_transfn(fcinfo, &datum_min_int32, WINDOW_MIN, CROSSINGS);
 }
 
 PG_FUNCTION_INFO_V1(tfloat_wmin_transfn);
@@ -660,7 +870,7 @@ PG_FUNCTION_INFO_V1(tfloat_wmin_transfn);
 PGDLLEXPORT Datum
 tfloat_wmin_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_wagg_transfn(fcinfo, &datum_min_float8, MIN, CROSSINGS);
+  return temporal_wagg_transfn(fcinfo, &datum_min_float8, WINDOW_MIN, CROSSINGS);
 }
 
 PG_FUNCTION_INFO_V1(tint_wmax_transfn);
@@ -670,7 +880,7 @@ PG_FUNCTION_INFO_V1(tint_wmax_transfn);
 PGDLLEXPORT Datum
 tint_wmax_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_wagg_transfn(fcinfo, &datum_max_int32, MAX, CROSSINGS);
+  return temporal_wagg_transfn(fcinfo, &datum_max_int32, WINDOW_MAX, CROSSINGS);
 }
 
 PG_FUNCTION_INFO_V1(tfloat_wmax_transfn);
@@ -680,7 +890,7 @@ PG_FUNCTION_INFO_V1(tfloat_wmax_transfn);
 PGDLLEXPORT Datum
 tfloat_wmax_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_wagg_transfn(fcinfo, &datum_max_float8, MAX, CROSSINGS);
+  return temporal_wagg_transfn(fcinfo, &datum_max_float8, WINDOW_MAX, CROSSINGS);
 }
 
 PG_FUNCTION_INFO_V1(tint_wsum_transfn);
@@ -690,7 +900,7 @@ PG_FUNCTION_INFO_V1(tint_wsum_transfn);
 PGDLLEXPORT Datum
 tint_wsum_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_wagg_transfn(fcinfo, &datum_sum_int32, MIN, CROSSINGS_NO);
+  return temporal_wagg_transfn(fcinfo, &datum_sum_int32, WINDOW_SUM, CROSSINGS_NO);
 }
 
 PG_FUNCTION_INFO_V1(tfloat_wsum_transfn);
@@ -700,7 +910,7 @@ PG_FUNCTION_INFO_V1(tfloat_wsum_transfn);
 PGDLLEXPORT Datum
 tfloat_wsum_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_wagg_transfn(fcinfo, &datum_sum_float8, MIN, CROSSINGS);
+  return temporal_wagg_transfn(fcinfo, &datum_sum_float8, WINDOW_SUM, CROSSINGS);
 }
 
 PG_FUNCTION_INFO_V1(temporal_wcount_transfn);
@@ -710,8 +920,7 @@ PG_FUNCTION_INFO_V1(temporal_wcount_transfn);
 PGDLLEXPORT Datum
 temporal_wcount_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_wagg_transform_transfn(fcinfo, &datum_sum_int32, 
-    &temporal_transform_wcount);
+  return temporal_wagg_transform_transfn(fcinfo, &datum_sum_int32, WINDOW_COUNT);
 }
 
 PG_FUNCTION_INFO_V1(tnumber_wavg_transfn);
@@ -721,8 +930,7 @@ PG_FUNCTION_INFO_V1(tnumber_wavg_transfn);
 PGDLLEXPORT Datum
 tnumber_wavg_transfn(PG_FUNCTION_ARGS)
 {
-  return temporal_wagg_transform_transfn(fcinfo, &datum_sum_double2, 
-    &tnumber_transform_wavg);
+  return temporal_wagg_transform_transfn(fcinfo, &datum_sum_double2, WINDOW_AVG);
 }
 
 /*****************************************************************************/
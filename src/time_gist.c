@@ -15,6 +15,11 @@
 
 #include <assert.h>
 #include <access/gist.h>
+#include <access/brin_internal.h>
+#include <access/brin_tuple.h>
+#include <utils/datum.h>
+#include <utils/sortsupport.h>
+#include <utils/typcache.h>
 #include <utils/timestamp.h>
 
 #include "timetypes.h"
@@ -24,6 +29,8 @@
 #include "timeops.h"
 #include "temporal.h"
 #include "oidcache.h"
+#include "indexesstat.h"
+#include "mobdb_probes.h"
 
 /*****************************************************************************
  * GiST consistent methods
@@ -181,11 +188,14 @@ period_gist_consistent(PG_FUNCTION_ARGS)
   else
     elog(ERROR, "unrecognized strategy number: %d", strategy);
 
+  TRACE_MOBILITYDB_GIST_CONSISTENT_START(GIST_STAT_PERIOD, strategy);
   if (GIST_LEAF(entry))
     result = period_index_consistent_leaf(key, period, strategy);
   else
     result = period_gist_consistent_internal(key, period, strategy);
+  TRACE_MOBILITYDB_GIST_CONSISTENT_DONE(GIST_STAT_PERIOD, result);
 
+  gist_consistent_count(GIST_STAT_PERIOD, GIST_LEAF(entry), result, *recheck);
   PG_RETURN_BOOL(result);
 }
 
@@ -845,6 +855,7 @@ period_gist_picksplit(PG_FUNCTION_ARGS)
   size_t nbytes;
   OffsetNumber maxoff;
 
+  TRACE_MOBILITYDB_GIST_PICKSPLIT_START(GIST_STAT_PERIOD, entryvec->n - 1);
   maxoff = (OffsetNumber) (entryvec->n - 1);
   nbytes = (maxoff + 1) * sizeof(OffsetNumber);
   v->spl_left = (OffsetNumber *) palloc(nbytes);
@@ -852,6 +863,8 @@ period_gist_picksplit(PG_FUNCTION_ARGS)
 
   period_gist_double_sorting_split(entryvec, v);
 
+  TRACE_MOBILITYDB_GIST_PICKSPLIT_DONE(GIST_STAT_PERIOD, v->spl_nleft,
+    v->spl_nright);
   PG_RETURN_POINTER(v);
 }
 
@@ -888,4 +901,172 @@ period_gist_fetch(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(entry);
 }
 
-/*****************************************************************************/
\ No newline at end of file
+
+#if MOBDB_PGSQL_VERSION >= 140000
+/*****************************************************************************
+ * GiST sortsupport method
+ *****************************************************************************/
+
+/**
+ * Compares the centers of two periods
+ */
+static int
+period_gist_cmp_center(Datum a, Datum b, SortSupport ssup)
+{
+  const Period *p1 = DatumGetPeriod(a);
+  const Period *p2 = DatumGetPeriod(b);
+  /* Halving the bounds avoids overflows with infinite timestamps */
+  TimestampTz c1 = (p1->lower >> 1) + (p1->upper >> 1);
+  TimestampTz c2 = (p2->lower >> 1) + (p2->upper >> 1);
+  if (c1 == c2)
+    return 0;
+  return (c1 < c2) ? -1 : 1;
+}
+
+PG_FUNCTION_INFO_V1(period_gist_sortsupport);
+/**
+ * GiST sortsupport method for time types. It is used for building the
+ * index by sorting the periods by their center instead of inserting them
+ * one by one.
+ */
+PGDLLEXPORT Datum
+period_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+  SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+  ssup->comparator = period_gist_cmp_center;
+  PG_RETURN_VOID();
+}
+#endif
+
+/*****************************************************************************
+ * BRIN methods
+ *
+ * The summary of a block range is the union of the periods of its values.
+ * Since this union plays the same role as the key of an internal node of a
+ * GiST index, the consistent method reuses the GiST internal-page
+ * consistency.
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(period_brin_opcinfo);
+/**
+ * BRIN opcinfo method for periods
+ */
+PGDLLEXPORT Datum
+period_brin_opcinfo(PG_FUNCTION_ARGS)
+{
+  BrinOpcInfo *result = palloc0(MAXALIGN(SizeofBrinOpcInfo(1)));
+  result->oi_nstored = 1;
+  result->oi_typcache[0] = lookup_type_cache(type_oid(T_PERIOD), 0);
+  PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(period_brin_add_value);
+/**
+ * BRIN add value method for periods
+ */
+PGDLLEXPORT Datum
+period_brin_add_value(PG_FUNCTION_ARGS)
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  Datum newval = PG_GETARG_DATUM(2);
+  bool isnull = PG_GETARG_BOOL(3);
+  Period *period, *unionper;
+
+  if (isnull)
+  {
+    if (column->bv_hasnulls)
+      PG_RETURN_BOOL(false);
+    column->bv_hasnulls = true;
+    PG_RETURN_BOOL(true);
+  }
+
+  period = DatumGetPeriod(newval);
+  if (column->bv_allnulls)
+  {
+    column->bv_values[0] = datumCopy(newval, false, sizeof(Period));
+    column->bv_allnulls = false;
+    PG_RETURN_BOOL(true);
+  }
+  unionper = DatumGetPeriod(column->bv_values[0]);
+  if (contains_period_period_internal(unionper, period))
+    PG_RETURN_BOOL(false);
+  period_expand(unionper, period);
+  PG_RETURN_BOOL(true);
+}
+
+PG_FUNCTION_INFO_V1(period_brin_consistent);
+/**
+ * BRIN consistent method for periods
+ */
+PGDLLEXPORT Datum
+period_brin_consistent(PG_FUNCTION_ARGS)
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  ScanKey key = (ScanKey) PG_GETARG_POINTER(2);
+  Oid subtype = key->sk_subtype;
+  Period *period, p;
+
+  /* Handle IS NULL/IS NOT NULL tests */
+  if (key->sk_flags & SK_ISNULL)
+  {
+    if (key->sk_flags & SK_SEARCHNULL)
+      PG_RETURN_BOOL(column->bv_allnulls || column->bv_hasnulls);
+    if (key->sk_flags & SK_SEARCHNOTNULL)
+      PG_RETURN_BOOL(! column->bv_allnulls);
+    /* Neither IS NULL nor IS NOT NULL was used, the operators are strict */
+    PG_RETURN_BOOL(false);
+  }
+
+  /* If the block range contains only nulls, it cannot contain any match */
+  if (column->bv_allnulls)
+    PG_RETURN_BOOL(false);
+
+  /* Transform the query into a period */
+  if (subtype == TIMESTAMPTZOID)
+  {
+    TimestampTz t = DatumGetTimestampTz(key->sk_argument);
+    period_set(&p, t, t, true, true);
+    period = &p;
+  }
+  else if (subtype == type_oid(T_TIMESTAMPSET))
+    period = timestampset_bbox(
+      (TimestampSet *) PG_DETOAST_DATUM(key->sk_argument));
+  else if (subtype == type_oid(T_PERIOD))
+    period = DatumGetPeriod(key->sk_argument);
+  else if (subtype == type_oid(T_PERIODSET))
+    period = periodset_bbox(
+      (PeriodSet *) PG_DETOAST_DATUM(key->sk_argument));
+  else
+    elog(ERROR, "Unsupported subtype for indexing: %d", subtype);
+
+  PG_RETURN_BOOL(period_gist_consistent_internal(
+    DatumGetPeriod(column->bv_values[0]), period, key->sk_strategy));
+}
+
+PG_FUNCTION_INFO_V1(period_brin_union);
+/**
+ * BRIN union method for periods
+ */
+PGDLLEXPORT Datum
+period_brin_union(PG_FUNCTION_ARGS)
+{
+  BrinValues *col_a = (BrinValues *) PG_GETARG_POINTER(1);
+  BrinValues *col_b = (BrinValues *) PG_GETARG_POINTER(2);
+
+  if (col_b->bv_hasnulls)
+    col_a->bv_hasnulls = true;
+  if (col_b->bv_allnulls)
+    PG_RETURN_VOID();
+  if (col_a->bv_allnulls)
+  {
+    col_a->bv_values[0] = datumCopy(col_b->bv_values[0], false,
+      sizeof(Period));
+    col_a->bv_allnulls = false;
+    PG_RETURN_VOID();
+  }
+  period_expand(DatumGetPeriod(col_a->bv_values[0]),
+    DatumGetPeriod(col_b->bv_values[0]));
+  PG_RETURN_VOID();
+}
+
+/*****************************************************************************/
@@ -131,61 +131,67 @@ calc_periodsel(VariableStatData *vardata, Period *constval, Oid operator)
 }
 
 /*
- * Calculate period operator selectivity using histograms of period bounds.
+ * Fetch the histograms of lower and upper period bounds of the column, and
+ * the histogram of period lengths if the operator needs it.
  *
- * This estimate is for the portion of values that are not NULL.
+ * Returns false if the statistics are not available.
  */
-double
-calc_period_hist_selectivity(VariableStatData *vardata, Period *constval,
-  CachedOp cachedOp)
+static bool
+period_hist_fetch(VariableStatData *vardata, CachedOp cachedOp,
+  AttStatsSlot *hslot, AttStatsSlot *lslot, PeriodBound **hist_lower,
+  PeriodBound **hist_upper, int *nhist)
 {
-  AttStatsSlot hslot, lslot;
-  PeriodBound *hist_lower, *hist_upper;
-  PeriodBound  const_lower, const_upper;
-  double    hist_selec;
-  int      nhist, i;
-
   if (!(HeapTupleIsValid(vardata->statsTuple) &&
-      get_attstatsslot(&hslot, vardata->statsTuple,
+      get_attstatsslot(hslot, vardata->statsTuple,
                STATISTIC_KIND_PERIOD_BOUNDS_HISTOGRAM, 
                InvalidOid, ATTSTATSSLOT_VALUES)))
-    return -1.0;
+    return false;
   /*
    * Convert histogram of periods into histograms of its lower and upper
    * bounds.
    */
-  nhist = hslot.nvalues;
-  hist_lower = (PeriodBound *) palloc(sizeof(PeriodBound) * nhist);
-  hist_upper = (PeriodBound *) palloc(sizeof(PeriodBound) * nhist);
-  for (i = 0; i < nhist; i++)
-    period_deserialize(DatumGetPeriod(hslot.values[i]),
-               &hist_lower[i], &hist_upper[i]);
+  *nhist = hslot->nvalues;
+  *hist_lower = (PeriodBound *) palloc(sizeof(PeriodBound) * *nhist);
+  *hist_upper = (PeriodBound *) palloc(sizeof(PeriodBound) * *nhist);
+  for (int i = 0; i < *nhist; i++)
+    period_deserialize(DatumGetPeriod(hslot->values[i]),
+               &(*hist_lower)[i], &(*hist_upper)[i]);
 
   /* @> and @< also need a histogram of period lengths */
   if (cachedOp == CONTAINS_OP || cachedOp == CONTAINED_OP)
   {
     if (!(HeapTupleIsValid(vardata->statsTuple) &&
-        get_attstatsslot(&lslot, vardata->statsTuple,
+        get_attstatsslot(lslot, vardata->statsTuple,
                  STATISTIC_KIND_PERIOD_LENGTH_HISTOGRAM, 
                  InvalidOid, ATTSTATSSLOT_VALUES)))
     {
-      free_attstatsslot(&hslot);
-      return -1.0;
+      free_attstatsslot(hslot);
+      return false;
     }
 
     /* check that it's a histogram, not just a dummy entry */
-    if (lslot.nvalues < 2)
+    if (lslot->nvalues < 2)
     {
-      free_attstatsslot(&lslot);
-      free_attstatsslot(&hslot);
-      return -1.0;
+      free_attstatsslot(lslot);
+      free_attstatsslot(hslot);
+      return false;
     }
   }
   else
-    memset(&lslot, 0, sizeof(lslot));
+    memset(lslot, 0, sizeof(AttStatsSlot));
+  return true;
+}
 
-  /* Extract the bounds of the constant value. */
-  period_deserialize(constval, &const_lower, &const_upper);
+/*
+ * Calculate period operator selectivity of the bounds of a constant period
+ * using the histograms of period bounds of a column.
+ */
+static double
+period_hist_selectivity_bounds(PeriodBound *const_lower,
+  PeriodBound *const_upper, CachedOp cachedOp, PeriodBound *hist_lower,
+  PeriodBound *hist_upper, int nhist, AttStatsSlot *lslot)
+{
+  double    hist_selec;
 
   /*
    * Calculate selectivity comparing the lower or upper bound of the
@@ -202,32 +208,32 @@ calc_period_hist_selectivity(VariableStatData *vardata, Period *constval,
      * combination of parameters. This is because the b-tree stores the
      * values, not their BBoxes.
      */
-    hist_selec = calc_period_hist_selectivity_scalar(&const_lower,
+    hist_selec = calc_period_hist_selectivity_scalar(const_lower,
       hist_lower, nhist, false);
   else if (cachedOp == LE_OP)
-    hist_selec = calc_period_hist_selectivity_scalar(&const_lower,
+    hist_selec = calc_period_hist_selectivity_scalar(const_lower,
       hist_lower, nhist, true);
   else if (cachedOp == GT_OP)
-    hist_selec = 1 - calc_period_hist_selectivity_scalar(&const_lower,
+    hist_selec = 1 - calc_period_hist_selectivity_scalar(const_lower,
       hist_lower, nhist, false);
   else if (cachedOp == GE_OP)
-    hist_selec = 1 - calc_period_hist_selectivity_scalar(&const_lower,
+    hist_selec = 1 - calc_period_hist_selectivity_scalar(const_lower,
       hist_lower, nhist, true);
   else if (cachedOp == BEFORE_OP)
     /* var <<# const when upper(var) < lower(const)*/
-    hist_selec = calc_period_hist_selectivity_scalar(&const_lower,
+    hist_selec = calc_period_hist_selectivity_scalar(const_lower,
       hist_upper, nhist, false);
   else if (cachedOp == OVERBEFORE_OP)
     /* var &<# const when upper(var) <= upper(const) */
-    hist_selec = calc_period_hist_selectivity_scalar(&const_upper,
+    hist_selec = calc_period_hist_selectivity_scalar(const_upper,
       hist_upper, nhist, true);
   else if (cachedOp == AFTER_OP)
     /* var #>> const when lower(var) > upper(const) */
-    hist_selec = 1 - calc_period_hist_selectivity_scalar(&const_upper,
+    hist_selec = 1 - calc_period_hist_selectivity_scalar(const_upper,
       hist_lower, nhist, true);
   else if (cachedOp == OVERAFTER_OP)
     /* var #&> const when lower(var) >= lower(const)*/
-    hist_selec = 1 - calc_period_hist_selectivity_scalar(&const_lower,
+    hist_selec = 1 - calc_period_hist_selectivity_scalar(const_lower,
       hist_lower, nhist, false);
   else if (cachedOp == OVERLAPS_OP)
   {
@@ -243,26 +249,53 @@ calc_period_hist_selectivity(VariableStatData *vardata, Period *constval,
      * caller already constructed the singular period from the element
      * constant, so just treat it the same as &&.
      */
-    hist_selec = calc_period_hist_selectivity_scalar(&const_lower,
+    hist_selec = calc_period_hist_selectivity_scalar(const_lower,
       hist_upper, nhist, false);
-    hist_selec += (1.0 - calc_period_hist_selectivity_scalar(&const_upper,
+    hist_selec += (1.0 - calc_period_hist_selectivity_scalar(const_upper,
       hist_lower, nhist, true));
     hist_selec = 1.0 - hist_selec;
   }
   else if (cachedOp == CONTAINS_OP)
-    hist_selec = calc_period_hist_selectivity_contains(&const_lower,
-      &const_upper, hist_lower, nhist, lslot.values, lslot.nvalues);
+    hist_selec = calc_period_hist_selectivity_contains(const_lower,
+      const_upper, hist_lower, nhist, lslot->values, lslot->nvalues);
   else if (cachedOp == CONTAINED_OP)
-    hist_selec = calc_period_hist_selectivity_contained(&const_lower,
-      &const_upper, hist_lower, nhist, lslot.values, lslot.nvalues);
+    hist_selec = calc_period_hist_selectivity_contained(const_lower,
+      const_upper, hist_lower, nhist, lslot->values, lslot->nvalues);
   else if (cachedOp == ADJACENT_OP)
-    hist_selec = calc_period_hist_selectivity_adjacent(&const_lower,
-      &const_upper, hist_lower, hist_upper,nhist);
+    hist_selec = calc_period_hist_selectivity_adjacent(const_lower,
+      const_upper, hist_lower, hist_upper,nhist);
   else
   {
     elog(ERROR, "Unable to compute selectivity for unknown period operator");
     hist_selec = -1.0;  /* keep compiler quiet */
   }
+  return hist_selec;
+}
+
+/*
+ * Calculate period operator selectivity using histograms of period bounds.
+ *
+ * This estimate is for the portion of values that are not NULL.
+ */
+double
+calc_period_hist_selectivity(VariableStatData *vardata, Period *constval,
+  CachedOp cachedOp)
+{
+  AttStatsSlot hslot, lslot;
+  PeriodBound *hist_lower, *hist_upper;
+  PeriodBound  const_lower, const_upper;
+  double    hist_selec;
+  int      nhist;
+
+  if (! period_hist_fetch(vardata, cachedOp, &hslot, &lslot, &hist_lower,
+      &hist_upper, &nhist))
+    return -1.0;
+
+  /* Extract the bounds of the constant value. */
+  period_deserialize(constval, &const_lower, &const_upper);
+
+  hist_selec = period_hist_selectivity_bounds(&const_lower, &const_upper,
+    cachedOp, hist_lower, hist_upper, nhist, &lslot);
 
   free_attstatsslot(&lslot);
   free_attstatsslot(&hslot);
@@ -270,6 +303,60 @@ calc_period_hist_selectivity(VariableStatData *vardata, Period *constval,
   return hist_selec;
 }
 
+/*
+ * Calculate the join selectivity of a period operator between two columns
+ * using their histograms of period bounds.
+ *
+ * The periods of the histogram of the second column, which are built from
+ * equi-depth histograms of its lower and upper bounds, are used as a sample
+ * of this column. The selectivity is the average of the selectivity of
+ * these periods with respect to the histograms of the first column. For the
+ * operators that compare a bound of each side, such as && or <<#, this
+ * amounts to combining the distributions of the bounds of both columns.
+ *
+ * This estimate is for the portion of values that are not NULL.
+ */
+double
+calc_period_hist_joinselectivity(VariableStatData *vardata1,
+  VariableStatData *vardata2, CachedOp cachedOp)
+{
+  AttStatsSlot hslot1, lslot1, hslot2, lslot2;
+  PeriodBound *hist_lower1, *hist_upper1, *hist_lower2, *hist_upper2;
+  double    hist_selec = 0.0;
+  int      nhist1, nhist2;
+
+  /* There is no ~= operator for time types */
+  if (cachedOp != LT_OP && cachedOp != LE_OP && cachedOp != GT_OP &&
+    cachedOp != GE_OP && cachedOp != BEFORE_OP && cachedOp != OVERBEFORE_OP &&
+    cachedOp != AFTER_OP && cachedOp != OVERAFTER_OP &&
+    cachedOp != OVERLAPS_OP && cachedOp != CONTAINS_OP &&
+    cachedOp != CONTAINED_OP && cachedOp != ADJACENT_OP)
+    return -1.0;
+
+  if (! period_hist_fetch(vardata1, cachedOp, &hslot1, &lslot1, &hist_lower1,
+      &hist_upper1, &nhist1))
+    return -1.0;
+  /* The length histogram of the second column is not needed */
+  if (! period_hist_fetch(vardata2, OVERLAPS_OP, &hslot2, &lslot2,
+      &hist_lower2, &hist_upper2, &nhist2))
+  {
+    free_attstatsslot(&lslot1);
+    free_attstatsslot(&hslot1);
+    return -1.0;
+  }
+
+  for (int i = 0; i < nhist2; i++)
+    hist_selec += period_hist_selectivity_bounds(&hist_lower2[i],
+      &hist_upper2[i], cachedOp, hist_lower1, hist_upper1, nhist1, &lslot1);
+  hist_selec = (nhist2 > 0) ? hist_selec / nhist2 : -1.0;
+
+  free_attstatsslot(&hslot2);
+  free_attstatsslot(&lslot1);
+  free_attstatsslot(&hslot1);
+
+  return hist_selec;
+}
+
 /*
  * Binary search on an array of period bounds. Returns greatest index of period
  * bound in array which is less(less or equal) than given period bound. If all
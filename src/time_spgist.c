@@ -426,8 +426,7 @@ spperiod_gist_inner_consistent(PG_FUNCTION_ARGS)
     /* For temporal types whose bounding box is a period */
     else if (temporal_type(subtype))
     {
-      temporal_bbox(&period,
-        DatumGetTemporal(in->scankeys[i].sk_argument));
+      temporal_bbox_slice(&period, in->scankeys[i].sk_argument);
       query = &period;
     }
     else
@@ -720,8 +719,7 @@ spperiod_gist_leaf_consistent(PG_FUNCTION_ARGS)
     {
       /* All tests are lossy for temporal types */
       out->recheck = true;
-      temporal_bbox(&period,
-        DatumGetTemporal(in->scankeys[i].sk_argument));
+      temporal_bbox_slice(&period, in->scankeys[i].sk_argument);
       query = &period;
     }
     else
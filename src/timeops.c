@@ -19,6 +19,7 @@
 #include "periodset.h"
 #include "timestampset.h"
 #include "oidcache.h"
+#include "temporal_argcache.h"
 
 typedef enum
 {
@@ -117,6 +118,71 @@ setop_timestampset_timestampset(const TimestampSet *ts1,
   return timestampset_make_free(times, k);
 }
 
+/**
+ * Sets the run to the timestamps of the run between the two positions
+ */
+static void
+timestamprun_slice(TimestampRun *result, const TimestampRun *run, int first,
+  int last)
+{
+  result->start = run->start + first * run->step;
+  result->step = run->step;
+  result->count = last - first + 1;
+  return;
+}
+
+/**
+ * Returns the intersection or the difference of the encoded timestamp set
+ * and the array of periods
+ *
+ * The result is computed run by run from the positions of the timestamps
+ * of each run contained in the periods, without expanding the runs.
+ *
+ * @param[in] ts Encoded timestamp set value
+ * @param[in] periods Array of ordered and disjoint periods
+ * @param[in] count Number of elements in the array
+ * @param[in] setop Set operation
+ */
+static TimestampSet *
+setop_timestampruns_periods(const TimestampSet *ts, const Period **periods,
+  int count, SetOper setop)
+{
+  assert(setop == INTER || setop == MINUS);
+  /* Every period splits at most one run into two */
+  int nruns = timestampset_num_runs(ts);
+  TimestampRun *runs = palloc(sizeof(TimestampRun) * (nruns + count));
+  int j = 0, k = 0;
+  for (int i = 0; i < nruns; i++)
+  {
+    const TimestampRun *run = timestampset_run_n(ts, i);
+    TimestampTz end = run->start + (run->count - 1) * run->step;
+    /* Skip the periods before the run */
+    while (j < count && periods[j]->upper < run->start)
+      j++;
+    /* First position of the run that is not inside the previous periods */
+    int from = 0;
+    for (int l = j; l < count && periods[l]->lower <= end; l++)
+    {
+      int first, last;
+      if (! timestamprun_find_period(run, periods[l], &first, &last))
+        continue;
+      if (setop == INTER)
+        timestamprun_slice(&runs[k++], run, first, last);
+      else
+      {
+        if (first > from)
+          timestamprun_slice(&runs[k++], run, from, first - 1);
+        from = last + 1;
+      }
+    }
+    if (setop == MINUS && from < run->count)
+      timestamprun_slice(&runs[k++], run, from, run->count - 1);
+  }
+  TimestampSet *result = timestampset_make_runs(runs, k);
+  pfree(runs);
+  return result;
+}
+
 /**
  * Returns the intersection or the difference of the two time values
  */
@@ -130,6 +196,9 @@ setop_timestampset_period(const TimestampSet *ts, const Period *p,
   if (!overlaps_period_period_internal(p1, p))
     return (setop == INTER) ? NULL : timestampset_copy(ts);
 
+  if (timestampset_num_runs(ts) > 0)
+    return setop_timestampruns_periods(ts, &p, 1, setop);
+
   TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
   int k = 0;
   for (int i = 0; i < ts->count; i++)
@@ -156,6 +225,17 @@ setop_timestampset_periodset(const TimestampSet *ts, const PeriodSet *ps,
   if (!overlaps_period_period_internal(p1, p2))
     return (setop == INTER) ? NULL : timestampset_copy(ts);
 
+  if (timestampset_num_runs(ts) > 0)
+  {
+    const Period **periods = palloc(sizeof(Period *) * ps->count);
+    for (int i = 0; i < ps->count; i++)
+      periods[i] = periodset_per_n(ps, i);
+    TimestampSet *result = setop_timestampruns_periods(ts, periods,
+      ps->count, setop);
+    pfree(periods);
+    return result;
+  }
+
   TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
   TimestampTz t = timestampset_time_n(ts, 0);
   Period *p = periodset_per_n(ps, 0);
@@ -200,6 +280,120 @@ setop_timestampset_periodset(const TimestampSet *ts, const PeriodSet *ps,
   return timestampset_make_free(times, k);
 }
 
+/**
+ * Returns the bound of the period set value at the position, where the
+ * bounds of the period at position i are at positions 2i and 2i+1
+ */
+static void
+periodset_bound_n(PeriodBound *bound, const PeriodSet *ps, int n)
+{
+  const Period *p = periodset_per_n(ps, n / 2);
+  bound->lower = (n % 2 == 0);
+  bound->t = bound->lower ? p->lower : p->upper;
+  bound->inclusive = bound->lower ? p->lower_inc : p->upper_inc;
+  return;
+}
+
+/**
+ * Returns the union, intersection or difference of the two time values
+ *
+ * The bounds of the periods of both values are merged in a single sweep
+ * that keeps track of whether the current instant belongs to each value.
+ * A period of the result starts or ends whenever the membership condition
+ * of the set operation changes. At the same instant, lower bounds are
+ * processed before upper bounds so that periods that share an inclusive
+ * bound are merged by the union and intersect in the intersection.
+ *
+ * @param[in] ps1,ps2 Period set values
+ * @param[in] from1,from2 Periods of each value from which the sweep starts,
+ * which must not overlap with any period of the other value that precedes
+ * the start of the sweep
+ * @param[in] setop Set operation
+ */
+static PeriodSet *
+setop_periodset_periodset(const PeriodSet *ps1, const PeriodSet *ps2,
+  int from1, int from2, SetOper setop)
+{
+  int count1 = 2 * ps1->count, count2 = 2 * ps2->count;
+  Period **periods = palloc(sizeof(Period *) *
+    (ps1->count - from1 + ps2->count - from2));
+  PeriodBound b1, b2, start, end;
+  bool in1 = false, in2 = false, out = false;
+  int i = 2 * from1, j = 2 * from2, k = 0;
+  while (i < count1 || j < count2)
+  {
+    /* The result cannot grow after the end of the first value for the
+     * intersection and the difference, nor after the end of the second
+     * value for the intersection */
+    if ((setop != UNION && i == count1) || (setop == INTER && j == count2))
+      break;
+    bool first;
+    if (i == count1)
+    {
+      periodset_bound_n(&b2, ps2, j);
+      first = false;
+    }
+    else if (j == count2)
+    {
+      periodset_bound_n(&b1, ps1, i);
+      first = true;
+    }
+    else
+    {
+      periodset_bound_n(&b1, ps1, i);
+      periodset_bound_n(&b2, ps2, j);
+      int cmp = period_cmp_bounds(&b1, &b2);
+      first = (cmp == 0 && b1.lower != b2.lower) ? b1.lower : (cmp <= 0);
+    }
+    PeriodBound *b;
+    if (first)
+    {
+      b = &b1;
+      in1 = b->lower;
+      i++;
+    }
+    else
+    {
+      b = &b2;
+      in2 = b->lower;
+      j++;
+    }
+    bool newout = (setop == UNION) ? (in1 || in2) :
+      ((setop == INTER) ? (in1 && in2) : (in1 && ! in2));
+    if (newout == out)
+      continue;
+    out = newout;
+    if (out)
+    {
+      /* An upper bound starting a period is the end of the second value
+       * in a difference, whose complement starts at the bound */
+      start = *b;
+      if (! b->lower)
+      {
+        start.lower = true;
+        start.inclusive = ! b->inclusive;
+      }
+    }
+    else
+    {
+      /* Symmetrically, a lower bound ending a period is the start of the
+       * second value in a difference */
+      end = *b;
+      if (b->lower)
+      {
+        end.lower = false;
+        end.inclusive = ! b->inclusive;
+      }
+      /* Discard empty periods resulting from equal bounds */
+      if (start.t < end.t ||
+        (start.t == end.t && start.inclusive && end.inclusive))
+        periods[k++] = period_make(start.t, end.t, start.inclusive,
+          end.inclusive);
+    }
+  }
+  return periodset_make_free(periods, k, NORMALIZE);
+}
+
 /*****************************************************************************/
 /* contains? */
 
@@ -378,6 +572,39 @@ contains_periodset_timestamp_internal(const PeriodSet *ps, TimestampTz t)
   return true;
 }
 
+/**
+ * Returns true if the period set argument contains the timestamp
+ *
+ * When the period set argument is the same across the calls of a query,
+ * the membership test is answered by the search index of the period set
+ * kept in the argument cache of the function.
+ *
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] psarg Number of the period set argument
+ * @param[in] t Timestamp
+ */
+static bool
+contains_periodset_timestamp1(FunctionCallInfo fcinfo, int psarg,
+  TimestampTz t)
+{
+  ArgCacheEntry *entry = argcache_periodset(fcinfo, psarg);
+  PeriodSet *ps = entry ? (PeriodSet *) DatumGetPointer(entry->value) :
+    PG_GETARG_PERIODSET(psarg);
+  bool result;
+  if (entry == NULL)
+    result = contains_periodset_timestamp_internal(ps, t);
+  else
+  {
+    /* Bounding box test */
+    int loc;
+    result = contains_period_timestamp_internal(periodset_bbox(ps), t) &&
+      periodset_index_find_timestamp((PeriodSetIndex *) entry->aux, ps, t,
+        &loc);
+  }
+  ARGCACHE_FREE_IF_COPY(ps, psarg, entry);
+  return result;
+}
+
 PG_FUNCTION_INFO_V1(contains_periodset_timestamp);
 /**
  * Returns true if the first time value contains the second one
@@ -385,11 +612,8 @@ PG_FUNCTION_INFO_V1(contains_periodset_timestamp);
 PGDLLEXPORT Datum
 contains_periodset_timestamp(PG_FUNCTION_ARGS)
 {
-  PeriodSet *ps = PG_GETARG_PERIODSET(0);
   TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
-  bool result = contains_periodset_timestamp_internal(ps, t);
-  PG_FREE_IF_COPY(ps, 0);
-  PG_RETURN_BOOL(result);
+  PG_RETURN_BOOL(contains_periodset_timestamp1(fcinfo, 0, t));
 }
 
 /**
@@ -587,10 +811,7 @@ PGDLLEXPORT Datum
 contained_timestamp_periodset(PG_FUNCTION_ARGS)
 {
   TimestampTz t = PG_GETARG_TIMESTAMPTZ(0);
-  PeriodSet *ps = PG_GETARG_PERIODSET(1);
-  bool result = contains_periodset_timestamp_internal(ps, t);
-  PG_FREE_IF_COPY(ps, 1);
-  PG_RETURN_BOOL(result);
+  PG_RETURN_BOOL(contains_periodset_timestamp1(fcinfo, 1, t));
 }
 
 PG_FUNCTION_INFO_V1(contained_timestampset_timestampset);
@@ -844,14 +1065,7 @@ overlaps_period_timestampset(PG_FUNCTION_ARGS)
 bool
 overlaps_period_period_internal(const Period *p1, const Period *p2)
 {
-  int c1 = timestamp_cmp_internal(p1->lower, p2->upper);
-  int c2 = timestamp_cmp_internal(p2->lower, p1->upper);
-  if (
-    (c1 < 0 || (c1 == 0 && p1->lower_inc && p2->upper_inc)) &&
-    (c2 < 0 || (c2 == 0 && p2->lower_inc && p1->upper_inc))
-  )
-    return true;
-  return false;
+  return overlaps_period_period_inline(p1, p2);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_period_period);
@@ -3125,102 +3339,7 @@ union_periodset_period(PG_FUNCTION_ARGS)
 PeriodSet *
 union_periodset_periodset_internal(const PeriodSet *ps1, const PeriodSet *ps2)
 {
-  Period *p1, *p2;
-  Period **periods = palloc(sizeof(Period *) * (ps1->count + ps2->count));
-  Period **mustfree = NULL;
-  /* If the period sets overlap we will be intersecting composing periods */
-  if (overlaps_periodset_periodset_internal(ps1, ps2))
-    mustfree = palloc(sizeof(Period *) * Max(ps1->count, ps2->count));
-
-  int i = 0, j = 0, k = 0, l = 0;
-  while (i < ps1->count && j < ps2->count)
-  {
-    p1 = periodset_per_n(ps1, i);
-    p2 = periodset_per_n(ps2, j);
-    /* The periods do not overlap, copy the earliest period */
-    if (!overlaps_period_period_internal(p1, p2))
-    {
-      if (before_period_period_internal(p1, p2))
-      {
-        periods[k++] = p1;
-        i++;
-      }
-      else
-      {
-        periods[k++] = p2;
-        j++;
-      }
-    }
-    else
-    {
-      /* Find all periods in ps1 that overlap with periods in ps2
-       *      i                    i
-       *   |-----| |-| |-----|  |-----|
-       *       |---------|  |-----|
-       *            j          j
-       */
-      Period *q = period_super_union(p1, p2);
-      while (i < ps1->count && j < ps2->count)
-      {
-        p1 = periodset_per_n(ps1, i);
-        p2 = periodset_per_n(ps2, j);
-        if (!overlaps_period_period_internal(p1, q) &&
-          !overlaps_period_period_internal(p2, q))
-          break;
-        if (overlaps_period_period_internal(p1, q))
-        {
-          period_expand(q, p1);
-          i++;
-        }
-        if (overlaps_period_period_internal(p2, q))
-        {
-          period_expand(q, p2);
-          j++;
-        }
-      }
-      /* When one of the sets is finished we need to absorb overlapping
-       * periods in the other set */
-      while (i < ps1->count)
-      {
-        p1 = periodset_per_n(ps1, i);
-        if (overlaps_period_period_internal(p1, q))
-        {
-          period_expand(q, p1);
-          i++;
-        }
-        else
-          break;
-      }
-      while (j < ps2->count)
-      {
-        p2 = periodset_per_n(ps2, j);
-        if (overlaps_period_period_internal(p2, q))
-        {
-          period_expand(q, p2);
-          j++;
-        }
-        else
-          break;
-      }
-      periods[k++] = mustfree[l++] = q;
-    }
-  }
-  while (i < ps1->count)
-    periods[k++] = periodset_per_n(ps1, i++);
-  while (j < ps2->count)
-    periods[k++] = periodset_per_n(ps2, j++);
-  /* k is never equal to 0 since the periodsets are not empty */
-  PeriodSet *result = periodset_make(periods, k, NORMALIZE);
-  pfree(periods);
-
-  if (mustfree)
-  {
-    for (i = 0; i < l; i++)
-      pfree(mustfree[i]);
-    pfree(mustfree);
-  }
-
-  return result;
+  return setop_periodset_periodset(ps1, ps2, 0, 0, UNION);
 }
 
 PG_FUNCTION_INFO_V1(union_periodset_periodset);
@@ -3580,31 +3699,13 @@ intersection_periodset_periodset_internal(const PeriodSet *ps1,
   if (!overlaps_period_period_internal(p1, p2))
     return NULL;
 
+  /* Start the sweep at the periods that may intersect */
   Period *inter = intersection_period_period_internal(p1, p2);
   int loc1, loc2;
   periodset_find_timestamp(ps1, inter->lower, &loc1);
   periodset_find_timestamp(ps2, inter->lower, &loc2);
   pfree(inter);
-  Period **periods = palloc(sizeof(Period *) * (ps1->count + ps2->count - loc1 - loc2));
-  int i = loc1, j = loc2, k = 0;
-  while (i < ps1->count && j < ps2->count)
-  {
-    p1 = periodset_per_n(ps1, i);
-    p2 = periodset_per_n(ps2, j);
-    inter = intersection_period_period_internal(p1, p2);
-    if (inter != NULL)
-      periods[k++] = inter;
-    int cmp = timestamp_cmp_internal(p1->upper, p2->upper);
-    if (cmp == 0 && p1->upper_inc == p2->upper_inc)
-    {
-      i++; j++;
-    }
-    else if (cmp < 0 || (cmp == 0 && ! p1->upper_inc && p2->upper_inc))
-      i++;
-    else
-      j++;
-  }
-  return periodset_make_free(periods, k, NORMALIZE);
+  return setop_periodset_periodset(ps1, ps2, loc1, loc2, INTER);
 }
 
 PG_FUNCTION_INFO_V1(intersection_periodset_periodset);
@@ -4311,45 +4412,7 @@ minus_periodset_periodset_internal(const PeriodSet *ps1, const PeriodSet *ps2)
   if (!overlaps_period_period_internal(p1, p2))
     return periodset_copy(ps1);
 
-  Period **periods = palloc(sizeof(const Period *) * (ps1->count + ps2->count));
-  int i = 0, j = 0, k = 0;
-  while (i < ps1->count && j < ps2->count)
-  {
-    p1 = periodset_per_n(ps1, i);
-    p2 = periodset_per_n(ps2, j);
-    /* The periods do not overlap, copy the first period */
-    if (!overlaps_period_period_internal(p1, p2))
-    {
-      periods[k++] = period_copy(p1);
-      i++;
-    }
-    else
-    {
-      /* Find all periods in ps2 that overlap with p1
-       *                  i
-       *    |------------------------|
-       *      |-----|  |-----|          |---|
-       *         j                        l
-       */
-      int l;
-      for (l = j; l < ps2->count; l++)
-      {
-        Period *p3 = periodset_per_n(ps2, l);
-        if (!overlaps_period_period_internal(p1, p3))
-          break;
-      }
-      int to = Min(l, ps2->count);
-      /* Compute the difference of the overlapping periods */
-      k += minus_period_periodset_internal1(&periods[k], p1,
-        ps2, j, to);
-      i++;
-      j = l;
-    }
-  }
-  /* Copy the sequences after the period set */
-  while (i < ps1->count)
-    periods[k++] = period_copy(periodset_per_n(ps1, i++));
-  return periodset_make_free(periods, k, NORMALIZE_NO);
+  return setop_periodset_periodset(ps1, ps2, 0, 0, MINUS);
 }
 
 PG_FUNCTION_INFO_V1(minus_periodset_periodset);
@@ -12,6 +12,7 @@
 
 #include "timestampset.h"
 
+#include <assert.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
 #include <utils/timestamp.h>
@@ -27,6 +28,10 @@
  
 /**
  * Returns a pointer to the array of offsets of the timestamp set value
+ *
+ * Since the first timestamp of a timestamp set stored explicitly is at
+ * offset 0, the first element of the array is used in encoded timestamp
+ * sets to keep their number of runs.
  */
 static size_t *
 timestampset_offsets_ptr(const TimestampSet *ts)
@@ -44,12 +49,58 @@ timestampset_data_ptr(const TimestampSet *ts)
     sizeof(size_t) * (ts->count + 1));
 }
 
+/**
+ * Returns the number of runs of the timestamp set value, or 0 if its
+ * timestamps are stored explicitly
+ */
+int
+timestampset_num_runs(const TimestampSet *ts)
+{
+  return (int) timestampset_offsets_ptr(ts)[0];
+}
+
+/**
+ * Returns a pointer to the array of runs of the encoded timestamp set value,
+ * which follows the number of runs
+ */
+static TimestampRun *
+timestampset_runs_ptr(const TimestampSet *ts)
+{
+  return (TimestampRun *) (timestampset_offsets_ptr(ts) + 1);
+}
+
+/**
+ * Returns the n-th run of the encoded timestamp set value
+ */
+const TimestampRun *
+timestampset_run_n(const TimestampSet *ts, int index)
+{
+  assert(timestampset_num_runs(ts) > 0);
+  return &timestampset_runs_ptr(ts)[index];
+}
+
 /**
  * Returns the n-th timestamp of the timestamp set value
  */
 TimestampTz
 timestampset_time_n(const TimestampSet *ts, int index)
 {
+  int nruns = timestampset_num_runs(ts);
+  if (nruns > 0)
+  {
+    /* Find the last run starting at or before the position */
+    const TimestampRun *runs = timestampset_runs_ptr(ts);
+    int first = 0, last = nruns - 1;
+    while (first < last)
+    {
+      int middle = (first + last + 1) / 2;
+      if (runs[middle].first <= index)
+        first = middle;
+      else
+        last = middle - 1;
+    }
+    return runs[first].start + (index - runs[first].first) * runs[first].step;
+  }
   size_t *offsets = timestampset_offsets_ptr(ts);
   TimestampTz *result = (TimestampTz *) (timestampset_data_ptr(ts) + offsets[index]);
   return *result;
@@ -61,10 +112,92 @@ timestampset_time_n(const TimestampSet *ts, int index)
 Period *
 timestampset_bbox(const TimestampSet *ts)
 {
+  int nruns = timestampset_num_runs(ts);
+  if (nruns > 0)
+    return (Period *)(timestampset_runs_ptr(ts) + nruns);
   size_t *offsets = timestampset_offsets_ptr(ts);
   return (Period *)(timestampset_data_ptr(ts) + offsets[ts->count]);
 }
 
+/**
+ * Splits the array of timestamps into runs of equally spaced timestamps
+ *
+ * @param[out] runs Array of runs, may be NULL to only count them
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the array
+ * @result Number of runs
+ */
+static int
+timestamparr_runs(TimestampRun *runs, const TimestampTz *times, int count)
+{
+  int i = 0, k = 0;
+  while (i < count)
+  {
+    int64 step = 0;
+    int j = i + 1;
+    if (j < count)
+    {
+      step = times[j] - times[i];
+      while (j + 1 < count && times[j + 1] - times[j] == step)
+        j++;
+      j++;
+    }
+    if (runs != NULL)
+    {
+      runs[k].start = times[i];
+      runs[k].step = step;
+      runs[k].count = j - i;
+      runs[k].first = i;
+    }
+    k++;
+    i = j;
+  }
+  return k;
+}
+
+/**
+ * Construct an encoded timestamp set from an array of runs
+ *
+ * The memory structure of an encoded timestamp set with 2 runs is as follows
+ * @code
+ * -----------------------------------------------------------
+ * ( TimestampSet | nruns | Run_0 | Run_1 | ( bbox )_Y )_X |
+ * -----------------------------------------------------------
+ * @endcode
+ * where the `X` are unused bytes added for double padding, the `Y` are 
+ * unused bytes added for int4 padding, and `nruns` is the number of runs,
+ * which is located at the place of the first offset of a timestamp set
+ * stored explicitly. Since the latter is always 0, the header of the timestamp
+ * sets stored explicitly is unchanged.
+ *
+ * @param[in] runs Array of runs, whose position of the first timestamp is
+ * set by the function
+ * @param[in] nruns Number of runs in the array
+ * @param[in] count Number of timestamps in the runs
+ */
+static TimestampSet *
+timestampset_make_encoded(TimestampRun *runs, int nruns, int count)
+{
+  size_t memsize = double_pad(sizeof(TimestampSet) + sizeof(size_t)) +
+    sizeof(TimestampRun) * nruns + double_pad(sizeof(Period));
+  TimestampSet *result = palloc0(memsize);
+  SET_VARSIZE(result, memsize);
+  result->count = count;
+  timestampset_offsets_ptr(result)[0] = (size_t) nruns;
+  int first = 0;
+  for (int i = 0; i < nruns; i++)
+  {
+    runs[i].first = first;
+    first += runs[i].count;
+  }
+  memcpy(timestampset_runs_ptr(result), runs, sizeof(TimestampRun) * nruns);
+  /* Precompute the bounding box */
+  const TimestampRun *last = &runs[nruns - 1];
+  period_set(timestampset_bbox(result), runs[0].start,
+    last->start + (last->count - 1) * last->step, true, true);
+  return result;
+}
+
 /**
  * Construct a timestamp set from an array of timestamps 
  * 
@@ -83,6 +216,11 @@ timestampset_bbox(const TimestampSet *ts)
  * offsets for the corresponding timestamps, and `offset_3` is the offset 
  * for the bounding box which is a period.
  *
+ * When the timestamps are made of long runs of equally spaced timestamps,
+ * for example, a regular grid, the timestamp set is encoded by its runs,
+ * each one storing its first timestamp, its step, and its number of
+ * timestamps.
+ *
  * @param[in] times Array of timestamps
  * @param[in] count Number of elements in the array
  */
@@ -98,10 +236,21 @@ timestampset_make_internal(const TimestampTz *times, int count)
         errmsg("Invalid value for timestamp set")));
   }
 
+  int nruns = timestamparr_runs(NULL, times, count);
+  if (nruns * TIMESTAMPSET_RUN_MIN_LENGTH <= count)
+  {
+    TimestampRun *runs = palloc(sizeof(TimestampRun) * nruns);
+    timestamparr_runs(runs, times, count);
+    TimestampSet *result = timestampset_make_encoded(runs, nruns, count);
+    pfree(runs);
+    return result;
+  }
+
   size_t memsize = double_pad(sizeof(TimestampTz) * count + double_pad(sizeof(Period)));
   /* Array of pointers containing the pointers to the component timestamps,
      and a pointer to the bbox */
-  size_t pdata = double_pad(sizeof(TimestampSet) + (count + 1) * sizeof(size_t));
+  size_t pdata = double_pad(sizeof(TimestampSet) +
+    (count + 1) * sizeof(size_t));
   /* Create the TimestampSet */
   TimestampSet *result = palloc0(pdata + memsize);
   SET_VARSIZE(result, pdata + memsize);
@@ -142,6 +291,37 @@ timestampset_make_free(TimestampTz *times, int count)
   return result;
 }
 
+/**
+ * Construct a timestamp set from an array of ordered and disjoint runs
+ *
+ * The result is encoded unless the runs are too short, in which case the
+ * timestamps are stored explicitly.
+ *
+ * @param[in] runs Array of runs
+ * @param[in] count Number of elements in the array
+ * @result Timestamp set or NULL if the runs are empty
+ */
+TimestampSet *
+timestampset_make_runs(TimestampRun *runs, int count)
+{
+  int total = 0;
+  for (int i = 0; i < count; i++)
+    total += runs[i].count;
+  if (total == 0)
+    return NULL;
+  if (count * TIMESTAMPSET_RUN_MIN_LENGTH <= total)
+    return timestampset_make_encoded(runs, count, total);
+
+  TimestampTz *times = palloc(sizeof(TimestampTz) * total);
+  int k = 0;
+  for (int i = 0; i < count; i++)
+  {
+    for (int j = 0; j < runs[i].count; j++)
+      times[k++] = runs[i].start + j * runs[i].step;
+  }
+  return timestampset_make_free(times, total);
+}
+
 /**
  * Returns a copy of the timestamp set
  */
@@ -153,9 +333,103 @@ timestampset_copy(const TimestampSet *ts)
   return result;
 }
 
+/**
+ * Returns the positions of the first and the last timestamps of the run
+ * that are contained in the period
+ *
+ * The positions are computed arithmetically from the step of the run.
+ *
+ * @param[in] run Run
+ * @param[in] p Period
+ * @param[out] first,last Positions in the run
+ * @result Returns false if no timestamp of the run is contained in the period
+ */
+bool
+timestamprun_find_period(const TimestampRun *run, const Period *p,
+  int *first, int *last)
+{
+  TimestampTz end = run->start + (run->count - 1) * run->step;
+  if (p->upper < run->start || (p->upper == run->start && ! p->upper_inc) ||
+    p->lower > end || (p->lower == end && ! p->lower_inc))
+    return false;
+  /* Run composed of a single timestamp */
+  if (run->count == 1)
+  {
+    *first = *last = 0;
+    return true;
+  }
+  int64 offset;
+  int a, b;
+  if (p->lower < run->start)
+    a = 0;
+  else
+  {
+    offset = p->lower - run->start;
+    a = (int) (offset / run->step);
+    if (offset % run->step != 0 || ! p->lower_inc)
+      a++;
+  }
+  if (p->upper > end)
+    b = run->count - 1;
+  else
+  {
+    offset = p->upper - run->start;
+    b = (int) (offset / run->step);
+    if (offset % run->step == 0 && ! p->upper_inc)
+      b--;
+  }
+  if (a > b)
+    return false;
+  *first = a;
+  *last = b;
+  return true;
+}
+
+/**
+ * Returns the location of the timestamp in the encoded timestamp set value
+ */
+static bool 
+timestampset_runs_find_timestamp(const TimestampSet *ts, TimestampTz t,
+  int *loc)
+{
+  /* Find the last run starting at or before the timestamp */
+  const TimestampRun *runs = timestampset_runs_ptr(ts);
+  int first = 0, last = timestampset_num_runs(ts) - 1;
+  if (t < runs[0].start)
+  {
+    *loc = 0;
+    return false;
+  }
+  while (first < last)
+  {
+    int middle = (first + last + 1) / 2;
+    if (runs[middle].start <= t)
+      first = middle;
+    else
+      last = middle - 1;
+  }
+  const TimestampRun *run = &runs[first];
+  int64 offset = t - run->start;
+  if (offset == 0)
+  {
+    *loc = run->first;
+    return true;
+  }
+  if (run->count == 1 || offset > (run->count - 1) * run->step)
+  {
+    *loc = run->first + run->count;
+    return false;
+  }
+  *loc = run->first + (int) (offset / run->step);
+  if (offset % run->step == 0)
+    return true;
+  (*loc)++;
+  return false;
+}
+
 /**
  * Returns the location of the timestamp in the timestamp set value
- * using binary search
+ * using interpolation search with a fallback to binary search
  *
  * If the timestamp is found, the index of the timestamp is returned
  * in the output parameter. Otherwise, return a number encoding whether it 
@@ -180,27 +454,38 @@ timestampset_copy(const TimestampSet *ts)
 bool 
 timestampset_find_timestamp(const TimestampSet *ts, TimestampTz t, int *loc)
 {
+  if (timestampset_num_runs(ts) > 0)
+    return timestampset_runs_find_timestamp(ts, t, loc);
   int first = 0;
   int last = ts->count - 1;
-  int middle = 0; /* make compiler quiet */
+  /* Approximate time span of the timestamps first to last */
+  TimestampTz t1 = timestampset_time_n(ts, first);
+  TimestampTz t2 = timestampset_time_n(ts, last);
+  int probes = 0;
   while (first <= last) 
   {
-    middle = (first + last)/2;
-    TimestampTz t1 = timestampset_time_n(ts, middle);
-    int cmp = timestamp_cmp_internal(t, t1);
+    int middle = (probes++ < INTERPOLATION_MAX_PROBES) ?
+      interpolation_probe(first, last, t1, t2, t) : (first + last)/2;
+    TimestampTz t3 = timestampset_time_n(ts, middle);
+    int cmp = timestamp_cmp_internal(t, t3);
     if (cmp == 0)
     {
       *loc = middle;
       return true;
     }
     if (cmp < 0)
+    {
       last = middle - 1;
+      t2 = t3;
+    }
     else
+    {
       first = middle + 1;
+      t1 = t3;
+    }
   }
-  if (middle == ts->count)
-    middle++;
-  *loc = middle;
+  /* The timestamp would be inserted before the element first */
+  *loc = first;
   return false;
 }
 
@@ -449,6 +734,18 @@ TimestampTz *
 timestampset_timestamps_internal(const TimestampSet *ts)
 {
   TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
+  int nruns = timestampset_num_runs(ts);
+  if (nruns > 0)
+  {
+    int k = 0;
+    for (int i = 0; i < nruns; i++)
+    {
+      const TimestampRun *run = timestampset_run_n(ts, i);
+      for (int j = 0; j < run->count; j++)
+        times[k++] = run->start + j * run->step;
+    }
+    return times;
+  }
   for (int i = 0; i < ts->count; i++) 
     times[i] = timestampset_time_n(ts, i);
   return times;
@@ -475,6 +772,20 @@ timestampset_timestamps(PG_FUNCTION_ARGS)
 TimestampSet *
 timestampset_shift_internal(const TimestampSet *ts, const Interval *interval)
 {
+  /* An interval without months and days shifts every run by the same
+   * amount and thus keeps the encoding */
+  int nruns = timestampset_num_runs(ts);
+  if (nruns > 0 && interval->month == 0 && interval->day == 0)
+  {
+    TimestampSet *result = timestampset_copy(ts);
+    TimestampRun *runs = timestampset_runs_ptr(result);
+    for (int i = 0; i < nruns; i++)
+      runs[i].start += interval->time;
+    Period *p = timestampset_bbox(result);
+    period_set(p, p->lower + interval->time, p->upper + interval->time,
+      true, true);
+    return result;
+  }
   TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
   for (int i = 0; i < ts->count; i++)
   {
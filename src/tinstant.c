@@ -13,8 +13,13 @@
 #include "tinstant.h"
 
 #include <assert.h>
+#include <math.h>
+#include <access/hash.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
+#if MOBDB_PGSQL_VERSION >= 120000
+#include <utils/float.h>
+#endif
 #include <utils/timestamp.h>
 
 #include "timetypes.h"
@@ -546,7 +551,7 @@ tinstant_restrict_value(const TInstant *inst, Datum value, bool atfunc)
  * Returns true if the temporal value satisfies the restriction to the
  * (complement of the) array of base values
  *
- * @pre There are no duplicates values in the array
+ * @pre The array is sorted and there are no duplicates values in it
  * @note This function is called for each composing instant in a temporal
  * instant set.
  */
@@ -555,12 +560,18 @@ tinstant_restrict_values_test(const TInstant *inst, const Datum *values,
   int count, bool atfunc)
 {
   Datum value = tinstant_value(inst);
-  for (int i = 0; i < count; i++)
+  /* Points are not ordered in a way compatible with their equality */
+  if (tgeo_base_type(inst->valuetypid))
   {
-    if (datum_eq(value, values[i], inst->valuetypid))
-      return atfunc ? true : false;
+    for (int i = 0; i < count; i++)
+    {
+      if (datum_eq(value, values[i], inst->valuetypid))
+        return atfunc ? true : false;
+    }
+    return atfunc ? false : true;
   }
-  return atfunc ? false : true;
+  bool found = datumarr_contains(values, count, value, inst->valuetypid);
+  return atfunc ? found : ! found;
 }
 
 /**
@@ -852,38 +863,169 @@ tinstant_cmp(const TInstant *inst1, const TInstant *inst2)
  * the lower and upper bounds.
  *****************************************************************************/
 
+/**
+ * Returns the hash value of a timestamp, which is identical to the one
+ * computed by the function hashint8 but avoids to call it through the
+ * function manager
+ */
+static uint32
+timestamp_hash(TimestampTz t)
+{
+  int64 val = (int64) t;
+  uint32 lohalf = (uint32) val;
+  uint32 hihalf = (uint32) (val >> 32);
+  lohalf ^= (val >= 0) ? hihalf : ~hihalf;
+  return DatumGetUInt32(hash_uint32(lohalf));
+}
+
+/**
+ * Returns the hash value of a float, which is identical to the one computed
+ * by the function hashfloat8, in particular for zero and NaN values
+ */
+static uint32
+float8_hash(double d)
+{
+  /* Minus zero and zero must give the same hash value */
+  if (d == (float8) 0)
+    return 0;
+  /* All NaNs must give the same hash value */
+  if (isnan(d))
+    d = get_float8_nan();
+  return DatumGetUInt32(hash_any((unsigned char *) &d, sizeof(d)));
+}
+
+/**
+ * Returns the hash value of the value of the temporal instant
+ */
+static uint32
+tinstant_value_hash(const TInstant *inst)
+{
+  Datum value = tinstant_value(inst);
+  uint32 result = 0;
+  /* Apply the hash function according to the subtype */
+  switch (inst->valuetypid)
+  {
+    case BOOLOID:
+      result = DatumGetUInt32(hash_uint32((int32) DatumGetBool(value)));
+      break;
+    case INT4OID:
+      result = DatumGetUInt32(hash_uint32(DatumGetInt32(value)));
+      break;
+    case FLOAT8OID:
+      result = float8_hash(DatumGetFloat8(value));
+      break;
+    case TEXTOID:
+      /* The default collation is deterministic */
+      result = DatumGetUInt32(hash_any(
+        (unsigned char *) VARDATA_ANY(DatumGetPointer(value)),
+        VARSIZE_ANY_EXHDR(DatumGetPointer(value))));
+      break;
+    default:
+      if (tgeo_base_type(inst->valuetypid))
+        result = DatumGetUInt32(call_function1(lwgeom_hash, value));
+      else
+        ensure_temporal_base_type(inst->valuetypid);
+  }
+  return result;
+}
+
 /**
  * Returns the hash value of the temporal value
+ *
+ * The hash functions of the base types and of the timestamps are computed
+ * directly instead of being called through the function manager.
  */
 uint32
 tinstant_hash(const TInstant *inst)
 {
   uint32 result;
-  uint32 time_hash;
+  uint32 value_hash = tinstant_value_hash(inst);
+  uint32 time_hash = timestamp_hash(inst->t);
+
+  /* Merge hashes of value and timestamp */
+  result = value_hash;
+  result = (result << 1) | (result >> 31);
+  result ^= time_hash;
+
+  return result;
+}
 
+#if MOBDB_PGSQL_VERSION >= 110000
+/**
+ * Returns the 64-bit hash value of the value of the temporal instant
+ * using a seed
+ */
+static uint64
+tinstant_value_hash_extended(const TInstant *inst, uint64 seed)
+{
   Datum value = tinstant_value(inst);
+  uint64 result = 0;
+  double d;
   /* Apply the hash function according to the subtype */
-  uint32 value_hash = 0;
-  ensure_temporal_base_type(inst->valuetypid);
-  if (inst->valuetypid == BOOLOID)
-    value_hash = DatumGetUInt32(call_function1(hashchar, value));
-  else if (inst->valuetypid == INT4OID)
-    value_hash = DatumGetUInt32(call_function1(hashint4, value));
-  else if (inst->valuetypid == FLOAT8OID)
-    value_hash = DatumGetUInt32(call_function1(hashfloat8, value));
-  else if (inst->valuetypid == TEXTOID)
-    value_hash = DatumGetUInt32(call_function1(hashtext, value));
-  else if (tgeo_base_type(inst->valuetypid))
-    value_hash = DatumGetUInt32(call_function1(lwgeom_hash, value));
-  /* Apply the hash function according to the timestamp */
-  time_hash = DatumGetUInt32(call_function1(hashint8, TimestampTzGetDatum(inst->t)));
+  switch (inst->valuetypid)
+  {
+    case BOOLOID:
+      result = DatumGetUInt64(hash_uint32_extended(
+        (int32) DatumGetBool(value), seed));
+      break;
+    case INT4OID:
+      result = DatumGetUInt64(hash_uint32_extended(
+        DatumGetInt32(value), seed));
+      break;
+    case FLOAT8OID:
+      /* Same approach as in the function hashfloat8extended */
+      d = DatumGetFloat8(value);
+      if (d == (float8) 0)
+        return seed;
+      if (isnan(d))
+        d = get_float8_nan();
+      result = DatumGetUInt64(hash_any_extended((unsigned char *) &d,
+        sizeof(d), seed));
+      break;
+    case TEXTOID:
+      /* The default collation is deterministic */
+      result = DatumGetUInt64(hash_any_extended(
+        (unsigned char *) VARDATA_ANY(DatumGetPointer(value)),
+        VARSIZE_ANY_EXHDR(DatumGetPointer(value)), seed));
+      break;
+    default:
+      if (tgeo_base_type(inst->valuetypid))
+      {
+        /* There is no extended hash function for geometries, the result is
+         * derived from lwgeom_hash so that its low 32 bits with a zero seed
+         * are those of tinstant_value_hash */
+        uint32 hash = DatumGetUInt32(call_function1(lwgeom_hash, value));
+        result = DatumGetUInt64(hash_uint32_extended(hash, seed)) ^
+          (uint64) (DatumGetUInt32(hash_uint32(hash)) ^ hash);
+      }
+      else
+        ensure_temporal_base_type(inst->valuetypid);
+  }
+  return result;
+}
+
+/**
+ * Returns the 64-bit hash value of the temporal value using a seed
+ */
+uint64
+tinstant_hash_extended(const TInstant *inst, uint64 seed)
+{
+  uint64 result;
+  uint64 value_hash = tinstant_value_hash_extended(inst, seed);
+  /* Same approach as in the function hashint8extended */
+  int64 val = (int64) inst->t;
+  uint32 lohalf = (uint32) val;
+  uint32 hihalf = (uint32) (val >> 32);
+  lohalf ^= (val >= 0) ? hihalf : ~hihalf;
+  uint64 time_hash = DatumGetUInt64(hash_uint32_extended(lohalf, seed));
 
   /* Merge hashes of value and timestamp */
   result = value_hash;
-  result = (result << 1) | (result >> 31);
+  result = ROTATE_HIGH_AND_LOW_32BITS(result);
   result ^= time_hash;
 
   return result;
 }
+#endif
 
 /*****************************************************************************/
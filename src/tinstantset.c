@@ -13,6 +13,7 @@
 #include "tinstantset.h"
 
 #include <assert.h>
+#include <lib/binaryheap.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
 #include <utils/lsyscache.h>
@@ -36,25 +37,68 @@
  * General functions
  *****************************************************************************/
 
+/**
+ * Returns a pointer to the array of offsets of the temporal value
+ *
+ * In the original format, that is, for values without the version flag,
+ * the offsets follow the fixed-size part of the struct.
+ */
+static void *
+tinstantset_offsets_ptr(const TInstantSet *ti)
+{
+  if (! MOBDB_FLAGS_GET_VERSION(ti->flags))
+    return ((char *)ti) + double_pad(sizeof(TInstantSet));
+  return (((char *)ti) + double_pad(sizeof(TInstantSet)) +
+    double_pad(temporal_bbox_size(ti->valuetypid)));
+}
+
+/**
+ * Returns a pointer to the first instant of the temporal value
+ */
+static char *
+tinstantset_data_ptr(const TInstantSet *ti)
+{
+  /* In the original format the offset array has an additional element
+   * keeping the offset of the bounding box */
+  if (! MOBDB_FLAGS_GET_VERSION(ti->flags))
+    return (char *)(tinstantset_offsets_ptr(ti)) +
+      sizeof(size_t) * (ti->count + 1);
+  /* Instants of base types passed by value have a fixed size and thus
+   * there is no offset array */
+  if (MOBDB_FLAGS_GET_BYVAL(ti->flags))
+    return (char *)(tinstantset_offsets_ptr(ti));
+  return (char *)(tinstantset_offsets_ptr(ti)) +
+    double_pad(TEMPORAL_OFFSET_SIZE(ti->flags) * ti->count);
+}
+
 /**
  * Returns the n-th instant of the temporal value
  */
 TInstant *
 tinstantset_inst_n(const TInstantSet *ti, int index)
 {
-  return (TInstant *) (
-    (char *)(&ti->offsets[ti->count + 1]) +   /* start of data */
-      ti->offsets[index]);          /* offset */
+  if (MOBDB_FLAGS_GET_VERSION(ti->flags) && MOBDB_FLAGS_GET_BYVAL(ti->flags))
+    return (TInstant *)(tinstantset_data_ptr(ti) +
+      index * TINSTANT_BYVAL_SIZE);
+  size_t offset = temporal_offset_get(tinstantset_offsets_ptr(ti),
+    ti->flags, index);
+  return (TInstant *)(tinstantset_data_ptr(ti) + offset);
 }
 
 /**
  * Returns a pointer to the precomputed bounding box of the temporal value
+ *
+ * The bounding box is located immediately after the fixed-size part of the
+ * struct so that it can be read by fetching only a prefix of the value.
+ * In the original format it is located after the instants.
  */
 void *
 tinstantset_bbox_ptr(const TInstantSet *ti)
 {
-  return (char *)(&ti->offsets[ti->count + 1]) +  /* start of data */
-    ti->offsets[ti->count];            /* offset */
+  if (! MOBDB_FLAGS_GET_VERSION(ti->flags))
+    return tinstantset_data_ptr(ti) +
+      temporal_offset_get(tinstantset_offsets_ptr(ti), ti->flags, ti->count);
+  return ((char *)ti) + double_pad(sizeof(TInstantSet));
 }
 
 /**
@@ -89,13 +133,16 @@ tinstantset_make1(TInstant **instants, int count)
 {
   /* Get the bounding box size */
   size_t bboxsize = temporal_bbox_size(instants[0]->valuetypid);
-  size_t memsize = double_pad(bboxsize);
   /* Add the size of composing instants */
+  size_t memsize = 0;
   for (int i = 0; i < count; i++)
     memsize += double_pad(VARSIZE(instants[i]));
-  /* Add the size of the struct and the offset array
-   * Notice that the first offset is already declared in the struct */
-  size_t pdata = double_pad(sizeof(TInstantSet) + count * sizeof(size_t));
+  /* Add the size of the struct, the bounding box, and the offset array,
+   * which is not needed for instants of a base type passed by value */
+  bool byval = MOBDB_FLAGS_GET_BYVAL(instants[0]->flags);
+  size_t pdata = double_pad(sizeof(TInstantSet)) + double_pad(bboxsize);
+  if (! byval)
+    pdata += double_pad(count * sizeof(uint32));
   /* Create the TInstantSet */
   TInstantSet *result = palloc0(pdata + memsize);
   SET_VARSIZE(result, pdata + memsize);
@@ -106,20 +153,13 @@ tinstantset_make1(TInstant **instants, int count)
     MOBDB_FLAGS_GET_LINEAR(instants[0]->flags));
   MOBDB_FLAGS_SET_X(result->flags, true);
   MOBDB_FLAGS_SET_T(result->flags, true);
+  MOBDB_FLAGS_SET_VERSION(result->flags, true);
+  MOBDB_FLAGS_SET_BYVAL(result->flags, byval);
   if (tgeo_base_type(instants[0]->valuetypid))
   {
     MOBDB_FLAGS_SET_Z(result->flags, MOBDB_FLAGS_GET_Z(instants[0]->flags));
     MOBDB_FLAGS_SET_GEODETIC(result->flags, MOBDB_FLAGS_GET_GEODETIC(instants[0]->flags));
   }
-  /* Initialization of the variable-length part */
-  size_t pos = 0;
-  for (int i = 0; i < count; i++)
-  {
-    memcpy(((char *)result) + pdata + pos, instants[i],
-      VARSIZE(instants[i]));
-    result->offsets[i] = pos;
-    pos += double_pad(VARSIZE(instants[i]));
-  }
   /*
    * Precompute the bounding box
    * Only external types have precomputed bounding box, internal types such
@@ -127,9 +167,19 @@ tinstantset_make1(TInstant **instants, int count)
    */
   if (bboxsize != 0)
   {
-    void *bbox = ((char *) result) + pdata + pos;
+    void *bbox = tinstantset_bbox_ptr(result);
     tinstantset_make_bbox(bbox, instants, count);
-    result->offsets[count] = pos;
+  }
+  /* Initialization of the variable-length part */
+  void *offsets = tinstantset_offsets_ptr(result);
+  size_t pos = 0;
+  for (int i = 0; i < count; i++)
+  {
+    memcpy(((char *)result) + pdata + pos, instants[i],
+      VARSIZE(instants[i]));
+    if (! byval)
+      temporal_offset_set(offsets, result->flags, i, pos);
+    pos += double_pad(VARSIZE(instants[i]));
   }
   return result;
 }
@@ -141,16 +191,17 @@ tinstantset_make1(TInstant **instants, int count)
  * For example, the memory structure of a temporal instant set value
  * with 2 instants is as follows
  * @code
- *  ------------------------------------------------------
- *  ( TInstantSet | offset_0 | offset_1 | offset_2 )_X | ...
- *  ------------------------------------------------------
- *  ----------------------------------------------------------
- *  ( TInstant_0 )_X | ( TInstant_1 )_X | ( bbox )_X |
- *  ----------------------------------------------------------
+ *  --------------------------------------------------------------
+ *  ( TInstantSet )_X | ( bbox )_X | ( offset_0 | offset_1 )_X | ...
+ *  --------------------------------------------------------------
+ *  ------------------------------------
+ *  ( TInstant_0 )_X | ( TInstant_1 )_X |
+ *  ------------------------------------
  * @endcode
- * where the `_X` are unused bytes added for double padding, `offset_0` and
- * `offset_1` are offsets for the corresponding instants, and `offset_2`
- * is the offset for the bounding box.
+ * where the `_X` are unused bytes added for double padding, and `offset_0`
+ * and `offset_1` are offsets for the corresponding instants. The bounding
+ * box is stored before the offsets so that it is located at a fixed
+ * position that only depends on the base type.
  *
  * @param[in] instants Array of instants
  * @param[in] count Number of elements in the array
@@ -245,11 +296,40 @@ tinstantset_merge(const TInstantSet *ti1, const TInstantSet *ti2)
   return tinstantset_merge_array((TInstantSet **) instsets, 2);
 }
 
+/**
+ * Structure keeping the position of the next instant of every value
+ * during the merge of an array of temporal instant set values
+ */
+typedef struct
+{
+  TInstantSet **instsets;    /**< values to merge */
+  int *pos;                  /**< position of the next instant of the values */
+} TInstantSetMergeState;
+
+/**
+ * Comparator of the values on the timestamp of their next instant, which
+ * is inverted since the binary heap of PostgreSQL keeps the largest
+ * element at the root
+ */
+static int
+tinstantset_merge_cmp(Datum a, Datum b, void *arg)
+{
+  TInstantSetMergeState *state = (TInstantSetMergeState *) arg;
+  int i = DatumGetInt32(a), j = DatumGetInt32(b);
+  TInstant *inst1 = tinstantset_inst_n(state->instsets[i], state->pos[i]);
+  TInstant *inst2 = tinstantset_inst_n(state->instsets[j], state->pos[j]);
+  return timestamp_cmp_internal(inst2->t, inst1->t);
+}
+
 /**
  * Merge the array of temporal instant values. The function does not assume
  * that the values in the array can be strictly ordered on time, i.e., the
  * intersection of the bounding boxes of two values may be a period.
- * For this reason two passes are necessary.
+ *
+ * Since the instants of each value are ordered, they are merged with a
+ * binary heap keeping the next instant of every value, which costs
+ * O(N log k) for k values with N instants in total. Duplicate instants are
+ * removed and validated in the same pass.
  *
  * @param[in] instsets Array of values
  * @param[in] count Number of elements in the array
@@ -267,34 +347,43 @@ tinstantset_merge_array(TInstantSet **instsets, int count)
     ensure_spatial_validity((Temporal *)instsets[i - 1], (Temporal *)instsets[i]);
     totalcount += instsets[i]->count;
   }
-  /* Collect the composing instants */
-  TInstant **instants = palloc0(sizeof(TInstant *) * totalcount);
-  int k = 0;
+  /* Merge the composing instants */
+  TInstant **instants = palloc(sizeof(TInstant *) * totalcount);
+  TInstantSetMergeState state;
+  state.instsets = instsets;
+  state.pos = palloc0(sizeof(int) * count);
+  binaryheap *heap = binaryheap_allocate(count, tinstantset_merge_cmp,
+    &state);
   for (int i = 0; i < count; i++)
+    binaryheap_add_unordered(heap, Int32GetDatum(i));
+  binaryheap_build(heap);
+  int k = 0;
+  while (! binaryheap_empty(heap))
   {
-    for (int j = 0; j < instsets[i]->count; j++)
-      instants[k++] = tinstantset_inst_n(instsets[i], j);
-  }
-  if (totalcount > 1)
-    tinstantarr_sort(instants, totalcount);
-  totalcount = tinstantarr_remove_duplicates(instants, totalcount);
-  /* Test the validity of the composing instants */
-  TInstant *inst1 = instants[0];
-  for (int i = 1; i < totalcount; i++)
-  {
-    TInstant *inst2 = instants[i];
-    if (inst1->t == inst2->t && ! datum_eq(tinstant_value(inst1),
-      tinstant_value(inst2), inst1->valuetypid))
+    int i = DatumGetInt32(binaryheap_first(heap));
+    TInstant *inst = tinstantset_inst_n(instsets[i], state.pos[i]);
+    if (k > 0 && instants[k - 1]->t == inst->t)
     {
-      char *t = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(inst1->t));
-      ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-        errmsg("The temporal values have different value at their common instant %s", t)));
+      if (! datum_eq(tinstant_value(instants[k - 1]), tinstant_value(inst),
+        inst->valuetypid))
+      {
+        char *t = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(inst->t));
+        ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+          errmsg("The temporal values have different value at their common instant %s", t)));
+      }
     }
-    inst1 = inst2;
+    else
+      instants[k++] = inst;
+    if (++state.pos[i] < instsets[i]->count)
+      binaryheap_replace_first(heap, Int32GetDatum(i));
+    else
+      binaryheap_remove_first(heap);
   }
+  binaryheap_free(heap);
+  pfree(state.pos);
   /* Create the result */
-  Temporal *result = (k == 1) ? (Temporal *) instants[0] :
-    (Temporal *) tinstantset_make(instants, totalcount);
+  Temporal *result = (k == 1) ? (Temporal *) tinstant_copy(instants[0]) :
+    (Temporal *) tinstantset_make(instants, k);
   pfree(instants);
   return result;
 }
@@ -833,12 +922,23 @@ tinstantset_shift_tscale(const TInstantSet *ti, const Interval *start,
   inst->t = p2.lower;
   if (ti->count > 1)
   {
-    /* Shift and/or scale from the second to the penultimate instant */
-    for (int i = 1; i < ti->count - 1; i++)
+    /* Shift and/or scale from the second to the penultimate instant.
+     * When the duration is kept, which is the case when the value is only
+     * shifted, all timestamps are moved by the same delta */
+    if (new_duration == orig_duration)
     {
-      TInstant *inst = tinstantset_inst_n(result, i);
-      double fraction = (double) (inst->t - p1.lower) / orig_duration;
-      inst->t = (TimestampTz) ((long) p2.lower + (long) (new_duration * fraction));
+      TimestampTz delta = p2.lower - p1.lower;
+      for (int i = 1; i < ti->count - 1; i++)
+        tinstantset_inst_n(result, i)->t += delta;
+    }
+    else
+    {
+      for (int i = 1; i < ti->count - 1; i++)
+      {
+        TInstant *inst = tinstantset_inst_n(result, i);
+        double fraction = (double) (inst->t - p1.lower) / orig_duration;
+        inst->t = (TimestampTz) ((long) p2.lower + (long) (new_duration * fraction));
+      }
     }
     /* Set the last instant */
     TInstant *inst = tinstantset_inst_n(result, ti->count - 1);
@@ -1477,7 +1577,7 @@ tinstantset_eq(const TInstantSet *ti1, const TInstantSet *ti2)
 {
   assert(ti1->valuetypid == ti2->valuetypid);
   /* If number of sequences or flags are not equal */
-  if (ti1->count != ti2->count || ti1->flags != ti2->flags)
+  if (ti1->count != ti2->count || MOBDB_FLAGS_LOGICAL(ti1->flags) != MOBDB_FLAGS_LOGICAL(ti2->flags))
     return false;
 
   /* If bounding boxes are not equal */
@@ -1547,10 +1647,17 @@ tinstantset_cmp(const TInstantSet *ti1, const TInstantSet *ti2)
 
 /**
  * Returns the hash value of the temporal value
+ *
+ * @note Since a temporal instant set is equal to a temporal instant if it
+ * has a single instant, and to a temporal sequence set composed of
+ * instantaneous sequences with the same instants, the hash values are
+ * computed in a way that is consistent with these equalities
  */
 uint32
 tinstantset_hash(const TInstantSet *ti)
 {
+  if (ti->count == 1)
+    return tinstant_hash(tinstantset_inst_n(ti, 0));
   uint32 result = 1;
   for (int i = 0; i < ti->count; i++)
   {
@@ -1561,4 +1668,24 @@ tinstantset_hash(const TInstantSet *ti)
   return result;
 }
 
+#if MOBDB_PGSQL_VERSION >= 110000
+/**
+ * Returns the 64-bit hash value of the temporal value using a seed
+ */
+uint64
+tinstantset_hash_extended(const TInstantSet *ti, uint64 seed)
+{
+  if (ti->count == 1)
+    return tinstant_hash_extended(tinstantset_inst_n(ti, 0), seed);
+  uint64 result = 1;
+  for (int i = 0; i < ti->count; i++)
+  {
+    TInstant *inst = tinstantset_inst_n(ti, i);
+    uint64 inst_hash = tinstant_hash_extended(inst, seed);
+    result = (result << 5) - result + inst_hash;
+  }
+  return result;
+}
+#endif
+
 /*****************************************************************************/
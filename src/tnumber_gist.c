@@ -17,10 +17,18 @@
 #include <float.h>
 #include <math.h>
 #include <access/gist.h>
+#include <access/brin_internal.h>
+#include <access/brin_tuple.h>
 #include <utils/builtins.h>
+#include <utils/datum.h>
+#include <utils/sortsupport.h>
 
 #if MOBDB_PGSQL_VERSION >= 120000
 #include <utils/float.h>
+#include <utils/typcache.h>
+#endif
+#if MOBDB_PGSQL_VERSION >= 130000
+#include <access/reloptions.h>
 #endif
 
 #include "rangetypes_ext.h"
@@ -28,6 +36,9 @@
 #include "timeops.h"
 #include "time_gist.h"
 #include "oidcache.h"
+#include "indexesstat.h"
+#include "mobdb_probes.h"
+#include "temporal_util.h"
 #include "temporal_boxops.h"
 #include "temporal_posops.h"
 
@@ -234,11 +245,14 @@ tnumber_gist_consistent(PG_FUNCTION_ARGS)
   else
     elog(ERROR, "unrecognized strategy number: %d", strategy);
 
+  TRACE_MOBILITYDB_GIST_CONSISTENT_START(GIST_STAT_TBOX, strategy);
   if (GIST_LEAF(entry))
     result = tbox_index_consistent_leaf(key, &query, strategy);
   else
     result = tbox_gist_consistent_internal(key, &query, strategy);
+  TRACE_MOBILITYDB_GIST_CONSISTENT_DONE(GIST_STAT_TBOX, result);
 
+  gist_consistent_count(GIST_STAT_TBOX, GIST_LEAF(entry), result, *recheck);
   PG_RETURN_BOOL(result);
 }
 
@@ -246,6 +260,16 @@ tnumber_gist_consistent(PG_FUNCTION_ARGS)
  * GiST union method
  *****************************************************************************/
 
+/**
+ * Returns true if the value coordinates of the box are not NaN, in which
+ * case the box can be compared with the inline comparisons
+ */
+static inline bool
+tbox_nonan(const TBOX *box)
+{
+  return ! isnan(box->xmin) && ! isnan(box->xmax);
+}
+
 /**
  * Increase the first box to include the second one
  *
@@ -255,14 +279,59 @@ tnumber_gist_consistent(PG_FUNCTION_ARGS)
 static void
 tbox_adjust(TBOX *b, const TBOX *addon)
 {
-  if (FLOAT8_LT(b->xmax, addon->xmax))
-    b->xmax = addon->xmax;
-  if (FLOAT8_GT(b->xmin, addon->xmin))
-    b->xmin = addon->xmin;
-  if (FLOAT8_LT(b->tmax, addon->tmax))
-    b->tmax = addon->tmax;
-  if (FLOAT8_GT(b->tmin, addon->tmin))
-    b->tmin = addon->tmin;
+  if (tbox_nonan(b) && tbox_nonan(addon))
+  {
+    b->xmax = FAST_MAX(b->xmax, addon->xmax);
+    b->xmin = FAST_MIN(b->xmin, addon->xmin);
+  }
+  else
+  {
+    if (FLOAT8_LT(b->xmax, addon->xmax))
+      b->xmax = addon->xmax;
+    if (FLOAT8_GT(b->xmin, addon->xmin))
+      b->xmin = addon->xmin;
+  }
+  b->tmax = FAST_MAX(b->tmax, addon->tmax);
+  b->tmin = FAST_MIN(b->tmin, addon->tmin);
+  return;
+}
+
+/**
+ * Returns in the first box the union of the boxes of the entries of the
+ * vector from the first to the last offset (inclusive)
+ *
+ * The extrema are accumulated by a branch-free loop that also detects the
+ * NaN coordinates, in which case the union is computed again with the
+ * NaN-aware comparisons.
+ */
+static void
+tbox_union_vector(TBOX *result, const GistEntryVector *entryvec,
+  OffsetNumber first, OffsetNumber last)
+{
+  const TBOX *box = DatumGetTboxP(entryvec->vector[first].key);
+  *result = *box;
+  double xmin = box->xmin, xmax = box->xmax;
+  TimestampTz tmin = box->tmin, tmax = box->tmax;
+  bool hasnan = ! tbox_nonan(box);
+  for (OffsetNumber i = first + 1; i <= last; i++)
+  {
+    box = DatumGetTboxP(entryvec->vector[i].key);
+    xmin = FAST_MIN(xmin, box->xmin);
+    xmax = FAST_MAX(xmax, box->xmax);
+    tmin = FAST_MIN(tmin, box->tmin);
+    tmax = FAST_MAX(tmax, box->tmax);
+    hasnan |= isnan(box->xmin) | isnan(box->xmax);
+  }
+  if (hasnan)
+  {
+    for (OffsetNumber i = first + 1; i <= last; i++)
+      tbox_adjust(result, DatumGetTboxP(entryvec->vector[i].key));
+    return;
+  }
+  result->xmin = xmin;
+  result->xmax = xmax;
+  result->tmin = tmin;
+  result->tmax = tmax;
   return;
 }
 
@@ -277,17 +346,8 @@ tbox_gist_union(PG_FUNCTION_ARGS)
 {
   GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
   int *sizep = (int *) PG_GETARG_POINTER(1);
-  int numranges, i;
-  TBOX *cur, *pageunion;
-  numranges = entryvec->n;
-  pageunion = (TBOX *) palloc0(sizeof(TBOX));
-  cur = DatumGetTboxP(entryvec->vector[0].key);
-  memcpy((void *) pageunion, (void *) cur, sizeof(TBOX));
-  for (i = 1; i < numranges; i++)
-  {
-    cur = DatumGetTboxP(entryvec->vector[i].key);
-    tbox_adjust(pageunion, cur);
-  }
+  TBOX *pageunion = (TBOX *) palloc0(sizeof(TBOX));
+  tbox_union_vector(pageunion, entryvec, 0, (OffsetNumber) (entryvec->n - 1));
   *sizep = sizeof(TBOX);
   PG_RETURN_POINTER(pageunion);
 }
@@ -307,9 +367,8 @@ tnumber_gist_compress(PG_FUNCTION_ARGS)
   if (entry->leafkey)
   {
     GISTENTRY *retval = palloc(sizeof(GISTENTRY));
-    Temporal *temp = DatumGetTemporal(entry->key);
     TBOX *box = palloc0(sizeof(TBOX));
-    temporal_bbox(box, temp);
+    temporal_bbox_slice(box, entry->key);
     gistentryinit(*retval, PointerGetDatum(box),
       entry->rel, entry->page, entry->offset, false);
     PG_RETURN_POINTER(retval);
@@ -348,12 +407,29 @@ static void
 tbox_union_rt(TBOX *n, const TBOX *a, const TBOX *b)
 {
   n->xmax = FLOAT8_MAX(a->xmax, b->xmax);
-  n->tmax = FLOAT8_MAX(a->tmax, b->tmax);
+  n->tmax = FAST_MAX(a->tmax, b->tmax);
   n->xmin = FLOAT8_MIN(a->xmin, b->xmin);
-  n->tmin = FLOAT8_MIN(a->tmin, b->tmin);
+  n->tmin = FAST_MIN(a->tmin, b->tmin);
   return;
 }
 
+/**
+ * Returns the size of the union of two temporal boxes whose coordinates
+ * are not NaN, without constructing the union
+ */
+static inline double
+tbox_union_size_nonan(const TBOX *a, const TBOX *b)
+{
+  double xmin = FAST_MIN(a->xmin, b->xmin);
+  double xmax = FAST_MAX(a->xmax, b->xmax);
+  TimestampTz tmin = FAST_MIN(a->tmin, b->tmin);
+  TimestampTz tmax = FAST_MAX(a->tmax, b->tmax);
+  /* The same zero-width cases as in tbox_size */
+  if (xmax <= xmin || tmax <= tmin)
+    return 0.0;
+  return (xmax - xmin) * (tmax - tmin);
+}
+
 /**
  * Returns the size of a temporal box for penalty-calculation purposes.
  * The result can be +Infinity, but not NaN.
@@ -361,6 +437,9 @@ tbox_union_rt(TBOX *n, const TBOX *a, const TBOX *b)
 static double
 tbox_size(const TBOX *box)
 {
+  if (tbox_nonan(box))
+    return tbox_union_size_nonan(box, box);
+
   /*
    * Check for zero-width cases.  Note that we define the size of a zero-
    * by-infinity box as zero.  It's important to special-case this somehow,
@@ -369,7 +448,7 @@ tbox_size(const TBOX *box)
    * The less-than cases should not happen, but if they do, say "zero".
    */
   if (FLOAT8_LE(box->xmax, box->xmin) ||
-    FLOAT8_LE(box->tmax, box->tmin))
+    box->tmax <= box->tmin)
     return 0.0;
 
   /*
@@ -391,11 +470,39 @@ tbox_penalty(const TBOX *original, const TBOX *new)
 {
   TBOX unionbox;
 
+  if (tbox_nonan(original) && tbox_nonan(new))
+    return tbox_union_size_nonan(original, new) - tbox_size(original);
   memset(&unionbox, 0, sizeof(TBOX));
   tbox_union_rt(&unionbox, original, new);
   return tbox_size(&unionbox) - tbox_size(original);
 }
 
+/**
+ * Computes for the common entries of a split the delta between the
+ * penalties of adding them to the left and to the right box
+ *
+ * The sizes of the left and the right boxes are computed once for all the
+ * entries whose coordinates are not NaN.
+ */
+static void
+tbox_common_deltas(const TBOX *left, const TBOX *right,
+  const GistEntryVector *entryvec, CommonEntry *entries, int count)
+{
+  bool nonan = tbox_nonan(left) && tbox_nonan(right);
+  double leftsize = tbox_size(left), rightsize = tbox_size(right);
+  for (int i = 0; i < count; i++)
+  {
+    const TBOX *box = DatumGetTboxP(entryvec->vector[entries[i].index].key);
+    if (nonan && tbox_nonan(box))
+      entries[i].delta = Abs((tbox_union_size_nonan(left, box) - leftsize) -
+        (tbox_union_size_nonan(right, box) - rightsize));
+    else
+      entries[i].delta = Abs(tbox_penalty(left, box) -
+        tbox_penalty(right, box));
+  }
+  return;
+}
+
 PG_FUNCTION_INFO_V1(tbox_gist_penalty);
 /**
  * GiST penalty method for temporal boxes.
@@ -638,6 +745,325 @@ tbox_gist_consider_split(ConsiderSplitContext *context, int dimNum,
   }
 }
 
+/*****************************************************************************
+ * R*-tree split
+ *****************************************************************************/
+
+/**
+ * Minimum fraction of the entries in each group of an R*-tree split
+ */
+#define RSTAR_MIN_FILL 0.4
+
+/**
+ * Context for sorting the entries of an R*-tree split along a dimension
+ */
+typedef struct
+{
+  const double *bounds;  /**< normalized bounds of the entries */
+  int ndims;             /**< number of dimensions */
+  int dim;               /**< dimension of the sort */
+  bool upper;            /**< true when sorting by the upper bound */
+} RStarSortContext;
+
+#define RSTAR_LOW(bounds, ndims, i, d) ((bounds)[((i) * (ndims) + (d)) * 2])
+#define RSTAR_HIGH(bounds, ndims, i, d) ((bounds)[((i) * (ndims) + (d)) * 2 + 1])
+
+/**
+ * Compares two entries by their lower (resp. upper) bound along the
+ * dimension of the sort, and then by their upper (resp. lower) bound
+ */
+static int
+rstar_entry_cmp(const void *a, const void *b, void *arg)
+{
+  const RStarSortContext *ctx = (const RStarSortContext *) arg;
+  int i1 = *(const int *) a, i2 = *(const int *) b;
+  double k1 = RSTAR_LOW(ctx->bounds, ctx->ndims, i1, ctx->dim),
+    k2 = RSTAR_LOW(ctx->bounds, ctx->ndims, i2, ctx->dim),
+    l1 = RSTAR_HIGH(ctx->bounds, ctx->ndims, i1, ctx->dim),
+    l2 = RSTAR_HIGH(ctx->bounds, ctx->ndims, i2, ctx->dim);
+  if (ctx->upper)
+  {
+    double tmp = k1; k1 = l1; l1 = tmp;
+    tmp = k2; k2 = l2; l2 = tmp;
+  }
+  if (k1 != k2)
+    return (k1 < k2) ? -1 : 1;
+  if (l1 != l2)
+    return (l1 < l2) ? -1 : 1;
+  return 0;
+}
+
+/**
+ * Computes the bounding boxes of the prefixes (resp. suffixes) of the
+ * sorted entries. Element k of the result is the box of the first (resp.
+ * last) k + 1 entries.
+ */
+static void
+rstar_cumulative_boxes(double *result, const double *bounds, int ndims,
+  const int *order, int nentries, bool suffix)
+{
+  for (int k = 0; k < nentries; k++)
+  {
+    int i = suffix ? order[nentries - 1 - k] : order[k];
+    for (int d = 0; d < ndims; d++)
+    {
+      double low = RSTAR_LOW(bounds, ndims, i, d),
+        high = RSTAR_HIGH(bounds, ndims, i, d);
+      if (k > 0)
+      {
+        low = Min(low, RSTAR_LOW(result, ndims, k - 1, d));
+        high = Max(high, RSTAR_HIGH(result, ndims, k - 1, d));
+      }
+      RSTAR_LOW(result, ndims, k, d) = low;
+      RSTAR_HIGH(result, ndims, k, d) = high;
+    }
+  }
+  return;
+}
+
+/**
+ * R*-tree split algorithm.
+ *
+ * The bounds of each dimension are first normalized by the extent of the
+ * union of the entries so that an elongated dimension, typically time, does
+ * not dominate the others, and the dimensions where all the entries have
+ * the same value are ignored. The split axis is the one minimizing the sum
+ * of the margins of the groups for all the distributions of the entries
+ * sorted along it. Along this axis, the distribution minimizing the overlap
+ * of the groups is chosen, ties being broken by the volume and then by the
+ * margin of the groups.
+ *
+ * For details see:
+ * "The R*-tree: an efficient and robust access method for points and
+ * rectangles", N. Beckmann, H.-P. Kriegel, R. Schneider, B. Seeger,
+ * SIGMOD 1990
+ *
+ * @param[inout] bounds Array of nentries * ndims pairs (min, max) with the
+ * bounds of each dimension of each entry, which are normalized in place
+ * @param[in] nentries Number of entries
+ * @param[in] ndims Number of dimensions
+ * @param[out] left Array of nentries booleans set to true for the entries
+ * that go to the left group
+ */
+void
+gist_rstar_split(double *bounds, int nentries, int ndims, bool *left)
+{
+  int *order = palloc(sizeof(int) * nentries);
+  double *prefix = palloc(sizeof(double) * nentries * ndims * 2);
+  double *suffix = palloc(sizeof(double) * nentries * ndims * 2);
+  bool *active = palloc(sizeof(bool) * ndims);
+  int minfill = Max(1, (int) (RSTAR_MIN_FILL * nentries));
+  int i, d, k, bestdim = -1, bestk = -1;
+  bool bestupper = false;
+  double bestmargin = DBL_MAX, bestoverlap = DBL_MAX, bestvolume = DBL_MAX;
+  RStarSortContext ctx;
+
+  if (nentries - 2 * minfill < 0)
+    minfill = nentries / 2;
+
+  /* Normalize the dimensions by the extent of the union of the entries */
+  for (d = 0; d < ndims; d++)
+  {
+    double low = RSTAR_LOW(bounds, ndims, 0, d),
+      high = RSTAR_HIGH(bounds, ndims, 0, d);
+    for (i = 1; i < nentries; i++)
+    {
+      low = Min(low, RSTAR_LOW(bounds, ndims, i, d));
+      high = Max(high, RSTAR_HIGH(bounds, ndims, i, d));
+    }
+    active[d] = isfinite(high - low) && high > low;
+    for (i = 0; i < nentries; i++)
+    {
+      if (active[d])
+      {
+        RSTAR_LOW(bounds, ndims, i, d) =
+          (RSTAR_LOW(bounds, ndims, i, d) - low) / (high - low);
+        RSTAR_HIGH(bounds, ndims, i, d) =
+          (RSTAR_HIGH(bounds, ndims, i, d) - low) / (high - low);
+      }
+      else
+        RSTAR_LOW(bounds, ndims, i, d) = RSTAR_HIGH(bounds, ndims, i, d) = 0;
+    }
+  }
+
+  ctx.bounds = bounds;
+  ctx.ndims = ndims;
+  for (i = 0; i < nentries; i++)
+    order[i] = i;
+
+  /* Choose the split axis as the one with the minimum sum of margins */
+  for (d = 0; d < ndims; d++)
+  {
+    double margin = 0;
+    if (! active[d])
+      continue;
+    ctx.dim = d;
+    for (int u = 0; u < 2; u++)
+    {
+      ctx.upper = (u == 1);
+      qsort_arg(order, nentries, sizeof(int), rstar_entry_cmp, &ctx);
+      rstar_cumulative_boxes(prefix, bounds, ndims, order, nentries, false);
+      rstar_cumulative_boxes(suffix, bounds, ndims, order, nentries, true);
+      for (k = minfill; k <= nentries - minfill; k++)
+        for (int e = 0; e < ndims; e++)
+          margin +=
+            RSTAR_HIGH(prefix, ndims, k - 1, e) - RSTAR_LOW(prefix, ndims, k - 1, e) +
+            RSTAR_HIGH(suffix, ndims, nentries - k - 1, e) -
+            RSTAR_LOW(suffix, ndims, nentries - k - 1, e);
+    }
+    if (margin < bestmargin)
+    {
+      bestmargin = margin;
+      bestdim = d;
+    }
+  }
+
+  /* All the entries are equal, split them in two halves */
+  if (bestdim < 0)
+  {
+    for (i = 0; i < nentries; i++)
+      left[i] = (i < nentries / 2);
+    pfree(order); pfree(prefix); pfree(suffix); pfree(active);
+    return;
+  }
+
+  /* Choose the distribution along the split axis */
+  ctx.dim = bestdim;
+  bestmargin = DBL_MAX;
+  for (int u = 0; u < 2; u++)
+  {
+    ctx.upper = (u == 1);
+    qsort_arg(order, nentries, sizeof(int), rstar_entry_cmp, &ctx);
+    rstar_cumulative_boxes(prefix, bounds, ndims, order, nentries, false);
+    rstar_cumulative_boxes(suffix, bounds, ndims, order, nentries, true);
+    for (k = minfill; k <= nentries - minfill; k++)
+    {
+      const double *lbox = &prefix[(k - 1) * ndims * 2],
+        *rbox = &suffix[(nentries - k - 1) * ndims * 2];
+      double overlap = 1, lvolume = 1, rvolume = 1, margin = 0;
+      for (int e = 0; e < ndims; e++)
+      {
+        double llen = RSTAR_HIGH(lbox, ndims, 0, e) - RSTAR_LOW(lbox, ndims, 0, e),
+          rlen = RSTAR_HIGH(rbox, ndims, 0, e) - RSTAR_LOW(rbox, ndims, 0, e),
+          olen = Min(RSTAR_HIGH(lbox, ndims, 0, e), RSTAR_HIGH(rbox, ndims, 0, e)) -
+            Max(RSTAR_LOW(lbox, ndims, 0, e), RSTAR_LOW(rbox, ndims, 0, e));
+        if (! active[e])
+          continue;
+        overlap *= Max(olen, 0);
+        lvolume *= llen;
+        rvolume *= rlen;
+        margin += llen + rlen;
+      }
+      if (overlap < bestoverlap ||
+        (overlap == bestoverlap && (lvolume + rvolume < bestvolume ||
+          (lvolume + rvolume == bestvolume && margin < bestmargin))))
+      {
+        bestoverlap = overlap;
+        bestvolume = lvolume + rvolume;
+        bestmargin = margin;
+        bestk = k;
+        bestupper = ctx.upper;
+      }
+    }
+  }
+
+  /* Sort again the entries according to the chosen distribution */
+  ctx.upper = bestupper;
+  qsort_arg(order, nentries, sizeof(int), rstar_entry_cmp, &ctx);
+  for (k = 0; k < nentries; k++)
+    left[order[k]] = (k < bestk);
+  pfree(order); pfree(prefix); pfree(suffix); pfree(active);
+  return;
+}
+
+#if MOBDB_PGSQL_VERSION >= 130000
+/**
+ * Values of the split parameter of the GiST operator classes for boxes
+ */
+static relopt_enum_elt_def box_gist_split_values[] =
+{
+  {"doublesort", BOX_GIST_SPLIT_DOUBLESORT},
+  {"rstar", BOX_GIST_SPLIT_RSTAR},
+  {(const char *) NULL}    /* list terminator */
+};
+
+PG_FUNCTION_INFO_V1(box_gist_options);
+/**
+ * GiST options method for temporal numbers and temporal points. The
+ * parameter split selects the split strategy of the index, that is, either
+ * the double sorting split (the default) or the R*-tree split.
+ */
+PGDLLEXPORT Datum
+box_gist_options(PG_FUNCTION_ARGS)
+{
+  local_relopts *relopts = (local_relopts *) PG_GETARG_POINTER(0);
+  init_local_reloptions(relopts, sizeof(BoxGistOptions));
+  add_local_enum_reloption(relopts, "split", "split strategy",
+    box_gist_split_values, BOX_GIST_SPLIT_DOUBLESORT,
+    "Valid values are \"doublesort\" and \"rstar\".",
+    offsetof(BoxGistOptions, split));
+  PG_RETURN_VOID();
+}
+#endif
+
+/**
+ * Returns the split strategy given by the parameters of the operator class
+ * of the GiST picksplit method
+ */
+int
+box_gist_split_strategy(FunctionCallInfo fcinfo)
+{
+#if MOBDB_PGSQL_VERSION >= 130000
+  if (PG_HAS_OPCLASS_OPTIONS())
+    return ((BoxGistOptions *) PG_GET_OPCLASS_OPTIONS())->split;
+#endif
+  return BOX_GIST_SPLIT_DOUBLESORT;
+}
+
+/**
+ * R*-tree split for temporal numbers
+ */
+static void
+tbox_gist_rstar_split(GistEntryVector *entryvec, GIST_SPLITVEC *v)
+{
+  OffsetNumber i, maxoff = (OffsetNumber) (entryvec->n - 1);
+  int nentries = maxoff - FirstOffsetNumber + 1, k;
+  double *bounds = palloc(sizeof(double) * nentries * 4);
+  bool *left = palloc(sizeof(bool) * nentries);
+  TBOX *leftBox = NULL, *rightBox = NULL;
+
+  for (i = FirstOffsetNumber, k = 0; i <= maxoff; i = OffsetNumberNext(i), k++)
+  {
+    TBOX *box = DatumGetTboxP(entryvec->vector[i].key);
+    bounds[k * 4] = box->xmin;
+    bounds[k * 4 + 1] = box->xmax;
+    bounds[k * 4 + 2] = (double) box->tmin;
+    bounds[k * 4 + 3] = (double) box->tmax;
+  }
+  gist_rstar_split(bounds, nentries, 2, left);
+
+  v->spl_left = (OffsetNumber *) palloc(nentries * sizeof(OffsetNumber));
+  v->spl_right = (OffsetNumber *) palloc(nentries * sizeof(OffsetNumber));
+  v->spl_nleft = v->spl_nright = 0;
+  for (i = FirstOffsetNumber, k = 0; i <= maxoff; i = OffsetNumberNext(i), k++)
+  {
+    TBOX *box = DatumGetTboxP(entryvec->vector[i].key);
+    TBOX **groupBox = left[k] ? &leftBox : &rightBox;
+    if (*groupBox == NULL)
+      *groupBox = tbox_copy(box);
+    else
+      tbox_adjust(*groupBox, box);
+    if (left[k])
+      v->spl_left[v->spl_nleft++] = i;
+    else
+      v->spl_right[v->spl_nright++] = i;
+  }
+  v->spl_ldatum = PointerGetDatum(leftBox);
+  v->spl_rdatum = PointerGetDatum(rightBox);
+  pfree(bounds); pfree(left);
+  return;
+}
+
 /**
  * Double sorting split algorithm.
  *
@@ -685,6 +1111,15 @@ tbox_gist_picksplit(PG_FUNCTION_ARGS)
   CommonEntry *commonEntries;
   int      nentries;
 
+  TRACE_MOBILITYDB_GIST_PICKSPLIT_START(GIST_STAT_TBOX, entryvec->n - 1);
+  if (box_gist_split_strategy(fcinfo) == BOX_GIST_SPLIT_RSTAR)
+  {
+    tbox_gist_rstar_split(entryvec, v);
+    TRACE_MOBILITYDB_GIST_PICKSPLIT_DONE(GIST_STAT_TBOX, v->spl_nleft,
+      v->spl_nright);
+    PG_RETURN_POINTER(v);
+  }
+
   memset(&context, 0, sizeof(ConsiderSplitContext));
 
   maxoff = (OffsetNumber) (entryvec->n - 1);
@@ -697,14 +1132,8 @@ tbox_gist_picksplit(PG_FUNCTION_ARGS)
   /*
    * Calculate the overall minimum bounding box over all the entries.
    */
-  for (i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext(i))
-  {
-    box = DatumGetTboxP(entryvec->vector[i].key);
-    if (i == FirstOffsetNumber)
-      context.boundingBox = *box;
-    else
-      tbox_adjust(&context.boundingBox, box);
-  }
+  tbox_union_vector(&context.boundingBox, entryvec, FirstOffsetNumber,
+    maxoff);
 
   /*
    * Iterate over axes for optimal split searching.
@@ -856,6 +1285,8 @@ tbox_gist_picksplit(PG_FUNCTION_ARGS)
   if (context.first)
   {
     tbox_gist_fallback_split(entryvec, v);
+    TRACE_MOBILITYDB_GIST_PICKSPLIT_DONE(GIST_STAT_TBOX, v->spl_nleft,
+      v->spl_nright);
     PG_RETURN_POINTER(v);
   }
 
@@ -970,12 +1401,8 @@ tbox_gist_picksplit(PG_FUNCTION_ARGS)
      * Calculate delta between penalties of join "common entries" to
      * different groups.
      */
-    for (i = 0; i < commonEntriesCount; i++)
-    {
-      box = DatumGetTboxP(entryvec->vector[commonEntries[i].index].key);
-      commonEntries[i].delta = Abs(tbox_penalty(leftBox, box) -
-                     tbox_penalty(rightBox, box));
-    }
+    tbox_common_deltas(leftBox, rightBox, entryvec, commonEntries,
+      commonEntriesCount);
 
     /*
      * Sort "common entries" by calculated deltas in order to distribute
@@ -1011,6 +1438,8 @@ tbox_gist_picksplit(PG_FUNCTION_ARGS)
 
   v->spl_ldatum = PointerGetDatum(leftBox);
   v->spl_rdatum = PointerGetDatum(rightBox);
+  TRACE_MOBILITYDB_GIST_PICKSPLIT_DONE(GIST_STAT_TBOX, v->spl_nleft,
+    v->spl_nright);
   PG_RETURN_POINTER(v);
 }
 
@@ -1042,6 +1471,23 @@ tbox_gist_same(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * GiST fetch method
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(tbox_gist_fetch);
+/**
+ * GiST fetch method for temporal boxes. Since the keys of the index are
+ * the boxes themselves, they are returned unchanged, which enables
+ * index-only scans.
+ */
+PGDLLEXPORT Datum
+tbox_gist_fetch(PG_FUNCTION_ARGS)
+{
+  GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  PG_RETURN_POINTER(entry);
+}
+
 /*****************************************************************************
  * GiST distance method
  *****************************************************************************/
@@ -1159,4 +1605,187 @@ tbox_gist_distance(PG_FUNCTION_ARGS)
   PG_RETURN_FLOAT8(distance);
 }
 
+
+#if MOBDB_PGSQL_VERSION >= 140000
+/*****************************************************************************
+ * GiST sortsupport method
+ *****************************************************************************/
+
+/**
+ * Compares the centers of two temporal boxes along a Z-order curve
+ */
+static int
+tbox_gist_cmp_zorder(Datum a, Datum b, SortSupport ssup)
+{
+  const TBOX *box1 = DatumGetTboxP(a);
+  const TBOX *box2 = DatumGetTboxP(b);
+  uint64 keys1[2], keys2[2];
+  keys1[0] = double_zorder_key(box1->xmin / 2.0 + box1->xmax / 2.0);
+  /* Halving the bounds avoids overflows with infinite timestamps */
+  keys1[1] = timestamp_zorder_key((box1->tmin >> 1) + (box1->tmax >> 1));
+  keys2[0] = double_zorder_key(box2->xmin / 2.0 + box2->xmax / 2.0);
+  keys2[1] = timestamp_zorder_key((box2->tmin >> 1) + (box2->tmax >> 1));
+  return zorder_cmp(keys1, keys2, 2);
+}
+
+PG_FUNCTION_INFO_V1(tbox_gist_sortsupport);
+/**
+ * GiST sortsupport method for temporal numbers. It is used for building
+ * the index by sorting the boxes along a Z-order curve instead of inserting
+ * them one by one.
+ */
+PGDLLEXPORT Datum
+tbox_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+  SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+  ssup->comparator = tbox_gist_cmp_zorder;
+  PG_RETURN_VOID();
+}
+#endif
+
+/*****************************************************************************
+ * BRIN methods
+ *
+ * The summary of a block range is the union of the bounding boxes of its
+ * values. Since this union plays the same role as the key of an internal
+ * node of a GiST index, the consistent method reuses the GiST internal-page
+ * consistency.
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(tbox_brin_opcinfo);
+/**
+ * BRIN opcinfo method for temporal numbers and temporal boxes
+ */
+PGDLLEXPORT Datum
+tbox_brin_opcinfo(PG_FUNCTION_ARGS)
+{
+  BrinOpcInfo *result = palloc0(MAXALIGN(SizeofBrinOpcInfo(1)));
+  result->oi_nstored = 1;
+  result->oi_typcache[0] = lookup_type_cache(type_oid(T_TBOX), 0);
+  PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tbox_brin_add_value);
+/**
+ * BRIN add value method for temporal numbers and temporal boxes
+ */
+PGDLLEXPORT Datum
+tbox_brin_add_value(PG_FUNCTION_ARGS)
+{
+  BrinDesc *bdesc = (BrinDesc *) PG_GETARG_POINTER(0);
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  Datum newval = PG_GETARG_DATUM(2);
+  bool isnull = PG_GETARG_BOOL(3);
+  Oid typid = TupleDescAttr(bdesc->bd_tupdesc, column->bv_attno - 1)->atttypid;
+  TBOX box, *unionbox;
+
+  if (isnull)
+  {
+    if (column->bv_hasnulls)
+      PG_RETURN_BOOL(false);
+    column->bv_hasnulls = true;
+    PG_RETURN_BOOL(true);
+  }
+
+  memset(&box, 0, sizeof(TBOX));
+  if (typid == type_oid(T_TBOX))
+    box = *DatumGetTboxP(newval);
+  else
+    temporal_bbox_slice(&box, newval);
+
+  if (column->bv_allnulls)
+  {
+    column->bv_values[0] = datumCopy(PointerGetDatum(&box), false,
+      sizeof(TBOX));
+    column->bv_allnulls = false;
+    PG_RETURN_BOOL(true);
+  }
+  unionbox = DatumGetTboxP(column->bv_values[0]);
+  if (contains_tbox_tbox_internal(unionbox, &box))
+    PG_RETURN_BOOL(false);
+  tbox_adjust(unionbox, &box);
+  PG_RETURN_BOOL(true);
+}
+
+PG_FUNCTION_INFO_V1(tbox_brin_consistent);
+/**
+ * BRIN consistent method for temporal numbers and temporal boxes
+ */
+PGDLLEXPORT Datum
+tbox_brin_consistent(PG_FUNCTION_ARGS)
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  ScanKey key = (ScanKey) PG_GETARG_POINTER(2);
+  Oid subtype = key->sk_subtype;
+  TBOX query;
+
+  /* Handle IS NULL/IS NOT NULL tests */
+  if (key->sk_flags & SK_ISNULL)
+  {
+    if (key->sk_flags & SK_SEARCHNULL)
+      PG_RETURN_BOOL(column->bv_allnulls || column->bv_hasnulls);
+    if (key->sk_flags & SK_SEARCHNOTNULL)
+      PG_RETURN_BOOL(! column->bv_allnulls);
+    /* Neither IS NULL nor IS NOT NULL was used, the operators are strict */
+    PG_RETURN_BOOL(false);
+  }
+
+  /* If the block range contains only nulls, it cannot contain any match */
+  if (column->bv_allnulls)
+    PG_RETURN_BOOL(false);
+
+  /*
+   * Transform the query into a box setting which are the dimensions that
+   * must be taken into account by the operators.
+   */
+  memset(&query, 0, sizeof(TBOX));
+  if (tnumber_range_type(subtype))
+  {
+#if MOBDB_PGSQL_VERSION < 110000
+    RangeType *range = DatumGetRangeType(key->sk_argument);
+#else
+    RangeType *range = DatumGetRangeTypeP(key->sk_argument);
+#endif
+    /* Return false on empty range */
+    if (range_get_flags(range) & RANGE_EMPTY)
+      PG_RETURN_BOOL(false);
+    range_to_tbox_internal(&query, range);
+  }
+  else if (subtype == type_oid(T_TBOX))
+    query = *DatumGetTboxP(key->sk_argument);
+  else if (tnumber_type(subtype))
+    temporal_bbox(&query, DatumGetTemporal(key->sk_argument));
+  else
+    elog(ERROR, "Unsupported subtype for indexing: %d", subtype);
+
+  PG_RETURN_BOOL(tbox_gist_consistent_internal(
+    DatumGetTboxP(column->bv_values[0]), &query, key->sk_strategy));
+}
+
+PG_FUNCTION_INFO_V1(tbox_brin_union);
+/**
+ * BRIN union method for temporal numbers and temporal boxes
+ */
+PGDLLEXPORT Datum
+tbox_brin_union(PG_FUNCTION_ARGS)
+{
+  BrinValues *col_a = (BrinValues *) PG_GETARG_POINTER(1);
+  BrinValues *col_b = (BrinValues *) PG_GETARG_POINTER(2);
+
+  if (col_b->bv_hasnulls)
+    col_a->bv_hasnulls = true;
+  if (col_b->bv_allnulls)
+    PG_RETURN_VOID();
+  if (col_a->bv_allnulls)
+  {
+    col_a->bv_values[0] = datumCopy(col_b->bv_values[0], false,
+      sizeof(TBOX));
+    col_a->bv_allnulls = false;
+    PG_RETURN_VOID();
+  }
+  tbox_adjust(DatumGetTboxP(col_a->bv_values[0]),
+    DatumGetTboxP(col_b->bv_values[0]));
+  PG_RETURN_VOID();
+}
+
 /*****************************************************************************/
@@ -197,6 +197,15 @@ arithop_tnumber_base1(FunctionCallInfo fcinfo,
     }
   }
 
+  /* Apply the operator directly to the values of a temporal float when the
+   * result does not need to be normalized */
+  if (temp->valuetypid == FLOAT8OID && (oper != DIV || ! invert))
+  {
+    double d = datum_double(value, valuetypid);
+    if (oper != MULT || d != 0.0)
+      return tfunc_tfloat_arithop_base(temp, d, oper, invert);
+  }
+
   Oid temptypid = get_fn_expr_rettype(fcinfo->flinfo);
   LiftedFunctionInfo lfinfo;
   lfinfo.func = (varfunc) func;
@@ -269,16 +278,20 @@ arithop_tnumber_tnumber(FunctionCallInfo fcinfo,
   bool linear2 = MOBDB_FLAGS_GET_LINEAR(temp2->flags);
 
   /* If division test whether the denominator will ever be zero during
-   * the common timespan */
-  if (oper == DIV)
+   * the common timespan. The denominator is only restricted to the time
+   * of the numerator when it is ever zero, which is first tested on the
+   * whole value with the help of its bounding box */
+  if (oper == DIV && temporal_ever_eq_internal(temp2, Float8GetDatum(0.0)))
   {
     PeriodSet *ps = temporal_get_time_internal(temp1);
     Temporal *projtemp2 = temporal_restrict_periodset_internal(temp2, ps, REST_AT);
+    pfree(ps);
     if (projtemp2 == NULL)
       PG_RETURN_NULL();
     if (temporal_ever_eq_internal(projtemp2, Float8GetDatum(0.0)))
       ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
         errmsg("Division by zero")));
+    pfree(projtemp2);
   }
 
   Oid temptypid = get_fn_expr_rettype(fcinfo->flinfo);
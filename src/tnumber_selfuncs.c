@@ -21,6 +21,7 @@
 #include <catalog/pg_collation_d.h>
 #endif
 #include <utils/builtins.h>
+#include <utils/lsyscache.h>
 #if MOBDB_PGSQL_VERSION >= 120000
 #include <utils/float.h>
 #endif
@@ -973,14 +974,427 @@ tnumber_sel(PG_FUNCTION_ARGS)
   PG_RETURN_FLOAT8(selec);
 }
 
+/**
+ * Returns the base type of the values of a join argument, or InvalidOid
+ * if there are no statistics on the values of the argument
+ */
+static Oid
+tnumber_join_valuetypid(Oid typid)
+{
+  if (tnumber_type(typid))
+    return base_oid_from_temporal(typid);
+  if (typid == type_oid(T_INTRANGE))
+    return INT4OID;
+  if (typid == type_oid(T_FLOATRANGE))
+    return FLOAT8OID;
+  return InvalidOid;
+}
+
+/**
+ * Calculate the join selectivity of a range operator between two columns
+ * using their histograms of range bounds.
+ *
+ * As for the time dimension, the ranges of the histogram of the second
+ * column are used as a sample of this column and the selectivity is the
+ * average of their selectivity with respect to the first column.
+ */
+static double
+calc_hist_joinselectivity(TypeCacheEntry *typcache,
+  VariableStatData *vardata1, VariableStatData *vardata2, Oid operator)
+{
+  AttStatsSlot hslot;
+  double selec = 0.0;
+
+  if (!(HeapTupleIsValid(vardata2->statsTuple) &&
+      get_attstatsslot(&hslot, vardata2->statsTuple,
+               STATISTIC_KIND_BOUNDS_HISTOGRAM, InvalidOid,
+               ATTSTATSSLOT_VALUES)))
+    return -1.0;
+
+  for (int i = 0; i < hslot.nvalues; i++)
+  {
+#if MOBDB_PGSQL_VERSION < 110000
+    RangeType *range = DatumGetRangeType(hslot.values[i]);
+#else
+    RangeType *range = DatumGetRangeTypeP(hslot.values[i]);
+#endif
+    double hist_selec = calc_hist_selectivity(typcache, vardata1, range,
+      operator);
+    if (hist_selec < 0.0)
+    {
+      free_attstatsslot(&hslot);
+      return -1.0;
+    }
+    selec += hist_selec;
+  }
+  selec = (hslot.nvalues > 0) ? selec / hslot.nvalues : -1.0;
+  free_attstatsslot(&hslot);
+  return selec;
+}
+
 PG_FUNCTION_INFO_V1(tnumber_joinsel);
 /**
  * Estimate the join selectivity value of the operators for temporal numbers
+ *
+ * The selectivity of the value and time dimensions are computed from the
+ * histograms of range bounds and of period bounds of both columns, and are
+ * multiplied assuming that the dimensions are independent.
  */
 PGDLLEXPORT Datum
 tnumber_joinsel(PG_FUNCTION_ARGS)
 {
-  PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+  PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+  Oid operator = PG_GETARG_OID(1);
+  List *args = (List *) PG_GETARG_POINTER(2);
+  SpecialJoinInfo *sjinfo = (SpecialJoinInfo *) PG_GETARG_POINTER(4);
+  VariableStatData vardata1, vardata2;
+  bool join_is_reversed;
+  Selectivity selec, dimselec;
+  CachedOp cachedOp;
+
+  /*
+   * Get enumeration value associated to the operator
+   */
+  bool found = tnumber_cachedop(operator, &cachedOp);
+  /* In the case of unknown operator */
+  if (!found)
+    PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+
+  /* There is no ~= operator for range/time types and only joins between
+   * two binary operator arguments are estimated */
+  if (cachedOp == SAME_OP || list_length(args) != 2)
+    PG_RETURN_FLOAT8(default_tnumber_selectivity(cachedOp));
+
+  get_join_variables(root, args, sjinfo, &vardata1, &vardata2,
+    &join_is_reversed);
+
+  /* Enable the multiplication of the selectivity of the value and time
+   * dimensions since either may be missing */
+  selec = 1.0;
+
+  bool bboxop = (cachedOp == OVERLAPS_OP || cachedOp == CONTAINS_OP ||
+    cachedOp == CONTAINED_OP || cachedOp == LT_OP || cachedOp == LE_OP ||
+    cachedOp == GT_OP || cachedOp == GE_OP);
+  bool valueop = bboxop || cachedOp == LEFT_OP || cachedOp == RIGHT_OP ||
+    cachedOp == OVERLEFT_OP || cachedOp == OVERRIGHT_OP;
+  bool timeop = bboxop || cachedOp == BEFORE_OP || cachedOp == AFTER_OP ||
+    cachedOp == OVERBEFORE_OP || cachedOp == OVERAFTER_OP;
+  /* Unknown operator */
+  if (! valueop && ! timeop)
+    selec = -1.0;
+
+  /* Selectivity for the value dimension */
+  if (valueop)
+  {
+    Oid valuetypid = tnumber_join_valuetypid(vardata1.atttype);
+    Oid rangeop = tnumber_cachedop_rangeop(cachedOp);
+    dimselec = -1.0;
+    if (valuetypid != InvalidOid && rangeop != InvalidOid &&
+      valuetypid == tnumber_join_valuetypid(vardata2.atttype))
+    {
+      TypeCacheEntry *typcache = lookup_type_cache(
+        range_oid_from_base(valuetypid), TYPECACHE_RANGE_INFO);
+      dimselec = calc_hist_joinselectivity(typcache, &vardata1, &vardata2,
+        rangeop);
+    }
+    selec = (dimselec < 0.0) ? -1.0 : selec * dimselec;
+  }
+  /* Selectivity for the time dimension */
+  if (timeop && selec >= 0.0)
+  {
+    dimselec = calc_period_hist_joinselectivity(&vardata1, &vardata2,
+      cachedOp);
+    selec = (dimselec < 0.0) ? -1.0 : selec * dimselec;
+  }
+  if (selec < 0.0)
+    selec = default_tnumber_selectivity(cachedOp);
+
+  ReleaseVariableStats(vardata1);
+  ReleaseVariableStats(vardata2);
+  CLAMP_PROBABILITY(selec);
+  PG_RETURN_FLOAT8(selec);
+}
+
+/*****************************************************************************
+ * Selectivity of ever/always comparison operators
+ *****************************************************************************/
+
+/**
+ * Returns the fraction of the ranges of a histogram of range lengths whose
+ * length is zero, that is, the fraction of temporal numbers that are
+ * constant
+ */
+static double
+calc_length_hist_zero_fraction(VariableStatData *vardata)
+{
+  AttStatsSlot lslot;
+  int i;
+  double frac;
+
+  if (!(HeapTupleIsValid(vardata->statsTuple) &&
+      get_attstatsslot(&lslot, vardata->statsTuple,
+               STATISTIC_KIND_RANGE_LENGTH_HISTOGRAM, InvalidOid,
+               ATTSTATSSLOT_VALUES)))
+    return -1.0;
+
+  /* check that it's a histogram, not just a dummy entry */
+  if (lslot.nvalues < 2)
+  {
+    free_attstatsslot(&lslot);
+    return -1.0;
+  }
+  for (i = 0; i < lslot.nvalues; i++)
+    if (DatumGetFloat8(lslot.values[i]) > 0.0)
+      break;
+  frac = (i == 0) ? 0.0 : (double) (i - 1) / (double) (lslot.nvalues - 1);
+  free_attstatsslot(&lslot);
+  return frac;
+}
+
+/**
+ * Calculate the selectivity of an ever/always comparison between a column
+ * of temporal numbers and a constant value.
+ *
+ * The lower and upper bounds of the histogram of value ranges are the
+ * histograms of the minimum and the maximum values of the temporal numbers.
+ * A temporal number ever satisfies a comparison with a constant if its
+ * minimum (for < and <=) or its maximum (for > and >=) satisfies it, and
+ * always satisfies it if its maximum (for < and <=) or its minimum (for >
+ * and >=) satisfies it. A temporal number is ever equal to a constant if
+ * the constant is between its minimum and its maximum values, which is
+ * exact for temporal floats with linear interpolation and an upper bound
+ * otherwise, and it is always equal to a constant if in addition its
+ * minimum and maximum values are equal.
+ *
+ * @param[in] typcache Information about the range type of the values
+ * @param[in] vardata Statistics of the temporal column
+ * @param[in] value Constant value
+ * @param[in] ever True for the ever operators, false for the always ones
+ * @param[in] cachedOp Comparison operator
+ */
+static double
+calc_hist_selectivity_ever(TypeCacheEntry *typcache,
+  VariableStatData *vardata, Datum value, bool ever, CachedOp cachedOp)
+{
+  AttStatsSlot hslot;
+  int nhist;
+  RangeBound *hist_lower, *hist_upper;
+  RangeBound constbound;
+  bool empty;
+  double lt_lower, le_lower, lt_upper, le_upper, frac, selec;
+
+  /* Can't use the histogram with insecure range support functions */
+  if (!statistic_proc_security_check(vardata,
+                     typcache->rng_cmp_proc_finfo.fn_oid))
+    return -1.0;
+  if (OidIsValid(typcache->rng_subdiff_finfo.fn_oid) &&
+    !statistic_proc_security_check(vardata,
+                     typcache->rng_subdiff_finfo.fn_oid))
+    return -1.0;
+
+  /* Try to get histogram of ranges */
+  if (!(HeapTupleIsValid(vardata->statsTuple) &&
+      get_attstatsslot(&hslot, vardata->statsTuple,
+               STATISTIC_KIND_BOUNDS_HISTOGRAM, InvalidOid,
+               ATTSTATSSLOT_VALUES)))
+    return -1.0;
+
+  /* Split the histogram into the histograms of minimum and maximum values */
+  nhist = hslot.nvalues;
+  if (nhist < 2)
+  {
+    free_attstatsslot(&hslot);
+    return -1.0;
+  }
+  hist_lower = (RangeBound *) palloc(sizeof(RangeBound) * nhist);
+  hist_upper = (RangeBound *) palloc(sizeof(RangeBound) * nhist);
+  for (int i = 0; i < nhist; i++)
+  {
+#if MOBDB_PGSQL_VERSION < 110000
+    range_deserialize(typcache, DatumGetRangeType(hslot.values[i]),
+              &hist_lower[i], &hist_upper[i], &empty);
+#else
+    range_deserialize(typcache, DatumGetRangeTypeP(hslot.values[i]),
+              &hist_lower[i], &hist_upper[i], &empty);
+#endif
+    /* The histogram should not contain any empty ranges */
+    if (empty)
+      elog(ERROR, "bounds histogram contains an empty range");
+  }
+
+  /* The bounds of the histogram are inclusive and so is the constant */
+  constbound.val = value;
+  constbound.infinite = false;
+  constbound.inclusive = true;
+  constbound.lower = true;
+
+  /* Fractions of minimum and maximum values less than (or equal) value */
+  lt_lower = calc_hist_selectivity_scalar(typcache, &constbound,
+    hist_lower, nhist, false);
+  le_lower = calc_hist_selectivity_scalar(typcache, &constbound,
+    hist_lower, nhist, true);
+  lt_upper = calc_hist_selectivity_scalar(typcache, &constbound,
+    hist_upper, nhist, false);
+  le_upper = calc_hist_selectivity_scalar(typcache, &constbound,
+    hist_upper, nhist, true);
+
+  switch (cachedOp)
+  {
+    case LT_OP:
+      selec = ever ? lt_lower : lt_upper;
+      break;
+    case LE_OP:
+      selec = ever ? le_lower : le_upper;
+      break;
+    case GT_OP:
+      selec = ever ? 1.0 - le_upper : 1.0 - le_lower;
+      break;
+    case GE_OP:
+      selec = ever ? 1.0 - lt_upper : 1.0 - lt_lower;
+      break;
+    case EQ_OP:
+    case NE_OP:
+      /* min <= value <= max, the events max < value and min > value being
+       * mutually exclusive */
+      selec = 1.0 - lt_upper - (1.0 - le_lower);
+      CLAMP_PROBABILITY(selec);
+      /* always_eq additionally requires min = max. The negator of
+       * always_eq is ever_ne and the negator of ever_eq is always_ne */
+      if ((ever && cachedOp == NE_OP) || (!ever && cachedOp == EQ_OP))
+      {
+        frac = calc_length_hist_zero_fraction(vardata);
+        selec = (frac < 0.0) ? selec * DEFAULT_EQ_SEL : selec * frac;
+      }
+      if (cachedOp == NE_OP)
+        selec = 1.0 - selec;
+      break;
+    default:
+      selec = -1.0;
+      break;
+  }
+
+  pfree(hist_lower); pfree(hist_upper);
+  free_attstatsslot(&hslot);
+  return selec;
+}
+
+/**
+ * Returns a default selectivity estimate for the ever/always operators
+ * when we don't have statistics or cannot use them for some reason.
+ */
+static double
+default_tnumber_ever_selectivity(CachedOp cachedOp)
+{
+  if (cachedOp == EQ_OP)
+    return DEFAULT_EQ_SEL;
+  if (cachedOp == NE_OP)
+    return 1.0 - DEFAULT_EQ_SEL;
+  return DEFAULT_INEQ_SEL;
+}
+
+/**
+ * Get the ever/always flag and the comparison associated to an operator,
+ * whose name is the comparison prefixed by ? (ever) or % (always)
+ */
+static bool
+tnumber_ever_cachedop(Oid operator, bool *ever, CachedOp *cachedOp)
+{
+  char *opname = get_opname(operator);
+  bool result = true;
+
+  if (opname == NULL || (opname[0] != '?' && opname[0] != '%'))
+    result = false;
+  else
+  {
+    *ever = (opname[0] == '?');
+    if (strcmp(opname + 1, "=") == 0)
+      *cachedOp = EQ_OP;
+    else if (strcmp(opname + 1, "<>") == 0)
+      *cachedOp = NE_OP;
+    else if (strcmp(opname + 1, "<") == 0)
+      *cachedOp = LT_OP;
+    else if (strcmp(opname + 1, "<=") == 0)
+      *cachedOp = LE_OP;
+    else if (strcmp(opname + 1, ">") == 0)
+      *cachedOp = GT_OP;
+    else if (strcmp(opname + 1, ">=") == 0)
+      *cachedOp = GE_OP;
+    else
+      result = false;
+  }
+  if (opname != NULL)
+    pfree(opname);
+  return result;
+}
+
+PG_FUNCTION_INFO_V1(tnumber_ever_sel);
+/**
+ * Estimate the selectivity value of the ever/always comparison operators
+ * for temporal numbers
+ */
+PGDLLEXPORT Datum
+tnumber_ever_sel(PG_FUNCTION_ARGS)
+{
+  PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+  Oid operator = PG_GETARG_OID(1);
+  List *args = (List *) PG_GETARG_POINTER(2);
+  int varRelid = PG_GETARG_INT32(3);
+  VariableStatData vardata;
+  Node *other;
+  bool varonleft, ever;
+  Selectivity selec;
+  CachedOp cachedOp;
+  Oid valuetypid;
+
+  /*
+   * Get the comparison associated to the operator
+   */
+  if (!tnumber_ever_cachedop(operator, &ever, &cachedOp))
+    PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+
+  /*
+   * If expression is not (variable op something) or (something op
+   * variable), then punt and return a default estimate.
+   */
+  if (!get_restriction_variable(root, args, varRelid,
+                  &vardata, &other, &varonleft))
+    PG_RETURN_FLOAT8(default_tnumber_ever_selectivity(cachedOp));
+
+  /*
+   * Can't do anything useful if the something is not a constant or if the
+   * variable is not the temporal argument, since the operators have no
+   * commutator.
+   */
+  if (!IsA(other, Const) || !varonleft || !tnumber_type(vardata.atttype))
+  {
+    ReleaseVariableStats(vardata);
+    PG_RETURN_FLOAT8(default_tnumber_ever_selectivity(cachedOp));
+  }
+
+  /* The operators are strict */
+  if (((Const *) other)->constisnull)
+  {
+    ReleaseVariableStats(vardata);
+    PG_RETURN_FLOAT8(0.0);
+  }
+
+  valuetypid = base_oid_from_temporal(vardata.atttype);
+  if (((Const *) other)->consttype != valuetypid)
+  {
+    ReleaseVariableStats(vardata);
+    PG_RETURN_FLOAT8(default_tnumber_ever_selectivity(cachedOp));
+  }
+
+  TypeCacheEntry *typcache = lookup_type_cache(
+    range_oid_from_base(valuetypid), TYPECACHE_RANGE_INFO);
+  selec = calc_hist_selectivity_ever(typcache, &vardata,
+    ((Const *) other)->constvalue, ever, cachedOp);
+  if (selec < 0.0)
+    selec = default_tnumber_ever_selectivity(cachedOp);
+
+  ReleaseVariableStats(vardata);
+  CLAMP_PROBABILITY(selec);
+  PG_RETURN_FLOAT8(selec);
 }
 
 /*****************************************************************************/
@@ -545,8 +545,7 @@ tbox_spgist_inner_consistent(PG_FUNCTION_ARGS)
       memcpy(&queries[i], DatumGetTboxP(in->scankeys[i].sk_argument),
         sizeof(TBOX));
     else if (tnumber_type(subtype))
-      temporal_bbox(&queries[i],
-        DatumGetTemporal(in->scankeys[i].sk_argument));
+      temporal_bbox_slice(&queries[i], in->scankeys[i].sk_argument);
     else
       elog(ERROR, "Unrecognized subtype: %d", subtype);
   }
@@ -700,8 +699,7 @@ tbox_spgist_leaf_consistent(PG_FUNCTION_ARGS)
     }
     else if (tnumber_type(subtype))
     {
-      temporal_bbox(&query,
-        DatumGetTemporal(in->scankeys[i].sk_argument));
+      temporal_bbox_slice(&query, in->scankeys[i].sk_argument);
       res = tbox_index_consistent_leaf(key, &query, strategy);
     }
     else
@@ -736,10 +734,8 @@ PG_FUNCTION_INFO_V1(sptnumber_gist_compress);
 PGDLLEXPORT Datum
 sptnumber_gist_compress(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL(0);
   TBOX *box = palloc0(sizeof(TBOX));
-  temporal_bbox(box, temp);
-  PG_FREE_IF_COPY(temp, 0);
+  temporal_bbox_slice(box, PG_GETARG_DATUM(0));
   PG_RETURN_TBOX_P(box);
 }
 #endif
@@ -29,7 +29,10 @@
 #include "oidcache.h"
 #include "temporal_util.h"
 #include "temporal_boxops.h"
+#include "tbox.h"
 #include "rangetypes_ext.h"
+#include "funcstat.h"
+#include "mobdb_probes.h"
 
 #include "tpoint.h"
 #include "tpoint_boxops.h"
@@ -638,57 +641,166 @@ datum_collinear(Oid valuetypid, Datum value1, Datum value2, Datum value3,
  * @result Array of normalized temporal instant values
  * @pre The input array has at least two elements
  * @note The function does not create new instants, it creates an array of
- * pointers to a subset of the input instants
+ * pointers to a subset of the input instants. The array is only allocated
+ * when a redundant instant is found, otherwise the input array is returned.
  */
 static TInstant **
 tinstantarr_normalize(TInstant **instants, bool linear, int count,
   int *newcount)
 {
   assert(count > 1);
-  Oid valuetypid = instants[0]->valuetypid;
-  TInstant **result = palloc(sizeof(TInstant *) * count);
+  TInstant **result = NULL;
   /* Remove redundant instants */
   TInstant *inst1 = instants[0];
-  Datum value1 = tinstant_value(inst1);
   TInstant *inst2 = instants[1];
-  Datum value2 = tinstant_value(inst2);
-  result[0] = inst1;
   int k = 1;
   for (int i = 2; i < count; i++)
   {
     TInstant *inst3 = instants[i];
-    Datum value3 = tinstant_value(inst3);
-    if (
-      /* step sequences and 2 consecutive instants that have the same value
-        ... 1@t1, 1@t2, 2@t3, ... -> ... 1@t1, 2@t3, ...
-      */
-      (!linear && datum_eq(value1, value2, valuetypid))
-      ||
-      /* 3 consecutive linear instants that have the same value
-        ... 1@t1, 1@t2, 1@t3, ... -> ... 1@t1, 1@t3, ...
-      */
-      (linear && datum_eq(value1, value2, valuetypid) && datum_eq(value2, value3, valuetypid))
-      ||
-      /* collinear linear instants
-        ... 1@t1, 2@t2, 3@t3, ... -> ... 1@t1, 3@t3, ...
-      */
-      (linear && datum_collinear(valuetypid, value1, value2, value3, inst1->t, inst2->t, inst3->t))
-      )
+    if (tsequence_redundant_tinstant(inst1, inst2, inst3, linear))
     {
-      inst2 = inst3; value2 = value3;
+      /* The instants before the first redundant one are kept as is */
+      if (result == NULL)
+      {
+        result = palloc(sizeof(TInstant *) * count);
+        memcpy(result, instants, sizeof(TInstant *) * k);
+      }
+      inst2 = inst3;
     }
     else
     {
-      result[k++] = inst2;
-      inst1 = inst2; value1 = value2;
-      inst2 = inst3; value2 = value3;
+      if (result != NULL)
+        result[k] = inst2;
+      k++;
+      inst1 = inst2;
+      inst2 = inst3;
     }
   }
+  if (result == NULL)
+  {
+    *newcount = count;
+    return instants;
+  }
   result[k++] = inst2;
   *newcount = k;
   return result;
 }
 
+/**
+ * Determine whether two consecutive sequences can be joined
+ *
+ * @param[in] seq1,seq2 Input sequences
+ * @param[out] removelast,removefirst State whether the last instant of the
+ * first sequence and the first instant of the second sequence must be
+ * removed when joining the sequences
+ */
+static bool
+tsequence_join_test(const TSequence *seq1, const TSequence *seq2,
+  bool *removelast, bool *removefirst)
+{
+  Oid valuetypid = seq1->valuetypid;
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
+  bool adjacent = seq1->period.upper == seq2->period.lower &&
+    (seq1->period.upper_inc || seq2->period.lower_inc);
+  if (! adjacent)
+    return false;
+
+  TInstant *last2 = (seq1->count == 1) ? NULL :
+    tsequence_inst_n(seq1, seq1->count - 2);
+  Datum last2value = (seq1->count == 1) ? 0 :
+    tinstant_value(last2);
+  TInstant *last1 = tsequence_inst_n(seq1, seq1->count - 1);
+  Datum last1value = tinstant_value(last1);
+  TInstant *first1 = tsequence_inst_n(seq2, 0);
+  Datum first1value = tinstant_value(first1);
+  TInstant *first2 = (seq2->count == 1) ? NULL :
+    tsequence_inst_n(seq2, 1);
+  Datum first2value = (seq2->count == 1) ? 0 :
+    tinstant_value(first2);
+  /* If they are adjacent and not instantaneous */
+  if (last2 != NULL && first2 != NULL &&
+    (
+    /* If step and the last segment of the first sequence is constant
+       ..., 1@t1, 1@t2) [1@t2, 1@t3, ... -> ..., 1@t1, 2@t3, ...
+       ..., 1@t1, 1@t2) [1@t2, 2@t3, ... -> ..., 1@t1, 2@t3, ...
+       ..., 1@t1, 1@t2] (1@t2, 2@t3, ... -> ..., 1@t1, 2@t3, ...
+     */
+    (!linear &&
+    datum_eq(last2value, last1value, valuetypid) &&
+    datum_eq(last1value, first1value, valuetypid))
+    ||
+    /* If the last/first segments are constant and equal
+       ..., 1@t1, 1@t2] (1@t2, 1@t3, ... -> ..., 1@t1, 1@t3, ...
+     */
+    (datum_eq(last2value, last1value, valuetypid) &&
+    datum_eq(last1value, first1value, valuetypid) &&
+    datum_eq(first1value, first2value, valuetypid))
+    ||
+    /* If float/point sequences and collinear last/first segments having the same duration
+       ..., 1@t1, 2@t2) [2@t2, 3@t3, ... -> ..., 1@t1, 3@t3, ...
+    */
+    (datum_eq(last1value, first1value, valuetypid) &&
+    datum_collinear(valuetypid, last2value, first1value, first2value,
+      last2->t, first1->t, first2->t))
+    ))
+  {
+    /* Remove the last and first instants of the sequences */
+    *removelast = true;
+    *removefirst = true;
+    return true;
+  }
+  /* If step sequences and the first one has an exclusive upper bound,
+     by definition the first sequence has the last segment constant
+     ..., 1@t1, 1@t2) [2@t2, 3@t3, ... -> ..., 1@t1, 2@t2, 3@t3, ...
+     ..., 1@t1, 1@t2) [2@t2] -> ..., 1@t1, 2@t2]
+   */
+  if (!linear && !seq1->period.upper_inc)
+  {
+    /* Remove the last instant of the first sequence */
+    *removelast = true;
+    *removefirst = false;
+    return true;
+  }
+  /* If they are adjacent and have equal last/first value respectively
+    Stewise
+    ... 1@t1, 2@t2], (2@t2, 1@t3, ... -> ..., 1@t1, 2@t2, 1@t3, ...
+    [1@t1], (1@t1, 2@t2, ... -> ..., 1@t1, 2@t2
+    Linear
+    ..., 1@t1, 2@t2), [2@t2, 1@t3, ... -> ..., 1@t1, 2@t2, 1@t3, ...
+    ..., 1@t1, 2@t2], (2@t2, 1@t3, ... -> ..., 1@t1, 2@t2, 1@t3, ...
+    ..., 1@t1, 2@t2), [2@t2] -> ..., 1@t1, 2@t2]
+    [1@t1],(1@t1, 2@t2, ... -> [1@t1, 2@t2, ...
+  */
+  if (datum_eq(last1value, first1value, valuetypid))
+  {
+    /* Remove the first instant of the second sequence */
+    *removelast = false;
+    *removefirst = true;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Returns true if no two consecutive sequences of the array can be joined,
+ * that is, if the array is already normalized
+ *
+ * @param[in] sequences Array of input sequences
+ * @param[in] count Number of elements in the input array
+ */
+bool
+tsequencearr_normalized(TSequence **sequences, int count)
+{
+  bool removelast, removefirst;
+  for (int i = 1; i < count; i++)
+  {
+    if (tsequence_join_test(sequences[i - 1], sequences[i], &removelast,
+        &removefirst))
+      return false;
+  }
+  return true;
+}
+
 /**
  * Normalize the array of temporal sequence values
  *
@@ -704,7 +816,8 @@ tinstantarr_normalize(TInstant **instants, bool linear, int count,
  * @pre When merging sequences, the test whether the value is the same
  * at the common instant should be ensured by the calling function.
  * @note The function creates new sequences and does not free the original
- * sequences
+ * sequences. Use `tsequencearr_normalized` before calling the function to
+ * avoid the copies when the array is already normalized.
  */
 TSequence **
 tsequencearr_normalize(TSequence **sequences, int count, int *newcount)
@@ -712,83 +825,19 @@ tsequencearr_normalize(TSequence **sequences, int count, int *newcount)
   TSequence **result = palloc(sizeof(TSequence *) * count);
   /* seq1 is the sequence to which we try to join subsequent seq2 */
   TSequence *seq1 = sequences[0];
-  Oid valuetypid = seq1->valuetypid;
-  bool linear = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
   bool isnew = false;
   int k = 0;
   for (int i = 1; i < count; i++)
   {
     TSequence *seq2 = sequences[i];
-    TInstant *last2 = (seq1->count == 1) ? NULL :
-      tsequence_inst_n(seq1, seq1->count - 2);
-    Datum last2value = (seq1->count == 1) ? 0 :
-      tinstant_value(last2);
-    TInstant *last1 = tsequence_inst_n(seq1, seq1->count - 1);
-    Datum last1value = tinstant_value(last1);
-    TInstant *first1 = tsequence_inst_n(seq2, 0);
-    Datum first1value = tinstant_value(first1);
-    TInstant *first2 = (seq2->count == 1) ? NULL :
-      tsequence_inst_n(seq2, 1);
-    Datum first2value = (seq2->count == 1) ? 0 :
-      tinstant_value(first2);
-    bool adjacent = seq1->period.upper == seq2->period.lower &&
-      (seq1->period.upper_inc || seq2->period.lower_inc);
-    /* If they are adjacent and not instantaneous */
-    if (adjacent && last2 != NULL && first2 != NULL &&
-      (
-      /* If step and the last segment of the first sequence is constant
-         ..., 1@t1, 1@t2) [1@t2, 1@t3, ... -> ..., 1@t1, 2@t3, ...
-         ..., 1@t1, 1@t2) [1@t2, 2@t3, ... -> ..., 1@t1, 2@t3, ...
-         ..., 1@t1, 1@t2] (1@t2, 2@t3, ... -> ..., 1@t1, 2@t3, ...
-       */
-      (!linear &&
-      datum_eq(last2value, last1value, valuetypid) &&
-      datum_eq(last1value, first1value, valuetypid))
-      ||
-      /* If the last/first segments are constant and equal
-         ..., 1@t1, 1@t2] (1@t2, 1@t3, ... -> ..., 1@t1, 1@t3, ...
-       */
-      (datum_eq(last2value, last1value, valuetypid) &&
-      datum_eq(last1value, first1value, valuetypid) &&
-      datum_eq(first1value, first2value, valuetypid))
-      ||
-      /* If float/point sequences and collinear last/first segments having the same duration
-         ..., 1@t1, 2@t2) [2@t2, 3@t3, ... -> ..., 1@t1, 3@t3, ...
-      */
-      (datum_eq(last1value, first1value, valuetypid) &&
-      datum_collinear(valuetypid, last2value, first1value, first2value,
-        last2->t, first1->t, first2->t))
-      ))
-    {
-      /* Remove the last and first instants of the sequences */
-      seq1 = tsequence_join(seq1, seq2, true, true);
-      isnew = true;
-    }
-    /* If step sequences and the first one has an exclusive upper bound,
-       by definition the first sequence has the last segment constant
-       ..., 1@t1, 1@t2) [2@t2, 3@t3, ... -> ..., 1@t1, 2@t2, 3@t3, ...
-       ..., 1@t1, 1@t2) [2@t2] -> ..., 1@t1, 2@t2]
-     */
-    else if (adjacent && !linear && !seq1->period.upper_inc)
-    {
-      /* Remove the last instant of the first sequence */
-      seq1 = tsequence_join(seq1, seq2, true, false);
-      isnew = true;
-    }
-    /* If they are adjacent and have equal last/first value respectively
-      Stewise
-      ... 1@t1, 2@t2], (2@t2, 1@t3, ... -> ..., 1@t1, 2@t2, 1@t3, ...
-      [1@t1], (1@t1, 2@t2, ... -> ..., 1@t1, 2@t2
-      Linear
-      ..., 1@t1, 2@t2), [2@t2, 1@t3, ... -> ..., 1@t1, 2@t2, 1@t3, ...
-      ..., 1@t1, 2@t2], (2@t2, 1@t3, ... -> ..., 1@t1, 2@t2, 1@t3, ...
-      ..., 1@t1, 2@t2), [2@t2] -> ..., 1@t1, 2@t2]
-      [1@t1],(1@t1, 2@t2, ... -> [1@t1, 2@t2, ...
-    */
-    else if (adjacent && datum_eq(last1value, first1value, valuetypid))
+    bool removelast, removefirst;
+    if (tsequence_join_test(seq1, seq2, &removelast, &removefirst))
     {
-      /* Remove the first instant of the second sequence */
-      seq1 = tsequence_join(seq1, seq2, false, true);
+      TSequence *newseq1 = tsequence_join(seq1, seq2, removelast,
+        removefirst);
+      if (isnew)
+        pfree(seq1);
+      seq1 = newseq1;
       isnew = true;
     }
     else
@@ -805,25 +854,133 @@ tsequencearr_normalize(TSequence **sequences, int count, int *newcount)
 
 /*****************************************************************************/
 
+/**
+ * Returns a pointer to the array of offsets of the temporal value
+ *
+ * The array has one more element than the number of instants, which keeps
+ * the offset of the precomputed trajectory, if any. Sequences with
+ * simplification levels have an additional element keeping their offset.
+ */
+void *
+tsequence_offsets_ptr(const TSequence *seq)
+{
+  /* In the original format, that is, for values without the version flag,
+   * the offsets follow the fixed-size part of the struct */
+  if (! MOBDB_FLAGS_GET_VERSION(seq->flags))
+    return ((char *)seq) + double_pad(sizeof(TSequence));
+  return (((char *)seq) + double_pad(sizeof(TSequence)) +
+    double_pad(temporal_bbox_size(seq->valuetypid)));
+}
+
+/**
+ * Returns the number of elements of the array of offsets of the temporal
+ * value
+ */
+int
+tsequence_offsets_count(const TSequence *seq)
+{
+  /* In the original format the array keeps the offsets of the bounding box
+   * and of the trajectory */
+  if (! MOBDB_FLAGS_GET_VERSION(seq->flags))
+    return seq->count + 2;
+  return seq->count + (MOBDB_FLAGS_GET_LEVELS(seq->flags) ? 2 : 1);
+}
+
+/**
+ * Returns the number of blocks of the directory of the temporal value
+ *
+ * The block `i` covers the segments defined by the instants
+ * `i * TSEQUENCE_BLOCK_SIZE` to `(i + 1) * TSEQUENCE_BLOCK_SIZE`, so
+ * that the last instant of a block is the first instant of the next one.
+ *
+ * @return Returns 0 if the sequence does not have a block directory
+ */
+int
+tsequence_block_count(const TSequence *seq)
+{
+  if (! MOBDB_FLAGS_GET_BLOCKS(seq->flags))
+    return 0;
+  return (seq->count + TSEQUENCE_BLOCK_SIZE - 2) / TSEQUENCE_BLOCK_SIZE;
+}
+
+/**
+ * Returns the size in bytes of the block directory of a temporal sequence
+ */
+static size_t
+tsequence_blocks_size(Oid valuetypid, int nblocks)
+{
+  return nblocks * double_pad(temporal_bbox_size(valuetypid));
+}
+
+/**
+ * Returns a pointer to the block directory of the temporal value, which
+ * is located after the offset array
+ */
+static char *
+tsequence_blocks_ptr(const TSequence *seq)
+{
+  char *result = (char *)(tsequence_offsets_ptr(seq));
+  if (! MOBDB_FLAGS_GET_VERSION(seq->flags))
+    return result + sizeof(size_t) * tsequence_offsets_count(seq);
+  /* Instants of base types passed by value have a fixed size and such
+   * sequences do not have a precomputed trajectory, thus there is no
+   * offset array */
+  if (! MOBDB_FLAGS_GET_BYVAL(seq->flags))
+    result += double_pad(TEMPORAL_OFFSET_SIZE(seq->flags) *
+      tsequence_offsets_count(seq));
+  return result;
+}
+
+/**
+ * Returns a pointer to the bounding box of the n-th block of the temporal
+ * value
+ */
+void *
+tsequence_block_bbox_ptr(const TSequence *seq, int block)
+{
+  assert(MOBDB_FLAGS_GET_BLOCKS(seq->flags));
+  return tsequence_blocks_ptr(seq) +
+    block * double_pad(temporal_bbox_size(seq->valuetypid));
+}
+
+/**
+ * Returns a pointer to the first instant of the temporal value
+ */
+char *
+tsequence_data_ptr(const TSequence *seq)
+{
+  return tsequence_blocks_ptr(seq) +
+    tsequence_blocks_size(seq->valuetypid, tsequence_block_count(seq));
+}
+
 /**
  * Returns the n-th instant of the temporal value
  */
 TInstant *
 tsequence_inst_n(const TSequence *seq, int index)
 {
-  return (TInstant *)(
-    (char *)(&seq->offsets[seq->count + 2]) +   /* start of data */
-      seq->offsets[index]);          /* offset */
+  if (MOBDB_FLAGS_GET_VERSION(seq->flags) && MOBDB_FLAGS_GET_BYVAL(seq->flags))
+    return (TInstant *)(tsequence_data_ptr(seq) +
+      index * TINSTANT_BYVAL_SIZE);
+  size_t offset = temporal_offset_get(tsequence_offsets_ptr(seq),
+    seq->flags, index);
+  return (TInstant *)(tsequence_data_ptr(seq) + offset);
 }
 
 /**
  * Returns a pointer to the precomputed bounding box of the temporal value
+ *
+ * The bounding box is located immediately after the fixed-size part of the
+ * struct so that it can be read by fetching only a prefix of the value.
+ * In the original format it is located after the instants.
  */
 void *
 tsequence_bbox_ptr(const TSequence *seq)
 {
-  return (char *)(&seq->offsets[seq->count + 2]) +    /* start of data */
-    seq->offsets[seq->count];            /* offset */
+  if (! MOBDB_FLAGS_GET_VERSION(seq->flags))
+    return tsequence_data_ptr(seq) +
+      temporal_offset_get(tsequence_offsets_ptr(seq), seq->flags, seq->count);
+  return ((char *)seq) + double_pad(sizeof(TSequence));
 }
 
 /**
@@ -841,21 +998,63 @@ tsequence_bbox(void *box, const TSequence *seq)
  * Return the size in bytes required for string a temporal sequence value
  */
 static size_t
-tsequence_make_size(TInstant **instants, int count, size_t bboxsize, size_t trajsize)
+tsequence_make_size(TInstant **instants, int count, size_t bboxsize,
+  int nblocks, size_t trajsize)
 {
   /* Add the bounding box size */
   size_t result = bboxsize;
   /* Add the size of composing instants */
   for (int i = 0; i < count; i++)
     result += double_pad(VARSIZE(instants[i]));
+  /* Add the size of the block directory */
+  result += tsequence_blocks_size(instants[0]->valuetypid, nblocks);
   /* Add the trajectory size */
   result += trajsize;
-  /* Add the size of the struct and the offset array
-   * Notice that the first offset is already declared in the struct */
-  result += double_pad(sizeof(TSequence)) + (count + 1) * sizeof(size_t);
+  /* Add the size of the struct and the offset array, which is not needed
+   * for instants of a base type passed by value */
+  result += double_pad(sizeof(TSequence));
+  if (! MOBDB_FLAGS_GET_BYVAL(instants[0]->flags))
+    result += double_pad((count + 1) * sizeof(uint32));
   return result;
 }
 
+/**
+ * Set the bounding boxes of the block directory of the temporal value from
+ * its instants
+ */
+static void
+tsequence_make_blocks(TSequence *seq, TInstant **instants)
+{
+  int nblocks = tsequence_block_count(seq);
+  for (int i = 0; i < nblocks; i++)
+  {
+    int first = i * TSEQUENCE_BLOCK_SIZE;
+    int last = Min(first + TSEQUENCE_BLOCK_SIZE, seq->count - 1);
+    void *box = tsequence_block_bbox_ptr(seq, i);
+    if (tgeo_base_type(seq->valuetypid))
+      tpointinstarr_to_stbox((STBOX *) box, &instants[first],
+        last - first + 1);
+    else
+      tsequence_make_bbox(box, &instants[first], last - first + 1,
+        true, true);
+  }
+  return;
+}
+
+/**
+ * Recompute the bounding boxes of the block directory of the temporal value
+ * after its values have been modified in place
+ */
+void
+tsequence_reset_blocks(TSequence *seq)
+{
+  if (! MOBDB_FLAGS_GET_BLOCKS(seq->flags))
+    return;
+  TInstant **instants = tsequence_instants(seq);
+  tsequence_make_blocks(seq, instants);
+  pfree(instants);
+  return;
+}
 /**
  * Ensure the validity of the arguments when creating a temporal value
  */
@@ -877,14 +1076,43 @@ tsequence_make_valid(TInstant **instants, int count, bool lower_inc, bool upper_
   return;
 }
 
+/**
+ * Returns true if the instants of the temporal sequence are regularly
+ * sampled, that is, each instant is less than a quarter of the average
+ * interval between two instants away from its position in an even sampling
+ * of the period of the sequence
+ */
+static bool
+tsequence_regular(const TSequence *seq)
+{
+  if (seq->count < TSEQUENCE_REGULAR_MIN_COUNT)
+    return false;
+  double step = (double) (seq->period.upper - seq->period.lower) /
+    (seq->count - 1);
+  for (int i = 1; i < seq->count - 1; i++)
+  {
+    double delta = (double) (tsequence_inst_n(seq, i)->t -
+      seq->period.lower) - i * step;
+    if (Abs(delta) > step / 4)
+      return false;
+  }
+  return true;
+}
+
 /**
  * Creating a temporal value from its arguments
+ *
+ * This is the trusted constructor for internal callers such as the
+ * restriction functions, whose instants are derived from a valid sequence
+ * and thus need not be validated again.
+ *
  * @pre The validity of the arguments has been tested before
  */
 TSequence *
 tsequence_make1(TInstant **instants, int count, bool lower_inc, bool upper_inc,
   bool linear, bool normalize)
 {
+  TRACE_MOBILITYDB_SEQUENCE_MAKE_START(count);
   /* Normalize the array of instants */
   TInstant **norminsts = instants;
   int newcount = count;
@@ -896,24 +1124,42 @@ tsequence_make1(TInstant **instants, int count, bool lower_inc, bool upper_inc,
 
   /* Precompute the trajectory */
   size_t trajsize = 0;
-  bool hastraj = false; /* keep compiler quiet */
+  bool hastraj = false, maketraj = false;
   Datum traj = 0; /* keep compiler quiet */
   bool isgeo = tgeo_base_type(instants[0]->valuetypid);
   if (isgeo)
   {
-    hastraj = type_has_precomputed_trajectory(instants[0]->valuetypid);
-    if (hastraj)
-    {
-      /* A trajectory is a geometry/geography, a point, a multipoint,
-       * or a linestring, which may be self-intersecting */
+    hastraj = precompute_trajectory &&
+      type_has_precomputed_trajectory(instants[0]->valuetypid);
+    /* A trajectory is a geometry/geography, a point, a multipoint,
+     * or a linestring, which may be self-intersecting. When it is not
+     * kept, it is only computed for the bounding box of geodetic segments,
+     * which is not the one of their instants */
+    maketraj = hastraj || (linear && newcount > 1 &&
+      MOBDB_FLAGS_GET_GEODETIC(instants[0]->flags));
+    if (maketraj)
       traj = tpointseq_make_trajectory(norminsts, newcount, linear);
+    if (hastraj)
       trajsize += double_pad(VARSIZE(DatumGetPointer(traj)));
-    }
   }
 
+  /* Long sequences of temporal numbers and planar temporal points keep a
+   * directory with the bounding boxes of their blocks of segments. The
+   * bounding box of a block of geodetic segments is not the one of its
+   * instants and thus the directory is not kept for geodetic points */
+  int nblocks = 0;
+  if (newcount >= TSEQUENCE_BLOCK_MIN_COUNT &&
+    (tnumber_base_type(instants[0]->valuetypid) ||
+     (isgeo && ! MOBDB_FLAGS_GET_GEODETIC(instants[0]->flags))))
+    nblocks = (newcount + TSEQUENCE_BLOCK_SIZE - 2) / TSEQUENCE_BLOCK_SIZE;
+
   /* Create the temporal sequence */
-  size_t seqsize = tsequence_make_size(norminsts, newcount, bboxsize, trajsize);
+  size_t seqsize = tsequence_make_size(norminsts, newcount, bboxsize,
+    nblocks, trajsize);
   TSequence *result = palloc0(seqsize);
+  FUNC_STAT_ADD(FUNC_STAT_SEQUENCES, 1);
+  FUNC_STAT_ADD(FUNC_STAT_INSTANTS, newcount);
+  FUNC_STAT_ADD(FUNC_STAT_SEQUENCE_BYTES, seqsize);
   SET_VARSIZE(result, seqsize);
   result->count = newcount;
   result->valuetypid = instants[0]->valuetypid;
@@ -923,54 +1169,66 @@ tsequence_make1(TInstant **instants, int count, bool lower_inc, bool upper_inc,
   MOBDB_FLAGS_SET_LINEAR(result->flags, linear);
   MOBDB_FLAGS_SET_X(result->flags, true);
   MOBDB_FLAGS_SET_T(result->flags, true);
+  MOBDB_FLAGS_SET_VERSION(result->flags, true);
+  MOBDB_FLAGS_SET_BYVAL(result->flags,
+    MOBDB_FLAGS_GET_BYVAL(instants[0]->flags));
+  MOBDB_FLAGS_SET_BLOCKS(result->flags, nblocks > 0);
   if (isgeo)
   {
     MOBDB_FLAGS_SET_Z(result->flags, MOBDB_FLAGS_GET_Z(instants[0]->flags));
     MOBDB_FLAGS_SET_GEODETIC(result->flags, MOBDB_FLAGS_GET_GEODETIC(instants[0]->flags));
-  }
-  /* Initialization of the variable-length part
-   * Notice that the first offset is already declared in the struct */
-  size_t pdata = double_pad(sizeof(TSequence)) + (newcount + 1) * sizeof(size_t);
-  size_t pos = 0;
-  for (int i = 0; i < newcount; i++)
-  {
-    memcpy(((char *)result) + pdata + pos, norminsts[i],
-      VARSIZE(norminsts[i]));
-    result->offsets[i] = pos;
-    pos += double_pad(VARSIZE(norminsts[i]));
+    MOBDB_FLAGS_SET_TRAJ(result->flags, hastraj);
   }
   /*
    * Precompute the bounding box
    * Only external types have precomputed bounding box, internal types such
    * as double2, double3, or double4 do not have precomputed bounding box.
    * For temporal points the bounding box is computed from the trajectory
-   * for efficiency reasons.
+   * for efficiency reasons when it is computed, and from the instants
+   * otherwise.
    */
   if (bboxsize != 0)
   {
-    void *bbox = ((char *) result) + pdata + pos;
-    if (hastraj)
+    void *bbox = tsequence_bbox_ptr(result);
+    if (maketraj)
     {
       geo_to_stbox_internal(bbox, (GSERIALIZED *)DatumGetPointer(traj));
       ((STBOX *)bbox)->tmin = result->period.lower;
       ((STBOX *)bbox)->tmax = result->period.upper;
       MOBDB_FLAGS_SET_T(((STBOX *)bbox)->flags, true);
     }
+    else if (isgeo)
+      tpointinstarr_to_stbox((STBOX *) bbox, norminsts, newcount);
     else
       tsequence_make_bbox(bbox, norminsts, newcount, lower_inc, upper_inc);
-    result->offsets[newcount] = pos;
-    pos += double_pad(bboxsize);
   }
-  if (isgeo && hastraj)
+  /* Compute the bounding boxes of the blocks */
+  tsequence_make_blocks(result, norminsts);
+  /* Initialization of the variable-length part */
+  void *offsets = tsequence_offsets_ptr(result);
+  char *pdata = tsequence_data_ptr(result);
+  size_t pos = 0;
+  for (int i = 0; i < newcount; i++)
   {
-    result->offsets[newcount + 1] = pos;
-    memcpy(((char *) result) + pdata + pos, DatumGetPointer(traj),
+    memcpy(pdata + pos, norminsts[i], VARSIZE(norminsts[i]));
+    if (! MOBDB_FLAGS_GET_BYVAL(result->flags))
+      temporal_offset_set(offsets, result->flags, i, pos);
+    pos += double_pad(VARSIZE(norminsts[i]));
+  }
+  if (hastraj)
+  {
+    temporal_offset_set(offsets, result->flags, newcount, pos);
+    memcpy(pdata + pos, DatumGetPointer(traj),
       VARSIZE(DatumGetPointer(traj)));
-    pfree(DatumGetPointer(traj));
   }
+  if (maketraj)
+    pfree(DatumGetPointer(traj));
+
+  MOBDB_FLAGS_SET_REGULAR(result->flags, tsequence_regular(result));
 
-  if (normalize && count > 2)
+  if (norminsts != instants)
     pfree(norminsts);
+  TRACE_MOBILITYDB_SEQUENCE_MAKE_DONE(newcount, (int64) seqsize);
   return result;
 }
 
@@ -981,18 +1239,19 @@ tsequence_make1(TInstant **instants, int count, bool lower_inc, bool upper_inc,
  * For example, the memory structure of a temporal sequence value with
  * 2 instants and a precomputed trajectory is as follows:
  * @code
- * -------------------------------------------------------------------
- * ( TSequence )_X | offset_0 | offset_1 | offset_2 | offset_3 | ...
- * -------------------------------------------------------------------
- * ------------------------------------------------------------------------
- * ( TInstant_0 )_X | ( TInstant_1 )_X | ( bbox )_X | ( Traj )_X  |
- * ------------------------------------------------------------------------
+ * -----------------------------------------------------------------------
+ * ( TSequence )_X | ( bbox )_X | ( offset_0 | offset_1 | offset_2 )_X | ...
+ * -----------------------------------------------------------------------
+ * ------------------------------------------------------
+ * ( TInstant_0 )_X | ( TInstant_1 )_X | ( Traj )_X  |
+ * ------------------------------------------------------
  * @endcode
  * where the `X` are unused bytes added for double padding, `offset_0` and
- * `offset_1` are offsets for the corresponding instants, `offset_2` is the
- * offset for the bounding box and `offset_3` is the offset for the
- * precomputed trajectory. Precomputed trajectories are only kept for temporal
- * points of sequence duration.
+ * `offset_1` are offsets for the corresponding instants, and `offset_2` is
+ * the offset for the precomputed trajectory. Precomputed trajectories are
+ * only kept for temporal points of sequence duration. The bounding box is
+ * stored before the offsets so that it is located at a fixed position that
+ * only depends on the base type.
  *
  * @param[in] instants Array of instants
  * @param[in] count Number of elements in the array
@@ -1032,6 +1291,291 @@ tsequence_make_free(TInstant **instants, int count, bool lower_inc,
   return result;
 }
 
+/**
+ * Construct a temporal sequence value from the array of temporal
+ * instant values without validating them and free the array and the
+ * instants after the creation
+ *
+ * @pre The validity of the arguments has been tested before
+ */
+TSequence *
+tsequence_make_free1(TInstant **instants, int count, bool lower_inc,
+   bool upper_inc, bool linear, bool normalize)
+{
+  assert (count > 0);
+  TSequence *result = tsequence_make1(instants, count, lower_inc, upper_inc,
+    linear, normalize);
+  for (int i = 0; i < count; i++)
+    pfree(instants[i]);
+  pfree(instants);
+  return result;
+}
+
+/*****************************************************************************
+ * Sequence builder
+ *****************************************************************************/
+
+/**
+ * Returns the n-th instant written in the buffer of the builder
+ */
+static TInstant *
+tsequence_builder_slot(const TSequenceBuilder *b, int n)
+{
+  return (TInstant *)(b->data + n * TINSTANT_BYVAL_SIZE);
+}
+
+/**
+ * Writes in place an instant of a base type passed by value
+ */
+static void
+tsequence_builder_write(const TSequenceBuilder *b, TInstant *inst, Datum value,
+  TimestampTz t)
+{
+  SET_VARSIZE(inst, TINSTANT_BYVAL_SIZE);
+  inst->duration = INSTANT;
+  inst->flags = b->instflags;
+  inst->valuetypid = b->valuetypid;
+  inst->t = t;
+  *tinstant_value_ptr(inst) = value;
+  return;
+}
+
+/**
+ * Initialize a builder for a temporal sequence of at most `maxcount` instants
+ *
+ * For base types passed by value the instants have a fixed size and are
+ * written directly at their position in the resulting sequence, which avoids
+ * allocating each instant and copying all of them again at the end. For base
+ * types passed by reference the instants are kept in an array and the
+ * sequence, including its trajectory, is constructed by `tsequence_make1`.
+ *
+ * @param[out] b Builder
+ * @param[in] valuetypid Base type of the instants
+ * @param[in] maxcount Upper bound of the number of instants appended
+ * @param[in] linear True when the interpolation is linear
+ * @param[in] normalize True when redundant instants are removed while
+ * appending them
+ */
+void
+tsequence_builder_init(TSequenceBuilder *b, Oid valuetypid, int maxcount,
+  bool linear, bool normalize)
+{
+  assert(maxcount > 0);
+  b->valuetypid = valuetypid;
+  b->maxcount = maxcount;
+  b->count = 0;
+  b->linear = linear;
+  b->normalize = normalize;
+  b->byval = get_typbyval_fast(valuetypid);
+  b->seq = NULL;
+  b->data = NULL;
+  b->instants = NULL;
+  if (! b->byval)
+  {
+    b->instants = palloc(sizeof(TInstant *) * maxcount);
+    return;
+  }
+  /* The instants are written after the space needed for the largest
+   * block directory and moved back at the end if needed */
+  int maxblocks = (maxcount >= TSEQUENCE_BLOCK_MIN_COUNT &&
+    tnumber_base_type(valuetypid)) ?
+    (maxcount + TSEQUENCE_BLOCK_SIZE - 2) / TSEQUENCE_BLOCK_SIZE : 0;
+  size_t hdrsize = double_pad(sizeof(TSequence)) +
+    double_pad(temporal_bbox_size(valuetypid)) +
+    tsequence_blocks_size(valuetypid, maxblocks);
+  b->seq = palloc0(hdrsize + maxcount * TINSTANT_BYVAL_SIZE);
+  b->data = ((char *) b->seq) + hdrsize;
+  b->instflags = 0;
+  MOBDB_FLAGS_SET_BYVAL(b->instflags, true);
+  MOBDB_FLAGS_SET_LINEAR(b->instflags, linear_interpolation(valuetypid));
+  MOBDB_FLAGS_SET_X(b->instflags, true);
+  MOBDB_FLAGS_SET_T(b->instflags, true);
+  return;
+}
+
+/**
+ * Returns the last instant appended to the builder
+ */
+TInstant *
+tsequence_builder_last(const TSequenceBuilder *b)
+{
+  assert(b->count > 0);
+  return b->byval ? tsequence_builder_slot(b, b->count - 1) :
+    b->instants[b->count - 1];
+}
+
+/**
+ * Append an instant to the builder
+ *
+ * When the builder normalizes, the last instant is replaced by the new one
+ * if it is redundant, which gives the same result as `tinstantarr_normalize`
+ * since this only depends on the instants kept before it.
+ *
+ * @pre The timestamp is greater than the one of the last instant
+ */
+void
+tsequence_builder_append(TSequenceBuilder *b, Datum value, TimestampTz t)
+{
+  assert(b->count < b->maxcount);
+  assert(b->count == 0 || tsequence_builder_last(b)->t < t);
+  TInstant *inst;
+  if (b->byval)
+  {
+    inst = tsequence_builder_slot(b, b->count);
+    tsequence_builder_write(b, inst, value, t);
+  }
+  else
+    inst = tinstant_make(value, t, b->valuetypid);
+  if (b->normalize && b->count > 1)
+  {
+    TInstant *inst1 = b->byval ? tsequence_builder_slot(b, b->count - 2) :
+      b->instants[b->count - 2];
+    TInstant *inst2 = tsequence_builder_last(b);
+    if (tsequence_redundant_tinstant(inst1, inst2, inst, b->linear))
+    {
+      if (b->byval)
+        memcpy(inst2, inst, TINSTANT_BYVAL_SIZE);
+      else
+      {
+        pfree(inst2);
+        b->instants[b->count - 1] = inst;
+      }
+      return;
+    }
+  }
+  if (! b->byval)
+    b->instants[b->count] = inst;
+  b->count++;
+  return;
+}
+
+/**
+ * Remove the last instant appended to the builder
+ */
+void
+tsequence_builder_remove_last(TSequenceBuilder *b)
+{
+  assert(b->count > 0);
+  b->count--;
+  if (! b->byval)
+    pfree(b->instants[b->count]);
+  return;
+}
+
+/**
+ * Append a copy of the instant to the builder
+ */
+void
+tsequence_builder_append_tinstant(TSequenceBuilder *b, const TInstant *inst)
+{
+  tsequence_builder_append(b, tinstant_value(inst), inst->t);
+  return;
+}
+
+/**
+ * Construct the temporal sequence from the instants appended to the builder
+ *
+ * The last two values of a sequence with step interpolation and exclusive
+ * upper bound are made equal.
+ */
+TSequence *
+tsequence_builder_finish(TSequenceBuilder *b, bool lower_inc, bool upper_inc)
+{
+  assert(b->count > 0);
+  int count = b->count;
+  if (count == 1 && (! lower_inc || ! upper_inc))
+    ereport(ERROR, (errcode(ERRCODE_RESTRICT_VIOLATION),
+        errmsg("Instant sequence must have inclusive bounds")));
+  TInstant *prev = (count == 1) ? NULL : (b->byval ?
+    tsequence_builder_slot(b, count - 2) : b->instants[count - 2]);
+  TInstant *last = tsequence_builder_last(b);
+  if (! b->linear && ! upper_inc && count > 1 &&
+    datum_ne(tinstant_value(prev), tinstant_value(last), b->valuetypid))
+  {
+    if (b->byval)
+      tsequence_builder_write(b, last, tinstant_value(prev), last->t);
+    else
+    {
+      b->instants[count - 1] = tinstant_make(tinstant_value(prev), last->t,
+        b->valuetypid);
+      pfree(last);
+    }
+  }
+
+  TSequence *result;
+  if (! b->byval)
+  {
+    result = tsequence_make1(b->instants, count, lower_inc, upper_inc,
+      b->linear, NORMALIZE_NO);
+    for (int i = 0; i < count; i++)
+      pfree(b->instants[i]);
+    pfree(b->instants);
+    return result;
+  }
+
+  result = b->seq;
+  int nblocks = (count >= TSEQUENCE_BLOCK_MIN_COUNT &&
+    tnumber_base_type(b->valuetypid)) ?
+    (count + TSEQUENCE_BLOCK_SIZE - 2) / TSEQUENCE_BLOCK_SIZE : 0;
+  result->count = count;
+  result->valuetypid = b->valuetypid;
+  result->duration = SEQUENCE;
+  MOBDB_FLAGS_SET_LINEAR(result->flags, b->linear);
+  MOBDB_FLAGS_SET_X(result->flags, true);
+  MOBDB_FLAGS_SET_T(result->flags, true);
+  MOBDB_FLAGS_SET_VERSION(result->flags, true);
+  MOBDB_FLAGS_SET_BYVAL(result->flags, true);
+  MOBDB_FLAGS_SET_BLOCKS(result->flags, nblocks > 0);
+  /* Move the instants back if the block directory is smaller than the
+   * one for which space was reserved */
+  char *pdata = tsequence_data_ptr(result);
+  if (pdata != b->data)
+    memmove(pdata, b->data, count * TINSTANT_BYVAL_SIZE);
+  size_t seqsize = (pdata - (char *) result) + count * TINSTANT_BYVAL_SIZE;
+  SET_VARSIZE(result, seqsize);
+  TInstant *first = tsequence_inst_n(result, 0);
+  last = tsequence_inst_n(result, count - 1);
+  period_set(&result->period, first->t, last->t, lower_inc, upper_inc);
+  MOBDB_FLAGS_SET_REGULAR(result->flags, tsequence_regular(result));
+
+  /* Compute the bounding box and the ones of the blocks in a single pass
+   * over the instants */
+  if (temporal_bbox_size(b->valuetypid) != 0)
+  {
+    void *bbox = tsequence_bbox_ptr(result);
+    if (talpha_base_type(b->valuetypid))
+      period_set((Period *) bbox, first->t, last->t, lower_inc, upper_inc);
+    else
+    {
+      TBOX *box = (TBOX *) bbox;
+      TBOX *blockbox = NULL;
+      tinstant_make_bbox(box, first);
+      for (int i = 0; i < count; i++)
+      {
+        TInstant *inst = tsequence_inst_n(result, i);
+        TBOX box1;
+        memset(&box1, 0, sizeof(TBOX));
+        tinstant_make_bbox(&box1, inst);
+        tbox_expand(box, &box1);
+        if (nblocks == 0)
+          continue;
+        /* The instant ending a block starts the next one */
+        if (blockbox != NULL)
+          tbox_expand(blockbox, &box1);
+        if (i % TSEQUENCE_BLOCK_SIZE == 0 && i / TSEQUENCE_BLOCK_SIZE < nblocks)
+        {
+          blockbox = tsequence_block_bbox_ptr(result, i / TSEQUENCE_BLOCK_SIZE);
+          memcpy(blockbox, &box1, sizeof(TBOX));
+        }
+      }
+    }
+  }
+  /* Release the unused part of the buffer if it is large */
+  if (count < b->maxcount / 2)
+    result = repalloc(result, seqsize);
+  return result;
+}
+
 /**
  * Join the two temporal sequence values
  *
@@ -1102,6 +1646,36 @@ tsequence_from_base(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(result);
 }
 
+/**
+ * Returns true if the second instant of three consecutive instants of a
+ * sequence is redundant, that is, if removing it does not change the
+ * value of the sequence
+ */
+bool
+tsequence_redundant_tinstant(const TInstant *inst1, const TInstant *inst2,
+  const TInstant *inst3, bool linear)
+{
+  Oid valuetypid = inst1->valuetypid;
+  Datum value1 = tinstant_value(inst1);
+  Datum value2 = tinstant_value(inst2);
+  Datum value3 = tinstant_value(inst3);
+  return
+    /* step sequences and 2 consecutive instants that have the same value
+      ... 1@t1, 1@t2, 2@t3, ... -> ... 1@t1, 2@t3, ...
+    */
+    (! linear && datum_eq(value1, value2, valuetypid))
+    ||
+    /* 3 consecutive float/point instants that have the same value
+      ... 1@t1, 1@t2, 1@t3, ... -> ... 1@t1, 1@t3, ...
+    */
+    (datum_eq(value1, value2, valuetypid) && datum_eq(value2, value3, valuetypid))
+    ||
+    /* collinear float/point instants that have the same duration
+      ... 1@t1, 2@t2, 3@t3, ... -> ... 1@t1, 3@t3, ...
+    */
+    (linear && datum_collinear(valuetypid, value1, value2, value3, inst1->t, inst2->t, inst3->t));
+}
+
 /**
  * Append an instant to the temporal value
  */
@@ -1136,35 +1710,12 @@ tsequence_append_tinstant(const TSequence *seq, const TInstant *inst)
 
   /* The result is a sequence */
   int count = seq->count + 1;
-  if (seq->count > 1)
-  {
-    /* Normalize the result */
-    inst1 = tsequence_inst_n(seq, seq->count - 2);
-    Datum value1 = tinstant_value(inst1);
-    TInstant *inst2 = tsequence_inst_n(seq, seq->count - 1);
-    Datum value2 = tinstant_value(inst2);
-    Datum value3 = tinstant_value(inst);
-    if (
-      /* step sequences and 2 consecutive instants that have the same value
-        ... 1@t1, 1@t2, 2@t3, ... -> ... 1@t1, 2@t3, ...
-      */
-      (! linear && datum_eq(value1, value2, seq->valuetypid))
-      ||
-      /* 3 consecutive float/point instants that have the same value
-        ... 1@t1, 1@t2, 1@t3, ... -> ... 1@t1, 1@t3, ...
-      */
-      (datum_eq(value1, value2, seq->valuetypid) && datum_eq(value2, value3, seq->valuetypid))
-      ||
-      /* collinear float/point instants that have the same duration
-        ... 1@t1, 2@t2, 3@t3, ... -> ... 1@t1, 3@t3, ...
-      */
-      (linear && datum_collinear(seq->valuetypid, value1, value2, value3, inst1->t, inst2->t, inst->t))
-      )
-    {
-      /* The new instant replaces the last instant of the sequence */
-      count--;
-    }
-  }
+  /* Normalize the result: the new instant replaces the last instant of the
+   * sequence if the latter is redundant */
+  if (seq->count > 1 &&
+    tsequence_redundant_tinstant(tsequence_inst_n(seq, seq->count - 2),
+      tsequence_inst_n(seq, seq->count - 1), inst, linear))
+    count--;
 
   TInstant **instants = palloc(sizeof(TInstant *) * count);
   int k = 0;
@@ -1187,10 +1738,28 @@ tsequence_merge(const TSequence *seq1, const TSequence *seq2)
   return tsequence_merge_array((TSequence **) sequences, 2);
 }
 
+/**
+ * Ways in which a sequence is merged with the previous one
+ */
+typedef enum
+{
+  MERGE_NONE,        /**< the sequence starts a new sequence */
+  MERGE_SKIP_FIRST,  /**< the first instant of the sequence is skipped */
+  MERGE_SKIP_LAST,   /**< the last instant of the previous one is skipped */
+} MergeJoin;
+
 /**
  * Merge the array of temporal sequence values.
  * The values in the array may overlap on a single instant.
  *
+ * The sequences are sorted only if they are not already sorted, which is
+ * the common case, e.g., when merging the daily fragments of a trip. Their
+ * validity is then tested in a single pass that also determines which
+ * adjacent sequences are joined. Each resulting sequence is finally
+ * constructed with a builder in which the instants of the sequences it
+ * joins are appended and normalized on the fly, which avoids copying the
+ * joined sequence again for every sequence added to it.
+ *
  * @param[in] sequences Array of values
  * @param[in] count Number of elements in the array
  * @param[out] totalcount Number of elements in the resulting array
@@ -1199,9 +1768,22 @@ tsequence_merge(const TSequence *seq1, const TSequence *seq2)
 TSequence **
 tsequence_merge_array1(TSequence **sequences, int count, int *totalcount)
 {
-  if (count > 1)
-    tsequencearr_sort(sequences, count);
-  /* Test the validity of the composing sequences */
+  for (int i = 1; i < count; i++)
+  {
+    if (period_cmp_internal(&sequences[i - 1]->period,
+      &sequences[i]->period) > 0)
+    {
+      tsequencearr_sort(sequences, count);
+      break;
+    }
+  }
+  /* Test the validity of the composing sequences and determine how each
+   * sequence is joined to the previous one */
+  MergeJoin *join = palloc(sizeof(MergeJoin) * count);
+  join[0] = MERGE_NONE;
+  bool linear = MOBDB_FLAGS_GET_LINEAR(sequences[0]->flags);
+  Oid valuetypid = sequences[0]->valuetypid;
+  int nseqs = 1;
   TSequence *seq1 = sequences[0];
   for (int i = 1; i < count; i++)
   {
@@ -1226,46 +1808,232 @@ tsequence_merge_array1(TSequence **sequences, int count, int *totalcount)
           errmsg("The temporal values have different value at their overlapping instant %s", t1)));
       }
     }
+    /* The cases in which adjacent sequences are joined are those of
+     * tsequencearr_normalize, the removal of redundant instants at the
+     * junction is done by the builder */
+    bool adjacent = seq1->period.upper == seq2->period.lower &&
+      (seq1->period.upper_inc || seq2->period.lower_inc);
+    if (adjacent && datum_eq(tinstant_value(inst1), tinstant_value(inst2),
+        valuetypid))
+      join[i] = MERGE_SKIP_FIRST;
+    else if (adjacent && ! linear && ! seq1->period.upper_inc)
+      join[i] = MERGE_SKIP_LAST;
+    else
+    {
+      join[i] = MERGE_NONE;
+      nseqs++;
+    }
     seq1 = seq2;
   }
-  return tsequencearr_normalize(sequences, count, totalcount);
+
+  /* Construct the resulting sequences */
+  TSequence **result = palloc(sizeof(TSequence *) * nseqs);
+  int k = 0;
+  for (int i = 0; i < count; )
+  {
+    /* Find the sequences joined into the next result */
+    int j = i + 1, maxcount = sequences[i]->count;
+    while (j < count && join[j] != MERGE_NONE)
+      maxcount += sequences[j++]->count;
+    if (j == i + 1)
+    {
+      result[k++] = tsequence_copy(sequences[i]);
+      i = j;
+      continue;
+    }
+    TSequenceBuilder builder;
+    tsequence_builder_init(&builder, valuetypid, maxcount, linear, NORMALIZE);
+    for (int l = i; l < j; l++)
+    {
+      int first = 0;
+      if (l > i && join[l] == MERGE_SKIP_FIRST)
+        first = 1;
+      else if (l > i)
+        tsequence_builder_remove_last(&builder);
+      for (int m = first; m < sequences[l]->count; m++)
+        tsequence_builder_append_tinstant(&builder,
+          tsequence_inst_n(sequences[l], m));
+    }
+    result[k++] = tsequence_builder_finish(&builder,
+      sequences[i]->period.lower_inc, sequences[j - 1]->period.upper_inc);
+    i = j;
+  }
+  pfree(join);
+  *totalcount = k;
+  return result;
+}
+
+/**
+ * Merge the array of temporal sequence values.
+ * The values in the array may overlap on a single instant.
+ *
+ * @param[in] sequences Array of values
+ * @param[in] count Number of elements in the array
+ * @result Merged value
+ */
+Temporal *
+tsequence_merge_array(TSequence **sequences, int count)
+{
+  int totalcount;
+  TSequence **newseqs = tsequence_merge_array1(sequences, count, &totalcount);
+  Temporal *result = (totalcount == 1) ? (Temporal *) newseqs[0] :
+    (Temporal *) tsequenceset_make_free(newseqs, totalcount, NORMALIZE_NO);
+  return result;
+}
+
+/**
+ * Returns a copy of the temporal value
+ */
+TSequence *
+tsequence_copy(const TSequence *seq)
+{
+  TSequence *result = palloc0(VARSIZE(seq));
+  memcpy(result, seq, VARSIZE(seq));
+  return result;
+}
+
+/*****************************************************************************
+ * Simplification levels
+ *****************************************************************************/
+
+/**
+ * Returns the size in bytes of the simplification levels of a temporal
+ * sequence
+ *
+ * @param[in] count Number of levels
+ * @param[in] total Number of instants of the finest level
+ */
+size_t
+tsequence_levels_size(int count, int total)
+{
+  return double_pad(sizeof(TSequenceLevels) +
+    sizeof(int32) * (count + total)) + sizeof(double) * total;
 }
 
 /**
- * Merge the array of temporal sequence values.
- * The values in the array may overlap on a single instant.
+ * Returns a pointer to the array keeping the number of instants of each
+ * simplification level
+ */
+int32 *
+tsequence_levels_counts(const TSequenceLevels *levels)
+{
+  return (int32 *)(((char *) levels) + sizeof(TSequenceLevels));
+}
+
+/**
+ * Returns a pointer to the array keeping the indexes of the instants of the
+ * simplification levels by decreasing significance
+ */
+int32 *
+tsequence_levels_indexes(const TSequenceLevels *levels)
+{
+  return tsequence_levels_counts(levels) + levels->count;
+}
+
+/**
+ * Returns a pointer to the array keeping the significance of the instants
+ * of the simplification levels
+ */
+double *
+tsequence_levels_significance(const TSequenceLevels *levels)
+{
+  return (double *)(((char *) levels) + double_pad(sizeof(TSequenceLevels) +
+    sizeof(int32) * (levels->count + levels->total)));
+}
+
+/**
+ * Returns a pointer to the simplification levels of the temporal value,
+ * which are located after its instants and its precomputed trajectory
  *
- * @param[in] sequences Array of values
- * @param[in] count Number of elements in the array
- * @result Merged value
+ * @return Returns NULL if the sequence does not have simplification levels
  */
-Temporal *
-tsequence_merge_array(TSequence **sequences, int count)
+const TSequenceLevels *
+tsequence_levels_ptr(const TSequence *seq)
 {
-  int totalcount;
-  TSequence **newseqs = tsequence_merge_array1(sequences, count, &totalcount);
-  Temporal *result = (totalcount == 1) ? (Temporal *) newseqs[0] :
-    (Temporal *) tsequenceset_make_free(newseqs, totalcount, NORMALIZE);
-  return result;
+  if (! MOBDB_FLAGS_GET_LEVELS(seq->flags))
+    return NULL;
+  size_t offset = temporal_offset_get(tsequence_offsets_ptr(seq),
+    seq->flags, seq->count + 1);
+  return (const TSequenceLevels *)(tsequence_data_ptr(seq) + offset);
 }
 
 /**
- * Returns a copy of the temporal value
+ * Returns a copy of the temporal value with the simplification levels,
+ * which replace the previous ones if any
+ *
+ * The bounding box, the block directory, the instants, and the precomputed
+ * trajectory are copied as they are. Values in the original format, whose
+ * bounding box and trajectory follow the instants, are first constructed
+ * again in the current format without normalization, so that the indexes
+ * of the levels still refer to the same instants.
  */
 TSequence *
-tsequence_copy(const TSequence *seq)
+tsequence_add_levels(const TSequence *seq, const TSequenceLevels *levels)
 {
-  TSequence *result = palloc0(VARSIZE(seq));
-  memcpy(result, seq, VARSIZE(seq));
+  if (! MOBDB_FLAGS_GET_VERSION(seq->flags))
+  {
+    TInstant **instants = tsequence_instants(seq);
+    TSequence *seq1 = tsequence_make1(instants, seq->count,
+      seq->period.lower_inc, seq->period.upper_inc,
+      MOBDB_FLAGS_GET_LINEAR(seq->flags), NORMALIZE_NO);
+    TSequence *result = tsequence_add_levels(seq1, levels);
+    pfree(instants); pfree(seq1);
+    return result;
+  }
+  assert(! MOBDB_FLAGS_GET_BYVAL(seq->flags));
+  char *data = tsequence_data_ptr(seq);
+  const TSequenceLevels *oldlevels = tsequence_levels_ptr(seq);
+  size_t datasize = oldlevels ? (size_t) ((char *) oldlevels - data) :
+    (size_t) ((char *) seq + VARSIZE(seq) - data);
+  size_t prefix = double_pad(sizeof(TSequence)) +
+    double_pad(temporal_bbox_size(seq->valuetypid));
+  size_t blocks = tsequence_blocks_size(seq->valuetypid,
+    tsequence_block_count(seq));
+  size_t levelssize = tsequence_levels_size(levels->count, levels->total);
+  size_t size = prefix + double_pad(sizeof(uint32) * (seq->count + 2)) +
+    blocks + datasize + double_pad(levelssize);
+  TSequence *result = palloc0(size);
+  memcpy(result, seq, prefix);
+  SET_VARSIZE(result, size);
+  MOBDB_FLAGS_SET_VERSION(result->flags, true);
+  MOBDB_FLAGS_SET_LEVELS(result->flags, true);
+  void *offsets = tsequence_offsets_ptr(result);
+  void *oldoffsets = tsequence_offsets_ptr(seq);
+  for (int i = 0; i <= seq->count; i++)
+    temporal_offset_set(offsets, result->flags, i,
+      temporal_offset_get(oldoffsets, seq->flags, i));
+  temporal_offset_set(offsets, result->flags, seq->count + 1, datasize);
+  memcpy(tsequence_blocks_ptr(result), tsequence_blocks_ptr(seq), blocks);
+  char *pdata = tsequence_data_ptr(result);
+  memcpy(pdata, data, datasize);
+  memcpy(pdata + datasize, levels, levelssize);
   return result;
 }
 
+/**
+ * Returns true if the segment of the temporal sequence starting at the
+ * instant n contains the timestamp
+ */
+static bool
+tsequence_segment_contains(const TSequence *seq, int n, TimestampTz t)
+{
+  TInstant *inst1 = tsequence_inst_n(seq, n);
+  TInstant *inst2 = tsequence_inst_n(seq, n + 1);
+  bool lower_inc = (n == 0) ? seq->period.lower_inc : true;
+  bool upper_inc = (n == seq->count - 2) ? seq->period.upper_inc : false;
+  return (inst1->t < t && t < inst2->t) ||
+    (lower_inc && inst1->t == t) || (upper_inc && inst2->t == t);
+}
+
 /**
  * Returns the index of the segment of the temporal sequence value
  * containing the timestamp using binary search
  *
  * If the timestamp is contained in the temporal value, the index of the
  * segment containing the timestamp is returned in the output parameter.
+ * When the instants of the sequence are regularly sampled, the segment
+ * estimated from the timestamp and the two neighbouring ones are tested
+ * before the binary search.
  * For example, given a value composed of 3 sequences and a timestamp,
  * the value returned in the output parameter is as follows:
  * @code
@@ -1287,15 +2055,26 @@ tsequence_find_timestamp(const TSequence *seq, TimestampTz t)
 {
   int first = 0;
   int last = seq->count - 2;
+  if (MOBDB_FLAGS_GET_REGULAR(seq->flags) &&
+    seq->period.lower <= t && t <= seq->period.upper)
+  {
+    /* Every instant is less than a quarter of the average interval away
+     * from its position in an even sampling of the period, and thus the
+     * segment is at most one position away from the estimated one */
+    int guess = interpolation_probe(first, last, seq->period.lower,
+      seq->period.upper, t);
+    if (tsequence_segment_contains(seq, guess, t))
+      return guess;
+    if (guess > first && tsequence_segment_contains(seq, guess - 1, t))
+      return guess - 1;
+    if (guess < last && tsequence_segment_contains(seq, guess + 1, t))
+      return guess + 1;
+  }
   int middle = (first + last)/2;
   while (first <= last)
   {
     TInstant *inst1 = tsequence_inst_n(seq, middle);
-    TInstant *inst2 = tsequence_inst_n(seq, middle + 1);
-    bool lower_inc = (middle == 0) ? seq->period.lower_inc : true;
-    bool upper_inc = (middle == seq->count - 2) ? seq->period.upper_inc : false;
-    if ((inst1->t < t && t < inst2->t) ||
-      (lower_inc && inst1->t == t) || (upper_inc && inst2->t == t))
+    if (tsequence_segment_contains(seq, middle, t))
       return middle;
     if (t <= inst1->t)
       last = middle - 1;
@@ -1306,6 +2085,50 @@ tsequence_find_timestamp(const TSequence *seq, TimestampTz t)
   return -1;
 }
 
+/**
+ * Returns the index of the segment of the temporal sequence in which the
+ * timestamp is located, starting the search at the segment `from`
+ *
+ * The search gallops, that is, the timestamp is compared with the instants
+ * at distance 1, 2, 4, ... from the starting segment before a binary search
+ * in the last interval. Locating m increasing timestamps in a sequence of n
+ * instants thus costs O(m log(n/m)), which amounts to a linear merge when m
+ * is close to n and to a binary search per timestamp when m is much smaller
+ * than n.
+ *
+ * @param[in] seq Temporal sequence value
+ * @param[in] t Timestamp
+ * @param[in] from Segment from which the search starts
+ * @result Returns the greatest index of a segment whose first instant is
+ * not after the timestamp
+ * @pre The timestamp is contained in the period of the sequence and is not
+ * before the first instant of the segment `from`
+ */
+static int
+tsequence_find_timestamp_from(const TSequence *seq, TimestampTz t, int from)
+{
+  int last = seq->count - 2;
+  int lo = from, step = 1;
+  int hi = from + step;
+  while (hi <= last && tsequence_inst_n(seq, hi)->t <= t)
+  {
+    lo = hi;
+    step *= 2;
+    hi = lo + step;
+  }
+  if (hi > last)
+    hi = last;
+  while (lo < hi)
+  {
+    int middle = (lo + hi + 1) / 2;
+    if (tsequence_inst_n(seq, middle)->t <= t)
+      lo = middle;
+    else
+      hi = middle - 1;
+  }
+  return lo;
+}
+
 /**
  * Convert an an array of arrays of temporal sequence values into an array of
  * sequence values.
@@ -1459,6 +2282,26 @@ intersection_tsequence_tsequence(const TSequence *seq1, const TSequence *seq2,
  * interpolation.
  *****************************************************************************/
 
+/**
+ * Returns true if the two temporal values are defined over the same
+ * period and the same timestamps, which is typically the case for values
+ * sampled by the same device
+ */
+bool
+tsequence_same_timestamps(const TSequence *seq1, const TSequence *seq2)
+{
+  if (seq1->count != seq2->count ||
+    ! period_eq_internal(&seq1->period, &seq2->period))
+    return false;
+  /* The bounds are equal since the periods are equal */
+  for (int i = 1; i < seq1->count - 1; i++)
+  {
+    if (tsequence_inst_n(seq1, i)->t != tsequence_inst_n(seq2, i)->t)
+      return false;
+  }
+  return true;
+}
+
 /**
  * Synchronize the two temporal values
  *
@@ -1484,6 +2327,17 @@ synchronize_tsequence_tsequence(const TSequence *seq1, const TSequence *seq2,
   bool linear2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags);
   TInstant *inst1, *inst2;
 
+  /* If the two sequences have the same timestamps they are already
+   * synchronized, unless crossings must be added */
+  if ((! crossings || (! linear1 && ! linear2)) &&
+    tsequence_same_timestamps(seq1, seq2))
+  {
+    *sync1 = tsequence_copy(seq1);
+    *sync2 = tsequence_copy(seq2);
+    pfree(inter);
+    return true;
+  }
+
   /* If the two sequences intersect at an instant */
   if (inter->lower == inter->upper)
   {
@@ -1519,9 +2373,10 @@ synchronize_tsequence_tsequence(const TSequence *seq1, const TSequence *seq2,
     j = tsequence_find_timestamp(seq2, inter->lower);
   }
   int count = (seq1->count - i + seq2->count - j) * 2;
-  TInstant **instants1 = palloc(sizeof(TInstant *) * count);
-  TInstant **instants2 = palloc(sizeof(TInstant *) * count);
-  TInstant **tofree = palloc(sizeof(TInstant *) * count * 2);
+  TSequenceBuilder b1, b2;
+  tsequence_builder_init(&b1, seq1->valuetypid, count, linear1, NORMALIZE_NO);
+  tsequence_builder_init(&b2, seq2->valuetypid, count, linear2, NORMALIZE_NO);
+  TInstant **tofree = palloc(sizeof(TInstant *) * count);
   if (tofreeinst != NULL)
     tofree[l++] = tofreeinst;
   while (i < seq1->count && j < seq2->count &&
@@ -1550,52 +2405,32 @@ synchronize_tsequence_tsequence(const TSequence *seq1, const TSequence *seq2,
     {
       TimestampTz crosstime;
       Datum inter1, inter2;
-      if (tsequence_intersection(instants1[k - 1], inst1, linear1,
-        instants2[k - 1], inst2, linear2, &inter1, &inter2, &crosstime))
+      if (tsequence_intersection(tsequence_builder_last(&b1), inst1, linear1,
+        tsequence_builder_last(&b2), inst2, linear2, &inter1, &inter2,
+        &crosstime))
       {
-        instants1[k] = tofree[l++] = tinstant_make(inter1,
-          crosstime, seq1->valuetypid);
-        instants2[k++] = tofree[l++] = tinstant_make(inter2,
-          crosstime, seq2->valuetypid);
+        tsequence_builder_append(&b1, inter1, crosstime);
+        tsequence_builder_append(&b2, inter2, crosstime);
+        k++;
       }
     }
-    instants1[k] = inst1; instants2[k++] = inst2;
+    tsequence_builder_append_tinstant(&b1, inst1);
+    tsequence_builder_append_tinstant(&b2, inst2);
+    k++;
     if (i == seq1->count || j == seq2->count)
       break;
     inst1 = tsequence_inst_n(seq1, i);
     inst2 = tsequence_inst_n(seq2, j);
   }
-  /* We are sure that k != 0 due to the period intersection test above */
-  /* The last two values of sequences with step interpolation and
-     exclusive upper bound must be equal */
-  if (! inter->upper_inc && k > 1 && ! linear1)
-  {
-    if (datum_ne(tinstant_value(instants1[k - 2]),
-      tinstant_value(instants1[k - 1]), seq1->valuetypid))
-    {
-      instants1[k - 1] = tinstant_make(tinstant_value(instants1[k - 2]),
-        instants1[k - 1]->t, instants1[k - 1]->valuetypid);
-      tofree[l++] = instants1[k - 1];
-    }
-  }
-  if (! inter->upper_inc && k > 1 && ! linear2)
-  {
-    if (datum_ne(tinstant_value(instants2[k - 2]),
-      tinstant_value(instants2[k - 1]), seq2->valuetypid))
-    {
-      instants2[k - 1] = tinstant_make(tinstant_value(instants2[k - 2]),
-        instants2[k - 1]->t, instants2[k - 1]->valuetypid);
-      tofree[l++] = instants2[k - 1];
-    }
-  }
-  *sync1 = tsequence_make(instants1, k, inter->lower_inc,
-    inter->upper_inc, linear1, NORMALIZE_NO);
-  *sync2 = tsequence_make(instants2, k, inter->lower_inc,
-    inter->upper_inc, linear2, NORMALIZE_NO);
+  /* We are sure that k != 0 due to the period intersection test above.
+   * The builders make equal the last two values of sequences with step
+   * interpolation and exclusive upper bound */
+  *sync1 = tsequence_builder_finish(&b1, inter->lower_inc, inter->upper_inc);
+  *sync2 = tsequence_builder_finish(&b2, inter->lower_inc, inter->upper_inc);
 
   for (i = 0; i < l; i++)
     pfree(tofree[i]);
-  pfree(instants1); pfree(instants2); pfree(tofree); pfree(inter);
+  pfree(tofree); pfree(inter);
 
   return true;
 }
@@ -1705,6 +2540,7 @@ tintseq_to_tfloatseq(const TSequence *seq)
     Datum *value_ptr = tinstant_value_ptr(inst);
     *value_ptr = Float8GetDatum((double)DatumGetInt32(tinstant_value(inst)));
   }
+  tsequence_reset_blocks(result);
   return result;
 }
 
@@ -1728,6 +2564,7 @@ tfloatseq_to_tintseq(const TSequence *seq)
     Datum *value_ptr = tinstant_value_ptr(inst);
     *value_ptr = Int32GetDatum((double)DatumGetFloat8(tinstant_value(inst)));
   }
+  tsequence_reset_blocks(result);
   return result;
 }
 
@@ -1741,7 +2578,7 @@ tfloatseq_to_tintseq(const TSequence *seq)
 TSequence *
 tinstant_to_tsequence(const TInstant *inst, bool linear)
 {
-  return tsequence_make((TInstant **)&inst, 1, true, true, linear, NORMALIZE_NO);
+  return tsequence_make1((TInstant **)&inst, 1, true, true, linear, NORMALIZE_NO);
 }
 
 /**
@@ -1802,7 +2639,7 @@ tstepseq_to_linear1(TSequence **result, const TSequence *seq)
     instants[1] = tinstant_make(value1, inst2->t, seq->valuetypid);
     bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc &&
       datum_eq(value1, value2, seq->valuetypid) : false;
-    result[k++] = tsequence_make(instants, 2, lower_inc, upper_inc,
+    result[k++] = tsequence_make1(instants, 2, lower_inc, upper_inc,
       LINEAR, NORMALIZE_NO);
     inst1 = inst2;
     value1 = value2;
@@ -1831,7 +2668,7 @@ tstepseq_to_linear(const TSequence *seq)
 {
   TSequence **sequences = palloc(sizeof(TSequence *) * seq->count);
   int count = tstepseq_to_linear1(sequences, seq);
-  return tsequenceset_make_free(sequences, count, NORMALIZE_NO);
+  return tsequenceset_make_free1(sequences, count, NORMALIZE_NO);
 }
 
 /*****************************************************************************
@@ -2157,6 +2994,7 @@ tsequence_shift_tscale(const TSequence *seq, const Interval *start,
   assert(start != NULL || duration != NULL);
   TSequence *result = tsequence_copy(seq);
   /* Shift and/or scale the period */
+  TimestampTz orig_lower = seq->period.lower;
   double orig_duration = (double) (seq->period.upper - seq->period.lower);
   period_shift_tscale(&result->period, start, duration);
   double new_duration = (double) (result->period.upper - result->period.lower);
@@ -2166,12 +3004,23 @@ tsequence_shift_tscale(const TSequence *seq, const Interval *start,
   inst->t = result->period.lower;
   if (seq->count > 1)
   {
-    /* Shift and/or scale from the second to the penultimate instant */
-    for (int i = 1; i < seq->count - 1; i++)
+    /* Shift and/or scale from the second to the penultimate instant.
+     * When the duration is kept, which is the case when the value is only
+     * shifted, all timestamps are moved by the same delta */
+    if (new_duration == orig_duration)
+    {
+      TimestampTz delta = result->period.lower - orig_lower;
+      for (int i = 1; i < seq->count - 1; i++)
+        tsequence_inst_n(result, i)->t += delta;
+    }
+    else
     {
-      TInstant *inst = tsequence_inst_n(result, i);
-      double fraction = (double) (inst->t - seq->period.lower) / orig_duration;
-      inst->t = (TimestampTz) ((long) result->period.lower + (long) (new_duration * fraction));
+      for (int i = 1; i < seq->count - 1; i++)
+      {
+        TInstant *inst = tsequence_inst_n(result, i);
+        double fraction = (double) (inst->t - orig_lower) / orig_duration;
+        inst->t = (TimestampTz) ((long) result->period.lower + (long) (new_duration * fraction));
+      }
     }
     /* Set the last instant */
     TInstant *inst = tsequence_inst_n(result, seq->count - 1);
@@ -2180,6 +3029,28 @@ tsequence_shift_tscale(const TSequence *seq, const Interval *start,
   /* Shift and/or scale bounding box */
   void *bbox = tsequence_bbox_ptr(result);
   temporal_bbox_shift_tscale(bbox, start, duration, seq->valuetypid);
+  /* Set the time span of the blocks from their new first and last instants */
+  int nblocks = tsequence_block_count(result);
+  for (int i = 0; i < nblocks; i++)
+  {
+    int first = i * TSEQUENCE_BLOCK_SIZE;
+    int last = Min(first + TSEQUENCE_BLOCK_SIZE, result->count - 1);
+    TimestampTz tmin = tsequence_inst_n(result, first)->t;
+    TimestampTz tmax = tsequence_inst_n(result, last)->t;
+    void *box = tsequence_block_bbox_ptr(result, i);
+    if (talpha_base_type(seq->valuetypid))
+      period_set((Period *) box, tmin, tmax, true, true);
+    else if (tnumber_base_type(seq->valuetypid))
+    {
+      ((TBOX *) box)->tmin = tmin;
+      ((TBOX *) box)->tmax = tmax;
+    }
+    else /* tgeo_base_type(seq->valuetypid) */
+    {
+      ((STBOX *) box)->tmin = tmin;
+      ((STBOX *) box)->tmax = tmax;
+    }
+  }
   return result;
 }
 
@@ -2223,6 +3094,77 @@ tlinearseq_ever_eq1(const TInstant *inst1, const TInstant *inst2,
     NULL, NULL);
 }
 
+/**
+ * Returns true if the bounding box of a block of a temporal number or a
+ * planar temporal point contains the base value
+ *
+ * @note Only the value dimensions of the box are tested
+ *
+ * @param[in] box Bounding box of the block
+ * @param[in] valuetypid Oid of the base type
+ * @param[in] value Base value
+ * @param[in] valuebox Bounding box of the value for temporal points
+ */
+static bool
+tsequence_block_ever_eq(const void *box, Oid valuetypid, Datum value,
+  const STBOX *valuebox)
+{
+  if (tnumber_base_type(valuetypid))
+  {
+    const TBOX *box1 = (const TBOX *) box;
+    double d = datum_double(value, valuetypid);
+    return box1->xmin <= d && d <= box1->xmax;
+  }
+  return contains_stbox_stbox_internal((const STBOX *) box, valuebox);
+}
+
+/**
+ * Returns true if the temporal value is ever equal to the base value
+ * skipping the blocks whose bounding box does not contain the value
+ */
+static bool
+tsequence_ever_eq_blocks(const TSequence *seq, Datum value)
+{
+  STBOX valuebox;
+  memset(&valuebox, 0, sizeof(STBOX));
+  if (tgeo_base_type(seq->valuetypid))
+    geo_to_stbox_internal(&valuebox, (GSERIALIZED *)DatumGetPointer(value));
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  int nblocks = tsequence_block_count(seq);
+  for (int i = 0; i < nblocks; i++)
+  {
+    if (! tsequence_block_ever_eq(tsequence_block_bbox_ptr(seq, i),
+        seq->valuetypid, value, &valuebox))
+      continue;
+    int first = i * TSEQUENCE_BLOCK_SIZE;
+    int last = Min(first + TSEQUENCE_BLOCK_SIZE, seq->count - 1);
+    /* Stepwise interpolation */
+    if (! linear)
+    {
+      for (int j = first; j <= last; j++)
+      {
+        Datum value1 = tinstant_value(tsequence_inst_n(seq, j));
+        if (datum_eq(value1, value, seq->valuetypid))
+          return true;
+      }
+      continue;
+    }
+    /* Linear interpolation */
+    TInstant *inst1 = tsequence_inst_n(seq, first);
+    bool lower_inc = (first == 0) ? seq->period.lower_inc : true;
+    for (int j = first + 1; j <= last; j++)
+    {
+      TInstant *inst2 = tsequence_inst_n(seq, j);
+      bool upper_inc = (j == seq->count - 1) ? seq->period.upper_inc : false;
+      if (tlinearseq_ever_eq1(inst1, inst2, lower_inc, upper_inc, value))
+        return true;
+      inst1 = inst2;
+      lower_inc = true;
+    }
+  }
+  return false;
+}
+
 /**
  * Returns true if the temporal value is ever equal to the base value
  */
@@ -2233,6 +3175,10 @@ tsequence_ever_eq(const TSequence *seq, Datum value)
   if (! temporal_bbox_ev_al_eq((Temporal *)seq, value, EVER))
     return false;
 
+  /* Long sequence with a block directory */
+  if (MOBDB_FLAGS_GET_BLOCKS(seq->flags))
+    return tsequence_ever_eq_blocks(seq, value);
+
   /* Stepwise interpolation or instantaneous sequence */
   if (! MOBDB_FLAGS_GET_LINEAR(seq->flags) || seq->count == 1)
   {
@@ -2525,7 +3471,7 @@ tsequence_restrict_value2(TSequence **result,
   {
     instants[0] = (TInstant *) inst1;
     instants[1] = (TInstant *) inst2;
-    result[0] = tsequence_make(instants, 2, lower_inc && lower,
+    result[0] = tsequence_make1(instants, 2, lower_inc && lower,
       upper_inc && upper, linear, NORMALIZE_NO);
     return 1;
   }
@@ -2538,7 +3484,7 @@ tsequence_restrict_value2(TSequence **result,
     {
       instants[0] = (TInstant *) inst1;
       instants[1] = tinstant_make(value1, inst2->t, valuetypid);
-      result[k++] = tsequence_make(instants, 2, lower_inc, false,
+      result[k++] = tsequence_make1(instants, 2, lower_inc, false,
         linear, NORMALIZE_NO);
       pfree(instants[1]);
     }
@@ -2568,11 +3514,11 @@ tsequence_restrict_value2(TSequence **result,
     {
       instants[0] = (TInstant *) inst1;
       instants[1] = tinstant_make(projvalue, t, valuetypid);
-      result[0] = tsequence_make(instants, 2, lower_inc, false,
+      result[0] = tsequence_make1(instants, 2, lower_inc, false,
         LINEAR, NORMALIZE_NO);
       instants[0] = instants[1];
       instants[1] = (TInstant *) inst2;
-      result[1] = tsequence_make(instants, 2, false, upper_inc,
+      result[1] = tsequence_make1(instants, 2, false, upper_inc,
         LINEAR, NORMALIZE_NO);
       pfree(instants[0]);
       DATUM_FREE(projvalue, valuetypid);
@@ -2625,6 +3571,14 @@ tsequence_restrict_value1(TSequence **result, const TSequence *seq, Datum value,
     return 1;
   }
 
+  /* The segments of the blocks whose bounding box does not contain the
+   * value are not in the result of the at function */
+  int nblocks = atfunc ? tsequence_block_count(seq) : 0;
+  STBOX valuebox;
+  memset(&valuebox, 0, sizeof(STBOX));
+  if (nblocks > 0 && tgeo_base_type(seq->valuetypid))
+    geo_to_stbox_internal(&valuebox, (GSERIALIZED *)DatumGetPointer(value));
+
   /* General case */
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
   inst1 = tsequence_inst_n(seq, 0);
@@ -2632,6 +3586,16 @@ tsequence_restrict_value1(TSequence **result, const TSequence *seq, Datum value,
   int k = 0;
   for (int i = 1; i < seq->count; i++)
   {
+    if (nblocks > 0 && (i - 1) % TSEQUENCE_BLOCK_SIZE == 0 &&
+      ! tsequence_block_ever_eq(tsequence_block_bbox_ptr(seq, 
+          (i - 1) / TSEQUENCE_BLOCK_SIZE), seq->valuetypid, value, &valuebox))
+    {
+      /* Continue with the last instant of the block */
+      i = Min(i - 1 + TSEQUENCE_BLOCK_SIZE, seq->count - 1);
+      inst1 = tsequence_inst_n(seq, i);
+      lower_inc = true;
+      continue;
+    }
     TInstant *inst2 = tsequence_inst_n(seq, i);
     bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
     k += tsequence_restrict_value2(&result[k], inst1, inst2, linear,
@@ -2662,7 +3626,7 @@ tsequence_restrict_value(const TSequence *seq, Datum value, bool atfunc)
     count *= 2;
   TSequence **sequences = palloc(sizeof(TSequence *) * count);
   int newcount = tsequence_restrict_value1(sequences, seq, value, atfunc);
-  return tsequenceset_make_free(sequences, newcount, NORMALIZE);
+  return tsequenceset_make_free1(sequences, newcount, NORMALIZE);
 }
 
 /*****************************************************************************/
@@ -2676,7 +3640,7 @@ tsequence_restrict_value(const TSequence *seq, Datum value, bool atfunc)
  * @param[in] values Array of base values
  * @param[in] count Number of elements in the input array
  * @return Number of resulting sequences returned
- * @pre There are no duplicates values in the array
+ * @pre The array is sorted and there are no duplicates values in it
  * @note This function is called for each sequence of a temporal sequence set
  */
 int
@@ -2706,6 +3670,8 @@ tsequence_at_values1(TSequence **result, const TSequence *seq,
 
   /* General case */
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  bool search = ! tgeo_base_type(seq->valuetypid);
+  Oid valuetypid = seq->valuetypid;
   inst1 = tsequence_inst_n(seq, 0);
   bool lower_inc = seq->period.lower_inc;
   int k = 0;
@@ -2713,9 +3679,43 @@ tsequence_at_values1(TSequence **result, const TSequence *seq,
   {
     inst2 = tsequence_inst_n(seq, i);
     bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-    for (int j = 0; j < count; j++)
-      k += tsequence_restrict_value2(&result[k], inst1, inst2, linear,
-        lower_inc, upper_inc, values[j], REST_AT);
+    if (! search)
+    {
+      /* Points are not ordered in a way compatible with their equality */
+      for (int j = 0; j < count1; j++)
+        k += tsequence_restrict_value2(&result[k], inst1, inst2, linear,
+          lower_inc, upper_inc, values1[j], REST_AT);
+    }
+    else if (! linear)
+    {
+      /* Only the values of the bounds of the segment may be in the answer
+       * and they are found by binary search in the sorted array */
+      Datum value1 = tinstant_value(inst1);
+      Datum value2 = tinstant_value(inst2);
+      if (datumarr_contains(values1, count1, value1, valuetypid))
+        k += tsequence_restrict_value2(&result[k], inst1, inst2, linear,
+          lower_inc, upper_inc, value1, REST_AT);
+      if (upper_inc && datum_ne(value1, value2, valuetypid) &&
+          datumarr_contains(values1, count1, value2, valuetypid))
+        k += tsequence_restrict_value2(&result[k], inst1, inst2, linear,
+          lower_inc, upper_inc, value2, REST_AT);
+    }
+    else
+    {
+      /* Only the values between the bounds of the segment may be in the
+       * answer and they are found by binary search in the sorted array */
+      Datum value1 = tinstant_value(inst1);
+      Datum value2 = tinstant_value(inst2);
+      Datum min = value1, max = value2;
+      if (datum_lt(value2, value1, valuetypid))
+      {
+        min = value2; max = value1;
+      }
+      for (int j = datumarr_lower_bound(values1, count1, min, valuetypid);
+        j < count1 && datum_le(values1[j], max, valuetypid); j++)
+        k += tsequence_restrict_value2(&result[k], inst1, inst2, linear,
+          lower_inc, upper_inc, values1[j], REST_AT);
+    }
     inst1 = inst2;
     lower_inc = true;
   }
@@ -2745,7 +3745,7 @@ tsequence_restrict_values(const TSequence *seq, const Datum *values, int count,
   /* General case */
   TSequence **sequences = palloc(sizeof(TSequence *) * seq->count * count * 2);
   int newcount = tsequence_at_values1(sequences, seq, values, count);
-  TSequenceSet *atresult = tsequenceset_make_free(sequences, newcount, NORMALIZE);
+  TSequenceSet *atresult = tsequenceset_make_free1(sequences, newcount, NORMALIZE);
   if (atfunc)
     return atresult;
 
@@ -2804,7 +3804,7 @@ tnumberseq_restrict_range2(TSequence **result,
       return 0;
     instants[0] = (TInstant *) inst1;
     instants[1] = (TInstant *) inst2;
-    result[0] = tsequence_make(instants, 2, lower_inclu, upper_inclu,
+    result[0] = tsequence_make1(instants, 2, lower_inclu, upper_inclu,
       linear, NORMALIZE_NO);
     return 1;
   }
@@ -2818,7 +3818,7 @@ tnumberseq_restrict_range2(TSequence **result,
     {
       instants[0] = (TInstant *) inst1;
       instants[1] = tinstant_make(value1, inst2->t, valuetypid);
-      result[k++] = tsequence_make(instants, 2, lower_inclu, false,
+      result[k++] = tsequence_make1(instants, 2, lower_inclu, false,
         linear, NORMALIZE_NO);
       pfree(instants[1]);
     }
@@ -2853,7 +3853,7 @@ tnumberseq_restrict_range2(TSequence **result,
     /* MINUS */
     instants[0] = (TInstant *) inst1;
     instants[1] = (TInstant *) inst2;
-    result[0] = tsequence_make(instants, 2, lower_inclu, upper_inclu,
+    result[0] = tsequence_make1(instants, 2, lower_inclu, upper_inclu,
       linear, NORMALIZE_NO);
     return 1;
   }
@@ -2893,7 +3893,7 @@ tnumberseq_restrict_range2(TSequence **result,
     }
     instants[0] = (TInstant *)inst1;
     instants[1] = (TInstant *)inst2;
-    result[0] = tsequence_make(instants, 2, lower_inc1, upper_inc1,
+    result[0] = tsequence_make1(instants, 2, lower_inc1, upper_inc1,
       linear, NORMALIZE_NO);
     return 1;
   }
@@ -2942,7 +3942,7 @@ tnumberseq_restrict_range2(TSequence **result,
     }
 
     /* Create the result */
-    result[0] = tsequence_make(instants, 2, lower_inc1, upper_inc1,
+    result[0] = tsequence_make1(instants, 2, lower_inc1, upper_inc1,
       linear, NORMALIZE_NO);
     if (freei)
       pfree(instants[i]);
@@ -2977,18 +3977,18 @@ tnumberseq_restrict_range2(TSequence **result,
   {
     instants[0] = (TInstant *) inst1;
     instants[1] = instbounds[0];
-    result[k++] = tsequence_make(instants, 2, lower_inclu, lower_inc1,
+    result[k++] = tsequence_make1(instants, 2, lower_inclu, lower_inc1,
       linear, NORMALIZE_NO);
     instants[0] = instbounds[1];
     instants[1] = (TInstant *) inst2;
-    result[k++] = tsequence_make(instants, 2, upper_inc1, upper_inclu,
+    result[k++] = tsequence_make1(instants, 2, upper_inc1, upper_inclu,
       linear, NORMALIZE_NO);
   }
   else if (instbounds[0] != NULL)
   {
     instants[0] = (TInstant *) inst1;
     instants[1] = instbounds[0];
-    result[k++] = tsequence_make(instants, 2, lower_inclu, lower_inc1,
+    result[k++] = tsequence_make1(instants, 2, lower_inclu, lower_inc1,
       linear, NORMALIZE_NO);
     if (upper_inclu && upper_inc1)
       result[k++] = tinstant_to_tsequence(inst2, linear);
@@ -2999,7 +3999,7 @@ tnumberseq_restrict_range2(TSequence **result,
       result[k++] = tinstant_to_tsequence(inst1, linear);
     instants[0] = instbounds[1];
     instants[1] = (TInstant *) inst2;
-    result[k++] = tsequence_make(instants, 2, upper_inc1, upper_inclu,
+    result[k++] = tsequence_make1(instants, 2, upper_inc1, upper_inclu,
       linear, NORMALIZE_NO);
   }
 
@@ -3095,7 +4095,7 @@ tnumberseq_restrict_range(const TSequence *seq, RangeType *range, bool atfunc)
     count *= 2;
   TSequence **sequences = palloc(sizeof(TSequence *) * count);
   int newcount = tnumberseq_restrict_range1(sequences, seq, range, atfunc);
-  return tsequenceset_make_free(sequences, newcount, NORMALIZE);
+  return tsequenceset_make_free1(sequences, newcount, NORMALIZE);
 }
 
 /*****************************************************************************/
@@ -3137,6 +4137,7 @@ tnumberseq_restrict_ranges1(TSequence **result, const TSequence *seq,
         return 1;
       }
     }
+    count = newcount;
   }
   else
     newranges = normranges;
@@ -3163,6 +4164,9 @@ tnumberseq_restrict_ranges1(TSequence **result, const TSequence *seq,
   {
     /* AT function */
     bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+    double *lower = palloc(sizeof(double) * count);
+    double *upper = palloc(sizeof(double) * count);
+    rangearr_bounds(newranges, count, lower, upper);
     inst1 = tsequence_inst_n(seq, 0);
     bool lower_inc = seq->period.lower_inc;
     int k = 0;
@@ -3170,7 +4174,22 @@ tnumberseq_restrict_ranges1(TSequence **result, const TSequence *seq,
     {
       inst2 = tsequence_inst_n(seq, i);
       bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-      for (int j = 0; j < count; j++)
+      /* Only the ranges overlapping the values of the segment may give a
+       * result. Since the ranges are normalized they are sorted and
+       * disjoint, so the first one is found by binary search */
+      double value1 = datum_double(tinstant_value(inst1), seq->valuetypid);
+      double value2 = datum_double(tinstant_value(inst2), seq->valuetypid);
+      double min = Min(value1, value2), max = Max(value1, value2);
+      int first = 0, last = count;
+      while (first < last)
+      {
+        int middle = first + (last - first) / 2;
+        if (upper[middle] < min)
+          first = middle + 1;
+        else
+          last = middle;
+      }
+      for (int j = first; j < count && lower[j] <= max; j++)
       {
         k += tnumberseq_restrict_range2(&result[k], inst1, inst2, linear,
           lower_inc, upper_inc, newranges[j], REST_AT);
@@ -3178,6 +4197,7 @@ tnumberseq_restrict_ranges1(TSequence **result, const TSequence *seq,
       inst1 = inst2;
       lower_inc = true;
     }
+    pfree(lower); pfree(upper);
     if (bboxtest)
       pfree(newranges);
     if (k > 1)
@@ -3240,7 +4260,7 @@ tnumberseq_restrict_ranges(const TSequence *seq, RangeType **normranges,
   TSequence **sequences = palloc(sizeof(TSequence *) * maxcount);
   int newcount = tnumberseq_restrict_ranges1(sequences, seq, normranges,
     count, atfunc, bboxtest);
-  return tsequenceset_make_free(sequences, newcount, NORMALIZE);
+  return tsequenceset_make_free1(sequences, newcount, NORMALIZE);
 }
 
 /*****************************************************************************/
@@ -3387,6 +4407,105 @@ tsequence_value_at_timestamp_inc(const TSequence *seq, TimestampTz t, Datum *res
   return tsequence_value_at_timestamp(seq, t, result);
 }
 
+/**
+ * Returns the base values of the temporal value at the timestamps
+ *
+ * The segment of each timestamp is searched from the one of the previous
+ * timestamp when the timestamps are increasing. For temporal floats with
+ * linear interpolation, the segments are located first and the values are
+ * then interpolated in a loop without data-dependent branches that the
+ * compiler can vectorize.
+ *
+ * @param[in] seq Temporal value
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the array
+ * @param[out] values Array of base values
+ * @param[out] found Array stating whether each timestamp is contained in
+ * the temporal value
+ * @result Returns the number of timestamps contained in the temporal value
+ */
+int
+tsequence_values_at_timestamps(const TSequence *seq, const TimestampTz *times,
+  int count, Datum *values, bool *found)
+{
+  int result = 0;
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+  {
+    TInstant *inst = tsequence_inst_n(seq, 0);
+    for (int i = 0; i < count; i++)
+    {
+      found[i] = (inst->t == times[i]);
+      if (found[i])
+      {
+        values[i] = tinstant_value_copy(inst);
+        result++;
+      }
+    }
+    return result;
+  }
+
+  /* General case */
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+  int *segs = palloc(sizeof(int) * count);
+  int n = 0;
+  TimestampTz last = seq->period.lower;
+  for (int i = 0; i < count; i++)
+  {
+    found[i] = contains_period_timestamp_internal(&seq->period, times[i]);
+    if (! found[i])
+    {
+      /* Any segment can be used for the interpolation below */
+      segs[i] = n;
+      continue;
+    }
+    if (times[i] < last)
+      n = 0;
+    n = tsequence_find_timestamp_from(seq, times[i], n);
+    segs[i] = n;
+    last = times[i];
+    result++;
+  }
+
+  if (linear && seq->valuetypid == FLOAT8OID)
+  {
+    double *start = palloc(sizeof(double) * count);
+    double *end = palloc(sizeof(double) * count);
+    TimestampTz *lower = palloc(sizeof(TimestampTz) * count);
+    TimestampTz *upper = palloc(sizeof(TimestampTz) * count);
+    for (int i = 0; i < count; i++)
+    {
+      TInstant *inst1 = tsequence_inst_n(seq, segs[i]);
+      TInstant *inst2 = tsequence_inst_n(seq, segs[i] + 1);
+      start[i] = DatumGetFloat8(tinstant_value(inst1));
+      end[i] = DatumGetFloat8(tinstant_value(inst2));
+      lower[i] = inst1->t;
+      upper[i] = inst2->t;
+    }
+    /* The value at the upper bound of a segment is taken as is to avoid
+     * rounding errors in the interpolation */
+    for (int i = 0; i < count; i++)
+    {
+      double ratio = (double) (times[i] - lower[i]) /
+        (double) (upper[i] - lower[i]);
+      double value = start[i] + (end[i] - start[i]) * ratio;
+      values[i] = Float8GetDatum(times[i] == upper[i] ? end[i] : value);
+    }
+    pfree(start); pfree(end); pfree(lower); pfree(upper);
+  }
+  else
+  {
+    for (int i = 0; i < count; i++)
+    {
+      if (found[i])
+        values[i] = tsequence_value_at_timestamp1(tsequence_inst_n(seq, segs[i]),
+          tsequence_inst_n(seq, segs[i] + 1), linear, times[i]);
+    }
+  }
+  pfree(segs);
+  return result;
+}
+
 /**
  * Restricts the segment of a temporal value to the timestamp
  *
@@ -3473,14 +4592,14 @@ tsequence_minus_timestamp1(TSequence **result, const TSequence *seq,
       if (linear)
       {
         instants[n] = inst1;
-        result[k++] = tsequence_make(instants, n + 1,
+        result[k++] = tsequence_make1(instants, n + 1,
           seq->period.lower_inc, false, linear, NORMALIZE_NO);
       }
       else
       {
         instants[n] = tinstant_make(tinstant_value(instants[n - 1]), t,
           inst1->valuetypid);
-        result[k++] = tsequence_make(instants, n + 1,
+        result[k++] = tsequence_make1(instants, n + 1,
           seq->period.lower_inc, false, linear, NORMALIZE_NO);
         pfree(instants[n]);
       }
@@ -3493,7 +4612,7 @@ tsequence_minus_timestamp1(TSequence **result, const TSequence *seq,
         tsequence_at_timestamp1(inst1, inst2, true, t) :
         tinstant_make(tinstant_value(inst1), t,
           inst1->valuetypid);
-      result[k++] = tsequence_make(instants, n + 2,
+      result[k++] = tsequence_make1(instants, n + 2,
         seq->period.lower_inc, false, linear, NORMALIZE_NO);
       pfree(instants[n + 1]);
     }
@@ -3506,7 +4625,7 @@ tsequence_minus_timestamp1(TSequence **result, const TSequence *seq,
     instants[0] = tsequence_at_timestamp1(inst1, inst2, linear, t);
     for (int i = 1; i < seq->count - n; i++)
       instants[i] = tsequence_inst_n(seq, i + n);
-    result[k++] = tsequence_make(instants, seq->count - n,
+    result[k++] = tsequence_make1(instants, seq->count - n,
       false, seq->period.upper_inc, linear, NORMALIZE_NO);
     pfree(instants[0]);
   }
@@ -3527,7 +4646,7 @@ tsequence_minus_timestamp(const TSequence *seq, TimestampTz t)
   int count = tsequence_minus_timestamp1((TSequence **)sequences, seq, t);
   if (count == 0)
     return NULL;
-  TSequenceSet *result = tsequenceset_make(sequences, count, NORMALIZE_NO);
+  TSequenceSet *result = tsequenceset_make1(sequences, count, NORMALIZE_NO);
   for (int i = 0; i < count; i++)
     pfree(sequences[i]);
   return result;
@@ -3567,18 +4686,27 @@ tsequence_at_timestampset(const TSequence *seq, const TimestampSet *ts)
     return tinstantset_make(&inst, 1);
   }
 
-  /* General case */
+  /* General case: since both the timestamps and the instants are ordered,
+   * the segment of each timestamp is searched from the one of the previous
+   * timestamp */
   TimestampTz t = Max(seq->period.lower, p->lower);
   int loc;
   timestampset_find_timestamp(ts, t, &loc);
+  bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
   TInstant **instants = palloc(sizeof(TInstant *) * (ts->count - loc));
-  int k = 0;
+  int k = 0, n = 0;
   for (int i = loc; i < ts->count; i++)
   {
     t = timestampset_time_n(ts, i);
-    inst = tsequence_at_timestamp(seq, t);
-    if (inst != NULL)
-      instants[k++] = inst;
+    if (! contains_period_timestamp_internal(&seq->period, t))
+    {
+      if (t >= seq->period.upper)
+        break;
+      continue;
+    }
+    n = tsequence_find_timestamp_from(seq, t, n);
+    instants[k++] = tsequence_at_timestamp1(tsequence_inst_n(seq, n),
+      tsequence_inst_n(seq, n + 1), linear, t);
   }
   return tinstantset_make_free(instants, k);
 }
@@ -3646,7 +4774,7 @@ tsequence_minus_timestampset1(TSequence **result, const TSequence *seq,
       if (linear)
       {
         instants[l] = inst;
-        result[k++] = tsequence_make(instants, l + 1,
+        result[k++] = tsequence_make1(instants, l + 1,
           lower_inc, false, linear, NORMALIZE_NO);
         instants[0] = inst;
       }
@@ -3654,7 +4782,7 @@ tsequence_minus_timestampset1(TSequence **result, const TSequence *seq,
       {
         instants[l] = tinstant_make(tinstant_value(instants[l - 1]),
           t, inst->valuetypid);
-        result[k++] = tsequence_make(instants, l + 1,
+        result[k++] = tsequence_make1(instants, l + 1,
           lower_inc, false, linear, NORMALIZE_NO);
         pfree(instants[l]);
         if (tofree)
@@ -3679,7 +4807,7 @@ tsequence_minus_timestampset1(TSequence **result, const TSequence *seq,
           tsequence_at_timestamp1(instants[l - 1], inst, true, t) :
           tinstant_make(tinstant_value(instants[l - 1]), t,
             inst->valuetypid);
-        result[k++] = tsequence_make(instants, l + 1,
+        result[k++] = tsequence_make1(instants, l + 1,
           lower_inc, false, linear, NORMALIZE_NO);
         if (tofree)
           pfree(tofree);
@@ -3695,7 +4823,7 @@ tsequence_minus_timestampset1(TSequence **result, const TSequence *seq,
   {
     for (j = i; j < seq->count; j++)
       instants[l++] = tsequence_inst_n(seq, j);
-    result[k++] = tsequence_make(instants, l,
+    result[k++] = tsequence_make1(instants, l,
       false, seq->period.upper_inc, linear, NORMALIZE_NO);
   }
   if (tofree)
@@ -3711,16 +4839,23 @@ tsequence_minus_timestampset(const TSequence *seq, const TimestampSet *ts)
 {
   TSequence **sequences = palloc0(sizeof(TSequence *) * (ts->count + 1));
   int count = tsequence_minus_timestampset1(sequences, seq, ts);
-  return tsequenceset_make_free(sequences, count, NORMALIZE);
+  return tsequenceset_make_free1(sequences, count, NORMALIZE);
 }
 
 /*****************************************************************************/
 
 /**
  * Restricts the temporal value to the period
+ *
+ * @param[in] seq Temporal value
+ * @param[in] p Period
+ * @param[in,out] from Segment from which the lower bound of the period is
+ * searched, which is set to the segment of the upper bound of the period
+ * so that the restriction to the next period of a period set starts
+ * from there
  */
-TSequence *
-tsequence_at_period(const TSequence *seq, const Period *p)
+static TSequence *
+tsequence_at_period1(const TSequence *seq, const Period *p, int *from)
 {
   /* Bounding box test */
   if (!overlaps_period_period_internal(&seq->period, p))
@@ -3735,19 +4870,18 @@ tsequence_at_period(const TSequence *seq, const Period *p)
   Period *inter = intersection_period_period_internal(&seq->period, p);
   bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
   TSequence *result;
+  int n = tsequence_find_timestamp_from(seq, inter->lower, *from);
   /* Intersecting period is instantaneous */
   if (inter->lower == inter->upper)
   {
-    inst1 = tsequence_at_timestamp(seq, inter->lower);
+    inst1 = tsequence_at_timestamp1(tsequence_inst_n(seq, n),
+      tsequence_inst_n(seq, n + 1), linear, inter->lower);
     result = tinstant_to_tsequence(inst1, linear);
     pfree(inst1); pfree(inter);
+    *from = n;
     return result;
   }
 
-  int n = tsequence_find_timestamp(seq, inter->lower);
-  /* If the lower bound of the intersecting period is exclusive */
-  if (n == -1)
-    n = 0;
   TInstant **instants = palloc(sizeof(TInstant *) * (seq->count - n));
   /* Compute the value at the beginning of the intersecting period */
   inst1 = tsequence_inst_n(seq, n);
@@ -3762,6 +4896,7 @@ tsequence_at_period(const TSequence *seq, const Period *p)
 
     inst1 = inst2;
     inst2 = tsequence_inst_n(seq, i);
+    n++;
     /* If the intersecting period contains inst1 */
     if (inter->lower <= inst1->t && inst1->t <= inter->upper)
       instants[k++] = inst1;
@@ -3778,14 +4913,24 @@ tsequence_at_period(const TSequence *seq, const Period *p)
   }
   /* Since by definition the sequence is normalized it is not necessary to
    * normalize the projection of the sequence to the period */
-  result = tsequence_make(instants, k, inter->lower_inc, inter->upper_inc,
+  result = tsequence_make1(instants, k, inter->lower_inc, inter->upper_inc,
     linear, NORMALIZE_NO);
 
   pfree(instants[0]); pfree(instants[k - 1]); pfree(instants); pfree(inter);
-
+  *from = n;
   return result;
 }
 
+/**
+ * Restricts the temporal value to the period
+ */
+TSequence *
+tsequence_at_period(const TSequence *seq, const Period *p)
+{
+  int from = 0;
+  return tsequence_at_period1(seq, p, &from);
+}
+
 /**
  * Restricts the temporal value to the complement of the period
  *
@@ -3833,7 +4978,7 @@ tsequence_minus_period(const TSequence *seq, const Period *p)
   int count = tsequence_minus_period1(sequences, seq, p);
   if (count == 0)
     return NULL;
-  TSequenceSet *result = tsequenceset_make(sequences, count, NORMALIZE_NO);
+  TSequenceSet *result = tsequenceset_make1(sequences, count, NORMALIZE_NO);
   for (int i = 0; i < count; i++)
     pfree(sequences[i]);
   return result;
@@ -3860,7 +5005,7 @@ tsequence_at_periodset(TSequence **result, const TSequence *seq,
   if (ps->count == 1)
   {
     result[0] = tsequence_at_period(seq, periodset_per_n(ps, 0));
-    return 1;
+    return (result[0] == NULL) ? 0 : 1;
   }
 
   /* Bounding box test */
@@ -3878,14 +5023,15 @@ tsequence_at_periodset(TSequence **result, const TSequence *seq,
     return 1;
   }
 
-  /* General case */
+  /* General case: since the periods are ordered, the restriction to each
+   * period starts from the segment where the previous one ended */
   int loc;
   periodset_find_timestamp(ps, seq->period.lower, &loc);
-  int k = 0;
+  int k = 0, from = 0;
   for (int i = loc; i < ps->count; i++)
   {
     p = periodset_per_n(ps, i);
-    TSequence *seq1 = tsequence_at_period(seq, p);
+    TSequence *seq1 = tsequence_at_period1(seq, p, &from);
     if (seq1 != NULL)
       result[k++] = seq1;
     if (seq->period.upper < p->upper)
@@ -3980,7 +5126,7 @@ tsequence_restrict_periodset(const TSequence *seq, const PeriodSet *ps,
   TSequence **sequences = palloc(sizeof(TSequence *) * count);
   int count1 = atfunc ? tsequence_at_periodset(sequences, seq, ps) :
     tsequence_minus_periodset(sequences, seq, ps, 0);
-  return tsequenceset_make_free(sequences, count1, NORMALIZE_NO);
+  return tsequenceset_make_free1(sequences, count1, NORMALIZE_NO);
 }
 
 /*****************************************************************************
@@ -4035,31 +5181,50 @@ tsequence_intersects_periodset(const TSequence *seq, const PeriodSet *ps)
 
 /**
  * Returns the integral (area under the curve) of the temporal number
+ *
+ * @note The interpolation and the base type are tested once outside the
+ * loop so that each loop only reads the timestamps and the by-value
+ * base values of the instants
  */
 double
 tnumberseq_integral(const TSequence *seq)
 {
   double result = 0;
   TInstant *inst1 = tsequence_inst_n(seq, 0);
-  for (int i = 1; i < seq->count; i++)
+  if (MOBDB_FLAGS_GET_LINEAR(seq->flags))
   {
-    TInstant *inst2 = tsequence_inst_n(seq, i);
-    if (MOBDB_FLAGS_GET_LINEAR(seq->flags))
+    /* Linear interpolation: the area of each segment is a trapezoid */
+    double value1 = DatumGetFloat8(tinstant_value(inst1));
+    for (int i = 1; i < seq->count; i++)
     {
-      /* Linear interpolation */
-      double min = Min(DatumGetFloat8(tinstant_value(inst1)),
-        DatumGetFloat8(tinstant_value(inst2)));
-      double max = Max(DatumGetFloat8(tinstant_value(inst1)),
-        DatumGetFloat8(tinstant_value(inst2)));
-      result += (max + min) * (double) (inst2->t - inst1->t) / 2.0;
+      TInstant *inst2 = tsequence_inst_n(seq, i);
+      double value2 = DatumGetFloat8(tinstant_value(inst2));
+      result += (value1 + value2) * (double) (inst2->t - inst1->t);
+      inst1 = inst2;
+      value1 = value2;
     }
-    else
+    return result / 2.0;
+  }
+  /* Step interpolation: the area of each segment is a rectangle */
+  if (seq->valuetypid == INT4OID)
+  {
+    for (int i = 1; i < seq->count; i++)
     {
-      /* Step interpolation */
-      result += datum_double(tinstant_value(inst1), inst1->valuetypid) *
+      TInstant *inst2 = tsequence_inst_n(seq, i);
+      result += (double) DatumGetInt32(tinstant_value(inst1)) *
         (double) (inst2->t - inst1->t);
+      inst1 = inst2;
+    }
+  }
+  else
+  {
+    for (int i = 1; i < seq->count; i++)
+    {
+      TInstant *inst2 = tsequence_inst_n(seq, i);
+      result += DatumGetFloat8(tinstant_value(inst1)) *
+        (double) (inst2->t - inst1->t);
+      inst1 = inst2;
     }
-    inst1 = inst2;
   }
   return result;
 }
@@ -4096,7 +5261,7 @@ tsequence_eq(const TSequence *seq1, const TSequence *seq2)
 {
   assert(seq1->valuetypid == seq2->valuetypid);
   /* If number of sequences, flags, or periods are not equal */
-  if (seq1->count != seq2->count || seq1->flags != seq2->flags ||
+  if (seq1->count != seq2->count || MOBDB_FLAGS_LOGICAL(seq1->flags) != MOBDB_FLAGS_LOGICAL(seq2->flags) ||
       ! period_eq_internal(&seq1->period, &seq2->period))
     return false;
 
@@ -4178,6 +5343,9 @@ tsequence_cmp(const TSequence *seq1, const TSequence *seq2)
 
 /**
  * Returns the hash value of the temporal value
+ *
+ * @note An instantaneous sequence has the hash value of its instant since
+ * it is equal to the corresponding temporal instant
  */
 uint32
 tsequence_hash(const TSequence *seq)
@@ -4185,6 +5353,9 @@ tsequence_hash(const TSequence *seq)
   uint32 result;
   char flags = '\0';
 
+  if (seq->count == 1)
+    return tinstant_hash(tsequence_inst_n(seq, 0));
+
   /* Create flags from the lower_inc and upper_inc values */
   if (seq->period.lower_inc)
     flags |= 0x01;
@@ -4202,4 +5373,35 @@ tsequence_hash(const TSequence *seq)
   return result;
 }
 
+#if MOBDB_PGSQL_VERSION >= 110000
+/**
+ * Returns the 64-bit hash value of the temporal value using a seed
+ */
+uint64
+tsequence_hash_extended(const TSequence *seq, uint64 seed)
+{
+  uint64 result;
+  char flags = '\0';
+
+  if (seq->count == 1)
+    return tinstant_hash_extended(tsequence_inst_n(seq, 0), seed);
+
+  /* Create flags from the lower_inc and upper_inc values */
+  if (seq->period.lower_inc)
+    flags |= 0x01;
+  if (seq->period.upper_inc)
+    flags |= 0x02;
+  result = DatumGetUInt64(hash_uint32_extended((uint32) flags, seed));
+
+  /* Merge with hash of instants */
+  for (int i = 0; i < seq->count; i++)
+  {
+    TInstant *inst = tsequence_inst_n(seq, i);
+    uint64 inst_hash = tinstant_hash_extended(inst, seed);
+    result = (result << 5) - result + inst_hash;
+  }
+  return result;
+}
+#endif
+
 /*****************************************************************************/
@@ -13,6 +13,11 @@
 #include "tsequenceset.h"
 
 #include <assert.h>
+#if MOBDB_PGSQL_VERSION < 130000
+#include <access/tuptoaster.h>
+#else
+#include <access/detoast.h>
+#endif
 #include <libpq/pqformat.h>
 #include <utils/lsyscache.h>
 #include <utils/builtins.h>
@@ -35,25 +40,61 @@
  * General functions
  *****************************************************************************/
 
+/**
+ * Returns a pointer to the array of offsets of the temporal value
+ *
+ * In the original format, that is, for values without the version flag,
+ * the offsets follow the fixed-size part of the struct.
+ */
+static void *
+tsequenceset_offsets_ptr(const TSequenceSet *ts)
+{
+  if (! MOBDB_FLAGS_GET_VERSION(ts->flags))
+    return ((char *)ts) + double_pad(sizeof(TSequenceSet));
+  return (((char *)ts) + double_pad(sizeof(TSequenceSet)) +
+    double_pad(temporal_bbox_size(ts->valuetypid)));
+}
+
+/**
+ * Returns a pointer to the first sequence of the temporal value
+ */
+static char *
+tsequenceset_data_ptr(const TSequenceSet *ts)
+{
+  /* In the original format the offset array has an additional element
+   * keeping the offset of the bounding box */
+  if (! MOBDB_FLAGS_GET_VERSION(ts->flags))
+    return (char *)(tsequenceset_offsets_ptr(ts)) +
+      sizeof(size_t) * (ts->count + 1);
+  return (char *)(tsequenceset_offsets_ptr(ts)) +
+    double_pad(TEMPORAL_OFFSET_SIZE(ts->flags) * ts->count);
+}
+
 /**
  * Returns the n-th sequence of the temporal value
  */
 TSequence *
 tsequenceset_seq_n(const TSequenceSet *ts, int index)
 {
-  return (TSequence *)(
-    (char *)(&ts->offsets[ts->count + 1]) +   /* start of data */
-      ts->offsets[index]);          /* offset */
+  size_t offset = temporal_offset_get(tsequenceset_offsets_ptr(ts),
+    ts->flags, index);
+  return (TSequence *)(tsequenceset_data_ptr(ts) + offset);
 }
 
 /**
  * Returns a pointer to the precomputed bounding box of the temporal value
+ *
+ * The bounding box is located immediately after the fixed-size part of the
+ * struct so that it can be read by fetching only a prefix of the value.
+ * In the original format it is located after the sequences.
  */
 void *
 tsequenceset_bbox_ptr(const TSequenceSet *ts)
 {
-  return (char *)(&ts->offsets[ts->count + 1]) +  /* start of data */
-    ts->offsets[ts->count];            /* offset */
+  if (! MOBDB_FLAGS_GET_VERSION(ts->flags))
+    return tsequenceset_data_ptr(ts) +
+      temporal_offset_get(tsequenceset_offsets_ptr(ts), ts->flags, ts->count);
+  return ((char *)ts) + double_pad(sizeof(TSequenceSet));
 }
 
 /**
@@ -74,38 +115,42 @@ tsequenceset_bbox(void *box, const TSequenceSet *ts)
  * For example, the memory structure of a temporal sequence set value
  * with 2 sequences is as follows
  * @code
- * --------------------------------------------------------
- * ( TSequenceSet )_X | offset_0 | offset_1 | offset_2 | ...
- * --------------------------------------------------------
- * --------------------------------------------------------
- * ( TSequence_0 )_X | ( TSequence_1 )_X | ( bbox )_X |
- * --------------------------------------------------------
+ * ----------------------------------------------------------------
+ * ( TSequenceSet )_X | ( bbox )_X | ( offset_0 | offset_1 )_X | ...
+ * ----------------------------------------------------------------
+ * --------------------------------------
+ * ( TSequence_0 )_X | ( TSequence_1 )_X |
+ * --------------------------------------
  * @endcode
- * where the `_X` are unused bytes added for double padding, `offset_0` and
- * `offset_1` are offsets for the corresponding sequences and `offset_2`
- * is the offset for the bounding box. Temporal sequence set values do not
- * have precomputed trajectory.
+ * where the `_X` are unused bytes added for double padding, and `offset_0`
+ * and `offset_1` are offsets for the corresponding sequences. The bounding
+ * box is stored before the offsets so that it is located at a fixed
+ * position that only depends on the base type. Temporal sequence set values
+ * do not have precomputed trajectory.
  *
  * @param[in] sequences Array of sequences
  * @param[in] count Number of elements in the array
  * @param[in] normalize True when the resulting value should be normalized.
  * In particular, normalize is false when synchronizing two
  * temporal sequence set values before applying an operation to them.
+ * @pre The validity of the sequences has been tested before
  */
 TSequenceSet *
-tsequenceset_make(TSequence **sequences, int count, bool normalize)
+tsequenceset_make1(TSequence **sequences, int count, bool normalize)
 {
-  /* Test the validity of the sequences */
   assert(count > 0);
-  ensure_valid_tsequencearr(sequences, count);
-
   TSequence **newsequences = sequences;
   int newcount = count;
-  if (normalize && count > 1)
+  /* Avoid copying the sequences when they are already normalized */
+  bool isnew = normalize && count > 1 &&
+    ! tsequencearr_normalized(sequences, count);
+  if (isnew)
     newsequences = tsequencearr_normalize(sequences, count, &newcount);
-  /* Add the size of the struct and the offset array
-   * Notice that the first offset is already declared in the struct */
-  size_t pdata = double_pad(sizeof(TSequenceSet)) + newcount * sizeof(size_t);
+  /* Get the bounding box size */
+  size_t bboxsize = temporal_bbox_size(sequences[0]->valuetypid);
+  /* Add the size of the struct, the bounding box, and the offset array */
+  size_t pdata = double_pad(sizeof(TSequenceSet)) + double_pad(bboxsize) +
+    double_pad(newcount * sizeof(uint32));
   size_t memsize = 0;
   int totalcount = 0;
   for (int i = 0; i < newcount; i++)
@@ -113,9 +158,6 @@ tsequenceset_make(TSequence **sequences, int count, bool normalize)
     totalcount += newsequences[i]->count;
     memsize += double_pad(VARSIZE(newsequences[i]));
   }
-  /* Get the bounding box size */
-  size_t bboxsize = temporal_bbox_size(sequences[0]->valuetypid);
-  memsize += double_pad(bboxsize);
   TSequenceSet *result = palloc0(pdata + memsize);
   SET_VARSIZE(result, pdata + memsize);
   result->count = newcount;
@@ -126,6 +168,7 @@ tsequenceset_make(TSequence **sequences, int count, bool normalize)
     MOBDB_FLAGS_GET_LINEAR(sequences[0]->flags));
   MOBDB_FLAGS_SET_X(result->flags, true);
   MOBDB_FLAGS_SET_T(result->flags, true);
+  MOBDB_FLAGS_SET_VERSION(result->flags, true);
   if (tgeo_base_type(sequences[0]->valuetypid))
   {
     MOBDB_FLAGS_SET_Z(result->flags,
@@ -133,15 +176,6 @@ tsequenceset_make(TSequence **sequences, int count, bool normalize)
     MOBDB_FLAGS_SET_GEODETIC(result->flags,
       MOBDB_FLAGS_GET_GEODETIC(sequences[0]->flags));
   }
-  /* Initialization of the variable-length part */
-  size_t pos = 0;
-  for (int i = 0; i < newcount; i++)
-  {
-    memcpy(((char *) result) + pdata + pos, newsequences[i],
-      VARSIZE(newsequences[i]));
-    result->offsets[i] = pos;
-    pos += double_pad(VARSIZE(newsequences[i]));
-  }
   /*
    * Precompute the bounding box
    * Only external types have precomputed bounding box, internal types such
@@ -149,11 +183,20 @@ tsequenceset_make(TSequence **sequences, int count, bool normalize)
    */
   if (bboxsize != 0)
   {
-    void *bbox = ((char *) result) + pdata + pos;
+    void *bbox = tsequenceset_bbox_ptr(result);
     tsequenceset_make_bbox(bbox, newsequences, newcount);
-    result->offsets[newcount] = pos;
   }
-  if (normalize && count > 1)
+  /* Initialization of the variable-length part */
+  void *offsets = tsequenceset_offsets_ptr(result);
+  size_t pos = 0;
+  for (int i = 0; i < newcount; i++)
+  {
+    memcpy(((char *) result) + pdata + pos, newsequences[i],
+      VARSIZE(newsequences[i]));
+    temporal_offset_set(offsets, result->flags, i, pos);
+    pos += double_pad(VARSIZE(newsequences[i]));
+  }
+  if (isnew)
   {
     for (int i = 0; i < newcount; i++)
       pfree(newsequences[i]);
@@ -162,6 +205,23 @@ tsequenceset_make(TSequence **sequences, int count, bool normalize)
   return result;
 }
 
+/**
+ * Construct a temporal sequence set value from the array of temporal
+ * sequence values after validating them
+ *
+ * @param[in] sequences Array of sequences
+ * @param[in] count Number of elements in the array
+ * @param[in] normalize True when the resulting value should be normalized.
+ */
+TSequenceSet *
+tsequenceset_make(TSequence **sequences, int count, bool normalize)
+{
+  /* Test the validity of the sequences */
+  assert(count > 0);
+  ensure_valid_tsequencearr(sequences, count);
+  return tsequenceset_make1(sequences, count, normalize);
+}
+
 /**
  * Construct a temporal sequence set value from the array of temporal
  * sequence values and free the array and the sequences after the creation
@@ -185,13 +245,35 @@ tsequenceset_make_free(TSequence **sequences, int count, bool normalize)
   return result;
 }
 
+/**
+ * Construct a temporal sequence set value from the array of temporal
+ * sequence values without validating them and free the array and the
+ * sequences after the creation
+ *
+ * @pre The validity of the sequences has been tested before
+ */
+TSequenceSet *
+tsequenceset_make_free1(TSequence **sequences, int count, bool normalize)
+{
+  if (count == 0)
+  {
+    pfree(sequences);
+    return NULL;
+  }
+  TSequenceSet *result = tsequenceset_make1(sequences, count, normalize);
+  for (int i = 0; i < count; i++)
+    pfree(sequences[i]);
+  pfree(sequences);
+  return result;
+}
+
 /**
  * Construct a temporal sequence set value from the temporal sequence
  */
 TSequenceSet *
 tsequence_to_tsequenceset(const TSequence *seq)
 {
-  return tsequenceset_make((TSequence **)&seq, 1, NORMALIZE_NO);
+  return tsequenceset_make1((TSequence **)&seq, 1, NORMALIZE_NO);
 }
 
 /**
@@ -311,7 +393,7 @@ tsequenceset_copy(const TSequenceSet *ts)
 
 /**
  * Returns the location of the timestamp in the temporal sequence set value
- * using binary search
+ * using interpolation search with a fallback to binary search
  *
  * If the timestamp is contained in the temporal value, the index of the
  * sequence is returned in the output parameter. Otherwise, returns a number
@@ -337,28 +419,80 @@ bool
 tsequenceset_find_timestamp(const TSequenceSet *ts, TimestampTz t, int *loc)
 {
   int first = 0, last = ts->count - 1;
-  int middle = 0; /* make compiler quiet */
-  TSequence *seq = NULL; /* make compiler quiet */
+  /* Approximate time span of the sequences first to last */
+  TimestampTz t1 = tsequenceset_seq_n(ts, first)->period.lower;
+  TimestampTz t2 = tsequenceset_seq_n(ts, last)->period.upper;
+  int probes = 0;
   while (first <= last)
   {
-    middle = (first + last)/2;
-    seq = tsequenceset_seq_n(ts, middle);
+    int middle = (probes++ < INTERPOLATION_MAX_PROBES) ?
+      interpolation_probe(first, last, t1, t2, t) : (first + last)/2;
+    TSequence *seq = tsequenceset_seq_n(ts, middle);
     if (contains_period_timestamp_internal(&seq->period, t))
     {
       *loc = middle;
       return true;
     }
     if (t <= seq->period.lower)
+    {
       last = middle - 1;
+      t2 = seq->period.lower;
+    }
     else
+    {
       first = middle + 1;
+      t1 = seq->period.upper;
+    }
   }
-  if (t >= seq->period.upper)
-    middle++;
-  *loc = middle;
+  /* All the sequences before first end before the timestamp and all the
+   * others start after it */
+  *loc = first;
   return false;
 }
 
+/**
+ * Returns the location of the timestamp in the temporal sequence set value
+ * using the location of a previous timestamp as a hint
+ *
+ * When a temporal value is probed with increasing timestamps, e.g., in a
+ * join with a series of timestamps, the timestamp is usually located in the
+ * same sequence as the previous one or in the next one, which are thus
+ * tested before the binary search of tsequenceset_find_timestamp.
+ *
+ * @param[in] ts Temporal sequence set value
+ * @param[in] t Timestamp
+ * @param[in] hint Location of a previous timestamp
+ * @param[out] loc Location
+ * @result Returns true if the timestamp is contained in the temporal value
+ */
+bool
+tsequenceset_find_timestamp_hint(const TSequenceSet *ts, TimestampTz t,
+  int hint, int *loc)
+{
+  if (hint >= 0 && hint < ts->count - 1)
+  {
+    TSequence *seq1 = tsequenceset_seq_n(ts, hint);
+    TSequence *seq2 = tsequenceset_seq_n(ts, hint + 1);
+    if (contains_period_timestamp_internal(&seq1->period, t))
+    {
+      *loc = hint;
+      return true;
+    }
+    if (contains_period_timestamp_internal(&seq2->period, t))
+    {
+      *loc = hint + 1;
+      return true;
+    }
+    /* The timestamp is in the gap between the two sequences */
+    if (seq1->period.upper <= t && t <= seq2->period.lower)
+    {
+      *loc = hint + 1;
+      return false;
+    }
+  }
+  return tsequenceset_find_timestamp(ts, t, loc);
+}
+
 /*****************************************************************************
  * Intersection/synchronize functions
  *****************************************************************************/
@@ -517,8 +651,8 @@ intersection_tsequenceset_tsequence(const TSequenceSet *ts, const TSequence *seq
     return false;
   }
 
-  *inter1 = tsequenceset_make_free(sequences1, k, NORMALIZE_NO);
-  *inter2 = tsequenceset_make_free(sequences2, k, NORMALIZE_NO);
+  *inter1 = tsequenceset_make_free1(sequences1, k, NORMALIZE_NO);
+  *inter2 = tsequenceset_make_free1(sequences2, k, NORMALIZE_NO);
   return true;
 }
 
@@ -593,8 +727,8 @@ intersection_tsequenceset_tsequenceset(const TSequenceSet *ts1, const TSequenceS
     return false;
   }
 
-  *inter1 = tsequenceset_make_free(sequences1, k, NORMALIZE_NO);
-  *inter2 = tsequenceset_make_free(sequences2, k, NORMALIZE_NO);
+  *inter1 = tsequenceset_make_free1(sequences1, k, NORMALIZE_NO);
+  *inter2 = tsequenceset_make_free1(sequences2, k, NORMALIZE_NO);
   return true;
 }
 
@@ -694,6 +828,7 @@ tintseqset_to_tfloatseqset(const TSequenceSet *ts)
       Datum *value_ptr = tinstant_value_ptr(inst);
       *value_ptr = Float8GetDatum((double)DatumGetInt32(tinstant_value(inst)));
     }
+    tsequence_reset_blocks(seq);
   }
   return result;
 }
@@ -722,6 +857,7 @@ tfloatseqset_to_tintseqset(const TSequenceSet *ts)
       Datum *value_ptr = tinstant_value_ptr(inst);
       *value_ptr = Int32GetDatum((double)DatumGetFloat8(tinstant_value(inst)));
     }
+    tsequence_reset_blocks(seq);
   }
   return result;
 }
@@ -754,7 +890,7 @@ tinstantset_to_tsequenceset(const TInstantSet *ti, bool linear)
     TInstant *inst = tinstantset_inst_n(ti, i);
     sequences[i] = tinstant_to_tsequence(inst, linear);
   }
-  TSequenceSet *result = tsequenceset_make(sequences, ti->count, NORMALIZE_NO);
+  TSequenceSet *result = tsequenceset_make1(sequences, ti->count, NORMALIZE_NO);
   pfree(sequences);
   return result;
 }
@@ -778,7 +914,7 @@ tstepseqset_to_linear(const TSequenceSet *ts)
     TSequence *seq = tsequenceset_seq_n(ts, i);
     k += tstepseq_to_linear1(&sequences[k], seq);
   }
-  return tsequenceset_make_free(sequences, k, NORMALIZE);
+  return tsequenceset_make_free1(sequences, k, NORMALIZE);
 }
 
 /*****************************************************************************
@@ -1452,7 +1588,7 @@ tsequenceset_restrict_value(const TSequenceSet *ts, Datum value, bool atfunc)
     TSequence *seq = tsequenceset_seq_n(ts, i);
     k += tsequence_restrict_value1(&sequences[k], seq, value, atfunc) ;
   }
-  return tsequenceset_make_free(sequences, k, NORMALIZE);
+  return tsequenceset_make_free1(sequences, k, NORMALIZE);
 }
 
 /**
@@ -1482,7 +1618,7 @@ tsequenceset_restrict_values(const TSequenceSet *ts, const Datum *values,
     TSequence *seq = tsequenceset_seq_n(ts, i);
     k += tsequence_at_values1(&sequences[k], seq, values, count);
   }
-  TSequenceSet *atresult = tsequenceset_make_free(sequences, k, NORMALIZE);
+  TSequenceSet *atresult = tsequenceset_make_free1(sequences, k, NORMALIZE);
   if (atfunc)
     return atresult;
 
@@ -1532,7 +1668,7 @@ tnumberseqset_restrict_range(const TSequenceSet *ts, RangeType *range,
     TSequence *seq = tsequenceset_seq_n(ts, i);
     k += tnumberseq_restrict_range1(&sequences[k], seq, range, atfunc);
   }
-  return tsequenceset_make_free(sequences, k, NORMALIZE);
+  return tsequenceset_make_free1(sequences, k, NORMALIZE);
 }
 
 /**
@@ -1569,7 +1705,7 @@ tnumberseqset_restrict_ranges(const TSequenceSet *ts, RangeType **normranges,
     k += tnumberseq_restrict_ranges1(&sequences[k], seq, normranges,
       count, atfunc, BBOX_TEST);
   }
-  return tsequenceset_make_free(sequences, k, NORMALIZE);
+  return tsequenceset_make_free1(sequences, k, NORMALIZE);
 }
 
 /**
@@ -1633,7 +1769,7 @@ tsequenceset_restrict_timestamp(const TSequenceSet *ts, TimestampTz t,
       sequences[k++] = tsequence_copy(tsequenceset_seq_n(ts, j));
     /* k is never equal to 0 since in that case it is a singleton sequence set
        and it has been dealt by tsequence_minus_timestamp above */
-    return (Temporal *) tsequenceset_make_free(sequences, k, NORMALIZE_NO);
+    return (Temporal *) tsequenceset_make_free1(sequences, k, NORMALIZE_NO);
   }
 }
 
@@ -1660,6 +1796,141 @@ tsequenceset_value_at_timestamp(const TSequenceSet *ts, TimestampTz t, Datum *re
   return tsequence_value_at_timestamp(tsequenceset_seq_n(ts, loc), t, result);
 }
 
+/**
+ * Returns an aligned copy of the bytes of the toasted temporal value given
+ * as a datum, where the offset is counted from the start of the varlena
+ */
+static char *
+tsequenceset_fetch_slice(Datum tsdatum, size_t offset, size_t length)
+{
+  struct varlena *slice = PG_DETOAST_DATUM_SLICE(tsdatum, offset - VARHDRSZ,
+    length);
+  char *result = palloc(length);
+  memcpy(result, VARDATA(slice), length);
+  pfree(slice);
+  return result;
+}
+
+/**
+ * Returns the base value at the timestamp of a temporal sequence set value
+ * stored out of line without compression, fetching only the parts of the
+ * value that are needed
+ *
+ * The fixed-size part of the struct, the bounding box, and the offset array
+ * are fetched first. The sequence containing the timestamp is then found by
+ * binary search, fetching only the fixed-size part of the probed sequences,
+ * and finally the selected sequence is fetched.
+ *
+ * @param[in] tsdatum Temporal value given as a datum
+ * @param[in] t Timestamp
+ * @param[out] result Base value
+ * @param[out] found True if the timestamp is contained in the temporal value
+ * @result Returns false if the datum is not a temporal sequence set value
+ * stored out of line without compression, in which case the value must be
+ * detoasted completely by the caller
+ */
+bool
+tsequenceset_value_at_timestamp_slice(Datum tsdatum, TimestampTz t,
+  Datum *result, bool *found)
+{
+  struct varlena *attr = (struct varlena *) DatumGetPointer(tsdatum);
+  if (! VARATT_IS_EXTERNAL_ONDISK(attr))
+    return false;
+  struct varatt_external toast_pointer;
+  VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+  if (VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer))
+    return false;
+
+  /* Fixed-size part and bounding box */
+  size_t bboxsize = double_pad(sizeof(bboxunion));
+  size_t headsize = double_pad(sizeof(TSequenceSet)) + bboxsize;
+  TSequenceSet *head = (TSequenceSet *) PG_DETOAST_DATUM_SLICE(tsdatum, 0,
+    headsize - VARHDRSZ);
+  if (head->duration != SEQUENCESET || MOBDB_FLAGS_GET_PACKED(head->flags))
+  {
+    pfree(head);
+    return false;
+  }
+
+  /* Offset array, which in the original format follows the fixed-size
+   * part of the struct and keeps the offset of the bounding box that
+   * follows the sequences */
+  int count = head->count;
+  int16 flags = head->flags;
+  bool version = MOBDB_FLAGS_GET_VERSION(flags);
+  size_t offsetsstart = double_pad(sizeof(TSequenceSet));
+  if (version)
+    offsetsstart += double_pad(temporal_bbox_size(head->valuetypid));
+  size_t offsetssize = TEMPORAL_OFFSET_SIZE(flags) *
+    (version ? count : count + 1);
+  size_t datastart = offsetsstart + (version ? double_pad(offsetssize) :
+    offsetssize);
+  char *offsets = NULL;
+  void *box;
+  if (version)
+    box = tsequenceset_bbox_ptr(head);
+  else
+  {
+    offsets = tsequenceset_fetch_slice(tsdatum, offsetsstart, offsetssize);
+    box = tsequenceset_fetch_slice(tsdatum,
+      datastart + temporal_offset_get(offsets, flags, count),
+      temporal_bbox_size(head->valuetypid));
+  }
+
+  /* Bounding box test, the time bounds of the box are inclusive unless
+   * the box is a period */
+  *found = false;
+  Period p;
+  if (talpha_base_type(head->valuetypid))
+    p = *((Period *) box);
+  else if (tnumber_base_type(head->valuetypid))
+    period_set(&p, ((TBOX *) box)->tmin, ((TBOX *) box)->tmax, true, true);
+  else /* tgeo_base_type(head->valuetypid) */
+    period_set(&p, ((STBOX *) box)->tmin, ((STBOX *) box)->tmax, true, true);
+  if (! version)
+    pfree(box);
+  pfree(head);
+  if (! contains_period_timestamp_internal(&p, t))
+  {
+    if (offsets != NULL)
+      pfree(offsets);
+    return true;
+  }
+  if (offsets == NULL)
+    offsets = tsequenceset_fetch_slice(tsdatum, offsetsstart, offsetssize);
+
+  /* Binary search on the periods of the sequences */
+  int first = 0, last = count - 1;
+  while (first <= last)
+  {
+    int middle = (first + last) / 2;
+    TSequence *seq = (TSequence *) tsequenceset_fetch_slice(tsdatum,
+      datastart + temporal_offset_get(offsets, flags, middle),
+      sizeof(TSequence));
+    p = seq->period;
+    pfree(seq);
+    if (contains_period_timestamp_internal(&p, t))
+    {
+      /* Fetch the sequence and compute the value */
+      size_t start = temporal_offset_get(offsets, flags, middle);
+      size_t end = (middle < count - 1 || ! version) ?
+        temporal_offset_get(offsets, flags, middle + 1) :
+        toast_raw_datum_size(tsdatum) - datastart;
+      seq = (TSequence *) tsequenceset_fetch_slice(tsdatum, datastart + start,
+        end - start);
+      *found = tsequence_value_at_timestamp(seq, t, result);
+      pfree(seq);
+      break;
+    }
+    if (t <= p.lower)
+      last = middle - 1;
+    else
+      first = middle + 1;
+  }
+  pfree(offsets);
+  return true;
+}
+
 /**
  * Returns the base value of the temporal value at the timestamp when the
  * timestamp may be at an exclusive bound
@@ -1770,7 +2041,7 @@ tsequenceset_restrict_timestampset(const TSequenceSet *ts1,
       k += tsequence_minus_timestampset1(&sequences[k], seq, ts2);
 
     }
-    return (Temporal *) tsequenceset_make_free(sequences, k, NORMALIZE);
+    return (Temporal *) tsequenceset_make_free1(sequences, k, NORMALIZE);
   }
 }
 
@@ -1834,7 +2105,7 @@ tsequenceset_restrict_period(const TSequenceSet *ts, const Period *p, bool atfun
     }
     /* Since both the tsequenceset and the period are normalized it is not
      * necessary to normalize the result of the projection */
-    result = tsequenceset_make(sequences, k, NORMALIZE_NO);
+    result = tsequenceset_make1(sequences, k, NORMALIZE_NO);
     for (int i = 0; i < l; i++)
       pfree(tofree[i]);
     pfree(sequences);
@@ -1941,7 +2212,7 @@ tsequenceset_restrict_periodset(const TSequenceSet *ts, const PeriodSet *ps,
   }
   /* It is necessary to normalize despite the fact that both the tsequenceset
   * and the periodset are normalized */
-  return tsequenceset_make_free(sequences, k, NORMALIZE);
+  return tsequenceset_make_free1(sequences, k, NORMALIZE);
 }
 
 /*****************************************************************************
@@ -2058,7 +2329,7 @@ tsequenceset_eq(const TSequenceSet *ts1, const TSequenceSet *ts2)
 {
   assert(ts1->valuetypid == ts2->valuetypid);
   /* If number of sequences or flags are not equal */
-  if (ts1->count != ts2->count || ts1->flags != ts2->flags)
+  if (ts1->count != ts2->count || MOBDB_FLAGS_LOGICAL(ts1->flags) != MOBDB_FLAGS_LOGICAL(ts2->flags))
     return false;
 
   /* If bounding boxes are not equal */
@@ -2137,10 +2408,15 @@ tsequenceset_cmp(const TSequenceSet *ts1, const TSequenceSet *ts2)
 
 /**
  * Returns the hash value of the temporal value
+ *
+ * @note A sequence set composed of a single sequence has the hash value of
+ * this sequence since it is equal to it
  */
 uint32
 tsequenceset_hash(const TSequenceSet *ts)
 {
+  if (ts->count == 1)
+    return tsequence_hash(tsequenceset_seq_n(ts, 0));
   uint32 result = 1;
   for (int i = 0; i < ts->count; i++)
   {
@@ -2151,4 +2427,24 @@ tsequenceset_hash(const TSequenceSet *ts)
   return result;
 }
 
+#if MOBDB_PGSQL_VERSION >= 110000
+/**
+ * Returns the 64-bit hash value of the temporal value using a seed
+ */
+uint64
+tsequenceset_hash_extended(const TSequenceSet *ts, uint64 seed)
+{
+  if (ts->count == 1)
+    return tsequence_hash_extended(tsequenceset_seq_n(ts, 0), seed);
+  uint64 result = 1;
+  for (int i = 0; i < ts->count; i++)
+  {
+    TSequence *seq = tsequenceset_seq_n(ts, i);
+    uint64 seq_hash = tsequence_hash_extended(seq, seed);
+    result = (result << 5) - result + seq_hash;
+  }
+  return result;
+}
+#endif
+
 /*****************************************************************************/
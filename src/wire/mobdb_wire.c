@@ -0,0 +1,405 @@
+/*****************************************************************************
+ *
+ * mobdb_wire.c
+ *    Standalone writer of the compact binary format of temporal types.
+ *
+ * The writer collects the timestamps and the values of the instants added
+ * by the application and writes, when the value is finished, the header of
+ * the compact binary format followed by the array of timestamps and by the
+ * array of values, as done by the function temporal_write_compact. The
+ * numbers are written in network byte order. The writer only verifies
+ * the structure of the value, the validity of the instants is tested by
+ * the receive function when constructing the value in the database.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "mobdb_wire.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Constants of the compact binary format, see temporal.h */
+#define WIRE_BINARY_FLAG     0x80
+#define WIRE_BINARY_VERSION  1
+#define WIRE_LINEAR          0x01
+#define WIRE_Z               0x02
+#define WIRE_GEODETIC        0x04
+#define WIRE_LOWER_INC       0x01
+#define WIRE_UPPER_INC       0x02
+
+/**
+ * Growable array of bytes
+ */
+typedef struct
+{
+  uint8_t *data;
+  size_t len;
+  size_t maxlen;
+} WireBuffer;
+
+/**
+ * Header of a sequence
+ */
+typedef struct
+{
+  int32_t count;
+  uint8_t bounds;
+} WireSequence;
+
+/**
+ * State of the writer
+ */
+struct MobdbWireWriter
+{
+  MobdbWireBase base;
+  int duration;
+  bool linear;
+  bool hasz;
+  int32_t srid;
+  MobdbWireAllocator allocator;
+  int64_t *times;          /**< Timestamps of the instants */
+  int32_t count;           /**< Number of instants */
+  int32_t maxcount;
+  WireBuffer values;       /**< Values of the instants */
+  WireSequence *seqs;      /**< Headers of the sequences */
+  int32_t nseqs;
+  int32_t maxseqs;
+};
+
+static void *
+wire_default_alloc(size_t size)
+{
+  return malloc(size);
+}
+
+static void *
+wire_default_realloc(void *ptr, size_t size)
+{
+  return realloc(ptr, size);
+}
+
+static void
+wire_default_free(void *ptr)
+{
+  free(ptr);
+  return;
+}
+
+/**
+ * Grows the array so that it has room for one more element
+ *
+ * @param[in] writer Writer whose allocator is used
+ * @param[in,out] array Array
+ * @param[in,out] maxcount Number of elements allocated
+ * @param[in] count Number of elements used
+ * @param[in] size Size of an element
+ */
+static bool
+wire_grow(MobdbWireWriter *writer, void **array, int32_t *maxcount,
+  int32_t count, size_t size)
+{
+  if (count < *maxcount)
+    return true;
+  int32_t newmax = *maxcount == 0 ? 16 : *maxcount * 2;
+  void *result = writer->allocator.realloc(*array, size * (size_t) newmax);
+  if (result == NULL)
+    return false;
+  *array = result;
+  *maxcount = newmax;
+  return true;
+}
+
+/**
+ * Ensures that the buffer has room for the given number of bytes
+ */
+static bool
+wire_buffer_reserve(MobdbWireWriter *writer, WireBuffer *buf, size_t size)
+{
+  if (buf->len + size <= buf->maxlen)
+    return true;
+  size_t newmax = buf->maxlen == 0 ? 256 : buf->maxlen;
+  while (newmax < buf->len + size)
+    newmax *= 2;
+  uint8_t *result = writer->allocator.realloc(buf->data, newmax);
+  if (result == NULL)
+    return false;
+  buf->data = result;
+  buf->maxlen = newmax;
+  return true;
+}
+
+/**
+ * Writes the unsigned integer of the given number of bytes in network byte
+ * order at the end of the buffer, which must have enough room
+ */
+static void
+wire_put(WireBuffer *buf, uint64_t value, int size)
+{
+  for (int i = size - 1; i >= 0; i--)
+    buf->data[buf->len++] = (uint8_t) (value >> (8 * i));
+  return;
+}
+
+static void
+wire_put_float8(WireBuffer *buf, double value)
+{
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(double));
+  wire_put(buf, bits, 8);
+  return;
+}
+
+/**
+ * Returns a new writer of temporal values of the given base type and
+ * duration
+ *
+ * @param[in] base Base type
+ * @param[in] duration Duration, one of the MOBDB_WIRE_INSTANT constants
+ * @param[in] linear True when the values have linear interpolation, which
+ * is only allowed for temporal floats and temporal points
+ * @param[in] hasz True when the temporal points have Z coordinates
+ * @param[in] srid SRID of the temporal points
+ * @param[in] allocator Allocator, or NULL for the one of the C library
+ * @return NULL if the arguments are invalid or if there is no memory
+ */
+MobdbWireWriter *
+mobdb_wire_writer_new(MobdbWireBase base, int duration, bool linear,
+  bool hasz, int32_t srid, const MobdbWireAllocator *allocator)
+{
+  bool point = (base == MOBDB_WIRE_GEOMPOINT || base == MOBDB_WIRE_GEOGPOINT);
+  if (base < MOBDB_WIRE_BOOL || base > MOBDB_WIRE_GEOGPOINT ||
+      duration < MOBDB_WIRE_INSTANT || duration > MOBDB_WIRE_SEQUENCESET ||
+      (linear && base != MOBDB_WIRE_FLOAT && ! point) ||
+      (hasz && ! point))
+    return NULL;
+  MobdbWireAllocator alloc = { &wire_default_alloc, &wire_default_realloc,
+    &wire_default_free };
+  if (allocator != NULL)
+    alloc = *allocator;
+  MobdbWireWriter *result = alloc.alloc(sizeof(MobdbWireWriter));
+  if (result == NULL)
+    return NULL;
+  memset(result, 0, sizeof(MobdbWireWriter));
+  result->base = base;
+  result->duration = duration;
+  /* Instants and instant sets have step interpolation */
+  result->linear = linear && duration >= MOBDB_WIRE_SEQUENCE;
+  result->hasz = hasz;
+  result->srid = srid;
+  result->allocator = alloc;
+  return result;
+}
+
+/**
+ * Frees the writer
+ */
+void
+mobdb_wire_writer_free(MobdbWireWriter *writer)
+{
+  if (writer == NULL)
+    return;
+  void (*freefn)(void *) = writer->allocator.free;
+  if (writer->times != NULL)
+    freefn(writer->times);
+  if (writer->values.data != NULL)
+    freefn(writer->values.data);
+  if (writer->seqs != NULL)
+    freefn(writer->seqs);
+  freefn(writer);
+  return;
+}
+
+/**
+ * Discards the instants added to the writer, keeping the memory allocated
+ * for the next value
+ */
+void
+mobdb_wire_writer_reset(MobdbWireWriter *writer)
+{
+  writer->count = 0;
+  writer->nseqs = 0;
+  writer->values.len = 0;
+  return;
+}
+
+/**
+ * Starts a new sequence of a sequence or of a sequence set
+ */
+MobdbWireStatus
+mobdb_wire_begin_sequence(MobdbWireWriter *writer, bool lower_inc,
+  bool upper_inc)
+{
+  if (writer->duration != MOBDB_WIRE_SEQUENCE &&
+      writer->duration != MOBDB_WIRE_SEQUENCESET)
+    return MOBDB_WIRE_INVALID;
+  if (writer->duration == MOBDB_WIRE_SEQUENCE && writer->nseqs == 1)
+    return MOBDB_WIRE_INVALID;
+  if (writer->nseqs > 0 && writer->seqs[writer->nseqs - 1].count == 0)
+    return MOBDB_WIRE_EMPTY;
+  if (! wire_grow(writer, (void **) &writer->seqs, &writer->maxseqs,
+      writer->nseqs, sizeof(WireSequence)))
+    return MOBDB_WIRE_NOMEM;
+  WireSequence *seq = &writer->seqs[writer->nseqs++];
+  seq->count = 0;
+  seq->bounds = (uint8_t) ((lower_inc ? WIRE_LOWER_INC : 0) |
+    (upper_inc ? WIRE_UPPER_INC : 0));
+  return MOBDB_WIRE_OK;
+}
+
+/**
+ * Adds the timestamp of a new instant and reserves the room for its value
+ *
+ * @param[in] writer Writer
+ * @param[in] base Base type of the value
+ * @param[in] t Timestamp in microseconds since 2000-01-01
+ * @param[in] size Size of the value
+ */
+static MobdbWireStatus
+wire_add_instant(MobdbWireWriter *writer, MobdbWireBase base, int64_t t,
+  size_t size)
+{
+  if (base != writer->base &&
+      ! (base == MOBDB_WIRE_GEOMPOINT && writer->base == MOBDB_WIRE_GEOGPOINT))
+    return MOBDB_WIRE_INVALID;
+  if (writer->duration == MOBDB_WIRE_INSTANT && writer->count == 1)
+    return MOBDB_WIRE_INVALID;
+  bool sequences = (writer->duration == MOBDB_WIRE_SEQUENCE ||
+    writer->duration == MOBDB_WIRE_SEQUENCESET);
+  if (sequences && writer->nseqs == 0)
+    return MOBDB_WIRE_INVALID;
+  /* The first instant of a sequence may have the timestamp of the last
+   * instant of the previous sequence when one of the bounds is exclusive,
+   * which is tested by the receive function */
+  if (writer->count > 0)
+  {
+    int64_t last = writer->times[writer->count - 1];
+    bool first = sequences && writer->seqs[writer->nseqs - 1].count == 0;
+    if (t < last || (t == last && ! first))
+      return MOBDB_WIRE_ORDER;
+  }
+  if (! wire_grow(writer, (void **) &writer->times, &writer->maxcount,
+        writer->count, sizeof(int64_t)) ||
+      ! wire_buffer_reserve(writer, &writer->values, size))
+    return MOBDB_WIRE_NOMEM;
+  writer->times[writer->count++] = t;
+  if (sequences)
+    writer->seqs[writer->nseqs - 1].count++;
+  return MOBDB_WIRE_OK;
+}
+
+/**
+ * Adds an instant to a temporal boolean
+ */
+MobdbWireStatus
+mobdb_wire_add_bool(MobdbWireWriter *writer, int64_t t, bool value)
+{
+  MobdbWireStatus status = wire_add_instant(writer, MOBDB_WIRE_BOOL, t, 1);
+  if (status == MOBDB_WIRE_OK)
+    wire_put(&writer->values, value ? 1 : 0, 1);
+  return status;
+}
+
+/**
+ * Adds an instant to a temporal integer
+ */
+MobdbWireStatus
+mobdb_wire_add_int(MobdbWireWriter *writer, int64_t t, int32_t value)
+{
+  MobdbWireStatus status = wire_add_instant(writer, MOBDB_WIRE_INT, t, 4);
+  if (status == MOBDB_WIRE_OK)
+    wire_put(&writer->values, (uint32_t) value, 4);
+  return status;
+}
+
+/**
+ * Adds an instant to a temporal float
+ */
+MobdbWireStatus
+mobdb_wire_add_float(MobdbWireWriter *writer, int64_t t, double value)
+{
+  MobdbWireStatus status = wire_add_instant(writer, MOBDB_WIRE_FLOAT, t, 8);
+  if (status == MOBDB_WIRE_OK)
+    wire_put_float8(&writer->values, value);
+  return status;
+}
+
+/**
+ * Adds an instant to a temporal point, the Z coordinate is ignored when
+ * the writer has no Z coordinates
+ */
+MobdbWireStatus
+mobdb_wire_add_point(MobdbWireWriter *writer, int64_t t, double x, double y,
+  double z)
+{
+  MobdbWireStatus status = wire_add_instant(writer, MOBDB_WIRE_GEOMPOINT, t,
+    writer->hasz ? 24 : 16);
+  if (status == MOBDB_WIRE_OK)
+  {
+    wire_put_float8(&writer->values, x);
+    wire_put_float8(&writer->values, y);
+    if (writer->hasz)
+      wire_put_float8(&writer->values, z);
+  }
+  return status;
+}
+
+/**
+ * Writes the temporal value in the compact binary format and resets the
+ * writer for the next value
+ *
+ * @param[in] writer Writer
+ * @param[out] data Binary representation, allocated with the allocator of
+ * the writer and freed by the caller
+ * @param[out] size Size of the binary representation
+ */
+MobdbWireStatus
+mobdb_wire_finish(MobdbWireWriter *writer, uint8_t **data, size_t *size)
+{
+  if (writer->count == 0 ||
+      (writer->nseqs > 0 && writer->seqs[writer->nseqs - 1].count == 0))
+    return MOBDB_WIRE_EMPTY;
+  bool point = (writer->base == MOBDB_WIRE_GEOMPOINT ||
+    writer->base == MOBDB_WIRE_GEOGPOINT);
+  size_t len = 3 + (point ? 4 : 0) + 4 + 5 * (size_t) writer->nseqs +
+    8 * (size_t) writer->count + writer->values.len;
+  WireBuffer buf = { writer->allocator.alloc(len), 0, len };
+  if (buf.data == NULL)
+    return MOBDB_WIRE_NOMEM;
+
+  wire_put(&buf, (uint8_t) writer->duration | WIRE_BINARY_FLAG, 1);
+  wire_put(&buf, WIRE_BINARY_VERSION, 1);
+  wire_put(&buf, (writer->linear ? WIRE_LINEAR : 0) |
+    (writer->hasz ? WIRE_Z : 0) |
+    (writer->base == MOBDB_WIRE_GEOGPOINT ? WIRE_GEODETIC : 0), 1);
+  if (point)
+    wire_put(&buf, (uint32_t) writer->srid, 4);
+
+  /* Write the headers */
+  if (writer->duration == MOBDB_WIRE_INSTANTSET)
+    wire_put(&buf, (uint32_t) writer->count, 4);
+  else if (writer->duration == MOBDB_WIRE_SEQUENCESET)
+    wire_put(&buf, (uint32_t) writer->nseqs, 4);
+  for (int32_t i = 0; i < writer->nseqs; i++)
+  {
+    wire_put(&buf, (uint32_t) writer->seqs[i].count, 4);
+    wire_put(&buf, writer->seqs[i].bounds, 1);
+  }
+
+  /* Write the arrays of timestamps and of values */
+  for (int32_t i = 0; i < writer->count; i++)
+    wire_put(&buf, (uint64_t) writer->times[i], 8);
+  memcpy(buf.data + buf.len, writer->values.data, writer->values.len);
+  buf.len += writer->values.len;
+
+  *data = buf.data;
+  *size = buf.len;
+  mobdb_wire_writer_reset(writer);
+  return MOBDB_WIRE_OK;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,173 @@
+/*****************************************************************************
+ *
+ * mobdb_wire_batch.c
+ *    Batch API of the standalone writer of the compact binary format.
+ *
+ * The sequences of the batch are written by a pool of threads. Each thread
+ * has its own writer, whose arrays are reused for all the sequences written
+ * by the thread, and takes the next chunk of sequences from a counter shared
+ * by the threads, so that the threads finishing their chunks first continue
+ * with the remaining ones. The writers have no global state, the allocator
+ * of the batch must be thread-safe, as are the functions of the C library
+ * used by default.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "mobdb_wire.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+/* Number of sequences taken at a time by a thread */
+#define WIRE_BATCH_CHUNK 64
+
+/**
+ * State shared by the threads writing a batch
+ */
+typedef struct
+{
+  MobdbWireBase base;
+  bool linear;
+  bool hasz;
+  int32_t srid;
+  const MobdbWireAllocator *allocator;
+  const MobdbWireSequence *seqs;
+  int32_t count;
+  MobdbWireOutput *outputs;
+  atomic_int next;            /**< First sequence of the next chunk */
+} WireBatch;
+
+/**
+ * Writes the sequence with the writer
+ */
+static MobdbWireStatus
+wire_batch_write_sequence(MobdbWireWriter *writer, MobdbWireBase base,
+  const MobdbWireSequence *seq, MobdbWireOutput *output)
+{
+  MobdbWireStatus status = mobdb_wire_begin_sequence(writer, seq->lower_inc,
+    seq->upper_inc);
+  for (int32_t i = 0; i < seq->count && status == MOBDB_WIRE_OK; i++)
+  {
+    int64_t t = seq->times[i];
+    if (base == MOBDB_WIRE_BOOL)
+      status = mobdb_wire_add_bool(writer, t, seq->x[i] != 0.0);
+    else if (base == MOBDB_WIRE_INT)
+      status = mobdb_wire_add_int(writer, t, (int32_t) seq->x[i]);
+    else if (base == MOBDB_WIRE_FLOAT)
+      status = mobdb_wire_add_float(writer, t, seq->x[i]);
+    else
+      status = mobdb_wire_add_point(writer, t, seq->x[i], seq->y[i],
+        seq->z != NULL ? seq->z[i] : 0.0);
+  }
+  if (status == MOBDB_WIRE_OK)
+    status = mobdb_wire_finish(writer, &output->data, &output->size);
+  /* The writer is only reset by mobdb_wire_finish when it succeeds */
+  if (status != MOBDB_WIRE_OK)
+    mobdb_wire_writer_reset(writer);
+  return status;
+}
+
+/**
+ * Function executed by the threads of the pool
+ */
+static void *
+wire_batch_worker(void *arg)
+{
+  WireBatch *batch = (WireBatch *) arg;
+  MobdbWireWriter *writer = mobdb_wire_writer_new(batch->base,
+    MOBDB_WIRE_SEQUENCE, batch->linear, batch->hasz, batch->srid,
+    batch->allocator);
+  while (true)
+  {
+    int first = atomic_fetch_add(&batch->next, WIRE_BATCH_CHUNK);
+    if (first >= batch->count)
+      break;
+    int last = first + WIRE_BATCH_CHUNK < batch->count ?
+      first + WIRE_BATCH_CHUNK : batch->count;
+    for (int i = first; i < last; i++)
+    {
+      MobdbWireOutput *output = &batch->outputs[i];
+      output->data = NULL;
+      output->size = 0;
+      output->status = writer == NULL ? MOBDB_WIRE_NOMEM :
+        wire_batch_write_sequence(writer, batch->base, &batch->seqs[i],
+          output);
+    }
+  }
+  mobdb_wire_writer_free(writer);
+  return NULL;
+}
+
+/**
+ * Writes the sequences in the compact binary format using the given
+ * number of threads
+ *
+ * @param[in] base Base type
+ * @param[in] linear True when the sequences have linear interpolation
+ * @param[in] hasz True when the temporal points have Z coordinates
+ * @param[in] srid SRID of the temporal points
+ * @param[in] seqs Sequences
+ * @param[in] count Number of sequences
+ * @param[in] nthreads Number of threads, the calling thread is used when it
+ * is less than 2
+ * @param[in] allocator Thread-safe allocator, or NULL for the one of the
+ * C library
+ * @param[out] outputs Binary representations of the sequences, whose
+ * status states whether each sequence was written
+ * @return MOBDB_WIRE_INVALID if the arguments are invalid, the status of
+ * each sequence is given in the outputs otherwise
+ */
+MobdbWireStatus
+mobdb_wire_write_batch(MobdbWireBase base, bool linear, bool hasz,
+  int32_t srid, const MobdbWireSequence *seqs, int32_t count, int nthreads,
+  const MobdbWireAllocator *allocator, MobdbWireOutput *outputs)
+{
+  /* Verify the arguments with the ones of a writer */
+  MobdbWireWriter *writer = mobdb_wire_writer_new(base, MOBDB_WIRE_SEQUENCE,
+    linear, hasz, srid, allocator);
+  if (writer == NULL)
+    return MOBDB_WIRE_INVALID;
+  mobdb_wire_writer_free(writer);
+  if (count < 0)
+    return MOBDB_WIRE_INVALID;
+
+  WireBatch batch;
+  batch.base = base;
+  batch.linear = linear;
+  batch.hasz = hasz;
+  batch.srid = srid;
+  batch.allocator = allocator;
+  batch.seqs = seqs;
+  batch.count = count;
+  batch.outputs = outputs;
+  atomic_init(&batch.next, 0);
+
+  /* There is no need of more threads than chunks */
+  int nchunks = (count + WIRE_BATCH_CHUNK - 1) / WIRE_BATCH_CHUNK;
+  if (nthreads > nchunks)
+    nthreads = nchunks;
+  pthread_t *threads = nthreads < 2 ? NULL :
+    malloc(sizeof(pthread_t) * (size_t) nthreads);
+  int started = 0;
+  for (int i = 0; threads != NULL && i < nthreads; i++)
+  {
+    if (pthread_create(&threads[i], NULL, &wire_batch_worker, &batch) != 0)
+      break;
+    started++;
+  }
+  /* The calling thread writes the batch if no thread was started */
+  if (started == 0)
+    wire_batch_worker(&batch);
+  for (int i = 0; i < started; i++)
+    pthread_join(threads[i], NULL);
+  free(threads);
+  return MOBDB_WIRE_OK;
+}
+
+/*****************************************************************************/
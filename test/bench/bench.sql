@@ -0,0 +1,18 @@
+-------------------------------------------------------------------------------
+-- Microbenchmarks of the kernels of temporal types
+-- Run with the bench target of the build, e.g., make bench
+-------------------------------------------------------------------------------
+
+SELECT b.kernel, b.instants, b.iterations,
+  round(b.ns_per_instant::numeric, 1) AS ns_per_instant,
+  b.bytes_per_call,
+  round(b.bytes_per_call::numeric / b.instants, 1) AS bytes_per_instant
+FROM (VALUES ('tsequence_make', 1), ('tsequence_at_period', 2),
+    ('sync_tfunc', 3), ('distance_tpoint_geo', 4),
+    ('tpointseq_at_geometry', 5), ('tsequence_tagg', 6),
+    ('temporal_out', 7), ('temporal_in', 8)) k(name, ord),
+  (VALUES (10, 10000), (100, 1000), (1000, 100), (10000, 10)) s(n, it),
+  LATERAL mobdb_bench(k.name, s.n, s.it) b
+ORDER BY k.ord, s.n;
+
+-------------------------------------------------------------------------------
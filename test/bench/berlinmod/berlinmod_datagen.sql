@@ -0,0 +1,166 @@
+-------------------------------------------------------------------------------
+-- BerlinMOD benchmark: generation of a dataset of a given scale factor
+--
+-- The trips of the cars are generated with the BerlinMOD trip generator
+-- create_trip on a synthetic road network, which is a square grid whose
+-- rows and columns are side roads except every fifth one, which is a main
+-- road, and every twentieth one, which is a freeway. Each car makes every
+-- day a trip from its home to its work in the morning and back in the
+-- evening along a Manhattan path. The number of cars and of days follow
+-- the scale factor as in BerlinMOD. All choices are deterministic, so that
+-- the datasets generated by two builds are equal.
+-------------------------------------------------------------------------------
+
+DROP TYPE IF EXISTS berlinmod_step CASCADE;
+CREATE TYPE berlinmod_step AS (linestring geometry, maxspeed float,
+  category int);
+
+/*
+ * Returns the edges of the Manhattan path between the two nodes of the
+ * grid, first along the row of the source and then along the column of the
+ * target
+ */
+DROP FUNCTION IF EXISTS berlinmod_path;
+CREATE FUNCTION berlinmod_path(source int, target int, gridsize int,
+  spacing float)
+RETURNS berlinmod_step[] AS $$
+DECLARE
+  i int := source / gridsize;
+  j int := source % gridsize;
+  i2 int := target / gridsize;
+  j2 int := target % gridsize;
+  d int;
+  category int;
+  maxspeed float;
+  result berlinmod_step[] := '{}';
+BEGIN
+  WHILE j <> j2 LOOP
+    d := sign(j2 - j);
+    IF i % 20 = 0 THEN category := 2; maxspeed := 100.0;
+    ELSIF i % 5 = 0 THEN category := 1; maxspeed := 50.0;
+    ELSE category := 0; maxspeed := 30.0;
+    END IF;
+    result := result || ROW(ST_MakeLine(ST_MakePoint(j * spacing, i * spacing),
+      ST_MakePoint((j + d) * spacing, i * spacing)), maxspeed,
+      category)::berlinmod_step;
+    j := j + d;
+  END LOOP;
+  WHILE i <> i2 LOOP
+    d := sign(i2 - i);
+    IF j % 20 = 0 THEN category := 2; maxspeed := 100.0;
+    ELSIF j % 5 = 0 THEN category := 1; maxspeed := 50.0;
+    ELSE category := 0; maxspeed := 30.0;
+    END IF;
+    result := result || ROW(ST_MakeLine(ST_MakePoint(j * spacing, i * spacing),
+      ST_MakePoint(j * spacing, (i + d) * spacing)), maxspeed,
+      category)::berlinmod_step;
+    i := i + d;
+  END LOOP;
+  RETURN result;
+END;
+$$ LANGUAGE plpgsql IMMUTABLE STRICT;
+
+/*
+ * Generates the tables of the benchmark for the scale factor, where the
+ * scale factor 1.0 corresponds to 2,000 cars during 28 days
+ */
+DROP FUNCTION IF EXISTS berlinmod_generate;
+CREATE FUNCTION berlinmod_generate(scalefactor float DEFAULT 0.005,
+  gridsize int DEFAULT 40, spacing float DEFAULT 250.0)
+RETURNS text AS $$
+DECLARE
+  nocars int;
+  nodays int;
+  nonodes int := gridsize * gridsize;
+BEGIN
+  nocars := greatest(10, round(2000 * sqrt(scalefactor)));
+  nodays := greatest(1, round(28 * sqrt(scalefactor)));
+
+  DROP TABLE IF EXISTS Nodes, Cars, Trips, Licences, Licences1, Licences2,
+    Points, Points1, Regions, Regions1, Instants, Instants1, Periods,
+    Periods1;
+
+  CREATE TABLE Nodes AS
+  SELECT i * gridsize + j AS NodeId,
+    ST_MakePoint(j * spacing, i * spacing) AS geom
+  FROM generate_series(0, gridsize - 1) i, generate_series(0, gridsize - 1) j;
+
+  CREATE TABLE Cars AS
+  SELECT c AS CarId,
+    'B-' || chr(65 + c % 26) || chr(65 + (c / 26) % 26) || ' ' || c AS Licence,
+    CASE WHEN c % 20 = 0 THEN 'truck' WHEN c % 20 = 1 THEN 'bus'
+      ELSE 'passenger' END AS Type,
+    (ARRAY['Mercedes-Benz', 'Volkswagen', 'Maybach', 'Porsche', 'Opel', 'BMW',
+      'Audi', 'Acura', 'Cadillac', 'Chrysler', 'Dodge', 'Ferrari', 'Honda',
+      'Jaguar', 'Toyota', 'Ford'])[1 + (c * 7) % 16] AS Model,
+    (c * 7919) % nonodes AS HomeNode,
+    (c * 104729 + nonodes / 2) % nonodes AS WorkNode
+  FROM generate_series(1, nocars) c;
+  UPDATE Cars SET WorkNode = (WorkNode + 1) % nonodes
+  WHERE HomeNode = WorkNode;
+
+  CREATE TABLE Trips AS
+  SELECT (row_number() OVER (ORDER BY c.CarId, d, dir))::int AS TripId,
+    c.CarId, d AS Day, create_trip(
+      berlinmod_path(CASE WHEN dir = 0 THEN HomeNode ELSE WorkNode END,
+        CASE WHEN dir = 0 THEN WorkNode ELSE HomeNode END, gridsize, spacing),
+      timestamptz '2020-06-01 08:00:00+00' + d * interval '1 day' +
+        dir * interval '9 hours' +
+        ((c.CarId * 7919 + d * 104729 + dir * 1299709) % 3600) *
+        interval '1 second', false, 'minimal') AS Trip
+  FROM Cars c, generate_series(0, nodays - 1) d, generate_series(0, 1) dir
+  ORDER BY c.CarId, d, dir;
+  ALTER TABLE Trips ADD COLUMN Trajectory geometry;
+  UPDATE Trips SET Trajectory = trajectory(Trip);
+
+  CREATE TABLE Licences AS
+  SELECT k AS LicenceId, c.Licence, c.CarId
+  FROM generate_series(1, 100) k, Cars c
+  WHERE c.CarId = (k * 31) % nocars + 1;
+  CREATE TABLE Licences1 AS SELECT * FROM Licences WHERE LicenceId <= 10;
+  CREATE TABLE Licences2 AS SELECT * FROM Licences
+    WHERE LicenceId > 10 AND LicenceId <= 20;
+
+  /* The points are nodes of the network and thus are crossed by trips */
+  CREATE TABLE Points AS
+  SELECT k AS PointId, n.geom
+  FROM generate_series(1, 100) k, Nodes n
+  WHERE n.NodeId = (k * 7907) % nonodes;
+  CREATE TABLE Points1 AS SELECT * FROM Points WHERE PointId <= 10;
+
+  CREATE TABLE Regions AS
+  SELECT k AS RegionId, ST_Buffer(n.geom, spacing * (1 + k % 3), 'quad_segs=2')
+    AS geom
+  FROM generate_series(1, 100) k, Nodes n
+  WHERE n.NodeId = (k * 6007) % nonodes;
+  CREATE TABLE Regions1 AS SELECT * FROM Regions WHERE RegionId <= 10;
+
+  /* The instants and the periods are in the hours of the trips */
+  CREATE TABLE Instants AS
+  SELECT k AS InstantId, timestamptz '2020-06-01 07:30:00+00' +
+    (k % nodays) * interval '1 day' + ((k * 37) % 630) * interval '1 minute'
+    AS Instant
+  FROM generate_series(1, 100) k;
+  CREATE TABLE Instants1 AS SELECT * FROM Instants WHERE InstantId <= 10;
+
+  CREATE TABLE Periods AS
+  SELECT k AS PeriodId, period(Instant, Instant + (1 + k % 6) *
+    interval '10 minutes') AS Period
+  FROM (SELECT k, timestamptz '2020-06-01 07:30:00+00' +
+    (k % nodays) * interval '1 day' + ((k * 53) % 630) * interval '1 minute'
+    AS Instant FROM generate_series(1, 100) k) t;
+  CREATE TABLE Periods1 AS SELECT * FROM Periods WHERE PeriodId <= 10;
+
+  CREATE UNIQUE INDEX Cars_CarId_idx ON Cars USING btree(CarId);
+  CREATE UNIQUE INDEX Trips_TripId_idx ON Trips USING btree(TripId);
+  CREATE INDEX Trips_CarId_idx ON Trips USING btree(CarId);
+  CREATE INDEX Licences_CarId_idx ON Licences USING btree(CarId);
+  CREATE INDEX Points_geom_idx ON Points USING gist(geom);
+  CREATE INDEX Regions_geom_idx ON Regions USING gist(geom);
+
+  RETURN format('Generated %s trips of %s cars during %s days',
+    (SELECT count(*) FROM Trips), nocars, nodays);
+END;
+$$ LANGUAGE plpgsql STRICT;
+
+-------------------------------------------------------------------------------
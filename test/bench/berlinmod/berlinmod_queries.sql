@@ -0,0 +1,280 @@
+-------------------------------------------------------------------------------
+-- BerlinMOD benchmark: the 17 range queries of BerlinMOD/r and the runner
+-- measuring their planning and execution time and recording their plans
+-------------------------------------------------------------------------------
+
+DROP TABLE IF EXISTS berlinmod_queries;
+CREATE TABLE berlinmod_queries(QueryId text PRIMARY KEY, Description text,
+  Query text);
+
+INSERT INTO berlinmod_queries VALUES
+('Q01', 'Models of the vehicles with licences from QueryLicences', $q$
+SELECT DISTINCT l.Licence, c.Model
+FROM Cars c, Licences l
+WHERE c.Licence = l.Licence
+$q$),
+('Q02', 'Number of vehicles that are passenger cars', $q$
+SELECT COUNT(*)
+FROM Cars
+WHERE Type = 'passenger'
+$q$),
+('Q03', 'Positions of the vehicles with licences from QueryLicences1 at the instants from QueryInstants1', $q$
+SELECT DISTINCT l.Licence, i.InstantId, i.Instant,
+  valueAtTimestamp(t.Trip, i.Instant) AS Pos
+FROM Trips t, Licences1 l, Instants1 i
+WHERE t.CarId = l.CarId AND intersectsTimestamp(t.Trip, i.Instant)
+$q$),
+('Q04', 'Licences of the vehicles that have passed the points from QueryPoints', $q$
+SELECT DISTINCT p.PointId, c.Licence
+FROM Trips t, Cars c, Points p
+WHERE t.CarId = c.CarId AND intersects(t.Trip, p.geom)
+$q$),
+('Q05', 'Minimum distance between the places where the vehicles from QueryLicences1 and QueryLicences2 have been', $q$
+SELECT l1.Licence AS Licence1, l2.Licence AS Licence2,
+  MIN(ST_Distance(t1.Trajectory, t2.Trajectory)) AS MinDist
+FROM Trips t1, Licences1 l1, Trips t2, Licences2 l2
+WHERE t1.CarId = l1.CarId AND t2.CarId = l2.CarId AND t1.CarId < t2.CarId
+GROUP BY l1.Licence, l2.Licence
+$q$),
+('Q06', 'Pairs of trucks that have ever been as close as 10m or less to each other', $q$
+SELECT DISTINCT c1.Licence AS Licence1, c2.Licence AS Licence2
+FROM Trips t1, Cars c1, Trips t2, Cars c2
+WHERE t1.CarId = c1.CarId AND t2.CarId = c2.CarId AND t1.CarId < t2.CarId AND
+  c1.Type = 'truck' AND c2.Type = 'truck' AND
+  t1.Trip && expandSpatial(stbox(t2.Trip), 10) AND
+  dwithin(t1.Trip, t2.Trip, 10)
+$q$),
+('Q07', 'Licences of the passenger cars that have reached the points from QueryPoints1 first', $q$
+WITH Timestamps AS (
+  SELECT c.Licence, p.PointId,
+    MIN(startTimestamp(atValue(t.Trip, p.geom))) AS Instant
+  FROM Trips t, Cars c, Points1 p
+  WHERE t.CarId = c.CarId AND c.Type = 'passenger' AND
+    intersects(t.Trip, p.geom)
+  GROUP BY c.Licence, p.PointId )
+SELECT t1.Licence, t1.PointId, t1.Instant
+FROM Timestamps t1
+WHERE t1.Instant <= ALL (
+  SELECT t2.Instant FROM Timestamps t2 WHERE t1.PointId = t2.PointId)
+$q$),
+('Q08', 'Distances travelled by the vehicles from QueryLicences1 during the periods from QueryPeriods1', $q$
+SELECT l.Licence, p.PeriodId, SUM(length(atPeriod(t.Trip, p.Period))) AS Dist
+FROM Trips t, Licences1 l, Periods1 p
+WHERE t.CarId = l.CarId AND t.Trip && stbox(p.Period)
+GROUP BY l.Licence, p.PeriodId
+$q$),
+('Q09', 'Longest distance travelled by a vehicle during each of the periods from QueryPeriods', $q$
+WITH Distances AS (
+  SELECT p.PeriodId, t.CarId, SUM(length(atPeriod(t.Trip, p.Period))) AS Dist
+  FROM Trips t, Periods p
+  WHERE t.Trip && stbox(p.Period)
+  GROUP BY p.PeriodId, t.CarId )
+SELECT PeriodId, MAX(Dist) AS MaxDist
+FROM Distances
+GROUP BY PeriodId
+$q$),
+('Q10', 'When the vehicles from QueryLicences1 met other vehicles at less than 3m and their licences', $q$
+SELECT l1.Licence AS Licence1, t2.CarId AS Car2Id,
+  getTime(atValue(tdwithin(t1.Trip, t2.Trip, 3.0), true)) AS Periods
+FROM Trips t1, Licences1 l1, Trips t2
+WHERE t1.CarId = l1.CarId AND t1.CarId <> t2.CarId AND
+  t2.Trip && expandSpatial(stbox(t1.Trip), 3) AND
+  dwithin(t1.Trip, t2.Trip, 3.0)
+$q$),
+('Q11', 'Vehicles that passed a point from QueryPoints1 at an instant from QueryInstants1', $q$
+SELECT p.PointId, i.InstantId, c.Licence
+FROM Trips t, Cars c, Points1 p, Instants1 i
+WHERE t.CarId = c.CarId AND t.Trip @> stbox(p.geom, i.Instant) AND
+  ST_Equals(valueAtTimestamp(t.Trip, i.Instant), p.geom)
+$q$),
+('Q12', 'Vehicles that met at a point from QueryPoints1 at an instant from QueryInstants1', $q$
+SELECT DISTINCT p.PointId, i.InstantId, c1.Licence AS Licence1,
+  c2.Licence AS Licence2
+FROM Trips t1, Cars c1, Trips t2, Cars c2, Points1 p, Instants1 i
+WHERE t1.CarId = c1.CarId AND t2.CarId = c2.CarId AND t1.CarId < t2.CarId AND
+  t1.Trip @> stbox(p.geom, i.Instant) AND t2.Trip @> stbox(p.geom, i.Instant) AND
+  ST_Equals(valueAtTimestamp(t1.Trip, i.Instant), p.geom) AND
+  ST_Equals(valueAtTimestamp(t2.Trip, i.Instant), p.geom)
+$q$),
+('Q13', 'Vehicles that travelled within a region from QueryRegions1 during a period from QueryPeriods1', $q$
+SELECT DISTINCT r.RegionId, p.PeriodId, c.Licence
+FROM Trips t, Cars c, Regions1 r, Periods1 p
+WHERE t.CarId = c.CarId AND t.Trip && stbox(r.geom, p.Period) AND
+  intersects(atPeriod(t.Trip, p.Period), r.geom)
+$q$),
+('Q14', 'Vehicles that travelled within a region from QueryRegions1 at an instant from QueryInstants1', $q$
+SELECT DISTINCT r.RegionId, i.InstantId, c.Licence
+FROM Trips t, Cars c, Regions1 r, Instants1 i
+WHERE t.CarId = c.CarId AND t.Trip && stbox(r.geom, i.Instant) AND
+  ST_Contains(r.geom, valueAtTimestamp(t.Trip, i.Instant))
+$q$),
+('Q15', 'Vehicles that passed a point from QueryPoints1 during a period from QueryPeriods1', $q$
+SELECT DISTINCT pt.PointId, pr.PeriodId, c.Licence
+FROM Trips t, Cars c, Points1 pt, Periods1 pr
+WHERE t.CarId = c.CarId AND t.Trip && stbox(pt.geom, pr.Period) AND
+  intersects(atPeriod(t.Trip, pr.Period), pt.geom)
+$q$),
+('Q16', 'Pairs of vehicles from QueryLicences1 and QueryLicences2 present in a region from QueryRegions1 during a period from QueryPeriods1 that do not meet', $q$
+SELECT p.PeriodId, r.RegionId, l1.Licence AS Licence1, l2.Licence AS Licence2
+FROM Trips t1, Licences1 l1, Trips t2, Licences2 l2, Periods1 p, Regions1 r
+WHERE t1.CarId = l1.CarId AND t2.CarId = l2.CarId AND
+  l1.Licence < l2.Licence AND
+  t1.Trip && stbox(r.geom, p.Period) AND t2.Trip && stbox(r.geom, p.Period) AND
+  intersects(atPeriod(t1.Trip, p.Period), r.geom) AND
+  intersects(atPeriod(t2.Trip, p.Period), r.geom) AND
+  NOT dwithin(atGeometry(atPeriod(t1.Trip, p.Period), r.geom),
+    atGeometry(atPeriod(t2.Trip, p.Period), r.geom), 0.0)
+$q$),
+('Q17', 'Points from QueryPoints visited by the maximum number of vehicles', $q$
+WITH PointCount AS (
+  SELECT p.PointId, COUNT(DISTINCT t.CarId) AS Hits
+  FROM Trips t, Points p
+  WHERE intersects(t.Trip, p.geom)
+  GROUP BY p.PointId )
+SELECT PointId, Hits
+FROM PointCount
+WHERE Hits = (SELECT MAX(Hits) FROM PointCount)
+$q$);
+
+/*
+ * Returns the shape of the plan, i.e., the types of its nodes in depth-first
+ * order with the indexes that they scan, which is compared with the one of
+ * the baseline to detect plan changes
+ */
+DROP FUNCTION IF EXISTS berlinmod_plan_shape;
+CREATE FUNCTION berlinmod_plan_shape(plan json)
+RETURNS text AS $$
+DECLARE
+  result text;
+  child json;
+BEGIN
+  result := plan->>'Node Type';
+  IF plan->>'Index Name' IS NOT NULL THEN
+    result := result || ' on ' || (plan->>'Index Name');
+  END IF;
+  IF plan->'Plans' IS NOT NULL THEN
+    FOR child IN SELECT * FROM json_array_elements(plan->'Plans') LOOP
+      result := result || ' (' || berlinmod_plan_shape(child) || ')';
+    END LOOP;
+  END IF;
+  RETURN result;
+END;
+$$ LANGUAGE plpgsql IMMUTABLE STRICT;
+
+DROP VIEW IF EXISTS berlinmod_report CASCADE;
+DROP TABLE IF EXISTS berlinmod_results;
+CREATE TABLE berlinmod_results(IndexType text, QueryId text, Runs int,
+  PlanningMs float, ExecutionMs float, NumRows bigint, PlanShape text,
+  Plan json);
+
+/*
+ * Runs the queries with a GiST and, from PostgreSQL 11, with an SP-GiST
+ * index on the trips. Each query is run the given number of times after a
+ * warm-up run and the median of the planning and execution times reported
+ * by EXPLAIN ANALYZE is recorded with the plan of the last run. The time
+ * for building the index is recorded as the query Index.
+ */
+DROP FUNCTION IF EXISTS berlinmod_run;
+CREATE FUNCTION berlinmod_run(runs int DEFAULT 3)
+RETURNS bigint AS $$
+DECLARE
+  indextype text;
+  rec record;
+  plan json;
+  planning float[];
+  execution float[];
+  starttime timestamptz;
+BEGIN
+  DELETE FROM berlinmod_results;
+  DROP INDEX IF EXISTS Trips_Trip_idx;
+  FOREACH indextype IN ARRAY CASE
+    WHEN current_setting('server_version_num')::int >= 110000
+    THEN ARRAY['gist', 'spgist'] ELSE ARRAY['gist'] END
+  LOOP
+    starttime := clock_timestamp();
+    EXECUTE format('CREATE INDEX Trips_Trip_idx ON Trips USING %s(Trip)',
+      indextype);
+    INSERT INTO berlinmod_results VALUES (indextype, 'Index', 1, 0.0,
+      extract(epoch FROM clock_timestamp() - starttime) * 1000.0, NULL, NULL,
+      NULL);
+    ANALYZE Trips;
+    FOR rec IN SELECT * FROM berlinmod_queries ORDER BY QueryId LOOP
+      planning := '{}';
+      execution := '{}';
+      FOR i IN 0..runs LOOP
+        EXECUTE 'EXPLAIN (ANALYZE, TIMING OFF, FORMAT JSON) ' || rec.Query
+          INTO plan;
+        /* The first run warms up the caches */
+        IF i > 0 THEN
+          planning := planning || (plan->0->>'Planning Time')::float;
+          execution := execution || (plan->0->>'Execution Time')::float;
+        END IF;
+      END LOOP;
+      INSERT INTO berlinmod_results
+      SELECT indextype, rec.QueryId, runs,
+        (SELECT percentile_cont(0.5) WITHIN GROUP (ORDER BY x)
+          FROM unnest(planning) x),
+        (SELECT percentile_cont(0.5) WITHIN GROUP (ORDER BY x)
+          FROM unnest(execution) x),
+        (plan->0->'Plan'->>'Actual Rows')::bigint,
+        berlinmod_plan_shape(plan->0->'Plan'), plan->0;
+    END LOOP;
+    EXECUTE 'DROP INDEX Trips_Trip_idx';
+  END LOOP;
+  RETURN (SELECT count(*) FROM berlinmod_results);
+END;
+$$ LANGUAGE plpgsql STRICT;
+
+CREATE VIEW berlinmod_report AS
+SELECT IndexType, QueryId, Runs, round(PlanningMs::numeric, 3) AS PlanningMs,
+  round(ExecutionMs::numeric, 3) AS ExecutionMs, NumRows, PlanShape
+FROM berlinmod_results;
+
+/* The baseline is loaded from the file of the results of a previous run */
+DROP TABLE IF EXISTS berlinmod_baseline;
+CREATE TABLE berlinmod_baseline AS
+SELECT * FROM berlinmod_report WITH NO DATA;
+
+/*
+ * Compares the results with those of the baseline. A query regresses when
+ * its execution time exceeds the one of the baseline by the given ratio and
+ * by at least the given number of milliseconds, which avoids reporting the
+ * noise of the fast queries.
+ */
+DROP FUNCTION IF EXISTS berlinmod_compare;
+CREATE FUNCTION berlinmod_compare(maxratio float DEFAULT 1.5,
+  minms float DEFAULT 5.0)
+RETURNS TABLE(IndexType text, QueryId text, BaselineMs numeric,
+  CurrentMs numeric, Ratio numeric, RowsChanged boolean, PlanChanged boolean,
+  Regression boolean) AS $$
+  SELECT r.IndexType, r.QueryId, b.ExecutionMs, r.ExecutionMs,
+    round(r.ExecutionMs / nullif(b.ExecutionMs, 0), 2),
+    r.NumRows IS DISTINCT FROM b.NumRows,
+    r.PlanShape IS DISTINCT FROM b.PlanShape,
+    r.ExecutionMs > b.ExecutionMs * maxratio AND
+      r.ExecutionMs - b.ExecutionMs > minms
+  FROM berlinmod_report r JOIN berlinmod_baseline b
+    ON r.IndexType = b.IndexType AND r.QueryId = b.QueryId
+  ORDER BY r.IndexType, r.QueryId;
+$$ LANGUAGE sql;
+
+/*
+ * Raises an error when a query regresses with respect to the baseline
+ */
+DROP FUNCTION IF EXISTS berlinmod_check;
+CREATE FUNCTION berlinmod_check(maxratio float DEFAULT 1.5,
+  minms float DEFAULT 5.0)
+RETURNS void AS $$
+DECLARE
+  queries text;
+BEGIN
+  SELECT string_agg(IndexType || ' ' || QueryId, ', ') INTO queries
+  FROM berlinmod_compare(maxratio, minms)
+  WHERE Regression;
+  IF queries IS NOT NULL THEN
+    RAISE EXCEPTION 'Queries slower than the baseline: %', queries;
+  END IF;
+END;
+$$ LANGUAGE plpgsql STRICT;
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,105 @@
+-------------------------------------------------------------------------------
+-- Assertions of the performance tests
+-- The file is prepended to every performance test by test.sh run_perf. The
+-- functions raise an error, and thus fail the test, when the assertion does
+-- not hold. The execution times are only compared with the ones of a
+-- baseline query run on the same machine, the absolute execution times of
+-- the kernels are measured by the bench target instead.
+-------------------------------------------------------------------------------
+
+/* Asserts that the plan of the query scans the index */
+CREATE OR REPLACE FUNCTION perf_assert_index(query text, indexname text)
+RETURNS void AS $$
+DECLARE
+  plan jsonb;
+  found int;
+BEGIN
+  EXECUTE 'EXPLAIN (FORMAT JSON) ' || query INTO plan;
+  WITH RECURSIVE nodes(node) AS (
+    SELECT plan->0->'Plan'
+    UNION ALL
+    SELECT jsonb_array_elements(node->'Plans')
+    FROM nodes
+    WHERE node ? 'Plans' )
+  SELECT count(*) INTO found
+  FROM nodes
+  WHERE node->>'Index Name' = indexname;
+  IF found = 0 THEN
+    RAISE EXCEPTION 'The plan does not use the index %: %: %', indexname,
+      query, plan;
+  END IF;
+END;
+$$ LANGUAGE plpgsql;
+
+/* Asserts that the best execution time of the runs of the query is at most
+ * the given ratio of the best execution time of the runs of the baseline.
+ * The runs of both queries are interleaved so that the load of the machine
+ * affects both of them. */
+CREATE OR REPLACE FUNCTION perf_assert_faster(query text, baseline text,
+  maxratio float, runs int DEFAULT 5)
+RETURNS void AS $$
+DECLARE
+  plan json;
+  best float = 'Infinity';
+  bestbaseline float = 'Infinity';
+BEGIN
+  FOR i IN 1..runs LOOP
+    EXECUTE 'EXPLAIN (ANALYZE, FORMAT JSON) ' || query INTO plan;
+    best = least(best, (plan->0->>'Execution Time')::float);
+    EXECUTE 'EXPLAIN (ANALYZE, FORMAT JSON) ' || baseline INTO plan;
+    bestbaseline = least(bestbaseline,
+      (plan->0->>'Execution Time')::float);
+  END LOOP;
+  IF best > maxratio * bestbaseline THEN
+    RAISE EXCEPTION 'The query took % ms, more than % times the % ms of the baseline: %: %',
+      round(best::numeric, 3), maxratio, round(bestbaseline::numeric, 3),
+      query, baseline;
+  END IF;
+END;
+$$ LANGUAGE plpgsql;
+
+/* Asserts that a counter of mobilitydb_stat_functions of the query is
+ * bounded */
+CREATE OR REPLACE FUNCTION perf_assert_counter(query text, countername text,
+  maxvalue bigint)
+RETURNS void AS $$
+DECLARE
+  oldstats text;
+  result bigint;
+BEGIN
+  oldstats = current_setting('mobilitydb.function_stats');
+  PERFORM set_config('mobilitydb.function_stats', 'on', false);
+  PERFORM mobilitydb_stat_reset();
+  EXECUTE 'SELECT count(*) FROM (' || query || ') q';
+  SELECT value INTO result
+  FROM mobilitydb_stat_functions
+  WHERE counter = countername;
+  PERFORM set_config('mobilitydb.function_stats', oldstats, false);
+  IF result > maxvalue THEN
+    RAISE EXCEPTION 'The counter % is %, more than the bound of %: %',
+      countername, result, maxvalue, query;
+  END IF;
+END;
+$$ LANGUAGE plpgsql;
+
+/* Asserts that the number of calls of the consistent method of the GiST
+ * indexes of the key type on the leaf entries of the query is bounded */
+CREATE OR REPLACE FUNCTION perf_assert_gist(query text, keytype text,
+  maxcalls bigint)
+RETURNS void AS $$
+DECLARE
+  result bigint;
+BEGIN
+  PERFORM gist_consistent_reset();
+  EXECUTE 'SELECT count(*) FROM (' || query || ') q';
+  SELECT s.leaf_calls INTO result
+  FROM gist_consistent_stats s
+  WHERE s.keytype = perf_assert_gist.keytype;
+  IF result > maxcalls THEN
+    RAISE EXCEPTION 'The index made % consistent calls on % leaf entries, more than the bound of %: %',
+      result, keytype, maxcalls, query;
+  END IF;
+END;
+$$ LANGUAGE plpgsql;
+
+-------------------------------------------------------------------------------
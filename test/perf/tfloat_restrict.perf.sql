@@ -0,0 +1,45 @@
+-------------------------------------------------------------------------------
+-- Performance of the restriction of temporal floats to a period and of the
+-- GiST index on temporal floats
+-------------------------------------------------------------------------------
+
+DROP TABLE IF EXISTS perf_tfloat;
+CREATE TABLE perf_tfloat AS
+SELECT k, temp
+FROM generate_tfloats(20000, 100, 0, 100, period '[2000-01-01, 2000-02-01]')
+  WITH ORDINALITY t(temp, k);
+CREATE INDEX perf_tfloat_gist_idx ON perf_tfloat USING gist(temp);
+ANALYZE perf_tfloat;
+
+/* The selective queries on the time dimension use the index */
+SELECT perf_assert_index(
+  'SELECT k FROM perf_tfloat WHERE temp && period ''[2000-01-10, 2000-01-10 00:10:00]''',
+  'perf_tfloat_gist_idx');
+SELECT perf_assert_index(
+  'SELECT k FROM perf_tfloat WHERE temp && tbox ''TBOX((10, 2000-01-10), (20, 2000-01-11))''',
+  'perf_tfloat_gist_idx');
+
+/* The index only visits the leaf entries of a few pages */
+SELECT perf_assert_gist(
+  'SELECT k FROM perf_tfloat WHERE temp && period ''[2000-01-10, 2000-01-10 00:10:00]''',
+  'tbox', 2000);
+
+/* The restriction of the values overlapping a period of 10 minutes, which
+ * are sequences of 100 instants separated by one minute, constructs at
+ * most 12 instants for each value */
+SELECT perf_assert_counter(
+  'SELECT atPeriod(temp, period ''[2000-01-10, 2000-01-10 00:10:00]'') FROM perf_tfloat WHERE temp && period ''[2000-01-10, 2000-01-10 00:10:00]''',
+  'instants',
+  12 * (SELECT count(*) FROM perf_tfloat
+    WHERE temp && period '[2000-01-10, 2000-01-10 00:10:00]'));
+
+/* The index scan is faster than the scan computing the boxes of all the
+ * values */
+SELECT perf_assert_faster(
+  'SELECT k FROM perf_tfloat WHERE temp && tbox ''TBOX((10, 2000-01-10), (20, 2000-01-11))''',
+  'SELECT k FROM perf_tfloat WHERE temp::tbox && tbox ''TBOX((10, 2000-01-10), (20, 2000-01-11))''',
+  0.5);
+
+DROP TABLE perf_tfloat;
+
+-------------------------------------------------------------------------------
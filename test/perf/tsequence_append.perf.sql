@@ -0,0 +1,49 @@
+-------------------------------------------------------------------------------
+-- Performance of the appending of instants to a temporal sequence kept in
+-- expanded format by an aggregate
+-------------------------------------------------------------------------------
+
+DROP TABLE IF EXISTS perf_append;
+CREATE TABLE perf_append AS
+SELECT k, tfloatinst(k, timestamptz '2000-01-01' + k * interval '1 minute')
+  AS inst
+FROM generate_series(1, 5000) k;
+
+/* The state of the aggregate is the sequence, which is passed read-write to
+ * appendInstant */
+CREATE AGGREGATE perf_extend(tfloat) (
+  SFUNC = appendInstant,
+  STYPE = tfloat,
+  INITCOND = '[0@2000-01-01]'
+);
+
+/* The instants are appended in place to the expanded state, so that the
+ * sequence is only constructed when the result is output instead of for
+ * every instant as for the flat values */
+SELECT perf_assert_counter(
+  'SELECT perf_extend(inst ORDER BY k) FROM perf_append',
+  'sequences', 10);
+
+/* The SQL function passes its arguments read-only, so that appendInstant
+ * copies the whole sequence for every instant */
+CREATE FUNCTION perf_append_flat(tfloat, tfloat)
+RETURNS tfloat AS $$
+  SELECT appendInstant($1, $2)
+$$ LANGUAGE sql;
+CREATE AGGREGATE perf_extend_flat(tfloat) (
+  SFUNC = perf_append_flat,
+  STYPE = tfloat,
+  INITCOND = '[0@2000-01-01]'
+);
+
+SELECT perf_assert_faster(
+  'SELECT perf_extend(inst ORDER BY k) FROM perf_append',
+  'SELECT perf_extend_flat(inst ORDER BY k) FROM perf_append',
+  0.5);
+
+DROP AGGREGATE perf_extend_flat(tfloat);
+DROP FUNCTION perf_append_flat(tfloat, tfloat);
+DROP AGGREGATE perf_extend(tfloat);
+DROP TABLE perf_append;
+
+-------------------------------------------------------------------------------
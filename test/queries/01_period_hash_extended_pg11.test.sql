@@ -1,3 +1,3 @@
-SELECT period_hash_extended('[2000-01-01,2000-01-02]') = period_hash_extended('[2000-01-01,2000-01-02]');
-SELECT period_hash_extended('[2000-01-01,2000-01-02]') <> period_hash_extended('[2000-01-02,2000-01-02]');
-SELECT count(*) FROM tbl_period WHERE period_hash_extended(p)=period_hash_extended(p);
\ No newline at end of file
+SELECT period_hash_extended('[2000-01-01,2000-01-02]', 1) = period_hash_extended('[2000-01-01,2000-01-02]', 1);
+SELECT period_hash_extended('[2000-01-01,2000-01-02]', 1) <> period_hash_extended('[2000-01-02,2000-01-02]', 1);
+SELECT count(*) FROM tbl_period WHERE period_hash_extended(p, 1)=period_hash_extended(p, 1);
\ No newline at end of file
@@ -56,6 +56,12 @@ SELECT timestamps(timestampset '{2000-01-01, 2000-01-02, 2000-01-03}');
 SELECT shift(timestampset '{2000-01-01}', '5 min');
 SELECT shift(timestampset '{2000-01-01, 2000-01-02, 2000-01-03}', '5 min');
 
+SELECT memSize(timestampset(ARRAY(SELECT timestamptz '2000-01-01' + i * interval '5 minutes' FROM generate_series(0, 8639) i)));
+SELECT timestampN(timestampset(ARRAY(SELECT timestamptz '2000-01-01' + i * interval '5 minutes' FROM generate_series(0, 8639) i)), 8640);
+SELECT endTimestamp(shift(timestampset(ARRAY(SELECT timestamptz '2000-01-01' + i * interval '5 minutes' FROM generate_series(0, 8639) i)), '1 hour'));
+SELECT timestampset '{2000-01-01, 2000-01-02, 2000-01-03, 2000-01-04, 2000-01-06, 2000-01-07, 2000-01-08, 2000-01-09}';
+SELECT timestampN(timestampset '{2000-01-01, 2000-01-02, 2000-01-03, 2000-01-04, 2000-01-06, 2000-01-07, 2000-01-08, 2000-01-09}', 6);
+
 SELECT timestampset_cmp(timestampset '{2000-01-01}', timestampset '{2000-01-01, 2000-01-02, 2000-01-03}') = -1;
 SELECT timestampset '{2000-01-01}' = timestampset '{2000-01-01, 2000-01-02, 2000-01-03}';
 SELECT timestampset '{2000-01-01}' <> timestampset '{2000-01-01, 2000-01-02, 2000-01-03}';
@@ -108,6 +108,13 @@ SELECT timestampset '{2000-01-01, 2000-01-04}' - periodset '{[2000-01-02, 2000-0
 SELECT timestampset '{2000-01-01, 2000-01-03}' - periodset '{(2000-01-01, 2000-01-04)}';
 SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' - periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}';
 
+SELECT numTimestamps(timestampset(ARRAY(SELECT timestamptz '2000-01-01' + i * interval '5 minutes' FROM generate_series(0, 8639) i)) * period '[2000-01-10, 2000-01-11)');
+SELECT numTimestamps(timestampset(ARRAY(SELECT timestamptz '2000-01-01' + i * interval '5 minutes' FROM generate_series(0, 8639) i)) - periodset '{[2000-01-10, 2000-01-11), [2000-01-20 00:02, 2000-01-20 00:07]}');
+SELECT memSize(timestampset(ARRAY(SELECT timestamptz '2000-01-01' + i * interval '5 minutes' FROM generate_series(0, 8639) i)) - periodset '{[2000-01-10, 2000-01-11), [2000-01-20 00:02, 2000-01-20 00:07]}');
+SELECT timestampset(ARRAY(SELECT timestamptz '2000-01-01' + i * interval '5 minutes' FROM generate_series(0, 8639) i)) @> timestamptz '2000-01-15 12:35';
+SELECT timestampset(ARRAY(SELECT timestamptz '2000-01-01' + i * interval '5 minutes' FROM generate_series(0, 8639) i)) @> timestamptz '2000-01-15 12:36';
+SELECT timestampset '{2000-01-01, 2000-01-02, 2000-01-03, 2000-01-04, 2000-01-06, 2000-01-07, 2000-01-08, 2000-01-09}' * period '(2000-01-02, 2000-01-07]';
+
 SELECT period '[2000-01-01, 2000-01-01]' - timestamptz '2000-01-01';
 SELECT period '[2000-01-01, 2000-01-03]' - timestamptz '2000-01-01';
 SELECT period '[2000-01-01, 2000-01-01]' - timestampset '{2000-01-01, 2000-01-03, 2000-01-05}';
@@ -146,6 +153,12 @@ SELECT periodset '{[2000-01-01, 2000-01-03]}' - period '[2000-01-01, 2000-01-03]
 SELECT periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}' - periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}';
 SELECT periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}' - periodset '{[2000-01-04, 2000-01-05]}';
 SELECT periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}' - periodset '{[2000-01-01, 2000-01-03]}';
+SELECT periodset '{[2000-01-05, 2000-01-10]}' - periodset '{[2000-01-01, 2000-01-02],[2000-01-06, 2000-01-07]}';
+SELECT COUNT(*) FROM generate_series(0, 3999) j WHERE (SELECT periodset(array_agg(period(timestamptz '2000-01-01' + i * interval '1 day' + interval '0 hours', timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours'))) FROM generate_series(0, 999) i) @> timestamptz '2000-01-01' + j * interval '6 hours';
+SELECT COUNT(*) FROM generate_series(0, 3999) j WHERE timestamptz '2000-01-01' + ((j * 7) % 4000) * interval '6 hours' <@ (SELECT periodset(array_agg(period(timestamptz '2000-01-01' + i * interval '1 day' + interval '0 hours', timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours'))) FROM generate_series(0, 999) i);
+SELECT numPeriods((SELECT periodset(array_agg(period(timestamptz '2000-01-01' + i * interval '1 day' + interval '0 hours', timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours'))) FROM generate_series(0, 999) i) + (SELECT periodset(array_agg(period(timestamptz '2000-01-01' + i * interval '1 day' + interval '6 hours', timestamptz '2000-01-01' + i * interval '1 day' + interval '18 hours'))) FROM generate_series(0, 999) i));
+SELECT numPeriods((SELECT periodset(array_agg(period(timestamptz '2000-01-01' + i * interval '1 day' + interval '0 hours', timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours'))) FROM generate_series(0, 999) i) * (SELECT periodset(array_agg(period(timestamptz '2000-01-01' + i * interval '1 day' + interval '6 hours', timestamptz '2000-01-01' + i * interval '1 day' + interval '18 hours'))) FROM generate_series(0, 999) i));
+SELECT numPeriods((SELECT periodset(array_agg(period(timestamptz '2000-01-01' + i * interval '1 day' + interval '0 hours', timestamptz '2000-01-01' + i * interval '1 day' + interval '12 hours'))) FROM generate_series(0, 999) i) - (SELECT periodset(array_agg(period(timestamptz '2000-01-01' + i * interval '1 day' + interval '6 hours', timestamptz '2000-01-01' + i * interval '1 day' + interval '18 hours'))) FROM generate_series(0, 999) i));
 
 -------------------------------------------------------------------------------
 
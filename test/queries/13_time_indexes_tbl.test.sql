@@ -71,6 +71,16 @@ DROP INDEX IF EXISTS tbl_timestampset_big_gist_idx;
 DROP INDEX IF EXISTS tbl_period_big_gist_idx;
 DROP INDEX IF EXISTS tbl_periodset_big_gist_idx;
 
+CREATE INDEX tbl_period_big_brin_idx ON tbl_period_big USING BRIN(p);
+
+SELECT count(*) FROM tbl_period_big WHERE p && period '[2001-06-01, 2001-07-01]';
+SELECT count(*) FROM tbl_period_big WHERE p @> period '[2001-06-01, 2001-07-01]';
+SELECT count(*) FROM tbl_period_big WHERE p <<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_period_big WHERE p #>> period '[2001-11-01, 2001-12-01]';
+SELECT count(*) FROM tbl_period_big WHERE p && periodset '{[2001-01-01, 2001-02-01]}';
+
+DROP INDEX IF EXISTS tbl_period_big_brin_idx;
+
 -------------------------------------------------------------------------------
 
 DROP TABLE IF EXISTS tbl_period_test;
@@ -16,6 +16,8 @@ SELECT tint '1@2012-01-01 08:00:00';
 SELECT tint '2@2012-01-01 08:00:00';
 SELECT tfloat '1@2012-01-01 08:00:00';
 SELECT tfloat '2@2012-01-01 08:00:00';
+SELECT tfloat '{0.1@2012-01-01 08:00:00.1234+05:30, 1.5@2012-01-01 08:00:00.125+02}';
+SELECT tfloat '-2.25@0044-03-15 12:00:00 BC';
 SELECT ttext 'AAA@2012-01-01 08:00:00';
 SELECT ttext 'BBB@2012-01-01 08:00:00';
 /* Errors */
@@ -526,8 +528,12 @@ SELECT appendInstant(tfloat '{[1@2000-01-01, 1@2000-01-02]}', '1@2000-01-02');
 SELECT appendInstant(tfloat '{[1@2000-01-01, 1@2000-01-02)}', '1@2000-01-02');
 SELECT appendInstant(tfloat '{[1@2000-01-01, 1@2000-01-02)}', '2@2000-01-02');
 SELECT appendInstant(tfloat 'Interp=Stepwise;{[1@2000-01-01, 1@2000-01-02)}', '2@2000-01-02');
+SELECT appendInstant(appendInstant(tfloat '[1@2000-01-01, 2@2000-01-02]', tfloat '3@2000-01-03'), tfloat '1@2000-01-04');
+SELECT appendInstant(appendInstant(ttext '[AAA@2000-01-01, BBB@2000-01-02]', ttext 'BBB@2000-01-03'), ttext 'CCC@2000-01-04');
+SELECT appendInstant(appendInstant(tfloat '[1@2000-01-01]', tfloat '1@2000-01-02'), tfloat '1@2000-01-02');
 /* Errors */
 SELECT appendInstant(tfloat '{1@2000-01-01, 2@2000-01-02}', tfloat '2@2000-01-01');
+SELECT appendInstant(appendInstant(tint '[1@2000-01-01]', tint '2@2000-01-03'), tint '3@2000-01-02');
 SELECT appendInstant(tfloat '[1@2000-01-01, 1@2000-01-02]', '2@2000-01-02');
 SELECT appendInstant(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-04, 1@2000-01-05]');
 SELECT appendInstant(tfloat '{[1@2000-01-01, 1@2000-01-02]}', '2@2000-01-02');
@@ -580,6 +586,10 @@ SELECT merge(ARRAY[tint '{1@2000-01-01}', '{[2@2000-01-02, 3@2000-01-03]}']);
 SELECT merge(ARRAY[tint '[1@2000-01-01]', '{[2@2000-01-02, 3@2000-01-03]}']);
 SELECT merge(ARRAY[tint '[1@2000-01-01]', '[1@2000-01-01, 1@2000-01-02, 2@2000-01-03]', '[2@2000-01-04]']);
 
+SELECT merge(ARRAY[tfloat '[1@2000-01-03, 2@2000-01-04]', '[1@2000-01-01, 1@2000-01-02]', '[1@2000-01-02, 1@2000-01-03]']);
+SELECT merge(ARRAY[tint '[1@2000-01-01, 1@2000-01-02)', '[2@2000-01-02, 2@2000-01-03]']);
+SELECT merge(ARRAY[tint '{1@2000-01-01, 3@2000-01-03}', '{2@2000-01-02, 3@2000-01-03, 4@2000-01-04}', '{5@2000-01-05}']);
+
 SELECT merge(tint '{1@2000-01-03, 2@2000-01-04}', tint '1@2000-01-01');
 SELECT merge(tint '[1@2000-01-03, 2@2000-01-04]', tint '1@2000-01-01');
 SELECT merge(tint '{[2@2000-01-02], [1@2000-01-03, 2@2000-01-04]}', tint '1@2000-01-01');
@@ -712,6 +722,12 @@ SELECT memSize(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}');
 SELECT memSize(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]');
 SELECT memSize(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}');
 
+SELECT base_values, instants FROM memBreakdown(tfloat '1.5@2000-01-01');
+SELECT base_values FROM memBreakdown(tfloat '{1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03}');
+SELECT base_values, trajectory FROM memBreakdown(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}');
+SELECT header + bbox + offsets + blocks + instants + base_values + trajectory = size FROM memBreakdown(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}');
+SELECT size = memSize(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]') FROM memBreakdown(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]');
+
 /*
 SELECT tbox(tint '1@2000-01-01');
 SELECT tbox(tfloat '1.5@2000-01-01');
@@ -1289,6 +1305,8 @@ SELECT shiftTscale(ttext 'AAA@2000-01-01', '1 day', '1 day');
 SELECT shiftTscale(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}', '1 day', '1 day');
 SELECT shiftTscale(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]', '1 day', '1 day');
 SELECT shiftTscale(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}', '1 day', '1 day');
+SELECT shift(tfloat '[1@2000-01-01, 2@2000-01-02 06:00, 1@2000-01-03]', '36 hours') = tfloat '[1@2000-01-02 12:00, 2@2000-01-03 18:00, 1@2000-01-04 12:00]';
+SELECT shift(shift(tfloatseq(array_agg(tfloatinst(i::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)), '5 hours'), '-5 hours') = tfloatseq(array_agg(tfloatinst(i::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) FROM generate_series(1, 2000) i;
 
 /* Errors */
 SELECT tscale(tfloat '1@2000-01-01', '0');
@@ -1334,6 +1352,13 @@ SELECT ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04,
 
 SELECT tfloat '[1@2000-01-01, 1@2000-01-03]' ?= 1;
 SELECT tfloat '[1@2000-01-01, 2@2000-01-03]' ?= 2;
+-- Long sequences with a directory of block bounding boxes
+SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) ?= 1500.5 FROM generate_series(1, 2000) i;
+SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false) ?= 2.5 FROM generate_series(1, 2000) i;
+SELECT tint(tfloatseq(array_agg(tfloatinst(i + 0.5, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false)) ?= 1500 FROM generate_series(1, 2000) i;
+SELECT tfloat(tintseq(array_agg(tintinst(i, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i))) ?= 1500.5 FROM generate_series(1, 2000) i;
+SELECT atValue(temp, 1500.5) = atValues(temp, ARRAY[1500.5]) FROM (SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(1, 2000) i) t;
+SELECT atValue(tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), true, true, false), 2.5) IS NULL FROM generate_series(1, 2000) i;
 
 SELECT tbool 't@2000-01-01' %= true;
 SELECT tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}' %= true;
@@ -1588,6 +1613,10 @@ SELECT atValues(tint '{1@2000-01-01}', '{}'::int[]);
 SELECT atValues(tfloat '{1@2000-01-01}', '{}'::float[]);
 SELECT atValues(ttext '{1@2000-01-01}', '{}'::text[]);
 
+SELECT atValues(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03, 5@2000-01-04]', ARRAY(SELECT generate_series(5, 500, 5)) || 1) = atValues(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03, 5@2000-01-04]', ARRAY[1, 5]);
+SELECT atValues(tfloat '[1@2000-01-01, 3@2000-01-02, 0.5@2000-01-03]', ARRAY(SELECT generate_series(0, 100)::float)) = atValues(tfloat '[1@2000-01-01, 3@2000-01-02, 0.5@2000-01-03]', ARRAY[1, 2, 3]);
+SELECT atValues(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}', ARRAY(SELECT 'A' || i FROM generate_series(1, 100) i) || text 'BBB') = ttext '{BBB@2000-01-02}';
+
 SELECT minusValues(tbool 't@2000-01-01', ARRAY[true]);
 SELECT minusValues(tbool '{t@2000-01-01}', ARRAY[true]);
 SELECT minusValues(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', ARRAY[true]);
@@ -1696,6 +1725,8 @@ SELECT atRanges(tfloat '1.5@2000-01-01', ARRAY[floatrange '[5,6]']);
 SELECT atRanges(tfloat '{1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03}', ARRAY[floatrange '[5,6]']);
 SELECT atRanges(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]', ARRAY[floatrange '[5,6]']);
 SELECT atRanges(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', ARRAY[floatrange '[5,6]']);
+SELECT atRanges(tint '[1@2000-01-01, 7@2000-01-02, 3@2000-01-03]', ARRAY(SELECT intrange(i, i + 1) FROM generate_series(1, 101, 2) i)) = tint '{[1@2000-01-01, 7@2000-01-02, 3@2000-01-03]}';
+SELECT atRanges(tfloat '[1@2000-01-01, 5@2000-01-02, 2@2000-01-03]', ARRAY(SELECT floatrange(i, i + 0.5) FROM generate_series(0, 100) i)) = atRanges(tfloat '[1@2000-01-01, 5@2000-01-02, 2@2000-01-03]', ARRAY[floatrange '[1,1.5)', floatrange '[2,2.5)', floatrange '[3,3.5)', floatrange '[4,4.5)', floatrange '[5,5.5)']);
 
 SELECT minusRanges(tint '1@2000-01-01', ARRAY[intrange 'empty']);
 SELECT minusRanges(tint '1@2000-01-01', ARRAY[intrange '[1,3]']);
@@ -1849,6 +1880,20 @@ SELECT valueAtTimestamp(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}'
 SELECT valueAtTimestamp(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]', timestamptz '2000-01-01');
 SELECT valueAtTimestamp(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}', timestamptz '2000-01-01');
 
+SELECT SUM(valueAtTimestamp(tfloat '{[1@2000-01-01, 2@2000-01-02],[3@2000-01-03, 4@2000-01-04],[5@2000-01-05, 6@2000-01-06]}', timestamptz '2000-01-01' + i * interval '6 hours')) FROM generate_series(0, 24) i;
+SELECT SUM(valueAtTimestamp(tfloat '{[1@2000-01-01, 2@2000-01-02],[3@2000-01-03, 4@2000-01-04],[5@2000-01-05, 6@2000-01-06]}', timestamptz '2000-01-01' + ((i * 7) % 25) * interval '6 hours')) FROM generate_series(0, 24) i;
+WITH seq AS (SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute' + (i % 5) * interval '5 seconds') ORDER BY i)) AS temp FROM generate_series(1, 1000) i) SELECT bool_and(valueAtTimestamp(temp, getTimestamp(inst)) = getValue(inst)) FROM seq, unnest(instants(temp)) inst;
+WITH seq AS (SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute' + (i % 2) * interval '40 seconds') ORDER BY i)) AS temp FROM generate_series(1, 1000) i) SELECT bool_and(valueAtTimestamp(temp, getTimestamp(inst)) = getValue(inst)) FROM seq, unnest(instants(temp)) inst;
+WITH seq AS (SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i), false, false) AS temp FROM generate_series(1, 1000) i) SELECT valueAtTimestamp(temp, timestamptz '2000-01-01 00:01:00') IS NULL AND valueAtTimestamp(temp, timestamptz '2000-01-01 16:40:00') IS NULL FROM seq;
+WITH ss AS (SELECT tfloats(array_agg(tfloatseq(ARRAY[tfloatinst(1, timestamptz '2000-01-01' + i * interval '1 hour'), tfloatinst(2, timestamptz '2000-01-01' + i * interval '1 hour' + interval '30 minutes')]) ORDER BY i)) AS temp FROM generate_series(1, 500) i) SELECT SUM(valueAtTimestamp(temp, timestamptz '2000-01-01' + j * interval '15 minutes')) FROM ss, generate_series(0, 2004) j;
+WITH ts AS (SELECT timestampset(array_agg(timestamptz '2000-01-01' + i * interval '1 minute' + (i % 2) * interval '40 seconds' ORDER BY i)) AS ts FROM generate_series(1, 1000) i) SELECT bool_and(ts @> t AND NOT ts @> t + interval '1 second') FROM ts, unnest(timestamps(ts)) t;
+
+SELECT valuesAtTimestamps(tfloat '[1@2000-01-01, 3@2000-01-03]', ARRAY[timestamptz '2000-01-02', '2000-01-04', '2000-01-01', '2000-01-03']);
+SELECT valuesAtTimestamps(tfloat '{[1@2000-01-01, 2@2000-01-02],[3@2000-01-04, 3@2000-01-05]}', ARRAY[timestamptz '2000-01-03', '2000-01-04 12:00']);
+SELECT valuesAtTimestamps(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', ARRAY[timestamptz '2000-01-01 12:00', '2000-01-02 12:00', '2000-01-03']);
+SELECT valuesAtTimestamps(ttext '{AAA@2000-01-01, BBB@2000-01-02}', ARRAY[timestamptz '2000-01-02', '2000-01-01']);
+WITH seq AS (SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(1, 1000) i), times AS (SELECT array_agg(timestamptz '2000-01-01' + j * interval '17 seconds' ORDER BY j % 3, j) AS arr FROM generate_series(0, 4000) j) SELECT bool_and(v IS NOT DISTINCT FROM valueAtTimestamp(temp, t)) FROM seq, times, unnest(arr, valuesAtTimestamps(temp, arr)) AS u(t, v);
+
 SELECT minusTimestamp(tbool 't@2000-01-01', timestamptz '2000-01-01');
 SELECT minusTimestamp(tbool '{t@2000-01-01}', timestamptz '2000-01-01');
 SELECT minusTimestamp(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', timestamptz '2000-01-01');
@@ -2006,6 +2051,10 @@ SELECT minusPeriod(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC
 
 SELECT minusPeriod(tfloat '[1@2000-01-01]', period '[2000-01-01, 2000-01-02]');
 
+SELECT atPeriod(tfloat '(1@2000-01-01, 2@2000-01-02, 1@2000-01-03)', period '(2000-01-01, 2000-01-03)');
+SELECT minusPeriod(tfloat '{1@2000-01-01, 2@2000-01-02}', period '[2000-01-03, 2000-01-04]');
+SELECT minusPeriod(tfloat '[1@2000-01-01, 2@2000-01-02]', period '[2000-01-03, 2000-01-04]');
+
 SELECT atPeriodSet(tbool 't@2000-01-01', periodset '{[2000-01-01,2000-01-02]}');
 SELECT atPeriodSet(tbool '{t@2000-01-01}', periodset '{[2000-01-01,2000-01-02]}');
 SELECT atPeriodSet(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', periodset '{[2000-01-01,2000-01-02]}');
@@ -2039,6 +2088,11 @@ SELECT atPeriodSet(tfloat '[1@2000-01-01,1@2000-01-02]', '{[2000-01-01,2000-01-0
 SELECT atPeriodSet(tfloat '{[1@2000-01-01, 1@2000-01-02]}', periodset '{[2000-01-03, 2000-01-04]}');
 SELECT atPeriodSet(tfloat '{[1@2000-01-02, 1@2000-01-03),[1@2000-01-04, 1@2000-01-05]}', periodset '{[2000-01-01, 2000-01-02),[2000-01-03, 2000-01-04)}');
 
+SELECT numInstants(atTimestampSet(temp, ts)) FROM (SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(1, 1000) i) t1, (SELECT timestampset(array_agg(timestamptz '2000-01-01' + i * interval '10 minutes' + interval '30 seconds' ORDER BY i)) AS ts FROM generate_series(0, 100) i) t2;
+SELECT maxValue(atTimestampSet(temp, ts)) FROM (SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(1, 1000) i) t1, (SELECT timestampset(array_agg(timestamptz '2000-01-01' + i * interval '10 minutes' + interval '30 seconds' ORDER BY i)) AS ts FROM generate_series(0, 100) i) t2;
+SELECT numSequences(atPeriodSet(temp, ps)) FROM (SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(1, 1000) i) t1, (SELECT periodset(array_agg(period(timestamptz '2000-01-01' + i * interval '10 minutes' + interval '15 seconds', timestamptz '2000-01-01' + i * interval '10 minutes' + interval '45 seconds') ORDER BY i)) AS ps FROM generate_series(0, 100) i) t2;
+SELECT maxValue(atPeriodSet(temp, ps)) FROM (SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) AS temp FROM generate_series(1, 1000) i) t1, (SELECT periodset(array_agg(period(timestamptz '2000-01-01' + i * interval '10 minutes' + interval '15 seconds', timestamptz '2000-01-01' + i * interval '10 minutes' + interval '45 seconds') ORDER BY i)) AS ps FROM generate_series(0, 100) i) t2;
+
 SELECT minusPeriodSet(tbool 't@2000-01-01', periodset '{[2000-01-01,2000-01-02]}');
 SELECT minusPeriodSet(tbool '{t@2000-01-01}', periodset '{[2000-01-01,2000-01-02]}');
 SELECT minusPeriodSet(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', periodset '{[2000-01-01,2000-01-02]}');
@@ -0,0 +1,15 @@
+SELECT tint_hash(tint '1@2000-01-01') = tint_hash(tint '{1@2000-01-01}');
+SELECT tint_hash(tint '1@2000-01-01') = tint_hash(tint '[1@2000-01-01]');
+SELECT tfloat_hash(tfloat '[1.5@2000-01-01, 2.5@2000-01-02]') = tfloat_hash(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02]}');
+SELECT tfloat_hash(tfloat '{1.5@2000-01-01, 2.5@2000-01-02}') = tfloat_hash(tfloat '{[1.5@2000-01-01], [2.5@2000-01-02]}');
+SELECT tfloat_hash(tfloat '0@2000-01-01') = tfloat_hash(tfloat '-0@2000-01-01');
+SELECT tbool_hash_extended(tbool 't@2000-01-01', 1) = tbool_hash_extended(tbool '{t@2000-01-01}', 1);
+SELECT tint_hash_extended(tint '1@2000-01-01', 1) = tint_hash_extended(tint '[1@2000-01-01]', 1);
+SELECT tint_hash_extended(tint '[1@2000-01-01, 2@2000-01-02]', 1) <> tint_hash_extended(tint '[1@2000-01-01, 2@2000-01-02]', 2);
+SELECT tfloat_hash_extended(tfloat '[1.5@2000-01-01, 2.5@2000-01-02]', 1) = tfloat_hash_extended(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02]}', 1);
+SELECT tfloat_hash_extended(tfloat '[1.5@2000-01-01, 2.5@2000-01-02]', 1) <> tfloat_hash_extended(tfloat '(1.5@2000-01-01, 2.5@2000-01-02]', 1);
+SELECT ttext_hash_extended(ttext 'AAA@2000-01-01', 1) = ttext_hash_extended(ttext '{AAA@2000-01-01}', 1);
+SELECT bool_and(tbool_hash_extended(temp, 1) = tbool_hash_extended(temp, 1)) FROM tbl_tbool;
+SELECT bool_and(tint_hash_extended(temp, 1) = tint_hash_extended(temp, 1)) FROM tbl_tint;
+SELECT bool_and(tfloat_hash_extended(temp, 1) = tfloat_hash_extended(temp, 1)) FROM tbl_tfloat;
+SELECT bool_and(ttext_hash_extended(temp, 1) = ttext_hash_extended(temp, 1)) FROM tbl_ttext;
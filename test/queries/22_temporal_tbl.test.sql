@@ -27,6 +27,49 @@ DROP TABLE tbl_tint_tmp;
 DROP TABLE tbl_tfloat_tmp;
 DROP TABLE tbl_ttext_tmp;
 
+SET mobilitydb.binary_format = compact;
+COPY tbl_tbool TO '/tmp/tbl_tbool_compact' (FORMAT BINARY);
+COPY tbl_tint TO '/tmp/tbl_tint_compact' (FORMAT BINARY);
+COPY tbl_tfloat TO '/tmp/tbl_tfloat_compact' (FORMAT BINARY);
+COPY tbl_ttext TO '/tmp/tbl_ttext_compact' (FORMAT BINARY);
+RESET mobilitydb.binary_format;
+
+DROP TABLE IF EXISTS tbl_tbool_tmp;
+DROP TABLE IF EXISTS tbl_tint_tmp;
+DROP TABLE IF EXISTS tbl_tfloat_tmp;
+DROP TABLE IF EXISTS tbl_ttext_tmp;
+
+CREATE TABLE tbl_tbool_tmp AS TABLE tbl_tbool WITH NO DATA;
+CREATE TABLE tbl_tint_tmp AS TABLE tbl_tint WITH NO DATA;
+CREATE TABLE tbl_tfloat_tmp AS TABLE tbl_tfloat WITH NO DATA;
+CREATE TABLE tbl_ttext_tmp AS TABLE tbl_ttext WITH NO DATA;
+
+COPY tbl_tbool_tmp FROM '/tmp/tbl_tbool_compact' (FORMAT BINARY);
+COPY tbl_tint_tmp FROM '/tmp/tbl_tint_compact' (FORMAT BINARY);
+COPY tbl_tfloat_tmp FROM '/tmp/tbl_tfloat_compact' (FORMAT BINARY);
+COPY tbl_ttext_tmp FROM '/tmp/tbl_ttext_compact' (FORMAT BINARY);
+
+SELECT COUNT(*) FROM tbl_tbool t1 FULL JOIN tbl_tbool_tmp t2 ON t1.k = t2.k WHERE t1.temp IS DISTINCT FROM t2.temp;
+SELECT COUNT(*) FROM tbl_tint t1 FULL JOIN tbl_tint_tmp t2 ON t1.k = t2.k WHERE t1.temp IS DISTINCT FROM t2.temp;
+SELECT COUNT(*) FROM tbl_tfloat t1 FULL JOIN tbl_tfloat_tmp t2 ON t1.k = t2.k WHERE t1.temp IS DISTINCT FROM t2.temp;
+SELECT COUNT(*) FROM tbl_ttext t1 FULL JOIN tbl_ttext_tmp t2 ON t1.k = t2.k WHERE t1.temp IS DISTINCT FROM t2.temp;
+
+DROP TABLE tbl_tbool_tmp;
+DROP TABLE tbl_tint_tmp;
+DROP TABLE tbl_tfloat_tmp;
+DROP TABLE tbl_ttext_tmp;
+
+DROP TABLE IF EXISTS tbl_tfloats_ext;
+CREATE TABLE tbl_tfloats_ext(k int, temp tfloat);
+ALTER TABLE tbl_tfloats_ext ALTER COLUMN temp SET STORAGE EXTERNAL;
+INSERT INTO tbl_tfloats_ext
+SELECT 1, tfloats(array_agg(tfloatseq(i::float, period(timestamptz '2000-01-01' + i * interval '1 hour',
+  timestamptz '2000-01-01' + i * interval '1 hour' + interval '30 minutes')) ORDER BY i))
+FROM generate_series(1, 1000) i;
+SELECT valueAtTimestamp(temp, timestamptz '2000-01-01' + interval '500 hours 10 minutes') = 500 FROM tbl_tfloats_ext;
+SELECT valueAtTimestamp(temp, timestamptz '2000-01-01' + interval '500 hours 40 minutes') IS NULL FROM tbl_tfloats_ext;
+DROP TABLE tbl_tfloats_ext;
+
 -------------------------------------------------------------------------------
 -- Transformation functions
 -------------------------------------------------------------------------------
@@ -146,6 +189,7 @@ SELECT MAX(memSize(temp)) FROM tbl_tbool;
 SELECT MAX(memSize(temp)) FROM tbl_tint;
 SELECT MAX(memSize(temp)) FROM tbl_tfloat;
 SELECT MAX(memSize(temp)) FROM tbl_ttext;
+SELECT (b).header + (b).bbox + (b).offsets + (b).blocks + (b).instants + (b).base_values + (b).trajectory = (b).size AND (b).stored_size = (SELECT sum(memSize(temp)) FROM tbl_tfloat) FROM (SELECT sum(memBreakdown(temp)) AS b FROM tbl_tfloat) t;
 
 /*
 SELECT period(temp) FROM tbl_tbool;
@@ -466,6 +510,9 @@ SELECT round(sum(integral(temp))::numeric, 6) FROM tbl_tfloat;
 SELECT round(sum(twAvg(temp))::numeric, 6) FROM tbl_tint;
 SELECT round(sum(twAvg(temp))::numeric, 6) FROM tbl_tfloat;
 
+SELECT count(*) FROM tbl_tint WHERE twAvg(temp * 2) <> twAvg(temp) * 2;
+SELECT count(*) FROM tbl_tfloat WHERE abs(twAvg(temp * 3.6) - twAvg(temp) * 3.6) > 1e-6;
+
 -------------------------------------------------------------------------------
 -- Comparison functions and B-tree indexing
 -------------------------------------------------------------------------------
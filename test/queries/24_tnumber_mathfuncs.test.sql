@@ -540,5 +540,15 @@ SELECT round(degrees(tfloat '{1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03}'),
 SELECT round(degrees(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]'), 1);
 SELECT round(degrees(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}'), 1);
 
+SELECT tbox(tfloat '{[1@2000-01-01, 3@2000-01-03],[2@2000-01-04, 5@2000-01-05]}' * -2);
+SELECT tbox(10 - tfloat '{1@2000-01-01, 3@2000-01-03, 2@2000-01-04}');
+SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) * -2 ?= -3002 FROM generate_series(1, 2000) i;
+SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) / 2 ?= 0.5 FROM generate_series(1, 2000) i;
+
+SELECT tint '[1@2000-01-01, 2@2000-01-02, 3@2000-01-04]' + tint '[1@2000-01-01, 1@2000-01-03)';
+SELECT numInstants(tfloatseq(array_agg(tfloatinst(i::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) + tfloatseq(array_agg(tfloatinst(i::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i))) FROM generate_series(1, 2000) i;
+SELECT maxValue(tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) + tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i))) FROM generate_series(1, 2000) i;
+SELECT tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) + tfloatseq(array_agg(tfloatinst(((i % 2) * i)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i)) ?= 3998 FROM generate_series(1, 2000) i;
+
 -------------------------------------------------------------------------------
 
@@ -17,6 +17,8 @@ SELECT tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}' & TRUE;
 SELECT tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]' & TRUE;
 SELECT tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}' & TRUE;
 
+SELECT tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03),[t@2000-01-03, t@2000-01-05]}' & FALSE;
+
 SELECT tbool 't@2000-01-01' & tbool 't@2000-01-01';
 SELECT tbool 't@2000-01-01' & tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}';
 SELECT tbool 't@2000-01-01' & tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]';
@@ -78,3 +80,7 @@ SELECT ~ tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@200
 
 -------------------------------------------------------------------------------
 
+SELECT tbool '[t@2000-01-01, f@2000-01-03, t@2000-01-05]' & tbool '[t@2000-01-02, t@2000-01-04, f@2000-01-06]';
+SELECT tbool '{[f@2000-01-01, f@2000-01-02], [t@2000-01-04, f@2000-01-05]}' | tbool '[f@2000-01-01, t@2000-01-03, f@2000-01-06]';
+
+-------------------------------------------------------------------------------
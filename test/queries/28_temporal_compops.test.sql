@@ -117,6 +117,9 @@ SELECT tfloat 'Interp=Stepwise;[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]'
 SELECT tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}' #= 2;
 SELECT tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}' #= 2;
 
+SELECT tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}' #>= 2.5;
+SELECT 2.5 #< tfloat '{1.5@2000-01-01, 2.5@2000-01-02, 3.5@2000-01-03}';
+
 SELECT tint '1@2000-01-01' #= tfloat '1.5@2000-01-01';
 SELECT tint '{1@2000-01-01, 2@2000-01-02, 1@2000-01-03}' #= tfloat '1.5@2000-01-01';
 SELECT tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]' #= tfloat '1.5@2000-01-01';
@@ -957,4 +960,13 @@ SELECT ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}' #>= ttext '{[AAA
 SELECT ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]' #>= ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}';
 SELECT ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}' #>= ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}';
 
+SELECT tfloat '{[1@2000-01-01, 3@2000-01-03, 1@2000-01-05], [2@2000-01-06, 2@2000-01-07]}' #< 2.0;
+SELECT 2.0 #<= tfloat '[2@2000-01-01, 4@2000-01-03, 0@2000-01-05)';
+
+SELECT atValue(tint '[1@2000-01-01, 3@2000-01-03, 1@2000-01-05]' #>= 2, true);
+SELECT tnumber_at_tgt(tfloat '[1@2000-01-01, 5@2000-01-05]', 2.0, true);
+SELECT tnumber_at_tgt(tfloat '[1@2000-01-01, 5@2000-01-05]', 2.0, false);
+SELECT tnumber_at_tlt(tint '{1@2000-01-01, 3@2000-01-03}', 0, true);
+SELECT tnumber_at_tlt(tint '{1@2000-01-01, 3@2000-01-03}', 0, false);
+
 -------------------------------------------------------------------------------
@@ -178,4 +178,7 @@ SELECT count(*) FROM tbl_ttext, tbl_text WHERE t #>= temp IS NOT NULL;
 SELECT count(*) FROM tbl_ttext, tbl_text WHERE temp #>= t IS NOT NULL;
 SELECT count(*) FROM tbl_ttext t1, tbl_ttext t2 WHERE t1.temp #>= t2.temp IS NOT NULL;
 
+SELECT count(*) FROM (SELECT temp, temp #> 50 AS c FROM tbl_tint OFFSET 0) t WHERE atValue(c, true) IS DISTINCT FROM tnumber_at_tgt(temp, 50, true);
+SELECT count(*) FROM (SELECT temp, temp #<= 50 AS c FROM tbl_tint OFFSET 0) t WHERE atValue(c, false) IS DISTINCT FROM tnumber_at_tle(temp, 50, false);
+
 -------------------------------------------------------------------------------
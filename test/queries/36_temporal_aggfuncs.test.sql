@@ -109,6 +109,8 @@ SELECT tor(temp) FROM (VALUES
 SELECT extent(temp) FROM (VALUES
 ('[1@2000-01-01, 2@2000-01-03, 1@2000-01-05, 2@2000-01-07]'::tint), 
 ('[3@2000-01-02, 4@2000-01-06]'::tint)) t(temp);
+SELECT k, extent(temp) OVER (ORDER BY k) FROM (VALUES
+(1, tint '[1@2000-01-01, 2@2000-01-03]'), (2, NULL), (3, tint '[3@2000-01-02, 4@2000-01-06]'), (4, tint '0@2000-01-04')) t(k, temp);
 
 SELECT tcount(temp) FROM (VALUES
 ('[1@2000-01-01, 2@2000-01-03, 1@2000-01-05, 2@2000-01-07]'::tint), 
@@ -182,6 +184,18 @@ SELECT round(tavg(temp), 6) FROM (VALUES
 ('[1@2000-01-01, 2@2000-01-03, 1@2000-01-05, 2@2000-01-07]'::tfloat), 
 ('[3@2000-01-02, 4@2000-01-06]'::tfloat)) t(temp);
 
+SELECT tsum(tintinst(i, timestamptz '2000-01-01' + (i % 3) * interval '1 day')) FROM generate_series(1, 9) i;
+SELECT tcount(tint '[1@2000-01-01, 1@2000-01-02]') FROM generate_series(1, 100);
+SELECT valueAtTimestamp(tmax(tintseq(i, period(timestamptz '2000-01-01' + i * interval '1 day', timestamptz '2000-01-03' + i * interval '1 day'))), timestamptz '2000-01-05 12:00') FROM generate_series(1, 100) i;
+SELECT valueAtTimestamp(tsum(tintseq(i, period(timestamptz '2000-01-01' + i * interval '1 day', timestamptz '2000-01-03' + i * interval '1 day'))), timestamptz '2000-01-05 12:00') FROM generate_series(1, 100) i;
+
+WITH t(i, temp) AS (SELECT i, tintseq(i % 3 + 1, period(timestamptz '2000-01-01' + i * interval '1 day', timestamptz '2000-01-04' + i * interval '1 day')) FROM generate_series(1, 20) i) SELECT COUNT(*) FROM (SELECT i, tcount(temp) OVER (ORDER BY i ROWS 2 PRECEDING) AS m FROM t) t1 WHERE m = (SELECT tcount(temp) FROM t t2 WHERE t2.i BETWEEN t1.i - 2 AND t1.i);
+WITH t(i, temp) AS (SELECT i, tintseq(i % 3 + 1, period(timestamptz '2000-01-01' + i * interval '1 day', timestamptz '2000-01-04' + i * interval '1 day')) FROM generate_series(1, 20) i) SELECT COUNT(*) FROM (SELECT i, tsum(temp) OVER (ORDER BY i ROWS 2 PRECEDING) AS m FROM t) t1 WHERE m = (SELECT tsum(temp) FROM t t2 WHERE t2.i BETWEEN t1.i - 2 AND t1.i);
+WITH t(i, temp) AS (SELECT i, tintseq(i % 3 + 1, period(timestamptz '2000-01-01' + i * interval '1 day', timestamptz '2000-01-04' + i * interval '1 day')) FROM generate_series(1, 20) i) SELECT COUNT(*) FROM (SELECT i, tavg(temp) OVER (ORDER BY i ROWS 2 PRECEDING) AS m FROM t) t1 WHERE m = (SELECT tavg(temp) FROM t t2 WHERE t2.i BETWEEN t1.i - 2 AND t1.i);
+WITH t(i, temp) AS (SELECT i, tintseq(i % 3 + 1, period(timestamptz '2000-01-01' + i * interval '1 day', timestamptz '2000-01-04' + i * interval '1 day')) FROM generate_series(1, 1000) i) SELECT COUNT(*) FROM (SELECT i, tcount(temp) OVER (ORDER BY i ROWS 2 PRECEDING) AS m FROM t) t1 WHERE m = (SELECT tcount(temp) FROM t t2 WHERE t2.i BETWEEN t1.i - 2 AND t1.i);
+WITH t(i, temp) AS (SELECT i, tintseq(i % 3 + 1, period(timestamptz '2000-01-01' + i * interval '1 day', timestamptz '2000-01-04' + i * interval '1 day')) FROM generate_series(1, 1000) i) SELECT COUNT(*) FROM (SELECT i, tavg(temp) OVER (ORDER BY i ROWS 2 PRECEDING) AS m FROM t) t1 WHERE m = (SELECT tavg(temp) FROM t t2 WHERE t2.i BETWEEN t1.i - 2 AND t1.i);
+WITH t(i, temp) AS (SELECT i, tintinst(i % 3 + 1, timestamptz '2000-01-01' + (i / 2) * interval '1 day') FROM generate_series(1, 1000) i) SELECT COUNT(*) FROM (SELECT i, tsum(temp) OVER (ORDER BY i ROWS 2 PRECEDING) AS m FROM t) t1 WHERE m = (SELECT tsum(temp) FROM t t2 WHERE t2.i BETWEEN t1.i - 2 AND t1.i);
+
 --------------------------------------------------
 
 /* Errors */
@@ -205,3 +219,82 @@ SELECT tsum(temp) FROM (VALUES
 ('{[3@2000-01-02, 4@2000-01-06]}'::tfloat)) t(temp);
 
 --------------------------------------------------
+
+SELECT appendInstant(temp) FROM (VALUES
+(tint '1@2000-01-01'), (tint '1@2000-01-02'), (tint '2@2000-01-03')) t(temp);
+SELECT appendInstant(temp) FROM (VALUES
+(tfloat '1@2000-01-01'), (tfloat '2@2000-01-02'), (tfloat '3@2000-01-03')) t(temp);
+SELECT appendInstant(temp) FROM (VALUES
+(tfloat '1@2000-01-01'), (tfloat '1@2000-01-01'), (NULL::tfloat), (tfloat '2@2000-01-02')) t(temp);
+SELECT appendInstant(temp) FROM (VALUES
+(NULL::ttext), (NULL::ttext)) t(temp);
+
+/* Errors */
+SELECT appendInstant(temp) FROM (VALUES
+(tfloat '[1@2000-01-01, 2@2000-01-02]')) t(temp);
+SELECT appendInstant(temp) FROM (VALUES
+(tfloat '2@2000-01-02'), (tfloat '1@2000-01-01')) t(temp);
+SELECT appendInstant(temp) FROM (VALUES
+(tfloat '1@2000-01-01'), (tfloat '2@2000-01-01')) t(temp);
+
+--------------------------------------------------
+
+SELECT tcount(temp, interval '1 day') FROM (VALUES
+(tint '[1@2000-01-01, 1@2000-01-03]'), (tint '[2@2000-01-02 12:00, 2@2000-01-04]'), (tint '5@2000-01-05')) t(temp);
+SELECT round(tavg(temp, interval '1 day'), 3) FROM (VALUES
+(tint '[1@2000-01-01, 1@2000-01-03]'), (tint '[2@2000-01-02 12:00, 2@2000-01-04]'), (tint '5@2000-01-05')) t(temp);
+SELECT tavg(temp, interval '12 hours') FROM (VALUES
+(tfloat '[0@2000-01-01, 4@2000-01-02]')) t(temp);
+SELECT tcount(temp, interval '1 hour', timestamptz '2000-01-01 00:30') FROM (VALUES
+(tint '[1@2000-01-01 00:00, 1@2000-01-01 01:30)')) t(temp);
+SELECT tcount(temp, interval '1 day') FROM (VALUES
+(ttext '{AAA@2000-01-01, BBB@2000-01-01 12:00, CCC@2000-01-02}'), (ttext 'AAA@2000-01-01 06:00'), (NULL::ttext)) t(temp);
+SELECT tcountApprox(id, temp, interval '1 day') FROM (VALUES
+(1, tint '[1@2000-01-01, 1@2000-01-03]'), (1, tint '[2@2000-01-02 12:00, 2@2000-01-04]'), (2, tint '5@2000-01-05')) t(id, temp);
+SELECT tcountApprox(id, temp, interval '1 hour', timestamptz '2000-01-01 00:30') FROM (VALUES
+(1, tint '[1@2000-01-01 00:00, 1@2000-01-01 01:30)'), (NULL, tint '1@2000-01-01'), (2, NULL::tint)) t(id, temp);
+SELECT tcountApprox(i % 10, ttext 'AAA@2000-01-01', interval '1 day') =
+  (SELECT tcountApprox(i, ttext 'AAA@2000-01-01', interval '1 day') FROM generate_series(0, 9) i)
+FROM generate_series(1, 1000) i;
+SELECT abs(maxValue(tcountApprox(i, tfloat '[1@2000-01-01, 2@2000-01-02)', interval '1 day')) - 10000) < 1000
+FROM generate_series(1, 10000) i;
+SELECT tunion(p) FROM (VALUES
+(period '[2000-01-01, 2000-01-03)'), (period '[2000-01-02, 2000-01-04]'), (period '(2000-01-04, 2000-01-05]'),
+(period '[2000-01-07, 2000-01-08)'), (NULL::period)) t(p);
+SELECT tunion(ps) FROM (VALUES
+(periodset '{[2000-01-01, 2000-01-02), [2000-01-03, 2000-01-04)}'), (periodset '{[2000-01-02, 2000-01-03)}')) t(ps);
+SELECT numPeriods(tunion(period(t, t + interval '30 minutes'))) FROM (
+SELECT timestamptz '2000-01-01' + i * interval '1 hour' FROM generate_series(1, 10000) i) s(t);
+SELECT tunion(period(t, t + interval '2 hours')) FROM (
+SELECT timestamptz '2000-01-01' + i * interval '1 hour' FROM generate_series(10000, 1, -1) i) s(t);
+SELECT tsample(tfloat '[1@2000-01-01, 5@2000-01-05]', interval '1 day');
+SELECT tsample(tint '{[1@2000-01-01 06:00, 3@2000-01-02 06:00, 3@2000-01-02 18:00), [5@2000-01-03, 5@2000-01-03 12:00]}', interval '12 hours', timestamptz '2000-01-01 03:00');
+SELECT tsample(tfloat '(1@2000-01-01, 3@2000-01-03)', interval '1 day');
+SELECT tsample(tfloat '[1@2000-01-01 01:00, 2@2000-01-01 02:00]', interval '1 day');
+SELECT tprecision(tfloat '[0@2000-01-01, 4@2000-01-02]', interval '12 hours');
+SELECT tprecision(tint '{[1@2000-01-01, 1@2000-01-02 12:00), [3@2000-01-02 12:00, 3@2000-01-03]}', interval '1 day');
+
+/* Errors */
+SELECT tcount(temp, interval '1 month') FROM (VALUES
+(tint '1@2000-01-01')) t(temp);
+SELECT tavg(temp, interval '0 minutes') FROM (VALUES
+(tint '1@2000-01-01')) t(temp);
+SELECT tsample(tfloat '1@2000-01-01', interval '1 month');
+SELECT tcountApprox(1, temp, interval '1 month') FROM (VALUES
+(tbool 't@2000-01-01')) t(temp);
+
+--------------------------------------------------
+
+SET work_mem = '64kB';
+SELECT numSequences(tcount(format('[1@%s, 1@%s]', t, t + interval '30 minutes')::tint)) FROM (
+SELECT timestamptz '2000-01-01' + i * interval '1 hour' FROM generate_series(1, 10000) i) s(t);
+SELECT maxValue(r), minValue(r), numSequences(r) FROM (
+SELECT tsum(format('[1@%s, 1@%s]', t, t + interval '3 hours')::tint) FROM (
+SELECT timestamptz '2000-01-01' + i * interval '1 hour' FROM generate_series(1, 10000) i) s(t)) u(r);
+RESET work_mem;
+SELECT count(*), sum(numSequences(r)) FROM (
+SELECT i % 1000, tcount(format('[1@%s, 1@%s]', t, t + interval '30 minutes')::tint) FROM (
+SELECT i, timestamptz '2000-01-01' + i * interval '1 hour' FROM generate_series(1, 10000) i) s(i, t)
+GROUP BY i % 1000) u(k, r);
+
+--------------------------------------------------
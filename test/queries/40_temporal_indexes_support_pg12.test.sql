@@ -0,0 +1,120 @@
+-------------------------------------------------------------------------------
+-- Planner support function of the intersection with a timestamp
+-------------------------------------------------------------------------------
+
+DROP TABLE IF EXISTS tbl_tbool_snapshot;
+DROP TABLE IF EXISTS tbl_tfloat_snapshot;
+CREATE TABLE tbl_tbool_snapshot AS
+SELECT k, tboolseq(k % 2 = 0, period(timestamptz '2000-01-01' + k * interval '1 hour',
+  timestamptz '2000-01-01' + (k + 2) * interval '1 hour')) AS temp
+FROM generate_series(1, 1000) k;
+CREATE TABLE tbl_tfloat_snapshot AS
+SELECT k, tfloatseq(k::float, period(timestamptz '2000-01-01' + k * interval '1 hour',
+  timestamptz '2000-01-01' + (k + 2) * interval '1 hour')) AS temp
+FROM generate_series(1, 1000) k;
+CREATE INDEX tbl_tbool_snapshot_gist_idx ON tbl_tbool_snapshot USING GIST(temp);
+CREATE INDEX tbl_tfloat_snapshot_gist_idx ON tbl_tfloat_snapshot USING GIST(temp);
+ANALYZE tbl_tbool_snapshot;
+ANALYZE tbl_tfloat_snapshot;
+
+SET enable_seqscan = off;
+
+SELECT k, valueAtTimestamp(temp, timestamptz '2000-01-11 00:30') FROM tbl_tbool_snapshot
+  WHERE intersectsTimestamp(temp, timestamptz '2000-01-11 00:30') ORDER BY k;
+SELECT count(*), sum(valueAtTimestamp(temp, timestamptz '2000-01-11 00:30')) FROM tbl_tfloat_snapshot
+  WHERE intersectsTimestamp(temp, timestamptz '2000-01-11 00:30');
+SELECT count(*) FROM tbl_tfloat_snapshot
+  WHERE intersectsTimestamp(temp, timestamptz '2000-01-01 00:30');
+
+RESET enable_seqscan;
+DROP TABLE tbl_tbool_snapshot;
+DROP TABLE tbl_tfloat_snapshot;
+
+-------------------------------------------------------------------------------
+-- Planner support function of the overlaps of the bounding boxes
+-------------------------------------------------------------------------------
+
+/* Returns the number of relations scanned by the plan of the query */
+CREATE FUNCTION plan_relations(query text)
+RETURNS bigint AS $$
+DECLARE
+  plan jsonb;
+  result bigint;
+BEGIN
+  EXECUTE 'EXPLAIN (FORMAT JSON) ' || query INTO plan;
+  WITH RECURSIVE nodes(node) AS (
+    SELECT plan->0->'Plan'
+    UNION ALL
+    SELECT jsonb_array_elements(node->'Plans')
+    FROM nodes
+    WHERE node ? 'Plans' )
+  SELECT count(*) INTO result
+  FROM nodes
+  WHERE node ? 'Relation Name';
+  RETURN result;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TABLE IF EXISTS tbl_tfloat_part;
+CREATE TABLE tbl_tfloat_part(k int, temp tfloat)
+  PARTITION BY RANGE (startTimestamp(temp));
+CREATE TABLE tbl_tfloat_part_1 PARTITION OF tbl_tfloat_part
+  FOR VALUES FROM ('2000-01-01') TO ('2000-01-02');
+CREATE TABLE tbl_tfloat_part_2 PARTITION OF tbl_tfloat_part
+  FOR VALUES FROM ('2000-01-02') TO ('2000-01-03');
+CREATE TABLE tbl_tfloat_part_3 PARTITION OF tbl_tfloat_part
+  FOR VALUES FROM ('2000-01-03') TO ('2000-01-04');
+INSERT INTO tbl_tfloat_part
+SELECT k, tfloatseq(k::float, period(timestamptz '2000-01-01' + k * interval '1 hour',
+  timestamptz '2000-01-01' + (k + 2) * interval '1 hour'))
+FROM generate_series(0, 71) k;
+
+SELECT count(*) FROM tbl_tfloat_part
+  WHERE temp && period '[2000-01-01 10:00, 2000-01-01 12:00]';
+SELECT plan_relations('SELECT count(*) FROM tbl_tfloat_part
+  WHERE temp && period ''[2000-01-01 10:00, 2000-01-01 12:00]''');
+SELECT count(*) FROM tbl_tfloat_part
+  WHERE period '[2000-01-02 10:00, 2000-01-02 12:00]' && temp;
+SELECT plan_relations('SELECT count(*) FROM tbl_tfloat_part
+  WHERE period ''[2000-01-02 10:00, 2000-01-02 12:00]'' && temp');
+SELECT count(*) FROM tbl_tfloat_part WHERE temp && tbox(10.0, 20.0);
+SELECT plan_relations('SELECT count(*) FROM tbl_tfloat_part WHERE temp && tbox(10.0, 20.0)');
+
+SET plan_cache_mode = force_generic_plan;
+PREPARE tbl_tfloat_part_query(period) AS
+  SELECT count(*) FROM tbl_tfloat_part WHERE temp && $1;
+EXECUTE tbl_tfloat_part_query('[2000-01-01 10:00, 2000-01-01 12:00]');
+SELECT plan_relations('EXECUTE tbl_tfloat_part_query(''[2000-01-01 10:00, 2000-01-01 12:00]'')');
+DEALLOCATE tbl_tfloat_part_query;
+RESET plan_cache_mode;
+
+DROP TABLE IF EXISTS tbl_tint_inherit_1;
+DROP TABLE IF EXISTS tbl_tint_inherit_2;
+DROP TABLE IF EXISTS tbl_tint_inherit;
+CREATE TABLE tbl_tint_inherit(k int, temp tint,
+  endt timestamptz GENERATED ALWAYS AS (endTimestamp(temp)) STORED);
+CREATE TABLE tbl_tint_inherit_1 (CHECK (endt < '2000-01-02'))
+  INHERITS (tbl_tint_inherit);
+CREATE TABLE tbl_tint_inherit_2 (CHECK (endt >= '2000-01-02'))
+  INHERITS (tbl_tint_inherit);
+INSERT INTO tbl_tint_inherit_1(k, temp)
+SELECT k, tintseq(k, period(timestamptz '2000-01-01' + k * interval '1 hour',
+  timestamptz '2000-01-01' + (k + 2) * interval '1 hour'))
+FROM generate_series(0, 21) k;
+INSERT INTO tbl_tint_inherit_2(k, temp)
+SELECT k, tintseq(k, period(timestamptz '2000-01-01' + k * interval '1 hour',
+  timestamptz '2000-01-01' + (k + 2) * interval '1 hour'))
+FROM generate_series(22, 47) k;
+
+SELECT count(*) FROM tbl_tint_inherit
+  WHERE temp && period '[2000-01-02 10:00, 2000-01-02 12:00]';
+SELECT plan_relations('SELECT count(*) FROM tbl_tint_inherit
+  WHERE temp && period ''[2000-01-02 10:00, 2000-01-02 12:00]''');
+
+DROP TABLE tbl_tfloat_part;
+DROP TABLE tbl_tint_inherit_1;
+DROP TABLE tbl_tint_inherit_2;
+DROP TABLE tbl_tint_inherit;
+DROP FUNCTION plan_relations;
+
+-------------------------------------------------------------------------------
@@ -215,5 +215,26 @@ DROP INDEX IF EXISTS tbl_tint_big_gist_idx;
 DROP INDEX IF EXISTS tbl_tfloat_big_gist_idx;
 DROP INDEX IF EXISTS tbl_ttext_big_gist_idx;
 
+CREATE INDEX tbl_tfloat_big_brin_idx ON tbl_tfloat_big USING BRIN(temp);
+
+SELECT count(*) FROM tbl_tfloat_big WHERE temp && floatrange '[1,3]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp && tbox 'TBOX((1,2001-01-01),(50,2001-02-01))';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp @> tbox 'TBOX((1,2001-01-01),(50,2001-02-01))';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp <<# tbox 'TBOX((1,2001-01-01),(50,2001-02-01))';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp #>> tbox 'TBOX((1,2001-01-01),(50,2001-02-01))';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp && tfloat '[1@2001-01-01, 10@2001-02-01]';
+
+DROP INDEX IF EXISTS tbl_tfloat_big_brin_idx;
+
+VACUUM ANALYZE tbl_tbox;
+SET enable_seqscan = off;
+CREATE INDEX tbl_tbox_gist_idx ON tbl_tbox USING GIST(b);
+
+SELECT count(*) FROM tbl_tbox t1, tbl_tbox t2 WHERE t1.b && t2.b;
+SELECT count(*) FROM tbl_tbox t1, tbl_tbox t2 WHERE t1.b @> t2.b;
+
+DROP INDEX IF EXISTS tbl_tbox_gist_idx;
+RESET enable_seqscan;
+
 -------------------------------------------------------------------------------
 
@@ -501,3 +501,16 @@ SELECT count(*) FROM tbl_tbool WHERE period '[2001-01-01, 2001-06-01]' <<# temp;
 SELECT count(*) FROM tbl_ttext WHERE period '[2001-01-01, 2001-06-01]' <<# temp;
 
 -------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Test the join selectivity
+-------------------------------------------------------------------------------
+
+SELECT (SELECT count(*) FROM tbl_tbool t1, tbl_tbool t2 WHERE t1.temp && t2.temp) = (SELECT count(*) FROM tbl_tbool t1, tbl_tbool t2 WHERE t2.temp && t1.temp);
+SELECT (SELECT count(*) FROM tbl_tbool t1, tbl_tbool t2 WHERE t1.temp @> t2.temp) = (SELECT count(*) FROM tbl_tbool t1, tbl_tbool t2 WHERE t2.temp <@ t1.temp);
+SELECT (SELECT count(*) FROM tbl_tbool t1, tbl_tbool t2 WHERE t1.temp <<# t2.temp) = (SELECT count(*) FROM tbl_tbool t1, tbl_tbool t2 WHERE t2.temp #>> t1.temp);
+SELECT (SELECT count(*) FROM tbl_ttext t1, tbl_ttext t2 WHERE t1.temp && t2.temp) = (SELECT count(*) FROM tbl_ttext t1, tbl_ttext t2 WHERE t2.temp && t1.temp);
+SELECT (SELECT count(*) FROM tbl_ttext t1, tbl_ttext t2 WHERE t1.temp @> t2.temp) = (SELECT count(*) FROM tbl_ttext t1, tbl_ttext t2 WHERE t2.temp <@ t1.temp);
+SELECT (SELECT count(*) FROM tbl_ttext t1, tbl_ttext t2 WHERE t1.temp <<# t2.temp) = (SELECT count(*) FROM tbl_ttext t1, tbl_ttext t2 WHERE t2.temp #>> t1.temp);
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,27 @@
+-------------------------------------------------------------------------------
+-- GiST statistics
+-------------------------------------------------------------------------------
+
+DROP INDEX IF EXISTS tbl_tfloat_giststat_idx;
+CREATE INDEX tbl_tfloat_giststat_idx ON tbl_tfloat USING GIST(temp);
+
+SELECT giststat('tbl_tfloat_giststat_idx') LIKE 'totalPages:%depth:%level 0:%';
+SELECT giststat('tbl_tfloat');
+
+-------------------------------------------------------------------------------
+-- Counters of the GiST consistent methods
+-------------------------------------------------------------------------------
+
+SET enable_seqscan = off;
+
+SELECT gist_consistent_reset();
+SELECT leaf_calls FROM gist_consistent_stats WHERE keytype = 'tbox';
+SELECT count(*) > 0 FROM tbl_tfloat WHERE temp && tbox 'TBOX((-1000,1900-01-01),(1000,2100-01-01))';
+SELECT leaf_calls > 0 AND leaf_true > 0 AND leaf_true <= leaf_calls AND leaf_recheck <= leaf_true FROM gist_consistent_stats WHERE keytype = 'tbox';
+SELECT leaf_true_ratio BETWEEN 0 AND 1 FROM gist_consistent_stats WHERE keytype = 'tbox';
+SELECT keytype FROM gist_consistent_stats ORDER BY keytype;
+
+RESET enable_seqscan;
+DROP INDEX tbl_tfloat_giststat_idx;
+
+-------------------------------------------------------------------------------
@@ -953,3 +953,33 @@ SELECT count(*) FROM tbl_tfloat WHERE temp #&> period '[2001-06-01, 2001-07-01]'
 SELECT count(*) FROM tbl_tfloat WHERE temp #&> periodset '{[2001-06-01, 2001-07-01]}';
 
 -------------------------------------------------------------------------------
+-- Ever/always comparison operators
+-------------------------------------------------------------------------------
+
+SELECT (SELECT count(*) FROM tbl_tint WHERE temp ?> 50) = (SELECT count(*) FROM tbl_tint WHERE NOT temp %<= 50);
+SELECT (SELECT count(*) FROM tbl_tint WHERE temp %< 50) = (SELECT count(*) FROM tbl_tint WHERE NOT temp ?>= 50);
+SELECT (SELECT count(*) FROM tbl_tint WHERE temp ?= 50) = (SELECT count(*) FROM tbl_tint WHERE NOT temp %<> 50);
+SELECT (SELECT count(*) FROM tbl_tfloat WHERE temp ?> 50) = (SELECT count(*) FROM tbl_tfloat WHERE NOT temp %<= 50);
+SELECT (SELECT count(*) FROM tbl_tfloat WHERE temp %< 50) = (SELECT count(*) FROM tbl_tfloat WHERE NOT temp ?>= 50);
+SELECT (SELECT count(*) FROM tbl_tfloat WHERE temp %= 50) = (SELECT count(*) FROM tbl_tfloat WHERE NOT temp ?<> 50);
+
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Test the join selectivity
+-------------------------------------------------------------------------------
+
+SELECT (SELECT count(*) FROM tbl_tint t1, tbl_tint t2 WHERE t1.temp && t2.temp) = (SELECT count(*) FROM tbl_tint t1, tbl_tint t2 WHERE t2.temp && t1.temp);
+SELECT (SELECT count(*) FROM tbl_tint t1, tbl_tint t2 WHERE t1.temp @> t2.temp) = (SELECT count(*) FROM tbl_tint t1, tbl_tint t2 WHERE t2.temp <@ t1.temp);
+SELECT (SELECT count(*) FROM tbl_tint t1, tbl_tint t2 WHERE t1.temp <<# t2.temp) = (SELECT count(*) FROM tbl_tint t1, tbl_tint t2 WHERE t2.temp #>> t1.temp);
+SELECT (SELECT count(*) FROM tbl_tint t1, tbl_tint t2 WHERE t1.temp << t2.temp) = (SELECT count(*) FROM tbl_tint t1, tbl_tint t2 WHERE t2.temp >> t1.temp);
+SELECT (SELECT count(*) FROM tbl_tint t1, tbl_tfloat t2 WHERE t1.temp && t2.temp) = (SELECT count(*) FROM tbl_tint t1, tbl_tfloat t2 WHERE t2.temp && t1.temp);
+SELECT (SELECT count(*) FROM tbl_tint t1, tbl_tfloat t2 WHERE t1.temp @> t2.temp) = (SELECT count(*) FROM tbl_tint t1, tbl_tfloat t2 WHERE t2.temp <@ t1.temp);
+SELECT (SELECT count(*) FROM tbl_tint t1, tbl_tfloat t2 WHERE t1.temp <<# t2.temp) = (SELECT count(*) FROM tbl_tint t1, tbl_tfloat t2 WHERE t2.temp #>> t1.temp);
+SELECT (SELECT count(*) FROM tbl_tint t1, tbl_tfloat t2 WHERE t1.temp << t2.temp) = (SELECT count(*) FROM tbl_tint t1, tbl_tfloat t2 WHERE t2.temp >> t1.temp);
+SELECT (SELECT count(*) FROM tbl_tfloat t1, tbl_tfloat t2 WHERE t1.temp && t2.temp) = (SELECT count(*) FROM tbl_tfloat t1, tbl_tfloat t2 WHERE t2.temp && t1.temp);
+SELECT (SELECT count(*) FROM tbl_tfloat t1, tbl_tfloat t2 WHERE t1.temp @> t2.temp) = (SELECT count(*) FROM tbl_tfloat t1, tbl_tfloat t2 WHERE t2.temp <@ t1.temp);
+SELECT (SELECT count(*) FROM tbl_tfloat t1, tbl_tfloat t2 WHERE t1.temp <<# t2.temp) = (SELECT count(*) FROM tbl_tfloat t1, tbl_tfloat t2 WHERE t2.temp #>> t1.temp);
+SELECT (SELECT count(*) FROM tbl_tfloat t1, tbl_tfloat t2 WHERE t1.temp << t2.temp) = (SELECT count(*) FROM tbl_tfloat t1, tbl_tfloat t2 WHERE t2.temp >> t1.temp);
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+-------------------------------------------------------------------------------
+-- Counters of the work done by the functions
+-------------------------------------------------------------------------------
+
+SET mobilitydb.function_stats = on;
+
+SELECT mobilitydb_stat_reset();
+SELECT count(*) FROM mobilitydb_stat_functions WHERE value <> 0;
+SELECT numInstants(tfloatseq(ARRAY[
+tfloatinst(1, '2012-01-01 08:00:00'),
+tfloatinst(3, '2012-01-01 08:10:00'),
+tfloatinst(2, '2012-01-01 08:20:00')
+]));
+SELECT counter, value FROM mobilitydb_stat_functions
+WHERE counter IN ('sequences', 'instants') ORDER BY counter;
+SELECT value > 0 FROM mobilitydb_stat_functions WHERE counter = 'sequence_bytes';
+
+/* The counters are not updated when the parameter is off */
+SET mobilitydb.function_stats = off;
+SELECT mobilitydb_stat_reset();
+SELECT numInstants(tfloatseq(ARRAY[
+tfloatinst(1, '2012-01-01 08:00:00'),
+tfloatinst(3, '2012-01-01 08:10:00')
+]));
+SELECT count(*) FROM mobilitydb_stat_functions WHERE value <> 0;
+SELECT counter FROM mobilitydb_stat_functions ORDER BY counter;
+
+RESET mobilitydb.function_stats;
+
+/* The shared cache is created when the library is preloaded */
+SHOW mobilitydb.shared_cache_size;
+SET mobilitydb.function_stats = on;
+CREATE TABLE tbl_shared_cache(k int, temp tfloat);
+ALTER TABLE tbl_shared_cache ALTER COLUMN temp SET STORAGE EXTERNAL;
+INSERT INTO tbl_shared_cache
+SELECT 1, tfloats(array_agg(tfloatseq(i::float, period(timestamptz '2000-01-01' + i * interval '1 hour',
+  timestamptz '2000-01-01' + i * interval '1 hour' + interval '30 minutes')) ORDER BY i))
+FROM generate_series(1, 100) i;
+SELECT mobilitydb_shared_cache_reset();
+SELECT mobilitydb_stat_reset();
+/* A value is only kept in the cache when it is missed for the second time */
+SELECT numSequences(temp) FROM tbl_shared_cache;
+SELECT value FROM mobilitydb_stat_functions WHERE counter = 'shared_cache_hits';
+SELECT numSequences(temp) FROM tbl_shared_cache;
+SELECT value FROM mobilitydb_stat_functions WHERE counter = 'shared_cache_hits';
+SELECT numSequences(temp) FROM tbl_shared_cache;
+SELECT value FROM mobilitydb_stat_functions WHERE counter = 'shared_cache_hits';
+/* The values of a table are invalidated when it is rewritten */
+VACUUM FULL tbl_shared_cache;
+SELECT mobilitydb_stat_reset();
+SELECT numSequences(temp) FROM tbl_shared_cache;
+SELECT numSequences(temp) FROM tbl_shared_cache;
+SELECT value FROM mobilitydb_stat_functions WHERE counter = 'shared_cache_hits';
+TRUNCATE tbl_shared_cache;
+INSERT INTO tbl_shared_cache
+SELECT 1, tfloats(array_agg(tfloatseq(2 * i::float, period(timestamptz '2000-01-01' + i * interval '1 hour',
+  timestamptz '2000-01-01' + i * interval '1 hour' + interval '30 minutes')) ORDER BY i))
+FROM generate_series(1, 100) i;
+SELECT startValue(temp) FROM tbl_shared_cache;
+/* The cache is not used when the parameter is off */
+SET mobilitydb.enable_shared_cache = off;
+SELECT mobilitydb_stat_reset();
+SELECT numSequences(temp) FROM tbl_shared_cache;
+SELECT numSequences(temp) FROM tbl_shared_cache;
+SELECT value FROM mobilitydb_stat_functions WHERE counter = 'shared_cache_hits';
+RESET mobilitydb.enable_shared_cache;
+RESET mobilitydb.function_stats;
+DROP TABLE tbl_shared_cache;
+
+-------------------------------------------------------------------------------
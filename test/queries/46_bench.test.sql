@@ -0,0 +1,18 @@
+-------------------------------------------------------------------------------
+
+SELECT kernel, instants, iterations, ns_per_instant >= 0, bytes_per_call > 0
+FROM mobdb_bench('tsequence_make', 10, 2);
+SELECT kernel, instants, iterations, ns_per_instant >= 0, bytes_per_call > 0
+FROM mobdb_bench('tpointseq_at_geometry', 100);
+SELECT count(*) FROM (VALUES ('tsequence_make'), ('tsequence_at_period'),
+    ('sync_tfunc'), ('distance_tpoint_geo'), ('tpointseq_at_geometry'),
+    ('tsequence_tagg'), ('temporal_out'), ('temporal_in')) k(name),
+  LATERAL mobdb_bench(k.name, 50, 1) b
+WHERE b.bytes_per_call > 0;
+
+/* Errors */
+SELECT * FROM mobdb_bench('tsequence_unknown', 10, 1);
+SELECT * FROM mobdb_bench('tsequence_make', 1, 1);
+SELECT * FROM mobdb_bench('tsequence_make', 10, 0);
+
+-------------------------------------------------------------------------------
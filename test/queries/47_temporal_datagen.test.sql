@@ -0,0 +1,67 @@
+-------------------------------------------------------------------------------
+
+SELECT count(*), min(numInstants(temp)), max(numInstants(temp))
+FROM generate_tints(100, 10, 1, 5, period '[2000-01-01, 2000-01-02]') temp;
+SELECT bool_and(minValue(temp) >= 1 AND maxValue(temp) <= 5 AND
+  period '[2000-01-01, 2000-01-02]' @> temp)
+FROM generate_tints(100, 10, 1, 5, period '[2000-01-01, 2000-01-02]') temp;
+SELECT bool_and(minValue(temp) >= 0.5 AND maxValue(temp) <= 1.5 AND
+  interpolation(temp) = 'Linear')
+FROM generate_tfloats(100, 10, 0.5, 1.5, period '[2000-01-01, 2000-01-02]') temp;
+SELECT DISTINCT interpolation(temp)
+FROM generate_tfloats(10, 5, 0, 1, period '[2000-01-01, 2000-01-02]', '1 hour', false) temp;
+SELECT DISTINCT duration(temp)
+FROM generate_tfloats(10, 1, 0, 1, period '[2000-01-01, 2000-01-02]') temp;
+SELECT bool_and(length(startValue(temp)) BETWEEN 1 AND 4)
+FROM generate_ttexts(100, 10, 4, period '[2000-01-01, 2000-01-02]') temp;
+SELECT (SELECT string_agg(temp::text, ',') FROM
+  generate_tfloats(5, 3, 0, 1, period '[2000-01-01, 2000-01-02]', '1 minute', true, 7) temp) =
+  (SELECT string_agg(temp::text, ',') FROM
+  generate_tfloats(5, 3, 0, 1, period '[2000-01-01, 2000-01-02]', '1 minute', true, 7) temp);
+SELECT (SELECT string_agg(temp::text, ',') FROM
+  generate_tints(5, 3, 0, 9, period '[2000-01-01, 2000-01-02]', '1 minute', 1) temp) =
+  (SELECT string_agg(temp::text, ',') FROM
+  generate_tints(5, 3, 0, 9, period '[2000-01-01, 2000-01-02]', '1 minute', 2) temp);
+
+/* Values in the storage format of previous versions */
+SELECT from_storage('\x02000000140000001700000002000000000000000000000000000000200000000000000040000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000', NULL::tint);
+SELECT from_storage('\x02000000140000001700000002000000000000000000000000000000200000000000000040000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000', NULL::tint) = tint '{1@2000-01-01, 2@2000-01-02}';
+SELECT tbox(from_storage('\x02000000140000001700000002000000000000000000000000000000200000000000000040000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000', NULL::tint));
+SELECT valueAtTimestamp(from_storage('\x02000000140000001700000002000000000000000000000000000000200000000000000040000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000', NULL::tint), timestamptz '2000-01-02');
+SELECT shift(from_storage('\x02000000140000001700000002000000000000000000000000000000200000000000000040000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000', NULL::tint), '1 day');
+SELECT from_storage('\x0300000014000000170000000300000000000000000000000000000000c0ae3b280000000101000000000000000000000000000020000000000000004000000000000000600000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d1400000002000000000000008000000001000000160000001700000000c0ae3b280000000100000000000000000000000000f03f0000000000000040000000000000000000c0ae3b280000001400000000000000', NULL::tint);
+SELECT from_storage('\x0300000014000000170000000300000000000000000000000000000000c0ae3b280000000101000000000000000000000000000020000000000000004000000000000000600000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d1400000002000000000000008000000001000000160000001700000000c0ae3b280000000100000000000000000000000000f03f0000000000000040000000000000000000c0ae3b280000001400000000000000', NULL::tint) = tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]';
+SELECT tbox(from_storage('\x0300000014000000170000000300000000000000000000000000000000c0ae3b280000000101000000000000000000000000000020000000000000004000000000000000600000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d1400000002000000000000008000000001000000160000001700000000c0ae3b280000000100000000000000000000000000f03f0000000000000040000000000000000000c0ae3b280000001400000000000000', NULL::tint));
+SELECT getValues(from_storage('\x0300000014000000170000000300000000000000000000000000000000c0ae3b280000000101000000000000000000000000000020000000000000004000000000000000600000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d1400000002000000000000008000000001000000160000001700000000c0ae3b280000000100000000000000000000000000f03f0000000000000040000000000000000000c0ae3b280000001400000000000000', NULL::tint));
+SELECT shift(from_storage('\x0300000014000000170000000300000000000000000000000000000000c0ae3b280000000101000000000000000000000000000020000000000000004000000000000000600000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d1400000002000000000000008000000001000000160000001700000000c0ae3b280000000100000000000000000000000000f03f0000000000000040000000000000000000c0ae3b280000001400000000000000', NULL::tint), '1 day');
+SELECT from_storage('\x04000000140000001700000002000000040000000000000000000000b8000000000000007001000000000000e0020000030000001400000017000000020000000000000000000000000000000060d71d14000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000e00200000300000014000000170000000200000000000000002086593c00000000805d77500000000101000000000000000000000000000020000000000000004000000000000000000000000000000080000000010000001600000017000000002086593c00000003000000000000008000000001000000160000001700000000805d7750000000030000000000000000000000000008400000000000000840002086593c00000000805d77500000001400000000000000000000000000f03f0000000000000840000000000000000000805d77500000001400000000000000', NULL::tint);
+SELECT from_storage('\x04000000140000001700000002000000040000000000000000000000b8000000000000007001000000000000e0020000030000001400000017000000020000000000000000000000000000000060d71d14000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000e00200000300000014000000170000000200000000000000002086593c00000000805d77500000000101000000000000000000000000000020000000000000004000000000000000000000000000000080000000010000001600000017000000002086593c00000003000000000000008000000001000000160000001700000000805d7750000000030000000000000000000000000008400000000000000840002086593c00000000805d77500000001400000000000000000000000000f03f0000000000000840000000000000000000805d77500000001400000000000000', NULL::tint) = tint '{[1@2000-01-01, 2@2000-01-02], [3@2000-01-04, 3@2000-01-05]}';
+SELECT tbox(from_storage('\x04000000140000001700000002000000040000000000000000000000b8000000000000007001000000000000e0020000030000001400000017000000020000000000000000000000000000000060d71d14000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000e00200000300000014000000170000000200000000000000002086593c00000000805d77500000000101000000000000000000000000000020000000000000004000000000000000000000000000000080000000010000001600000017000000002086593c00000003000000000000008000000001000000160000001700000000805d7750000000030000000000000000000000000008400000000000000840002086593c00000000805d77500000001400000000000000000000000000f03f0000000000000840000000000000000000805d77500000001400000000000000', NULL::tint));
+SELECT valueAtTimestamp(from_storage('\x04000000140000001700000002000000040000000000000000000000b8000000000000007001000000000000e0020000030000001400000017000000020000000000000000000000000000000060d71d14000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000e00200000300000014000000170000000200000000000000002086593c00000000805d77500000000101000000000000000000000000000020000000000000004000000000000000000000000000000080000000010000001600000017000000002086593c00000003000000000000008000000001000000160000001700000000805d7750000000030000000000000000000000000008400000000000000840002086593c00000000805d77500000001400000000000000000000000000f03f0000000000000840000000000000000000805d77500000001400000000000000', NULL::tint), timestamptz '2000-01-04');
+SELECT sequenceN(from_storage('\x04000000140000001700000002000000040000000000000000000000b8000000000000007001000000000000e0020000030000001400000017000000020000000000000000000000000000000060d71d14000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000e00200000300000014000000170000000200000000000000002086593c00000000805d77500000000101000000000000000000000000000020000000000000004000000000000000000000000000000080000000010000001600000017000000002086593c00000003000000000000008000000001000000160000001700000000805d7750000000030000000000000000000000000008400000000000000840002086593c00000000805d77500000001400000000000000000000000000f03f0000000000000840000000000000000000805d77500000001400000000000000', NULL::tint), 2);
+SELECT shift(from_storage('\x04000000140000001700000002000000040000000000000000000000b8000000000000007001000000000000e0020000030000001400000017000000020000000000000000000000000000000060d71d14000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000e00200000300000014000000170000000200000000000000002086593c00000000805d77500000000101000000000000000000000000000020000000000000004000000000000000000000000000000080000000010000001600000017000000002086593c00000003000000000000008000000001000000160000001700000000805d7750000000030000000000000000000000000008400000000000000840002086593c00000000805d77500000001400000000000000000000000000f03f0000000000000840000000000000000000805d77500000001400000000000000', NULL::tint), '1 day');
+SELECT (m).header, (m).bbox, (m).offsets, (m).trajectory
+FROM (SELECT memBreakdown(from_storage('\x04000000140000001700000002000000040000000000000000000000b8000000000000007001000000000000e0020000030000001400000017000000020000000000000000000000000000000060d71d14000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000200000000000000000000000000f03f000000000000004000000000000000000060d71d140000001400000000000000e00200000300000014000000170000000200000000000000002086593c00000000805d77500000000101000000000000000000000000000020000000000000004000000000000000000000000000000080000000010000001600000017000000002086593c00000003000000000000008000000001000000160000001700000000805d7750000000030000000000000000000000000008400000000000000840002086593c00000000805d77500000001400000000000000000000000000f03f0000000000000840000000000000000000805d77500000001400000000000000', NULL::tint)) AS m) t;
+CREATE TABLE tbl_tint_storage(temp tint);
+ALTER TABLE tbl_tint_storage ALTER COLUMN temp SET STORAGE EXTERNAL;
+INSERT INTO tbl_tint_storage SELECT from_storage('\x0400000014000000170000000c000000180000000000000000000000b80000000000000070010000000000002802000000000000e002000000000000980300000000000050040000000000000805000000000000c00500000000000078060000000000003007000000000000e807000000000000a008000000000000e0020000030000001400000017000000020000000000000000000000000000000060d71d14000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000000000000000000100000000000000800000000100000016000000170000000060d71d140000000100000000000000000000000000f03f000000000000f03f00000000000000000060d71d140000001400000000000000e0020000030000001400000017000000020000000000000000c0ae3b28000000002086593c000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000c0ae3b28000000020000000000000080000000010000001600000017000000002086593c00000002000000000000000000000000000040000000000000004000c0ae3b28000000002086593c0000001400000000000000e0020000030000001400000017000000020000000000000000805d775000000000e0349564000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000805d775000000003000000000000008000000001000000160000001700000000e034956400000003000000000000000000000000000840000000000000084000805d775000000000e03495640000001400000000000000e0020000030000001400000017000000020000000000000000400cb37800000000a0e3d08c000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000400cb37800000004000000000000008000000001000000160000001700000000a0e3d08c00000004000000000000000000000000001040000000000000104000400cb37800000000a0e3d08c0000001400000000000000e002000003000000140000001700000002000000000000000000bbeea00000000060920cb500000001010000000000000000000000000000200000000000000040000000000000000000000000000000800000000100000016000000170000000000bbeea00000000500000000000000800000000100000016000000170000000060920cb50000000500000000000000000000000000144000000000000014400000bbeea00000000060920cb50000001400000000000000e0020000030000001400000017000000020000000000000000c0692ac900000000204148dd000000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000c0692ac900000006000000000000008000000001000000160000001700000000204148dd00000006000000000000000000000000001840000000000000184000c0692ac900000000204148dd0000001400000000000000e0020000030000001400000017000000020000000000000000801866f100000000e0ef8305010000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000801866f100000007000000000000008000000001000000160000001700000000e0ef830501000007000000000000000000000000001c400000000000001c4000801866f100000000e0ef83050100001400000000000000e002000003000000140000001700000002000000000000000040c7a11901000000a09ebf2d01000001010000000000000000000000000000200000000000000040000000000000000000000000000000800000000100000016000000170000000040c7a11901000008000000000000008000000001000000160000001700000000a09ebf2d0100000800000000000000000000000000204000000000000020400040c7a11901000000a09ebf2d0100001400000000000000e00200000300000014000000170000000200000000000000000076dd4101000000604dfb550100000101000000000000000000000000000020000000000000004000000000000000000000000000000080000000010000001600000017000000000076dd4101000009000000000000008000000001000000160000001700000000604dfb55010000090000000000000000000000000022400000000000002240000076dd4101000000604dfb550100001400000000000000e0020000030000001400000017000000020000000000000000c024196a0100000020fc367e010000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000c024196a0100000a00000000000000800000000100000016000000170000000020fc367e0100000a000000000000000000000000002440000000000000244000c024196a0100000020fc367e0100001400000000000000e002000003000000140000001700000002000000000000000080d3549201000000e0aa72a601000001010000000000000000000000000000200000000000000040000000000000000000000000000000800000000100000016000000170000000080d354920100000b000000000000008000000001000000160000001700000000e0aa72a60100000b00000000000000000000000000264000000000000026400080d3549201000000e0aa72a60100001400000000000000e0020000030000001400000017000000020000000000000000408290ba01000000a059aece010000010100000000000000000000000000002000000000000000400000000000000000000000000000008000000001000000160000001700000000408290ba0100000c000000000000008000000001000000160000001700000000a059aece0100000c000000000000000000000000002840000000000000284000408290ba01000000a059aece0100001400000000000000000000000000f03f0000000000002840000000000000000000a059aece0100001400000000000000', NULL::tint);
+SELECT valueAtTimestamp(temp, timestamptz '2000-01-11 12:00') = 6 FROM tbl_tint_storage;
+SELECT valueAtTimestamp(temp, timestamptz '2000-01-24') = 12 FROM tbl_tint_storage;
+SELECT valueAtTimestamp(temp, timestamptz '2000-01-04 12:00') IS NULL FROM tbl_tint_storage;
+SELECT tbox(temp) FROM tbl_tint_storage;
+DROP TABLE tbl_tint_storage;
+SELECT from_storage('\x03000000000000000000000008000000000000001000000000000000180000000000000000000000000000000060d71d1400000000c0ae3b28000000000000000000000000c0ae3b280000000101000000000000', NULL::timestampset);
+SELECT from_storage('\x03000000000000000000000008000000000000001000000000000000180000000000000000000000000000000060d71d1400000000c0ae3b28000000000000000000000000c0ae3b280000000101000000000000', NULL::timestampset) = timestampset '{2000-01-01, 2000-01-02, 2000-01-03}';
+SELECT timestampN(from_storage('\x03000000000000000000000008000000000000001000000000000000180000000000000000000000000000000060d71d1400000000c0ae3b28000000000000000000000000c0ae3b280000000101000000000000', NULL::timestampset), 3);
+SELECT memSize(from_storage('\x03000000000000000000000008000000000000001000000000000000180000000000000000000000000000000060d71d1400000000c0ae3b28000000000000000000000000c0ae3b280000000101000000000000', NULL::timestampset));
+SELECT from_storage('\x03000000000000000000000008000000000000001000000000000000180000000000000000000000000000000060d71d1400000000c0ae3b28000000000000000000000000c0ae3b280000000101000000000000', NULL::timestampset) * period '[2000-01-02, 2000-01-03]';
+
+/* Errors */
+SELECT * FROM generate_tints(-1, 10, 1, 5, period '[2000-01-01, 2000-01-02]');
+SELECT * FROM generate_tints(10, 0, 1, 5, period '[2000-01-01, 2000-01-02]');
+SELECT * FROM generate_tints(10, 10, 5, 1, period '[2000-01-01, 2000-01-02]');
+SELECT * FROM generate_tfloats(10, 10, 0, 1, period '[2000-01-01, 2000-01-02]', '1 month');
+SELECT * FROM generate_tfloats(10, 10, 0, 1, period '[2000-01-01, 2000-01-02]', '3 hours');
+SELECT * FROM generate_ttexts(10, 10, 0, period '[2000-01-01, 2000-01-02]');
+
+-------------------------------------------------------------------------------
@@ -62,3 +62,62 @@ foreach(file ${testfiles})
 	endif()
 endforeach()
 
+# The performance tests assert the plans, the work counters, and the
+# execution time of queries on generated data
+file(GLOB perffiles "test/perf/*.perf.sql")
+list(SORT perffiles)
+
+foreach(file ${perffiles})
+	get_filename_component(TESTNAME ${file} NAME_WE)
+	add_test(
+		NAME perf_${TESTNAME}
+		WORKING_DIRECTORY ${PROJECT_SOURCE_DIR}/test
+		COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh run_perf ${CMAKE_BINARY_DIR} perf_${TESTNAME} ${file}
+	)
+	set_tests_properties(perf_${TESTNAME} PROPERTIES FIXTURES_REQUIRED DB)
+	set_tests_properties(perf_${TESTNAME} PROPERTIES RESOURCE_LOCK DBLOCK)
+	set_tests_properties(perf_${TESTNAME} PROPERTIES LABELS perf)
+endforeach()
+
+
+# The values written by the standalone writer are read by the receive
+# functions of the extension
+if (WITH_WIRE_LIBRARY)
+	add_executable(wire_roundtrip test/wire/wire_roundtrip.c)
+	target_link_libraries(wire_roundtrip mobdb_wire)
+	add_test(
+		NAME wire_roundtrip
+		WORKING_DIRECTORY ${PROJECT_SOURCE_DIR}/test
+		COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh run_wire ${CMAKE_BINARY_DIR} wire_roundtrip $<TARGET_FILE:wire_roundtrip>
+	)
+	set_tests_properties(wire_roundtrip PROPERTIES FIXTURES_REQUIRED DB)
+	set_tests_properties(wire_roundtrip PROPERTIES RESOURCE_LOCK DBLOCK)
+
+	# The batch API is tested without the database
+	add_executable(wire_batch test/wire/wire_batch.c)
+	target_link_libraries(wire_batch mobdb_wire)
+	add_test(NAME wire_batch COMMAND wire_batch)
+endif ()
+
+add_custom_target(bench
+	COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh setup ${CMAKE_BINARY_DIR}
+	COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh create_ext ${CMAKE_BINARY_DIR}
+	COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh run_bench ${CMAKE_BINARY_DIR} ${PROJECT_SOURCE_DIR}/test/bench/bench.sql
+	COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh teardown ${CMAKE_BINARY_DIR}
+	WORKING_DIRECTORY ${PROJECT_SOURCE_DIR}/test
+	DEPENDS ${CMAKE_PROJECT_NAME} sqlscript control
+	COMMENT "Running the microbenchmarks of the kernels"
+)
+
+set(BERLINMOD_SCALE "0.005" CACHE STRING "Scale factor of the BerlinMOD benchmark")
+set(BERLINMOD_RUNS "3" CACHE STRING "Number of runs of each query of the BerlinMOD benchmark")
+
+add_custom_target(bench_berlinmod
+	COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh setup ${CMAKE_BINARY_DIR}
+	COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh create_ext ${CMAKE_BINARY_DIR}
+	COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh run_berlinmod ${CMAKE_BINARY_DIR} ${BERLINMOD_SCALE} ${BERLINMOD_RUNS}
+	COMMAND ${PROJECT_SOURCE_DIR}/test/scripts/test.sh teardown ${CMAKE_BINARY_DIR}
+	WORKING_DIRECTORY ${PROJECT_SOURCE_DIR}/test
+	DEPENDS ${CMAKE_PROJECT_NAME} sqlscript control
+	COMMENT "Running the BerlinMOD benchmark"
+)
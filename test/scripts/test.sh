@@ -23,10 +23,14 @@ setup)
 	mkdir -p "$WORKDIR"/db "$WORKDIR"/lock "$WORKDIR"/out "$WORKDIR"/log
 	initdb -D "$DBDIR" 2>&1 | tee "$WORKDIR"/log/initdb.log
 
+	# MobilityDB is preloaded to create its shared cache
 	if [ ! -z "$POSTGIS" ]; then
 		POSTGIS=$(basename "$POSTGIS" .so)
-		echo "shared_preload_libraries = '$POSTGIS'" >> "$WORKDIR"/db/postgresql.conf
+		echo "shared_preload_libraries = '$POSTGIS, $SOFILE'" >> "$WORKDIR"/db/postgresql.conf
+	else
+		echo "shared_preload_libraries = '$SOFILE'" >> "$WORKDIR"/db/postgresql.conf
 	fi
+	echo "mobilitydb.shared_cache_size = 1MB" >> "$WORKDIR"/db/postgresql.conf
 	echo "max_locks_per_transaction = 128" >> "$WORKDIR"/db/postgresql.conf
 	echo "timezone = 'UTC'" >> "$WORKDIR"/db/postgresql.conf
 	echo "parallel_tuple_cost = 100" >> "$WORKDIR"/db/postgresql.conf
@@ -118,6 +122,89 @@ run_passfail)
 	exit $?
 	;;
 
+run_perf)
+	TESTNAME=$3
+	TESTFILE=$4
+	HELPERS=$(dirname "$0")/../perf/perf_helpers.sql
+
+	$PGCTL status || $PGCTL start
+
+	while ! $PSQL -l; do
+		sleep 1
+	done
+
+	cat "$HELPERS" "$TESTFILE" | $FAILPSQL 2>&1 | tee "$WORKDIR"/out/"$TESTNAME".out > /dev/null
+	exit $?
+	;;
+
+run_wire)
+	TESTNAME=$3
+	PROGRAM=$4
+	mkdir -p "$WORKDIR"/wire
+
+	$PGCTL status || $PGCTL start
+
+	while ! $PSQL -l; do
+		sleep 1
+	done
+
+	# The program writes the values and prints the script checking them
+	"$PROGRAM" "$WORKDIR"/wire | $FAILPSQL 2>&1 | tee "$WORKDIR"/out/"$TESTNAME".out > /dev/null
+	exit $?
+	;;
+
+run_bench)
+	BENCHFILE=$3
+
+	$PGCTL status || $PGCTL start
+
+	while ! $PSQL -l; do
+		sleep 1
+	done
+
+	$FAILPSQL < "$BENCHFILE" 2>&1 | tee "$WORKDIR"/out/bench.out
+	exit $?
+	;;
+
+run_berlinmod)
+	SCALE=$3
+	RUNS=$4
+	BENCHDIR=$(dirname "$0")/../bench/berlinmod
+	BASELINE=$BENCHDIR/baseline.csv
+	OUTDIR=$WORKDIR/out/berlinmod
+	BENCHPSQL="psql -h $WORKDIR/lock -X -q --set ON_ERROR_STOP=1 postgres"
+
+	$PGCTL status || $PGCTL start
+
+	while ! $PSQL -l; do
+		sleep 1
+	done
+
+	mkdir -p "$OUTDIR"
+	$BENCHPSQL -f "$BENCHDIR"/berlinmod_datagen.sql || { $PGCTL stop; exit 1; }
+	$BENCHPSQL -c "SELECT berlinmod_generate($SCALE)" || { $PGCTL stop; exit 1; }
+	$BENCHPSQL -f "$BENCHDIR"/berlinmod_queries.sql || { $PGCTL stop; exit 1; }
+	$BENCHPSQL -c "SELECT berlinmod_run($RUNS)" || { $PGCTL stop; exit 1; }
+	$BENCHPSQL -c "\copy (SELECT * FROM berlinmod_report ORDER BY IndexType, QueryId) TO '$OUTDIR/results.csv' CSV HEADER" || { $PGCTL stop; exit 1; }
+	$BENCHPSQL -At -c "SELECT json_build_object('index', IndexType, 'query', QueryId, 'plan', Plan) FROM berlinmod_results WHERE Plan IS NOT NULL ORDER BY IndexType, QueryId" > "$OUTDIR"/plans.json || { $PGCTL stop; exit 1; }
+	$BENCHPSQL -c "SELECT IndexType, QueryId, PlanningMs, ExecutionMs, NumRows FROM berlinmod_report ORDER BY IndexType, QueryId"
+
+	if [ ! -z "$BENCH_GENERATE" ]; then
+		echo "BENCH_GENERATE is on; storing the results as the baseline"
+		cp "$OUTDIR"/results.csv "$BASELINE"
+		exit 0
+	fi
+	if [ ! -f "$BASELINE" ]; then
+		echo "No baseline in $BASELINE; run with BENCH_GENERATE=1 to store one"
+		exit 0
+	fi
+	$BENCHPSQL -c "\copy berlinmod_baseline FROM '$BASELINE' CSV HEADER" || { $PGCTL stop; exit 1; }
+	$BENCHPSQL -c "SELECT * FROM berlinmod_compare()" | tee "$OUTDIR"/compare.txt
+	# Stop the server also on failure since the teardown is skipped then
+	$BENCHPSQL -c "SELECT berlinmod_check()" || { $PGCTL stop; exit 1; }
+	exit 0
+	;;
+
 esac
 
 echo "Bad usage." >&2
@@ -0,0 +1,344 @@
+/*****************************************************************************
+ *
+ * wire_batch.c
+ *    Tests of the batch API of the standalone writer of the compact binary
+ *    format.
+ *
+ * The program verifies the bytes written for a sequence against the
+ * compact binary format, the statuses returned for invalid arguments and
+ * for invalid sequences, and that the sequences written by several threads
+ * are identical to the ones written by the calling thread and by a single
+ * writer. The allocator of the tests counts the blocks allocated, so that
+ * the memory of the writers of the threads is verified to be freed.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "mobdb_wire.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* One day in microseconds */
+#define DAY ((int64_t) 86400000000)
+
+/* Number of sequences of the batches, which spans several chunks */
+#define NSEQS 1000
+
+/* Maximum number of instants of the sequences of the batches */
+#define MAXCOUNT 40
+
+/* Size of the largest block returned by the allocator that fails */
+#define MAXALLOC 4096
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (! (cond)) \
+    { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, \
+        #cond); \
+      failures++; \
+    } \
+  } while (0)
+
+/*****************************************************************************
+ * Allocators
+ *****************************************************************************/
+
+/* Number of blocks allocated and not yet freed */
+static atomic_int nblocks;
+
+static void *
+test_alloc(size_t size)
+{
+  void *result = malloc(size);
+  if (result != NULL)
+    atomic_fetch_add(&nblocks, 1);
+  return result;
+}
+
+static void *
+test_realloc(void *ptr, size_t size)
+{
+  void *result = realloc(ptr, size);
+  if (result != NULL && ptr == NULL)
+    atomic_fetch_add(&nblocks, 1);
+  return result;
+}
+
+static void
+test_free(void *ptr)
+{
+  if (ptr != NULL)
+    atomic_fetch_sub(&nblocks, 1);
+  free(ptr);
+  return;
+}
+
+static const MobdbWireAllocator test_allocator =
+  { &test_alloc, &test_realloc, &test_free };
+
+/**
+ * Reallocation failing for the blocks larger than MAXALLOC, so that the
+ * writer of a long sequence runs out of memory
+ */
+static void *
+test_limited_realloc(void *ptr, size_t size)
+{
+  if (size > MAXALLOC)
+    return NULL;
+  return test_realloc(ptr, size);
+}
+
+static const MobdbWireAllocator test_limited_allocator =
+  { &test_alloc, &test_limited_realloc, &test_free };
+
+/*****************************************************************************
+ * Sequences of the batches
+ *****************************************************************************/
+
+static int64_t times[NSEQS][MAXCOUNT];
+static double xs[NSEQS][MAXCOUNT];
+static double ys[NSEQS][MAXCOUNT];
+static double zs[NSEQS][MAXCOUNT];
+
+/**
+ * Fills the sequences of the batch with instants whose number and values
+ * vary with the sequence
+ */
+static void
+batch_fill(MobdbWireSequence *seqs, bool hasz)
+{
+  for (int i = 0; i < NSEQS; i++)
+  {
+    int count = 1 + i % MAXCOUNT;
+    for (int j = 0; j < count; j++)
+    {
+      times[i][j] = i * DAY + j * 1000000;
+      xs[i][j] = i + j * 0.5;
+      ys[i][j] = i - j * 0.25;
+      zs[i][j] = j;
+    }
+    seqs[i].count = count;
+    seqs[i].times = times[i];
+    seqs[i].x = xs[i];
+    seqs[i].y = ys[i];
+    seqs[i].z = hasz ? zs[i] : NULL;
+    seqs[i].lower_inc = true;
+    seqs[i].upper_inc = (count == 1 || i % 2 == 0);
+  }
+  return;
+}
+
+/**
+ * Writes the sequence with a single writer
+ */
+static MobdbWireStatus
+sequence_write(MobdbWireBase base, bool linear, bool hasz, int32_t srid,
+  const MobdbWireSequence *seq, uint8_t **data, size_t *size)
+{
+  MobdbWireWriter *writer = mobdb_wire_writer_new(base, MOBDB_WIRE_SEQUENCE,
+    linear, hasz, srid, NULL);
+  if (writer == NULL)
+    return MOBDB_WIRE_INVALID;
+  MobdbWireStatus status = mobdb_wire_begin_sequence(writer, seq->lower_inc,
+    seq->upper_inc);
+  for (int32_t i = 0; i < seq->count && status == MOBDB_WIRE_OK; i++)
+  {
+    if (base == MOBDB_WIRE_FLOAT)
+      status = mobdb_wire_add_float(writer, seq->times[i], seq->x[i]);
+    else
+      status = mobdb_wire_add_point(writer, seq->times[i], seq->x[i],
+        seq->y[i], seq->z != NULL ? seq->z[i] : 0.0);
+  }
+  if (status == MOBDB_WIRE_OK)
+    status = mobdb_wire_finish(writer, data, size);
+  mobdb_wire_writer_free(writer);
+  return status;
+}
+
+/**
+ * Frees the outputs of the batch
+ */
+static void
+outputs_free(MobdbWireOutput *outputs, int count)
+{
+  for (int i = 0; i < count; i++)
+    test_free(outputs[i].data);
+  return;
+}
+
+/*****************************************************************************
+ * Tests
+ *****************************************************************************/
+
+/**
+ * Verifies the bytes written for a sequence of a temporal float and of a
+ * temporal point with Z coordinates
+ */
+static void
+test_encoding(void)
+{
+  static const uint8_t float_bytes[] =
+  {
+    0x83, 0x01, 0x01,                                /* Header */
+    0x00, 0x00, 0x00, 0x02, 0x01,                    /* Sequence [..) */
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 2000-01-01 */
+    0x00, 0x00, 0x00, 0x14, 0x1D, 0xD7, 0x60, 0x00,  /* 2000-01-02 */
+    0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 1 */
+    0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 2 */
+  };
+  static const uint8_t point_bytes[] =
+  {
+    0x83, 0x01, 0x07,                                /* Header */
+    0x00, 0x00, 0x10, 0xE6,                          /* SRID 4326 */
+    0x00, 0x00, 0x00, 0x01, 0x03,                    /* Sequence [..] */
+    0x00, 0x00, 0x00, 0x14, 0x1D, 0xD7, 0x60, 0x00,  /* 2000-01-02 */
+    0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 1 */
+    0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* 2 */
+    0xC0, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* -3 */
+  };
+  int64_t t[] = {0, DAY};
+  double x[] = {1, 2};
+  double y[] = {2, 0};
+  double z[] = {-3, 0};
+  MobdbWireSequence seqs[] =
+  {
+    {2, t, x, NULL, NULL, true, false},
+    {1, &t[1], x, y, z, true, true},
+  };
+  MobdbWireOutput outputs[2];
+
+  CHECK(mobdb_wire_write_batch(MOBDB_WIRE_FLOAT, true, false, 0, &seqs[0], 1,
+    1, &test_allocator, &outputs[0]) == MOBDB_WIRE_OK);
+  CHECK(outputs[0].status == MOBDB_WIRE_OK);
+  CHECK(outputs[0].size == sizeof(float_bytes) &&
+    memcmp(outputs[0].data, float_bytes, sizeof(float_bytes)) == 0);
+  CHECK(mobdb_wire_write_batch(MOBDB_WIRE_GEOGPOINT, true, true, 4326,
+    &seqs[1], 1, 1, &test_allocator, &outputs[1]) == MOBDB_WIRE_OK);
+  CHECK(outputs[1].status == MOBDB_WIRE_OK);
+  CHECK(outputs[1].size == sizeof(point_bytes) &&
+    memcmp(outputs[1].data, point_bytes, sizeof(point_bytes)) == 0);
+  outputs_free(outputs, 2);
+  return;
+}
+
+/**
+ * Verifies the status of the batch for invalid arguments and the status of
+ * the outputs for invalid sequences
+ */
+static void
+test_statuses(void)
+{
+  int64_t t[] = {0, DAY, DAY};
+  int64_t tunordered[] = {DAY, 0};
+  double x[] = {1, 2, 3};
+  static int64_t tlong[1024];
+  static double xlong[1024];
+  for (int i = 0; i < 1024; i++)
+  {
+    tlong[i] = i;
+    xlong[i] = i;
+  }
+  MobdbWireSequence seqs[] =
+  {
+    {2, t, x, NULL, NULL, true, true},
+    {2, tunordered, x, NULL, NULL, true, true},
+    {3, t, x, NULL, NULL, true, true},
+    {0, t, x, NULL, NULL, true, true},
+    {1024, tlong, xlong, NULL, NULL, true, true},
+  };
+  MobdbWireOutput outputs[5];
+
+  /* Invalid arguments of the batch */
+  CHECK(mobdb_wire_write_batch(MOBDB_WIRE_INT, true, false, 0, seqs, 1, 1,
+    &test_allocator, outputs) == MOBDB_WIRE_INVALID);
+  CHECK(mobdb_wire_write_batch(MOBDB_WIRE_FLOAT, true, true, 0, seqs, 1, 1,
+    &test_allocator, outputs) == MOBDB_WIRE_INVALID);
+  CHECK(mobdb_wire_write_batch(MOBDB_WIRE_FLOAT, true, false, 0, seqs, -1, 1,
+    &test_allocator, outputs) == MOBDB_WIRE_INVALID);
+  CHECK(mobdb_wire_write_batch(MOBDB_WIRE_FLOAT, true, false, 0, seqs, 0, 4,
+    &test_allocator, outputs) == MOBDB_WIRE_OK);
+
+  /* Invalid sequences only fail their own output */
+  CHECK(mobdb_wire_write_batch(MOBDB_WIRE_FLOAT, true, false, 0, seqs, 5, 1,
+    &test_limited_allocator, outputs) == MOBDB_WIRE_OK);
+  CHECK(outputs[0].status == MOBDB_WIRE_OK && outputs[0].data != NULL);
+  CHECK(outputs[1].status == MOBDB_WIRE_ORDER && outputs[1].data == NULL);
+  CHECK(outputs[2].status == MOBDB_WIRE_ORDER && outputs[2].data == NULL);
+  CHECK(outputs[3].status == MOBDB_WIRE_EMPTY && outputs[3].data == NULL);
+  CHECK(outputs[4].status == MOBDB_WIRE_NOMEM && outputs[4].data == NULL);
+  outputs_free(outputs, 5);
+  return;
+}
+
+/**
+ * Verifies that the batch written by several threads is identical to the
+ * one written by the calling thread and by a single writer
+ */
+static void
+test_threads(MobdbWireBase base, bool hasz, int32_t srid)
+{
+  static MobdbWireSequence seqs[NSEQS];
+  static MobdbWireOutput single[NSEQS];
+  static MobdbWireOutput multi[NSEQS];
+
+  batch_fill(seqs, hasz);
+  /* One sequence fails in the middle of the batch */
+  times[NSEQS / 2][1] = times[NSEQS / 2][0];
+  CHECK(mobdb_wire_write_batch(base, true, hasz, srid, seqs, NSEQS, 1,
+    &test_allocator, single) == MOBDB_WIRE_OK);
+  CHECK(mobdb_wire_write_batch(base, true, hasz, srid, seqs, NSEQS, 4,
+    &test_allocator, multi) == MOBDB_WIRE_OK);
+  for (int i = 0; i < NSEQS; i++)
+  {
+    MobdbWireStatus expected = i == NSEQS / 2 ? MOBDB_WIRE_ORDER :
+      MOBDB_WIRE_OK;
+    CHECK(single[i].status == expected);
+    CHECK(multi[i].status == expected);
+    CHECK(single[i].size == multi[i].size &&
+      (single[i].size == 0 ||
+        memcmp(single[i].data, multi[i].data, single[i].size) == 0));
+    if (expected != MOBDB_WIRE_OK)
+      continue;
+    uint8_t *data;
+    size_t size;
+    CHECK(sequence_write(base, true, hasz, srid, &seqs[i], &data, &size) ==
+      MOBDB_WIRE_OK);
+    CHECK(size == multi[i].size && memcmp(data, multi[i].data, size) == 0);
+    free(data);
+  }
+  outputs_free(single, NSEQS);
+  outputs_free(multi, NSEQS);
+  return;
+}
+
+int
+main(void)
+{
+  atomic_init(&nblocks, 0);
+  test_encoding();
+  test_statuses();
+  test_threads(MOBDB_WIRE_FLOAT, false, 0);
+  test_threads(MOBDB_WIRE_GEOMPOINT, false, 0);
+  test_threads(MOBDB_WIRE_GEOMPOINT, true, 3812);
+  test_threads(MOBDB_WIRE_GEOGPOINT, true, 4326);
+  /* The writers of the batches and their outputs are freed */
+  CHECK(atomic_load(&nblocks) == 0);
+  if (failures > 0)
+  {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  return 0;
+}
+
+/*****************************************************************************/
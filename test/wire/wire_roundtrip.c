@@ -0,0 +1,238 @@
+/*****************************************************************************
+ *
+ * wire_roundtrip.c
+ *    Round trip of the values written by the standalone writer of the
+ *    compact binary format through the receive functions of the extension.
+ *
+ * The program writes each value of the test with the writer into a file in
+ * the binary format of COPY and prints to the standard output a script that
+ * loads the files with COPY, which reads the values with the receive
+ * function of their type, and raises an error when the text representation
+ * of a value differs from the expected one.
+ *
+ * Usage: wire_roundtrip <directory of the files>
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *     Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "mobdb_wire.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* One day in microseconds */
+#define DAY ((int64_t) 86400000000)
+
+/**
+ * Instant of a value of the test, the values of temporal booleans, integers
+ * and floats are given in x
+ */
+typedef struct
+{
+  int64_t t;
+  double x;
+  double y;
+  double z;
+} WireInstant;
+
+/**
+ * Sequence of a value of the test, the ones of instants and instant sets
+ * have no bounds
+ */
+typedef struct
+{
+  int count;
+  WireInstant instants[4];
+  bool lower_inc;
+  bool upper_inc;
+} WireSeq;
+
+/**
+ * Value of the test with its expected text representation
+ */
+typedef struct
+{
+  const char *type;         /**< SQL type of the value */
+  const char *output;       /**< SQL function giving the text of the value */
+  MobdbWireBase base;
+  int duration;
+  bool linear;
+  bool hasz;
+  int32_t srid;
+  int count;
+  WireSeq seqs[2];
+  const char *expected;
+} WireCase;
+
+static const WireCase wire_cases[] =
+{
+  {"tbool", "text", MOBDB_WIRE_BOOL, MOBDB_WIRE_INSTANT, false, false, 0,
+    1, {{1, {{0, 1, 0, 0}}, false, false}},
+    "t@2000-01-01 00:00:00+00"},
+  {"tint", "text", MOBDB_WIRE_INT, MOBDB_WIRE_INSTANTSET, false, false, 0,
+    1, {{3, {{0, 1, 0, 0}, {DAY, -2, 0, 0}, {2 * DAY, 3, 0, 0}},
+      false, false}},
+    "{1@2000-01-01 00:00:00+00, -2@2000-01-02 00:00:00+00, "
+    "3@2000-01-03 00:00:00+00}"},
+  {"tfloat", "text", MOBDB_WIRE_FLOAT, MOBDB_WIRE_SEQUENCE, true, false, 0,
+    1, {{3, {{0, 1.5, 0, 0}, {DAY, 2.5, 0, 0}, {2 * DAY, 1, 0, 0}},
+      true, false}},
+    "[1.5@2000-01-01 00:00:00+00, 2.5@2000-01-02 00:00:00+00, "
+    "1@2000-01-03 00:00:00+00)"},
+  {"tfloat", "text", MOBDB_WIRE_FLOAT, MOBDB_WIRE_SEQUENCE, false, false, 0,
+    1, {{2, {{0, 1.5, 0, 0}, {DAY, 2.5, 0, 0}}, true, true}},
+    "Interp=Stepwise;[1.5@2000-01-01 00:00:00+00, "
+    "2.5@2000-01-02 00:00:00+00]"},
+  {"tint", "text", MOBDB_WIRE_INT, MOBDB_WIRE_SEQUENCESET, false, false, 0,
+    2, {{2, {{0, 1, 0, 0}, {DAY, 2, 0, 0}}, true, true},
+      {2, {{2 * DAY, 3, 0, 0}, {3 * DAY, 3, 0, 0}}, false, true}},
+    "{[1@2000-01-01 00:00:00+00, 2@2000-01-02 00:00:00+00], "
+    "(3@2000-01-03 00:00:00+00, 3@2000-01-04 00:00:00+00]}"},
+  {"tgeompoint", "asEWKT", MOBDB_WIRE_GEOMPOINT, MOBDB_WIRE_INSTANT, true,
+    false, 0,
+    1, {{1, {{0, 1, 2, 0}}, false, false}},
+    "POINT(1 2)@2000-01-01 00:00:00+00"},
+  {"tgeompoint", "asEWKT", MOBDB_WIRE_GEOMPOINT, MOBDB_WIRE_SEQUENCE, true,
+    false, 0,
+    1, {{3, {{0, 1, 1, 0}, {DAY, 2, 3, 0}, {2 * DAY, 1, 4, 0}}, true, true}},
+    "[POINT(1 1)@2000-01-01 00:00:00+00, POINT(2 3)@2000-01-02 00:00:00+00, "
+    "POINT(1 4)@2000-01-03 00:00:00+00]"},
+  {"tgeompoint", "asEWKT", MOBDB_WIRE_GEOMPOINT, MOBDB_WIRE_SEQUENCESET, true,
+    true, 3812,
+    2, {{2, {{0, 1, 2, 3}, {DAY, 4, 5, 6}}, true, false},
+      {1, {{2 * DAY, 7, 8, 9}}, true, true}},
+    "SRID=3812;{[POINT Z (1 2 3)@2000-01-01 00:00:00+00, "
+    "POINT Z (4 5 6)@2000-01-02 00:00:00+00), "
+    "[POINT Z (7 8 9)@2000-01-03 00:00:00+00]}"},
+  {"tgeogpoint", "asEWKT", MOBDB_WIRE_GEOGPOINT, MOBDB_WIRE_INSTANTSET, true,
+    false, 4326,
+    1, {{2, {{0, 1, 2, 0}, {DAY, 3, 4, 0}}, false, false}},
+    "SRID=4326;{POINT(1 2)@2000-01-01 00:00:00+00, "
+    "POINT(3 4)@2000-01-02 00:00:00+00}"},
+  {"tgeogpoint", "asEWKT", MOBDB_WIRE_GEOGPOINT, MOBDB_WIRE_SEQUENCE, true,
+    true, 4326,
+    1, {{2, {{0, 1, 2, 3}, {DAY, 2, 3, 5}}, true, true}},
+    "SRID=4326;[POINT Z (1 2 3)@2000-01-01 00:00:00+00, "
+    "POINT Z (2 3 5)@2000-01-02 00:00:00+00]"},
+};
+
+#define NCASES ((int) (sizeof(wire_cases) / sizeof(WireCase)))
+
+/**
+ * Writes the value of the test with the writer
+ */
+static MobdbWireStatus
+wire_case_write(const WireCase *c, uint8_t **data, size_t *size)
+{
+  MobdbWireWriter *writer = mobdb_wire_writer_new(c->base, c->duration,
+    c->linear, c->hasz, c->srid, NULL);
+  MobdbWireStatus status = writer == NULL ? MOBDB_WIRE_INVALID :
+    MOBDB_WIRE_OK;
+  for (int i = 0; i < c->count && status == MOBDB_WIRE_OK; i++)
+  {
+    const WireSeq *seq = &c->seqs[i];
+    if (c->duration == MOBDB_WIRE_SEQUENCE ||
+      c->duration == MOBDB_WIRE_SEQUENCESET)
+      status = mobdb_wire_begin_sequence(writer, seq->lower_inc,
+        seq->upper_inc);
+    for (int j = 0; j < seq->count && status == MOBDB_WIRE_OK; j++)
+    {
+      const WireInstant *inst = &seq->instants[j];
+      if (c->base == MOBDB_WIRE_BOOL)
+        status = mobdb_wire_add_bool(writer, inst->t, inst->x != 0.0);
+      else if (c->base == MOBDB_WIRE_INT)
+        status = mobdb_wire_add_int(writer, inst->t, (int32_t) inst->x);
+      else if (c->base == MOBDB_WIRE_FLOAT)
+        status = mobdb_wire_add_float(writer, inst->t, inst->x);
+      else
+        status = mobdb_wire_add_point(writer, inst->t, inst->x, inst->y,
+          inst->z);
+    }
+  }
+  if (status == MOBDB_WIRE_OK)
+    status = mobdb_wire_finish(writer, data, size);
+  mobdb_wire_writer_free(writer);
+  return status;
+}
+
+/**
+ * Writes a 16-bit or 32-bit integer in network byte order
+ */
+static void
+copy_write_int(FILE *file, uint32_t value, int bytes)
+{
+  for (int i = bytes - 1; i >= 0; i--)
+    fputc((int) ((value >> (8 * i)) & 0xFF), file);
+}
+
+/**
+ * Writes a file in the binary format of COPY with one row whose only
+ * column has the value
+ */
+static bool
+copy_write_file(const char *path, const uint8_t *data, size_t size)
+{
+  static const char signature[] = "PGCOPY\n\377\r\n";
+  FILE *file = fopen(path, "wb");
+  if (file == NULL)
+    return false;
+  /* The signature includes its terminating null byte */
+  fwrite(signature, 1, sizeof(signature), file);
+  copy_write_int(file, 0, 4);          /* Flags */
+  copy_write_int(file, 0, 4);          /* Length of the header extension */
+  copy_write_int(file, 1, 2);          /* Number of columns of the row */
+  copy_write_int(file, (uint32_t) size, 4);
+  fwrite(data, 1, size, file);
+  copy_write_int(file, 0xFFFF, 2);     /* Trailer */
+  return fclose(file) == 0;
+}
+
+int
+main(int argc, char **argv)
+{
+  char path[4096];
+
+  if (argc != 2)
+  {
+    fprintf(stderr, "Usage: %s <directory of the files>\n", argv[0]);
+    return 2;
+  }
+
+  for (int i = 0; i < NCASES; i++)
+  {
+    const WireCase *c = &wire_cases[i];
+    uint8_t *data;
+    size_t size;
+    MobdbWireStatus status = wire_case_write(c, &data, &size);
+    if (status != MOBDB_WIRE_OK)
+    {
+      fprintf(stderr, "wire_%d: the writer returned the status %d\n", i,
+        (int) status);
+      return 1;
+    }
+    snprintf(path, sizeof(path), "%s/wire_%d.bin", argv[1], i);
+    bool written = copy_write_file(path, data, size);
+    free(data);
+    if (! written)
+    {
+      fprintf(stderr, "wire_%d: cannot write the file %s\n", i, path);
+      return 1;
+    }
+
+    printf("CREATE TEMP TABLE wire_%d(temp %s);\n", i, c->type);
+    printf("\\copy wire_%d FROM '%s' WITH (FORMAT binary)\n", i, path);
+    printf("DO $$\nDECLARE\n  result text;\nBEGIN\n");
+    printf("  SELECT %s(temp) INTO STRICT result FROM wire_%d;\n", c->output,
+      i);
+    printf("  IF result IS DISTINCT FROM '%s' THEN\n", c->expected);
+    printf("    RAISE EXCEPTION 'wire_%d: %%', result;\n", i);
+    printf("  END IF;\nEND $$;\n");
+  }
+  return 0;
+}
+
+/*****************************************************************************/